@@ -1,16 +1,31 @@
 // Copyright 2015 Dirk Hutter
 
 #include "ChildProcessManager.hpp"
+#include "LiveStats.hpp"
+#include "Monitor.hpp"
+#include "device_operator.hpp"
 #include "log.hpp"
 #include "parameters.hpp"
 #include "shm_device_server.hpp"
 #include <boost/algorithm/string.hpp>
+#include <atomic>
 #include <csignal>
 #include <memory>
+#include <thread>
+#include <unistd.h>
+#include <vector>
 
 namespace {
 volatile std::sig_atomic_t signal_status = 0;
-}
+
+// Removes the name of the live statistics segment when leaving main()
+struct LiveStatsGuard {
+  LiveStatsGuard() = default;
+  LiveStatsGuard(const LiveStatsGuard&) = delete;
+  void operator=(const LiveStatsGuard&) = delete;
+  ~LiveStatsGuard() { cbm::LiveStats::Remove(); }
+};
+} // namespace
 
 static void signal_handler(int sig) { signal_status = sig; }
 
@@ -36,31 +51,93 @@ int main(int argc, char* argv[]) {
 
     parameters par(argc, argv);
 
-    std::unique_ptr<cri::cri_device> cri;
-    if (par.dev_autodetect()) {
-      cri = std::make_unique<cri::cri_device>(0);
+    std::vector<std::unique_ptr<cri::cri_device>> cris;
+    if (par.all_devices()) {
+      pda::device_operator dev_op;
+      uint64_t num_dev = dev_op.device_count();
+      if (num_dev == 0) {
+        L_(error) << "no CRI found";
+        return EXIT_FAILURE;
+      }
+      for (size_t i = 0; i < num_dev; ++i) {
+        cris.push_back(std::make_unique<cri::cri_device>(i));
+      }
+    } else if (par.dev_autodetect()) {
+      cris.push_back(std::make_unique<cri::cri_device>(0));
     } else {
-      cri = std::make_unique<cri::cri_device>(
-          par.dev_addr().bus, par.dev_addr().dev, par.dev_addr().func);
+      cris.push_back(std::make_unique<cri::cri_device>(
+          par.dev_addr().bus, par.dev_addr().dev, par.dev_addr().func));
     }
-    L_(info) << "using CRI: " << cri->print_devinfo();
-    if (par.archivable_data()) {
-      L_(info) << "enforcing archivable data";
-      if (!cri->check_build()) {
-        L_(error) << "unsupported CRI hardware build";
-        return EXIT_FAILURE;
+
+    std::vector<std::string> shms;
+    for (size_t i = 0; i < cris.size(); ++i) {
+      auto& cri = cris[i];
+      shms.push_back(par.all_devices() ? par.shm(i) : par.shm());
+      L_(info) << "using CRI: " << cri->print_devinfo() << " (NUMA node "
+               << cri->numa_node() << ", shm " << shms.back() << ")";
+      if (par.archivable_data()) {
+        L_(info) << "enforcing archivable data";
+        if (!cri->check_build()) {
+          L_(error) << "unsupported CRI hardware build";
+          return EXIT_FAILURE;
+        }
       }
     }
 
-    // create server
-    cri_shm_device_server server(cri.get(), par.shm(),
-                                 par.data_buffer_size_exp(),
-                                 par.desc_buffer_size_exp(), &signal_status);
+    std::unique_ptr<cbm::Monitor> monitor;
+    if (!par.monitor_uri().empty()) {
+      monitor = std::make_unique<cbm::Monitor>(par.monitor_uri());
+    }
+    LiveStatsGuard live_stats_guard;
+    if (par.live_stats()) {
+      cbm::LiveStats::Create("cri_server." + std::to_string(getpid()));
+    }
+
+    index_batch_policy index_batch;
+    index_batch.window = par.index_batch_window();
+    index_batch.desc = par.index_batch_desc();
+
+    // create one server per device, with buffers on the device's NUMA node
+    std::vector<std::unique_ptr<cri_shm_device_server>> servers;
+    for (size_t i = 0; i < cris.size(); ++i) {
+      servers.push_back(std::make_unique<cri_shm_device_server>(
+          cris[i].get(), shms[i], par.data_buffer_size_exp(),
+          par.desc_buffer_size_exp(), &signal_status, par.lockfree_index(),
+          par.poll_interval(), par.shadow_index(), cris[i]->numa_node(),
+          par.huge_pages(), monitor.get(), par.monitor_interval(),
+          index_batch, par.persistent_shm()));
+    }
     if (!par.exec().empty()) {
-      start_exec(par.exec(), par.shm());
+      for (const auto& shm : shms) {
+        start_exec(par.exec(), shm);
+      }
       ChildProcessManager::get().allow_stop_processes(nullptr);
     }
-    server.run();
+
+    if (servers.size() == 1) {
+      servers.front()->run();
+    } else {
+      // serve each device in its own thread, a failure stops all of them
+      std::vector<std::thread> threads;
+      std::atomic<bool> failed{false};
+      for (auto& server : servers) {
+        threads.emplace_back([&server, &failed] {
+          try {
+            server->run();
+          } catch (std::exception const& e) {
+            L_(fatal) << "exception: " << e.what();
+            failed = true;
+            signal_status = SIGTERM;
+          }
+        });
+      }
+      for (auto& thread : threads) {
+        thread.join();
+      }
+      if (failed) {
+        return EXIT_FAILURE;
+      }
+    }
 
   } catch (std::exception const& e) {
     L_(fatal) << "exception: " << e.what();
@@ -2,12 +2,14 @@
 
 #pragma once
 
+#include "MemoryPolicy.hpp"
 #include "MicrosliceDescriptor.hpp"
 #include "Utility.hpp"
 #include "cri.hpp"
 #include "log.hpp"
 #include <boost/numeric/conversion/cast.hpp>
 #include <boost/program_options.hpp>
+#include <chrono>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -68,11 +70,39 @@ public:
 
   bool dev_autodetect() const { return _dev_autodetect; }
   pci_addr dev_addr() const { return _pci_addr; }
+  bool all_devices() const { return _all_devices; }
   std::string shm() { return _shm; }
+
+  // Shared memory name for the n-th of several devices. A trailing number
+  // is counted up (cri_0, cri_1, ...), otherwise the index is appended.
+  std::string shm(size_t n) const {
+    size_t digits = _shm.find_last_not_of("0123456789") + 1;
+    if (digits < _shm.size()) {
+      return _shm.substr(0, digits) +
+             std::to_string(std::stoul(_shm.substr(digits)) + n);
+    }
+    return _shm + "_" + std::to_string(n);
+  }
   size_t data_buffer_size_exp() const { return _data_buffer_size_exp; }
   size_t desc_buffer_size_exp() const { return _desc_buffer_size_exp; }
   std::string exec() const { return _exec; }
   bool archivable_data() const { return _archivable_data; }
+  bool lockfree_index() const { return _lockfree_index; }
+  bool shadow_index() const { return _shadow_index; }
+  HugePages huge_pages() const { return _huge_pages; }
+  std::string monitor_uri() const { return _monitor_uri; }
+  bool live_stats() const { return _live_stats; }
+  std::chrono::milliseconds monitor_interval() const {
+    return std::chrono::milliseconds(_monitor_interval_ms);
+  }
+  std::chrono::microseconds poll_interval() const {
+    return std::chrono::microseconds(_poll_interval_us);
+  }
+  std::chrono::microseconds index_batch_window() const {
+    return std::chrono::microseconds(_index_batch_us);
+  }
+  uint64_t index_batch_desc() const { return _index_batch_desc; }
+  bool persistent_shm() const { return _persistent_shm; }
 
   std::string print_buffer_info() const {
     std::stringstream ss;
@@ -104,6 +134,12 @@ private:
     auto config_add = config.add_options();
     config_add("pci-addr,i", po::value<pci_addr>(),
                "PCI BDF address of target CRI in BB:DD.F format");
+    config_add("all-devices",
+               po::value<bool>(&_all_devices)
+                   ->value_name("<bool>")
+                   ->default_value(false),
+               "serve all CRIs, each with its own shared memory and server "
+               "thread on the device's NUMA node");
     config_add("shm,o", po::value<std::string>(&_shm)->default_value("cri_0"),
                "name of the shared memory to be used");
     config_add("data-buffer-size-exp",
@@ -124,6 +160,26 @@ private:
                    ->implicit_value(log_syslog)
                    ->value_name("<n>"),
                "enable logging to syslog at given log level");
+    config_add("monitor,m",
+               po::value<std::string>(&_monitor_uri)
+                   ->value_name("<uri>")
+                   ->implicit_value("influx1:login:8086:cri_server_status"),
+               "publish the CRI hardware counters and buffer occupancies to "
+               "InfluxDB (or \"file:cout\" for console output)");
+    config_add("monitor-interval",
+               po::value<unsigned>(&_monitor_interval_ms)
+                   ->value_name("<ms>")
+                   ->default_value(1000),
+               "interval of the published hardware counters (the counters "
+               "are reset on each sample, so do not run cri_status at the "
+               "same time)");
+    config_add("live-stats",
+               po::value<bool>(&_live_stats)
+                   ->value_name("<bool>")
+                   ->default_value(false)
+                   ->implicit_value(true),
+               "publish live counters and microslice size histograms in a "
+               "shared memory segment for external tools (see fles_stats)");
     config_add("exec,e", po::value<std::string>(&_exec)->value_name("<string>"),
                "name of an executable to run after startup");
     config_add("archivable-data",
@@ -131,6 +187,48 @@ private:
                    ->value_name("<bool>")
                    ->default_value(false),
                "enforce traceable CRI hardware");
+    config_add("lockfree-index",
+               po::value<bool>(&_lockfree_index)
+                   ->value_name("<bool>")
+                   ->default_value(false),
+               "exchange the buffer indices through shared memory atomics "
+               "instead of locked requests");
+    config_add("poll-interval",
+               po::value<unsigned>(&_poll_interval_us)
+                   ->value_name("<us>")
+                   ->default_value(10),
+               "hardware polling interval in lock-free index mode and for "
+               "batched index requests (0: busy polling)");
+    config_add("index-batch-window",
+               po::value<unsigned>(&_index_batch_us)
+                   ->value_name("<us>")
+                   ->default_value(0),
+               "maximum time to hold back write index updates to a client "
+               "until enough data is available (0: no batching)");
+    config_add("index-batch-desc",
+               po::value<uint64_t>(&_index_batch_desc)
+                   ->value_name("<n>")
+                   ->default_value(1),
+               "number of new microslices that completes a batch of write "
+               "index updates, unless the client asks for a threshold");
+    config_add("shadow-index",
+               po::value<bool>(&_shadow_index)
+                   ->value_name("<bool>")
+                   ->default_value(false),
+               "detect new descriptors in host memory and read the DMA "
+               "write index register only if there are any");
+    config_add("persistent-shm",
+               po::value<bool>(&_persistent_shm)
+                   ->value_name("<bool>")
+                   ->default_value(false),
+               "keep the shared memory on exit, and re-attach to a kept one "
+               "of the same configuration instead of creating it anew");
+    config_add("huge-pages",
+               po::value<std::string>()->value_name("<mode>")->default_value(
+                   "none"),
+               "back the DMA buffers with huge pages to reduce the number of "
+               "SG entries and IOTLB misses: 'none' or 'thp' (transparent "
+               "huge pages, requires shmem_enabled=advise)");
 
     po::options_description cmdline_options("Allowed options");
     cmdline_options.add(generic).add(config);
@@ -169,6 +267,32 @@ private:
                           static_cast<severity_level>(log_syslog));
     }
 
+    if (_all_devices && vm.count("pci-addr") != 0u) {
+      throw ParametersException("pci-addr and all-devices are exclusive");
+    }
+
+    try {
+      _huge_pages = parse_huge_pages(vm["huge-pages"].as<std::string>());
+    } catch (std::exception const& e) {
+      throw ParametersException(e.what());
+    }
+    if (_monitor_interval_ms == 0) {
+      throw ParametersException("monitor-interval must be positive");
+    }
+    // clients wait for write index updates for at most 100 ms
+    if (_index_batch_us > 50000) {
+      throw ParametersException("index-batch-window must not exceed 50 ms");
+    }
+    if (_index_batch_desc == 0) {
+      throw ParametersException("index-batch-desc must be positive");
+    }
+
+    if (_huge_pages == HugePages::Size2M || _huge_pages == HugePages::Size1G) {
+      // POSIX shared memory lives on tmpfs, which cannot use hugetlbfs pages
+      throw ParametersException(
+          "explicit huge pages cannot back a shared memory, use 'thp'");
+    }
+
     if (vm.count("pci-addr") != 0u) {
       _pci_addr = vm["pci-addr"].as<pci_addr>();
       _dev_autodetect = false;
@@ -188,9 +312,20 @@ private:
 
   bool _dev_autodetect = true;
   pci_addr _pci_addr = {};
+  bool _all_devices = false;
   std::string _shm;
   size_t _data_buffer_size_exp;
   size_t _desc_buffer_size_exp;
   std::string _exec;
   bool _archivable_data;
+  bool _lockfree_index;
+  bool _shadow_index;
+  HugePages _huge_pages = HugePages::None;
+  std::string _monitor_uri;
+  unsigned _monitor_interval_ms;
+  bool _live_stats;
+  unsigned _poll_interval_us;
+  unsigned _index_batch_us;
+  uint64_t _index_batch_desc;
+  bool _persistent_shm;
 };
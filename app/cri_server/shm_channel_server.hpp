@@ -3,17 +3,32 @@
 #pragma once
 
 #include "cri_channel.hpp"
+#include "LiveStats.hpp"
+#include "MemoryPolicy.hpp"
+#include "Monitor.hpp"
 #include "log.hpp"
 #include "shm_channel.hpp"
 #include "shm_device.hpp"
+#include "shm_persistent.hpp"
 #include <boost/date_time/posix_time/posix_time_types.hpp>
 #include <boost/interprocess/managed_shared_memory.hpp>
 #include <boost/interprocess/sync/scoped_lock.hpp>
+#include <chrono>
 #include <cstdint>
 #include <string>
 
 namespace ip = boost::interprocess;
 
+// Batching of write index updates. A client request for the write index is
+// held back until the client's threshold or, if it has none, desc new
+// descriptors are available, but at most for the window. In lock-free mode,
+// the index is published under the same conditions. A window of zero
+// disables batching.
+struct index_batch_policy {
+  std::chrono::microseconds window{0};
+  uint64_t desc = 1;
+};
+
 template <typename T_DESC, typename T_DATA> class shm_channel_server {
 
 public:
@@ -22,21 +37,45 @@ public:
                      size_t index,
                      cri::cri_channel* cri_channel,
                      size_t data_buffer_size_exp,
-                     size_t desc_buffer_size_exp)
+                     size_t desc_buffer_size_exp,
+                     bool lockfree = false,
+                     bool shadow_index = false,
+                     int numa_node = -1,
+                     HugePages huge_pages = HugePages::None,
+                     index_batch_policy index_batch = {},
+                     bool reattach = false)
       : m_shm(shm), m_shm_dev(shm_dev), m_index(index),
-        m_cri_channel(cri_channel),
+        m_cri_channel(cri_channel), m_lockfree(lockfree),
+        m_numa_node(numa_node), m_huge_pages(huge_pages),
+        m_index_batch(index_batch),
         m_data_buffer_size_exp(data_buffer_size_exp),
         m_desc_buffer_size_exp(desc_buffer_size_exp) {
 
-    // allocate buffers
-    void* data_buffer_raw = alloc_buffer(data_buffer_size_exp, data_item_size);
-    void* desc_buffer_raw = alloc_buffer(desc_buffer_size_exp, desc_item_size);
-
-    // constuct channel exchange object in shared memory
     std::string channel_name = "shm_channel_" + std::to_string(m_index);
-    m_shm_ch = m_shm->construct<shm_channel>(channel_name.c_str())(
-        m_shm, data_buffer_raw, data_buffer_size_exp, sizeof(T_DATA),
-        desc_buffer_raw, desc_buffer_size_exp, sizeof(T_DESC));
+    void* data_buffer_raw = nullptr;
+    void* desc_buffer_raw = nullptr;
+    if (reattach) {
+      // reuse the buffers of a persistent segment, whose pages already
+      // exist and need not be zeroed again when they are pinned for DMA
+      m_shm_ch = renew_shm_channel(m_shm, channel_name);
+      data_buffer_raw = m_shm_ch->data_buffer_ptr(m_shm);
+      desc_buffer_raw = m_shm_ch->desc_buffer_ptr(m_shm);
+      apply_policy(data_buffer_raw,
+                   (UINT64_C(1) << data_buffer_size_exp) * data_item_size);
+      apply_policy(desc_buffer_raw,
+                   (UINT64_C(1) << desc_buffer_size_exp) * desc_item_size);
+    } else {
+      // allocate buffers
+      data_buffer_raw = alloc_buffer(data_buffer_size_exp, data_item_size);
+      desc_buffer_raw = alloc_buffer(desc_buffer_size_exp, desc_item_size);
+
+      // constuct channel exchange object in shared memory
+      m_shm_ch = m_shm->construct<shm_channel>(channel_name.c_str())(
+          m_shm, data_buffer_raw, data_buffer_size_exp, sizeof(T_DATA),
+          desc_buffer_raw, desc_buffer_size_exp, sizeof(T_DESC));
+    }
+    m_shm_ch->set_lockfree(m_lockfree);
+    m_shm_ch->set_index_batch_us(m_index_batch.window.count());
 
     // initialize buffer info
     T_DATA* data_buffer = reinterpret_cast<T_DATA*>(data_buffer_raw);
@@ -56,11 +95,24 @@ public:
     m_cri_channel->init_dma(data_buffer_raw, data_buffer_size_exp + 0,
                             desc_buffer_raw, desc_buffer_size_exp + 5);
     m_dma_transfer_size = m_cri_channel->dma()->dma_transfer_size();
+    L_(debug) << "channel " << m_index << " data buffer: "
+              << m_cri_channel->dma()->data_buffer_info();
+    m_cri_channel->dma()->set_shadow_index(shadow_index);
+
+    if (cbm::LiveStats::Enabled()) {
+      m_live = true;
+      m_live_microslices = cbm::LiveStats::Counter("cri_microslices");
+      m_live_bytes = cbm::LiveStats::Counter("cri_bytes");
+    }
 
     m_cri_channel->enable_readout();
   }
 
   ~shm_channel_server() {
+    if (m_lockfree) {
+      m_shm_ch->set_lockfree_eof(true);
+      publish_write_index();
+    }
     try {
       ip::scoped_lock<ip::interprocess_mutex> lock(m_shm_dev->m_mutex);
       update_write_index(lock);
@@ -73,11 +125,26 @@ public:
     // TODO destroy channel object and deallocate buffers if it is worth to do
   }
 
+  // Alignment of the buffers in the shared memory. With huge pages, the
+  // buffers start on a huge page boundary, so that they are fully covered by
+  // huge pages and the DMA engine gets one SG entry per huge page or less.
+  static size_t buffer_alignment(HugePages huge_pages) {
+    constexpr size_t huge_page_size = UINT64_C(1) << 21;
+    return huge_pages == HugePages::None
+               ? static_cast<size_t>(sysconf(_SC_PAGESIZE))
+               : huge_page_size;
+  }
+
   bool check_pending_req(ip::scoped_lock<ip::interprocess_mutex>& lock) {
     assert(lock); // ensure mutex is really owned
-    return m_shm_ch->req_read_index(lock) || m_shm_ch->req_write_index(lock);
+    return m_shm_ch->req_read_index(lock) ||
+           (m_shm_ch->req_write_index(lock) && !m_req_deferred);
   }
 
+  // Whether a write index request is held back for batching, to be checked
+  // again after the poll interval.
+  bool deferred_req() const { return m_req_deferred; }
+
   void try_handle_req(ip::scoped_lock<ip::interprocess_mutex>& lock) {
     assert(lock); // ensure mutex is really owned
 
@@ -85,6 +152,7 @@ public:
       DualIndex read_index = m_shm_ch->read_index(lock);
       // reset req before releasing lock ensures not to miss last req
       m_shm_ch->set_req_read_index(lock, false);
+      m_read_index = read_index;
       lock.unlock();
       L_(trace) << "updating read_index: data " << read_index.data << " desc "
                 << read_index.desc;
@@ -96,26 +164,194 @@ public:
       lock.lock();
     }
 
-    if (m_shm_ch->req_write_index(lock)) {
+    if (m_shm_ch->req_write_index(lock) && write_index_due(lock)) {
       update_write_index(lock);
     }
   }
 
+  // Lock-free mode: publish the DMA write index and apply the minimum read
+  // index of the primary clients. Returns true if any of them has changed.
+  bool poll() {
+    assert(m_lockfree);
+    bool changed = publish_write_index();
+
+    DualIndex read_index = m_shm_ch->lockfree_read_index(m_read_index);
+    if (!(read_index == m_read_index)) {
+      m_read_index = read_index;
+      L_(trace) << "updating read_index: data " << read_index.data << " desc "
+                << read_index.desc;
+      m_cri_channel->dma()->set_sw_read_pointers(
+          hw_pointer(read_index.data, m_data_buffer_size_exp, data_item_size,
+                     m_dma_transfer_size),
+          hw_pointer(read_index.desc, m_desc_buffer_size_exp, desc_item_size));
+      m_shm_ch->lockfree_retained_index().publish(read_index);
+      changed = true;
+    }
+    return changed;
+  }
+
+  // Reset the hardware counters to start a monitoring interval.
+  void reset_counters() {
+    m_cri_channel->set_perf_cnt(false, true);
+    m_cri_channel->set_perf_gtx_cnt(false, true);
+  }
+
+  // Queue the hardware counters of the last interval and the buffer
+  // occupancies (as of the last index exchange) as a metric.
+  void queue_metrics(cbm::Monitor& monitor,
+                     const std::string& hostname,
+                     const std::string& cri) {
+    cri::cri_channel::ch_snapshot_t snapshot = m_cri_channel->get_snapshot();
+    const auto& perf = snapshot.perf;
+    const auto& perf_gtx = snapshot.perf_gtx;
+
+    cbm::MetricFieldSet fields{
+        {"enable", snapshot.ready_for_data},
+        {"data_used", m_write_index.data - m_read_index.data},
+        {"desc_used", m_write_index.desc - m_read_index.desc},
+        {"data_fill",
+         static_cast<double>(m_write_index.data - m_read_index.data) /
+             static_cast<double>(UINT64_C(1) << m_data_buffer_size_exp)},
+        {"desc_fill",
+         static_cast<double>(m_write_index.desc - m_read_index.desc) /
+             static_cast<double>(UINT64_C(1) << m_desc_buffer_size_exp)}};
+
+    // skip counters that have overflowed (or not yet counted)
+    if (perf.cycles != 0xFFFFFFFF && perf.cycles != 0) {
+      auto cycles = static_cast<double>(perf.cycles);
+      fields.emplace_back("dma_trans",
+                          static_cast<double>(perf.dma_trans) / cycles);
+      fields.emplace_back("dma_stall",
+                          static_cast<double>(perf.dma_stall) / cycles);
+      fields.emplace_back("dma_busy",
+                          static_cast<double>(perf.dma_busy) / cycles);
+      fields.emplace_back("data_buf_stall",
+                          static_cast<double>(perf.data_buf_stall) / cycles);
+      fields.emplace_back("desc_buf_stall",
+                          static_cast<double>(perf.desc_buf_stall) / cycles);
+      fields.emplace_back("rate", static_cast<double>(perf.microslice_cnt) /
+                                      (cycles / cri::pkt_clk));
+    }
+    if (perf_gtx.cycles != 0xFFFFFFFF && perf_gtx.cycles != 0) {
+      auto cycles = static_cast<double>(perf_gtx.cycles);
+      double mc_trans = static_cast<double>(perf_gtx.mc_trans) / cycles;
+      fields.emplace_back("mc_trans", mc_trans);
+      fields.emplace_back("mc_stall",
+                          static_cast<double>(perf_gtx.mc_stall) / cycles);
+      fields.emplace_back("mc_busy",
+                          static_cast<double>(perf_gtx.mc_busy) / cycles);
+      fields.emplace_back("throughput", mc_trans * cri::gtx_clk * 8);
+    }
+
+    monitor.QueueMetric("cri_ch_status",
+                        {{"host", hostname},
+                         {"cri", cri},
+                         {"ch", std::to_string(m_index)}},
+                        std::move(fields));
+  }
+
 private:
+  // Lock-free mode: publish the current DMA write index if it has changed
+  // and the batch is complete. Returns true if the DMA write index has
+  // changed.
+  bool publish_write_index() {
+    auto const steady_now = std::chrono::steady_clock::now();
+    auto now = to_shm_time(boost::posix_time::microsec_clock::universal_time());
+    bool changed = fetch_write_index();
+    if (!(m_write_index == m_published_index) && publish_due(steady_now)) {
+      m_shm_ch->lockfree_write_index().publish(m_write_index, now);
+      m_published_index = m_write_index;
+      m_published_time = steady_now;
+    }
+    m_shm_ch->set_lockfree_polled(now);
+    return changed;
+  }
+
+  bool publish_due(std::chrono::steady_clock::time_point now) {
+    return m_index_batch.window.count() == 0 || m_shm_ch->lockfree_eof() ||
+           m_write_index.desc - m_published_index.desc >= m_index_batch.desc ||
+           now - m_published_time >= m_index_batch.window;
+  }
+
+  // Check whether the pending write index request is to be answered now,
+  // otherwise keep it deferred (see index_batch_policy).
+  bool write_index_due(ip::scoped_lock<ip::interprocess_mutex>& lock) {
+    if (m_index_batch.window.count() == 0) {
+      return true;
+    }
+    auto const now = std::chrono::steady_clock::now();
+    if (!m_req_deferred) {
+      m_req_deferred = true;
+      m_req_since = now;
+    }
+    if (now - m_req_since >= m_index_batch.window) {
+      return true;
+    }
+    DualIndex threshold = m_shm_ch->write_index_threshold(lock);
+    if (threshold == DualIndex{0, 0}) {
+      threshold.desc = m_answered_index.desc + m_index_batch.desc;
+    }
+    lock.unlock();
+    fetch_write_index();
+    lock.lock();
+    return reaches_threshold(m_write_index, threshold);
+  }
+
+  // Read the DMA write index into m_write_index. Returns true if it has
+  // changed. The data index is only derived from a new descriptor, as
+  // consumed descriptors may have been cleared (shadow index mode).
+  bool fetch_write_index() {
+    auto* dma = m_cri_channel->dma();
+    uint64_t desc = dma->get_desc_index();
+    auto stats = dma->index_stats();
+    m_shm_ch->set_index_stats(stats.polls, stats.register_reads);
+    if (desc == m_write_index.desc) {
+      return false;
+    }
+    if (m_live) {
+      record_live_stats(m_write_index.desc, desc);
+    }
+    m_write_index.desc = desc;
+    m_write_index.data = m_desc_buffer_view->at(desc - 1).offset +
+                         m_desc_buffer_view->at(desc - 1).size;
+    return true;
+  }
+
+  // Record the microslices of the new descriptors in the live statistics.
+  void record_live_stats(uint64_t begin, uint64_t end) {
+    // e.g. after re-attaching, only the descriptors in the buffer exist
+    uint64_t const desc_buffer_size = UINT64_C(1) << m_desc_buffer_size_exp;
+    if (end - begin > desc_buffer_size) {
+      begin = end - desc_buffer_size;
+    }
+    uint64_t bytes = 0;
+    for (uint64_t i = begin; i < end; ++i) {
+      const T_DESC& desc = m_desc_buffer_view->at(i);
+      if (desc.eq_id != m_live_eq_id) {
+        m_live_eq_id = desc.eq_id;
+        m_live_sizes = cbm::LiveStats::Histogram("microslice_size", desc.eq_id);
+      }
+      m_live_sizes.Record(desc.size);
+      bytes += desc.size;
+    }
+    m_live_microslices.Add(end - begin);
+    m_live_bytes.Add(bytes);
+  }
+
   void update_write_index(ip::scoped_lock<ip::interprocess_mutex>& lock) {
     m_shm_ch->set_req_write_index(lock, false);
     lock.unlock();
     // fill write indices
     TimedDualIndex write_index;
-    write_index.index.desc = m_cri_channel->dma()->get_desc_index();
-    write_index.index.data =
-        m_desc_buffer_view->at(write_index.index.desc - 1).offset +
-        m_desc_buffer_view->at(write_index.index.desc - 1).size;
+    fetch_write_index();
+    write_index.index = m_write_index;
     write_index.updated = boost::posix_time::microsec_clock::universal_time();
     L_(trace) << "fetching write_index: data " << write_index.index.data
               << " desc " << write_index.index.desc;
     lock.lock();
     m_shm_ch->set_write_index(lock, write_index);
+    m_req_deferred = false;
+    m_answered_index = write_index.index;
   }
 
   // Convert index into byte pointer for hardware
@@ -138,7 +374,26 @@ private:
   void* alloc_buffer(size_t size_exp, size_t item_size) {
     size_t bytes = (UINT64_C(1) << size_exp) * item_size;
     L_(trace) << "allocating shm buffer of " << bytes << " bytes";
-    return m_shm->allocate_aligned(bytes, sysconf(_SC_PAGESIZE));
+    void* buffer =
+        m_shm->allocate_aligned(bytes, buffer_alignment(m_huge_pages));
+    // bind to the device's node and request huge pages before the pages are
+    // touched (pinned)
+    apply_policy(buffer, bytes);
+    return buffer;
+  }
+
+  void apply_policy(void* buffer, size_t bytes) {
+    if (m_numa_node >= 0 || m_huge_pages != HugePages::None) {
+      MemoryPolicy policy;
+      policy.numa_node = m_numa_node;
+      policy.huge_pages = m_huge_pages;
+      try {
+        apply_memory_policy(buffer, bytes, policy);
+      } catch (std::exception const& e) {
+        L_(warning) << "cannot apply memory policy (" << policy.description()
+                    << ") to shm buffer: " << e.what();
+      }
+    }
   }
 
   ip::managed_shared_memory* m_shm;
@@ -146,6 +401,30 @@ private:
   size_t m_index;
   cri::cri_channel* m_cri_channel;
   size_t m_dma_transfer_size;
+  bool m_lockfree;
+  int m_numa_node;
+  HugePages m_huge_pages;
+  index_batch_policy m_index_batch;
+
+  // last fetched write index and applied read index
+  DualIndex m_write_index{0, 0};
+  DualIndex m_read_index{0, 0};
+
+  // write index last given to the client and time of the pending deferred
+  // request (locked mode) or of the last publication (lock-free mode)
+  DualIndex m_answered_index{0, 0};
+  bool m_req_deferred = false;
+  std::chrono::steady_clock::time_point m_req_since{};
+  DualIndex m_published_index{0, 0};
+  std::chrono::steady_clock::time_point m_published_time{};
+
+  // live statistics of the received microslices (see cbm::LiveStats), with
+  // the size histogram of the eq_id of the last descriptor
+  bool m_live = false;
+  cbm::LiveCounter m_live_microslices;
+  cbm::LiveCounter m_live_bytes;
+  int32_t m_live_eq_id = -1;
+  cbm::LiveHistogram m_live_sizes;
 
   shm_channel* m_shm_ch;
   std::unique_ptr<RingBufferView<T_DATA>> m_data_buffer_view;
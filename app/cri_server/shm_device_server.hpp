@@ -4,24 +4,31 @@
 
 #include "cri_channel.hpp"
 #include "cri_device.hpp"
+#include "Monitor.hpp"
+#include "System.hpp"
+#include "ThreadContainer.hpp"
 #include "log.hpp"
 #include "shm_channel_server.hpp"
 #include "shm_device.hpp"
+#include <algorithm>
 #include <boost/date_time/posix_time/posix_time_types.hpp>
 #include <boost/interprocess/managed_shared_memory.hpp>
 #include <boost/interprocess/sync/interprocess_condition.hpp>
 #include <boost/interprocess/sync/interprocess_mutex.hpp>
 #include <boost/interprocess/sync/scoped_lock.hpp>
+#include <chrono>
 #include <csignal>
 #include <cstdint>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 
 namespace ip = boost::interprocess;
 
-template <typename T_DESC, typename T_DATA> class shm_device_server {
+template <typename T_DESC, typename T_DATA>
+class shm_device_server : public ThreadContainer {
 
 public:
   using shm_channel_server_type = shm_channel_server<T_DESC, T_DATA>;
@@ -30,9 +37,23 @@ public:
                     std::string shm_identifier,
                     size_t data_buffer_size_exp,
                     size_t desc_buffer_size_exp,
-                    volatile std::sig_atomic_t* signal_status)
+                    volatile std::sig_atomic_t* signal_status,
+                    bool lockfree = false,
+                    std::chrono::microseconds poll_interval =
+                        std::chrono::microseconds(10),
+                    bool shadow_index = false,
+                    int numa_node = -1,
+                    HugePages huge_pages = HugePages::None,
+                    cbm::Monitor* monitor = nullptr,
+                    std::chrono::milliseconds monitor_interval =
+                        std::chrono::seconds(1),
+                    index_batch_policy index_batch = {},
+                    bool persistent = false)
       : m_cri(cri), m_shm_identifier(std::move(shm_identifier)),
-        m_signal_status(signal_status) {
+        m_signal_status(signal_status), m_lockfree(lockfree),
+        m_persistent(persistent),
+        m_poll_interval(poll_interval), m_numa_node(numa_node),
+        m_monitor(monitor), m_monitor_interval(monitor_interval) {
 
     std::vector<cri::cri_channel*> cri_channels = m_cri->channels();
 
@@ -46,35 +67,68 @@ public:
                        std::end(cri_channels));
     L_(info) << "enabled cri channels detected: " << cri_channels.size();
 
-    // create a big enough shared memory segment
-    size_t shm_size = ((UINT64_C(1) << data_buffer_size_exp) * sizeof(T_DATA) +
-                       (UINT64_C(1) << desc_buffer_size_exp) * sizeof(T_DESC) +
-                       2 * sysconf(_SC_PAGESIZE) + sizeof(shm_channel)) *
-                          cri_channels.size() +
-                      sizeof(shm_device) + 1000;
-    m_shm = std::make_unique<ip::managed_shared_memory>(
-        ip::create_only, m_shm_identifier.c_str(), shm_size);
+    // re-attach to the segment of a previous server, if kept
+    if (m_persistent) {
+      m_shm = open_persistent_shm(m_shm_identifier, cri_channels.size(),
+                                  data_buffer_size_exp, desc_buffer_size_exp,
+                                  sizeof(T_DATA), sizeof(T_DESC));
+    }
+    const bool reattach = m_shm != nullptr;
 
-    // constuct device exchange object in sharde memory
-    std::string device_name = "shm_device";
-    m_shm_dev = m_shm->construct<shm_device>(device_name.c_str())();
+    if (reattach) {
+      L_(info) << "re-attaching to persistent shared memory "
+               << m_shm_identifier;
+      m_shm_dev = renew_shm_device(m_shm.get());
+    } else {
+      if (m_persistent) {
+        // replace a kept segment of a different configuration
+        ip::shared_memory_object::remove(m_shm_identifier.c_str());
+      }
+      // create a big enough shared memory segment
+      size_t alignment = shm_channel_server_type::buffer_alignment(huge_pages);
+      size_t shm_size =
+          ((UINT64_C(1) << data_buffer_size_exp) * sizeof(T_DATA) +
+           (UINT64_C(1) << desc_buffer_size_exp) * sizeof(T_DESC) +
+           2 * alignment + sizeof(shm_channel)) *
+              cri_channels.size() +
+          sizeof(shm_device) + 1000;
+      m_shm = std::make_unique<ip::managed_shared_memory>(
+          ip::create_only, m_shm_identifier.c_str(), shm_size);
+
+      // constuct device exchange object in sharde memory
+      std::string device_name = "shm_device";
+      m_shm_dev = m_shm->construct<shm_device>(device_name.c_str())();
+    }
+    m_shm_dev->set_numa_node(m_numa_node);
 
     // create channels for active cri channels
     size_t idx = 0;
     for (cri::cri_channel* channel : cri_channels) {
       m_shm_ch_vec.push_back(std::make_unique<shm_channel_server_type>(
           m_shm.get(), m_shm_dev, idx, channel, data_buffer_size_exp,
-          desc_buffer_size_exp));
+          desc_buffer_size_exp, m_lockfree, shadow_index, m_numa_node,
+          huge_pages, index_batch, reattach));
       ++idx;
       m_shm_dev->inc_num_channels();
     }
   }
 
   ~shm_device_server() {
-    ip::shared_memory_object::remove(m_shm_identifier.c_str());
+    if (!m_persistent) {
+      ip::shared_memory_object::remove(m_shm_identifier.c_str());
+    }
   }
 
+  // Serve requests in the calling thread, which is bound to the device's
+  // NUMA node (if known).
   void run() {
+    if (m_numa_node >= 0) {
+      set_node(m_numa_node);
+    }
+    if (m_lockfree) {
+      run_lockfree();
+      return;
+    }
     if (!m_run) { // don't start twice
       m_run = true;
       L_(info) << "cri server started and running";
@@ -86,15 +140,23 @@ public:
         // INFO: need to loop over all individual requests,
         // alternative would be global request cue.
         bool pending_req = false;
+        bool deferred_req = false;
         for (const std::unique_ptr<shm_channel_server_type>& shm_ch :
              m_shm_ch_vec) {
           pending_req |= shm_ch->check_pending_req(lock);
+          deferred_req |= shm_ch->deferred_req();
         }
         if (!pending_req) {
-          // sleep if nothing is pending
-          auto const abs_time =
-              boost::posix_time::microsec_clock::universal_time() +
+          // sleep if nothing is pending, but check deferred (batched)
+          // requests again after the poll interval
+          boost::posix_time::time_duration timeout =
               boost::posix_time::milliseconds(100);
+          if (deferred_req) {
+            timeout = boost::posix_time::microseconds(
+                std::max<int64_t>(m_poll_interval.count(), 1));
+          }
+          auto const abs_time =
+              boost::posix_time::microsec_clock::universal_time() + timeout;
           m_shm_dev->m_cond_req.timed_wait(lock, abs_time);
         }
         if (*m_signal_status != 0) {
@@ -106,6 +168,34 @@ public:
              m_shm_ch_vec) {
           shm_ch->try_handle_req(lock);
         }
+        report_metrics();
+      }
+    }
+  }
+
+  // Poll the hardware and the published client read indices. No lock is
+  // taken, so clients never wait for the server or for each other.
+  void run_lockfree() {
+    if (!m_run) { // don't start twice
+      m_run = true;
+      L_(info) << "cri server started and running (lock-free index exchange)";
+      while (m_run) {
+        bool changed = false;
+        for (const std::unique_ptr<shm_channel_server_type>& shm_ch :
+             m_shm_ch_vec) {
+          changed |= shm_ch->poll();
+        }
+        if (*m_signal_status != 0) {
+          stop();
+        }
+        report_metrics();
+        if (!changed) {
+          if (m_poll_interval.count() > 0) {
+            std::this_thread::sleep_for(m_poll_interval);
+          } else {
+            std::this_thread::yield();
+          }
+        }
       }
     }
   }
@@ -113,6 +203,46 @@ public:
   void stop() { m_run = false; }
 
 private:
+  // Publish the hardware counters and buffer occupancies periodically. This
+  // runs in the server thread between requests, so the channel state needs
+  // no synchronization, and the counters are read as one snapshot per
+  // channel to keep the register accesses few.
+  void report_metrics() {
+    if (m_monitor == nullptr) {
+      return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (now < m_next_report) {
+      return;
+    }
+    bool first = m_next_report == std::chrono::steady_clock::time_point();
+    m_next_report = now + m_monitor_interval;
+    if (first) {
+      // start the first interval now
+      m_hostname = fles::system::current_hostname();
+      m_devinfo = m_cri->print_devinfo();
+      m_cri->set_perf_cnt(false, true);
+      for (const auto& shm_ch : m_shm_ch_vec) {
+        shm_ch->reset_counters();
+      }
+      return;
+    }
+
+    cri::cri_device::dev_perf_t dev_perf = m_cri->get_perf();
+    if (dev_perf.cycles != 0xFFFFFFFF && dev_perf.cycles != 0) {
+      auto cycles = static_cast<double>(dev_perf.cycles);
+      m_monitor->QueueMetric(
+          "cri_dev_status", {{"host", m_hostname}, {"cri", m_devinfo}},
+          {{"pci_trans", static_cast<double>(dev_perf.pci_trans) / cycles},
+           {"pci_stall", static_cast<double>(dev_perf.pci_stall) / cycles},
+           {"pci_busy", static_cast<double>(dev_perf.pci_busy) / cycles},
+           {"pci_max_stall", dev_perf.pci_max_stall}});
+    }
+    for (const auto& shm_ch : m_shm_ch_vec) {
+      shm_ch->queue_metrics(*m_monitor, m_hostname, m_devinfo);
+    }
+  }
+
   std::string print_shm_info() {
     std::stringstream ss;
     ss << "SHM INFO" << std::endl
@@ -133,6 +263,16 @@ private:
   std::unique_ptr<ip::managed_shared_memory> m_shm;
   shm_device* m_shm_dev = nullptr;
   std::vector<std::unique_ptr<shm_channel_server_type>> m_shm_ch_vec;
+  bool m_lockfree;
+  bool m_persistent;
+  std::chrono::microseconds m_poll_interval;
+  int m_numa_node;
+
+  cbm::Monitor* m_monitor;
+  std::chrono::milliseconds m_monitor_interval;
+  std::chrono::steady_clock::time_point m_next_report{};
+  std::string m_hostname;
+  std::string m_devinfo;
 
   bool m_run = false;
 };
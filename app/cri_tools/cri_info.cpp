@@ -28,6 +28,7 @@ int main() {
       try {
         cris.push_back(std::make_unique<cri_device>(i));
         std::cout << "Address: " << cris.back()->print_devinfo() << std::endl;
+        std::cout << "NUMA node: " << cris.back()->numa_node() << std::endl;
         std::cout << "Hardware channels: "
                   << static_cast<unsigned>(cris.back()->number_of_hw_channels())
                   << std::endl;
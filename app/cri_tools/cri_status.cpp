@@ -8,6 +8,9 @@
 #include "cri.hpp"
 #include "device_operator.hpp"
 #include "fles_ipc/System.hpp"
+#include "shm_channel.hpp"
+#include "shm_device.hpp"
+#include <boost/interprocess/managed_shared_memory.hpp>
 #include <boost/program_options.hpp>
 #include <chrono>
 #include <csignal>
@@ -43,8 +46,16 @@ static void s_catch_signals() {
 
 namespace po = boost::program_options;
 
+// index access statistics of the channels of a cri_server shared memory
+struct shm_index_stats_t {
+  shm_channel* channel;
+  uint64_t polls;
+  uint64_t reads;
+};
+
 int main(int argc, char* argv[]) {
   std::string monitor_uri;
+  std::string shm_identifier;
   bool detailed_stats = false;
   po::options_description desc("Allowed options");
   auto desc_add = desc.add_options();
@@ -58,6 +69,10 @@ int main(int argc, char* argv[]) {
                ->implicit_value("influx1:login:8086:cri_status"),
            "publish CRI status to InfluxDB (or \"file:cout\" for "
            "console output)");
+  desc_add("shm,s",
+           po::value<std::string>(&shm_identifier)->value_name("<id>"),
+           "also show the DMA index access statistics of the cri_server "
+           "using the given shared memory");
 
   po::variables_map vm;
   po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -82,6 +97,10 @@ int main(int argc, char* argv[]) {
            "data_s:   stall from full data buffer (ratio)\n"
            "desc_s:   stall from full desc buffer (ratio)\n"
            "rate:     ms processing rate (Hz*)\n"
+           "Per shared memory channel counters (--shm):\n"
+           "polls:    DMA write index requests by cri_server (Hz)\n"
+           "reads:    DMA write index register reads (Hz)\n"
+           "saved:    register reads saved by shadow index mode (ratio)\n"
            "* Based on the assumption that the PCIe clock is exactly 100 "
            "MHz.\n"
            "  This may not be true in case of PCIe spread-spectrum "
@@ -122,6 +141,26 @@ int main(int argc, char* argv[]) {
       }
     }
 
+    // attach to cri_server shared memory
+    std::unique_ptr<ip::managed_shared_memory> shm;
+    std::vector<shm_index_stats_t> shm_stats;
+    if (!shm_identifier.empty()) {
+      shm = std::make_unique<ip::managed_shared_memory>(
+          ip::open_only, shm_identifier.c_str());
+      shm_device* shm_dev = shm->find<shm_device>("shm_device").first;
+      if (shm_dev == nullptr) {
+        throw std::runtime_error("Unable to find object shm_device");
+      }
+      for (size_t i = 0; i < shm_dev->num_channels(); ++i) {
+        std::string channel_name = "shm_channel_" + std::to_string(i);
+        shm_channel* ch = shm->find<shm_channel>(channel_name.c_str()).first;
+        if (ch == nullptr) {
+          throw std::runtime_error("Unable to find object " + channel_name);
+        }
+        shm_stats.push_back({ch, ch->index_polls(), ch->index_reads()});
+      }
+    }
+
     std::cout << "Starting measurements" << std::endl;
     if (console && clear_screen) {
       std::cout << "\x1B[2J" << std::flush;
@@ -194,16 +233,18 @@ int main(int argc, char* argv[]) {
 
         std::stringstream ss;
         for (size_t i = 0; i < num_channels; ++i) {
-          cri::cri_channel::ch_perf_t perf = channels.at(i)->get_perf();
-          cri::cri_channel::ch_perf_gtx_t perf_gtx =
-              channels.at(i)->get_perf_gtx();
-          bool ready_for_data = channels.at(i)->get_ready_for_data();
+          // capture and read all counters of the channel at once
+          cri::cri_channel::ch_snapshot_t snapshot =
+              channels.at(i)->get_snapshot();
+          const cri::cri_channel::ch_perf_t& perf = snapshot.perf;
+          const cri::cri_channel::ch_perf_gtx_t& perf_gtx = snapshot.perf_gtx;
+          bool ready_for_data = snapshot.ready_for_data;
 
           // check overflow
           if (perf.cycles == 0xFFFFFFFF || perf_gtx.cycles == 0xFFFFFFFF) {
             if (console) {
               ss << std::setw(2) << j << "/" << i << "  ";
-              ss << std::setw(8) << channels.at(i)->data_source() << "  ";
+              ss << std::setw(8) << snapshot.data_source << "  ";
               ss << "stats counter overflow";
               ss << "\n";
             }
@@ -226,7 +267,7 @@ int main(int argc, char* argv[]) {
 
           if (console) {
             ss << std::setw(1) << j << "/" << i << "  ";
-            ss << std::setw(8) << channels.at(i)->data_source() << "  ";
+            ss << std::setw(8) << snapshot.data_source << "  ";
             ss << std::setw(2) << ready_for_data << "  ";
             // perf counters
             ss << std::setprecision(5);
@@ -248,7 +289,7 @@ int main(int argc, char* argv[]) {
                 {{"host", hostname},
                  {"cri", cri->print_devinfo()},
                  {"ch", std::to_string(i)}},
-                {{"data_src", static_cast<int>(channels.at(i)->data_source())},
+                {{"data_src", static_cast<int>(snapshot.data_source)},
                  {"enable", ready_for_data},
                  {"throughput", mc_throughput},
                  {"rate", microslice_rate},
@@ -270,6 +311,45 @@ int main(int argc, char* argv[]) {
 
         ++j;
       }
+      if (!shm_stats.empty()) {
+        if (console) {
+          std::cout << " shm ch     polls/s     reads/s     saved\n";
+        }
+        std::stringstream ss;
+        for (size_t i = 0; i < shm_stats.size(); ++i) {
+          auto& stats = shm_stats[i];
+          uint64_t polls = stats.channel->index_polls();
+          uint64_t reads = stats.channel->index_reads();
+          float interval_s = interval_ms / 1000.0;
+          float poll_rate = (polls - stats.polls) / interval_s;
+          float read_rate = (reads - stats.reads) / interval_s;
+          float saved = poll_rate > 0 ? 1 - read_rate / poll_rate : 0;
+          stats.polls = polls;
+          stats.reads = reads;
+
+          if (console) {
+            ss << std::setw(7) << i << "  ";
+            ss << std::setprecision(5);
+            ss << std::setw(10) << poll_rate << "  ";
+            ss << std::setw(10) << read_rate << "  ";
+            ss << std::setprecision(3);
+            ss << std::setw(8) << saved * 100 << "\n";
+          }
+          if (monitor) {
+            monitor->QueueMetric("shm_index_status",
+                                 {{"host", hostname},
+                                  {"shm", shm_identifier},
+                                  {"ch", std::to_string(i)}},
+                                 {{"poll_rate", poll_rate},
+                                  {"read_rate", read_rate},
+                                  {"saved", saved}});
+          }
+        }
+        if (console) {
+          std::cout << ss.str() << std::endl;
+        }
+      }
+
       // sleep will be canceled by signals (which is handy in our case)
       // https://gcc.gnu.org/bugzilla/show_bug.cgi?id=66803
       ++loop_cnt;
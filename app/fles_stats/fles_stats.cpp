@@ -0,0 +1,215 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+//
+// Read the live statistics segments (see cbm::LiveStats) published by
+// flesnet, tsclient and cri_server with the live-stats option. Prints the
+// counters with their rates and the histogram summaries at a given interval,
+// and optionally exports them to a monitoring sink.
+
+#include "LiveStats.hpp"
+#include "Monitor.hpp"
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace po = boost::program_options;
+
+namespace {
+
+volatile std::sig_atomic_t signal_status = 0;
+
+void signal_handler(int sig) { signal_status = sig; }
+
+std::string hex_key(uint32_t key) {
+  std::ostringstream ss;
+  ss << "0x" << std::hex << std::setw(4) << std::setfill('0') << key;
+  return ss.str();
+}
+
+void list_instances() {
+  for (const auto& instance : cbm::LiveStatsReader::List()) {
+    std::cout << instance;
+    try {
+      cbm::LiveStatsReader reader(instance);
+      if (!reader.Alive()) {
+        std::cout << " (terminated)";
+      }
+    } catch (std::exception const& e) {
+      std::cout << " (" << e.what() << ")";
+    }
+    std::cout << "\n";
+  }
+}
+
+// Reads the segment of an instance at each call, derives the counter rates
+// from the previous call and prints or exports the values.
+class Sampler {
+public:
+  Sampler(const std::string& instance, cbm::Monitor* monitor)
+      : reader_(instance), monitor_(monitor) {}
+
+  void sample() {
+    auto now = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(now - last_time_).count();
+    bool has_rate = !last_values_.empty() && seconds > 0.;
+
+    std::map<std::string, uint64_t> values;
+    cbm::MetricFieldSet fields;
+    if (monitor_ == nullptr) {
+      std::cout << reader_.Instance() << " (pid " << reader_.Pid()
+                << (reader_.Alive() ? "" : ", terminated") << ")\n";
+    }
+    for (const auto& counter : reader_.Counters()) {
+      values[counter.fName] = counter.fValue;
+      double rate = 0.;
+      if (has_rate) {
+        auto last = last_values_.find(counter.fName);
+        uint64_t previous = last == last_values_.end() ? 0 : last->second;
+        if (counter.fValue >= previous) {
+          rate = static_cast<double>(counter.fValue - previous) / seconds;
+        }
+      }
+      if (monitor_ != nullptr) {
+        fields.emplace_back(counter.fName, counter.fValue);
+        if (has_rate) {
+          fields.emplace_back(counter.fName + "_rate", rate);
+        }
+      } else {
+        std::cout << "  " << std::left << std::setw(32) << counter.fName
+                  << std::right << std::setw(20) << counter.fValue;
+        if (has_rate) {
+          std::cout << std::setw(16) << std::fixed << std::setprecision(1)
+                    << rate << " /s";
+        }
+        std::cout << "\n";
+      }
+    }
+
+    for (const auto& histogram : reader_.Histograms()) {
+      const auto& h = histogram.fHistogram;
+      if (monitor_ != nullptr) {
+        monitor_->QueueMetric("live_stats_histogram",
+                              {{"instance", reader_.Instance()},
+                               {"name", histogram.fName},
+                               {"key", hex_key(histogram.fKey)}},
+                              {{"value", h}});
+      } else if (h.Count() > 0) {
+        std::cout << "  " << histogram.fName << "[" << hex_key(histogram.fKey)
+                  << "]: count " << h.Count() << ", mean " << std::fixed
+                  << std::setprecision(1) << h.Mean() << ", p50 "
+                  << h.Percentile(0.5) << ", p99 " << h.Percentile(0.99)
+                  << ", max " << h.Max() << "\n";
+      }
+    }
+
+    if (monitor_ != nullptr && !fields.empty()) {
+      monitor_->QueueMetric("live_stats", {{"instance", reader_.Instance()}},
+                            std::move(fields));
+    }
+    std::cout << std::flush;
+    last_values_ = std::move(values);
+    last_time_ = now;
+  }
+
+private:
+  cbm::LiveStatsReader reader_;
+  cbm::Monitor* monitor_;
+  std::map<std::string, uint64_t> last_values_;
+  std::chrono::steady_clock::time_point last_time_;
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  std::signal(SIGINT, signal_handler);
+  std::signal(SIGTERM, signal_handler);
+
+  std::vector<std::string> instances;
+  double interval = 1.0;
+  uint64_t count = 0;
+  std::string monitor_uri;
+
+  po::options_description desc("Options");
+  auto desc_add = desc.add_options();
+  desc_add("help,h", "produce help message");
+  desc_add("instance",
+           po::value<std::vector<std::string>>(&instances)->multitoken(),
+           "instances to read (default: list the existing instances)");
+  desc_add("interval,i",
+           po::value<double>(&interval)->default_value(interval)->value_name(
+               "<s>"),
+           "interval between samples in seconds");
+  desc_add("count,n", po::value<uint64_t>(&count)->value_name("<n>"),
+           "stop after n samples (default: run until interrupted)");
+  desc_add("monitor,m",
+           po::value<std::string>(&monitor_uri)
+               ->value_name("<uri>")
+               ->implicit_value("influx1:login:8086:fles_stats"),
+           "export the samples to InfluxDB (or \"file:cout\" for console "
+           "output) instead of printing them");
+  po::positional_options_description pos;
+  pos.add("instance", -1);
+
+  try {
+    po::variables_map vm;
+    po::store(po::command_line_parser(argc, argv)
+                  .options(desc)
+                  .positional(pos)
+                  .run(),
+              vm);
+    po::notify(vm);
+    if (vm.count("help") != 0) {
+      std::cout << "Usage: " << argv[0] << " [options] [<instance> ...]\n"
+                << "Read the live statistics of flesnet, tsclient and "
+                   "cri_server.\n\n"
+                << desc;
+      return EXIT_SUCCESS;
+    }
+    if (interval <= 0.) {
+      throw std::runtime_error("interval must be positive");
+    }
+
+    if (instances.empty()) {
+      list_instances();
+      return EXIT_SUCCESS;
+    }
+
+    std::unique_ptr<cbm::Monitor> monitor;
+    if (!monitor_uri.empty()) {
+      monitor = std::make_unique<cbm::Monitor>(monitor_uri);
+    }
+    std::vector<std::unique_ptr<Sampler>> samplers;
+    for (const auto& instance : instances) {
+      samplers.push_back(std::make_unique<Sampler>(instance, monitor.get()));
+    }
+
+    auto next = std::chrono::steady_clock::now();
+    auto period = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::duration<double>(interval));
+    for (uint64_t n = 0; (count == 0 || n < count) && signal_status == 0;
+         ++n) {
+      if (n > 0) {
+        next += period;
+        std::this_thread::sleep_until(next);
+      }
+      for (auto& sampler : samplers) {
+        sampler->sample();
+      }
+    }
+  } catch (std::exception const& e) {
+    std::cerr << "FATAL: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
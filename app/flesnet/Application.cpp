@@ -1,31 +1,119 @@
 // Copyright 2012-2016 Jan de Cuveland <cmail@cuveland.de>
 
 #include "Application.hpp"
+#include "AllocationStats.hpp"
 #include "ChildProcessManager.hpp"
+#include "EventTrace.hpp"
 #include "FlesnetPatternGenerator.hpp"
+#include "LiveStats.hpp"
+#include "MicrosliceArchiveReplay.hpp"
+#include "ProfileLoadGenerator.hpp"
 #include "ItemDistributor.hpp"
+#include "Topology.hpp"
 #include "Utility.hpp"
 #include "log.hpp"
 #include "shm_channel_client.hpp"
 #include <boost/algorithm/string.hpp>
 #include <boost/thread/future.hpp>
 #include <boost/thread/thread.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
 #include <string>
+#include <unistd.h>
+
+namespace {
+// Log the duration of a startup stage and start timing the next one
+void log_startup_stage(const std::string& stage,
+                       std::chrono::steady_clock::time_point& begin) {
+  auto now = std::chrono::steady_clock::now();
+  L_(info) << "startup: " << stage << " in "
+           << std::chrono::duration_cast<std::chrono::milliseconds>(now -
+                                                                    begin)
+                  .count()
+           << " ms";
+  begin = now;
+}
+} // namespace
 
 Application::Application(Parameters const& par,
                          volatile sig_atomic_t* signal_status)
-    : par_(par), signal_status_(signal_status) {
+    : par_(par), signal_status_(signal_status),
+      zmq_context_(static_cast<int>(par.zeromq_io_threads())) {
+  // keep the threads started from here off the cores of the data path
+  if (par_.thread_placement() == ThreadPlacement::Topology) {
+    placement_ =
+        std::make_unique<CorePlacement>(node_cpus(), par_.housekeeping_cpus());
+    set_cpus(par_.housekeeping_cpus());
+    L_(info) << "placement: housekeeping on CPUs "
+             << format_cpu_list(par_.housekeeping_cpus());
+  }
+
+  // reserve cache and memory bandwidth for the data path
+  if (!par_.resctrl_transport().empty()) {
+    transport_group_ = std::make_unique<ResctrlGroup>(
+        par_.resctrl_transport(), par_.resctrl_transport_schemata());
+  }
+  if (!par_.resctrl_processor().empty()) {
+    processor_group_ = std::make_unique<ResctrlGroup>(
+        par_.resctrl_processor(), par_.resctrl_processor_schemata());
+  }
+
   // start up monitoring
   if (!par.monitor_uri().empty()) {
     monitor_ = std::make_unique<cbm::Monitor>(par_.monitor_uri());
+    if (par_.allocation_stats()) {
+      cbm::AllocationStats::Enable();
+    }
+    if (par_.thread_stats()) {
+      monitor_->EnableThreadStats();
+    }
+  }
+  if (par_.live_stats()) {
+    cbm::LiveStats::Create("flesnet." + std::to_string(getpid()));
+  }
+
+  // start up event tracing
+  if (!par.trace_file().empty()) {
+    EventTrace::enable();
+    EventTrace::start_writer(par_.trace_file(), par_.trace_continuous());
+    L_(info) << "recording event trace to " << par_.trace_file();
   }
 
+#ifdef HAVE_LIBFABRIC
+  if (par_.transport() == Transport::LibFabric && par_.on_demand_paging()) {
+    tl_libfabric::Provider::enable_on_demand_paging();
+  }
+  if (par_.transport() == Transport::LibFabric && par_.provider_probe()) {
+    tl_libfabric::Provider::enable_probe();
+  }
+#endif
+
+  if (par_.transport() == Transport::SHM) {
+    // one channel for each pair of input and output
+    std::size_t num_channels = par_.inputs().size() * par_.outputs().size();
+    for (std::size_t i = 0; i < num_channels; ++i) {
+      shm_channels_.push_back(std::make_unique<ComponentChannelShm>());
+    }
+  }
+
+  auto stage_begin = std::chrono::steady_clock::now();
   create_input_channel_senders();
+  log_startup_stage("input channels created", stage_begin);
   create_timeslice_buffers();
-  set_node();
+  log_startup_stage("timeslice buffers created", stage_begin);
+  if (!placement_) {
+    set_node();
+  }
 }
 
 Application::~Application() {
+  EventTrace::stop_writer();
+  if (par_.live_stats()) {
+    cbm::LiveStats::Remove();
+  }
+
   // delay to allow monitor to process pending messages
   constexpr auto destruct_delay = std::chrono::milliseconds(200);
   std::this_thread::sleep_for(destruct_delay);
@@ -46,54 +134,269 @@ void Application::create_timeslice_buffers() {
     }
   }
 
+  std::vector<std::string> input_hosts;
+  std::vector<std::string> input_services;
+  for (unsigned i = 0; i < input_size; ++i) {
+    input_hosts.push_back(par_.inputs().at(i).host);
+    input_services.push_back(std::to_string(par_.base_port() + i));
+  }
+
   for (unsigned i : par_.output_indexes()) {
     auto shm_identifier = par_.outputs().at(i).path.at(0);
     auto param = par_.outputs().at(i).param;
 
+    // the data buffer size per input, or a list of one size per input
     uint32_t datasize = 27; // 128 MiB
+    std::vector<uint32_t> datasizes;
     if (param.count("datasize") != 0u) {
-      datasize = stou(param.at("datasize"));
+      std::vector<std::string> values;
+      boost::split(values, param.at("datasize"), boost::is_any_of(","));
+      if (values.size() == 1) {
+        datasize = stou(values.at(0));
+      } else if (values.size() == input_size) {
+        for (const auto& value : values) {
+          datasizes.push_back(stou(value));
+        }
+      } else {
+        throw std::runtime_error("invalid datasize list, need one value per "
+                                 "input: " +
+                                 param.at("datasize"));
+      }
+    }
+    // size the data buffers in proportion to the data rates of the inputs
+    if (param.count("datarates") != 0u) {
+      if (!datasizes.empty()) {
+        throw std::runtime_error("datarates requires a single datasize");
+      }
+      std::vector<std::string> values;
+      boost::split(values, param.at("datarates"), boost::is_any_of(","));
+      if (values.size() != input_size) {
+        throw std::runtime_error("invalid datarates, need one value per "
+                                 "input: " +
+                                 param.at("datarates"));
+      }
+      std::vector<double> rates;
+      for (const auto& value : values) {
+        rates.push_back(std::stod(value));
+      }
+      datasizes = TimesliceBuffer::data_size_exps_for_rates(rates, datasize);
+    }
+    if (datasizes.empty()) {
+      datasizes.assign(input_size, datasize);
     }
     uint32_t descsize = 19; // 16 MiB
     if (param.count("descsize") != 0u) {
       descsize = stou(param.at("descsize"));
     }
 
+    bool use_shm_item_channel = false;
+    if (param.count("distribution") != 0u) {
+      const auto& distribution = param.at("distribution");
+      if (distribution == "shm") {
+        use_shm_item_channel = true;
+      } else if (distribution != "zmq") {
+        throw std::runtime_error("invalid item distribution: " + distribution);
+      }
+    }
+    auto work_item_encoding = fles::WorkItemEncoding::Binary;
+    if (param.count("workitem") != 0u) {
+      const auto& encoding = param.at("workitem");
+      if (encoding == "legacy") {
+        work_item_encoding = fles::WorkItemEncoding::Legacy;
+      } else if (encoding == "flat") {
+        work_item_encoding = fles::WorkItemEncoding::Flat;
+      } else if (encoding != "binary") {
+        throw std::runtime_error("invalid work item encoding: " + encoding);
+      }
+    }
+    // keep the segment for a restarted flesnet to re-attach to
+    bool persistent = false;
+    if (param.count("persistent") != 0u) {
+      persistent = stou(param.at("persistent")) != 0;
+    }
+    // partition the workers across several distributor threads
+    size_t distributor_shards = 1;
+    if (param.count("shards") != 0u) {
+      distributor_shards = stou(param.at("shards"));
+    }
+
     const std::string producer_address = "inproc://" + shm_identifier;
     const std::string worker_address = "ipc://@" + shm_identifier;
 
     auto item_distributor = std::make_unique<ItemDistributor>(
-        zmq_context_, producer_address, worker_address);
+        zmq_context_, producer_address, worker_address,
+        TimesliceBuffer::item_deadline_horizon(descsize), distributor_shards);
+    item_distributor->set_status_interval(par_.monitor_interval());
     item_distributors_.push_back(std::move(item_distributor));
 
     std::unique_ptr<TimesliceBuffer> tsb(
         new TimesliceBuffer(zmq_context_, producer_address, shm_identifier,
-                            datasize, descsize, input_size));
+                            datasizes, descsize,
+                            par_.outputs().at(i).memory_policy,
+                            use_shm_item_channel, work_item_encoding,
+                            persistent));
+    // verify or compute the microslice CRCs once for all consumers
+    if (param.count("crc") != 0u) {
+      tsb->set_crc_check(parse_crc_check_mode(param.at("crc")));
+    }
+    // hand on timeslices to the consumers with their first complete component
+    if (param.count("partial") != 0u && stou(param.at("partial")) != 0) {
+      if (par_.transport() != Transport::RDMA &&
+          par_.transport() != Transport::TCP) {
+        throw std::runtime_error(
+            "partial delivery requires the rdma or tcp transport");
+      }
+      tsb->set_partial_delivery(true);
+    }
+    // spill timeslices to local storage while the consumers fall behind
+    if (param.count("spill") != 0u) {
+      SpillParameters spill;
+      spill.directory = param.at("spill");
+      if (param.count("spillhigh") != 0u) {
+        spill.high_water = std::stod(param.at("spillhigh"));
+      }
+      if (param.count("spilllow") != 0u) {
+        spill.low_water = std::stod(param.at("spilllow"));
+      }
+      if (param.count("spillmax") != 0u) {
+        spill.max_size = UINT64_C(1) << stou(param.at("spillmax"));
+      }
+      tsb->set_spill(spill);
+    }
+    // keep completed timeslices for dumps on request
+    if (param.count("retain") != 0u) {
+      RetentionParameters retention;
+      retention.depth = std::chrono::milliseconds(
+          std::llround(std::stod(param.at("retain")) * 1000));
+      if (param.count("retainfill") != 0u) {
+        retention.max_fill = std::stod(param.at("retainfill"));
+      }
+      retention.trigger_address = param.count("trigger") != 0u
+                                      ? param.at("trigger")
+                                      : "ipc://@" + shm_identifier + "_history";
+      tsb->set_retention(retention);
+    }
+    // measure the rates and recommend buffer sizes
+    if (param.count("calibrate") != 0u) {
+      CalibrationParameters calibration;
+      calibration.duration = std::chrono::milliseconds(
+          std::llround(std::stod(param.at("calibrate")) * 1000));
+      if (param.count("headroom") != 0u) {
+        calibration.headroom = std::chrono::milliseconds(
+            std::llround(std::stod(param.at("headroom")) * 1000));
+      }
+      if (param.count("calibratefile") != 0u) {
+        calibration.output_file = param.at("calibratefile");
+      }
+      tsb->set_calibration(calibration);
+    }
 
     L_(info) << "timeslice buffer " << i << ": " << tsb->description();
 
-    start_processes(shm_identifier);
+    if (par_.warm_buffers() > 0 && !tsb->data_on_device()) {
+      std::size_t data_bytes = tsb->get_data_size();
+      std::size_t desc_bytes = (UINT64_C(1) << descsize) * input_size *
+                               sizeof(fles::TimesliceComponentDescriptor);
+      buffer_warmers_.push_back(std::make_unique<BufferWarmer>(
+          "timeslice buffer " + std::to_string(i),
+          std::vector<BufferWarmer::Region>{{tsb->get_data_ptr(0), data_bytes},
+                                            {tsb->get_desc_ptr(0), desc_bytes}},
+          par_.warm_buffers()));
+    }
+
+    auto processors = std::make_unique<ProcessorPool>();
+    processors->shm_identifier = shm_identifier;
+    uint32_t instances = par_.processor_instances();
+    if (par_.processor_scaling().enabled()) {
+      processors->scaler =
+          std::make_unique<ProcessorScaler>(par_.processor_scaling(), instances);
+      instances = processors->scaler->instances();
+      item_distributors_.back()->set_load_observer(
+          [this, pool = processors.get()](size_t pending_items) {
+            scale_processes(*pool, pending_items);
+          },
+          std::chrono::milliseconds(100));
+    }
+    start_processes(*processors, instances);
+    processor_pools_.push_back(std::move(processors));
     ChildProcessManager::get().allow_stop_processes(this);
 
+    int nic_node = interface_numa_node(par_.outputs().at(i).host);
+    std::size_t builder_threads =
+        (par_.transport() == Transport::RDMA) ? par_.progress_threads() : 1;
+    builder_cpus_.push_back(assign_cpus("timeslice builder " +
+                                            std::to_string(i),
+                                        nic_node, builder_threads));
+
     if (par_.transport() == Transport::ZeroMQ) {
       std::unique_ptr<TimesliceBuilderZeromq> builder(
           new TimesliceBuilderZeromq(
               i, *tsb, input_server_addresses, output_size,
               par_.timeslice_size(), par_.max_timeslice_number(),
               signal_status_, static_cast<void*>(zmq_context_),
-              monitor_.get()));
+              monitor_.get(), par_.zeromq_streams()));
       timeslice_builders_zeromq_.push_back(std::move(builder));
+    } else if (par_.transport() == Transport::TCP) {
+      // the builders listen for the overlap requests of their predecessors
+      // on the ports following those of the inputs
+      std::string overlap_host;
+      std::string overlap_service;
+      uint32_t overlap_port_base = par_.base_port() + input_size;
+      if (par_.tcp_overlap_sharing()) {
+        unsigned next = (i + 1) % output_size;
+        overlap_host = par_.outputs().at(next).host;
+        overlap_service = std::to_string(overlap_port_base + next);
+      }
+      std::unique_ptr<TimesliceBuilderTcp> builder(new TimesliceBuilderTcp(
+          i, *tsb, input_hosts, input_services, output_size,
+          par_.core_microslices(), par_.max_timeslice_number(),
+          par_.tcp_streams(), par_.tcp_compression(),
+          par_.tcp_compression_level(), par_.tcp_compression_threads(),
+          overlap_host, overlap_service,
+          static_cast<uint16_t>(overlap_port_base + i),
+          std::chrono::milliseconds(par_.timeslice_deadline()), signal_status_,
+          monitor_.get()));
+      timeslice_builders_tcp_.push_back(std::move(builder));
+    } else if (par_.transport() == Transport::SHM) {
+      std::vector<ComponentChannelShm*> channels;
+      for (unsigned j = 0; j < input_size; ++j) {
+        channels.push_back(shm_channels_.at(j * output_size + i).get());
+      }
+      std::unique_ptr<TimesliceBuilderShm> builder(new TimesliceBuilderShm(
+          i, *tsb, channels, output_size, par_.core_microslices(),
+          par_.max_timeslice_number(), signal_status_, monitor_.get()));
+      timeslice_builders_shm_.push_back(std::move(builder));
+    } else if (par_.transport() == Transport::UCX) {
+#ifdef HAVE_UCX
+      std::unique_ptr<TimesliceBuilderUcx> builder(new TimesliceBuilderUcx(
+          i, *tsb, input_hosts, input_services, output_size,
+          par_.timeslice_size(), par_.max_timeslice_number(), signal_status_,
+          monitor_.get()));
+      timeslice_builders_ucx_.push_back(std::move(builder));
+#else
+      L_(fatal) << "flesnet built without UCX support";
+#endif
     } else if (par_.transport() == Transport::LibFabric) {
 #ifdef HAVE_LIBFABRIC
       std::unique_ptr<tl_libfabric::TimesliceBuilder> builder(
           new tl_libfabric::TimesliceBuilder(
               i, *tsb, par_.base_port() + i, input_size, par_.timeslice_size(),
               signal_status_, par_.drop_process_ts(), par_.outputs().at(i).host,
-              par_.scheduler_history_size(), par_.scheduler_interval_length(),
+              par_.outputs().at(i).rails, par_.outputs().at(i).standby,
+              par_.scheduler_history_size(),
+              par_.scheduler_interval_length(),
               par_.scheduler_speedup_difference_percentage(),
               par_.scheduler_speedup_percentage(),
               par_.scheduler_speedup_interval_count(),
-              par_.scheduler_log_directory(), par_.scheduler_enable_logging()));
+              par_.scheduler_policy(), par_.scheduler_target_buffer_fill(),
+              par_.scheduler_log_directory(), par_.scheduler_enable_logging(),
+              par_.shared_receive_context(), par_.dedicated_heartbeat(),
+              par_.progress_mode(), par_.progress_spin_time(), monitor_.get()));
+      builder->set_compute_node_count(static_cast<uint32_t>(std::count_if(
+          par_.outputs().begin(), par_.outputs().end(),
+          [](const auto& output) { return !output.standby; })));
+      builder->set_timeslice_target_bytes(par_.timeslice_target_bytes());
+      builder->set_ack_coalescing(par_.ack_coalescing());
       timeslice_builders_.push_back(std::move(builder));
 #else
       L_(fatal) << "flesnet built without LIBFABRIC support";
@@ -101,8 +404,12 @@ void Application::create_timeslice_buffers() {
     } else {
 #ifdef HAVE_RDMA
       std::unique_ptr<TimesliceBuilder> builder(new TimesliceBuilder(
-          i, *tsb, par_.base_port() + i, input_size, par_.timeslice_size(),
-          signal_status_, false, monitor_.get()));
+          i, *tsb, par_.base_port() + i, input_size, par_.core_microslices(),
+          output_size, signal_status_, false, par_.progress_threads(),
+          par_.progress_mode(), par_.progress_spin_time(), monitor_.get()));
+      builder->set_status_interval(par_.monitor_interval());
+      builder->set_perf_counters(par_.perf_counters());
+      builder->set_ack_coalescing(par_.ack_coalescing());
       timeslice_builders_.push_back(std::move(builder));
 #else
       L_(fatal) << "flesnet built without RDMA support";
@@ -124,11 +431,19 @@ void Application::create_input_channel_senders() {
     output_services.push_back(std::to_string(par_.base_port() + i));
   }
 
+  std::vector<std::vector<std::string>> output_rails;
+  std::vector<bool> output_standby;
+  for (unsigned int i = 0; i < par_.outputs().size(); ++i) {
+    output_rails.push_back(par_.outputs().at(i).rails);
+    output_standby.push_back(par_.outputs().at(i).standby);
+  }
+
   for (size_t c = 0; c < par_.input_indexes().size(); ++c) {
     unsigned index = par_.input_indexes().at(c);
 
     auto scheme = par_.inputs().at(index).scheme;
     auto param = par_.inputs().at(index).param;
+    int numa_node = par_.inputs().at(index).memory_policy.numa_node;
 
     if (scheme == "shm") {
       auto shm_identifier = par_.inputs().at(index).path.at(0);
@@ -149,6 +464,8 @@ void Application::create_input_channel_senders() {
       data_sources_.push_back(
           std::unique_ptr<InputBufferReadInterface>(new flib_shm_channel_client(
               shm_devices_.at(shm_identifier), channel)));
+      // the buffers are located on the node the CRI is attached to
+      numa_node = shm_devices_.at(shm_identifier)->numa_node();
     } else if (scheme == "pgen") {
       uint32_t datasize = 27; // 128 MiB
       if (param.count("datasize") != 0u) {
@@ -178,6 +495,18 @@ void Application::create_input_channel_senders() {
       if (param.count("initial") != 0u) {
         initial_ns = stoul(param.at("initial"));
       }
+      uint32_t fill_threads = 0;
+      if (param.count("threads") != 0u) {
+        fill_threads = stou(param.at("threads"));
+      }
+      uint32_t content_alignment = 0;
+      if (param.count("align") != 0u) {
+        content_alignment = stou(param.at("align"));
+        if ((content_alignment & (content_alignment - 1)) != 0) {
+          throw std::runtime_error("invalid microslice alignment: " +
+                                   param.at("align"));
+        }
+      }
 
       L_(info) << "input buffer " << index
                << " size: " << human_readable_count(UINT64_C(1) << datasize)
@@ -190,16 +519,120 @@ void Application::create_input_channel_senders() {
       data_sources_.push_back(std::unique_ptr<InputBufferReadInterface>(
           new FlesnetPatternGenerator(datasize, descsize, index, size_mean,
                                       (pattern != 0), (size_var != 0), delay_ns,
-                                      initial_ns)));
+                                      initial_ns,
+                                      par_.inputs().at(index).memory_policy,
+                                      fill_threads, content_alignment)));
+      if (par_.warm_buffers() > 0) {
+        InputBufferReadInterface& source = *data_sources_.back();
+        buffer_warmers_.push_back(std::make_unique<BufferWarmer>(
+            "input buffer " + std::to_string(index),
+            std::vector<BufferWarmer::Region>{
+                {source.data_buffer().ptr(), source.data_buffer().bytes()},
+                {source.desc_buffer().ptr(), source.desc_buffer().bytes()}},
+            par_.warm_buffers()));
+      }
+    } else if (scheme == "profile") {
+      std::string filename;
+      for (const auto& segment : par_.inputs().at(index).path) {
+        filename += "/" + segment;
+      }
+      uint32_t datasize = 27; // 128 MiB
+      if (param.count("datasize") != 0u) {
+        datasize = stou(param.at("datasize"));
+      }
+      uint32_t descsize = 19; // 16 MiB
+      if (param.count("descsize") != 0u) {
+        descsize = stou(param.at("descsize"));
+      }
+      double speed = 1.0;
+      if (param.count("speed") != 0u) {
+        speed = std::stod(param.at("speed"));
+      }
+      double scale = 1.0;
+      if (param.count("scale") != 0u) {
+        scale = std::stod(param.at("scale"));
+      }
+      const LoadProfile profile = LoadProfile::load(filename);
+      if (profile.components.empty()) {
+        throw std::runtime_error("load profile without components: " +
+                                 filename);
+      }
+      std::size_t component = index % profile.components.size();
+      if (param.count("component") != 0u) {
+        component = stou(param.at("component"));
+      }
+
+      auto* generator = new ProfileLoadGenerator(
+          datasize, descsize, profile.components.at(component), speed, scale,
+          index, par_.inputs().at(index).memory_policy);
+      data_sources_.push_back(
+          std::unique_ptr<InputBufferReadInterface>(generator));
+      L_(info) << "input buffer " << index << ": replaying load profile "
+               << filename << " component " << component << " ("
+               << human_readable_count(
+                      static_cast<uint64_t>(generator->profile().mean_rate()))
+               << "/s at original speed)";
+    } else if (scheme == "msa") {
+      std::string filename;
+      for (const auto& segment : par_.inputs().at(index).path) {
+        filename += "/" + segment;
+      }
+      uint32_t descsize = 19; // 16 MiB
+      if (param.count("descsize") != 0u) {
+        descsize = stou(param.at("descsize"));
+      }
+      uint64_t loops = 1;
+      if (param.count("loop") != 0u) {
+        loops = stoul(param.at("loop"));
+      }
+      uint32_t pace = 0;
+      if (param.count("pace") != 0u) {
+        pace = stou(param.at("pace"));
+      }
+
+      auto* replay = new MicrosliceArchiveReplay(
+          filename, descsize, loops, (pace != 0),
+          par_.inputs().at(index).memory_policy);
+      data_sources_.push_back(
+          std::unique_ptr<InputBufferReadInterface>(replay));
+      L_(info) << "input buffer " << index << ": replaying "
+               << replay->num_microslices() << " microslices from "
+               << filename << " ("
+               << human_readable_count(replay->data_buffer().bytes()) << ")";
     } else {
       L_(fatal) << "unknown input scheme: " << scheme;
     }
+    input_numa_nodes_.push_back(numa_node);
+    if (numa_node >= 0) {
+      L_(info) << "input " << index << " running on NUMA node " << numa_node;
+    }
+    int input_node = (numa_node >= 0)
+                         ? numa_node
+                         : interface_numa_node(par_.inputs().at(index).host);
+    input_cpus_.push_back(
+        assign_cpus("input channel " + std::to_string(index), input_node, 1));
 
     uint32_t overlap_size = 1;
     if (param.count("overlap") != 0u) {
       overlap_size = stou(param.at("overlap"));
     }
 
+    InputBufferReadInterface* source = data_sources_.at(c).get();
+    if (param.count("reduce") != 0u) {
+      unsigned reduce_threads = 0;
+      if (param.count("reducethreads") != 0u) {
+        reduce_threads = stou(param.at("reducethreads"));
+      }
+      // dropping microslices keeps time-based timeslices aligned only
+      reducing_sources_.push_back(std::make_unique<ReducingSource>(
+          *source, make_microslice_reducer(param.at("reduce")),
+          reduce_threads, par_.timeslice_duration() != 0,
+          par_.inputs().at(index).memory_policy));
+      source = reducing_sources_.back().get();
+      L_(info) << "input " << index << ": reducing microslices ("
+               << param.at("reduce") << ")";
+    }
+
     if (par_.transport() == Transport::ZeroMQ) {
       std::string listen_address =
           "tcp://*:" + std::to_string(par_.base_port() + index);
@@ -207,19 +640,64 @@ void Application::create_input_channel_senders() {
         listen_address = "inproc://input" + std::to_string(index);
       }
       std::unique_ptr<ComponentSenderZeromq> sender(new ComponentSenderZeromq(
-          index, *(data_sources_.at(c).get()), listen_address,
+          index, *source, listen_address,
           par_.timeslice_size(), overlap_size, par_.max_timeslice_number(),
           signal_status_, static_cast<void*>(zmq_context_), monitor_.get()));
       component_senders_zeromq_.push_back(std::move(sender));
+    } else if (par_.transport() == Transport::TCP) {
+      std::unique_ptr<ComponentSenderTcp> sender(new ComponentSenderTcp(
+          index, *source,
+          static_cast<uint16_t>(par_.base_port() + index),
+          par_.timeslice_size(), overlap_size, par_.timeslice_duration(),
+          par_.overlap_duration(), par_.max_timeslice_number(),
+          par_.tcp_zerocopy(), par_.tcp_compression_threads(), signal_status_,
+          monitor_.get()));
+      component_senders_tcp_.push_back(std::move(sender));
+    } else if (par_.transport() == Transport::SHM) {
+      std::size_t output_size = par_.outputs().size();
+      std::vector<ComponentChannelShm*> channels;
+      for (std::size_t o = 0; o < output_size; ++o) {
+        channels.push_back(shm_channels_.at(index * output_size + o).get());
+      }
+      std::unique_ptr<ComponentSenderShm> sender(new ComponentSenderShm(
+          index, *source, channels,
+          par_.timeslice_size(), overlap_size, par_.timeslice_duration(),
+          par_.overlap_duration(), par_.max_timeslice_number(),
+          signal_status_, monitor_.get()));
+      component_senders_shm_.push_back(std::move(sender));
+    } else if (par_.transport() == Transport::UCX) {
+#ifdef HAVE_UCX
+      std::unique_ptr<ComponentSenderUcx> sender(new ComponentSenderUcx(
+          index, *source,
+          static_cast<uint16_t>(par_.base_port() + index),
+          par_.timeslice_size(), overlap_size, par_.max_timeslice_number(),
+          signal_status_, monitor_.get()));
+      component_senders_ucx_.push_back(std::move(sender));
+#else
+      L_(fatal) << "flesnet built without UCX support";
+#endif
     } else if (par_.transport() == Transport::LibFabric) {
 #ifdef HAVE_LIBFABRIC
       std::unique_ptr<tl_libfabric::InputChannelSender> sender(
           new tl_libfabric::InputChannelSender(
-              index, *(data_sources_.at(c).get()), output_hosts,
+              index, *source, output_hosts,
               output_services, par_.timeslice_size(), overlap_size,
               par_.max_timeslice_number(), par_.inputs().at(index).host,
-              par_.scheduler_interval_length(), par_.scheduler_log_directory(),
-              par_.scheduler_enable_logging()));
+              par_.inputs().at(index).rails, output_rails, output_standby,
+              par_.scheduler_interval_length(),
+              par_.scheduler_bandwidth_aware_placement(),
+              par_.scheduler_staggered_transfers(),
+              par_.scheduler_shedding_levels(),
+              par_.scheduler_shedding_priority_interval(),
+              par_.scheduler_log_directory(), par_.scheduler_enable_logging(),
+              par_.dedicated_heartbeat(),
+              par_.progress_mode(), par_.progress_spin_time(),
+              par_.write_signal_interval(), monitor_.get()));
+      sender->set_link_model(par_.link_model());
+      sender->set_input_node_count(
+          static_cast<uint32_t>(par_.inputs().size()));
+      sender->set_adaptive_timeslice_size(par_.timeslice_target_bytes() != 0);
+      sender->set_inline_data_size(par_.inline_data_size());
       input_channel_senders_.push_back(std::move(sender));
 #else
       L_(fatal) << "flesnet built without LIBFABRIC support";
@@ -227,9 +705,18 @@ void Application::create_input_channel_senders() {
     } else {
 #ifdef HAVE_RDMA
       std::unique_ptr<InputChannelSender> sender(new InputChannelSender(
-          index, *(data_sources_.at(c).get()), output_hosts, output_services,
-          par_.timeslice_size(), overlap_size, par_.max_timeslice_number(),
-          monitor_.get()));
+          index, *source, output_hosts, output_services,
+          par_.timeslice_size(), overlap_size, par_.timeslice_duration(),
+          par_.overlap_duration(), par_.max_timeslice_number(),
+          par_.pointer_write(), par_.write_with_imm(), par_.rdma_pull(),
+          par_.progress_mode(), par_.progress_spin_time(), monitor_.get()));
+      sender->set_status_interval(par_.monitor_interval());
+      sender->set_perf_counters(par_.perf_counters());
+      sender->set_content_alignment(par_.content_alignment());
+      sender->set_inline_data_size(par_.inline_data_size());
+      if (par_.control_connections()) {
+        sender->set_control_connections(par_.control_tos());
+      }
       input_channel_senders_.push_back(std::move(sender));
 #else
       L_(fatal) << "flesnet built without RDMA support";
@@ -242,7 +729,10 @@ void Application::run() {
   std::vector<std::thread> distributor_threads;
 
   for (auto& distributor : item_distributors_) {
-    distributor_threads.emplace_back(std::ref(*distributor));
+    distributor_threads.emplace_back([this, &distributor] {
+      join_transport_group();
+      (*distributor)();
+    });
   }
 
   auto cleanup_distributor_threads = [&]() {
@@ -259,11 +749,13 @@ void Application::run() {
 #if defined(HAVE_RDMA) || defined(HAVE_LIBFABRIC)
   if (timeslice_builders_.size() == 1 && input_channel_senders_.empty()) {
     L_(debug) << "using existing thread for single timeslice builder";
+    bind_builder_thread(0);
     (*timeslice_builders_[0])();
     cleanup_distributor_threads();
   }
   if (input_channel_senders_.size() == 1 && timeslice_builders_.empty()) {
     L_(debug) << "using existing thread for single input channel sender";
+    bind_input_thread(0);
     (*input_channel_senders_[0])();
     return;
   }
@@ -275,8 +767,83 @@ void Application::run() {
   bool stop = false;
 
 #if defined(HAVE_RDMA) || defined(HAVE_LIBFABRIC)
-  for (auto& buffer : timeslice_builders_) {
-    boost::packaged_task<void> task(std::ref(*buffer));
+  for (size_t b = 0; b < timeslice_builders_.size(); ++b) {
+    auto& buffer = timeslice_builders_[b];
+    boost::packaged_task<void> task([this, &buffer, b] {
+      bind_builder_thread(b);
+      (*buffer)();
+    });
+    futures.push_back(task.get_future());
+    auto* thread = new boost::thread(std::move(task)); // NOLINT
+#if defined(HAVE_PTHREAD_SETNAME_NP)
+    pthread_setname_np(thread->native_handle(), buffer->thread_name().c_str());
+#endif
+    threads.add_thread(thread);
+  }
+
+  for (size_t c = 0; c < input_channel_senders_.size(); ++c) {
+    auto& buffer = input_channel_senders_[c];
+    boost::packaged_task<void> task([this, &buffer, c] {
+      bind_input_thread(c);
+      (*buffer)();
+    });
+    futures.push_back(task.get_future());
+    auto* thread = new boost::thread(std::move(task)); // NOLINT
+#if defined(HAVE_PTHREAD_SETNAME_NP)
+    pthread_setname_np(thread->native_handle(), buffer->thread_name().c_str());
+#endif
+    threads.add_thread(thread);
+  }
+#endif
+
+  for (size_t b = 0; b < timeslice_builders_zeromq_.size(); ++b) {
+    auto& buffer = timeslice_builders_zeromq_[b];
+    boost::packaged_task<void> task([this, &buffer, b] {
+      bind_builder_thread(b);
+      (*buffer)();
+    });
+    futures.push_back(task.get_future());
+    auto* thread = new boost::thread(std::move(task)); // NOLINT
+#if defined(HAVE_PTHREAD_SETNAME_NP)
+    pthread_setname_np(thread->native_handle(), buffer->thread_name().c_str());
+#endif
+    threads.add_thread(thread);
+  }
+
+  for (size_t c = 0; c < component_senders_zeromq_.size(); ++c) {
+    auto& buffer = component_senders_zeromq_[c];
+    boost::packaged_task<void> task([this, &buffer, c] {
+      bind_input_thread(c);
+      (*buffer)();
+    });
+    futures.push_back(task.get_future());
+    auto* thread = new boost::thread(std::move(task)); // NOLINT
+#if defined(HAVE_PTHREAD_SETNAME_NP)
+    pthread_setname_np(thread->native_handle(), buffer->thread_name().c_str());
+#endif
+    threads.add_thread(thread);
+  }
+
+  for (size_t b = 0; b < timeslice_builders_tcp_.size(); ++b) {
+    auto& buffer = timeslice_builders_tcp_[b];
+    boost::packaged_task<void> task([this, &buffer, b] {
+      bind_builder_thread(b);
+      (*buffer)();
+    });
+    futures.push_back(task.get_future());
+    auto* thread = new boost::thread(std::move(task)); // NOLINT
+#if defined(HAVE_PTHREAD_SETNAME_NP)
+    pthread_setname_np(thread->native_handle(), buffer->thread_name().c_str());
+#endif
+    threads.add_thread(thread);
+  }
+
+  for (size_t c = 0; c < component_senders_tcp_.size(); ++c) {
+    auto& buffer = component_senders_tcp_[c];
+    boost::packaged_task<void> task([this, &buffer, c] {
+      bind_input_thread(c);
+      (*buffer)();
+    });
     futures.push_back(task.get_future());
     auto* thread = new boost::thread(std::move(task)); // NOLINT
 #if defined(HAVE_PTHREAD_SETNAME_NP)
@@ -285,8 +852,12 @@ void Application::run() {
     threads.add_thread(thread);
   }
 
-  for (auto& buffer : input_channel_senders_) {
-    boost::packaged_task<void> task(std::ref(*buffer));
+  for (size_t b = 0; b < timeslice_builders_shm_.size(); ++b) {
+    auto& buffer = timeslice_builders_shm_[b];
+    boost::packaged_task<void> task([this, &buffer, b] {
+      bind_builder_thread(b);
+      (*buffer)();
+    });
     futures.push_back(task.get_future());
     auto* thread = new boost::thread(std::move(task)); // NOLINT
 #if defined(HAVE_PTHREAD_SETNAME_NP)
@@ -294,10 +865,28 @@ void Application::run() {
 #endif
     threads.add_thread(thread);
   }
+
+  for (size_t c = 0; c < component_senders_shm_.size(); ++c) {
+    auto& buffer = component_senders_shm_[c];
+    boost::packaged_task<void> task([this, &buffer, c] {
+      bind_input_thread(c);
+      (*buffer)();
+    });
+    futures.push_back(task.get_future());
+    auto* thread = new boost::thread(std::move(task)); // NOLINT
+#if defined(HAVE_PTHREAD_SETNAME_NP)
+    pthread_setname_np(thread->native_handle(), buffer->thread_name().c_str());
 #endif
+    threads.add_thread(thread);
+  }
 
-  for (auto& buffer : timeslice_builders_zeromq_) {
-    boost::packaged_task<void> task(std::ref(*buffer));
+#if defined(HAVE_UCX)
+  for (size_t b = 0; b < timeslice_builders_ucx_.size(); ++b) {
+    auto& buffer = timeslice_builders_ucx_[b];
+    boost::packaged_task<void> task([this, &buffer, b] {
+      bind_builder_thread(b);
+      (*buffer)();
+    });
     futures.push_back(task.get_future());
     auto* thread = new boost::thread(std::move(task)); // NOLINT
 #if defined(HAVE_PTHREAD_SETNAME_NP)
@@ -306,8 +895,12 @@ void Application::run() {
     threads.add_thread(thread);
   }
 
-  for (auto& buffer : component_senders_zeromq_) {
-    boost::packaged_task<void> task(std::ref(*buffer));
+  for (size_t c = 0; c < component_senders_ucx_.size(); ++c) {
+    auto& buffer = component_senders_ucx_[c];
+    boost::packaged_task<void> task([this, &buffer, c] {
+      bind_input_thread(c);
+      (*buffer)();
+    });
     futures.push_back(task.get_future());
     auto* thread = new boost::thread(std::move(task)); // NOLINT
 #if defined(HAVE_PTHREAD_SETNAME_NP)
@@ -315,6 +908,7 @@ void Application::run() {
 #endif
     threads.add_thread(thread);
   }
+#endif
 
   L_(debug) << "threads started: " << threads.size();
 
@@ -337,21 +931,126 @@ void Application::run() {
   cleanup_distributor_threads();
 }
 
-void Application::start_processes(const std::string& shared_memory_identifier) {
+Application::Statistics Application::statistics() const {
+  Statistics stats;
+  for (const auto& buffer : timeslice_buffers_) {
+    stats.timeslices += buffer->get_num_timeslices_sent();
+    stats.timeslice_bytes += buffer->get_num_bytes_sent();
+  }
+  for (const auto& source : data_sources_) {
+    if (const auto* pgen =
+            dynamic_cast<const FlesnetPatternGenerator*>(source.get())) {
+      stats.input_bytes += pgen->acked_data();
+    }
+  }
+  return stats;
+}
+
+void Application::start_processes(ProcessorPool& pool, uint32_t count) {
   const std::string processor_executable = par_.processor_executable();
   assert(!processor_executable.empty());
-  for (uint_fast32_t i = 0; i < par_.processor_instances(); ++i) {
+  // the processes inherit the affinity, do not crowd them on housekeeping
+  if (placement_) {
+    std::vector<int> all_cpus;
+    for (const auto& [node, cpus] : node_cpus()) {
+      all_cpus.insert(all_cpus.end(), cpus.begin(), cpus.end());
+    }
+    set_cpus(all_cpus);
+  }
+  for (uint_fast32_t i = 0; i < count; ++i) {
     std::stringstream index;
-    index << i;
+    index << pool.pids.size();
     ChildProcess cp = ChildProcess();
     cp.owner = this;
     boost::split(cp.arg, processor_executable, boost::is_any_of(" \t"),
                  boost::token_compress_on);
     cp.path = cp.arg.at(0);
     for (auto& arg : cp.arg) {
-      boost::replace_all(arg, "%s", shared_memory_identifier);
+      boost::replace_all(arg, "%s", pool.shm_identifier);
       boost::replace_all(arg, "%i", index.str());
     }
-    ChildProcessManager::get().start_process(cp);
+    pid_t pid = 0;
+    if (ChildProcessManager::get().start_process(cp, &pid)) {
+      pool.pids.push_back(pid);
+      // the instance has just been exec'd, its threads follow its group
+      if (processor_group_) {
+        try {
+          processor_group_->add_task(pid);
+        } catch (const std::exception& e) {
+          L_(warning) << "processor instance " << pid << ": " << e.what();
+        }
+      }
+    }
+  }
+  if (placement_) {
+    set_cpus(par_.housekeeping_cpus());
+  }
+}
+
+void Application::scale_processes(ProcessorPool& pool, size_t pending_items) {
+  const int delta = pool.scaler->update(pending_items);
+  if (delta > 0) {
+    L_(info) << "timeslice buffer " << pool.shm_identifier << ": "
+             << pending_items << " pending work items, starting "
+             << delta << " processor instance(s)";
+    start_processes(pool, static_cast<uint32_t>(delta));
+    ChildProcessManager::get().allow_stop_processes(this);
+  }
+  for (int i = delta; i < 0 && !pool.pids.empty(); ++i) {
+    L_(info) << "timeslice buffer " << pool.shm_identifier << ": "
+             << pending_items << " pending work items, retiring processor "
+             << "instance " << pool.pids.size() - 1;
+    ChildProcessManager::get().stop_process(pool.pids.back());
+    pool.pids.pop_back();
+  }
+}
+
+void Application::bind_input_thread(size_t c) {
+  join_transport_group();
+  int node = input_numa_nodes_.at(c);
+  if (node >= 0) {
+    set_node(node);
+  }
+  if (!input_cpus_.at(c).empty()) {
+    set_cpus(input_cpus_.at(c));
+  }
+}
+
+void Application::bind_builder_thread(size_t b) {
+  join_transport_group();
+  if (!builder_cpus_.at(b).empty()) {
+    set_cpus(builder_cpus_.at(b));
+  }
+}
+
+void Application::join_transport_group() const {
+  if (!transport_group_) {
+    return;
+  }
+  try {
+    transport_group_->add_thread();
+  } catch (const std::exception& e) {
+    L_(warning) << "resctrl group " << transport_group_->name() << ": "
+                << e.what();
+  }
+}
+
+std::vector<int> Application::assign_cpus(const std::string& name, int node,
+                                          std::size_t count) {
+  if (!placement_) {
+    return {};
+  }
+  auto cpus = placement_->assign(node, count);
+  if (cpus.empty()) {
+    L_(warning) << "placement: no free CPU for " << name;
+    return cpus;
+  }
+  int cpu_node = placement_->node_of(cpus.front());
+  L_(info) << "placement: " << name << " on CPUs " << format_cpu_list(cpus)
+           << " (NUMA node " << cpu_node << ")";
+  if (node >= 0 && node != cpu_node) {
+    L_(warning) << "placement: no free CPU on NUMA node " << node << " for "
+                << name;
   }
+  return cpus;
 }
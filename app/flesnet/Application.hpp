@@ -1,13 +1,23 @@
 // Copyright 2012-2016 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include "BufferWarmer.hpp"
+#include "ComponentChannelShm.hpp"
+#include "ComponentSenderShm.hpp"
+#include "ComponentSenderTcp.hpp"
 #include "ComponentSenderZeromq.hpp"
 #include "ConnectionGroupWorker.hpp"
 #include "ItemDistributor.hpp"
 #include "Monitor.hpp"
 #include "Parameters.hpp"
+#include "ProcessorScaler.hpp"
+#include "ReducingSource.hpp"
+#include "ResourceControl.hpp"
 #include "ThreadContainer.hpp"
 #include "TimesliceBuffer.hpp"
+#include "Topology.hpp"
+#include "TimesliceBuilderShm.hpp"
+#include "TimesliceBuilderTcp.hpp"
 #include "TimesliceBuilderZeromq.hpp"
 #include "shm_device_client.hpp"
 #if defined(HAVE_RDMA)
@@ -18,6 +28,10 @@
 #include "fles_libfabric/InputChannelSender.hpp"
 #include "fles_libfabric/TimesliceBuilder.hpp"
 #endif
+#if defined(HAVE_UCX)
+#include "ComponentSenderUcx.hpp"
+#include "TimesliceBuilderUcx.hpp"
+#endif
 #include <csignal>
 #include <map>
 #include <memory>
@@ -39,6 +53,16 @@ public:
 
   void run();
 
+  /// Data path counters of this process.
+  struct Statistics {
+    uint64_t timeslices = 0;      ///< work items sent by the buffers
+    uint64_t timeslice_bytes = 0; ///< data bytes in these work items
+    uint64_t input_bytes = 0;     ///< acknowledged pattern generator bytes
+  };
+
+  /// Retrieve the current data path counters (from any thread).
+  [[nodiscard]] Statistics statistics() const;
+
   Application(const Application&) = delete;
   void operator=(const Application&) = delete;
 
@@ -54,15 +78,37 @@ private:
   std::unique_ptr<cbm::Monitor> monitor_;
 
   /// The application's ZeroMQ context
-  zmq::context_t zmq_context_{1};
+  zmq::context_t zmq_context_;
 
   // Input node application
   std::map<std::string, std::shared_ptr<flib_shm_device_client>> shm_devices_;
 
   /// The application's input and output buffer objects
   std::vector<std::unique_ptr<InputBufferReadInterface>> data_sources_;
+
+  /// The reduction stages of the input buffers, if any
+  std::vector<std::unique_ptr<ReducingSource>> reducing_sources_;
+
+  /// The NUMA node of each input buffer (-1: unknown)
+  std::vector<int> input_numa_nodes_;
+
+  /// The core assignment (only with topology-driven thread placement)
+  std::unique_ptr<CorePlacement> placement_;
+
+  /// The CPUs of each input channel thread (empty: not pinned)
+  std::vector<std::vector<int>> input_cpus_;
+
+  /// The CPUs of each timeslice builder thread (empty: not pinned)
+  std::vector<std::vector<int>> builder_cpus_;
+
+  /// The resctrl groups of the transport threads and processor instances
+  std::unique_ptr<ResctrlGroup> transport_group_;
+  std::unique_ptr<ResctrlGroup> processor_group_;
   std::vector<std::unique_ptr<TimesliceBuffer>> timeslice_buffers_;
 
+  /// Background population of the buffers at startup
+  std::vector<std::unique_ptr<BufferWarmer>> buffer_warmers_;
+
   // The application's output item distributor objects
   std::vector<std::unique_ptr<ItemDistributor>> item_distributors_;
 
@@ -77,5 +123,52 @@ private:
       timeslice_builders_zeromq_;
   std::vector<std::unique_ptr<ComponentSenderZeromq>> component_senders_zeromq_;
 
-  void start_processes(const std::string& shared_memory_identifier);
+  /// The application's TCP transport objects
+  std::vector<std::unique_ptr<TimesliceBuilderTcp>> timeslice_builders_tcp_;
+  std::vector<std::unique_ptr<ComponentSenderTcp>> component_senders_tcp_;
+
+  /// The in-process channels of the SHM transport (input-major order)
+  std::vector<std::unique_ptr<ComponentChannelShm>> shm_channels_;
+
+  /// The application's SHM transport objects
+  std::vector<std::unique_ptr<TimesliceBuilderShm>> timeslice_builders_shm_;
+  std::vector<std::unique_ptr<ComponentSenderShm>> component_senders_shm_;
+
+#if defined(HAVE_UCX)
+  /// The application's UCX transport objects
+  std::vector<std::unique_ptr<TimesliceBuilderUcx>> timeslice_builders_ucx_;
+  std::vector<std::unique_ptr<ComponentSenderUcx>> component_senders_ucx_;
+#endif
+
+  /// The timeslice processor instances of a timeslice buffer.
+  struct ProcessorPool {
+    std::string shm_identifier;
+    /// The pids of the running instances, in the order of their start
+    std::vector<pid_t> pids;
+    /// The autoscaling of the instances (null: fixed number)
+    std::unique_ptr<ProcessorScaler> scaler;
+  };
+
+  /// The processor instances of each timeslice buffer
+  std::vector<std::unique_ptr<ProcessorPool>> processor_pools_;
+
+  /// Start additional processor instances of a timeslice buffer.
+  void start_processes(ProcessorPool& pool, uint32_t count);
+
+  /// Adapt the processor instances of a timeslice buffer to its pending work
+  /// items (called from the thread of its item distributor).
+  void scale_processes(ProcessorPool& pool, size_t pending_items);
+
+  /// Bind the calling thread to the NUMA node of the given input buffer.
+  void bind_input_thread(size_t c);
+
+  /// Bind the calling thread to the CPUs of the given timeslice builder.
+  void bind_builder_thread(size_t b);
+
+  /// Add the calling thread to the transport resctrl group, if any.
+  void join_transport_group() const;
+
+  /// Assign dedicated CPUs close to a NUMA node and log the result.
+  std::vector<int> assign_cpus(const std::string& name, int node,
+                               std::size_t count);
 };
@@ -1,7 +1,10 @@
 // Copyright 2012-2013 Jan de Cuveland <cmail@cuveland.de>
 
 #include "Parameters.hpp"
+#include "ChunkCodec.hpp"
 #include "GitRevision.hpp"
+#include "ResourceControl.hpp"
+#include "Topology.hpp"
 #include "Utility.hpp"
 #include "log.hpp"
 #include <algorithm>
@@ -9,6 +12,7 @@
 #include <boost/program_options.hpp>
 #include <fstream>
 #include <iterator>
+#include <sstream>
 
 namespace po = boost::program_options;
 
@@ -24,6 +28,12 @@ std::istream& operator>>(std::istream& in, Transport& transport) {
     transport = Transport::LibFabric;
   } else if (token == "zeromq" || token == "z") {
     transport = Transport::ZeroMQ;
+  } else if (token == "ucx" || token == "u") {
+    transport = Transport::UCX;
+  } else if (token == "tcp") {
+    transport = Transport::TCP;
+  } else if (token == "shm" || token == "s") {
+    transport = Transport::SHM;
   } else {
     throw po::invalid_option_value(token);
   }
@@ -41,6 +51,104 @@ std::ostream& operator<<(std::ostream& out, const Transport& transport) {
   case Transport::ZeroMQ:
     out << "ZeroMQ";
     break;
+  case Transport::UCX:
+    out << "UCX";
+    break;
+  case Transport::TCP:
+    out << "TCP";
+    break;
+  case Transport::SHM:
+    out << "SHM";
+    break;
+  }
+  return out;
+}
+
+std::istream& operator>>(std::istream& in, ThreadPlacement& placement) {
+  std::string token;
+  in >> token;
+  std::transform(std::begin(token), std::end(token), std::begin(token),
+                 [](const unsigned char i) { return tolower(i); });
+
+  if (token == "none") {
+    placement = ThreadPlacement::None;
+  } else if (token == "topology") {
+    placement = ThreadPlacement::Topology;
+  } else {
+    throw po::invalid_option_value(token);
+  }
+  return in;
+}
+
+std::ostream& operator<<(std::ostream& out, const ThreadPlacement& placement) {
+  switch (placement) {
+  case ThreadPlacement::None:
+    out << "None";
+    break;
+  case ThreadPlacement::Topology:
+    out << "Topology";
+    break;
+  }
+  return out;
+}
+
+std::istream& operator>>(std::istream& in, ProgressMode& mode) {
+  std::string token;
+  in >> token;
+  std::transform(std::begin(token), std::end(token), std::begin(token),
+                 [](const unsigned char i) { return tolower(i); });
+
+  if (token == "busy") {
+    mode = ProgressMode::Busy;
+  } else if (token == "adaptive") {
+    mode = ProgressMode::Adaptive;
+  } else if (token == "blocking") {
+    mode = ProgressMode::Blocking;
+  } else {
+    throw po::invalid_option_value(token);
+  }
+  return in;
+}
+
+std::ostream& operator<<(std::ostream& out, const ProgressMode& mode) {
+  switch (mode) {
+  case ProgressMode::Busy:
+    out << "Busy";
+    break;
+  case ProgressMode::Adaptive:
+    out << "Adaptive";
+    break;
+  case ProgressMode::Blocking:
+    out << "Blocking";
+    break;
+  }
+  return out;
+}
+
+std::istream& operator>>(std::istream& in, SchedulerPolicy& policy) {
+  std::string token;
+  in >> token;
+  std::transform(std::begin(token), std::end(token), std::begin(token),
+                 [](const unsigned char i) { return tolower(i); });
+
+  if (token == "heuristic") {
+    policy = SchedulerPolicy::Heuristic;
+  } else if (token == "model") {
+    policy = SchedulerPolicy::Model;
+  } else {
+    throw po::invalid_option_value(token);
+  }
+  return in;
+}
+
+std::ostream& operator<<(std::ostream& out, const SchedulerPolicy& policy) {
+  switch (policy) {
+  case SchedulerPolicy::Heuristic:
+    out << "Heuristic";
+    break;
+  case SchedulerPolicy::Model:
+    out << "Model";
+    break;
   }
   return out;
 }
@@ -53,7 +161,26 @@ std::istream& operator>>(std::istream& in, InterfaceSpecification& ifspec) {
     ifspec.host = uri.authority;
     ifspec.path = split(uri.path, "/");
     ifspec.param = uri.query_components;
-  } catch (const std::runtime_error& e) {
+    if (ifspec.param.count("hugepages") != 0u) {
+      ifspec.memory_policy.huge_pages =
+          parse_huge_pages(ifspec.param.at("hugepages"));
+    }
+    if (ifspec.param.count("numa") != 0u) {
+      ifspec.memory_policy.numa_node = std::stoi(ifspec.param.at("numa"));
+    }
+    if (ifspec.param.count("mirror") != 0u) {
+      ifspec.memory_policy.mirrored = std::stoi(ifspec.param.at("mirror")) != 0;
+    }
+    if (ifspec.param.count("gpu") != 0u) {
+      ifspec.memory_policy.device = std::stoi(ifspec.param.at("gpu"));
+    }
+    if (ifspec.param.count("rails") != 0u) {
+      ifspec.rails = split(ifspec.param.at("rails"), ",");
+    }
+    if (ifspec.param.count("standby") != 0u) {
+      ifspec.standby = std::stoi(ifspec.param.at("standby")) != 0;
+    }
+  } catch (const std::exception& e) {
     throw po::invalid_option_value(ifspec.full_uri);
   }
   return in;
@@ -70,6 +197,12 @@ void Parameters::parse_options(int argc, char* argv[]) {
   unsigned log_syslog = 2;
   std::string log_file;
   std::string config_file;
+  std::string housekeeping_cpus = "0";
+  std::string resctrl_transport_schemata;
+  std::string resctrl_processor_schemata;
+  std::vector<std::string> shedding_levels;
+  std::string link_model;
+  std::string processor_autoscale;
 
   po::options_description generic("Generic options");
   auto generic_add = generic.add_options();
@@ -95,6 +228,32 @@ void Parameters::parse_options(int argc, char* argv[]) {
                   ->implicit_value("influx1:login:8086:flesnet_status"),
               "publish flesnet status to InfluxDB (or \"file:cout\" for "
               "console output)");
+  generic_add("monitor-interval",
+              po::value<uint32_t>(&monitor_interval_)
+                  ->default_value(monitor_interval_)
+                  ->value_name("<ms>"),
+              "interval of the buffer status and backpressure reports (RDMA "
+              "and item distributors)");
+  generic_add("perf-counters", po::bool_switch(&perf_counters_),
+              "publish hardware performance counters per loop phase of the "
+              "transport threads with the status reports (RDMA)");
+  generic_add("allocation-stats", po::bool_switch(&allocation_stats_),
+              "publish the live bytes, allocation rate and peak of the "
+              "timeslice, microslice, item and metric objects");
+  generic_add("thread-stats", po::bool_switch(&thread_stats_),
+              "publish the CPU utilization, run queue wait and context "
+              "switch rates of the named threads");
+  generic_add("live-stats", po::bool_switch(&live_stats_),
+              "publish live counters and microslice size histograms of the "
+              "timeslice buffers in a shared memory segment for external "
+              "tools (see fles_stats)");
+  generic_add("trace-file",
+              po::value<std::string>(&trace_file_)->value_name("<filename>"),
+              "record a binary event trace of the data path, written to file "
+              "on SIGUSR2 and at exit (convert with trace2json)");
+  generic_add("trace-continuous",
+              po::bool_switch(&trace_continuous_),
+              "write all events of the trace to file continuously");
   generic_add("help,h", "display this help and exit");
   generic_add("version,V", "output version information and exit");
 
@@ -123,6 +282,18 @@ void Parameters::parse_options(int argc, char* argv[]) {
                  ->default_value(timeslice_size_)
                  ->value_name("<n>"),
              "set the global timeslice size in number of microslices");
+  config_add("timeslice-duration",
+             po::value<uint64_t>(&timeslice_duration_)->value_name("<ns>"),
+             "cut timeslices by microslice start time into windows of the "
+             "given duration instead of by microslice count");
+  config_add("overlap-duration",
+             po::value<uint64_t>(&overlap_duration_)->value_name("<ns>"),
+             "set the overlap duration of time-based timeslices");
+  config_add("timeslice-target-bytes",
+             po::value<uint64_t>(&timeslice_target_bytes_)->value_name("<n>"),
+             "adapt the timeslice size to the data rate to reach the given "
+             "number of bytes per timeslice, up to the timeslice size "
+             "(libfabric only)");
   config_add("max-timeslice-number,n",
              po::value<uint32_t>(&max_timeslice_number_)->value_name("<n>"),
              "quit after processing given number of timeslices");
@@ -135,6 +306,13 @@ void Parameters::parse_options(int argc, char* argv[]) {
                  ->default_value(processor_instances_)
                  ->value_name("<n>"),
              "number of instances of the timeslice processor executable");
+  config_add("processor-autoscale",
+             po::value<std::string>(&processor_autoscale)
+                 ->value_name("<key>=<value>,..."),
+             "scale the number of processor instances with the pending work "
+             "items; keys are 'min' and 'max' (instances), 'up' and 'down' "
+             "(pending items per instance) and 'updelay' and 'downdelay' "
+             "(s), e.g. 'min=1,max=8,up=4,down=1'");
   config_add("base-port",
              po::value<uint32_t>(&base_port_)
                  ->default_value(base_port_)
@@ -145,7 +323,8 @@ void Parameters::parse_options(int argc, char* argv[]) {
                  ->default_value(transport_)
                  ->value_name("<id>"),
              "select transport implementation; possible values "
-             "(case-insensitive) are: RDMA, LibFabric, ZeroMQ");
+             "(case-insensitive) are: RDMA, LibFabric, ZeroMQ, UCX, TCP, "
+             "SHM (all inputs and outputs in this process)");
   config_add("discard-all-ts",
              po::value<bool>(&drop_process_ts_)->default_value(false),
              "Discard all timeslices at receiver (debug only)");
@@ -156,6 +335,35 @@ void Parameters::parse_options(int argc, char* argv[]) {
       "scheduler-interval-length",
       po::value<uint32_t>(&scheduler_interval_length_)->default_value(10000),
       "The initial scheduler interval Timeslices (LibFabric only)");
+  config_add("scheduler-bandwidth-aware-placement",
+             po::value<bool>(&scheduler_bandwidth_aware_placement_)
+                 ->default_value(false),
+             "Down-weight slow compute nodes when placing timeslices "
+             "(LibFabric only)");
+  config_add("scheduler-staggered-transfers",
+             po::value<bool>(&scheduler_staggered_transfers_)
+                 ->default_value(false),
+             "Spread the transfers of each round over time so that the "
+             "input nodes target different compute nodes (LibFabric only)");
+  config_add("scheduler-shedding-level",
+             po::value<std::vector<std::string>>(&shedding_levels)
+                 ->multitoken()
+                 ->value_name("<fill>:<keep> ..."),
+             "keep only <keep> percent of the timeslices while an input "
+             "buffer is at least <fill> percent full (LibFabric only)");
+  config_add("scheduler-shedding-priority-interval",
+             po::value<uint32_t>(&scheduler_shedding_priority_interval_)
+                 ->default_value(0)
+                 ->value_name("<n>"),
+             "never shed every n-th timeslice, 0 for none (LibFabric only)");
+  config_add("link-model",
+             po::value<std::string>(&link_model)
+                 ->value_name("<key>=<value>,..."),
+             "hold back the transfers of the inputs to emulate network links "
+             "on a single host; keys are 'latency' and 'jitter' (ns), "
+             "'bandwidth' (per link) and 'uplink' (per input) in bytes/s, "
+             "and 'seed', e.g. 'latency=20000,bandwidth=1.2e9' (LibFabric "
+             "only)");
   config_add("scheduler-speedup-difference-percentage",
              po::value<uint32_t>(&scheduler_speedup_difference_percentage_)
                  ->default_value(0),
@@ -168,6 +376,19 @@ void Parameters::parse_options(int argc, char* argv[]) {
       "scheduler-speedup-interval-count",
       po::value<uint32_t>(&scheduler_speedup_interval_count_)->default_value(0),
       "The scheduler speeding up interval count (LibFabric only)");
+  config_add("scheduler-policy",
+             po::value<SchedulerPolicy>(&scheduler_policy_)
+                 ->default_value(scheduler_policy_)
+                 ->value_name("<id>"),
+             "interval pacing of the scheduler; possible values "
+             "(case-insensitive) are: Heuristic (speedup parameters), Model "
+             "(online throughput model) (LibFabric only)");
+  config_add("scheduler-target-buffer-fill",
+             po::value<uint32_t>(&scheduler_target_buffer_fill_)
+                 ->default_value(scheduler_target_buffer_fill_)
+                 ->value_name("<fill>"),
+             "compute buffer fill percentage the Model scheduler policy "
+             "paces the intervals towards (LibFabric only)");
   config_add(
       "scheduler-log-directory",
       po::value<std::string>(&scheduler_log_directory_)->default_value("."),
@@ -175,9 +396,251 @@ void Parameters::parse_options(int argc, char* argv[]) {
   config_add("scheduler-enable-logging",
              po::value<bool>(&scheduler_enable_logging_)->default_value(false),
              "Enable generating logging files (LibFabric only)");
+  config_add("progress-mode",
+             po::value<ProgressMode>(&progress_mode_)
+                 ->default_value(progress_mode_)
+                 ->value_name("<id>"),
+             "event loop behavior when idle; possible values "
+             "(case-insensitive) are: Busy, Adaptive, Blocking (LibFabric "
+             "and RDMA)");
+  config_add("progress-spin-time",
+             po::value<uint32_t>(&progress_spin_time_)
+                 ->default_value(progress_spin_time_)
+                 ->value_name("<us>"),
+             "time to keep polling after activity in Adaptive progress mode "
+             "(LibFabric and RDMA)");
+  config_add("ack-coalesce-count",
+             po::value<uint32_t>(&ack_coalesce_count_)
+                 ->default_value(ack_coalesce_count_)
+                 ->value_name("<n>"),
+             "acknowledge up to n timeslices per message to the input node, "
+             "1 sends every acknowledgement immediately (LibFabric and RDMA "
+             "in pointer write mode)");
+  config_add("ack-coalesce-delay",
+             po::value<uint32_t>(&ack_coalesce_delay_)
+                 ->default_value(ack_coalesce_delay_)
+                 ->value_name("<us>"),
+             "maximum time a coalesced acknowledgement is held back");
+  config_add("ack-expedite-fill",
+             po::value<double>(&ack_expedite_fill_)
+                 ->default_value(ack_expedite_fill_)
+                 ->value_name("<fraction>"),
+             "send a held back acknowledgement immediately once the input "
+             "node's view of the buffer is filled to the given fraction");
+  config_add("write-signal-interval",
+             po::value<uint32_t>(&write_signal_interval_)
+                 ->default_value(write_signal_interval_)
+                 ->value_name("<n>"),
+             "request a completion only for the RDMA writes of every n-th "
+             "timeslice per connection (LibFabric only)");
+  config_add("inline-data-size",
+             po::value<uint32_t>(&inline_data_size_)->value_name("<bytes>"),
+             "write timeslice components up to the given size inline, i.e., "
+             "copied into the work request, for low latency with small "
+             "components (RDMA and LibFabric, limited by the provider)");
+  config_add("shared-receive-context",
+             po::value<bool>(&shared_receive_context_)->default_value(false),
+             "receive control messages from all input nodes through one "
+             "shared receive context (LibFabric only)");
+  config_add("on-demand-paging",
+             po::value<bool>(&on_demand_paging_)->default_value(false),
+             "register memory for on-demand paging instead of pinning it, "
+             "where supported by the provider (LibFabric verbs only)");
+  config_add("provider-probe",
+             po::value<bool>(&provider_probe_)->default_value(false),
+             "log the attributes of all available providers at startup and "
+             "size the connection queues from the selected one (LibFabric "
+             "only)");
+  config_add("warm-buffers",
+             po::value<uint32_t>(&warm_buffers_)
+                 ->default_value(warm_buffers_)
+                 ->value_name("<n>"),
+             "fault in the timeslice buffers and pattern generator input "
+             "buffers on <n> background threads while the connections are "
+             "set up, so that the memory registration only needs to pin "
+             "them (0: off)");
+  config_add("dedicated-heartbeat",
+             po::value<bool>(&dedicated_heartbeat_)->default_value(false),
+             "detect failed nodes by RDMA heartbeat counters written from a "
+             "dedicated thread (connection-less LibFabric only)");
+  config_add("progress-threads",
+             po::value<uint32_t>(&progress_threads_)
+                 ->default_value(progress_threads_)
+                 ->value_name("<n>"),
+             "number of threads to distribute the input connections of a "
+             "compute node over (RDMA only)");
+  config_add("pointer-write",
+             po::value<bool>(&pointer_write_)->default_value(false),
+             "exchange buffer positions by RDMA writes into polled status "
+             "slots instead of status messages (RDMA only)");
+  config_add("write-with-imm",
+             po::value<bool>(&write_with_imm_)->default_value(false),
+             "write timeslice component descriptors with immediate data to "
+             "notify the compute node instead of fencing them behind the "
+             "data (RDMA only)");
+  config_add("rdma-pull", po::value<bool>(&rdma_pull_)->default_value(false),
+             "let the compute nodes read the timeslice components from the "
+             "input buffers at their own pace instead of the inputs writing "
+             "them (RDMA only, count-based timeslices)");
+  config_add("control-connections",
+             po::value<bool>(&control_connections_)->default_value(false),
+             "exchange the status of each connection over a separate "
+             "connection, so that it does not queue behind the component "
+             "transfers (RDMA only)");
+  config_add("control-tos",
+             po::value<uint32_t>(&control_tos_)
+                 ->default_value(control_tos_)
+                 ->value_name("<tos>"),
+             "type of service of the control connections, selecting their "
+             "traffic class or service level (RDMA only)");
+  config_add("content-alignment",
+             po::value<uint32_t>(&content_alignment_)->value_name("<bytes>"),
+             "place the component contents in the compute node buffers at "
+             "the input buffer offset modulo the given power of two, so "
+             "that microslices aligned by the input (e.g., pgen align=64) "
+             "stay aligned (RDMA only, without rdma-pull)");
+  config_add("zeromq-streams",
+             po::value<uint32_t>(&zeromq_streams_)
+                 ->default_value(zeromq_streams_)
+                 ->value_name("<n>"),
+             "number of parallel streams per input connection, over which "
+             "each component is striped (ZeroMQ only)");
+  config_add("zeromq-io-threads",
+             po::value<uint32_t>(&zeromq_io_threads_)
+                 ->default_value(zeromq_io_threads_)
+                 ->value_name("<n>"),
+             "number of ZeroMQ I/O threads per process (ZeroMQ only)");
+  config_add("tcp-streams",
+             po::value<uint32_t>(&tcp_streams_)
+                 ->default_value(tcp_streams_)
+                 ->value_name("<n>"),
+             "number of parallel TCP streams per input connection (TCP "
+             "only)");
+  config_add("tcp-zerocopy",
+             po::value<bool>(&tcp_zerocopy_)->default_value(tcp_zerocopy_),
+             "send timeslice data from the input buffer with MSG_ZEROCOPY "
+             "where supported (TCP only)");
+  config_add("tcp-compression",
+             po::value<std::string>(&tcp_compression_)->value_name("<codec>"),
+             "compress the timeslice components sent to this compute node "
+             "with the given codec ('zstd', or 'shuffle<n>' and 'delta<n>' "
+             "for words of n bytes) (TCP only)");
+  config_add("tcp-compression-level",
+             po::value<int32_t>(&tcp_compression_level_)
+                 ->default_value(tcp_compression_level_)
+                 ->value_name("<n>"),
+             "level of the timeslice component compression (TCP only)");
+  config_add("tcp-compression-threads",
+             po::value<uint32_t>(&tcp_compression_threads_)
+                 ->default_value(tcp_compression_threads_)
+                 ->value_name("<n>"),
+             "number of threads compressing or decompressing the timeslice "
+             "components of a sender or builder (0: in its own thread) (TCP "
+             "only)");
+  config_add("tcp-overlap-sharing",
+             po::value<bool>(&tcp_overlap_sharing_)->default_value(false),
+             "transfer the overlap microslice contents from the input nodes "
+             "only once and let each compute node fetch them from the one "
+             "building the next timeslice (TCP only)");
+  config_add("timeslice-deadline",
+             po::value<uint32_t>(&timeslice_deadline_)
+                 ->default_value(timeslice_deadline_)
+                 ->value_name("<ms>"),
+             "hand on a timeslice with the components not yet available "
+             "marked as missing once this time has passed after its first "
+             "request, and discard them on the inputs (0: wait "
+             "indefinitely) (TCP only, not with overlap sharing)");
+  config_add("thread-placement",
+             po::value<ThreadPlacement>(&thread_placement_)
+                 ->default_value(thread_placement_)
+                 ->value_name("<id>"),
+             "pin threads to cores; possible values (case-insensitive) are: "
+             "None, Topology (input channels near their input buffer, "
+             "timeslice builders near their network interface)");
+  config_add("housekeeping-cpus",
+             po::value<std::string>(&housekeeping_cpus)
+                 ->default_value(housekeeping_cpus)
+                 ->value_name("<list>"),
+             "CPUs (e.g., 0-1,8) for the monitoring, tracing and "
+             "distribution threads in Topology placement");
+  config_add("resctrl-transport",
+             po::value<std::string>(&resctrl_transport_)
+                 ->value_name("<name>"),
+             "add the input channel, timeslice builder and item distributor "
+             "threads to this Linux resctrl group (created if needed) to "
+             "reserve them a share of the last-level cache and memory "
+             "bandwidth");
+  config_add("resctrl-transport-schemata",
+             po::value<std::string>(&resctrl_transport_schemata)
+                 ->value_name("<lines>"),
+             "cache and memory bandwidth allocation of the transport group, "
+             "comma-separated schemata lines (e.g., "
+             "L3:0=ff0;1=ff0,MB:0=50;1=50)");
+  config_add("resctrl-processor",
+             po::value<std::string>(&resctrl_processor_)
+                 ->value_name("<name>"),
+             "add the processor instances to this Linux resctrl group "
+             "(created if needed)");
+  config_add("resctrl-processor-schemata",
+             po::value<std::string>(&resctrl_processor_schemata)
+                 ->value_name("<lines>"),
+             "cache and memory bandwidth allocation of the processor group, "
+             "comma-separated schemata lines (e.g., "
+             "L3:0=00f;1=00f,MB:0=30;1=30)");
+
+  po::options_description benchmark("Benchmark options");
+  auto benchmark_add = benchmark.add_options();
+  benchmark_add("self-check",
+                po::value<bool>(&self_check_)->implicit_value(true),
+                "measure the memory, shared memory, network and CRI "
+                "performance of this node, print a report with recommended "
+                "settings for the given configuration and exit");
+  benchmark_add(
+      "benchmark",
+      po::value<std::string>(&benchmark_report_)->value_name("<filename>"),
+      "run a benchmark sweep over the values given below and append a "
+      "report line (JSON) per point to file; all nodes need the same "
+      "options, the inputs must be pattern generators (pgen)");
+  benchmark_add("bench-duration",
+                po::value<uint32_t>(&benchmark_duration_)
+                    ->default_value(benchmark_duration_)
+                    ->value_name("<s>"),
+                "measurement duration per benchmark point");
+  benchmark_add("bench-transport",
+                po::value<std::vector<Transport>>(&benchmark_transports_)
+                    ->multitoken()
+                    ->value_name("<id> ..."),
+                "transports to benchmark (default: --transport)");
+  benchmark_add(
+      "bench-timeslice-size",
+      po::value<std::vector<uint32_t>>(&benchmark_timeslice_sizes_)
+          ->multitoken()
+          ->value_name("<n> ..."),
+      "timeslice sizes to benchmark (default: --timeslice-size)");
+  benchmark_add("bench-overlap",
+                po::value<std::vector<uint32_t>>(&benchmark_overlap_sizes_)
+                    ->multitoken()
+                    ->value_name("<n> ..."),
+                "overlap sizes to benchmark (default: of the first input)");
+  benchmark_add(
+      "bench-microslice-size",
+      po::value<std::vector<uint32_t>>(&benchmark_microslice_sizes_)
+          ->multitoken()
+          ->value_name("<bytes> ..."),
+      "mean microslice sizes to benchmark (default: of the first input)");
+  benchmark_add("bench-inputs",
+                po::value<std::vector<uint32_t>>(&benchmark_num_inputs_)
+                    ->multitoken()
+                    ->value_name("<n> ..."),
+                "numbers of inputs to benchmark (default: all)");
+  benchmark_add("bench-outputs",
+                po::value<std::vector<uint32_t>>(&benchmark_num_outputs_)
+                    ->multitoken()
+                    ->value_name("<n> ..."),
+                "numbers of compute nodes to benchmark (default: all)");
 
   po::options_description cmdline_options("Allowed options");
-  cmdline_options.add(generic).add(config);
+  cmdline_options.add(generic).add(config).add(benchmark);
 
   po::variables_map vm;
   po::store(po::parse_command_line(argc, argv, cmdline_options), vm);
@@ -222,6 +685,143 @@ void Parameters::parse_options(int argc, char* argv[]) {
     throw ParametersException("timeslice size cannot be zero");
   }
 
+  if (timeslice_duration_ != 0 && transport_ != Transport::RDMA &&
+      transport_ != Transport::TCP && transport_ != Transport::SHM) {
+    throw ParametersException(
+        "time-based timeslices require the rdma, tcp or shm transport");
+  }
+
+  if (timeslice_target_bytes_ != 0 &&
+      (transport_ != Transport::LibFabric || timeslice_duration_ != 0)) {
+    throw ParametersException("timeslice-target-bytes requires the libfabric "
+                              "transport and count-based timeslices");
+  }
+
+  if (rdma_pull_ && (transport_ != Transport::RDMA ||
+                     timeslice_duration_ != 0 || write_with_imm_)) {
+    throw ParametersException("rdma-pull requires the rdma transport and "
+                              "count-based timeslices, without "
+                              "write-with-imm");
+  }
+
+  if (content_alignment_ != 0 &&
+      ((content_alignment_ & (content_alignment_ - 1)) != 0 ||
+       transport_ != Transport::RDMA || rdma_pull_)) {
+    throw ParametersException("content-alignment requires a power of two "
+                              "and the rdma transport, without rdma-pull");
+  }
+
+  if (inline_data_size_ != 0 && transport_ != Transport::RDMA &&
+      transport_ != Transport::LibFabric) {
+    throw ParametersException("inline-data-size requires the rdma or "
+                              "libfabric transport");
+  }
+
+  if (control_connections_ && transport_ != Transport::RDMA) {
+    throw ParametersException("control-connections requires the rdma "
+                              "transport");
+  }
+
+  if (control_tos_ > 255) {
+    throw ParametersException("control-tos must be in the range 0..255");
+  }
+
+  if (progress_threads_ < 1) {
+    throw ParametersException("number of progress threads cannot be zero");
+  }
+
+  if (monitor_interval_ < 1) {
+    throw ParametersException("monitor interval cannot be zero");
+  }
+
+  if (zeromq_streams_ < 1) {
+    throw ParametersException("number of ZeroMQ streams cannot be zero");
+  }
+
+  if (zeromq_io_threads_ < 1) {
+    throw ParametersException("number of ZeroMQ I/O threads cannot be zero");
+  }
+
+  if (tcp_streams_ < 1) {
+    throw ParametersException("number of TCP streams cannot be zero");
+  }
+
+  if (!tcp_compression_.empty()) {
+    try {
+      fles::make_chunk_codec(tcp_compression_, tcp_compression_level_);
+    } catch (const std::invalid_argument& e) {
+      throw ParametersException(e.what());
+    } catch (const std::runtime_error& e) {
+      L_(warning) << "TCP component compression disabled: " << e.what();
+      tcp_compression_.clear();
+    }
+  }
+
+  if (ack_coalesce_count_ < 1) {
+    throw ParametersException("ack coalesce count cannot be zero");
+  }
+
+  if (ack_expedite_fill_ <= 0. || ack_expedite_fill_ > 1.) {
+    throw ParametersException("ack-expedite-fill must be in the range "
+                              "(0, 1]");
+  }
+
+  if (write_signal_interval_ < 1) {
+    throw ParametersException("write signal interval cannot be zero");
+  }
+
+  for (const auto& level : shedding_levels) {
+    uint32_t fill = 0;
+    uint32_t keep = 0;
+    char separator = 0;
+    std::istringstream iss(level);
+    if (!(iss >> fill >> separator >> keep) || separator != ':' ||
+        !iss.eof() || fill < 1 || fill > 100 || keep > 100) {
+      throw ParametersException("invalid shedding level: " + level);
+    }
+    scheduler_shedding_levels_.emplace_back(fill, keep);
+  }
+
+  try {
+    link_model_ = LinkModelParameters::parse(link_model);
+  } catch (const std::invalid_argument& e) {
+    throw ParametersException(e.what());
+  }
+
+  try {
+    processor_scaling_ = ProcessorScalingParameters::parse(processor_autoscale);
+  } catch (const std::invalid_argument& e) {
+    throw ParametersException(e.what());
+  }
+
+  try {
+    housekeeping_cpus_ = parse_cpu_list(housekeeping_cpus);
+  } catch (const std::invalid_argument& e) {
+    throw ParametersException(e.what());
+  }
+  if (thread_placement_ == ThreadPlacement::Topology &&
+      housekeeping_cpus_.empty()) {
+    throw ParametersException("list of housekeeping CPUs is empty");
+  }
+
+  try {
+    resctrl_transport_schemata_ =
+        parse_resctrl_schemata(resctrl_transport_schemata);
+    resctrl_processor_schemata_ =
+        parse_resctrl_schemata(resctrl_processor_schemata);
+  } catch (const std::invalid_argument& e) {
+    throw ParametersException(e.what());
+  }
+  if ((resctrl_transport_.empty() && !resctrl_transport_schemata_.empty()) ||
+      (resctrl_processor_.empty() && !resctrl_processor_schemata_.empty())) {
+    throw ParametersException("resctrl schemata given without group name");
+  }
+  if (!resctrl_transport_.empty() &&
+      resctrl_transport_ == resctrl_processor_) {
+    throw ParametersException(
+        "transport and processor resctrl groups are the same");
+  }
+
 #ifndef HAVE_RDMA
   if (transport_ == Transport::RDMA) {
     throw ParametersException("flesnet built without RDMA support");
@@ -232,6 +832,11 @@ void Parameters::parse_options(int argc, char* argv[]) {
     throw ParametersException("flesnet built without LIBFABRIC support");
   }
 #endif
+#ifndef HAVE_UCX
+  if (transport_ == Transport::UCX) {
+    throw ParametersException("flesnet built without UCX support");
+  }
+#endif
 
   if (vm.count("input") == 0u) {
     throw ParametersException("list of inputs is empty");
@@ -260,6 +865,30 @@ void Parameters::parse_options(int argc, char* argv[]) {
       throw ParametersException("invalid output specification: " +
                                 output.full_uri);
     }
+    // the other transports access the data buffers from the host
+    if (output.memory_policy.device >= 0 && transport_ != Transport::RDMA) {
+      throw ParametersException("timeslice buffers on a GPU are only "
+                                "supported with the RDMA transport");
+    }
+    if (output.standby && transport_ != Transport::LibFabric) {
+      throw ParametersException("standby outputs are only supported with "
+                                "the LibFabric transport");
+    }
+  }
+  if (!outputs_.empty() &&
+      std::all_of(outputs_.begin(), outputs_.end(),
+                  [](const auto& output) { return output.standby; })) {
+    throw ParametersException("at least one output must not be on standby");
+  }
+  if (tcp_overlap_sharing_ &&
+      (transport_ != Transport::TCP || outputs_.size() < 2)) {
+    throw ParametersException(
+        "overlap sharing requires the tcp transport and two outputs");
+  }
+  if (timeslice_deadline_ != 0 &&
+      (transport_ != Transport::TCP || tcp_overlap_sharing_)) {
+    throw ParametersException("timeslice-deadline requires the tcp transport "
+                              "without overlap sharing");
   }
 
   if (vm.count("input-index") != 0u) {
@@ -291,6 +920,11 @@ void Parameters::parse_options(int argc, char* argv[]) {
     }
   }
 
+  if (transport_ == Transport::SHM && !local_only()) {
+    throw ParametersException(
+        "SHM transport requires all inputs and outputs in this process");
+  }
+
   if (!outputs_.empty() && processor_executable_.empty()) {
     throw ParametersException("processor executable not specified");
   }
@@ -314,8 +948,142 @@ void Parameters::parse_options(int argc, char* argv[]) {
 
   for (auto input_index : input_indexes_) {
     if (input_index == 0) {
-      L_(info) << "timeslice size: " << timeslice_size_ << " microslices";
+      if (timeslice_duration_ != 0) {
+        L_(info) << "timeslice duration: " << timeslice_duration_ << " ns";
+      } else {
+        L_(info) << "timeslice size: " << timeslice_size_ << " microslices";
+      }
+      if (timeslice_target_bytes_ != 0) {
+        L_(info) << "timeslice target size: " << timeslice_target_bytes_
+                 << " bytes";
+      }
       L_(info) << "number of timeslices: " << max_timeslice_number_;
     }
   }
+
+  all_inputs_ = inputs_;
+  all_outputs_ = outputs_;
+  all_input_indexes_ = input_indexes_;
+  all_output_indexes_ = output_indexes_;
+
+  if (!benchmark_report_.empty()) {
+    check_benchmark_options();
+  }
+}
+
+void Parameters::check_benchmark_options() const {
+  if (!trace_file_.empty()) {
+    throw ParametersException("event trace cannot be used in benchmark mode");
+  }
+  if (benchmark_duration_ < 1) {
+    throw ParametersException("benchmark duration cannot be zero");
+  }
+  for (const auto& input : inputs_) {
+    if (input.scheme != "pgen") {
+      throw ParametersException("benchmark requires pattern generator "
+                                "inputs: " +
+                                input.full_uri);
+    }
+  }
+  for (auto size : benchmark_timeslice_sizes_) {
+    if (size < 1) {
+      throw ParametersException("timeslice size cannot be zero");
+    }
+  }
+  [[maybe_unused]] auto benchmarks = [this](Transport transport) {
+    return std::find(benchmark_transports_.begin(),
+                     benchmark_transports_.end(),
+                     transport) != benchmark_transports_.end();
+  };
+#ifndef HAVE_RDMA
+  if (benchmarks(Transport::RDMA)) {
+    throw ParametersException("flesnet built without RDMA support");
+  }
+#endif
+#ifndef HAVE_LIBFABRIC
+  if (benchmarks(Transport::LibFabric)) {
+    throw ParametersException("flesnet built without LIBFABRIC support");
+  }
+#endif
+#ifndef HAVE_UCX
+  if (benchmarks(Transport::UCX)) {
+    throw ParametersException("flesnet built without UCX support");
+  }
+#endif
+  for (auto n : benchmark_num_inputs_) {
+    if (n < 1 || n > inputs_.size()) {
+      throw ParametersException("number of benchmark inputs out of range: " +
+                                std::to_string(n));
+    }
+  }
+  for (auto n : benchmark_num_outputs_) {
+    if (n < 1 || n > outputs_.size()) {
+      throw ParametersException("number of benchmark outputs out of range: " +
+                                std::to_string(n));
+    }
+  }
+}
+
+std::vector<BenchmarkPoint> Parameters::benchmark_points() const {
+  const auto& param = all_inputs_.at(0).param;
+  auto or_default = [](std::vector<uint32_t> values, uint32_t value) {
+    return values.empty() ? std::vector<uint32_t>{value} : values;
+  };
+
+  auto transports = benchmark_transports_;
+  if (transports.empty()) {
+    transports.push_back(transport_);
+  }
+  auto timeslice_sizes = or_default(benchmark_timeslice_sizes_,
+                                    timeslice_size_);
+  auto overlap_sizes = or_default(
+      benchmark_overlap_sizes_,
+      param.count("overlap") != 0u ? stou(param.at("overlap")) : 1);
+  auto microslice_sizes = or_default(
+      benchmark_microslice_sizes_,
+      param.count("mean") != 0u ? stou(param.at("mean")) : 1024);
+  auto num_inputs = or_default(benchmark_num_inputs_,
+                               static_cast<uint32_t>(all_inputs_.size()));
+  auto num_outputs = or_default(benchmark_num_outputs_,
+                                static_cast<uint32_t>(all_outputs_.size()));
+
+  std::vector<BenchmarkPoint> points;
+  for (auto transport : transports) {
+    for (auto timeslice_size : timeslice_sizes) {
+      for (auto overlap_size : overlap_sizes) {
+        for (auto microslice_size : microslice_sizes) {
+          for (auto inputs : num_inputs) {
+            for (auto outputs : num_outputs) {
+              points.push_back({transport, timeslice_size, overlap_size,
+                                microslice_size, inputs, outputs});
+            }
+          }
+        }
+      }
+    }
+  }
+  return points;
+}
+
+void Parameters::apply_benchmark_point(const BenchmarkPoint& point) {
+  transport_ = point.transport;
+  timeslice_size_ = point.timeslice_size;
+
+  inputs_.assign(all_inputs_.begin(),
+                 all_inputs_.begin() + point.num_inputs);
+  for (auto& input : inputs_) {
+    input.param["overlap"] = std::to_string(point.overlap_size);
+    input.param["mean"] = std::to_string(point.microslice_size);
+  }
+  outputs_.assign(all_outputs_.begin(),
+                  all_outputs_.begin() + point.num_outputs);
+
+  input_indexes_.clear();
+  std::copy_if(all_input_indexes_.begin(), all_input_indexes_.end(),
+               std::back_inserter(input_indexes_),
+               [&](unsigned i) { return i < point.num_inputs; });
+  output_indexes_.clear();
+  std::copy_if(all_output_indexes_.begin(), all_output_indexes_.end(),
+               std::back_inserter(output_indexes_),
+               [&](unsigned i) { return i < point.num_outputs; });
 }
@@ -1,10 +1,18 @@
 // Copyright 2012-2013 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include "AckCoalescer.hpp"
+#include "LinkModel.hpp"
+#include "MemoryPolicy.hpp"
+#include "ProcessorScaler.hpp"
+#include "ProgressMode.hpp"
+#include "SchedulerPolicy.hpp"
+#include <chrono>
 #include <cstdint>
 #include <map>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 /// Run parameter exception class.
@@ -24,14 +32,45 @@ struct InterfaceSpecification {
   std::string host;
   std::vector<std::string> path;
   std::map<std::string, std::string> param;
+  /// Buffer placement from the 'hugepages', 'numa', 'mirror' and 'gpu'
+  /// parameters.
+  MemoryPolicy memory_policy;
+  /// Addresses of additional network interfaces from the 'rails' parameter
+  /// (comma-separated, LibFabric only).
+  std::vector<std::string> rails;
+  /// Whether the output joins the running system later, from the 'standby'
+  /// parameter (LibFabric only).
+  bool standby = false;
 };
 
 /// Transport implementation enum.
-enum class Transport { RDMA, LibFabric, ZeroMQ };
+enum class Transport { RDMA, LibFabric, ZeroMQ, UCX, TCP, SHM };
 
 std::istream& operator>>(std::istream& in, Transport& transport);
 std::ostream& operator<<(std::ostream& out, const Transport& transport);
 
+/// Thread placement policy enum.
+enum class ThreadPlacement { None, Topology };
+
+std::istream& operator>>(std::istream& in, ThreadPlacement& placement);
+std::ostream& operator<<(std::ostream& out, const ThreadPlacement& placement);
+
+std::istream& operator>>(std::istream& in, ProgressMode& mode);
+std::ostream& operator<<(std::ostream& out, const ProgressMode& mode);
+
+std::istream& operator>>(std::istream& in, SchedulerPolicy& policy);
+std::ostream& operator<<(std::ostream& out, const SchedulerPolicy& policy);
+
+/// One point of a benchmark parameter sweep.
+struct BenchmarkPoint {
+  Transport transport;      ///< transport implementation
+  uint32_t timeslice_size;  ///< timeslice size in microslices
+  uint32_t overlap_size;    ///< overlap size in microslices
+  uint32_t microslice_size; ///< mean microslice content size in bytes
+  uint32_t num_inputs;      ///< number of participating inputs
+  uint32_t num_outputs;     ///< number of participating compute nodes
+};
+
 /// Global run parameter class.
 /** A Parameters object stores the information given on the command
     line or in a configuration file. */
@@ -46,9 +85,75 @@ public:
 
   [[nodiscard]] std::string monitor_uri() const { return monitor_uri_; }
 
+  /// Retrieve the interval of the buffer status reports.
+  [[nodiscard]] std::chrono::milliseconds monitor_interval() const {
+    return std::chrono::milliseconds(monitor_interval_);
+  }
+
+  /// Retrieve whether hardware performance counters are published (RDMA).
+  [[nodiscard]] bool perf_counters() const { return perf_counters_; }
+
+  /// Retrieve whether allocation statistics are published.
+  [[nodiscard]] bool allocation_stats() const { return allocation_stats_; }
+
+  /// Retrieve whether the statistics of the named threads are published.
+  [[nodiscard]] bool thread_stats() const { return thread_stats_; }
+
+  /// Retrieve whether to publish live statistics in shared memory.
+  [[nodiscard]] bool live_stats() const { return live_stats_; }
+
+  /// Retrieve the event trace file name (empty if tracing is disabled).
+  [[nodiscard]] std::string trace_file() const { return trace_file_; }
+
+  /// Retrieve whether the event trace is written continuously.
+  [[nodiscard]] bool trace_continuous() const { return trace_continuous_; }
+
+  /// Retrieve whether to run the node performance self-check instead.
+  [[nodiscard]] bool self_check() const { return self_check_; }
+
+  /// Retrieve the benchmark report file name (empty if not benchmarking).
+  [[nodiscard]] std::string benchmark_report() const {
+    return benchmark_report_;
+  }
+
+  /// Retrieve the measurement duration of each benchmark point.
+  [[nodiscard]] std::chrono::seconds benchmark_duration() const {
+    return std::chrono::seconds(benchmark_duration_);
+  }
+
+  /// Retrieve the points of the benchmark parameter sweep.
+  [[nodiscard]] std::vector<BenchmarkPoint> benchmark_points() const;
+
+  /// Override the run parameters with those of a benchmark point.
+  /** The inputs and compute nodes are restricted to the first
+      point.num_inputs and point.num_outputs entries of the configured
+      lists. */
+  void apply_benchmark_point(const BenchmarkPoint& point);
+
   /// Retrieve the global timeslice size in number of microslices.
   [[nodiscard]] uint32_t timeslice_size() const { return timeslice_size_; }
 
+  /// Retrieve the global timeslice duration in ns (zero if timeslices are
+  /// cut by microslice count).
+  [[nodiscard]] uint64_t timeslice_duration() const {
+    return timeslice_duration_;
+  }
+
+  /// Retrieve the global overlap duration of time-based timeslices in ns.
+  [[nodiscard]] uint64_t overlap_duration() const { return overlap_duration_; }
+
+  /// Retrieve the target number of bytes per timeslice (zero if the
+  /// timeslice size is fixed).
+  [[nodiscard]] uint64_t timeslice_target_bytes() const {
+    return timeslice_target_bytes_;
+  }
+
+  /// Retrieve the number of core microslices common to all timeslice
+  /// components (zero for time-based timeslices).
+  [[nodiscard]] uint32_t core_microslices() const {
+    return timeslice_duration_ != 0 ? 0 : timeslice_size_;
+  }
+
   /// Retrieve the global maximum timeslice number.
   [[nodiscard]] uint32_t max_timeslice_number() const {
     return max_timeslice_number_;
@@ -64,6 +169,11 @@ public:
     return processor_instances_;
   }
 
+  /// Retrieve the autoscaling of the timeslice processor instances.
+  [[nodiscard]] const ProcessorScalingParameters& processor_scaling() const {
+    return processor_scaling_;
+  }
+
   /// Retrieve the global base port.
   [[nodiscard]] uint32_t base_port() const { return base_port_; }
 
@@ -109,6 +219,32 @@ public:
     return scheduler_interval_length_;
   }
 
+  /// Check whether to place timeslices according to the compute node load
+  [[nodiscard]] bool scheduler_bandwidth_aware_placement() const {
+    return scheduler_bandwidth_aware_placement_;
+  }
+
+  /// Check whether to stagger the transfers of a round across compute nodes
+  [[nodiscard]] bool scheduler_staggered_transfers() const {
+    return scheduler_staggered_transfers_;
+  }
+
+  /// Retrieve the load shedding levels <fill percentage, keep percentage>
+  [[nodiscard]] const std::vector<std::pair<uint32_t, uint32_t>>&
+  scheduler_shedding_levels() const {
+    return scheduler_shedding_levels_;
+  }
+
+  /// Retrieve the emulated links from the inputs to the compute nodes
+  [[nodiscard]] const LinkModelParameters& link_model() const {
+    return link_model_;
+  }
+
+  /// Retrieve the interval of timeslices that are never shed
+  [[nodiscard]] uint32_t scheduler_shedding_priority_interval() const {
+    return scheduler_shedding_priority_interval_;
+  }
+
   /// Retrieve the maximum difference percentage between the proposed and the
   /// actual duration to apply the scheduler_speedup_percentage_
   [[nodiscard]] uint32_t scheduler_speedup_difference_percentage() const {
@@ -126,6 +262,16 @@ public:
     return scheduler_speedup_interval_count_;
   }
 
+  /// Retrieve the interval pacing policy of the scheduler
+  [[nodiscard]] SchedulerPolicy scheduler_policy() const {
+    return scheduler_policy_;
+  }
+
+  /// Retrieve the target compute buffer fill of the model-based scheduler
+  [[nodiscard]] uint32_t scheduler_target_buffer_fill() const {
+    return scheduler_target_buffer_fill_;
+  }
+
   /// Retrieve the directory to store DFS log files
   [[nodiscard]] std::string scheduler_log_directory() const {
     return scheduler_log_directory_;
@@ -136,15 +282,221 @@ public:
     return scheduler_enable_logging_;
   }
 
+  /// Retrieve the event loop progress mode (LibFabric and RDMA).
+  [[nodiscard]] ProgressMode progress_mode() const { return progress_mode_; }
+
+  /// Retrieve the time to keep polling after activity (LibFabric and RDMA).
+  [[nodiscard]] std::chrono::microseconds progress_spin_time() const {
+    return std::chrono::microseconds(progress_spin_time_);
+  }
+
+  /// Retrieve the parameters of the acknowledgement coalescing of the
+  /// compute node connections (LibFabric and RDMA).
+  [[nodiscard]] AckCoalescer::Parameters ack_coalescing() const {
+    return {ack_coalesce_count_,
+            std::chrono::microseconds(ack_coalesce_delay_), ack_expedite_fill_};
+  }
+
+  /// Retrieve the number of timeslices per signaled write (LibFabric only).
+  [[nodiscard]] uint32_t write_signal_interval() const {
+    return write_signal_interval_;
+  }
+
+  /// Retrieve the maximum size of the components written inline (RDMA and
+  /// LibFabric, zero if disabled).
+  [[nodiscard]] uint32_t inline_data_size() const { return inline_data_size_; }
+
+  /// Retrieve whether to use a shared receive context (LibFabric only).
+  [[nodiscard]] bool shared_receive_context() const {
+    return shared_receive_context_;
+  }
+
+  /// Retrieve whether to register memory for on-demand paging (LibFabric
+  /// only).
+  [[nodiscard]] bool on_demand_paging() const { return on_demand_paging_; }
+
+  /// Retrieve whether to probe the providers at startup (LibFabric only).
+  [[nodiscard]] bool provider_probe() const { return provider_probe_; }
+
+  /// Retrieve the number of threads to warm the buffers with at startup
+  /// (0: off).
+  [[nodiscard]] uint32_t warm_buffers() const { return warm_buffers_; }
+
+  /// Retrieve whether to use the dedicated heartbeat agent (LibFabric only).
+  [[nodiscard]] bool dedicated_heartbeat() const {
+    return dedicated_heartbeat_;
+  }
+
+  /// Retrieve the number of progress threads per compute node (RDMA only).
+  [[nodiscard]] uint32_t progress_threads() const { return progress_threads_; }
+
+  /// Retrieve whether buffer positions are exchanged by RDMA writes (RDMA
+  /// only).
+  [[nodiscard]] bool pointer_write() const { return pointer_write_; }
+
+  /// Retrieve whether descriptors are written with immediate data (RDMA
+  /// only).
+  [[nodiscard]] bool write_with_imm() const { return write_with_imm_; }
+
+  /// Retrieve whether the compute nodes read the components (RDMA only).
+  [[nodiscard]] bool rdma_pull() const { return rdma_pull_; }
+
+  /// Retrieve whether the status is exchanged over separate connections
+  /// (RDMA only).
+  [[nodiscard]] bool control_connections() const {
+    return control_connections_;
+  }
+
+  /// Retrieve the type of service of the control connections (RDMA only).
+  [[nodiscard]] uint8_t control_tos() const {
+    return static_cast<uint8_t>(control_tos_);
+  }
+
+  /// Retrieve the alignment of the component contents in the compute node
+  /// buffers (RDMA only, 0: none).
+  [[nodiscard]] uint32_t content_alignment() const {
+    return content_alignment_;
+  }
+
+  /// Retrieve the number of parallel streams per connection (ZeroMQ only).
+  [[nodiscard]] uint32_t zeromq_streams() const { return zeromq_streams_; }
+
+  /// Retrieve the number of ZeroMQ I/O threads (ZeroMQ only).
+  [[nodiscard]] uint32_t zeromq_io_threads() const {
+    return zeromq_io_threads_;
+  }
+
+  /// Retrieve the number of parallel streams per connection (TCP only).
+  [[nodiscard]] uint32_t tcp_streams() const { return tcp_streams_; }
+
+  /// Retrieve whether to send with MSG_ZEROCOPY (TCP only).
+  [[nodiscard]] bool tcp_zerocopy() const { return tcp_zerocopy_; }
+
+  /// Retrieve the codec of the component compression (TCP only, empty:
+  /// uncompressed).
+  [[nodiscard]] const std::string& tcp_compression() const {
+    return tcp_compression_;
+  }
+
+  /// Retrieve the level of the component compression (TCP only).
+  [[nodiscard]] int32_t tcp_compression_level() const {
+    return tcp_compression_level_;
+  }
+
+  /// Retrieve the number of component compression threads (TCP only).
+  [[nodiscard]] uint32_t tcp_compression_threads() const {
+    return tcp_compression_threads_;
+  }
+
+  /// Retrieve whether the builders share the overlap contents (TCP only).
+  [[nodiscard]] bool tcp_overlap_sharing() const {
+    return tcp_overlap_sharing_;
+  }
+
+  /// Retrieve the time after which the builders give up on missing
+  /// components (in ms, zero: never, TCP only).
+  [[nodiscard]] uint32_t timeslice_deadline() const {
+    return timeslice_deadline_;
+  }
+
+  /// Retrieve the thread placement policy.
+  [[nodiscard]] ThreadPlacement thread_placement() const {
+    return thread_placement_;
+  }
+
+  /// Retrieve the CPUs reserved for housekeeping threads.
+  [[nodiscard]] const std::vector<int>& housekeeping_cpus() const {
+    return housekeeping_cpus_;
+  }
+
+  /// Retrieve the resctrl group of the transport threads (empty: none).
+  [[nodiscard]] const std::string& resctrl_transport() const {
+    return resctrl_transport_;
+  }
+
+  /// Retrieve the schemata lines of the transport resctrl group.
+  [[nodiscard]] const std::vector<std::string>&
+  resctrl_transport_schemata() const {
+    return resctrl_transport_schemata_;
+  }
+
+  /// Retrieve the resctrl group of the processor instances (empty: none).
+  [[nodiscard]] const std::string& resctrl_processor() const {
+    return resctrl_processor_;
+  }
+
+  /// Retrieve the schemata lines of the processor resctrl group.
+  [[nodiscard]] const std::vector<std::string>&
+  resctrl_processor_schemata() const {
+    return resctrl_processor_schemata_;
+  }
+
 private:
   /// Parse command line options.
   void parse_options(int argc, char* argv[]);
 
+  /// Check the consistency of the benchmark options.
+  void check_benchmark_options() const;
+
   std::string monitor_uri_;
 
+  /// The interval of the buffer status reports in milliseconds.
+  uint32_t monitor_interval_ = 1000;
+
+  /// Publish hardware performance counters of the transport threads.
+  bool perf_counters_ = false;
+
+  /// Publish the allocation statistics (see cbm::AllocationStats).
+  bool allocation_stats_ = false;
+
+  /// Publish the CPU usage and scheduling statistics of the named threads.
+  bool thread_stats_ = false;
+
+  /// Publish live statistics in shared memory (see cbm::LiveStats).
+  bool live_stats_ = false;
+
+  /// The event trace file name.
+  std::string trace_file_;
+
+  /// Write the event trace continuously instead of on SIGUSR2 and at exit.
+  bool trace_continuous_ = false;
+
+  /// Run the node performance self-check instead of the application.
+  bool self_check_ = false;
+
+  /// The benchmark report file name.
+  std::string benchmark_report_;
+
+  /// The measurement duration of each benchmark point in seconds.
+  uint32_t benchmark_duration_ = 10;
+
+  /// The swept values of the benchmark (empty: configured value).
+  std::vector<Transport> benchmark_transports_;
+  std::vector<uint32_t> benchmark_timeslice_sizes_;
+  std::vector<uint32_t> benchmark_overlap_sizes_;
+  std::vector<uint32_t> benchmark_microslice_sizes_;
+  std::vector<uint32_t> benchmark_num_inputs_;
+  std::vector<uint32_t> benchmark_num_outputs_;
+
+  /// The configured lists of inputs, outputs and indexes, from which the
+  /// benchmark points select.
+  std::vector<InterfaceSpecification> all_inputs_;
+  std::vector<InterfaceSpecification> all_outputs_;
+  std::vector<unsigned> all_input_indexes_;
+  std::vector<unsigned> all_output_indexes_;
+
   /// The global timeslice size in number of microslices.
   uint32_t timeslice_size_ = 100;
 
+  /// The global timeslice duration in ns, zero for count-based timeslices.
+  uint64_t timeslice_duration_ = 0;
+
+  /// The global overlap duration of time-based timeslices in ns.
+  uint64_t overlap_duration_ = 0;
+
+  /// The target number of bytes per timeslice, zero for a fixed size.
+  uint64_t timeslice_target_bytes_ = 0;
+
   /// The global maximum timeslice number.
   uint32_t max_timeslice_number_ = UINT32_MAX;
 
@@ -154,6 +506,9 @@ private:
   /// The number of instances of the timeslice processor executable.
   uint32_t processor_instances_ = 1;
 
+  /// The autoscaling of the timeslice processor instances.
+  ProcessorScalingParameters processor_scaling_;
+
   /// The global base port.
   uint32_t base_port_ = 20079;
 
@@ -181,6 +536,21 @@ private:
   /// The intial TSs of each interval of the scheduler
   uint32_t scheduler_interval_length_{};
 
+  /// Place timeslices according to the compute node load
+  bool scheduler_bandwidth_aware_placement_ = false;
+
+  /// Stagger the transfers of a round across compute nodes
+  bool scheduler_staggered_transfers_ = false;
+
+  /// The load shedding levels <fill percentage, keep percentage>
+  std::vector<std::pair<uint32_t, uint32_t>> scheduler_shedding_levels_;
+
+  /// The emulated links from the inputs to the compute nodes
+  LinkModelParameters link_model_;
+
+  /// Every n-th timeslice is never shed (0 for none)
+  uint32_t scheduler_shedding_priority_interval_ = 0;
+
   /// The maximum difference percentage between the proposed and the actual
   /// duration to apply the scheduler_speedup_percentage_
   uint32_t scheduler_speedup_difference_percentage_{};
@@ -191,8 +561,112 @@ private:
   /// The speeding up interval count of the scheduler
   uint32_t scheduler_speedup_interval_count_{};
 
+  /// The interval pacing policy of the scheduler
+  SchedulerPolicy scheduler_policy_ = SchedulerPolicy::Heuristic;
+
+  /// The target compute buffer fill percentage of the model-based scheduler
+  uint32_t scheduler_target_buffer_fill_ = 80;
+
   /// The directory to store the log files
   std::string scheduler_log_directory_;
 
   bool scheduler_enable_logging_ = false;
+
+  /// The event loop progress mode
+  ProgressMode progress_mode_ = ProgressMode::Busy;
+
+  /// The time to keep polling after activity in microseconds
+  uint32_t progress_spin_time_ = 100;
+
+  /// The maximum number of timeslices per acknowledgement message
+  uint32_t ack_coalesce_count_ = 1;
+
+  /// The maximum time an acknowledgement is held back (in microseconds)
+  uint32_t ack_coalesce_delay_ = 100;
+
+  /// The input buffer fill that expedites a held back acknowledgement
+  double ack_expedite_fill_ = 0.5;
+
+  /// The number of timeslices per signaled RDMA write
+  uint32_t write_signal_interval_ = 1;
+
+  /// The maximum size of the components written inline (in bytes)
+  uint32_t inline_data_size_ = 0;
+
+  /// Whether compute nodes use a shared receive context
+  bool shared_receive_context_ = false;
+
+  /// Whether memory is registered for on-demand paging
+  bool on_demand_paging_ = false;
+
+  /// Whether the providers are probed at startup
+  bool provider_probe_ = false;
+
+  /// Number of threads to warm the buffers with at startup
+  uint32_t warm_buffers_ = 0;
+
+  /// Whether heartbeats use a dedicated endpoint and thread
+  bool dedicated_heartbeat_ = false;
+
+  /// The number of progress threads per compute node
+  uint32_t progress_threads_ = 1;
+
+  /// Whether buffer positions are RDMA-written into status slots
+  bool pointer_write_ = false;
+
+  /// Whether descriptor writes carry immediate data instead of a fence
+  bool write_with_imm_ = false;
+
+  /// Whether the compute nodes read the components from the inputs
+  bool rdma_pull_ = false;
+
+  /// Whether the status is exchanged over separate control connections
+  bool control_connections_ = false;
+
+  /// The type of service of the control connections
+  uint32_t control_tos_ = 0;
+
+  /// The alignment of the component contents in the compute node buffers
+  uint32_t content_alignment_ = 0;
+
+  /// The number of parallel ZeroMQ streams per input connection
+  uint32_t zeromq_streams_ = 1;
+
+  /// The number of ZeroMQ I/O threads
+  uint32_t zeromq_io_threads_ = 1;
+
+  /// The number of parallel TCP streams per input connection
+  uint32_t tcp_streams_ = 4;
+
+  /// Whether TCP sends use MSG_ZEROCOPY where supported
+  bool tcp_zerocopy_ = true;
+
+  /// The codec compressing the components over TCP (empty: none)
+  std::string tcp_compression_;
+
+  /// The level of the TCP component compression
+  int32_t tcp_compression_level_ = 1;
+
+  /// The number of threads compressing or decompressing TCP components
+  uint32_t tcp_compression_threads_ = 4;
+
+  /// Whether the builders share the overlap contents over TCP
+  bool tcp_overlap_sharing_ = false;
+
+  /// The time after which the builders give up on missing components (ms)
+  uint32_t timeslice_deadline_ = 0;
+
+  /// The thread placement policy
+  ThreadPlacement thread_placement_ = ThreadPlacement::None;
+
+  /// The CPUs reserved for housekeeping threads
+  std::vector<int> housekeeping_cpus_;
+
+  /// The resctrl groups of the transport threads and processor instances
+  std::string resctrl_transport_;
+  std::string resctrl_processor_;
+
+  /// The schemata lines of the resctrl groups (empty: keep current)
+  std::vector<std::string> resctrl_transport_schemata_;
+  std::vector<std::string> resctrl_processor_schemata_;
 };
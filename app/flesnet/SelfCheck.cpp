@@ -0,0 +1,489 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "SelfCheck.hpp"
+#include "MemoryPolicy.hpp"
+#include "StreamingCopy.hpp"
+#include "System.hpp"
+#include "Topology.hpp"
+#include "Utility.hpp"
+#include "log.hpp"
+#include "shm_device_client.hpp"
+#include <algorithm>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sched.h>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+#ifdef HAVE_LIBFABRIC
+#include "WriteLoopback.hpp"
+#endif
+
+#ifdef HAVE_CRI
+#include "cri.hpp"
+#include "device_operator.hpp"
+#endif
+
+namespace {
+
+using clock = std::chrono::steady_clock;
+
+/// Size of each buffer of the memory and page fault checks.
+constexpr std::size_t check_buffer_size = std::size_t(1) << 28;
+
+/// Repetitions of the memory copy, the fastest one is reported.
+constexpr int copy_repetitions = 4;
+
+/// Size of the writes of the bandwidth loopback check.
+constexpr std::size_t loopback_message_size = std::size_t(1) << 20;
+
+/// Duration of the loopback and CRI checks (the CRI performance counters
+/// overflow after 17 s).
+constexpr auto check_duration = std::chrono::seconds(2);
+
+// Values expected of a FLES node, a run is likely limited by a node that
+// does not reach them
+constexpr double expected_memcpy_gbs = 5.0;
+constexpr double expected_streaming_gbs = 8.0;
+constexpr double expected_fault_gbs = 2.0;
+constexpr double expected_write_gbs = 10.0;
+constexpr double expected_write_latency_us = 5.0;
+constexpr double expected_cri_gbs = 6.0;
+
+/// Buffer fault-in time from which warming the buffers is recommended.
+constexpr double warm_buffers_threshold_s = 1.0;
+
+double seconds_since(clock::time_point begin) {
+  return std::chrono::duration<double>(clock::now() - begin).count();
+}
+
+std::string read_line(const std::string& filename) {
+  std::ifstream file(filename);
+  std::string line;
+  std::getline(file, line);
+  return line;
+}
+
+// Restrict the calling thread to a set of CPUs
+void pin_thread(const std::vector<int>& cpus) {
+  cpu_set_t cpu_mask;
+  CPU_ZERO(&cpu_mask);
+  for (int cpu : cpus) {
+    CPU_SET(cpu, &cpu_mask);
+  }
+  if (sched_setaffinity(0, sizeof(cpu_mask), &cpu_mask) != 0) {
+    L_(warning) << "self-check: could not pin thread to CPUs "
+                << format_cpu_list(cpus);
+  }
+}
+
+// Measure the fastest of several copies of a buffer in bytes per second
+template <typename Copy>
+double copy_bandwidth(void* dst, const void* src, std::size_t size, Copy copy) {
+  double best = 0.0;
+  for (int i = 0; i < copy_repetitions; ++i) {
+    auto begin = clock::now();
+    copy(dst, src, size);
+    best = std::max(best, static_cast<double>(size) / seconds_since(begin));
+  }
+  return best;
+}
+
+// Measure how fast a new shared memory segment is faulted in (in bytes per
+// second), either by touching every page or at once (see prefault_memory())
+double shm_fault_rate(HugePages huge_pages, bool populate) {
+  namespace ip = boost::interprocess;
+  const std::string name = "flesnet_self_check." + std::to_string(getpid());
+  ip::shared_memory_object::remove(name.c_str());
+  struct Remover {
+    std::string name;
+    ~Remover() { ip::shared_memory_object::remove(name.c_str()); }
+  } remover{name};
+
+  ip::shared_memory_object shm(ip::create_only, name.c_str(), ip::read_write);
+  shm.truncate(static_cast<ip::offset_t>(check_buffer_size));
+  ip::mapped_region region(shm, ip::read_write);
+  MemoryPolicy policy;
+  policy.huge_pages = huge_pages;
+  apply_memory_policy(region.get_address(), region.get_size(), policy);
+
+  auto* data = static_cast<volatile uint8_t*>(region.get_address());
+  const auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  auto begin = clock::now();
+  if (populate) {
+    prefault_memory(region.get_address(), region.get_size());
+  } else {
+    for (std::size_t offset = 0; offset < region.get_size();
+         offset += page_size) {
+      data[offset] = 1;
+    }
+  }
+  return static_cast<double>(region.get_size()) / seconds_since(begin);
+}
+
+// Retrieve the size of the timeslice buffer of an output, given as log2 of
+// the data size per input ('datasize' parameter, see Application)
+uint64_t timeslice_buffer_bytes(const InterfaceSpecification& output,
+                                std::size_t num_inputs) {
+  std::vector<std::string> values{"27"};
+  if (output.param.count("datasize") != 0u) {
+    values = split(output.param.at("datasize"), ",");
+  }
+  uint64_t bytes = 0;
+  for (std::size_t i = 0; i < num_inputs; ++i) {
+    const auto& value = values.at(values.size() == num_inputs ? i : 0);
+    bytes += UINT64_C(1) << stou(value);
+  }
+  return bytes;
+}
+
+} // namespace
+
+SelfCheck::SelfCheck(const Parameters& par)
+    : par_(par), node_cpus_(node_cpus()) {}
+
+void SelfCheck::run(std::ostream& out) {
+  L_(info) << "self-check: memory bandwidth of " << node_cpus_.size()
+           << " NUMA node(s)";
+  check_memory_bandwidth();
+  L_(info) << "self-check: shared memory page faults";
+  check_page_faults();
+  check_write_loopback();
+  check_cri_dma();
+
+  out << "flesnet self-check on " << fles::system::current_hostname()
+      << "\n\n";
+  write_results(out);
+  write_placement(out);
+  write_buffer_settings(out);
+  if (!notes_.empty()) {
+    out << "\nnotes:\n";
+    for (const auto& note : notes_) {
+      out << "  " << note << "\n";
+    }
+  }
+  out << std::flush;
+}
+
+void SelfCheck::check_memory_bandwidth() {
+  bool bind = node_cpus_.size() > 1;
+  for (const auto& [node, cpus] : node_cpus_) {
+    MemoryPolicy policy;
+    policy.numa_node = bind ? node : -1;
+    void* src = nullptr;
+    void* dst = nullptr;
+    try {
+      src = allocate_memory(check_buffer_size, policy);
+      dst = allocate_memory(check_buffer_size, policy);
+    } catch (const std::runtime_error& e) {
+      free_memory(src, check_buffer_size, policy);
+      if (!bind) {
+        throw;
+      }
+      // e.g., built without libnuma: the nodes cannot be told apart
+      notes_.push_back("memory not bound to NUMA nodes: " +
+                       std::string(e.what()));
+      bind = false;
+      policy.numa_node = -1;
+      src = allocate_memory(check_buffer_size, policy);
+      dst = allocate_memory(check_buffer_size, policy);
+    }
+
+    NodeBandwidth& bandwidth = node_bandwidth_[node];
+    // measure on a thread of the node, as the data path threads are placed
+    std::thread thread([&, cpus = cpus] {
+      pin_thread(cpus);
+      std::memset(src, 0x5a, check_buffer_size);
+      prefault_memory(dst, check_buffer_size);
+      bandwidth.memcpy =
+          copy_bandwidth(dst, src, check_buffer_size,
+                         [](void* d, const void* s, std::size_t n) {
+                           std::memcpy(d, s, n);
+                         });
+      bandwidth.streaming =
+          copy_bandwidth(dst, src, check_buffer_size,
+                         [](void* d, const void* s, std::size_t n) {
+                           streaming_copy(d, s, n);
+                         });
+    });
+    thread.join();
+    free_memory(src, check_buffer_size, policy);
+    free_memory(dst, check_buffer_size, policy);
+
+    const std::string where = "node " + std::to_string(node);
+    results_.push_back({"memcpy, " + where, bandwidth.memcpy / 1e9,
+                        expected_memcpy_gbs, "GB/s", true});
+    results_.push_back({"streaming copy, " + where, bandwidth.streaming / 1e9,
+                        expected_streaming_gbs, "GB/s", true});
+  }
+}
+
+void SelfCheck::check_page_faults() {
+  try {
+    fault_rate_ = shm_fault_rate(HugePages::None, false);
+    thp_fault_rate_ = shm_fault_rate(HugePages::Transparent, false);
+    populate_rate_ = shm_fault_rate(HugePages::None, true);
+  } catch (const std::exception& e) {
+    notes_.push_back("shared memory page faults not measured: " +
+                     std::string(e.what()));
+    return;
+  }
+  const auto page_size = static_cast<double>(sysconf(_SC_PAGESIZE));
+  results_.push_back({"shm fault-in, touching pages", fault_rate_ / 1e9,
+                      expected_fault_gbs, "GB/s", true});
+  results_.push_back({"shm fault-in, per page", page_size / fault_rate_ * 1e6,
+                      page_size / (expected_fault_gbs * 1e9) * 1e6, "us",
+                      false});
+  results_.push_back({"shm fault-in, transparent huge pages",
+                      thp_fault_rate_ / 1e9, expected_fault_gbs, "GB/s",
+                      true});
+  results_.push_back({"shm fault-in, populated at once", populate_rate_ / 1e9,
+                      expected_fault_gbs, "GB/s", true});
+
+  const std::string shmem_thp =
+      read_line("/sys/kernel/mm/transparent_hugepage/shmem_enabled");
+  if (!shmem_thp.empty() && shmem_thp.find("[never]") != std::string::npos) {
+    notes_.push_back("transparent huge pages are disabled for shared memory "
+                     "(shmem_enabled: " +
+                     shmem_thp + "), 'hugepages=thp' has no effect");
+  }
+}
+
+void SelfCheck::check_write_loopback() {
+  if (par_.transport() != Transport::LibFabric) {
+    notes_.push_back("fi_write loopback skipped, transport is not LibFabric");
+    return;
+  }
+#ifdef HAVE_LIBFABRIC
+  std::string host;
+  if (!par_.input_indexes().empty()) {
+    host = par_.inputs().at(par_.input_indexes().front()).host;
+  } else if (!par_.output_indexes().empty()) {
+    host = par_.outputs().at(par_.output_indexes().front()).host;
+  }
+  L_(info) << "self-check: fi_write loopback on " << host;
+  try {
+    auto result = tl_libfabric::measure_write_loopback(
+        host, loopback_message_size,
+        std::chrono::duration_cast<std::chrono::milliseconds>(check_duration));
+    results_.push_back({"fi_write bandwidth (" + result.provider + ")",
+                        result.bandwidth / 1e9, expected_write_gbs, "GB/s",
+                        true});
+    results_.push_back({"fi_write latency (" + result.provider + ")",
+                        result.latency_us, expected_write_latency_us, "us",
+                        false});
+  } catch (const std::exception& e) {
+    notes_.push_back("fi_write loopback failed: " + std::string(e.what()));
+  }
+#else
+  notes_.push_back("fi_write loopback skipped, flesnet built without "
+                   "LibFabric support");
+#endif
+}
+
+void SelfCheck::check_cri_dma() {
+#ifdef HAVE_CRI
+  try {
+    pda::device_operator dev_op;
+    const uint64_t num_dev = dev_op.device_count();
+    for (uint64_t i = 0; i < num_dev; ++i) {
+      cri::cri_device cri(static_cast<int>(i));
+      L_(info) << "self-check: CRI " << i << " (" << cri.print_devinfo()
+               << ") DMA with pattern generators enabled";
+      // enable the pattern generators as cri_en_pgen does, restore after
+      const bool pgen_enabled = cri.rf()->get_bit(CRI_REG_MC_CNT_CFG_L, 31);
+      cri.enable_mc_cnt(true);
+      cri.set_perf_cnt(false, true);
+      std::this_thread::sleep_for(check_duration);
+      const auto perf = cri.get_perf();
+      std::size_t pgen_channels = 0;
+      for (auto* channel : cri.channels()) {
+        if (channel->data_source() == cri::cri_channel::rx_pgen &&
+            channel->get_ready_for_data()) {
+          ++pgen_channels;
+        }
+      }
+      cri.enable_mc_cnt(pgen_enabled);
+
+      if (perf.cycles == 0 || perf.cycles == 0xFFFFFFFF) {
+        notes_.push_back("CRI " + std::to_string(i) +
+                         ": performance counter overflow");
+        continue;
+      }
+      const double throughput = static_cast<double>(perf.pci_trans) /
+                                static_cast<double>(perf.cycles) *
+                                cri::pci_clk * 32;
+      results_.push_back({"CRI " + std::to_string(i) + " DMA (" +
+                              std::to_string(pgen_channels) +
+                              " pgen channels)",
+                          throughput / 1e9, expected_cri_gbs, "GB/s", true});
+      if (pgen_channels == 0) {
+        notes_.push_back("CRI " + std::to_string(i) +
+                         ": no channel with pattern generator data source "
+                         "enabled (configure with cri_cfg and start "
+                         "cri_server first)");
+      }
+      if (const int node = cri.numa_node(); node >= 0) {
+        notes_.push_back("CRI " + std::to_string(i) + " is attached to NUMA "
+                         "node " + std::to_string(node));
+      }
+    }
+  } catch (const std::exception& e) {
+    notes_.push_back("CRI DMA not measured: " + std::string(e.what()));
+  }
+#else
+  notes_.push_back("CRI DMA skipped, flesnet built without CRI support");
+#endif
+}
+
+void SelfCheck::write_results(std::ostream& out) const {
+  std::size_t width = 0;
+  for (const auto& result : results_) {
+    width = std::max(width, result.name.size());
+  }
+  out << std::left << std::setw(static_cast<int>(width)) << "measurement"
+      << "     value  expected\n";
+  for (const auto& result : results_) {
+    const bool ok = result.higher_is_better ? result.value >= result.expected
+                                            : result.value <= result.expected;
+    std::ostringstream expected;
+    expected << (result.higher_is_better ? ">= " : "<= ")
+             << std::setprecision(3) << result.expected;
+    out << std::left << std::setw(static_cast<int>(width)) << result.name
+        << std::right << std::fixed << std::setprecision(2) << std::setw(10)
+        << result.value << "  " << std::left << std::setw(8)
+        << expected.str() << " " << std::setw(5) << result.unit
+        << (ok ? "ok" : (result.higher_is_better ? "LOW" : "HIGH")) << "\n";
+    out.unsetf(std::ios::floatfield);
+  }
+}
+
+int SelfCheck::input_node(unsigned index) const {
+  const auto& input = par_.inputs().at(index);
+  if (input.memory_policy.numa_node >= 0) {
+    return input.memory_policy.numa_node;
+  }
+  if (input.scheme == "shm" && !input.path.empty()) {
+    // the buffers are located on the node the CRI is attached to
+    try {
+      flib_shm_device_client device(input.path.at(0));
+      if (device.numa_node() >= 0) {
+        return device.numa_node();
+      }
+    } catch (const std::exception& e) {
+      L_(debug) << "self-check: cannot open shared memory "
+                << input.path.at(0) << ": " << e.what();
+    }
+  }
+  return interface_numa_node(input.host);
+}
+
+void SelfCheck::write_placement(std::ostream& out) const {
+  out << "\nrecommended thread placement (as with --thread-placement "
+         "Topology, housekeeping on CPUs "
+      << format_cpu_list(par_.housekeeping_cpus()) << "):\n";
+  CorePlacement placement(node_cpus_, par_.housekeeping_cpus());
+  for (unsigned index : par_.input_indexes()) {
+    const int node = input_node(index);
+    const auto cpus = placement.assign(node, 1);
+    out << "  input channel " << index << ": NUMA node "
+        << (node >= 0 ? std::to_string(node) : "unknown") << ", CPU "
+        << format_cpu_list(cpus) << "\n";
+  }
+  for (unsigned index : par_.output_indexes()) {
+    const int node = interface_numa_node(par_.outputs().at(index).host);
+    const std::size_t threads = (par_.transport() == Transport::RDMA)
+                                    ? par_.progress_threads()
+                                    : 1;
+    const auto cpus = placement.assign(node, threads);
+    out << "  timeslice builder " << index << ": NUMA node "
+        << (node >= 0 ? std::to_string(node) : "unknown") << ", CPUs "
+        << format_cpu_list(cpus) << "\n";
+  }
+  if (node_cpus_.size() > 1 &&
+      par_.thread_placement() != ThreadPlacement::Topology) {
+    out << "  use --thread-placement Topology to apply it\n";
+  }
+
+  // nodes that copy much slower than the best one
+  double best = 0.0;
+  for (const auto& [node, bandwidth] : node_bandwidth_) {
+    best = std::max(best, bandwidth.streaming);
+  }
+  for (const auto& [node, bandwidth] : node_bandwidth_) {
+    if (bandwidth.streaming < 0.8 * best) {
+      out << "  avoid NUMA node " << node << " for data path threads ("
+          << std::setprecision(3) << bandwidth.streaming / best * 100
+          << "% of the best copy bandwidth)\n";
+    }
+  }
+}
+
+void SelfCheck::write_buffer_settings(std::ostream& out) const {
+  out << "\nrecommended buffer settings:\n";
+  bool any = false;
+  auto recommend = [&](const std::string& what, const MemoryPolicy& policy,
+                       uint64_t bytes, int nic_node) {
+    std::vector<std::string> advice;
+    const double rate = (policy.huge_pages == HugePages::Transparent)
+                            ? thp_fault_rate_
+                            : fault_rate_;
+    if (rate > 0.0 && policy.huge_pages != HugePages::Size2M &&
+        policy.huge_pages != HugePages::Size1G) {
+      const double fault_s = static_cast<double>(bytes) / rate;
+      if (fault_s > warm_buffers_threshold_s && par_.warm_buffers() == 0) {
+        std::ostringstream oss;
+        oss << "faulting in takes " << std::setprecision(2) << fault_s
+            << " s, use --warm-buffers <n>";
+        advice.push_back(oss.str());
+      }
+      if (policy.huge_pages == HugePages::None &&
+          thp_fault_rate_ > 1.5 * fault_rate_) {
+        advice.push_back("use hugepages=thp");
+      }
+    }
+    if (nic_node >= 0 && node_cpus_.size() > 1 &&
+        policy.numa_node != nic_node) {
+      advice.push_back("use numa=" + std::to_string(nic_node) +
+                       " (network interface node)");
+    }
+    if (!advice.empty()) {
+      any = true;
+      out << "  " << what << " (" << human_readable_count(bytes) << ", "
+          << policy.description() << "):";
+      for (const auto& a : advice) {
+        out << "\n    " << a;
+      }
+      out << "\n";
+    }
+  };
+
+  for (unsigned index : par_.output_indexes()) {
+    const auto& output = par_.outputs().at(index);
+    recommend("output " + std::to_string(index) + " timeslice buffer",
+              output.memory_policy,
+              timeslice_buffer_bytes(output, par_.inputs().size()),
+              interface_numa_node(output.host));
+  }
+  for (unsigned index : par_.input_indexes()) {
+    const auto& input = par_.inputs().at(index);
+    if (input.scheme != "pgen") {
+      continue;
+    }
+    uint32_t datasize = 27; // as in Application
+    if (input.param.count("datasize") != 0u) {
+      datasize = stou(input.param.at("datasize"));
+    }
+    recommend("input " + std::to_string(index) + " pattern generator buffer",
+              input.memory_policy, UINT64_C(1) << datasize, -1);
+  }
+  if (!any) {
+    out << "  none, the configured settings fit the measurements\n";
+  }
+}
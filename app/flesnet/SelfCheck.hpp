@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#pragma once
+
+#include "Parameters.hpp"
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/// Node performance self-check.
+/** A SelfCheck object measures the local limits of a flesnet run on this
+    node before it is started: the single-thread memory copy bandwidth of
+    each NUMA node (std::memcpy and non-temporal streaming_copy()), the
+    cost of faulting in shared memory pages, the fi_write() loopback
+    bandwidth and latency of the selected LibFabric provider, and the DMA
+    throughput of the CRI boards with their pattern generators enabled.
+
+    The report compares the results to the expected values of a FLES node
+    and recommends thread placement and buffer settings for the inputs and
+    outputs of this node in the given configuration. */
+class SelfCheck {
+public:
+  /// The SelfCheck constructor.
+  explicit SelfCheck(const Parameters& par);
+
+  SelfCheck(const SelfCheck&) = delete;
+  void operator=(const SelfCheck&) = delete;
+
+  /// Run all checks and write the report.
+  void run(std::ostream& out);
+
+private:
+  /// A measured value and its expected minimum (or maximum).
+  struct Result {
+    std::string name;      ///< what has been measured
+    double value;          ///< measured value
+    double expected;       ///< expected minimum, or maximum
+    std::string unit;      ///< unit of value and expected
+    bool higher_is_better; ///< whether expected is a minimum
+  };
+
+  /// Memory copy bandwidth of a NUMA node in bytes per second.
+  struct NodeBandwidth {
+    double memcpy = 0.0;    ///< std::memcpy()
+    double streaming = 0.0; ///< streaming_copy()
+  };
+
+  void check_memory_bandwidth();
+  void check_page_faults();
+  void check_write_loopback();
+  void check_cri_dma();
+
+  void write_results(std::ostream& out) const;
+  void write_placement(std::ostream& out) const;
+  void write_buffer_settings(std::ostream& out) const;
+
+  /// The NUMA node the buffer of a local input is located on, or -1.
+  [[nodiscard]] int input_node(unsigned index) const;
+
+  const Parameters& par_;
+
+  std::map<int, std::vector<int>> node_cpus_;
+  std::map<int, NodeBandwidth> node_bandwidth_;
+
+  /// Shared memory fault-in rates in bytes per second (0: not measured).
+  double fault_rate_ = 0.0;
+  double thp_fault_rate_ = 0.0;
+  double populate_rate_ = 0.0;
+
+  std::vector<Result> results_;
+  std::vector<std::string> notes_;
+};
@@ -0,0 +1,267 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "TransportBenchmark.hpp"
+#include "EventTrace.hpp"
+#include "GitRevision.hpp"
+#include "System.hpp"
+#include "Utility.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <sys/resource.h>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+/// Events per thread ring, enough for the measurement of a point at typical
+/// timeslice rates (older events only reduce the latency sample).
+constexpr std::size_t trace_ring_size = std::size_t(1) << 20;
+
+/// Interval for polling the application state.
+constexpr auto poll_interval = std::chrono::milliseconds(10);
+
+/// Pause between points to let the connections and ports be released.
+constexpr auto point_pause = std::chrono::seconds(2);
+
+double process_cpu_seconds() {
+  struct rusage usage {};
+  getrusage(RUSAGE_SELF, &usage);
+  auto seconds = [](const struct timeval& tv) {
+    return static_cast<double>(tv.tv_sec) +
+           static_cast<double>(tv.tv_usec) * 1e-6;
+  };
+  return seconds(usage.ru_utime) + seconds(usage.ru_stime);
+}
+
+void write_latency(std::ostream& os,
+                   const char* name,
+                   const cbm::Histogram& histogram) {
+  auto us = [&](uint64_t ns) { return static_cast<double>(ns) / 1000.; };
+  os << ",\"" << name << "\":{\"count\":" << histogram.Count()
+     << ",\"p50\":" << us(histogram.Percentile(0.5))
+     << ",\"p90\":" << us(histogram.Percentile(0.9))
+     << ",\"p99\":" << us(histogram.Percentile(0.99))
+     << ",\"max\":" << us(histogram.Max()) << "}";
+}
+
+template <typename T>
+void write_list(std::ostream& os, const char* name, const T& values) {
+  os << ",\"" << name << "\":[";
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    os << (i != 0 ? "," : "") << values[i];
+  }
+  os << "]";
+}
+
+} // namespace
+
+TransportBenchmark::TransportBenchmark(Parameters& par,
+                                       volatile sig_atomic_t* signal_status)
+    : par_(par), signal_status_(signal_status) {}
+
+void TransportBenchmark::run() {
+  std::ofstream report(par_.benchmark_report(), std::ios::app);
+  if (!report) {
+    throw std::runtime_error("cannot open benchmark report file: " +
+                             par_.benchmark_report());
+  }
+
+  EventTrace::enable(trace_ring_size);
+
+  const auto points = par_.benchmark_points();
+  L_(info) << "benchmark: " << points.size() << " points of "
+           << par_.benchmark_duration().count() << " s";
+
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    const auto& point = points[i];
+    L_(info) << "benchmark point " << i << ": " << point.transport
+             << ", timeslice size " << point.timeslice_size << ", overlap "
+             << point.overlap_size << ", microslice size "
+             << point.microslice_size << ", " << point.num_inputs
+             << " inputs, " << point.num_outputs << " outputs";
+
+    Result result = run_point(point);
+    if (*signal_status_ != 0) {
+      L_(warning) << "benchmark interrupted";
+      break;
+    }
+    write_report(report, i, point, result);
+    report.flush();
+
+    if (result.active) {
+      double duration_s =
+          static_cast<double>(result.end_ns - result.begin_ns) * 1e-9;
+      auto bytes = std::max(result.data.timeslice_bytes,
+                            result.data.input_bytes);
+      L_(status) << "benchmark point " << i << ": "
+                 << human_readable_count(static_cast<uint64_t>(
+                        static_cast<double>(bytes) / duration_s))
+                 << "/s, transfer latency p99 "
+                 << result.transfer_ns.Percentile(0.99) / 1000 << " us";
+    }
+
+    if (i + 1 < points.size()) {
+      std::this_thread::sleep_for(point_pause);
+    }
+  }
+}
+
+TransportBenchmark::Result
+TransportBenchmark::run_point(const BenchmarkPoint& point) {
+  par_.apply_benchmark_point(point);
+  EventTrace::reset();
+  stop_point_ = 0;
+
+  Result result;
+  result.active =
+      !par_.input_indexes().empty() || !par_.output_indexes().empty();
+  if (!result.active) {
+    return result;
+  }
+
+  Application app(par_, &stop_point_);
+  std::atomic<bool> app_done{false};
+  std::thread timer([&] { measure(app, app_done, result); });
+  try {
+    app.run();
+  } catch (...) {
+    app_done = true;
+    timer.join();
+    throw;
+  }
+  app_done = true;
+  timer.join();
+
+  evaluate_trace(result);
+  return result;
+}
+
+void TransportBenchmark::measure(const Application& app,
+                                 const std::atomic<bool>& app_done,
+                                 Result& result) {
+  // the window starts with the first data of this process
+  Application::Statistics begin;
+  while (!app_done && *signal_status_ == 0) {
+    begin = app.statistics();
+    if (begin.timeslices != 0 || begin.input_bytes != 0) {
+      break;
+    }
+    std::this_thread::sleep_for(poll_interval);
+  }
+  result.begin_ns = EventTrace::now_ns();
+  double cpu_begin = process_cpu_seconds();
+
+  auto end = std::chrono::steady_clock::now() + par_.benchmark_duration();
+  while (!app_done && *signal_status_ == 0 &&
+         std::chrono::steady_clock::now() < end) {
+    std::this_thread::sleep_for(poll_interval);
+  }
+
+  Application::Statistics stats = app.statistics();
+  result.end_ns = EventTrace::now_ns();
+  result.cpu_s = process_cpu_seconds() - cpu_begin;
+  result.data.timeslices = stats.timeslices - begin.timeslices;
+  result.data.timeslice_bytes = stats.timeslice_bytes - begin.timeslice_bytes;
+  result.data.input_bytes = stats.input_bytes - begin.input_bytes;
+
+  // compute nodes pass the stop request on to their inputs
+  stop_point_ = (*signal_status_ != 0) ? *signal_status_ : SIGINT;
+}
+
+void TransportBenchmark::evaluate_trace(Result& result) {
+  std::vector<TraceEvent> events;
+  EventTrace::collect(events);
+  std::stable_sort(events.begin(), events.end(),
+                   [](const TraceEvent& a, const TraceEvent& b) {
+                     return a.time_ns < b.time_ns;
+                   });
+
+  using Key = std::tuple<uint32_t, uint64_t, uint64_t>;
+  std::map<Key, uint64_t> posted;
+  std::map<Key, uint64_t> sent;
+  for (const auto& event : events) {
+    const Key key{event.thread, event.id, event.arg};
+    const bool in_window =
+        event.time_ns >= result.begin_ns && event.time_ns <= result.end_ns;
+    switch (static_cast<TraceEventType>(event.type)) {
+    case TraceEventType::TimeslicePosted:
+      if (in_window) {
+        posted[key] = event.time_ns;
+      }
+      break;
+    case TraceEventType::WriteCompleted:
+      if (auto it = posted.find(key); it != posted.end()) {
+        result.transfer_ns.Record(event.time_ns - it->second);
+        posted.erase(it);
+      }
+      break;
+    case TraceEventType::WorkItemSent:
+      if (in_window) {
+        sent[{event.thread, event.id, 0}] = event.time_ns;
+      }
+      break;
+    case TraceEventType::CompletionReceived:
+      if (auto it = sent.find(key); it != sent.end()) {
+        result.processing_ns.Record(event.time_ns - it->second);
+        sent.erase(it);
+      }
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+void TransportBenchmark::write_report(std::ostream& os,
+                                      std::size_t index,
+                                      const BenchmarkPoint& point,
+                                      const Result& result) const {
+  std::ostringstream line;
+  line << "{\"host\":\"" << fles::system::current_hostname()
+       << "\",\"revision\":\"" << g_GIT_REVISION << "\",\"point\":" << index
+       << ",\"transport\":\"" << point.transport
+       << "\",\"timeslice_size\":" << point.timeslice_size
+       << ",\"overlap_size\":" << point.overlap_size
+       << ",\"microslice_size\":" << point.microslice_size
+       << ",\"inputs\":" << point.num_inputs
+       << ",\"outputs\":" << point.num_outputs;
+  write_list(line, "input_indexes", par_.input_indexes());
+  write_list(line, "output_indexes", par_.output_indexes());
+  line << ",\"active\":" << (result.active ? "true" : "false");
+
+  if (result.active) {
+    const double duration_s =
+        static_cast<double>(result.end_ns - result.begin_ns) * 1e-9;
+    const auto& data = result.data;
+    auto rate = [&](uint64_t count) {
+      return duration_s > 0 ? static_cast<double>(count) / duration_s : 0.;
+    };
+    // the CPU time refers to the data received if this is a compute node
+    const uint64_t bytes =
+        data.timeslice_bytes != 0 ? data.timeslice_bytes : data.input_bytes;
+
+    line << ",\"duration_s\":" << duration_s
+         << ",\"timeslices\":" << data.timeslices
+         << ",\"timeslice_rate\":" << rate(data.timeslices)
+         << ",\"timeslice_bytes\":" << data.timeslice_bytes
+         << ",\"timeslice_throughput\":" << rate(data.timeslice_bytes)
+         << ",\"input_bytes\":" << data.input_bytes
+         << ",\"input_throughput\":" << rate(data.input_bytes)
+         << ",\"cpu_s\":" << result.cpu_s << ",\"cpu_s_per_gb\":";
+    if (bytes != 0) {
+      line << result.cpu_s / (static_cast<double>(bytes) * 1e-9);
+    } else {
+      line << "null";
+    }
+    write_latency(line, "transfer_latency_us", result.transfer_ns);
+    write_latency(line, "processing_latency_us", result.processing_ns);
+  }
+  line << "}\n";
+  os << line.str();
+}
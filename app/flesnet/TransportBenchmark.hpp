@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#pragma once
+
+#include "Application.hpp"
+#include "Histogram.hpp"
+#include "Parameters.hpp"
+#include <atomic>
+#include <csignal>
+#include <cstdint>
+#include <ostream>
+
+/// Transport benchmark sweep.
+/** A TransportBenchmark object runs the Application once per point of the
+    parameter sweep given by the benchmark options. Each point is measured
+    for a fixed duration, starting with the first data of this process, and
+    then stopped. A report line per point is appended to the report file.
+
+    All nodes run the same sweep in the same order. The points are
+    synchronized by the connection setup, nodes that do not participate
+    in a point continue with the next one immediately. */
+class TransportBenchmark {
+public:
+  /// The TransportBenchmark constructor.
+  TransportBenchmark(Parameters& par, volatile sig_atomic_t* signal_status);
+
+  TransportBenchmark(const TransportBenchmark&) = delete;
+  void operator=(const TransportBenchmark&) = delete;
+
+  /// Run all points of the sweep.
+  void run();
+
+private:
+  /// Measurement results of one point in this process.
+  struct Result {
+    bool active = false;          ///< this process took part in the point
+    uint64_t begin_ns = 0;        ///< start of the measurement window
+    uint64_t end_ns = 0;          ///< end of the measurement window
+    Application::Statistics data; ///< data path counters in the window
+    double cpu_s = 0;             ///< process CPU time in the window
+    cbm::Histogram transfer_ns;   ///< component post to write completion
+    cbm::Histogram processing_ns; ///< work item to completion
+  };
+
+  Result run_point(const BenchmarkPoint& point);
+
+  /// Measure the running application and stop it after the duration.
+  void measure(const Application& app,
+               const std::atomic<bool>& app_done,
+               Result& result);
+
+  /// Evaluate the event trace of the measurement window.
+  static void evaluate_trace(Result& result);
+
+  void write_report(std::ostream& os,
+                    std::size_t index,
+                    const BenchmarkPoint& point,
+                    const Result& result) const;
+
+  Parameters& par_;
+  volatile sig_atomic_t* signal_status_;
+
+  /// The stop flag passed to the application of the current point.
+  volatile sig_atomic_t stop_point_ = 0;
+};
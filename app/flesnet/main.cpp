@@ -1,9 +1,12 @@
 // Copyright 2012-2013 Jan de Cuveland <cmail@cuveland.de>
 
 #include "Application.hpp"
+#include "TransportBenchmark.hpp"
 #include "Parameters.hpp"
+#include "SelfCheck.hpp"
 #include "log.hpp"
 #include <csignal>
+#include <iostream>
 
 namespace {
 volatile sig_atomic_t signal_status = 0;
@@ -17,8 +20,16 @@ int main(int argc, char* argv[]) {
 
   try {
     Parameters par(argc, argv);
-    Application app(par, &signal_status);
-    app.run();
+    if (par.self_check()) {
+      SelfCheck check(par);
+      check.run(std::cout);
+    } else if (!par.benchmark_report().empty()) {
+      TransportBenchmark benchmark(par, &signal_status);
+      benchmark.run();
+    } else {
+      Application app(par, &signal_status);
+      app.run();
+    }
   } catch (std::exception const& e) {
     L_(fatal) << e.what();
     return EXIT_FAILURE;
@@ -1,21 +1,55 @@
 // Copyright 2012-2015 Jan de Cuveland <cmail@cuveland.de>
 
 #include "Application.hpp"
+#include "FilterExamples.hpp"
 #include "FlesnetPatternGenerator.hpp"
+#include "LoadProfileAnalyzer.hpp"
+#include "MergingSource.hpp"
 #include "MicrosliceAnalyzer.hpp"
 #include "MicrosliceInputArchive.hpp"
 #include "MicrosliceOutputArchive.hpp"
 #include "MicrosliceReceiver.hpp"
 #include "MicrosliceTransmitter.hpp"
+#include "NativeInputArchive.hpp"
+#include "NativeMicrosliceBlockOutputArchive.hpp"
+#include "OfflineTimesliceBuilder.hpp"
+#include "Pipeline.hpp"
+#include "PrefetchingSource.hpp"
 #include "TimesliceDebugger.hpp"
+#include "TimesliceOutputArchive.hpp"
+#include "Utility.hpp"
 #include "log.hpp"
 #include "shm_channel_client.hpp"
+#include <boost/algorithm/string.hpp>
 #include <chrono>
+#include <exception>
 #include <iostream>
 #include <memory>
 #include <thread>
 
+namespace {
+std::unique_ptr<fles::MicrosliceSink>
+make_output_archive(const std::string& filename, const Parameters& par) {
+  if (par.output_blocks > 0) {
+    return std::make_unique<fles::NativeMicrosliceBlockOutputArchive>(
+        filename, par.output_blocks);
+  }
+  return std::unique_ptr<fles::MicrosliceSink>(
+      new fles::MicrosliceOutputArchive(
+          filename, fles::ArchiveCompression::None, false, {}, {},
+          par.output_compact ? fles::DescriptorEncoding::Compact
+                             : fles::DescriptorEncoding::Verbatim));
+}
+} // namespace
+
 Application::Application(Parameters const& par) : par_(par) {
+  if (par_.build_timeslices()) {
+    return;
+  }
+  if (par_.multi_channel()) {
+    init_channels();
+    return;
+  }
 
   // Source setup
   if (!par_.input_shm.empty()) {
@@ -25,7 +59,7 @@ Application::Application(Parameters const& par) : par_(par) {
 
     if (par_.channel_idx < shm_device_->num_channels()) {
       data_source_ = std::make_unique<flib_shm_channel_client>(
-          shm_device_, par_.channel_idx);
+          shm_device_, par_.channel_idx, shm_reader());
 
     } else {
       throw std::runtime_error("shared memory channel not available");
@@ -43,10 +77,26 @@ Application::Application(Parameters const& par) : par_(par) {
   }
 
   if (data_source_) {
-    source_ = std::make_unique<fles::MicrosliceReceiver>(*data_source_);
+    receiver_ = std::make_unique<fles::MicrosliceReceiver>(*data_source_);
+    // the pipeline stages and sinks share the microslices in the buffer
+    receiver_->set_zero_copy(true);
   } else if (!par_.input_archive.empty()) {
-    source_ =
-        std::make_unique<fles::MicrosliceInputArchive>(par_.input_archive);
+    if (fles::is_native_archive(par_.input_archive)) {
+      source_ = std::make_unique<fles::NativeMicrosliceInputArchive>(
+          par_.input_archive);
+    } else {
+      source_ =
+          std::make_unique<fles::MicrosliceInputArchive>(par_.input_archive);
+    }
+  }
+
+  // Processing stages
+  if (par_.override_descriptor) {
+    stages_.push_back(std::make_unique<fles::DescriptorOverrideStage>(
+        par_.override_sys_id, par_.override_sys_ver));
+  }
+  if (par_.combine_contents) {
+    stages_.push_back(std::make_unique<fles::CombineContentsStage>());
   }
 
   // Sink setup
@@ -55,14 +105,23 @@ Application::Application(Parameters const& par) : par_(par) {
         new MicrosliceAnalyzer(100000, 3, std::cout, "", par_.channel_idx)));
   }
 
+  if (!par_.learn_profile.empty()) {
+    sinks_.push_back(std::unique_ptr<fles::MicrosliceSink>(
+        new MicrosliceLoadProfiler(par_.learn_profile)));
+  }
+
   if (par_.dump_verbosity > 0) {
+    DumpSampling sampling;
+    sampling.every = par_.dump_every;
+    sampling.rate = par_.dump_rate;
+    sampling.bytes_per_second = par_.dump_bytes;
     sinks_.push_back(std::unique_ptr<fles::MicrosliceSink>(
-        new MicrosliceDumper(std::cout, par_.dump_verbosity)));
+        new MicrosliceDumper(std::cout, par_.dump_verbosity, sampling)));
   }
 
   if (!par_.output_archive.empty()) {
-    sinks_.push_back(std::unique_ptr<fles::MicrosliceSink>(
-        new fles::MicrosliceOutputArchive(par_.output_archive)));
+    sinks_.push_back(
+        make_output_archive(par_.output_archive, par_));
   }
 
   if (!par_.output_shm.empty()) {
@@ -72,7 +131,8 @@ Application::Application(Parameters const& par) : par_(par) {
     constexpr std::size_t data_buffer_size_exp = 27; // 128 MiB
 
     output_shm_device_ = std::make_unique<flib_shm_device_provider>(
-        par_.output_shm, 1, data_buffer_size_exp, desc_buffer_size_exp);
+        par_.output_shm, 1, data_buffer_size_exp, desc_buffer_size_exp,
+        par_.output_shm_persistent);
     InputBufferWriteInterface* data_sink = output_shm_device_->channels().at(0);
     sinks_.push_back(std::unique_ptr<fles::MicrosliceSink>(
         new fles::MicrosliceTransmitter(*data_sink)));
@@ -83,22 +143,254 @@ Application::~Application() {
   L_(info) << "total microslices processed: " << count_;
 }
 
-void Application::run() {
+void Application::run_batched() {
   uint64_t limit = par_.maximum_number;
 
-  while (auto microslice = source_->get()) {
-    std::shared_ptr<const fles::Microslice> ms(std::move(microslice));
-    for (auto& sink : sinks_) {
-      sink->put(ms);
-    }
-    ++count_;
-    if (count_ == limit) {
+  while (count_ < limit) {
+    fles::MicrosliceBatch batch = receiver_->get_batch(limit - count_);
+    if (batch.empty()) {
       break;
     }
+    for (const auto& view : batch) {
+      // all sinks consume synchronously, the batch outlives the pointer
+      std::shared_ptr<const fles::Microslice> ms(
+          std::shared_ptr<const fles::Microslice>(), &view);
+      for (auto& sink : sinks_) {
+        sink->put(ms);
+      }
+      ++count_;
+    }
+  }
+}
+
+void Application::run_pipeline(fles::MicrosliceSource& source) {
+  std::vector<fles::MicrosliceSink*> sinks;
+  sinks.reserve(sinks_.size());
+  for (auto& sink : sinks_) {
+    sinks.push_back(sink.get());
+  }
+
+  // Read in the calling thread. Each stage runs on its own thread, as do the
+  // sinks if read-ahead is requested without any stages.
+  fles::Pipeline<fles::Microslice> pipeline(source);
+  if (stages_.empty()) {
+    if (par_.prefetch > 0) {
+      pipeline = std::move(pipeline).thread(par_.prefetch);
+    }
+    count_ = std::move(pipeline).run(sinks, par_.maximum_number);
+    return;
+  }
+
+  std::size_t capacity = par_.prefetch > 0 ? par_.prefetch : par_.stage_queue;
+  auto staged = std::move(pipeline).thread(capacity).then(*stages_.front());
+  for (std::size_t i = 1; i < stages_.size(); ++i) {
+    staged = std::move(staged).thread(par_.stage_queue).then(*stages_[i]);
+  }
+  count_ = std::move(staged).run(sinks, par_.maximum_number);
+}
+
+void Application::init_channels() {
+  constexpr uint32_t typical_content_size = 10000;
+  constexpr std::size_t desc_buffer_size_exp = 19; // 512 ki entries
+  constexpr std::size_t data_buffer_size_exp = 27; // 128 MiB
+
+  std::vector<size_t> channels = par_.channels;
+  if (!par_.input_shm.empty()) {
+    L_(info) << "using shared memory as data source: " << par_.input_shm;
+    shm_device_ = std::make_shared<flib_shm_device_client>(par_.input_shm);
+    if (par_.all_channels) {
+      for (size_t c = 0; c < shm_device_->num_channels(); ++c) {
+        channels.push_back(c);
+      }
+    }
+  } else {
+    L_(info) << "using pattern generators as data source";
+  }
+  if (channels.empty()) {
+    throw std::runtime_error("no channels to read");
+  }
+
+  // the readers refer to their statistics, so reserve no more afterwards
+  channel_statistics_.resize(channels.size());
+  for (std::size_t i = 0; i < channels.size(); ++i) {
+    size_t c = channels[i];
+    std::unique_ptr<InputBufferReadInterface> data_source;
+    if (shm_device_) {
+      if (c >= shm_device_->num_channels()) {
+        throw std::runtime_error("shared memory channel " + std::to_string(c) +
+                                 " not available");
+      }
+      data_source = std::make_unique<flib_shm_channel_client>(
+          shm_device_, c, shm_reader());
+    } else {
+      data_source = std::make_unique<FlesnetPatternGenerator>(
+          data_buffer_size_exp, desc_buffer_size_exp, c, typical_content_size,
+          true, true);
+    }
+    channel_statistics_[i].channel = c;
+    auto reader = std::make_unique<ChannelReader>(
+        std::move(data_source), par_.maximum_number, channel_statistics_[i]);
+
+    if (par_.analyze) {
+      reader->add_sink(std::make_unique<MicrosliceAnalyzer>(
+          100000, 3, std::cout, "ch" + std::to_string(c) + ": ", c));
+    }
+    if (!par_.output_archive.empty() && !par_.merge_output) {
+      std::string filename = par_.output_archive;
+      if (filename.find("%c") == std::string::npos) {
+        filename += ".%c";
+      }
+      boost::replace_all(filename, "%c", std::to_string(c));
+      reader->add_sink(make_output_archive(filename, par_));
+    }
+    channel_readers_.push_back(std::move(reader));
+  }
+
+  if (par_.merge_output) {
+    sinks_.push_back(
+        make_output_archive(par_.output_archive, par_));
+  }
+}
+
+void Application::run_channels() {
+  std::vector<std::thread> threads;
+  std::vector<std::exception_ptr> errors(channel_readers_.size());
+  threads.reserve(channel_readers_.size());
+  for (std::size_t i = 0; i < channel_readers_.size(); ++i) {
+    threads.emplace_back([this, i, &errors] {
+      try {
+        channel_readers_[i]->run();
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+void Application::run_channels_merged() {
+  // Each channel is read ahead on its own thread; the merged stream is
+  // written in the calling thread.
+  constexpr std::size_t default_merge_queue = 1000;
+  std::size_t queue = par_.prefetch > 0 ? par_.prefetch : default_merge_queue;
+
+  std::vector<std::unique_ptr<fles::MicrosliceSource>> sources;
+  for (auto& reader : channel_readers_) {
+    sources.push_back(std::move(reader));
+  }
+  channel_readers_.clear();
+  fles::MergingSource<fles::MicrosliceSource> merged(std::move(sources),
+                                                     queue);
+  while (auto ms = merged.get()) {
+    std::shared_ptr<const fles::Microslice> ptr(std::move(ms));
+    for (auto& sink : sinks_) {
+      sink->put(ptr);
+    }
   }
   for (auto& sink : sinks_) {
     sink->end_stream();
   }
+}
+
+void Application::report_channels() const {
+  uint64_t total_bytes = 0;
+  for (const auto& stats : channel_statistics_) {
+    L_(info) << "channel " << stats.channel << ": " << stats.microslices
+             << " microslices, "
+             << human_readable_count(stats.content_bytes);
+    total_bytes += stats.content_bytes;
+  }
+  L_(info) << "all " << channel_statistics_.size() << " channels: " << count_
+           << " microslices, " << human_readable_count(total_bytes);
+  if (channel_seconds_ > 0) {
+    L_(info) << "aggregate throughput: "
+             << human_readable_count(static_cast<uint64_t>(
+                    static_cast<double>(total_bytes) / channel_seconds_))
+             << "/s";
+  }
+}
+
+void Application::run_timeslice_builder() {
+  constexpr std::size_t default_channel_prefetch = 1000;
+  constexpr std::size_t timeslice_queue = 4;
+
+  L_(info) << "building timeslices from " << par_.input_archives.size()
+           << " microslice archives";
+  auto time_begin = std::chrono::steady_clock::now();
+  std::unique_ptr<fles::TimesliceSource> builder =
+      OfflineTimesliceBuilder::from_archives(
+          par_.input_archives, par_.timeslice_size, par_.overlap_size,
+          par_.timeslice_duration, par_.overlap_duration,
+          par_.prefetch > 0 ? par_.prefetch : default_channel_prefetch);
+  // Assemble the timeslices on a background thread while the calling
+  // thread writes them.
+  fles::PrefetchingSource<fles::TimesliceSource> source(std::move(builder),
+                                                        timeslice_queue);
+  fles::TimesliceOutputArchiveSequence sink(
+      par_.output_timeslice_archive,
+      par_.timeslices_per_file > 0 ? par_.timeslices_per_file : SIZE_MAX);
+  uint64_t timeslices = 0;
+  uint64_t bytes = 0;
+  while (auto ts = source.get()) {
+    for (uint64_t c = 0; c < ts->num_components(); ++c) {
+      bytes += ts->size_component(c);
+    }
+    sink.put(std::move(ts));
+    ++timeslices;
+  }
+  sink.end_stream();
+  const double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - time_begin)
+                             .count();
+  L_(info) << "timeslices built: " << timeslices << ", "
+           << human_readable_count(bytes);
+  if (seconds > 0) {
+    L_(info) << "throughput: "
+             << human_readable_count(
+                    static_cast<uint64_t>(static_cast<double>(bytes) / seconds))
+             << "/s";
+  }
+}
+
+void Application::run() {
+  if (par_.build_timeslices()) {
+    run_timeslice_builder();
+    return;
+  }
+  if (!channel_statistics_.empty()) {
+    auto time_begin = std::chrono::steady_clock::now();
+    if (par_.merge_output) {
+      run_channels_merged();
+    } else {
+      run_channels();
+    }
+    channel_seconds_ = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - time_begin)
+                           .count();
+    count_ = 0;
+    for (const auto& stats : channel_statistics_) {
+      count_ += stats.microslices;
+    }
+    report_channels();
+    return;
+  }
+  if (receiver_ && stages_.empty()) {
+    run_batched();
+    for (auto& sink : sinks_) {
+      sink->end_stream();
+    }
+  } else if (receiver_) {
+    run_pipeline(*receiver_);
+  } else {
+    run_pipeline(*source_);
+  }
   if (output_shm_device_) {
     L_(info) << "waiting until output shared memory is empty";
     while (!output_shm_device_->channels().at(0)->empty()) {
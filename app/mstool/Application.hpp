@@ -1,15 +1,22 @@
 // Copyright 2012-2015 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include "ChannelReader.hpp"
 #include "DualRingBuffer.hpp"
 #include "MicrosliceSource.hpp"
 #include "Parameters.hpp"
+#include "Pipeline.hpp"
 #include "Sink.hpp"
 #include "shm_device_client.hpp"
 #include "shm_device_provider.hpp"
 #include <memory>
 #include <vector>
 
+namespace fles {
+class MicrosliceReceiver;
+class StorableMicroslice;
+} // namespace fles
+
 /// %Application base class.
 class Application {
 public:
@@ -23,14 +30,44 @@ public:
   void run();
 
 private:
+  void run_batched();
+  void run_pipeline(fles::MicrosliceSource& source);
+
+  /// Set up one reader per channel for multi-channel mode.
+  void init_channels();
+  /// Retrieve the reader type of the input shared memory channels.
+  [[nodiscard]] shm_reader_type shm_reader() const {
+    return par_.input_shm_lossy ? shm_reader_type::lossy
+                                : shm_reader_type::primary;
+  }
+  /// Run the channel readers in parallel, one thread each.
+  void run_channels();
+  /// Run the channel readers merged into a single output archive.
+  void run_channels_merged();
+  /// Print the per-channel and aggregate statistics.
+  void report_channels() const;
+  /// Build timeslices from the input archives and write them.
+  void run_timeslice_builder();
+
   Parameters const& par_;
 
   std::shared_ptr<flib_shm_device_client> shm_device_;
   std::unique_ptr<flib_shm_device_provider> output_shm_device_;
   std::unique_ptr<InputBufferReadInterface> data_source_;
 
+  std::unique_ptr<fles::MicrosliceReceiver> receiver_;
   std::unique_ptr<fles::MicrosliceSource> source_;
+  std::vector<std::unique_ptr<
+      fles::PipelineStage<fles::Microslice, fles::StorableMicroslice>>>
+      stages_;
   std::vector<std::unique_ptr<fles::MicrosliceSink>> sinks_;
 
+  /// Channel readers in multi-channel mode.
+  std::vector<std::unique_ptr<ChannelReader>> channel_readers_;
+  /// Channel statistics (referenced by the channel readers).
+  std::vector<ChannelStatistics> channel_statistics_;
+  /// Duration of the multi-channel run (for throughput statistics).
+  double channel_seconds_ = 0.0;
+
   uint64_t count_ = 0;
 };
@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "ChannelReader.hpp"
+
+ChannelReader::ChannelReader(
+    std::unique_ptr<InputBufferReadInterface> data_source,
+    uint64_t limit,
+    ChannelStatistics& statistics)
+    : data_source_(std::move(data_source)), receiver_(*data_source_),
+      limit_(limit), statistics_(statistics) {}
+
+void ChannelReader::run() {
+  while (statistics_.microslices < limit_) {
+    fles::MicrosliceBatch batch =
+        receiver_.get_batch(limit_ - statistics_.microslices);
+    if (batch.empty()) {
+      break;
+    }
+    for (const auto& view : batch) {
+      consume(view);
+    }
+  }
+  finish();
+}
+
+fles::Microslice* ChannelReader::do_get() {
+  if (eos_) {
+    return nullptr;
+  }
+  std::unique_ptr<fles::StorableMicroslice> ms;
+  if (statistics_.microslices < limit_) {
+    ms = receiver_.get();
+  }
+  if (!ms) {
+    finish();
+    return nullptr;
+  }
+  consume(*ms);
+  return ms.release();
+}
+
+void ChannelReader::consume(const fles::Microslice& ms) {
+  // all sinks consume synchronously, the caller outlives the pointer
+  std::shared_ptr<const fles::Microslice> ptr(
+      std::shared_ptr<const fles::Microslice>(), &ms);
+  for (auto& sink : sinks_) {
+    sink->put(ptr);
+  }
+  ++statistics_.microslices;
+  statistics_.content_bytes += ms.desc().size;
+}
+
+void ChannelReader::finish() {
+  eos_ = true;
+  for (auto& sink : sinks_) {
+    sink->end_stream();
+  }
+}
@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#pragma once
+
+#include "DualRingBuffer.hpp"
+#include "MicrosliceReceiver.hpp"
+#include "MicrosliceSource.hpp"
+#include "Sink.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/// Statistics of a single channel in multi-channel mode.
+struct ChannelStatistics {
+  std::size_t channel = 0;
+  uint64_t microslices = 0;
+  uint64_t content_bytes = 0;
+};
+
+/// Per-channel microslice reader class.
+/** A ChannelReader object receives the microslices of one input channel and
+    passes them to its own sinks. It is meant to be used from a dedicated
+    thread, either consuming the channel completely (run()) or as a source
+    feeding a merged output stream. The statistics are written to a
+    caller-provided object, which must outlive the reader. */
+
+class ChannelReader : public fles::MicrosliceSource {
+public:
+  /// The ChannelReader constructor.
+  ChannelReader(std::unique_ptr<InputBufferReadInterface> data_source,
+                uint64_t limit,
+                ChannelStatistics& statistics);
+
+  ChannelReader(const ChannelReader&) = delete;
+  void operator=(const ChannelReader&) = delete;
+
+  ~ChannelReader() override = default;
+
+  /// Add a sink to pass the microslices of this channel to.
+  void add_sink(std::unique_ptr<fles::MicrosliceSink> sink) {
+    sinks_.push_back(std::move(sink));
+  }
+
+  /// Consume all microslices of the channel without copying them.
+  void run();
+
+  [[nodiscard]] bool eos() const override { return eos_; }
+
+private:
+  std::unique_ptr<InputBufferReadInterface> data_source_;
+  fles::MicrosliceReceiver receiver_;
+  std::vector<std::unique_ptr<fles::MicrosliceSink>> sinks_;
+
+  /// Number of microslices after which the channel ends.
+  const uint64_t limit_;
+
+  ChannelStatistics& statistics_;
+
+  bool eos_ = false;
+
+  fles::Microslice* do_get() override;
+
+  /// Pass a microslice to all sinks of the channel.
+  void consume(const fles::Microslice& ms);
+
+  /// Signal the end of the channel to all sinks.
+  void finish();
+};
@@ -30,8 +30,8 @@ void Parameters::parse_options(int argc, char* argv[]) {
                   ->value_name("<n>"),
               "enable logging to syslog at given log level");
   general_add("maximum-number,n", po::value<uint64_t>(&maximum_number),
-              "set the maximum number of microslices to process (default: "
-              "unlimited)");
+              "set the maximum number of microslices to process, per channel "
+              "in multi-channel mode (default: unlimited)");
   general_add("exec,e", po::value<std::string>(&exec)->value_name("<string>"),
               "name of an executable to run after startup");
 
@@ -41,24 +41,121 @@ void Parameters::parse_options(int argc, char* argv[]) {
              "use pattern generator to produce timeslices");
   source_add("channel,c", po::value<size_t>(&channel_idx),
              "use given channel/component index for source/sink");
+  source_add("channels",
+             po::value<std::vector<size_t>>(&channels)
+                 ->multitoken()
+                 ->value_name("<n>..."),
+             "read the given channels of the input shared memory (or "
+             "pattern generators) in parallel, one thread each");
+  source_add("all-channels",
+             po::value<bool>(&all_channels)->implicit_value(true),
+             "read all channels of the input shared memory in parallel");
   source_add("input-shm,I", po::value<std::string>(&input_shm),
              "name of a shared memory to use as data source");
+  source_add("input-shm-lossy",
+             po::value<bool>(&input_shm_lossy)->implicit_value(true),
+             "read the input shared memory without holding back its writer, "
+             "skipping overwritten microslices");
   source_add("input-archive,i", po::value<std::string>(&input_archive),
              "name of an input file archive to read");
+  source_add("input-archives",
+             po::value<std::vector<std::string>>(&input_archives)
+                 ->multitoken()
+                 ->value_name("<file>..."),
+             "build timeslices from the given microslice archives, one per "
+             "channel and each read on its own thread (requires "
+             "--output-timeslice-archive)");
+  source_add("prefetch", po::value<size_t>(&prefetch)->value_name("<n>"),
+             "read up to <n> microslices from the input archive ahead on a "
+             "background thread");
+
+  po::options_description stage("Processing options");
+  auto stage_add = stage.add_options();
+  stage_add("override-sys-id", po::value<unsigned>()->value_name("<id>"),
+            "override the subsystem identifier of each microslice (requires "
+            "--override-sys-ver)");
+  stage_add("override-sys-ver", po::value<unsigned>()->value_name("<ver>"),
+            "override the subsystem format version of each microslice");
+  stage_add("combine-contents",
+            po::value<bool>(&combine_contents)->implicit_value(true),
+            "combine the contents of each two consecutive microslices");
+  stage_add("stage-queue",
+            po::value<size_t>(&stage_queue)
+                ->default_value(stage_queue)
+                ->value_name("<n>"),
+            "run each processing option on its own thread, queueing up to "
+            "<n> microslices in between");
 
   po::options_description sink("Sink options");
   auto sink_add = sink.add_options();
   sink_add("analyze,a", po::value<bool>(&analyze)->implicit_value(true),
            "enable/disable pattern check");
+  sink_add("learn-profile", po::value<std::string>(&learn_profile),
+           "learn the microslice size distribution and spill structure and "
+           "write them as a load profile for the 'profile' input of flesnet");
   sink_add("dump_verbosity,v", po::value<size_t>(&dump_verbosity),
            "set output debug dump verbosity");
+  sink_add("dump-every", po::value<uint64_t>(&dump_every)->value_name("<n>"),
+           "dump only every <n>th microslice; sampled dumps are formatted "
+           "in the background");
+  sink_add("dump-rate", po::value<double>(&dump_rate)->value_name("<x>"),
+           "dump at most <x> microslices per second (default: 0 = no limit)");
+  sink_add("dump-bytes", po::value<uint64_t>(&dump_bytes)->value_name("<n>"),
+           "limit the debug dump output to <n> bytes per second (default: 0 "
+           "= no limit)");
   sink_add("output-shm,O", po::value<std::string>(&output_shm),
            "name of a shared memory to write to");
+  sink_add("output-shm-persistent",
+           po::value<bool>(&output_shm_persistent)->implicit_value(true),
+           "keep the output shared memory on exit, and re-attach to a kept "
+           "one of the same size instead of creating it anew");
   sink_add("output-archive,o", po::value<std::string>(&output_archive),
            "name of an output file archive to write");
+  sink_add("output-compact",
+           po::value<bool>(&output_compact)->implicit_value(true),
+           "encode the microslice descriptors in the output file archive "
+           "compactly (relative to the previous microslice)");
+  sink_add("output-blocks",
+           po::value<size_t>(&output_blocks)->value_name("<n>"),
+           "write the output file archive in the native format, in blocks of "
+           "up to <n> microslices stored as one descriptor array and one "
+           "content blob each (for channels with many small microslices)");
+  sink_add("merge", po::value<bool>(&merge_output)->implicit_value(true),
+           "in multi-channel mode, write all channels to a single output "
+           "file archive in ascending order of microslice index (default: "
+           "one archive per channel, use placeholder %c in filename)");
+
+  po::options_description build("Timeslice building options");
+  auto build_add = build.add_options();
+  build_add("output-timeslice-archive",
+            po::value<std::string>(&output_timeslice_archive),
+            "name of the timeslice archive to write the timeslices built "
+            "from --input-archives to (use placeholder %n with "
+            "--timeslices-per-file)");
+  build_add("timeslices-per-file",
+            po::value<size_t>(&timeslices_per_file)->value_name("<n>"),
+            "start a new timeslice archive file after <n> timeslices "
+            "(default: unlimited)");
+  build_add("timeslice-size",
+            po::value<uint32_t>(&timeslice_size)
+                ->default_value(timeslice_size)
+                ->value_name("<n>"),
+            "number of core microslices per timeslice");
+  build_add("overlap-size",
+            po::value<uint32_t>(&overlap_size)
+                ->default_value(overlap_size)
+                ->value_name("<n>"),
+            "number of overlapping microslices per timeslice");
+  build_add("timeslice-duration",
+            po::value<uint64_t>(&timeslice_duration)->value_name("<ns>"),
+            "cut the timeslices by time windows of the given duration "
+            "instead of by microslice count");
+  build_add("overlap-duration",
+            po::value<uint64_t>(&overlap_duration)->value_name("<ns>"),
+            "overlap duration of time-based timeslices");
 
   po::options_description desc;
-  desc.add(general).add(source).add(sink);
+  desc.add(general).add(source).add(stage).add(sink).add(build);
 
   po::variables_map vm;
   po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -88,12 +185,75 @@ void Parameters::parse_options(int argc, char* argv[]) {
 
   use_pattern_generator = vm.count("pattern-generator") != 0;
 
+  if ((vm.count("override-sys-id") != 0u) !=
+      (vm.count("override-sys-ver") != 0u)) {
+    throw ParametersException(
+        "override-sys-id and override-sys-ver must be given together");
+  }
+  if (vm.count("override-sys-id") != 0u) {
+    override_descriptor = true;
+    override_sys_id =
+        static_cast<uint8_t>(vm["override-sys-id"].as<unsigned>());
+    override_sys_ver =
+        static_cast<uint8_t>(vm["override-sys-ver"].as<unsigned>());
+  }
+
   size_t input_sources = vm.count("pattern-generator") +
-                         vm.count("input-archive") + vm.count("input-shm");
+                         vm.count("input-archive") + vm.count("input-shm") +
+                         vm.count("input-archives");
   if (input_sources == 0) {
     throw ParametersException("no input source specified");
   }
   if (input_sources > 1) {
     throw ParametersException("more than one input source specified");
   }
+
+  if (all_channels && !channels.empty()) {
+    throw ParametersException("channels and all-channels are exclusive");
+  }
+  if (multi_channel()) {
+    if (vm.count("channel") != 0u) {
+      throw ParametersException("channel and channels are exclusive");
+    }
+    if (!input_archive.empty()) {
+      throw ParametersException(
+          "multi-channel mode requires a shared memory or pattern generator "
+          "input");
+    }
+    if (all_channels && input_shm.empty()) {
+      throw ParametersException("all-channels requires a shared memory input");
+    }
+    if (override_descriptor || combine_contents || dump_verbosity > 0 ||
+        !output_shm.empty()) {
+      throw ParametersException(
+          "multi-channel mode supports analyze and output-archive only");
+    }
+  }
+  if (build_timeslices() != !output_timeslice_archive.empty()) {
+    throw ParametersException(
+        "input-archives and output-timeslice-archive must be given together");
+  }
+  if (build_timeslices()) {
+    if (multi_channel() || override_descriptor || combine_contents ||
+        analyze || !learn_profile.empty() || dump_verbosity > 0 ||
+        !output_shm.empty() || !output_archive.empty()) {
+      throw ParametersException(
+          "timeslice building supports no other processing or sink options");
+    }
+    if (timeslice_duration == 0 && timeslice_size == 0) {
+      throw ParametersException("timeslice size must be positive");
+    }
+  }
+  if (output_blocks > 0 && (output_archive.empty() || output_compact)) {
+    throw ParametersException(
+        "output-blocks requires an output archive and excludes output-compact");
+  }
+  if (merge_output && (!multi_channel() || output_archive.empty())) {
+    throw ParametersException(
+        "merge requires multi-channel mode and an output archive");
+  }
+  if (dump_every == 0 || dump_rate < 0.0) {
+    throw ParametersException(
+        "dump-every must be positive and dump-rate must not be negative");
+  }
 }
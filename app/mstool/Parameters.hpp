@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 /// Run parameters exception class.
 class ParametersException : public std::runtime_error {
@@ -17,6 +18,16 @@ struct Parameters {
   Parameters(int argc, char* argv[]) { parse_options(argc, argv); }
   void parse_options(int argc, char* argv[]);
 
+  /// Check if several channels are read in parallel.
+  [[nodiscard]] bool multi_channel() const {
+    return all_channels || !channels.empty();
+  }
+
+  /// Check if timeslices are built from per-channel microslice archives.
+  [[nodiscard]] bool build_timeslices() const {
+    return !input_archives.empty();
+  }
+
   // general options
   uint64_t maximum_number = UINT64_MAX;
   std::string exec;
@@ -25,12 +36,40 @@ struct Parameters {
   uint32_t pattern_generator = 0;
   bool use_pattern_generator = false;
   size_t channel_idx = 0;
+  std::vector<size_t> channels;
+  bool all_channels = false;
   std::string input_shm;
+  bool input_shm_lossy = false;
   std::string input_archive;
+  std::vector<std::string> input_archives;
+  size_t prefetch = 0;
+
+  // processing stages
+  bool override_descriptor = false;
+  uint8_t override_sys_id = 0;
+  uint8_t override_sys_ver = 0;
+  bool combine_contents = false;
+  size_t stage_queue = 16;
 
   // sink selection
   bool analyze = false;
+  std::string learn_profile;
   size_t dump_verbosity = 0;
+  uint64_t dump_every = 1;
+  double dump_rate = 0.0;
+  uint64_t dump_bytes = 0;
   std::string output_shm;
+  bool output_shm_persistent = false;
   std::string output_archive;
+  bool output_compact = false;
+  size_t output_blocks = 0;
+  bool merge_output = false;
+
+  // timeslice building
+  std::string output_timeslice_archive;
+  size_t timeslices_per_file = 0;
+  uint32_t timeslice_size = 100;
+  uint32_t overlap_size = 1;
+  uint64_t timeslice_duration = 0;
+  uint64_t overlap_duration = 0;
 };
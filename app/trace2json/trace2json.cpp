@@ -0,0 +1,206 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+//
+// Convert binary event trace files (see EventTrace.hpp) of one or several
+// processes to the Chrome trace event format, which can be loaded into
+// Perfetto (ui.perfetto.dev) or chrome://tracing.
+
+#include "EventTrace.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct TraceFile {
+  std::string host;
+  uint32_t pid = 0;
+  std::map<uint32_t, std::string> thread_names;
+  std::vector<TraceEvent> events;
+};
+
+template <typename T> void read_entry(std::ifstream& ifs, T& entry) {
+  ifs.read(reinterpret_cast<char*>(&entry), sizeof(T));
+}
+
+TraceFile read_trace_file(const std::string& filename) {
+  std::ifstream ifs(filename, std::ios::binary);
+  if (!ifs) {
+    throw std::runtime_error("cannot open " + filename);
+  }
+  TraceFileHeader header;
+  read_entry(ifs, header);
+  if (!ifs || header.magic != TraceFileHeader::magic_value) {
+    throw std::runtime_error("not an event trace file: " + filename);
+  }
+  TraceFile file;
+  file.host = std::string(header.host, strnlen(header.host,
+                                               sizeof(header.host)));
+  file.pid = header.pid;
+
+  TraceChunkHeader chunk;
+  while (read_entry(ifs, chunk), ifs) {
+    for (uint32_t i = 0; i < chunk.count && ifs; ++i) {
+      if (chunk.kind == TraceChunkHeader::Threads) {
+        TraceThreadInfo info;
+        read_entry(ifs, info);
+        file.thread_names[info.index] =
+            std::string(info.name, strnlen(info.name, sizeof(info.name)));
+      } else if (chunk.kind == TraceChunkHeader::Events) {
+        TraceEvent event{};
+        read_entry(ifs, event);
+        file.events.push_back(event);
+      } else {
+        throw std::runtime_error("corrupt event trace file: " + filename);
+      }
+    }
+  }
+  // events of different threads are interleaved in chunks
+  std::stable_sort(file.events.begin(), file.events.end(),
+                   [](const TraceEvent& a, const TraceEvent& b) {
+                     return a.time_ns < b.time_ns;
+                   });
+  return file;
+}
+
+class JsonWriter {
+public:
+  JsonWriter(std::ostream& os, uint64_t time_base)
+      : os_(os), time_base_(time_base) {
+    os_ << "{\"traceEvents\":[\n";
+  }
+
+  ~JsonWriter() { os_ << "\n]}\n"; }
+
+  void metadata(const char* name, uint32_t pid, uint32_t tid,
+                const std::string& value) {
+    begin();
+    os_ << R"({"ph":"M","name":")" << name << R"(","pid":)" << pid
+        << R"(,"tid":)" << tid << R"(,"args":{"name":")" << value << "\"}}";
+  }
+
+  void instant(const TraceEvent& event, uint32_t pid) {
+    begin();
+    os_ << R"({"ph":"i","s":"t","name":")"
+        << trace_event_name(static_cast<TraceEventType>(event.type))
+        << R"(","pid":)" << pid << R"(,"tid":)" << event.thread
+        << R"(,"ts":)";
+    timestamp(event.time_ns);
+    os_ << R"(,"args":{"ts":)" << event.id << R"(,"arg":)" << event.arg
+        << "}}";
+  }
+
+  // One half of an async span, shown as a bar per timeslice
+  void span(char phase, const char* name, const TraceEvent& event,
+            uint32_t pid, uint64_t id) {
+    begin();
+    os_ << R"({"ph":")" << phase << R"(","cat":")" << name << R"(","name":")"
+        << name << R"(","id":)" << id << R"(,"pid":)" << pid << R"(,"tid":)"
+        << event.thread << R"(,"ts":)";
+    timestamp(event.time_ns);
+    os_ << R"(,"args":{"ts":)" << event.id << "}}";
+  }
+
+private:
+  void begin() {
+    if (!first_) {
+      os_ << ",\n";
+    }
+    first_ = false;
+  }
+
+  // microseconds relative to the earliest event, with ns resolution
+  void timestamp(uint64_t time_ns) {
+    uint64_t t = time_ns - time_base_;
+    os_ << t / 1000 << '.' << std::setw(3) << std::setfill('0') << t % 1000;
+  }
+
+  std::ostream& os_;
+  uint64_t time_base_;
+  bool first_ = true;
+};
+
+void convert(const std::vector<TraceFile>& files, std::ostream& os) {
+  uint64_t time_base = UINT64_MAX;
+  for (const auto& file : files) {
+    if (!file.events.empty()) {
+      time_base = std::min(time_base, file.events.front().time_ns);
+    }
+  }
+  if (time_base == UINT64_MAX) {
+    time_base = 0;
+  }
+
+  JsonWriter json(os, time_base);
+  for (uint32_t pid = 0; pid < files.size(); ++pid) {
+    const auto& file = files[pid];
+    json.metadata("process_name", pid, 0,
+                  file.host + " (" + std::to_string(file.pid) + ")");
+    for (const auto& [tid, name] : file.thread_names) {
+      if (!name.empty()) {
+        json.metadata("thread_name", pid, tid, name);
+      }
+    }
+
+    for (const auto& event : file.events) {
+      json.instant(event, pid);
+      // spans are keyed by timeslice (and compute node for transfers), the
+      // pid makes them unique across processes
+      uint64_t transfer_id = (event.id << 16 | (event.arg & 0xffff)) * 1024 +
+                             pid;
+      uint64_t item_id = event.id * 1024 + pid;
+      switch (static_cast<TraceEventType>(event.type)) {
+      case TraceEventType::TimeslicePosted:
+        json.span('b', "transfer", event, pid, transfer_id);
+        break;
+      case TraceEventType::WriteCompleted:
+        json.span('e', "transfer", event, pid, transfer_id);
+        break;
+      case TraceEventType::WorkItemSent:
+        json.span('b', "processing", event, pid, item_id);
+        break;
+      case TraceEventType::CompletionReceived:
+        json.span('e', "processing", event, pid, item_id);
+        break;
+      default:
+        break;
+      }
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0]
+              << " <output.json> <trace file> [<trace file> ...]\n"
+              << "Convert event trace files to the Chrome trace format.\n";
+    return EXIT_FAILURE;
+  }
+
+  try {
+    std::vector<TraceFile> files;
+    for (int i = 2; i < argc; ++i) {
+      files.push_back(read_trace_file(argv[i]));
+    }
+    std::ofstream ofs(argv[1]);
+    if (!ofs) {
+      throw std::runtime_error(std::string("cannot open ") + argv[1]);
+    }
+    convert(files, ofs);
+  } catch (std::exception const& e) {
+    std::cerr << "FATAL: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -1,58 +1,187 @@
 // Copyright 2012-2013 Jan de Cuveland <cmail@cuveland.de>
 
 #include "Application.hpp"
+#include "AllocationStats.hpp"
+#include "AsyncSink.hpp"
+#include "ChunkedTimesliceOutputArchive.hpp"
+#include "DeviceTimesliceAnalyzer.hpp"
+#include "LoadProfileAnalyzer.hpp"
 #include "ManagedTimesliceBuffer.hpp"
+#include "NativeOutputArchive.hpp"
+#include "PrefetchingSource.hpp"
+#include "ResourceControl.hpp"
 #include "StorableTimeslice.hpp"
+#include "System.hpp"
 #include "Timeslice.hpp"
 #include "TimesliceAnalyzer.hpp"
 #include "TimesliceAutoSource.hpp"
 #include "TimesliceDebugger.hpp"
+#include "TimesliceForwarderTcp.hpp"
+#include "TimesliceIndexedInputArchive.hpp"
 #include "TimesliceOutputArchive.hpp"
 #include "TimeslicePublisher.hpp"
+#include "TimesliceTap.hpp"
 #include "Utility.hpp"
+#include <filesystem>
 #include <thread>
 #include <utility>
 
 Application::Application(Parameters const& par,
                          volatile sig_atomic_t* signal_status)
     : par_(par), signal_status_(signal_status) {
+  // the threads started from here on follow the group
+  if (!par_.resctrl_group().empty()) {
+    ResctrlGroup group(par_.resctrl_group(), par_.resctrl_schemata());
+    group.add_process();
+    // shared with the other instances
+    group.keep();
+  }
+
   // start up monitoring
   if (!par.monitor_uri().empty()) {
     monitor_ = std::make_unique<cbm::Monitor>(par_.monitor_uri());
+    if (par_.allocation_stats()) {
+      cbm::AllocationStats::Enable();
+    }
+    if (par_.thread_stats()) {
+      monitor_->EnableThreadStats();
+    }
+  }
+  if (par_.live_stats()) {
+    cbm::LiveStats::Create("tsclient." +
+                           std::to_string(fles::system::current_pid()));
+    live_count_ = cbm::LiveStats::Counter("processed_timeslices");
+    live_index_ = cbm::LiveStats::Counter("timeslice_index");
   }
 
   if (par_.client_index() != -1) {
     output_prefix_ = std::to_string(par_.client_index()) + ": ";
   }
 
-  source_ = std::make_unique<fles::TimesliceAutoSource>(par_.input_uri());
+  // forwarded timeslices are received straight into the shm output
+  const bool forward_input = par_.input_uri().rfind("forward://", 0) == 0;
+  std::string input_uri = par_.input_uri();
+  if (!par_.checkpoint_file().empty()) {
+    checkpoint_.input = input_uri;
+    if (par_.resume() && std::filesystem::exists(par_.checkpoint_file())) {
+      auto checkpoint = ConsumerCheckpoint::read(par_.checkpoint_file());
+      if (checkpoint.input != checkpoint_.input) {
+        throw ParametersException("checkpoint file " +
+                                  par_.checkpoint_file() +
+                                  " belongs to a different input: " +
+                                  checkpoint.input);
+      }
+      checkpoint_ = checkpoint;
+      count_ = checkpoint_.count;
+      L_(info) << output_prefix_ << "resuming after timeslice "
+               << checkpoint_.index << " (" << count_
+               << " timeslices processed)";
+    }
+    try {
+      // with no timeslice processed yet, this only checks the input
+      const auto resume_uri = checkpoint_.resume_locator(input_uri);
+      if (count_ > 0) {
+        input_uri = resume_uri;
+      }
+    } catch (const std::runtime_error& e) {
+      throw ParametersException(std::string("checkpoint not supported: ") +
+                                e.what());
+    }
+  }
+  if (!forward_input) {
+    source_ = std::make_unique<fles::TimesliceAutoSource>(input_uri);
+    if (par_.prefetch() > 0) {
+      source_ =
+          std::make_unique<fles::PrefetchingSource<fles::TimesliceSource>>(
+              std::move(source_), par_.prefetch());
+    }
+  }
 
   if (par_.analyze()) {
     if (par_.histograms()) {
-      sinks_.push_back(std::unique_ptr<fles::TimesliceSink>(
-          new TimesliceAnalyzer(1000, status_log_.stream, output_prefix_,
-                                &std::cout, monitor_.get())));
+      add_sink(std::unique_ptr<fles::TimesliceSink>(new TimesliceAnalyzer(
+                   1000, status_log_.stream, output_prefix_, &std::cout,
+                   monitor_.get(), par_.analyze_threads())),
+               "analyzer");
     } else {
-      sinks_.push_back(std::unique_ptr<fles::TimesliceSink>(
-          new TimesliceAnalyzer(1000, status_log_.stream, output_prefix_,
-                                nullptr, monitor_.get())));
+      add_sink(std::unique_ptr<fles::TimesliceSink>(new TimesliceAnalyzer(
+                   1000, status_log_.stream, output_prefix_, nullptr,
+                   monitor_.get(), par_.analyze_threads())),
+               "analyzer");
     }
   }
 
+  if (par_.analyze_gpu()) {
+    DeviceTimesliceAnalyzer::Parameters parameters;
+    parameters.device = par_.analyze_gpu_device();
+    parameters.batch_timeslices = par_.analyze_gpu_batch();
+    add_sink(std::unique_ptr<fles::TimesliceSink>(new DeviceTimesliceAnalyzer(
+                 parameters, status_log_.stream, output_prefix_,
+                 par_.histograms() ? &std::cout : nullptr)),
+             "gpu_analyzer");
+  }
+
+  if (!par_.learn_profile().empty()) {
+    add_sink(std::unique_ptr<fles::TimesliceSink>(
+                 new TimesliceLoadProfiler(par_.learn_profile())),
+             "profiler");
+  }
+
   if (par_.verbosity() > 0) {
-    sinks_.push_back(std::unique_ptr<fles::TimesliceSink>(
-        new TimesliceDumper(debug_log_.stream, par_.verbosity())));
+    DumpSampling sampling;
+    sampling.every = par_.dump_every();
+    sampling.rate = par_.dump_rate();
+    sampling.bytes_per_second = par_.dump_bytes();
+    add_sink(std::unique_ptr<fles::TimesliceSink>(new TimesliceDumper(
+                 debug_log_.stream, par_.verbosity(), sampling)),
+             "dumper");
   }
 
   bool has_shm_output = false;
   for (const auto& output_uri : par_.output_uris()) {
     // If output_uri has no full URI pattern, everything is in "uri.path"
     UriComponents uri{output_uri};
+    const auto sink_name = output_uri.substr(0, output_uri.find('?'));
+
+    // Queue parameters, valid for all schemes
+    size_t queue = par_.sink_queue();
+    auto overflow = fles::OverflowPolicy::Block;
+    if (auto it = uri.query_components.find("queue");
+        it != uri.query_components.end()) {
+      queue = stoull(it->second);
+      uri.query_components.erase(it);
+    }
+    if (auto it = uri.query_components.find("overflow");
+        it != uri.query_components.end()) {
+      overflow = fles::parse_overflow_policy(it->second);
+      uri.query_components.erase(it);
+    }
+    if (overflow != fles::OverflowPolicy::Block && queue == 0) {
+      throw std::runtime_error("overflow policy requires a sink queue: " +
+                               output_uri);
+    }
+    // Tap parameters, valid for all schemes
+    fles::TapParameters tap;
+    for (auto it = uri.query_components.begin();
+         it != uri.query_components.end();) {
+      it = tap.parse(it->first, it->second) ? uri.query_components.erase(it)
+                                             : std::next(it);
+    }
 
     if (uri.scheme == "file" || uri.scheme.empty()) {
       size_t items = SIZE_MAX;
       size_t bytes = SIZE_MAX;
       fles::ArchiveCompression compression = fles::ArchiveCompression::None;
+      bool index = false;
+      bool chunked = false;
+      bool native = false;
+      bool overlap_refs = false;
+      fles::ZstdParameters zstd_parameters;
+      fles::DirectIoParameters direct_io;
+      auto descriptor_encoding = fles::DescriptorEncoding::Verbatim;
+      std::string codecs;
+      std::string dictionaries;
+      std::string manifest;
       for (auto& [key, value] : uri.query_components) {
         if (key == "items") {
           items = stoull(value);
@@ -67,26 +196,114 @@ Application::Application(Parameters const& par,
             throw std::runtime_error(
                 "invalid compression type for scheme file: " + value);
           }
+        } else if (key == "level") {
+          zstd_parameters.level = std::stoi(value);
+        } else if (key == "threads") {
+          zstd_parameters.threads = stou(value);
+        } else if (key == "index") {
+          index = stoull(value) != 0;
+        } else if (key == "chunked") {
+          chunked = stoull(value) != 0;
+        } else if (key == "native") {
+          native = stoull(value) != 0;
+        } else if (key == "overlap_refs") {
+          overlap_refs = stoull(value) != 0;
+        } else if (key == "codecs") {
+          codecs = value;
+        } else if (key == "dict") {
+          dictionaries = value;
+        } else if (key == "manifest") {
+          manifest = value;
+        } else if (key == "direct") {
+          direct_io.enabled = stoull(value) != 0;
+        } else if (key == "depth") {
+          direct_io.queue_depth = stoull(value);
+        } else if (key == "fsync") {
+          direct_io.fsync = fles::parse_fsync_policy(value);
+        } else if (key == "descriptors") {
+          if (value == "verbatim") {
+            descriptor_encoding = fles::DescriptorEncoding::Verbatim;
+          } else if (value == "compact") {
+            descriptor_encoding = fles::DescriptorEncoding::Compact;
+          } else {
+            throw std::runtime_error(
+                "invalid descriptor encoding for scheme file: " + value);
+          }
         } else {
           throw std::runtime_error(
               "query parameter not implemented for scheme file: " + key);
         }
       }
       const auto file_path = uri.authority + uri.path;
-      if (items == SIZE_MAX && bytes == SIZE_MAX) {
-        sinks_.push_back(std::unique_ptr<fles::TimesliceSink>(
-            new fles::TimesliceOutputArchive(file_path, compression)));
+      if (native) {
+        if (chunked || items != SIZE_MAX || bytes != SIZE_MAX || index ||
+            compression != fles::ArchiveCompression::None ||
+            descriptor_encoding != fles::DescriptorEncoding::Verbatim ||
+            !codecs.empty() || !dictionaries.empty() || !manifest.empty()) {
+          throw std::runtime_error("query parameters chunked, items, bytes, "
+                                   "index, c, descriptors, codecs, dict and "
+                                   "manifest not implemented for native "
+                                   "output");
+        }
+        add_sink(std::unique_ptr<fles::TimesliceSink>(
+                     new fles::NativeTimesliceOutputArchive(
+                         file_path, true, direct_io, overlap_refs)),
+                 sink_name, queue, overflow, tap);
+      } else if (overlap_refs) {
+        throw std::runtime_error(
+            "query parameter overlap_refs requires native output");
+      } else if (chunked) {
+        if (items != SIZE_MAX || bytes != SIZE_MAX || index ||
+            zstd_parameters.threads != 0 || direct_io.enabled ||
+            descriptor_encoding != fles::DescriptorEncoding::Verbatim ||
+            !manifest.empty()) {
+          throw std::runtime_error("query parameters items, bytes, index, "
+                                   "threads, direct, descriptors and "
+                                   "manifest not implemented for chunked "
+                                   "output");
+        }
+        add_sink(std::unique_ptr<fles::TimesliceSink>(
+                     new fles::ChunkedTimesliceOutputArchive(
+                         file_path, compression, zstd_parameters.level,
+                         codecs.empty() ? fles::ChunkCodecMap()
+                                        : fles::ChunkCodecMap::parse(
+                                              codecs, zstd_parameters.level),
+                         dictionaries.empty()
+                             ? fles::ZstdDictionaries()
+                             : fles::load_zstd_dictionaries(dictionaries))),
+                 sink_name, queue, overflow, tap);
+      } else if (!codecs.empty() || !dictionaries.empty()) {
+        throw std::runtime_error(
+            "query parameters codecs and dict require chunked output");
+      } else if (items == SIZE_MAX && bytes == SIZE_MAX && manifest.empty()) {
+        add_sink(std::unique_ptr<fles::TimesliceSink>(
+                     new fles::TimesliceOutputArchive(
+                         file_path, compression, index, zstd_parameters,
+                         direct_io, descriptor_encoding)),
+                 sink_name, queue, overflow, tap);
       } else {
-        sinks_.push_back(std::unique_ptr<fles::TimesliceSink>(
-            new fles::TimesliceOutputArchiveSequence(file_path, items, bytes,
-                                                     compression)));
+        add_sink(std::unique_ptr<fles::TimesliceSink>(
+                     new fles::TimesliceOutputArchiveSequence(
+                         file_path, items, bytes, compression, index,
+                         zstd_parameters, direct_io, descriptor_encoding,
+                         manifest)),
+                 sink_name, queue, overflow, tap);
       }
 
     } else if (uri.scheme == "tcp") {
       uint32_t hwm = 1;
+      bool zero_copy = false;
+      std::size_t shards = 1;
+      bool desc_only = false;
       for (auto& [key, value] : uri.query_components) {
         if (key == "hwm") {
           hwm = stou(value);
+        } else if (key == "zerocopy") {
+          zero_copy = stoull(value) != 0;
+        } else if (key == "shards") {
+          shards = stoull(value);
+        } else if (key == "desc_only") {
+          desc_only = stoull(value) != 0;
         } else {
           throw std::runtime_error(
               "query parameter not implemented for scheme " + uri.scheme +
@@ -94,13 +311,44 @@ Application::Application(Parameters const& par,
         }
       }
       const auto address = uri.scheme + "://" + uri.authority;
-      sinks_.push_back(std::unique_ptr<fles::TimesliceSink>(
-          new fles::TimeslicePublisher(address, hwm)));
+      add_sink(std::unique_ptr<fles::TimesliceSink>(
+                   new fles::TimeslicePublisher(address, hwm, zero_copy,
+                                                shards, desc_only)),
+               sink_name, queue, overflow, tap);
+
+    } else if (uri.scheme == "forward") {
+      std::size_t window = 8;
+      bool zero_copy = true;
+      for (auto& [key, value] : uri.query_components) {
+        if (key == "window") {
+          window = stoull(value);
+        } else if (key == "zerocopy") {
+          zero_copy = stoull(value) != 0;
+        } else {
+          throw std::runtime_error(
+              "query parameter not implemented for scheme " + uri.scheme +
+              ": " + key);
+        }
+      }
+      const auto colon = uri.authority.rfind(':');
+      if (colon == std::string::npos) {
+        throw ParametersException("address without port for scheme " +
+                                  uri.scheme + ": " + uri.authority);
+      }
+      add_sink(std::unique_ptr<fles::TimesliceSink>(new TimesliceForwarderTcp(
+                   uri.authority.substr(0, colon),
+                   uri.authority.substr(colon + 1), window, zero_copy)),
+               sink_name, queue, overflow, tap);
 
     } else if (uri.scheme == "shm") {
       uint32_t num_components = 1;
       uint32_t datasize = 27; // 128 MiB
       uint32_t descsize = 19; // 16 MiB
+      MemoryPolicy memory_policy;
+      bool use_shm_item_channel = false;
+      auto work_item_encoding = fles::WorkItemEncoding::Binary;
+      bool persistent = false;
+      unsigned copy_threads = 0;
       for (auto& [key, value] : uri.query_components) {
         if (key == "datasize") {
           datasize = std::stoul(value);
@@ -108,6 +356,25 @@ Application::Application(Parameters const& par,
           descsize = std::stoul(value);
         } else if (key == "n") {
           num_components = std::stoul(value);
+        } else if (key == "hugepages") {
+          memory_policy.huge_pages = parse_huge_pages(value);
+        } else if (key == "numa") {
+          memory_policy.numa_node = std::stoi(value);
+        } else if (key == "persistent") {
+          persistent = std::stoi(value) != 0;
+        } else if (key == "copythreads") {
+          copy_threads = stou(value);
+        } else if (key == "distribution" &&
+                   (value == "shm" || value == "zmq")) {
+          use_shm_item_channel = (value == "shm");
+        } else if (key == "workitem" &&
+                   (value == "binary" || value == "legacy" ||
+                    value == "flat")) {
+          work_item_encoding = (value == "legacy")
+                                   ? fles::WorkItemEncoding::Legacy
+                               : (value == "flat")
+                                   ? fles::WorkItemEncoding::Flat
+                                   : fles::WorkItemEncoding::Binary;
         } else {
           throw std::runtime_error(
               "query parameter not implemented for scheme " + uri.scheme +
@@ -115,9 +382,11 @@ Application::Application(Parameters const& par,
         }
       }
       const auto shm_identifier = split(uri.path, "/").at(0);
-      sinks_.push_back(std::unique_ptr<fles::TimesliceSink>(
-          new ManagedTimesliceBuffer(zmq_context_, shm_identifier, datasize,
-                                     descsize, num_components)));
+      add_sink(std::unique_ptr<fles::TimesliceSink>(new ManagedTimesliceBuffer(
+                   zmq_context_, shm_identifier, datasize, descsize,
+                   num_components, memory_policy, use_shm_item_channel,
+                   work_item_encoding, persistent, copy_threads)),
+               sink_name, queue, overflow, tap);
       has_shm_output = true;
 
     } else {
@@ -125,6 +394,26 @@ Application::Application(Parameters const& par,
     }
   }
 
+  if (forward_input) {
+    ManagedTimesliceBuffer* target = nullptr;
+    if (sinks_.size() == 1) {
+      target = dynamic_cast<ManagedTimesliceBuffer*>(sinks_.front().get());
+    }
+    if (target == nullptr) {
+      throw ParametersException(
+          "input scheme forward requires a single shm output");
+    }
+    UriComponents uri{par_.input_uri()};
+    const auto colon = uri.authority.rfind(':');
+    if (colon == std::string::npos) {
+      throw ParametersException("address without port for scheme forward: " +
+                                uri.authority);
+    }
+    forward_receiver_ = std::make_unique<TimesliceForwardReceiverTcp>(
+        static_cast<uint16_t>(stou(uri.authority.substr(colon + 1))), *target,
+        signal_status_);
+  }
+
   if (has_shm_output) {
     // wait a moment to allow the ManagedTimesliceBuffer clients to connect
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
@@ -135,55 +424,175 @@ Application::Application(Parameters const& par,
   }
 
   if (par_.rate_limit() != 0.0) {
+    rate_scheduler_ = std::make_unique<ReplayScheduler>();
     L_(info) << output_prefix_ << "rate limit active: "
              << human_readable_count(par_.rate_limit(), true, "Hz");
   }
+
+  if (par_.native_speed() != 0.0) {
+    replay_scheduler_ = std::make_unique<ReplayScheduler>(par_.native_speed());
+    L_(info) << output_prefix_ << "replay at " << par_.native_speed()
+             << " times the original speed";
+  }
+
+  hostname_ = fles::system::current_hostname();
 }
 
 Application::~Application() {
   L_(info) << output_prefix_ << "total timeslices processed: " << count_;
+  if (par_.live_stats()) {
+    cbm::LiveStats::Remove();
+  }
+
+  for (const auto& async_sink : async_sinks_) {
+    if (async_sink.dropped > 0) {
+      L_(warning) << output_prefix_ << "sink " << async_sink.name << ": "
+                  << async_sink.dropped
+                  << " timeslices dropped due to queue overflow";
+    }
+  }
+
+  for (const auto* total : {&replay_statistics_, &rate_statistics_}) {
+    if (total->count > 0) {
+      L_(info) << output_prefix_ << "pacing error: mean "
+               << total->mean_error().count() / 1000.0 << " us, max "
+               << total->max_error.count() / 1000.0 << " us, "
+               << total->late_count << " of " << total->count << " late";
+    }
+  }
 
   // delay to allow monitor to process pending messages
   constexpr auto destruct_delay = std::chrono::milliseconds(200);
   std::this_thread::sleep_for(destruct_delay);
 }
 
-void Application::rate_limit_delay() const {
-  auto delta_is = std::chrono::high_resolution_clock::now() - time_begin_;
-  auto delta_want = std::chrono::microseconds(
-      static_cast<uint64_t>(count_ * 1.0e6 / par_.rate_limit()));
+void Application::add_sink(std::unique_ptr<fles::TimesliceSink> sink,
+                           const std::string& name,
+                           size_t queue,
+                           fles::OverflowPolicy overflow,
+                           const fles::TapParameters& tap) {
+  if (queue != 0) {
+    auto async_sink = std::make_unique<fles::AsyncSink<fles::Timeslice>>(
+        std::move(sink), queue, overflow);
+    async_sinks_.push_back({name, async_sink.get(), 0});
+    sink = std::move(async_sink);
+  }
+  if (!tap.all()) {
+    // Discard the unselected timeslices before they are queued
+    sink = std::make_unique<fles::TimesliceTap>(std::move(sink), tap);
+  }
+  sinks_.push_back(std::move(sink));
+}
+
+void Application::add_sink(std::unique_ptr<fles::TimesliceSink> sink,
+                           const std::string& name) {
+  add_sink(std::move(sink), name, par_.sink_queue(),
+           fles::OverflowPolicy::Block, {});
+}
 
-  if (delta_want > delta_is) {
-    std::this_thread::sleep_for(delta_want - delta_is);
+void Application::write_checkpoint(bool force) {
+  const auto interval =
+      std::chrono::duration<double>(par_.checkpoint_interval());
+  auto now = std::chrono::steady_clock::now();
+  if (par_.checkpoint_file().empty() || checkpoint_.count == 0 ||
+      (!force && now - last_checkpoint_ < interval)) {
+    return;
   }
+  last_checkpoint_ = now;
+  // the checkpoint must not be ahead of the output
+  for (const auto& async_sink : async_sinks_) {
+    async_sink.sink->flush();
+  }
+  checkpoint_.write(par_.checkpoint_file());
 }
 
-void Application::native_speed_delay(uint64_t ts_start_time) {
-  if (count_ == 0) {
-    first_ts_start_time_ = ts_start_time;
-  } else {
-    auto delta_is = std::chrono::high_resolution_clock::now() - time_begin_;
-    auto delta_want =
-        std::chrono::nanoseconds(ts_start_time - first_ts_start_time_) /
-        par_.native_speed();
-    if (delta_want > delta_is) {
-      std::this_thread::sleep_for(delta_want - delta_is);
+void Application::report_sinks(bool force) {
+  constexpr auto interval = std::chrono::seconds(1);
+  auto now = std::chrono::steady_clock::now();
+  if (async_sinks_.empty() || (!force && now - last_sink_report_ < interval)) {
+    return;
+  }
+  last_sink_report_ = now;
+  const std::string prefix = output_prefix_.empty() ? ":" : output_prefix_;
+  for (auto& async_sink : async_sinks_) {
+    auto stats = async_sink.sink->statistics();
+    async_sink.sink->reset_statistics();
+    async_sink.dropped += stats.dropped;
+    if (monitor_ != nullptr) {
+      monitor_->QueueMetric("tsclient_sink_status",
+                            {{"host", hostname_},
+                             {"output_prefix", prefix},
+                             {"sink", async_sink.name}},
+                            {{"count", stats.count},
+                             {"dropped", stats.dropped},
+                             {"queue_depth", stats.queue_depth},
+                             {"max_queue_depth", stats.max_queue_depth}});
     }
   }
 }
 
-void Application::run() {
-  time_begin_ = std::chrono::high_resolution_clock::now();
+void Application::report_pacing(bool force) {
+  constexpr auto interval = std::chrono::seconds(1);
+  auto now = std::chrono::steady_clock::now();
+  if (!force && now - last_pacing_report_ < interval) {
+    return;
+  }
+  last_pacing_report_ = now;
+  if (replay_scheduler_) {
+    report_pacing("speed", *replay_scheduler_, replay_statistics_);
+  }
+  if (rate_scheduler_) {
+    report_pacing("rate", *rate_scheduler_, rate_statistics_);
+  }
+}
+
+void Application::report_pacing(const std::string& mode,
+                                ReplayScheduler& scheduler,
+                                ReplayScheduler::Statistics& total) {
+  const auto& stats = scheduler.statistics();
+  if (monitor_ != nullptr && stats.count > 0) {
+    const std::string prefix = output_prefix_.empty() ? ":" : output_prefix_;
+    monitor_->QueueMetric(
+        "tsclient_pacing_status",
+        {{"host", hostname_}, {"output_prefix", prefix}, {"mode", mode}},
+        {{"count", stats.count},
+         {"late_count", stats.late_count},
+         {"error_mean_ns", stats.mean_error().count()},
+         {"error_max_ns", stats.max_error.count()}});
+  }
+  total.add(stats);
+  scheduler.reset_statistics();
+}
 
+void Application::run() {
   if (benchmark_) {
     benchmark_->run();
     return;
   }
 
+  for (const auto& filename : par_.build_index_files()) {
+    auto archive_index =
+        fles::TimesliceIndexedInputArchive::build_index(filename);
+    archive_index.write(fles::ArchiveIndex::sidecar_filename(filename));
+    L_(info) << output_prefix_ << "wrote index of " << archive_index.size()
+             << " timeslices for " << filename;
+  }
+  if (!par_.build_index_files().empty()) {
+    return;
+  }
+
   uint64_t limit = par_.maximum_number();
+  last_pacing_report_ = std::chrono::steady_clock::now();
+  last_sink_report_ = last_pacing_report_;
 
-  uint64_t index = 0;
-  while (auto timeslice = source_->get()) {
+  if (forward_receiver_) {
+    (*forward_receiver_)();
+    count_ = forward_receiver_->count();
+  }
+
+  uint64_t index = checkpoint_.position;
+  last_checkpoint_ = last_pacing_report_;
+  while (auto timeslice = source_ ? source_->get() : nullptr) {
     if (index >= par_.offset() &&
         (index - par_.offset()) % par_.stride() == 0) {
       ++index;
@@ -198,16 +607,28 @@ void Application::run() {
     } else {
       ts = std::shared_ptr<const fles::Timeslice>(std::move(timeslice));
     }
-    if (par_.native_speed() != 0.0) {
-      native_speed_delay(ts->start_time());
+    if (replay_scheduler_) {
+      replay_scheduler_->wait(ts->start_time());
     }
-    if (par_.rate_limit() != 0.0) {
-      rate_limit_delay();
+    if (rate_scheduler_) {
+      rate_scheduler_->wait(
+          static_cast<uint64_t>(static_cast<double>(count_) * 1.0e9 /
+                                par_.rate_limit()));
     }
     for (auto& sink : sinks_) {
       sink->put(ts);
     }
     ++count_;
+    live_count_.Add();
+    live_index_.Set(ts->index());
+    checkpoint_.index = ts->index();
+    checkpoint_.position = index;
+    checkpoint_.count = count_;
+    if (replay_scheduler_ || rate_scheduler_) {
+      report_pacing();
+    }
+    report_sinks();
+    write_checkpoint();
     if (count_ == limit || *signal_status_ != 0) {
       break;
     }
@@ -215,6 +636,15 @@ void Application::run() {
     timeslice.reset();
   }
 
+  report_pacing(true);
+
+  // Wait for the asynchronous sinks to catch up
+  for (const auto& async_sink : async_sinks_) {
+    async_sink.sink->flush();
+  }
+  report_sinks(true);
+  write_checkpoint(true);
+
   // Loop over sinks. For all sinks of type ManagedTimesliceBuffer, check if
   // they are empty. If at least one of them is not empty, wait for 100 ms.
   // Repeat until all sinks are empty.
@@ -224,7 +654,15 @@ void Application::run() {
   while (!all_empty && *signal_status_ == 0) {
     all_empty = true;
     for (auto& sink : sinks_) {
-      auto* mtb = dynamic_cast<ManagedTimesliceBuffer*>(sink.get());
+      auto* target = sink.get();
+      if (auto* tap = dynamic_cast<fles::TimesliceTap*>(target)) {
+        target = &tap->sink();
+      }
+      if (auto* async = dynamic_cast<fles::AsyncSink<fles::Timeslice>*>(
+              target)) {
+        target = &async->sink();
+      }
+      auto* mtb = dynamic_cast<ManagedTimesliceBuffer*>(target);
       if (mtb != nullptr) {
         mtb->handle_timeslice_completions();
         if (!mtb->empty()) {
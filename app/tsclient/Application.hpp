@@ -1,15 +1,22 @@
 // Copyright 2012-2013 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include "AsyncSink.hpp"
 #include "Benchmark.hpp"
+#include "ConsumerCheckpoint.hpp"
+#include "LiveStats.hpp"
 #include "Monitor.hpp"
 #include "Parameters.hpp"
+#include "ReplayScheduler.hpp"
 #include "Sink.hpp"
+#include "TimesliceForwardReceiverTcp.hpp"
 #include "TimesliceSource.hpp"
+#include "TimesliceTap.hpp"
 #include "log.hpp"
 #include <chrono>
 #include <csignal>
 #include <memory>
+#include <string>
 #include <vector>
 #include <zmq.hpp>
 
@@ -37,17 +44,66 @@ private:
 
   std::unique_ptr<fles::TimesliceSource> source_;
   std::vector<std::unique_ptr<fles::TimesliceSink>> sinks_;
+
+  /// Receiver writing forwarded timeslices to the shm output (forward input)
+  std::unique_ptr<TimesliceForwardReceiverTcp> forward_receiver_;
+
+  /// A sink running on its own thread (sink-queue option)
+  struct AsyncSinkInfo {
+    std::string name;
+    fles::AsyncSink<fles::Timeslice>* sink;
+    /// Total number of dropped timeslices, as of the last report
+    uint64_t dropped;
+  };
+  std::vector<AsyncSinkInfo> async_sinks_;
+  std::chrono::steady_clock::time_point last_sink_report_;
+
   std::unique_ptr<Benchmark> benchmark_;
 
   uint64_t count_ = 0;
 
+  /// Live statistics of the processed timeslices (live-stats option)
+  cbm::LiveCounter live_count_;
+  cbm::LiveCounter live_index_;
+
+  /// Position in the input, as of the last processed timeslice
+  ConsumerCheckpoint checkpoint_;
+  std::chrono::steady_clock::time_point last_checkpoint_;
+
   logging::OstreamLog status_log_{status};
   logging::OstreamLog debug_log_{debug};
   std::string output_prefix_;
 
-  std::chrono::high_resolution_clock::time_point time_begin_;
-  uint64_t first_ts_start_time_{};
+  /// Pacing according to the timeslice start times (speed option)
+  std::unique_ptr<ReplayScheduler> replay_scheduler_;
+  /// Pacing to a fixed item rate (rate-limit option)
+  std::unique_ptr<ReplayScheduler> rate_scheduler_;
+
+  ReplayScheduler::Statistics replay_statistics_;
+  ReplayScheduler::Statistics rate_statistics_;
+  std::chrono::steady_clock::time_point last_pacing_report_;
+  std::string hostname_;
+
+  /// Add a sink, running it on its own thread if queue is not zero and
+  /// passing it only the timeslices selected by the tap parameters.
+  void add_sink(std::unique_ptr<fles::TimesliceSink> sink,
+                const std::string& name,
+                size_t queue,
+                fles::OverflowPolicy overflow,
+                const fles::TapParameters& tap);
+  /// Add a sink using the default queue parameters.
+  void add_sink(std::unique_ptr<fles::TimesliceSink> sink,
+                const std::string& name);
+
+  /// Write the checkpoint file after the asynchronous sinks have caught up.
+  void write_checkpoint(bool force = false);
+
+  /// Report the queue statistics of the asynchronous sinks to the monitor.
+  void report_sinks(bool force = false);
 
-  void rate_limit_delay() const;
-  void native_speed_delay(uint64_t ts_start_time);
+  /// Report the pacing error of the current interval to the monitor.
+  void report_pacing(bool force = false);
+  void report_pacing(const std::string& mode,
+                     ReplayScheduler& scheduler,
+                     ReplayScheduler::Statistics& total);
 };
@@ -2,6 +2,7 @@
 
 #include "Parameters.hpp"
 #include "GitRevision.hpp"
+#include "ResourceControl.hpp"
 #include "System.hpp"
 #include "log.hpp"
 #include <boost/program_options.hpp>
@@ -13,6 +14,7 @@ void Parameters::parse_options(int argc, char* argv[]) {
   unsigned log_level = 2;
   unsigned log_syslog = 2;
   std::string log_file;
+  std::string resctrl_schemata;
 
   auto terminal_width = fles::system::current_terminal_width();
   po::options_description desc("Allowed options", terminal_width,
@@ -39,39 +41,156 @@ void Parameters::parse_options(int argc, char* argv[]) {
   desc_add("analyze-pattern,a",
            po::value<bool>(&analyze_)->implicit_value(true),
            "enable/disable pattern check");
+  desc_add("analyze-threads",
+           po::value<unsigned>(&analyze_threads_)->value_name("N"),
+           "number of threads for the pattern check (0: check in the calling "
+           "thread)");
+  desc_add("analyze-gpu",
+           po::value<int>(&analyze_gpu_)->implicit_value(0)->value_name("N"),
+           "check the CRCs, test patterns and microslice sizes of batches of "
+           "timeslices on GPU device N, concurrently with the other outputs "
+           "(-1: check the batches on the host)");
+  desc_add("analyze-gpu-batch",
+           po::value<size_t>(&analyze_gpu_batch_)->value_name("N"),
+           "number of timeslices per batch of analyze-gpu (default: 16)");
+  desc_add("learn-profile",
+           po::value<std::string>(&learn_profile_)->value_name("FILENAME"),
+           "learn the microslice size distributions and spill structure of "
+           "the components and write them as a load profile for the "
+           "'profile' input of flesnet");
   desc_add("monitor,m",
            po::value<std::string>(&monitor_uri_)
                ->value_name("URI")
                ->implicit_value("influx1:login:8086:tsclient_status"),
            "publish tsclient status to InfluxDB (or \"file:cout\" for "
            "console output)");
+  desc_add("allocation-stats",
+           po::value<bool>(&allocation_stats_)->implicit_value(true),
+           "publish the live bytes, allocation rate and peak of the "
+           "timeslice and microslice objects with the status");
+  desc_add("thread-stats",
+           po::value<bool>(&thread_stats_)->implicit_value(true),
+           "publish the CPU utilization, run queue wait and context switch "
+           "rates of the named threads with the status");
+  desc_add("live-stats", po::value<bool>(&live_stats_)->implicit_value(true),
+           "publish live counters and microslice size histograms in a "
+           "shared memory segment for external tools (see fles_stats)");
+  desc_add("resctrl-group",
+           po::value<std::string>(&resctrl_group_)->value_name("NAME"),
+           "run in this Linux resctrl group (created if needed) to confine "
+           "the last-level cache and memory bandwidth use of the analysis");
+  desc_add("resctrl-schemata",
+           po::value<std::string>(&resctrl_schemata)->value_name("LINES"),
+           "cache and memory bandwidth allocation of the resctrl group, "
+           "comma-separated schemata lines (e.g., "
+           "L3:0=00f;1=00f,MB:0=30;1=30)");
   desc_add("benchmark,b", po::value<bool>(&benchmark_)->implicit_value(true),
            "run benchmark test only");
+  desc_add("build-index",
+           po::value<std::vector<std::string>>()->multitoken()->value_name(
+               "FILE ..."),
+           "write random-access index sidecar files for the given existing "
+           "archive files and exit");
   desc_add("verbose,v", po::value<size_t>(&verbosity_), "set output verbosity");
+  desc_add("dump-every", po::value<uint64_t>(&dump_every_)->value_name("N"),
+           "dump only every Nth timeslice at verbosity > 0; sampled dumps "
+           "are formatted in the background");
+  desc_add("dump-rate", po::value<double>(&dump_rate_)->value_name("X"),
+           "dump at most X timeslices per second (default: 0 = no limit)");
+  desc_add("dump-bytes", po::value<uint64_t>(&dump_bytes_)->value_name("N"),
+           "limit the dump output to N bytes per second (default: 0 = no "
+           "limit)");
   desc_add("histograms", po::value<bool>(&histograms_)->implicit_value(true),
            "enable microslice histogram data output");
   desc_add("input-uri,i",
            po::value<std::string>(&input_uri_)->value_name("URI"),
-           "uri of a timeslice source");
+           "uri of a timeslice source; 'forward://*:<port>' receives the "
+           "timeslices of a 'forward' output straight into the single "
+           "'shm' output");
   desc_add("output-uri,o",
            po::value<std::vector<std::string>>()->multitoken()->value_name(
                "scheme://host/path?param=value ..."),
            "specify an output. The URI scheme determines the type of output, "
            "which can be one of: 'file' (write to an output file archive), "
            "'shm' (write to a flesnet shared memory segment managed by this "
-           "process), 'tcp' (enable timeslice publisher on given address).\n"
+           "process), 'tcp' (enable timeslice publisher on given address), "
+           "'forward' (send to a tsclient receiving with a 'forward' input "
+           "at the given address).\n"
            "Supported parameters for 'file': "
            "'items' (limit number of timeslices per file to given number, "
            "create sequence of output archive files; use placeholder %n in "
            "filename), 'bytes' (limit number of bytes per file to given "
            "number, create sequence of output archive files; use placeholder "
-           "%n in filename). Example: 'file:///tmp/output%n.tsa?items=100'.\n"
+           "%n in filename), 'c' (compression, 'none' or 'zstd'), 'level' "
+           "(zstd compression level; default: 1), 'threads' (number of zstd "
+           "compression threads writing independent frames; default: 0, "
+           "compress in the calling thread), 'index' (write a random-access "
+           "index sidecar file <filename>.idx if set to 1, uncompressed "
+           "output only), 'chunked' (write a chunked archive storing each "
+           "component separately if set to 1, for selective reading), "
+           "'native' (write the native archive format, storing the raw "
+           "component data with frame checksums without boost "
+           "serialization, if set to 1; uncompressed output only), "
+           "'overlap_refs' (store the overlap microslices shared by "
+           "consecutive timeslices once in a native archive if set to 1), "
+           "'codecs' (content-aware compression of the chunks of a chunked "
+           "archive, 'auto' for the built-in selection by subsystem or a "
+           "list like 'sts:shuffle4,tof:delta8,*:zstd'; codecs are "
+           "'stored', 'zstd', 'shuffle<n>' and 'delta<n>' for words of n "
+           "bytes), 'dict' (directory of trained zstd dictionaries, see "
+           "tsconvert --train-dictionaries, compressing the chunks of the "
+           "respective subsystem format versions of a chunked archive), "
+           "'manifest' (run manifest file to append an entry to for each "
+           "completed archive file, see TimesliceAutoSource; may be shared "
+           "by all writers of a run), "
+           "'direct' (write with O_DIRECT through aligned staging buffers "
+           "if set to 1, bypassing the page cache), 'depth' (number of "
+           "direct writes in flight; default: 2), 'fsync' (durability of "
+           "direct output, 'none', 'close' to sync each file when it is "
+           "closed, or 'always' to complete each write on stable storage; "
+           "default: 'none'), 'descriptors' (microslice descriptor "
+           "encoding, 'verbatim' or 'compact' for a delta and run-length "
+           "encoding, which cannot be memory-mapped; default: 'verbatim'). "
+           "Example: 'file:///tmp/output%n.tsa?items=100'.\n"
            "Supported parameters for 'shm': "
-           "'n' (number of components), 'datasize', 'descsize'. Example: "
+           "'n' (number of components), 'datasize', 'descsize', 'hugepages' "
+           "('none' or 'thp' for transparent huge pages), 'numa' (bind the "
+           "buffers to the given NUMA node), 'distribution' ('zmq' or 'shm' "
+           "to pass work items through shared memory queues; default: "
+           "'zmq'), 'workitem' ('binary', 'legacy' for receivers of older "
+           "versions, or 'flat' for the offset-based segment layout readable "
+           "without Boost.Interprocess; default: 'binary'), 'persistent' "
+           "(keep the pre-faulted segment for a restarted tsclient to "
+           "re-attach to if set to 1; requires the 'binary' or 'legacy' "
+           "work item encoding), 'copythreads' (number of additional "
+           "threads copying large timeslices into the buffer concurrently; "
+           "default: 0). Example: "
            "'shm://127.0.0.1/tsclient_0?n=10&datasize=27&descsize=19'.\n"
            "Supported parameters for 'tcp': "
            "'hwm' (high-water mark for the publisher, in TS, TS drop happens "
-           "if more buffered; default: 1). Example: 'tcp://*:5556?hwm=2'.");
+           "if more buffered; default: 1), 'zerocopy' (send the component "
+           "data without serialization and copy if set to 1), 'shards' "
+           "(publish on the given number of consecutive ports, sending each "
+           "TS on port + index modulo shards; default: 1), 'desc_only' "
+           "(send the microslice descriptors only, omitting the contents, "
+           "if set to 1). Example: 'tcp://*:5556?hwm=2'.\n"
+           "Supported parameters for 'forward': "
+           "'window' (number of TS in flight, each kept in the local buffer "
+           "until the receiver has stored it; default: 8), 'zerocopy' (send "
+           "the component data with MSG_ZEROCOPY where supported if set to "
+           "1; default: 1). Example: 'forward://node2:5560?window=4'.\n"
+           "Supported parameters for all schemes: 'queue' (number of "
+           "timeslices to queue for the output, overriding sink-queue), "
+           "'overflow' (behavior if the queue is full: 'block' to wait, "
+           "'drop' to discard the new timeslice, 'sample' to discard the "
+           "oldest queued timeslice; default: 'block'), 'stride' and "
+           "'offset' (pass only every TS with index = m * stride + offset), "
+           "'rate' (pass at most the given number of TS per second), "
+           "'sys_id' and 'eq_id' (pass only the components with the given "
+           "comma-separated identifiers, without copying them). Unselected "
+           "TS are discarded before queueing and serialization. Example: "
+           "'tcp://*:5556?queue=2&overflow=sample', "
+           "'tcp://*:5557?rate=1&sys_id=0x10'.");
   desc_add("maximum-number,n",
            po::value<uint64_t>(&maximum_number_)->value_name("N"),
            "set the maximum number of timeslices to process (default: "
@@ -85,7 +204,25 @@ void Parameters::parse_options(int argc, char* argv[]) {
   desc_add("rate-limit", po::value<double>(&rate_limit_)->value_name("X"),
            "limit the item rate to given frequency (in Hz)");
   desc_add("speed", po::value<double>(&native_speed_)->value_name("X"),
-           "limit the item rate to given factor of original speed");
+           "replay the items at given factor of their original speed, "
+           "according to the timeslice start times (> 1: compress time)");
+  desc_add("prefetch", po::value<size_t>(&prefetch_)->value_name("N"),
+           "read up to N timeslices ahead on a background thread (default: "
+           "4 if rate-limit or speed is set, 0 otherwise)");
+  desc_add("sink-queue", po::value<size_t>(&sink_queue_)->value_name("N"),
+           "run each output on its own thread, queueing up to N timeslices "
+           "for it (default: 8; 0: run all outputs in the main thread)");
+  desc_add("checkpoint",
+           po::value<std::string>(&checkpoint_file_)->value_name("FILENAME"),
+           "periodically write the position in the input (archive files "
+           "only) to the given state file");
+  desc_add("checkpoint-interval",
+           po::value<double>(&checkpoint_interval_)->value_name("S"),
+           "interval (in s) between checkpoints (default: 10)");
+  desc_add("resume", po::value<bool>(&resume_)->implicit_value(true),
+           "continue after the timeslice recorded in the checkpoint file, "
+           "seeking to it through the index sidecar files; start from the "
+           "beginning if there is no checkpoint file yet");
   desc_add("release-mode,R",
            po::value<bool>(&release_mode_)->implicit_value(true),
            "copy and release each timeslice immediately after receiving it");
@@ -120,14 +257,55 @@ void Parameters::parse_options(int argc, char* argv[]) {
     output_uris_ = vm["output-uri"].as<std::vector<std::string>>();
   }
 
+  if (vm.count("build-index") != 0u) {
+    build_index_files_ = vm["build-index"].as<std::vector<std::string>>();
+  }
+
+  try {
+    resctrl_schemata_ = parse_resctrl_schemata(resctrl_schemata);
+  } catch (const std::invalid_argument& e) {
+    throw ParametersException(e.what());
+  }
+  if (resctrl_group_.empty() && !resctrl_schemata_.empty()) {
+    throw ParametersException("resctrl schemata given without group name");
+  }
+
   size_t input_sources = vm.count("input-uri");
-  if (input_sources == 0 && !benchmark_) {
+  if (input_sources == 0 && !benchmark_ && build_index_files_.empty()) {
     throw ParametersException("no input source specified");
   }
   if (input_sources > 1) {
     throw ParametersException("more than one input source specified");
   }
+  analyze_gpu_enabled_ = vm.count("analyze-gpu") != 0u;
+  if (analyze_gpu_enabled_ && analyze_gpu_ < -1) {
+    throw ParametersException("invalid analyze-gpu device: " +
+                              std::to_string(analyze_gpu_));
+  }
+  if (analyze_gpu_batch_ == 0) {
+    throw ParametersException("analyze-gpu-batch must be greater than zero");
+  }
   if (stride_ == 0) {
     throw ParametersException("stride must be greater than zero");
   }
+  if (dump_every_ == 0) {
+    throw ParametersException("dump-every must be greater than zero");
+  }
+  if (dump_rate_ < 0.0) {
+    throw ParametersException("dump-rate must not be negative");
+  }
+  if (rate_limit_ < 0.0 || native_speed_ < 0.0) {
+    throw ParametersException("rate-limit and speed must not be negative");
+  }
+  if (resume_ && checkpoint_file_.empty()) {
+    throw ParametersException("resume requires a checkpoint file");
+  }
+  if (checkpoint_interval_ <= 0.0) {
+    throw ParametersException("checkpoint-interval must be positive");
+  }
+  if (vm.count("prefetch") == 0 &&
+      (rate_limit_ != 0.0 || native_speed_ != 0.0)) {
+    // keep reading from proceeding while waiting for the release time
+    prefetch_ = 4;
+  }
 }
@@ -23,6 +23,20 @@ public:
 
   [[nodiscard]] std::string monitor_uri() const { return monitor_uri_; }
 
+  [[nodiscard]] bool allocation_stats() const { return allocation_stats_; }
+
+  [[nodiscard]] bool thread_stats() const { return thread_stats_; }
+
+  [[nodiscard]] bool live_stats() const { return live_stats_; }
+
+  [[nodiscard]] const std::string& resctrl_group() const {
+    return resctrl_group_;
+  }
+
+  [[nodiscard]] const std::vector<std::string>& resctrl_schemata() const {
+    return resctrl_schemata_;
+  }
+
   [[nodiscard]] int32_t client_index() const { return client_index_; }
 
   [[nodiscard]] std::string input_uri() const { return input_uri_; }
@@ -33,10 +47,30 @@ public:
 
   [[nodiscard]] bool analyze() const { return analyze_; }
 
+  [[nodiscard]] unsigned analyze_threads() const { return analyze_threads_; }
+
+  [[nodiscard]] bool analyze_gpu() const { return analyze_gpu_enabled_; }
+
+  [[nodiscard]] int analyze_gpu_device() const { return analyze_gpu_; }
+
+  [[nodiscard]] size_t analyze_gpu_batch() const { return analyze_gpu_batch_; }
+
+  [[nodiscard]] std::string learn_profile() const { return learn_profile_; }
+
   [[nodiscard]] bool benchmark() const { return benchmark_; }
 
+  [[nodiscard]] std::vector<std::string> build_index_files() const {
+    return build_index_files_;
+  }
+
   [[nodiscard]] size_t verbosity() const { return verbosity_; }
 
+  [[nodiscard]] uint64_t dump_every() const { return dump_every_; }
+
+  [[nodiscard]] double dump_rate() const { return dump_rate_; }
+
+  [[nodiscard]] uint64_t dump_bytes() const { return dump_bytes_; }
+
   [[nodiscard]] bool histograms() const { return histograms_; }
 
   [[nodiscard]] uint64_t maximum_number() const { return maximum_number_; }
@@ -49,24 +83,57 @@ public:
 
   [[nodiscard]] double native_speed() const { return native_speed_; }
 
+  [[nodiscard]] size_t prefetch() const { return prefetch_; }
+
+  [[nodiscard]] size_t sink_queue() const { return sink_queue_; }
+
   [[nodiscard]] bool release_mode() const { return release_mode_; }
 
+  [[nodiscard]] std::string checkpoint_file() const {
+    return checkpoint_file_;
+  }
+
+  [[nodiscard]] double checkpoint_interval() const {
+    return checkpoint_interval_;
+  }
+
+  [[nodiscard]] bool resume() const { return resume_; }
+
 private:
   void parse_options(int argc, char* argv[]);
 
   std::string monitor_uri_;
+  bool allocation_stats_ = false;
+  bool thread_stats_ = false;
+  bool live_stats_ = false;
+  std::string resctrl_group_;
+  std::vector<std::string> resctrl_schemata_;
 
   int32_t client_index_ = -1;
   std::string input_uri_;
   std::vector<std::string> output_uris_;
   bool analyze_ = false;
+  unsigned analyze_threads_ = 0;
+  bool analyze_gpu_enabled_ = false;
+  int analyze_gpu_ = 0;
+  size_t analyze_gpu_batch_ = 16;
+  std::string learn_profile_;
   bool benchmark_ = false;
+  std::vector<std::string> build_index_files_;
   size_t verbosity_ = 0;
+  uint64_t dump_every_ = 1;
+  double dump_rate_ = 0.0;
+  uint64_t dump_bytes_ = 0;
   bool histograms_ = false;
   uint64_t maximum_number_ = UINT64_MAX;
   uint64_t offset_ = 0;
   uint64_t stride_ = 1;
   double rate_limit_ = 0.0;
   double native_speed_ = 0.0;
+  size_t prefetch_ = 0;
+  size_t sink_queue_ = 8;
   bool release_mode_ = false;
+  std::string checkpoint_file_;
+  double checkpoint_interval_ = 10.0;
+  bool resume_ = false;
 };
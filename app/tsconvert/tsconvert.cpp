@@ -0,0 +1,175 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+//
+// Re-chunk, filter, and recompress uncompressed timeslice archive files (see
+// TimesliceArchiveConverter.hpp). Unchanged timeslices are copied verbatim.
+// Alternatively, train zstd dictionaries for chunked archives on samples of
+// the input archive files (see ZstdDictionary.hpp).
+
+#include "TimesliceArchiveConverter.hpp"
+#include "TimesliceAutoSource.hpp"
+#include "ZstdDictionary.hpp"
+#include <algorithm>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace po = boost::program_options;
+
+namespace {
+
+void train_dictionaries(const std::vector<std::string>& inputs,
+                        const std::string& directory,
+                        std::size_t dictionary_size) {
+  fles::ZstdDictionaryTrainer trainer(dictionary_size);
+  uint64_t timeslices = 0;
+  for (const auto& input : inputs) {
+    fles::TimesliceAutoSource source(input);
+    while (!trainer.saturated()) {
+      auto ts = source.get();
+      if (!ts) {
+        break;
+      }
+      trainer.add(*ts);
+      ++timeslices;
+    }
+  }
+  const auto dictionaries = trainer.train();
+  fles::save_zstd_dictionaries(directory, dictionaries);
+  std::cout << "trained " << dictionaries.size() << " dictionaries on "
+            << timeslices << " timeslices" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  std::vector<std::string> inputs;
+  std::string output;
+  std::vector<std::string> selection;
+  std::string compression = "none";
+  std::string encoding;
+  std::string dictionary_directory;
+  std::size_t dictionary_size = 112640;
+  fles::ArchiveConversion conversion;
+  conversion.threads = std::max(std::thread::hardware_concurrency(), 1U);
+
+  po::options_description desc("Allowed options");
+  auto desc_add = desc.add_options();
+  desc_add("help,h", "produce help message");
+  desc_add("input,i",
+           po::value<std::vector<std::string>>(&inputs)->multitoken(),
+           "input archive files (uncompressed)");
+  desc_add("output,o", po::value<std::string>(&output),
+           "output archive file name (template), \"%n\" is replaced by the "
+           "file number");
+  desc_add("timeslices-per-file,n",
+           po::value<std::size_t>(&conversion.items_per_file),
+           "number of timeslices per output file (0: as in the input)");
+  desc_add("first", po::value<uint64_t>(&conversion.first),
+           "lowest timeslice index to keep");
+  desc_add("last", po::value<uint64_t>(&conversion.last),
+           "highest timeslice index to keep");
+  desc_add("select,s",
+           po::value<std::vector<std::string>>(&selection)->multitoken(),
+           "component selection, e.g., \"sys_id=0x10,0x60\" (keys: sys_id, "
+           "eq_id, flags_set, flags_clear)");
+  desc_add("compression,c", po::value<std::string>(&compression),
+           "output compression (none, zstd)");
+  desc_add("zstd-level",
+           po::value<int>(&conversion.zstd_parameters.level)->default_value(1),
+           "zstd compression level");
+  desc_add("zstd-threads",
+           po::value<unsigned>(&conversion.zstd_parameters.threads)
+               ->default_value(0),
+           "zstd worker threads per output file");
+  desc_add("descriptor-encoding", po::value<std::string>(&encoding),
+           "microslice descriptor encoding (verbatim, compact; default: as "
+           "in the input)");
+  desc_add("no-index", "do not write index sidecar files");
+  desc_add("threads,j", po::value<std::size_t>(&conversion.threads),
+           "number of output files written concurrently");
+  desc_add("train-dictionaries", po::value<std::string>(&dictionary_directory),
+           "instead of converting, train a zstd dictionary per subsystem "
+           "format version on the inputs and write them to the given "
+           "directory (for the chunked archive output of tsclient)");
+  desc_add("dictionary-size",
+           po::value<std::size_t>(&dictionary_size)
+               ->default_value(dictionary_size),
+           "maximum size of each trained dictionary in bytes");
+
+  po::positional_options_description positional;
+  positional.add("input", -1);
+
+  try {
+    po::variables_map vm;
+    po::store(po::command_line_parser(argc, argv)
+                  .options(desc)
+                  .positional(positional)
+                  .run(),
+              vm);
+    if (vm.count("help") != 0u) {
+      std::cout << "Usage: " << argv[0]
+                << " [options] -o <output> <input>...\n"
+                << "       " << argv[0]
+                << " --train-dictionaries <directory> <input>...\n"
+                << desc << std::endl;
+      return EXIT_SUCCESS;
+    }
+    po::notify(vm);
+
+    if (inputs.empty()) {
+      throw std::runtime_error("no input archive files given");
+    }
+    if (!dictionary_directory.empty()) {
+      train_dictionaries(inputs, dictionary_directory, dictionary_size);
+      return EXIT_SUCCESS;
+    }
+    if (output.empty()) {
+      throw std::runtime_error("no output archive file given");
+    }
+    for (const auto& s : selection) {
+      const auto eq = s.find('=');
+      if (eq == std::string::npos ||
+          !fles::parse_filter_parameter(s.substr(0, eq), s.substr(eq + 1),
+                                        conversion.filter)) {
+        throw std::runtime_error("invalid component selection: " + s);
+      }
+    }
+    if (compression == "zstd") {
+      conversion.compression = fles::ArchiveCompression::Zstd;
+    } else if (compression != "none") {
+      throw std::runtime_error("invalid compression: " + compression);
+    }
+    if (encoding == "verbatim") {
+      conversion.descriptor_encoding = fles::DescriptorEncoding::Verbatim;
+    } else if (encoding == "compact") {
+      conversion.descriptor_encoding = fles::DescriptorEncoding::Compact;
+    } else if (!encoding.empty()) {
+      throw std::runtime_error("invalid descriptor encoding: " + encoding);
+    }
+    conversion.write_index = vm.count("no-index") == 0u;
+
+    const auto start = std::chrono::steady_clock::now();
+    fles::TimesliceArchiveConverter converter(inputs, output, conversion);
+    const auto statistics = converter.run();
+    const std::chrono::duration<double> seconds =
+        std::chrono::steady_clock::now() - start;
+
+    std::cout << "wrote " << statistics.files << " files: "
+              << statistics.copied << " timeslices copied ("
+              << statistics.copied_bytes << " bytes), "
+              << statistics.transformed << " timeslices transformed in "
+              << seconds.count() << " s" << std::endl;
+  } catch (std::exception& e) {
+    std::cerr << "tsconvert: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "PatternData.hpp"
+#include <stdexcept>
+
+namespace {
+
+// 2's exponent of a buffer size that holds at least n entries
+std::size_t size_exponent(uint64_t n) {
+  std::size_t exp = 0;
+  while ((UINT64_C(1) << exp) < n) {
+    ++exp;
+  }
+  return exp;
+}
+
+// microslices per component: 100 core microslices and one of overlap
+constexpr uint32_t microslices_per_component = 101;
+
+} // namespace
+
+PatternData::PatternData(const TimesliceShape& shape) : shape_(shape) {
+  // the randomized sizes vary by a few sigma, rounded up generously, so the
+  // buffers are never full before the requested microslices are generated
+  const uint64_t max_bytes =
+      UINT64_C(2) * shape.microslices * (shape.microslice_size + 64);
+  for (uint32_t c = 0; c < shape.components; ++c) {
+    auto source = std::make_unique<FlesnetPatternGenerator>(
+        size_exponent(max_bytes), size_exponent(2 * shape.microslices), c,
+        shape.microslice_size, true, true);
+    source->proceed();
+    if (source->get_write_index().desc < shape.microslices) {
+      throw std::runtime_error("pattern generator buffer too small");
+    }
+    for (uint32_t m = 0; m < shape.microslices; ++m) {
+      timeslice_bytes_ += source->desc_buffer().at(m).size;
+    }
+    sources_.push_back(std::move(source));
+  }
+}
+
+fles::StorableTimeslice PatternData::timeslice(uint64_t index) const {
+  fles::StorableTimeslice ts{shape_.microslices - 1, index};
+  for (uint32_t c = 0; c < shape_.components; ++c) {
+    ts.append_component(shape_.microslices);
+    for (uint32_t m = 0; m < shape_.microslices; ++m) {
+      ts.append_microslice(c, m, descriptor(c, m), content(c, m));
+    }
+  }
+  return ts;
+}
+
+void timeslice_shapes(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"components", "ms_size"});
+  b->Args({4, 1024});
+  b->Args({16, 4096});
+  b->Args({4, 65536});
+}
+
+TimesliceShape timeslice_shape(const benchmark::State& state) {
+  return {static_cast<uint32_t>(state.range(0)), microslices_per_component,
+          static_cast<uint32_t>(state.range(1))};
+}
@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the PatternData class used by the microbenchmarks.
+#pragma once
+
+#include "FlesnetPatternGenerator.hpp"
+#include "MicrosliceDescriptor.hpp"
+#include "StorableTimeslice.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/// Shape of the generated timeslices.
+struct TimesliceShape {
+  uint32_t components;      ///< number of components
+  uint32_t microslices;     ///< microslices per component (incl. overlap)
+  uint32_t microslice_size; ///< mean microslice content size in bytes
+};
+
+/**
+ * \brief Microslice data of several components, generated by one
+ * FlesnetPatternGenerator per component.
+ *
+ * The content sizes are randomized around the mean, as in flesnet runs
+ * with the 'var' pattern generator parameter.
+ */
+class PatternData {
+public:
+  explicit PatternData(const TimesliceShape& shape);
+
+  /// Retrieve the shape given at construction.
+  [[nodiscard]] const TimesliceShape& shape() const { return shape_; }
+
+  /// Retrieve the descriptor of a microslice.
+  [[nodiscard]] const fles::MicrosliceDescriptor&
+  descriptor(uint32_t component, uint32_t microslice) const {
+    return sources_[component]->desc_buffer().at(microslice);
+  }
+
+  /// Retrieve the content of a microslice.
+  [[nodiscard]] const uint8_t* content(uint32_t component,
+                                       uint32_t microslice) const {
+    return &sources_[component]->data_buffer().at(
+        descriptor(component, microslice).offset);
+  }
+
+  /// Build a timeslice from the generated microslices.
+  [[nodiscard]] fles::StorableTimeslice timeslice(uint64_t index = 0) const;
+
+  /// Retrieve the total content size of a timeslice.
+  [[nodiscard]] uint64_t timeslice_bytes() const { return timeslice_bytes_; }
+
+private:
+  TimesliceShape shape_;
+  std::vector<std::unique_ptr<FlesnetPatternGenerator>> sources_;
+  uint64_t timeslice_bytes_ = 0;
+};
+
+/// Register the typical timeslice shapes (components, microslice size) as
+/// benchmark arguments.
+void timeslice_shapes(benchmark::internal::Benchmark* b);
+
+/// Retrieve the timeslice shape selected by the benchmark arguments.
+TimesliceShape timeslice_shape(const benchmark::State& state);
@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Benchmarks of the component chunk codecs on the reference archives.
+
+#include "ByteShuffle.hpp"
+#include "ChunkCodec.hpp"
+#include "MicrosliceDescriptor.hpp"
+#include "StorableTimeslice.hpp"
+#include "TimesliceInputArchive.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+const std::vector<std::string> codec_names{"stored",   "zstd",   "shuffle4",
+                                           "shuffle8", "delta4", "delta8"};
+
+/// Component chunk (descriptors followed by contents) of an archive.
+struct Chunk {
+  std::vector<uint8_t> data;
+  std::size_t descriptor_bytes;
+  uint8_t sys_id;
+  uint8_t sys_ver;
+};
+
+// All components of the timeslices of test/reference/example1.tsa
+const std::vector<Chunk>& reference_chunks() {
+  static const std::vector<Chunk> chunks = [] {
+    std::vector<Chunk> v;
+    fles::TimesliceInputArchive archive(FLESNET_REFERENCE_DIR
+                                        "/example1.tsa");
+    while (auto ts = archive.get()) {
+      for (uint64_t c = 0; c < ts->num_components(); ++c) {
+        if (ts->num_microslices(c) == 0) {
+          continue;
+        }
+        const auto& md = ts->descriptor(c, 0);
+        const auto* begin = reinterpret_cast<const uint8_t*>(&md);
+        v.push_back({{begin, begin + ts->size_component(c)},
+                     ts->num_microslices(c) *
+                         sizeof(fles::MicrosliceDescriptor),
+                     md.sys_id,
+                     md.sys_ver});
+      }
+    }
+    return v;
+  }();
+  return chunks;
+}
+
+int64_t total_bytes(const std::vector<Chunk>& chunks) {
+  int64_t bytes = 0;
+  for (const auto& chunk : chunks) {
+    bytes += static_cast<int64_t>(chunk.data.size());
+  }
+  return bytes;
+}
+
+// Encode with a single codec, or (argument -1) with the content-aware
+// selection by subsystem
+void BM_ChunkCodec_Encode(benchmark::State& state) {
+  const auto& chunks = reference_chunks();
+  const std::string name =
+      state.range(0) < 0
+          ? "auto"
+          : "*:" + codec_names.at(static_cast<std::size_t>(state.range(0)));
+  const auto map = fles::ChunkCodecMap::parse(name);
+  state.SetLabel(name);
+  std::size_t encoded_bytes = 0;
+  for (auto _ : state) {
+    encoded_bytes = 0;
+    for (const auto& chunk : chunks) {
+      const auto* codec = map.find(chunk.sys_id, chunk.sys_ver);
+      encoded_bytes +=
+          codec->encode(chunk.data.data(), chunk.data.size(),
+                        chunk.descriptor_bytes)
+              .size();
+    }
+  }
+  const int64_t bytes = total_bytes(chunks);
+  state.SetBytesProcessed(state.iterations() * bytes);
+  state.counters["ratio"] =
+      static_cast<double>(bytes) / static_cast<double>(encoded_bytes);
+}
+BENCHMARK(BM_ChunkCodec_Encode)->DenseRange(-1, 5);
+
+void BM_ChunkCodec_Decode(benchmark::State& state) {
+  const auto& chunks = reference_chunks();
+  const auto& name = codec_names.at(static_cast<std::size_t>(state.range(0)));
+  const auto codec = fles::make_chunk_codec(name);
+  state.SetLabel(name);
+  std::vector<std::string> encoded;
+  for (const auto& chunk : chunks) {
+    encoded.push_back(codec->encode(chunk.data.data(), chunk.data.size(),
+                                    chunk.descriptor_bytes));
+  }
+  std::vector<uint8_t> data;
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < chunks.size(); ++i) {
+      data.resize(chunks[i].data.size());
+      codec->decode(reinterpret_cast<const uint8_t*>(encoded[i].data()),
+                    encoded[i].size(), data.data(), data.size(),
+                    chunks[i].descriptor_bytes);
+      benchmark::ClobberMemory();
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * total_bytes(chunks));
+}
+BENCHMARK(BM_ChunkCodec_Decode)->DenseRange(0, 5);
+
+// The shuffle transform alone, for the vectorized (4, 8) and generic widths
+void BM_ByteShuffle(benchmark::State& state) {
+  const auto width = static_cast<std::size_t>(state.range(0));
+  const std::size_t size = std::size_t{1} << 20;
+  std::vector<uint8_t> src(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    src[i] = static_cast<uint8_t>(i * 7);
+  }
+  std::vector<uint8_t> dst(size);
+  for (auto _ : state) {
+    fles::byte_shuffle(src.data(), dst.data(), size, width);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+}
+BENCHMARK(BM_ByteShuffle)->Arg(2)->Arg(4)->Arg(8)->Arg(32);
+
+} // namespace
@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Benchmark of merging timeslice streams from several sources.
+
+#include "MergingSource.hpp"
+#include "PatternData.hpp"
+#include "StorableTimeslice.hpp"
+#include "TimesliceSource.hpp"
+#include <benchmark/benchmark.h>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace {
+
+/// Timeslice source returning a prepared list of timeslices.
+class MemorySource : public fles::TimesliceSource {
+public:
+  explicit MemorySource(std::deque<fles::StorableTimeslice> timeslices)
+      : timeslices_(std::move(timeslices)) {}
+
+  [[nodiscard]] bool eos() const override { return timeslices_.empty(); }
+
+private:
+  std::deque<fles::StorableTimeslice> timeslices_;
+
+  fles::Timeslice* do_get() override {
+    if (timeslices_.empty()) {
+      return nullptr;
+    }
+    auto* ts = new fles::StorableTimeslice(std::move(timeslices_.front()));
+    timeslices_.pop_front();
+    return ts;
+  }
+};
+
+constexpr uint64_t timeslices_per_source = 64;
+
+// Merge k interleaved streams of small timeslices, so the cost of the merge
+// itself dominates
+void BM_MergingSource(benchmark::State& state) {
+  const auto num_sources = static_cast<uint64_t>(state.range(0));
+  const PatternData data({1, 2, 64});
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::vector<std::unique_ptr<fles::TimesliceSource>> sources;
+    for (uint64_t s = 0; s < num_sources; ++s) {
+      std::deque<fles::StorableTimeslice> timeslices;
+      for (uint64_t i = 0; i < timeslices_per_source; ++i) {
+        timeslices.push_back(data.timeslice(i * num_sources + s));
+      }
+      sources.push_back(std::make_unique<MemorySource>(std::move(timeslices)));
+    }
+    fles::MergingSource<fles::TimesliceSource> merging(std::move(sources));
+    state.ResumeTiming();
+    while (auto item = merging.get()) {
+      benchmark::DoNotOptimize(item->index());
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(
+      state.iterations() * num_sources * timeslices_per_source));
+}
+BENCHMARK(BM_MergingSource)->RangeMultiplier(4)->Range(2, 128);
+
+} // namespace
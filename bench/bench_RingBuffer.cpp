@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Benchmarks of the ring buffer element access.
+
+#include "MicrosliceDescriptor.hpp"
+#include "RingBuffer.hpp"
+#include "RingBufferView.hpp"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// Sequential access across the wrap-around, as done by the input channels
+void BM_RingBuffer_At(benchmark::State& state) {
+  const auto size_exp = static_cast<std::size_t>(state.range(0));
+  RingBuffer<uint64_t> buffer(size_exp);
+  const uint64_t n = buffer.size() * 2;
+  uint64_t start = 0;
+  for (auto _ : state) {
+    for (uint64_t i = start; i < start + n; ++i) {
+      buffer.at(i) = i;
+    }
+    benchmark::ClobberMemory();
+    start += n / 2 + 1;
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * n *
+                                               sizeof(uint64_t)));
+}
+BENCHMARK(BM_RingBuffer_At)->Arg(10)->Arg(16)->Arg(22);
+
+// Sum of the microslice sizes in a window of descriptors, as computed for
+// each timeslice component by the input channel sender
+void BM_RingBufferView_DescriptorSum(benchmark::State& state) {
+  const auto size_exp = static_cast<std::size_t>(state.range(0));
+  RingBuffer<fles::MicrosliceDescriptor, true> buffer(size_exp);
+  RingBufferView<fles::MicrosliceDescriptor> view(buffer.ptr(), size_exp);
+  for (uint64_t i = 0; i < buffer.size(); ++i) {
+    view.at(i).size = static_cast<uint32_t>(i & 0xfff);
+  }
+  const uint64_t window = 101;
+  uint64_t start = 0;
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (uint64_t i = start; i < start + window; ++i) {
+      sum += view.at(i).size;
+    }
+    benchmark::DoNotOptimize(sum);
+    start += window - 1;
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * window));
+}
+BENCHMARK(BM_RingBufferView_DescriptorSum)->Arg(10)->Arg(20);
+
+// Copy of timeslice components of the given size into a 64 MiB data buffer,
+// wrapping around at its end, with copy_in() (arg 1: prefetch the source)
+void BM_RingBufferView_CopyIn(benchmark::State& state) {
+  const auto size = static_cast<std::size_t>(state.range(0));
+  const bool prefetch = state.range(1) != 0;
+  RingBuffer<uint8_t> buffer(26);
+  RingBufferView<uint8_t> view(buffer.ptr(), 26);
+  const std::vector<uint8_t> source(size, 0x5a);
+  uint64_t index = 0;
+  for (auto _ : state) {
+    view.copy_in(index, source.data(), size, prefetch);
+    benchmark::ClobberMemory();
+    index += size + 64;
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+}
+BENCHMARK(BM_RingBufferView_CopyIn)
+    ->Args({1 << 16, 0})
+    ->Args({1 << 20, 0})
+    ->Args({1 << 20, 1})
+    ->Args({1 << 24, 0})
+    ->Args({1 << 24, 1});
+
+// The same copies with std::memcpy for comparison
+void BM_RingBufferView_CopyInMemcpy(benchmark::State& state) {
+  const auto size = static_cast<std::size_t>(state.range(0));
+  RingBuffer<uint8_t> buffer(26);
+  RingBufferView<uint8_t> view(buffer.ptr(), 26);
+  const std::vector<uint8_t> source(size, 0x5a);
+  uint64_t index = 0;
+  for (auto _ : state) {
+    const std::size_t n1 =
+        std::min(size, view.size() - (index & view.size_mask()));
+    std::memcpy(&view.at(index), source.data(), n1);
+    std::memcpy(view.ptr(), source.data() + n1, size - n1);
+    benchmark::ClobberMemory();
+    index += size + 64;
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+}
+BENCHMARK(BM_RingBufferView_CopyInMemcpy)
+    ->Arg(1 << 16)
+    ->Arg(1 << 20)
+    ->Arg(1 << 24);
+
+} // namespace
@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Benchmarks of the timeslice serialization and archive readers.
+
+#include "PatternData.hpp"
+#include "StorableTimeslice.hpp"
+#include "TimesliceInputArchive.hpp"
+#include "TimesliceMappedArchive.hpp"
+#include "TimesliceOutputArchive.hpp"
+#include <benchmark/benchmark.h>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/filesystem.hpp>
+#include <memory>
+#include <sstream>
+#include <string>
+
+namespace {
+
+constexpr uint64_t timeslices_per_archive = 16;
+
+void set_counters(benchmark::State& state,
+                  const PatternData& data,
+                  uint64_t timeslices = 1) {
+  const auto items = static_cast<int64_t>(state.iterations() * timeslices);
+  state.SetItemsProcessed(items);
+  state.SetBytesProcessed(items * static_cast<int64_t>(data.timeslice_bytes()));
+}
+
+/// Temporary timeslice archive file, removed on destruction.
+class ArchiveFile {
+public:
+  explicit ArchiveFile(const PatternData& data)
+      : filename_((boost::filesystem::temp_directory_path() /
+                   boost::filesystem::unique_path("bench_%%%%-%%%%.tsa"))
+                      .string()) {
+    fles::TimesliceOutputArchive archive(filename_);
+    for (uint64_t i = 0; i < timeslices_per_archive; ++i) {
+      archive.put(
+          std::make_shared<const fles::StorableTimeslice>(data.timeslice(i)));
+    }
+  }
+
+  ArchiveFile(const ArchiveFile&) = delete;
+  void operator=(const ArchiveFile&) = delete;
+
+  ~ArchiveFile() { boost::filesystem::remove(filename_); }
+
+  [[nodiscard]] const std::string& filename() const { return filename_; }
+
+private:
+  std::string filename_;
+};
+
+// Visit the first descriptor of every component, as needed for any use of a
+// returned timeslice
+uint64_t touch(const fles::Timeslice& ts) {
+  uint64_t sum = 0;
+  for (uint64_t c = 0; c < ts.num_components(); ++c) {
+    sum += ts.descriptor(c, 0).idx;
+  }
+  return sum;
+}
+
+void BM_Serialization_BoostSave(benchmark::State& state) {
+  const PatternData data(timeslice_shape(state));
+  const auto ts = data.timeslice();
+  std::stringstream stream;
+  for (auto _ : state) {
+    stream.str({});
+    boost::archive::binary_oarchive oarchive(stream);
+    oarchive << ts;
+    benchmark::ClobberMemory();
+  }
+  set_counters(state, data);
+}
+BENCHMARK(BM_Serialization_BoostSave)->Apply(timeslice_shapes);
+
+void BM_Serialization_BoostLoad(benchmark::State& state) {
+  const PatternData data(timeslice_shape(state));
+  auto ts = data.timeslice();
+  std::string serialized;
+  {
+    std::ostringstream stream;
+    boost::archive::binary_oarchive oarchive(stream);
+    oarchive << ts;
+    serialized = stream.str();
+  }
+  for (auto _ : state) {
+    std::istringstream stream(serialized);
+    boost::archive::binary_iarchive iarchive(stream);
+    iarchive >> ts;
+    benchmark::DoNotOptimize(touch(ts));
+  }
+  set_counters(state, data);
+}
+BENCHMARK(BM_Serialization_BoostLoad)->Apply(timeslice_shapes);
+
+// Read an archive file with boost deserialization into StorableTimeslices
+void BM_Archive_Input(benchmark::State& state) {
+  const PatternData data(timeslice_shape(state));
+  const ArchiveFile file(data);
+  for (auto _ : state) {
+    fles::TimesliceInputArchive archive(file.filename());
+    while (auto ts = archive.get()) {
+      benchmark::DoNotOptimize(touch(*ts));
+    }
+  }
+  set_counters(state, data, timeslices_per_archive);
+}
+BENCHMARK(BM_Archive_Input)->Apply(timeslice_shapes);
+
+// Read the same archive file as zero-copy views into the mapped file
+void BM_Archive_Mapped(benchmark::State& state) {
+  const PatternData data(timeslice_shape(state));
+  const ArchiveFile file(data);
+  for (auto _ : state) {
+    fles::TimesliceMappedArchive archive(file.filename());
+    while (auto ts = archive.get()) {
+      benchmark::DoNotOptimize(touch(*ts));
+    }
+  }
+  set_counters(state, data, timeslices_per_archive);
+}
+BENCHMARK(BM_Archive_Mapped)->Apply(timeslice_shapes);
+
+} // namespace
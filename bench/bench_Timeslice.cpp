@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Benchmarks of the construction of and access to timeslices.
+
+#include "MicrosliceView.hpp"
+#include "PatternData.hpp"
+#include "StorableTimeslice.hpp"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+void set_counters(benchmark::State& state, const PatternData& data) {
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(data.timeslice_bytes()));
+}
+
+// Build a timeslice microslice by microslice, as in the archive readers
+void BM_StorableTimeslice_Construct(benchmark::State& state) {
+  const PatternData data(timeslice_shape(state));
+  for (auto _ : state) {
+    auto ts = data.timeslice();
+    benchmark::DoNotOptimize(ts.num_components());
+  }
+  set_counters(state, data);
+}
+BENCHMARK(BM_StorableTimeslice_Construct)->Apply(timeslice_shapes);
+
+// Copy a complete timeslice, as done when a view is made storable
+void BM_StorableTimeslice_Copy(benchmark::State& state) {
+  const PatternData data(timeslice_shape(state));
+  const auto ts = data.timeslice();
+  for (auto _ : state) {
+    fles::StorableTimeslice copy(ts);
+    benchmark::DoNotOptimize(copy.num_components());
+  }
+  set_counters(state, data);
+}
+BENCHMARK(BM_StorableTimeslice_Copy)->Apply(timeslice_shapes);
+
+// Visit every microslice of a timeslice, as done by typical consumers
+void BM_Timeslice_GetMicroslice(benchmark::State& state) {
+  const PatternData data(timeslice_shape(state));
+  const auto ts = data.timeslice();
+  uint64_t microslices = 0;
+  for (auto _ : state) {
+    for (uint64_t c = 0; c < ts.num_components(); ++c) {
+      const uint64_t n = ts.num_microslices(c);
+      for (uint64_t m = 0; m < n; ++m) {
+        auto ms = ts.get_microslice(c, m);
+        benchmark::DoNotOptimize(ms.desc().size);
+        benchmark::DoNotOptimize(ms.content());
+      }
+      microslices += n;
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(microslices));
+}
+BENCHMARK(BM_Timeslice_GetMicroslice)->Apply(timeslice_shapes);
+
+// Sum the first content word of every microslice through the accessors of
+// the timeslice, which recompute the component offsets on each call
+void BM_Timeslice_Content(benchmark::State& state) {
+  const PatternData data(timeslice_shape(state));
+  const auto ts = data.timeslice();
+  uint64_t microslices = 0;
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (uint64_t c = 0; c < ts.num_components(); ++c) {
+      const uint64_t n = ts.num_microslices(c);
+      for (uint64_t m = 0; m < n; ++m) {
+        sum += ts.descriptor(c, m).size + *ts.content(c, m);
+      }
+      microslices += n;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(microslices));
+}
+BENCHMARK(BM_Timeslice_Content)->Apply(timeslice_shapes);
+
+// The same through the flat ComponentView iterators
+void BM_ComponentView_Iterate(benchmark::State& state) {
+  const PatternData data(timeslice_shape(state));
+  const auto ts = data.timeslice();
+  uint64_t microslices = 0;
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (uint64_t c = 0; c < ts.num_components(); ++c) {
+      const auto component = ts.component(c);
+      for (const auto& ms : component) {
+        sum += ms.desc.size + *ms.content;
+      }
+      microslices += component.size();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(microslices));
+}
+BENCHMARK(BM_ComponentView_Iterate)->Apply(timeslice_shapes);
+
+} // namespace
@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Benchmark of the timeslice transfer from a timeslice buffer to a
+/// consumer process through shared memory.
+
+#include "PatternData.hpp"
+#include "TimesliceBuffer.hpp"
+#include "TimesliceReceiver.hpp"
+#include "TimesliceView.hpp"
+#include "TimesliceWorkItem.hpp"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include <zmq.hpp>
+
+namespace {
+
+// Number of timeslice slots in the buffer of each component
+constexpr uint64_t slots = 4;
+
+// Send work items for the prepared timeslices of a TimesliceBuffer and
+// receive them as TimesliceView objects, both in this thread. Each
+// iteration covers the work item encoding, the transfer through the shared
+// memory item channel, the view construction, access to all microslices and
+// the completion of the previous timeslice.
+void BM_TimesliceView_Receive(benchmark::State& state) {
+  const PatternData data(timeslice_shape(state));
+  const auto ts = data.timeslice();
+  const auto components = static_cast<uint32_t>(ts.num_components());
+
+  uint64_t max_component_size = 0;
+  for (uint32_t c = 0; c < components; ++c) {
+    max_component_size = std::max(max_component_size, ts.size_component(c));
+  }
+  uint32_t data_exp = 0;
+  while ((UINT64_C(1) << data_exp) < slots * max_component_size) {
+    ++data_exp;
+  }
+  const uint32_t desc_exp = 10;
+
+  const std::string shm_id = "bench_flesnet_" + std::to_string(getpid());
+  zmq::context_t zmq_context;
+  TimesliceBuffer buffer(zmq_context, "inproc://" + shm_id, shm_id, data_exp,
+                         desc_exp, components, MemoryPolicy{}, true,
+                         fles::WorkItemEncoding::Binary);
+  for (uint32_t c = 0; c < components; ++c) {
+    for (uint64_t slot = 0; slot < slots; ++slot) {
+      std::memcpy(&buffer.get_data(c, slot * max_component_size),
+                  &ts.descriptor(c, 0), ts.size_component(c));
+    }
+  }
+
+  fles::TimesliceReceiver receiver(
+      shm_id, WorkerParameters{1, 0, WorkerQueuePolicy::QueueAll, 0, "bench"});
+  ItemCompletionBatch batch;
+  // let the distributor accept the worker registration
+  static_cast<void>(buffer.try_receive_completions(batch));
+
+  uint64_t index = 0;
+  for (auto _ : state) {
+    const uint64_t slot = index % slots;
+    for (uint32_t c = 0; c < components; ++c) {
+      buffer.get_desc(c, index) = {index, slot * max_component_size,
+                                   ts.size_component(c),
+                                   ts.num_microslices(c)};
+    }
+    buffer.send_work_item(
+        {{index, index, static_cast<uint32_t>(ts.num_core_microslices()),
+          components},
+         data_exp,
+         desc_exp});
+
+    auto view = receiver.get();
+    for (uint64_t c = 0; c < view->num_components(); ++c) {
+      for (uint64_t m = 0; m < view->num_microslices(c); ++m) {
+        auto ms = view->get_microslice(c, m);
+        benchmark::DoNotOptimize(ms.desc().size);
+        benchmark::DoNotOptimize(ms.content());
+      }
+    }
+    view.reset();
+    // the completion is sent by the worker on the next call to get()
+    static_cast<void>(buffer.try_receive_completions(batch));
+    ++index;
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(data.timeslice_bytes()));
+}
+BENCHMARK(BM_TimesliceView_Receive)->Apply(timeslice_shapes);
+
+} // namespace
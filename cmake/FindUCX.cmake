@@ -0,0 +1,10 @@
+# SPDX-License-Identifier: GPL-3.0-only
+# (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+find_path(UCX_INCLUDE_DIR ucp/api/ucp.h)
+find_library(UCP_LIBRARY ucp)
+find_library(UCS_LIBRARY ucs)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(UCX REQUIRED_VARS UCP_LIBRARY UCS_LIBRARY UCX_INCLUDE_DIR)
+set(UCX_LIBRARIES ${UCP_LIBRARY} ${UCS_LIBRARY})
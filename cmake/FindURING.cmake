@@ -0,0 +1,8 @@
+# SPDX-License-Identifier: GPL-3.0-only
+# (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+find_path(URING_INCLUDE_DIR liburing.h)
+find_library(URING_LIBRARY uring)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(URING REQUIRED_VARS URING_LIBRARY URING_INCLUDE_DIR)
@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+// Batched CRC-32C (Castagnoli) computation over many independent buffers.
+//
+// Uses the SSE4.2 crc32 instruction (x86-64) or the ARMv8 CRC extension
+// (aarch64) if available at compile time, and a table-driven software
+// implementation otherwise. To hide the instruction latency, several
+// buffers are processed in interleaved independent streams. Large buffers
+// are split into blocks that are processed in parallel streams and folded
+// together afterwards, using PCLMULQDQ when available at run time.
+//
+// The results are identical to crcutil_interface::CRC created with the
+// Castagnoli polynomial 0x82f63b78 in canonical mode.
+
+#ifndef CRCUTIL_CRC32C_BATCH_H_
+#define CRCUTIL_CRC32C_BATCH_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace crcutil_interface {
+
+// A memory region for batched CRC computation.
+struct CrcBuffer {
+  const void* data;
+  size_t size;
+};
+
+// Computes the CRC-32C of a single memory region. A previous result may be
+// passed as "crc" to continue the computation over a following region.
+uint32_t Crc32c(const void* data, size_t size, uint32_t crc = 0);
+
+// Computes the CRC-32C of "count" independent memory regions and stores
+// the results in crcs[0 .. count-1].
+void Crc32cBatch(const CrcBuffer* buffers, size_t count, uint32_t* crcs);
+
+// Returns the name of the implementation selected at run time.
+const char* Crc32cImplementation();
+
+}  // namespace crcutil_interface
+
+#endif  // CRCUTIL_CRC32C_BATCH_H_
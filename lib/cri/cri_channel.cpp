@@ -9,6 +9,7 @@
 
 #include "cri_channel.hpp"
 #include <arpa/inet.h> // ntohl
+#include <array>
 #include <cassert>
 #include <memory>
 
@@ -176,18 +177,33 @@ uint32_t cri_channel::get_microslice_cnt() {
   return m_rfpkt->get_reg(CRI_REG_PKT_PERF_N_EVENTS);
 }
 
+// read all shadowed counters in a single register window access
+void cri_channel::read_perf(ch_perf_t& perf) {
+  static_assert(CRI_REG_PKT_PERF_N_EVENTS - CRI_REG_PKT_PERF_CYCLE == 6,
+                "unexpected packetizer perf counter layout");
+  std::array<uint32_t, 7> regs{};
+  if (m_rfpkt->get_mem(CRI_REG_PKT_PERF_CYCLE, regs.data(), regs.size()) !=
+      0) {
+    throw CriException("Failed to read perf counters");
+  }
+  perf.cycles = regs[CRI_REG_PKT_PERF_CYCLE - CRI_REG_PKT_PERF_CYCLE];
+  perf.dma_trans = regs[CRI_REG_PKT_PERF_DMA_TRANS - CRI_REG_PKT_PERF_CYCLE];
+  perf.dma_stall = regs[CRI_REG_PKT_PERF_DMA_STALL - CRI_REG_PKT_PERF_CYCLE];
+  perf.dma_busy = regs[CRI_REG_PKT_PERF_DMA_BUSY - CRI_REG_PKT_PERF_CYCLE];
+  perf.data_buf_stall =
+      regs[CRI_REG_PKT_PERF_EBUF_STALL - CRI_REG_PKT_PERF_CYCLE];
+  perf.desc_buf_stall =
+      regs[CRI_REG_PKT_PERF_RBUF_STALL - CRI_REG_PKT_PERF_CYCLE];
+  perf.microslice_cnt =
+      regs[CRI_REG_PKT_PERF_N_EVENTS - CRI_REG_PKT_PERF_CYCLE];
+}
+
 cri_channel::ch_perf_t cri_channel::get_perf() {
   ch_perf_t perf;
   // capture and rest perf counters
   set_perf_cnt(true, true);
   // return shadowed counters
-  perf.cycles = get_perf_cycles();
-  perf.dma_trans = get_dma_trans();
-  perf.dma_stall = get_dma_stall();
-  perf.dma_busy = get_dma_busy();
-  perf.data_buf_stall = get_data_buf_stall();
-  perf.desc_buf_stall = get_desc_buf_stall();
-  perf.microslice_cnt = get_microslice_cnt();
+  read_perf(perf);
   return perf;
 }
 
@@ -220,16 +236,46 @@ uint32_t cri_channel::get_mc_busy() {
   return m_rfgtx->get_reg(CRI_REG_GTX_PERF_MC_BUSY);
 }
 
+// read the datapath config and all shadowed counters in a single register
+// window access
+void cri_channel::read_perf_gtx(ch_perf_gtx_t& perf, uint32_t& datapath_cfg) {
+  static_assert(CRI_REG_GTX_PERF_MC_BUSY - CRI_REG_GTX_DATAPATH_CFG == 8,
+                "unexpected gtx perf counter layout");
+  std::array<uint32_t, 9> regs{};
+  if (m_rfgtx->get_mem(CRI_REG_GTX_DATAPATH_CFG, regs.data(), regs.size()) !=
+      0) {
+    throw CriException("Failed to read gtx perf counters");
+  }
+  datapath_cfg = regs[0];
+  perf.cycles = regs[CRI_REG_GTX_PERF_CYCLE - CRI_REG_GTX_DATAPATH_CFG];
+  perf.mc_trans = regs[CRI_REG_GTX_PERF_MC_TRANS - CRI_REG_GTX_DATAPATH_CFG];
+  perf.mc_stall = regs[CRI_REG_GTX_PERF_MC_STALL - CRI_REG_GTX_DATAPATH_CFG];
+  perf.mc_busy = regs[CRI_REG_GTX_PERF_MC_BUSY - CRI_REG_GTX_DATAPATH_CFG];
+}
+
 cri_channel::ch_perf_gtx_t cri_channel::get_perf_gtx() {
   ch_perf_gtx_t perf;
+  uint32_t datapath_cfg = 0;
   // capture and rest perf counters
   set_perf_gtx_cnt(true, true);
   // return shadowed counters
-  perf.cycles = get_perf_gtx_cycles();
-  perf.mc_trans = get_mc_trans();
-  perf.mc_stall = get_mc_stall();
-  perf.mc_busy = get_mc_busy();
+  read_perf_gtx(perf, datapath_cfg);
   return perf;
 }
 
+//////*** Snapshot ***//////
+
+cri_channel::ch_snapshot_t cri_channel::get_snapshot() {
+  ch_snapshot_t snapshot;
+  // capture both domains back to back to keep the intervals aligned
+  set_perf_cnt(true, true);
+  set_perf_gtx_cnt(true, true);
+  read_perf(snapshot.perf);
+  uint32_t datapath_cfg = 0;
+  read_perf_gtx(snapshot.perf_gtx, datapath_cfg);
+  snapshot.data_source = static_cast<data_source_t>(datapath_cfg & 0x3);
+  snapshot.ready_for_data = (datapath_cfg & (1 << 2)) != 0u;
+  return snapshot;
+}
+
 } // namespace cri
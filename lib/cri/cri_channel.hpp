@@ -99,6 +99,18 @@ public:
   uint32_t get_mc_stall();
   uint32_t get_mc_busy();
 
+  // Consistent snapshot of the channel status and performance counters.
+  // Both counter sets are captured (and reset) back to back, then the
+  // shadowed register windows are read in bulk.
+  using ch_snapshot_t = struct {
+    data_source_t data_source;
+    bool ready_for_data;
+    ch_perf_t perf;
+    ch_perf_gtx_t perf_gtx;
+  };
+
+  ch_snapshot_t get_snapshot();
+
   /*** Getter ***/
   size_t channel_index() const { return m_ch_index; };
   sys_bus_addr base_addr() const { return m_base_addr; };
@@ -110,6 +122,9 @@ public:
   register_file* register_file_gtx() const { return m_rfgtx.get(); }
 
 protected:
+  void read_perf(ch_perf_t& perf);
+  void read_perf_gtx(ch_perf_gtx_t& perf, uint32_t& datapath_cfg);
+
   std::unique_ptr<dma_channel> m_dma_channel;
   std::unique_ptr<register_file> m_rfpkt;
   std::unique_ptr<register_file> m_rfgtx;
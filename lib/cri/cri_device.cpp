@@ -13,6 +13,7 @@
 #include "pda/pci_bar.hpp"
 #include "register_file_bar.hpp"
 #include <arpa/inet.h> // ntohl
+#include <array>
 #include <ctime>
 #include <iomanip>
 #include <memory>
@@ -183,6 +184,8 @@ std::string cri_device::print_devinfo() {
   return ss.str();
 }
 
+int cri_device::numa_node() { return m_device->numa_node(); }
+
 std::chrono::seconds cri_device::uptime() {
   std::chrono::duration<double, std::ratio<1, pci_clk>> uptime(
       static_cast<uint64_t>(m_register_file->get_reg(CRI_REG_UPTIME)) << 24);
@@ -284,12 +287,22 @@ cri_device::dev_perf_t cri_device::get_perf() {
   dev_perf_t perf;
   // capture and rest perf counters
   set_perf_cnt(true, true);
-  // return shadowed counters
-  perf.cycles = get_perf_cycles();
-  perf.pci_trans = get_pci_trans();
-  perf.pci_stall = get_pci_stall();
-  perf.pci_busy = get_pci_busy();
-  perf.pci_max_stall = get_pci_max_stall();
+  // return shadowed counters, read in a single register window access
+  static_assert(CRI_REG_PCI_PERF_DMA_MAX_NRDY - CRI_REG_PCI_PERF_CYCLE == 4,
+                "unexpected pci perf counter layout");
+  std::array<uint32_t, 5> regs{};
+  if (m_register_file->get_mem(CRI_REG_PCI_PERF_CYCLE, regs.data(),
+                               regs.size()) != 0) {
+    throw CriException("Failed to read pci perf counters");
+  }
+  perf.cycles = regs[CRI_REG_PCI_PERF_CYCLE - CRI_REG_PCI_PERF_CYCLE];
+  perf.pci_trans = regs[CRI_REG_PCI_PERF_DMA_TRANS - CRI_REG_PCI_PERF_CYCLE];
+  perf.pci_stall = regs[CRI_REG_PCI_PERF_DMA_STALL - CRI_REG_PCI_PERF_CYCLE];
+  perf.pci_busy = regs[CRI_REG_PCI_PERF_DMA_BUSY - CRI_REG_PCI_PERF_CYCLE];
+  perf.pci_max_stall =
+      static_cast<float>(
+          regs[CRI_REG_PCI_PERF_DMA_MAX_NRDY - CRI_REG_PCI_PERF_CYCLE]) *
+      (1.0 / pci_clk) * 1E6;
   return perf;
 }
 
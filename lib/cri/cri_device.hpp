@@ -56,6 +56,7 @@ public:
   struct build_info_t build_info();
   std::string print_build_info();
   std::string print_devinfo();
+  int numa_node();
   std::chrono::seconds uptime();
   std::string print_uptime();
   std::string print_version_warning() const;
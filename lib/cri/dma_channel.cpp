@@ -8,7 +8,9 @@
 #include "dma_channel.hpp"
 #include "cri_registers.hpp"
 #include "data_structures.hpp"
+#include <atomic>
 #include <cassert>
+#include <cstddef>
 #include <cstring>
 #include <memory>
 
@@ -82,6 +84,13 @@ void dma_channel::set_sw_read_pointers(uint64_t data_offset,
   // no need to chache sync pointers bit because it is pulse only
   offsets.dma_ctrl = m_reg_dmactrl_cached | (1 << BIT_DMACTRL_SYNC_SWRDPTRS);
 
+  if (m_shadow_index) {
+    // clear consumed entries before handing them back to the hardware
+    clear_desc_entries(m_desc_read_offset, desc_offset);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+  m_desc_read_offset = desc_offset;
+
   m_rfpkt->set_mem(CRI_REG_EBDM_SW_READ_POINTER_L, &offsets,
                    sizeof(offsets) >> 2);
 }
@@ -94,11 +103,35 @@ uint64_t dma_channel::get_data_offset() {
 
 // get descriptor count from HW
 uint64_t dma_channel::get_desc_index() {
+  ++m_index_stats.polls;
+  if (m_shadow_index) {
+    // the entry at the write position is still cleared if the hardware has
+    // not written a new descriptor (see set_sw_read_pointers)
+    size_t entries = m_desc_buffer->size() / sizeof(fles::MicrosliceDescriptor);
+    const volatile uint8_t* next =
+        reinterpret_cast<const volatile uint8_t*>(m_desc_buffer->mem()) +
+        (m_desc_index & (entries - 1)) * sizeof(fles::MicrosliceDescriptor) +
+        offsetof(fles::MicrosliceDescriptor, hdr_id);
+    if (*next == 0) {
+      return m_desc_index;
+    }
+  }
+  ++m_index_stats.register_reads;
   uint64_t index = 0;
   m_rfpkt->get_mem(CRI_REG_DESC_CNT_L, &index, 2);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  m_desc_index = index;
   return index;
 }
 
+void dma_channel::set_shadow_index(bool enable) {
+  m_shadow_index = enable;
+  if (enable) {
+    ++m_index_stats.register_reads;
+    m_rfpkt->get_mem(CRI_REG_DESC_CNT_L, &m_desc_index, 2);
+  }
+}
+
 std::string dma_channel::data_buffer_info() {
   return m_data_buffer->print_buffer_info();
 }
@@ -299,6 +332,19 @@ void dma_channel::set_dmactrl(uint32_t reg, uint32_t mask) {
   m_rfpkt->set_reg(CRI_REG_DMA_CTRL, m_reg_dmactrl_cached);
 }
 
+// clear the descriptor entries in the given range of byte offsets, which
+// wraps around at the end of the buffer
+void dma_channel::clear_desc_entries(uint64_t begin_offset,
+                                     uint64_t end_offset) {
+  auto* mem = reinterpret_cast<uint8_t*>(m_desc_buffer->mem());
+  if (end_offset >= begin_offset) {
+    memset(mem + begin_offset, 0, end_offset - begin_offset);
+  } else {
+    memset(mem + begin_offset, 0, m_desc_buffer->size() - begin_offset);
+    memset(mem, 0, end_offset);
+  }
+}
+
 inline uint32_t
 dma_channel::set_bits(uint32_t old_val, uint32_t new_val, uint32_t mask) {
   // clear all unselected bits in new_val
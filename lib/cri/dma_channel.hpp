@@ -47,6 +47,20 @@ public:
   uint64_t get_data_offset();
   uint64_t get_desc_index();
 
+  // Shadow index mode: detect new descriptors in host memory and read the
+  // descriptor count register only if there are any. Consumed descriptors
+  // are cleared in set_sw_read_pointers() to make this possible. Enable
+  // before the readout to ensure that the buffer holds no stale entries.
+  void set_shadow_index(bool enable);
+  bool shadow_index() const { return m_shadow_index; }
+
+  // number of get_desc_index() calls and of actual register reads
+  struct index_stats_t {
+    uint64_t polls;
+    uint64_t register_reads;
+  };
+  index_stats_t index_stats() const { return m_index_stats; }
+
   std::string data_buffer_info();
   std::string desc_buffer_info();
 
@@ -113,6 +127,8 @@ private:
 
   void set_dmactrl(uint32_t reg, uint32_t mask);
 
+  void clear_desc_entries(uint64_t begin_offset, uint64_t end_offset);
+
   static inline uint32_t
   set_bits(uint32_t old_val, uint32_t new_val, uint32_t mask);
 
@@ -126,6 +142,11 @@ private:
   std::unique_ptr<pda::dma_buffer> m_desc_buffer;
   size_t m_dma_transfer_size;
   uint32_t m_reg_dmactrl_cached;
+
+  bool m_shadow_index = false;
+  uint64_t m_desc_index = 0;       // cached descriptor count
+  uint64_t m_desc_read_offset = 0; // last sw read pointer (bytes)
+  index_stats_t m_index_stats = {0, 0};
 };
 
 } // namespace cri
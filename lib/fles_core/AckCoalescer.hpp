@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the AckCoalescer class.
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * \brief Adaptive coalescing of the acknowledgments of a compute node
+ * connection.
+ *
+ * Decides whether an advanced acknowledgment is sent to the input node now
+ * or held back to be combined with the following ones, which saves control
+ * messages at high timeslice rates. A held back acknowledgment is sent as
+ * soon as
+ * - it covers max_count timeslices,
+ * - it has been held back for max_delay, so that it does not wait for the
+ *   next timeslice at low rates, or
+ * - the input node's view of the buffer, i.e. its last reported write
+ *   position minus the last acknowledgment sent, is filled to at least
+ *   expedite_fill in either the data or the descriptor buffer, so that the
+ *   input node does not run out of space while acknowledgments are held.
+ *
+ * With a max_count of one (the default), every acknowledgment is sent
+ * immediately.
+ */
+class AckCoalescer {
+public:
+  using clock = std::chrono::steady_clock;
+
+  struct Parameters {
+    /// Maximum number of timeslices covered by a held back acknowledgment.
+    uint32_t max_count = 1;
+    /// Maximum time an acknowledgment is held back.
+    std::chrono::microseconds max_delay{100};
+    /// Input buffer fill (as seen by the input node) expediting an
+    /// acknowledgment.
+    double expedite_fill = 0.5;
+  };
+
+  AckCoalescer() = default;
+  explicit AckCoalescer(const Parameters& parameters)
+      : parameters_(parameters) {}
+
+  /// Check whether an acknowledgment is to be sent now.
+  /**
+     \param ack  Current acknowledgment (buffer position)
+     \param sent Last acknowledgment sent
+     \param wp   Last write position reported by the input node
+     \param size Buffer sizes
+     \return true if ack is to be sent, false if it is unchanged or held back
+  */
+  template <typename Position>
+  bool due(const Position& ack,
+           const Position& sent,
+           const Position& wp,
+           const Position& size) {
+    if (ack.desc == sent.desc) {
+      return false;
+    }
+    if (parameters_.max_count <= 1) {
+      return true;
+    }
+    auto now = clock::now();
+    if (!holding_) {
+      holding_ = true;
+      held_since_ = now;
+    }
+    return ack.desc - sent.desc >= parameters_.max_count ||
+           now - held_since_ >= parameters_.max_delay ||
+           fill(wp.desc - sent.desc, size.desc) >= parameters_.expedite_fill ||
+           fill(wp.data - sent.data, size.data) >= parameters_.expedite_fill;
+  }
+
+  /// Record that an acknowledgment has been sent.
+  /**
+     \param ack  Acknowledgment sent
+     \param sent Acknowledgment sent before
+  */
+  template <typename Position>
+  void on_sent(const Position& ack, const Position& sent) {
+    holding_ = false;
+    ++messages_;
+    timeslices_ += ack.desc - sent.desc;
+  }
+
+  /// The number of acknowledgment messages sent.
+  [[nodiscard]] uint64_t messages() const { return messages_; }
+
+  /// The number of timeslices acknowledged by these messages.
+  [[nodiscard]] uint64_t timeslices() const { return timeslices_; }
+
+private:
+  static double fill(uint64_t used, uint64_t size) {
+    return size == 0 ? 0.0
+                     : static_cast<double>(used) / static_cast<double>(size);
+  }
+
+  Parameters parameters_;
+
+  /// Flag, true if an acknowledgment is held back.
+  bool holding_ = false;
+
+  /// Time since the current acknowledgment is held back.
+  clock::time_point held_since_;
+
+  uint64_t messages_ = 0;
+  uint64_t timeslices_ = 0;
+};
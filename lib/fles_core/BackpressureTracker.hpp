@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the BackpressureTracker class.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+/// Reasons for a sender not to make progress.
+enum class BlockReason {
+  None,       ///< Not blocked
+  DataSource, ///< Waiting for data from the local data source
+  Credits,    ///< Waiting for local resources (e.g., send work requests)
+  RemoteAck,  ///< Waiting for buffer space acknowledged by the target
+  Count       ///< Number of reasons
+};
+
+/**
+ * \brief Attribution of the time a sender is blocked to reasons and
+ * targets.
+ *
+ * The sender reports each attempt that fails with blocked() and each
+ * successful one with progressed(). The clock is only read when the
+ * blocking state changes, so repeated failed attempts in a polling loop are
+ * cheap. The accumulated times are retrieved and reset with take().
+ */
+class BackpressureTracker {
+public:
+  using clock = std::chrono::steady_clock;
+
+  /// Index of no particular target.
+  static constexpr std::size_t no_target = static_cast<std::size_t>(-1);
+
+  /// The accumulated blocking times since the last take().
+  struct Times {
+    /// Time blocked per reason
+    std::array<clock::duration, static_cast<std::size_t>(BlockReason::Count)>
+        reason{};
+    /// Time blocked per target (for any reason)
+    std::vector<clock::duration> target;
+
+    [[nodiscard]] clock::duration operator[](BlockReason r) const {
+      return reason[static_cast<std::size_t>(r)];
+    }
+  };
+
+  explicit BackpressureTracker(std::size_t num_targets = 0)
+      : times_{{}, std::vector<clock::duration>(num_targets)} {}
+
+  /// Record a failed attempt for the given reason and responsible target.
+  void blocked(BlockReason reason, std::size_t target = no_target) {
+    if (reason != reason_ || target != target_) {
+      transition(reason, target, clock::now());
+    }
+  }
+
+  /// Record a successful attempt.
+  void progressed() {
+    if (reason_ != BlockReason::None) {
+      transition(BlockReason::None, no_target, clock::now());
+    }
+  }
+
+  /// Retrieve the current blocking reason.
+  [[nodiscard]] BlockReason reason() const { return reason_; }
+
+  /// Retrieve and reset the accumulated times, including the current
+  /// blocking period up to now.
+  Times take(clock::time_point now = clock::now()) {
+    transition(reason_, target_, now);
+    Times result = times_;
+    times_.reason.fill(clock::duration::zero());
+    std::fill(times_.target.begin(), times_.target.end(),
+              clock::duration::zero());
+    return result;
+  }
+
+private:
+  BlockReason reason_ = BlockReason::None;
+  std::size_t target_ = no_target;
+  clock::time_point since_ = clock::now();
+  Times times_;
+
+  void transition(BlockReason reason,
+                  std::size_t target,
+                  clock::time_point now) {
+    if (reason_ != BlockReason::None) {
+      const auto elapsed = now - since_;
+      times_.reason[static_cast<std::size_t>(reason_)] += elapsed;
+      if (target_ < times_.target.size()) {
+        times_.target[target_] += elapsed;
+      }
+    }
+    reason_ = reason;
+    target_ = target;
+    since_ = now;
+  }
+};
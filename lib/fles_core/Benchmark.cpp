@@ -1,8 +1,14 @@
 // Copyright 2015 Jan de Cuveland <cmail@cuveland.de>
 
 #include "Benchmark.hpp"
-#include "interface.h" // crcutil_interface
+#include "ComponentView.hpp"
+#include "FlesnetPatternChecker.hpp"
+#include "FlibPatternChecker.hpp"
+#include "MicrosliceView.hpp"
+#include "crc32c_batch.h" // crcutil_interface::Crc32cBatch
+#include "interface.h"    // crcutil_interface
 #include <algorithm>   // std::generate_n
+#include <cstring>
 #include <boost/crc.hpp>
 #include <chrono>
 #include <functional> // std::bind
@@ -129,6 +135,33 @@ uint32_t Benchmark::compute_crc32(Algorithm algorithm) {
     crc_32->Delete();
     break;
   }
+
+  case Algorithm::Crc32c: {
+    // Castagnoli
+    for (size_t i = 0; i < cycles_; ++i) {
+      crc = crcutil_interface::Crc32c(random_data_.data(), random_data_.size(),
+                                      crc);
+    }
+    break;
+  }
+
+  case Algorithm::Crc32cBatch: {
+    // Castagnoli, independent buffers; result is the XOR of all CRCs
+    const size_t count = random_data_.size() / batch_buffer_size_;
+    std::vector<crcutil_interface::CrcBuffer> buffers(count);
+    for (size_t b = 0; b < count; ++b) {
+      buffers[b] = {random_data_.data() + b * batch_buffer_size_,
+                    batch_buffer_size_};
+    }
+    std::vector<uint32_t> crcs(count);
+    for (size_t i = 0; i < cycles_; ++i) {
+      crcutil_interface::Crc32cBatch(buffers.data(), count, crcs.data());
+    }
+    for (uint32_t c : crcs) {
+      crc ^= c;
+    }
+    break;
+  }
   }
 
   return crc;
@@ -149,6 +182,37 @@ void Benchmark::run() {
   run_single(Algorithm::CrcUtil_C);
   std::cout << "CRC32 Benchmark: CrcUtil (IEEE)" << std::endl;
   run_single(Algorithm::CrcUtil_I);
+  std::cout << "CRC32 Benchmark: Crc32c "
+            << crcutil_interface::Crc32cImplementation() << " (Castagnoli)"
+            << std::endl;
+  run_single(Algorithm::Crc32c);
+  std::cout << "CRC32 Benchmark: Crc32cBatch "
+            << crcutil_interface::Crc32cImplementation() << " (" << std::dec
+            << batch_buffer_size_ << " byte buffers, Castagnoli)" << std::endl;
+  run_single(Algorithm::Crc32cBatch);
+
+  std::cout << "Pattern check benchmark: FlesnetPatternChecker ("
+            << to_string(ramp_compare_supported_isas().back()) << ", "
+            << std::dec << pattern_microslice_size_ << " byte microslices)"
+            << std::endl;
+  run_single(Checker::Flesnet);
+  std::cout << "Pattern check benchmark: FlibPatternChecker ("
+            << to_string(ramp_compare_supported_isas().back()) << ", "
+            << std::dec << pattern_microslice_size_ << " byte microslices)"
+            << std::endl;
+  run_single(Checker::Flib);
+  for (RampCompareIsa isa : ramp_compare_supported_isas()) {
+    std::cout << "Pattern check benchmark: ramp comparison (" << to_string(isa)
+              << ")" << std::endl;
+    run_single(isa);
+  }
+
+  std::cout << "Microslice iteration benchmark: header scan (" << std::dec
+            << scan_microslice_size_ << " byte microslices)" << std::endl;
+  run_scan(false);
+  std::cout << "Microslice iteration benchmark: header scan with prefetching"
+            << std::endl;
+  run_scan(true);
 }
 
 void Benchmark::run_single(Algorithm algorithm) {
@@ -163,3 +227,151 @@ void Benchmark::run_single(Algorithm algorithm) {
   std::cout << "crc32=" << std::hex << crc32 << "  " << rate << " MiB/s"
             << std::endl;
 }
+
+bool Benchmark::check_pattern(Checker checker) {
+  // generate microslices with a valid pattern of the given type
+  const size_t count = size_ / pattern_microslice_size_;
+  const size_t words = pattern_microslice_size_ / sizeof(uint64_t);
+  std::vector<uint64_t> content(count * words);
+  std::vector<fles::MicrosliceDescriptor> descs(count);
+  for (size_t i = 0; i < count; ++i) {
+    uint64_t* ms = content.data() + i * words;
+    uint32_t crc = 0;
+    for (size_t pos = 0; pos < words; ++pos) {
+      if (checker == Checker::Flesnet) {
+        ms[pos] = pos * sizeof(uint64_t);
+        crc ^= static_cast<uint32_t>(ms[pos]);
+      } else if (pos == 0) {
+        // last word size, header word and packet number
+        const uint8_t header[8] = {0, 0, 0xFF, 0xBB, 1, 0, 0, 0};
+        memcpy(&ms[pos], header, sizeof(header));
+      } else {
+        ms[pos] = 0xABCD000000000000 + pos - 1;
+      }
+    }
+    descs[i] = fles::MicrosliceDescriptor();
+    descs[i].size = static_cast<uint32_t>(pattern_microslice_size_);
+    descs[i].crc = crc;
+  }
+
+  std::unique_ptr<PatternChecker> pattern_checker;
+  if (checker == Checker::Flesnet) {
+    pattern_checker = std::make_unique<FlesnetPatternChecker>(0);
+  } else {
+    pattern_checker = std::make_unique<FlibPatternChecker>();
+  }
+
+  bool success = true;
+  for (size_t c = 0; c < cycles_; ++c) {
+    for (size_t i = 0; i < count; ++i) {
+      pattern_checker->reset();
+      fles::MicrosliceView m(
+          descs[i], reinterpret_cast<uint8_t*>(content.data() + i * words));
+      success &= pattern_checker->check(m);
+    }
+  }
+  return success;
+}
+
+bool Benchmark::compare_ramp(RampCompareIsa isa) {
+  const size_t count = size_ / sizeof(uint64_t);
+  std::vector<uint64_t> words(count);
+  for (size_t i = 0; i < count; ++i) {
+    words[i] = i;
+  }
+
+  bool success = true;
+  uint64_t word_xor = 0;
+  for (size_t c = 0; c < cycles_; ++c) {
+    success &= ramp_compare(isa, words.data(), count, 0, 1, word_xor) == count;
+  }
+  return success;
+}
+
+void Benchmark::run_single(Checker checker) {
+  const size_t bytes = size_ / pattern_microslice_size_ *
+                       pattern_microslice_size_ * cycles_;
+
+  auto start = std::chrono::system_clock::now();
+  bool success = check_pattern(checker);
+  auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::system_clock::now() - start);
+  const float rate =
+      static_cast<float>(bytes) / static_cast<float>(duration.count());
+  std::cout << "success=" << success << "  " << rate << " GB/s" << std::endl;
+}
+
+void Benchmark::run_single(RampCompareIsa isa) {
+  const size_t bytes = size_ / sizeof(uint64_t) * sizeof(uint64_t) * cycles_;
+
+  auto start = std::chrono::system_clock::now();
+  bool success = compare_ramp(isa);
+  auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::system_clock::now() - start);
+  const float rate =
+      static_cast<float>(bytes) / static_cast<float>(duration.count());
+  std::cout << "success=" << success << "  " << rate << " GB/s" << std::endl;
+}
+
+uint64_t Benchmark::scan_component(bool prefetch) {
+  const size_t num_microslices =
+      scan_component_size_ /
+      (scan_microslice_size_ + sizeof(fles::MicrosliceDescriptor));
+  if (scan_data_.empty()) {
+    scan_data_.resize(num_microslices * (sizeof(fles::MicrosliceDescriptor) +
+                                         scan_microslice_size_));
+    auto* desc = reinterpret_cast<fles::MicrosliceDescriptor*>(
+        scan_data_.data());
+    for (size_t m = 0; m < num_microslices; ++m) {
+      desc[m] = fles::MicrosliceDescriptor();
+      desc[m].idx = m;
+      desc[m].size = static_cast<uint32_t>(scan_microslice_size_);
+      desc[m].offset = m * scan_microslice_size_;
+    }
+    uint8_t* content = scan_data_.data() +
+                       num_microslices * sizeof(fles::MicrosliceDescriptor);
+    for (size_t m = 0; m < num_microslices; ++m) {
+      const uint64_t header = m;
+      memcpy(content + m * scan_microslice_size_, &header, sizeof(header));
+    }
+  }
+  const fles::TimesliceComponentDescriptor tscdesc{0, 0, scan_data_.size(),
+                                                   num_microslices};
+  const fles::ComponentView component(scan_data_.data(), tscdesc);
+
+  // read the descriptor and the first word of the content, as a consumer
+  // would do to locate the data of interest
+  uint64_t sum = 0;
+  auto scan = [&sum](uint64_t /*m*/, const fles::MicrosliceRef& ms) {
+    uint64_t header = 0;
+    memcpy(&header, ms.content, sizeof(header));
+    sum += ms.desc.idx ^ header;
+  };
+  for (size_t i = 0; i < cycles_ / 50; ++i) {
+    if (prefetch) {
+      component.for_each(scan);
+    } else {
+      for (uint64_t m = 0; m < component.size(); ++m) {
+        scan(m, component[m]);
+      }
+    }
+  }
+  return sum;
+}
+
+void Benchmark::run_scan(bool prefetch) {
+  const size_t num_microslices =
+      scan_component_size_ /
+      (scan_microslice_size_ + sizeof(fles::MicrosliceDescriptor));
+  scan_component(prefetch); // warm up, creating the data on first use
+
+  auto start = std::chrono::system_clock::now();
+  const uint64_t sum = scan_component(prefetch);
+  auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::system_clock::now() - start);
+  const float ns_per_microslice =
+      static_cast<float>(duration.count()) /
+      static_cast<float>(num_microslices * (cycles_ / 50));
+  std::cout << "success=" << (sum == 0) << "  " << ns_per_microslice
+            << " ns/microslice" << std::endl;
+}
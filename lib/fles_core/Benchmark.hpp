@@ -1,6 +1,7 @@
 // Copyright 2015 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include "RampCompare.hpp"
 #include <cstddef>
 #include <cstdint>
 #include <vector>
@@ -21,14 +22,39 @@ public:
     Intrinsic64,
 #endif
     CrcUtil_C,
-    CrcUtil_I
+    CrcUtil_I,
+    Crc32c,
+    Crc32cBatch
   };
   uint32_t compute_crc32(Algorithm algorithm);
   void run_single(Algorithm algorithm);
 
+  enum class Checker { Flesnet, Flib };
+  /// Check generated microslices of the given pattern type, return success.
+  bool check_pattern(Checker checker);
+  void run_single(Checker checker);
+  /// Compare a ramp of size_ bytes using the given implementation.
+  bool compare_ramp(RampCompareIsa isa);
+  void run_single(RampCompareIsa isa);
+
+  /// Scan the descriptors and content headers of a large component, with
+  /// or without prefetching, return the checksum of the scanned words.
+  uint64_t scan_component(bool prefetch);
+  void run_scan(bool prefetch);
+
   const size_t size_ = 1048576;
   const size_t cycles_ = 500;
+  /// Buffer size for the batched algorithm (typical microslice size).
+  const size_t batch_buffer_size_ = 4096;
+  /// Microslice size for the pattern checker measurement.
+  const size_t pattern_microslice_size_ = 65536;
+  /// Size of the component for the iteration measurement (exceeding the
+  /// caches) and of its microslices.
+  const size_t scan_component_size_ = 268435456;
+  const size_t scan_microslice_size_ = 1024;
 
 private:
   std::vector<uint8_t> random_data_;
+  /// Component data for the iteration measurement (created on first use).
+  std::vector<uint8_t> scan_data_;
 };
@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "BufferCalibrator.hpp"
+#include "Utility.hpp"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+std::string BufferRecommendation::to_string() const {
+  std::ostringstream s;
+  s << "datasize=";
+  for (std::size_t i = 0; i < data_size_exps.size(); ++i) {
+    s << (i == 0 ? "" : ",") << data_size_exps[i];
+  }
+  s << "&descsize=" << desc_size_exp;
+  return s.str();
+}
+
+BufferCalibrator::BufferCalibrator(const CalibrationParameters& parameters,
+                                   std::size_t num_inputs,
+                                   clock::time_point now)
+    : parameters_(parameters), start_(now), first_item_(now),
+      last_item_(now), total_bytes_(num_inputs, 0),
+      peak_used_(num_inputs, 0) {}
+
+void BufferCalibrator::record_item(uint64_t id,
+                                   const std::vector<uint64_t>& bytes,
+                                   const std::vector<uint64_t>& used,
+                                   uint64_t items,
+                                   clock::time_point now) {
+  // the rates are taken over the intervals following the first item
+  if (num_items_ == 0) {
+    first_item_ = now;
+  } else {
+    for (std::size_t i = 0; i < total_bytes_.size() && i < bytes.size();
+         ++i) {
+      total_bytes_[i] += bytes[i];
+    }
+  }
+  last_item_ = now;
+  ++num_items_;
+  for (std::size_t i = 0; i < peak_used_.size() && i < used.size(); ++i) {
+    peak_used_[i] = std::max(peak_used_[i], used[i]);
+  }
+  peak_items_ = std::max(peak_items_, items);
+  pending_[id] = now;
+}
+
+void BufferCalibrator::record_completion(uint64_t id, clock::time_point now) {
+  auto it = pending_.find(id);
+  if (it == pending_.end()) {
+    return;
+  }
+  total_latency_ += std::chrono::duration<double>(now - it->second).count();
+  ++num_completions_;
+  pending_.erase(it);
+}
+
+double BufferCalibrator::span() const {
+  return std::chrono::duration<double>(last_item_ - first_item_).count();
+}
+
+double BufferCalibrator::data_rate(std::size_t input) const {
+  const double seconds = span();
+  return seconds > 0 ? static_cast<double>(total_bytes_.at(input)) / seconds
+                     : 0.0;
+}
+
+double BufferCalibrator::item_rate() const {
+  const double seconds = span();
+  return seconds > 0 ? static_cast<double>(num_items_ - 1) / seconds : 0.0;
+}
+
+double BufferCalibrator::mean_latency() const {
+  return num_completions_ > 0
+             ? total_latency_ / static_cast<double>(num_completions_)
+             : 0.0;
+}
+
+double BufferCalibrator::latency_fill_ratio(std::size_t input,
+                                            uint32_t data_size_exp) const {
+  const double fill_time = std::ldexp(1.0, static_cast<int>(data_size_exp)) /
+                           data_rate(input);
+  return std::isfinite(fill_time) ? mean_latency() / fill_time : 0.0;
+}
+
+uint32_t BufferCalibrator::size_exp(double size,
+                                    uint32_t min_exp,
+                                    uint32_t max_exp) {
+  uint32_t exp = min_exp;
+  while (exp < max_exp && std::ldexp(1.0, static_cast<int>(exp)) < size) {
+    ++exp;
+  }
+  return exp;
+}
+
+BufferRecommendation BufferCalibrator::recommend() const {
+  const double headroom =
+      std::chrono::duration<double>(parameters_.headroom).count();
+  BufferRecommendation recommendation;
+  for (std::size_t i = 0; i < total_bytes_.size(); ++i) {
+    const double size =
+        static_cast<double>(peak_used_[i]) + data_rate(i) * headroom;
+    recommendation.data_size_exps.push_back(size_exp(
+        size, parameters_.min_data_size_exp, parameters_.max_data_size_exp));
+  }
+  const double items =
+      2.0 * (static_cast<double>(peak_items_) + item_rate() * headroom);
+  recommendation.desc_size_exp = size_exp(
+      items, parameters_.min_desc_size_exp, parameters_.max_desc_size_exp);
+  return recommendation;
+}
+
+std::string BufferCalibrator::summary() const {
+  const auto recommendation = recommend();
+  std::ostringstream s;
+  s << num_items_ << " items at " << item_rate()
+    << "/s, mean consumer latency " << mean_latency() * 1000 << " ms";
+  for (std::size_t i = 0; i < total_bytes_.size(); ++i) {
+    const uint32_t exp = recommendation.data_size_exps[i];
+    s << "; input " << i << ": "
+      << human_readable_count(static_cast<uint64_t>(data_rate(i)), true)
+      << "/s, peak " << human_readable_count(peak_used_[i])
+      << ", latency/fill " << latency_fill_ratio(i, exp);
+  }
+  s << "; recommended " << recommendation.to_string();
+  return s.str();
+}
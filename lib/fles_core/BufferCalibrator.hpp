@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the BufferCalibrator class.
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/// Parameters of the calibration of the buffer sizes.
+struct CalibrationParameters {
+  /// Duration of the measurement (0: no calibration).
+  std::chrono::milliseconds duration{0};
+  /// Time the buffers should be able to absorb at the observed rates on top
+  /// of the data held by the consumers.
+  std::chrono::milliseconds headroom{2000};
+  /// Minimum 2's exponent of the recommended data buffer sizes.
+  uint32_t min_data_size_exp = 20;
+  /// Maximum 2's exponent of the recommended data buffer sizes.
+  uint32_t max_data_size_exp = 36;
+  /// Minimum 2's exponent of the recommended descriptor buffer size.
+  uint32_t min_desc_size_exp = 8;
+  /// Maximum 2's exponent of the recommended descriptor buffer size.
+  uint32_t max_desc_size_exp = 28;
+  /// File to write the recommended buffer parameters to, if not empty.
+  std::string output_file;
+
+  /// Check whether the buffer sizes are calibrated at all.
+  [[nodiscard]] bool enabled() const { return duration.count() > 0; }
+};
+
+/// Buffer sizes recommended by a BufferCalibrator.
+struct BufferRecommendation {
+  /// 2's exponents of the data buffer sizes per input in bytes.
+  std::vector<uint32_t> data_size_exps;
+  /// 2's exponent of the descriptor buffer size per input in units of
+  /// descriptors.
+  uint32_t desc_size_exp = 0;
+
+  /// Format as timeslice buffer parameters ("datasize=...&descsize=...").
+  [[nodiscard]] std::string to_string() const;
+};
+
+/**
+ * \brief Measurement of the data and descriptor rates of the inputs of a
+ * buffer and recommendation of its size exponents.
+ *
+ * For each item written to the buffer, the data size per input is recorded
+ * along with the space in use by the items not yet completed by the
+ * consumers; the consumer latency is measured from the write to the
+ * completion of each item. The recommended size of each buffer is the peak
+ * space in use plus the headroom at the observed mean rate, rounded up to
+ * the next power of two. As the work items of a timeslice buffer have to be
+ * completed within half of the descriptor buffer (see
+ * TimesliceBuffer::item_deadline_horizon()), the descriptor buffer is
+ * doubled.
+ */
+class BufferCalibrator {
+public:
+  using clock = std::chrono::steady_clock;
+
+  /// Start the measurement for a number of inputs.
+  BufferCalibrator(const CalibrationParameters& parameters,
+                   std::size_t num_inputs,
+                   clock::time_point now = clock::now());
+
+  /// Record an item written to the buffer.
+  /**
+   * \param id      ID of the item (e.g., the buffer position)
+   * \param bytes   Data size of the item per input
+   * \param used    Data buffer space in use per input, including the item
+   * \param items   Number of items in the buffer, including the item
+   */
+  void record_item(uint64_t id,
+                   const std::vector<uint64_t>& bytes,
+                   const std::vector<uint64_t>& used,
+                   uint64_t items,
+                   clock::time_point now = clock::now());
+
+  /// Record the completion of an item by the consumers.
+  void record_completion(uint64_t id, clock::time_point now = clock::now());
+
+  /// Check whether the measurement duration has passed.
+  [[nodiscard]] bool done(clock::time_point now = clock::now()) const {
+    return now - start_ >= parameters_.duration;
+  }
+
+  /// Retrieve the mean data rate (in bytes/s) of an input.
+  [[nodiscard]] double data_rate(std::size_t input) const;
+
+  /// Retrieve the mean item (descriptor) rate in 1/s.
+  [[nodiscard]] double item_rate() const;
+
+  /// Retrieve the mean consumer latency in seconds.
+  [[nodiscard]] double mean_latency() const;
+
+  /// Retrieve the ratio of the mean consumer latency to the time it takes
+  /// to fill the given data buffer of an input at its observed rate.
+  [[nodiscard]] double latency_fill_ratio(std::size_t input,
+                                          uint32_t data_size_exp) const;
+
+  /// Compute the recommended buffer sizes.
+  [[nodiscard]] BufferRecommendation recommend() const;
+
+  /// Describe the measured rates and the recommendation.
+  [[nodiscard]] std::string summary() const;
+
+private:
+  CalibrationParameters parameters_;
+  clock::time_point start_;
+  /// time of the first and the last item recorded
+  clock::time_point first_item_;
+  clock::time_point last_item_;
+  uint64_t num_items_ = 0;
+  /// total data size per input
+  std::vector<uint64_t> total_bytes_;
+  /// peak data buffer space in use per input
+  std::vector<uint64_t> peak_used_;
+  /// peak number of items in the buffer
+  uint64_t peak_items_ = 0;
+  /// write times of the items not yet completed
+  std::map<uint64_t, clock::time_point> pending_;
+  uint64_t num_completions_ = 0;
+  double total_latency_ = 0.0;
+
+  /// Time span of the recorded items in seconds.
+  [[nodiscard]] double span() const;
+
+  /// Smallest exponent within the limits giving at least the size.
+  [[nodiscard]] static uint32_t size_exp(double size,
+                                         uint32_t min_exp,
+                                         uint32_t max_exp);
+};
@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "BufferWarmer.hpp"
+#include "MemoryPolicy.hpp"
+#include "Utility.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <utility>
+
+BufferWarmer::BufferWarmer(std::string name,
+                           std::vector<Region> regions,
+                           unsigned threads,
+                           std::size_t chunk_size)
+    : name_(std::move(name)), regions_(std::move(regions)),
+      chunk_size_(chunk_size), begin_(std::chrono::steady_clock::now()) {
+  for (const auto& region : regions_) {
+    first_chunk_.push_back(num_chunks_);
+    num_chunks_ += (region.bytes + chunk_size_ - 1) / chunk_size_;
+  }
+  if (num_chunks_ == 0) {
+    return;
+  }
+  threads = static_cast<unsigned>(
+      std::clamp<std::size_t>(threads, 1, num_chunks_));
+  threads_running_.store(threads, std::memory_order_relaxed);
+  for (unsigned i = 0; i < threads; ++i) {
+    threads_.emplace_back(&BufferWarmer::run, this);
+  }
+}
+
+BufferWarmer::~BufferWarmer() { wait(); }
+
+void BufferWarmer::wait() {
+  for (auto& thread : threads_) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+}
+
+void BufferWarmer::run() {
+  std::size_t chunk = 0;
+  while (!failed_.load(std::memory_order_relaxed) &&
+         (chunk = next_chunk_.fetch_add(1, std::memory_order_relaxed)) <
+             num_chunks_) {
+    // find the region of the chunk
+    auto it = std::upper_bound(first_chunk_.begin(), first_chunk_.end(), chunk);
+    auto r = static_cast<std::size_t>(it - first_chunk_.begin()) - 1;
+    std::size_t offset = (chunk - first_chunk_[r]) * chunk_size_;
+    std::size_t bytes = std::min(chunk_size_, regions_[r].bytes - offset);
+    try {
+      prefault_memory(static_cast<uint8_t*>(regions_[r].ptr) + offset, bytes);
+    } catch (std::exception const& e) {
+      // the pages will be faulted in on first access instead
+      if (!failed_.exchange(true)) {
+        L_(warning) << "cannot warm " << name_ << ": " << e.what();
+      }
+    }
+  }
+  if (threads_running_.fetch_sub(1, std::memory_order_acq_rel) == 1 &&
+      !failed_.load(std::memory_order_relaxed)) {
+    std::size_t total = 0;
+    for (const auto& region : regions_) {
+      total += region.bytes;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - begin_);
+    L_(info) << "startup: " << name_ << " warmed ("
+             << human_readable_count(total) << ") in " << elapsed.count()
+             << " ms";
+  }
+}
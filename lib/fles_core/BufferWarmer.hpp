@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the BufferWarmer class.
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * \brief Populate large buffers chunk by chunk on background threads.
+ *
+ * A BufferWarmer object faults in the pages of a set of memory regions
+ * (see prefault_memory()) while the application proceeds, e.g., with
+ * setting up its connections. Memory registration for RDMA then finds the
+ * pages resident and only needs to pin them, instead of faulting in and
+ * zeroing gigabytes page by page while the peers wait. Accessing or
+ * registering the buffers while they are being warmed is safe.
+ *
+ * The memory policies of the regions must be applied before. The
+ * destructor waits for the threads to finish.
+ */
+class BufferWarmer {
+public:
+  /// A memory region to warm.
+  struct Region {
+    void* ptr;
+    std::size_t bytes;
+  };
+
+  /**
+   * \brief Start warming the given regions.
+   *
+   * \param name       Description of the buffers for the log
+   * \param regions    Memory regions to warm
+   * \param threads    Number of background threads
+   * \param chunk_size Granularity of the work distribution in bytes
+   */
+  BufferWarmer(std::string name,
+               std::vector<Region> regions,
+               unsigned threads = 2,
+               std::size_t chunk_size = std::size_t{64} << 20);
+
+  BufferWarmer(const BufferWarmer&) = delete;
+  void operator=(const BufferWarmer&) = delete;
+
+  /// The BufferWarmer destructor, waits for completion.
+  ~BufferWarmer();
+
+  /// Check whether all regions have been warmed.
+  [[nodiscard]] bool done() const {
+    return threads_running_.load(std::memory_order_acquire) == 0;
+  }
+
+  /// Block until all regions have been warmed.
+  void wait();
+
+private:
+  void run();
+
+  const std::string name_;
+  const std::vector<Region> regions_;
+  const std::size_t chunk_size_;
+
+  /// Offsets of the first chunk of each region in the chunk numbering.
+  std::vector<std::size_t> first_chunk_;
+  std::size_t num_chunks_ = 0;
+
+  std::atomic<std::size_t> next_chunk_{0};
+  std::atomic<unsigned> threads_running_{0};
+  std::atomic<bool> failed_{false};
+
+  std::chrono::steady_clock::time_point begin_;
+  std::vector<std::thread> threads_;
+};
@@ -4,6 +4,7 @@
 #include "log.hpp"
 #include <csignal>
 #include <cstring>
+#include <mutex>
 #include <sstream>
 #include <sys/wait.h>
 #include <vector>
@@ -25,7 +26,9 @@ public:
     return instance;
   }
 
-  bool start_process(ChildProcess child_process) {
+  // Start a process, optionally returning its pid
+  bool start_process(ChildProcess child_process, pid_t* started = nullptr) {
+    std::lock_guard<std::mutex> lock(mutex_);
     std::stringstream args;
     copy(child_process.arg.begin(), child_process.arg.end(),
          std::ostream_iterator<std::string>(args, " "));
@@ -58,6 +61,9 @@ public:
         child_process.pid = pid;
         child_process.status = Running;
         child_processes_.push_back(child_process);
+        if (started != nullptr) {
+          *started = pid;
+        }
         L_(debug) << "child process started";
         return true;
       }
@@ -76,6 +82,15 @@ public:
     return false;
   }
 
+  // Stop a process started before, given its pid
+  bool stop_process(pid_t pid) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::find_if(
+        child_processes_.begin(), child_processes_.end(),
+        [pid](const ChildProcess& cp) { return cp.pid == pid; });
+    return stop_process(it);
+  }
+
   void stop_processes(void* owner) {
     for (auto it = child_processes_.begin(); it < child_processes_.end();
          ++it) {
@@ -172,5 +187,8 @@ private:
 
   std::vector<ChildProcess> child_processes_;
 
+  // Serializes the starting and stopping from several threads
+  std::mutex mutex_;
+
   sigaction_struct oldact_ = sigaction_struct();
 };
@@ -0,0 +1,122 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "ConsumerCheckpoint.hpp"
+#include "Utility.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+ConsumerCheckpoint ConsumerCheckpoint::read(const std::string& filename) {
+  std::ifstream ifs(filename);
+  if (!ifs) {
+    throw std::ios_base::failure("error opening file \"" + filename + "\"");
+  }
+  ConsumerCheckpoint checkpoint;
+  bool has_index = false;
+  std::string line;
+  while (std::getline(ifs, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    const auto equal = line.find('=');
+    if (equal == std::string::npos) {
+      throw std::runtime_error("malformed checkpoint file \"" + filename +
+                               "\": " + line);
+    }
+    const std::string key = line.substr(0, equal);
+    const std::string value = line.substr(equal + 1);
+    try {
+      if (key == "input") {
+        checkpoint.input = value;
+      } else if (key == "index") {
+        checkpoint.index = std::stoull(value);
+        has_index = true;
+      } else if (key == "position") {
+        checkpoint.position = std::stoull(value);
+      } else if (key == "count") {
+        checkpoint.count = std::stoull(value);
+      }
+    } catch (const std::logic_error&) {
+      throw std::runtime_error("malformed checkpoint file \"" + filename +
+                               "\": " + line);
+    }
+  }
+  if (!has_index) {
+    throw std::runtime_error("malformed checkpoint file \"" + filename +
+                             "\": no index");
+  }
+  return checkpoint;
+}
+
+void ConsumerCheckpoint::write(const std::string& filename) const {
+  const std::string temporary = filename + ".tmp";
+  {
+    std::ofstream ofs(temporary, std::ios::trunc);
+    ofs << "input=" << input << "\n"
+        << "index=" << index << "\n"
+        << "position=" << position << "\n"
+        << "count=" << count << "\n";
+    ofs.flush();
+    if (!ofs) {
+      throw std::ios_base::failure("error writing file \"" + temporary +
+                                   "\"");
+    }
+  }
+  if (std::rename(temporary.c_str(), filename.c_str()) != 0) {
+    throw std::ios_base::failure("error renaming file \"" + temporary +
+                                 "\"");
+  }
+}
+
+std::string
+ConsumerCheckpoint::resume_locator(const std::string& locator) const {
+  std::string result;
+  for (const auto& part : split(locator, ";")) {
+    UriComponents uri{part};
+    if (!uri.scheme.empty() && uri.scheme != "file" && uri.scheme != "http") {
+      throw std::runtime_error("cannot resume input of scheme " +
+                               uri.scheme + ": " + part);
+    }
+    for (const auto* key : {"cache", "cycles", "mmap", "chunked"}) {
+      if (uri.query_components.count(key) != 0) {
+        throw std::runtime_error(std::string("cannot resume input with "
+                                             "query parameter ") +
+                                 key + ": " + part);
+      }
+    }
+    // Keep a given range, but start after the checkpoint
+    auto first = [this](const std::string& value) {
+      return std::to_string(std::max<uint64_t>(std::stoull(value), index + 1));
+    };
+    std::string query;
+    bool ranged = false;
+    for (const auto& [key, value] : uri.query_components) {
+      std::string item = key + "=" + value;
+      if (key == "start") {
+        item = key + "=" + first(value);
+        ranged = true;
+      } else if (key == "range") {
+        const auto bounds = split(value, "-");
+        if (bounds.size() != 2) {
+          throw std::runtime_error("invalid timeslice range: " + value);
+        }
+        item = key + "=" + first(bounds[0]) + "-" + bounds[1];
+        ranged = true;
+      }
+      query += (query.empty() ? "" : "&") + item;
+    }
+    if (!ranged) {
+      query += (query.empty() ? "start=" : "&start=") + first("0");
+    }
+    if (!result.empty()) {
+      result += ";";
+    }
+    if (!uri.scheme.empty()) {
+      result += uri.scheme + "://" + uri.authority;
+    }
+    result += uri.path + "?" + query;
+  }
+  return result;
+}
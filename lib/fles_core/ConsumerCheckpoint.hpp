@@ -0,0 +1,40 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the ConsumerCheckpoint class.
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/**
+ * \brief The ConsumerCheckpoint class describes the position of a timeslice
+ * consumer in its input, to resume processing after a restart.
+ *
+ * The checkpoint is stored as a small text file, which is replaced
+ * atomically on each update. On resume, the archive locators of the input
+ * are restricted to the timeslices following the checkpoint (see
+ * resume_locator()), so that the index-based archive reader seeks straight
+ * to the first of them using the index sidecar files.
+ */
+struct ConsumerCheckpoint {
+  /// Input locator of the consumer.
+  std::string input;
+  /// Index of the last processed timeslice.
+  uint64_t index = 0;
+  /// Number of timeslices read from the input so far.
+  uint64_t position = 0;
+  /// Number of timeslices processed so far.
+  uint64_t count = 0;
+
+  /// Read a checkpoint file. Throws std::runtime_error on malformed input.
+  static ConsumerCheckpoint read(const std::string& filename);
+
+  /// Write the checkpoint file atomically (through a temporary file).
+  void write(const std::string& filename) const;
+
+  /// Restrict the archive locators of an input (separated by ";") to the
+  /// timeslices following the checkpoint. Throws std::runtime_error for
+  /// inputs which cannot be resumed.
+  [[nodiscard]] std::string resume_locator(const std::string& locator) const;
+};
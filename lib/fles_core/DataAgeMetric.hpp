@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the DataAgeMetric class.
+#pragma once
+
+#include "EventTrace.hpp"
+#include "Monitor.hpp"
+#include <cstdint>
+#include <string>
+
+/**
+ * \brief Histogram of the age of the data at a stage of the data path.
+ *
+ * The age is the time from the start time of a timeslice, i.e. the index of
+ * its first microslice in ns since the epoch, to the time the timeslice
+ * passes the stage. Comparing the stages on the input and compute nodes
+ * requires synchronized clocks, and the values are only meaningful if the
+ * microslice indexes are start times.
+ *
+ * The histogram is reported to the monitor as the field
+ * "<stage>_age_ns" of the measurement "data_age". Without a monitor,
+ * recording is a no-op and does not read the clock.
+ */
+class DataAgeMetric {
+public:
+  DataAgeMetric() = default;
+
+  DataAgeMetric(cbm::Monitor* monitor,
+                const cbm::MetricTagSet& tagset,
+                const std::string& stage) {
+    if (monitor != nullptr) {
+      metric_ = monitor->RegisterHistogram("data_age", tagset,
+                                           stage + "_age_ns");
+      enabled_ = true;
+    }
+  }
+
+  /// Check whether values are recorded.
+  [[nodiscard]] bool enabled() const { return enabled_; }
+
+  /// Record the age of data with the given start time.
+  void record(uint64_t start_time_ns) const {
+    if (!enabled_) {
+      return;
+    }
+    const uint64_t now = EventTrace::now_ns();
+    metric_.Record(now > start_time_ns ? now - start_time_ns : 0);
+  }
+
+private:
+  cbm::MetricHistogram metric_;
+  bool enabled_ = false;
+};
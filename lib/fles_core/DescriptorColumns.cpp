@@ -0,0 +1,186 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "DescriptorColumns.hpp"
+#include "RampCompare.hpp"
+
+#if defined(__x86_64__)
+#define DESCRIPTOR_COLUMNS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+using DecodeFunction = void (*)(const fles::MicrosliceDescriptor*,
+                                std::size_t,
+                                uint64_t*,
+                                uint32_t*,
+                                uint16_t*,
+                                uint16_t*);
+
+void decode_scalar(const fles::MicrosliceDescriptor* desc,
+                   std::size_t count,
+                   uint64_t* idx,
+                   uint32_t* size,
+                   uint16_t* flags,
+                   uint16_t* eq_id) {
+  for (std::size_t i = 0; i < count; ++i) {
+    idx[i] = desc[i].idx;
+    size[i] = desc[i].size;
+    flags[i] = desc[i].flags;
+    eq_id[i] = desc[i].eq_id;
+  }
+}
+
+#ifdef DESCRIPTOR_COLUMNS_X86
+// Transpose four descriptors at a time. A descriptor consists of the 64-bit
+// words w0 (header, eq_id, flags, subsystem), w1 (idx), w2 (crc, size), and
+// w3 (offset), and fills one 256-bit vector.
+__attribute__((target("avx2"))) void
+decode_avx2(const fles::MicrosliceDescriptor* desc,
+            std::size_t count,
+            uint64_t* idx,
+            uint32_t* size,
+            uint16_t* flags,
+            uint16_t* eq_id) {
+  static_assert(sizeof(fles::MicrosliceDescriptor) == sizeof(__m256i));
+  const auto* in = reinterpret_cast<const __m256i*>(desc);
+
+  // per 128-bit lane (w0 of two descriptors): the eq_id and flags fields
+  const __m256i field_bytes = _mm256_setr_epi8(
+      2, 3, 10, 11, 4, 5, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, //
+      2, 3, 10, 11, 4, 5, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1);
+  const __m256i field_dwords = _mm256_setr_epi32(0, 4, 1, 5, 0, 0, 0, 0);
+  const __m256i size_dwords = _mm256_setr_epi32(1, 3, 5, 7, 0, 0, 0, 0);
+
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const __m256i d0 = _mm256_loadu_si256(in + i);
+    const __m256i d1 = _mm256_loadu_si256(in + i + 1);
+    const __m256i d2 = _mm256_loadu_si256(in + i + 2);
+    const __m256i d3 = _mm256_loadu_si256(in + i + 3);
+    // (w0, w0 | w2, w2) and (w1, w1 | w3, w3) of two descriptors each
+    const __m256i even01 = _mm256_unpacklo_epi64(d0, d1);
+    const __m256i odd01 = _mm256_unpackhi_epi64(d0, d1);
+    const __m256i even23 = _mm256_unpacklo_epi64(d2, d3);
+    const __m256i odd23 = _mm256_unpackhi_epi64(d2, d3);
+    const __m256i w0 = _mm256_permute2x128_si256(even01, even23, 0x20);
+    const __m256i w1 = _mm256_permute2x128_si256(odd01, odd23, 0x20);
+    const __m256i w2 = _mm256_permute2x128_si256(even01, even23, 0x31);
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(idx + i), w1);
+    const __m256i s = _mm256_permutevar8x32_epi32(w2, size_dwords);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(size + i),
+                     _mm256_castsi256_si128(s));
+    const __m128i f = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(
+        _mm256_shuffle_epi8(w0, field_bytes), field_dwords));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(eq_id + i), f);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(flags + i),
+                     _mm_unpackhi_epi64(f, f));
+  }
+  decode_scalar(desc + i, count - i, idx + i, size + i, flags + i, eq_id + i);
+}
+#endif
+
+DecodeFunction decode_function(DescriptorColumnsIsa isa) {
+  switch (isa) {
+#ifdef DESCRIPTOR_COLUMNS_X86
+  case DescriptorColumnsIsa::Avx2:
+    return decode_avx2;
+#endif
+  default:
+    return decode_scalar;
+  }
+}
+
+} // namespace
+
+std::vector<DescriptorColumnsIsa> descriptor_columns_supported_isas() {
+  static const std::vector<DescriptorColumnsIsa> isas = [] {
+    std::vector<DescriptorColumnsIsa> v{DescriptorColumnsIsa::Scalar};
+#ifdef DESCRIPTOR_COLUMNS_X86
+    if (__builtin_cpu_supports("avx2") != 0) {
+      v.push_back(DescriptorColumnsIsa::Avx2);
+    }
+#endif
+    return v;
+  }();
+  return isas;
+}
+
+const char* to_string(DescriptorColumnsIsa isa) {
+  switch (isa) {
+  case DescriptorColumnsIsa::Scalar:
+    return "scalar";
+  case DescriptorColumnsIsa::Avx2:
+    return "avx2";
+  }
+  return "unknown";
+}
+
+void DescriptorColumns::assign(const fles::MicrosliceDescriptor* desc,
+                               std::size_t count) {
+  static const DescriptorColumnsIsa isa =
+      descriptor_columns_supported_isas().back();
+  assign(isa, desc, count);
+}
+
+void DescriptorColumns::assign(DescriptorColumnsIsa isa,
+                               const fles::MicrosliceDescriptor* desc,
+                               std::size_t count) {
+  idx.resize(count);
+  size.resize(count);
+  flags.resize(count);
+  eq_id.resize(count);
+  decode_function(isa)(desc, count, idx.data(), size.data(), flags.data(),
+                       eq_id.data());
+}
+
+uint64_t DescriptorColumns::total_size() const {
+  uint64_t total = 0;
+  for (uint32_t s : size) {
+    total += s;
+  }
+  return total;
+}
+
+std::size_t DescriptorColumns::count_flags(uint16_t mask) const {
+  std::size_t n = 0;
+  for (uint16_t f : flags) {
+    n += (f & mask) != 0 ? 1 : 0;
+  }
+  return n;
+}
+
+std::size_t DescriptorColumns::first_non_increasing() const {
+  // test blocks without early exit, so that the comparisons vectorize
+  constexpr std::size_t block = 16;
+  const std::size_t n = count();
+  std::size_t i = 1;
+  for (; i + block <= n; i += block) {
+    bool failed = false;
+    for (std::size_t k = 0; k < block; ++k) {
+      failed |= idx[i + k] <= idx[i + k - 1];
+    }
+    if (failed) {
+      break;
+    }
+  }
+  for (; i < n; ++i) {
+    if (idx[i] <= idx[i - 1]) {
+      return i;
+    }
+  }
+  return n;
+}
+
+std::size_t DescriptorColumns::first_irregular(std::size_t begin,
+                                               uint64_t first,
+                                               uint64_t step) const {
+  if (begin >= count()) {
+    return count();
+  }
+  uint64_t word_xor = 0;
+  return begin + ramp_compare(idx.data() + begin, count() - begin,
+                              first + begin * step, step, word_xor);
+}
@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the DescriptorColumns class.
+#pragma once
+
+#include "MicrosliceDescriptor.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// Instruction set extensions for decoding descriptor columns.
+enum class DescriptorColumnsIsa { Scalar, Avx2 };
+
+/// Retrieve the descriptor decoders supported at run time.
+/** The list is ordered by preference, the decoder used by default is the
+    last entry. */
+std::vector<DescriptorColumnsIsa> descriptor_columns_supported_isas();
+
+/// Retrieve the name of a descriptor decoder.
+const char* to_string(DescriptorColumnsIsa isa);
+
+/**
+ * \brief The DescriptorColumns class holds the frequently evaluated fields
+ * of an array of microslice descriptors as separate columns.
+ *
+ * The packed 32-byte descriptors (array of structures) are decoded in bulk
+ * into one array per field (structure of arrays), so that statistics and
+ * selections reading a single field use every byte of a cache line and
+ * vectorize. The storage is reused when decoding the next component.
+ */
+class DescriptorColumns {
+public:
+  /// Microslice indices / start times.
+  std::vector<uint64_t> idx;
+  /// Content sizes.
+  std::vector<uint32_t> size;
+  /// Status and error flags.
+  std::vector<uint16_t> flags;
+  /// Equipment identifiers.
+  std::vector<uint16_t> eq_id;
+
+  /// Decode an array of descriptors using the default decoder.
+  void assign(const fles::MicrosliceDescriptor* desc, std::size_t count);
+
+  /// Decode an array of descriptors using a given decoder, which has to be
+  /// supported on this machine.
+  void assign(DescriptorColumnsIsa isa,
+              const fles::MicrosliceDescriptor* desc,
+              std::size_t count);
+
+  /// Retrieve the number of decoded descriptors.
+  [[nodiscard]] std::size_t count() const { return idx.size(); }
+
+  /// Retrieve the sum of the content sizes.
+  [[nodiscard]] uint64_t total_size() const;
+
+  /// Retrieve the number of descriptors with any of the given flags set.
+  [[nodiscard]] std::size_t count_flags(uint16_t mask) const;
+
+  /// Retrieve the position of the first index not greater than its
+  /// predecessor, or count() if the indices are strictly increasing.
+  [[nodiscard]] std::size_t first_non_increasing() const;
+
+  /// Retrieve the first position m >= begin with idx[m] != first + m * step,
+  /// or count() if the indices from begin on are equidistant.
+  [[nodiscard]] std::size_t
+  first_irregular(std::size_t begin, uint64_t first, uint64_t step) const;
+};
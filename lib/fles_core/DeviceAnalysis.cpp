@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "DeviceAnalysis.hpp"
+#include "crc32c_batch.h"
+#include <cstring>
+#include <vector>
+
+void analyze_components_host(const DeviceAnalysisComponent* components,
+                             std::size_t count,
+                             DeviceAnalysisResult* results) {
+  std::vector<crcutil_interface::CrcBuffer> buffers;
+  std::vector<uint32_t> crcs;
+  for (std::size_t i = 0; i < count; ++i) {
+    const DeviceAnalysisComponent& component = components[i];
+    DeviceAnalysisResult& result = results[i];
+    std::memset(&result, 0, sizeof(result));
+    const uint64_t n = component.num_microslices;
+    if (n == 0) {
+      continue;
+    }
+    const auto* descs =
+        reinterpret_cast<const fles::MicrosliceDescriptor*>(component.data);
+    const uint8_t* contents =
+        component.data + n * sizeof(fles::MicrosliceDescriptor);
+    result.eq_id = descs[0].eq_id;
+    result.sys_id = descs[0].sys_id;
+    result.sys_ver = descs[0].sys_ver;
+
+    // compute the CRCs of the component in one batch
+    buffers.resize(n);
+    crcs.resize(n);
+    for (uint64_t m = 0; m < n; ++m) {
+      const bool crc_valid =
+          (descs[m].flags &
+           static_cast<uint16_t>(fles::MicrosliceFlags::CrcValid)) != 0;
+      buffers[m] = {contents + (descs[m].offset - descs[0].offset),
+                    crc_valid ? descs[m].size : 0};
+    }
+    crcutil_interface::Crc32cBatch(buffers.data(), n, crcs.data());
+
+    for (uint64_t m = 0; m < n; ++m) {
+      const auto& desc = descs[m];
+      const uint32_t status = device_analysis_status(
+          desc, static_cast<const uint8_t*>(buffers[m].data),
+          component.component, crcs[m]);
+      ++result.microslices;
+      result.content_bytes += desc.size;
+      ++result.size_bins[device_analysis_size_bin(desc.size)];
+      result.crc_checked += (status & CrcChecked) != 0 ? 1 : 0;
+      result.crc_errors += (status & CrcError) != 0 ? 1 : 0;
+      result.pattern_checked += (status & PatternChecked) != 0 ? 1 : 0;
+      result.pattern_errors += (status & PatternError) != 0 ? 1 : 0;
+    }
+  }
+}
@@ -0,0 +1,160 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the batch analysis data and checks shared by the host and
+/// the GPU implementation (see DeviceTimesliceAnalyzer).
+#pragma once
+
+#include "MicrosliceDescriptor.hpp"
+#include <cstddef>
+#include <cstdint>
+
+#ifdef __CUDACC__
+#define DEVICE_ANALYSIS_FUNC __host__ __device__
+#else
+#define DEVICE_ANALYSIS_FUNC
+#endif
+
+/// Number of bins of the microslice size histograms (powers of two).
+constexpr unsigned device_analysis_size_bins = 32;
+
+/// A timeslice component of an analysis batch.
+struct DeviceAnalysisComponent {
+  /// The component data (descriptors followed by the contents), in the
+  /// memory of the analyzing device
+  const uint8_t* data;
+  /// Number of microslices of the component
+  uint64_t num_microslices;
+  /// Index of the first microslice of the component within the batch
+  uint64_t first_microslice;
+  /// Index of the component within its timeslice
+  uint32_t component;
+  uint32_t reserved;
+};
+
+/// The analysis result of a timeslice component.
+struct DeviceAnalysisResult {
+  uint64_t content_bytes;   ///< Total size of the microslice contents
+  uint32_t microslices;     ///< Number of microslices analyzed
+  uint32_t crc_checked;     ///< Microslices with a CRC-32C verified
+  uint32_t crc_errors;      ///< Microslices failing the CRC-32C check
+  uint32_t pattern_checked; ///< Microslices with a test pattern checked
+  uint32_t pattern_errors;  ///< Microslices failing the pattern check
+  uint16_t eq_id;           ///< Equipment identifier of the component
+  uint8_t sys_id;           ///< Subsystem identifier of the component
+  uint8_t sys_ver;          ///< Subsystem format version of the component
+  /// Microslice content sizes, bin i counting sizes of bit width i
+  uint32_t size_bins[device_analysis_size_bins];
+};
+
+/// Outcome of the checks of a microslice (bit mask).
+enum DeviceAnalysisStatus : uint32_t {
+  CrcChecked = 1,
+  CrcError = 2,
+  PatternChecked = 4,
+  PatternError = 8
+};
+
+/// Retrieve the histogram bin of a microslice content size.
+DEVICE_ANALYSIS_FUNC inline unsigned device_analysis_size_bin(uint32_t size) {
+  unsigned bin = 0;
+  while (size != 0 && bin < device_analysis_size_bins - 1) {
+    size >>= 1;
+    ++bin;
+  }
+  return bin;
+}
+
+/// Retrieve entry i of the byte-wise CRC-32C (Castagnoli) lookup table.
+DEVICE_ANALYSIS_FUNC inline uint32_t crc32c_table_entry(uint32_t i) {
+  uint32_t crc = i;
+  for (int bit = 0; bit < 8; ++bit) {
+    crc = (crc >> 1) ^ ((crc & 1U) != 0 ? 0x82f63b78U : 0U);
+  }
+  return crc;
+}
+
+/// Compute the CRC-32C of a buffer byte by byte using a lookup table of
+/// crc32c_table_entry() values (as crcutil_interface::Crc32c()).
+DEVICE_ANALYSIS_FUNC inline uint32_t
+crc32c_bytewise(const uint32_t* table, const uint8_t* data, uint64_t size) {
+  uint32_t crc = 0xffffffffU;
+  for (uint64_t i = 0; i < size; ++i) {
+    crc = table[(crc ^ data[i]) & 0xffU] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+/// Check the content of a microslice of the flesnet test pattern (see
+/// FlesnetPatternChecker).
+DEVICE_ANALYSIS_FUNC inline bool check_ramp_pattern(const uint8_t* content,
+                                                    uint32_t size,
+                                                    uint32_t component,
+                                                    uint32_t expected_crc) {
+  const auto* words = reinterpret_cast<const uint64_t*>(content);
+  const uint32_t count = size / sizeof(uint64_t);
+  const uint64_t start = static_cast<uint64_t>(component) << 48;
+  uint64_t word_xor = 0;
+  for (uint32_t i = 0; i < count; ++i) {
+    if (words[i] != (start | (static_cast<uint64_t>(i) * sizeof(uint64_t)))) {
+      return false;
+    }
+    word_xor ^= words[i];
+  }
+  const uint32_t crc = static_cast<uint32_t>(word_xor & 0xffffffffU) ^
+                       static_cast<uint32_t>(word_xor >> 32);
+  return crc == expected_crc;
+}
+
+/// Check a microslice, given the CRC-32C of its content.
+/**
+   The CRC is verified if the descriptor is flagged with a valid CRC, the
+   content is checked for the flesnet test pattern if the descriptor
+   identifies it.
+   \return the DeviceAnalysisStatus bit mask
+*/
+DEVICE_ANALYSIS_FUNC inline uint32_t
+device_analysis_status(const fles::MicrosliceDescriptor& desc,
+                       const uint8_t* content,
+                       uint32_t component,
+                       uint32_t crc) {
+  uint32_t status = 0;
+  if ((desc.flags & static_cast<uint16_t>(fles::MicrosliceFlags::CrcValid)) !=
+      0) {
+    status |= CrcChecked;
+    if (crc != desc.crc) {
+      status |= CrcError;
+    }
+  }
+  if (desc.sys_id == static_cast<uint8_t>(fles::Subsystem::FLES) &&
+      desc.sys_ver ==
+          static_cast<uint8_t>(fles::SubsystemFormatFLES::BasicRampPattern)) {
+    status |= PatternChecked;
+    if (!check_ramp_pattern(content, desc.size, component, desc.crc)) {
+      status |= PatternError;
+    }
+  }
+  return status;
+}
+
+/// Analyze a batch of timeslice components on the host.
+/**
+   The component data is in host memory. results[i] is overwritten with the
+   result of components[i].
+*/
+void analyze_components_host(const DeviceAnalysisComponent* components,
+                             std::size_t count,
+                             DeviceAnalysisResult* results);
+
+#ifdef HAVE_CUDA
+/// Analyze a batch of timeslice components on the current GPU device.
+/**
+   All pointers refer to device memory, results must be zeroed. The work is
+   enqueued asynchronously on the given CUDA stream (a cudaStream_t).
+*/
+void launch_device_analysis(const DeviceAnalysisComponent* components,
+                            std::size_t count,
+                            uint64_t num_microslices,
+                            DeviceAnalysisResult* results,
+                            void* stream);
+#endif
@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "DeviceAnalysis.hpp"
+#include <algorithm>
+#include <cuda_runtime_api.h>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+constexpr unsigned block_size = 256;
+
+/// Find the component of a microslice (components sorted by microslice).
+__device__ std::size_t find_component(const DeviceAnalysisComponent* components,
+                                      std::size_t count,
+                                      uint64_t microslice) {
+  std::size_t lo = 0;
+  std::size_t hi = count;
+  while (hi - lo > 1) {
+    const std::size_t mid = lo + (hi - lo) / 2;
+    if (components[mid].first_microslice <= microslice) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/// Check one microslice per thread and add it to its component result.
+__global__ void analyze_kernel(const DeviceAnalysisComponent* components,
+                               std::size_t count,
+                               uint64_t num_microslices,
+                               DeviceAnalysisResult* results) {
+  __shared__ uint32_t crc_table[256];
+  for (unsigned i = threadIdx.x; i < 256; i += blockDim.x) {
+    crc_table[i] = crc32c_table_entry(i);
+  }
+  __syncthreads();
+
+  for (uint64_t ms = blockIdx.x * static_cast<uint64_t>(blockDim.x) +
+                     threadIdx.x;
+       ms < num_microslices;
+       ms += static_cast<uint64_t>(gridDim.x) * blockDim.x) {
+    const std::size_t c = find_component(components, count, ms);
+    const DeviceAnalysisComponent& component = components[c];
+    DeviceAnalysisResult& result = results[c];
+    const uint64_t m = ms - component.first_microslice;
+
+    const auto* descs =
+        reinterpret_cast<const fles::MicrosliceDescriptor*>(component.data);
+    const fles::MicrosliceDescriptor& desc = descs[m];
+    const uint8_t* content =
+        component.data +
+        component.num_microslices * sizeof(fles::MicrosliceDescriptor) +
+        (desc.offset - descs[0].offset);
+
+    uint32_t crc = 0;
+    if ((desc.flags &
+         static_cast<uint16_t>(fles::MicrosliceFlags::CrcValid)) != 0) {
+      crc = crc32c_bytewise(crc_table, content, desc.size);
+    }
+    const uint32_t status =
+        device_analysis_status(desc, content, component.component, crc);
+
+    if (m == 0) {
+      result.eq_id = desc.eq_id;
+      result.sys_id = desc.sys_id;
+      result.sys_ver = desc.sys_ver;
+    }
+    atomicAdd(&result.microslices, 1U);
+    atomicAdd(reinterpret_cast<unsigned long long*>(&result.content_bytes),
+              static_cast<unsigned long long>(desc.size));
+    atomicAdd(&result.size_bins[device_analysis_size_bin(desc.size)], 1U);
+    if ((status & CrcChecked) != 0) {
+      atomicAdd(&result.crc_checked, 1U);
+    }
+    if ((status & CrcError) != 0) {
+      atomicAdd(&result.crc_errors, 1U);
+    }
+    if ((status & PatternChecked) != 0) {
+      atomicAdd(&result.pattern_checked, 1U);
+    }
+    if ((status & PatternError) != 0) {
+      atomicAdd(&result.pattern_errors, 1U);
+    }
+  }
+}
+
+} // namespace
+
+void launch_device_analysis(const DeviceAnalysisComponent* components,
+                            std::size_t count,
+                            uint64_t num_microslices,
+                            DeviceAnalysisResult* results,
+                            void* stream) {
+  if (count == 0 || num_microslices == 0) {
+    return;
+  }
+  constexpr uint64_t max_blocks = 65535;
+  const uint64_t blocks =
+      std::min((num_microslices + block_size - 1) / block_size, max_blocks);
+  analyze_kernel<<<static_cast<unsigned>(blocks), block_size, 0,
+                   static_cast<cudaStream_t>(stream)>>>(
+      components, count, num_microslices, results);
+  cudaError_t result = cudaGetLastError();
+  if (result != cudaSuccess) {
+    throw std::runtime_error(std::string("analysis kernel launch failed: ") +
+                             cudaGetErrorString(result));
+  }
+}
@@ -0,0 +1,402 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "DeviceTimesliceAnalyzer.hpp"
+#include "TimesliceView.hpp"
+#include "Utility.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#ifdef HAVE_CUDA
+#include <cuda_runtime_api.h>
+#endif
+
+namespace {
+
+/// Alignment of the component data in the staging buffers, preserving the
+/// alignment of the microslice contents
+constexpr std::size_t staging_alignment = 256;
+
+std::size_t align_up(std::size_t value, std::size_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+#ifdef HAVE_CUDA
+void check(cudaError_t result, const std::string& what) {
+  if (result != cudaSuccess) {
+    throw std::runtime_error(what + " failed: " + cudaGetErrorString(result));
+  }
+}
+#endif
+
+} // namespace
+
+/// A batch of timeslice components and its staging and result buffers.
+struct DeviceTimesliceAnalyzer::Batch {
+  explicit Batch(int device);
+  Batch(const Batch&) = delete;
+  void operator=(const Batch&) = delete;
+  ~Batch();
+
+  /// Provide staging buffers of at least the given size (batch empty).
+  void reserve_staging(std::size_t bytes);
+
+  /// Provide device table and result buffers for the given number of
+  /// components (batch not pending).
+  void reserve_table(std::size_t count);
+
+  /// Clear the batch for reuse.
+  void reset();
+
+  int device;
+  std::vector<DeviceAnalysisComponent> components;
+  /// Timeslice index of each component
+  std::vector<uint64_t> ts_indices;
+  /// Timeslices whose data is analyzed in place
+  std::vector<std::shared_ptr<const fles::Timeslice>> timeslices;
+  /// Results of the analysis on the host
+  std::vector<DeviceAnalysisResult> results;
+  std::size_t num_timeslices = 0;
+  uint64_t num_microslices = 0;
+  std::size_t staged_bytes = 0;
+  std::size_t staging_capacity = 0;
+  std::size_t table_capacity = 0;
+  /// Flag, true if the batch is being analyzed
+  bool pending = false;
+
+#ifdef HAVE_CUDA
+  uint8_t* host_staging = nullptr;
+  uint8_t* device_staging = nullptr;
+  DeviceAnalysisComponent* device_table = nullptr;
+  DeviceAnalysisResult* host_results = nullptr;
+  DeviceAnalysisResult* device_results = nullptr;
+  cudaStream_t stream = nullptr;
+  cudaEvent_t done = nullptr;
+#endif
+};
+
+DeviceTimesliceAnalyzer::Batch::Batch(int arg_device) : device(arg_device) {
+#ifdef HAVE_CUDA
+  if (device >= 0) {
+    check(cudaSetDevice(device), "cudaSetDevice");
+    check(cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking),
+          "cudaStreamCreate");
+    check(cudaEventCreateWithFlags(&done, cudaEventDisableTiming),
+          "cudaEventCreate");
+  }
+#endif
+}
+
+DeviceTimesliceAnalyzer::Batch::~Batch() {
+#ifdef HAVE_CUDA
+  if (device >= 0) {
+    cudaSetDevice(device);
+    if (stream != nullptr) {
+      cudaStreamSynchronize(stream);
+      cudaStreamDestroy(stream);
+    }
+    if (done != nullptr) {
+      cudaEventDestroy(done);
+    }
+    cudaFreeHost(host_staging);
+    cudaFree(device_staging);
+    cudaFree(device_table);
+    cudaFreeHost(host_results);
+    cudaFree(device_results);
+  }
+#endif
+}
+
+void DeviceTimesliceAnalyzer::Batch::reserve_staging(std::size_t bytes) {
+  if (bytes <= staging_capacity) {
+    return;
+  }
+#ifdef HAVE_CUDA
+  check(cudaSetDevice(device), "cudaSetDevice");
+  cudaFreeHost(host_staging);
+  cudaFree(device_staging);
+  host_staging = nullptr;
+  device_staging = nullptr;
+  staging_capacity = 0;
+  check(cudaMallocHost(reinterpret_cast<void**>(&host_staging), bytes),
+        "cudaMallocHost");
+  check(cudaMalloc(reinterpret_cast<void**>(&device_staging), bytes),
+        "cudaMalloc");
+  staging_capacity = bytes;
+#else
+  throw std::runtime_error("GPU analysis requested, but built without CUDA");
+#endif
+}
+
+void DeviceTimesliceAnalyzer::Batch::reserve_table(std::size_t count) {
+  if (count <= table_capacity) {
+    return;
+  }
+#ifdef HAVE_CUDA
+  const std::size_t capacity = std::max(count, 2 * table_capacity);
+  check(cudaSetDevice(device), "cudaSetDevice");
+  cudaFree(device_table);
+  cudaFreeHost(host_results);
+  cudaFree(device_results);
+  device_table = nullptr;
+  host_results = nullptr;
+  device_results = nullptr;
+  table_capacity = 0;
+  check(cudaMalloc(reinterpret_cast<void**>(&device_table),
+                   capacity * sizeof(DeviceAnalysisComponent)),
+        "cudaMalloc");
+  check(cudaMallocHost(reinterpret_cast<void**>(&host_results),
+                       capacity * sizeof(DeviceAnalysisResult)),
+        "cudaMallocHost");
+  check(cudaMalloc(reinterpret_cast<void**>(&device_results),
+                   capacity * sizeof(DeviceAnalysisResult)),
+        "cudaMalloc");
+  table_capacity = capacity;
+#else
+  throw std::runtime_error("GPU analysis requested, but built without CUDA");
+#endif
+}
+
+void DeviceTimesliceAnalyzer::Batch::reset() {
+  components.clear();
+  ts_indices.clear();
+  timeslices.clear();
+  results.clear();
+  num_timeslices = 0;
+  num_microslices = 0;
+  staged_bytes = 0;
+  pending = false;
+}
+
+DeviceTimesliceAnalyzer::DeviceTimesliceAnalyzer(const Parameters& parameters,
+                                                 std::ostream& out,
+                                                 std::string output_prefix,
+                                                 std::ostream* hist)
+    : parameters_(parameters), out_(out),
+      output_prefix_(std::move(output_prefix)), hist_(hist),
+      previous_output_time_(std::chrono::steady_clock::now()) {
+#ifndef HAVE_CUDA
+  if (parameters_.device >= 0) {
+    throw std::runtime_error("GPU analysis requested, but built without CUDA");
+  }
+#endif
+  if (parameters_.batch_timeslices == 0) {
+    parameters_.batch_timeslices = 1;
+  }
+  for (auto& batch : batches_) {
+    batch = std::make_unique<Batch>(parameters_.device);
+    if (parameters_.device >= 0) {
+      batch->reserve_staging(parameters_.staging_bytes);
+    }
+  }
+}
+
+DeviceTimesliceAnalyzer::~DeviceTimesliceAnalyzer() {
+  try {
+    flush();
+    if (statistics_.timeslices > 0) {
+      out_ << output_prefix_ << "* " << status() << std::endl;
+    }
+    print_histograms();
+  } catch (const std::exception& e) {
+    L_(error) << output_prefix_ << "device analysis failed: " << e.what();
+  }
+}
+
+void DeviceTimesliceAnalyzer::put(
+    std::shared_ptr<const fles::Timeslice> timeslice) {
+  const auto* view = dynamic_cast<const fles::TimesliceView*>(timeslice.get());
+  const int data_device = view != nullptr ? view->data_device() : -1;
+  if (data_device >= 0 && data_device != parameters_.device) {
+    throw std::runtime_error("timeslice data on GPU " +
+                             std::to_string(data_device) +
+                             " cannot be analyzed " +
+                             (parameters_.device < 0
+                                  ? std::string("on the host")
+                                  : "on GPU " +
+                                        std::to_string(parameters_.device)));
+  }
+  // host memory data is copied to the staging buffer of a GPU
+  const bool staged = data_device < 0 && parameters_.device >= 0;
+  auto skip = [&](uint64_t c) {
+    return timeslice->num_microslices(c) == 0 ||
+           (data_device < 0 && timeslice->content_omitted(c));
+  };
+
+  std::size_t bytes = 0;
+  if (staged) {
+    for (uint64_t c = 0; c < timeslice->num_components(); ++c) {
+      if (!skip(c)) {
+        bytes += align_up(timeslice->size_component(c), staging_alignment);
+      }
+    }
+  }
+  if (batches_[current_]->staged_bytes + bytes >
+      batches_[current_]->staging_capacity) {
+    if (batches_[current_]->num_timeslices > 0) {
+      submit();
+    }
+    batches_[current_]->reserve_staging(bytes);
+  }
+
+  Batch& batch = *batches_[current_];
+  for (uint64_t c = 0; c < timeslice->num_components(); ++c) {
+    if (skip(c)) {
+      continue;
+    }
+    const uint8_t* data = nullptr;
+    if (data_device >= 0) {
+      data = view->component_data(c);
+    } else {
+      data = reinterpret_cast<const uint8_t*>(&timeslice->descriptor(c, 0));
+    }
+#ifdef HAVE_CUDA
+    if (staged) {
+      const std::size_t size = timeslice->size_component(c);
+      std::copy_n(data, size, batch.host_staging + batch.staged_bytes);
+      data = batch.device_staging + batch.staged_bytes;
+      batch.staged_bytes += align_up(size, staging_alignment);
+    }
+#endif
+    const uint64_t n = timeslice->num_microslices(c);
+    batch.components.push_back(
+        {data, n, batch.num_microslices, static_cast<uint32_t>(c), 0});
+    batch.ts_indices.push_back(timeslice->index());
+    batch.num_microslices += n;
+  }
+  ++batch.num_timeslices;
+  if (!staged) {
+    batch.timeslices.push_back(std::move(timeslice));
+  }
+
+  if (batch.num_timeslices >= parameters_.batch_timeslices) {
+    submit();
+  }
+}
+
+void DeviceTimesliceAnalyzer::flush() {
+  submit();
+  // the batch submitted last is not current
+  for (std::size_t i : {current_, 1 - current_}) {
+    if (batches_[i]->pending) {
+      complete(*batches_[i]);
+    }
+  }
+}
+
+void DeviceTimesliceAnalyzer::submit() {
+  Batch& batch = *batches_[current_];
+  if (batch.num_timeslices == 0) {
+    return;
+  }
+  const std::size_t count = batch.components.size();
+  if (parameters_.device < 0) {
+    batch.results.resize(count);
+    analyze_components_host(batch.components.data(), count,
+                            batch.results.data());
+  } else {
+#ifdef HAVE_CUDA
+    batch.reserve_table(count);
+    check(cudaSetDevice(batch.device), "cudaSetDevice");
+    if (batch.staged_bytes > 0) {
+      check(cudaMemcpyAsync(batch.device_staging, batch.host_staging,
+                            batch.staged_bytes, cudaMemcpyHostToDevice,
+                            batch.stream),
+            "cudaMemcpyAsync");
+    }
+    if (count > 0) {
+      check(cudaMemcpyAsync(batch.device_table, batch.components.data(),
+                            count * sizeof(DeviceAnalysisComponent),
+                            cudaMemcpyHostToDevice, batch.stream),
+            "cudaMemcpyAsync");
+      check(cudaMemsetAsync(batch.device_results, 0,
+                            count * sizeof(DeviceAnalysisResult),
+                            batch.stream),
+            "cudaMemsetAsync");
+      launch_device_analysis(batch.device_table, count, batch.num_microslices,
+                             batch.device_results, batch.stream);
+      check(cudaMemcpyAsync(batch.host_results, batch.device_results,
+                            count * sizeof(DeviceAnalysisResult),
+                            cudaMemcpyDeviceToHost, batch.stream),
+            "cudaMemcpyAsync");
+    }
+    check(cudaEventRecord(batch.done, batch.stream), "cudaEventRecord");
+#endif
+  }
+  batch.pending = true;
+
+  current_ = 1 - current_;
+  if (batches_[current_]->pending) {
+    complete(*batches_[current_]);
+  }
+}
+
+void DeviceTimesliceAnalyzer::complete(Batch& batch) {
+  const DeviceAnalysisResult* results = batch.results.data();
+#ifdef HAVE_CUDA
+  if (parameters_.device >= 0) {
+    check(cudaEventSynchronize(batch.done), "cudaEventSynchronize");
+    results = batch.host_results;
+  }
+#endif
+  for (std::size_t i = 0; i < batch.components.size(); ++i) {
+    const DeviceAnalysisResult& result = results[i];
+    ++statistics_.components;
+    statistics_.microslices += result.microslices;
+    statistics_.content_bytes += result.content_bytes;
+    statistics_.crc_checked += result.crc_checked;
+    statistics_.crc_errors += result.crc_errors;
+    statistics_.pattern_checked += result.pattern_checked;
+    statistics_.pattern_errors += result.pattern_errors;
+    auto& histogram = statistics_.size_histograms[result.eq_id];
+    for (unsigned bin = 0; bin < device_analysis_size_bins; ++bin) {
+      histogram[bin] += result.size_bins[bin];
+    }
+    if (handler_) {
+      handler_(batch.ts_indices[i], batch.components[i].component, result);
+    }
+  }
+  statistics_.timeslices += batch.num_timeslices;
+  batch.reset();
+
+  auto now = std::chrono::steady_clock::now();
+  if (previous_output_time_ + output_time_interval_ <= now) {
+    out_ << output_prefix_ << "* " << status() << std::endl;
+    previous_output_time_ = now;
+  }
+}
+
+std::string DeviceTimesliceAnalyzer::status() const {
+  std::stringstream s;
+  s << "checked " << statistics_.timeslices << " ts, "
+    << statistics_.components << " c, " << statistics_.microslices << " m, "
+    << human_readable_count(statistics_.content_bytes, true) << " on "
+    << (parameters_.device < 0 ? std::string("host")
+                               : "GPU " + std::to_string(parameters_.device));
+  if (statistics_.crc_errors > 0 || statistics_.pattern_errors > 0) {
+    s << " [crc errors: " << statistics_.crc_errors << "/"
+      << statistics_.crc_checked
+      << ", pattern errors: " << statistics_.pattern_errors << "/"
+      << statistics_.pattern_checked << "m]";
+  }
+  return s.str();
+}
+
+void DeviceTimesliceAnalyzer::print_histograms() {
+  if (hist_ == nullptr) {
+    return;
+  }
+  // one line per eq_id: the counts of content sizes of bit width 0..31
+  for (const auto& [eq_id, histogram] : statistics_.size_histograms) {
+    *hist_ << eq_id;
+    for (auto count : histogram) {
+      *hist_ << " " << count;
+    }
+    *hist_ << "\n";
+  }
+  hist_->flush();
+}
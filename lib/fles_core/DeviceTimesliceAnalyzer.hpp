@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the DeviceTimesliceAnalyzer class.
+#pragma once
+
+#include "DeviceAnalysis.hpp"
+#include "Sink.hpp"
+#include "Timeslice.hpp"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+
+/**
+ * \brief The DeviceTimesliceAnalyzer class checks batches of timeslices on a
+ * GPU.
+ *
+ * The timeslices are collected in batches. Each batch is analyzed on the
+ * GPU while the next one is collected, so the calling thread only stages
+ * the data. For each microslice, the CRC-32C is verified (if flagged as
+ * valid), the flesnet test pattern is checked (if identified by the
+ * descriptor), and the content size is added to the size histogram of its
+ * eq_id. The results of a batch are processed when its buffers are reused
+ * or the analyzer is flushed.
+ *
+ * Component data in host memory is copied to pinned staging memory and
+ * transferred to the GPU. The data of a TimesliceView in the memory of the
+ * analyzing GPU (see TimesliceView::data_device()) is analyzed in place.
+ *
+ * With a device index of -1, the same checks are done on the host when a
+ * batch is complete, e.g. for builds without CUDA support.
+ */
+class DeviceTimesliceAnalyzer : public fles::TimesliceSink {
+public:
+  struct Parameters {
+    /// GPU device index (-1: analyze on the host)
+    int device = 0;
+    /// Maximum number of timeslices per batch
+    std::size_t batch_timeslices = 16;
+    /// Size of the staging buffers of host memory data per batch (grown if
+    /// a single timeslice does not fit)
+    std::size_t staging_bytes = std::size_t{256} << 20;
+  };
+
+  /// The accumulated analysis results.
+  struct Statistics {
+    uint64_t timeslices = 0;
+    uint64_t components = 0;
+    uint64_t microslices = 0;
+    uint64_t content_bytes = 0;
+    uint64_t crc_checked = 0;
+    uint64_t crc_errors = 0;
+    uint64_t pattern_checked = 0;
+    uint64_t pattern_errors = 0;
+    /// Microslice content size histograms by eq_id (see
+    /// DeviceAnalysisResult::size_bins)
+    std::map<uint16_t, std::array<uint64_t, device_analysis_size_bins>>
+        size_histograms;
+  };
+
+  /// Function called with the result of each analyzed component.
+  using ResultHandler = std::function<void(
+      uint64_t ts_index, uint32_t component, const DeviceAnalysisResult&)>;
+
+  /**
+     \param parameters    Device and batch parameters
+     \param out           Stream for the status output
+     \param output_prefix Prefix of the status output lines
+     \param hist          Stream for the final size histograms (or nullptr)
+     \throws std::runtime_error if a GPU device is requested and the library
+     has been built without CUDA support
+  */
+  DeviceTimesliceAnalyzer(const Parameters& parameters,
+                          std::ostream& out,
+                          std::string output_prefix,
+                          std::ostream* hist = nullptr);
+
+  /// Delete copy constructor (non-copyable).
+  DeviceTimesliceAnalyzer(const DeviceTimesliceAnalyzer&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const DeviceTimesliceAnalyzer&) = delete;
+
+  /// Analyze the remaining timeslices and print the final statistics.
+  ~DeviceTimesliceAnalyzer() override;
+
+  void put(std::shared_ptr<const fles::Timeslice> timeslice) override;
+
+  void end_stream() override { flush(); }
+
+  /// Analyze all collected timeslices and process their results.
+  void flush();
+
+  /// Set a function to be called with the result of each component. It is
+  /// called from put() or flush() once the batch has been analyzed.
+  void set_result_handler(ResultHandler handler) {
+    handler_ = std::move(handler);
+  }
+
+  /// Retrieve the results of the timeslices analyzed so far.
+  [[nodiscard]] const Statistics& statistics() const { return statistics_; }
+
+private:
+  struct Batch;
+
+  /// Start the analysis of the current batch and switch to the other one.
+  void submit();
+
+  /// Wait for the analysis of a batch and process its results.
+  void complete(Batch& batch);
+
+  [[nodiscard]] std::string status() const;
+
+  void print_histograms();
+
+  Parameters parameters_;
+  std::ostream& out_;
+  std::string output_prefix_;
+  std::ostream* hist_;
+
+  /// Double buffered batches: one is collected while the other is analyzed
+  std::array<std::unique_ptr<Batch>, 2> batches_;
+  std::size_t current_ = 0;
+
+  Statistics statistics_;
+  ResultHandler handler_;
+
+  std::chrono::steady_clock::time_point previous_output_time_;
+  static constexpr std::chrono::seconds output_time_interval_{1};
+};
@@ -3,6 +3,8 @@
 
 #include "MicrosliceDescriptor.hpp"
 #include "RingBufferView.hpp"
+#include <chrono>
+#include <thread>
 
 struct DualIndex {
   uint64_t desc;
@@ -62,6 +64,18 @@ inline bool operator==(const DualIndex& lhs, const DualIndex& rhs) {
   return lhs.desc == rhs.desc && lhs.data == rhs.data;
 }
 
+/// Check whether an index has reached a threshold in either component.
+/** A zero component of the threshold is ignored; a threshold of zero in
+    both components is always reached. */
+inline bool reaches_threshold(const DualIndex& index,
+                              const DualIndex& threshold) {
+  if (threshold.desc == 0 && threshold.data == 0) {
+    return true;
+  }
+  return (threshold.desc != 0 && index.desc >= threshold.desc) ||
+         (threshold.data != 0 && index.data >= threshold.data);
+}
+
 /// Abstract FLES data source class.
 template <typename T_DESC, typename T_DATA> class DualRingBufferReadInterface {
 public:
@@ -76,6 +90,38 @@ public:
   virtual void set_read_index(DualIndex new_read_index) = 0;
   virtual DualIndex get_read_index() = 0;
 
+  /// Check whether the reader may lose entries it has not yet released.
+  /** A lossy reader does not hold back the writer, e.g., a monitoring
+      reader sharing the buffers with a primary one. Entries before the
+      retained index (see get_retained_index()) may have been overwritten,
+      so the reader has to skip them and check its reads against it. */
+  virtual bool lossy() { return false; }
+
+  /// Retrieve the index of the oldest entry not yet released to the writer
+  /// (lossy readers only).
+  virtual DualIndex get_retained_index() { return get_read_index(); }
+
+  /// Block until the write index may differ from a known value, the end of
+  /// stream may have been reached, or the timeout expires.
+  /** Sources that can signal index updates wake the caller as soon as the
+      writer moves the index; the default implementation sleeps for the
+      timeout. */
+  virtual void wait_for_write_index(DualIndex /* known */,
+                                    std::chrono::milliseconds timeout) {
+    std::this_thread::sleep_for(timeout);
+  }
+
+  /// Retrieve the write index, preferably once it has reached a threshold.
+  /** The threshold is an absolute write index (see reaches_threshold()),
+      i.e., the caller asks to be served once enough descriptors or enough
+      data bytes are available for its next step. Sources that batch index
+      updates may hold the caller for a bounded time to let the threshold
+      be reached; the returned index may still fall short of it. The
+      default implementation returns get_write_index(). */
+  virtual DualIndex get_write_index_min(DualIndex /* threshold */) {
+    return get_write_index();
+  }
+
   virtual RingBufferView<T_DATA>& data_buffer() = 0;
   virtual RingBufferView<T_DESC>& desc_buffer() = 0;
 };
@@ -90,6 +136,14 @@ public:
 
   virtual void set_eof(bool eof) = 0;
 
+  /// Block until the read index may differ from a known value or the
+  /// timeout expires.
+  /** The default implementation sleeps for the timeout. */
+  virtual void wait_for_read_index(DualIndex /* known */,
+                                   std::chrono::milliseconds timeout) {
+    std::this_thread::sleep_for(timeout);
+  }
+
   virtual RingBufferView<T_DATA>& data_buffer() = 0;
   virtual RingBufferView<T_DESC>& desc_buffer() = 0;
 };
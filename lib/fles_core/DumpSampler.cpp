@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "DumpSampler.hpp"
+#include <algorithm>
+#include <utility>
+
+DumpSampler::DumpSampler(const DumpSampling& sampling)
+    : sampling_(sampling), item_tokens_(std::max(sampling.rate, 1.0)),
+      byte_tokens_(static_cast<double>(sampling.bytes_per_second)),
+      last_refill_(clock::now()) {
+  if (sampling_.every == 0) {
+    sampling_.every = 1;
+  }
+}
+
+bool DumpSampler::sample(uint64_t bytes, clock::time_point now) {
+  // refill the token buckets up to one second's worth
+  const double elapsed =
+      std::chrono::duration<double>(now - last_refill_).count();
+  if (elapsed > 0.0) {
+    last_refill_ = now;
+    if (sampling_.rate > 0.0) {
+      item_tokens_ = std::min(item_tokens_ + elapsed * sampling_.rate,
+                              std::max(sampling_.rate, 1.0));
+    }
+    if (sampling_.bytes_per_second > 0) {
+      const auto budget = static_cast<double>(sampling_.bytes_per_second);
+      byte_tokens_ = std::min(byte_tokens_ + elapsed * budget, budget);
+    }
+  }
+
+  const bool selected =
+      count_++ % sampling_.every == 0 &&
+      (sampling_.rate <= 0.0 || item_tokens_ >= 1.0) &&
+      (sampling_.bytes_per_second == 0 || byte_tokens_ > 0.0);
+  if (!selected) {
+    ++skipped_;
+    return false;
+  }
+  if (sampling_.rate > 0.0) {
+    item_tokens_ -= 1.0;
+  }
+  if (sampling_.bytes_per_second > 0) {
+    byte_tokens_ -= static_cast<double>(bytes);
+  }
+  ++sampled_;
+  return true;
+}
+
+DumpWriter::DumpWriter(std::ostream& out, std::size_t capacity)
+    : out_(out), capacity_(capacity == 0 ? 1 : capacity) {
+  thread_ = std::thread(&DumpWriter::work, this);
+}
+
+DumpWriter::~DumpWriter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  not_empty_.notify_one();
+  thread_.join();
+}
+
+bool DumpWriter::submit(Job job) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queue_.size() >= capacity_) {
+      ++dropped_;
+      return false;
+    }
+    queue_.push_back(std::move(job));
+  }
+  not_empty_.notify_one();
+  return true;
+}
+
+uint64_t DumpWriter::dropped() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return dropped_;
+}
+
+void DumpWriter::work() {
+  std::string text;
+  for (;;) {
+    Job job;
+    bool last_queued = false;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      not_empty_.wait(lock, [this] { return stopped_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        break;
+      }
+      job = std::move(queue_.front());
+      queue_.pop_front();
+      last_queued = queue_.empty();
+    }
+    text.clear();
+    job(text);
+    out_.write(text.data(), static_cast<std::streamsize>(text.size()));
+    if (last_queued) {
+      out_.flush();
+    }
+  }
+}
@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the DumpSampler and DumpWriter classes.
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+/// Selection of the items dumped by a debug dumper (see DumpSampler).
+struct DumpSampling {
+  /// Dump only every Nth item
+  uint64_t every = 1;
+  /// Maximum number of items dumped per second (0: unlimited)
+  double rate = 0.0;
+  /// Maximum number of dump output bytes per second (0: unlimited)
+  uint64_t bytes_per_second = 0;
+
+  /// Check whether items are sampled (instead of dumping all of them).
+  [[nodiscard]] bool enabled() const {
+    return every > 1 || rate > 0.0 || bytes_per_second > 0;
+  }
+};
+
+/**
+ * \brief Decides which items a debug dumper outputs.
+ *
+ * An item is selected if it is the Nth one since the last selection, and
+ * both the item rate and the output byte budget permit it. The rate and
+ * the budget are token buckets filled continuously up to one second's
+ * worth. A single item may overdraw the byte budget, which then delays the
+ * following ones, so that the average output rate stays within the budget
+ * even for items larger than it.
+ */
+class DumpSampler {
+public:
+  using clock = std::chrono::steady_clock;
+
+  explicit DumpSampler(const DumpSampling& sampling);
+
+  /// Decide whether to dump the next item.
+  /**
+     \param bytes Estimated size of the dump output of the item
+     \param now   Current time
+  */
+  bool sample(uint64_t bytes, clock::time_point now = clock::now());
+
+  /// The number of items selected.
+  [[nodiscard]] uint64_t sampled() const { return sampled_; }
+
+  /// The number of items not selected.
+  [[nodiscard]] uint64_t skipped() const { return skipped_; }
+
+private:
+  DumpSampling sampling_;
+  uint64_t count_ = 0;
+  double item_tokens_ = 0.0;
+  double byte_tokens_ = 0.0;
+  clock::time_point last_refill_;
+  uint64_t sampled_ = 0;
+  uint64_t skipped_ = 0;
+};
+
+/**
+ * \brief Formats and writes debug dumps on a background thread.
+ *
+ * Each job appends the dump of one item to a string, which is then written
+ * to the output stream as a whole. If the given number of jobs is already
+ * queued, further jobs are discarded, so that a slow output stream does not
+ * hold up the caller. The queued jobs are completed on destruction.
+ */
+class DumpWriter {
+public:
+  using Job = std::function<void(std::string&)>;
+
+  DumpWriter(std::ostream& out, std::size_t capacity);
+
+  /// Delete copy constructor (non-copyable).
+  DumpWriter(const DumpWriter&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const DumpWriter&) = delete;
+
+  ~DumpWriter();
+
+  /// Queue a job, or discard it if the queue is full.
+  /** \return true if the job has been queued */
+  bool submit(Job job);
+
+  /// The number of jobs discarded.
+  [[nodiscard]] uint64_t dropped() const;
+
+private:
+  void work();
+
+  std::ostream& out_;
+  std::size_t capacity_;
+  mutable std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::deque<Job> queue_;
+  bool stopped_ = false;
+  uint64_t dropped_ = 0;
+  std::thread thread_;
+};
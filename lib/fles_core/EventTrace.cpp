@@ -0,0 +1,288 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "EventTrace.hpp"
+#include "System.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+std::atomic<bool> EventTrace::enabled_{false};
+
+namespace {
+
+// The ring of one recording thread. Rings are never freed, so the events of
+// threads that have ended remain available.
+struct ThreadRing {
+  ThreadRing(uint32_t arg_index, std::size_t size)
+      : index(arg_index), events(size), mask(size - 1) {}
+
+  uint32_t index;
+  std::string name;
+  std::vector<TraceEvent> events;
+  uint64_t mask;
+  std::atomic<uint64_t> head{0}; // number of recorded events
+  uint64_t written = 0;          // continuous mode: number of written events
+};
+
+std::mutex rings_mutex;
+std::vector<std::unique_ptr<ThreadRing>> rings;
+std::size_t ring_size = 65536;
+uint64_t threads_version = 0; // incremented on each thread or name change
+std::atomic<uint64_t> generation{0}; // incremented on each reset
+thread_local ThreadRing* thread_ring = nullptr;
+thread_local uint64_t thread_generation = 0;
+
+std::atomic<uint64_t> lost{0};
+
+std::mutex writer_mutex;
+std::condition_variable writer_cv;
+bool writer_stop = false;
+std::thread writer_thread;
+
+volatile std::sig_atomic_t dump_requested = 0;
+
+extern "C" void dump_signal_handler(int /*sig*/) { dump_requested = 1; }
+
+ThreadRing& attach_thread() {
+  std::lock_guard<std::mutex> lock(rings_mutex);
+  rings.push_back(std::make_unique<ThreadRing>(
+      static_cast<uint32_t>(rings.size()), ring_size));
+  ++threads_version;
+  thread_ring = rings.back().get();
+  thread_generation = generation.load(std::memory_order_relaxed);
+  return *thread_ring;
+}
+
+ThreadRing& current_ring() {
+  if (thread_ring != nullptr &&
+      thread_generation == generation.load(std::memory_order_relaxed)) {
+    return *thread_ring;
+  }
+  return attach_thread();
+}
+
+// Append the events [from, head) of a ring to out and return head. Events
+// that are overwritten by the recording thread meanwhile are skipped.
+uint64_t copy_events(const ThreadRing& ring,
+                     uint64_t from,
+                     std::vector<TraceEvent>& out) {
+  const uint64_t size = ring.events.size();
+  const uint64_t head = ring.head.load(std::memory_order_acquire);
+  from = std::max(from, head > size ? head - size : 0);
+  const std::size_t start = out.size();
+  for (uint64_t i = from; i < head; ++i) {
+    out.push_back(ring.events[i & ring.mask]);
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  // the slot of event n is reused by event n + size, which may be partially
+  // written already
+  const uint64_t head_after = ring.head.load(std::memory_order_relaxed);
+  if (head_after + 1 > from + size) {
+    const uint64_t valid_from = std::min(head_after + 1 - size, head);
+    out.erase(out.begin() + static_cast<std::ptrdiff_t>(start),
+              out.begin() + static_cast<std::ptrdiff_t>(start + valid_from -
+                                                        from));
+  }
+  return head;
+}
+
+void write_chunk(std::ofstream& ofs,
+                 TraceChunkHeader::Kind kind,
+                 const void* data,
+                 std::size_t count,
+                 std::size_t entry_size) {
+  if (count == 0) {
+    return;
+  }
+  TraceChunkHeader chunk;
+  chunk.kind = kind;
+  chunk.count = static_cast<uint32_t>(count);
+  ofs.write(reinterpret_cast<const char*>(&chunk), sizeof(chunk));
+  ofs.write(static_cast<const char*>(data),
+            static_cast<std::streamsize>(count * entry_size));
+}
+
+void write_file_header(std::ofstream& ofs) {
+  TraceFileHeader header;
+  header.pid = static_cast<uint32_t>(getpid());
+  std::string host = fles::system::current_hostname();
+  std::strncpy(header.host, host.c_str(), sizeof(header.host) - 1);
+  ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+// Write the thread list (caller holds rings_mutex)
+void write_threads(std::ofstream& ofs) {
+  std::vector<TraceThreadInfo> threads(rings.size());
+  for (std::size_t i = 0; i < rings.size(); ++i) {
+    threads[i].index = rings[i]->index;
+    std::strncpy(threads[i].name, rings[i]->name.c_str(),
+                 sizeof(threads[i].name) - 1);
+  }
+  write_chunk(ofs, TraceChunkHeader::Threads, threads.data(), threads.size(),
+              sizeof(TraceThreadInfo));
+}
+
+// Append all events not yet written to a continuous trace file
+void write_new_events(std::ofstream& ofs, uint64_t& written_version) {
+  std::vector<TraceEvent> events;
+  std::lock_guard<std::mutex> lock(rings_mutex);
+  if (written_version != threads_version) {
+    write_threads(ofs);
+    written_version = threads_version;
+  }
+  for (auto& ring : rings) {
+    const uint64_t from = ring->written;
+    const std::size_t before = events.size();
+    ring->written = copy_events(*ring, from, events);
+    lost += (ring->written - from) - (events.size() - before);
+  }
+  write_chunk(ofs, TraceChunkHeader::Events, events.data(), events.size(),
+              sizeof(TraceEvent));
+  ofs.flush();
+}
+
+void run_writer(std::string filename, bool continuous) {
+  std::ofstream ofs;
+  uint64_t written_version = 0;
+  if (continuous) {
+    ofs.open(filename, std::ios::binary | std::ios::trunc);
+    write_file_header(ofs);
+  }
+  std::unique_lock<std::mutex> lock(writer_mutex);
+  while (!writer_stop) {
+    writer_cv.wait_for(lock, std::chrono::milliseconds(100));
+    lock.unlock();
+    if (continuous) {
+      write_new_events(ofs, written_version);
+    } else if (dump_requested != 0) {
+      dump_requested = 0;
+      EventTrace::dump(filename);
+      L_(info) << "event trace written to " << filename;
+    }
+    lock.lock();
+  }
+  lock.unlock();
+  if (continuous) {
+    write_new_events(ofs, written_version);
+  } else {
+    EventTrace::dump(filename);
+  }
+}
+
+} // namespace
+
+const char* trace_event_name(TraceEventType type) {
+  static const std::array<const char*,
+                          static_cast<std::size_t>(TraceEventType::Count)>
+      names{"timeslice_posted", "write_completed", "ack_received",
+            "work_item_sent", "completion_received"};
+  auto index = static_cast<std::size_t>(type);
+  return index < names.size() ? names[index] : "unknown";
+}
+
+void EventTrace::enable(std::size_t events_per_thread) {
+  if (events_per_thread == 0 ||
+      (events_per_thread & (events_per_thread - 1)) != 0) {
+    throw std::invalid_argument(
+        "event trace ring size must be a power of two");
+  }
+  {
+    std::lock_guard<std::mutex> lock(rings_mutex);
+    ring_size = events_per_thread;
+  }
+  enabled_.store(true, std::memory_order_relaxed);
+}
+
+void EventTrace::record_event(TraceEventType type, uint64_t id, uint64_t arg) {
+  ThreadRing& ring = current_ring();
+  const uint64_t head = ring.head.load(std::memory_order_relaxed);
+  TraceEvent& event = ring.events[head & ring.mask];
+  event.time_ns = now_ns();
+  event.id = id;
+  event.arg = arg;
+  event.type = static_cast<uint16_t>(type);
+  event.reserved = 0;
+  event.thread = ring.index;
+  ring.head.store(head + 1, std::memory_order_release);
+}
+
+void EventTrace::set_thread_name(const std::string& name) {
+  if (!enabled()) {
+    return;
+  }
+  ThreadRing& ring = current_ring();
+  std::lock_guard<std::mutex> lock(rings_mutex);
+  ring.name = name;
+  ++threads_version;
+}
+
+void EventTrace::dump(const std::string& filename) {
+  std::ofstream ofs(filename, std::ios::binary | std::ios::trunc);
+  if (!ofs) {
+    throw std::runtime_error("cannot open trace file " + filename);
+  }
+  write_file_header(ofs);
+  std::vector<TraceEvent> events;
+  std::lock_guard<std::mutex> lock(rings_mutex);
+  write_threads(ofs);
+  for (auto& ring : rings) {
+    copy_events(*ring, 0, events);
+  }
+  write_chunk(ofs, TraceChunkHeader::Events, events.data(), events.size(),
+              sizeof(TraceEvent));
+}
+
+void EventTrace::collect(std::vector<TraceEvent>& events) {
+  std::lock_guard<std::mutex> lock(rings_mutex);
+  for (auto& ring : rings) {
+    copy_events(*ring, 0, events);
+  }
+}
+
+void EventTrace::reset() {
+  std::lock_guard<std::mutex> lock(rings_mutex);
+  rings.clear();
+  generation.fetch_add(1, std::memory_order_relaxed);
+  ++threads_version;
+  lost = 0;
+}
+
+void EventTrace::start_writer(const std::string& filename, bool continuous) {
+  if (writer_thread.joinable()) {
+    throw std::logic_error("event trace writer already running");
+  }
+  if (!continuous) {
+    std::signal(SIGUSR2, dump_signal_handler);
+  }
+  writer_stop = false;
+  writer_thread = std::thread(run_writer, filename, continuous);
+}
+
+void EventTrace::stop_writer() {
+  if (!writer_thread.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    writer_stop = true;
+  }
+  writer_cv.notify_one();
+  writer_thread.join();
+  if (lost_events() > 0) {
+    L_(warning) << "event trace: " << lost_events() << " events lost";
+  }
+}
+
+uint64_t EventTrace::lost_events() { return lost.load(); }
@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the EventTrace class and the binary trace file format.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+/**
+ * \brief Types of events in the timeslice building data path.
+ *
+ * The input side events carry the timeslice index as id and the compute
+ * node index as arg, except for AckReceived, which carries the
+ * acknowledged descriptor position of the compute node buffer as id. The
+ * timeslice buffer events carry the buffer position as id and, for
+ * WorkItemSent, the timeslice index as arg.
+ */
+enum class TraceEventType : uint16_t {
+  TimeslicePosted,    ///< Input: component transfer posted
+  WriteCompleted,     ///< Input: component transfer completed
+  AckReceived,        ///< Input: acknowledgment received from compute node
+  WorkItemSent,       ///< Buffer: work item sent to the consumers
+  CompletionReceived, ///< Buffer: completion received from the consumers
+  Count               ///< Number of event types
+};
+
+/// Retrieve the name of an event type, e.g. "timeslice_posted".
+const char* trace_event_name(TraceEventType type);
+
+/// A fixed-size binary trace event.
+struct TraceEvent {
+  uint64_t time_ns; ///< Wall clock time in ns since the epoch
+  uint64_t id;      ///< Timeslice index
+  uint64_t arg;     ///< Event specific argument
+  uint16_t type;    ///< The TraceEventType
+  uint16_t reserved;
+  uint32_t thread; ///< Index of the recording thread
+};
+static_assert(sizeof(TraceEvent) == 32, "unexpected TraceEvent size");
+
+/// Header of a trace file.
+struct TraceFileHeader {
+  static constexpr uint64_t magic_value = 0x3143525453454c46; // "FLESTRC1"
+
+  uint64_t magic = magic_value;
+  uint32_t pid = 0;
+  uint32_t reserved = 0;
+  char host[64] = {};
+};
+
+/// Header of a chunk of TraceThreadInfo or TraceEvent entries.
+struct TraceChunkHeader {
+  enum Kind : uint32_t { Threads = 1, Events = 2 };
+
+  uint32_t kind = Events;
+  uint32_t count = 0; ///< Number of entries following
+};
+
+/// Description of a recording thread.
+struct TraceThreadInfo {
+  uint32_t index = 0;
+  char name[28] = {};
+};
+
+/**
+ * \brief Low-overhead recorder of binary events into per-thread rings.
+ *
+ * Each thread records into a ring buffer of its own without
+ * synchronization, so the most recent events of every thread are always
+ * available. The rings are written to a trace file either on request
+ * (dump(), or a signal) or continuously by a background thread. A trace
+ * file consists of a TraceFileHeader followed by chunks of TraceThreadInfo
+ * and TraceEvent entries. The trace2json tool converts the trace files of
+ * several nodes to the Chrome/Perfetto trace format.
+ *
+ * Recording is a no-op until enable() has been called.
+ */
+class EventTrace {
+public:
+  /// Enable recording, with the given number of events per thread ring.
+  static void enable(std::size_t events_per_thread = 65536);
+
+  /// Return true if recording is enabled.
+  static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  /// Record an event in the calling thread's ring.
+  static void record(TraceEventType type, uint64_t id, uint64_t arg = 0) {
+    if (!enabled()) {
+      return;
+    }
+    record_event(type, id, arg);
+  }
+
+  /// Name the calling thread in the trace.
+  static void set_thread_name(const std::string& name);
+
+  /// Write the current contents of all rings to a trace file.
+  static void dump(const std::string& filename);
+
+  /// Append the current contents of all rings to events.
+  static void collect(std::vector<TraceEvent>& events);
+
+  /**
+   * \brief Discard all recorded events and thread rings.
+   *
+   * Must not be called while other threads record events or the writer is
+   * running.
+   */
+  static void reset();
+
+  /**
+   * \brief Start writing the trace to a file in the background.
+   *
+   * If continuous, all events are appended to the file as they are
+   * recorded (events overwritten before being written are counted as
+   * lost). Otherwise, the rings are dumped whenever the process receives
+   * SIGUSR2, and at stop_writer().
+   */
+  static void start_writer(const std::string& filename, bool continuous);
+
+  /// Stop the background writer and write the remaining events.
+  static void stop_writer();
+
+  /// Retrieve the number of events lost in continuous mode.
+  static uint64_t lost_events();
+
+  /// Retrieve the current wall clock time in ns since the epoch.
+  static uint64_t now_ns() {
+    struct timespec ts {};
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000 +
+           static_cast<uint64_t>(ts.tv_nsec);
+  }
+
+private:
+  static void record_event(TraceEventType type, uint64_t id, uint64_t arg);
+
+  static std::atomic<bool> enabled_;
+};
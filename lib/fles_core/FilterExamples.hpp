@@ -1,11 +1,16 @@
 // Copyright 2016 Jan de Cuveland <cmail@cuveland.de>
 /// \file
-/// \brief Example microslice stream filters based on fles::Filter.
+/// \brief Example microslice stream filters based on fles::Filter and the
+/// corresponding fles::StaticStage implementations.
 #pragma once
 
 #include "Filter.hpp"
 #include "Microslice.hpp"
+#include "StaticPipeline.hpp"
 #include "StorableMicroslice.hpp"
+#include <memory>
+#include <utility>
+#include <vector>
 
 namespace fles {
 
@@ -24,19 +29,61 @@ public:
       return std::make_pair(std::unique_ptr<StorableMicroslice>(nullptr),
                             false);
     }
-    auto m = new StorableMicroslice(*item);
+    std::unique_ptr<StorableMicroslice> m(new StorableMicroslice(*item));
+    apply(*m);
+    return std::make_pair(std::move(m), false);
+  }
 
-    // Modify microslice descriptor
-    m->desc().sys_id = sys_id_;
-    m->desc().sys_ver = sys_ver_;
+  /// Modify the microslice descriptor.
+  void apply(StorableMicroslice& m) const {
+    m.desc().sys_id = sys_id_;
+    m.desc().sys_ver = sys_ver_;
+  }
+};
+
+/// Pipeline stage overriding the system ID, see DescriptorOverrideFilter.
+/** Stored microslices are modified in place, all other microslices are
+    copied once. */
+class DescriptorOverrideStage
+    : public StaticStage<DescriptorOverrideStage, Microslice,
+                         StorableMicroslice> {
+public:
+  DescriptorOverrideStage(uint8_t sys_id, uint8_t sys_ver)
+      : filter_(sys_id, sys_ver) {}
 
-    return std::make_pair(std::unique_ptr<StorableMicroslice>(m), false);
+  template <class Emit>
+  void process_item(std::unique_ptr<Microslice> item, Emit& emit) {
+    std::unique_ptr<StorableMicroslice> m;
+    if (auto* sms = dynamic_cast<StorableMicroslice*>(item.get())) {
+      item.release();
+      m.reset(sms);
+    } else {
+      m = std::make_unique<StorableMicroslice>(*item);
+    }
+    filter_.apply(*m);
+    emit(std::move(m));
   }
+
+private:
+  DescriptorOverrideFilter filter_;
 };
 
 // Example filter 2: Combine microslices
 class CombineContentsFilter
     : public BufferingFilter<Microslice, StorableMicroslice> {
+public:
+  /// Combine the contents of two consecutive microslices.
+  static std::unique_ptr<StorableMicroslice> combine(const Microslice& item1,
+                                                     const Microslice& item2) {
+    MicrosliceDescriptor desc = item1.desc();
+    std::vector<uint8_t> content;
+    content.reserve(item1.desc().size + item2.desc().size);
+    content.assign(item1.content(), item1.content() + item1.desc().size);
+    content.insert(content.end(), item2.content(),
+                   item2.content() + item2.desc().size);
+    return std::make_unique<StorableMicroslice>(desc, std::move(content));
+  }
+
 private:
   void process() override {
     // combine the contents of two consecutive microslices
@@ -45,17 +92,27 @@ private:
       this->input.pop_front();
       auto item2 = input.front();
       this->input.pop_front();
+      output.push(combine(*item1, *item2));
+    }
+  }
+};
 
-      MicrosliceDescriptor desc = item1->desc();
-      desc.size += item2->desc().size;
-      std::vector<uint8_t> content;
-      content.assign(item1->content(), item1->content() + item1->desc().size);
-      content.insert(content.end(), item2->content(),
-                     item2->content() + item2->desc().size);
-      std::unique_ptr<StorableMicroslice> combined(
-          new StorableMicroslice(desc, content));
-      output.push(std::move(combined));
+/// Pipeline stage combining microslices, see CombineContentsFilter.
+/** A single remaining microslice at the end of the stream is dropped. */
+class CombineContentsStage
+    : public StaticStage<CombineContentsStage, Microslice, StorableMicroslice> {
+public:
+  template <class Emit>
+  void process_item(std::unique_ptr<Microslice> item, Emit& emit) {
+    if (!pending_) {
+      pending_ = std::move(item);
+      return;
     }
+    emit(CombineContentsFilter::combine(*pending_, *item));
+    pending_.reset();
   }
+
+private:
+  std::unique_ptr<Microslice> pending_;
 };
 } // namespace fles
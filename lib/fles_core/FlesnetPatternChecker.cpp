@@ -1,18 +1,20 @@
 // Copyright 2013, 2015 Jan de Cuveland <cmail@cuveland.de>
 
 #include "FlesnetPatternChecker.hpp"
+#include "RampCompare.hpp"
 
 bool FlesnetPatternChecker::check(const fles::Microslice& m) {
   const auto* content = reinterpret_cast<const uint64_t*>(m.content());
-  uint32_t crc = 0x00000000;
-  for (size_t pos = 0; pos < m.desc().size / sizeof(uint64_t); ++pos) {
-    uint64_t data_word = content[pos];
-    crc ^= (data_word & 0xffffffff) ^ (data_word >> 32);
-    uint64_t expected =
-        (static_cast<uint64_t>(component) << 48) | (pos * sizeof(uint64_t));
-    if (data_word != expected) {
-      return false;
-    }
+  const size_t count = m.desc().size / sizeof(uint64_t);
+  // the word offset never reaches bit 48, so (component << 48) | offset is
+  // a ramp starting at (component << 48)
+  uint64_t word_xor = 0;
+  if (ramp_compare(content, count, static_cast<uint64_t>(component) << 48,
+                   sizeof(uint64_t), word_xor) != count) {
+    return false;
   }
+  // the XOR over all words folds into the XOR over all 32-bit halves
+  const uint32_t crc = static_cast<uint32_t>(word_xor & 0xffffffff) ^
+                       static_cast<uint32_t>(word_xor >> 32);
   return crc == m.desc().crc;
 }
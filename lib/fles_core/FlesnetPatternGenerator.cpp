@@ -1,19 +1,97 @@
 // Copyright 2012-2014 Jan de Cuveland <cmail@cuveland.de>
 
 #include "FlesnetPatternGenerator.hpp"
+#include "WorkerPool.hpp"
+#include <cstring>
+#include <random>
+
+namespace {
+/// Number of entries in the cyclic table of random content sizes.
+constexpr std::size_t random_size_count = 65536;
+} // namespace
+
+FlesnetPatternGenerator::FlesnetPatternGenerator(
+    std::size_t data_buffer_size_exp,
+    std::size_t desc_buffer_size_exp,
+    uint64_t input_index,
+    uint32_t typical_content_size,
+    bool generate_pattern,
+    bool randomize_sizes,
+    uint64_t delay_ns,
+    uint64_t initial_ns,
+    const MemoryPolicy& memory_policy,
+    unsigned fill_threads,
+    uint32_t content_alignment)
+    : data_buffer_(data_buffer_size_exp, memory_policy),
+      desc_buffer_(desc_buffer_size_exp, memory_policy),
+      data_buffer_view_(data_buffer_.ptr(), data_buffer_size_exp,
+                        data_buffer_.mirrored()),
+      desc_buffer_view_(desc_buffer_.ptr(), desc_buffer_size_exp,
+                        desc_buffer_.mirrored()),
+      input_index_(input_index), generate_pattern_(generate_pattern),
+      typical_content_size_(typical_content_size),
+      randomize_sizes_(randomize_sizes),
+      content_alignment_(content_alignment), delay_ns_(delay_ns),
+      initial_ns_(initial_ns) {
+  unsigned int max_content_size = typical_content_size_;
+  if (randomize_sizes_) {
+    // drawing the sizes is too expensive to be done per microslice
+    std::default_random_engine random_generator;
+    std::poisson_distribution<unsigned int> random_distribution(
+        typical_content_size_);
+    random_sizes_.resize(random_size_count);
+    for (auto& size : random_sizes_) {
+      size = random_distribution(random_generator);
+      max_content_size = std::max(max_content_size, size);
+    }
+  }
+
+  if (generate_pattern_) {
+    const std::size_t words = max_content_size / sizeof(uint64_t);
+    pattern_.resize(words);
+    pattern_crc_.resize(words + 1, 0);
+    for (std::size_t i = 0; i < words; ++i) {
+      const uint64_t data_word = (input_index_ << 48L) | (i * sizeof(uint64_t));
+      pattern_[i] = data_word;
+      pattern_crc_[i + 1] =
+          pattern_crc_[i] ^ static_cast<uint32_t>(data_word & 0xffffffff) ^
+          static_cast<uint32_t>(data_word >> 32L);
+    }
+    if (fill_threads > 0) {
+      fill_pool_ = std::make_unique<WorkerPool>(fill_threads);
+    }
+  }
+
+  begin_ = std::chrono::high_resolution_clock::now();
+}
+
+FlesnetPatternGenerator::~FlesnetPatternGenerator() = default;
 
 void FlesnetPatternGenerator::proceed() {
+  const std::size_t max_batches = fill_pool_ ? 2 * fill_pool_->size() : 0;
+  if (fill_pool_) {
+    publish_fill_batches();
+    if (fill_batches_.size() >= max_batches) {
+      return;
+    }
+  }
+
   const DualIndex min_avail = {desc_buffer_.size() / 4,
                                data_buffer_.size() / 4};
 
   // break unless significant space is available
-  if ((write_index_.data - read_index_.data + min_avail.data >
+  if ((fill_index_.data - read_index_.data + min_avail.data >
        data_buffer_.size()) ||
-      (write_index_.desc - read_index_.desc + min_avail.desc >
+      (fill_index_.desc - read_index_.desc + min_avail.desc >
        desc_buffer_.size())) {
     return;
   }
 
+  // with fill threads, distribute the available space over the workers
+  const uint64_t batch_bytes =
+      fill_pool_ ? min_avail.data / fill_pool_->size() : 0;
+  uint64_t batch_begin = fill_index_.data;
+
   while (true) {
     // check for current time (rate limiting)
     if (delay_ns_ != UINT64_C(0)) {
@@ -21,23 +99,33 @@ void FlesnetPatternGenerator::proceed() {
       auto delta_ns =
           std::chrono::duration_cast<std::chrono::nanoseconds>(delta).count();
       auto required_ns =
-          static_cast<int64_t>(delay_ns_ * write_index_.desc + initial_ns_);
+          static_cast<int64_t>(delay_ns_ * fill_index_.desc + initial_ns_);
       if (delta_ns < required_ns) {
-        return;
+        break;
       }
     }
 
     unsigned int content_bytes = typical_content_size_;
     if (randomize_sizes_) {
-      content_bytes = random_distribution_(random_generator_);
+      content_bytes = random_sizes_[random_size_index_];
     }
     content_bytes &= ~0x7u; // round down to multiple of sizeof(uint64_t)
 
+    // padding to the aligned start of the content
+    uint64_t padding = 0;
+    if (content_alignment_ > 1) {
+      padding = (content_alignment_ - fill_index_.data) &
+                (content_alignment_ - 1);
+    }
+
     // check for space in data and descriptor buffers
-    if ((write_index_.data - read_index_.data + content_bytes >
+    if ((fill_index_.data + padding - read_index_.data + content_bytes >
          data_buffer_.bytes()) ||
-        (write_index_.desc - read_index_.desc + 1 > desc_buffer_.size())) {
-      return;
+        (fill_index_.desc - read_index_.desc + 1 > desc_buffer_.size())) {
+      break;
+    }
+    if (randomize_sizes_) {
+      random_size_index_ = (random_size_index_ + 1) % random_sizes_.size();
     }
 
     const auto hdr_id =
@@ -50,28 +138,84 @@ void FlesnetPatternGenerator::proceed() {
     const auto sys_ver = static_cast<uint8_t>(
         generate_pattern_ ? fles::SubsystemFormatFLES::BasicRampPattern
                           : fles::SubsystemFormatFLES::Uninitialized);
-    uint64_t idx = write_index_.desc;
+    uint64_t idx = fill_index_.desc;
     uint32_t crc = 0x00000000;
     uint32_t size = content_bytes;
-    uint64_t offset = write_index_.data;
+    uint64_t offset = fill_index_.data + padding;
 
     // write to data buffer
     if (generate_pattern_) {
-      for (uint64_t i = 0; i < content_bytes; i += sizeof(uint64_t)) {
-        uint64_t data_word = (input_index_ << 48L) | i;
-        reinterpret_cast<uint64_t&>(data_buffer_.at(write_index_.data)) =
-            data_word;
-        write_index_.data += sizeof(uint64_t);
-        crc ^= (data_word & 0xffffffff) ^ (data_word >> 32L);
+      crc = pattern_crc_[content_bytes / sizeof(uint64_t)];
+      if (!fill_pool_) {
+        write_pattern(offset, size);
       }
-    } else {
-      write_index_.data += content_bytes;
     }
 
     // write to descriptor buffer
     const_cast<fles::MicrosliceDescriptor&>(
-        desc_buffer_.at(write_index_.desc++)) =
+        desc_buffer_.at(fill_index_.desc)) =
         fles::MicrosliceDescriptor({hdr_id, hdr_ver, eq_id, flags, sys_id,
                                     sys_ver, idx, crc, size, offset});
+    fill_index_.desc += 1;
+    fill_index_.data = offset + content_bytes;
+
+    if (!fill_pool_) {
+      write_index_ = fill_index_;
+    } else if (fill_index_.data - batch_begin >= batch_bytes) {
+      submit_fill_batch();
+      batch_begin = fill_index_.data;
+      if (fill_batches_.size() >= max_batches) {
+        break;
+      }
+    }
+  }
+
+  if (fill_pool_) {
+    submit_fill_batch();
+  }
+}
+
+void FlesnetPatternGenerator::write_pattern(uint64_t offset, uint32_t size) {
+  uint8_t* data = data_buffer_.ptr();
+  const auto* pattern = reinterpret_cast<const uint8_t*>(pattern_.data());
+  const std::size_t begin = offset & data_buffer_.size_mask();
+  if (data_buffer_.mirrored()) {
+    memcpy(data + begin, pattern, size);
+    return;
+  }
+  const std::size_t first =
+      std::min<std::size_t>(size, data_buffer_.bytes() - begin);
+  memcpy(data + begin, pattern, first);
+  memcpy(data, pattern + first, size - first);
+}
+
+void FlesnetPatternGenerator::fill(uint64_t desc_begin, uint64_t desc_end) {
+  for (uint64_t i = desc_begin; i < desc_end; ++i) {
+    const auto& desc =
+        const_cast<const fles::MicrosliceDescriptor&>(desc_buffer_.at(i));
+    write_pattern(desc.offset, desc.size);
+  }
+}
+
+void FlesnetPatternGenerator::submit_fill_batch() {
+  const uint64_t desc_begin =
+      fill_batches_.empty() ? write_index_.desc : fill_batches_.back().end.desc;
+  if (fill_index_.desc == desc_begin) {
+    return;
+  }
+  const uint64_t desc_end = fill_index_.desc;
+  fill_batches_.push_back(
+      {fill_index_, fill_pool_->submit([this, desc_begin, desc_end] {
+         fill(desc_begin, desc_end);
+       })});
+}
+
+void FlesnetPatternGenerator::publish_fill_batches() {
+  while (!fill_batches_.empty() &&
+         fill_batches_.front().done.wait_for(std::chrono::seconds(0)) ==
+             std::future_status::ready) {
+    fill_batches_.front().done.get();
+    write_index_ = fill_batches_.front().end;
+    fill_batches_.pop_front();
   }
 }
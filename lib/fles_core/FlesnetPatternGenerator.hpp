@@ -7,10 +7,22 @@
 #include "RingBufferView.hpp"
 #include "log.hpp"
 #include <algorithm>
+#include <atomic>
 #include <chrono>
-#include <random>
+#include <deque>
+#include <future>
+#include <memory>
+#include <vector>
+
+class WorkerPool;
 
 /// Simple embedded software pattern generator.
+/** The content of a microslice only depends on its size, so it is copied
+    from a precomputed template. With fill threads, the content is written
+    by a pool of workers in batches of consecutive microslices, which are
+    published in order once they are complete. The microslice contents can
+    be padded to start at multiples of a given alignment in the data
+    buffer. */
 class FlesnetPatternGenerator : public InputBufferReadInterface {
 public:
   /// The FlesnetPatternGenerator constructor.
@@ -21,17 +33,12 @@ public:
                           bool generate_pattern = false,
                           bool randomize_sizes = false,
                           uint64_t delay_ns = 0,
-                          uint64_t initial_ns = 0)
-      : data_buffer_(data_buffer_size_exp), desc_buffer_(desc_buffer_size_exp),
-        data_buffer_view_(data_buffer_.ptr(), data_buffer_size_exp),
-        desc_buffer_view_(desc_buffer_.ptr(), desc_buffer_size_exp),
-        input_index_(input_index), generate_pattern_(generate_pattern),
-        typical_content_size_(typical_content_size),
-        randomize_sizes_(randomize_sizes),
-        random_distribution_(typical_content_size), delay_ns_(delay_ns),
-        initial_ns_(initial_ns) {
-    begin_ = std::chrono::high_resolution_clock::now();
-  }
+                          uint64_t initial_ns = 0,
+                          const MemoryPolicy& memory_policy = {},
+                          unsigned fill_threads = 0,
+                          uint32_t content_alignment = 0);
+
+  ~FlesnetPatternGenerator() override;
 
   FlesnetPatternGenerator(const FlesnetPatternGenerator&) = delete;
   void operator=(const FlesnetPatternGenerator&) = delete;
@@ -50,10 +57,16 @@ public:
 
   void set_read_index(DualIndex new_read_index) override {
     read_index_ = new_read_index;
+    acked_data_.store(new_read_index.data, std::memory_order_relaxed);
   }
 
   DualIndex get_read_index() override { return read_index_; }
 
+  /// Retrieve the number of acknowledged data bytes (from any thread).
+  [[nodiscard]] uint64_t acked_data() const {
+    return acked_data_.load(std::memory_order_relaxed);
+  }
+
 private:
   /// Input data buffer.
   RingBuffer<uint8_t> data_buffer_;
@@ -71,11 +84,21 @@ private:
   uint32_t typical_content_size_;
   bool randomize_sizes_;
 
-  /// A pseudo-random number generator.
-  std::default_random_engine random_generator_;
+  /// Alignment of the microslice contents in the data buffer (power of two,
+  /// 0: none).
+  uint32_t content_alignment_;
 
-  /// Distribution to use in determining data content sizes.
-  std::poisson_distribution<unsigned int> random_distribution_;
+  /// Cyclic table of pseudo-random content sizes.
+  std::vector<unsigned int> random_sizes_;
+
+  /// Next entry in the table of content sizes.
+  std::size_t random_size_index_ = 0;
+
+  /// Pattern content of the largest microslice.
+  std::vector<uint64_t> pattern_;
+
+  /// Pattern CRC by content size in words.
+  std::vector<uint32_t> pattern_crc_;
 
   uint64_t delay_ns_;
   uint64_t initial_ns_;
@@ -85,6 +108,36 @@ private:
   /// node.
   DualIndex read_index_{0, 0};
 
+  /// Copy of read_index_.data for readers in other threads.
+  std::atomic<uint64_t> acked_data_{0};
+
   /// FLIB-internal number of written microslices and data bytes.
   DualIndex write_index_{0, 0};
+
+  /// Number of microslices and data bytes handed to the fill threads.
+  DualIndex fill_index_{0, 0};
+
+  /// A range of microslices filled by a worker thread.
+  struct FillBatch {
+    DualIndex end;
+    std::future<void> done;
+  };
+
+  /// Batches in flight, in order.
+  std::deque<FillBatch> fill_batches_;
+
+  /// Fill threads (destroyed first, completing all batches).
+  std::unique_ptr<WorkerPool> fill_pool_;
+
+  /// Write content of the given size at offset in the data buffer.
+  void write_pattern(uint64_t offset, uint32_t size);
+
+  /// Write the content of the microslices in a range of descriptors.
+  void fill(uint64_t desc_begin, uint64_t desc_end);
+
+  /// Hand the microslices planned after the last batch to a fill thread.
+  void submit_fill_batch();
+
+  /// Publish the batches completed by the fill threads.
+  void publish_fill_batches();
 };
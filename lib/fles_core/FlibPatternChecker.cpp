@@ -11,6 +11,7 @@
 // Implementation is not dump parallelizable across ts components!
 
 #include "FlibPatternChecker.hpp"
+#include "RampCompare.hpp"
 #include <iostream>
 
 bool FlibPatternChecker::check(const fles::Microslice& m) {
@@ -83,21 +84,21 @@ bool FlibPatternChecker::check(const fles::Microslice& m) {
     } else {
       ramp_limit = 9;
     }
-    size_t pos = 1;
-    uint64_t ramp = 0xABCD000000000000;
+    const uint64_t ramp = 0xABCD000000000000;
     const uint64_t* content =
         reinterpret_cast<const uint64_t*>(m.content()) + 0;
 
-    while (pos <= ((m.desc().size - ramp_limit) / sizeof(uint64_t))) {
-      if (content[pos] != ramp) {
-        std::cerr << "Flib pgen: error in ramp word "
-                  << " exp " << std::hex << ramp << " seen " << content[pos]
-                  << std::endl;
-        return false;
-      }
-      ++ramp;
-      ++pos;
+    // ramp words at positions 1 .. count
+    const size_t count = (m.desc().size - ramp_limit) / sizeof(uint64_t);
+    uint64_t word_xor = 0;
+    size_t mismatch = ramp_compare(content + 1, count, ramp, 1, word_xor);
+    if (mismatch != count) {
+      std::cerr << "Flib pgen: error in ramp word "
+                << " exp " << std::hex << ramp + mismatch << " seen "
+                << content[1 + mismatch] << std::endl;
+      return false;
     }
+    size_t pos = 1 + count;
 
     // check last word if any
     size_t last_word_start = pos * sizeof(uint64_t);
@@ -0,0 +1,196 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the ItemBitmap class.
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * \brief Set of item IDs within a sliding window, stored as a ring-indexed
+ * bitmap.
+ *
+ * The IDs in the set span a window of at most the capacity of the ring (all
+ * IDs between the lowest and the highest one), such as the positions of the
+ * timeslices in flight in a timeslice buffer. Inserting and erasing an ID
+ * are O(1) without allocation, and ranges of IDs are visited and erased a
+ * word of 64 IDs at a time with bit scans. The lowest ID in the set serves
+ * as a watermark. If an ID outside of the window is inserted, the ring
+ * grows.
+ */
+class ItemBitmap {
+public:
+  /// Construct an empty set with an initial window of 2^size_exp IDs.
+  explicit ItemBitmap(uint32_t size_exp = 10) {
+    words_.assign(std::max<std::size_t>((std::size_t(1) << size_exp) / 64, 1),
+                  0);
+    mask_ = words_.size() - 1;
+  }
+
+  /// Check whether the set is empty.
+  [[nodiscard]] bool empty() const { return count_ == 0; }
+
+  /// Retrieve the number of IDs in the set.
+  [[nodiscard]] std::size_t size() const { return count_; }
+
+  /// Retrieve the lowest ID in the set (requires a non-empty set).
+  [[nodiscard]] uint64_t front() const {
+    assert(!empty());
+    return begin_;
+  }
+
+  /// Check whether an ID is in the set.
+  [[nodiscard]] bool contains(uint64_t id) const {
+    return count_ != 0 && id >= begin_ && id < end_ &&
+           (word(id) & bit(id)) != 0;
+  }
+
+  /// Insert an ID (which must not be in the set).
+  void insert(uint64_t id) {
+    assert(!contains(id));
+    if (count_ == 0) {
+      begin_ = id;
+      end_ = id + 1;
+    } else {
+      const uint64_t begin = std::min(begin_, id);
+      const uint64_t end = std::max(end_, id + 1);
+      while (end - (begin & ~UINT64_C(63)) > capacity()) {
+        grow();
+      }
+      begin_ = begin;
+      end_ = end;
+    }
+    word(id) |= bit(id);
+    ++count_;
+  }
+
+  /// Erase an ID.
+  /** \return true if the ID had been in the set */
+  bool erase(uint64_t id) {
+    if (!contains(id)) {
+      return false;
+    }
+    word(id) &= ~bit(id);
+    if (--count_ != 0 && id == begin_) {
+      begin_ = find_next(id + 1);
+    }
+    return true;
+  }
+
+  /// Erase all IDs below end, passing each of them in ascending order to a
+  /// function.
+  template <typename Function> void erase_below(uint64_t end, Function&& f) {
+    if (count_ == 0 || end <= begin_) {
+      return;
+    }
+    end = std::min(end, end_);
+    for (uint64_t w = begin_ >> 6; count_ != 0 && (w << 6) < end; ++w) {
+      uint64_t& bits = words_[w & mask_];
+      uint64_t erased = bits;
+      if (((w + 1) << 6) > end) {
+        erased &= bit(end) - 1;
+      }
+      bits &= ~erased;
+      while (erased != 0) {
+        --count_;
+        f((w << 6) + static_cast<uint64_t>(__builtin_ctzll(erased)));
+        erased &= erased - 1;
+      }
+    }
+    if (count_ != 0) {
+      begin_ = find_next(end);
+    }
+  }
+
+  /// Erase all IDs below end.
+  void erase_below(uint64_t end) {
+    erase_below(end, [](uint64_t /* id */) {});
+  }
+
+  /// Erase the run of consecutive IDs starting at begin, if any.
+  /** \return the first ID from begin on that had not been in the set */
+  uint64_t erase_run(uint64_t begin) {
+    const uint64_t end = find_next_missing(begin);
+    erase_below(end);
+    return end;
+  }
+
+  /// Pass the IDs in [begin, end) in ascending order to a function.
+  template <typename Function>
+  void for_each(uint64_t begin, uint64_t end, Function&& f) const {
+    if (count_ == 0) {
+      return;
+    }
+    begin = std::max(begin, begin_);
+    end = std::min(end, end_);
+    for (uint64_t id = find_next(begin); id < end; id = find_next(id + 1)) {
+      f(id);
+    }
+  }
+
+  /// Retrieve the current number of IDs in the window of the ring.
+  [[nodiscard]] std::size_t capacity() const { return words_.size() * 64; }
+
+private:
+  std::vector<uint64_t> words_;
+  std::size_t mask_ = 0;
+  std::size_t count_ = 0;
+  /// Lowest ID in the set (if not empty).
+  uint64_t begin_ = 0;
+  /// An upper bound of the IDs in the set (if not empty).
+  uint64_t end_ = 0;
+
+  static uint64_t bit(uint64_t id) { return UINT64_C(1) << (id & 63); }
+
+  uint64_t& word(uint64_t id) { return words_[(id >> 6) & mask_]; }
+  [[nodiscard]] uint64_t word(uint64_t id) const {
+    return words_[(id >> 6) & mask_];
+  }
+
+  /// Find the lowest ID in the set from id on (end_ if none).
+  [[nodiscard]] uint64_t find_next(uint64_t id) const {
+    while (id < end_) {
+      const uint64_t bits = word(id) >> (id & 63);
+      if (bits != 0) {
+        return std::min(id + static_cast<uint64_t>(__builtin_ctzll(bits)),
+                        end_);
+      }
+      id = (id | 63) + 1;
+    }
+    return end_;
+  }
+
+  /// Find the lowest ID not in the set from id on.
+  [[nodiscard]] uint64_t find_next_missing(uint64_t id) const {
+    if (!contains(id)) {
+      return id;
+    }
+    while (id < end_) {
+      const uint64_t bits = ~word(id) >> (id & 63);
+      if (bits != 0) {
+        return std::min(id + static_cast<uint64_t>(__builtin_ctzll(bits)),
+                        end_);
+      }
+      id = (id | 63) + 1;
+    }
+    return end_;
+  }
+
+  /// Double the size of the ring, keeping the IDs in the set.
+  void grow() {
+    std::vector<uint64_t> old_words = std::move(words_);
+    const std::size_t old_mask = mask_;
+    words_.assign(old_words.size() * 2, 0);
+    mask_ = words_.size() - 1;
+    if (count_ == 0) {
+      return;
+    }
+    for (uint64_t w = begin_ >> 6; (w << 6) < end_; ++w) {
+      words_[w & mask_] = old_words[w & old_mask];
+    }
+  }
+};
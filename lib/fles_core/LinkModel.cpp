@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "LinkModel.hpp"
+#include "Utility.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+LinkModelParameters LinkModelParameters::parse(const std::string& spec) {
+  LinkModelParameters parameters;
+  for (const auto& item : split(spec, ",")) {
+    if (item.empty()) {
+      continue;
+    }
+    const auto equal = item.find('=');
+    if (equal == std::string::npos) {
+      throw std::invalid_argument("invalid link model parameter: " + item);
+    }
+    const std::string key = item.substr(0, equal);
+    const std::string value = item.substr(equal + 1);
+    bool known = true;
+    try {
+      if (key == "latency") {
+        parameters.latency_ns = std::stoull(value);
+      } else if (key == "jitter") {
+        parameters.jitter_ns = std::stoull(value);
+      } else if (key == "bandwidth") {
+        parameters.link_bandwidth = std::stod(value);
+      } else if (key == "uplink") {
+        parameters.uplink_bandwidth = std::stod(value);
+      } else if (key == "seed") {
+        parameters.seed = std::stoull(value);
+      } else {
+        known = false;
+      }
+    } catch (const std::logic_error&) {
+      throw std::invalid_argument("invalid link model parameter: " + item);
+    }
+    if (!known) {
+      throw std::invalid_argument("unknown link model parameter: " + key);
+    }
+    if (parameters.link_bandwidth < 0 || parameters.uplink_bandwidth < 0) {
+      throw std::invalid_argument("invalid link model parameter: " + item);
+    }
+  }
+  return parameters;
+}
+
+LinkModel::LinkModel(const LinkModelParameters& parameters,
+                     std::size_t num_links,
+                     uint64_t sender_index)
+    : parameters_(parameters), links_(num_links),
+      random_(parameters.seed ^ (sender_index * UINT64_C(0x9e3779b97f4a7c15))) {
+}
+
+bool LinkModel::admit(std::size_t link,
+                      uint64_t transfer,
+                      uint64_t bytes,
+                      clock::time_point now) {
+  Link& l = links_.at(link);
+  if (!l.pending || l.transfer != transfer) {
+    uint64_t delay_ns = parameters_.latency_ns;
+    if (parameters_.jitter_ns != 0) {
+      delay_ns += std::uniform_int_distribution<uint64_t>(
+          0, parameters_.jitter_ns)(random_);
+    }
+    l.pending = true;
+    l.transfer = transfer;
+    l.ready = now + std::chrono::nanoseconds(delay_ns);
+  }
+  if (now < std::max({l.ready, l.free, uplink_free_})) {
+    return false;
+  }
+  l.pending = false;
+  l.free = now + transmission_time(bytes, parameters_.link_bandwidth);
+  uplink_free_ = now + transmission_time(bytes, parameters_.uplink_bandwidth);
+  return true;
+}
+
+LinkModel::clock::duration LinkModel::transmission_time(uint64_t bytes,
+                                                        double bandwidth) {
+  if (bandwidth <= 0) {
+    return clock::duration::zero();
+  }
+  return std::chrono::duration_cast<clock::duration>(
+      std::chrono::duration<double>(static_cast<double>(bytes) / bandwidth));
+}
@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the LinkModel class.
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+/// Parameters of an emulated network link.
+struct LinkModelParameters {
+  /// Delay added to each transfer in ns.
+  uint64_t latency_ns = 0;
+  /// Maximum random addition to the delay in ns.
+  uint64_t jitter_ns = 0;
+  /// Bandwidth of each link from a sender to a receiver in bytes/s (0:
+  /// unlimited).
+  double link_bandwidth = 0;
+  /// Bandwidth shared by all links of a sender in bytes/s (0: unlimited).
+  double uplink_bandwidth = 0;
+  /// Seed of the jitter, combined with the index of the sender.
+  uint64_t seed = 0;
+
+  /// Check whether the model affects any transfer.
+  [[nodiscard]] bool enabled() const {
+    return latency_ns != 0 || jitter_ns != 0 || link_bandwidth > 0 ||
+           uplink_bandwidth > 0;
+  }
+
+  /// Parse a list like "latency=20000,bandwidth=1e9". Keys are latency and
+  /// jitter (ns), bandwidth and uplink (bytes/s), and seed. Throws
+  /// std::invalid_argument on malformed input.
+  static LinkModelParameters parse(const std::string& spec);
+};
+
+/**
+ * \brief Emulation of the delay and bandwidth of the links of a sender.
+ *
+ * Transfers are held back in the sender before they are posted, so a fast
+ * local transport (e.g., the Libfabric sockets provider on a single host)
+ * behaves like a cluster network. A transfer becomes ready the latency
+ * (plus jitter) after it was first offered, and it is admitted once its
+ * link and the uplink of the sender are free again, i.e., the preceding
+ * transfers have been serialized at the respective bandwidth. The jitter is
+ * pseudo-random with a fixed seed, so runs are reproducible up to the
+ * timing of the underlying transport.
+ */
+class LinkModel {
+public:
+  using clock = std::chrono::steady_clock;
+
+  LinkModel() = default;
+
+  LinkModel(const LinkModelParameters& parameters,
+            std::size_t num_links,
+            uint64_t sender_index = 0);
+
+  /// Check whether the model affects any transfer.
+  [[nodiscard]] bool enabled() const { return parameters_.enabled(); }
+
+  /// Offer a transfer on a link.
+  /**
+     \param link     Index of the link (i.e., the receiver)
+     \param transfer Identifier of the transfer, unique per link
+     \param bytes    Size of the transfer
+     \param now      Current time
+     \return true if the transfer may be posted now
+   */
+  bool admit(std::size_t link,
+             uint64_t transfer,
+             uint64_t bytes,
+             clock::time_point now = clock::now());
+
+private:
+  struct Link {
+    bool pending = false;
+    uint64_t transfer = 0;
+    clock::time_point ready{};
+    clock::time_point free{};
+  };
+
+  LinkModelParameters parameters_;
+  std::vector<Link> links_;
+  clock::time_point uplink_free_{};
+  std::mt19937_64 random_;
+
+  [[nodiscard]] static clock::duration transmission_time(uint64_t bytes,
+                                                         double bandwidth);
+};
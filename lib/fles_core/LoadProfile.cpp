@@ -0,0 +1,266 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "LoadProfile.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+void SizeHistogram::add(const SizeHistogram& other) {
+  for (const auto& [bin, count] : other.bins_) {
+    bins_[bin] += count;
+  }
+  total_ += other.total_;
+}
+
+double SizeHistogram::mean() const {
+  if (total_ == 0) {
+    return 0;
+  }
+  double sum = 0;
+  for (const auto& [bin, count] : bins_) {
+    const double center =
+        static_cast<double>(lower_bound(bin) + upper_bound(bin) - 1) / 2;
+    sum += center * static_cast<double>(count);
+  }
+  return sum / static_cast<double>(total_);
+}
+
+uint32_t SizeHistogram::sample(std::mt19937_64& random) const {
+  if (total_ == 0) {
+    return 0;
+  }
+  uint64_t n = std::uniform_int_distribution<uint64_t>(0, total_ - 1)(random);
+  for (const auto& [bin, count] : bins_) {
+    if (n < count) {
+      const uint64_t upper = std::min<uint64_t>(upper_bound(bin), UINT32_MAX);
+      return static_cast<uint32_t>(std::uniform_int_distribution<uint64_t>(
+          lower_bound(bin), upper - 1)(random));
+    }
+    n -= count;
+  }
+  return static_cast<uint32_t>(lower_bound(bins_.rbegin()->first));
+}
+
+uint32_t SizeHistogram::bin(uint32_t size) {
+  if (size < 8) {
+    return size;
+  }
+  const auto exponent = static_cast<uint32_t>(31 - __builtin_clz(size));
+  const uint32_t mantissa = (size >> (exponent - 3)) & 7;
+  return 8 * (exponent - 2) + mantissa;
+}
+
+uint64_t SizeHistogram::lower_bound(uint32_t bin) {
+  if (bin < 8) {
+    return bin;
+  }
+  const uint32_t exponent = bin / 8 + 2;
+  const uint32_t mantissa = bin % 8;
+  return static_cast<uint64_t>(8 + mantissa) << (exponent - 3);
+}
+
+double ComponentLoadProfile::mean_rate() const {
+  if (microslice_duration_ns == 0) {
+    return 0;
+  }
+  const double duty = spill_period_ns == 0 ? 1.0 : spill_duty;
+  const double mean_size =
+      duty * spill_sizes.mean() + (1 - duty) * pause_sizes.mean();
+  return mean_size * 1e9 / static_cast<double>(microslice_duration_ns);
+}
+
+//---------------------------------------------------------------------------
+
+namespace {
+
+void save_sizes(std::ostream& out,
+                const std::string& keyword,
+                const SizeHistogram& sizes) {
+  out << keyword;
+  for (const auto& [bin, count] : sizes.bins()) {
+    out << " " << SizeHistogram::lower_bound(bin) << ":" << count;
+  }
+  out << "\n";
+}
+
+void load_sizes(std::istringstream& line, SizeHistogram& sizes) {
+  std::string token;
+  while (line >> token) {
+    const auto colon = token.find(':');
+    if (colon == std::string::npos) {
+      throw std::runtime_error("invalid size bin in load profile: " + token);
+    }
+    const auto size = std::stoul(token.substr(0, colon));
+    const auto count = std::stoull(token.substr(colon + 1));
+    if (size > UINT32_MAX) {
+      throw std::runtime_error("invalid size bin in load profile: " + token);
+    }
+    sizes.add(static_cast<uint32_t>(size), count);
+  }
+}
+
+} // namespace
+
+void LoadProfile::save(std::ostream& out) const {
+  out << "# flesnet load profile\n"
+         "# component <sys_id> <sys_ver> <eq_id> <microslice duration/ns> "
+         "<spill period/ns> <spill duty>\n";
+  for (const auto& c : components) {
+    out << "component " << std::showbase << std::hex
+        << static_cast<unsigned>(c.sys_id) << " "
+        << static_cast<unsigned>(c.sys_ver) << " " << c.eq_id << std::dec
+        << std::noshowbase << " " << c.microslice_duration_ns << " "
+        << c.spill_period_ns << " " << std::setprecision(6) << c.spill_duty
+        << "\n";
+    save_sizes(out, "spill", c.spill_sizes);
+    save_sizes(out, "pause", c.pause_sizes);
+  }
+}
+
+void LoadProfile::save(const std::string& filename) const {
+  std::ofstream out(filename);
+  if (!out) {
+    throw std::runtime_error("could not open load profile: " + filename);
+  }
+  save(out);
+  if (!out) {
+    throw std::runtime_error("could not write load profile: " + filename);
+  }
+}
+
+LoadProfile LoadProfile::load(std::istream& in) {
+  LoadProfile profile;
+  std::string text;
+  while (std::getline(in, text)) {
+    std::istringstream line(text);
+    std::string keyword;
+    if (!(line >> keyword) || keyword[0] == '#') {
+      continue;
+    }
+    if (keyword == "component") {
+      std::string sys_id;
+      std::string sys_ver;
+      std::string eq_id;
+      ComponentLoadProfile c;
+      if (!(line >> sys_id >> sys_ver >> eq_id >> c.microslice_duration_ns >>
+            c.spill_period_ns >> c.spill_duty)) {
+        throw std::runtime_error("invalid component in load profile: " +
+                                 text);
+      }
+      c.sys_id = static_cast<uint8_t>(std::stoul(sys_id, nullptr, 0));
+      c.sys_ver = static_cast<uint8_t>(std::stoul(sys_ver, nullptr, 0));
+      c.eq_id = static_cast<uint16_t>(std::stoul(eq_id, nullptr, 0));
+      profile.components.push_back(std::move(c));
+    } else if (keyword == "spill" || keyword == "pause") {
+      if (profile.components.empty()) {
+        throw std::runtime_error("size distribution without component in "
+                                 "load profile");
+      }
+      auto& c = profile.components.back();
+      load_sizes(line, keyword == "spill" ? c.spill_sizes : c.pause_sizes);
+    } else {
+      throw std::runtime_error("unknown keyword in load profile: " + keyword);
+    }
+  }
+  return profile;
+}
+
+LoadProfile LoadProfile::load(const std::string& filename) {
+  std::ifstream in(filename);
+  if (!in) {
+    throw std::runtime_error("could not open load profile: " + filename);
+  }
+  return load(in);
+}
+
+//---------------------------------------------------------------------------
+
+void LoadProfileLearner::add(std::size_t component,
+                             const fles::MicrosliceDescriptor& desc) {
+  if (component >= components_.size()) {
+    components_.resize(component + 1);
+  }
+  Component& c = components_[component];
+  if (c.count == 0) {
+    c.first = desc;
+  }
+  c.last_idx = desc.idx;
+  ++c.count;
+  if (!c.window_open) {
+    c.windows.push_back({desc.idx, 0, {}});
+    c.window_open = true;
+  }
+  Window& w = c.windows.back();
+  w.bytes += desc.size;
+  w.sizes.add(desc.size);
+}
+
+void LoadProfileLearner::end_window() {
+  for (auto& c : components_) {
+    c.window_open = false;
+  }
+}
+
+LoadProfile LoadProfileLearner::profile() const {
+  LoadProfile profile;
+  for (const auto& c : components_) {
+    profile.components.push_back(learn(c));
+  }
+  return profile;
+}
+
+ComponentLoadProfile LoadProfileLearner::learn(const Component& c) {
+  ComponentLoadProfile p;
+  p.eq_id = c.first.eq_id;
+  p.sys_id = c.first.sys_id;
+  p.sys_ver = c.first.sys_ver;
+  if (c.count > 1 && c.last_idx > c.first.idx) {
+    p.microslice_duration_ns = (c.last_idx - c.first.idx) / (c.count - 1);
+  }
+  if (c.windows.empty()) {
+    return p;
+  }
+
+  uint64_t total_bytes = 0;
+  for (const auto& w : c.windows) {
+    total_bytes += w.bytes;
+  }
+  const double threshold = static_cast<double>(total_bytes) /
+                           (2.0 * static_cast<double>(c.windows.size()));
+  std::vector<bool> pause(c.windows.size());
+  std::vector<std::size_t> spill_starts;
+  for (std::size_t i = 0; i < c.windows.size(); ++i) {
+    pause[i] = static_cast<double>(c.windows[i].bytes) < threshold;
+    if (i > 0 && pause[i - 1] && !pause[i]) {
+      spill_starts.push_back(i);
+    }
+  }
+
+  if (spill_starts.size() < 2) {
+    // no complete spill cycle, the load is treated as stationary
+    for (const auto& w : c.windows) {
+      p.spill_sizes.add(w.sizes);
+    }
+    return p;
+  }
+
+  const std::size_t first = spill_starts.front();
+  const std::size_t last = spill_starts.back();
+  p.spill_period_ns = (c.windows[last].start_idx - c.windows[first].start_idx) /
+                      (spill_starts.size() - 1);
+  std::size_t spill_windows = 0;
+  for (std::size_t i = first; i < last; ++i) {
+    if (!pause[i]) {
+      ++spill_windows;
+    }
+  }
+  p.spill_duty =
+      static_cast<double>(spill_windows) / static_cast<double>(last - first);
+  for (std::size_t i = 0; i < c.windows.size(); ++i) {
+    (pause[i] ? p.pause_sizes : p.spill_sizes).add(c.windows[i].sizes);
+  }
+  return p;
+}
@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the LoadProfile class and related types.
+#pragma once
+
+#include "MicrosliceDescriptor.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * \brief Histogram of microslice content sizes with logarithmic bins.
+ *
+ * Sizes below 8 have a bin each; above, each power of two is divided into
+ * eight bins, so the relative bin width is at most 1/8 and heavy tails are
+ * represented with few bins.
+ */
+class SizeHistogram {
+public:
+  /// Add a number of sizes.
+  void add(uint32_t size, uint64_t count = 1) {
+    bins_[bin(size)] += count;
+    total_ += count;
+  }
+
+  /// Add all sizes of another histogram.
+  void add(const SizeHistogram& other);
+
+  /// Retrieve the number of sizes.
+  [[nodiscard]] uint64_t total() const { return total_; }
+
+  /// Retrieve the mean size, assuming the sizes to be at the bin centers.
+  [[nodiscard]] double mean() const;
+
+  /// Draw a size, uniformly distributed within the drawn bin.
+  [[nodiscard]] uint32_t sample(std::mt19937_64& random) const;
+
+  /// Retrieve the counts by bin index.
+  [[nodiscard]] const std::map<uint32_t, uint64_t>& bins() const {
+    return bins_;
+  }
+
+  /// Retrieve the bin index of a size.
+  [[nodiscard]] static uint32_t bin(uint32_t size);
+
+  /// Retrieve the smallest size of a bin.
+  [[nodiscard]] static uint64_t lower_bound(uint32_t bin);
+
+  /// Retrieve the smallest size of the next bin.
+  [[nodiscard]] static uint64_t upper_bound(uint32_t bin) {
+    return lower_bound(bin + 1);
+  }
+
+private:
+  std::map<uint32_t, uint64_t> bins_;
+  uint64_t total_ = 0;
+};
+
+/// Load of a single component: microslice sizes and spill structure.
+struct ComponentLoadProfile {
+  uint16_t eq_id = 0;
+  uint8_t sys_id = 0;
+  uint8_t sys_ver = 0;
+
+  /// Time covered by a microslice in ns.
+  uint64_t microslice_duration_ns = 0;
+
+  /// Length of a spill cycle in ns (0: no spill structure).
+  uint64_t spill_period_ns = 0;
+
+  /// Fraction of the spill cycle with beam, starting at the cycle begin.
+  double spill_duty = 1.0;
+
+  /// Sizes of the microslices during the spill.
+  SizeHistogram spill_sizes;
+
+  /// Sizes of the microslices between the spills.
+  SizeHistogram pause_sizes;
+
+  /// Check whether a time (relative to the start of a cycle) is in a spill.
+  [[nodiscard]] bool in_spill(uint64_t time_ns) const {
+    if (spill_period_ns == 0) {
+      return true;
+    }
+    return static_cast<double>(time_ns % spill_period_ns) <
+           spill_duty * static_cast<double>(spill_period_ns);
+  }
+
+  /// Retrieve the mean data rate in bytes/s.
+  [[nodiscard]] double mean_rate() const;
+};
+
+/**
+ * \brief The LoadProfile class describes the load of a set of detector
+ * components.
+ *
+ * A profile is learned from the microslices of an archive by the
+ * LoadProfileLearner and replayed by the ProfileLoadGenerator. It is stored
+ * in a line-based text format:
+ *
+ *     component <sys_id> <sys_ver> <eq_id> <duration> <period> <duty>
+ *     spill <size>:<count> ...
+ *     pause <size>:<count> ...
+ *
+ * where the sizes are the lower bounds of the histogram bins. Lines starting
+ * with '#' are ignored.
+ */
+class LoadProfile {
+public:
+  std::vector<ComponentLoadProfile> components;
+
+  /// Write the profile to a text stream.
+  void save(std::ostream& out) const;
+
+  /// Write the profile to a text file.
+  void save(const std::string& filename) const;
+
+  /// Read a profile from a text stream. Throws std::runtime_error on
+  /// malformed input.
+  static LoadProfile load(std::istream& in);
+
+  /// Read a profile from a text file.
+  static LoadProfile load(const std::string& filename);
+};
+
+/**
+ * \brief The LoadProfileLearner class derives a LoadProfile from a stream of
+ * microslice descriptors.
+ *
+ * The stream is divided into windows (e.g., timeslices). Windows with less
+ * than half the mean content volume of a component are attributed to the
+ * pause between spills. The spill period is the mean distance of the starts
+ * of the spills, which requires at least two complete pauses.
+ */
+class LoadProfileLearner {
+public:
+  /// Account the microslice of a component to the current window.
+  void add(std::size_t component, const fles::MicrosliceDescriptor& desc);
+
+  /// Close the current window.
+  void end_window();
+
+  /// Derive the profile from the windows seen so far.
+  [[nodiscard]] LoadProfile profile() const;
+
+private:
+  struct Window {
+    uint64_t start_idx = 0;
+    uint64_t bytes = 0;
+    SizeHistogram sizes;
+  };
+
+  struct Component {
+    fles::MicrosliceDescriptor first{};
+    uint64_t last_idx = 0;
+    uint64_t count = 0;
+    std::vector<Window> windows;
+    bool window_open = false;
+  };
+
+  std::vector<Component> components_;
+
+  [[nodiscard]] static ComponentLoadProfile learn(const Component& c);
+};
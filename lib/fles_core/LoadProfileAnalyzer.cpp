@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "LoadProfileAnalyzer.hpp"
+#include "Microslice.hpp"
+#include "Timeslice.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <exception>
+
+namespace {
+
+void write_profile(const LoadProfile& profile, const std::string& filename) {
+  try {
+    profile.save(filename);
+  } catch (std::exception& e) {
+    L_(error) << e.what();
+    return;
+  }
+  for (std::size_t c = 0; c < profile.components.size(); ++c) {
+    const auto& p = profile.components[c];
+    L_(info) << "load profile component " << c << ": "
+             << p.spill_sizes.total() + p.pause_sizes.total()
+             << " microslices, mean rate " << p.mean_rate() / 1e6
+             << " MB/s, spill period " << p.spill_period_ns / 1e6
+             << " ms, duty " << p.spill_duty;
+  }
+  L_(info) << "load profile written to " << filename;
+}
+
+} // namespace
+
+void TimesliceLoadProfiler::put(
+    std::shared_ptr<const fles::Timeslice> timeslice) {
+  const uint64_t core = timeslice->num_core_microslices();
+  for (uint64_t c = 0; c < timeslice->num_components(); ++c) {
+    const uint64_t n = std::min(core, timeslice->num_microslices(c));
+    for (uint64_t m = 0; m < n; ++m) {
+      learner_.add(c, timeslice->descriptor(c, m));
+    }
+  }
+  learner_.end_window();
+}
+
+TimesliceLoadProfiler::~TimesliceLoadProfiler() {
+  write_profile(learner_.profile(), filename_);
+}
+
+void MicrosliceLoadProfiler::put(
+    std::shared_ptr<const fles::Microslice> microslice) {
+  learner_.add(0, microslice->desc());
+  if (++count_ % window_microslices_ == 0) {
+    learner_.end_window();
+  }
+}
+
+MicrosliceLoadProfiler::~MicrosliceLoadProfiler() {
+  write_profile(learner_.profile(), filename_);
+}
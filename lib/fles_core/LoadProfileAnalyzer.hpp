@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the TimesliceLoadProfiler and MicrosliceLoadProfiler
+/// classes.
+#pragma once
+
+#include "LoadProfile.hpp"
+#include "Sink.hpp"
+#include <memory>
+#include <string>
+
+/**
+ * \brief The TimesliceLoadProfiler class learns the load profile of the
+ * components of a timeslice stream and writes it on destruction.
+ *
+ * Each timeslice is a window of the spill detection; only the core
+ * microslices are accounted.
+ */
+class TimesliceLoadProfiler : public fles::TimesliceSink {
+public:
+  explicit TimesliceLoadProfiler(std::string filename)
+      : filename_(std::move(filename)) {}
+
+  ~TimesliceLoadProfiler() override;
+
+  void put(std::shared_ptr<const fles::Timeslice> timeslice) override;
+
+private:
+  std::string filename_;
+  LoadProfileLearner learner_;
+};
+
+/**
+ * \brief The MicrosliceLoadProfiler class learns the load profile of a
+ * microslice stream of a single component and writes it on destruction.
+ *
+ * Consecutive groups of microslices form the windows of the spill
+ * detection.
+ */
+class MicrosliceLoadProfiler : public fles::MicrosliceSink {
+public:
+  explicit MicrosliceLoadProfiler(std::string filename,
+                                  uint64_t window_microslices = 100)
+      : filename_(std::move(filename)),
+        window_microslices_(window_microslices) {}
+
+  ~MicrosliceLoadProfiler() override;
+
+  void put(std::shared_ptr<const fles::Microslice> microslice) override;
+
+private:
+  std::string filename_;
+  uint64_t window_microslices_;
+  uint64_t count_ = 0;
+  LoadProfileLearner learner_;
+};
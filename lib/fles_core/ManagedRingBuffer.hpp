@@ -45,16 +45,18 @@ public:
   }
 
   void append(const T* buf, std::size_t n) {
-    if (&this->at(write_index_) + n <= this->ptr() + this->size()) {
-      // one chunk
-      std::copy(buf, buf + n, &this->at(write_index_));
-    } else {
-      // two chunks
-      size_t a = this->ptr() + this->size() - &this->at(write_index_);
-      std::copy(buf, buf + a, &this->at(write_index_));
-      std::copy(buf + a, buf + n, &this->at(write_index_ + a));
-    }
+    assert(size_available() >= n);
+    this->copy_in(write_index_, buf, n);
+    write_index_ += n;
+  }
+
+  // reserve n entries at the write index to be filled in by the caller,
+  // return the index of the first entry
+  std::size_t reserve(std::size_t n) {
+    assert(size_available() >= n);
+    const std::size_t index = write_index_;
     write_index_ += n;
+    return index;
   }
 
   // skip remaining entries in ring buffer so that n entries can be stored
@@ -1,32 +1,51 @@
 // Copyright 2023 Jan de Cuveland <cmail@cuveland.de>
 
 #include "ManagedTimesliceBuffer.hpp"
+#include "StreamingCopy.hpp"
 #include "Timeslice.hpp"
 #include "TimesliceWorkItem.hpp"
+#include "WorkerPool.hpp"
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <future>
 
 ManagedTimesliceBuffer::ManagedTimesliceBuffer(
     zmq::context_t& context,
     const std::string& shm_identifier,
     uint32_t data_buffer_size_exp,
     uint32_t desc_buffer_size_exp,
-    uint32_t num_input_nodes)
+    uint32_t num_input_nodes,
+    const MemoryPolicy& memory_policy,
+    bool use_shm_item_channel,
+    fles::WorkItemEncoding work_item_encoding,
+    bool persistent,
+    unsigned copy_threads)
     : producer_address_("inproc://" + shm_identifier),
       worker_address_("ipc://@" + shm_identifier),
-      item_distributor_(context, producer_address_, worker_address_),
+      item_distributor_(
+          context, producer_address_, worker_address_,
+          TimesliceBuffer::item_deadline_horizon(desc_buffer_size_exp)),
       timeslice_buffer_(context,
                         producer_address_,
                         shm_identifier,
                         data_buffer_size_exp,
                         desc_buffer_size_exp,
-                        num_input_nodes),
+                        num_input_nodes,
+                        memory_policy,
+                        use_shm_item_channel,
+                        work_item_encoding,
+                        persistent),
       ack_(desc_buffer_size_exp),
       distributor_thread_(std::ref(item_distributor_)) {
   for (uint32_t i = 0; i < num_input_nodes; ++i) {
     desc_.emplace_back(timeslice_buffer_.get_desc_ptr(i),
                        timeslice_buffer_.get_desc_size_exp());
     data_.emplace_back(timeslice_buffer_.get_data_ptr(i),
-                       timeslice_buffer_.get_data_size_exp());
+                       timeslice_buffer_.get_data_size_exp(i));
+  }
+  if (copy_threads > 0) {
+    copy_pool_ = std::make_unique<WorkerPool>(copy_threads);
   }
 }
 
@@ -36,27 +55,38 @@ ManagedTimesliceBuffer::~ManagedTimesliceBuffer() {
 }
 
 void ManagedTimesliceBuffer::handle_timeslice_completions() {
-  fles::TimesliceCompletion c{};
-  while (timeslice_buffer_.try_receive_completion(c)) {
-    if (c.ts_pos == acked_) {
-      do {
-        ++acked_;
-      } while (ack_.at(acked_) > c.ts_pos);
-      for (std::size_t i = 0; i < desc_.size(); ++i) {
-        desc_.at(i).set_read_index(acked_);
-        data_.at(i).set_read_index(desc_.at(i).at(acked_ - 1).offset +
-                                   desc_.at(i).at(acked_ - 1).size);
-      }
-    } else {
-      ack_.at(c.ts_pos) = c.ts_pos;
+  std::lock_guard<std::mutex> lock(mutex_);
+  ItemCompletionBatch batch;
+  while (timeslice_buffer_.try_receive_completions(batch)) {
+    handle_completion_batch(batch);
+  }
+}
+
+void ManagedTimesliceBuffer::handle_completion_batch(
+    const ItemCompletionBatch& batch) {
+  uint64_t acked = std::max(acked_, batch.completed_up_to);
+  // Mark out-of-order completions, then advance over all consecutive ones
+  ack_.erase_below(acked);
+  for (auto ts_pos : batch.completed) {
+    if (ts_pos >= acked && !ack_.contains(ts_pos)) {
+      ack_.insert(ts_pos);
+    }
+  }
+  acked = ack_.erase_run(acked);
+  if (acked != acked_) {
+    acked_ = acked;
+    for (std::size_t i = 0; i < desc_.size(); ++i) {
+      desc_.at(i).set_read_index(acked_);
+      data_.at(i).set_read_index(desc_.at(i).at(acked_ - 1).offset +
+                                 desc_.at(i).at(acked_ - 1).size);
     }
   }
 }
 
 bool ManagedTimesliceBuffer::timeslice_fits_in_buffer(
-    const fles::Timeslice& timeslice) {
-  for (uint64_t i = 0; i < timeslice.num_components(); ++i) {
-    if (data_.at(i).size_available_contiguous() < timeslice.size_component(i) ||
+    const std::vector<fles::TimesliceComponentDescriptor>& tscd) {
+  for (uint64_t i = 0; i < tscd.size(); ++i) {
+    if (data_.at(i).size_available_contiguous() < tscd[i].size ||
         desc_.at(i).size_available() < 1) {
       return false;
     }
@@ -66,39 +96,118 @@ bool ManagedTimesliceBuffer::timeslice_fits_in_buffer(
 
 void ManagedTimesliceBuffer::put(
     std::shared_ptr<const fles::Timeslice> timeslice) {
+  const auto num_components = timeslice->num_components();
+  std::vector<fles::TimesliceComponentDescriptor> tscd(num_components);
+  for (uint64_t i = 0; i < num_components; ++i) {
+    tscd[i] = *timeslice->desc_ptr_[i];
+  }
+  const auto reservation = reserve(std::move(tscd));
+  copy_components(*timeslice, reservation);
+  commit(reservation, timeslice->timeslice_descriptor_);
+}
+
+void ManagedTimesliceBuffer::copy_components(const fles::Timeslice& timeslice,
+                                             const Reservation& reservation) {
+  struct Chunk {
+    uint8_t* dst;
+    const uint8_t* src;
+    std::size_t size;
+  };
+
+  // Split the components into chunks of similar size.
+  std::vector<Chunk> chunks;
+  for (uint64_t i = 0; i < reservation.tscd.size(); ++i) {
+    uint8_t* dst = data_ptr(reservation, i);
+    const uint8_t* src = timeslice.component_data_ptr(i);
+    const std::size_t size = timeslice.size_component(i);
+    for (std::size_t offset = 0; offset < size; offset += copy_chunk_size) {
+      chunks.push_back({dst + offset, src + offset,
+                        std::min(copy_chunk_size, size - offset)});
+    }
+  }
+
+  std::atomic<std::size_t> next_chunk{0};
+  auto copy_chunks = [&chunks, &next_chunk] {
+    std::size_t c = 0;
+    while ((c = next_chunk.fetch_add(1, std::memory_order_relaxed)) <
+           chunks.size()) {
+      streaming_copy(chunks[c].dst, chunks[c].src, chunks[c].size);
+    }
+  };
+
+  // Copy small timeslices on the calling thread only, the pool would not
+  // pay off. Otherwise, the calling thread helps the pool.
+  std::vector<std::future<void>> helpers;
+  if (copy_pool_ != nullptr && chunks.size() > 1) {
+    const auto num_helpers = std::min(copy_pool_->size(), chunks.size() - 1);
+    for (std::size_t i = 0; i < num_helpers; ++i) {
+      helpers.push_back(copy_pool_->submit(copy_chunks));
+    }
+  }
+  copy_chunks();
+  // The helpers refer to the chunks, wait for all of them before rethrowing
+  for (auto& helper : helpers) {
+    helper.wait();
+  }
+  for (auto& helper : helpers) {
+    helper.get();
+  }
+}
+
+ManagedTimesliceBuffer::Reservation ManagedTimesliceBuffer::reserve(
+    std::vector<fles::TimesliceComponentDescriptor> tscd) {
 
   // The existing shared memory TimesliceBuffer has to support the correct
   // number of input nodes.
-  if (timeslice->num_components() != timeslice_buffer_.get_num_input_nodes()) {
+  if (tscd.size() != timeslice_buffer_.get_num_input_nodes()) {
     throw std::runtime_error("Timeslice has wrong number of components");
   }
-  // Poll for timeslice completions until enough space is available.
-  handle_timeslice_completions();
-  while (!timeslice_fits_in_buffer(*timeslice)) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
-    handle_timeslice_completions();
-  }
-
-  // Copy each component to the shared memory buffer.
-  for (uint64_t i = 0; i < timeslice->num_components(); ++i) {
 
+  // Reserve the buffer position and space, waiting for completions until
+  // enough space is available.
+  std::unique_lock<std::mutex> lock(mutex_);
+  ItemCompletionBatch batch;
+  while (timeslice_buffer_.try_receive_completions(batch)) {
+    handle_completion_batch(batch);
+  }
+  while (!timeslice_fits_in_buffer(tscd)) {
+    if (commit_pos_ != ts_pos_) {
+      // Let the pending producers send their work items first, they
+      // need the lock to do so
+      committed_.wait(lock);
+    } else if (timeslice_buffer_.wait_for_completions(batch,
+                                                      completion_timeout)) {
+      handle_completion_batch(batch);
+    }
+  }
+  Reservation reservation{ts_pos_++, std::move(tscd)};
+  for (uint64_t i = 0; i < reservation.tscd.size(); ++i) {
+    const auto size = reservation.tscd[i].size;
     // Skip remaining bytes in the data buffer to avoid a fragmented entry.
-    data_.at(i).skip_buffer_wrap(timeslice->size_component(i));
-
+    data_.at(i).skip_buffer_wrap(size);
     // Rewrite the offset in the timeslice component descriptor.
-    auto* tscd = timeslice->desc_ptr_[i];
-    tscd->offset = data_.at(i).write_index();
+    reservation.tscd[i].offset = data_.at(i).reserve(size);
+    desc_.at(i).reserve(1);
+  }
+  return reservation;
+}
 
-    // Copy the data into the shared memory.
-    data_.at(i).append(timeslice->data_ptr_[i], timeslice->size_component(i));
-    desc_.at(i).append(tscd, 1);
+void ManagedTimesliceBuffer::commit(const Reservation& reservation,
+                                    fles::TimesliceDescriptor tsd) {
+  const auto ts_pos = reservation.ts_pos;
+  for (uint64_t i = 0; i < reservation.tscd.size(); ++i) {
+    desc_.at(i).at(ts_pos) = reservation.tscd[i];
   }
 
   // Rewrite the timeslice index in the descriptor
-  auto tsd = timeslice->timeslice_descriptor_;
-  tsd.ts_pos = ts_pos_++;
+  tsd.ts_pos = ts_pos;
 
-  // Send the work item.
-  timeslice_buffer_.send_work_item({tsd, timeslice_buffer_.get_data_size_exp(),
+  // Send the work item after those of all preceding positions.
+  std::unique_lock<std::mutex> lock(mutex_);
+  committed_.wait(lock, [this, ts_pos] { return commit_pos_ == ts_pos; });
+  timeslice_buffer_.send_work_item({tsd,
+                                    timeslice_buffer_.get_max_data_size_exp(),
                                     timeslice_buffer_.get_desc_size_exp()});
+  ++commit_pos_;
+  committed_.notify_all();
 }
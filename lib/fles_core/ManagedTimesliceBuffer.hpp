@@ -1,20 +1,42 @@
 // Copyright 2023 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include "ItemBitmap.hpp"
 #include "ItemDistributor.hpp"
 #include "ManagedRingBuffer.hpp"
-#include "RingBuffer.hpp"
 #include "Sink.hpp"
 #include "TimesliceBuffer.hpp"
 #include "TimesliceComponentDescriptor.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include <vector>
 #include <zmq.h>
 
+class WorkerPool;
+
 /**
  * \brief The ManagedTimesliceBuffer manages the items in a shared memory
  * TimesliceBuffer. It implements the TimesliceSink interface to receive
  * Timeslice objects.
+ *
+ * Several producers may call put() concurrently. Each call reserves its
+ * buffer position and the space in the data buffers under a lock, copies the
+ * components outside of it, and sends its work item once those of all
+ * preceding positions have been sent, so that work items are always
+ * distributed in buffer order. While the buffer is full, the producers wait
+ * for completions from the item distributor instead of polling.
+ *
+ * With copy threads, put() splits the components of large timeslices into
+ * chunks and copies them concurrently on a thread pool (and the calling
+ * thread), so that a single producer is not limited by the bandwidth of
+ * one copy stream. The work item is sent once all chunks are copied.
+ *
+ * Producers that receive the components from elsewhere can write them in
+ * place instead: reserve() the space, fill in the components at
+ * data_ptr(), and commit() the timeslice.
  */
 class ManagedTimesliceBuffer : public fles::TimesliceSink {
 public:
@@ -23,7 +45,13 @@ public:
                          const std::string& shm_identifier,
                          uint32_t data_buffer_size_exp,
                          uint32_t desc_buffer_size_exp,
-                         uint32_t num_input_nodes);
+                         uint32_t num_input_nodes,
+                         const MemoryPolicy& memory_policy = {},
+                         bool use_shm_item_channel = false,
+                         fles::WorkItemEncoding work_item_encoding =
+                             fles::WorkItemEncoding::Binary,
+                         bool persistent = false,
+                         unsigned copy_threads = 0);
 
   /// The ManagedTimesliceBuffer destructor.
   ~ManagedTimesliceBuffer() override;
@@ -33,13 +61,49 @@ public:
 
   void put(std::shared_ptr<const fles::Timeslice> timeslice) override;
 
+  /// The buffer position and space reserved for a timeslice.
+  struct Reservation {
+    uint64_t ts_pos = 0;
+    std::vector<fles::TimesliceComponentDescriptor> tscd;
+  };
+
+  /// Reserve the space for a timeslice with the given components, waiting
+  /// for completions until enough space is available. The offsets of the
+  /// component descriptors are rewritten.
+  Reservation reserve(std::vector<fles::TimesliceComponentDescriptor> tscd);
+
+  /// Retrieve the reserved space of a component.
+  uint8_t* data_ptr(const Reservation& reservation, uint64_t component) {
+    return &data_.at(component).at(reservation.tscd.at(component).offset);
+  }
+
+  /// Send the work item of a timeslice written to reserved space, after
+  /// those of all preceding positions.
+  void commit(const Reservation& reservation, fles::TimesliceDescriptor tsd);
+
   /// Return true if the buffer is empty.
-  [[nodiscard]] bool empty() const { return acked_ == ts_pos_; }
+  [[nodiscard]] bool empty() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return acked_ == ts_pos_;
+  }
 
   /// Handle pending timeslice completions and advance read indexes.
   void handle_timeslice_completions();
 
 private:
+  /// Maximum time to wait for completions while the buffer is full.
+  static constexpr auto completion_timeout = std::chrono::milliseconds(100);
+
+  /// Size of the chunks copied concurrently by put().
+  static constexpr std::size_t copy_chunk_size = std::size_t{4} << 20;
+
+  /// Copy the components of a timeslice to the reserved space.
+  void copy_components(const fles::Timeslice& timeslice,
+                       const Reservation& reservation);
+
+  /// Handle a batch of completions (with the lock held).
+  void handle_completion_batch(const ItemCompletionBatch& batch);
+
   /// Address that is used for communication between the TimesliceBuffer and the
   /// ItemDistributor.
   const std::string producer_address_;
@@ -53,12 +117,15 @@ private:
   /// Shared memory buffer to store received timeslices.
   TimesliceBuffer timeslice_buffer_;
 
-  /// Buffer to store acknowledged status of timeslices.
-  RingBuffer<uint64_t, true> ack_;
+  /// Timeslices completed out of order (local buffer positions).
+  ItemBitmap ack_;
 
   /// Thread for the ItemDistributor.
   std::thread distributor_thread_;
 
+  /// Additional threads copying the components in put() (if any).
+  std::unique_ptr<WorkerPool> copy_pool_;
+
   /// The index of acknowledged timeslices (local buffer position).
   uint64_t acked_ = 0;
 
@@ -66,10 +133,21 @@ private:
   /// position).
   uint64_t ts_pos_ = 0;
 
+  /// The index of the next timeslice to send the work item of (local buffer
+  /// position). Positions from here to ts_pos_ are being copied.
+  uint64_t commit_pos_ = 0;
+
+  /// Protects the buffer state and the TimesliceBuffer.
+  mutable std::mutex mutex_;
+
+  /// Signals that a work item has been sent.
+  std::condition_variable committed_;
+
   /// ManagedRingBuffer wrappers for the TimesliceComponentDescriptor buffer.
   std::vector<ManagedRingBuffer<fles::TimesliceComponentDescriptor>> desc_;
   std::vector<ManagedRingBuffer<uint8_t>> data_;
 
-  /// Check if the timeslice fits in the buffer.
-  bool timeslice_fits_in_buffer(const fles::Timeslice& timeslice);
+  /// Check if the timeslice fits in the buffer (with the lock held).
+  bool timeslice_fits_in_buffer(
+      const std::vector<fles::TimesliceComponentDescriptor>& tscd);
 };
@@ -0,0 +1,258 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "MemoryPolicy.hpp"
+#include "log.hpp"
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifdef HAVE_NUMA
+#include <numa.h>
+#include <numaif.h>
+#endif
+
+namespace {
+
+std::size_t round_up(std::size_t value, std::size_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+std::runtime_error errno_error(const std::string& what) {
+  return std::runtime_error(what + ": " + strerror(errno));
+}
+
+void bind_to_node(void* addr, std::size_t length, int node) {
+#ifdef HAVE_NUMA
+  if (numa_available() == -1) {
+    throw std::runtime_error("numa_available() failed");
+  }
+  if (node > numa_max_node()) {
+    throw std::runtime_error("invalid NUMA node: " + std::to_string(node));
+  }
+  struct bitmask* nodemask = numa_allocate_nodemask();
+  numa_bitmask_setbit(nodemask, static_cast<unsigned int>(node));
+  long ret = mbind(addr, length, MPOL_BIND, nodemask->maskp,
+                   nodemask->size + 1, 0);
+  numa_free_nodemask(nodemask);
+  if (ret != 0) {
+    throw errno_error("mbind");
+  }
+#else
+  (void)addr;
+  (void)length;
+  (void)node;
+  throw std::runtime_error("NUMA node binding requested, but built without "
+                           "libnuma");
+#endif
+}
+
+// Map a memory file twice in a row, so that the second half mirrors the
+// first one
+void* map_mirrored(std::size_t length, const MemoryPolicy& policy) {
+  unsigned int fd_flags = MFD_CLOEXEC;
+  // the huge page sizes are encoded as for mmap
+  if (policy.huge_pages == HugePages::Size2M) {
+    fd_flags |= MFD_HUGETLB | (21U << MAP_HUGE_SHIFT);
+  } else if (policy.huge_pages == HugePages::Size1G) {
+    fd_flags |= MFD_HUGETLB | (30U << MAP_HUGE_SHIFT);
+  }
+  int fd = memfd_create("flesnet_ring_buffer", fd_flags);
+  if (fd == -1) {
+    throw errno_error("memfd_create (" + policy.description() + ")");
+  }
+  if (ftruncate(fd, static_cast<off_t>(length)) != 0) {
+    const auto error = errno_error("ftruncate");
+    close(fd);
+    throw error;
+  }
+
+  // reserve the address range, then replace both halves by the file
+  void* addr = mmap(nullptr, 2 * length, PROT_NONE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (addr == MAP_FAILED) {
+    const auto error = errno_error("mmap");
+    close(fd);
+    throw error;
+  }
+  for (std::size_t half = 0; half < 2; ++half) {
+    void* half_addr = static_cast<uint8_t*>(addr) + half * length;
+    if (mmap(half_addr, length, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+      const auto error = errno_error("mmap (mirrored)");
+      munmap(addr, 2 * length);
+      close(fd);
+      throw error;
+    }
+  }
+
+  // the mappings persist after the file descriptor has been closed
+  close(fd);
+  return addr;
+}
+
+} // namespace
+
+HugePages parse_huge_pages(const std::string& str) {
+  if (str == "none" || str == "0") {
+    return HugePages::None;
+  }
+  if (str == "thp") {
+    return HugePages::Transparent;
+  }
+  if (str == "2M") {
+    return HugePages::Size2M;
+  }
+  if (str == "1G") {
+    return HugePages::Size1G;
+  }
+  throw std::runtime_error("invalid huge page specification: " + str);
+}
+
+std::size_t MemoryPolicy::page_size() const {
+  switch (huge_pages) {
+  case HugePages::Size2M:
+    return UINT64_C(1) << 21;
+  case HugePages::Size1G:
+    return UINT64_C(1) << 30;
+  default:
+    return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  }
+}
+
+std::string MemoryPolicy::description() const {
+  std::string desc;
+  switch (huge_pages) {
+  case HugePages::None:
+    desc = "regular pages";
+    break;
+  case HugePages::Transparent:
+    desc = "transparent huge pages";
+    break;
+  case HugePages::Size2M:
+    desc = "2 MiB huge pages";
+    break;
+  case HugePages::Size1G:
+    desc = "1 GiB huge pages";
+    break;
+  }
+  if (numa_node >= 0) {
+    desc += " on NUMA node " + std::to_string(numa_node);
+  }
+  if (mirrored) {
+    desc += ", mirrored";
+  }
+  if (device >= 0) {
+    desc += ", data on GPU " + std::to_string(device);
+  }
+  return desc;
+}
+
+void* allocate_memory(std::size_t bytes, const MemoryPolicy& policy) {
+  if (policy.device >= 0) {
+    throw std::runtime_error("GPU placement only supported for timeslice "
+                             "buffers");
+  }
+  const std::size_t length = round_up(bytes, policy.page_size());
+  void* ptr = nullptr;
+  if (policy.mirrored) {
+    if (length != bytes) {
+      throw std::runtime_error(
+          "mirrored buffer size " + std::to_string(bytes) +
+          " is not a multiple of the page size (" + policy.description() +
+          ")");
+    }
+    ptr = map_mirrored(length, policy);
+  } else {
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    if (policy.huge_pages == HugePages::Size2M) {
+      flags |= MAP_HUGETLB | (21 << MAP_HUGE_SHIFT);
+    } else if (policy.huge_pages == HugePages::Size1G) {
+      flags |= MAP_HUGETLB | (30 << MAP_HUGE_SHIFT);
+    }
+    ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (ptr == MAP_FAILED) {
+      throw errno_error("mmap (" + policy.description() + ")");
+    }
+  }
+
+  try {
+    if (policy.huge_pages == HugePages::Transparent &&
+        madvise(ptr, length, MADV_HUGEPAGE) != 0) {
+      L_(warning) << "madvise(MADV_HUGEPAGE) failed: " << strerror(errno);
+    }
+    if (policy.numa_node >= 0) {
+      bind_to_node(ptr, length, policy.numa_node);
+    }
+  } catch (...) {
+    munmap(ptr, policy.mirrored ? 2 * length : length);
+    throw;
+  }
+  return ptr;
+}
+
+void free_memory(void* ptr, std::size_t bytes, const MemoryPolicy& policy) {
+  if (ptr != nullptr) {
+    const std::size_t length = round_up(bytes, policy.page_size());
+    munmap(ptr, policy.mirrored ? 2 * length : length);
+  }
+}
+
+void apply_memory_policy(void* addr, std::size_t bytes,
+                         const MemoryPolicy& policy) {
+  if (policy.huge_pages == HugePages::Size2M ||
+      policy.huge_pages == HugePages::Size1G) {
+    throw std::runtime_error(
+        "explicit huge pages not supported for existing mappings, use 'thp'");
+  }
+  if (policy.mirrored) {
+    throw std::runtime_error("mirroring not supported for existing mappings");
+  }
+  if (policy.device >= 0) {
+    throw std::runtime_error("GPU placement not supported for host mappings");
+  }
+
+  const auto page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+  const auto begin = round_up(reinterpret_cast<uintptr_t>(addr), page_size);
+  const auto end =
+      (reinterpret_cast<uintptr_t>(addr) + bytes) / page_size * page_size;
+  if (end <= begin) {
+    return;
+  }
+  void* ptr = reinterpret_cast<void*>(begin);
+  const std::size_t length = end - begin;
+
+  if (policy.huge_pages == HugePages::Transparent &&
+      madvise(ptr, length, MADV_HUGEPAGE) != 0) {
+    L_(warning) << "madvise(MADV_HUGEPAGE) failed: " << strerror(errno);
+  }
+  if (policy.numa_node >= 0) {
+    bind_to_node(ptr, length, policy.numa_node);
+  }
+}
+
+void prefault_memory(void* addr, std::size_t bytes) {
+  if (bytes == 0) {
+    return;
+  }
+#ifdef MADV_POPULATE_WRITE
+  if (madvise(addr, bytes, MADV_POPULATE_WRITE) == 0) {
+    return;
+  }
+  if (errno != EINVAL) {
+    // the kernel supports it, but cannot populate
+    throw errno_error("madvise(MADV_POPULATE_WRITE)");
+  }
+#endif
+  // older kernels: write-fault every page with an atomic no-op, which keeps
+  // concurrent writes intact
+  const auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  auto* ptr = static_cast<uint8_t*>(addr);
+  for (std::size_t offset = 0; offset < bytes; offset += page_size) {
+    __atomic_fetch_or(ptr + offset, 0, __ATOMIC_RELAXED);
+  }
+  __atomic_fetch_or(ptr + bytes - 1, 0, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the MemoryPolicy struct and buffer allocation functions.
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/// Huge page usage for buffer memory.
+enum class HugePages {
+  None,        ///< Regular pages
+  Transparent, ///< Transparent huge pages (madvise)
+  Size2M,      ///< Explicit 2 MiB huge pages (MAP_HUGETLB)
+  Size1G       ///< Explicit 1 GiB huge pages (MAP_HUGETLB)
+};
+
+/// Parse a huge page specification ("none", "thp", "2M", or "1G").
+HugePages parse_huge_pages(const std::string& str);
+
+/// Placement policy for large buffers.
+struct MemoryPolicy {
+  /// The huge page usage.
+  HugePages huge_pages = HugePages::None;
+
+  /// The NUMA node to bind the memory to, or -1 for no binding.
+  int numa_node = -1;
+
+  /// Map ring buffer memory twice in a row (see allocate_memory()).
+  bool mirrored = false;
+
+  /// The GPU device to place the data in, or -1 for host memory. Only
+  /// supported for the data buffers of a TimesliceBuffer.
+  int device = -1;
+
+  /// Return true if this is the default policy (plain allocation).
+  [[nodiscard]] bool is_default() const {
+    return huge_pages == HugePages::None && numa_node < 0 && !mirrored &&
+           device < 0;
+  }
+
+  /// Retrieve the policy with the GPU device placement removed.
+  [[nodiscard]] MemoryPolicy host_policy() const {
+    MemoryPolicy policy = *this;
+    policy.device = -1;
+    return policy;
+  }
+
+  /// Retrieve the page size used for allocations with this policy.
+  [[nodiscard]] std::size_t page_size() const;
+
+  /// Retrieve a human-readable description of the policy.
+  [[nodiscard]] std::string description() const;
+};
+
+/**
+ * \brief Allocate private anonymous memory according to the policy.
+ *
+ * The size is rounded up to a multiple of the policy's page size. With
+ * explicit huge pages, the allocation fails if the kernel's huge page pool
+ * is exhausted.
+ *
+ * With a mirrored policy, the memory is mapped a second time directly
+ * behind the first mapping, so that an access beyond the end continues at
+ * the beginning. Ring buffer contents that wrap around are thus contiguous
+ * in virtual memory. The size must be a multiple of the page size.
+ *
+ * \return Pointer to the zero-initialized memory
+ * \throws std::runtime_error if the allocation or binding fails or a GPU
+ * device is requested
+ */
+void* allocate_memory(std::size_t bytes, const MemoryPolicy& policy);
+
+/// Free memory obtained from allocate_memory() with identical arguments.
+void free_memory(void* ptr, std::size_t bytes, const MemoryPolicy& policy);
+
+/**
+ * \brief Apply huge page advice and NUMA binding to an existing mapping.
+ *
+ * Only the whole pages within the given range are affected. This is meant
+ * for shared memory regions that have not yet been touched. Explicit huge
+ * pages, mirroring and GPU placement cannot be applied to an existing
+ * mapping.
+ *
+ * \throws std::runtime_error if the binding fails or explicit huge pages,
+ * mirroring or a GPU device are requested
+ */
+void apply_memory_policy(void* addr, std::size_t bytes,
+                         const MemoryPolicy& policy);
+
+/**
+ * \brief Populate all pages of a writable mapping.
+ *
+ * The pages are faulted in at once (MADV_POPULATE_WRITE, or by touching
+ * every page on older kernels), so that the first accesses in the data
+ * path do not fault. The contents are left unchanged, even if the memory
+ * is written concurrently. Memory policies must be applied before.
+ *
+ * \throws std::runtime_error if the pages cannot be populated
+ */
+void prefault_memory(void* addr, std::size_t bytes);
@@ -4,7 +4,6 @@
 #include "PatternChecker.hpp"
 #include "TimesliceDebugger.hpp"
 #include "Utility.hpp"
-#include <cassert>
 #include <sstream>
 
 MicrosliceAnalyzer::MicrosliceAnalyzer(uint64_t arg_output_interval,
@@ -14,29 +13,26 @@ MicrosliceAnalyzer::MicrosliceAnalyzer(uint64_t arg_output_interval,
                                        size_t component)
     : output_interval_(arg_output_interval), out_verbosity_(arg_out_verbosity),
       out_(arg_out), output_prefix_(std::move(arg_output_prefix)),
-      component_(component) {
-  // create CRC-32C engine (Castagnoli polynomial)
-  crc32_engine_ = crcutil_interface::CRC::Create(
-      0x82f63b78, 0, 32, true, 0, 0, 0,
-      crcutil_interface::CRC::IsSSE42Available(), nullptr);
-}
+      component_(component),
+      live_microslices_(cbm::LiveStats::Counter("ms_analyzer_microslices")),
+      live_content_bytes_(
+          cbm::LiveStats::Counter("ms_analyzer_content_bytes")),
+      live_errors_(cbm::LiveStats::Counter("ms_analyzer_errors")),
+      live_truncated_(cbm::LiveStats::Counter("ms_analyzer_truncated")) {}
 
-MicrosliceAnalyzer::~MicrosliceAnalyzer() {
-  if (crc32_engine_ != nullptr) {
-    crc32_engine_->Delete();
-  }
-}
+MicrosliceAnalyzer::~MicrosliceAnalyzer() = default;
 
 uint32_t MicrosliceAnalyzer::compute_crc(const fles::Microslice& ms) const {
-  assert(crc32_engine_);
-
-  crcutil_interface::UINT64 crc64 = 0;
-  crc32_engine_->Compute(ms.content(), ms.desc().size, &crc64);
-
-  return static_cast<uint32_t>(crc64);
+  return crcutil_interface::Crc32c(ms.content(), ms.desc().size);
 }
 
 bool MicrosliceAnalyzer::check_crc(const fles::Microslice& ms) const {
+  // rely on a previous check by flesnet
+  if ((ms.desc().flags &
+       static_cast<uint16_t>(fles::MicrosliceFlags::CrcChecked)) != 0) {
+    return (ms.desc().flags &
+            static_cast<uint16_t>(fles::MicrosliceFlags::CrcError)) == 0;
+  }
   return compute_crc(ms) == ms.desc().crc;
 }
 
@@ -45,6 +41,7 @@ void MicrosliceAnalyzer::initialize(const fles::Microslice& ms) {
   reference_descriptor_ = desc;
   pattern_checker_ =
       PatternChecker::create(desc.sys_id, desc.sys_ver, component_);
+  live_sizes_ = cbm::LiveStats::Histogram("microslice_size", desc.eq_id);
 }
 
 bool MicrosliceAnalyzer::check_microslice(const fles::Microslice& ms) {
@@ -86,6 +83,7 @@ bool MicrosliceAnalyzer::check_microslice(const fles::Microslice& ms) {
            << microslice_count_ << std::endl;
     }
     ++microslice_truncated_count_;
+    live_truncated_.Add();
   }
 
   if (!pattern_checker_->check(ms)) {
@@ -114,10 +112,14 @@ bool MicrosliceAnalyzer::check_microslice(const fles::Microslice& ms) {
            << BufferDump(ms.content(), ms.desc().size) << std::flush;
     }
     ++microslice_error_count_;
+    live_errors_.Add();
   }
 
   ++microslice_count_;
   content_bytes_ += ms.desc().size;
+  live_microslices_.Add();
+  live_content_bytes_.Add(ms.desc().size);
+  live_sizes_.Record(ms.desc().size);
   previous_start_ = ms.desc().idx;
 
   return result;
@@ -136,8 +138,8 @@ std::string MicrosliceAnalyzer::statistics() const {
   return s.str();
 }
 
-void MicrosliceAnalyzer::put(std::shared_ptr<const fles::Microslice> ms) {
-  if (!check_microslice(*ms)) {
+void MicrosliceAnalyzer::consume(const fles::Microslice& ms) {
+  if (!check_microslice(ms)) {
     // for now we do not reset the checker to follow ms count across errors
     // pattern_checker_->reset();
   }
@@ -1,17 +1,19 @@
 // Copyright 2015 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include "LiveStats.hpp"
 #include "Microslice.hpp"
 #include "MicrosliceDescriptor.hpp"
-#include "Sink.hpp"
-#include "interface.h" // crcutil_interface
+#include "StaticPipeline.hpp"
+#include "crc32c_batch.h" // crcutil_interface::Crc32c
 #include <memory>
 #include <ostream>
 #include <string>
 
 class PatternChecker;
 
-class MicrosliceAnalyzer : public fles::MicrosliceSink {
+class MicrosliceAnalyzer
+    : public fles::StaticSink<MicrosliceAnalyzer, fles::Microslice> {
 public:
   MicrosliceAnalyzer(uint64_t arg_output_interval,
                      size_t arg_out_verbosity,
@@ -20,7 +22,7 @@ public:
                      size_t component = 0);
   ~MicrosliceAnalyzer() override;
 
-  void put(std::shared_ptr<const fles::Microslice> ms) override;
+  void consume(const fles::Microslice& ms);
 
 private:
   bool check_microslice(const fles::Microslice& ms);
@@ -33,8 +35,6 @@ private:
 
   void initialize(const fles::Microslice& ms);
 
-  crcutil_interface::CRC* crc32_engine_ = nullptr;
-
   fles::MicrosliceDescriptor reference_descriptor_{};
   std::unique_ptr<PatternChecker> pattern_checker_;
 
@@ -51,4 +51,11 @@ private:
   size_t microslice_error_count_ = 0;
   size_t microslice_truncated_count_ = 0;
   size_t content_bytes_ = 0;
+
+  /// Live statistics of the checked data (see cbm::LiveStats).
+  cbm::LiveCounter live_microslices_;
+  cbm::LiveCounter live_content_bytes_;
+  cbm::LiveCounter live_errors_;
+  cbm::LiveCounter live_truncated_;
+  cbm::LiveHistogram live_sizes_;
 };
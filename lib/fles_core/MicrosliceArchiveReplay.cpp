@@ -0,0 +1,238 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "MicrosliceArchiveReplay.hpp"
+#include "ArchiveCursor.hpp"
+#include "System.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <ios>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+std::size_t size_exponent(std::size_t size) {
+  std::size_t exp = 0;
+  while ((std::size_t{1} << exp) < size) {
+    ++exp;
+  }
+  return exp;
+}
+
+} // namespace
+
+MicrosliceArchiveReplay::MicrosliceArchiveReplay(
+    const std::string& filename,
+    std::size_t desc_buffer_size_exp,
+    uint64_t loops,
+    bool pace,
+    const MemoryPolicy& memory_policy)
+    : mapping_(map_file(filename, loops != 1)),
+      desc_buffer_(desc_buffer_size_exp, memory_policy),
+      data_buffer_view_(mapping_.data, mapping_.size_exp),
+      desc_buffer_view_(desc_buffer_.ptr(), desc_buffer_size_exp,
+                        desc_buffer_.mirrored()),
+      pace_(pace) {
+  try {
+    build_index(filename);
+  } catch (...) {
+    munmap(mapping_.data, std::size_t{1} << mapping_.size_exp);
+    throw;
+  }
+  limit_ = loops * microslices_.size();
+
+  if (microslices_.size() > 1) {
+    // continue with the mean microslice index increment
+    idx_step_ = (microslices_.back().idx - microslices_.front().idx) /
+                (microslices_.size() - 1);
+  }
+
+  begin_ = std::chrono::high_resolution_clock::now();
+}
+
+MicrosliceArchiveReplay::~MicrosliceArchiveReplay() {
+  munmap(mapping_.data, std::size_t{1} << mapping_.size_exp);
+}
+
+MicrosliceArchiveReplay::Mapping
+MicrosliceArchiveReplay::map_file(const std::string& filename, bool repeat) {
+  int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    throw std::ios_base::failure("error opening file \"" + filename +
+                                 "\": " + fles::system::stringerror(errno));
+  }
+
+  struct stat st {};
+  if (fstat(fd, &st) == -1) {
+    int err = errno;
+    close(fd);
+    throw std::ios_base::failure("error accessing file \"" + filename +
+                                 "\": " + fles::system::stringerror(err));
+  }
+  const auto file_size = static_cast<std::size_t>(st.st_size);
+  const auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  const std::size_t size_exp =
+      size_exponent(std::max(file_size, page_size));
+  const std::size_t size = std::size_t{1} << size_exp;
+
+  // Reserve the complete data buffer, then map the file into it. The
+  // mapping is private and writable, as required for RDMA registration.
+  void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  std::size_t repeat_offset = 0;
+  if (addr != MAP_FAILED && file_size > 0) {
+    void* file_addr = mmap(addr, file_size, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_FIXED, fd, 0);
+    repeat_offset = (file_size + page_size - 1) / page_size * page_size;
+    if (file_addr != MAP_FAILED && repeat && repeat_offset < size) {
+      file_addr = mmap(static_cast<uint8_t*>(addr) + repeat_offset,
+                       std::min(file_size, size - repeat_offset),
+                       PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0);
+    } else {
+      repeat_offset = 0;
+    }
+    if (file_addr == MAP_FAILED) {
+      int err = errno;
+      munmap(addr, size);
+      close(fd);
+      throw std::ios_base::failure("error mapping file \"" + filename +
+                                   "\": " + fles::system::stringerror(err));
+    }
+  }
+  if (addr == MAP_FAILED) {
+    int err = errno;
+    close(fd);
+    throw std::ios_base::failure("error mapping file \"" + filename +
+                                 "\": " + fles::system::stringerror(err));
+  }
+  // The contents are typically consumed front to back
+  madvise(addr, file_size, MADV_SEQUENTIAL);
+
+  // The mapping persists after the file descriptor has been closed
+  close(fd);
+  return {static_cast<uint8_t*>(addr), size_exp, file_size, repeat_offset};
+}
+
+void MicrosliceArchiveReplay::build_index(const std::string& filename) {
+  fles::ArchiveCursor cursor(mapping_.data, mapping_.file_size, 0);
+  const fles::ArchiveDescriptor descriptor =
+      cursor.read_archive_descriptor(filename);
+  if (descriptor.archive_type() != fles::ArchiveType::MicrosliceArchive) {
+    throw std::runtime_error("File \"" + filename +
+                             "\" is not of correct archive type");
+  }
+  if (descriptor.archive_compression() != fles::ArchiveCompression::None) {
+    throw std::runtime_error("Compressed archive file \"" + filename +
+                             "\" cannot be memory-mapped");
+  }
+
+  while (!cursor.at_end()) {
+    try {
+      // StorableMicroslice::serialize()
+      if (microslices_.empty()) {
+        cursor.read_class_info(); // StorableMicroslice
+        cursor.read_class_info(); // MicrosliceDescriptor
+      }
+      // The serialized members have the layout of the packed struct
+      fles::MicrosliceDescriptor desc{};
+      std::memcpy(&desc, cursor.skip(sizeof(desc)), sizeof(desc));
+      // content_: std::vector<uint8_t>
+      auto size = cursor.read<uint64_t>();
+      if (size != desc.size) {
+        throw std::runtime_error("inconsistent microslice in archive file \"" +
+                                 filename + "\"");
+      }
+      desc.offset = cursor.offset();
+      cursor.skip(size);
+      microslices_.push_back(desc);
+    } catch (const fles::TruncatedArchive&) {
+      L_(warning) << "ignoring incomplete microslice at end of file \""
+                  << filename << "\"";
+      break;
+    }
+  }
+
+  if (microslices_.empty()) {
+    throw std::runtime_error("Archive file \"" + filename +
+                             "\" contains no microslices");
+  }
+
+  if (mapping_.repeat_offset != 0) {
+    const std::size_t repeat_size =
+        std::min(mapping_.file_size,
+                 data_buffer_view_.bytes() - mapping_.repeat_offset);
+    while (repeat_count_ < microslices_.size() &&
+           microslices_[repeat_count_].offset +
+                   microslices_[repeat_count_].size <=
+               repeat_size) {
+      ++repeat_count_;
+    }
+  }
+}
+
+void MicrosliceArchiveReplay::proceed() {
+  const uint64_t buffer_bytes = data_buffer_view_.bytes();
+
+  while (!eof_) {
+    if (limit_ != 0 && write_index_.desc == limit_) {
+      eof_ = true;
+      break;
+    }
+
+    const fles::MicrosliceDescriptor& entry = microslices_[next_];
+    const uint64_t offset = period_ * buffer_bytes +
+                            (in_repeat_ ? mapping_.repeat_offset : 0) +
+                            entry.offset;
+    const uint64_t idx = entry.idx + idx_shift_;
+
+    // check for space in data and descriptor buffers
+    if ((offset + entry.size - read_index_.data > buffer_bytes) ||
+        (write_index_.desc - read_index_.desc + 1 > desc_buffer_.size())) {
+      break;
+    }
+
+    // check for current time (pacing to the microslice index)
+    if (pace_) {
+      auto delta = std::chrono::high_resolution_clock::now() - begin_;
+      auto delta_ns =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(delta).count();
+      auto required_ns = static_cast<int64_t>(idx - microslices_.front().idx);
+      if (delta_ns < required_ns) {
+        break;
+      }
+    }
+
+    fles::MicrosliceDescriptor& desc = desc_buffer_.at(write_index_.desc);
+    desc = entry;
+    desc.idx = idx;
+    desc.offset = offset;
+    write_index_ = {write_index_.desc + 1, offset + entry.size};
+
+    advance();
+  }
+}
+
+void MicrosliceArchiveReplay::advance() {
+  ++next_;
+  const std::size_t end = in_repeat_ ? repeat_count_ : microslices_.size();
+  if (next_ < end) {
+    return;
+  }
+
+  // restart at the first microslice, continuing the microslice index
+  idx_shift_ +=
+      microslices_[next_ - 1].idx - microslices_.front().idx + idx_step_;
+  next_ = 0;
+  if (!in_repeat_ && repeat_count_ > 0) {
+    in_repeat_ = true;
+  } else {
+    in_repeat_ = false;
+    ++period_;
+  }
+}
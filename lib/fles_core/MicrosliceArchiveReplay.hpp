@@ -0,0 +1,126 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the MicrosliceArchiveReplay class.
+#pragma once
+
+#include "DualRingBuffer.hpp"
+#include "MicrosliceDescriptor.hpp"
+#include "RingBuffer.hpp"
+#include "RingBufferView.hpp"
+#include <chrono>
+#include <string>
+#include <vector>
+
+/// Input buffer replaying the microslices of an archive file.
+/** The uncompressed microslice archive file is memory-mapped as the data
+    buffer, so the microslice contents are passed on without any copy. Only
+    the descriptors are written to a separate descriptor buffer, with their
+    offsets pointing to the contents in the mapped file.
+
+    The data buffer spans the file size rounded up to a power of two. When
+    looping, the remaining space holds a second mapping of the file, from
+    which the leading microslices are replayed once more before the buffer
+    wraps around. The microslice indexes are continued across the repeats. */
+class MicrosliceArchiveReplay : public InputBufferReadInterface {
+public:
+  /**
+   * \brief The MicrosliceArchiveReplay constructor.
+   *
+   * \param filename File name of the microslice archive
+   * \param desc_buffer_size_exp Size exponent of the descriptor buffer
+   * \param loops Number of times to replay the archive (0: infinite)
+   * \param pace Pace the microslices according to their index (in ns)
+   * \param memory_policy Placement of the descriptor buffer
+   */
+  MicrosliceArchiveReplay(const std::string& filename,
+                          std::size_t desc_buffer_size_exp,
+                          uint64_t loops = 1,
+                          bool pace = false,
+                          const MemoryPolicy& memory_policy = {});
+
+  ~MicrosliceArchiveReplay() override;
+
+  MicrosliceArchiveReplay(const MicrosliceArchiveReplay&) = delete;
+  void operator=(const MicrosliceArchiveReplay&) = delete;
+
+  RingBufferView<uint8_t>& data_buffer() override { return data_buffer_view_; }
+
+  RingBufferView<fles::MicrosliceDescriptor>& desc_buffer() override {
+    return desc_buffer_view_;
+  }
+
+  void proceed() override;
+
+  DualIndex get_write_index() override { return write_index_; }
+
+  bool get_eof() override { return eof_; }
+
+  void set_read_index(DualIndex new_read_index) override {
+    read_index_ = new_read_index;
+  }
+
+  DualIndex get_read_index() override { return read_index_; }
+
+  /// Retrieve the number of microslices in the archive file.
+  [[nodiscard]] std::size_t num_microslices() const {
+    return microslices_.size();
+  }
+
+private:
+  /// Memory mapping of the archive file.
+  struct Mapping {
+    /// Start of the data buffer (file size rounded up to a power of two).
+    uint8_t* data;
+    std::size_t size_exp;
+    std::size_t file_size;
+    /// Offset of the second file mapping in the data buffer (0: none).
+    std::size_t repeat_offset;
+  };
+
+  /// Map the file, adding a second mapping if repeat is set.
+  static Mapping map_file(const std::string& filename, bool repeat);
+
+  Mapping mapping_;
+
+  /// Input descriptor buffer.
+  RingBuffer<fles::MicrosliceDescriptor, true> desc_buffer_;
+
+  RingBufferView<uint8_t> data_buffer_view_;
+  RingBufferView<fles::MicrosliceDescriptor> desc_buffer_view_;
+
+  /// Descriptors of the archived microslices, offset points into the file.
+  std::vector<fles::MicrosliceDescriptor> microslices_;
+
+  /// Number of leading microslices contained in the second file mapping.
+  std::size_t repeat_count_ = 0;
+
+  /// Total number of microslices to replay (0: infinite).
+  uint64_t limit_ = 0;
+  bool pace_;
+  std::chrono::high_resolution_clock::time_point begin_;
+
+  /// Position of the next microslice: buffer period, mapping, and entry.
+  uint64_t period_ = 0;
+  bool in_repeat_ = false;
+  std::size_t next_ = 0;
+
+  /// Index increment after the archive, and the resulting index shift.
+  uint64_t idx_step_ = 0;
+  uint64_t idx_shift_ = 0;
+
+  /// Number of acknowledged data bytes and microslices. Updated by input
+  /// node.
+  DualIndex read_index_{0, 0};
+
+  /// Number of written microslices and data bytes.
+  DualIndex write_index_{0, 0};
+
+  bool eof_ = false;
+
+  /// Build the list of microslices from the mapped archive.
+  void build_index(const std::string& filename);
+
+  /// Advance to the next microslice.
+  void advance();
+};
@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "MicrosliceCrcChecker.hpp"
+#include <stdexcept>
+
+CrcCheckMode parse_crc_check_mode(const std::string& mode) {
+  if (mode == "none") {
+    return CrcCheckMode::None;
+  }
+  if (mode == "verify") {
+    return CrcCheckMode::Verify;
+  }
+  if (mode == "compute") {
+    return CrcCheckMode::Compute;
+  }
+  throw std::invalid_argument("invalid crc check mode: " + mode);
+}
+
+void MicrosliceCrcChecker::check(fles::MicrosliceDescriptor* descs,
+                                 uint64_t count,
+                                 const uint8_t* content) {
+  if (mode_ == CrcCheckMode::None || count == 0) {
+    return;
+  }
+  constexpr auto crc_valid =
+      static_cast<uint16_t>(fles::MicrosliceFlags::CrcValid);
+  constexpr auto crc_checked =
+      static_cast<uint16_t>(fles::MicrosliceFlags::CrcChecked);
+  constexpr auto crc_error =
+      static_cast<uint16_t>(fles::MicrosliceFlags::CrcError);
+
+  // compute the CRC-32C of all microslices to process in one batch
+  buffers_.resize(count);
+  values_.resize(count);
+  const uint64_t first_offset = descs[0].offset;
+  for (uint64_t i = 0; i < count; ++i) {
+    const auto& desc = descs[i];
+    bool process = (desc.flags & crc_checked) == 0 &&
+                   ((desc.flags & crc_valid) != 0 ||
+                    mode_ == CrcCheckMode::Compute);
+    if (process) {
+      buffers_[i] = {content + (desc.offset - first_offset), desc.size};
+    } else {
+      buffers_[i] = {nullptr, 0};
+    }
+  }
+  crcutil_interface::Crc32cBatch(buffers_.data(), count, values_.data());
+
+  for (uint64_t i = 0; i < count; ++i) {
+    auto& desc = descs[i];
+    if (buffers_[i].data == nullptr) {
+      continue;
+    }
+    if ((desc.flags & crc_valid) == 0) {
+      desc.crc = values_[i];
+      desc.flags |= crc_valid | crc_checked;
+      ++computed_;
+      continue;
+    }
+    desc.flags |= crc_checked;
+    ++checked_;
+    if (values_[i] != desc.crc) {
+      desc.flags |= crc_error;
+      ++errors_;
+    }
+  }
+}
@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the MicrosliceCrcChecker class.
+#pragma once
+
+#include "MicrosliceDescriptor.hpp"
+#include "crc32c_batch.h" // crcutil_interface::CrcBuffer
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// The CRC handling of a MicrosliceCrcChecker.
+enum class CrcCheckMode {
+  None,   ///< Leave the microslices untouched
+  Verify, ///< Verify the microslices with a valid CRC
+  Compute ///< Also compute the CRC of the microslices without a valid one
+};
+
+/// Parse a CRC check mode ("none", "verify" or "compute").
+/** Throws std::invalid_argument for an unknown mode. */
+CrcCheckMode parse_crc_check_mode(const std::string& mode);
+
+/**
+ * \brief Checks the CRCs of the microslices of timeslice components once.
+ *
+ * A MicrosliceCrcChecker computes the CRC-32C of the microslice contents of
+ * a component in one batch and records the result in the descriptors:
+ * verified microslices are flagged with MicrosliceFlags::CrcChecked, and
+ * additionally with MicrosliceFlags::CrcError on a mismatch. In compute
+ * mode, microslices without a valid CRC get one and are flagged with
+ * MicrosliceFlags::CrcValid and MicrosliceFlags::CrcChecked. Microslices
+ * already flagged as checked are skipped, and consumers can rely on the
+ * flags instead of reading the contents again.
+ */
+class MicrosliceCrcChecker {
+public:
+  explicit MicrosliceCrcChecker(CrcCheckMode mode) : mode_(mode) {}
+
+  /// Retrieve the CRC check mode.
+  [[nodiscard]] CrcCheckMode mode() const { return mode_; }
+
+  /// Check the microslices of a component.
+  /** The contents follow the descriptors as in a timeslice component, i.e.,
+      the content of microslice i starts at content + descs[i].offset -
+      descs[0].offset. */
+  void check(fles::MicrosliceDescriptor* descs,
+             uint64_t count,
+             const uint8_t* content);
+
+  /// Retrieve the number of microslices verified.
+  [[nodiscard]] uint64_t checked() const { return checked_; }
+
+  /// Retrieve the number of microslices with a CRC computed.
+  [[nodiscard]] uint64_t computed() const { return computed_; }
+
+  /// Retrieve the number of microslices that failed verification.
+  [[nodiscard]] uint64_t errors() const { return errors_; }
+
+private:
+  CrcCheckMode mode_;
+  std::vector<crcutil_interface::CrcBuffer> buffers_;
+  std::vector<uint32_t> values_;
+  uint64_t checked_ = 0;
+  uint64_t computed_ = 0;
+  uint64_t errors_ = 0;
+};
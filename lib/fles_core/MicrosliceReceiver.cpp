@@ -1,8 +1,8 @@
 // Copyright 2015 Jan de Cuveland <cmail@cuveland.de>
 
 #include "MicrosliceReceiver.hpp"
-#include <chrono>
-#include <thread>
+#include <cassert>
+#include <utility>
 
 namespace fles {
 
@@ -11,7 +11,25 @@ MicrosliceReceiver::MicrosliceReceiver(InputBufferReadInterface& data_source)
       write_index_desc_(data_source_.get_write_index().desc),
       read_index_desc_(data_source_.get_read_index().desc) {}
 
+void MicrosliceReceiver::skip_lost() {
+  const uint64_t retained = data_source_.get_retained_index().desc;
+  if (read_index_desc_ < retained) {
+    lost_microslices_ += retained - read_index_desc_;
+    read_index_desc_ = retained;
+  }
+}
+
+bool MicrosliceReceiver::overwritten(uint64_t desc_index,
+                                     uint64_t data_offset) {
+  const DualIndex retained = data_source_.get_retained_index();
+  return retained.desc > desc_index || retained.data > data_offset;
+}
+
 StorableMicroslice* MicrosliceReceiver::try_get() {
+  if (data_source_.lossy()) {
+    skip_lost();
+  }
+
   // update write_index if needed
   if (write_index_desc_ <= read_index_desc_) {
     write_index_desc_ = data_source_.get_write_index().desc;
@@ -29,7 +47,22 @@ StorableMicroslice* MicrosliceReceiver::try_get() {
 
     StorableMicroslice* sms;
 
-    if (data_begin <= data_end) {
+    // refer to the data buffer unless the writer may overwrite it
+    const bool referenced =
+        zero_copy_ && !data_source_.lossy() && data_begin <= data_end;
+    // a copy is released right away, but may have to wait for the
+    // outstanding microslices before it
+    const bool tracked = track(offset_end, !referenced);
+
+    if (referenced) {
+      auto release = [outstanding = outstanding_, index = read_index_desc_] {
+        std::lock_guard<std::mutex> lock(outstanding->mutex);
+        outstanding->entries.at(index - outstanding->first_desc).second = true;
+      };
+      // NOLINTNEXTLINE
+      sms = new StorableMicroslice(
+          desc, SharedContent(data_begin, desc.size, std::move(release)));
+    } else if (data_begin <= data_end) {
       // NOLINTNEXTLINE
       sms = new StorableMicroslice(
           const_cast<const fles::MicrosliceDescriptor&>(desc),
@@ -49,12 +82,30 @@ StorableMicroslice* MicrosliceReceiver::try_get() {
 
       // NOLINTNEXTLINE
       sms = new StorableMicroslice(
-          const_cast<const fles::MicrosliceDescriptor&>(desc), data);
+          const_cast<const fles::MicrosliceDescriptor&>(desc),
+          std::move(data));
+    }
+
+    // the copy is only valid if the writer has not yet reached it
+    if (data_source_.lossy() &&
+        overwritten(read_index_desc_, sms->desc().offset)) {
+      delete sms; // NOLINT
+      const uint64_t lost = read_index_desc_;
+      skip_lost();
+      if (read_index_desc_ == lost) {
+        ++read_index_desc_;
+        ++lost_microslices_;
+      }
+      return nullptr;
     }
 
     ++read_index_desc_;
 
-    data_source_.set_read_index({read_index_desc_, offset_end});
+    if (tracked) {
+      advance_released();
+    } else {
+      data_source_.set_read_index({read_index_desc_, offset_end});
+    }
 
     return sms;
   }
@@ -62,6 +113,7 @@ StorableMicroslice* MicrosliceReceiver::try_get() {
 }
 
 StorableMicroslice* MicrosliceReceiver::do_get() {
+  assert(!batch_held_);
   if (eos_) {
     return nullptr;
   }
@@ -69,18 +121,127 @@ StorableMicroslice* MicrosliceReceiver::do_get() {
   // wait until a microslice is available in the input buffer
   StorableMicroslice* sms = nullptr;
   while (sms == nullptr) {
+    advance_released();
     data_source_.proceed();
     sms = try_get();
     if (sms == nullptr) {
+      const DualIndex write_index = data_source_.get_write_index();
+      if (write_index.desc > read_index_desc_) {
+        continue;
+      }
       if (data_source_.get_eof() &&
           read_index_desc_ == data_source_.get_write_index().desc) {
         eos_ = true;
         return nullptr;
       }
-      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      data_source_.wait_for_write_index(write_index, index_wait_timeout);
     }
   }
 
   return sms;
 }
+
+bool MicrosliceReceiver::wait_for_microslice() {
+  while (true) {
+    data_source_.proceed();
+    const DualIndex write_index = data_source_.get_write_index();
+    write_index_desc_ = write_index.desc;
+    if (write_index_desc_ > read_index_desc_) {
+      return true;
+    }
+    if (data_source_.get_eof() &&
+        read_index_desc_ == data_source_.get_write_index().desc) {
+      eos_ = true;
+      return false;
+    }
+    data_source_.wait_for_write_index(write_index, index_wait_timeout);
+  }
+}
+
+bool MicrosliceReceiver::track(uint64_t offset_end, bool released) {
+  std::lock_guard<std::mutex> lock(outstanding_->mutex);
+  auto& entries = outstanding_->entries;
+  if (released && entries.empty()) {
+    return false;
+  }
+  if (entries.empty()) {
+    outstanding_->first_desc = read_index_desc_;
+  }
+  entries.emplace_back(offset_end, released);
+  return true;
+}
+
+void MicrosliceReceiver::advance_released() {
+  std::lock_guard<std::mutex> lock(outstanding_->mutex);
+  auto& entries = outstanding_->entries;
+  if (entries.empty() || !entries.front().second) {
+    return;
+  }
+  uint64_t offset_end = 0;
+  while (!entries.empty() && entries.front().second) {
+    offset_end = entries.front().first;
+    entries.pop_front();
+    ++outstanding_->first_desc;
+  }
+  data_source_.set_read_index({outstanding_->first_desc, offset_end});
+}
+
+MicrosliceBatch MicrosliceReceiver::get_batch(std::size_t max_count) {
+  assert(!batch_held_);
+  advance_released();
+  assert(outstanding_->entries.empty());
+  std::vector<MicrosliceView> views = std::move(batch_views_);
+  views.clear();
+
+  if (data_source_.lossy()) {
+    // the views of a batch are not protected against being overwritten
+    skip_lost();
+  }
+  if (eos_ || max_count == 0 || !wait_for_microslice()) {
+    return {nullptr, std::move(views), {}};
+  }
+
+  RingBufferView<uint8_t>& data_buffer = data_source_.data_buffer();
+  uint64_t offset_end = 0;
+  while (read_index_desc_ < write_index_desc_ && views.size() < max_count) {
+    MicrosliceDescriptor& desc =
+        data_source_.desc_buffer().at(read_index_desc_);
+    uint8_t* content = &data_buffer.at(desc.offset);
+
+    const std::size_t begin = desc.offset & data_buffer.size_mask();
+    if (begin + desc.size > data_buffer.bytes()) {
+      // only the first microslice of a batch may wrap around, it is copied
+      if (!views.empty()) {
+        break;
+      }
+      const std::size_t first = data_buffer.bytes() - begin;
+      wrap_buffer_.assign(content, content + first);
+      wrap_buffer_.insert(wrap_buffer_.end(), data_buffer.ptr(),
+                          data_buffer.ptr() + (desc.size - first));
+      content = wrap_buffer_.data();
+    }
+
+    views.emplace_back(desc, content);
+    offset_end = desc.offset + desc.size;
+    ++read_index_desc_;
+  }
+
+  batch_held_ = true;
+  return {this, std::move(views), {read_index_desc_, offset_end}};
+}
+
+void MicrosliceReceiver::release_batch(DualIndex end,
+                                       std::vector<MicrosliceView> views) {
+  assert(batch_held_);
+  data_source_.set_read_index(end);
+  batch_views_ = std::move(views);
+  batch_held_ = false;
+}
+
+MicrosliceBatch::~MicrosliceBatch() {
+  if (receiver_ != nullptr) {
+    receiver_->release_batch(end_, std::move(views_));
+  }
+}
+
 } // namespace fles
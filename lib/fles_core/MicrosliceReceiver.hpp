@@ -5,13 +5,78 @@
 
 #include "DualRingBuffer.hpp"
 #include "MicrosliceSource.hpp"
+#include "MicrosliceView.hpp"
 #include "RingBuffer.hpp"
 #include "StorableMicroslice.hpp"
+#include <chrono>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 namespace fles {
 
+class MicrosliceReceiver;
+
+/**
+ * \brief The MicrosliceBatch class provides access to a number of
+ * consecutive microslices in the buffers of a MicrosliceReceiver.
+ *
+ * The views refer to the descriptor and data buffers of the data source
+ * directly. The microslices are released to the data source when the batch
+ * is destroyed, so the views must not be used beyond the lifetime of the
+ * batch.
+ */
+class MicrosliceBatch {
+public:
+  /// Move constructor.
+  MicrosliceBatch(MicrosliceBatch&& other) noexcept
+      : receiver_(other.receiver_), views_(std::move(other.views_)),
+        end_(other.end_) {
+    other.receiver_ = nullptr;
+  }
+  /// Delete copy constructor (non-copyable).
+  MicrosliceBatch(const MicrosliceBatch&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const MicrosliceBatch&) = delete;
+
+  /// Destructor, releases the microslices to the data source.
+  ~MicrosliceBatch();
+
+  /// Retrieve the number of microslices in the batch.
+  [[nodiscard]] std::size_t size() const { return views_.size(); }
+
+  /// Check if the batch is empty (i.e., end-of-stream was reached).
+  [[nodiscard]] bool empty() const { return views_.empty(); }
+
+  /// Retrieve a microslice by index.
+  [[nodiscard]] const MicrosliceView& operator[](std::size_t i) const {
+    return views_[i];
+  }
+
+  [[nodiscard]] std::vector<MicrosliceView>::const_iterator begin() const {
+    return views_.begin();
+  }
+  [[nodiscard]] std::vector<MicrosliceView>::const_iterator end() const {
+    return views_.end();
+  }
+
+private:
+  friend class MicrosliceReceiver;
+
+  MicrosliceBatch(MicrosliceReceiver* receiver,
+                  std::vector<MicrosliceView> views,
+                  DualIndex end)
+      : receiver_(receiver), views_(std::move(views)), end_(end) {}
+
+  /// Receiver to release the microslices to (nullptr if released).
+  MicrosliceReceiver* receiver_;
+  std::vector<MicrosliceView> views_;
+  /// Read index of the data source after the batch.
+  DualIndex end_;
+};
+
 /**
  * \brief The MicrosliceReceiver class implements a mechanism to receive
  * Microslices from an InputBufferReadInterface object.
@@ -39,19 +104,99 @@ public:
     return std::unique_ptr<StorableMicroslice>(do_get());
   };
 
+  /**
+   * \brief Retrieve a batch of the next items without copying them.
+   *
+   * This function blocks if the next item is not yet available. It
+   * returns all available items up to the given maximum number. Only
+   * one batch can be held at a time, and get() must not be used while a
+   * batch is held, nor get_batch() while microslices referring to the data
+   * buffer (see set_zero_copy()) are held.
+   *
+   * \return batch of items, empty if end-of-file
+   */
+  MicrosliceBatch get_batch(std::size_t max_count = SIZE_MAX);
+
   [[nodiscard]] bool eos() const override { return eos_; }
 
+  /**
+   * \brief Hand out microslices referring to the data buffer of the data
+   * source instead of copies.
+   *
+   * The read index of the data source only advances past a microslice once
+   * it (and all copies sharing its content) has been destroyed, so holding
+   * many microslices stalls the data source. The microslices must not be
+   * used beyond the lifetime of the data source. Microslices wrapping around
+   * the data buffer and all microslices of a lossy data source are still
+   * copied.
+   */
+  void set_zero_copy(bool enable) { zero_copy_ = enable; }
+
+  /// Retrieve the number of microslices lost by a lossy data source.
+  [[nodiscard]] uint64_t lost_microslices() const { return lost_microslices_; }
+
 private:
+  friend class MicrosliceBatch;
+
+  /// Maximum time to wait for the write index to move.
+  static constexpr auto index_wait_timeout = std::chrono::milliseconds(10);
+
   StorableMicroslice* do_get() override;
 
   StorableMicroslice* try_get();
 
+  /// Skip the microslices overwritten in a lossy data source.
+  void skip_lost();
+
+  /// Check whether a microslice read from a lossy data source may have been
+  /// overwritten while reading it.
+  bool overwritten(uint64_t desc_index, uint64_t data_offset);
+
   /// Data source (e.g., FLIB).
   InputBufferReadInterface& data_source_;
 
   uint64_t write_index_desc_;
   uint64_t read_index_desc_;
 
+  /// Number of microslices lost by a lossy data source.
+  uint64_t lost_microslices_ = 0;
+
   bool eos_ = false;
+
+  /// True while a MicrosliceBatch is held.
+  bool batch_held_ = false;
+  /// Storage of the batch views, reused across batches.
+  std::vector<MicrosliceView> batch_views_;
+  /// Contiguous copy of a microslice wrapping around the data buffer.
+  std::vector<uint8_t> wrap_buffer_;
+
+  /// Wait until a microslice is available or end-of-file is reached.
+  bool wait_for_microslice();
+
+  /// The microslices handed out by get() which may still refer to the data
+  /// buffer, in order.
+  struct Outstanding {
+    std::mutex mutex;
+    /// Descriptor index of the first entry.
+    uint64_t first_desc = 0;
+    /// End offset in the data buffer and released flag of each microslice.
+    std::deque<std::pair<uint64_t, bool>> entries;
+  };
+
+  /// Hand out microslices referring to the data buffer.
+  bool zero_copy_ = false;
+  /// Outstanding microslices (shared with their release callbacks).
+  std::shared_ptr<Outstanding> outstanding_ = std::make_shared<Outstanding>();
+
+  /// Record the next microslice as outstanding unless it is released and
+  /// there are no outstanding microslices before it. Returns whether it has
+  /// been recorded.
+  bool track(uint64_t offset_end, bool released);
+
+  /// Advance the read index of the data source past the released
+  /// microslices.
+  void advance_released();
+
+  void release_batch(DualIndex end, std::vector<MicrosliceView> views);
 };
 } // namespace fles
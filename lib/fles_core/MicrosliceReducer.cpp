@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "MicrosliceReducer.hpp"
+#include <cstring>
+#include <stdexcept>
+
+bool EmptyMicrosliceReducer::reduce(fles::MicrosliceDescriptor& desc,
+                                    const uint8_t* content,
+                                    uint8_t* output) const {
+  if (desc.size == 0) {
+    return false;
+  }
+  std::memcpy(output, content, desc.size);
+  return true;
+}
+
+bool TruncatingMicrosliceReducer::reduce(fles::MicrosliceDescriptor& desc,
+                                         const uint8_t* content,
+                                         uint8_t* output) const {
+  if (desc.size > max_size_) {
+    desc.size = max_size_;
+    desc.flags |= static_cast<uint16_t>(fles::MicrosliceFlags::OverflowUser);
+    desc.flags &= ~static_cast<uint16_t>(fles::MicrosliceFlags::CrcValid);
+  }
+  std::memcpy(output, content, desc.size);
+  return true;
+}
+
+std::unique_ptr<MicrosliceReducer>
+make_microslice_reducer(const std::string& spec) {
+  if (spec == "empty") {
+    return std::make_unique<EmptyMicrosliceReducer>();
+  }
+  const std::string truncate = "truncate:";
+  if (spec.compare(0, truncate.size(), truncate) == 0) {
+    std::size_t pos = 0;
+    unsigned long max_size = 0;
+    try {
+      max_size = std::stoul(spec.substr(truncate.size()), &pos);
+    } catch (const std::logic_error&) {
+      pos = 0;
+    }
+    if (pos != 0 && pos == spec.size() - truncate.size() &&
+        max_size <= UINT32_MAX) {
+      return std::make_unique<TruncatingMicrosliceReducer>(
+          static_cast<uint32_t>(max_size));
+    }
+  }
+  throw std::invalid_argument("invalid microslice reducer: " + spec);
+}
@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the MicrosliceReducer interface and basic reducers.
+#pragma once
+
+#include "MicrosliceDescriptor.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/// Abstract per-microslice data reduction on the input node (see
+/// ReducingSource).
+class MicrosliceReducer {
+public:
+  virtual ~MicrosliceReducer() = default;
+
+  /// Reduce the content of a microslice.
+  /** Writes the reduced content of at most desc.size bytes to output and
+      updates the descriptor (size, flags, crc) accordingly. Called
+      concurrently for different microslices.
+      \return false to drop the microslice */
+  virtual bool reduce(fles::MicrosliceDescriptor& desc,
+                      const uint8_t* content,
+                      uint8_t* output) const = 0;
+};
+
+/// Reducer dropping microslices without content.
+class EmptyMicrosliceReducer : public MicrosliceReducer {
+public:
+  bool reduce(fles::MicrosliceDescriptor& desc,
+              const uint8_t* content,
+              uint8_t* output) const override;
+};
+
+/// Reducer truncating the content of microslices to a maximum size.
+/** Truncated microslices are flagged with MicrosliceFlags::OverflowUser,
+    their CRC is no longer valid. */
+class TruncatingMicrosliceReducer : public MicrosliceReducer {
+public:
+  explicit TruncatingMicrosliceReducer(uint32_t max_size)
+      : max_size_(max_size) {}
+
+  bool reduce(fles::MicrosliceDescriptor& desc,
+              const uint8_t* content,
+              uint8_t* output) const override;
+
+private:
+  uint32_t max_size_;
+};
+
+/// Create a reducer from a specification ("empty" or "truncate:<bytes>").
+/** Throws std::invalid_argument for an unknown specification. */
+std::unique_ptr<MicrosliceReducer>
+make_microslice_reducer(const std::string& spec);
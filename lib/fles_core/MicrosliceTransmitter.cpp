@@ -3,8 +3,6 @@
 #include "MicrosliceTransmitter.hpp"
 #include <algorithm>
 #include <cassert>
-#include <chrono>
-#include <thread>
 
 namespace fles {
 
@@ -30,23 +28,10 @@ bool MicrosliceTransmitter::try_put(
     return false;
   }
 
-  uint8_t* const data_begin = &data_sink_.data_buffer().at(write_index_.data);
-
-  uint8_t* const data_end =
-      &data_sink_.data_buffer().at(write_index_.data + item_size.data);
-
-  if (data_begin <= data_end) {
-    std::copy_n(item->content(), item_size.data, data_begin);
-  } else {
-    size_t part1_size =
-        buffer_size.data -
-        (write_index_.data & data_sink_.data_buffer().size_mask());
-
-    // copy data into two segments
-    std::copy_n(item->content(), part1_size, data_begin);
-    std::copy_n(item->content() + part1_size, item_size.data - part1_size,
-                data_sink_.data_buffer().ptr());
-  }
+  // the microslice content is typically not in the caches (e.g., read from
+  // an archive), prefetch it while streaming it into the buffer
+  data_sink_.data_buffer().copy_in(write_index_.data, item->content(),
+                                   item_size.data, true);
 
   data_sink_.desc_buffer().at(write_index_.desc) = item->desc();
   data_sink_.desc_buffer().at(write_index_.desc).offset = write_index_.data;
@@ -59,7 +44,8 @@ bool MicrosliceTransmitter::try_put(
 
 void MicrosliceTransmitter::put(std::shared_ptr<const Microslice> item) {
   while (!try_put(item)) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    // try_put() has just updated the cached read index
+    data_sink_.wait_for_read_index(read_index_cached_, index_wait_timeout);
   }
 }
 } // namespace fles
@@ -6,6 +6,7 @@
 #include "DualRingBuffer.hpp"
 #include "Microslice.hpp"
 #include "Sink.hpp"
+#include <chrono>
 
 namespace fles {
 
@@ -35,6 +36,9 @@ public:
   void end_stream() override { data_sink_.set_eof(true); }
 
 private:
+  /// Maximum time to wait for the read index to move.
+  static constexpr auto index_wait_timeout = std::chrono::milliseconds(10);
+
   bool try_put(const std::shared_ptr<const Microslice>& item);
 
   /// Data sink (e.g., shared memory buffer).
@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "OfflineTimesliceBuilder.hpp"
+#include "MicrosliceInputArchive.hpp"
+#include "PrefetchingSource.hpp"
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+bool OfflineTimesliceBuilder::Channel::read_next() {
+  auto ms = source_->get();
+  if (!ms) {
+    return false;
+  }
+  microslices_.push_back(std::move(ms));
+  return true;
+}
+
+void OfflineTimesliceBuilder::Channel::drop_before(uint64_t index) {
+  while (first_ < index && !microslices_.empty()) {
+    microslices_.pop_front();
+    ++first_;
+  }
+}
+
+OfflineTimesliceBuilder::OfflineTimesliceBuilder(
+    std::vector<std::unique_ptr<fles::MicrosliceSource>> channels,
+    uint32_t timeslice_size,
+    uint32_t overlap_size,
+    uint64_t duration,
+    uint64_t overlap_duration)
+    : core_microslices_(duration != 0 ? 0 : timeslice_size) {
+  if (duration == 0 && timeslice_size == 0) {
+    throw std::invalid_argument("timeslice size must be positive");
+  }
+  channels_.reserve(channels.size());
+  boundaries_.reserve(channels.size());
+  for (auto& source : channels) {
+    auto& channel =
+        channels_.emplace_back(std::make_unique<Channel>(std::move(source)));
+    boundaries_.push_back(std::make_unique<TimesliceBoundaries<Channel>>(
+        *channel, timeslice_size, overlap_size, duration, overlap_duration));
+  }
+  eos_ = channels_.empty();
+}
+
+OfflineTimesliceBuilder::~OfflineTimesliceBuilder() = default;
+
+std::unique_ptr<OfflineTimesliceBuilder> OfflineTimesliceBuilder::from_archives(
+    const std::vector<std::string>& filenames,
+    uint32_t timeslice_size,
+    uint32_t overlap_size,
+    uint64_t duration,
+    uint64_t overlap_duration,
+    std::size_t prefetch) {
+  std::vector<std::unique_ptr<fles::MicrosliceSource>> channels;
+  channels.reserve(filenames.size());
+  for (const auto& filename : filenames) {
+    channels.push_back(
+        std::make_unique<fles::PrefetchingSource<fles::MicrosliceSource>>(
+            std::make_unique<fles::MicrosliceInputArchive>(filename),
+            prefetch));
+  }
+  return std::make_unique<OfflineTimesliceBuilder>(
+      std::move(channels), timeslice_size, overlap_size, duration,
+      overlap_duration);
+}
+
+fles::StorableTimeslice* OfflineTimesliceBuilder::do_get() {
+  if (eos_) {
+    return nullptr;
+  }
+
+  // determine the components of the timeslice in all channels
+  std::vector<TimesliceBoundaries<Channel>::Component> components;
+  components.reserve(channels_.size());
+  for (std::size_t c = 0; c < channels_.size(); ++c) {
+    Channel& channel = *channels_[c];
+    std::optional<TimesliceBoundaries<Channel>::Component> component;
+    while (!(component = boundaries_[c]->component(timeslice_,
+                                                   channel.write_index()))) {
+      if (!channel.read_next()) {
+        eos_ = true;
+        return nullptr;
+      }
+    }
+    components.push_back(*component);
+  }
+
+  auto* ts = new fles::StorableTimeslice(core_microslices_, // NOLINT
+                                         timeslice_);
+  for (std::size_t c = 0; c < channels_.size(); ++c) {
+    const auto& component = components[c];
+    Channel& channel = *channels_[c];
+    const uint32_t ts_component = ts->append_component(component.desc_length);
+    for (uint64_t m = 0; m < component.desc_length; ++m) {
+      const fles::Microslice& ms =
+          channel.microslice(component.desc_offset + m);
+      ts->append_microslice(ts_component, m, ms.desc(), ms.content());
+    }
+    // the next timeslice starts at or after this one
+    channel.drop_before(component.desc_offset);
+    boundaries_[c]->release(timeslice_ + 1);
+  }
+  ++timeslice_;
+  return ts;
+}
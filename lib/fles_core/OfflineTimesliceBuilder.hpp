@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the OfflineTimesliceBuilder class.
+#pragma once
+
+#include "DualRingBuffer.hpp"
+#include "MicrosliceSource.hpp"
+#include "StorableTimeslice.hpp"
+#include "TimesliceBoundaries.hpp"
+#include "TimesliceSource.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * \brief The OfflineTimesliceBuilder class builds timeslices from the
+ * microslices of a number of recorded input channels.
+ *
+ * Each microslice source provides one timeslice component. The components
+ * are cut by TimesliceBoundaries, so the result is the same as that of an
+ * InputChannelSender with the given timeslice and overlap size (or
+ * duration) reading the channels. The stream ends with the last timeslice
+ * that is complete in all channels.
+ *
+ * The builder holds only the microslices of the current timeslice of each
+ * channel. Reading the channels in parallel is left to the sources, e.g.,
+ * by wrapping each in a PrefetchingSource (see from_archives()).
+ */
+class OfflineTimesliceBuilder : public fles::TimesliceSource {
+public:
+  /// The OfflineTimesliceBuilder constructor.
+  /** \param duration the timeslice duration in ns, or zero to cut by
+      microslice count
+      \param overlap_duration the overlap duration in ns (with duration) */
+  OfflineTimesliceBuilder(
+      std::vector<std::unique_ptr<fles::MicrosliceSource>> channels,
+      uint32_t timeslice_size,
+      uint32_t overlap_size,
+      uint64_t duration = 0,
+      uint64_t overlap_duration = 0);
+
+  OfflineTimesliceBuilder(const OfflineTimesliceBuilder&) = delete;
+  void operator=(const OfflineTimesliceBuilder&) = delete;
+
+  ~OfflineTimesliceBuilder() override;
+
+  /// Create a builder reading each of the given microslice archives on its
+  /// own thread, up to the given number of microslices ahead.
+  static std::unique_ptr<OfflineTimesliceBuilder>
+  from_archives(const std::vector<std::string>& filenames,
+                uint32_t timeslice_size,
+                uint32_t overlap_size,
+                uint64_t duration = 0,
+                uint64_t overlap_duration = 0,
+                std::size_t prefetch = 1000);
+
+  /// Read the next timeslice.
+  std::unique_ptr<fles::StorableTimeslice> get() {
+    return std::unique_ptr<fles::StorableTimeslice>(do_get());
+  }
+
+  [[nodiscard]] bool eos() const override { return eos_; }
+
+private:
+  /// The microslices of a channel not yet passed beyond, providing the
+  /// data source interface of TimesliceBoundaries.
+  class Channel {
+  public:
+    explicit Channel(std::unique_ptr<fles::MicrosliceSource> source)
+        : source_(std::move(source)) {}
+
+    /// Read the next microslice, return false at the end of the channel.
+    bool read_next();
+
+    /// Drop the microslices before the given descriptor index.
+    void drop_before(uint64_t index);
+
+    /// Retrieve the index after the last microslice read.
+    [[nodiscard]] uint64_t write_index() const {
+      return first_ + microslices_.size();
+    }
+
+    [[nodiscard]] const fles::Microslice& microslice(uint64_t index) const {
+      return *microslices_[index - first_];
+    }
+
+    // data source interface of TimesliceBoundaries
+    [[nodiscard]] const Channel& desc_buffer() const { return *this; }
+    [[nodiscard]] const fles::MicrosliceDescriptor& at(uint64_t index) const {
+      return microslice(index).desc();
+    }
+    [[nodiscard]] std::size_t size() const { return max_pending; }
+    [[nodiscard]] DualIndex get_read_index() const { return {0, 0}; }
+
+  private:
+    /// Capacity reported to TimesliceBoundaries (pending timeslices in time
+    /// mode, not a limit of the held microslices).
+    static constexpr std::size_t max_pending = 1024;
+
+    std::unique_ptr<fles::MicrosliceSource> source_;
+    std::deque<std::unique_ptr<fles::Microslice>> microslices_;
+    uint64_t first_ = 0;
+  };
+
+  std::vector<std::unique_ptr<Channel>> channels_;
+  std::vector<std::unique_ptr<TimesliceBoundaries<Channel>>> boundaries_;
+  const uint32_t core_microslices_;
+  uint64_t timeslice_ = 0;
+  bool eos_ = false;
+
+  fles::StorableTimeslice* do_get() override;
+};
@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "PerfCounters.hpp"
+#include "log.hpp"
+#include <cerrno>
+#include <exception>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+namespace {
+
+int open_counter(uint32_t type, uint64_t config, int group_fd) {
+  perf_event_attr attr{};
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.disabled = group_fd == -1 ? 1 : 0;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+  auto fd = syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+  if (fd < 0) {
+    throw std::system_error(errno, std::generic_category(),
+                            "perf_event_open");
+  }
+  return static_cast<int>(fd);
+}
+
+constexpr uint64_t cache_read_miss(uint64_t cache) {
+  return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+} // namespace
+
+PerfCounters::PerfCounters() {
+  fds_.fill(-1);
+  try {
+    fds_[Cycles] =
+        open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+    fds_[Instructions] = open_counter(
+        PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, fds_[Cycles]);
+    fds_[CacheMisses] =
+        open_counter(PERF_TYPE_HW_CACHE,
+                     cache_read_miss(PERF_COUNT_HW_CACHE_L1D), fds_[Cycles]);
+    fds_[LlcMisses] =
+        open_counter(PERF_TYPE_HW_CACHE,
+                     cache_read_miss(PERF_COUNT_HW_CACHE_LL), fds_[Cycles]);
+  } catch (...) {
+    for (int fd : fds_) {
+      if (fd >= 0) {
+        ::close(fd);
+      }
+    }
+    throw;
+  }
+  ioctl(fds_[Cycles], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(fds_[Cycles], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+PerfCounters::~PerfCounters() {
+  for (int fd : fds_) {
+    ::close(fd);
+  }
+}
+
+PerfCounters::Values PerfCounters::read() const {
+  // PERF_FORMAT_GROUP: number of counters followed by their values
+  std::array<uint64_t, NumEvents + 1> buffer{};
+  Values values{};
+  if (::read(fds_[Cycles], buffer.data(), sizeof(buffer)) ==
+      static_cast<ssize_t>(sizeof(buffer))) {
+    for (std::size_t i = 0; i < NumEvents; ++i) {
+      values[i] = buffer[i + 1];
+    }
+  }
+  return values;
+}
+
+PhasePerfCounters::PhasePerfCounters(std::vector<std::string> phase_names)
+    : phase_names_(std::move(phase_names)), totals_(phase_names_.size()) {}
+
+PhasePerfCounters::~PhasePerfCounters() = default;
+
+void PhasePerfCounters::enable() {
+  try {
+    counters_ = std::make_unique<PerfCounters>();
+    last_ = counters_->read();
+  } catch (std::exception& e) {
+    L_(warning) << "performance counters not available: " << e.what();
+  }
+}
+
+void PhasePerfCounters::switch_phase(std::size_t phase) {
+  const auto now = counters_->read();
+  auto& total = totals_[phase_];
+  for (std::size_t i = 0; i < PerfCounters::NumEvents; ++i) {
+    total[i] += now[i] - last_[i];
+  }
+  last_ = now;
+  phase_ = phase;
+}
+
+void PhasePerfCounters::report(cbm::Monitor* monitor,
+                               const cbm::MetricTagSet& tagset,
+                               uint64_t items) {
+  if (counters_ == nullptr) {
+    return;
+  }
+  // account the running phase up to now
+  switch_phase(phase_);
+  const double per_item = items > 0 ? 1.0 / static_cast<double>(items) : 0;
+  for (std::size_t p = 0; p < phase_names_.size(); ++p) {
+    auto& total = totals_[p];
+    if (monitor != nullptr) {
+      cbm::MetricTagSet tags = tagset;
+      tags.emplace_back("phase", phase_names_[p]);
+      monitor->QueueMetric(
+          "perf_counters", std::move(tags),
+          {{"cycles", total[PerfCounters::Cycles]},
+           {"instructions", total[PerfCounters::Instructions]},
+           {"ipc", total[PerfCounters::Cycles] > 0
+                       ? static_cast<double>(
+                             total[PerfCounters::Instructions]) /
+                             static_cast<double>(total[PerfCounters::Cycles])
+                       : 0.0},
+           {"cache_misses", total[PerfCounters::CacheMisses]},
+           {"llc_misses", total[PerfCounters::LlcMisses]},
+           {"cache_misses_per_item",
+            static_cast<double>(total[PerfCounters::CacheMisses]) * per_item},
+           {"llc_misses_per_item",
+            static_cast<double>(total[PerfCounters::LlcMisses]) * per_item}});
+    }
+    total.fill(0);
+  }
+}
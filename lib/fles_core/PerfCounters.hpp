@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the PerfCounters and PhasePerfCounters classes.
+#pragma once
+
+#include "Monitor.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * \brief A group of hardware performance counters of the calling thread.
+ *
+ * The counters are opened with perf_event_open() for the thread that
+ * constructs the object and count in user space only, so an unprivileged
+ * process needs perf_event_paranoid <= 2. All counters are read at once.
+ */
+class PerfCounters {
+public:
+  /// The counted events.
+  enum Event : std::size_t {
+    Cycles,       ///< CPU cycles
+    Instructions, ///< Retired instructions
+    CacheMisses,  ///< Level 1 data cache read misses
+    LlcMisses,    ///< Last level cache read misses
+    NumEvents
+  };
+
+  using Values = std::array<uint64_t, NumEvents>;
+
+  /// Open the counters for the calling thread. Throws std::system_error if
+  /// they are not available.
+  PerfCounters();
+
+  PerfCounters(const PerfCounters&) = delete;
+  void operator=(const PerfCounters&) = delete;
+
+  ~PerfCounters();
+
+  /// Read the current values of all counters.
+  [[nodiscard]] Values read() const;
+
+private:
+  std::array<int, NumEvents> fds_{};
+};
+
+/**
+ * \brief Attribution of hardware performance counts to the phases of a
+ * loop.
+ *
+ * The loop calls enter() at the start of each phase. The counts since the
+ * previous call are added to the previous phase. Until enable() has
+ * succeeded, enter() is a single branch, so the instrumentation can stay in
+ * the hot loops.
+ *
+ * report() publishes the counts per phase to the monitor as the
+ * measurement "perf_counters" with the tag "phase", including the IPC and
+ * the cache misses per item (e.g., per timeslice).
+ */
+class PhasePerfCounters {
+public:
+  /// Construct an object for the phases with the given names.
+  explicit PhasePerfCounters(std::vector<std::string> phase_names);
+
+  ~PhasePerfCounters();
+
+  /// Open the counters for the calling thread, which has to be the thread
+  /// of the loop. Logs a warning and stays disabled if they are not
+  /// available.
+  void enable();
+
+  /// Check whether the counters are enabled.
+  [[nodiscard]] bool enabled() const { return counters_ != nullptr; }
+
+  /// Start a phase of the loop.
+  void enter(std::size_t phase) {
+    if (counters_ != nullptr) {
+      switch_phase(phase);
+    }
+  }
+
+  /// Publish and reset the counts of all phases.
+  /**
+     \param items Number of items processed since the previous report
+   */
+  void report(cbm::Monitor* monitor,
+              const cbm::MetricTagSet& tagset,
+              uint64_t items);
+
+private:
+  std::vector<std::string> phase_names_;
+  std::vector<PerfCounters::Values> totals_;
+  std::unique_ptr<PerfCounters> counters_;
+  std::size_t phase_ = 0;
+  PerfCounters::Values last_{};
+
+  void switch_phase(std::size_t phase);
+};
@@ -0,0 +1,407 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::Pipeline class template and the related classes
+/// for multi-stage processing of move-only items.
+#pragma once
+
+#include "Sink.hpp"
+#include "Source.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fles {
+
+/// Exception thrown into the threads of a pipeline after a failure in any of
+/// its stages.
+class PipelineAborted : public std::exception {
+public:
+  [[nodiscard]] const char* what() const noexcept override {
+    return "pipeline aborted";
+  }
+};
+
+/**
+ * \brief The PipelineQueue class passes items between the threads of a
+ * pipeline.
+ *
+ * The queue holds at most a given number of items. A producer pushing to a
+ * full queue blocks until the consumer has caught up, so the slowest stage
+ * throttles all preceding stages (backpressure).
+ */
+template <class T> class PipelineQueue {
+public:
+  /// Construct a queue holding up to capacity items.
+  explicit PipelineQueue(std::size_t capacity)
+      : capacity_(capacity == 0 ? 1 : capacity) {}
+
+  /// Append an item, blocking while the queue is full.
+  void push(std::unique_ptr<T> item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock,
+                   [this] { return aborted_ || items_.size() < capacity_; });
+    if (aborted_) {
+      throw PipelineAborted();
+    }
+    items_.push_back(std::move(item));
+    not_empty_.notify_one();
+  }
+
+  /// Remove the next item, blocking while the queue is empty. Returns a
+  /// nullptr after the last item if the queue has been closed.
+  std::unique_ptr<T> pop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock,
+                    [this] { return aborted_ || closed_ || !items_.empty(); });
+    if (aborted_) {
+      throw PipelineAborted();
+    }
+    if (items_.empty()) {
+      return nullptr;
+    }
+    auto item = std::move(items_.front());
+    items_.pop_front();
+    not_full_.notify_one();
+    return item;
+  }
+
+  /// Signal the end of the stream to the consumer.
+  void close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    not_empty_.notify_all();
+  }
+
+  /// Wake up all waiting threads and make further calls throw.
+  void abort() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    aborted_ = true;
+    not_full_.notify_all();
+    not_empty_.notify_all();
+  }
+
+private:
+  std::size_t capacity_;
+  std::mutex mutex_;
+  std::condition_variable not_full_;
+  std::condition_variable not_empty_;
+  std::deque<std::unique_ptr<T>> items_;
+  bool closed_ = false;
+  bool aborted_ = false;
+};
+
+/// The PipelineOutput class receives the items emitted by a pipeline stage.
+template <class T> class PipelineOutput {
+public:
+  /// Receive an item.
+  virtual void push(std::unique_ptr<T> item) = 0;
+
+  /// Receive the end-of-stream signal.
+  virtual void finish() = 0;
+
+  virtual ~PipelineOutput() = default;
+};
+
+/**
+ * \brief The PipelineStage class is the abstract base class of a processing
+ * stage in a Pipeline.
+ *
+ * A stage takes ownership of each input item and may push any number of
+ * output items for it, e.g., the modified input item itself. Stages keeping
+ * items across calls push the remaining output in finish().
+ */
+template <class Input, class Output = Input> class PipelineStage {
+public:
+  using input_type = Input;
+  using output_type = Output;
+
+  /// Process an input item, passing the resulting items to output.
+  virtual void process(std::unique_ptr<Input> item,
+                       PipelineOutput<Output>& output) = 0;
+
+  /// Pass any remaining items to output at the end of the stream.
+  virtual void finish(PipelineOutput<Output>& /* output */) {}
+
+  virtual ~PipelineStage() = default;
+};
+
+/// Implementation details of the Pipeline class.
+namespace pipeline {
+
+/// Base class of the building blocks of a pipeline.
+class Node {
+public:
+  virtual ~Node() = default;
+
+  /// Start the worker thread of the node (if any).
+  virtual void start() {}
+
+  /// Make the worker thread of the node (if any) stop.
+  virtual void abort() {}
+
+  /// Wait for the worker thread of the node (if any) to finish.
+  virtual void join() {}
+};
+
+/// State shared by the nodes of a pipeline.
+class State {
+public:
+  std::vector<std::unique_ptr<Node>> nodes;
+
+  /// Record the first failure and stop all threads.
+  void fail(std::exception_ptr error) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (error_) {
+        return;
+      }
+      error_ = std::move(error);
+    }
+    for (auto& node : nodes) {
+      node->abort();
+    }
+  }
+
+  /// Rethrow the first failure (if any).
+  void rethrow() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+  }
+
+private:
+  std::mutex mutex_;
+  std::exception_ptr error_;
+};
+
+/// Node reading from a source in the thread calling Pipeline::run().
+class Head : public Node {
+public:
+  /// Read up to limit items from the source and push them downstream.
+  virtual void pump(uint64_t limit) = 0;
+};
+
+template <class T> class SourceNode : public Head {
+public:
+  explicit SourceNode(Source<T>& source) : source_(source) {}
+
+  void pump(uint64_t limit) override {
+    for (uint64_t count = 0; count < limit; ++count) {
+      auto item = source_.get();
+      if (!item) {
+        break;
+      }
+      next->push(std::move(item));
+    }
+    next->finish();
+  }
+
+  PipelineOutput<T>* next = nullptr;
+
+private:
+  Source<T>& source_;
+};
+
+template <class T, class Input, class Output>
+class StageNode : public Node, public PipelineOutput<T> {
+public:
+  explicit StageNode(PipelineStage<Input, Output>& stage) : stage_(stage) {}
+
+  void push(std::unique_ptr<T> item) override {
+    stage_.process(std::unique_ptr<Input>(std::move(item)), *next);
+  }
+
+  void finish() override {
+    stage_.finish(*next);
+    next->finish();
+  }
+
+  PipelineOutput<Output>* next = nullptr;
+
+private:
+  PipelineStage<Input, Output>& stage_;
+};
+
+template <class T> class QueueNode : public Node, public PipelineOutput<T> {
+public:
+  QueueNode(std::size_t capacity, State& state)
+      : queue_(capacity), state_(state) {}
+
+  void push(std::unique_ptr<T> item) override { queue_.push(std::move(item)); }
+
+  void finish() override { queue_.close(); }
+
+  void start() override { thread_ = std::thread(&QueueNode::run, this); }
+
+  void abort() override { queue_.abort(); }
+
+  void join() override {
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+  PipelineOutput<T>* next = nullptr;
+
+private:
+  void run() {
+    try {
+      while (auto item = queue_.pop()) {
+        next->push(std::move(item));
+      }
+      next->finish();
+    } catch (const PipelineAborted&) {
+      // failure elsewhere, already recorded
+    } catch (...) {
+      state_.fail(std::current_exception());
+    }
+  }
+
+  PipelineQueue<T> queue_;
+  State& state_;
+  std::thread thread_;
+};
+
+template <class T, class U>
+class SinkNode : public Node, public PipelineOutput<T> {
+public:
+  explicit SinkNode(std::vector<Sink<U>*> sinks) : sinks_(std::move(sinks)) {}
+
+  void push(std::unique_ptr<T> item) override {
+    std::shared_ptr<const U> shared(std::move(item));
+    for (auto* sink : sinks_) {
+      sink->put(shared);
+    }
+    ++count;
+  }
+
+  void finish() override {
+    for (auto* sink : sinks_) {
+      sink->end_stream();
+    }
+  }
+
+  uint64_t count = 0;
+
+private:
+  std::vector<Sink<U>*> sinks_;
+};
+
+} // namespace pipeline
+
+/**
+ * \brief The Pipeline class connects a source, a chain of processing stages,
+ * and a number of sinks.
+ *
+ * Items are passed on as std::unique_ptr, so each item has a single owner at
+ * any time and stages can modify items in place. By default, all stages run
+ * in the thread calling run(). Each call to thread() starts a new thread for
+ * the following stages, connected through a PipelineQueue, so that the
+ * stages run in parallel on several cores. A failure in any stage stops all
+ * threads and is rethrown by run().
+ *
+ * Example:
+ * \code
+ * MicrosliceInputArchive source("input.msa");
+ * CombineContentsStage combine;
+ * std::vector<MicrosliceSink*> sinks{&output};
+ * Pipeline<Microslice>(source).thread(16).then(combine).run(sinks);
+ * \endcode
+ *
+ * \tparam T The type of the items at the current end of the pipeline
+ */
+template <class T> class Pipeline {
+public:
+  /// Start a pipeline reading from a source in the thread calling run().
+  explicit Pipeline(Source<T>& source)
+      : state_(std::make_unique<pipeline::State>()) {
+    auto head = std::make_unique<pipeline::SourceNode<T>>(source);
+    head_ = head.get();
+    tail_ = &head->next;
+    state_->nodes.push_back(std::move(head));
+  }
+
+  /// Append a stage running in the thread of the preceding stage.
+  template <class Input, class Output>
+  Pipeline<Output> then(PipelineStage<Input, Output>& stage) && {
+    static_assert(std::is_convertible<T*, Input*>::value,
+                  "stage input type does not match");
+    auto node =
+        std::make_unique<pipeline::StageNode<T, Input, Output>>(stage);
+    *tail_ = node.get();
+    Pipeline<Output> result(std::move(state_), head_, &node->next);
+    result.state_->nodes.push_back(std::move(node));
+    return result;
+  }
+
+  /// Run the following stages in a new thread, receiving the items through
+  /// a queue holding up to capacity items.
+  Pipeline<T> thread(std::size_t capacity) && {
+    auto node = std::make_unique<pipeline::QueueNode<T>>(capacity, *state_);
+    *tail_ = node.get();
+    Pipeline<T> result(std::move(state_), head_, &node->next);
+    result.state_->nodes.push_back(std::move(node));
+    return result;
+  }
+
+  /**
+   * \brief Process all items, passing the resulting items to the sinks.
+   *
+   * The sinks are called in the thread of the last stage. The end of the
+   * stream is signaled to them after the last item.
+   *
+   * \param sinks The sinks to receive each resulting item
+   * \param limit Maximum number of items to read from the source
+   * \return The number of items passed to the sinks
+   */
+  template <class U>
+  uint64_t run(const std::vector<Sink<U>*>& sinks,
+               uint64_t limit = UINT64_MAX) && {
+    static_assert(std::is_convertible<T*, const U*>::value,
+                  "sink item type does not match");
+    auto sink = std::make_unique<pipeline::SinkNode<T, U>>(sinks);
+    auto* sink_node = sink.get();
+    *tail_ = sink_node;
+    state_->nodes.push_back(std::move(sink));
+
+    for (auto& node : state_->nodes) {
+      node->start();
+    }
+    try {
+      head_->pump(limit);
+    } catch (const PipelineAborted&) {
+      // failure elsewhere, already recorded
+    } catch (...) {
+      state_->fail(std::current_exception());
+    }
+    for (auto& node : state_->nodes) {
+      node->join();
+    }
+    state_->rethrow();
+    return sink_node->count;
+  }
+
+private:
+  template <class> friend class Pipeline;
+
+  Pipeline(std::unique_ptr<pipeline::State> state,
+           pipeline::Head* head,
+           PipelineOutput<T>** tail)
+      : state_(std::move(state)), head_(head), tail_(tail) {}
+
+  std::unique_ptr<pipeline::State> state_;
+  pipeline::Head* head_ = nullptr;
+  PipelineOutput<T>** tail_ = nullptr;
+};
+
+} // namespace fles
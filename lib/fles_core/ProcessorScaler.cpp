@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "ProcessorScaler.hpp"
+#include "Utility.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+ProcessorScalingParameters
+ProcessorScalingParameters::parse(const std::string& spec) {
+  ProcessorScalingParameters parameters;
+  auto to_ms = [](const std::string& value) {
+    const double seconds = std::stod(value);
+    if (!(seconds >= 0)) {
+      throw std::invalid_argument(value);
+    }
+    return std::chrono::milliseconds(std::llround(seconds * 1000));
+  };
+  for (const auto& item : split(spec, ",")) {
+    if (item.empty()) {
+      continue;
+    }
+    const auto equal = item.find('=');
+    if (equal == std::string::npos) {
+      throw std::invalid_argument("invalid autoscaling parameter: " + item);
+    }
+    const std::string key = item.substr(0, equal);
+    const std::string value = item.substr(equal + 1);
+    bool known = true;
+    try {
+      if (key == "min") {
+        parameters.min_instances = static_cast<uint32_t>(std::stoul(value));
+      } else if (key == "max") {
+        parameters.max_instances = static_cast<uint32_t>(std::stoul(value));
+      } else if (key == "up") {
+        parameters.scale_up_load = std::stod(value);
+      } else if (key == "down") {
+        parameters.scale_down_load = std::stod(value);
+      } else if (key == "updelay") {
+        parameters.scale_up_delay = to_ms(value);
+      } else if (key == "downdelay") {
+        parameters.scale_down_delay = to_ms(value);
+      } else {
+        known = false;
+      }
+    } catch (const std::logic_error&) {
+      throw std::invalid_argument("invalid autoscaling parameter: " + item);
+    }
+    if (!known) {
+      throw std::invalid_argument("unknown autoscaling parameter: " + key);
+    }
+  }
+  if (parameters.enabled() &&
+      (parameters.min_instances > parameters.max_instances ||
+       parameters.scale_down_load < 0 ||
+       parameters.scale_down_load >= parameters.scale_up_load)) {
+    throw std::invalid_argument("inconsistent autoscaling parameters: " +
+                                spec);
+  }
+  return parameters;
+}
+
+ProcessorScaler::ProcessorScaler(const ProcessorScalingParameters& parameters,
+                                 uint32_t instances,
+                                 clock::time_point now)
+    : parameters_(parameters),
+      instances_(std::clamp(instances, parameters.min_instances,
+                            parameters.max_instances)),
+      trend_since_(now) {}
+
+int ProcessorScaler::update(std::size_t pending_items, clock::time_point now) {
+  const double load = static_cast<double>(pending_items) /
+                      static_cast<double>(std::max(instances_, 1U));
+  int trend = 0;
+  if (load > parameters_.scale_up_load &&
+      instances_ < parameters_.max_instances) {
+    trend = 1;
+  } else if (load < parameters_.scale_down_load &&
+             instances_ > parameters_.min_instances) {
+    trend = -1;
+  }
+  if (trend != trend_) {
+    trend_ = trend;
+    trend_since_ = now;
+  }
+  if (trend_ == 0) {
+    return 0;
+  }
+  const auto delay = trend_ > 0 ? parameters_.scale_up_delay
+                                : parameters_.scale_down_delay;
+  if (now - trend_since_ < delay) {
+    return 0;
+  }
+  // restart the delay for the next change
+  instances_ = static_cast<uint32_t>(static_cast<int>(instances_) + trend_);
+  trend_since_ = now;
+  return trend_;
+}
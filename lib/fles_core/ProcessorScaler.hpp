@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the ProcessorScaler class.
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// Parameters of the autoscaling of the timeslice processor instances.
+struct ProcessorScalingParameters {
+  /// Minimum number of instances.
+  uint32_t min_instances = 1;
+  /// Maximum number of instances (0: no autoscaling).
+  uint32_t max_instances = 0;
+  /// Pending work items per instance above which an instance is added.
+  double scale_up_load = 2.0;
+  /// Pending work items per instance below which an instance is retired.
+  double scale_down_load = 0.5;
+  /// Time the load has to stay above the upper threshold.
+  std::chrono::milliseconds scale_up_delay{2000};
+  /// Time the load has to stay below the lower threshold.
+  std::chrono::milliseconds scale_down_delay{30000};
+
+  /// Check whether the number of instances is scaled at all.
+  [[nodiscard]] bool enabled() const { return max_instances != 0; }
+
+  /// Parse a list like "min=1,max=8,up=4". Keys are min and max
+  /// (instances), up and down (pending items per instance), and updelay and
+  /// downdelay (s). Throws std::invalid_argument on malformed input.
+  static ProcessorScalingParameters parse(const std::string& spec);
+};
+
+/**
+ * \brief Autoscaling policy of the timeslice processor instances of a
+ * timeslice buffer.
+ *
+ * The load is the number of work items outstanding at or queued for the
+ * processors, divided by the number of instances. An instance is added once
+ * the load has stayed above the upper threshold for the scale-up delay, and
+ * retired once it has stayed below the lower threshold for the scale-down
+ * delay, within the minimum and maximum number of instances. The gap
+ * between the thresholds and the delays provide the hysteresis; after each
+ * change, the respective delay passes again before the next one, so that a
+ * new instance has time to register and take over work.
+ */
+class ProcessorScaler {
+public:
+  using clock = std::chrono::steady_clock;
+
+  /// Start with a number of instances (clamped to the limits of the enabled
+  /// parameters).
+  ProcessorScaler(const ProcessorScalingParameters& parameters,
+                  uint32_t instances,
+                  clock::time_point now = clock::now());
+
+  /// Take a sample of the pending work items, return the number of
+  /// instances to add (positive) or retire (negative).
+  int update(std::size_t pending_items, clock::time_point now = clock::now());
+
+  /// Retrieve the current target number of instances.
+  [[nodiscard]] uint32_t instances() const { return instances_; }
+
+private:
+  ProcessorScalingParameters parameters_;
+  uint32_t instances_;
+  // Whether the load is above the upper threshold (1), below the lower one
+  // (-1) or in between (0), and since when (or since the last change)
+  int trend_ = 0;
+  clock::time_point trend_since_;
+};
@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "ProfileLoadGenerator.hpp"
+#include <algorithm>
+#include <random>
+#include <utility>
+
+namespace {
+/// Number of entries in the cyclic tables of random content sizes.
+constexpr std::size_t random_size_count = 65536;
+
+/// Draw a cyclic table of content sizes from a distribution.
+std::vector<uint32_t> draw_sizes(const SizeHistogram& sizes,
+                                 double scale,
+                                 uint64_t max_size,
+                                 std::mt19937_64& random) {
+  if (sizes.total() == 0) {
+    return {0};
+  }
+  std::vector<uint32_t> table(random_size_count);
+  for (auto& size : table) {
+    const auto scaled = static_cast<uint64_t>(
+        static_cast<double>(sizes.sample(random)) * scale);
+    size = static_cast<uint32_t>(std::min(scaled, max_size));
+  }
+  return table;
+}
+} // namespace
+
+ProfileLoadGenerator::ProfileLoadGenerator(std::size_t data_buffer_size_exp,
+                                           std::size_t desc_buffer_size_exp,
+                                           ComponentLoadProfile profile,
+                                           double speed,
+                                           double size_scale,
+                                           uint64_t seed,
+                                           const MemoryPolicy& memory_policy)
+    : data_buffer_(data_buffer_size_exp, memory_policy),
+      desc_buffer_(desc_buffer_size_exp, memory_policy),
+      data_buffer_view_(data_buffer_.ptr(), data_buffer_size_exp,
+                        data_buffer_.mirrored()),
+      desc_buffer_view_(desc_buffer_.ptr(), desc_buffer_size_exp,
+                        desc_buffer_.mirrored()),
+      profile_(std::move(profile)), speed_(speed) {
+  // drawing the sizes is too expensive to be done per microslice; a single
+  // microslice must leave space for others in the data buffer
+  std::mt19937_64 random(seed);
+  const uint64_t max_size =
+      std::min<uint64_t>(data_buffer_.bytes() / 4, UINT32_MAX);
+  spill_sizes_ = draw_sizes(profile_.spill_sizes, size_scale, max_size, random);
+  pause_sizes_ = draw_sizes(profile_.pause_sizes, size_scale, max_size, random);
+
+  const uint64_t now_ns = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count());
+  const uint64_t duration = profile_.microslice_duration_ns;
+  start_idx_ = duration > 0 ? now_ns - now_ns % duration : now_ns;
+
+  begin_ = std::chrono::steady_clock::now();
+}
+
+void ProfileLoadGenerator::proceed() {
+  const DualIndex min_avail = {desc_buffer_.size() / 4,
+                               data_buffer_.size() / 4};
+
+  // break unless significant space is available
+  if ((write_index_.data - read_index_.data + min_avail.data >
+       data_buffer_.size()) ||
+      (write_index_.desc - read_index_.desc + min_avail.desc >
+       desc_buffer_.size())) {
+    return;
+  }
+
+  const uint64_t duration = profile_.microslice_duration_ns;
+  while (true) {
+    const uint64_t time_ns = write_index_.desc * duration;
+
+    // check for current time (rate limiting)
+    if (speed_ > 0 && duration > 0) {
+      auto delta = std::chrono::steady_clock::now() - begin_;
+      auto delta_ns =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(delta).count();
+      if (static_cast<double>(delta_ns) <
+          static_cast<double>(time_ns) / speed_) {
+        break;
+      }
+    }
+
+    const bool spill = profile_.in_spill(time_ns);
+    const auto& sizes = spill ? spill_sizes_ : pause_sizes_;
+    auto& size_index = spill ? spill_index_ : pause_index_;
+    const uint32_t content_bytes = sizes[size_index];
+
+    // check for space in data and descriptor buffers
+    if ((write_index_.data - read_index_.data + content_bytes >
+         data_buffer_.bytes()) ||
+        (write_index_.desc - read_index_.desc + 1 > desc_buffer_.size())) {
+      break;
+    }
+    size_index = (size_index + 1) % sizes.size();
+
+    const auto hdr_id =
+        static_cast<uint8_t>(fles::HeaderFormatIdentifier::Standard);
+    const auto hdr_ver =
+        static_cast<uint8_t>(fles::HeaderFormatVersion::Standard);
+    const uint16_t flags = 0x0000;
+    const uint32_t crc = 0x00000000;
+
+    const_cast<fles::MicrosliceDescriptor&>(
+        desc_buffer_.at(write_index_.desc)) =
+        fles::MicrosliceDescriptor(
+            {hdr_id, hdr_ver, profile_.eq_id, flags, profile_.sys_id,
+             profile_.sys_ver, start_idx_ + time_ns, crc, content_bytes,
+             write_index_.data});
+    write_index_.desc += 1;
+    write_index_.data += content_bytes;
+  }
+}
@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the ProfileLoadGenerator class.
+#pragma once
+
+#include "DualRingBuffer.hpp"
+#include "LoadProfile.hpp"
+#include "MemoryPolicy.hpp"
+#include "MicrosliceDescriptor.hpp"
+#include "RingBuffer.hpp"
+#include "RingBufferView.hpp"
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+/**
+ * \brief Synthetic data source replaying the load profile of a component.
+ *
+ * The microslice sizes are drawn from the size distributions of the
+ * profile, separately for the spills and the pauses in between, and the
+ * microslices are released at the pace given by the microslice duration,
+ * divided by the speed factor. The microslice indexes are start times in ns
+ * since the epoch, beginning at the construction time. Only the descriptors
+ * are meaningful; the content is not written.
+ */
+class ProfileLoadGenerator : public InputBufferReadInterface {
+public:
+  /**
+   * \brief The ProfileLoadGenerator constructor.
+   *
+   * \param data_buffer_size_exp Exponent of the data buffer size
+   * \param desc_buffer_size_exp Exponent of the descriptor buffer size
+   * \param profile              Load profile of the component to replay
+   * \param speed                Factor of the original rate (0: unlimited)
+   * \param size_scale           Factor applied to all microslice sizes
+   * \param seed                 Seed of the size distributions
+   * \param memory_policy        Placement of the buffers
+   */
+  ProfileLoadGenerator(std::size_t data_buffer_size_exp,
+                       std::size_t desc_buffer_size_exp,
+                       ComponentLoadProfile profile,
+                       double speed = 1.0,
+                       double size_scale = 1.0,
+                       uint64_t seed = 0,
+                       const MemoryPolicy& memory_policy = {});
+
+  ProfileLoadGenerator(const ProfileLoadGenerator&) = delete;
+  void operator=(const ProfileLoadGenerator&) = delete;
+
+  RingBufferView<uint8_t>& data_buffer() override { return data_buffer_view_; }
+
+  RingBufferView<fles::MicrosliceDescriptor>& desc_buffer() override {
+    return desc_buffer_view_;
+  }
+
+  void proceed() override;
+
+  DualIndex get_write_index() override { return write_index_; }
+
+  bool get_eof() override { return false; }
+
+  void set_read_index(DualIndex new_read_index) override {
+    read_index_ = new_read_index;
+  }
+
+  DualIndex get_read_index() override { return read_index_; }
+
+  /// Retrieve the replayed load profile.
+  [[nodiscard]] const ComponentLoadProfile& profile() const {
+    return profile_;
+  }
+
+private:
+  /// Input data buffer.
+  RingBuffer<uint8_t> data_buffer_;
+
+  /// Input descriptor buffer.
+  RingBuffer<fles::MicrosliceDescriptor, true> desc_buffer_;
+
+  RingBufferView<uint8_t> data_buffer_view_;
+  RingBufferView<fles::MicrosliceDescriptor> desc_buffer_view_;
+
+  ComponentLoadProfile profile_;
+  double speed_;
+
+  /// Cyclic tables of pseudo-random content sizes in and between spills.
+  std::vector<uint32_t> spill_sizes_;
+  std::vector<uint32_t> pause_sizes_;
+
+  /// Next entries in the tables of content sizes.
+  std::size_t spill_index_ = 0;
+  std::size_t pause_index_ = 0;
+
+  /// Index of the first microslice.
+  uint64_t start_idx_ = 0;
+
+  std::chrono::steady_clock::time_point begin_;
+
+  /// Number of acknowledged data bytes and microslices. Updated by input
+  /// node.
+  DualIndex read_index_{0, 0};
+
+  /// Number of written microslices and data bytes.
+  DualIndex write_index_{0, 0};
+};
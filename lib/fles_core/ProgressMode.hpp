@@ -0,0 +1,12 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the ProgressMode enum for connection group event loops.
+#pragma once
+
+/// Progress strategy of a connection group event loop.
+enum class ProgressMode {
+  Busy,     ///< Poll the completion queues continuously
+  Adaptive, ///< Poll for a bounded time after activity, then block
+  Blocking  ///< Block on the completion queues whenever idle
+};
@@ -0,0 +1,250 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "RampCompare.hpp"
+
+#if defined(__x86_64__)
+#define RAMP_COMPARE_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define RAMP_COMPARE_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+using RampCompareFunction = size_t (*)(
+    const uint64_t*, size_t, uint64_t, uint64_t, uint64_t&);
+
+// Compare words[begin .. count-1], continuing a partial XOR "x". Also used to
+// locate the exact mismatch in a block rejected by a vectorized comparison.
+size_t ramp_compare_tail(const uint64_t* words,
+                         size_t begin,
+                         size_t count,
+                         uint64_t first,
+                         uint64_t step,
+                         uint64_t x,
+                         uint64_t& word_xor) {
+  uint64_t expected = first + begin * step;
+  for (size_t i = begin; i < count; ++i) {
+    if (words[i] != expected) {
+      return i;
+    }
+    x ^= words[i];
+    expected += step;
+  }
+  word_xor = x;
+  return count;
+}
+
+size_t ramp_compare_scalar(const uint64_t* words,
+                           size_t count,
+                           uint64_t first,
+                           uint64_t step,
+                           uint64_t& word_xor) {
+  return ramp_compare_tail(words, 0, count, first, step, 0, word_xor);
+}
+
+#ifdef RAMP_COMPARE_X86
+__attribute__((target("avx2"))) size_t ramp_compare_avx2(const uint64_t* words,
+                                                         size_t count,
+                                                         uint64_t first,
+                                                         uint64_t step,
+                                                         uint64_t& word_xor) {
+  // two vectors of four words per iteration
+  constexpr size_t lanes = 4;
+  constexpr size_t block = 2 * lanes;
+
+  const auto e = [=](uint64_t k) {
+    return static_cast<long long>(first + k * step);
+  };
+  __m256i expected0 = _mm256_setr_epi64x(e(0), e(1), e(2), e(3));
+  __m256i expected1 = _mm256_setr_epi64x(e(4), e(5), e(6), e(7));
+  const __m256i increment =
+      _mm256_set1_epi64x(static_cast<long long>(block * step));
+  __m256i acc0 = _mm256_setzero_si256();
+  __m256i acc1 = _mm256_setzero_si256();
+
+  size_t i = 0;
+  for (; i + block <= count; i += block) {
+    const __m256i data0 =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+    const __m256i data1 =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i + lanes));
+    const __m256i diff = _mm256_or_si256(_mm256_xor_si256(data0, expected0),
+                                         _mm256_xor_si256(data1, expected1));
+    if (_mm256_testz_si256(diff, diff) == 0) {
+      break;
+    }
+    acc0 = _mm256_xor_si256(acc0, data0);
+    acc1 = _mm256_xor_si256(acc1, data1);
+    expected0 = _mm256_add_epi64(expected0, increment);
+    expected1 = _mm256_add_epi64(expected1, increment);
+  }
+
+  alignas(32) uint64_t folded[lanes];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(folded),
+                     _mm256_xor_si256(acc0, acc1));
+  const uint64_t x = folded[0] ^ folded[1] ^ folded[2] ^ folded[3];
+  return ramp_compare_tail(words, i, count, first, step, x, word_xor);
+}
+
+__attribute__((target("avx512f"))) size_t
+ramp_compare_avx512(const uint64_t* words,
+                    size_t count,
+                    uint64_t first,
+                    uint64_t step,
+                    uint64_t& word_xor) {
+  // two vectors of eight words per iteration
+  constexpr size_t lanes = 8;
+  constexpr size_t block = 2 * lanes;
+
+  const auto e = [=](uint64_t k) {
+    return static_cast<long long>(first + k * step);
+  };
+  __m512i expected0 =
+      _mm512_set_epi64(e(7), e(6), e(5), e(4), e(3), e(2), e(1), e(0));
+  __m512i expected1 =
+      _mm512_set_epi64(e(15), e(14), e(13), e(12), e(11), e(10), e(9), e(8));
+  const __m512i increment =
+      _mm512_set1_epi64(static_cast<long long>(block * step));
+  __m512i acc0 = _mm512_setzero_si512();
+  __m512i acc1 = _mm512_setzero_si512();
+
+  size_t i = 0;
+  for (; i + block <= count; i += block) {
+    const __m512i data0 = _mm512_loadu_si512(words + i);
+    const __m512i data1 = _mm512_loadu_si512(words + i + lanes);
+    if ((_mm512_cmpneq_epu64_mask(data0, expected0) |
+         _mm512_cmpneq_epu64_mask(data1, expected1)) != 0) {
+      break;
+    }
+    acc0 = _mm512_xor_si512(acc0, data0);
+    acc1 = _mm512_xor_si512(acc1, data1);
+    expected0 = _mm512_add_epi64(expected0, increment);
+    expected1 = _mm512_add_epi64(expected1, increment);
+  }
+
+  alignas(64) uint64_t folded[lanes];
+  _mm512_store_si512(folded, _mm512_xor_si512(acc0, acc1));
+  uint64_t x = 0;
+  for (uint64_t f : folded) {
+    x ^= f;
+  }
+  return ramp_compare_tail(words, i, count, first, step, x, word_xor);
+}
+#endif
+
+#ifdef RAMP_COMPARE_NEON
+size_t ramp_compare_neon(const uint64_t* words,
+                         size_t count,
+                         uint64_t first,
+                         uint64_t step,
+                         uint64_t& word_xor) {
+  // four vectors of two words per iteration
+  constexpr size_t lanes = 2;
+  constexpr size_t block = 4 * lanes;
+
+  uint64x2_t expected[4];
+  for (size_t v = 0; v < 4; ++v) {
+    const uint64_t e[lanes] = {first + (v * lanes) * step,
+                               first + (v * lanes + 1) * step};
+    expected[v] = vld1q_u64(e);
+  }
+  const uint64x2_t increment = vdupq_n_u64(block * step);
+  uint64x2_t acc[4] = {vdupq_n_u64(0), vdupq_n_u64(0), vdupq_n_u64(0),
+                       vdupq_n_u64(0)};
+
+  size_t i = 0;
+  for (; i + block <= count; i += block) {
+    uint64x2_t data[4];
+    uint64x2_t diff = vdupq_n_u64(0);
+    for (size_t v = 0; v < 4; ++v) {
+      data[v] = vld1q_u64(words + i + v * lanes);
+      diff = vorrq_u64(diff, veorq_u64(data[v], expected[v]));
+    }
+    if (vmaxvq_u32(vreinterpretq_u32_u64(diff)) != 0) {
+      break;
+    }
+    for (size_t v = 0; v < 4; ++v) {
+      acc[v] = veorq_u64(acc[v], data[v]);
+      expected[v] = vaddq_u64(expected[v], increment);
+    }
+  }
+
+  const uint64x2_t folded =
+      veorq_u64(veorq_u64(acc[0], acc[1]), veorq_u64(acc[2], acc[3]));
+  const uint64_t x = vgetq_lane_u64(folded, 0) ^ vgetq_lane_u64(folded, 1);
+  return ramp_compare_tail(words, i, count, first, step, x, word_xor);
+}
+#endif
+
+RampCompareFunction ramp_compare_function(RampCompareIsa isa) {
+  switch (isa) {
+#ifdef RAMP_COMPARE_X86
+  case RampCompareIsa::Avx2:
+    return ramp_compare_avx2;
+  case RampCompareIsa::Avx512:
+    return ramp_compare_avx512;
+#endif
+#ifdef RAMP_COMPARE_NEON
+  case RampCompareIsa::Neon:
+    return ramp_compare_neon;
+#endif
+  default:
+    return ramp_compare_scalar;
+  }
+}
+
+} // namespace
+
+std::vector<RampCompareIsa> ramp_compare_supported_isas() {
+  static const std::vector<RampCompareIsa> isas = [] {
+    std::vector<RampCompareIsa> v{RampCompareIsa::Scalar};
+#ifdef RAMP_COMPARE_X86
+    if (__builtin_cpu_supports("avx2") != 0) {
+      v.push_back(RampCompareIsa::Avx2);
+    }
+    if (__builtin_cpu_supports("avx512f") != 0) {
+      v.push_back(RampCompareIsa::Avx512);
+    }
+#elif defined(RAMP_COMPARE_NEON)
+    v.push_back(RampCompareIsa::Neon);
+#endif
+    return v;
+  }();
+  return isas;
+}
+
+const char* to_string(RampCompareIsa isa) {
+  switch (isa) {
+  case RampCompareIsa::Scalar:
+    return "scalar";
+  case RampCompareIsa::Avx2:
+    return "avx2";
+  case RampCompareIsa::Avx512:
+    return "avx512";
+  case RampCompareIsa::Neon:
+    return "neon";
+  }
+  return "unknown";
+}
+
+size_t ramp_compare(const uint64_t* words,
+                    size_t count,
+                    uint64_t first,
+                    uint64_t step,
+                    uint64_t& word_xor) {
+  static const RampCompareFunction function =
+      ramp_compare_function(ramp_compare_supported_isas().back());
+  return function(words, count, first, step, word_xor);
+}
+
+size_t ramp_compare(RampCompareIsa isa,
+                    const uint64_t* words,
+                    size_t count,
+                    uint64_t first,
+                    uint64_t step,
+                    uint64_t& word_xor) {
+  return ramp_compare_function(isa)(words, count, first, step, word_xor);
+}
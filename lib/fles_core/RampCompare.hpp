@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the ramp pattern comparison used by the pattern checkers.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// Instruction set extensions for the ramp pattern comparison.
+enum class RampCompareIsa { Scalar, Avx2, Avx512, Neon };
+
+/// Retrieve the ramp comparison implementations supported at run time.
+/** The list is ordered by preference, the implementation used by default is
+    the last entry. */
+std::vector<RampCompareIsa> ramp_compare_supported_isas();
+
+/// Retrieve the name of a ramp comparison implementation.
+const char* to_string(RampCompareIsa isa);
+
+/// Compare a sequence of words to a ramp pattern.
+/**
+ * Searches for the first word with words[i] != first + i * step.
+ *
+ * \param words      buffer of words to compare (no alignment required)
+ * \param count      number of words
+ * \param first      expected value of the first word
+ * \param step       expected increment between consecutive words
+ * \param word_xor   set to the XOR of all words if all words match
+ * \return index of the first mismatching word, or count if all words match
+ */
+size_t ramp_compare(const uint64_t* words,
+                    size_t count,
+                    uint64_t first,
+                    uint64_t step,
+                    uint64_t& word_xor);
+
+/// Compare a sequence of words to a ramp pattern using a given
+/// implementation, which has to be supported on this machine.
+size_t ramp_compare(RampCompareIsa isa,
+                    const uint64_t* words,
+                    size_t count,
+                    uint64_t first,
+                    uint64_t step,
+                    uint64_t& word_xor);
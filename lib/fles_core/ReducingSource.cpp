@@ -0,0 +1,196 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "ReducingSource.hpp"
+#include "Utility.hpp"
+#include "WorkerPool.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+ReducingSource::ReducingSource(InputBufferReadInterface& upstream,
+                               std::unique_ptr<MicrosliceReducer> reducer,
+                               unsigned threads,
+                               bool allow_drop,
+                               const MemoryPolicy& memory_policy)
+    : upstream_(upstream), reducer_(std::move(reducer)),
+      allow_drop_(allow_drop),
+      data_buffer_(upstream.data_buffer().size_exponent(), memory_policy),
+      desc_buffer_(upstream.desc_buffer().size_exponent(), memory_policy),
+      data_buffer_view_(data_buffer_.ptr(), data_buffer_.size_exponent(),
+                        data_buffer_.mirrored()),
+      desc_buffer_view_(desc_buffer_.ptr(), desc_buffer_.size_exponent(),
+                        desc_buffer_.mirrored()),
+      upstream_end_(upstream.desc_buffer().size_exponent()),
+      upstream_next_(upstream.get_read_index().desc),
+      upstream_published_(upstream_next_),
+      upstream_read_(upstream.get_read_index()) {
+  if (threads > 0) {
+    pool_ = std::make_unique<WorkerPool>(threads);
+  }
+}
+
+ReducingSource::~ReducingSource() {
+  if (bytes_in_ > 0) {
+    L_(info) << "input reduction: " << human_readable_count(bytes_in_)
+             << " -> " << human_readable_count(bytes_out_) << " ("
+             << 100 * bytes_out_ / bytes_in_ << "%)";
+  }
+}
+
+void ReducingSource::proceed() {
+  upstream_.proceed();
+  publish_batches();
+  submit_batches();
+  publish_batches();
+}
+
+bool ReducingSource::get_eof() {
+  return upstream_.get_eof() && batches_.empty() &&
+         upstream_next_ == upstream_.get_write_index().desc;
+}
+
+void ReducingSource::set_read_index(DualIndex new_read_index) {
+  read_index_ = new_read_index;
+  // dropped microslices are released with the staged ones preceding them,
+  // or once all staged microslices have been acknowledged
+  release_upstream(read_index_.desc == write_index_.desc
+                       ? upstream_published_
+                       : upstream_end_.at(read_index_.desc - 1));
+}
+
+void ReducingSource::release_upstream(uint64_t desc_end) {
+  if (desc_end <= upstream_read_.desc) {
+    return;
+  }
+  const auto& last = upstream_.desc_buffer().at(desc_end - 1);
+  upstream_read_ = {desc_end, last.offset + last.size};
+  upstream_.set_read_index(upstream_read_);
+}
+
+void ReducingSource::reduce(ReduceBatch& batch) const {
+  auto& descs = upstream_.desc_buffer();
+  auto& data = upstream_.data_buffer();
+  batch.content.resize(batch.bytes);
+  std::vector<uint8_t> wrapped;
+  std::size_t pos = 0;
+  for (uint64_t i = batch.desc_begin; i < batch.desc_end; ++i) {
+    fles::MicrosliceDescriptor desc = descs.at(i);
+    const uint32_t size = desc.size;
+    const uint8_t* content = &data.at(desc.offset);
+    const std::size_t begin = desc.offset & data.size_mask();
+    if (!data.mirrored() && begin + size > data.bytes()) {
+      // content wraps around the end of the upstream buffer
+      const std::size_t first = data.bytes() - begin;
+      wrapped.resize(size);
+      std::memcpy(wrapped.data(), content, first);
+      std::memcpy(wrapped.data() + first, data.ptr(), size - first);
+      content = wrapped.data();
+    }
+    bool keep = reducer_->reduce(desc, content, batch.content.data() + pos);
+    if (desc.size > size) {
+      throw std::logic_error("microslice reducer increased content size");
+    }
+    if (!keep) {
+      if (allow_drop_) {
+        continue;
+      }
+      if (desc.size != 0) {
+        desc.size = 0;
+        desc.flags |=
+            static_cast<uint16_t>(fles::MicrosliceFlags::OverflowUser);
+        desc.flags &= ~static_cast<uint16_t>(fles::MicrosliceFlags::CrcValid);
+      }
+    }
+    desc.offset = pos;
+    pos += desc.size;
+    batch.descs.push_back(desc);
+    batch.upstream_end.push_back(i + 1);
+  }
+  batch.content.resize(pos);
+}
+
+void ReducingSource::submit_batches() {
+  const uint64_t upstream_write = upstream_.get_write_index().desc;
+  // without threads, the batches are reduced right away
+  const std::size_t max_batches = pool_ ? 2 * pool_->size() : SIZE_MAX;
+  const uint64_t max_batch_bytes = data_buffer_.bytes() / 8;
+
+  while (upstream_next_ < upstream_write && batches_.size() < max_batches) {
+    // the reduced content never exceeds the upstream content
+    const DualIndex used = write_index_ + reserved_ - read_index_;
+    ReduceBatch batch{upstream_next_, upstream_next_, 0, {}, {}, {}, {}};
+    while (batch.desc_end < upstream_write) {
+      const uint32_t size = upstream_.desc_buffer().at(batch.desc_end).size;
+      if (used.desc + (batch.desc_end - batch.desc_begin) + 1 >
+              desc_buffer_.size() ||
+          used.data + batch.bytes + size > data_buffer_.bytes() ||
+          (batch.bytes != 0 && batch.bytes + size > max_batch_bytes)) {
+        break;
+      }
+      batch.bytes += size;
+      ++batch.desc_end;
+    }
+    if (batch.desc_end == batch.desc_begin) {
+      break;
+    }
+    upstream_next_ = batch.desc_end;
+    reserved_ += {batch.desc_end - batch.desc_begin, batch.bytes};
+    batches_.push_back(std::move(batch));
+    ReduceBatch& submitted = batches_.back();
+    if (pool_) {
+      submitted.done =
+          pool_->submit([this, &submitted] { reduce(submitted); });
+    } else {
+      reduce(submitted);
+    }
+  }
+}
+
+void ReducingSource::publish_batches() {
+  while (!batches_.empty()) {
+    ReduceBatch& batch = batches_.front();
+    if (batch.done.valid()) {
+      if (batch.done.wait_for(std::chrono::seconds(0)) !=
+          std::future_status::ready) {
+        break;
+      }
+      batch.done.get();
+    }
+    write_content(write_index_.data, batch.content.data(),
+                  batch.content.size());
+    for (std::size_t i = 0; i < batch.descs.size(); ++i) {
+      fles::MicrosliceDescriptor desc = batch.descs[i];
+      desc.offset += write_index_.data;
+      desc_buffer_.at(write_index_.desc + i) = desc;
+      upstream_end_.at(write_index_.desc + i) = batch.upstream_end[i];
+    }
+    write_index_ += {batch.descs.size(), batch.content.size()};
+    reserved_ -= {batch.desc_end - batch.desc_begin, batch.bytes};
+    upstream_published_ = batch.desc_end;
+    bytes_in_ += batch.bytes;
+    bytes_out_ += batch.content.size();
+    batches_.pop_front();
+  }
+  if (read_index_.desc == write_index_.desc) {
+    // nothing staged is pending, release the dropped microslices
+    release_upstream(upstream_published_);
+  }
+}
+
+void ReducingSource::write_content(uint64_t offset,
+                                   const uint8_t* content,
+                                   std::size_t size) {
+  uint8_t* data = data_buffer_.ptr();
+  const std::size_t begin = offset & data_buffer_.size_mask();
+  if (data_buffer_.mirrored()) {
+    std::memcpy(data + begin, content, size);
+    return;
+  }
+  const std::size_t first =
+      std::min<std::size_t>(size, data_buffer_.bytes() - begin);
+  std::memcpy(data + begin, content, first);
+  std::memcpy(data, content + first, size - first);
+}
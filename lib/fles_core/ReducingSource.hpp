@@ -0,0 +1,153 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the ReducingSource class.
+#pragma once
+
+#include "DualRingBuffer.hpp"
+#include "MemoryPolicy.hpp"
+#include "MicrosliceDescriptor.hpp"
+#include "MicrosliceReducer.hpp"
+#include "RingBuffer.hpp"
+#include "RingBufferView.hpp"
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <vector>
+
+class WorkerPool;
+
+/**
+ * \brief Input buffer holding the reduced microslices of another one.
+ *
+ * A ReducingSource object sits between an input buffer and the input node
+ * sender. It passes the microslices of the upstream buffer through a
+ * MicrosliceReducer into a staging buffer of the same geometry, from which
+ * the sender transmits, so the network only carries the reduced data. The
+ * upstream buffer space is released as the sender acknowledges the
+ * corresponding staged microslices.
+ *
+ * With reduce threads, batches of microslices are reduced concurrently on a
+ * worker pool and published in order. Dropping microslices changes the
+ * microslice count, which only preserves the timeslice alignment across
+ * inputs with time-based timeslices. Otherwise, dropped microslices are
+ * kept as empty descriptors flagged with MicrosliceFlags::OverflowUser.
+ */
+class ReducingSource : public InputBufferReadInterface {
+public:
+  /**
+   * \brief The ReducingSource constructor.
+   *
+   * \param upstream      The input buffer to reduce
+   * \param reducer       The reduction applied to each microslice
+   * \param threads       Number of reduce threads (0: reduce in proceed())
+   * \param allow_drop    Remove dropped microslices from the stream
+   * \param memory_policy Placement of the staging buffers
+   */
+  ReducingSource(InputBufferReadInterface& upstream,
+                 std::unique_ptr<MicrosliceReducer> reducer,
+                 unsigned threads = 0,
+                 bool allow_drop = false,
+                 const MemoryPolicy& memory_policy = {});
+
+  ~ReducingSource() override;
+
+  ReducingSource(const ReducingSource&) = delete;
+  void operator=(const ReducingSource&) = delete;
+
+  RingBufferView<uint8_t>& data_buffer() override { return data_buffer_view_; }
+
+  RingBufferView<fles::MicrosliceDescriptor>& desc_buffer() override {
+    return desc_buffer_view_;
+  }
+
+  void proceed() override;
+
+  DualIndex get_write_index() override { return write_index_; }
+
+  bool get_eof() override;
+
+  void set_read_index(DualIndex new_read_index) override;
+
+  DualIndex get_read_index() override { return read_index_; }
+
+  /// Retrieve the number of content bytes taken from the upstream buffer.
+  [[nodiscard]] uint64_t bytes_in() const { return bytes_in_; }
+
+  /// Retrieve the number of reduced content bytes staged for sending.
+  [[nodiscard]] uint64_t bytes_out() const { return bytes_out_; }
+
+private:
+  InputBufferReadInterface& upstream_;
+  std::unique_ptr<MicrosliceReducer> reducer_;
+  const bool allow_drop_;
+
+  /// Staging data buffer.
+  RingBuffer<uint8_t> data_buffer_;
+
+  /// Staging descriptor buffer.
+  RingBuffer<fles::MicrosliceDescriptor, true> desc_buffer_;
+
+  RingBufferView<uint8_t> data_buffer_view_;
+  RingBufferView<fles::MicrosliceDescriptor> desc_buffer_view_;
+
+  /// Upstream descriptor index following each staged microslice.
+  RingBuffer<uint64_t> upstream_end_;
+
+  /// Number of acknowledged staged microslices and data bytes.
+  DualIndex read_index_{0, 0};
+
+  /// Number of staged microslices and data bytes.
+  DualIndex write_index_{0, 0};
+
+  /// Next upstream microslice to be reduced.
+  uint64_t upstream_next_;
+
+  /// Upstream descriptor index following the last published batch.
+  uint64_t upstream_published_;
+
+  /// Upstream read index last written.
+  DualIndex upstream_read_;
+
+  uint64_t bytes_in_ = 0;
+  uint64_t bytes_out_ = 0;
+
+  /// A range of upstream microslices reduced by a worker thread.
+  struct ReduceBatch {
+    uint64_t desc_begin;
+    uint64_t desc_end;
+    /// Upstream content bytes of the batch.
+    uint64_t bytes;
+    /// Reduced descriptors, offsets relative to the reduced content.
+    std::vector<fles::MicrosliceDescriptor> descs;
+    std::vector<uint64_t> upstream_end;
+    std::vector<uint8_t> content;
+    std::future<void> done;
+  };
+
+  /// Batches in flight, in order.
+  std::deque<ReduceBatch> batches_;
+
+  /// Staging space reserved for the batches in flight.
+  DualIndex reserved_{0, 0};
+
+  /// Reduce threads (destroyed first, completing all batches).
+  std::unique_ptr<WorkerPool> pool_;
+
+  /// Reduce the microslices of a batch.
+  void reduce(ReduceBatch& batch) const;
+
+  /// Hand the next upstream microslices that fit the staging buffers to the
+  /// reduce threads.
+  void submit_batches();
+
+  /// Copy the completed batches to the staging buffers.
+  void publish_batches();
+
+  /// Release the upstream microslices before the given descriptor index.
+  void release_upstream(uint64_t desc_end);
+
+  /// Write reduced content to the staging data buffer.
+  void write_content(uint64_t offset, const uint8_t* content, std::size_t size);
+};
@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "ReplayScheduler.hpp"
+#include <stdexcept>
+#include <thread>
+
+ReplayScheduler::ReplayScheduler(double speed,
+                                 std::chrono::nanoseconds spin_threshold,
+                                 std::chrono::nanoseconds tolerance)
+    : speed_(speed), spin_threshold_(spin_threshold), tolerance_(tolerance) {
+  if (!(speed_ > 0.0)) {
+    throw std::invalid_argument("replay speed must be greater than zero");
+  }
+}
+
+std::chrono::nanoseconds ReplayScheduler::wait(uint64_t timestamp) {
+  if (!started_) {
+    started_ = true;
+    time_begin_ = clock::now();
+    first_timestamp_ = timestamp;
+    ++statistics_.count;
+    return std::chrono::nanoseconds{0};
+  }
+
+  // items with timestamps before the first one are released immediately
+  clock::time_point target = time_begin_;
+  if (timestamp > first_timestamp_) {
+    target += std::chrono::nanoseconds(static_cast<int64_t>(
+        static_cast<double>(timestamp - first_timestamp_) / speed_));
+  }
+
+  clock::time_point now = clock::now();
+  if (target - now > spin_threshold_) {
+    std::this_thread::sleep_until(target - spin_threshold_);
+    now = clock::now();
+  }
+  while (now < target) {
+    now = clock::now();
+  }
+
+  auto error =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(now - target);
+  ++statistics_.count;
+  if (error > tolerance_) {
+    ++statistics_.late_count;
+  }
+  statistics_.total_error += error;
+  if (error > statistics_.max_error) {
+    statistics_.max_error = error;
+  }
+  return error;
+}
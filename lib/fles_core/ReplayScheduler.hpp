@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the ReplayScheduler class.
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * \brief The ReplayScheduler class releases items at the pace given by their
+ * timestamps.
+ *
+ * The first item is released immediately and defines the time origin. Each
+ * following item is held back until the difference of its timestamp to the
+ * first timestamp, divided by the speed factor, has elapsed on the monotonic
+ * clock. The calling thread sleeps until shortly before the release time and
+ * spins for the remainder, so that the release jitter stays well below the
+ * scheduling granularity of the operating system.
+ */
+class ReplayScheduler {
+public:
+  using clock = std::chrono::steady_clock;
+
+  /// Pacing error statistics, accumulated since the last reset.
+  struct Statistics {
+    /// Number of released items.
+    uint64_t count = 0;
+    /// Number of items released later than the tolerance.
+    uint64_t late_count = 0;
+    /// Sum of the pacing errors.
+    std::chrono::nanoseconds total_error{0};
+    /// Largest pacing error.
+    std::chrono::nanoseconds max_error{0};
+
+    /// Accumulate the statistics of another interval.
+    void add(const Statistics& other) {
+      count += other.count;
+      late_count += other.late_count;
+      total_error += other.total_error;
+      if (other.max_error > max_error) {
+        max_error = other.max_error;
+      }
+    }
+
+    /// Retrieve the mean pacing error.
+    [[nodiscard]] std::chrono::nanoseconds mean_error() const {
+      if (count == 0) {
+        return std::chrono::nanoseconds{0};
+      }
+      return total_error / static_cast<int64_t>(count);
+    }
+  };
+
+  /**
+   * \brief The ReplayScheduler constructor.
+   *
+   * \param speed          Factor of the original speed (> 1: compress time)
+   * \param spin_threshold Time before the release time to switch from
+   *                       sleeping to spinning
+   * \param tolerance      Pacing error above which an item counts as late
+   */
+  explicit ReplayScheduler(
+      double speed = 1.0,
+      std::chrono::nanoseconds spin_threshold = std::chrono::microseconds(200),
+      std::chrono::nanoseconds tolerance = std::chrono::microseconds(100));
+
+  /**
+   * \brief Wait until the release time of an item.
+   *
+   * \param timestamp Timestamp of the item (in ns)
+   * \return The pacing error, i.e., the delay of the actual behind the
+   * intended release time
+   */
+  std::chrono::nanoseconds wait(uint64_t timestamp);
+
+  /// Retrieve the pacing error statistics.
+  [[nodiscard]] const Statistics& statistics() const { return statistics_; }
+
+  /// Reset the pacing error statistics.
+  void reset_statistics() { statistics_ = Statistics(); }
+
+private:
+  double speed_;
+  std::chrono::nanoseconds spin_threshold_;
+  std::chrono::nanoseconds tolerance_;
+
+  bool started_ = false;
+  clock::time_point time_begin_;
+  uint64_t first_timestamp_ = 0;
+
+  Statistics statistics_;
+};
@@ -0,0 +1,150 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "ResourceControl.hpp"
+#include "log.hpp"
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <utility>
+
+namespace {
+
+std::string read_line(const std::string& filename) {
+  std::ifstream file(filename);
+  std::string line;
+  std::getline(file, line);
+  return line;
+}
+
+// Write a string to a resctrl file with a single write() call, as the
+// kernel parses each call separately
+void write_file(const std::string& root,
+                const std::string& filename,
+                const std::string& content) {
+  int fd = open(filename.c_str(), O_WRONLY | O_CLOEXEC);
+  if (fd == -1) {
+    throw std::runtime_error(filename + ": " + strerror(errno));
+  }
+  ssize_t ret = write(fd, content.data(), content.size());
+  int error = errno;
+  close(fd);
+  if (ret != static_cast<ssize_t>(content.size())) {
+    // the kernel explains rejected input in last_cmd_status
+    std::string status = read_line(root + "/info/last_cmd_status");
+    throw std::runtime_error(
+        filename + ": cannot write '" + boost::trim_copy(content) +
+        "': " + strerror(ret == -1 ? error : EIO) +
+        (status.empty() ? "" : " (" + status + ")"));
+  }
+}
+
+} // namespace
+
+std::vector<std::string> parse_resctrl_schemata(const std::string& str) {
+  std::vector<std::string> lines;
+  std::vector<std::string> items;
+  boost::split(items, str, boost::is_any_of(","));
+  for (auto& item : items) {
+    boost::trim(item);
+    if (item.empty()) {
+      continue;
+    }
+    const auto colon = item.find(':');
+    if (colon == 0 || colon == std::string::npos) {
+      throw std::invalid_argument("invalid schemata line: " + item);
+    }
+    std::vector<std::string> domains;
+    boost::split(domains, item.substr(colon + 1), boost::is_any_of(";"));
+    for (const auto& domain : domains) {
+      const auto equal = domain.find('=');
+      if (equal == 0 || equal == std::string::npos ||
+          equal + 1 == domain.size()) {
+        throw std::invalid_argument("invalid schemata line: " + item);
+      }
+    }
+    lines.push_back(item);
+  }
+  return lines;
+}
+
+ResctrlGroup::ResctrlGroup(std::string name,
+                           const std::vector<std::string>& schemata,
+                           const std::string& root)
+    : name_(std::move(name)), root_(root), path_(root + "/" + name_) {
+  if (name_.empty() || name_.find('/') != std::string::npos) {
+    throw std::invalid_argument("invalid resctrl group name: " + name_);
+  }
+  if (!boost::filesystem::exists(root_ + "/schemata")) {
+    throw std::runtime_error("resctrl file system not mounted at " + root_);
+  }
+  if (mkdir(path_.c_str(), 0755) == 0) {
+    created_ = true;
+  } else if (errno != EEXIST) {
+    throw std::runtime_error("cannot create resctrl group " + path_ + ": " +
+                             strerror(errno));
+  }
+
+  try {
+    for (const auto& line : schemata) {
+      write_file(root_, path_ + "/schemata", line + "\n");
+    }
+  } catch (...) {
+    if (created_) {
+      rmdir(path_.c_str());
+    }
+    throw;
+  }
+  L_(info) << "resctrl group " << name_ << (created_ ? " created" : "")
+           << ": " << this->schemata();
+}
+
+ResctrlGroup::~ResctrlGroup() {
+  if (created_ && rmdir(path_.c_str()) != 0) {
+    L_(warning) << "cannot remove resctrl group " << path_ << ": "
+                << strerror(errno);
+  }
+}
+
+void ResctrlGroup::add_thread() const {
+  add_task(static_cast<pid_t>(syscall(SYS_gettid)));
+}
+
+void ResctrlGroup::add_task(pid_t tid) const {
+  write_file(root_, path_ + "/tasks", std::to_string(tid) + "\n");
+}
+
+void ResctrlGroup::add_process() const {
+  for (const auto& entry :
+       boost::filesystem::directory_iterator("/proc/self/task")) {
+    const std::string tid = entry.path().filename().string();
+    try {
+      write_file(root_, path_ + "/tasks", tid + "\n");
+    } catch (const std::runtime_error&) {
+      // the thread may have terminated in the meantime
+      if (boost::filesystem::exists(entry.path())) {
+        throw;
+      }
+    }
+  }
+}
+
+std::string ResctrlGroup::schemata() const {
+  std::ifstream file(path_ + "/schemata");
+  std::string line;
+  std::vector<std::string> lines;
+  while (std::getline(file, line)) {
+    boost::trim(line);
+    if (!line.empty()) {
+      lines.push_back(line);
+    }
+  }
+  return boost::join(lines, ",");
+}
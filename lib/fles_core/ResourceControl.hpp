@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the ResctrlGroup class.
+#pragma once
+
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+/// Default mount point of the Linux resctrl file system.
+constexpr const char* default_resctrl_root = "/sys/fs/resctrl";
+
+/// Parse a resctrl schemata specification.
+/** The lines of the schemata file are separated by commas, e.g.,
+    "L3:0=ff0;1=ff0,MB:0=50;1=50" for a cache allocation (CAT) bit mask and
+    a memory bandwidth allocation (MBA) percentage on two cache domains.
+
+    \throws std::invalid_argument if a line is not of the form
+    "<resource>:<domain>=<value>[;<domain>=<value>...]"
+*/
+std::vector<std::string> parse_resctrl_schemata(const std::string& str);
+
+/// Linux resctrl control group.
+/** A control group assigns a share of the last-level cache and of the
+    memory bandwidth (Intel CAT/MBA, AMD L3 CAT/MBA) to the tasks added to
+    it. The group is created below the resctrl mount point if it does not
+    exist yet and removed again on destruction if it was created here, which
+    returns its tasks to the default group. Threads created by a task of the
+    group belong to the group as well. */
+class ResctrlGroup {
+public:
+  /// The ResctrlGroup constructor.
+  /**
+     \param name     Name of the group (directory below root)
+     \param schemata Schemata lines to apply (empty: keep the current ones)
+     \param root     Mount point of the resctrl file system
+
+     \throws std::runtime_error if the group cannot be created or the
+     schemata are rejected
+  */
+  ResctrlGroup(std::string name,
+               const std::vector<std::string>& schemata,
+               const std::string& root = default_resctrl_root);
+
+  ResctrlGroup(const ResctrlGroup&) = delete;
+  void operator=(const ResctrlGroup&) = delete;
+
+  ~ResctrlGroup();
+
+  /// Add the calling thread to the group.
+  void add_thread() const;
+
+  /// Add a task (thread or main thread of a process) to the group.
+  void add_task(pid_t tid) const;
+
+  /// Add all current threads of this process to the group.
+  void add_process() const;
+
+  /// Keep the group after destruction (e.g., if shared with other
+  /// processes).
+  void keep() { created_ = false; }
+
+  /// Retrieve the name of the group.
+  [[nodiscard]] const std::string& name() const { return name_; }
+
+  /// Retrieve the effective schemata of the group.
+  [[nodiscard]] std::string schemata() const;
+
+private:
+  std::string name_;
+  std::string root_;
+  std::string path_;
+  bool created_ = false;
+};
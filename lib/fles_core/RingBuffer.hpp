@@ -1,6 +1,7 @@
 // Copyright 2012-2013 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include "MemoryPolicy.hpp"
 #include <algorithm>
 #include <cstdlib>
 #include <cstring>
@@ -33,24 +34,28 @@ public:
     alloc_with_size_exponent(new_size_exponent);
   }
 
+  /// The RingBuffer initializing constructor using a memory policy.
+  RingBuffer(size_t new_size_exponent, const MemoryPolicy& policy) {
+    alloc_with_size_exponent(new_size_exponent, policy);
+  }
+
   RingBuffer(const RingBuffer&) = delete;
   void operator=(const RingBuffer&) = delete;
 
   /// Create and initialize buffer with given minimum size.
   void alloc_with_size(size_t minimum_size) {
-    size_t new_size_exponent = 0;
-    if (minimum_size > 1) {
-      minimum_size--;
-      ++new_size_exponent;
-      while ((minimum_size >>= 1) != 0u) {
-        ++new_size_exponent;
-      }
-    }
-    alloc_with_size_exponent(new_size_exponent);
+    alloc_with_size_exponent(size_exponent_for(minimum_size));
+  }
+
+  /// Create and initialize buffer with given minimum size using a memory
+  /// policy.
+  void alloc_with_size(size_t minimum_size, const MemoryPolicy& policy) {
+    alloc_with_size_exponent(size_exponent_for(minimum_size), policy);
   }
 
   /// Create and initialize buffer with given size exponent.
   void alloc_with_size_exponent(size_t new_size_exponent) {
+    mirrored_ = false;
     size_exponent_ = new_size_exponent;
     size_ = UINT64_C(1) << size_exponent_;
     size_mask_ = size_ - 1;
@@ -89,6 +94,42 @@ public:
     }
   }
 
+  /**
+   * \brief Create and initialize buffer with given size exponent using a
+   * memory policy.
+   *
+   * The memory is obtained from allocate_memory(), i.e., it is page aligned
+   * regardless of PAGE_ALIGNED and may use huge pages, NUMA binding and
+   * mirroring. A default policy falls back to the regular allocation.
+   */
+  void alloc_with_size_exponent(size_t new_size_exponent,
+                                const MemoryPolicy& policy) {
+    if (policy.is_default()) {
+      alloc_with_size_exponent(new_size_exponent);
+      return;
+    }
+    mirrored_ = policy.mirrored;
+    size_exponent_ = new_size_exponent;
+    size_ = UINT64_C(1) << size_exponent_;
+    size_mask_ = size_ - 1;
+    const size_t bytes = sizeof(T) * size_;
+    using plain_t = typename std::remove_volatile<T>::type;
+    auto* ptr = static_cast<plain_t*>(allocate_memory(bytes, policy));
+    for (size_t i = 0; i < size_; ++i) {
+      if (CLEARED) {
+        new (&ptr[i]) plain_t();
+      } else {
+        new (&ptr[i]) plain_t;
+      }
+    }
+    buf_ = buf_t(ptr, [size = size_, bytes, policy](T* p) {
+      for (size_t i = size; i != 0u; --i) {
+        p[i - 1].~T();
+      }
+      free_memory(const_cast<plain_t*>(p), bytes, policy);
+    });
+  }
+
   /// The element accessor operator.
   T& at(size_t n) { return buf_[n & size_mask_]; }
 
@@ -113,15 +154,35 @@ public:
   /// Retrieve buffer size in bytes.
   [[nodiscard]] size_t bytes() const { return size_ * sizeof(T); }
 
+  /// Check if the buffer is mirrored, i.e., the size() entries following
+  /// &at(n) are contiguous in memory for any n.
+  [[nodiscard]] bool mirrored() const { return mirrored_; }
+
   void clear() { std::fill_n(buf_, size_, T()); }
 
 private:
+  /// Compute the smallest size exponent for the given minimum size.
+  static size_t size_exponent_for(size_t minimum_size) {
+    size_t new_size_exponent = 0;
+    if (minimum_size > 1) {
+      minimum_size--;
+      ++new_size_exponent;
+      while ((minimum_size >>= 1) != 0u) {
+        ++new_size_exponent;
+      }
+    }
+    return new_size_exponent;
+  }
+
   /// Buffer size (maximum number of entries).
   size_t size_ = 0;
 
   /// Buffer size given as two's exponent.
   size_t size_exponent_ = 0;
 
+  /// Buffer is mapped twice in a row.
+  bool mirrored_ = false;
+
   /// Buffer addressing bit mask.
   size_t size_mask_ = 0;
 
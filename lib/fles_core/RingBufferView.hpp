@@ -1,17 +1,21 @@
 // Copyright 2012-2013 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include "StreamingCopy.hpp"
 #include <cstddef>
 #include <cstdint>
+#include <type_traits>
 
 /// Simple generic ring buffer view class.
 template <typename T> class RingBufferView {
 public:
   /// The RingBufferView constructor.
-  RingBufferView(T* buffer, std::size_t new_size_exponent)
+  /** A mirrored buffer is mapped twice in a row (see RingBuffer). */
+  RingBufferView(T* buffer, std::size_t new_size_exponent,
+                 bool mirrored = false)
       : buf_(buffer), size_exponent_(new_size_exponent),
         size_(UINT64_C(1) << size_exponent_),
-        size_mask_((UINT64_C(1) << size_exponent_) - 1) {}
+        size_mask_((UINT64_C(1) << size_exponent_) - 1), mirrored_(mirrored) {}
 
   /// The element accessor operator.
   T& at(std::size_t n) { return buf_[n & size_mask_]; }
@@ -21,6 +25,33 @@ public:
     return buf_[n & size_mask_];
   }
 
+  /// Copy n entries into the buffer, starting at index and wrapping around
+  /// at its end if required.
+  /** Large copies use non-temporal stores (see streaming_copy()), so that
+     filling the buffer does not evict the working set of the caller. */
+  void copy_in(std::size_t index,
+               const T* src,
+               std::size_t n,
+               bool prefetch_source = false) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const std::size_t n1 = contiguous(index, n);
+    streaming_copy(&at(index), src, n1 * sizeof(T), prefetch_source);
+    if (n1 < n) {
+      streaming_copy(buf_, src + n1, (n - n1) * sizeof(T), prefetch_source);
+    }
+  }
+
+  /// Copy n entries out of the buffer, starting at index and wrapping around
+  /// at its end if required.
+  void copy_out(std::size_t index, T* dst, std::size_t n) const {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const std::size_t n1 = contiguous(index, n);
+    streaming_copy(dst, &at(index), n1 * sizeof(T));
+    if (n1 < n) {
+      streaming_copy(dst + n1, buf_, (n - n1) * sizeof(T));
+    }
+  }
+
   /// Retrieve pointer to memory buffer.
   T* ptr() { return buf_; }
 
@@ -39,7 +70,27 @@ public:
   /// Retrieve buffer size in bytes.
   [[nodiscard]] std::size_t bytes() const { return size_ * sizeof(T); }
 
+  /// Check if the buffer is mirrored, i.e., the size() entries following
+  /// &at(n) are contiguous in memory for any n.
+  [[nodiscard]] bool mirrored() const { return mirrored_; }
+
+  /// Retrieve the size of the mapped memory in bytes, e.g., for memory
+  /// registration (twice the buffer size if mirrored).
+  [[nodiscard]] std::size_t mapped_bytes() const {
+    return mirrored_ ? 2 * bytes() : bytes();
+  }
+
 private:
+  /// Number of the n entries from index on that are contiguous in memory.
+  [[nodiscard]] std::size_t contiguous(std::size_t index,
+                                       std::size_t n) const {
+    if (mirrored_) {
+      return n;
+    }
+    const std::size_t to_end = size_ - (index & size_mask_);
+    return n < to_end ? n : to_end;
+  }
+
   /// The data buffer.
   T* buf_;
 
@@ -51,4 +102,7 @@ private:
 
   /// Buffer addressing bit mask.
   const std::size_t size_mask_;
+
+  /// Buffer is mapped twice in a row.
+  const bool mirrored_;
 };
@@ -1,60 +1,373 @@
 // Copyright 2012-2013 Jan de Cuveland <cmail@cuveland.de>
+/// \file
+/// \brief Defines the Scheduler class.
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <ctime>
-#include <functional>
-#include <queue>
+#include <new>
+#include <sys/time.h>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
+/**
+ * \brief The Scheduler class runs deferred events from an event loop.
+ *
+ * Events are kept in a hierarchical timer wheel on the monotonic clock:
+ * four levels of 64 slots with a resolution of 2^16 ns (about 66 us) at the
+ * lowest level, each level covering 64 times the span of the one below.
+ * Adding and cancelling an event take constant time, and an event is moved
+ * at most once per level before it expires. Event storage and callbacks
+ * are recycled, so small callbacks (such as lambdas capturing a few
+ * pointers) are stored without heap allocation.
+ *
+ * Events due at the time they are added run on the next call of timer().
+ * All other events run on the first call of timer() after their tick has
+ * elapsed, in order of insertion within a tick. timer() returns without
+ * reading the clock if no event is pending, so event loops can call it on
+ * every iteration.
+ */
 class Scheduler {
 public:
-  struct event {
-    using callback_type = std::function<void()>;
-    using time_type = std::chrono::time_point<std::chrono::system_clock>;
+  using clock = std::chrono::steady_clock;
 
-    event(callback_type cb, const time_type& when)
-        : callback_(std::move(cb)), when_(when) {}
+  /// Callback of an event, stored in place if small enough.
+  class callback {
+  public:
+    callback() = default;
 
-    void operator()() const { callback_(); }
+    template <typename F,
+              typename = std::enable_if_t<
+                  !std::is_same_v<std::decay_t<F>, callback>>>
+    callback(F&& f) { // NOLINT(google-explicit-constructor)
+      using T = std::decay_t<F>;
+      if constexpr (sizeof(T) <= inline_size &&
+                    alignof(T) <= alignof(std::max_align_t) &&
+                    std::is_nothrow_move_constructible_v<T>) {
+        new (storage_) T(std::forward<F>(f));
+        ops_ = &inline_ops<T>::ops;
+      } else {
+        *reinterpret_cast<T**>(storage_) = new T(std::forward<F>(f));
+        ops_ = &heap_ops<T>::ops;
+      }
+    }
 
-    callback_type callback_;
-    time_type when_;
-  };
+    callback(callback&& other) noexcept : ops_(other.ops_) {
+      if (ops_ != nullptr) {
+        ops_->move(storage_, other.storage_);
+        other.ops_ = nullptr;
+      }
+    }
 
-  struct event_less : public std::less<> {
-    bool operator()(const event& e1, const event& e2) const {
-      return (e2.when_ < e1.when_);
+    callback& operator=(callback&& other) noexcept {
+      if (this != &other) {
+        reset();
+        ops_ = other.ops_;
+        if (ops_ != nullptr) {
+          ops_->move(storage_, other.storage_);
+          other.ops_ = nullptr;
+        }
+      }
+      return *this;
     }
+
+    callback(const callback&) = delete;
+    callback& operator=(const callback&) = delete;
+
+    ~callback() { reset(); }
+
+    void operator()() { ops_->invoke(storage_); }
+
+    explicit operator bool() const { return ops_ != nullptr; }
+
+    /// Destroy the stored callable.
+    void reset() {
+      if (ops_ != nullptr) {
+        ops_->destroy(storage_);
+        ops_ = nullptr;
+      }
+    }
+
+  private:
+    /// Maximum size of a callable stored in place.
+    static constexpr std::size_t inline_size = 48;
+
+    struct ops_type {
+      void (*invoke)(void*);
+      void (*move)(void* dst, void* src);
+      void (*destroy)(void*);
+    };
+
+    template <typename T> struct inline_ops {
+      static constexpr ops_type ops = {
+          [](void* p) { (*static_cast<T*>(p))(); },
+          [](void* dst, void* src) {
+            new (dst) T(std::move(*static_cast<T*>(src)));
+            static_cast<T*>(src)->~T();
+          },
+          [](void* p) { static_cast<T*>(p)->~T(); }};
+    };
+
+    template <typename T> struct heap_ops {
+      static constexpr ops_type ops = {
+          [](void* p) { (**static_cast<T**>(p))(); },
+          [](void* dst, void* src) {
+            *static_cast<T**>(dst) = *static_cast<T**>(src);
+          },
+          [](void* p) { delete *static_cast<T**>(p); }};
+    };
+
+    alignas(std::max_align_t) unsigned char storage_[inline_size];
+    const ops_type* ops_ = nullptr;
+  };
+
+  /// Handle of an added event, used to cancel it.
+  struct handle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
   };
 
-  void add(const event::callback_type& cb, const time_t& when) {
-    auto real_when = std::chrono::system_clock::from_time_t(when);
+  Scheduler() : current_tick_(to_tick(clock::now())) {
+    heads_.fill(nil);
+    tails_.fill(nil);
+  }
 
-    event_queue_.emplace(cb, real_when);
+  /// Add an event to run at a given time of the monotonic clock.
+  handle add(callback cb, clock::time_point when) {
+    const clock::time_point now = clock::now();
+    if (size_ == 0) {
+      // The wheel is empty, skip the ticks elapsed since it was last used
+      current_tick_ = std::max(current_tick_, to_tick(now));
+    }
+    uint32_t index = allocate();
+    node& n = nodes_[index];
+    n.cb = std::move(cb);
+    // Round up, so that no event runs early
+    n.expire = to_tick(when + tick_duration - clock::duration(1));
+    if (when <= now || n.expire <= current_tick_) {
+      link(index, due_list);
+    } else {
+      insert(index);
+    }
+    return {index, n.generation};
   }
 
-  void add(const event::callback_type& cb, const timeval& when) {
-    auto real_when = std::chrono::system_clock::from_time_t(when.tv_sec) +
-                     std::chrono::microseconds(when.tv_usec);
+  /// Add an event to run at a given time of the system clock.
+  handle add(callback cb,
+             const std::chrono::time_point<std::chrono::system_clock>& when) {
+    return add(std::move(cb),
+               clock::now() + std::chrono::duration_cast<clock::duration>(
+                                  when - std::chrono::system_clock::now()));
+  }
 
-    event_queue_.emplace(cb, real_when);
+  /// Add an event to run at a given time of the system clock.
+  handle add(callback cb, const time_t& when) {
+    return add(std::move(cb), std::chrono::system_clock::from_time_t(when));
   }
 
-  void add(const event::callback_type& cb,
-           const std::chrono::time_point<std::chrono::system_clock>& when) {
-    event_queue_.emplace(cb, when);
+  /// Add an event to run at a given time of the system clock.
+  handle add(callback cb, const timeval& when) {
+    return add(std::move(cb), std::chrono::system_clock::from_time_t(
+                                  when.tv_sec) +
+                                  std::chrono::microseconds(when.tv_usec));
   }
 
-  void timer() {
-    event::time_type now = std::chrono::system_clock::now();
+  /**
+   * \brief Cancel a pending event.
+   *
+   * \return true if the event was pending, false if it has already run or
+   * been cancelled
+   */
+  bool cancel(const handle& h) {
+    if (h.index >= nodes_.size() ||
+        nodes_[h.index].generation != h.generation ||
+        nodes_[h.index].list == nil) {
+      return false;
+    }
+    unlink(h.index);
+    release(h.index);
+    return true;
+  }
 
-    while (!event_queue_.empty() && (event_queue_.top().when_ <= now)) {
-      event_queue_.top()();
-      event_queue_.pop();
+  /// Retrieve the number of pending events.
+  [[nodiscard]] std::size_t size() const { return size_; }
+
+  /// Check whether no event is pending.
+  [[nodiscard]] bool empty() const { return size_ == 0; }
+
+  /// Run all events that are due.
+  void timer() {
+    if (size_ == 0) {
+      return;
+    }
+    const uint64_t now_tick = to_tick(clock::now());
+    run_list(due_list);
+    while (current_tick_ < now_tick) {
+      // Skip ahead to the next cascade if the lower levels are empty
+      unsigned int empty_levels = 0;
+      while (empty_levels < levels && level_size_[empty_levels] == 0) {
+        ++empty_levels;
+      }
+      if (empty_levels == levels) {
+        current_tick_ = now_tick;
+        break;
+      }
+      if (empty_levels > 0) {
+        const uint64_t span = UINT64_C(1) << (level_bits * empty_levels);
+        current_tick_ = std::min(now_tick - 1, current_tick_ | (span - 1));
+      }
+      ++current_tick_;
+      for (unsigned int level = levels - 1; level > 0; --level) {
+        if ((current_tick_ & ((UINT64_C(1) << (level_bits * level)) - 1)) ==
+            0) {
+          cascade(level);
+        }
+      }
+      run_list(slot_list(0, current_tick_));
     }
   }
 
 private:
-  std::priority_queue<event, std::vector<event>, event_less> event_queue_;
+  static constexpr unsigned int tick_bits = 16; // 65.536 us
+  static constexpr unsigned int level_bits = 6;
+  static constexpr unsigned int slots = 1U << level_bits;
+  static constexpr unsigned int levels = 4;
+  static constexpr uint32_t nil = UINT32_MAX;
+  static constexpr std::chrono::nanoseconds tick_duration{1 << tick_bits};
+  static constexpr uint32_t due_list = levels * slots;
+  static constexpr uint32_t running_list = due_list + 1;
+
+  struct node {
+    callback cb;
+    uint64_t expire = 0;
+    uint32_t prev = nil;
+    uint32_t next = nil;
+    uint32_t list = nil;
+    uint32_t generation = 0;
+  };
+
+  static uint64_t to_tick(clock::time_point t) {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  t.time_since_epoch())
+                  .count();
+    return ns < 0 ? 0 : static_cast<uint64_t>(ns) >> tick_bits;
+  }
+
+  static uint32_t slot_list(unsigned int level, uint64_t tick) {
+    return level * slots +
+           static_cast<uint32_t>((tick >> (level_bits * level)) & (slots - 1));
+  }
+
+  uint32_t allocate() {
+    if (free_ == nil) {
+      nodes_.emplace_back();
+      return static_cast<uint32_t>(nodes_.size() - 1);
+    }
+    uint32_t index = free_;
+    free_ = nodes_[index].next;
+    return index;
+  }
+
+  void release(uint32_t index) {
+    node& n = nodes_[index];
+    n.cb.reset();
+    ++n.generation;
+    n.next = free_;
+    free_ = index;
+  }
+
+  // Place a node in the wheel relative to the current tick
+  void insert(uint32_t index) {
+    const uint64_t expire = nodes_[index].expire;
+    const uint64_t delta = expire > current_tick_ ? expire - current_tick_ : 0;
+    unsigned int level = 0;
+    while (level < levels - 1 &&
+           delta >= (UINT64_C(1) << (level_bits * (level + 1)))) {
+      ++level;
+    }
+    uint64_t tick = expire;
+    if (delta >= (UINT64_C(1) << (level_bits * levels))) {
+      // Beyond the span of the wheel, re-inserted on cascade
+      tick = current_tick_ + (UINT64_C(1) << (level_bits * levels)) - 1;
+    }
+    link(index, slot_list(level, tick));
+  }
+
+  void link(uint32_t index, uint32_t list) {
+    node& n = nodes_[index];
+    n.list = list;
+    n.next = nil;
+    n.prev = tails_[list];
+    if (n.prev == nil) {
+      heads_[list] = index;
+    } else {
+      nodes_[n.prev].next = index;
+    }
+    tails_[list] = index;
+    if (list < due_list) {
+      ++level_size_[list / slots];
+    }
+    ++size_;
+  }
+
+  void unlink(uint32_t index) {
+    node& n = nodes_[index];
+    if (n.prev == nil) {
+      heads_[n.list] = n.next;
+    } else {
+      nodes_[n.prev].next = n.next;
+    }
+    if (n.next == nil) {
+      tails_[n.list] = n.prev;
+    } else {
+      nodes_[n.next].prev = n.prev;
+    }
+    if (n.list < due_list) {
+      --level_size_[n.list / slots];
+    }
+    n.list = nil;
+    --size_;
+  }
+
+  // Move the nodes of the current slot of a level to the levels below
+  void cascade(unsigned int level) {
+    const uint32_t list = slot_list(level, current_tick_);
+    uint32_t index = heads_[list];
+    while (index != nil) {
+      uint32_t next = nodes_[index].next;
+      unlink(index);
+      insert(index);
+      index = next;
+    }
+  }
+
+  // Run the nodes of a list, except those added to it while running
+  void run_list(uint32_t list) {
+    uint32_t index = heads_[list];
+    while (index != nil) {
+      uint32_t next = nodes_[index].next;
+      unlink(index);
+      link(index, running_list);
+      index = next;
+    }
+    while ((index = heads_[running_list]) != nil) {
+      unlink(index);
+      callback cb = std::move(nodes_[index].cb);
+      release(index);
+      cb();
+    }
+  }
+
+  std::vector<node> nodes_;
+  std::array<uint32_t, levels * slots + 2> heads_{};
+  std::array<uint32_t, levels * slots + 2> tails_{};
+  std::array<std::size_t, levels> level_size_{};
+  uint32_t free_ = nil;
+  uint64_t current_tick_;
+  std::size_t size_ = 0;
 };
@@ -0,0 +1,11 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the SchedulerPolicy enum for the DFS interval scheduler.
+#pragma once
+
+/// Policy of the DFS interval scheduler to derive the interval durations.
+enum class SchedulerPolicy {
+  Heuristic, ///< Median of the history, sped up by fixed percentages
+  Model      ///< Online model of durations, round trips and buffer fill
+};
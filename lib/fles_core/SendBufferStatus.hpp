@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the SendBufferStatus struct.
+#pragma once
+
+#include <boost/format.hpp>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Snapshot of the occupancy of an input node send buffer for status
+/// reports.
+struct SendBufferStatus {
+  std::chrono::system_clock::time_point time;
+  uint64_t size = 0;
+
+  uint64_t cached_acked = 0;
+  uint64_t acked = 0;
+  uint64_t sent = 0;
+  uint64_t written = 0;
+
+  [[nodiscard]] int64_t used() const {
+    assert(sent <= written);
+    return written - sent;
+  }
+  [[nodiscard]] int64_t sending() const {
+    assert(acked <= sent);
+    return sent - acked;
+  }
+  [[nodiscard]] int64_t freeing() const {
+    assert(cached_acked <= acked);
+    return acked - cached_acked;
+  }
+  [[nodiscard]] int64_t unused() const {
+    assert(written <= cached_acked + size);
+    return cached_acked + size - written;
+  }
+
+  [[nodiscard]] float percentage(int64_t value) const {
+    return static_cast<float>(value) / static_cast<float>(size);
+  }
+
+  static std::string caption() { return {"used/sending/freeing/free"}; }
+
+  [[nodiscard]] std::string percentage_str(int64_t value) const {
+    boost::format percent_fmt("%4.1f%%");
+    percent_fmt % (percentage(value) * 100);
+    std::string s = percent_fmt.str();
+    s.resize(4);
+    return s;
+  }
+
+  [[nodiscard]] std::string percentages() const {
+    return percentage_str(used()) + " " + percentage_str(sending()) + " " +
+           percentage_str(freeing()) + " " + percentage_str(unused());
+  }
+
+  [[nodiscard]] std::vector<int64_t> vector() const {
+    return std::vector<int64_t>{used(), sending(), freeing(), unused()};
+  }
+};
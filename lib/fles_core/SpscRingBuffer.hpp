@@ -0,0 +1,138 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the SpscRingBuffer template class.
+#pragma once
+
+#include "RingBuffer.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * \brief Lock-free single-producer/single-consumer ring buffer.
+ *
+ * The write (head) and read (tail) positions are atomic with acquire/release
+ * semantics and live on separate cache lines, together with the respective
+ * side's cached copy of the opposite position. The cached copy is refreshed
+ * only if it does not suffice for a request, so producer and consumer touch
+ * the other side's cache line only when the buffer appears full or empty.
+ *
+ * Elements are written in batches: reserve() a number of slots, fill them
+ * via slot(), and publish them with commit(). Reading works the same way
+ * with available(), at(), and consume(). Positions are monotonically
+ * increasing 64-bit counters, i.e., they never wrap in practice.
+ */
+template <typename T, bool PAGE_ALIGNED = false> class SpscRingBuffer {
+public:
+  /// Construct a ring buffer holding 2^size_exponent elements.
+  explicit SpscRingBuffer(std::size_t size_exponent)
+      : buffer_(size_exponent) {}
+
+  SpscRingBuffer(const SpscRingBuffer&) = delete;
+  void operator=(const SpscRingBuffer&) = delete;
+
+  /// Retrieve buffer size in maximum number of entries.
+  [[nodiscard]] std::size_t size() const { return buffer_.size(); }
+
+  // Producer interface
+
+  /**
+   * \brief Reserve up to n slots for writing (producer only).
+   *
+   * \return The number of slots available for writing, at most n
+   */
+  std::size_t reserve(std::size_t n = SIZE_MAX) {
+    uint64_t head = producer_.position.load(std::memory_order_relaxed);
+    uint64_t free = buffer_.size() - (head - producer_.cached);
+    if (free < n) {
+      producer_.cached = consumer_.position.load(std::memory_order_acquire);
+      free = buffer_.size() - (head - producer_.cached);
+    }
+    return free < n ? free : n;
+  }
+
+  /// Access the i-th reserved slot (producer only).
+  T& slot(std::size_t i) {
+    return buffer_.at(producer_.position.load(std::memory_order_relaxed) + i);
+  }
+
+  /// Publish the first n reserved slots to the consumer (producer only).
+  void commit(std::size_t n) {
+    producer_.position.store(
+        producer_.position.load(std::memory_order_relaxed) + n,
+        std::memory_order_release);
+  }
+
+  /// Write a single element if there is space (producer only).
+  bool push(const T& item) {
+    if (reserve(1) == 0) {
+      return false;
+    }
+    slot(0) = item;
+    commit(1);
+    return true;
+  }
+
+  /// Retrieve the total number of elements written.
+  [[nodiscard]] uint64_t write_position() const {
+    return producer_.position.load(std::memory_order_acquire);
+  }
+
+  // Consumer interface
+
+  /**
+   * \brief Query up to n elements available for reading (consumer only).
+   *
+   * \return The number of elements available for reading, at most n
+   */
+  std::size_t available(std::size_t n = SIZE_MAX) {
+    uint64_t tail = consumer_.position.load(std::memory_order_relaxed);
+    uint64_t filled = consumer_.cached - tail;
+    if (filled < n) {
+      consumer_.cached = producer_.position.load(std::memory_order_acquire);
+      filled = consumer_.cached - tail;
+    }
+    return filled < n ? filled : n;
+  }
+
+  /// Access the i-th available element (consumer only).
+  const T& at(std::size_t i) const {
+    return buffer_.at(consumer_.position.load(std::memory_order_relaxed) + i);
+  }
+
+  /// Release the first n available elements to the producer (consumer only).
+  void consume(std::size_t n) {
+    consumer_.position.store(
+        consumer_.position.load(std::memory_order_relaxed) + n,
+        std::memory_order_release);
+  }
+
+  /// Read a single element if available (consumer only).
+  bool pop(T& item) {
+    if (available(1) == 0) {
+      return false;
+    }
+    item = at(0);
+    consume(1);
+    return true;
+  }
+
+  /// Retrieve the total number of elements read.
+  [[nodiscard]] uint64_t read_position() const {
+    return consumer_.position.load(std::memory_order_acquire);
+  }
+
+private:
+  static constexpr std::size_t cache_line_size = 64;
+
+  /// Position owned by one side, with its cached copy of the other side's.
+  struct alignas(cache_line_size) Index {
+    std::atomic<uint64_t> position{0};
+    uint64_t cached = 0;
+  };
+
+  RingBuffer<T, true, PAGE_ALIGNED> buffer_;
+  Index producer_;
+  Index consumer_;
+};
@@ -0,0 +1,259 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::StaticPipeline class template and the CRTP base
+/// classes of its stages and sinks.
+#pragma once
+
+#include "Pipeline.hpp"
+#include "Sink.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace fles {
+
+/**
+ * \brief The StaticStage class is the CRTP base class of a processing stage
+ * usable in both a StaticPipeline and a (dynamic) Pipeline.
+ *
+ * The derived class implements
+ * \code
+ * template <class Emit>
+ * void process_item(std::unique_ptr<Input> item, Emit& emit);
+ * \endcode
+ * and, if it keeps items across calls, a corresponding finish_items(emit).
+ * Output items are passed on by calling emit(std::unique_ptr<Output>). In a
+ * StaticPipeline, emit is the inlined call of the following stage; in a
+ * Pipeline, it pushes to the PipelineOutput.
+ */
+template <class Derived, class Input, class Output = Input>
+class StaticStage : public PipelineStage<Input, Output> {
+public:
+  void process(std::unique_ptr<Input> item,
+               PipelineOutput<Output>& output) final {
+    auto emit = [&output](std::unique_ptr<Output> out) {
+      output.push(std::move(out));
+    };
+    static_cast<Derived&>(*this).process_item(std::move(item), emit);
+  }
+
+  void finish(PipelineOutput<Output>& output) final {
+    auto emit = [&output](std::unique_ptr<Output> out) {
+      output.push(std::move(out));
+    };
+    static_cast<Derived&>(*this).finish_items(emit);
+  }
+
+  /// Pass any remaining items on at the end of the stream (default: none).
+  template <class Emit> void finish_items(Emit& /* emit */) {}
+};
+
+/**
+ * \brief The StaticSink class is the CRTP base class of a sink usable in both
+ * a StaticPipeline and as a (dynamic) Sink.
+ *
+ * The derived class implements void consume(const T& item), which receives
+ * each item by reference and must not keep it beyond the call. Only the Sink
+ * interface converts the items to std::shared_ptr.
+ */
+template <class Derived, class T> class StaticSink : public Sink<T> {
+public:
+  void put(std::shared_ptr<const T> item) final {
+    static_cast<Derived&>(*this).consume(*item);
+  }
+};
+
+/// Implementation details of the StaticPipeline class.
+namespace pipeline {
+
+template <class Stage, class Item, class Emit>
+using process_item_t = decltype(std::declval<Stage&>().process_item(
+    std::declval<Item>(), std::declval<Emit&>()));
+
+template <class Stage, class Emit>
+using finish_items_t =
+    decltype(std::declval<Stage&>().finish_items(std::declval<Emit&>()));
+
+template <class Sink, class Item>
+using consume_t =
+    decltype(std::declval<Sink&>().consume(*std::declval<Item>()));
+
+/// Check whether a stage implements process_item() (see StaticStage).
+template <class Stage, class Item, class Emit, class = void>
+struct has_process_item : std::false_type {};
+
+template <class Stage, class Item, class Emit>
+struct has_process_item<Stage, Item, Emit,
+                        std::void_t<process_item_t<Stage, Item, Emit>>>
+    : std::true_type {};
+
+/// Check whether a stage implements finish_items() (see StaticStage).
+template <class Stage, class Emit, class = void>
+struct has_finish_items : std::false_type {};
+
+template <class Stage, class Emit>
+struct has_finish_items<Stage, Emit, std::void_t<finish_items_t<Stage, Emit>>>
+    : std::true_type {};
+
+/// Check whether a sink implements consume() (see StaticSink).
+template <class Sink, class Item, class = void>
+struct has_consume : std::false_type {};
+
+template <class Sink, class Item>
+struct has_consume<Sink, Item, std::void_t<consume_t<Sink, Item>>>
+    : std::true_type {};
+
+/// Output of a dynamic PipelineStage passing each item on to emit.
+template <class T, class Emit> class EmitOutput : public PipelineOutput<T> {
+public:
+  explicit EmitOutput(Emit& emit) : emit_(emit) {}
+
+  void push(std::unique_ptr<T> item) override { emit_(std::move(item)); }
+
+  void finish() override {}
+
+private:
+  Emit& emit_;
+};
+
+/// Call a dynamic PipelineStage with an inlined continuation.
+template <class Input, class Output, class Item, class Emit>
+void process_dynamic(PipelineStage<Input, Output>& stage,
+                     Item item,
+                     Emit& emit) {
+  EmitOutput<Output, Emit> output(emit);
+  stage.process(std::move(item), output);
+}
+
+template <class Input, class Output, class Emit>
+void finish_dynamic(PipelineStage<Input, Output>& stage, Emit& emit) {
+  EmitOutput<Output, Emit> output(emit);
+  stage.finish(output);
+}
+
+/// Pass an item to a dynamic Sink, which shares its ownership.
+template <class T, class Item> void put_dynamic(Sink<T>& sink, Item item) {
+  sink.put(std::shared_ptr<const T>(std::move(item)));
+}
+
+} // namespace pipeline
+
+/**
+ * \brief The StaticPipeline class connects a source, a fixed chain of
+ * processing stages, and a sink at compile time.
+ *
+ * In contrast to the Pipeline class, all stages run in the calling thread
+ * and each stage calls the following one directly, so that the compiler can
+ * inline the whole chain. Items are moved from stage to stage as
+ * std::unique_ptr and passed to the sink by reference.
+ *
+ * StaticStage and StaticSink objects are called without virtual function
+ * calls. Any other PipelineStage or Sink is accepted as well and called
+ * through its dynamic interface, so existing components can be combined
+ * with static ones. The source is any object whose get() returns a
+ * std::unique_ptr to the next item, or nullptr at the end of the stream.
+ *
+ * Use make_pipeline() to construct a StaticPipeline.
+ */
+template <class SourceType, class... Elements> class StaticPipeline {
+  static_assert(sizeof...(Elements) >= 1, "pipeline without sink");
+
+public:
+  StaticPipeline(SourceType& source, Elements&... elements)
+      : source_(source), elements_(elements...) {}
+
+  /**
+   * \brief Process all items, passing the resulting items to the sink.
+   *
+   * The end of the stream is signaled to the sink after the last item.
+   *
+   * \param limit Maximum number of items to read from the source
+   * \return The number of items passed to the sink
+   */
+  uint64_t run(uint64_t limit = UINT64_MAX) {
+    count_ = 0;
+    for (uint64_t count = 0; count < limit; ++count) {
+      auto item = source_.get();
+      if (!item) {
+        break;
+      }
+      push<0>(std::move(item));
+    }
+    finish<0>();
+    return count_;
+  }
+
+private:
+  static constexpr std::size_t sink_index = sizeof...(Elements) - 1;
+
+  SourceType& source_;
+  std::tuple<Elements&...> elements_;
+  uint64_t count_ = 0;
+
+  template <std::size_t I> auto emitter() {
+    return [this](auto item) { push<I + 1>(std::move(item)); };
+  }
+
+  template <std::size_t I, class Item> void push(Item item) {
+    auto& element = std::get<I>(elements_);
+    using ElementType = std::remove_reference_t<decltype(element)>;
+    if constexpr (I == sink_index) {
+      if constexpr (pipeline::has_consume<ElementType, Item>::value) {
+        element.consume(*item);
+      } else {
+        pipeline::put_dynamic(element, std::move(item));
+      }
+      ++count_;
+    } else {
+      auto emit = emitter<I>();
+      if constexpr (pipeline::has_process_item<ElementType, Item,
+                                               decltype(emit)>::value) {
+        element.process_item(std::move(item), emit);
+      } else {
+        pipeline::process_dynamic(element, std::move(item), emit);
+      }
+    }
+  }
+
+  /// Flush the stages in order, then end the stream of the sink.
+  template <std::size_t I> void finish() {
+    auto& element = std::get<I>(elements_);
+    if constexpr (I == sink_index) {
+      element.end_stream();
+    } else {
+      using ElementType = std::remove_reference_t<decltype(element)>;
+      auto emit = emitter<I>();
+      if constexpr (pipeline::has_finish_items<ElementType,
+                                               decltype(emit)>::value) {
+        element.finish_items(emit);
+      } else {
+        pipeline::finish_dynamic(element, emit);
+      }
+      finish<I + 1>();
+    }
+  }
+};
+
+/**
+ * \brief Construct a StaticPipeline from a source, any number of stages, and
+ * a sink (the last argument).
+ *
+ * Example:
+ * \code
+ * MicrosliceInputArchive source("input.msa");
+ * CombineContentsStage combine;
+ * MicrosliceOutputArchive output("output.msa");
+ * make_pipeline(source, combine, output).run();
+ * \endcode
+ */
+template <class SourceType, class... Elements>
+StaticPipeline<SourceType, Elements...>
+make_pipeline(SourceType& source, Elements&... elements) {
+  return StaticPipeline<SourceType, Elements...>(source, elements...);
+}
+
+} // namespace fles
@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "StreamingCopy.hpp"
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+void streaming_copy(void* dst,
+                    const void* src,
+                    std::size_t size,
+                    bool prefetch_source) {
+#if defined(__x86_64__)
+  if (size >= streaming_copy_threshold) {
+    auto* d = static_cast<uint8_t*>(dst);
+    const auto* s = static_cast<const uint8_t*>(src);
+
+    // Align the destination for the streaming stores
+    constexpr std::size_t vector_size = sizeof(__m128i);
+    const std::size_t head =
+        (vector_size - reinterpret_cast<std::uintptr_t>(d) % vector_size) %
+        vector_size;
+    std::memcpy(d, s, head);
+    d += head;
+    s += head;
+    size -= head;
+
+    // Four vectors (one cache line) per iteration
+    constexpr std::size_t block = 4 * vector_size;
+    constexpr std::size_t prefetch_distance = 8 * block;
+    for (; size >= block; size -= block, d += block, s += block) {
+      if (prefetch_source && size >= prefetch_distance + block) {
+        _mm_prefetch(reinterpret_cast<const char*>(s + prefetch_distance),
+                     _MM_HINT_NTA);
+      }
+      const auto* in = reinterpret_cast<const __m128i*>(s);
+      auto* out = reinterpret_cast<__m128i*>(d);
+      const __m128i v0 = _mm_loadu_si128(in);
+      const __m128i v1 = _mm_loadu_si128(in + 1);
+      const __m128i v2 = _mm_loadu_si128(in + 2);
+      const __m128i v3 = _mm_loadu_si128(in + 3);
+      _mm_stream_si128(out, v0);
+      _mm_stream_si128(out + 1, v1);
+      _mm_stream_si128(out + 2, v2);
+      _mm_stream_si128(out + 3, v3);
+    }
+    std::memcpy(d, s, size);
+    _mm_sfence();
+    return;
+  }
+#else
+  (void)prefetch_source;
+#endif
+  std::memcpy(dst, src, size);
+}
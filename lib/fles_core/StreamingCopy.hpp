@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines a memory copy bypassing the caches for large buffers.
+#pragma once
+
+#include <cstddef>
+
+/// Size in bytes from which streaming_copy() bypasses the caches.
+constexpr std::size_t streaming_copy_threshold = std::size_t{1} << 18;
+
+/// Copy a buffer that is not read again soon by the calling thread.
+/**
+ * Buffers of at least streaming_copy_threshold bytes are written with
+ * non-temporal stores where available (x86-64), so that copying large
+ * timeslice components into a shared memory buffer neither evicts the
+ * working set of the caller nor reads the destination lines first. The
+ * stores are ordered before any subsequent store on return, so the data is
+ * visible to other processes once a work item referring to it has been
+ * published. Smaller buffers are copied with std::memcpy.
+ *
+ * With prefetch_source, the source is prefetched a few cache lines ahead
+ * of the streaming loop, which helps if it is not in the caches and its
+ * pages are not sequential to the hardware prefetcher (e.g., a mapped
+ * archive file).
+ */
+void streaming_copy(void* dst,
+                    const void* src,
+                    std::size_t size,
+                    bool prefetch_source = false);
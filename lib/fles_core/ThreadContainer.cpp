@@ -25,6 +25,29 @@ void ThreadContainer::set_node() {
 #endif
 }
 
+// Bind the calling thread and its future allocations to a single node.
+void ThreadContainer::set_node(int node) {
+#ifdef HAVE_NUMA
+  if (numa_available() == -1) {
+    L_(error) << "numa_available() failed";
+    return;
+  }
+  if (node < 0 || node > numa_max_node()) {
+    L_(debug) << "set_node: node " << node << " is not in range 0.."
+              << numa_max_node();
+    return;
+  }
+
+  struct bitmask* nodemask = numa_allocate_nodemask();
+  numa_bitmask_setbit(nodemask, static_cast<unsigned int>(node));
+  numa_bind(nodemask);
+  numa_free_nodemask(nodemask);
+#else
+  (void)node;
+  L_(debug) << "set_node: built without libnuma";
+#endif
+}
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wold-style-cast"
 
@@ -49,4 +72,31 @@ void ThreadContainer::set_cpu(int n) {
 #endif
 }
 
+// Restrict the calling thread to a set of CPUs (inherited by its children).
+void ThreadContainer::set_cpus(const std::vector<int>& cpus) {
+#ifdef HAVE_NUMA
+  int nprocs = sysconf(_SC_NPROCESSORS_ONLN);
+  cpu_set_t cpu_mask;
+  CPU_ZERO(&cpu_mask);
+  for (int n : cpus) {
+    if (n < 0 || n >= nprocs) {
+      L_(debug) << "set_cpus: CPU " << n << " is not in range 0.."
+                << (nprocs - 1);
+      continue;
+    }
+    CPU_SET(n, &cpu_mask);
+  }
+  if (CPU_COUNT(&cpu_mask) == 0) {
+    return;
+  }
+
+  if (sched_setaffinity(0, sizeof(cpu_mask), &cpu_mask) != 0) {
+    L_(error) << "set_cpus: could not set CPU affinity";
+  }
+#else
+  (void)cpus;
+  L_(debug) << "set_cpus: built without libnuma";
+#endif
+}
+
 #pragma GCC diagnostic pop
@@ -1,8 +1,12 @@
 // Copyright 2013 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include <vector>
+
 class ThreadContainer {
 protected:
   static void set_node();
+  static void set_node(int node);
   static void set_cpu(int n);
+  static void set_cpus(const std::vector<int>& cpus);
 };
@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the TimesliceAckTracker class template.
+#pragma once
+
+#include "DualRingBuffer.hpp"
+#include "RingBuffer.hpp"
+#include "TimesliceBoundaries.hpp"
+#include <cassert>
+#include <cstdint>
+
+/**
+ * \brief Transport-independent acknowledgment accounting of an input node
+ * sender.
+ *
+ * Tracks the completions of the timeslice components sent from an input
+ * buffer, which may arrive out of order, and releases the buffer space of the
+ * components completed in order to the data source. The read index is
+ * written with a hysteresis of a quarter of each buffer, or on sync().
+ *
+ * The transport properties are compile-time parameters, so the tracker is
+ * inlined into the completion handlers: the data source type (any type
+ * providing desc_buffer(), data_buffer(), get_read_index() and
+ * set_read_index()), and the number of completions that finish a component
+ * (e.g., two if descriptors and data are acknowledged separately).
+ *
+ * Constructed from a TimesliceBoundaries object, the tracker supports
+ * timeslices that are not fixed in size and releases their boundaries once
+ * completed.
+ */
+template <typename DataSource, unsigned int CompletionsPerTimeslice = 1>
+class TimesliceAckTracker {
+  static_assert(CompletionsPerTimeslice > 0);
+
+public:
+  TimesliceAckTracker(DataSource& data_source, uint64_t timeslice_size)
+      : data_source_(data_source), timeslice_size_(timeslice_size),
+        min_acked_({data_source.desc_buffer().size() / 4,
+                    data_source.data_buffer().size() / 4}),
+        start_index_(data_source.get_read_index()), acked_(start_index_),
+        cached_acked_(start_index_) {
+    ack_.alloc_with_size(
+        (data_source.desc_buffer().size() / timeslice_size + 1) *
+        CompletionsPerTimeslice);
+  }
+
+  TimesliceAckTracker(DataSource& data_source,
+                      TimesliceBoundaries<DataSource>& boundaries)
+      : data_source_(data_source), timeslice_size_(0),
+        boundaries_(&boundaries),
+        min_acked_({data_source.desc_buffer().size() / 4,
+                    data_source.data_buffer().size() / 4}),
+        start_index_(data_source.get_read_index()), acked_(start_index_),
+        cached_acked_(start_index_) {
+    ack_.alloc_with_size(boundaries.max_pending() * CompletionsPerTimeslice);
+  }
+
+  /// Record a completion of a timeslice component.
+  /** \param completion the index of the completion for the component, less
+      than CompletionsPerTimeslice */
+  void ack(uint64_t timeslice, unsigned int completion = 0) {
+    assert(completion < CompletionsPerTimeslice);
+    uint64_t n = timeslice * CompletionsPerTimeslice + completion;
+    assert(n >= acked_count_);
+    if (n != acked_count_) {
+      // transmission has been reordered, store completion information
+      ack_.at(n) = n;
+      return;
+    }
+    // completion is for earliest pending timeslice, update indices
+    do {
+      ++acked_count_;
+    } while (ack_.at(acked_count_) > n);
+
+    if (boundaries_ != nullptr) {
+      boundaries_->release(acked_timeslices());
+      acked_.desc = boundaries_->begin(acked_timeslices());
+    } else {
+      acked_.desc = acked_timeslices() * timeslice_size_ + start_index_.desc;
+    }
+    if (acked_.desc == start_index_.desc) {
+      // only a partial completion of the first timeslice
+      return;
+    }
+    acked_.data = data_source_.desc_buffer().at(acked_.desc - 1).offset +
+                  data_source_.desc_buffer().at(acked_.desc - 1).size;
+    if (acked_.data >= cached_acked_.data + min_acked_.data ||
+        acked_.desc >= cached_acked_.desc + min_acked_.desc) {
+      cached_acked_ = acked_;
+      data_source_.set_read_index(cached_acked_);
+    }
+  }
+
+  /// Release all buffer space of the completed components to the data
+  /// source.
+  void sync() {
+    if (acked_.data > cached_acked_.data || acked_.desc > cached_acked_.desc) {
+      cached_acked_ = acked_;
+      data_source_.set_read_index(cached_acked_);
+    }
+  }
+
+  /// Retrieve the number of timeslices completed in order.
+  [[nodiscard]] uint64_t acked_timeslices() const {
+    return acked_count_ / CompletionsPerTimeslice;
+  }
+
+  /// Retrieve the read indexes of the components completed in order.
+  [[nodiscard]] const DualIndex& acked() const { return acked_; }
+
+  /// Retrieve the read indexes last written to the data source.
+  [[nodiscard]] const DualIndex& cached_acked() const { return cached_acked_; }
+
+  /// Retrieve the read indexes at the start of operation.
+  [[nodiscard]] const DualIndex& start_index() const { return start_index_; }
+
+private:
+  DataSource& data_source_;
+
+  const uint64_t timeslice_size_;
+
+  /// Boundaries of timeslices not fixed in size, if any.
+  TimesliceBoundaries<DataSource>* boundaries_ = nullptr;
+
+  /// Hysteresis for writing read indexes to data source.
+  const DualIndex min_acked_;
+
+  /// Read indexes at start of operation.
+  const DualIndex start_index_;
+
+  /// Buffer to store out-of-order completions.
+  RingBuffer<uint64_t, true> ack_;
+
+  /// Number of in-order completions.
+  uint64_t acked_count_ = 0;
+
+  /// Indexes of acknowledged microslices (i.e., read indexes).
+  DualIndex acked_;
+
+  /// Read indexes last written to data source.
+  DualIndex cached_acked_;
+};
@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the TimesliceAggregator class.
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * \brief Lock-free aggregation of timeslice positions across shards.
+ *
+ * The input connections of a timeslice builder may be distributed over
+ * several progress threads (shards). Each shard publishes the number of
+ * timeslices that are completely written on all of its connections. A
+ * timeslice is complete once every shard has delivered its components, i.e.,
+ * the overall position is the minimum over all shards. In the opposite
+ * direction, the aggregation stage publishes the acknowledged position for
+ * the shards to pick up.
+ *
+ * Every position has a single writer and lives on its own cache line.
+ */
+class TimesliceAggregator {
+public:
+  /// Construct an aggregator for a given number of shards.
+  explicit TimesliceAggregator(std::size_t num_shards)
+      : num_shards_(num_shards),
+        written_(std::make_unique<Position[]>(num_shards)) {
+    assert(num_shards > 0);
+  }
+
+  TimesliceAggregator(const TimesliceAggregator&) = delete;
+  void operator=(const TimesliceAggregator&) = delete;
+
+  /// Retrieve the number of shards.
+  [[nodiscard]] std::size_t num_shards() const { return num_shards_; }
+
+  /// Publish the number of timeslices completely written to a shard.
+  void publish_written(std::size_t shard, uint64_t written) {
+    assert(shard < num_shards_);
+    written_[shard].value.store(written, std::memory_order_release);
+  }
+
+  /// Retrieve the number of timeslices completely written to all shards.
+  [[nodiscard]] uint64_t completely_written() const {
+    uint64_t written = UINT64_MAX;
+    for (std::size_t i = 0; i < num_shards_; ++i) {
+      written =
+          std::min(written, written_[i].value.load(std::memory_order_acquire));
+    }
+    return written;
+  }
+
+  /// Publish the number of acknowledged timeslices.
+  void publish_acked(uint64_t acked) {
+    acked_.value.store(acked, std::memory_order_release);
+  }
+
+  /// Retrieve the number of acknowledged timeslices.
+  [[nodiscard]] uint64_t acked() const {
+    return acked_.value.load(std::memory_order_acquire);
+  }
+
+private:
+  static constexpr std::size_t cache_line_size = 64;
+
+  struct alignas(cache_line_size) Position {
+    std::atomic<uint64_t> value{0};
+  };
+
+  std::size_t num_shards_;
+
+  /// Per-shard number of completely written timeslices
+  std::unique_ptr<Position[]> written_;
+
+  /// Number of timeslices acknowledged by the aggregation stage
+  Position acked_;
+};
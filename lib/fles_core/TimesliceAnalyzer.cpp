@@ -1,16 +1,21 @@
 // Copyright 2013, 2015, 2021, 2023 Jan de Cuveland <cmail@cuveland.de>
 
 #include "TimesliceAnalyzer.hpp"
+#include "DescriptorColumns.hpp"
 #include "PatternChecker.hpp"
 #include "System.hpp"
 #include "TimesliceDebugger.hpp"
 #include "Utility.hpp"
+#include "WorkerPool.hpp"
+#include "crc32c_batch.h" // crcutil_interface::Crc32cBatch
 #include <boost/algorithm/string.hpp>
 #include <boost/format.hpp>
 #include <cassert>
 #include <chrono>
+#include <future>
 #include <iomanip>
 #include <sstream>
+#include <utility>
 
 // Aim for balance: the TimesliceAnalyzer should provide detailed information if
 // an inconsistency is encountered in the data stream. On the other hand, it
@@ -43,36 +48,102 @@ std::string ns_timestamp(uint64_t time_ns) {
 }
 } // namespace
 
+/// The results of checking a single timeslice component.
+/** The diagnostic messages are recorded in blocks. Each block is printed if
+    the output is still active when it is applied, followed by counting its
+    microslice error, just like in a serial check. */
+struct TimesliceAnalyzer::ComponentCheck {
+  struct Block {
+    std::vector<std::pair<std::string, std::string>> messages;
+    bool microslice_error = false;
+  };
+
+  /// Record diagnostic messages (output was active at the start).
+  bool record = false;
+  std::vector<Block> blocks;
+  Block current;
+  std::string histogram;
+
+  bool success = true;
+  size_t microslice_count = 0;
+  size_t content_bytes = 0;
+
+  /// Descriptor fields of the component's microslices.
+  DescriptorColumns columns;
+  /// Microslice contents of the component for CRC computation.
+  std::vector<crcutil_interface::CrcBuffer> crc_buffers;
+  /// Computed CRC-32C values of the component's microslices.
+  std::vector<uint32_t> crc_values;
+
+  void reset(bool arg_record) {
+    record = arg_record;
+    blocks.clear();
+    current = Block();
+    histogram.clear();
+    success = true;
+    microslice_count = 0;
+    content_bytes = 0;
+  }
+
+  void print(std::string text, const std::string& prefix = "") {
+    current.messages.emplace_back(std::move(text), prefix);
+  }
+
+  void end_block(bool microslice_error) {
+    if (microslice_error || !current.messages.empty()) {
+      current.microslice_error = microslice_error;
+      blocks.push_back(std::move(current));
+      current = Block();
+    }
+  }
+};
+
 TimesliceAnalyzer::TimesliceAnalyzer(uint64_t arg_output_interval,
                                      std::ostream& arg_out,
                                      std::string arg_output_prefix,
                                      std::ostream* arg_hist,
-                                     cbm::Monitor* monitor)
+                                     cbm::Monitor* monitor,
+                                     unsigned arg_threads)
     : output_interval_(arg_output_interval), out_(arg_out),
       output_prefix_(std::move(arg_output_prefix)), hist_(arg_hist),
       previous_output_time_(std::chrono::system_clock::now()),
       monitor_(monitor) {
-  // create CRC-32C engine (Castagnoli polynomial)
-  crc32_engine_ = crcutil_interface::CRC::Create(
-      0x82f63b78, 0, 32, true, 0, 0, 0,
-      crcutil_interface::CRC::IsSSE42Available(), nullptr);
-
   hostname_ = fles::system::current_hostname();
+  if (arg_threads > 0) {
+    pool_ = std::make_unique<WorkerPool>(arg_threads);
+  }
+  if (cbm::LiveStats::Enabled()) {
+    live_ = std::make_unique<LiveStatistics>();
+    live_->timeslices = cbm::LiveStats::Counter("analyzer_timeslices");
+    live_->components = cbm::LiveStats::Counter("analyzer_components");
+    live_->microslices = cbm::LiveStats::Counter("analyzer_microslices");
+    live_->content_bytes = cbm::LiveStats::Counter("analyzer_content_bytes");
+    live_->timeslice_errors =
+        cbm::LiveStats::Counter("analyzer_timeslice_errors");
+    live_->component_errors =
+        cbm::LiveStats::Counter("analyzer_component_errors");
+    live_->microslice_errors =
+        cbm::LiveStats::Counter("analyzer_microslice_errors");
+    live_->timeslice_index = cbm::LiveStats::Counter("analyzer_ts_index");
+  }
 
   report_status();
 }
 
-TimesliceAnalyzer::~TimesliceAnalyzer() {
-  if (crc32_engine_ != nullptr) {
-    crc32_engine_->Delete();
-  }
-}
+TimesliceAnalyzer::~TimesliceAnalyzer() = default;
 
 void TimesliceAnalyzer::put(std::shared_ptr<const fles::Timeslice> timeslice) {
   bool success = check_timeslice(*timeslice);
   if (!success) {
     ++timeslice_error_count_;
   }
+  if (live_) {
+    live_->timeslices.Add();
+    live_->timeslice_index.Set(timeslice->index());
+    if (!success) {
+      live_->timeslice_errors.Add();
+    }
+  }
   scheduler_.timer();
 
   // print statistics if either the next round number (multiple of
@@ -89,12 +160,19 @@ void TimesliceAnalyzer::initialize(const fles::Timeslice& ts) {
   start_index_ = ts.index();
   reference_descriptors_.clear();
   pattern_checkers_.clear();
+  if (live_) {
+    live_->microslice_sizes.clear();
+  }
   for (size_t c = 0; c < ts.num_components(); ++c) {
     assert(ts.num_microslices(c) > 0);
     fles::MicrosliceDescriptor desc = ts.get_microslice(c, 0).desc();
     reference_descriptors_.push_back(desc);
     pattern_checkers_.push_back(
         PatternChecker::create(desc.sys_id, desc.sys_ver, c));
+    if (live_) {
+      live_->microslice_sizes.push_back(
+          cbm::LiveStats::Histogram("microslice_size", desc.eq_id));
+    }
   }
 }
 
@@ -162,10 +240,28 @@ bool TimesliceAnalyzer::check_timeslice(const fles::Timeslice& ts) {
   }
 
   // check the individual timeslice components
+  checks_.resize(ts.num_components());
+  if (pool_) {
+    // error counts only increase, so output inactive now stays inactive
+    const bool record = output_active();
+    std::vector<std::future<void>> futures;
+    futures.reserve(ts.num_components());
+    for (size_t c = 0; c < ts.num_components(); ++c) {
+      checks_[c].reset(record);
+      futures.push_back(pool_->submit(
+          [this, &ts, c] { check_component(ts, c, checks_[c]); }));
+    }
+    for (auto& future : futures) {
+      future.get(); // rethrows exceptions of the check
+    }
+  }
   for (size_t c = 0; c < ts.num_components(); ++c) {
-    bool component_success = check_component(ts, c);
-    if (!component_success) {
-      ++component_error_count_;
+    if (!pool_) {
+      checks_[c].reset(output_active());
+      check_component(ts, c, checks_[c]);
+    }
+    apply_component_check(checks_[c]);
+    if (!checks_[c].success) {
       ts_success = false;
     }
   }
@@ -173,82 +269,153 @@ bool TimesliceAnalyzer::check_timeslice(const fles::Timeslice& ts) {
   return ts_success;
 }
 
-bool TimesliceAnalyzer::check_component(const fles::Timeslice& ts, size_t c) {
+void TimesliceAnalyzer::apply_component_check(ComponentCheck& check) {
   ++component_count_;
+  for (const auto& block : check.blocks) {
+    if (output_active()) {
+      for (const auto& [text, prefix] : block.messages) {
+        print(text, prefix);
+      }
+    }
+    if (block.microslice_error) {
+      ++microslice_error_count_;
+    }
+  }
+  if (hist_ != nullptr) {
+    *hist_ << check.histogram;
+  }
+  microslice_count_ += check.microslice_count;
+  content_bytes_ += check.content_bytes;
+  if (!check.success) {
+    ++component_error_count_;
+  }
+  if (live_) {
+    size_t microslice_errors = 0;
+    for (const auto& block : check.blocks) {
+      microslice_errors += block.microslice_error ? 1 : 0;
+    }
+    live_->components.Add();
+    live_->microslices.Add(check.microslice_count);
+    live_->content_bytes.Add(check.content_bytes);
+    live_->microslice_errors.Add(microslice_errors);
+    if (!check.success) {
+      live_->component_errors.Add();
+    }
+  }
+}
+
+void TimesliceAnalyzer::check_component(const fles::Timeslice& ts,
+                                        size_t c,
+                                        ComponentCheck& check) {
   bool component_success = true;
 
   if (ts.num_microslices(c) == 0) {
-    if (output_active()) {
+    if (check.record) {
       auto location = location_string(ts.index(), c);
-      print("error in " + location + ": no microslices in component");
+      check.print("error in " + location + ": no microslices in component");
     }
     component_success = false;
   }
+  check.end_block(false);
+
+  // decode the descriptor fields evaluated for the whole component
+  const fles::ComponentView component = ts.component(c);
+  const size_t num_microslices = component.size();
+  check.columns.assign(
+      num_microslices > 0 ? &component.descriptor(0) : nullptr,
+      num_microslices);
+  check.microslice_count += num_microslices;
+  check.content_bytes += check.columns.total_size();
+  if (live_ && c < live_->microslice_sizes.size()) {
+    const auto& histogram = live_->microslice_sizes[c];
+    for (uint32_t size : check.columns.size) {
+      histogram.Record(size);
+    }
+  }
+
+  // compute the CRC-32C of all microslices with valid CRC in one batch,
+  // except for those already checked by flesnet
+  check.crc_buffers.resize(num_microslices);
+  check.crc_values.resize(num_microslices);
+  auto* buffer = check.crc_buffers.data();
+  const uint16_t* flags = check.columns.flags.data();
+  for (const auto& ms : component) {
+    if ((*flags++ &
+         (static_cast<uint16_t>(fles::MicrosliceFlags::CrcValid) |
+          static_cast<uint16_t>(fles::MicrosliceFlags::CrcChecked))) ==
+        static_cast<uint16_t>(fles::MicrosliceFlags::CrcValid)) {
+      *buffer++ = {ms.content, ms.desc.size};
+    } else {
+      *buffer++ = {nullptr, 0};
+    }
+  }
+  crcutil_interface::Crc32cBatch(check.crc_buffers.data(), num_microslices,
+                                 check.crc_values.data());
 
   // check the individual microslices of the component
   pattern_checkers_.at(c)->reset();
-  for (size_t m = 0; m < ts.num_microslices(c); ++m) {
-    bool microslice_success = check_microslice(ts, c, m);
+  component.for_each([&](uint64_t m, const fles::MicrosliceRef& /*ms*/) {
+    bool microslice_success = check_microslice(ts, c, m, check);
+    check.end_block(!microslice_success);
     if (!microslice_success) {
-      ++microslice_error_count_;
       component_success = false;
     }
-  }
+  });
 
   // check start time consistency of microslices
-  if (ts.num_microslices(c) >= 2) {
-    uint64_t first = ts.get_microslice(c, 0).desc().idx;
-    uint64_t second = ts.get_microslice(c, 1).desc().idx;
+  if (num_microslices >= 2) {
+    uint64_t first = check.columns.idx[0];
+    uint64_t second = check.columns.idx[1];
     if (second <= first) {
-      if (output_active()) {
+      if (check.record) {
         auto location = location_string(ts.index(), c);
-        print("error in " + location +
-              ": start time not increasing in first two microslices");
-        print_microslice_descriptor(ts, c, 0);
-        print_microslice_descriptor(ts, c, 1);
+        check.print("error in " + location +
+                    ": start time not increasing in first two microslices");
+        print_microslice_descriptor(ts, c, 0, check);
+        print_microslice_descriptor(ts, c, 1, check);
       }
       component_success = false;
     } else {
       uint64_t reference_delta = second - first;
-      for (size_t m = 2; m < ts.num_microslices(c); ++m) {
-        uint64_t this_start_time = ts.get_microslice(c, m).desc().idx;
-        uint64_t expected_start_time = first + m * reference_delta;
-        if (this_start_time != expected_start_time) {
-          if (output_active()) {
-            auto location = location_string(ts.index(), c, m);
-            print("error in " + location +
-                  ": unexpected microslice start time");
-            print_microslice_descriptor(ts, c, 0);
-            print_microslice_descriptor(ts, c, 1);
-            print_microslice_descriptor(ts, c, m);
-          }
-          component_success = false;
+      for (size_t m =
+               check.columns.first_irregular(2, first, reference_delta);
+           m < num_microslices;
+           m = check.columns.first_irregular(m + 1, first, reference_delta)) {
+        if (check.record) {
+          auto location = location_string(ts.index(), c, m);
+          check.print("error in " + location +
+                      ": unexpected microslice start time");
+          print_microslice_descriptor(ts, c, 0, check);
+          print_microslice_descriptor(ts, c, 1, check);
+          print_microslice_descriptor(ts, c, m, check);
         }
+        component_success = false;
       }
     }
   }
 
-  return component_success;
+  check.end_block(false);
+
+  check.success = component_success;
 }
 
 bool TimesliceAnalyzer::check_microslice(const fles::Timeslice& ts,
                                          size_t c,
-                                         size_t m) {
+                                         size_t m,
+                                         ComponentCheck& check) {
   auto mv = ts.get_microslice(c, m);
   const auto& d = mv.desc();
 
-  ++microslice_count_;
-  content_bytes_ += d.size;
   bool error = false;
 
   // static descriptor checks
   if (d.hdr_id != 0xdd || d.hdr_ver != 0x01) {
     error = true;
-    if (output_active()) {
+    if (check.record) {
       auto location = location_string(ts.index(), c, m);
-      print("error in " + location +
-            ": unknown header format in microslice descriptor");
-      print_microslice_descriptor(ts, c, m);
+      check.print("error in " + location +
+                  ": unknown header format in microslice descriptor");
+      print_microslice_descriptor(ts, c, m, check);
     }
   }
 
@@ -256,69 +423,64 @@ bool TimesliceAnalyzer::check_microslice(const fles::Timeslice& ts,
   auto r = reference_descriptors_.at(c);
   if (d.eq_id != r.eq_id || d.sys_id != r.sys_id || d.sys_ver != r.sys_ver) {
     error = true;
-    if (output_active()) {
+    if (check.record) {
       auto location = location_string(ts.index(), c, m);
-      print("error in " + location +
-            ": unexpected change in microslice descriptor");
-      print_microslice_descriptor(ts, c, m);
+      check.print("error in " + location +
+                  ": unexpected change in microslice descriptor");
+      print_microslice_descriptor(ts, c, m, check);
     }
   }
 
   bool truncated =
       (d.flags & static_cast<uint16_t>(fles::MicrosliceFlags::OverflowFlim)) !=
       0;
-  if (truncated && output_active()) {
+  if (truncated && check.record) {
     auto location = location_string(ts.index(), c, m);
-    print("error in " + location + ": microslice truncated by FLIM");
-    print_microslice_descriptor(ts, c, m);
-    print_microslice_content(ts, c, m);
+    check.print("error in " + location + ": microslice truncated by FLIM");
+    print_microslice_descriptor(ts, c, m, check);
+    print_microslice_content(ts, c, m, check);
   }
 
   bool pattern_error = !pattern_checkers_.at(c)->check(mv);
-  if (pattern_error && output_active()) {
+  if (pattern_error && check.record) {
     auto location = location_string(ts.index(), c, m);
-    print("error in " + location + ": pattern error");
-    print_microslice_descriptor(ts, c, m);
-    print_microslice_content(ts, c, m);
+    check.print("error in " + location + ": pattern error");
+    print_microslice_descriptor(ts, c, m, check);
+    print_microslice_content(ts, c, m, check);
   }
 
+  bool crc_valid =
+      (d.flags & static_cast<uint16_t>(fles::MicrosliceFlags::CrcValid)) != 0;
+  bool crc_checked =
+      (d.flags & static_cast<uint16_t>(fles::MicrosliceFlags::CrcChecked)) !=
+      0;
   bool crc_error =
-      ((d.flags & static_cast<uint16_t>(fles::MicrosliceFlags::CrcValid)) !=
-       0) &&
-      !check_crc(mv);
-  if (crc_error && output_active()) {
+      crc_valid &&
+      (crc_checked ? (d.flags & static_cast<uint16_t>(
+                                    fles::MicrosliceFlags::CrcError)) != 0
+                   : check.crc_values.at(m) != d.crc);
+  if (crc_error && check.record) {
     auto location = location_string(ts.index(), c, m);
-    print("error in " + location + ": crc failure");
-    print_microslice_descriptor(ts, c, m);
-    print_microslice_content(ts, c, m);
+    check.print("error in " + location + ": crc failure");
+    print_microslice_descriptor(ts, c, m, check);
+    print_microslice_content(ts, c, m, check);
   }
 
   error |= truncated || pattern_error || crc_error;
 
   // output ms stats
   if (hist_ != nullptr) {
-    *hist_ << c << " " << m << " " << d.eq_id << " " << d.flags << " "
-           << uint16_t(d.sys_id) << " " << uint16_t(d.sys_ver) << " " << d.idx
-           << " " << d.size << " " << truncated << " " << pattern_error << " "
-           << crc_error << "\n";
+    std::ostringstream hist;
+    hist << c << " " << m << " " << d.eq_id << " " << d.flags << " "
+         << uint16_t(d.sys_id) << " " << uint16_t(d.sys_ver) << " " << d.idx
+         << " " << d.size << " " << truncated << " " << pattern_error << " "
+         << crc_error << "\n";
+    check.histogram += hist.str();
   }
 
   return !error;
 }
 
-uint32_t TimesliceAnalyzer::compute_crc(const fles::MicrosliceView& m) const {
-  assert(crc32_engine_);
-
-  crcutil_interface::UINT64 crc64 = 0;
-  crc32_engine_->Compute(m.content(), m.desc().size, &crc64);
-
-  return static_cast<uint32_t>(crc64);
-}
-
-bool TimesliceAnalyzer::check_crc(const fles::MicrosliceView& m) const {
-  return compute_crc(m) == m.desc().crc;
-}
-
 void TimesliceAnalyzer::print(std::string text, const std::string& prefix) {
   if (text.back() == '\n') {
     text.erase(text.end() - 1);
@@ -345,25 +507,26 @@ void TimesliceAnalyzer::print_reference() {
   }
 }
 
-void TimesliceAnalyzer::print_microslice_descriptor(const fles::Timeslice& ts,
-                                                    size_t c,
-                                                    size_t m) {
+void TimesliceAnalyzer::print_microslice_descriptor(
+    const fles::Timeslice& ts, size_t c, size_t m, ComponentCheck& check)
+    const {
   auto location = location_string(ts.index(), c, m);
-  print("microslice descriptor of " + location + ":");
-  print(boost::str(boost::format("%s") %
-                   MicrosliceDescriptorDump(ts.get_microslice(c, m).desc())),
-        "  ");
+  check.print("microslice descriptor of " + location + ":");
+  check.print(
+      boost::str(boost::format("%s") %
+                 MicrosliceDescriptorDump(ts.get_microslice(c, m).desc())),
+      "  ");
 }
 
-void TimesliceAnalyzer::print_microslice_content(const fles::Timeslice& ts,
-                                                 size_t c,
-                                                 size_t m) {
+void TimesliceAnalyzer::print_microslice_content(
+    const fles::Timeslice& ts, size_t c, size_t m, ComponentCheck& check)
+    const {
   auto location = location_string(ts.index(), c, m);
-  print("microslice content of " + location + ":");
-  print(boost::str(boost::format("%s") %
-                   BufferDump(ts.get_microslice(c, m).content(),
-                              ts.get_microslice(c, m).desc().size)),
-        "  ");
+  check.print("microslice content of " + location + ":");
+  check.print(boost::str(boost::format("%s") %
+                         BufferDump(ts.get_microslice(c, m).content(),
+                                    ts.get_microslice(c, m).desc().size)),
+              "  ");
 }
 
 std::string TimesliceAnalyzer::statistics() const {
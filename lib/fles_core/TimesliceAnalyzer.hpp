@@ -1,27 +1,38 @@
 // Copyright 2013, 2015 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include "LiveStats.hpp"
 #include "MicrosliceDescriptor.hpp"
 #include "Monitor.hpp"
 #include "Scheduler.hpp"
 #include "Sink.hpp"
 #include "Timeslice.hpp"
-#include "interface.h" // crcutil_interface
 #include <chrono>
 #include <memory>
 #include <optional>
 #include <ostream>
 #include <string>
+#include <vector>
 
 class PatternChecker;
-
+class WorkerPool;
+
+/**
+ * \brief The TimesliceAnalyzer class checks the consistency of timeslices.
+ *
+ * The components of a timeslice can be checked concurrently on a pool of
+ * worker threads. The results and diagnostic messages of each component are
+ * collected and applied in component order, so the output is identical to
+ * the serial check.
+ */
 class TimesliceAnalyzer : public fles::TimesliceSink {
 public:
   TimesliceAnalyzer(uint64_t arg_output_interval,
                     std::ostream& arg_out,
                     std::string arg_output_prefix,
                     std::ostream* arg_hist,
-                    cbm::Monitor* monitor);
+                    cbm::Monitor* monitor,
+                    unsigned arg_threads = 0);
   ~TimesliceAnalyzer() override;
 
   void put(std::shared_ptr<const fles::Timeslice> timeslice) override;
@@ -33,19 +44,29 @@ private:
     content_bytes_ = 0;
   }
 
-  [[nodiscard]] bool check_timeslice(const fles::Timeslice& ts);
-  [[nodiscard]] bool check_component(const fles::Timeslice& ts, size_t c);
-  [[nodiscard]] bool
-  check_microslice(const fles::Timeslice& ts, size_t c, size_t m);
+  struct ComponentCheck;
 
-  [[nodiscard]] uint32_t compute_crc(const fles::MicrosliceView& m) const;
-  [[nodiscard]] bool check_crc(const fles::MicrosliceView& m) const;
+  [[nodiscard]] bool check_timeslice(const fles::Timeslice& ts);
+  void check_component(const fles::Timeslice& ts,
+                       size_t c,
+                       ComponentCheck& check);
+  [[nodiscard]] bool check_microslice(const fles::Timeslice& ts,
+                                      size_t c,
+                                      size_t m,
+                                      ComponentCheck& check);
+  /// Apply the statistics and messages of a component check.
+  void apply_component_check(ComponentCheck& check);
 
   void print(std::string text, const std::string& prefix = "");
   void print_reference();
-  void
-  print_microslice_descriptor(const fles::Timeslice& ts, size_t c, size_t m);
-  void print_microslice_content(const fles::Timeslice& ts, size_t c, size_t m);
+  void print_microslice_descriptor(const fles::Timeslice& ts,
+                                   size_t c,
+                                   size_t m,
+                                   ComponentCheck& check) const;
+  void print_microslice_content(const fles::Timeslice& ts,
+                                size_t c,
+                                size_t m,
+                                ComponentCheck& check) const;
 
   [[nodiscard]] std::string statistics() const;
 
@@ -56,7 +77,10 @@ private:
 
   [[nodiscard]] bool output_active() const;
 
-  crcutil_interface::CRC* crc32_engine_ = nullptr;
+  /// Check state of the components of the current timeslice.
+  std::vector<ComponentCheck> checks_;
+  /// Worker threads for checking components (null: serial check).
+  std::unique_ptr<WorkerPool> pool_;
 
   uint64_t start_index_ = 0;
   std::vector<fles::MicrosliceDescriptor> reference_descriptors_;
@@ -80,6 +104,21 @@ private:
 
   void report_status();
 
+  /// Live statistics of the checked data (see cbm::LiveStats).
+  struct LiveStatistics {
+    cbm::LiveCounter timeslices;
+    cbm::LiveCounter components;
+    cbm::LiveCounter microslices;
+    cbm::LiveCounter content_bytes;
+    cbm::LiveCounter timeslice_errors;
+    cbm::LiveCounter component_errors;
+    cbm::LiveCounter microslice_errors;
+    cbm::LiveCounter timeslice_index;
+    /// Microslice size histograms by component (keyed by eq_id).
+    std::vector<cbm::LiveHistogram> microslice_sizes;
+  };
+  std::unique_ptr<LiveStatistics> live_;
+
   cbm::Monitor* monitor_;
   std::string hostname_;
 
@@ -0,0 +1,268 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the TimesliceBoundaries class template.
+#pragma once
+
+#include "MicrosliceDescriptor.hpp"
+#include "RingBuffer.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <optional>
+
+/**
+ * \brief Descriptor ranges of the timeslice components of an input buffer.
+ *
+ * In count mode, the component of timeslice n consists of timeslice_size
+ * core microslices followed by overlap_size overlap microslices, starting at
+ * microslice n * timeslice_size of the input. The size may be changed from a
+ * given timeslice on (see resize()), e.g., to adapt it to the data rate. The
+ * component of a timeslice then starts at the end of the core microslices of
+ * the previous one.
+ *
+ * In time mode (a nonzero duration), the component of timeslice n consists
+ * of the microslices starting in the time window [base + n * duration, base
+ * + (n + 1) * duration), followed by those starting within overlap_duration
+ * after it. The windows are aligned to multiples of the duration, and base
+ * is the start of the window of the first microslice, so the components of
+ * all inputs starting in the same window cover the same time window
+ * regardless of their microslice durations. A component contains at least
+ * one microslice: for a window without microslices, this is the first one
+ * following it, which belongs to the overlap.
+ *
+ * The window boundaries are found by binary search of the microslice start
+ * times (MicrosliceDescriptor::idx) in the descriptor buffer, from the
+ * previous boundary up to the write index. They are kept until the
+ * timeslice has been released, so the descriptors are never scanned.
+ *
+ * The data source type needs to provide desc_buffer() and get_read_index()
+ * (see TimesliceAckTracker).
+ */
+template <typename DataSource> class TimesliceBoundaries {
+public:
+  /// The descriptor range of a timeslice component.
+  struct Component {
+    uint64_t desc_offset;
+    uint64_t desc_length;
+    /// Number of core microslices, the others belong to the overlap.
+    uint64_t core_length;
+  };
+
+  /// The TimesliceBoundaries constructor.
+  /** \param duration the timeslice duration in ns, or zero for count mode
+      \param overlap_duration the overlap duration in ns (time mode only)
+      \param min_timeslice_size the minimum size set by resize(), or zero if
+      the size is fixed (count mode only) */
+  TimesliceBoundaries(DataSource& data_source,
+                      uint64_t timeslice_size,
+                      uint64_t overlap_size,
+                      uint64_t duration = 0,
+                      uint64_t overlap_duration = 0,
+                      uint64_t min_timeslice_size = 0)
+      : data_source_(data_source), timeslice_size_(timeslice_size),
+        overlap_size_(overlap_size), duration_(duration),
+        overlap_duration_(overlap_duration),
+        min_timeslice_size_(min_timeslice_size != 0 ? min_timeslice_size
+                                                    : timeslice_size),
+        start_(data_source.get_read_index().desc) {
+    segments_.push_back({0, start_, timeslice_size_});
+    if (duration_ != 0) {
+      // every pending timeslice but an empty window holds a microslice
+      begins_.alloc_with_size(data_source.desc_buffer().size() + 2);
+    }
+  }
+
+  /// Check whether the boundaries are time-based.
+  [[nodiscard]] bool time_based() const { return duration_ != 0; }
+
+  /// Retrieve the maximum number of timeslices pending release.
+  [[nodiscard]] uint64_t max_pending() const {
+    return time_based()
+               ? begins_.size() - 1
+               : data_source_.desc_buffer().size() / min_timeslice_size_ + 1;
+  }
+
+  /// Retrieve the descriptor range of the component of a timeslice.
+  /** \return the range, or nothing if it is not complete below the given
+      descriptor write index */
+  std::optional<Component> component(uint64_t timeslice,
+                                     uint64_t write_index) {
+    if (!time_based()) {
+      const Segment& s = segment(timeslice);
+      Component c{s.begin(timeslice), s.size + overlap_size_, s.size};
+      if (write_index < c.desc_offset + c.desc_length) {
+        return std::nullopt;
+      }
+      return c;
+    }
+    if (!find_begins(timeslice + 1, write_index)) {
+      return std::nullopt;
+    }
+    const uint64_t begin = begins_.at(timeslice);
+    const uint64_t core_end = begins_.at(timeslice + 1);
+    uint64_t end = core_end;
+    if (overlap_duration_ != 0) {
+      auto overlap_end = lower_bound(
+          end, write_index, window_begin(timeslice + 1) + overlap_duration_);
+      if (!overlap_end) {
+        return std::nullopt;
+      }
+      end = *overlap_end;
+    }
+    end = std::max(end, begin + 1);
+    return Component{begin, end - begin, core_end - begin};
+  }
+
+  /// Retrieve the descriptor write index required for the component of a
+  /// timeslice (a lower bound in time mode).
+  [[nodiscard]] uint64_t min_write_index(uint64_t timeslice) const {
+    if (!time_based()) {
+      const Segment& s = segment(timeslice);
+      return s.begin(timeslice) + s.size + overlap_size_;
+    }
+    return (known_ != 0 ? begins_.at(known_ - 1) : start_) + 1;
+  }
+
+  /// Retrieve the descriptor index of the first microslice of a timeslice.
+  /** In time mode, this is available once the component of the previous
+      timeslice has been determined. */
+  [[nodiscard]] uint64_t begin(uint64_t timeslice) const {
+    if (!time_based()) {
+      return segment(timeslice).begin(timeslice);
+    }
+    if (timeslice == 0) {
+      return start_;
+    }
+    assert(timeslice >= released_ && timeslice < known_);
+    return begins_.at(timeslice);
+  }
+
+  /// Retrieve the number of core microslices of a count-mode timeslice.
+  [[nodiscard]] uint64_t size(uint64_t timeslice) const {
+    return segment(timeslice).size;
+  }
+
+  /// Change the size of the count-mode timeslices from the given one on.
+  /** The preceding timeslices keep their ranges, so the timeslice must not
+      precede one whose range has been used. */
+  void resize(uint64_t timeslice, uint64_t size) {
+    assert(!time_based());
+    assert(size >= min_timeslice_size_);
+    Segment& last = segments_.back();
+    assert(timeslice >= last.first_timeslice);
+    if (timeslice == last.first_timeslice) {
+      last.size = size;
+    } else if (size != last.size) {
+      segments_.push_back({timeslice, last.begin(timeslice), size});
+    }
+  }
+
+  /// Release the boundaries of all timeslices before the given one.
+  void release(uint64_t timeslice) {
+    released_ = std::max(released_, timeslice);
+    while (segments_.size() > 1 && segments_[1].first_timeslice <= released_) {
+      segments_.pop_front();
+    }
+  }
+
+private:
+  /// A run of count-mode timeslices of the same size.
+  struct Segment {
+    uint64_t first_timeslice;
+    /// Descriptor index of the first microslice of the first timeslice.
+    uint64_t first_desc;
+    uint64_t size;
+
+    [[nodiscard]] uint64_t begin(uint64_t timeslice) const {
+      return first_desc + (timeslice - first_timeslice) * size;
+    }
+  };
+
+  DataSource& data_source_;
+  const uint64_t timeslice_size_;
+  const uint64_t overlap_size_;
+  const uint64_t duration_;
+  const uint64_t overlap_duration_;
+  const uint64_t min_timeslice_size_;
+
+  /// Descriptor index of the first microslice.
+  const uint64_t start_;
+
+  /// Start of the time window of timeslice 0.
+  uint64_t base_ = 0;
+
+  /// Descriptor indexes of the first microslice of each timeslice.
+  RingBuffer<uint64_t> begins_;
+
+  /// Number of timeslices with a known first microslice.
+  uint64_t known_ = 0;
+
+  /// Timeslices before this one have been released.
+  uint64_t released_ = 0;
+
+  /// Sizes of the count-mode timeslices from the oldest segment not
+  /// released on.
+  std::deque<Segment> segments_;
+
+  /// Find the segment of a count-mode timeslice.
+  [[nodiscard]] const Segment& segment(uint64_t timeslice) const {
+    auto it = segments_.end();
+    do {
+      --it;
+    } while (it != segments_.begin() && it->first_timeslice > timeslice);
+    return *it;
+  }
+
+  [[nodiscard]] uint64_t window_begin(uint64_t timeslice) const {
+    return base_ + timeslice * duration_;
+  }
+
+  /// Find the first microslice starting at or after the given time in the
+  /// descriptors from first to write_index.
+  std::optional<uint64_t>
+  lower_bound(uint64_t first, uint64_t write_index, uint64_t time) {
+    auto& descs = data_source_.desc_buffer();
+    uint64_t count = write_index > first ? write_index - first : 0;
+    while (count > 0) {
+      uint64_t step = count / 2;
+      if (descs.at(first + step).idx < time) {
+        first += step + 1;
+        count -= step + 1;
+      } else {
+        count = step;
+      }
+    }
+    if (first >= write_index) {
+      return std::nullopt;
+    }
+    return first;
+  }
+
+  /// Find the first microslices of all timeslices up to the given one.
+  bool find_begins(uint64_t timeslice, uint64_t write_index) {
+    if (known_ == 0) {
+      if (write_index <= start_) {
+        return false;
+      }
+      base_ = data_source_.desc_buffer().at(start_).idx / duration_ * duration_;
+      begins_.at(0) = start_;
+      known_ = 1;
+    }
+    while (known_ <= timeslice) {
+      if (known_ - released_ >= begins_.size()) {
+        // wait for the release of the oldest timeslices
+        return false;
+      }
+      auto begin = lower_bound(begins_.at(known_ - 1), write_index,
+                               window_begin(known_));
+      if (!begin) {
+        return false;
+      }
+      begins_.at(known_) = *begin;
+      ++known_;
+    }
+    return true;
+  }
+};
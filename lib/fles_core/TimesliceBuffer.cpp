@@ -1,40 +1,152 @@
 // Copyright 2016-2020 Jan de Cuveland <cmail@cuveland.de>
 
 #include "TimesliceBuffer.hpp"
+#include "DeviceMemory.hpp"
+#include "EventTrace.hpp"
+#include "MicrosliceDescriptor.hpp"
 #include "TimesliceDescriptor.hpp"
+#include "TimesliceShmSegment.hpp"
 #include "TimesliceShmWorkItem.hpp"
+#include "TimesliceSpillLog.hpp"
 #include "TimesliceWorkItem.hpp"
 #include "Utility.hpp"
+#include "log.hpp"
 #include <boost/archive/binary_oarchive.hpp>
 #include <boost/interprocess/managed_shared_memory.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstring>
+#include <fstream>
 #include <memory>
+#include <numeric>
+#include <stdexcept>
 
 namespace zmq {
 class context_t;
 }
 
+/// Geometry of a persistent timeslice buffer segment, checked before
+/// re-attaching to it. The data buffer sizes are stored in a separate
+/// array object.
+struct TimesliceBufferShmInfo {
+  uint32_t max_data_buffer_size_exp;
+  uint32_t desc_buffer_size_exp;
+  uint32_t num_input_nodes;
+  HugePages huge_pages;
+  int numa_node;
+  boost::interprocess::managed_shared_memory::handle_t data_handle;
+  boost::interprocess::managed_shared_memory::handle_t desc_handle;
+};
+
+/// Name of the array of data buffer size exponents in a persistent segment.
+constexpr const char* data_size_exps_name = "TimesliceBufferDataSizeExps";
+
+namespace {
+
+/// View of a timeslice in the buffer, e.g., for a history dump.
+class BufferTimeslice : public fles::Timeslice {
+public:
+  BufferTimeslice(TimesliceBuffer& buffer,
+                  const fles::TimesliceDescriptor& ts_desc) {
+    timeslice_descriptor_ = ts_desc;
+    data_ptr_.resize(ts_desc.num_components);
+    desc_ptr_.resize(ts_desc.num_components);
+    for (uint32_t c = 0; c < ts_desc.num_components; ++c) {
+      desc_ptr_[c] = &buffer.get_desc(c, ts_desc.ts_pos);
+      data_ptr_[c] = &buffer.get_data(c, desc_ptr_[c]->offset);
+    }
+  }
+};
+
+} // namespace
+
 TimesliceBuffer::TimesliceBuffer(zmq::context_t& context,
                                  const std::string& distributor_address,
                                  std::string shm_identifier,
                                  uint32_t data_buffer_size_exp,
                                  uint32_t desc_buffer_size_exp,
-                                 uint32_t num_input_nodes)
-    : ItemProducer(context, distributor_address),
+                                 uint32_t num_input_nodes,
+                                 const MemoryPolicy& memory_policy,
+                                 bool use_shm_item_channel,
+                                 fles::WorkItemEncoding work_item_encoding,
+                                 bool persistent)
+    : TimesliceBuffer(
+          context,
+          distributor_address,
+          std::move(shm_identifier),
+          std::vector<uint32_t>(num_input_nodes, data_buffer_size_exp),
+          desc_buffer_size_exp,
+          memory_policy,
+          use_shm_item_channel,
+          work_item_encoding,
+          persistent) {}
+
+TimesliceBuffer::TimesliceBuffer(zmq::context_t& context,
+                                 const std::string& distributor_address,
+                                 std::string shm_identifier,
+                                 std::vector<uint32_t> data_buffer_size_exps,
+                                 uint32_t desc_buffer_size_exp,
+                                 const MemoryPolicy& memory_policy,
+                                 bool use_shm_item_channel,
+                                 fles::WorkItemEncoding work_item_encoding,
+                                 bool persistent)
+    : ItemProducer(context, distributor_address), context_(context),
       shm_identifier_(std::move(shm_identifier)),
-      data_buffer_size_exp_(data_buffer_size_exp),
+      data_buffer_size_exps_(std::move(data_buffer_size_exps)),
       desc_buffer_size_exp_(desc_buffer_size_exp),
-      num_input_nodes_(num_input_nodes) {
+      num_input_nodes_(static_cast<uint32_t>(data_buffer_size_exps_.size())),
+      memory_policy_(memory_policy), work_item_encoding_(work_item_encoding),
+      persistent_(persistent), outstanding_(desc_buffer_size_exp) {
+  if (auto* monitor = cbm::Monitor::Ptr()) {
+    const cbm::MetricTagSet tagset{{"host", monitor->HostName()},
+                                   {"shm", shm_identifier_}};
+    dispatch_age_ = DataAgeMetric(monitor, tagset, "dispatch");
+    completion_age_ = DataAgeMetric(monitor, tagset, "completion");
+  }
+  if (cbm::LiveStats::Enabled()) {
+    live_ = std::make_unique<LiveStatistics>();
+    live_->timeslices = cbm::LiveStats::Counter("buffer_timeslices");
+    live_->components = cbm::LiveStats::Counter("buffer_components");
+    live_->microslices = cbm::LiveStats::Counter("buffer_microslices");
+    live_->bytes = cbm::LiveStats::Counter("buffer_bytes");
+  }
+
+  if (memory_policy_.huge_pages == HugePages::Size2M ||
+      memory_policy_.huge_pages == HugePages::Size1G) {
+    throw std::runtime_error("explicit huge pages not supported for shared "
+                             "memory timeslice buffers, use 'thp'");
+  }
+  if (memory_policy_.mirrored) {
+    // consumers map the buffer from the shared memory segment
+    throw std::runtime_error(
+        "mirroring not supported for shared memory timeslice buffers");
+  }
+
+  if (persistent_ && (memory_policy_.device >= 0 ||
+                      work_item_encoding_ == fles::WorkItemEncoding::Flat)) {
+    throw std::runtime_error("persistent shared memory timeslice buffers "
+                             "require host memory and the managed layout");
+  }
+
   boost::uuids::random_generator uuid_gen;
   shm_uuid_ = uuid_gen();
 
-  boost::interprocess::shared_memory_object::remove(shm_identifier_.c_str());
+  if (!persistent_) {
+    boost::interprocess::shared_memory_object::remove(shm_identifier_.c_str());
+  }
 
-  std::size_t data_size =
-      (UINT64_C(1) << data_buffer_size_exp_) * num_input_nodes_;
-  assert(data_size != 0);
+  // managed layout: the data buffers follow each other without gaps
+  data_offsets_.resize(num_input_nodes_);
+  for (uint32_t i = 0; i < num_input_nodes_; ++i) {
+    data_offsets_[i] = data_size_;
+    data_size_ += UINT64_C(1) << data_buffer_size_exps_[i];
+    max_data_buffer_size_exp_ =
+        std::max(max_data_buffer_size_exp_, data_buffer_size_exps_[i]);
+  }
+  assert(data_size_ != 0);
 
   std::size_t desc_buffer_size = (UINT64_C(1) << desc_buffer_size_exp_);
   std::size_t desc_size = desc_buffer_size * num_input_nodes_ *
@@ -42,7 +154,63 @@ TimesliceBuffer::TimesliceBuffer(zmq::context_t& context,
   assert(desc_size != 0);
 
   constexpr size_t overhead_size = 4096; // Wild guess, let's hope it's enough
-  size_t managed_shm_size = data_size + desc_size + overhead_size;
+
+  // Align the buffers to whole (huge) pages so that the policy covers them
+  const MemoryPolicy host_policy = memory_policy_.host_policy();
+  std::size_t alignment = 0;
+  if (host_policy.huge_pages == HugePages::Transparent) {
+    alignment = UINT64_C(1) << 21;
+  } else if (!host_policy.is_default()) {
+    alignment = host_policy.page_size();
+  }
+  const bool data_on_device = memory_policy_.device >= 0;
+
+  if (work_item_encoding_ == fles::WorkItemEncoding::Flat) {
+    if (data_on_device) {
+      throw std::runtime_error(
+          "flat shared memory layout not supported for data on a GPU");
+    }
+    flat_segment_ = std::make_unique<fles::TimesliceShmSegment>(
+        boost::interprocess::create_only, shm_identifier_, shm_uuid_,
+        data_buffer_size_exps_, desc_buffer_size_exp_, alignment);
+    const auto& layout = flat_segment_->layout();
+    data_ptr_ = layout.data_ring(0);
+    desc_ptr_ = layout.desc_ring(0);
+    // the rings of the flat layout are aligned individually
+    for (uint32_t i = 0; i < num_input_nodes_; ++i) {
+      data_offsets_[i] = static_cast<uint64_t>(layout.data_ring(i) - data_ptr_);
+    }
+    data_size_ = data_offsets_.back() +
+                 (UINT64_C(1) << data_buffer_size_exps_.back());
+    if (!host_policy.is_default()) {
+      apply_memory_policy(data_ptr_, data_size_, host_policy);
+      apply_memory_policy(desc_ptr_, desc_size, host_policy);
+    }
+    if (use_shm_item_channel) {
+      shm_item_distributor_ = std::make_unique<ShmItemDistributor>(
+          shm_item_channel_name(shm_identifier_),
+          item_deadline_horizon(desc_buffer_size_exp_));
+    }
+    return;
+  }
+
+  if (persistent_ && attach_persistent_segment(host_policy)) {
+    // the previous producer's descriptors are stale
+    std::memset(desc_ptr_, 0, desc_size);
+    prefault_memory(data_ptr_, data_size_);
+    prefault_memory(desc_ptr_, desc_size);
+    if (use_shm_item_channel) {
+      shm_item_distributor_ = std::make_unique<ShmItemDistributor>(
+          shm_item_channel_name(shm_identifier_),
+          item_deadline_horizon(desc_buffer_size_exp_));
+    }
+    return;
+  }
+  boost::interprocess::shared_memory_object::remove(shm_identifier_.c_str());
+
+  size_t managed_shm_size = (data_on_device ? 0 : data_size_) + desc_size +
+                            num_input_nodes_ * sizeof(uint32_t) +
+                            overhead_size + 2 * alignment;
 
   managed_shm_ = std::make_unique<boost::interprocess::managed_shared_memory>(
       boost::interprocess::create_only, shm_identifier_.c_str(),
@@ -51,54 +219,849 @@ TimesliceBuffer::TimesliceBuffer(zmq::context_t& context,
   managed_shm_->construct<boost::uuids::uuid>(
       boost::interprocess::unique_instance)(shm_uuid_);
 
-  data_ptr_ = static_cast<uint8_t*>(managed_shm_->allocate(data_size));
-  desc_ptr_ = reinterpret_cast<fles::TimesliceComponentDescriptor*>(
-      managed_shm_->allocate(desc_size));
+  auto allocate = [this, alignment, &host_policy](std::size_t size) {
+    if (alignment == 0) {
+      return managed_shm_->allocate(size);
+    }
+    void* ptr = managed_shm_->allocate_aligned(size, alignment);
+    apply_memory_policy(ptr, size, host_policy);
+    return ptr;
+  };
+
+  if (data_on_device) {
+    // consumers open the data buffers through the handle in the segment
+    data_device_ =
+        std::make_unique<fles::DeviceMemory>(memory_policy_.device, data_size_);
+    data_ptr_ = data_device_->ptr();
+    managed_shm_->construct<fles::DeviceMemoryHandle>(
+        boost::interprocess::unique_instance)(data_device_->handle());
+  } else {
+    data_ptr_ = static_cast<uint8_t*>(allocate(data_size_));
+  }
+  desc_ptr_ =
+      static_cast<fles::TimesliceComponentDescriptor*>(allocate(desc_size));
+
+  if (persistent_) {
+    managed_shm_->construct<TimesliceBufferShmInfo>(
+        boost::interprocess::unique_instance)(TimesliceBufferShmInfo{
+        max_data_buffer_size_exp_, desc_buffer_size_exp_, num_input_nodes_,
+        host_policy.huge_pages, host_policy.numa_node,
+        managed_shm_->get_handle_from_address(data_ptr_),
+        managed_shm_->get_handle_from_address(desc_ptr_)});
+    managed_shm_->construct_it<uint32_t>(data_size_exps_name)[num_input_nodes_](
+        data_buffer_size_exps_.data());
+    prefault_memory(data_ptr_, data_size_);
+    prefault_memory(desc_ptr_, desc_size);
+  }
+
+  if (use_shm_item_channel) {
+    shm_item_distributor_ = std::make_unique<ShmItemDistributor>(
+        shm_item_channel_name(shm_identifier_),
+        item_deadline_horizon(desc_buffer_size_exp_));
+  }
 }
 
 TimesliceBuffer::~TimesliceBuffer() {
-  boost::interprocess::shared_memory_object::remove(shm_identifier_.c_str());
+  if (crc_checker_.checked() + crc_checker_.computed() > 0) {
+    L_(info) << "timeslice buffer " << shm_identifier_ << ": "
+             << crc_checker_.checked() << " microslice CRCs verified, "
+             << crc_checker_.errors() << " errors, "
+             << crc_checker_.computed() << " computed";
+  }
+  if (spill_) {
+    const auto stats = spill_->statistics();
+    L_(info) << "timeslice buffer " << shm_identifier_ << ": "
+             << stats.timeslices << " timeslices spilled ("
+             << human_readable_count(stats.bytes) << "), " << stats.failed
+             << " failed";
+    // the writer thread may still read from the segment
+    spill_ = nullptr;
+  }
+  history_dump_ = nullptr;
+  flat_segment_ = nullptr;
+  if (!persistent_) {
+    boost::interprocess::shared_memory_object::remove(shm_identifier_.c_str());
+  }
+}
+
+bool TimesliceBuffer::attach_persistent_segment(
+    const MemoryPolicy& host_policy) {
+  using boost::interprocess::managed_shared_memory;
+  try {
+    managed_shm_ = std::make_unique<managed_shared_memory>(
+        boost::interprocess::open_only, shm_identifier_.c_str());
+  } catch (const boost::interprocess::interprocess_exception&) {
+    return false; // no segment yet
+  }
+  auto* uuid = managed_shm_
+                   ->find<boost::uuids::uuid>(
+                       boost::interprocess::unique_instance)
+                   .first;
+  auto* info = managed_shm_
+                   ->find<TimesliceBufferShmInfo>(
+                       boost::interprocess::unique_instance)
+                   .first;
+  auto data_size_exps = managed_shm_->find<uint32_t>(data_size_exps_name);
+  if (uuid == nullptr || info == nullptr ||
+      info->max_data_buffer_size_exp != max_data_buffer_size_exp_ ||
+      info->desc_buffer_size_exp != desc_buffer_size_exp_ ||
+      info->num_input_nodes != num_input_nodes_ ||
+      info->huge_pages != host_policy.huge_pages ||
+      info->numa_node != host_policy.numa_node ||
+      data_size_exps.first == nullptr ||
+      !std::equal(data_buffer_size_exps_.begin(), data_buffer_size_exps_.end(),
+                  data_size_exps.first,
+                  data_size_exps.first + data_size_exps.second)) {
+    // not a persistent segment of this geometry, replace it
+    managed_shm_ = nullptr;
+    return false;
+  }
+  shm_uuid_ = *uuid;
+  data_ptr_ = static_cast<uint8_t*>(
+      managed_shm_->get_address_from_handle(info->data_handle));
+  desc_ptr_ = static_cast<fles::TimesliceComponentDescriptor*>(
+      managed_shm_->get_address_from_handle(info->desc_handle));
+  reattached_ = true;
+  return true;
+}
+
+void TimesliceBuffer::set_crc_check(CrcCheckMode mode) {
+  if (mode != CrcCheckMode::None && data_device_) {
+    throw std::runtime_error("crc check requires host memory data buffers");
+  }
+  if (mode != CrcCheckMode::None && partial_delivery_) {
+    throw std::runtime_error("crc check not supported with partial delivery");
+  }
+  crc_checker_ = MicrosliceCrcChecker(mode);
+}
+
+void TimesliceBuffer::set_partial_delivery(bool enable) {
+  if (enable && !flat_segment_) {
+    throw std::runtime_error("partial delivery requires the flat layout");
+  }
+  if (enable && crc_checker_.mode() != CrcCheckMode::None) {
+    throw std::runtime_error("crc check not supported with partial delivery");
+  }
+  if (enable && spill_) {
+    throw std::runtime_error("spilling not supported with partial delivery");
+  }
+  partial_delivery_ = enable;
+}
+
+void TimesliceBuffer::set_spill(const SpillParameters& parameters) {
+  if (data_device_) {
+    throw std::runtime_error("spilling requires host memory data buffers");
+  }
+  if (partial_delivery_) {
+    throw std::runtime_error("spilling not supported with partial delivery");
+  }
+  if (retention_enabled_) {
+    throw std::runtime_error("spilling not supported with retention");
+  }
+  if (parameters.directory.empty() ||
+      !(parameters.low_water <= parameters.high_water)) {
+    throw std::runtime_error("invalid spill parameters");
+  }
+  spill_ = std::make_unique<TimesliceSpill>(
+      parameters.directory + "/" + shm_identifier_, parameters);
+}
+
+void TimesliceBuffer::set_retention(const RetentionParameters& parameters) {
+  if (data_device_) {
+    throw std::runtime_error("retention requires host memory data buffers");
+  }
+  if (spill_) {
+    throw std::runtime_error("spilling not supported with retention");
+  }
+  if (get_num_timeslices_sent() != 0) {
+    throw std::runtime_error("retention has to be enabled before the start");
+  }
+  retention_ = parameters;
+  retention_enabled_ = true;
+  if (!retention_.trigger_address.empty()) {
+    trigger_socket_ =
+        std::make_unique<zmq::socket_t>(context_, zmq::socket_type::pull);
+    trigger_socket_->bind(retention_.trigger_address);
+  }
+}
+
+void TimesliceBuffer::set_calibration(const CalibrationParameters& parameters) {
+  if (parameters.max_data_size_exp < parameters.min_data_size_exp ||
+      parameters.max_desc_size_exp < parameters.min_desc_size_exp) {
+    throw std::runtime_error("invalid calibration parameters");
+  }
+  calibration_ = parameters;
+  calibrator_.reset();
+}
+
+void TimesliceBuffer::record_calibration(uint64_t ts_pos) {
+  if (!calibrator_) {
+    calibrator_ =
+        std::make_unique<BufferCalibrator>(calibration_, num_input_nodes_);
+  }
+  if (!calibrator_->done()) {
+    const uint64_t oldest = oldest_in_use(ts_pos);
+    std::vector<uint64_t> bytes(num_input_nodes_);
+    std::vector<uint64_t> used(num_input_nodes_);
+    for (uint32_t c = 0; c < num_input_nodes_; ++c) {
+      const auto& last = get_desc(c, ts_pos);
+      bytes[c] = last.size;
+      used[c] = last.offset + last.size - get_desc(c, oldest).offset;
+    }
+    calibrator_->record_item(ts_pos, bytes, used, ts_pos + 1 - oldest);
+    return;
+  }
+
+  L_(info) << "timeslice buffer " << shm_identifier_
+           << ": calibration: " << calibrator_->summary();
+  if (!calibration_.output_file.empty()) {
+    std::ofstream file(calibration_.output_file);
+    file << calibrator_->recommend().to_string() << std::endl;
+    if (!file) {
+      L_(error) << "timeslice buffer " << shm_identifier_
+                << ": error writing " << calibration_.output_file;
+    }
+  }
+  calibration_.duration = std::chrono::milliseconds(0);
+  calibrator_.reset();
+}
+
+void TimesliceBuffer::request_history_dump(const HistoryDumpRequest& request) {
+  dump_requests_.push_back(request);
+  poll_history();
+}
+
+std::size_t TimesliceBuffer::get_num_retained() const {
+  return static_cast<std::size_t>(
+      std::count_if(history_.begin(), history_.end(),
+                    [](const auto& item) { return item.second.done; }));
+}
+
+void TimesliceBuffer::set_component_complete(uint32_t component,
+                                             uint64_t ts_pos) const {
+  if (partial_delivery_) {
+    flat_segment_->layout().set_component_complete(component, ts_pos);
+  }
+}
+
+bool TimesliceBuffer::component_complete(uint32_t component,
+                                         uint64_t ts_pos) const {
+  assert(partial_delivery_);
+  return flat_segment_->layout().component_complete(component, ts_pos);
+}
+
+void TimesliceBuffer::send_partial_work_item(
+    const fles::TimesliceWorkItem& wi) {
+  assert(partial_delivery_);
+  const auto ts_pos = wi.ts_desc.ts_pos;
+  assert(ts_pos >= partial_end_);
+  *flat_segment_->layout().ts_desc(ts_pos) = wi.ts_desc;
+  fles::encode_flat_work_item(work_item_buffer_, shm_uuid_.data,
+                              shm_identifier_, ts_pos);
+  partial_end_ = ts_pos + 1;
+  dispatch_work_item(wi);
 }
 
 void TimesliceBuffer::send_work_item(fles::TimesliceWorkItem wi) {
-  // Create and fill new TimesliceShmWorkItem to be sent via zmq
-  fles::TimesliceShmWorkItem item;
-  item.shm_uuid = shm_uuid_;
-  item.shm_identifier = shm_identifier_;
-  item.ts_desc = wi.ts_desc;
-  const auto num_components = item.ts_desc.num_components;
-  const auto ts_pos = item.ts_desc.ts_pos;
-  item.data.resize(num_components);
-  item.desc.resize(num_components);
+  if (live_) {
+    record_live_stats(wi);
+  }
+  if (crc_checker_.mode() != CrcCheckMode::None) {
+    for (uint32_t c = 0; c < wi.ts_desc.num_components; ++c) {
+      const auto& tsc_desc = get_desc(c, wi.ts_desc.ts_pos);
+      auto* descs = reinterpret_cast<fles::MicrosliceDescriptor*>(
+          &get_data(c, tsc_desc.offset));
+      crc_checker_.check(
+          descs, tsc_desc.num_microslices,
+          reinterpret_cast<const uint8_t*>(descs + tsc_desc.num_microslices));
+    }
+  }
+  if (spill_) {
+    poll_spill();
+    if (try_spill(wi)) {
+      return;
+    }
+    if (!held_.empty()) {
+      // keep the work items in order of the buffer position
+      held_.push_back({std::move(wi), false});
+      return;
+    }
+  }
+  send_shm_work_item(wi);
+}
+
+void TimesliceBuffer::record_live_stats(const fles::TimesliceWorkItem& wi) {
+  live_->timeslices.Add();
+  if (live_->microslice_sizes.size() < wi.ts_desc.num_components) {
+    live_->microslice_sizes.resize(wi.ts_desc.num_components,
+                                   {-1, cbm::LiveHistogram()});
+  }
+  for (uint32_t c = 0; c < wi.ts_desc.num_components; ++c) {
+    const auto& tsc_desc = get_desc(c, wi.ts_desc.ts_pos);
+    live_->components.Add();
+    live_->microslices.Add(tsc_desc.num_microslices);
+    live_->bytes.Add(tsc_desc.size);
+    if (tsc_desc.num_microslices == 0 || data_on_device()) {
+      continue;
+    }
+    const auto* descs = reinterpret_cast<const fles::MicrosliceDescriptor*>(
+        &get_data(c, tsc_desc.offset));
+    // the histogram handle is looked up again only if the eq_id changes
+    auto& [eq_id, histogram] = live_->microslice_sizes[c];
+    if (eq_id != descs[0].eq_id) {
+      eq_id = descs[0].eq_id;
+      histogram = cbm::LiveStats::Histogram("microslice_size", eq_id);
+    }
+    for (uint64_t m = 0; m < tsc_desc.num_microslices; ++m) {
+      histogram.Record(descs[m].size);
+    }
+  }
+}
+
+void TimesliceBuffer::send_shm_work_item(const fles::TimesliceWorkItem& wi) {
+  if (flat_segment_) {
+    complete_end_ = wi.ts_desc.ts_pos + 1;
+    send_flat_work_item(wi);
+    return;
+  }
+  const auto num_components = wi.ts_desc.num_components;
+  const auto ts_pos = wi.ts_desc.ts_pos;
+  data_handles_.resize(num_components);
+  desc_handles_.resize(num_components);
+  uint64_t bytes = 0;
   for (uint32_t c = 0; c < num_components; ++c) {
     fles::TimesliceComponentDescriptor* tsc_desc = &get_desc(c, ts_pos);
     uint8_t* tsc_data = &get_data(c, tsc_desc->offset);
-    item.data[c] = managed_shm_->get_handle_from_address(tsc_data);
-    item.desc[c] = managed_shm_->get_handle_from_address(tsc_desc);
+    // with data on a GPU, the handle is the offset in the device memory
+    data_handles_[c] = data_device_
+                           ? tsc_data - data_ptr_
+                           : managed_shm_->get_handle_from_address(tsc_data);
+    desc_handles_[c] = managed_shm_->get_handle_from_address(tsc_desc);
+    bytes += tsc_desc->size;
   }
+  // single writer, so no read-modify-write is needed
+  timeslices_sent_.store(timeslices_sent_.load(std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+  bytes_sent_.store(bytes_sent_.load(std::memory_order_relaxed) + bytes,
+                    std::memory_order_relaxed);
+
+  if (work_item_encoding_ == fles::WorkItemEncoding::Binary) {
+    fles::encode_binary_work_item(work_item_buffer_, shm_uuid_,
+                                  shm_identifier_, wi.ts_desc,
+                                  data_handles_.data(), desc_handles_.data());
+  } else {
+    // Create and fill new TimesliceShmWorkItem to be serialized
+    fles::TimesliceShmWorkItem item;
+    item.shm_uuid = shm_uuid_;
+    item.shm_identifier = shm_identifier_;
+    item.ts_desc = wi.ts_desc;
+    item.data = data_handles_;
+    item.desc = desc_handles_;
 
-  std::ostringstream ostream;
-  {
-    boost::archive::binary_oarchive oarchive(ostream);
-    oarchive << item;
+    std::ostringstream ostream;
+    {
+      boost::archive::binary_oarchive oarchive(ostream);
+      oarchive << item;
+    }
+    work_item_buffer_ = ostream.str();
   }
 
-  outstanding_.insert(ts_pos);
-  ItemProducer::send_work_item(ts_pos, ostream.str());
+  dispatch_work_item(wi);
+}
+
+void TimesliceBuffer::send_flat_work_item(const fles::TimesliceWorkItem& wi) {
+  const auto ts_pos = wi.ts_desc.ts_pos;
+  uint64_t bytes = 0;
+  for (uint32_t c = 0; c < wi.ts_desc.num_components; ++c) {
+    bytes += get_desc(c, ts_pos).size;
+  }
+  timeslices_sent_.store(timeslices_sent_.load(std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+  bytes_sent_.store(bytes_sent_.load(std::memory_order_relaxed) + bytes,
+                    std::memory_order_relaxed);
+
+  const auto& layout = flat_segment_->layout();
+  for (uint32_t c = 0; c < wi.ts_desc.num_components; ++c) {
+    layout.set_component_complete(c, ts_pos);
+  }
+  if (ts_pos < partial_end_) {
+    // already handed on by send_partial_work_item()
+    return;
+  }
+
+  // The table entry is published to the receivers by the work item
+  *layout.ts_desc(ts_pos) = wi.ts_desc;
+  fles::encode_flat_work_item(work_item_buffer_, shm_uuid_.data,
+                              shm_identifier_, ts_pos);
+  dispatch_work_item(wi);
+}
+
+void TimesliceBuffer::dispatch_work_item(const fles::TimesliceWorkItem& wi,
+                                         bool spilled) {
+  const auto ts_pos = wi.ts_desc.ts_pos;
+  if (!spilled) {
+    outstanding_.insert(ts_pos);
+    if (calibration_.enabled()) {
+      record_calibration(ts_pos);
+    }
+  }
+  if (retention_enabled_) {
+    history_[ts_pos].ts_desc = wi.ts_desc;
+  }
+  newest_ = ts_pos;
+  EventTrace::record(TraceEventType::WorkItemSent, ts_pos, wi.ts_desc.index);
+  if (dispatch_age_.enabled()) {
+    dispatch_age_.record(get_start_time(ts_pos));
+  }
+  if (shm_item_distributor_) {
+    shm_item_distributor_->send_work_item(ts_pos, work_item_buffer_);
+  } else {
+    ItemProducer::send_work_item(ts_pos, work_item_buffer_);
+  }
+}
+
+uint64_t TimesliceBuffer::oldest_in_use(uint64_t ts_pos) const {
+  // spilled timeslices have been released, all others are in use
+  uint64_t oldest = ts_pos;
+  if (!outstanding_.empty()) {
+    oldest = std::min(oldest, outstanding_.front());
+  }
+  if (!held_.empty()) {
+    oldest = std::min(oldest, held_.front().wi.ts_desc.ts_pos);
+  }
+  if (!history_.empty()) {
+    oldest = std::min(oldest, history_.begin()->first);
+  }
+  return oldest;
+}
+
+double TimesliceBuffer::fill_level(uint64_t ts_pos) {
+  const uint64_t oldest = oldest_in_use(ts_pos);
+  double fill = static_cast<double>(ts_pos + 1 - oldest) /
+                static_cast<double>(UINT64_C(1) << desc_buffer_size_exp_);
+  for (uint32_t c = 0; c < num_input_nodes_; ++c) {
+    const auto& first = get_desc(c, oldest);
+    const auto& last = get_desc(c, ts_pos);
+    const uint64_t used = last.offset + last.size - first.offset;
+    fill = std::max(fill, static_cast<double>(used) /
+                              static_cast<double>(
+                                  UINT64_C(1) << data_buffer_size_exps_[c]));
+  }
+  return fill;
+}
+
+bool TimesliceBuffer::try_spill(const fles::TimesliceWorkItem& wi) {
+  const auto ts_pos = wi.ts_desc.ts_pos;
+  const double fill = fill_level(ts_pos);
+  if (fill >= spill_->parameters().high_water) {
+    spilling_ = true;
+  } else if (fill < spill_->parameters().low_water) {
+    spilling_ = false;
+  }
+  if (!spilling_) {
+    return false;
+  }
+
+  TimesliceSpill::Request request;
+  request.ts_pos = ts_pos;
+  request.ts_desc = wi.ts_desc;
+  for (uint32_t c = 0; c < wi.ts_desc.num_components; ++c) {
+    const auto& tsc_desc = get_desc(c, ts_pos);
+    request.desc.push_back(tsc_desc);
+    request.data.push_back(&get_data(c, tsc_desc.offset));
+  }
+  if (!spill_->can_accept(TimesliceSpill::record_size(request))) {
+    return false;
+  }
+  spill_->submit(std::move(request));
+  held_.push_back({wi, true});
+  return true;
+}
+
+void TimesliceBuffer::poll_spill() {
+  while (!held_.empty()) {
+    if (!held_.front().spilling) {
+      const fles::TimesliceWorkItem wi = held_.front().wi;
+      held_.pop_front();
+      send_shm_work_item(wi);
+      continue;
+    }
+    TimesliceSpill::Result result;
+    if (!spill_->try_pop(result)) {
+      return;
+    }
+    const fles::TimesliceWorkItem wi = held_.front().wi;
+    held_.pop_front();
+    assert(result.ts_pos == wi.ts_desc.ts_pos);
+    if (result.written) {
+      send_spill_work_item(wi, result);
+    } else {
+      // the timeslice is still in the buffer
+      send_shm_work_item(wi);
+    }
+  }
+}
+
+void TimesliceBuffer::send_spill_work_item(
+    const fles::TimesliceWorkItem& wi, const TimesliceSpill::Result& result) {
+  const auto ts_pos = wi.ts_desc.ts_pos;
+  uint64_t bytes = 0;
+  for (uint32_t c = 0; c < wi.ts_desc.num_components; ++c) {
+    bytes += get_desc(c, ts_pos).size;
+  }
+  timeslices_sent_.store(timeslices_sent_.load(std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+  bytes_sent_.store(bytes_sent_.load(std::memory_order_relaxed) + bytes,
+                    std::memory_order_relaxed);
+
+  fles::encode_spill_work_item(work_item_buffer_,
+                               spill_->file_name(result.file), result.offset,
+                               result.size);
+  spilled_[ts_pos] = {result.file, result.size};
+  dispatch_work_item(wi, true);
+  released_.push_back(ts_pos);
+}
+
+bool TimesliceBuffer::release_spilled(ItemCompletionBatch& batch) {
+  if (released_.empty()) {
+    return false;
+  }
+  batch.completed_up_to = 0;
+  batch.completed.assign(released_.begin(), released_.end());
+  released_.clear();
+  return true;
+}
+
+void TimesliceBuffer::settle_spilled(ItemCompletionBatch& batch) {
+  // the buffer space of these has been released before
+  auto end = spilled_.lower_bound(batch.completed_up_to);
+  for (auto it = spilled_.begin(); it != end; ++it) {
+    spill_->release(it->second.file, it->second.size);
+  }
+  spilled_.erase(spilled_.begin(), end);
+  auto kept = std::remove_if(
+      batch.completed.begin(), batch.completed.end(), [this](ItemID id) {
+        auto it = spilled_.find(id);
+        if (it == spilled_.end()) {
+          return false;
+        }
+        spill_->release(it->second.file, it->second.size);
+        spilled_.erase(it);
+        return true;
+      });
+  batch.completed.erase(kept, batch.completed.end());
+}
+
+void TimesliceBuffer::poll_history() {
+  zmq::message_t message;
+  while (trigger_socket_ &&
+         trigger_socket_->recv(message, zmq::recv_flags::dontwait)) {
+    try {
+      dump_requests_.push_back(
+          HistoryDumpRequest::parse(message.to_string()));
+    } catch (const std::invalid_argument& e) {
+      L_(error) << "timeslice buffer " << shm_identifier_ << ": " << e.what();
+    }
+  }
+  if (history_dump_ && history_dump_->done()) {
+    if (history_dump_->error().empty()) {
+      L_(info) << "timeslice buffer " << shm_identifier_ << ": "
+               << history_dump_->size() << " timeslices written to "
+               << history_dump_->path();
+    } else {
+      L_(error) << "timeslice buffer " << shm_identifier_
+                << ": history dump failed: " << history_dump_->error();
+    }
+    history_dump_ = nullptr;
+    for (auto id : dump_pins_) {
+      history_[id].pinned = false;
+    }
+    dump_pins_.clear();
+  }
+  if (!history_dump_ && !dump_requests_.empty()) {
+    const HistoryDumpRequest request = dump_requests_.front();
+    dump_requests_.pop_front();
+    start_history_dump(request);
+  }
+}
+
+void TimesliceBuffer::start_history_dump(const HistoryDumpRequest& request) {
+  std::vector<std::shared_ptr<const fles::Timeslice>> timeslices;
+  for (auto& [id, item] : history_) {
+    if (item.ts_desc.index < request.first_index ||
+        item.ts_desc.index > request.last_index) {
+      continue;
+    }
+    item.pinned = true;
+    dump_pins_.push_back(id);
+    timeslices.push_back(
+        std::make_shared<BufferTimeslice>(*this, item.ts_desc));
+  }
+  L_(info) << "timeslice buffer " << shm_identifier_ << ": writing "
+           << timeslices.size() << " timeslices of indices "
+           << request.first_index << " to " << request.last_index << " to "
+           << request.path;
+  history_dump_ = std::make_unique<TimesliceHistoryDump>(
+      request.path, std::move(timeslices), retention_.io);
+}
+
+void TimesliceBuffer::retain_completions(ItemCompletionBatch& batch,
+                                         const std::deque<ItemID>& ids,
+                                         std::deque<ItemID>* completed) {
+  batch.completed_up_to = 0;
+  batch.completed.clear();
+  const auto now = std::chrono::steady_clock::now();
+  for (auto id : ids) {
+    auto it = history_.find(id);
+    if (it != history_.end()) {
+      it->second.done = true;
+      it->second.completion = now;
+    }
+  }
+  release_retained(batch, completed);
+}
+
+void TimesliceBuffer::release_retained(ItemCompletionBatch& batch,
+                                       std::deque<ItemID>* completed) {
+  const auto expiry = std::chrono::steady_clock::now() - retention_.depth;
+  bool full = fill_level(newest_) > retention_.max_fill;
+  for (auto it = history_.begin(); it != history_.end();) {
+    const RetainedItem& item = it->second;
+    if (!item.done || item.pinned) {
+      ++it;
+      continue;
+    }
+    // completions arrive roughly in order, so later ones are not yet due
+    if (!full && item.completion > expiry) {
+      break;
+    }
+    batch.completed.push_back(it->first);
+    if (completed != nullptr) {
+      completed->push_back(it->first);
+    }
+    it = history_.erase(it);
+    if (full) {
+      full = fill_level(newest_) > retention_.max_fill;
+    }
+  }
+}
+
+std::vector<uint32_t>
+TimesliceBuffer::data_size_exps_for_rates(const std::vector<double>& rates,
+                                          uint32_t mean_size_exp) {
+  const double total_rate = std::accumulate(
+      rates.begin(), rates.end(), 0.0,
+      [](double sum, double rate) { return sum + std::max(rate, 0.0); });
+  const uint32_t min_size_exp = mean_size_exp > 6 ? mean_size_exp - 6 : 0;
+  std::vector<uint32_t> exps(rates.size(), mean_size_exp);
+  if (!(total_rate > 0.0)) {
+    return exps;
+  }
+  const double total_size =
+      std::ldexp(static_cast<double>(rates.size()), mean_size_exp);
+  for (std::size_t i = 0; i < rates.size(); ++i) {
+    const double size = total_size * std::max(rates[i], 0.0) / total_rate;
+    // rounded down, at most the full total for a single input
+    const double exp = size >= 1.0 ? std::floor(std::log2(size)) : 0.0;
+    exps[i] = std::max(min_size_exp, static_cast<uint32_t>(exp));
+  }
+  return exps;
+}
+
+fles::ComponentSummary*
+TimesliceBuffer::get_summary_ptr(uint_fast16_t index) const {
+  if (!flat_segment_) {
+    return nullptr;
+  }
+  return flat_segment_->layout().summary_ring(static_cast<uint32_t>(index));
+}
+
+uint64_t TimesliceBuffer::get_start_time(uint64_t ts_pos) {
+  if (num_input_nodes_ == 0 || data_on_device()) {
+    return 0;
+  }
+  const auto& desc = get_desc(0, ts_pos);
+  const uint64_t data_buffer_size = UINT64_C(1) << data_buffer_size_exps_[0];
+  const uint64_t offset = desc.offset & (data_buffer_size - 1);
+  if (desc.num_microslices == 0 ||
+      offset + sizeof(fles::MicrosliceDescriptor) > data_buffer_size) {
+    return 0;
+  }
+  fles::MicrosliceDescriptor md{};
+  std::memcpy(&md, &get_data(0, offset), sizeof(md));
+  return md.idx;
+}
+
+bool TimesliceBuffer::try_receive_completions(ItemCompletionBatch& batch) {
+  return receive_completion_batch(batch, nullptr);
+}
+
+bool TimesliceBuffer::wait_for_completions(ItemCompletionBatch& batch,
+                                           std::chrono::milliseconds timeout) {
+  return receive_completion_batch(batch, nullptr, timeout);
+}
+
+bool TimesliceBuffer::try_receive_completion(fles::TimesliceCompletion& c) {
+  if (completions_.empty() &&
+      !receive_completion_batch(completion_batch_, &completions_)) {
+    return false;
+  }
+  if (completions_.empty()) {
+    return false;
+  }
+  c.ts_pos = completions_.front();
+  completions_.pop_front();
+  return true;
+}
+
+bool TimesliceBuffer::receive_completion_batch(
+    ItemCompletionBatch& batch,
+    std::deque<ItemID>* completed,
+    std::chrono::milliseconds timeout) {
+  if (retention_enabled_) {
+    poll_history();
+    batch.completed_up_to = 0;
+    batch.completed.clear();
+    release_retained(batch, completed);
+    if (!batch.completed.empty()) {
+      return true;
+    }
+  }
+  if (spill_) {
+    poll_spill();
+    if (release_spilled(batch)) {
+      if (completed != nullptr) {
+        completed->insert(completed->end(), batch.completed.begin(),
+                          batch.completed.end());
+      }
+      return true;
+    }
+  }
+  bool received = false;
+  if (release_deferred_completions(batch)) {
+    received = true;
+  } else if (timeout.count() > 0) {
+    received =
+        shm_item_distributor_
+            ? shm_item_distributor_->wait_for_completions(&batch, timeout)
+            : ItemProducer::wait_for_completions(&batch, timeout);
+  } else {
+    received = shm_item_distributor_
+                   ? shm_item_distributor_->try_receive_completions(&batch)
+                   : ItemProducer::try_receive_completions(&batch);
+  }
+  if (!received) {
+    return false;
+  }
+  if (partial_delivery_) {
+    defer_completions(batch);
+  }
+  if (!spilled_.empty()) {
+    settle_spilled(batch);
+  }
+  // in retention mode, the completed timeslices are kept in the buffer
+  std::deque<ItemID> retained;
+  std::deque<ItemID>* ids = retention_enabled_ ? &retained : completed;
+  outstanding_.erase_below(batch.completed_up_to, [&](ItemID id) {
+    EventTrace::record(TraceEventType::CompletionReceived, id);
+    if (completion_age_.enabled()) {
+      completion_age_.record(get_start_time(id));
+    }
+    if (calibrator_) {
+      calibrator_->record_completion(id);
+    }
+    if (ids != nullptr) {
+      ids->push_back(id);
+    }
+  });
+  for (auto id : batch.completed) {
+    if (!outstanding_.erase(id)) {
+      std::cerr << "Error: invalid item " << id << std::endl;
+      continue;
+    }
+    EventTrace::record(TraceEventType::CompletionReceived, id);
+    if (completion_age_.enabled()) {
+      completion_age_.record(get_start_time(id));
+    }
+    if (calibrator_) {
+      calibrator_->record_completion(id);
+    }
+    if (ids != nullptr) {
+      ids->push_back(id);
+    }
+  }
+  if (retention_enabled_) {
+    retain_completions(batch, retained, completed);
+  }
+  return true;
+}
+
+void TimesliceBuffer::defer_completions(ItemCompletionBatch& batch) {
+  if (batch.completed_up_to > complete_end_) {
+    outstanding_.for_each(complete_end_, batch.completed_up_to,
+                          [this](ItemID id) { deferred_.insert(id); });
+    batch.completed_up_to = complete_end_;
+  }
+  auto kept = std::partition(
+      batch.completed.begin(), batch.completed.end(),
+      [this](ItemID id) { return id < complete_end_; });
+  deferred_.insert(kept, batch.completed.end());
+  batch.completed.erase(kept, batch.completed.end());
+}
+
+bool TimesliceBuffer::release_deferred_completions(
+    ItemCompletionBatch& batch) {
+  auto end = deferred_.lower_bound(complete_end_);
+  if (end == deferred_.begin()) {
+    return false;
+  }
+  batch.completed_up_to = 0;
+  batch.completed.assign(deferred_.begin(), end);
+  deferred_.erase(deferred_.begin(), end);
+  return true;
 }
 
 std::string TimesliceBuffer::description() const {
-  size_t data_buffer_size = (UINT64_C(1) << data_buffer_size_exp_);
   size_t desc_buffer_size = (UINT64_C(1) << desc_buffer_size_exp_) *
                             sizeof(fles::TimesliceComponentDescriptor);
-  size_t overall_size =
-      num_input_nodes_ * (data_buffer_size + desc_buffer_size);
+  size_t overall_size = data_size_ + num_input_nodes_ * desc_buffer_size;
 
   std::string desc = shm_identifier_ + " {" +
-                     boost::uuids::to_string(shm_uuid_) +
-                     "}, size: " + std::to_string(num_input_nodes_) + " * (" +
-                     human_readable_count(data_buffer_size) + " + " +
-                     human_readable_count(desc_buffer_size) +
-                     ") = " + human_readable_count(overall_size);
+                     boost::uuids::to_string(shm_uuid_) + "}, size: ";
+  const bool uniform = std::all_of(
+      data_buffer_size_exps_.begin(), data_buffer_size_exps_.end(),
+      [this](uint32_t e) { return e == max_data_buffer_size_exp_; });
+  if (uniform) {
+    desc += std::to_string(num_input_nodes_) + " * (" +
+            human_readable_count(UINT64_C(1) << max_data_buffer_size_exp_) +
+            " + " + human_readable_count(desc_buffer_size) + ")";
+  } else {
+    desc += human_readable_count(data_size_) + " + " +
+            std::to_string(num_input_nodes_) + " * " +
+            human_readable_count(desc_buffer_size);
+  }
+  desc += " = " + human_readable_count(overall_size);
+  if (data_device_) {
+    desc += ", data on GPU " + std::to_string(data_device_->device());
+  }
+  if (flat_segment_) {
+    desc += partial_delivery_ ? ", flat layout, partial delivery"
+                              : ", flat layout";
+  }
+  if (persistent_) {
+    desc += reattached_ ? ", persistent (re-attached)" : ", persistent";
+  }
+  if (spill_) {
+    desc += ", spill to " + spill_->parameters().directory;
+  }
+  if (retention_enabled_) {
+    desc += ", retention: " + std::to_string(retention_.depth.count()) + " ms";
+    if (trigger_socket_) {
+      desc += ", trigger: " + retention_.trigger_address;
+    }
+  }
+  if (shm_item_distributor_) {
+    desc += ", item channel: " + shm_item_distributor_->channel_name();
+  }
   return desc;
 }
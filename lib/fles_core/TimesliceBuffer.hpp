@@ -1,19 +1,37 @@
 // Copyright 2016-2020 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include "BufferCalibrator.hpp"
+#include "ComponentSummary.hpp"
+#include "DataAgeMetric.hpp"
+#include "ItemBitmap.hpp"
 #include "ItemProducer.hpp"
+#include "LiveStats.hpp"
+#include "MemoryPolicy.hpp"
+#include "MicrosliceCrcChecker.hpp"
+#include "ShmItemDistributor.hpp"
 #include "TimesliceCompletion.hpp"
+#include "TimesliceHistory.hpp"
 #include "TimesliceComponentDescriptor.hpp"
+#include "TimesliceShmWorkItem.hpp"
+#include "TimesliceSpill.hpp"
+#include "TimesliceWorkItem.hpp"
 #include <boost/interprocess/interprocess_fwd.hpp>
 #include <boost/uuid/uuid.hpp>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <deque>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 namespace fles {
-struct TimesliceWorkItem;
+class DeviceMemory;
+class TimesliceShmSegment;
 }
 namespace zmq {
 class context_t;
@@ -26,12 +44,58 @@ class context_t;
 class TimesliceBuffer : public ItemProducer {
 public:
   /// The TimesliceBuffer constructor.
+  /** The memory policy is applied to the data and descriptor buffers within
+     the shared memory segment. As the segment is opened by name from other
+     processes, explicit huge pages are not supported; use transparent huge
+     pages instead.
+
+     If the memory policy selects a GPU device, the data buffers are placed
+     in device memory instead, and the descriptor buffers stay in the
+     segment. The segment then contains a fles::DeviceMemoryHandle for the
+     consumers to open the data buffers, and the data handles in the work
+     items are offsets into the device memory.
+
+     If use_shm_item_channel is set, work items are distributed through a
+     shared memory item channel (see ShmItemDistributor) instead of the ZMQ
+     item distributor at distributor_address. The legacy work item encoding
+     is only needed for timeslice receivers of older versions. With the flat
+     work item encoding, the segment is created in the flat layout (see
+     fles::TimesliceShmLayout) instead of as a managed shared memory, which
+     requires receivers supporting it and host memory data buffers.
+
+     If persistent is set, the segment is kept when the buffer is destroyed,
+     and a later buffer with the same identifier and geometry re-attaches to
+     it instead of creating a new one. The segment keeps its UUID, so
+     consumers stay attached across a producer restart, and its pages are
+     populated up front instead of faulting in the data path. Persistent
+     segments require the managed layout and host memory data buffers. */
   TimesliceBuffer(zmq::context_t& context,
                   const std::string& distributor_address,
                   std::string shm_identifier,
                   uint32_t data_buffer_size_exp,
                   uint32_t desc_buffer_size_exp,
-                  uint32_t num_input_nodes);
+                  uint32_t num_input_nodes,
+                  const MemoryPolicy& memory_policy = {},
+                  bool use_shm_item_channel = false,
+                  fles::WorkItemEncoding work_item_encoding =
+                      fles::WorkItemEncoding::Binary,
+                  bool persistent = false);
+
+  /// The TimesliceBuffer constructor for data buffers of individual sizes.
+  /** The data buffer of each input node (one per entry of
+     data_buffer_size_exps) is sized according to its data rate, so that
+     all of them cover about the same time span. The descriptor buffers
+     hold one entry per timeslice and input node and are of equal size. */
+  TimesliceBuffer(zmq::context_t& context,
+                  const std::string& distributor_address,
+                  std::string shm_identifier,
+                  std::vector<uint32_t> data_buffer_size_exps,
+                  uint32_t desc_buffer_size_exp,
+                  const MemoryPolicy& memory_policy = {},
+                  bool use_shm_item_channel = false,
+                  fles::WorkItemEncoding work_item_encoding =
+                      fles::WorkItemEncoding::Binary,
+                  bool persistent = false);
 
   TimesliceBuffer(const TimesliceBuffer&) = delete;
   void operator=(const TimesliceBuffer&) = delete;
@@ -39,21 +103,54 @@ public:
   /// The TimesliceBuffer destructor.
   ~TimesliceBuffer();
 
-  /// Get the 2's exponent of the size of the data buffer per input node in
-  /// bytes.
-  [[nodiscard]] uint32_t get_data_size_exp() const {
-    return data_buffer_size_exp_;
+  /// Get the 2's exponent of the size of the data buffer of the specified
+  /// input node in bytes.
+  [[nodiscard]] uint32_t get_data_size_exp(uint_fast16_t index) const {
+    return data_buffer_size_exps_[index];
+  }
+
+  /// Get the 2's exponent of the size of the largest data buffer in bytes.
+  [[nodiscard]] uint32_t get_max_data_size_exp() const {
+    return max_data_buffer_size_exp_;
   }
 
+  /// Get the size of the memory region spanning all data buffers in bytes.
+  [[nodiscard]] std::size_t get_data_size() const { return data_size_; }
+
+  /// Derive the 2's exponents of the data buffer sizes from the relative
+  /// data rates of the input nodes.
+  /** The buffers are sized in proportion to the rates, rounded down to
+     powers of two, so that in total they take no more memory than one
+     buffer of 2^mean_size_exp bytes per input node. No buffer is made
+     smaller than 2^(mean_size_exp - 6) bytes, and without positive rates
+     all buffers are of the mean size. */
+  [[nodiscard]] static std::vector<uint32_t>
+  data_size_exps_for_rates(const std::vector<double>& rates,
+                           uint32_t mean_size_exp);
+
   /// Get the 2's exponent of the size of the descriptor buffer per input node
   /// in units of TimesliceComponentDescriptors.
   [[nodiscard]] uint32_t get_desc_size_exp() const {
     return desc_buffer_size_exp_;
   }
 
+  /// Get the deadline horizon of the work items for a descriptor buffer size.
+  /** A work item is late once half of the descriptor buffer positions have
+     been filled after it. Timeslice receivers with a queue policy dropping
+     late items then no longer keep its buffer space in use. */
+  [[nodiscard]] static uint64_t
+  item_deadline_horizon(uint32_t desc_buffer_size_exp) {
+    return (UINT64_C(1) << desc_buffer_size_exp) / 2;
+  }
+
+  /// Check whether the data buffers are placed in GPU memory.
+  /** If so, data pointers are device pointers and not accessible from the
+     host. */
+  [[nodiscard]] bool data_on_device() const { return data_device_ != nullptr; }
+
   /// Get the pointer to the data buffer of the specified input node.
   [[nodiscard]] uint8_t* get_data_ptr(uint_fast16_t index) const {
-    return data_ptr_ + index * (UINT64_C(1) << data_buffer_size_exp_);
+    return data_ptr_ + data_offsets_[index];
   }
 
   /// Get the pointer to the descriptor buffer of the specified input node.
@@ -62,10 +159,17 @@ public:
     return desc_ptr_ + index * (UINT64_C(1) << desc_buffer_size_exp_);
   }
 
+  /// Get the pointer to the component summary buffer of the specified input
+  /// node, or nullptr if the buffer has none (see fles::ComponentSummary).
+  /** The summary buffer holds one entry per descriptor buffer entry. It
+     exists in the flat layout only. */
+  [[nodiscard]] fles::ComponentSummary*
+  get_summary_ptr(uint_fast16_t index) const;
+
   /// Get the reference to the data buffer of the specified input node at the
   /// given offset.
   [[nodiscard]] uint8_t& get_data(uint_fast16_t index, uint64_t offset) const {
-    offset &= (UINT64_C(1) << data_buffer_size_exp_) - 1;
+    offset &= (UINT64_C(1) << data_buffer_size_exps_[index]) - 1;
     return get_data_ptr(index)[offset];
   }
 
@@ -77,50 +181,341 @@ public:
     return get_desc_ptr(index)[offset];
   }
 
+  /// Get the start time of a timeslice, i.e. the index of the first
+  /// microslice of its first component (zero if not accessible).
+  [[nodiscard]] uint64_t get_start_time(uint64_t ts_pos);
+
   /// Get the number of input nodes.
   [[nodiscard]] uint32_t get_num_input_nodes() const {
     return num_input_nodes_;
   }
 
+  /// Check the microslice CRCs of each timeslice before it is handed on.
+  /** The results are recorded in the microslice descriptors in the buffer
+     (see MicrosliceCrcChecker), while the content is still in the cache of
+     the builder thread. Requires host memory data buffers. */
+  void set_crc_check(CrcCheckMode mode);
+
+  /// Retrieve the CRC check statistics (from the builder thread).
+  [[nodiscard]] const MicrosliceCrcChecker& crc_checker() const {
+    return crc_checker_;
+  }
+
   /// Send a work item to the item distributor.
+  /** With partial delivery, the work item of a timeslice already sent by
+     send_partial_work_item() is not sent again, but all of its components
+     are marked as complete. */
   void send_work_item(fles::TimesliceWorkItem wi);
 
-  /// Receive a completion from the item distributor.
-  [[nodiscard]] bool try_receive_completion(fles::TimesliceCompletion& c) {
-    ItemID id;
-    if (!ItemProducer::try_receive_completion(&id)) {
-      return false;
-    }
-    if (outstanding_.erase(id) != 1) {
-      std::cerr << "Error: invalid item " << id << std::endl;
-    }
-    c.ts_pos = id;
-    return true;
-  };
+  /// Hand on timeslices to the consumers before all components are complete.
+  /** The consumers then learn about the completion of each component from
+     the status rings of the segment (see fles::TimesliceShmLayout).
+     Requires the flat layout and no CRC check. */
+  void set_partial_delivery(bool enable);
+
+  /// Spill timeslices to log files on local storage while the buffer fills
+  /// up.
+  /** Once the fill level of the descriptor or data buffers reaches
+     parameters.high_water, complete timeslices are written to log files in
+     parameters.directory (see TimesliceSpill) instead of being handed on
+     from the buffer, until it falls below parameters.low_water. The buffer
+     space of a spilled timeslice is released to the input nodes as soon as
+     its record is on storage, and its work item refers to the record, so
+     that the consumers read it from the file once they catch up. Work items
+     are sent in order of the buffer position in either case. Requires host
+     memory data buffers and no partial delivery. */
+  void set_spill(const SpillParameters& parameters);
+
+  /// Retrieve the spill writer, if spilling is enabled.
+  [[nodiscard]] const TimesliceSpill* spill() const { return spill_.get(); }
+
+  /// Keep completed timeslices in the buffer for on-demand dumps.
+  /** The buffer space of a timeslice is released to the input nodes only
+     parameters.depth after its completion by the consumers, or earlier
+     while the buffer is filled beyond parameters.max_fill. On request
+     (see request_history_dump(), or a HistoryDumpRequest message to the
+     trigger socket bound to parameters.trigger_address), the timeslices
+     still in the buffer are written to an archive file on a background
+     thread, straight from the buffer. Their buffer space is kept until the
+     dump is complete. Has to be called before the first work item is sent.
+     Requires host memory data buffers and no spilling. */
+  void set_retention(const RetentionParameters& parameters);
+
+  /// Write the retained timeslices in a range of indices to an archive file.
+  /** The request is served after the previous ones. With a trigger socket,
+     requests are also received from there. */
+  void request_history_dump(const HistoryDumpRequest& request);
+
+  /// Measure the data and descriptor rates to recommend buffer sizes.
+  /** For parameters.duration from the first work item, the data size and
+     the buffer space in use are recorded for each timeslice, along with its
+     consumer latency (see BufferCalibrator). Then, the recommended size
+     exponents are logged and, if parameters.output_file is set, written to
+     that file in the format of the output parameters. */
+  void set_calibration(const CalibrationParameters& parameters);
+
+  /// Retrieve the number of timeslices kept in the buffer after completion.
+  [[nodiscard]] std::size_t get_num_retained() const;
+
+  /// Check whether partial delivery is enabled.
+  [[nodiscard]] bool partial_delivery() const { return partial_delivery_; }
+
+  /// Mark a component of a timeslice as complete (from any thread).
+  /** Only has an effect with partial delivery. The component data and
+     descriptor have to be in place. */
+  void set_component_complete(uint32_t component, uint64_t ts_pos) const;
+
+  /// Check whether a component of a timeslice has been marked as complete
+  /// (from any thread, requires partial delivery).
+  [[nodiscard]] bool component_complete(uint32_t component,
+                                        uint64_t ts_pos) const;
+
+  /// Send the work item of a timeslice some of whose components are not yet
+  /// complete (requires partial delivery).
+  /** Work items are sent in order of the buffer position. Completions of the
+     timeslice are held back until it has been passed to send_work_item(),
+     as consumers may drop the work item before. */
+  void send_partial_work_item(const fles::TimesliceWorkItem& wi);
+
+  /// Receive a batch of completions from the item distributor.
+  /** All timeslices before batch.completed_up_to and those listed in
+     batch.completed have been completed. */
+  [[nodiscard]] bool try_receive_completions(ItemCompletionBatch& batch);
+
+  /// Receive a batch of completions, waiting up to the given timeout if none
+  /// is pending.
+  [[nodiscard]] bool wait_for_completions(ItemCompletionBatch& batch,
+                                          std::chrono::milliseconds timeout);
+
+  /// Receive a single completion from the item distributor.
+  /** Completion batches are split into individual completions. Do not mix
+     with try_receive_completions(). */
+  [[nodiscard]] bool try_receive_completion(fles::TimesliceCompletion& c);
 
   // Remaining member functions are for backwards compatibility only
 
   [[nodiscard]] std::size_t get_num_work_items() const {
-    return outstanding_.size();
+    return outstanding_.size() + held_.size() + spilled_.size();
   }
 
   [[nodiscard]] std::size_t get_num_completions() const { return 0; }
 
   [[nodiscard]] std::string description() const;
 
+  /// Retrieve the number of work items sent (from any thread).
+  [[nodiscard]] uint64_t get_num_timeslices_sent() const {
+    return timeslices_sent_.load(std::memory_order_relaxed);
+  }
+
+  /// Retrieve the number of data bytes in the work items sent (from any
+  /// thread).
+  [[nodiscard]] uint64_t get_num_bytes_sent() const {
+    return bytes_sent_.load(std::memory_order_relaxed);
+  }
+
 private:
+  /// Send a work item referring to a timeslice in the flat segment.
+  void send_flat_work_item(const fles::TimesliceWorkItem& wi);
+
+  /// Open an existing persistent segment if its geometry matches.
+  bool attach_persistent_segment(const MemoryPolicy& host_policy);
+
+  /// Send a work item referring to a timeslice in the buffer.
+  void send_shm_work_item(const fles::TimesliceWorkItem& wi);
+
+  /// Pass the encoded work item to the item distributor. Spilled work items
+  /// are tracked in spilled_ instead of outstanding_.
+  void dispatch_work_item(const fles::TimesliceWorkItem& wi,
+                          bool spilled = false);
+
+  /// Receive a completion batch and release the completed items, optionally
+  /// appending their IDs to completed. With a non-zero timeout, wait for
+  /// completions if none are pending.
+  bool receive_completion_batch(
+      ItemCompletionBatch& batch,
+      std::deque<ItemID>* completed,
+      std::chrono::milliseconds timeout = std::chrono::milliseconds{0});
+
+  zmq::context_t& context_;       ///< ZMQ context of the sockets
   std::string shm_identifier_;    ///< shared memory identifier
   boost::uuids::uuid shm_uuid_{}; ///< shared memory UUID
-  uint32_t data_buffer_size_exp_; ///< 2's exponent of data buffer size in bytes
+  /// 2's exponents of the data buffer sizes in bytes
+  std::vector<uint32_t> data_buffer_size_exps_;
+  /// 2's exponent of the largest data buffer size in bytes
+  uint32_t max_data_buffer_size_exp_ = 0;
+  /// offsets of the data buffers from data_ptr_ in bytes
+  std::vector<uint64_t> data_offsets_;
+  /// size of the memory region spanning all data buffers in bytes
+  std::size_t data_size_ = 0;
   uint32_t desc_buffer_size_exp_; ///< 2's exponent of descriptor buffer size
                                   ///< in units of TimesliceComponentDescriptors
   uint32_t num_input_nodes_;      // number of input nodes
+  MemoryPolicy memory_policy_;    ///< placement policy of the buffers
+
+  fles::WorkItemEncoding work_item_encoding_; ///< encoding of work items
+
+  /// keep the segment for a later re-attach
+  bool persistent_;
+  /// whether an existing persistent segment was opened
+  bool reattached_ = false;
 
   std::unique_ptr<boost::interprocess::managed_shared_memory>
-      managed_shm_;   ///< shared memory object
+      managed_shm_; ///< shared memory object (unless in the flat layout)
+  std::unique_ptr<fles::TimesliceShmSegment>
+      flat_segment_;  ///< shared memory segment in the flat layout
   uint8_t* data_ptr_; ///< pointer to data buffer within shared memory
   fles::TimesliceComponentDescriptor*
-      desc_ptr_;                 ///< pointer to descriptor
-                                 ///< buffer within shared memory
-  std::set<ItemID> outstanding_; ///< set of outstanding work items
+      desc_ptr_;           ///< pointer to descriptor
+                           ///< buffer within shared memory
+  ItemBitmap outstanding_; ///< set of outstanding work items
+
+  /// data buffer memory, if placed on a GPU
+  std::unique_ptr<fles::DeviceMemory> data_device_;
+
+  std::vector<std::ptrdiff_t> data_handles_; ///< work item data handles
+  std::vector<std::ptrdiff_t> desc_handles_; ///< work item desc handles
+  std::string work_item_buffer_;             ///< encoded work item
+
+  ItemCompletionBatch completion_batch_; ///< last received completion batch
+  std::deque<ItemID> completions_;       ///< individual pending completions
+
+  std::atomic<uint64_t> timeslices_sent_{0}; ///< number of work items sent
+  std::atomic<uint64_t> bytes_sent_{0};      ///< data bytes of work items sent
+
+  /// hand on timeslices before all components are complete
+  bool partial_delivery_ = false;
+  /// buffer position following the last partial work item sent
+  uint64_t partial_end_ = 0;
+  /// buffer position following the last complete timeslice
+  uint64_t complete_end_ = 0;
+  /// completions held back until the timeslice is complete
+  std::set<ItemID> deferred_;
+
+  /// Hold back the completions of timeslices not yet complete.
+  void defer_completions(ItemCompletionBatch& batch);
+
+  /// Pass on the held back completions of complete timeslices, if any.
+  bool release_deferred_completions(ItemCompletionBatch& batch);
+
+  /// A work item waiting for the spill writer or for those before it.
+  struct HeldItem {
+    fles::TimesliceWorkItem wi; ///< the work item
+    bool spilling;              ///< whether it has been passed to spill_
+  };
+
+  /// The record of a spilled timeslice not yet completed.
+  struct SpilledItem {
+    uint32_t file; ///< number of the log file
+    uint64_t size; ///< size of the record
+  };
+
+  /// spill writer, if spilling is enabled
+  std::unique_ptr<TimesliceSpill> spill_;
+  /// whether the fill level has reached the high water mark
+  bool spilling_ = false;
+  /// work items held back to keep them in order
+  std::deque<HeldItem> held_;
+  /// spilled timeslices sent but not yet completed
+  std::map<ItemID, SpilledItem> spilled_;
+  /// spilled timeslices to be released to the input nodes
+  std::vector<ItemID> released_;
+
+  /// parameters of the calibration of the buffer sizes, if pending
+  CalibrationParameters calibration_;
+  /// calibration of the buffer sizes, from the first work item on
+  std::unique_ptr<BufferCalibrator> calibrator_;
+
+  /// Record a timeslice sent for the calibration, finish it once done.
+  void record_calibration(uint64_t ts_pos);
+
+  /// Get the oldest timeslice whose buffer space is in use.
+  [[nodiscard]] uint64_t oldest_in_use(uint64_t ts_pos) const;
+
+  /// Get the fill level of the buffer up to a timeslice (between 0 and 1).
+  [[nodiscard]] double fill_level(uint64_t ts_pos);
+
+  /// Pass a timeslice to the spill writer if the buffer is filled up.
+  bool try_spill(const fles::TimesliceWorkItem& wi);
+
+  /// Send the held work items whose spill writes have completed.
+  void poll_spill();
+
+  /// Send a work item referring to a spilled timeslice.
+  void send_spill_work_item(const fles::TimesliceWorkItem& wi,
+                            const TimesliceSpill::Result& result);
+
+  /// Pass on the buffer space of spilled timeslices as completions, if any.
+  bool release_spilled(ItemCompletionBatch& batch);
+
+  /// Remove completions of spilled timeslices from a batch and release their
+  /// records.
+  void settle_spilled(ItemCompletionBatch& batch);
+
+  /// A timeslice sent in retention mode.
+  struct RetainedItem {
+    fles::TimesliceDescriptor ts_desc; ///< timeslice descriptor
+    /// time of the completion by the consumers
+    std::chrono::steady_clock::time_point completion;
+    bool done = false;   ///< whether the consumers have completed it
+    bool pinned = false; ///< whether it is part of the current dump
+  };
+
+  /// whether completed timeslices are kept in the buffer
+  bool retention_enabled_ = false;
+  /// retention configuration
+  RetentionParameters retention_;
+  /// timeslices sent in retention mode and not yet released
+  std::map<ItemID, RetainedItem> history_;
+  /// buffer position of the last work item sent
+  uint64_t newest_ = 0;
+  /// socket receiving history dump requests, if bound
+  std::unique_ptr<zmq::socket_t> trigger_socket_;
+  /// history dump requests not yet served
+  std::deque<HistoryDumpRequest> dump_requests_;
+  /// history dump in progress, if any
+  std::unique_ptr<TimesliceHistoryDump> history_dump_;
+  /// timeslices pinned by the history dump in progress
+  std::vector<ItemID> dump_pins_;
+
+  /// Receive dump requests and finish or start history dumps.
+  void poll_history();
+
+  /// Pin the requested timeslices and start writing them.
+  void start_history_dump(const HistoryDumpRequest& request);
+
+  /// Mark timeslices as completed by the consumers and replace the batch by
+  /// the timeslices to be released.
+  void retain_completions(ItemCompletionBatch& batch,
+                          const std::deque<ItemID>& ids,
+                          std::deque<ItemID>* completed);
+
+  /// Append the retained timeslices due for release to batch.completed,
+  /// and to completed if given.
+  void release_retained(ItemCompletionBatch& batch,
+                        std::deque<ItemID>* completed);
+
+  /// microslice CRC check applied to the work items sent
+  MicrosliceCrcChecker crc_checker_{CrcCheckMode::None};
+
+  /// Live statistics of the completed timeslices (see cbm::LiveStats).
+  struct LiveStatistics {
+    cbm::LiveCounter timeslices;
+    cbm::LiveCounter components;
+    cbm::LiveCounter microslices;
+    cbm::LiveCounter bytes;
+    /// Microslice size histogram and its eq_id (-1: none), by component.
+    std::vector<std::pair<int32_t, cbm::LiveHistogram>> microslice_sizes;
+  };
+  std::unique_ptr<LiveStatistics> live_;
+
+  /// Record a completed timeslice in the live statistics.
+  void record_live_stats(const fles::TimesliceWorkItem& wi);
+
+  /// age of the timeslices handed on to the consumers
+  DataAgeMetric dispatch_age_;
+  /// age of the timeslices completed by the consumers
+  DataAgeMetric completion_age_;
+
+  /// shared memory item channel, if used instead of the ZMQ distributor
+  std::unique_ptr<ShmItemDistributor> shm_item_distributor_;
 };
@@ -0,0 +1,167 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the TimesliceCompletionTable class.
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * \brief Arrival accounting of the timeslice components on a compute node.
+ *
+ * The table holds one slot per timeslice position in a ring, with a bitmap
+ * of the inputs whose component has arrived and their number, so recording
+ * an arrival and checking the completeness of a timeslice are O(1) and do
+ * not touch the descriptor buffers of the inputs. Positions below the
+ * release mark may be reused; if a new position collides with an unreleased
+ * one, the ring grows.
+ */
+class TimesliceCompletionTable {
+public:
+  /// Construct a table for num_inputs inputs and initially 2^size_exp
+  /// timeslice positions.
+  explicit TimesliceCompletionTable(uint32_t num_inputs,
+                                    uint32_t size_exp = 10)
+      : num_inputs_(num_inputs), words_((num_inputs + 63) / 64) {
+    assert(num_inputs > 0);
+    resize(std::size_t(1) << size_exp);
+  }
+
+  /// Record the arrival of the component of an input.
+  /** \return true if the timeslice has become complete by this arrival */
+  bool mark_arrived(uint64_t ts_pos, uint32_t input) {
+    assert(input < num_inputs_);
+    Slot& s = slot_for(ts_pos);
+    uint64_t& word = bits_[s.bits + input / 64];
+    const uint64_t bit = UINT64_C(1) << (input % 64);
+    if ((word & bit) != 0) {
+      return false;
+    }
+    word |= bit;
+    return ++s.count == num_inputs_;
+  }
+
+  /// Revoke the arrival of the component of an input.
+  /** \return true if the arrival had been recorded */
+  bool unmark_arrived(uint64_t ts_pos, uint32_t input) {
+    assert(input < num_inputs_);
+    Slot* s = find(ts_pos);
+    if (s == nullptr) {
+      return false;
+    }
+    uint64_t& word = bits_[s->bits + input / 64];
+    const uint64_t bit = UINT64_C(1) << (input % 64);
+    if ((word & bit) == 0) {
+      return false;
+    }
+    word &= ~bit;
+    --s->count;
+    return true;
+  }
+
+  /// Check whether the components of all inputs have arrived.
+  [[nodiscard]] bool complete(uint64_t ts_pos) const {
+    return arrived(ts_pos) == num_inputs_;
+  }
+
+  /// Retrieve the number of arrived components of a timeslice.
+  [[nodiscard]] uint32_t arrived(uint64_t ts_pos) const {
+    const Slot& s = slots_[ts_pos & mask_];
+    return s.used && s.ts_pos == ts_pos ? s.count : 0;
+  }
+
+  /// Forget the arrivals of a timeslice (e.g., after a timeout).
+  void clear(uint64_t ts_pos) {
+    if (Slot* s = find(ts_pos)) {
+      s->used = false;
+    }
+  }
+
+  /// Allow the slots of all positions below end to be reused.
+  void release(uint64_t end) {
+    if (end > released_) {
+      released_ = end;
+    }
+  }
+
+  /// Change the number of inputs. Clears all recorded arrivals.
+  void set_num_inputs(uint32_t num_inputs) {
+    assert(num_inputs > 0);
+    num_inputs_ = num_inputs;
+    words_ = (num_inputs + 63) / 64;
+    resize(slots_.size());
+  }
+
+  /// Retrieve the current number of timeslice positions in the ring.
+  [[nodiscard]] std::size_t capacity() const { return slots_.size(); }
+
+private:
+  struct Slot {
+    uint64_t ts_pos = 0;
+    std::size_t bits = 0; ///< Index of the first bitmap word
+    uint32_t count = 0;
+    bool used = false;
+  };
+
+  uint32_t num_inputs_;
+  std::size_t words_;
+  std::size_t mask_ = 0;
+  uint64_t released_ = 0;
+  std::vector<Slot> slots_;
+  std::vector<uint64_t> bits_;
+
+  void resize(std::size_t size) {
+    slots_.assign(size, Slot());
+    bits_.assign(size * words_, 0);
+    mask_ = size - 1;
+    for (std::size_t i = 0; i < size; ++i) {
+      slots_[i].bits = i * words_;
+    }
+  }
+
+  Slot* find(uint64_t ts_pos) {
+    Slot& s = slots_[ts_pos & mask_];
+    return s.used && s.ts_pos == ts_pos ? &s : nullptr;
+  }
+
+  Slot& slot_for(uint64_t ts_pos) {
+    while (true) {
+      Slot& s = slots_[ts_pos & mask_];
+      if (s.used && s.ts_pos == ts_pos) {
+        return s;
+      }
+      if (!s.used || s.ts_pos < released_) {
+        s.ts_pos = ts_pos;
+        s.count = 0;
+        s.used = true;
+        std::fill_n(bits_.begin() + static_cast<std::ptrdiff_t>(s.bits),
+                    words_, 0);
+        return s;
+      }
+      grow();
+    }
+  }
+
+  /// Double the number of slots, keeping the unreleased positions.
+  void grow() {
+    std::vector<Slot> old_slots = std::move(slots_);
+    std::vector<uint64_t> old_bits = std::move(bits_);
+    resize(old_slots.size() * 2);
+    for (const Slot& old : old_slots) {
+      if (!old.used || old.ts_pos < released_) {
+        continue;
+      }
+      Slot& s = slots_[old.ts_pos & mask_];
+      s.ts_pos = old.ts_pos;
+      s.count = old.count;
+      s.used = true;
+      std::copy_n(old_bits.begin() + static_cast<std::ptrdiff_t>(old.bits),
+                  words_,
+                  bits_.begin() + static_cast<std::ptrdiff_t>(s.bits));
+    }
+  }
+};
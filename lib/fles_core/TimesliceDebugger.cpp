@@ -1,10 +1,44 @@
 // Copyright 2013-2015 Jan de Cuveland <cmail@cuveland.de>
 
 #include "TimesliceDebugger.hpp"
+#include "StorableMicroslice.hpp"
+#include "log.hpp"
 #include <algorithm>
-#include <boost/format.hpp>
+#include <cstdio>
 
-std::ostream& TimesliceDump::write_to_stream(std::ostream& s) const {
+namespace {
+
+// Number of jobs queued for formatting before further dumps are dropped
+constexpr std::size_t dump_writer_capacity = 4;
+
+const char hex_digits[] = "0123456789abcdef";
+
+// Append a value as a lower-case hex number of at least the given width
+// (as the printf "%0*lx" conversion)
+void append_hex(std::string& out, uint64_t value, int width) {
+  char buf[16];
+  int n = 0;
+  do {
+    buf[n++] = hex_digits[value & 0xf];
+    value >>= 4;
+  } while (value != 0 && n < 16);
+  while (n < width) {
+    buf[n++] = '0';
+  }
+  while (n > 0) {
+    out += buf[--n];
+  }
+}
+
+void append_number(std::string& out, uint64_t value) {
+  out += std::to_string(value);
+}
+
+} // namespace
+
+void append_timeslice_dump(std::string& out,
+                           const fles::Timeslice& ts,
+                           std::size_t verbosity) {
   uint64_t min_num_microslices = UINT64_MAX;
   uint64_t max_num_microslices = 0;
   uint64_t total_num_microslices = 0;
@@ -28,66 +62,232 @@ std::ostream& TimesliceDump::write_to_stream(std::ostream& s) const {
   uint64_t min_overlap = min_num_microslices - ts.num_core_microslices();
   uint64_t max_overlap = max_num_microslices - ts.num_core_microslices();
 
-  s << "timeslice " << ts.index() << " size: " << ts.num_components() << " x "
-    << ts.num_core_microslices() << " microslices";
+  out += "timeslice ";
+  append_number(out, ts.index());
+  out += " size: ";
+  append_number(out, ts.num_components());
+  out += " x ";
+  append_number(out, ts.num_core_microslices());
+  out += " microslices";
   if (ts.num_components() != 0) {
-    s << " (+";
+    out += " (+";
+    append_number(out, min_overlap);
     if (min_overlap != max_overlap) {
-      s << min_overlap << ".." << max_overlap;
-    } else {
-      s << min_overlap;
+      out += "..";
+      append_number(out, max_overlap);
     }
-    s << " overlap) = " << total_num_microslices << "\n";
-    s << "\tmicroslice size min/avg/max: " << min_microslice_size << "/"
-      << (static_cast<double>(total_microslice_size) / total_num_microslices)
-      << "/" << max_microslice_size << "\n";
+    out += " overlap) = ";
+    append_number(out, total_num_microslices);
+    out += "\n\tmicroslice size min/avg/max: ";
+    append_number(out, min_microslice_size);
+    out += '/';
+    // same as the default floating point format of an ostream
+    char avg[32];
+    std::snprintf(avg, sizeof(avg), "%g",
+                  static_cast<double>(total_microslice_size) /
+                      static_cast<double>(total_num_microslices));
+    out += avg;
+    out += '/';
+    append_number(out, max_microslice_size);
+    out += '\n';
   }
 
   if (verbosity > 1) {
     for (uint64_t c = 0; c < ts.num_components(); ++c) {
       uint64_t num_microslices = ts.num_microslices(c);
       for (uint64_t m = 0; m < num_microslices; ++m) {
-        s << "timeslice " << ts.index() << " microslice " << m << " component "
-          << c << "\n"
-          << ts.get_microslice(c, m) << std::endl;
+        out += "timeslice ";
+        append_number(out, ts.index());
+        out += " microslice ";
+        append_number(out, m);
+        out += " component ";
+        append_number(out, c);
+        out += '\n';
+        const fles::MicrosliceDescriptor& md = ts.descriptor(c, m);
+        append_descriptor_dump(out, md);
+        out += '\n';
+        append_buffer_dump(out, ts.content(c, m), md.size);
+        out += '\n';
       }
     }
   }
-
-  return s;
 }
 
-std::ostream& MicrosliceDescriptorDump::write_to_stream(std::ostream& s) const {
-  s << "hi hv eqid flag si sv idx/start        crc      size     offset\n";
-  s << boost::format(
-           "%02x %02x %04x %04x %02x %02x %016lx %08x %08x %016lx\n") %
-           static_cast<unsigned int>(md.hdr_id) %
-           static_cast<unsigned int>(md.hdr_ver) % md.eq_id % md.flags %
-           static_cast<unsigned int>(md.sys_id) %
-           static_cast<unsigned int>(md.sys_ver) % md.idx % md.crc % md.size %
-           md.offset;
-
-  return s;
+void append_descriptor_dump(std::string& out,
+                            const fles::MicrosliceDescriptor& md) {
+  out += "hi hv eqid flag si sv idx/start        crc      size     offset\n";
+  append_hex(out, md.hdr_id, 2);
+  out += ' ';
+  append_hex(out, md.hdr_ver, 2);
+  out += ' ';
+  append_hex(out, md.eq_id, 4);
+  out += ' ';
+  append_hex(out, md.flags, 4);
+  out += ' ';
+  append_hex(out, md.sys_id, 2);
+  out += ' ';
+  append_hex(out, md.sys_ver, 2);
+  out += ' ';
+  append_hex(out, md.idx, 16);
+  out += ' ';
+  append_hex(out, md.crc, 8);
+  out += ' ';
+  append_hex(out, md.size, 8);
+  out += ' ';
+  append_hex(out, md.offset, 16);
+  out += '\n';
 }
 
-std::ostream& BufferDump::write_to_stream(std::ostream& s) const {
-  constexpr int bytes_per_block = 8;
-  constexpr int bytes_per_line = 4 * bytes_per_block;
+void append_buffer_dump(std::string& out, const void* buf, std::size_t size) {
+  constexpr std::size_t bytes_per_block = 8;
+  constexpr std::size_t bytes_per_line = 4 * bytes_per_block;
+  const auto* bytes = static_cast<const uint8_t*>(buf);
 
-  for (int i = 0; i < static_cast<int>(size); i += bytes_per_line) {
-    for (int j = bytes_per_line - 1; j >= 0; --j) {
-      if (i + j >= static_cast<int>(size)) {
-        s << "  ";
+  for (std::size_t i = 0; i < size; i += bytes_per_line) {
+    for (std::size_t j = bytes_per_line; j-- > 0;) {
+      if (i + j >= size) {
+        out += "  ";
       } else {
-        s << boost::format("%02x") %
-                 static_cast<int>(static_cast<const uint8_t*>(buf)[i + j]);
+        out += hex_digits[bytes[i + j] >> 4];
+        out += hex_digits[bytes[i + j] & 0xf];
       }
       if ((j % bytes_per_block) == 0) {
-        s << "  ";
+        out += "  ";
       }
     }
-    s << boost::format(":%04x\n") % i;
+    out += ':';
+    append_hex(out, i, 4);
+    out += '\n';
   }
+}
+
+uint64_t estimated_dump_size(const fles::MicrosliceDescriptor& md,
+                             std::size_t verbosity) {
+  // descriptor header and value lines, 78 bytes per line of content
+  uint64_t size = 143;
+  if (verbosity > 1) {
+    size += (md.size + 31) / 32 * 78;
+  }
+  return size;
+}
+
+uint64_t estimated_dump_size(const fles::Timeslice& ts,
+                             std::size_t verbosity) {
+  // summary lines
+  uint64_t size = 120;
+  if (verbosity > 1) {
+    for (uint64_t c = 0; c < ts.num_components(); ++c) {
+      for (uint64_t m = 0; m < ts.num_microslices(c); ++m) {
+        size += 50 + estimated_dump_size(ts.descriptor(c, m), verbosity);
+      }
+    }
+  }
+  return size;
+}
+
+// ----------
+
+std::ostream& TimesliceDump::write_to_stream(std::ostream& s) const {
+  std::string text;
+  append_timeslice_dump(text, ts, verbosity);
+  return s << text;
+}
 
-  return s;
+std::ostream& MicrosliceDescriptorDump::write_to_stream(std::ostream& s) const {
+  std::string text;
+  append_descriptor_dump(text, md);
+  return s << text;
+}
+
+std::ostream& BufferDump::write_to_stream(std::ostream& s) const {
+  std::string text;
+  append_buffer_dump(text, buf, size);
+  return s << text;
+}
+
+// ----------
+
+MicrosliceDumper::MicrosliceDumper(std::ostream& arg_out,
+                                   std::size_t arg_verbosity,
+                                   const DumpSampling& arg_sampling)
+    : out(arg_out), verbosity(arg_verbosity), sampler(arg_sampling) {
+  if (arg_sampling.enabled()) {
+    writer = std::make_unique<DumpWriter>(out, dump_writer_capacity);
+  }
+}
+
+MicrosliceDumper::~MicrosliceDumper() {
+  if (writer) {
+    uint64_t dropped = writer->dropped();
+    writer.reset();
+    L_(info) << "microslice dump: " << sampler.sampled() - dropped
+             << " dumped, " << sampler.skipped() << " skipped, " << dropped
+             << " dropped";
+  }
+}
+
+void MicrosliceDumper::consume(const fles::Microslice& m) {
+  if (!writer) {
+    text.clear();
+    append_descriptor_dump(text, m.desc());
+    text += '\n';
+    if (verbosity > 1) {
+      append_buffer_dump(text, m.content(), m.desc().size);
+    }
+    out << text;
+    return;
+  }
+
+  if (!sampler.sample(estimated_dump_size(m.desc(), verbosity))) {
+    return;
+  }
+  // the microslice is only valid during this call
+  auto copy = std::make_shared<const fles::StorableMicroslice>(m);
+  writer->submit([copy, verbosity = verbosity](std::string& s) {
+    append_descriptor_dump(s, copy->desc());
+    s += '\n';
+    if (verbosity > 1) {
+      append_buffer_dump(s, copy->content(), copy->desc().size);
+    }
+  });
+}
+
+// ----------
+
+TimesliceDumper::TimesliceDumper(std::ostream& arg_out,
+                                 std::size_t arg_verbosity,
+                                 const DumpSampling& arg_sampling)
+    : out(arg_out), verbosity(arg_verbosity), sampler(arg_sampling) {
+  if (arg_sampling.enabled()) {
+    writer = std::make_unique<DumpWriter>(out, dump_writer_capacity);
+  }
+}
+
+TimesliceDumper::~TimesliceDumper() {
+  if (writer) {
+    uint64_t dropped = writer->dropped();
+    writer.reset();
+    L_(info) << "timeslice dump: " << sampler.sampled() - dropped
+             << " dumped, " << sampler.skipped() << " skipped, " << dropped
+             << " dropped";
+  }
+}
+
+void TimesliceDumper::put(std::shared_ptr<const fles::Timeslice> timeslice) {
+  if (!writer) {
+    text.clear();
+    append_timeslice_dump(text, *timeslice, verbosity);
+    text += '\n';
+    out << text;
+    return;
+  }
+
+  if (!sampler.sample(estimated_dump_size(*timeslice, verbosity))) {
+    return;
+  }
+  writer->submit([timeslice = std::move(timeslice),
+                  verbosity = verbosity](std::string& s) {
+    append_timeslice_dump(s, *timeslice, verbosity);
+    s += '\n';
+  });
 }
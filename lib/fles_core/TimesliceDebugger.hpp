@@ -1,10 +1,38 @@
 // Copyright 2013-2015 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include "DumpSampler.hpp"
 #include "MicrosliceDescriptor.hpp"
 #include "Sink.hpp"
+#include "StaticPipeline.hpp"
 #include "Timeslice.hpp"
+#include <memory>
 #include <ostream>
+#include <string>
+
+// The dump output is formatted by the append_*_dump() functions, which are
+// also used by the stream output classes below.
+
+/// Append the hex dump of a buffer, 32 bytes per line, to a string.
+void append_buffer_dump(std::string& out, const void* buf, std::size_t size);
+
+/// Append the dump of a microslice descriptor to a string.
+void append_descriptor_dump(std::string& out,
+                            const fles::MicrosliceDescriptor& md);
+
+/// Append the dump of a timeslice to a string.
+void append_timeslice_dump(std::string& out,
+                           const fles::Timeslice& ts,
+                           std::size_t verbosity);
+
+/// Estimate the size of the dump of a microslice.
+uint64_t estimated_dump_size(const fles::MicrosliceDescriptor& md,
+                             std::size_t verbosity);
+
+/// Estimate the size of the dump of a timeslice.
+uint64_t estimated_dump_size(const fles::Timeslice& ts, std::size_t verbosity);
+
+// ----------
 
 class BufferDump {
 public:
@@ -49,21 +77,27 @@ inline std::ostream& operator<<(std::ostream& s,
 
 // ----------
 
-class MicrosliceDumper : public fles::MicrosliceSink {
+/// Dumps microslices to a stream.
+/**
+ * If sampling is enabled (see DumpSampling), the selected microslices are
+ * copied and formatted on a background thread.
+ */
+class MicrosliceDumper
+    : public fles::StaticSink<MicrosliceDumper, fles::Microslice> {
 public:
-  MicrosliceDumper(std::ostream& arg_out, std::size_t arg_verbosity)
-      : out(arg_out), verbosity(arg_verbosity){};
+  MicrosliceDumper(std::ostream& arg_out,
+                   std::size_t arg_verbosity,
+                   const DumpSampling& arg_sampling = DumpSampling());
+  ~MicrosliceDumper() override;
 
-  void put(std::shared_ptr<const fles::Microslice> m) override {
-    out << MicrosliceDescriptorDump(m->desc()) << "\n";
-    if (verbosity > 1) {
-      out << BufferDump(m->content(), m->desc().size);
-    }
-  }
+  void consume(const fles::Microslice& m);
 
 private:
   std::ostream& out;
   std::size_t verbosity;
+  DumpSampler sampler;
+  std::unique_ptr<DumpWriter> writer;
+  std::string text;
 };
 
 // ----------
@@ -86,16 +120,24 @@ inline std::ostream& operator<<(std::ostream& s, const TimesliceDump& dump) {
 
 // ----------
 
+/// Dumps timeslices to a stream.
+/**
+ * If sampling is enabled (see DumpSampling), the selected timeslices are
+ * formatted on a background thread, which holds them until then.
+ */
 class TimesliceDumper : public fles::TimesliceSink {
 public:
-  TimesliceDumper(std::ostream& arg_out, std::size_t arg_verbosity)
-      : out(arg_out), verbosity(arg_verbosity){};
+  TimesliceDumper(std::ostream& arg_out,
+                  std::size_t arg_verbosity,
+                  const DumpSampling& arg_sampling = DumpSampling());
+  ~TimesliceDumper() override;
 
-  void put(std::shared_ptr<const fles::Timeslice> timeslice) override {
-    out << TimesliceDump(*timeslice, verbosity) << "\n";
-  }
+  void put(std::shared_ptr<const fles::Timeslice> timeslice) override;
 
 private:
   std::ostream& out;
   std::size_t verbosity;
+  DumpSampler sampler;
+  std::unique_ptr<DumpWriter> writer;
+  std::string text;
 };
@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "TimesliceHistory.hpp"
+#include "TimesliceOutputArchive.hpp"
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <zmq.hpp>
+
+std::string HistoryDumpRequest::to_string() const {
+  return std::to_string(first_index) + " " + std::to_string(last_index) +
+         " " + path;
+}
+
+HistoryDumpRequest HistoryDumpRequest::parse(const std::string& message) {
+  HistoryDumpRequest request;
+  std::istringstream stream(message);
+  stream >> request.first_index >> request.last_index >> std::ws;
+  std::getline(stream, request.path);
+  if (stream.bad() || request.path.empty() ||
+      request.last_index < request.first_index) {
+    throw std::invalid_argument("invalid history dump request: " + message);
+  }
+  return request;
+}
+
+void send_history_dump_request(zmq::context_t& context,
+                               const std::string& address,
+                               const HistoryDumpRequest& request) {
+  zmq::socket_t socket(context, zmq::socket_type::push);
+  socket.set(zmq::sockopt::linger, 1000);
+  socket.connect(address);
+  socket.send(zmq::buffer(request.to_string()), zmq::send_flags::none);
+}
+
+TimesliceHistoryDump::TimesliceHistoryDump(
+    std::string path,
+    std::vector<std::shared_ptr<const fles::Timeslice>> timeslices,
+    const fles::DirectIoParameters& io)
+    : path_(std::move(path)), timeslices_(std::move(timeslices)), io_(io) {
+  thread_ = std::thread(&TimesliceHistoryDump::work, this);
+}
+
+TimesliceHistoryDump::~TimesliceHistoryDump() { thread_.join(); }
+
+void TimesliceHistoryDump::work() {
+  try {
+    fles::TimesliceOutputArchive archive(path_, fles::ArchiveCompression::None,
+                                         false, {}, io_);
+    for (const auto& timeslice : timeslices_) {
+      archive.put(timeslice);
+    }
+  } catch (const std::exception& e) {
+    error_ = e.what();
+  }
+  done_.store(true, std::memory_order_release);
+}
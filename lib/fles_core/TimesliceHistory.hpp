@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the TimesliceHistoryDump class and the retention
+/// parameters of a TimesliceBuffer.
+#pragma once
+
+#include "DirectFileBuffer.hpp"
+#include "Timeslice.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace zmq {
+class context_t;
+}
+
+/// Configuration of the retention of completed timeslices in a
+/// TimesliceBuffer.
+struct RetentionParameters {
+  /// Time to keep timeslices in the buffer after their completion
+  std::chrono::milliseconds depth{10000};
+  /// Buffer fill level beyond which timeslices are released early
+  double max_fill = 0.5;
+  /// ZMQ address to bind the trigger socket to (none if empty)
+  std::string trigger_address;
+  /// Parameters of the archive file writer
+  fles::DirectIoParameters io;
+};
+
+/// Request to write retained timeslices to an archive file.
+struct HistoryDumpRequest {
+  uint64_t first_index = 0; ///< Index of the first timeslice
+  uint64_t last_index = 0;  ///< Index of the last timeslice (inclusive)
+  std::string path;         ///< File name of the timeslice archive
+
+  /// Encode the request as a trigger message ("<first> <last> <path>").
+  [[nodiscard]] std::string to_string() const;
+
+  /// Decode a trigger message.
+  /**
+     \throws std::invalid_argument if the message is malformed
+   */
+  [[nodiscard]] static HistoryDumpRequest parse(const std::string& message);
+};
+
+/// Send a request to the trigger socket of a TimesliceBuffer.
+void send_history_dump_request(zmq::context_t& context,
+                               const std::string& address,
+                               const HistoryDumpRequest& request);
+
+/**
+ * \brief The TimesliceHistoryDump class writes a set of timeslices to a
+ * timeslice archive file on a background thread.
+ *
+ * The timeslices are typically views into the timeslice buffer, which are
+ * serialized without copying the component data. They are released when
+ * the object is destroyed.
+ */
+class TimesliceHistoryDump {
+public:
+  /// Start writing the timeslices to the given archive file.
+  TimesliceHistoryDump(
+      std::string path,
+      std::vector<std::shared_ptr<const fles::Timeslice>> timeslices,
+      const fles::DirectIoParameters& io = {});
+
+  /// Delete copy constructor (non-copyable).
+  TimesliceHistoryDump(const TimesliceHistoryDump&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const TimesliceHistoryDump&) = delete;
+
+  /// Wait for the thread to finish.
+  ~TimesliceHistoryDump();
+
+  /// Check whether all timeslices have been written (or writing failed).
+  [[nodiscard]] bool done() const {
+    return done_.load(std::memory_order_acquire);
+  }
+
+  /// Retrieve the error message if writing failed (once done).
+  [[nodiscard]] const std::string& error() const { return error_; }
+
+  /// Retrieve the file name of the archive.
+  [[nodiscard]] const std::string& path() const { return path_; }
+
+  /// Retrieve the number of timeslices.
+  [[nodiscard]] std::size_t size() const { return timeslices_.size(); }
+
+private:
+  void work();
+
+  std::string path_;
+  std::vector<std::shared_ptr<const fles::Timeslice>> timeslices_;
+  fles::DirectIoParameters io_;
+  std::string error_;
+  std::atomic<bool> done_{false};
+  std::thread thread_;
+};
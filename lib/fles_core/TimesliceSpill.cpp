@@ -0,0 +1,230 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "TimesliceSpill.hpp"
+#include "TimesliceSpillLog.hpp"
+#include "log.hpp"
+#include <cstdio>
+#include <stdexcept>
+#include <utility>
+
+static_assert(fles::TimesliceSpillRecordHeader::record_alignment %
+                      fles::DirectFileBuffer::alignment ==
+                  0,
+              "spill records must be aligned for direct I/O");
+
+namespace {
+
+constexpr uint64_t record_alignment =
+    fles::TimesliceSpillRecordHeader::record_alignment;
+
+uint64_t padded_size(uint64_t size) {
+  return (size + record_alignment - 1) / record_alignment * record_alignment;
+}
+
+} // namespace
+
+TimesliceSpill::TimesliceSpill(std::string file_prefix,
+                               SpillParameters parameters)
+    : file_prefix_(std::move(file_prefix)), parameters_(std::move(parameters)),
+      padding_(record_alignment, 0) {
+  thread_ = std::thread(&TimesliceSpill::work, this);
+}
+
+TimesliceSpill::~TimesliceSpill() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  not_empty_.notify_one();
+  thread_.join();
+  if (writer_) {
+    close_file();
+  }
+  for (const auto& file : files_) {
+    std::remove(file_name(file.first).c_str());
+  }
+}
+
+uint64_t TimesliceSpill::record_size(const Request& request) {
+  uint64_t size = fles::TimesliceSpillRecord::data_offset(
+      static_cast<uint32_t>(request.desc.size()));
+  for (const auto& desc : request.desc) {
+    size += desc.size;
+  }
+  return padded_size(size);
+}
+
+bool TimesliceSpill::can_accept(uint64_t size) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return statistics_.live_size + queued_size_ + size <= parameters_.max_size;
+}
+
+void TimesliceSpill::submit(Request request) {
+  if (request.desc.size() != request.data.size()) {
+    throw std::invalid_argument("inconsistent spill request");
+  }
+  const uint64_t size = record_size(request);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queued_size_ += size;
+    queue_.push_back(std::move(request));
+  }
+  not_empty_.notify_one();
+}
+
+bool TimesliceSpill::try_pop(Result& result) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (results_.empty()) {
+    return false;
+  }
+  result = results_.front();
+  results_.pop_front();
+  return true;
+}
+
+void TimesliceSpill::release(uint32_t file, uint64_t size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = files_.find(file);
+  if (it == files_.end() || it->second.records == 0) {
+    return;
+  }
+  --it->second.records;
+  statistics_.live_size -= padded_size(size);
+  remove_if_done(file);
+}
+
+std::string TimesliceSpill::file_name(uint32_t file) const {
+  return file_prefix_ + ".spill." + std::to_string(file);
+}
+
+TimesliceSpill::Statistics TimesliceSpill::statistics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return statistics_;
+}
+
+void TimesliceSpill::work() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    not_empty_.wait(lock, [this] { return stopped_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      return;
+    }
+    const Request request = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+    const Result result = write(request);
+    lock.lock();
+    const uint64_t size = record_size(request);
+    queued_size_ -= size;
+    if (result.written) {
+      ++files_[result.file].records;
+      ++statistics_.timeslices;
+      statistics_.bytes += size;
+      statistics_.live_size += size;
+    } else {
+      ++statistics_.failed;
+    }
+    results_.push_back(result);
+  }
+}
+
+TimesliceSpill::Result TimesliceSpill::write(const Request& request) {
+  Result result;
+  result.ts_pos = request.ts_pos;
+  const auto num_components = static_cast<uint32_t>(request.desc.size());
+  const uint64_t data_offset =
+      fles::TimesliceSpillRecord::data_offset(num_components);
+  const uint64_t padded = record_size(request);
+
+  fles::TimesliceSpillRecordHeader header{};
+  header.magic = fles::TimesliceSpillRecordHeader::magic_value;
+  header.version = fles::TimesliceSpillRecordHeader::current_version;
+  header.num_components = num_components;
+  header.ts_desc = request.ts_desc;
+
+  // the component data follows the descriptors without gaps
+  std::vector<fles::TimesliceComponentDescriptor> desc = request.desc;
+  uint64_t offset = data_offset;
+  for (auto& d : desc) {
+    d.offset = offset;
+    offset += d.size;
+  }
+  header.size = offset;
+
+  auto put = [this](const void* data, uint64_t size) {
+    if (writer_->sputn(static_cast<const char*>(data),
+                       static_cast<std::streamsize>(size)) !=
+        static_cast<std::streamsize>(size)) {
+      throw std::runtime_error("short write to spill log \"" +
+                               file_name(current_file_) + "\"");
+    }
+  };
+
+  try {
+    if (writer_ && file_offset_ > 0 &&
+        file_offset_ + padded > parameters_.max_file_size) {
+      close_file();
+    }
+    if (!writer_) {
+      open_file();
+    }
+    put(&header, sizeof header);
+    put(desc.data(), desc.size() * sizeof(desc[0]));
+    for (uint32_t c = 0; c < num_components; ++c) {
+      put(request.data[c], desc[c].size);
+    }
+    put(padding_.data(), padded - header.size);
+    // the record is handed on only once it is on storage
+    writer_->flush();
+  } catch (const std::exception& e) {
+    L_(error) << "timeslice spill: " << e.what();
+    if (writer_) {
+      close_file();
+    }
+    return result;
+  }
+
+  result.written = true;
+  result.file = current_file_;
+  result.offset = file_offset_;
+  result.size = header.size;
+  file_offset_ += padded;
+  return result;
+}
+
+void TimesliceSpill::open_file() {
+  uint32_t file = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    file = statistics_.files;
+  }
+  writer_ =
+      std::make_unique<fles::DirectFileBuffer>(file_name(file), parameters_.io);
+  current_file_ = file;
+  file_offset_ = 0;
+  std::lock_guard<std::mutex> lock(mutex_);
+  files_[file] = File();
+  ++statistics_.files;
+}
+
+void TimesliceSpill::close_file() {
+  try {
+    writer_->close();
+  } catch (const std::exception& e) {
+    // the records flushed before remain readable
+    L_(error) << "timeslice spill: " << e.what();
+  }
+  writer_ = nullptr;
+  std::lock_guard<std::mutex> lock(mutex_);
+  files_[current_file_].closed = true;
+  remove_if_done(current_file_);
+}
+
+void TimesliceSpill::remove_if_done(uint32_t file) {
+  auto it = files_.find(file);
+  if (it != files_.end() && it->second.closed && it->second.records == 0) {
+    std::remove(file_name(file).c_str());
+    files_.erase(it);
+  }
+}
@@ -0,0 +1,163 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the TimesliceSpill class.
+#pragma once
+
+#include "DirectFileBuffer.hpp"
+#include "TimesliceComponentDescriptor.hpp"
+#include "TimesliceDescriptor.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Configuration of the spilling of timeslices to local storage.
+struct SpillParameters {
+  /// Directory of the spill log files
+  std::string directory;
+  /// Buffer fill level at which to start spilling
+  double high_water = 0.75;
+  /// Buffer fill level at which to stop spilling
+  double low_water = 0.5;
+  /// Size of a log file at which to start the next one in bytes
+  uint64_t max_file_size = UINT64_C(1) << 30;
+  /// Maximum size of the spilled timeslices not yet completed in bytes
+  uint64_t max_size = UINT64_C(64) << 30;
+  /// Parameters of the file writer
+  fles::DirectIoParameters io;
+};
+
+/**
+ * \brief The TimesliceSpill class writes timeslices to log files on local
+ * storage on a background thread.
+ *
+ * The records (see fles::TimesliceSpillRecordHeader) are appended to log
+ * files named "<prefix>.spill.<n>" through a fles::DirectFileBuffer. The
+ * component data of a submitted timeslice is read from the given pointers
+ * on the background thread, so it has to stay in place until the result has
+ * been retrieved by try_pop(). Results are retrieved in the order of
+ * submission once the record is on storage. A log file is removed once the
+ * writer has moved on to the next one and all of its records have been
+ * released.
+ */
+class TimesliceSpill {
+public:
+  /// A timeslice to be written.
+  struct Request {
+    uint64_t ts_pos = 0;                 ///< Buffer position
+    fles::TimesliceDescriptor ts_desc{}; ///< Timeslice descriptor
+    /// Component descriptors (the offsets are ignored)
+    std::vector<fles::TimesliceComponentDescriptor> desc;
+    std::vector<const uint8_t*> data; ///< Component data
+  };
+
+  /// The outcome of writing a timeslice.
+  struct Result {
+    uint64_t ts_pos = 0;  ///< Buffer position
+    bool written = false; ///< Whether the record is on storage
+    uint32_t file = 0;    ///< Number of the log file
+    uint64_t offset = 0;  ///< Offset of the record in the file
+    uint64_t size = 0;    ///< Size of the record without padding
+  };
+
+  /// Spill statistics.
+  struct Statistics {
+    uint64_t timeslices = 0; ///< Number of timeslices written
+    uint64_t bytes = 0;      ///< Number of record bytes written
+    uint64_t failed = 0;     ///< Number of timeslices not written
+    uint32_t files = 0;      ///< Number of log files opened
+    uint64_t live_size = 0;  ///< Size of the records not yet released
+  };
+
+  /// Construct a spill writer and start its thread.
+  /**
+     \param file_prefix Path prefix of the log files
+     \param parameters  Spill configuration
+   */
+  TimesliceSpill(std::string file_prefix, SpillParameters parameters);
+
+  /// Delete copy constructor (non-copyable).
+  TimesliceSpill(const TimesliceSpill&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const TimesliceSpill&) = delete;
+
+  /// Stop the thread after writing the queued timeslices and remove all log
+  /// files.
+  ~TimesliceSpill();
+
+  /// Retrieve the size of the record of a timeslice including padding.
+  [[nodiscard]] static uint64_t record_size(const Request& request);
+
+  /// Check whether a record of the given size fits in the configured
+  /// maximum size.
+  [[nodiscard]] bool can_accept(uint64_t size) const;
+
+  /// Queue a timeslice to be written.
+  void submit(Request request);
+
+  /// Retrieve the result of the oldest submitted timeslice, if available.
+  [[nodiscard]] bool try_pop(Result& result);
+
+  /// Release a record once the timeslice has been completed.
+  void release(uint32_t file, uint64_t size);
+
+  /// Retrieve the path of a log file.
+  [[nodiscard]] std::string file_name(uint32_t file) const;
+
+  /// Retrieve the spill statistics.
+  [[nodiscard]] Statistics statistics() const;
+
+  /// Retrieve the configuration.
+  [[nodiscard]] const SpillParameters& parameters() const {
+    return parameters_;
+  }
+
+private:
+  /// State of a log file.
+  struct File {
+    uint64_t records = 0; ///< Number of records not yet released
+    bool closed = false;  ///< Whether the writer has moved on
+  };
+
+  void work();
+
+  /// Write a record, return its result (from the thread).
+  Result write(const Request& request);
+
+  /// Start the next log file (from the thread).
+  void open_file();
+
+  /// Close the current log file (from the thread).
+  void close_file();
+
+  /// Remove a log file if it is closed and has no records left (with the
+  /// mutex held).
+  void remove_if_done(uint32_t file);
+
+  std::string file_prefix_;
+  SpillParameters parameters_;
+
+  /// Writer of the current log file (used by the thread only)
+  std::unique_ptr<fles::DirectFileBuffer> writer_;
+  uint32_t current_file_ = 0;
+  uint64_t file_offset_ = 0;
+  std::vector<uint8_t> padding_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::deque<Request> queue_;
+  std::deque<Result> results_;
+  std::map<uint32_t, File> files_;
+  uint64_t queued_size_ = 0;
+  Statistics statistics_;
+  bool stopped_ = false;
+
+  std::thread thread_;
+};
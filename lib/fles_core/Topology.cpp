@@ -0,0 +1,201 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "Topology.hpp"
+#include <arpa/inet.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <cstring>
+#include <fstream>
+#include <ifaddrs.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <utility>
+
+namespace {
+
+std::string read_line(const std::string& filename) {
+  std::ifstream file(filename);
+  std::string line;
+  std::getline(file, line);
+  return line;
+}
+
+bool same_address(const sockaddr* a, const sockaddr* b) {
+  if (a->sa_family != b->sa_family) {
+    return false;
+  }
+  if (a->sa_family == AF_INET) {
+    return reinterpret_cast<const sockaddr_in*>(a)->sin_addr.s_addr ==
+           reinterpret_cast<const sockaddr_in*>(b)->sin_addr.s_addr;
+  }
+  if (a->sa_family == AF_INET6) {
+    return std::memcmp(&reinterpret_cast<const sockaddr_in6*>(a)->sin6_addr,
+                       &reinterpret_cast<const sockaddr_in6*>(b)->sin6_addr,
+                       sizeof(in6_addr)) == 0;
+  }
+  return false;
+}
+
+} // namespace
+
+std::vector<int> parse_cpu_list(const std::string& str) {
+  std::vector<int> cpus;
+  std::vector<std::string> ranges;
+  const std::string trimmed = boost::trim_copy(str);
+  if (trimmed.empty()) {
+    return cpus;
+  }
+  boost::split(ranges, trimmed, boost::is_any_of(","));
+  for (const auto& range : ranges) {
+    const auto dash = range.find('-');
+    std::size_t pos = 0;
+    try {
+      const int first = std::stoi(range.substr(0, dash), &pos);
+      if (pos != std::min(dash, range.size())) {
+        throw std::invalid_argument(range);
+      }
+      int last = first;
+      if (dash != std::string::npos) {
+        const std::string tail = range.substr(dash + 1);
+        last = std::stoi(tail, &pos);
+        if (pos != tail.size()) {
+          throw std::invalid_argument(range);
+        }
+      }
+      if (first < 0 || last < first) {
+        throw std::invalid_argument(range);
+      }
+      for (int cpu = first; cpu <= last; ++cpu) {
+        cpus.push_back(cpu);
+      }
+    } catch (const std::logic_error&) {
+      throw std::invalid_argument("invalid CPU list: " + str);
+    }
+  }
+  return cpus;
+}
+
+std::string format_cpu_list(const std::vector<int>& cpus) {
+  std::string str;
+  for (std::size_t i = 0; i < cpus.size();) {
+    std::size_t j = i;
+    while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+      ++j;
+    }
+    if (!str.empty()) {
+      str += ",";
+    }
+    str += std::to_string(cpus[i]);
+    if (j != i) {
+      str += "-" + std::to_string(cpus[j]);
+    }
+    i = j + 1;
+  }
+  return str;
+}
+
+std::map<int, std::vector<int>> node_cpus() {
+  namespace fs = boost::filesystem;
+  std::map<int, std::vector<int>> nodes;
+  const fs::path node_dir("/sys/devices/system/node");
+  boost::system::error_code ec;
+  for (fs::directory_iterator it(node_dir, ec), end; !ec && it != end;
+       it.increment(ec)) {
+    const std::string name = it->path().filename().string();
+    if (name.rfind("node", 0) != 0 || name.size() == 4 ||
+        name.find_first_not_of("0123456789", 4) != std::string::npos) {
+      continue;
+    }
+    auto cpus = parse_cpu_list(read_line((it->path() / "cpulist").string()));
+    if (!cpus.empty()) {
+      nodes[std::stoi(name.substr(4))] = std::move(cpus);
+    }
+  }
+  if (nodes.empty()) {
+    nodes[0] = parse_cpu_list(read_line("/sys/devices/system/cpu/online"));
+  }
+  return nodes;
+}
+
+int interface_numa_node(const std::string& host) {
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  addrinfo* addresses = nullptr;
+  if (getaddrinfo(host.c_str(), nullptr, &hints, &addresses) != 0) {
+    return -1;
+  }
+  ifaddrs* interfaces = nullptr;
+  if (getifaddrs(&interfaces) != 0) {
+    freeaddrinfo(addresses);
+    return -1;
+  }
+
+  std::string interface;
+  for (ifaddrs* i = interfaces; i != nullptr && interface.empty();
+       i = i->ifa_next) {
+    if (i->ifa_addr == nullptr) {
+      continue;
+    }
+    for (addrinfo* a = addresses; a != nullptr; a = a->ai_next) {
+      if (same_address(i->ifa_addr, a->ai_addr)) {
+        interface = i->ifa_name;
+        break;
+      }
+    }
+  }
+  freeifaddrs(interfaces);
+  freeaddrinfo(addresses);
+
+  if (interface.empty()) {
+    return -1;
+  }
+  // virtual interfaces (e.g., loopback) have no device link
+  const std::string node =
+      read_line("/sys/class/net/" + interface + "/device/numa_node");
+  try {
+    return node.empty() ? -1 : std::stoi(node);
+  } catch (const std::logic_error&) {
+    return -1;
+  }
+}
+
+CorePlacement::CorePlacement(std::map<int, std::vector<int>> node_cpus,
+                             const std::vector<int>& reserved)
+    : node_cpus_(std::move(node_cpus)), used_(reserved.begin(), reserved.end()) {
+}
+
+std::vector<int> CorePlacement::assign(int node, std::size_t count) {
+  std::vector<int> cpus;
+  auto take_from = [this, &cpus, count](const std::vector<int>& candidates) {
+    for (int cpu : candidates) {
+      if (cpus.size() == count) {
+        return;
+      }
+      if (used_.insert(cpu).second) {
+        cpus.push_back(cpu);
+      }
+    }
+  };
+  auto it = node_cpus_.find(node);
+  if (it != node_cpus_.end()) {
+    take_from(it->second);
+  }
+  for (const auto& [other_node, candidates] : node_cpus_) {
+    take_from(candidates);
+  }
+  return cpus;
+}
+
+int CorePlacement::node_of(int cpu) const {
+  for (const auto& [node, cpus] : node_cpus_) {
+    for (int c : cpus) {
+      if (c == cpu) {
+        return node;
+      }
+    }
+  }
+  return -1;
+}
@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines functions to query the machine topology and the
+/// CorePlacement class.
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+/// Parse a Linux CPU list (e.g., "0-3,8,10-11").
+/**
+   \throws std::invalid_argument if the list is malformed
+*/
+std::vector<int> parse_cpu_list(const std::string& str);
+
+/// Format a CPU list in the Linux notation.
+std::string format_cpu_list(const std::vector<int>& cpus);
+
+/// Retrieve the online CPUs of each NUMA node from sysfs.
+/** On machines without NUMA information, all online CPUs are assigned to
+    node 0. */
+std::map<int, std::vector<int>> node_cpus();
+
+/// Retrieve the NUMA node of the network interface that carries the given
+/// local host name or address, or -1 if unknown.
+int interface_numa_node(const std::string& host);
+
+/// Assignment of dedicated CPU cores to threads.
+/** Each assigned core is used only once. Cores are preferably taken from
+    the requested NUMA node. If that node has no more free cores, or if the
+    node is unknown, the next free core of any node is used. The reserved
+    (housekeeping) cores are never assigned. */
+class CorePlacement {
+public:
+  CorePlacement(std::map<int, std::vector<int>> node_cpus,
+                const std::vector<int>& reserved);
+
+  /// Assign the given number of cores close to a node.
+  /**
+     \return The assigned cores, fewer if not enough are available
+  */
+  std::vector<int> assign(int node, std::size_t count = 1);
+
+  /// Retrieve the NUMA node of a core, or -1 if unknown.
+  [[nodiscard]] int node_of(int cpu) const;
+
+private:
+  std::map<int, std::vector<int>> node_cpus_;
+  std::set<int> used_;
+};
@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the WorkerPool class.
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * \brief A fixed set of worker threads executing submitted tasks.
+ *
+ * Tasks are executed in submission order by the next idle worker. The
+ * destructor completes all pending tasks before joining the workers.
+ */
+class WorkerPool {
+public:
+  /// Construct a pool with a given number of worker threads.
+  explicit WorkerPool(unsigned threads) {
+    for (unsigned i = 0; i < threads; ++i) {
+      workers_.emplace_back(&WorkerPool::work, this);
+    }
+  }
+
+  WorkerPool(const WorkerPool&) = delete;
+  void operator=(const WorkerPool&) = delete;
+
+  ~WorkerPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopped_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  /// Retrieve the number of worker threads.
+  [[nodiscard]] std::size_t size() const { return workers_.size(); }
+
+  /// Submit a task, the future reports its completion (or exception).
+  std::future<void> submit(std::function<void()> function) {
+    std::packaged_task<void()> task(std::move(function));
+    std::future<void> future = task.get_future();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+    return future;
+  }
+
+private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::packaged_task<void()>> tasks_;
+  bool stopped_ = false;
+  std::vector<std::thread> workers_;
+
+  void work() {
+    while (true) {
+      std::packaged_task<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return stopped_ || !tasks_.empty(); });
+        if (tasks_.empty()) {
+          return;
+        }
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+      task();
+    }
+  }
+};
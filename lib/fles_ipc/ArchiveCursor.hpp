@@ -0,0 +1,126 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::ArchiveCursor class.
+#pragma once
+
+#include "ArchiveDescriptor.hpp"
+#include "MappedFile.hpp"
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace fles {
+
+/// Exception thrown if data is missing at the end of the mapped file.
+class TruncatedArchive : public std::runtime_error {
+public:
+  TruncatedArchive() : std::runtime_error("truncated archive") {}
+};
+
+/**
+ * \brief Minimal reader for the primitive types of the boost binary archive
+ * format (library versions > 7) in a mapped memory region.
+ */
+class ArchiveCursor {
+public:
+  ArchiveCursor(const MappedFile& file, uint64_t offset)
+      : ArchiveCursor(file.data(), file.size(), offset) {}
+
+  ArchiveCursor(const uint8_t* data, uint64_t size, uint64_t offset)
+      : begin_(data), end_(data + size), pos_(data + offset) {}
+
+  template <typename T> T read() {
+    T value;
+    std::memcpy(&value, skip(sizeof(T)), sizeof(T));
+    return value;
+  }
+
+  const uint8_t* skip(uint64_t size) {
+    if (static_cast<uint64_t>(end_ - pos_) < size) {
+      throw TruncatedArchive();
+    }
+    const uint8_t* p = pos_;
+    pos_ += size;
+    return p;
+  }
+
+  std::string read_string() {
+    auto size = read<uint64_t>();
+    const auto* p = reinterpret_cast<const char*>(skip(size));
+    return {p, size};
+  }
+
+  /// Read the class info preceding the first object of a class, return the
+  /// class version.
+  uint32_t read_class_info() {
+    read<uint8_t>(); // tracking level
+    return read<uint32_t>();
+  }
+
+  /// Read the boost archive header and the archive descriptor at the start
+  /// of an archive file.
+  ArchiveDescriptor read_archive_descriptor(const std::string& filename) {
+    ArchiveDescriptor descriptor;
+    try {
+      // boost binary archive header
+      if (read_string() != "serialization::archive") {
+        throw std::runtime_error("File \"" + filename +
+                                 "\" is not a binary archive");
+      }
+      auto library_version = read<uint16_t>();
+      if (library_version <= 7) {
+        throw std::runtime_error("File \"" + filename +
+                                 "\" uses an unsupported archive version");
+      }
+      auto size_int = read<uint8_t>();
+      auto size_long = read<uint8_t>();
+      auto size_float = read<uint8_t>();
+      auto size_double = read<uint8_t>();
+      auto endianness = read<int32_t>();
+      if (size_int != sizeof(int) || size_long != sizeof(long) ||
+          size_float != sizeof(float) || size_double != sizeof(double) ||
+          endianness != 1) {
+        throw std::runtime_error("File \"" + filename +
+                                 "\" was written on an incompatible platform");
+      }
+
+      // archive descriptor
+      uint32_t version = read_class_info();
+      descriptor.archive_type_ =
+          version > 0 ? static_cast<ArchiveType>(read<int32_t>())
+                      : ArchiveType::TimesliceArchive;
+      descriptor.archive_compression_ =
+          version > 1 ? static_cast<ArchiveCompression>(read<int32_t>())
+                      : ArchiveCompression::None;
+      descriptor.descriptor_encoding_ =
+          version > 2 ? static_cast<DescriptorEncoding>(read<int32_t>())
+                      : DescriptorEncoding::Verbatim;
+      descriptor.time_created_ = read<int64_t>();
+      descriptor.hostname_ = read_string();
+      descriptor.username_ = read_string();
+      if (version > 3) {
+        auto count = read<uint32_t>();
+        for (uint32_t i = 0; i < count; ++i) {
+          auto key = read<uint16_t>();
+          descriptor.dictionaries_[key] = read_string();
+        }
+      }
+    } catch (const TruncatedArchive&) {
+      throw std::runtime_error("File \"" + filename +
+                               "\" is not a valid archive file");
+    }
+    return descriptor;
+  }
+
+  [[nodiscard]] bool at_end() const { return pos_ == end_; }
+  [[nodiscard]] uint64_t offset() const { return pos_ - begin_; }
+
+private:
+  const uint8_t* begin_;
+  const uint8_t* end_;
+  const uint8_t* pos_;
+};
+
+} // namespace fles
@@ -7,7 +7,10 @@
 #include <boost/serialization/access.hpp>
 #include <boost/serialization/version.hpp>
 #include <chrono>
+#include <cstdint>
+#include <map>
 #include <string>
+#include <utility>
 
 namespace fles {
 
@@ -15,12 +18,16 @@ namespace fles {
 enum class ArchiveType {
   TimesliceArchive,
   MicrosliceArchive,
-  RecoResultsArchive
+  RecoResultsArchive,
+  ChunkedTimesliceArchive
 };
 
 /// The archive compression enum
 enum class ArchiveCompression { None, Zstd };
 
+/// The microslice descriptor encoding enum (see DescriptorCodec)
+enum class DescriptorEncoding { Verbatim, Compact };
+
 template <class Base, class Derived, ArchiveType archive_type>
 class InputArchive;
 
@@ -37,11 +44,14 @@ public:
    *
    * \param archive_type The type of archive (e.g., timeslice, microslice).
    * \param archive_compression archive_compression.
+   * \param descriptor_encoding Encoding of the microslice descriptors.
    */
   explicit ArchiveDescriptor(
       ArchiveType archive_type,
-      ArchiveCompression archive_compression = ArchiveCompression::None)
-      : archive_type_(archive_type), archive_compression_(archive_compression) {
+      ArchiveCompression archive_compression = ArchiveCompression::None,
+      DescriptorEncoding descriptor_encoding = DescriptorEncoding::Verbatim)
+      : archive_type_(archive_type), archive_compression_(archive_compression),
+        descriptor_encoding_(descriptor_encoding) {
     time_created_ =
         std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
     hostname_ = fles::system::current_hostname();
@@ -56,6 +66,11 @@ public:
     return archive_compression_;
   }
 
+  /// Retrieve the encoding of the microslice descriptors in the archive.
+  [[nodiscard]] DescriptorEncoding descriptor_encoding() const {
+    return descriptor_encoding_;
+  }
+
   /// Retrieve the time of creation of the archive.
   [[nodiscard]] std::time_t time_created() const { return time_created_; }
 
@@ -65,6 +80,18 @@ public:
   /// Retrieve the hostname of the machine creating the archive.
   [[nodiscard]] std::string username() const { return username_; }
 
+  /// Retrieve the zstd dictionaries of the component chunks, keyed by
+  /// sys_id << 8 | sys_ver (chunked timeslice archives only, see
+  /// ZstdDictionary.hpp).
+  [[nodiscard]] const std::map<uint16_t, std::string>& dictionaries() const {
+    return dictionaries_;
+  }
+
+  /// Set the zstd dictionaries of the component chunks.
+  void set_dictionaries(std::map<uint16_t, std::string> dictionaries) {
+    dictionaries_ = std::move(dictionaries);
+  }
+
 private:
   friend class boost::serialization::access;
   /// Provide boost serialization access.
@@ -74,6 +101,10 @@ private:
   friend class InputArchiveLoop;
   template <class Base, class Derived, ArchiveType archive_type>
   friend class InputArchiveSequence;
+  friend class ArchiveCursor;
+  friend class TimesliceMappedArchive;
+  friend class TimesliceIndexedInputArchive;
+  friend class ChunkedTimesliceInputArchive;
 
   ArchiveDescriptor() = default;
 
@@ -89,21 +120,55 @@ private:
     } else {
       archive_compression_ = ArchiveCompression::None;
     };
+    if (version > 2) {
+      ar& descriptor_encoding_;
+    } else {
+      descriptor_encoding_ = DescriptorEncoding::Verbatim;
+    };
     ar& time_created_;
     ar& hostname_;
     ar& username_;
+    if (version > 3) {
+      serialize_dictionaries(ar);
+    } else {
+      dictionaries_.clear();
+    }
+  }
+
+  // The dictionaries are stored as primitives to be readable by
+  // ArchiveCursor
+  template <class Archive> void serialize_dictionaries(Archive& ar) {
+    auto count = static_cast<uint32_t>(dictionaries_.size());
+    ar& count;
+    if constexpr (Archive::is_saving::value) {
+      for (const auto& [key, content] : dictionaries_) {
+        ar& key;
+        ar& content;
+      }
+    } else {
+      dictionaries_.clear();
+      for (uint32_t i = 0; i < count; ++i) {
+        uint16_t key = 0;
+        std::string content;
+        ar& key;
+        ar& content;
+        dictionaries_[key] = std::move(content);
+      }
+    }
   }
 
   ArchiveType archive_type_{};
   ArchiveCompression archive_compression_{};
+  DescriptorEncoding descriptor_encoding_{};
   std::time_t time_created_ = std::time_t();
   std::string hostname_;
   std::string username_;
+  std::map<uint16_t, std::string> dictionaries_;
 };
 
 } // namespace fles
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wold-style-cast"
-BOOST_CLASS_VERSION(fles::ArchiveDescriptor, 2)
+BOOST_CLASS_VERSION(fles::ArchiveDescriptor, 4)
 #pragma GCC diagnostic pop
@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "ArchiveIndex.hpp"
+#include "RemoteStream.hpp"
+#include "Timeslice.hpp"
+#include <algorithm>
+#include <ios>
+#include <iterator>
+#include <stdexcept>
+
+namespace fles {
+
+namespace {
+
+void write_header(std::ostream& os) {
+  os.write(ArchiveIndex::magic, sizeof(ArchiveIndex::magic));
+  uint32_t version = ArchiveIndex::format_version;
+  uint32_t entry_size = sizeof(ArchiveIndexEntry);
+  os.write(reinterpret_cast<const char*>(&version), sizeof(version));
+  os.write(reinterpret_cast<const char*>(&entry_size), sizeof(entry_size));
+}
+
+} // namespace
+
+ArchiveIndex ArchiveIndex::read(const std::string& filename) {
+  auto stream = open_input_stream(filename);
+  std::istream& ifs = *stream;
+  if (!ifs) {
+    throw std::ios_base::failure("error opening file \"" + filename + "\"");
+  }
+
+  char file_magic[sizeof(magic)];
+  uint32_t version = 0;
+  uint32_t entry_size = 0;
+  ifs.read(file_magic, sizeof(file_magic));
+  ifs.read(reinterpret_cast<char*>(&version), sizeof(version));
+  ifs.read(reinterpret_cast<char*>(&entry_size), sizeof(entry_size));
+  if (!ifs || !std::equal(std::begin(magic), std::end(magic), file_magic)) {
+    throw std::runtime_error("File \"" + filename +
+                             "\" is not an archive index file");
+  }
+  if (version != format_version || entry_size != sizeof(ArchiveIndexEntry)) {
+    throw std::runtime_error("Unsupported version of archive index file \"" +
+                             filename + "\"");
+  }
+
+  // An index written by an interrupted process may end in a partial entry,
+  // which is ignored.
+  ArchiveIndex index;
+  ArchiveIndexEntry entry{};
+  while (ifs.read(reinterpret_cast<char*>(&entry), sizeof(entry))) {
+    index.push_back(entry);
+  }
+  return index;
+}
+
+void ArchiveIndex::write(const std::string& filename) const {
+  std::ofstream ofs(filename, std::ios::binary);
+  if (!ofs) {
+    throw std::ios_base::failure("error opening file \"" + filename + "\"");
+  }
+  write_header(ofs);
+  ofs.write(reinterpret_cast<const char*>(entries_.data()),
+            static_cast<std::streamsize>(entries_.size() *
+                                         sizeof(ArchiveIndexEntry)));
+  if (!ofs) {
+    throw std::ios_base::failure("error writing file \"" + filename + "\"");
+  }
+}
+
+ArchiveIndexWriter::ArchiveIndexWriter(const std::string& filename)
+    : ofstream_(filename, std::ios::binary) {
+  if (!ofstream_) {
+    throw std::ios_base::failure("error opening file \"" + filename + "\"");
+  }
+  write_header(ofstream_);
+}
+
+void ArchiveIndexWriter::add(const Timeslice& timeslice,
+                             uint64_t offset,
+                             uint64_t size) {
+  add({timeslice.index(), offset, size, timeslice.start_time()});
+}
+
+void ArchiveIndexWriter::add(const ArchiveIndexEntry& entry) {
+  ofstream_.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+}
+
+} // namespace fles
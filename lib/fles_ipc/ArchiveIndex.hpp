@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::ArchiveIndex class and related types.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fles {
+
+class Timeslice;
+
+/**
+ * \brief %Archive index entry struct, locating a single timeslice in an
+ * uncompressed archive file.
+ */
+struct ArchiveIndexEntry {
+  /// Global index of the timeslice.
+  uint64_t index;
+
+  /// Byte offset of the serialized timeslice in the archive file.
+  uint64_t offset;
+
+  /// Size (in bytes) of the serialized timeslice.
+  uint64_t size;
+
+  /// Start time of the timeslice, cf. Timeslice::start_time().
+  uint64_t start_time;
+};
+
+/**
+ * \brief The ArchiveIndex class contains the random-access index of a
+ * timeslice archive file.
+ *
+ * The index is stored in a sidecar file next to the archive (see
+ * sidecar_filename()). It consists of a short header followed by a
+ * sequence of ArchiveIndexEntry structs in archive order.
+ */
+class ArchiveIndex {
+public:
+  /// Construct an empty index.
+  ArchiveIndex() = default;
+
+  /// Read the index from the given index file.
+  static ArchiveIndex read(const std::string& filename);
+
+  /// Write the index to the given index file.
+  void write(const std::string& filename) const;
+
+  /// Retrieve the name of the index sidecar file for a given archive file.
+  static std::string sidecar_filename(const std::string& archive_filename) {
+    return archive_filename + ".idx";
+  }
+
+  /// Append an entry to the index.
+  void push_back(const ArchiveIndexEntry& entry) { entries_.push_back(entry); }
+
+  /// Retrieve the index entries in archive order.
+  [[nodiscard]] const std::vector<ArchiveIndexEntry>& entries() const {
+    return entries_;
+  }
+
+  /// Retrieve the number of indexed timeslices.
+  [[nodiscard]] std::size_t size() const { return entries_.size(); }
+
+  /// Identification bytes at the start of every index file.
+  static constexpr char magic[8] = {'F', 'L', 'E', 'S', 'T', 'S', 'I', 'X'};
+
+  /// Version of the index file format.
+  static constexpr uint32_t format_version = 1;
+
+private:
+  std::vector<ArchiveIndexEntry> entries_;
+};
+
+/**
+ * \brief The ArchiveIndexWriter class writes an index sidecar file
+ * incrementally while the corresponding archive is written.
+ */
+class ArchiveIndexWriter {
+public:
+  /// Create the given index file and write the header.
+  explicit ArchiveIndexWriter(const std::string& filename);
+
+  /// Append the entry for a timeslice written at the given archive position.
+  void add(const Timeslice& timeslice, uint64_t offset, uint64_t size);
+
+  /// Append an entry.
+  void add(const ArchiveIndexEntry& entry);
+
+private:
+  std::ofstream ofstream_;
+};
+
+} // namespace fles
@@ -0,0 +1,196 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "ArchiveManifest.hpp"
+#include "ComponentFilter.hpp"
+#include "RemoteStream.hpp"
+#include "Timeslice.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <ios>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace fles {
+
+namespace {
+
+const std::string manifest_extension = ".manifest";
+
+std::string format_sys_ids(const std::set<uint8_t>& sys_ids) {
+  if (sys_ids.empty()) {
+    return "-";
+  }
+  std::ostringstream s;
+  s << std::hex;
+  for (auto it = sys_ids.begin(); it != sys_ids.end(); ++it) {
+    s << (it == sys_ids.begin() ? "" : ",") << static_cast<unsigned>(*it);
+  }
+  return s.str();
+}
+
+std::set<uint8_t> parse_sys_ids(const std::string& field) {
+  std::set<uint8_t> sys_ids;
+  if (field == "-") {
+    return sys_ids;
+  }
+  std::istringstream s(field);
+  std::string value;
+  while (std::getline(s, value, ',')) {
+    sys_ids.insert(static_cast<uint8_t>(std::stoul(value, nullptr, 16)));
+  }
+  return sys_ids;
+}
+
+ArchiveManifestEntry parse_entry(const std::string& line) {
+  std::vector<std::string> fields;
+  std::istringstream s(line);
+  std::string field;
+  while (std::getline(s, field, '\t')) {
+    fields.push_back(field);
+  }
+  if (fields.size() != 7) {
+    throw std::runtime_error("invalid manifest line: " + line);
+  }
+  ArchiveManifestEntry entry;
+  entry.writer = fields[0];
+  entry.filename = fields[1];
+  entry.first_index = std::stoull(fields[2]);
+  entry.last_index = std::stoull(fields[3]);
+  entry.num_timeslices = std::stoull(fields[4]);
+  entry.size = std::stoull(fields[5]);
+  entry.sys_ids = parse_sys_ids(fields[6]);
+  return entry;
+}
+
+// Path of a file relative to the directory of the manifest
+std::string manifest_relative(const std::string& filename,
+                              const std::string& manifest_filename) {
+  const auto directory =
+      std::filesystem::absolute(manifest_filename).parent_path();
+  return std::filesystem::absolute(filename)
+      .lexically_proximate(directory)
+      .string();
+}
+
+} // namespace
+
+ArchiveManifest ArchiveManifest::read(const std::string& filename) {
+  auto stream = open_input_stream(filename);
+  std::istream& ifs = *stream;
+  if (!ifs) {
+    throw std::ios_base::failure("error opening file \"" + filename + "\"");
+  }
+
+  const auto directory = std::filesystem::path(filename).parent_path();
+  ArchiveManifest manifest;
+  std::string line;
+  while (std::getline(ifs, line)) {
+    if (line.empty() || line.front() == '#') {
+      continue;
+    }
+    auto entry = parse_entry(line);
+    if (std::filesystem::path(entry.filename).is_relative()) {
+      entry.filename = (directory / entry.filename).string();
+    }
+    manifest.entries_.push_back(std::move(entry));
+  }
+  return manifest;
+}
+
+void ArchiveManifest::append(const std::string& filename,
+                             const ArchiveManifestEntry& entry) {
+  std::ostringstream s;
+  s << entry.writer << '\t' << entry.filename << '\t' << entry.first_index
+    << '\t' << entry.last_index << '\t' << entry.num_timeslices << '\t'
+    << entry.size << '\t' << format_sys_ids(entry.sys_ids) << '\n';
+  const std::string line = s.str();
+
+  // a single append is not interleaved with those of other writers
+  int fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC,
+                  0644);
+  if (fd < 0) {
+    throw std::ios_base::failure("error opening file \"" + filename +
+                                 "\": " + std::strerror(errno));
+  }
+  ssize_t result = ::write(fd, line.data(), line.size());
+  int error = errno;
+  ::close(fd);
+  if (result != static_cast<ssize_t>(line.size())) {
+    throw std::ios_base::failure(
+        "error writing file \"" + filename +
+        "\": " + (result < 0 ? std::strerror(error) : "short write"));
+  }
+}
+
+bool ArchiveManifest::is_manifest_filename(const std::string& filename) {
+  return filename.size() > manifest_extension.size() &&
+         filename.compare(filename.size() - manifest_extension.size(),
+                          std::string::npos, manifest_extension) == 0;
+}
+
+std::vector<std::vector<std::string>>
+ArchiveManifest::select(uint64_t first,
+                        uint64_t last,
+                        const ComponentFilter& filter) const {
+  std::vector<std::vector<std::string>> files;
+  std::map<std::string, std::size_t> writers;
+  for (const auto& entry : entries_) {
+    if (!entry.overlaps(first, last)) {
+      continue;
+    }
+    if (!filter.sys_ids.empty() &&
+        std::none_of(entry.sys_ids.begin(), entry.sys_ids.end(),
+                     [&](uint8_t sys_id) {
+                       return filter.sys_ids.count(sys_id) != 0;
+                     })) {
+      continue;
+    }
+    auto [it, inserted] = writers.emplace(entry.writer, files.size());
+    if (inserted) {
+      files.emplace_back();
+    }
+    files[it->second].push_back(entry.filename);
+  }
+  return files;
+}
+
+ArchiveManifestWriter::ArchiveManifestWriter(std::string manifest_filename,
+                                             std::string writer)
+    : manifest_filename_(std::move(manifest_filename)),
+      writer_(manifest_relative(writer, manifest_filename_)) {}
+
+void ArchiveManifestWriter::add(const Timeslice& timeslice) {
+  const uint64_t index = timeslice.index();
+  if (entry_.num_timeslices == 0) {
+    entry_.first_index = index;
+    entry_.last_index = index;
+  } else {
+    entry_.first_index = std::min(entry_.first_index, index);
+    entry_.last_index = std::max(entry_.last_index, index);
+  }
+  ++entry_.num_timeslices;
+  for (uint64_t c = 0; c < timeslice.num_components(); ++c) {
+    if (timeslice.num_microslices(c) > 0) {
+      entry_.sys_ids.insert(timeslice.descriptor(c, 0).sys_id);
+    }
+  }
+}
+
+ArchiveManifestEntry
+ArchiveManifestWriter::finish_file(const std::string& filename,
+                                   uint64_t size) {
+  ArchiveManifestEntry entry = std::move(entry_);
+  entry_ = ArchiveManifestEntry();
+  entry.writer = writer_;
+  entry.filename = manifest_relative(filename, manifest_filename_);
+  entry.size = size;
+  return entry;
+}
+
+} // namespace fles
@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::ArchiveManifest class and related types.
+#pragma once
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace fles {
+
+class ComponentFilter;
+class Timeslice;
+
+/**
+ * \brief %Archive manifest entry struct, describing a single archive file
+ * written by an archive sequence.
+ */
+struct ArchiveManifestEntry {
+  /// File name template of the writing archive sequence.
+  std::string writer;
+
+  /// Name of the archive file.
+  std::string filename;
+
+  /// Lowest timeslice index in the file.
+  uint64_t first_index = 0;
+
+  /// Highest timeslice index in the file.
+  uint64_t last_index = 0;
+
+  /// Number of timeslices in the file.
+  uint64_t num_timeslices = 0;
+
+  /// Size (in bytes) of the file.
+  uint64_t size = 0;
+
+  /// Subsystem identifiers of the components in the file.
+  std::set<uint8_t> sys_ids;
+
+  /// Check whether the file holds timeslices in the given index range.
+  [[nodiscard]] bool overlaps(uint64_t first, uint64_t last) const {
+    return first_index <= last && last_index >= first;
+  }
+};
+
+/**
+ * \brief The ArchiveManifest class contains the list of the archive files of
+ * a run.
+ *
+ * Every archive sequence writing with a manifest appends one line per
+ * completed file to the shared manifest file, so that the files needed for
+ * a range of timeslices can be found without opening any of them. The lines
+ * consist of the tab-separated fields of an ArchiveManifestEntry, the
+ * subsystem identifiers as a comma-separated list of hexadecimal numbers.
+ * File names are stored relative to the directory of the manifest. Each line
+ * is appended by a single write, so that writers on several nodes may share
+ * a manifest on a parallel file system.
+ */
+class ArchiveManifest {
+public:
+  /// Construct an empty manifest.
+  ArchiveManifest() = default;
+
+  /**
+   * \brief Read the given manifest file.
+   *
+   * The file names are resolved relative to the directory of the manifest.
+   *
+   * \throws std::ios_base::failure if the file cannot be read
+   * \throws std::runtime_error if the file contains an invalid line
+   */
+  static ArchiveManifest read(const std::string& filename);
+
+  /// Append an entry to the given manifest file.
+  static void append(const std::string& filename,
+                     const ArchiveManifestEntry& entry);
+
+  /// Check whether a file name denotes a manifest (extension ".manifest").
+  static bool is_manifest_filename(const std::string& filename);
+
+  /// Retrieve the entries in manifest order.
+  [[nodiscard]] const std::vector<ArchiveManifestEntry>& entries() const {
+    return entries_;
+  }
+
+  /**
+   * \brief Select the archive files holding timeslices in the given index
+   * range.
+   *
+   * If the filter restricts the subsystem identifiers, files without any of
+   * the selected subsystems are skipped as well.
+   *
+   * \return the selected file names per writer in file order, the writers in
+   * order of their first entry
+   */
+  [[nodiscard]] std::vector<std::vector<std::string>>
+  select(uint64_t first, uint64_t last, const ComponentFilter& filter) const;
+
+private:
+  std::vector<ArchiveManifestEntry> entries_;
+};
+
+/**
+ * \brief The ArchiveManifestWriter class collects the manifest entries of
+ * the files of an archive sequence while they are written.
+ */
+class ArchiveManifestWriter {
+public:
+  /// Construct a writer for the given manifest file and writer template.
+  ArchiveManifestWriter(std::string manifest_filename, std::string writer);
+
+  /// Account for a timeslice written to the current file.
+  void add(const Timeslice& timeslice);
+
+  /// Retrieve the name of the manifest file.
+  [[nodiscard]] const std::string& manifest_filename() const {
+    return manifest_filename_;
+  }
+
+  /**
+   * \brief Complete the entry of the current file and start a new one.
+   *
+   * The entry is to be appended to the manifest (see
+   * ArchiveManifest::append()) once the file is closed, unless it holds no
+   * timeslices.
+   */
+  ArchiveManifestEntry finish_file(const std::string& filename,
+                                   uint64_t size);
+
+private:
+  std::string manifest_filename_;
+  std::string writer_;
+  ArchiveManifestEntry entry_;
+};
+
+} // namespace fles
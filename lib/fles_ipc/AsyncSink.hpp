@@ -0,0 +1,207 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::AsyncSink template class.
+#pragma once
+
+#include "Sink.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace fles {
+
+/// Behavior of an AsyncSink receiving an item while its queue is full.
+enum class OverflowPolicy {
+  Block, ///< Wait for the sink to catch up (lossless)
+  Drop,  ///< Discard the new item
+  Sample ///< Discard the oldest queued item, keeping the most recent ones
+};
+
+/// Parse an overflow policy name ("block", "drop", or "sample").
+inline OverflowPolicy parse_overflow_policy(const std::string& name) {
+  if (name == "block") {
+    return OverflowPolicy::Block;
+  }
+  if (name == "drop") {
+    return OverflowPolicy::Drop;
+  }
+  if (name == "sample") {
+    return OverflowPolicy::Sample;
+  }
+  throw std::invalid_argument("invalid overflow policy: " + name);
+}
+
+/**
+ * \brief The AsyncSink class passes items to a given sink on a background
+ * thread, so that a slow sink delays neither the source nor other sinks.
+ *
+ * Items are kept in a bounded queue. If the queue is full, put() blocks,
+ * discards the new item, or discards the oldest queued item, depending on
+ * the overflow policy. The latter makes the wrapped sink see a sample of the
+ * stream at the pace it can sustain. Exceptions thrown by the wrapped sink
+ * are rethrown by the next call to put(), flush(), or end_stream(); further
+ * items are discarded.
+ */
+template <class T> class AsyncSink : public Sink<T> {
+public:
+  /// Queue statistics, accumulated since the last reset.
+  struct Statistics {
+    /// Number of items passed to the wrapped sink.
+    uint64_t count = 0;
+    /// Number of items discarded due to overflow.
+    uint64_t dropped = 0;
+    /// Current number of queued items.
+    std::size_t queue_depth = 0;
+    /// Largest number of queued items.
+    std::size_t max_queue_depth = 0;
+  };
+
+  /**
+   * \brief Construct an asynchronous sink object and start its thread.
+   *
+   * \param sink     The sink to pass the items to
+   * \param capacity Maximum number of queued items
+   * \param policy   Behavior if the queue is full
+   */
+  AsyncSink(std::unique_ptr<Sink<T>> sink,
+            std::size_t capacity,
+            OverflowPolicy policy = OverflowPolicy::Block)
+      : sink_(std::move(sink)), capacity_(capacity == 0 ? 1 : capacity),
+        policy_(policy) {
+    thread_ = std::thread(&AsyncSink::work, this);
+  }
+
+  /// Delete copy constructor (non-copyable).
+  AsyncSink(const AsyncSink&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const AsyncSink&) = delete;
+
+  /// Pass all queued items to the wrapped sink and stop the thread.
+  ~AsyncSink() override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopped_ = true;
+    }
+    not_empty_.notify_one();
+    thread_.join();
+  }
+
+  void put(std::shared_ptr<const T> item) override {
+    std::unique_lock<std::mutex> lock(mutex_);
+    rethrow();
+    if (policy_ == OverflowPolicy::Block) {
+      not_full_.wait(lock, [this] { return queue_.size() < capacity_; });
+      rethrow();
+    } else if (queue_.size() >= capacity_) {
+      ++statistics_.dropped;
+      if (policy_ == OverflowPolicy::Drop) {
+        return;
+      }
+      queue_.pop_front();
+    }
+    queue_.push_back(std::move(item));
+    statistics_.max_queue_depth =
+        std::max(statistics_.max_queue_depth, queue_.size());
+    not_empty_.notify_one();
+  }
+
+  /// Pass all queued items to the wrapped sink, then signal the end of the
+  /// stream to it.
+  void end_stream() override {
+    flush();
+    sink_->end_stream();
+  }
+
+  /// Wait until all queued items have been passed to the wrapped sink.
+  void flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this] { return queue_.empty() && !busy_; });
+    rethrow();
+  }
+
+  /// Retrieve the wrapped sink. Call flush() before accessing it.
+  Sink<T>& sink() { return *sink_; }
+
+  /// Retrieve the queue statistics.
+  [[nodiscard]] Statistics statistics() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Statistics stats = statistics_;
+    stats.queue_depth = queue_.size();
+    return stats;
+  }
+
+  /// Reset the queue statistics.
+  void reset_statistics() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    statistics_ = Statistics();
+    statistics_.max_queue_depth = queue_.size();
+  }
+
+private:
+  std::unique_ptr<Sink<T>> sink_;
+  std::size_t capacity_;
+  OverflowPolicy policy_;
+
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::condition_variable idle_;
+  std::deque<std::shared_ptr<const T>> queue_;
+  Statistics statistics_;
+  bool busy_ = false;
+  bool stopped_ = false;
+  bool failed_ = false;
+  std::exception_ptr exception_;
+  std::thread thread_;
+
+  /// Rethrow a pending exception of the wrapped sink (once).
+  void rethrow() {
+    if (exception_) {
+      std::rethrow_exception(std::exchange(exception_, nullptr));
+    }
+  }
+
+  void work() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      not_empty_.wait(lock, [this] { return stopped_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      auto item = std::move(queue_.front());
+      queue_.pop_front();
+      not_full_.notify_one();
+      if (failed_) {
+        ++statistics_.dropped;
+      } else {
+        busy_ = true;
+        lock.unlock();
+        try {
+          sink_->put(std::move(item));
+          lock.lock();
+          ++statistics_.count;
+        } catch (...) {
+          lock.lock();
+          exception_ = std::current_exception();
+          failed_ = true;
+        }
+        busy_ = false;
+      }
+      if (queue_.empty()) {
+        idle_.notify_all();
+      }
+    }
+  }
+};
+
+} // namespace fles
@@ -0,0 +1,257 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "ByteShuffle.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__)
+#define BYTE_SHUFFLE_X86 1
+#include <immintrin.h>
+#endif
+
+namespace fles {
+
+namespace {
+
+// Elements per vectorized block
+constexpr std::size_t block = 16;
+
+// Transpose elements [begin, count) of src into the count-sized streams
+void shuffle_tail(const uint8_t* src,
+                  uint8_t* dst,
+                  std::size_t begin,
+                  std::size_t count,
+                  std::size_t width) {
+  for (std::size_t e = begin; e < count; ++e) {
+    for (std::size_t k = 0; k < width; ++k) {
+      dst[k * count + e] = src[e * width + k];
+    }
+  }
+}
+
+void unshuffle_tail(const uint8_t* src,
+                    uint8_t* dst,
+                    std::size_t begin,
+                    std::size_t count,
+                    std::size_t width) {
+  for (std::size_t e = begin; e < count; ++e) {
+    for (std::size_t k = 0; k < width; ++k) {
+      dst[e * width + k] = src[k * count + e];
+    }
+  }
+}
+
+#ifdef BYTE_SHUFFLE_X86
+bool has_ssse3() {
+  static const bool supported = __builtin_cpu_supports("ssse3") != 0;
+  return supported;
+}
+
+// Transpose the 4x4 matrix of 32-bit words in v[0..3]
+__attribute__((target("ssse3"))) void transpose_4x32(__m128i* v) {
+  const __m128i t0 = _mm_unpacklo_epi32(v[0], v[1]);
+  const __m128i t1 = _mm_unpacklo_epi32(v[2], v[3]);
+  const __m128i t2 = _mm_unpackhi_epi32(v[0], v[1]);
+  const __m128i t3 = _mm_unpackhi_epi32(v[2], v[3]);
+  v[0] = _mm_unpacklo_epi64(t0, t1);
+  v[1] = _mm_unpackhi_epi64(t0, t1);
+  v[2] = _mm_unpacklo_epi64(t2, t3);
+  v[3] = _mm_unpackhi_epi64(t2, t3);
+}
+
+// Transpose the 8x8 matrix of 16-bit words in v[0..7]
+__attribute__((target("ssse3"))) void transpose_8x16(__m128i* v) {
+  __m128i b[8];
+  for (int i = 0; i < 4; ++i) {
+    b[2 * i] = _mm_unpacklo_epi16(v[2 * i], v[2 * i + 1]);
+    b[2 * i + 1] = _mm_unpackhi_epi16(v[2 * i], v[2 * i + 1]);
+  }
+  __m128i c[8];
+  for (int i = 0; i < 2; ++i) {
+    c[4 * i] = _mm_unpacklo_epi32(b[4 * i], b[4 * i + 2]);
+    c[4 * i + 1] = _mm_unpackhi_epi32(b[4 * i], b[4 * i + 2]);
+    c[4 * i + 2] = _mm_unpacklo_epi32(b[4 * i + 1], b[4 * i + 3]);
+    c[4 * i + 3] = _mm_unpackhi_epi32(b[4 * i + 1], b[4 * i + 3]);
+  }
+  for (int i = 0; i < 4; ++i) {
+    v[2 * i] = _mm_unpacklo_epi64(c[i], c[i + 4]);
+    v[2 * i + 1] = _mm_unpackhi_epi64(c[i], c[i + 4]);
+  }
+}
+
+// Within each vector, gather byte k of the four (width 4) or two (width 8)
+// elements into 32-bit or 16-bit word k; the transposes then collect word k
+// of all vectors of a block into output stream k.
+__attribute__((target("ssse3"))) __m128i gather_mask(std::size_t width) {
+  if (width == 4) {
+    return _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+  }
+  return _mm_setr_epi8(0, 8, 1, 9, 2, 10, 3, 11, 4, 12, 5, 13, 6, 14, 7, 15);
+}
+
+__attribute__((target("ssse3"))) __m128i scatter_mask(std::size_t width) {
+  if (width == 4) {
+    return _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+  }
+  return _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+}
+
+__attribute__((target("ssse3"))) std::size_t shuffle_ssse3(
+    const uint8_t* src, uint8_t* dst, std::size_t count, std::size_t width) {
+  const __m128i mask = gather_mask(width);
+  __m128i v[8];
+  std::size_t e = 0;
+  for (; e + block <= count; e += block) {
+    const uint8_t* in = src + e * width;
+    for (std::size_t i = 0; i < width; ++i) {
+      v[i] = _mm_shuffle_epi8(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16 * i)),
+          mask);
+    }
+    if (width == 4) {
+      transpose_4x32(v);
+    } else {
+      transpose_8x16(v);
+    }
+    for (std::size_t k = 0; k < width; ++k) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + k * count + e), v[k]);
+    }
+  }
+  return e;
+}
+
+__attribute__((target("ssse3"))) std::size_t unshuffle_ssse3(
+    const uint8_t* src, uint8_t* dst, std::size_t count, std::size_t width) {
+  const __m128i mask = scatter_mask(width);
+  __m128i v[8];
+  std::size_t e = 0;
+  for (; e + block <= count; e += block) {
+    for (std::size_t k = 0; k < width; ++k) {
+      v[k] = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(src + k * count + e));
+    }
+    if (width == 4) {
+      transpose_4x32(v);
+    } else {
+      transpose_8x16(v);
+    }
+    uint8_t* out = dst + e * width;
+    for (std::size_t i = 0; i < width; ++i) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * i),
+                       _mm_shuffle_epi8(v[i], mask));
+    }
+  }
+  return e;
+}
+#endif
+
+bool vectorized(std::size_t width) {
+#ifdef BYTE_SHUFFLE_X86
+  return (width == 4 || width == 8) && has_ssse3();
+#else
+  (void)width;
+  return false;
+#endif
+}
+
+template <typename T>
+void delta_encode_words(uint8_t* data, std::size_t count) {
+  T previous = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    T word;
+    std::memcpy(&word, data + i * sizeof(T), sizeof(T));
+    const auto delta = static_cast<T>(word - previous);
+    std::memcpy(data + i * sizeof(T), &delta, sizeof(T));
+    previous = word;
+  }
+}
+
+template <typename T>
+void delta_decode_words(uint8_t* data, std::size_t count) {
+  T previous = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    T word;
+    std::memcpy(&word, data + i * sizeof(T), sizeof(T));
+    previous = static_cast<T>(previous + word);
+    std::memcpy(data + i * sizeof(T), &previous, sizeof(T));
+  }
+}
+
+[[noreturn]] void invalid_width(std::size_t width) {
+  throw std::invalid_argument("invalid delta word width: " +
+                              std::to_string(width));
+}
+
+} // namespace
+
+void byte_shuffle(const uint8_t* src,
+                  uint8_t* dst,
+                  std::size_t size,
+                  std::size_t width) {
+  if (width <= 1) {
+    std::memcpy(dst, src, size);
+    return;
+  }
+  const std::size_t count = size / width;
+  std::size_t done = 0;
+#ifdef BYTE_SHUFFLE_X86
+  if (vectorized(width)) {
+    done = shuffle_ssse3(src, dst, count, width);
+  }
+#endif
+  shuffle_tail(src, dst, done, count, width);
+  std::memcpy(dst + count * width, src + count * width, size - count * width);
+}
+
+void byte_unshuffle(const uint8_t* src,
+                    uint8_t* dst,
+                    std::size_t size,
+                    std::size_t width) {
+  if (width <= 1) {
+    std::memcpy(dst, src, size);
+    return;
+  }
+  const std::size_t count = size / width;
+  std::size_t done = 0;
+#ifdef BYTE_SHUFFLE_X86
+  if (vectorized(width)) {
+    done = unshuffle_ssse3(src, dst, count, width);
+  }
+#endif
+  unshuffle_tail(src, dst, done, count, width);
+  std::memcpy(dst + count * width, src + count * width, size - count * width);
+}
+
+void delta_encode(uint8_t* data, std::size_t size, std::size_t width) {
+  switch (width) {
+  case 1:
+    return delta_encode_words<uint8_t>(data, size);
+  case 2:
+    return delta_encode_words<uint16_t>(data, size / 2);
+  case 4:
+    return delta_encode_words<uint32_t>(data, size / 4);
+  case 8:
+    return delta_encode_words<uint64_t>(data, size / 8);
+  default:
+    invalid_width(width);
+  }
+}
+
+void delta_decode(uint8_t* data, std::size_t size, std::size_t width) {
+  switch (width) {
+  case 1:
+    return delta_decode_words<uint8_t>(data, size);
+  case 2:
+    return delta_decode_words<uint16_t>(data, size / 2);
+  case 4:
+    return delta_decode_words<uint32_t>(data, size / 4);
+  case 8:
+    return delta_decode_words<uint64_t>(data, size / 8);
+  default:
+    invalid_width(width);
+  }
+}
+
+} // namespace fles
@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Declares the byte shuffle and word delta transforms used by the
+/// component chunk codecs.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace fles {
+
+/**
+ * \brief Transpose the bytes of a sequence of elements of the given width.
+ *
+ * The output holds byte 0 of all elements, followed by byte 1 of all
+ * elements, and so on. Trailing bytes not forming a complete element are
+ * copied unchanged to the end. Slowly varying data (e.g., time stamps in
+ * detector hit words) thus turns into long runs of equal bytes, which
+ * compress much better. Widths 4 and 8 use SSSE3 if supported by the CPU.
+ *
+ * \param src   Input data
+ * \param dst   Output buffer of the same size (must not overlap src)
+ * \param size  Size of the data in bytes
+ * \param width Element width in bytes
+ */
+void byte_shuffle(const uint8_t* src,
+                  uint8_t* dst,
+                  std::size_t size,
+                  std::size_t width);
+
+/// Invert byte_shuffle (same parameters as in the call to be inverted).
+void byte_unshuffle(const uint8_t* src,
+                    uint8_t* dst,
+                    std::size_t size,
+                    std::size_t width);
+
+/**
+ * \brief Replace each little-endian word of the given width (1, 2, 4 or 8
+ * bytes) by its difference to the preceding word, in place.
+ *
+ * Trailing bytes not forming a complete word are left unchanged.
+ */
+void delta_encode(uint8_t* data, std::size_t size, std::size_t width);
+
+/// Invert delta_encode, in place.
+void delta_decode(uint8_t* data, std::size_t size, std::size_t width);
+
+} // namespace fles
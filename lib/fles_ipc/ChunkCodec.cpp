@@ -0,0 +1,330 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "ChunkCodec.hpp"
+#include "ByteShuffle.hpp"
+#include "MicrosliceDescriptor.hpp"
+#include "ZstdDictionary.hpp"
+#include "ZstdFrameCompressor.hpp"
+#include <boost/algorithm/string.hpp>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace fles {
+
+namespace {
+
+void check_size(std::size_t actual, std::size_t expected) {
+  if (actual != expected) {
+    throw std::runtime_error("corrupt component chunk");
+  }
+}
+
+class StoredCodec : public ChunkCodec {
+public:
+  [[nodiscard]] ChunkCodecId id() const override {
+    return ChunkCodecId::Stored;
+  }
+  [[nodiscard]] std::string name() const override { return "stored"; }
+
+  [[nodiscard]] std::string encode(const uint8_t* data,
+                                   std::size_t size,
+                                   std::size_t /* descriptor_bytes */)
+      const override {
+    return {reinterpret_cast<const char*>(data), size};
+  }
+
+  void decode(const uint8_t* encoded,
+              std::size_t encoded_size,
+              uint8_t* data,
+              std::size_t size,
+              std::size_t /* descriptor_bytes */) const override {
+    check_size(encoded_size, size);
+    std::memcpy(data, encoded, size);
+  }
+};
+
+#ifdef BOOST_IOS_HAS_ZSTD
+class ZstdCodec : public ChunkCodec {
+public:
+  explicit ZstdCodec(int level) : level_(level) {}
+
+  [[nodiscard]] ChunkCodecId id() const override { return ChunkCodecId::Zstd; }
+  [[nodiscard]] std::string name() const override { return "zstd"; }
+
+  [[nodiscard]] std::string encode(const uint8_t* data,
+                                   std::size_t size,
+                                   std::size_t /* descriptor_bytes */)
+      const override {
+    return compress_zstd_frame(data, size, level_);
+  }
+
+  void decode(const uint8_t* encoded,
+              std::size_t encoded_size,
+              uint8_t* data,
+              std::size_t size,
+              std::size_t /* descriptor_bytes */) const override {
+    decompress_zstd_frame(encoded, encoded_size, data, size);
+  }
+
+private:
+  int level_;
+};
+
+// The descriptor region is shuffled by descriptor, so that each descriptor
+// field forms a separate (mostly constant or slowly increasing) stream. The
+// content region is optionally delta encoded and shuffled by readout word.
+class ShuffleCodec : public ChunkCodec {
+public:
+  ShuffleCodec(std::size_t width, bool delta, int level)
+      : width_(width), delta_(delta), level_(level) {}
+
+  [[nodiscard]] ChunkCodecId id() const override {
+    return delta_ ? ChunkCodecId::DeltaShuffleZstd : ChunkCodecId::ShuffleZstd;
+  }
+  [[nodiscard]] uint8_t word_size() const override {
+    return static_cast<uint8_t>(width_);
+  }
+  [[nodiscard]] std::string name() const override {
+    return (delta_ ? "delta" : "shuffle") + std::to_string(width_);
+  }
+
+  [[nodiscard]] std::string encode(const uint8_t* data,
+                                   std::size_t size,
+                                   std::size_t descriptor_bytes)
+      const override {
+    check_descriptor_bytes(size, descriptor_bytes);
+    const std::size_t content_bytes = size - descriptor_bytes;
+    std::vector<uint8_t> shuffled(size);
+    byte_shuffle(data, shuffled.data(), descriptor_bytes,
+                 sizeof(MicrosliceDescriptor));
+    const uint8_t* content = data + descriptor_bytes;
+    std::vector<uint8_t> deltas;
+    if (delta_) {
+      deltas.assign(content, content + content_bytes);
+      delta_encode(deltas.data(), content_bytes, width_);
+      content = deltas.data();
+    }
+    byte_shuffle(content, shuffled.data() + descriptor_bytes, content_bytes,
+                 width_);
+    return compress_zstd_frame(shuffled.data(), shuffled.size(), level_);
+  }
+
+  void decode(const uint8_t* encoded,
+              std::size_t encoded_size,
+              uint8_t* data,
+              std::size_t size,
+              std::size_t descriptor_bytes) const override {
+    check_descriptor_bytes(size, descriptor_bytes);
+    const std::size_t content_bytes = size - descriptor_bytes;
+    std::vector<uint8_t> shuffled(size);
+    decompress_zstd_frame(encoded, encoded_size, shuffled.data(), size);
+    byte_unshuffle(shuffled.data(), data, descriptor_bytes,
+                   sizeof(MicrosliceDescriptor));
+    byte_unshuffle(shuffled.data() + descriptor_bytes, data + descriptor_bytes,
+                   content_bytes, width_);
+    if (delta_) {
+      delta_decode(data + descriptor_bytes, content_bytes, width_);
+    }
+  }
+
+private:
+  std::size_t width_;
+  bool delta_;
+  int level_;
+
+  static void check_descriptor_bytes(std::size_t size,
+                                     std::size_t descriptor_bytes) {
+    if (descriptor_bytes > size) {
+      throw std::runtime_error("corrupt component chunk");
+    }
+  }
+};
+#endif
+
+#ifdef HAVE_ZSTD
+class DictionaryCodec : public ChunkCodec {
+public:
+  DictionaryCodec(const std::string& dictionary, int level)
+      : dictionary_(dictionary, level) {}
+
+  [[nodiscard]] ChunkCodecId id() const override {
+    return ChunkCodecId::ZstdDictionary;
+  }
+  [[nodiscard]] std::string name() const override { return "dictionary"; }
+
+  [[nodiscard]] std::string encode(const uint8_t* data,
+                                   std::size_t size,
+                                   std::size_t /* descriptor_bytes */)
+      const override {
+    return dictionary_.compress(data, size);
+  }
+
+  void decode(const uint8_t* encoded,
+              std::size_t encoded_size,
+              uint8_t* data,
+              std::size_t size,
+              std::size_t /* descriptor_bytes */) const override {
+    dictionary_.decompress(encoded, encoded_size, data, size);
+  }
+
+private:
+  ZstdDictionary dictionary_;
+};
+#endif
+
+bool valid_word_size(unsigned long width) {
+  return width == 1 || width == 2 || width == 4 || width == 8;
+}
+
+uint8_t parse_number(const std::string& str) {
+  std::size_t pos = 0;
+  unsigned long value = 0;
+  try {
+    value = std::stoul(str, &pos, 0);
+  } catch (const std::logic_error&) {
+    pos = 0;
+  }
+  if (str.empty() || pos != str.size() || value > UINT8_MAX) {
+    throw std::invalid_argument("invalid number: " + str);
+  }
+  return static_cast<uint8_t>(value);
+}
+
+uint8_t parse_subsystem(const std::string& str) {
+  for (unsigned i = 0; i <= UINT8_MAX; ++i) {
+    const std::string& name = to_string(static_cast<Subsystem>(i));
+    if (name != "Undefined" && boost::iequals(name, str)) {
+      return static_cast<uint8_t>(i);
+    }
+  }
+  return parse_number(str);
+}
+
+} // namespace
+
+std::shared_ptr<const ChunkCodec>
+make_chunk_codec(ChunkCodecId id, uint8_t word_size, int level) {
+  switch (id) {
+  case ChunkCodecId::Stored:
+    return std::make_shared<StoredCodec>();
+#ifdef BOOST_IOS_HAS_ZSTD
+  case ChunkCodecId::Zstd:
+    return std::make_shared<ZstdCodec>(level);
+  case ChunkCodecId::ShuffleZstd:
+  case ChunkCodecId::DeltaShuffleZstd:
+    if (!valid_word_size(word_size)) {
+      break;
+    }
+    return std::make_shared<ShuffleCodec>(
+        word_size, id == ChunkCodecId::DeltaShuffleZstd, level);
+#endif
+  default:
+    break;
+  }
+  (void)level;
+  throw std::runtime_error(
+      "unsupported component chunk codec " +
+      std::to_string(static_cast<unsigned>(id)) + " (word size " +
+      std::to_string(static_cast<unsigned>(word_size)) + ")");
+}
+
+std::shared_ptr<const ChunkCodec>
+make_dictionary_chunk_codec(const std::string& dictionary, int level) {
+#ifdef HAVE_ZSTD
+  return std::make_shared<DictionaryCodec>(dictionary, level);
+#else
+  (void)dictionary;
+  (void)level;
+  throw std::runtime_error("zstd dictionaries not supported by this build");
+#endif
+}
+
+std::shared_ptr<const ChunkCodec> make_chunk_codec(const std::string& name,
+                                                   int level) {
+  if (name == "stored") {
+    return make_chunk_codec(ChunkCodecId::Stored, 0, level);
+  }
+  if (name == "zstd") {
+    return make_chunk_codec(ChunkCodecId::Zstd, 0, level);
+  }
+  for (const auto& [prefix, id] :
+       {std::pair{"shuffle", ChunkCodecId::ShuffleZstd},
+        std::pair{"delta", ChunkCodecId::DeltaShuffleZstd}}) {
+    const std::string p = prefix;
+    if (name.size() == p.size() + 1 && name.compare(0, p.size(), p) == 0) {
+      const unsigned long width = name.back() - '0';
+      if (valid_word_size(width)) {
+        return make_chunk_codec(id, static_cast<uint8_t>(width), level);
+      }
+    }
+  }
+  throw std::invalid_argument("unknown component chunk codec: " + name);
+}
+
+const ChunkCodec* ChunkCodecMap::find(uint8_t sys_id, uint8_t sys_ver) const {
+  if (auto it = versions_.find(key(sys_id, sys_ver)); it != versions_.end()) {
+    return it->second.get();
+  }
+  if (auto it = subsystems_.find(sys_id); it != subsystems_.end()) {
+    return it->second.get();
+  }
+  return default_.get();
+}
+
+ChunkCodecMap ChunkCodecMap::content_aware(int level) {
+  ChunkCodecMap map;
+  for (auto sys : {Subsystem::STS, Subsystem::MUCH, Subsystem::RICH,
+                   Subsystem::TRB3}) {
+    map.set(static_cast<uint8_t>(sys), make_chunk_codec("shuffle4", level));
+  }
+  for (auto sys : {Subsystem::TOF, Subsystem::BMON, Subsystem::TRD,
+                   Subsystem::TRD2D}) {
+    map.set(static_cast<uint8_t>(sys), make_chunk_codec("shuffle8", level));
+  }
+  map.set(static_cast<uint8_t>(Subsystem::FLES),
+          make_chunk_codec("delta8", level));
+  map.set_default(make_chunk_codec("zstd", level));
+  return map;
+}
+
+void ChunkCodecMap::set_dictionaries(
+    const std::map<uint16_t, std::string>& dictionaries, int level) {
+  for (const auto& [key, dictionary] : dictionaries) {
+    versions_[key] = make_dictionary_chunk_codec(dictionary, level);
+  }
+}
+
+ChunkCodecMap ChunkCodecMap::parse(const std::string& spec, int level) {
+  if (spec == "auto") {
+    return content_aware(level);
+  }
+  ChunkCodecMap map;
+  std::vector<std::string> entries;
+  boost::split(entries, spec, boost::is_any_of(","));
+  for (const auto& entry : entries) {
+    const auto colon = entry.find(':');
+    if (colon == std::string::npos) {
+      throw std::invalid_argument("invalid component chunk codec entry: " +
+                                  entry);
+    }
+    const std::string component = entry.substr(0, colon);
+    auto codec = make_chunk_codec(entry.substr(colon + 1), level);
+    if (component == "*") {
+      map.set_default(std::move(codec));
+      continue;
+    }
+    const auto dot = component.find('.');
+    const uint8_t sys_id = parse_subsystem(component.substr(0, dot));
+    if (dot == std::string::npos) {
+      map.set(sys_id, std::move(codec));
+    } else {
+      map.set(sys_id, parse_number(component.substr(dot + 1)),
+              std::move(codec));
+    }
+  }
+  return map;
+}
+
+} // namespace fles
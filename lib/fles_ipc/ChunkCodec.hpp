@@ -0,0 +1,183 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::ChunkCodec and fles::ChunkCodecMap classes.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace fles {
+
+/// Identifier of the codec of a component chunk (ComponentChunkDescriptor).
+enum class ChunkCodecId : uint8_t {
+  Archive = 0,         ///< Compression of the archive (ArchiveCompression)
+  Stored = 1,          ///< Uncompressed
+  Zstd = 2,            ///< Single zstd frame
+  ShuffleZstd = 3,     ///< Byte shuffle, then a single zstd frame
+  DeltaShuffleZstd = 4, ///< Word delta and byte shuffle, then a zstd frame
+  ZstdDictionary = 5    ///< Single zstd frame using the component dictionary
+};
+
+/**
+ * \brief The ChunkCodec class is the interface of the codecs compressing
+ * the component chunks of a chunked timeslice archive.
+ *
+ * A chunk consists of the microslice descriptors of the component followed
+ * by the microslice contents. Codecs may apply reversible transforms that
+ * exploit the structure of these regions (see ByteShuffle.hpp) before
+ * passing the data to an entropy coder.
+ */
+class ChunkCodec {
+public:
+  virtual ~ChunkCodec() = default;
+
+  /// Retrieve the identifier stored with each chunk.
+  [[nodiscard]] virtual ChunkCodecId id() const = 0;
+
+  /// Retrieve the word size parameter stored with each chunk (0 if unused).
+  [[nodiscard]] virtual uint8_t word_size() const { return 0; }
+
+  /// Retrieve the name of the codec (as accepted by make_chunk_codec()).
+  [[nodiscard]] virtual std::string name() const = 0;
+
+  /**
+   * \brief Encode a chunk.
+   *
+   * \param data             Chunk data
+   * \param size             Size of the chunk data in bytes
+   * \param descriptor_bytes Size of the microslice descriptor region
+   * \return Encoded chunk
+   */
+  [[nodiscard]] virtual std::string
+  encode(const uint8_t* data,
+         std::size_t size,
+         std::size_t descriptor_bytes) const = 0;
+
+  /**
+   * \brief Decode a chunk into a buffer of known size.
+   *
+   * \throws std::runtime_error if the encoded chunk is corrupt
+   */
+  virtual void decode(const uint8_t* encoded,
+                      std::size_t encoded_size,
+                      uint8_t* data,
+                      std::size_t size,
+                      std::size_t descriptor_bytes) const = 0;
+};
+
+/**
+ * \brief Create a chunk codec from its stored identifier and word size.
+ *
+ * \throws std::runtime_error if the codec is unknown or not supported by
+ * this build (zstd codecs require zstd support of Boost.Iostreams)
+ */
+std::shared_ptr<const ChunkCodec>
+make_chunk_codec(ChunkCodecId id, uint8_t word_size = 0, int level = 1);
+
+/**
+ * \brief Create a chunk codec compressing with a trained zstd dictionary.
+ *
+ * Chunks are stored with ChunkCodecId::ZstdDictionary; the dictionary is
+ * stored in the archive descriptor, keyed by the subsystem identifier and
+ * format version of the chunk (see ArchiveDescriptor::dictionaries()).
+ *
+ * \throws std::runtime_error if the dictionary is invalid or zstd
+ * dictionaries are not supported by this build
+ */
+std::shared_ptr<const ChunkCodec>
+make_dictionary_chunk_codec(const std::string& dictionary, int level = 1);
+
+/**
+ * \brief Create a chunk codec from its name.
+ *
+ * Names are "stored", "zstd", "shuffle<n>" (byte shuffle of n-byte words)
+ * and "delta<n>" (delta of n-byte words and byte shuffle), n being 1, 2, 4
+ * or 8.
+ *
+ * \throws std::invalid_argument if the name is unknown
+ */
+std::shared_ptr<const ChunkCodec> make_chunk_codec(const std::string& name,
+                                                   int level = 1);
+
+/**
+ * \brief The ChunkCodecMap class selects the chunk codec of a component by
+ * its Subsystem identifier and format version.
+ *
+ * Entries for a subsystem and format version take precedence over entries
+ * for the subsystem as a whole, which in turn take precedence over the
+ * default codec. Without a matching codec, chunks use the compression of
+ * the archive.
+ */
+class ChunkCodecMap {
+public:
+  /// Set the codec of a subsystem (all format versions).
+  void set(uint8_t sys_id, std::shared_ptr<const ChunkCodec> codec) {
+    subsystems_[sys_id] = std::move(codec);
+  }
+
+  /// Set the codec of a subsystem format version.
+  void set(uint8_t sys_id,
+           uint8_t sys_ver,
+           std::shared_ptr<const ChunkCodec> codec) {
+    versions_[key(sys_id, sys_ver)] = std::move(codec);
+  }
+
+  /// Set the codec of all other components.
+  void set_default(std::shared_ptr<const ChunkCodec> codec) {
+    default_ = std::move(codec);
+  }
+
+  /// Look up the codec of a component (nullptr if none).
+  [[nodiscard]] const ChunkCodec* find(uint8_t sys_id, uint8_t sys_ver) const;
+
+  /// Check whether no codec is set.
+  [[nodiscard]] bool empty() const {
+    return versions_.empty() && subsystems_.empty() && !default_;
+  }
+
+  /**
+   * \brief Create the built-in mapping for CBM detector data.
+   *
+   * Readout words are byte-shuffled with their native width (4 bytes for
+   * the STS-XYTER based and TRB3 based systems, 8 bytes for the others),
+   * flesnet pattern generator data (ramps) is delta encoded, and all other
+   * components are compressed with plain zstd.
+   */
+  static ChunkCodecMap content_aware(int level = 1);
+
+  /**
+   * \brief Select dictionary codecs for the format versions of the given
+   * zstd dictionaries (keyed by sys_id << 8 | sys_ver), replacing their
+   * previous entries.
+   */
+  void set_dictionaries(const std::map<uint16_t, std::string>& dictionaries,
+                        int level = 1);
+
+  /**
+   * \brief Parse a mapping specification.
+   *
+   * The specification is "auto" (see content_aware()) or a comma-separated
+   * list of "<subsystem>[.<sys_ver>]:<codec>" entries, where subsystem is a
+   * name as in fles::to_string(Subsystem) (case-insensitive) or a number,
+   * and "*" denotes the default, e.g., "sts:shuffle4,tof:shuffle8,*:zstd".
+   *
+   * \throws std::invalid_argument if the specification is invalid
+   */
+  static ChunkCodecMap parse(const std::string& spec, int level = 1);
+
+private:
+  std::map<uint16_t, std::shared_ptr<const ChunkCodec>> versions_;
+  std::map<uint8_t, std::shared_ptr<const ChunkCodec>> subsystems_;
+  std::shared_ptr<const ChunkCodec> default_;
+
+  static uint16_t key(uint8_t sys_id, uint8_t sys_ver) {
+    return static_cast<uint16_t>(sys_id << 8 | sys_ver);
+  }
+};
+
+} // namespace fles
@@ -0,0 +1,203 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "ChunkedTimesliceInputArchive.hpp"
+#include <boost/archive/binary_iarchive.hpp>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+namespace fles {
+
+namespace {
+
+template <typename T = StorableTimeslice> T* truncated_timeslice() {
+  std::cerr << "ChunkedTimesliceInputArchive: ignoring truncated timeslice "
+               "at end of archive file"
+            << std::endl;
+  return nullptr;
+}
+
+} // namespace
+
+ChunkedTimesliceInputArchive::ChunkedTimesliceInputArchive(
+    const std::string& filename, ComponentFilter filter)
+    : ChunkedTimesliceInputArchive(std::vector<std::string>{filename},
+                                   std::move(filter)) {}
+
+ChunkedTimesliceInputArchive::ChunkedTimesliceInputArchive(
+    std::vector<std::string> filenames,
+    ComponentFilter filter,
+    const RemoteParameters& remote)
+    : filenames_(std::move(filenames)), filter_(std::move(filter)),
+      remote_(remote) {
+  next_file();
+}
+
+void ChunkedTimesliceInputArchive::next_file() {
+  stream_ = nullptr;
+
+  if (file_count_ >= filenames_.size()) {
+    eos_ = true;
+    return;
+  }
+  const std::string& filename = filenames_.at(file_count_);
+  ++file_count_;
+
+  stream_ = open_input_stream(filename, remote_);
+  if (!*stream_) {
+    throw std::ios_base::failure("error opening file \"" + filename + "\"");
+  }
+
+  {
+    boost::archive::binary_iarchive iarchive(*stream_);
+    iarchive >> descriptor_;
+  }
+  decoder_ = std::make_unique<ComponentChunkDecoder>(descriptor_);
+  reader_ = nullptr;
+
+  if (descriptor_.archive_type() != ArchiveType::ChunkedTimesliceArchive) {
+    throw std::runtime_error("File \"" + filename +
+                             "\" is not of correct archive type");
+  }
+#ifndef BOOST_IOS_HAS_ZSTD
+  if (descriptor_.archive_compression() != ArchiveCompression::None) {
+    throw std::runtime_error("Unsupported compression type for input archive "
+                             "file \"" +
+                             filename + "\"");
+  }
+#endif
+}
+
+bool ChunkedTimesliceInputArchive::read_exactly(void* data, std::size_t size) {
+  stream_->read(static_cast<char*>(data), static_cast<std::streamsize>(size));
+  return static_cast<std::size_t>(stream_->gcount()) == size;
+}
+
+void ChunkedTimesliceInputArchive::set_lazy(bool lazy,
+                                            std::size_t read_ahead) {
+  lazy_ = lazy;
+  read_ahead_ = read_ahead;
+  reader_ = nullptr;
+}
+
+bool ChunkedTimesliceInputArchive::read_chunk_descriptors(
+    TimesliceDescriptor& ts_desc) {
+  if (!read_exactly(&ts_desc, sizeof(ts_desc))) {
+    if (stream_->gcount() != 0) {
+      truncated_timeslice();
+    }
+    return false;
+  }
+
+  chunks_.resize(ts_desc.num_components);
+  if (!read_exactly(chunks_.data(),
+                    chunks_.size() * sizeof(ComponentChunkDescriptor))) {
+    truncated_timeslice();
+    return false;
+  }
+  return true;
+}
+
+StorableTimeslice* ChunkedTimesliceInputArchive::read_timeslice() {
+  TimesliceDescriptor ts_desc{};
+  if (!read_chunk_descriptors(ts_desc)) {
+    return nullptr;
+  }
+
+  std::unique_ptr<StorableTimeslice> sts(new StorableTimeslice());
+  sts->timeslice_descriptor_ = ts_desc;
+  sts->timeslice_descriptor_.num_components = 0;
+
+  for (const auto& chunk : chunks_) {
+    // the flags are not part of the chunk descriptor and checked below
+    if (!filter_.all() && (chunk.component.num_microslices == 0 ||
+                           !filter_.matches(chunk.sys_id, chunk.eq_id))) {
+      stream_->seekg(static_cast<std::streamoff>(chunk.stored_size),
+                       std::ios::cur);
+      continue;
+    }
+
+    TimesliceArenaBuffer& data =
+        sts->data_.emplace_back(chunk.component.size);
+    if (decoder_->stored_as_is(chunk)) {
+      if (!read_exactly(data.data(), data.size())) {
+        return truncated_timeslice();
+      }
+    } else {
+      buffer_.resize(chunk.stored_size);
+      if (!read_exactly(buffer_.data(), buffer_.size())) {
+        return truncated_timeslice();
+      }
+      decoder_->decode(chunk, buffer_.data(), buffer_.size(),
+                       reinterpret_cast<uint8_t*>(data.data()));
+    }
+
+    if (filter_.uses_flags()) {
+      const auto* first =
+          reinterpret_cast<const MicrosliceDescriptor*>(data.data());
+      if (!filter_.matches_flags(first->flags)) {
+        sts->data_.pop_back();
+        continue;
+      }
+    }
+
+    sts->desc_.push_back(chunk.component);
+    ++sts->timeslice_descriptor_.num_components;
+  }
+
+  if (!*stream_) {
+    return truncated_timeslice();
+  }
+
+  sts->init_pointers();
+  return sts.release();
+}
+
+LazyTimeslice* ChunkedTimesliceInputArchive::read_lazy_timeslice() {
+  if (!reader_) {
+    const std::string& filename = filenames_.at(file_count_ - 1);
+    if (is_remote(filename)) {
+      throw std::runtime_error("lazy timeslices not implemented for remote "
+                               "archive file \"" +
+                               filename + "\"");
+    }
+    reader_ = std::make_shared<ComponentChunkReader>(filename, descriptor_,
+                                                     read_ahead_);
+    file_size_ = std::filesystem::file_size(filename);
+  }
+
+  TimesliceDescriptor ts_desc{};
+  if (!read_chunk_descriptors(ts_desc)) {
+    return nullptr;
+  }
+
+  std::vector<LazyTimeslice::Component> components;
+  components.reserve(chunks_.size());
+  auto offset = static_cast<uint64_t>(stream_->tellg());
+  for (const auto& chunk : chunks_) {
+    components.push_back({chunk, offset});
+    offset += chunk.stored_size;
+  }
+  // seeking beyond the end of the file succeeds
+  if (offset > file_size_) {
+    return truncated_timeslice<LazyTimeslice>();
+  }
+  stream_->seekg(static_cast<std::streamoff>(offset));
+
+  std::unique_ptr<LazyTimeslice> ts(
+      new LazyTimeslice(reader_, ts_desc, std::move(components)));
+  // filters on microslice flags load the components here
+  ts->select_components(filter_);
+  return ts.release();
+}
+
+Timeslice* ChunkedTimesliceInputArchive::do_get() {
+  if (lazy_) {
+    return next(&ChunkedTimesliceInputArchive::read_lazy_timeslice);
+  }
+  return next(&ChunkedTimesliceInputArchive::read_timeslice);
+}
+
+} // namespace fles
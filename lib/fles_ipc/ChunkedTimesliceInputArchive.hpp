@@ -0,0 +1,146 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::ChunkedTimesliceInputArchive class.
+#pragma once
+
+#include "ArchiveDescriptor.hpp"
+#include "ComponentChunkDescriptor.hpp"
+#include "ComponentChunkReader.hpp"
+#include "LazyTimeslice.hpp"
+#include "RemoteStream.hpp"
+#include "StorableTimeslice.hpp"
+#include "TimesliceSource.hpp"
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief The ChunkedTimesliceInputArchive class reads timeslices from one or
+ * more archive files of type ArchiveType::ChunkedTimesliceArchive.
+ *
+ * Only the components selected by the given ComponentFilter are read (and
+ * decompressed); the chunks of all other components are skipped. Filters
+ * on microslice flags require the chunk to be read before the check. The
+ * returned timeslices contain the selected components only, in archive
+ * order.
+ *
+ * In lazy mode (see set_lazy()), the chunks are skipped when reading and
+ * the source returns LazyTimeslice objects, which read each component from
+ * the archive file on first access. This suits consumers accessing a few
+ * components of each timeslice only, or none at all for most timeslices.
+ */
+class ChunkedTimesliceInputArchive : public TimesliceSource {
+public:
+  /**
+   * \brief Construct an input archive object for the given archive file.
+   *
+   * \param filename File name of the archive file
+   * \param filter   Selection of components to read
+   */
+  explicit ChunkedTimesliceInputArchive(const std::string& filename,
+                                        ComponentFilter filter = {});
+
+  /**
+   * \brief Construct an input archive object for a sequence of archive files,
+   * which are read one after the other.
+   *
+   * \param filenames File names (or "http://" URLs) of the archive files
+   * \param filter    Selection of components to read
+   * \param remote    Access parameters of remote archive files
+   */
+  explicit ChunkedTimesliceInputArchive(std::vector<std::string> filenames,
+                                        ComponentFilter filter = {},
+                                        const RemoteParameters& remote = {});
+
+  /// Delete copy constructor (non-copyable).
+  ChunkedTimesliceInputArchive(const ChunkedTimesliceInputArchive&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const ChunkedTimesliceInputArchive&) = delete;
+
+  ~ChunkedTimesliceInputArchive() override = default;
+
+  /// Read the next timeslice, including the data of all selected
+  /// components (also in lazy mode).
+  std::unique_ptr<StorableTimeslice> get() {
+    return std::unique_ptr<StorableTimeslice>(
+        next(&ChunkedTimesliceInputArchive::read_timeslice));
+  };
+
+  /// Read the next timeslice without the component data (also if not in
+  /// lazy mode).
+  std::unique_ptr<LazyTimeslice> get_lazy() {
+    return std::unique_ptr<LazyTimeslice>(
+        next(&ChunkedTimesliceInputArchive::read_lazy_timeslice));
+  };
+
+  /**
+   * \brief Switch the timeslices returned through the TimesliceSource
+   * interface to lazily materialized ones.
+   *
+   * Lazy mode requires local archive files, which are opened a second time
+   * for reading the components.
+   *
+   * \param lazy       Return LazyTimeslice objects
+   * \param read_ahead Minimum number of bytes read at a time when loading a
+   *                   component (see ComponentChunkReader)
+   */
+  void set_lazy(bool lazy, std::size_t read_ahead =
+                               ComponentChunkReader::default_read_ahead);
+
+  /// Retrieve the archive descriptor of the current archive file.
+  [[nodiscard]] const ArchiveDescriptor& descriptor() const {
+    return descriptor_;
+  };
+
+  [[nodiscard]] bool eos() const override { return eos_; }
+
+private:
+  std::vector<std::string> filenames_;
+  std::size_t file_count_ = 0;
+  ComponentFilter filter_;
+  RemoteParameters remote_;
+
+  std::unique_ptr<std::istream> stream_;
+  ArchiveDescriptor descriptor_;
+  std::vector<ComponentChunkDescriptor> chunks_;
+  std::vector<char> buffer_;
+  std::unique_ptr<ComponentChunkDecoder> decoder_;
+
+  bool lazy_ = false;
+  std::size_t read_ahead_ = ComponentChunkReader::default_read_ahead;
+  /// reader of the current archive file, shared by its lazy timeslices
+  std::shared_ptr<ComponentChunkReader> reader_;
+  uint64_t file_size_ = 0;
+
+  bool eos_ = false;
+
+  void next_file();
+  bool read_exactly(void* data, std::size_t size);
+  bool read_chunk_descriptors(TimesliceDescriptor& ts_desc);
+  StorableTimeslice* read_timeslice();
+  LazyTimeslice* read_lazy_timeslice();
+
+  template <typename T> T* next(T* (ChunkedTimesliceInputArchive::*read)()) {
+    while (!eos_) {
+      if (T* ts = (this->*read)()) {
+        return ts;
+      }
+      next_file();
+    }
+    return nullptr;
+  }
+
+  void do_get_batch(std::vector<std::unique_ptr<Timeslice>>& items,
+                    std::size_t max_items,
+                    std::chrono::nanoseconds /* timeout */) override {
+    get_available(items, max_items);
+  }
+
+  Timeslice* do_get() override;
+};
+
+} // namespace fles
@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "ChunkedTimesliceOutputArchive.hpp"
+#include "ComponentChunkDescriptor.hpp"
+#include "Timeslice.hpp"
+#include "ZstdFrameCompressor.hpp"
+#include <boost/archive/binary_oarchive.hpp>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace fles {
+
+ChunkedTimesliceOutputArchive::ChunkedTimesliceOutputArchive(
+    const std::string& filename,
+    ArchiveCompression compression,
+    int level,
+    ChunkCodecMap codecs,
+    const ZstdDictionaries& dictionaries)
+    : ofstream_(filename, std::ios::binary),
+      descriptor_{ArchiveType::ChunkedTimesliceArchive, compression},
+      level_(level), codecs_(std::move(codecs)) {
+  if (!ofstream_) {
+    throw std::ios_base::failure("error opening file \"" + filename + "\"");
+  }
+#ifndef BOOST_IOS_HAS_ZSTD
+  if (compression != ArchiveCompression::None) {
+    throw std::runtime_error(
+        "Unsupported compression type for output archive file \"" + filename +
+        "\"");
+  }
+#endif
+  if (!dictionaries.empty()) {
+    codecs_.set_dictionaries(dictionaries, level);
+    descriptor_.set_dictionaries(dictionaries);
+  }
+
+  // The archive descriptor is the only boost-serialized object in the file
+  boost::archive::binary_oarchive oarchive(ofstream_);
+  oarchive << descriptor_;
+}
+
+void ChunkedTimesliceOutputArchive::put(std::shared_ptr<const Timeslice> item) {
+  const Timeslice& ts = *item;
+  const auto num_components = ts.num_components();
+
+  std::vector<ComponentChunkDescriptor> chunks(num_components);
+  std::vector<std::string> compressed(num_components);
+  for (uint64_t c = 0; c < num_components; ++c) {
+    ComponentChunkDescriptor& chunk = chunks[c];
+    chunk = ComponentChunkDescriptor();
+    chunk.component = *ts.desc_ptr_[c];
+    if (ts.num_microslices(c) > 0) {
+      const auto& md = ts.descriptor(c, 0);
+      chunk.eq_id = md.eq_id;
+      chunk.sys_id = md.sys_id;
+      chunk.sys_ver = md.sys_ver;
+      if (const ChunkCodec* codec = codecs_.find(md.sys_id, md.sys_ver)) {
+        compressed[c] =
+            codec->encode(ts.component_data_ptr(c), chunk.component.size,
+                          ts.num_microslices(c) * sizeof(MicrosliceDescriptor));
+        chunk.stored_size = compressed[c].size();
+        chunk.codec = static_cast<uint8_t>(codec->id());
+        chunk.codec_word_size = codec->word_size();
+        continue;
+      }
+    }
+#ifdef BOOST_IOS_HAS_ZSTD
+    if (descriptor_.archive_compression() == ArchiveCompression::Zstd) {
+      compressed[c] = compress_zstd_frame(ts.component_data_ptr(c),
+                                          chunk.component.size, level_);
+      chunk.stored_size = compressed[c].size();
+      continue;
+    }
+#endif
+    chunk.stored_size = chunk.component.size;
+  }
+
+  ofstream_.write(reinterpret_cast<const char*>(&ts.timeslice_descriptor_),
+                  sizeof(TimesliceDescriptor));
+  ofstream_.write(reinterpret_cast<const char*>(chunks.data()),
+                  static_cast<std::streamsize>(
+                      chunks.size() * sizeof(ComponentChunkDescriptor)));
+  for (uint64_t c = 0; c < num_components; ++c) {
+    if (chunks[c].codec == 0 &&
+        descriptor_.archive_compression() == ArchiveCompression::None) {
+      ofstream_.write(reinterpret_cast<const char*>(ts.component_data_ptr(c)),
+                      static_cast<std::streamsize>(chunks[c].stored_size));
+    } else {
+      ofstream_.write(compressed[c].data(),
+                      static_cast<std::streamsize>(compressed[c].size()));
+    }
+  }
+  if (!ofstream_) {
+    throw std::ios_base::failure("error writing chunked timeslice archive");
+  }
+}
+
+} // namespace fles
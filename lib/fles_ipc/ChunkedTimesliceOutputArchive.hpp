@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::ChunkedTimesliceOutputArchive class.
+#pragma once
+
+#include "ArchiveDescriptor.hpp"
+#include "ChunkCodec.hpp"
+#include "Sink.hpp"
+#include "ZstdDictionary.hpp"
+#include <fstream>
+#include <memory>
+#include <string>
+
+namespace fles {
+
+class Timeslice;
+
+/**
+ * \brief The ChunkedTimesliceOutputArchive class writes timeslices to an
+ * archive file of type ArchiveType::ChunkedTimesliceArchive.
+ *
+ * In contrast to TimesliceOutputArchive, each timeslice component is stored
+ * as a separately addressable (and, if requested, separately compressed)
+ * chunk, see ComponentChunkDescriptor. This allows ChunkedTimesliceInputArchive
+ * to read only selected components. Chunks of components matched by the
+ * given ChunkCodecMap are encoded by the respective content-aware codec,
+ * all others use the archive compression. Components of the format versions
+ * of the given trained zstd dictionaries are compressed with them instead;
+ * the dictionaries are stored in the archive descriptor.
+ */
+class ChunkedTimesliceOutputArchive : public TimesliceSink {
+public:
+  /**
+   * \brief Construct an output archive object, open the given archive file
+   * for writing, and write the archive descriptor.
+   *
+   * \param filename    File name of the archive file
+   * \param compression Compression type to use for each chunk
+   * \param level       Compression level (zstd only)
+   * \param codecs      Codecs selected by subsystem
+   * \param dictionaries Zstd dictionaries by subsystem format version
+   */
+  explicit ChunkedTimesliceOutputArchive(
+      const std::string& filename,
+      ArchiveCompression compression = ArchiveCompression::None,
+      int level = 1,
+      ChunkCodecMap codecs = {},
+      const ZstdDictionaries& dictionaries = {});
+
+  /// Delete copy constructor (non-copyable).
+  ChunkedTimesliceOutputArchive(const ChunkedTimesliceOutputArchive&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const ChunkedTimesliceOutputArchive&) = delete;
+
+  ~ChunkedTimesliceOutputArchive() override = default;
+
+  /// Store a timeslice.
+  void put(std::shared_ptr<const Timeslice> item) override;
+
+private:
+  std::ofstream ofstream_;
+  ArchiveDescriptor descriptor_;
+  int level_;
+  ChunkCodecMap codecs_;
+};
+
+} // namespace fles
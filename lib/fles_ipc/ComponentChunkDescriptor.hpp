@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::ComponentChunkDescriptor struct.
+#pragma once
+
+#include "ComponentFilter.hpp"
+#include "TimesliceComponentDescriptor.hpp"
+#include <cstdint>
+
+namespace fles {
+
+#pragma pack(1)
+
+/**
+ * \brief %Component chunk descriptor struct.
+ *
+ * In a chunked timeslice archive, each timeslice record consists of the
+ * TimesliceDescriptor, followed by one ComponentChunkDescriptor per
+ * component and the chunks themselves (in component order). Each chunk
+ * holds the component data (microslice descriptors followed by microslice
+ * contents), either compressed as given by the archive descriptor
+ * (uncompressed or as a single zstd frame) or encoded by a ChunkCodec.
+ */
+struct ComponentChunkDescriptor {
+  /// Descriptor of the component; its size member is the uncompressed size.
+  TimesliceComponentDescriptor component;
+
+  /// Size (in bytes) of the chunk as stored in the archive file.
+  uint64_t stored_size;
+
+  /// Equipment identifier of the first microslice (0 if none).
+  uint16_t eq_id;
+
+  /// Subsystem identifier of the first microslice (0 if none).
+  uint8_t sys_id;
+
+  /// Subsystem format/version of the first microslice (0 if none).
+  uint8_t sys_ver;
+
+  /// Codec of the chunk (a ChunkCodecId, 0: archive compression).
+  uint8_t codec;
+
+  /// Word size parameter of the codec (0 if unused).
+  uint8_t codec_word_size;
+
+  /// Reserved, set to zero.
+  uint16_t reserved;
+};
+
+#pragma pack()
+
+} // namespace fles
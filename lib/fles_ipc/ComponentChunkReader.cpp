@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "ComponentChunkReader.hpp"
+#include "MicrosliceDescriptor.hpp"
+#include "ZstdDictionary.hpp"
+#include "ZstdFrameCompressor.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace fles {
+
+ComponentChunkDecoder::ComponentChunkDecoder(
+    const ArchiveDescriptor& descriptor)
+    : descriptor_(descriptor) {}
+
+const ChunkCodec&
+ComponentChunkDecoder::codec(const ComponentChunkDescriptor& chunk) {
+  if (chunk.codec == static_cast<uint8_t>(ChunkCodecId::ZstdDictionary)) {
+    const auto key = dictionary_key(chunk.sys_id, chunk.sys_ver);
+    auto& codec = dictionary_codecs_[key];
+    if (!codec) {
+      const auto it = descriptor_.dictionaries().find(key);
+      if (it == descriptor_.dictionaries().end()) {
+        throw std::runtime_error("missing zstd dictionary of component chunk");
+      }
+      codec = make_dictionary_chunk_codec(it->second);
+    }
+    return *codec;
+  }
+  const auto key =
+      static_cast<uint16_t>(chunk.codec << 8 | chunk.codec_word_size);
+  auto& codec = codecs_[key];
+  if (!codec) {
+    codec = make_chunk_codec(static_cast<ChunkCodecId>(chunk.codec),
+                             chunk.codec_word_size);
+  }
+  return *codec;
+}
+
+void ComponentChunkDecoder::decode(const ComponentChunkDescriptor& chunk,
+                                   const char* stored,
+                                   std::size_t stored_size,
+                                   uint8_t* data) {
+  if (chunk.codec != 0) {
+    codec(chunk).decode(
+        reinterpret_cast<const uint8_t*>(stored), stored_size, data,
+        chunk.component.size,
+        chunk.component.num_microslices * sizeof(MicrosliceDescriptor));
+  } else if (descriptor_.archive_compression() == ArchiveCompression::None) {
+    std::memcpy(data, stored, stored_size);
+  } else {
+#ifdef BOOST_IOS_HAS_ZSTD
+    decompress_zstd_frame(stored, stored_size, data, chunk.component.size);
+#else
+    throw std::runtime_error("unsupported compression of component chunk");
+#endif
+  }
+}
+
+ComponentChunkReader::ComponentChunkReader(const std::string& filename,
+                                           const ArchiveDescriptor& descriptor,
+                                           std::size_t read_ahead)
+    : stream_(filename, std::ios::binary), decoder_(descriptor),
+      read_ahead_(read_ahead) {
+  if (!stream_) {
+    throw std::ios_base::failure("error opening file \"" + filename + "\"");
+  }
+}
+
+void ComponentChunkReader::read(const ComponentChunkDescriptor& chunk,
+                                uint64_t offset,
+                                uint8_t* data) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (decoder_.stored_as_is(chunk) && chunk.stored_size >= read_ahead_) {
+    // large uncompressed chunks are read in place without caching
+    stream_.clear();
+    stream_.seekg(static_cast<std::streamoff>(offset));
+    stream_.read(reinterpret_cast<char*>(data),
+                 static_cast<std::streamsize>(chunk.stored_size));
+    if (static_cast<uint64_t>(stream_.gcount()) != chunk.stored_size) {
+      throw std::runtime_error("truncated component chunk in archive file");
+    }
+    return;
+  }
+  decoder_.decode(chunk, fetch(offset, chunk.stored_size), chunk.stored_size,
+                  data);
+}
+
+const char* ComponentChunkReader::fetch(uint64_t offset, std::size_t size) {
+  if (offset >= cache_offset_ &&
+      offset + size <= cache_offset_ + cache_.size()) {
+    return cache_.data() + (offset - cache_offset_);
+  }
+  cache_.resize(std::max(size, read_ahead_));
+  stream_.clear();
+  stream_.seekg(static_cast<std::streamoff>(offset));
+  stream_.read(cache_.data(), static_cast<std::streamsize>(cache_.size()));
+  // the read-ahead may extend beyond the end of the file
+  cache_.resize(static_cast<std::size_t>(stream_.gcount()));
+  cache_offset_ = offset;
+  if (cache_.size() < size) {
+    throw std::runtime_error("truncated component chunk in archive file");
+  }
+  return cache_.data();
+}
+
+} // namespace fles
@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::ComponentChunkDecoder and
+/// fles::ComponentChunkReader classes.
+#pragma once
+
+#include "ArchiveDescriptor.hpp"
+#include "ChunkCodec.hpp"
+#include "ComponentChunkDescriptor.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief The ComponentChunkDecoder class restores the component data from
+ * the chunks of a chunked timeslice archive file.
+ *
+ * The codecs (and dictionaries) given by the chunk descriptors are created
+ * on first use and kept for the archive file.
+ */
+class ComponentChunkDecoder {
+public:
+  /// Construct a decoder for an archive file with the given descriptor.
+  explicit ComponentChunkDecoder(const ArchiveDescriptor& descriptor);
+
+  /// Check whether a chunk is stored as is, i.e., its data can be read
+  /// without decoding.
+  [[nodiscard]] bool stored_as_is(const ComponentChunkDescriptor& chunk) const {
+    return chunk.codec == 0 &&
+           descriptor_.archive_compression() == ArchiveCompression::None;
+  }
+
+  /// Decode a chunk of stored_size bytes into data (chunk.component.size
+  /// bytes).
+  void decode(const ComponentChunkDescriptor& chunk,
+              const char* stored,
+              std::size_t stored_size,
+              uint8_t* data);
+
+private:
+  const ChunkCodec& codec(const ComponentChunkDescriptor& chunk);
+
+  ArchiveDescriptor descriptor_;
+  std::map<uint16_t, std::shared_ptr<const ChunkCodec>> codecs_;
+  /// dictionary codecs by dictionary_key()
+  std::map<uint16_t, std::shared_ptr<const ChunkCodec>> dictionary_codecs_;
+};
+
+/**
+ * \brief The ComponentChunkReader class reads single component chunks from a
+ * chunked timeslice archive file on demand (see LazyTimeslice).
+ *
+ * The file is opened separately from the archive reader. Each read fetches
+ * at least read_ahead bytes from the chunk on and keeps them, so that the
+ * following chunks of a timeslice are served from memory when a consumer
+ * accesses the components in order. The reader may be shared by several
+ * timeslices and threads.
+ */
+class ComponentChunkReader {
+public:
+  /// Default number of bytes read ahead.
+  static constexpr std::size_t default_read_ahead = std::size_t{4} << 20;
+
+  /**
+   * \brief Construct a reader for an archive file.
+   *
+   * \param filename   File name of the archive file
+   * \param descriptor Descriptor of the archive file
+   * \param read_ahead Minimum number of bytes read at a time
+   */
+  ComponentChunkReader(const std::string& filename,
+                       const ArchiveDescriptor& descriptor,
+                       std::size_t read_ahead = default_read_ahead);
+
+  /// Read and decode the chunk stored at the given file offset into data
+  /// (chunk.component.size bytes).
+  void read(const ComponentChunkDescriptor& chunk,
+            uint64_t offset,
+            uint8_t* data);
+
+private:
+  /// Make the stored bytes [offset, offset + size) available in the cache.
+  const char* fetch(uint64_t offset, std::size_t size);
+
+  std::mutex mutex_;
+  std::ifstream stream_;
+  ComponentChunkDecoder decoder_;
+  std::size_t read_ahead_;
+  std::vector<char> cache_;
+  /// file offset of the cached bytes
+  uint64_t cache_offset_ = 0;
+};
+
+} // namespace fles
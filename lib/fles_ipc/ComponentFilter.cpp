@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "ComponentFilter.hpp"
+#include "Utility.hpp"
+
+namespace fles {
+
+bool parse_filter_parameter(const std::string& key,
+                            const std::string& value,
+                            ComponentFilter& filter) {
+  if (key == "sys_id") {
+    for (const auto& id : split(value, ",")) {
+      filter.sys_ids.insert(static_cast<uint8_t>(stou(id, nullptr, 0)));
+    }
+  } else if (key == "eq_id") {
+    for (const auto& id : split(value, ",")) {
+      filter.eq_ids.insert(static_cast<uint16_t>(stou(id, nullptr, 0)));
+    }
+  } else if (key == "flags_set") {
+    filter.flags_set = static_cast<uint16_t>(stou(value, nullptr, 0));
+  } else if (key == "flags_clear") {
+    filter.flags_clear = static_cast<uint16_t>(stou(value, nullptr, 0));
+  } else {
+    return false;
+  }
+  return true;
+}
+
+} // namespace fles
@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::ComponentFilter class.
+#pragma once
+
+#include "MicrosliceDescriptor.hpp"
+#include <cstdint>
+#include <set>
+#include <string>
+
+namespace fles {
+
+/**
+ * \brief The ComponentFilter class selects timeslice components by subsystem
+ * identifier, equipment identifier, and microslice flags.
+ *
+ * A component is characterized by the descriptor of its first microslice;
+ * components without microslices are not selected by a restricting filter.
+ * An empty set matches all values and no flag bits are checked by default,
+ * so a default-constructed filter selects all components.
+ *
+ * Timeslice sources accepting a ComponentFilter return timeslices holding
+ * the selected components only, in their original order. They skip the
+ * other components as early as possible: the chunked archive reader does
+ * not read their chunks, and the memory-mapped and shared memory views do
+ * not touch their contents.
+ */
+class ComponentFilter {
+public:
+  /// Subsystem identifiers to select (empty: all).
+  std::set<uint8_t> sys_ids;
+
+  /// Equipment identifiers to select (empty: all).
+  std::set<uint16_t> eq_ids;
+
+  /// Microslice flag bits required to be set.
+  uint16_t flags_set = 0;
+
+  /// Microslice flag bits required to be cleared.
+  uint16_t flags_clear = 0;
+
+  /// Check whether a component with the given identifiers is selected,
+  /// disregarding the flags.
+  [[nodiscard]] bool matches(uint8_t sys_id, uint16_t eq_id) const {
+    return (sys_ids.empty() || sys_ids.count(sys_id) != 0) &&
+           (eq_ids.empty() || eq_ids.count(eq_id) != 0);
+  }
+
+  /// Check whether a component with the given first microslice is selected.
+  [[nodiscard]] bool matches(const MicrosliceDescriptor& desc) const {
+    return matches(desc.sys_id, desc.eq_id) && matches_flags(desc.flags);
+  }
+
+  /// Check whether the given microslice flags are selected.
+  [[nodiscard]] bool matches_flags(uint16_t flags) const {
+    return (flags & flags_set) == flags_set && (flags & flags_clear) == 0;
+  }
+
+  /// Check whether the filter checks microslice flags.
+  [[nodiscard]] bool uses_flags() const {
+    return flags_set != 0 || flags_clear != 0;
+  }
+
+  /// Check whether the filter selects all components.
+  [[nodiscard]] bool all() const {
+    return sys_ids.empty() && eq_ids.empty() && !uses_flags();
+  }
+};
+
+/**
+ * \brief Parse a component selection parameter of a URI query.
+ *
+ * The keys are "sys_id" and "eq_id" (comma-separated lists of identifiers),
+ * "flags_set" and "flags_clear", the values being decimal, octal, or
+ * hexadecimal numbers, e.g., "sys_id=0x10,0x60".
+ *
+ * \return false if the key does not denote a component selection parameter
+ */
+bool parse_filter_parameter(const std::string& key,
+                            const std::string& value,
+                            ComponentFilter& filter);
+
+} // namespace fles
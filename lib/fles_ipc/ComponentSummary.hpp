@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::ComponentSummary struct.
+#pragma once
+
+#include "MicrosliceDescriptor.hpp"
+#include <cstdint>
+
+namespace fles {
+
+#pragma pack(1)
+
+/**
+ * \brief Summary of the microslice descriptors of a timeslice component.
+ *
+ * The summary is computed by the input node while sending the component and
+ * transmitted along with its TimesliceComponentDescriptor where the
+ * transport and the timeslice buffer support it (see TimesliceShmLayout),
+ * so that consumers get these facts without scanning the descriptors (see
+ * Timeslice::component_summary()). A summary with a version of zero is
+ * not set.
+ */
+struct ComponentSummary {
+  /// Current version of the summary
+  static constexpr uint32_t current_version = 1;
+
+  uint32_t version;         ///< Version of the summary, zero if not set
+  uint32_t num_microslices; ///< Number of microslices
+  uint64_t ts_num;          ///< Global index of the timeslice
+  uint64_t content_size;    ///< Total size of the microslice contents
+  uint64_t first_idx;       ///< Index of the first microslice
+  uint64_t last_idx;        ///< Index of the last microslice
+  uint32_t error_count;     ///< Microslices flagged with a data error
+  uint32_t overflow_count;  ///< Microslices truncated by FLIM or user logic
+  uint32_t crc_valid_count; ///< Microslices with a valid CRC field
+  uint32_t crc_error_count; ///< Microslices failing the CRC check by flesnet
+  uint64_t reserved;        ///< Reserved, set to zero
+
+  /// Start an empty summary of the component of a timeslice.
+  static ComponentSummary begin(uint64_t ts_num) {
+    ComponentSummary summary{};
+    summary.version = current_version;
+    summary.ts_num = ts_num;
+    return summary;
+  }
+
+  /// Compute the summary of an array of microslice descriptors.
+  static ComponentSummary
+  compute(uint64_t ts_num, const MicrosliceDescriptor* desc, uint64_t count) {
+    ComponentSummary summary = begin(ts_num);
+    for (uint64_t i = 0; i < count; ++i) {
+      summary.add(desc[i]);
+    }
+    return summary;
+  }
+
+  /// Add the next microslice descriptor of the component.
+  void add(const MicrosliceDescriptor& desc) {
+    if (num_microslices == 0) {
+      first_idx = desc.idx;
+    }
+    last_idx = desc.idx;
+    ++num_microslices;
+    content_size += desc.size;
+    error_count += static_cast<uint32_t>(
+        (desc.flags & static_cast<uint16_t>(MicrosliceFlags::DataError)) != 0);
+    overflow_count += static_cast<uint32_t>(
+        (desc.flags &
+         (static_cast<uint16_t>(MicrosliceFlags::OverflowFlim) |
+          static_cast<uint16_t>(MicrosliceFlags::OverflowUser))) != 0);
+    crc_valid_count += static_cast<uint32_t>(
+        (desc.flags & static_cast<uint16_t>(MicrosliceFlags::CrcValid)) != 0);
+    crc_error_count += static_cast<uint32_t>(
+        (desc.flags & static_cast<uint16_t>(MicrosliceFlags::CrcError)) != 0);
+  }
+
+  /// Check whether the summary is set for the given component descriptor
+  /// values, i.e., not stale or of an unknown version.
+  [[nodiscard]] bool valid_for(uint64_t ts, uint64_t microslices) const {
+    return version == current_version && ts_num == ts &&
+           num_microslices == microslices;
+  }
+
+  /// Retrieve the fraction of microslices with a valid CRC field.
+  [[nodiscard]] double crc_valid_ratio() const {
+    return num_microslices == 0 ? 0.0
+                                : static_cast<double>(crc_valid_count) /
+                                      static_cast<double>(num_microslices);
+  }
+};
+
+#pragma pack()
+
+static_assert(sizeof(ComponentSummary) == 64);
+
+} // namespace fles
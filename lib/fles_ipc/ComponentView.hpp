@@ -0,0 +1,209 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::ComponentView class.
+#pragma once
+
+#include "MicrosliceDescriptor.hpp"
+#include "TimesliceComponentDescriptor.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+namespace fles {
+
+/// Descriptor and content of a microslice in a ComponentView.
+struct MicrosliceRef {
+  /// Descriptor of the microslice.
+  const MicrosliceDescriptor& desc;
+  /// Content of the microslice (desc.size bytes).
+  const uint8_t* content;
+};
+
+/**
+ * \brief The ComponentView class provides flat access to the microslices of
+ * a timeslice component.
+ *
+ * A component is stored contiguously, as the array of microslice
+ * descriptors followed by the microslice contents. The view caches the base
+ * pointers of both regions and the offset of the first microslice, so that
+ * locating a microslice (e.g., in a range-based for loop) takes a single
+ * load and addition instead of the indirections of Timeslice::content().
+ * The view is invalidated with the timeslice it refers to.
+ */
+class ComponentView {
+public:
+  /// Default distance (in microslices) of the prefetches in for_each().
+  static constexpr uint64_t default_prefetch_distance = 4;
+
+  /// Random access iterator over the microslices of the component.
+  class iterator {
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = MicrosliceRef;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = MicrosliceRef;
+
+    iterator() = default;
+
+    MicrosliceRef operator*() const {
+      return {*desc_, content_ + (desc_->offset - first_offset_)};
+    }
+    MicrosliceRef operator[](difference_type n) const { return *(*this + n); }
+
+    iterator& operator++() {
+      ++desc_;
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator it = *this;
+      ++desc_;
+      return it;
+    }
+    iterator& operator--() {
+      --desc_;
+      return *this;
+    }
+    iterator operator--(int) {
+      iterator it = *this;
+      --desc_;
+      return it;
+    }
+    iterator& operator+=(difference_type n) {
+      desc_ += n;
+      return *this;
+    }
+    iterator& operator-=(difference_type n) {
+      desc_ -= n;
+      return *this;
+    }
+    friend iterator operator+(iterator it, difference_type n) {
+      return it += n;
+    }
+    friend iterator operator+(difference_type n, iterator it) {
+      return it += n;
+    }
+    friend iterator operator-(iterator it, difference_type n) {
+      return it -= n;
+    }
+    friend difference_type operator-(const iterator& a, const iterator& b) {
+      return a.desc_ - b.desc_;
+    }
+
+    friend bool operator==(const iterator& a, const iterator& b) {
+      return a.desc_ == b.desc_;
+    }
+    friend bool operator!=(const iterator& a, const iterator& b) {
+      return a.desc_ != b.desc_;
+    }
+    friend bool operator<(const iterator& a, const iterator& b) {
+      return a.desc_ < b.desc_;
+    }
+    friend bool operator>(const iterator& a, const iterator& b) {
+      return a.desc_ > b.desc_;
+    }
+    friend bool operator<=(const iterator& a, const iterator& b) {
+      return a.desc_ <= b.desc_;
+    }
+    friend bool operator>=(const iterator& a, const iterator& b) {
+      return a.desc_ >= b.desc_;
+    }
+
+  private:
+    friend class ComponentView;
+
+    iterator(const MicrosliceDescriptor* desc,
+             const uint8_t* content,
+             uint64_t first_offset)
+        : desc_(desc), content_(content), first_offset_(first_offset) {}
+
+    const MicrosliceDescriptor* desc_ = nullptr;
+    const uint8_t* content_ = nullptr;
+    uint64_t first_offset_ = 0;
+  };
+
+  /// Construct a view of a component given its data and descriptor.
+  ComponentView(const uint8_t* data, const TimesliceComponentDescriptor& desc)
+      : descriptors_(reinterpret_cast<const MicrosliceDescriptor*>(data)),
+        num_microslices_(desc.num_microslices),
+        content_(data + desc.num_microslices * sizeof(MicrosliceDescriptor)),
+        content_size_(desc.size -
+                      desc.num_microslices * sizeof(MicrosliceDescriptor)),
+        first_offset_(desc.num_microslices != 0 ? descriptors_[0].offset
+                                                : 0) {}
+
+  /// Retrieve the number of microslices.
+  [[nodiscard]] uint64_t size() const { return num_microslices_; }
+
+  /// Check whether the component contains no microslices.
+  [[nodiscard]] bool empty() const { return num_microslices_ == 0; }
+
+  /// Retrieve the contiguous array of microslice descriptors.
+  [[nodiscard]] const MicrosliceDescriptor* descriptors() const {
+    return descriptors_;
+  }
+
+  /// Retrieve the contiguous contents of all microslices.
+  [[nodiscard]] const uint8_t* content() const { return content_; }
+
+  /// Retrieve the total size of the microslice contents in bytes.
+  [[nodiscard]] uint64_t content_size() const { return content_size_; }
+
+  /// Retrieve the descriptor of a given microslice.
+  [[nodiscard]] const MicrosliceDescriptor&
+  descriptor(uint64_t microslice) const {
+    return descriptors_[microslice];
+  }
+
+  /// Retrieve a pointer to the content of a given microslice.
+  [[nodiscard]] const uint8_t* content(uint64_t microslice) const {
+    return content_ + (descriptors_[microslice].offset - first_offset_);
+  }
+
+  /// Retrieve the descriptor and content of a given microslice.
+  MicrosliceRef operator[](uint64_t microslice) const {
+    return {descriptors_[microslice], content(microslice)};
+  }
+
+  /**
+   * \brief Call fn(index, microslice) for each microslice in order.
+   *
+   * The loop is software pipelined to hide the memory latency on large
+   * timeslices: the descriptor of microslice m + 2 * distance and the
+   * beginning of the content of microslice m + distance, whose descriptor
+   * has been prefetched before, are requested while microslice m is
+   * processed. The rest of a content is left to the hardware prefetcher.
+   */
+  template <typename Fn>
+  void for_each(Fn&& fn, uint64_t distance = default_prefetch_distance) const {
+    for (uint64_t m = 0; m < num_microslices_; ++m) {
+      if (m + 2 * distance < num_microslices_) {
+        __builtin_prefetch(&descriptors_[m + 2 * distance]);
+      }
+      if (m + distance < num_microslices_) {
+        const uint8_t* ahead = content(m + distance);
+        __builtin_prefetch(ahead);
+        __builtin_prefetch(ahead + 64);
+      }
+      fn(m, (*this)[m]);
+    }
+  }
+
+  [[nodiscard]] iterator begin() const {
+    return {descriptors_, content_, first_offset_};
+  }
+
+  [[nodiscard]] iterator end() const {
+    return {descriptors_ + num_microslices_, content_, first_offset_};
+  }
+
+private:
+  const MicrosliceDescriptor* descriptors_;
+  uint64_t num_microslices_;
+  const uint8_t* content_;
+  uint64_t content_size_;
+  uint64_t first_offset_;
+};
+
+} // namespace fles
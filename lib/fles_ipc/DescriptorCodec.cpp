@@ -0,0 +1,211 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "DescriptorCodec.hpp"
+#include <stdexcept>
+
+namespace fles {
+
+namespace {
+
+// Bits of the group mask byte
+constexpr uint8_t mask_hdr_id = 0x01;
+constexpr uint8_t mask_hdr_ver = 0x02;
+constexpr uint8_t mask_eq_id = 0x04;
+constexpr uint8_t mask_flags = 0x08;
+constexpr uint8_t mask_sys_id = 0x10;
+constexpr uint8_t mask_sys_ver = 0x20;
+constexpr uint8_t mask_stride = 0x40;
+constexpr uint8_t mask_offsets = 0x80;
+
+// Flag the header fields in which two descriptors differ
+uint8_t header_mask(const MicrosliceDescriptor& d,
+                    const MicrosliceDescriptor& p) {
+  uint8_t mask = 0;
+  mask |= d.hdr_id != p.hdr_id ? mask_hdr_id : 0;
+  mask |= d.hdr_ver != p.hdr_ver ? mask_hdr_ver : 0;
+  mask |= d.eq_id != p.eq_id ? mask_eq_id : 0;
+  mask |= d.flags != p.flags ? mask_flags : 0;
+  mask |= d.sys_id != p.sys_id ? mask_sys_id : 0;
+  mask |= d.sys_ver != p.sys_ver ? mask_sys_ver : 0;
+  return mask;
+}
+
+bool contiguous(const MicrosliceDescriptor& d, const MicrosliceDescriptor& p) {
+  return d.offset == p.offset + p.size;
+}
+
+uint64_t zigzag(uint64_t value) {
+  auto s = static_cast<int64_t>(value);
+  return (value << 1) ^ static_cast<uint64_t>(s >> 63);
+}
+
+uint64_t unzigzag(uint64_t value) { return (value >> 1) ^ (0 - (value & 1)); }
+
+void put_varint(std::vector<uint8_t>& out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<uint8_t>(value));
+}
+
+template <typename T> void put_raw(std::vector<uint8_t>& out, T value) {
+  for (std::size_t i = 0; i < sizeof(T); ++i) {
+    out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+  }
+}
+
+// Bounds-checked reader of an encoded buffer
+class Input {
+public:
+  Input(const uint8_t* data, std::size_t size)
+      : pos_(data), end_(data + size) {}
+
+  uint64_t varint() {
+    uint64_t value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+      uint8_t byte = raw<uint8_t>();
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        return value;
+      }
+    }
+    corrupt();
+  }
+
+  template <typename T> T raw() {
+    if (static_cast<std::size_t>(end_ - pos_) < sizeof(T)) {
+      corrupt();
+    }
+    T value = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+      value |= static_cast<T>(static_cast<T>(*pos_++) << (8 * i));
+    }
+    return value;
+  }
+
+  [[nodiscard]] bool at_end() const { return pos_ == end_; }
+
+  [[noreturn]] static void corrupt() {
+    throw std::runtime_error("corrupt compact microslice descriptors");
+  }
+
+private:
+  const uint8_t* pos_;
+  const uint8_t* end_;
+};
+
+} // namespace
+
+void DescriptorCodec::encode(const MicrosliceDescriptor* desc,
+                             std::size_t count,
+                             std::vector<uint8_t>& out) {
+  std::size_t i = 0;
+  while (i < count) {
+    const MicrosliceDescriptor& first = desc[i];
+    const uint64_t stride = first.idx - previous_.idx;
+    const bool group_contiguous = contiguous(first, previous_);
+    uint8_t mask = header_mask(first, previous_);
+    mask |= stride != stride_ ? mask_stride : 0;
+    mask |= group_contiguous ? 0 : mask_offsets;
+
+    std::size_t end = i + 1;
+    while (end < count && header_mask(desc[end], desc[end - 1]) == 0 &&
+           desc[end].idx - desc[end - 1].idx == stride &&
+           contiguous(desc[end], desc[end - 1]) == group_contiguous) {
+      ++end;
+    }
+
+    out.push_back(mask);
+    put_varint(out, end - i);
+    if ((mask & mask_hdr_id) != 0) {
+      put_raw<uint8_t>(out, first.hdr_id);
+    }
+    if ((mask & mask_hdr_ver) != 0) {
+      put_raw<uint8_t>(out, first.hdr_ver);
+    }
+    if ((mask & mask_eq_id) != 0) {
+      put_raw<uint16_t>(out, first.eq_id);
+    }
+    if ((mask & mask_flags) != 0) {
+      put_raw<uint16_t>(out, first.flags);
+    }
+    if ((mask & mask_sys_id) != 0) {
+      put_raw<uint8_t>(out, first.sys_id);
+    }
+    if ((mask & mask_sys_ver) != 0) {
+      put_raw<uint8_t>(out, first.sys_ver);
+    }
+    if ((mask & mask_stride) != 0) {
+      put_varint(out, zigzag(stride));
+    }
+    for (; i < end; ++i) {
+      put_raw<uint32_t>(out, desc[i].crc);
+      put_varint(out, desc[i].size);
+      if (!group_contiguous) {
+        put_varint(out,
+                   zigzag(desc[i].offset - (previous_.offset + previous_.size)));
+      }
+      previous_ = desc[i];
+    }
+    stride_ = stride;
+  }
+}
+
+void DescriptorCodec::decode(const uint8_t* data,
+                             std::size_t size,
+                             MicrosliceDescriptor* desc,
+                             std::size_t count) {
+  Input in(data, size);
+  std::size_t i = 0;
+  while (i < count) {
+    const auto mask = in.raw<uint8_t>();
+    const uint64_t group_size = in.varint();
+    if (group_size == 0 || group_size > count - i) {
+      Input::corrupt();
+    }
+    MicrosliceDescriptor d = previous_;
+    if ((mask & mask_hdr_id) != 0) {
+      d.hdr_id = in.raw<uint8_t>();
+    }
+    if ((mask & mask_hdr_ver) != 0) {
+      d.hdr_ver = in.raw<uint8_t>();
+    }
+    if ((mask & mask_eq_id) != 0) {
+      d.eq_id = in.raw<uint16_t>();
+    }
+    if ((mask & mask_flags) != 0) {
+      d.flags = in.raw<uint16_t>();
+    }
+    if ((mask & mask_sys_id) != 0) {
+      d.sys_id = in.raw<uint8_t>();
+    }
+    if ((mask & mask_sys_ver) != 0) {
+      d.sys_ver = in.raw<uint8_t>();
+    }
+    if ((mask & mask_stride) != 0) {
+      stride_ = unzigzag(in.varint());
+    }
+    for (const std::size_t end = i + group_size; i < end; ++i) {
+      d.idx = previous_.idx + stride_;
+      d.crc = in.raw<uint32_t>();
+      const uint64_t ms_size = in.varint();
+      if (ms_size > UINT32_MAX) {
+        Input::corrupt();
+      }
+      d.size = static_cast<uint32_t>(ms_size);
+      d.offset = previous_.offset + previous_.size;
+      if ((mask & mask_offsets) != 0) {
+        d.offset += unzigzag(in.varint());
+      }
+      desc[i] = d;
+      previous_ = d;
+    }
+  }
+  if (!in.at_end()) {
+    Input::corrupt();
+  }
+}
+
+} // namespace fles
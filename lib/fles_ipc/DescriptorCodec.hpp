@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::DescriptorCodec class.
+#pragma once
+
+#include "ArchiveDescriptor.hpp"
+#include "MicrosliceDescriptor.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief The DescriptorCodec class implements the compact encoding of
+ * microslice descriptors in archives (DescriptorEncoding::Compact).
+ *
+ * Each descriptor is encoded relative to its predecessor. Consecutive
+ * descriptors that share the header fields (hdr_id, hdr_ver, eq_id, flags,
+ * sys_id, sys_ver), the index stride, and offset contiguity form a group.
+ * A group is stored as:
+ * - a mask byte: bits 0-5 flag the header fields stored for the group,
+ *   bit 6 a new index stride, bit 7 explicit offsets,
+ * - the number of descriptors in the group (varint),
+ * - the flagged header fields (little endian),
+ * - the new index stride (zigzag varint), if flagged,
+ * - for each descriptor: crc (little endian), size (varint), and, if
+ *   flagged, the difference of the offset to the end of the predecessor
+ *   (zigzag varint).
+ *
+ * The state (predecessor and stride) is kept between calls, so a sequence
+ * of single descriptors (as in a microslice archive) is encoded compactly
+ * as well. Both sides have to reset() at the same positions.
+ */
+class DescriptorCodec {
+public:
+  /// Start a new sequence of descriptors.
+  void reset() {
+    previous_ = MicrosliceDescriptor();
+    stride_ = 0;
+  }
+
+  /// Append the encoding of a number of descriptors to a byte buffer.
+  void encode(const MicrosliceDescriptor* desc,
+              std::size_t count,
+              std::vector<uint8_t>& out);
+
+  /// Decode a number of descriptors from a byte buffer.
+  /**
+     \throws std::runtime_error if the buffer does not hold exactly the
+     encoding of count descriptors
+   */
+  void decode(const uint8_t* data,
+              std::size_t size,
+              MicrosliceDescriptor* desc,
+              std::size_t count);
+
+  /// Serialize a number of descriptors to a binary archive.
+  template <class Archive>
+  void save(Archive& ar, const MicrosliceDescriptor* desc, std::size_t count) {
+    buffer_.clear();
+    encode(desc, count, buffer_);
+    uint64_t size = buffer_.size();
+    ar << size;
+    ar.save_binary(buffer_.data(), buffer_.size());
+  }
+
+  /// Deserialize a number of descriptors from a binary archive.
+  template <class Archive>
+  void load(Archive& ar, MicrosliceDescriptor* desc, std::size_t count) {
+    uint64_t size = 0;
+    ar >> size;
+    buffer_.resize(size);
+    ar.load_binary(buffer_.data(), buffer_.size());
+    decode(buffer_.data(), buffer_.size(), desc, count);
+  }
+
+private:
+  MicrosliceDescriptor previous_{};
+  uint64_t stride_ = 0;
+  std::vector<uint8_t> buffer_;
+};
+
+/// Serialize an archive item using the given descriptor encoding.
+template <class Archive, class Item>
+void save_archive_item(Archive& ar,
+                       const Item& item,
+                       DescriptorEncoding encoding,
+                       DescriptorCodec& codec) {
+  if (encoding == DescriptorEncoding::Compact) {
+    item.save_compact(ar, codec);
+  } else {
+    ar << item;
+  }
+}
+
+/// Deserialize an archive item using the given descriptor encoding.
+template <class Archive, class Item>
+void load_archive_item(Archive& ar,
+                       Item& item,
+                       DescriptorEncoding encoding,
+                       DescriptorCodec& codec) {
+  if (encoding == DescriptorEncoding::Compact) {
+    item.load_compact(ar, codec);
+  } else {
+    ar >> item;
+  }
+}
+
+} // namespace fles
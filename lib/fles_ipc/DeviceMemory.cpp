@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "DeviceMemory.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#ifdef HAVE_CUDA
+#include <cuda_runtime_api.h>
+#endif
+
+namespace fles {
+
+#ifdef HAVE_CUDA
+
+namespace {
+
+void check(cudaError_t result, const std::string& what) {
+  if (result != cudaSuccess) {
+    throw std::runtime_error(what + " failed: " + cudaGetErrorString(result));
+  }
+}
+
+static_assert(sizeof(cudaIpcMemHandle_t) ==
+              sizeof(DeviceMemoryHandle::ipc_handle));
+
+} // namespace
+
+DeviceMemory::DeviceMemory(int device, std::size_t size)
+    : device_(device), size_(size), owner_(true) {
+  check(cudaSetDevice(device_), "cudaSetDevice");
+  void* ptr = nullptr;
+  check(cudaMalloc(&ptr, size_), "cudaMalloc");
+  ptr_ = static_cast<uint8_t*>(ptr);
+  cudaError_t result = cudaMemset(ptr_, 0, size_);
+  if (result != cudaSuccess) {
+    cudaFree(ptr_);
+    check(result, "cudaMemset");
+  }
+}
+
+DeviceMemory::DeviceMemory(const DeviceMemoryHandle& handle)
+    : device_(handle.device), size_(handle.size), owner_(false) {
+  check(cudaSetDevice(device_), "cudaSetDevice");
+  cudaIpcMemHandle_t ipc_handle;
+  std::memcpy(&ipc_handle, handle.ipc_handle, sizeof ipc_handle);
+  void* ptr = nullptr;
+  check(cudaIpcOpenMemHandle(&ptr, ipc_handle, cudaIpcMemLazyEnablePeerAccess),
+        "cudaIpcOpenMemHandle");
+  ptr_ = static_cast<uint8_t*>(ptr);
+}
+
+DeviceMemory::~DeviceMemory() {
+  if (owner_) {
+    cudaFree(ptr_);
+  } else {
+    cudaIpcCloseMemHandle(ptr_);
+  }
+}
+
+DeviceMemoryHandle DeviceMemory::handle() const {
+  DeviceMemoryHandle handle{};
+  handle.device = device_;
+  handle.size = size_;
+  cudaIpcMemHandle_t ipc_handle;
+  check(cudaIpcGetMemHandle(&ipc_handle, ptr_), "cudaIpcGetMemHandle");
+  std::memcpy(handle.ipc_handle, &ipc_handle, sizeof handle.ipc_handle);
+  return handle;
+}
+
+#else
+
+DeviceMemory::DeviceMemory(int device, std::size_t size)
+    : device_(device), size_(size), owner_(true) {
+  throw std::runtime_error("GPU memory requested, but built without CUDA");
+}
+
+DeviceMemory::DeviceMemory(const DeviceMemoryHandle& handle)
+    : device_(handle.device), size_(handle.size), owner_(false) {
+  throw std::runtime_error("GPU memory requested, but built without CUDA");
+}
+
+DeviceMemory::~DeviceMemory() = default;
+
+DeviceMemoryHandle DeviceMemory::handle() const { return {}; }
+
+#endif
+
+} // namespace fles
@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::DeviceMemory class.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace fles {
+
+/**
+ * \brief Information needed to open GPU memory in another process.
+ *
+ * Plain data, so that it can be placed in shared memory.
+ */
+struct DeviceMemoryHandle {
+  int32_t device;         ///< The GPU device index
+  uint64_t size;          ///< The size of the allocation in bytes
+  uint8_t ipc_handle[64]; ///< The CUDA IPC memory handle
+};
+
+/**
+ * \brief The DeviceMemory class represents a block of GPU memory.
+ *
+ * The memory is either allocated by this object or opened from another
+ * process through a DeviceMemoryHandle. Its contents are not accessible
+ * from the host.
+ */
+class DeviceMemory {
+public:
+  /// Allocate memory on a GPU device.
+  /**
+     \throws std::runtime_error if the allocation fails or the library has
+     been built without CUDA support
+   */
+  DeviceMemory(int device, std::size_t size);
+
+  /// Open memory allocated by another process.
+  /**
+     \throws std::runtime_error if the memory cannot be opened or the
+     library has been built without CUDA support
+   */
+  explicit DeviceMemory(const DeviceMemoryHandle& handle);
+
+  /// Delete copy constructor (non-copyable).
+  DeviceMemory(const DeviceMemory&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const DeviceMemory&) = delete;
+
+  ~DeviceMemory();
+
+  /// Retrieve the device pointer to the memory.
+  [[nodiscard]] uint8_t* ptr() const { return ptr_; }
+
+  /// Retrieve the size of the memory in bytes.
+  [[nodiscard]] std::size_t size() const { return size_; }
+
+  /// Retrieve the GPU device index.
+  [[nodiscard]] int device() const { return device_; }
+
+  /// Retrieve the handle to open the memory in another process.
+  [[nodiscard]] DeviceMemoryHandle handle() const;
+
+private:
+  int device_;
+  std::size_t size_;
+  uint8_t* ptr_ = nullptr;
+  bool owner_; ///< allocated (instead of opened) by this object
+};
+
+} // namespace fles
@@ -0,0 +1,303 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "DirectFileBuffer.hpp"
+#include "log.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <new>
+#include <stdexcept>
+#include <unistd.h>
+
+#ifdef HAVE_LIBURING
+#include <liburing.h>
+#endif
+
+namespace fles {
+
+namespace {
+
+std::string error_string(int error) { return std::strerror(error); }
+
+/// Write a block synchronously, return the number of bytes or -errno.
+long write_all(int fd, const char* data, std::size_t length, uint64_t offset) {
+  std::size_t done = 0;
+  while (done < length) {
+    ssize_t result = ::pwrite(fd, data + done, length - done,
+                              static_cast<off_t>(offset + done));
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -errno;
+    }
+    if (result == 0) {
+      break;
+    }
+    done += static_cast<std::size_t>(result);
+  }
+  return static_cast<long>(done);
+}
+
+} // namespace
+
+FsyncPolicy parse_fsync_policy(const std::string& name) {
+  if (name == "none") {
+    return FsyncPolicy::None;
+  }
+  if (name == "close") {
+    return FsyncPolicy::Close;
+  }
+  if (name == "always") {
+    return FsyncPolicy::Always;
+  }
+  throw std::invalid_argument("unknown fsync policy: " + name);
+}
+
+#ifdef HAVE_LIBURING
+struct DirectFileBuffer::Ring {
+  io_uring ring{};
+  ~Ring() { io_uring_queue_exit(&ring); }
+};
+#else
+struct DirectFileBuffer::Ring {};
+#endif
+
+DirectFileBuffer::DirectFileBuffer(const std::string& filename,
+                                   const DirectIoParameters& parameters)
+    : filename_(filename), parameters_(parameters) {
+  if (parameters_.queue_depth == 0) {
+    throw std::invalid_argument("direct I/O queue depth must be positive");
+  }
+  if (parameters_.buffer_size == 0 ||
+      parameters_.buffer_size % alignment != 0) {
+    throw std::invalid_argument(
+        "direct I/O buffer size must be a multiple of " +
+        std::to_string(alignment));
+  }
+
+  for (std::size_t i = 0; i < parameters_.queue_depth; ++i) {
+    void* data = std::aligned_alloc(alignment, parameters_.buffer_size);
+    if (data == nullptr) {
+      throw std::bad_alloc();
+    }
+    buffers_.push_back({{static_cast<char*>(data), std::free}, 0});
+  }
+
+  int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+  if (parameters_.fsync == FsyncPolicy::Always) {
+    flags |= O_DSYNC;
+  }
+  fd_ = ::open(filename_.c_str(), flags | O_DIRECT, 0644);
+  direct_ = fd_ >= 0;
+  if (fd_ < 0 && errno == EINVAL) {
+    // e.g., tmpfs: fall back to the page cache
+    fd_ = ::open(filename_.c_str(), flags, 0644);
+  }
+  if (fd_ < 0) {
+    throw std::runtime_error("cannot open output file \"" + filename_ +
+                             "\": " + error_string(errno));
+  }
+
+#ifdef HAVE_LIBURING
+  ring_ = std::make_unique<Ring>();
+  if (io_uring_queue_init(static_cast<unsigned>(parameters_.queue_depth),
+                          &ring_->ring, 0) < 0) {
+    // e.g., io_uring disabled: write synchronously
+    ring_ = nullptr;
+  }
+#endif
+
+  char* data = buffers_[current_].data.get();
+  setp(data, data + parameters_.buffer_size);
+}
+
+DirectFileBuffer::~DirectFileBuffer() {
+  try {
+    close();
+  } catch (const std::exception& e) {
+    L_(error) << e.what();
+  }
+}
+
+void DirectFileBuffer::close() {
+  if (fd_ < 0) {
+    return;
+  }
+  const auto length = static_cast<std::size_t>(pptr() - pbase());
+  const uint64_t file_size = size();
+  setp(nullptr, nullptr);
+  try {
+    if (length > 0) {
+      std::size_t padded = length;
+      if (direct_) {
+        // O_DIRECT writes whole blocks, the padding is truncated below
+        padded = (length + alignment - 1) / alignment * alignment;
+        std::memset(buffers_[current_].data.get() + length, 0,
+                    padded - length);
+      }
+      submit(padded);
+    }
+    for (std::size_t i = 0; i < buffers_.size(); ++i) {
+      wait_for(i);
+    }
+    if (file_offset_ != file_size &&
+        ::ftruncate(fd_, static_cast<off_t>(file_size)) != 0) {
+      throw std::runtime_error("cannot truncate output file \"" + filename_ +
+                               "\": " + error_string(errno));
+    }
+    if (parameters_.fsync != FsyncPolicy::None && ::fdatasync(fd_) != 0) {
+      throw std::runtime_error("cannot sync output file \"" + filename_ +
+                               "\": " + error_string(errno));
+    }
+  } catch (...) {
+    release();
+    throw;
+  }
+  file_offset_ = file_size;
+  release();
+}
+
+void DirectFileBuffer::flush() {
+  if (fd_ < 0) {
+    return;
+  }
+  const auto length = static_cast<std::size_t>(pptr() - pbase());
+  if (direct_ && length % alignment != 0) {
+    throw std::logic_error("unaligned flush of output file \"" + filename_ +
+                           "\"");
+  }
+  if (length > 0) {
+    submit(length);
+    current_ = (current_ + 1) % buffers_.size();
+  }
+  for (std::size_t i = 0; i < buffers_.size(); ++i) {
+    wait_for(i);
+  }
+  char* data = buffers_[current_].data.get();
+  setp(data, data + parameters_.buffer_size);
+}
+
+DirectFileBuffer::int_type DirectFileBuffer::overflow(int_type ch) {
+  if (fd_ < 0) {
+    return traits_type::eof();
+  }
+  submit(parameters_.buffer_size);
+  current_ = (current_ + 1) % buffers_.size();
+  wait_for(current_);
+  char* data = buffers_[current_].data.get();
+  setp(data, data + parameters_.buffer_size);
+  if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+    *pptr() = traits_type::to_char_type(ch);
+    pbump(1);
+  }
+  return traits_type::not_eof(ch);
+}
+
+DirectFileBuffer::pos_type
+DirectFileBuffer::seekoff(off_type off,
+                          std::ios_base::seekdir dir,
+                          std::ios_base::openmode which) {
+  // only position queries (tellp) are supported
+  if (off == 0 && dir == std::ios_base::cur && (which & std::ios_base::out)) {
+    return {static_cast<off_type>(size())};
+  }
+  return {off_type(-1)};
+}
+
+void DirectFileBuffer::submit(std::size_t length) {
+  Buffer& buffer = buffers_[current_];
+  const uint64_t offset = file_offset_;
+  buffer.length = length;
+  file_offset_ += length;
+#ifdef HAVE_LIBURING
+  if (ring_) {
+    io_uring_sqe* sqe = io_uring_get_sqe(&ring_->ring);
+    if (sqe == nullptr) {
+      throw std::runtime_error("io_uring submission queue full");
+    }
+    io_uring_prep_write(sqe, fd_, buffer.data.get(),
+                        static_cast<unsigned>(length), offset);
+    sqe->user_data = current_;
+    int result = io_uring_submit(&ring_->ring);
+    if (result < 0) {
+      throw std::runtime_error("io_uring submission failed: " +
+                               error_string(-result));
+    }
+    return;
+  }
+#endif
+  complete(current_, write_all(fd_, buffer.data.get(), length, offset));
+}
+
+void DirectFileBuffer::wait_for(std::size_t index) {
+#ifdef HAVE_LIBURING
+  while (ring_ && buffers_[index].length != 0) {
+    io_uring_cqe* cqe = nullptr;
+    int result = io_uring_wait_cqe(&ring_->ring, &cqe);
+    if (result == -EINTR) {
+      continue;
+    }
+    if (result < 0) {
+      throw std::runtime_error("io_uring completion failed: " +
+                               error_string(-result));
+    }
+    const auto completed = static_cast<std::size_t>(cqe->user_data);
+    const long written = cqe->res;
+    io_uring_cqe_seen(&ring_->ring, cqe);
+    complete(completed, written);
+  }
+#else
+  (void)index;
+#endif
+}
+
+void DirectFileBuffer::complete(std::size_t index, long result) {
+  Buffer& buffer = buffers_[index];
+  const std::size_t length = buffer.length;
+  buffer.length = 0;
+  if (result < 0) {
+    throw std::runtime_error("write to output file \"" + filename_ +
+                             "\" failed: " + error_string(-result));
+  }
+  if (static_cast<std::size_t>(result) != length) {
+    throw std::runtime_error("short write to output file \"" + filename_ +
+                             "\"");
+  }
+}
+
+void DirectFileBuffer::release() {
+#ifdef HAVE_LIBURING
+  // the buffers must not be freed while the kernel may still access them
+  for (auto& buffer : buffers_) {
+    while (ring_ && buffer.length != 0) {
+      io_uring_cqe* cqe = nullptr;
+      if (io_uring_wait_cqe(&ring_->ring, &cqe) == -EINTR) {
+        continue;
+      }
+      if (cqe == nullptr) {
+        break;
+      }
+      buffers_[static_cast<std::size_t>(cqe->user_data)].length = 0;
+      io_uring_cqe_seen(&ring_->ring, cqe);
+    }
+  }
+  ring_ = nullptr;
+#endif
+  ::close(fd_);
+  fd_ = -1;
+}
+
+std::unique_ptr<std::ostream>
+open_output_file(const std::string& filename,
+                 const DirectIoParameters& parameters) {
+  if (parameters.enabled) {
+    return std::make_unique<DirectFileStream>(filename, parameters);
+  }
+  return std::make_unique<std::ofstream>(filename, std::ios::binary);
+}
+
+} // namespace fles
@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::DirectFileBuffer and fles::DirectFileStream
+/// classes.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace fles {
+
+/// Durability guarantee of direct archive file output.
+enum class FsyncPolicy {
+  None,  ///< Leave write-back to the operating system
+  Close, ///< Flush the file to stable storage when it is closed
+  Always ///< Complete every write only on stable storage (O_DSYNC)
+};
+
+/// Parse an fsync policy name ("none", "close", or "always").
+/**
+   \throws std::invalid_argument if the name is unknown
+*/
+FsyncPolicy parse_fsync_policy(const std::string& name);
+
+/// Parameters of direct (O_DIRECT) output of archive files.
+struct DirectIoParameters {
+  /// Write archive files through a DirectFileBuffer.
+  bool enabled = false;
+
+  /// Number of staging buffers, i.e., the maximum number of writes in flight.
+  std::size_t queue_depth = 2;
+
+  /// Size of each staging buffer (a multiple of the block alignment).
+  std::size_t buffer_size = std::size_t{4} << 20;
+
+  /// Durability guarantee.
+  FsyncPolicy fsync = FsyncPolicy::None;
+};
+
+/**
+ * \brief The DirectFileBuffer class is an output stream buffer that writes
+ * a file with O_DIRECT, bypassing the page cache.
+ *
+ * Data is collected in a ring of aligned staging buffers. Each full buffer
+ * is submitted as a single write (through io_uring if available, otherwise
+ * synchronously) while the next one is filled, so that serialization and
+ * I/O overlap. Files on file systems without O_DIRECT support are written
+ * in the same way, but through the page cache.
+ */
+class DirectFileBuffer : public std::streambuf {
+public:
+  /// Alignment of buffer addresses, file offsets, and write sizes.
+  static constexpr std::size_t alignment = 4096;
+
+  /// Create (or truncate) a file for writing.
+  /**
+     \throws std::runtime_error if the file cannot be opened
+     \throws std::invalid_argument if the parameters are invalid
+   */
+  DirectFileBuffer(const std::string& filename,
+                   const DirectIoParameters& parameters);
+
+  /// Delete copy constructor (non-copyable).
+  DirectFileBuffer(const DirectFileBuffer&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const DirectFileBuffer&) = delete;
+
+  ~DirectFileBuffer() override;
+
+  /// Write the remaining data, wait for all writes, and close the file.
+  /**
+     \throws std::runtime_error if a write fails
+   */
+  void close();
+
+  /// Write the data collected so far and wait for all writes to complete.
+  /**
+     With direct I/O, the number of bytes written to the buffer so far has
+     to be a multiple of the alignment, e.g., by padding the data.
+
+     \throws std::runtime_error if a write fails
+     \throws std::logic_error if the size is not aligned
+   */
+  void flush();
+
+  /// Retrieve the number of bytes written to the buffer so far.
+  [[nodiscard]] uint64_t size() const {
+    return file_offset_ + static_cast<uint64_t>(pptr() - pbase());
+  }
+
+protected:
+  int_type overflow(int_type ch) override;
+  int sync() override { return 0; }
+  pos_type seekoff(off_type off,
+                   std::ios_base::seekdir dir,
+                   std::ios_base::openmode which) override;
+
+private:
+  struct Buffer {
+    std::unique_ptr<char, void (*)(void*)> data;
+    std::size_t length = 0; ///< length of the write in flight, 0 if idle
+  };
+  struct Ring;
+
+  std::string filename_;
+  DirectIoParameters parameters_;
+  int fd_ = -1;
+  bool direct_ = false; ///< O_DIRECT accepted by the file system
+  std::vector<Buffer> buffers_;
+  std::size_t current_ = 0; ///< buffer currently being filled
+  uint64_t file_offset_ = 0;
+  std::unique_ptr<Ring> ring_;
+
+  void submit(std::size_t length);
+  void wait_for(std::size_t index);
+  void complete(std::size_t index, long result);
+  void release();
+};
+
+/// Output stream writing a file through a DirectFileBuffer.
+class DirectFileStream : public std::ostream {
+public:
+  DirectFileStream(const std::string& filename,
+                   const DirectIoParameters& parameters)
+      : std::ostream(nullptr), buffer_(filename, parameters) {
+    rdbuf(&buffer_);
+  }
+
+  /// Write the remaining data and close the file.
+  void close() { buffer_.close(); }
+
+private:
+  DirectFileBuffer buffer_;
+};
+
+/// Open an archive output file, using direct I/O if enabled.
+std::unique_ptr<std::ostream>
+open_output_file(const std::string& filename,
+                 const DirectIoParameters& parameters);
+
+} // namespace fles
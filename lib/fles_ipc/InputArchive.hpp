@@ -4,6 +4,8 @@
 #pragma once
 
 #include "ArchiveDescriptor.hpp"
+#include "DescriptorCodec.hpp"
+#include "RemoteStream.hpp"
 #include "Source.hpp"
 #include <boost/archive/binary_iarchive.hpp>
 #ifdef BOOST_IOS_HAS_ZSTD
@@ -26,16 +28,17 @@ public:
    * \brief Construct an input archive object, open the given archive file for
    * reading, and read the archive descriptor.
    *
-   * \param filename File name of the archive file
+   * \param filename File name (or "http://" URL) of the archive file
+   * \param remote   Access parameters of a remote archive file
    */
-  explicit InputArchive(const std::string& filename) {
-    ifstream_ =
-        std::make_unique<std::ifstream>(filename.c_str(), std::ios::binary);
-    if (!*ifstream_) {
+  explicit InputArchive(const std::string& filename,
+                        const RemoteParameters& remote = {}) {
+    stream_ = open_input_stream(filename, remote);
+    if (!*stream_) {
       throw std::ios_base::failure("error opening file \"" + filename + "\"");
     }
 
-    iarchive_ = std::make_unique<boost::archive::binary_iarchive>(*ifstream_);
+    iarchive_ = std::make_unique<boost::archive::binary_iarchive>(*stream_);
 
     *iarchive_ >> descriptor_;
 
@@ -54,7 +57,7 @@ public:
             "Unsupported compression type for input archive file \"" +
             filename + "\"");
       }
-      in_->push(*ifstream_);
+      in_->push(*stream_);
       iarchive_ = std::make_unique<boost::archive::binary_iarchive>(
           *in_, boost::archive::no_header);
 #else
@@ -83,6 +86,12 @@ public:
   [[nodiscard]] bool eos() const override { return eos_; }
 
 private:
+  void do_get_batch(std::vector<std::unique_ptr<Base>>& items,
+                    std::size_t max_items,
+                    std::chrono::nanoseconds /* timeout */) override {
+    this->get_available(items, max_items);
+  }
+
   Derived* do_get() override {
     if (eos_) {
       return nullptr;
@@ -91,7 +100,8 @@ private:
     Derived* sts = nullptr;
     try {
       sts = new Derived(); // NOLINT
-      *iarchive_ >> *sts;
+      load_archive_item(*iarchive_, *sts, descriptor_.descriptor_encoding(),
+                        codec_);
     } catch (boost::archive::archive_exception& e) {
       if (e.code == boost::archive::archive_exception::input_stream_error) {
         delete sts; // NOLINT
@@ -103,10 +113,11 @@ private:
     return sts;
   }
 
-  std::unique_ptr<std::ifstream> ifstream_;
+  std::unique_ptr<std::istream> stream_;
   std::unique_ptr<boost::iostreams::filtering_istream> in_;
   std::unique_ptr<boost::archive::binary_iarchive> iarchive_;
   ArchiveDescriptor descriptor_;
+  DescriptorCodec codec_;
 
   bool eos_ = false;
 };
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "ArchiveDescriptor.hpp"
+#include "DescriptorCodec.hpp"
 #include "Source.hpp"
 #include <boost/archive/binary_iarchive.hpp>
 #ifdef BOOST_IOS_HAS_ZSTD
@@ -93,10 +94,17 @@ private:
 #endif
     }
 
+    codec_.reset();
     ++cycle_;
     archive_has_data_ = false;
   }
 
+  void do_get_batch(std::vector<std::unique_ptr<Base>>& items,
+                    std::size_t max_items,
+                    std::chrono::nanoseconds /* timeout */) override {
+    this->get_available(items, max_items);
+  }
+
   Derived* do_get() override {
     if (eos_) {
       return nullptr;
@@ -105,7 +113,8 @@ private:
     Derived* sts = nullptr;
     try {
       sts = new Derived(); // NOLINT
-      *iarchive_ >> *sts;
+      load_archive_item(*iarchive_, *sts, descriptor_.descriptor_encoding(),
+                        codec_);
       archive_has_data_ = true;
     } catch (boost::archive::archive_exception& e) {
       if (e.code == boost::archive::archive_exception::input_stream_error) {
@@ -126,6 +135,7 @@ private:
   std::unique_ptr<boost::iostreams::filtering_istream> in_;
   std::unique_ptr<boost::archive::binary_iarchive> iarchive_;
   ArchiveDescriptor descriptor_;
+  DescriptorCodec codec_;
 
   std::string filename_;
   uint64_t cycles_;
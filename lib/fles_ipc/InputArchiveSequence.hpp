@@ -4,6 +4,8 @@
 #pragma once
 
 #include "ArchiveDescriptor.hpp"
+#include "DescriptorCodec.hpp"
+#include "RemoteStream.hpp"
 #include "Source.hpp"
 #include <boost/algorithm/string.hpp>
 #include <boost/archive/binary_iarchive.hpp>
@@ -11,22 +13,37 @@
 #include <boost/iostreams/filter/zstd.hpp>
 #endif
 #include <boost/iostreams/filtering_stream.hpp>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <fstream>
 #include <iomanip>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
 namespace fles {
 
 /**
  * \brief The InputArchiveSequence class deserializes microslice data sets from
  * a sequence of input files.
+ *
+ * With parallel_files > 1, the next files of the sequence are opened and
+ * deserialized concurrently, each on its own thread and up to
+ * items_per_file_ahead items ahead. The items are still returned in
+ * sequence order.
  */
 template <class Base, class Derived, ArchiveType archive_type>
 class InputArchiveSequence : public Source<Base> {
 public:
+  /// Number of items per file read ahead in parallel mode.
+  static constexpr std::size_t items_per_file_ahead = 4;
+
   /**
    * \brief Construct an input archive object, open the first archive file for
    * reading, and read the archive descriptor. All occurences of the
@@ -34,26 +51,36 @@ public:
    * number.
    *
    * \param filename_template File name pattern of the archive files
+   * \param parallel_files    Number of files to read concurrently
+   * \param remote            Access parameters of remote archive files
    */
-  InputArchiveSequence(std::string filename_template)
-      : filename_template_(std::move(filename_template)) {
+  InputArchiveSequence(std::string filename_template,
+                       std::size_t parallel_files = 1,
+                       const RemoteParameters& remote = {})
+      : filename_template_(std::move(filename_template)),
+        parallel_files_(parallel_files), remote_(remote) {
     // append sequence number to file name if missing in template
     if (filename_template_.find("%n") == std::string::npos) {
       filename_template_ += ".%n";
     }
 
-    next_file();
+    first_file();
   }
 
   /**
    * \brief Construct an input archive object, open the first archive file for
    * reading, and read the archive descriptor.
    *
-   * \param filenames File names of the archive files
+   * \param filenames      File names of the archive files
+   * \param parallel_files Number of files to read concurrently
+   * \param remote         Access parameters of remote archive files
    */
-  InputArchiveSequence(std::vector<std::string> filenames)
-      : filenames_(std::move(filenames)) {
-    next_file();
+  InputArchiveSequence(std::vector<std::string> filenames,
+                       std::size_t parallel_files = 1,
+                       const RemoteParameters& remote = {})
+      : filenames_(std::move(filenames)), parallel_files_(parallel_files),
+        remote_(remote) {
+    first_file();
   }
 
   /// Delete copy constructor (non-copyable).
@@ -61,7 +88,7 @@ public:
   /// Delete assignment operator (non-copyable).
   void operator=(const InputArchiveSequence&) = delete;
 
-  ~InputArchiveSequence() override = default;
+  ~InputArchiveSequence() override { stop_readers(); }
 
   /// Read the next data set.
   std::unique_ptr<Derived> get() { return std::unique_ptr<Derived>(do_get()); };
@@ -74,15 +101,42 @@ public:
   [[nodiscard]] bool eos() const override { return eos_; }
 
 private:
-  std::unique_ptr<std::ifstream> ifstream_;
-  std::unique_ptr<boost::iostreams::filtering_istream> in_;
-  std::unique_ptr<boost::archive::binary_iarchive> iarchive_;
+  /// An open archive file.
+  struct File {
+    std::unique_ptr<std::istream> stream;
+    std::unique_ptr<boost::iostreams::filtering_istream> in;
+    std::unique_ptr<boost::archive::binary_iarchive> iarchive;
+    DescriptorEncoding encoding = DescriptorEncoding::Verbatim;
+    DescriptorCodec codec;
+  };
+
+  /// A file read ahead on a separate thread.
+  struct Reader {
+    std::size_t number = 0;
+    std::string filename;
+    RemoteParameters remote;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<std::unique_ptr<Derived>> queue;
+    std::optional<ArchiveDescriptor> descriptor; ///< set once opened
+    bool missing = false;                        ///< file does not exist
+    bool finished = false;
+    bool stopped = false;
+    std::exception_ptr exception;
+    std::thread thread;
+  };
+
+  File file_;
   ArchiveDescriptor descriptor_;
 
   std::string filename_template_;
   const std::vector<std::string> filenames_;
   std::size_t file_count_ = 0;
 
+  std::size_t parallel_files_;
+  RemoteParameters remote_;
+  std::deque<std::unique_ptr<Reader>> readers_;
+
   bool eos_ = false;
 
   [[nodiscard]] std::string filename_with_number(std::size_t n) const {
@@ -91,87 +145,264 @@ private:
     return boost::replace_all_copy(filename_template_, "%n", number.str());
   }
 
-  void next_file() {
-    iarchive_ = nullptr;
-    ifstream_ = nullptr;
-
-    std::string filename;
+  /// Retrieve the file name of the n-th file, return false if there is none.
+  bool filename(std::size_t n, std::string& name) const {
     if (!filenames_.empty()) {
       // We have a predefined vector
-      if (file_count_ >= filenames_.size()) {
-        eos_ = true;
-        return;
+      if (n >= filenames_.size()) {
+        return false;
       }
-      filename = filenames_.at(file_count_);
+      name = filenames_.at(n);
     } else {
       // We count ourselves
-      filename = filename_with_number(file_count_);
+      name = filename_with_number(n);
     }
+    return true;
+  }
 
-    ifstream_ = std::make_unique<std::ifstream>(filename, std::ios::binary);
-    if (!*ifstream_) {
-      if (file_count_ == 0 || !filenames_.empty()) {
-        // Not finding the first file or one given explicitely is an error
-        throw std::ios_base::failure("error opening file \"" + filename + "\"");
-      }
-      // Not finding a later file is just the end-of-stream condition
-      eos_ = true;
-      return;
+  /// Throw if a missing file is an error instead of the end of the sequence.
+  void check_missing(std::size_t n, const std::string& name) const {
+    if (n == 0 || !filenames_.empty()) {
+      // Not finding the first file or one given explicitely is an error
+      throw std::ios_base::failure("error opening file \"" + name + "\"");
     }
+  }
 
-    iarchive_ = std::make_unique<boost::archive::binary_iarchive>(*ifstream_);
+  /// Open an archive file and read its descriptor.
+  /**
+     \return false if the file cannot be opened
+   */
+  static bool open_file(const std::string& filename,
+                        const RemoteParameters& remote,
+                        File& file,
+                        ArchiveDescriptor& descriptor) {
+    file = File();
+    file.stream = open_input_stream(filename, remote);
+    if (!*file.stream) {
+      return false;
+    }
 
-    *iarchive_ >> descriptor_;
+    file.iarchive =
+        std::make_unique<boost::archive::binary_iarchive>(*file.stream);
 
-    if (descriptor_.archive_type() != archive_type) {
+    *file.iarchive >> descriptor;
+    file.encoding = descriptor.descriptor_encoding();
+
+    if (descriptor.archive_type() != archive_type) {
       throw std::runtime_error("File \"" + filename +
                                "\" is not of correct archive type");
     }
 
-    if (descriptor_.archive_compression() != ArchiveCompression::None) {
+    if (descriptor.archive_compression() != ArchiveCompression::None) {
 #ifdef BOOST_IOS_HAS_ZSTD
-      in_ = std::make_unique<boost::iostreams::filtering_istream>();
-      if (descriptor_.archive_compression() == ArchiveCompression::Zstd) {
-        in_->push(boost::iostreams::zstd_decompressor());
+      file.in = std::make_unique<boost::iostreams::filtering_istream>();
+      if (descriptor.archive_compression() == ArchiveCompression::Zstd) {
+        file.in->push(boost::iostreams::zstd_decompressor());
       } else {
         throw std::runtime_error(
             "Unsupported compression type for input archive file \"" +
             filename + "\"");
       }
-      in_->push(*ifstream_);
-      iarchive_ = std::make_unique<boost::archive::binary_iarchive>(
-          *in_, boost::archive::no_header);
+      file.in->push(*file.stream);
+      file.iarchive = std::make_unique<boost::archive::binary_iarchive>(
+          *file.in, boost::archive::no_header);
 #else
       throw std::runtime_error(
           "Unsupported compression type for input archive file \"" + filename +
           "\"");
 #endif
     }
+    return true;
+  }
+
+  /// Read the next item of a file, return nullptr at the end of the file.
+  static std::unique_ptr<Derived> read_item(File& file) {
+    std::unique_ptr<Derived> item(new Derived()); // NOLINT
+    try {
+      load_archive_item(*file.iarchive, *item, file.encoding, file.codec);
+    } catch (boost::archive::archive_exception& e) {
+      if (e.code == boost::archive::archive_exception::input_stream_error) {
+        return nullptr;
+      }
+      throw;
+    }
+    return item;
+  }
+
+  void first_file() {
+    if (parallel_files_ <= 1) {
+      next_file();
+      return;
+    }
+    start_readers();
+    if (readers_.empty()) {
+      eos_ = true;
+      return;
+    }
+    // Report a missing or invalid first file from the constructor
+    Reader& reader = *readers_.front();
+    std::unique_lock<std::mutex> lock(reader.mutex);
+    reader.changed.wait(lock, [&reader] {
+      return reader.descriptor.has_value() || reader.finished;
+    });
+    if (reader.descriptor) {
+      descriptor_ = *reader.descriptor;
+    } else {
+      lock.unlock();
+      finish_reader();
+    }
+  }
+
+  void next_file() {
+    file_ = File();
+
+    std::string name;
+    if (!filename(file_count_, name)) {
+      eos_ = true;
+      return;
+    }
+    if (!open_file(name, remote_, file_, descriptor_)) {
+      check_missing(file_count_, name);
+      // Not finding a later file is just the end-of-stream condition
+      eos_ = true;
+      return;
+    }
 
     ++file_count_;
   }
 
-  Derived* do_get() override {
-    if (eos_) {
-      return nullptr;
+  /// Start reader threads for the next files up to parallel_files_.
+  void start_readers() {
+    std::string name;
+    while (readers_.size() < parallel_files_ && filename(file_count_, name)) {
+      auto reader = std::make_unique<Reader>();
+      reader->number = file_count_;
+      reader->filename = name;
+      reader->remote = remote_;
+      reader->thread = std::thread(&InputArchiveSequence::read_file,
+                                   reader.get());
+      readers_.push_back(std::move(reader));
+      ++file_count_;
+    }
+  }
+
+  void stop_readers() {
+    for (auto& reader : readers_) {
+      {
+        std::lock_guard<std::mutex> lock(reader->mutex);
+        reader->stopped = true;
+      }
+      reader->changed.notify_all();
+    }
+    for (auto& reader : readers_) {
+      reader->thread.join();
     }
+    readers_.clear();
+  }
 
-    Derived* sts = nullptr;
+  /// Remove the completely read first reader and start the next one.
+  void finish_reader() {
+    std::unique_ptr<Reader> reader = std::move(readers_.front());
+    readers_.pop_front();
+    reader->thread.join();
+    if (reader->exception || reader->missing) {
+      eos_ = true;
+      stop_readers();
+      if (reader->exception) {
+        std::rethrow_exception(reader->exception);
+      }
+      check_missing(reader->number, reader->filename);
+      return;
+    }
+    start_readers();
+  }
+
+  /// Deserialize a file into the queue of its reader.
+  static void read_file(Reader* reader) {
     try {
-      sts = new Derived(); // NOLINT
-      *iarchive_ >> *sts;
-    } catch (boost::archive::archive_exception& e) {
-      if (e.code == boost::archive::archive_exception::input_stream_error) {
-        delete sts; // NOLINT
-        next_file();
-        if (!eos_) {
-          return do_get();
+      File file;
+      ArchiveDescriptor descriptor;
+      if (!open_file(reader->filename, reader->remote, file, descriptor)) {
+        std::lock_guard<std::mutex> lock(reader->mutex);
+        reader->missing = true;
+        reader->finished = true;
+        reader->changed.notify_all();
+        return;
+      }
+      {
+        std::lock_guard<std::mutex> lock(reader->mutex);
+        reader->descriptor = descriptor;
+        reader->changed.notify_all();
+      }
+      while (true) {
+        {
+          std::unique_lock<std::mutex> lock(reader->mutex);
+          reader->changed.wait(lock, [reader] {
+            return reader->stopped ||
+                   reader->queue.size() < items_per_file_ahead;
+          });
+          if (reader->stopped) {
+            return;
+          }
         }
-        return nullptr;
+        auto item = read_item(file);
+        std::lock_guard<std::mutex> lock(reader->mutex);
+        if (!item) {
+          reader->finished = true;
+          reader->changed.notify_all();
+          return;
+        }
+        reader->queue.push_back(std::move(item));
+        reader->changed.notify_all();
       }
-      throw;
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(reader->mutex);
+      reader->exception = std::current_exception();
+      reader->finished = true;
+      reader->changed.notify_all();
+    }
+  }
+
+  Derived* get_parallel() {
+    while (!readers_.empty()) {
+      Reader& reader = *readers_.front();
+      std::unique_lock<std::mutex> lock(reader.mutex);
+      reader.changed.wait(
+          lock, [&reader] { return reader.finished || !reader.queue.empty(); });
+      if (!reader.queue.empty()) {
+        auto item = std::move(reader.queue.front());
+        reader.queue.pop_front();
+        descriptor_ = *reader.descriptor;
+        reader.changed.notify_all();
+        return item.release();
+      }
+      lock.unlock();
+      finish_reader();
+    }
+    eos_ = true;
+    return nullptr;
+  }
+
+  void do_get_batch(std::vector<std::unique_ptr<Base>>& items,
+                    std::size_t max_items,
+                    std::chrono::nanoseconds /* timeout */) override {
+    this->get_available(items, max_items);
+  }
+
+  Derived* do_get() override {
+    if (eos_) {
+      return nullptr;
+    }
+    if (parallel_files_ > 1) {
+      return get_parallel();
+    }
+    while (!eos_) {
+      if (auto item = read_item(file_)) {
+        return item.release();
+      }
+      next_file();
     }
-    return sts;
+    return nullptr;
   }
 };
 
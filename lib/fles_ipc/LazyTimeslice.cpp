@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "LazyTimeslice.hpp"
+#include <utility>
+
+namespace fles {
+
+LazyTimeslice::LazyTimeslice(std::shared_ptr<ComponentChunkReader> reader,
+                             const TimesliceDescriptor& ts_desc,
+                             std::vector<Component> components)
+    : reader_(std::move(reader)), components_(std::move(components)),
+      data_(components_.size()) {
+  timeslice_descriptor_ = ts_desc;
+  timeslice_descriptor_.num_components = components_.size();
+
+  // initialize access pointer vectors, the data is located on first access
+  data_ptr_.assign(num_components(), nullptr);
+  desc_ptr_.resize(num_components());
+  for (std::size_t c = 0; c < num_components(); ++c) {
+    desc_ptr_[c] = &components_[c].chunk.component;
+  }
+}
+
+uint8_t* LazyTimeslice::load_component(uint64_t component) const {
+  const Component& c = components_[component];
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays)
+  auto data = std::make_unique<uint8_t[]>(c.chunk.component.size);
+  reader_->read(c.chunk, c.offset, data.get());
+  data_ptr_[component] = data.get();
+  data_[component] = std::move(data);
+  return data_ptr_[component];
+}
+
+void LazyTimeslice::select_components(const ComponentFilter& filter) {
+  if (filter.all()) {
+    return;
+  }
+  std::size_t selected = 0;
+  for (std::size_t c = 0; c < num_components(); ++c) {
+    const ComponentChunkDescriptor& chunk = components_[c].chunk;
+    if (chunk.component.num_microslices == 0 ||
+        !filter.matches(chunk.sys_id, chunk.eq_id) ||
+        (filter.uses_flags() && !component_selected(c, filter))) {
+      continue;
+    }
+    if (selected != c) {
+      components_[selected] = components_[c];
+      data_[selected] = std::move(data_[c]);
+      data_ptr_[selected] = data_ptr_[c];
+    }
+    ++selected;
+  }
+  components_.resize(selected);
+  data_.resize(selected);
+  data_ptr_.resize(selected);
+  desc_ptr_.resize(selected);
+  for (std::size_t c = 0; c < selected; ++c) {
+    desc_ptr_[c] = &components_[c].chunk.component;
+  }
+  timeslice_descriptor_.num_components = selected;
+  reset_caches();
+}
+
+} // namespace fles
@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::LazyTimeslice class.
+#pragma once
+
+#include "ComponentChunkDescriptor.hpp"
+#include "ComponentChunkReader.hpp"
+#include "Timeslice.hpp"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief The LazyTimeslice class provides access to a timeslice of a chunked
+ * archive file whose components are read on first access.
+ *
+ * Only the timeslice descriptor and the component chunk descriptors are read
+ * with the timeslice, together with the file offsets of the chunks. The data
+ * of a component is read (and decoded) by the ComponentChunkReader of the
+ * file once any of its microslices is accessed, e.g., through descriptor(),
+ * content() or get_microslice(). The component properties (such as
+ * num_microslices() and size_component()) are available right away.
+ *
+ * Loading is not synchronized with other threads accessing the same
+ * timeslice. Call materialize() before sharing a timeslice between threads.
+ */
+class LazyTimeslice : public Timeslice {
+public:
+  /// Delete copy constructor (non-copyable).
+  LazyTimeslice(const LazyTimeslice&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const LazyTimeslice&) = delete;
+
+  ~LazyTimeslice() override = default;
+
+  /// Check whether the data of a component has been loaded.
+  [[nodiscard]] bool component_loaded(uint64_t component) const {
+    return data_ptr_[component] != nullptr;
+  }
+
+  /**
+   * \brief Restrict the timeslice to the components selected by a filter.
+   *
+   * The subsystem and equipment identifiers are taken from the chunk
+   * descriptors, so only filters on microslice flags load the components.
+   */
+  void select_components(const ComponentFilter& filter) override;
+
+private:
+  friend class ChunkedTimesliceInputArchive;
+
+  /// A component of the timeslice and the location of its chunk.
+  struct Component {
+    ComponentChunkDescriptor chunk;
+    uint64_t offset; ///< file offset of the chunk
+  };
+
+  LazyTimeslice(std::shared_ptr<ComponentChunkReader> reader,
+                const TimesliceDescriptor& ts_desc,
+                std::vector<Component> components);
+
+  uint8_t* load_component(uint64_t component) const override;
+
+  std::shared_ptr<ComponentChunkReader> reader_;
+  std::vector<Component> components_;
+  /// component data once loaded
+  mutable std::vector<std::unique_ptr<uint8_t[]>> data_;
+};
+
+} // namespace fles
@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "MappedFile.hpp"
+#include "System.hpp"
+#include <cerrno>
+#include <fcntl.h>
+#include <ios>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace fles {
+
+MappedFile::MappedFile(std::string filename, bool sequential)
+    : filename_(std::move(filename)) {
+  int fd = open(filename_.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    throw std::ios_base::failure("error opening file \"" + filename_ +
+                                 "\": " + system::stringerror(errno));
+  }
+
+  struct stat st {};
+  if (fstat(fd, &st) == -1) {
+    int err = errno;
+    close(fd);
+    throw std::ios_base::failure("error accessing file \"" + filename_ +
+                                 "\": " + system::stringerror(err));
+  }
+  size_ = static_cast<std::size_t>(st.st_size);
+
+  if (size_ > 0) {
+    void* addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+      int err = errno;
+      close(fd);
+      throw std::ios_base::failure("error mapping file \"" + filename_ +
+                                   "\": " + system::stringerror(err));
+    }
+    // The contents are typically consumed front to back exactly once
+    madvise(addr, size_, sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+    data_ = static_cast<const uint8_t*>(addr);
+  }
+
+  // The mapping persists after the file descriptor has been closed
+  close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) {
+    munmap(const_cast<uint8_t*>(data_), size_);
+  }
+}
+
+} // namespace fles
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::MappedFile class.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace fles {
+
+/**
+ * \brief The MappedFile class maps the complete contents of a file read-only
+ * into the address space of the process.
+ *
+ * The mapping stays valid for the lifetime of the object. Objects of this
+ * class are typically held through a std::shared_ptr by all data structures
+ * pointing into the mapped pages.
+ */
+class MappedFile {
+public:
+  /**
+   * \brief Open the given file and map its contents.
+   *
+   * \param filename   File name of the file to map
+   * \param sequential Advise the kernel to read ahead for sequential access;
+   *                   otherwise, only the accessed pages are read
+   */
+  explicit MappedFile(std::string filename, bool sequential = true);
+
+  /// Delete copy constructor (non-copyable).
+  MappedFile(const MappedFile&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const MappedFile&) = delete;
+
+  ~MappedFile();
+
+  /// Retrieve a pointer to the start of the mapped file contents.
+  [[nodiscard]] const uint8_t* data() const { return data_; }
+
+  /// Retrieve the size of the mapped file in bytes.
+  [[nodiscard]] std::size_t size() const { return size_; }
+
+  /// Retrieve the file name of the mapped file.
+  [[nodiscard]] const std::string& filename() const { return filename_; }
+
+private:
+  std::string filename_;
+  const uint8_t* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+} // namespace fles
@@ -3,8 +3,11 @@
 /// \brief Defines the fles::MergingSource template class.
 #pragma once
 
-#include <algorithm>
+#include "PrefetchingSource.hpp"
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <queue>
 #include <vector>
 
 namespace fles {
@@ -14,6 +17,12 @@ namespace fles {
  * sources. Because of the way that data is provided by the source, one item
  * from every source has to be kept in memory at all times.
  *
+ * The sources are merged in ascending order of item index using a binary
+ * heap, so retrieving an item costs O(log k) for k sources. Items with equal
+ * index are returned in the order of their sources. Optionally, each source
+ * is wrapped in a PrefetchingSource, so that all sources are read in parallel
+ * and a single slow source does not stall the merged stream.
+ *
  * This class is meant to be used for detector debugging and similar special
  * cases, not for regular online operation.
  */
@@ -26,12 +35,21 @@ public:
    * sources, and start peeking into the item streams
    *
    * \param sources The input sources to read data from
+   * \param prefetch Number of items to read ahead from each source on a
+   * separate thread (0: read synchronously)
    */
-  MergingSource(std::vector<std::unique_ptr<SourceType>> sources)
+  MergingSource(std::vector<std::unique_ptr<SourceType>> sources,
+                std::size_t prefetch = 0)
       : sources_(std::move(sources)) {
     if (sources_.empty()) {
       eos_ = true;
     }
+    if (prefetch > 0) {
+      for (auto& source : sources_) {
+        source = std::make_unique<PrefetchingSource<SourceType>>(
+            std::move(source), prefetch);
+      }
+    }
   }
 
   /// Delete copy constructor (non-copyable).
@@ -44,15 +62,35 @@ public:
   [[nodiscard]] bool eos() const override { return eos_; }
 
 private:
+  /// Heap entry referring to the prefetched item of a given source.
+  struct HeapEntry {
+    uint64_t index;
+    std::size_t source;
+
+    // Inverted order for a min-heap in std::priority_queue
+    bool operator<(const HeapEntry& other) const {
+      return index != other.index ? index > other.index
+                                  : source > other.source;
+    }
+  };
+
   std::vector<std::unique_ptr<SourceType>> sources_;
   std::vector<std::unique_ptr<item_type>> prefetched_items_;
+  std::priority_queue<HeapEntry> heap_;
 
   bool eos_ = false;
 
+  void fetch(std::size_t source) {
+    prefetched_items_.at(source) = sources_.at(source)->get();
+    if (prefetched_items_[source]) {
+      heap_.push({prefetched_items_[source]->index(), source});
+    }
+  }
+
   void init_prefetch() {
-    for (auto& source : sources_) {
-      auto timeslice = source->get();
-      prefetched_items_.push_back(std::move(timeslice));
+    prefetched_items_.resize(sources_.size());
+    for (std::size_t source = 0; source < sources_.size(); ++source) {
+      fetch(source);
     }
   }
 
@@ -65,26 +103,15 @@ private:
       init_prefetch();
     }
 
-    auto item_it =
-        std::min_element(prefetched_items_.begin(), prefetched_items_.end(),
-                         [](const auto& a, const auto& b) {
-                           if (!a) {
-                             return false;
-                           }
-                           if (!b) {
-                             return true;
-                           }
-                           return a->index() < b->index();
-                         });
-    auto item_index = item_it - prefetched_items_.begin();
-
-    if (*item_it == nullptr) {
+    if (heap_.empty()) {
       eos_ = true;
       return nullptr;
     }
 
-    auto item = item_it->release();
-    prefetched_items_.at(item_index) = sources_.at(item_index)->get();
+    std::size_t source = heap_.top().source;
+    heap_.pop();
+    auto item = prefetched_items_.at(source).release();
+    fetch(source);
     return item;
   };
 };
@@ -26,6 +26,9 @@ public:
   /// Retrieve microslice descriptor reference
   [[nodiscard]] const MicrosliceDescriptor& desc() const { return *desc_ptr_; }
 
+  /// Retrieve the microslice index / start time
+  [[nodiscard]] uint64_t index() const { return desc_ptr_->idx; }
+
   /// Retrieve a pointer to the microslice data
   [[nodiscard]] const uint8_t* content() const { return content_ptr_; }
 
@@ -101,13 +101,17 @@ enum class HeaderFormatVersion : uint8_t { Standard = 0x01 };
  * \brief Microslice status and error flags.
  *
  * This enum defines the bits in the
- * fles::MicrosliceDescriptor::flags word.
+ * fles::MicrosliceDescriptor::flags word. CrcChecked and CrcError record the
+ * result of a CRC check on the compute node (see MicrosliceCrcChecker), so
+ * consumers need not verify the content again.
  */
 enum class MicrosliceFlags : uint16_t {
   CrcValid = 0x0001,     // information in CRC field is valid
   OverflowFlim = 0x0002, // truncated by FLIM
   OverflowUser = 0x0004, // truncated by user logic
-  DataError = 0x0008     // data error flag set by user logic
+  DataError = 0x0008,    // data error flag set by user logic
+  CrcChecked = 0x0010,   // CRC verified against the content by flesnet
+  CrcError = 0x0020      // CRC verification by flesnet failed
 };
 
 #pragma pack(1)
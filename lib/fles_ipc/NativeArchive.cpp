@@ -0,0 +1,555 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "NativeArchive.hpp"
+#include "MicrosliceDescriptor.hpp"
+#include "System.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+#ifdef __SSE4_2__
+  #include <nmmintrin.h>
+#endif
+
+namespace fles {
+
+namespace {
+
+#ifndef __SSE4_2__
+// Table of the reflected CRC-32C polynomial for the bytewise fallback
+const std::array<uint32_t, 256> crc32c_table = [] {
+  std::array<uint32_t, 256> table{};
+  for (uint32_t i = 0; i < table.size(); ++i) {
+    uint32_t crc = i;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ ((crc & 1) != 0 ? 0x82f63b78 : 0);
+    }
+    table[i] = crc;
+  }
+  return table;
+}();
+#endif
+
+// Copy a string into a null-padded fixed-size field
+template <std::size_t N>
+void copy_field(char (&field)[N], const std::string& value) {
+  std::memset(field, 0, N);
+  std::memcpy(field, value.data(), std::min(value.size(), N - 1));
+}
+
+} // namespace
+
+uint32_t crc32c(const void* data, std::size_t size, uint32_t crc) {
+  const auto* p = static_cast<const uint8_t*>(data);
+  crc = ~crc;
+#ifdef __SSE4_2__
+  uint64_t crc64 = crc;
+  for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t)) {
+    uint64_t word = 0;
+    std::memcpy(&word, p, sizeof(word));
+    crc64 = _mm_crc32_u64(crc64, word);
+    p += sizeof(uint64_t);
+  }
+  crc = static_cast<uint32_t>(crc64);
+  for (; size > 0; --size) {
+    crc = _mm_crc32_u8(crc, *p++);
+  }
+#else
+  for (; size > 0; --size) {
+    crc = (crc >> 8) ^ crc32c_table[(crc ^ *p++) & 0xff];
+  }
+#endif
+  return ~crc;
+}
+
+bool is_native_archive(const std::string& filename) {
+  auto stream = open_input_stream(filename);
+  std::array<char, sizeof(native_archive_magic)> magic{};
+  return *stream && stream->read(magic.data(), magic.size()) &&
+         std::memcmp(magic.data(), native_archive_magic, magic.size()) == 0;
+}
+
+NativeArchiveWriter::NativeArchiveWriter(const std::string& filename,
+                                         ArchiveType archive_type,
+                                         bool checksums,
+                                         const DirectIoParameters& direct_io,
+                                         bool overlap_refs,
+                                         bool microslice_blocks)
+    : ostream_(open_output_file(filename, direct_io)), checksums_(checksums),
+      overlap_refs_(overlap_refs), microslice_blocks_(microslice_blocks) {
+  if (overlap_refs && archive_type != ArchiveType::TimesliceArchive) {
+    throw std::runtime_error("Overlap references not supported for output "
+                             "archive file \"" +
+                             filename + "\"");
+  }
+  if (microslice_blocks && archive_type != ArchiveType::MicrosliceArchive) {
+    throw std::runtime_error("Microslice blocks not supported for output "
+                             "archive file \"" +
+                             filename + "\"");
+  }
+  NativeArchiveHeader header{};
+  std::memcpy(header.magic, native_archive_magic, sizeof(header.magic));
+  header.version = native_archive_version;
+  header.archive_type = static_cast<uint8_t>(archive_type);
+  header.flags = (checksums ? native_flag_checksums : 0) |
+                 (overlap_refs ? native_flag_overlap_refs : 0) |
+                 (microslice_blocks ? native_flag_microslice_blocks : 0);
+  header.header_size = sizeof(header);
+  header.time_created =
+      std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+  copy_field(header.hostname, system::current_hostname());
+  copy_field(header.username, system::current_username());
+  header.checksum = crc32c(&header, offsetof(NativeArchiveHeader, checksum));
+  ostream_->write(reinterpret_cast<const char*>(&header), sizeof(header));
+  if (!*ostream_) {
+    throw std::ios_base::failure("error writing output archive");
+  }
+}
+
+void NativeArchiveWriter::write(const Timeslice& timeslice) {
+  const uint64_t num_components = timeslice.num_components();
+  desc_.resize(num_components);
+  reused_.assign(num_components, 0);
+  blocks_.clear();
+  blocks_.push_back(
+      {&timeslice.timeslice_descriptor_, sizeof(TimesliceDescriptor)});
+  blocks_.push_back(
+      {desc_.data(), num_components * sizeof(TimesliceComponentDescriptor)});
+  if (overlap_refs_) {
+    blocks_.push_back({reused_.data(), num_components * sizeof(uint64_t)});
+    if (tails_.size() != num_components) {
+      tails_.assign(num_components, {});
+    }
+  }
+  for (uint64_t c = 0; c < num_components; ++c) {
+    desc_[c] = *timeslice.desc_ptr_[c];
+    const uint8_t* data = timeslice.component_data_ptr(c);
+    if (!overlap_refs_) {
+      blocks_.push_back({data, desc_[c].size});
+      continue;
+    }
+    const uint64_t k = reused_microslices(timeslice, c);
+    reused_[c] = k;
+    const uint64_t n = desc_[c].num_microslices;
+    const uint64_t desc_size = n * sizeof(MicrosliceDescriptor);
+    uint64_t reused_content = 0;
+    if (k != 0) {
+      const auto* md = reinterpret_cast<const MicrosliceDescriptor*>(data);
+      reused_content =
+          k < n ? md[k].offset - md[0].offset : desc_[c].size - desc_size;
+    }
+    blocks_.push_back({data + k * sizeof(MicrosliceDescriptor),
+                       desc_size - k * sizeof(MicrosliceDescriptor)});
+    blocks_.push_back({data + desc_size + reused_content,
+                       desc_[c].size - desc_size - reused_content});
+    update_tail(timeslice, c);
+  }
+  write_frame(blocks_);
+}
+
+uint64_t NativeArchiveWriter::reused_microslices(const Timeslice& timeslice,
+                                                 uint64_t component) {
+  const Tail& tail = tails_[component];
+  const uint64_t n = timeslice.num_microslices(component);
+  if (tail.desc.empty() || n == 0 || timeslice.content_omitted(component)) {
+    return 0;
+  }
+  const auto* md = reinterpret_cast<const MicrosliceDescriptor*>(
+      timeslice.component_data_ptr(component));
+  // locate the first microslice in the overlap of the preceding timeslice
+  const auto it = std::find_if(
+      tail.desc.begin(), tail.desc.end(), [md](const auto& desc) {
+        return std::memcmp(&desc, md, sizeof(MicrosliceDescriptor)) == 0;
+      });
+  const auto k = static_cast<uint64_t>(tail.desc.end() - it);
+  if (k == 0 || k > n ||
+      std::memcmp(&*it, md, k * sizeof(MicrosliceDescriptor)) != 0) {
+    return 0;
+  }
+  // the omitted contents have to end where those of the overlap end
+  const uint64_t content_size = timeslice.size_component(component) -
+                                n * sizeof(MicrosliceDescriptor);
+  const uint64_t end = k < n ? md[k].offset : md[0].offset + content_size;
+  return end == tail.end ? k : 0;
+}
+
+void NativeArchiveWriter::update_tail(const Timeslice& timeslice,
+                                      uint64_t component) {
+  Tail& tail = tails_[component];
+  tail.desc.clear();
+  const uint64_t n = timeslice.num_microslices(component);
+  const uint64_t core =
+      std::min<uint64_t>(n, timeslice.num_core_microslices());
+  if (core == n || timeslice.content_omitted(component)) {
+    return;
+  }
+  const auto* md = reinterpret_cast<const MicrosliceDescriptor*>(
+      timeslice.component_data_ptr(component));
+  tail.desc.assign(md + core, md + n);
+  tail.end = md[0].offset + timeslice.size_component(component) -
+             n * sizeof(MicrosliceDescriptor);
+}
+
+void NativeArchiveWriter::write(const Microslice& microslice) {
+  static constexpr uint64_t one = 1;
+  blocks_.clear();
+  if (microslice_blocks_) {
+    blocks_.push_back({&one, sizeof(one)});
+  }
+  blocks_.push_back({&microslice.desc(), sizeof(MicrosliceDescriptor)});
+  blocks_.push_back({microslice.content(), microslice.desc().size});
+  write_frame(blocks_);
+}
+
+void NativeArchiveWriter::write(
+    const std::vector<std::shared_ptr<const Microslice>>& microslices) {
+  if (!microslice_blocks_) {
+    for (const auto& microslice : microslices) {
+      write(*microslice);
+    }
+    return;
+  }
+  const uint64_t count = microslices.size();
+  block_desc_.clear();
+  blocks_.clear();
+  blocks_.push_back({&count, sizeof(count)});
+  // the descriptor array is located once it is complete
+  blocks_.push_back({nullptr, 0});
+  for (const auto& microslice : microslices) {
+    block_desc_.push_back(microslice->desc());
+    append_content(microslice->content(), microslice->desc().size);
+  }
+  blocks_[1] = {block_desc_.data(), count * sizeof(MicrosliceDescriptor)};
+  write_frame(blocks_);
+}
+
+void NativeArchiveWriter::append_content(const uint8_t* content,
+                                         std::size_t size) {
+  if (size == 0) {
+    return;
+  }
+  // extend the preceding content if adjacent in memory
+  constexpr std::size_t first_content = 2;
+  if (blocks_.size() > first_content) {
+    Block& last = blocks_.back();
+    if (static_cast<const uint8_t*>(last.data) + last.size == content) {
+      last.size += size;
+      return;
+    }
+  }
+  blocks_.push_back({content, size});
+}
+
+void NativeArchiveWriter::write_frame(const std::vector<Block>& blocks) {
+  NativeFrameHeader frame{native_frame_magic, 0, 0};
+  for (const auto& block : blocks) {
+    if (checksums_) {
+      frame.checksum = crc32c(block.data, block.size, frame.checksum);
+    }
+    frame.size += block.size;
+  }
+  ostream_->write(reinterpret_cast<const char*>(&frame), sizeof(frame));
+  for (const auto& block : blocks) {
+    ostream_->write(static_cast<const char*>(block.data),
+                    static_cast<std::streamsize>(block.size));
+  }
+  if (!*ostream_) {
+    throw std::ios_base::failure("error writing output archive");
+  }
+}
+
+NativeArchiveReader::NativeArchiveReader(const std::string& filename,
+                                         ArchiveType archive_type,
+                                         bool verify,
+                                         const RemoteParameters& remote)
+    : filename_(filename), stream_(open_input_stream(filename, remote)),
+      verify_(verify) {
+  if (!*stream_) {
+    throw std::ios_base::failure("error opening file \"" + filename + "\"");
+  }
+  if (!read_exactly(&header_, sizeof(header_)) ||
+      std::memcmp(header_.magic, native_archive_magic,
+                  sizeof(header_.magic)) != 0) {
+    throw std::runtime_error("File \"" + filename +
+                             "\" is not a native archive file");
+  }
+  if (header_.version != native_archive_version ||
+      header_.header_size != sizeof(header_) ||
+      header_.checksum !=
+          crc32c(&header_, offsetof(NativeArchiveHeader, checksum))) {
+    throw std::runtime_error("Unsupported or corrupt header of native "
+                             "archive file \"" +
+                             filename + "\"");
+  }
+  if (header_.archive_type != static_cast<uint8_t>(archive_type)) {
+    throw std::runtime_error("File \"" + filename +
+                             "\" is not of correct archive type");
+  }
+  verify_ = verify && (header_.flags & native_flag_checksums) != 0;
+}
+
+bool NativeArchiveReader::read_exactly(void* data, std::size_t size) {
+  stream_->read(static_cast<char*>(data), static_cast<std::streamsize>(size));
+  return static_cast<std::size_t>(stream_->gcount()) == size;
+}
+
+bool NativeArchiveReader::read_frame_header(NativeFrameHeader& frame) {
+  if (!read_exactly(&frame, sizeof(frame))) {
+    if (stream_->gcount() != 0) {
+      std::cerr << "NativeArchiveReader: ignoring truncated frame at end of "
+                   "archive file"
+                << std::endl;
+    }
+    return false;
+  }
+  if (frame.magic != native_frame_magic) {
+    throw std::runtime_error("corrupt frame in native archive file \"" +
+                             filename_ + "\"");
+  }
+  return true;
+}
+
+void NativeArchiveReader::check(const NativeFrameHeader& frame,
+                                uint32_t crc) const {
+  if (verify_ && crc != frame.checksum) {
+    throw std::runtime_error("checksum mismatch in native archive file \"" +
+                             filename_ + "\"");
+  }
+}
+
+StorableTimeslice* NativeArchiveReader::read_timeslice() {
+  NativeFrameHeader frame{};
+  if (!read_frame_header(frame)) {
+    return nullptr;
+  }
+  // read the next part of the payload, checking the size of the frame
+  uint64_t size = 0;
+  uint32_t crc = 0;
+  auto read_part = [&](void* data, uint64_t part_size) {
+    size += part_size;
+    if (size > frame.size) {
+      inconsistent();
+    }
+    if (!read_exactly(data, part_size)) {
+      return false;
+    }
+    if (verify_) {
+      crc = crc32c(data, part_size, crc);
+    }
+    return true;
+  };
+
+  std::unique_ptr<StorableTimeslice> sts(new StorableTimeslice());
+  auto& ts_desc = sts->timeslice_descriptor_;
+  const bool overlap_refs = (header_.flags & native_flag_overlap_refs) != 0;
+  bool complete = read_part(&ts_desc, sizeof(ts_desc));
+  if (complete) {
+    sts->desc_.resize(ts_desc.num_components);
+    complete = read_part(sts->desc_.data(),
+                         ts_desc.num_components *
+                             sizeof(TimesliceComponentDescriptor));
+  }
+  reused_.assign(ts_desc.num_components, 0);
+  if (complete && overlap_refs) {
+    complete =
+        read_part(reused_.data(), ts_desc.num_components * sizeof(uint64_t));
+  }
+  for (uint64_t c = 0; complete && c < ts_desc.num_components; ++c) {
+    const TimesliceComponentDescriptor& desc = sts->desc_[c];
+    const uint64_t desc_size =
+        desc.num_microslices * sizeof(MicrosliceDescriptor);
+    TimesliceArenaBuffer& data = sts->data_.emplace_back(desc.size);
+    const uint64_t k = reused_[c];
+    if (k == 0) {
+      complete = read_part(data.data(), data.size());
+      continue;
+    }
+    // take the leading microslices from the preceding timeslice
+    if (c >= tails_.size() || k > tails_[c].desc.size() ||
+        k > desc.num_microslices) {
+      inconsistent();
+    }
+    const Tail& tail = tails_[c];
+    const std::size_t t = tail.desc.size();
+    const uint64_t reused_content =
+        tail.content.size() - (tail.desc[t - k].offset - tail.desc[0].offset);
+    if (desc_size + reused_content > desc.size) {
+      inconsistent();
+    }
+    auto* out = reinterpret_cast<uint8_t*>(data.data());
+    std::memcpy(out, &tail.desc[t - k], k * sizeof(MicrosliceDescriptor));
+    std::memcpy(out + desc_size,
+                tail.content.data() + tail.content.size() - reused_content,
+                reused_content);
+    complete = read_part(out + k * sizeof(MicrosliceDescriptor),
+                         desc_size - k * sizeof(MicrosliceDescriptor)) &&
+               read_part(out + desc_size + reused_content,
+                         desc.size - desc_size - reused_content);
+  }
+  if (!complete) {
+    std::cerr << "NativeArchiveReader: ignoring truncated frame at end of "
+                 "archive file"
+              << std::endl;
+    return nullptr;
+  }
+  if (size != frame.size) {
+    inconsistent();
+  }
+  check(frame, crc);
+  sts->init_pointers();
+  if (overlap_refs) {
+    tails_.resize(sts->num_components());
+    for (uint64_t c = 0; c < sts->num_components(); ++c) {
+      update_tail(*sts, c);
+    }
+  }
+  return sts.release();
+}
+
+void NativeArchiveReader::update_tail(const StorableTimeslice& timeslice,
+                                      uint64_t component) {
+  Tail& tail = tails_[component];
+  tail.desc.clear();
+  tail.content.clear();
+  const uint64_t n = timeslice.num_microslices(component);
+  const uint64_t core =
+      std::min<uint64_t>(n, timeslice.num_core_microslices());
+  if (core == n || timeslice.content_omitted(component)) {
+    return;
+  }
+  const auto* data =
+      reinterpret_cast<const uint8_t*>(timeslice.data_[component].data());
+  const auto* md = reinterpret_cast<const MicrosliceDescriptor*>(data);
+  tail.desc.assign(md + core, md + n);
+  const uint8_t* end = data + timeslice.size_component(component);
+  tail.content.assign(data + n * sizeof(MicrosliceDescriptor) +
+                          (md[core].offset - md[0].offset),
+                      end);
+}
+
+void NativeArchiveReader::inconsistent() const {
+  throw std::runtime_error("inconsistent frame in native archive file \"" +
+                           filename_ + "\"");
+}
+
+StorableMicroslice* NativeArchiveReader::read_microslice() {
+  if ((header_.flags & native_flag_microslice_blocks) == 0) {
+    return read_single_microslice();
+  }
+  while (!block_ || block_index_ == block_->size()) {
+    block_.reset(read_block());
+    block_index_ = 0;
+    if (!block_) {
+      return nullptr;
+    }
+  }
+  return new StorableMicroslice( // NOLINT
+      block_->microslices()[block_index_++]);
+}
+
+NativeMicrosliceBlock* NativeArchiveReader::read_microslice_block() {
+  if ((header_.flags & native_flag_microslice_blocks) != 0) {
+    if (block_ && block_index_ != block_->size()) {
+      auto& views = block_->views_;
+      views.erase(views.begin(),
+                  views.begin() + static_cast<std::ptrdiff_t>(block_index_));
+      block_index_ = 0;
+      return block_.release();
+    }
+    return read_block();
+  }
+  std::unique_ptr<StorableMicroslice> microslice(read_single_microslice());
+  if (!microslice) {
+    return nullptr;
+  }
+  std::unique_ptr<NativeMicrosliceBlock> block(new NativeMicrosliceBlock());
+  block->desc_.push_back(microslice->desc());
+  block->content_.assign(microslice->content(),
+                         microslice->content() + microslice->desc().size);
+  block->views_.emplace_back(block->desc_.front(), block->content_.data());
+  return block.release();
+}
+
+NativeMicrosliceBlock* NativeArchiveReader::read_block() {
+  NativeFrameHeader frame{};
+  if (!read_frame_header(frame)) {
+    return nullptr;
+  }
+  uint64_t count = 0;
+  if (frame.size < sizeof(count)) {
+    inconsistent();
+  }
+  std::unique_ptr<NativeMicrosliceBlock> block(new NativeMicrosliceBlock());
+  bool complete = read_exactly(&count, sizeof(count));
+  if (complete) {
+    if (count > (frame.size - sizeof(count)) / sizeof(MicrosliceDescriptor)) {
+      inconsistent();
+    }
+    block->desc_.resize(count);
+    block->content_.resize(frame.size - sizeof(count) -
+                           count * sizeof(MicrosliceDescriptor));
+    complete = read_exactly(block->desc_.data(),
+                            count * sizeof(MicrosliceDescriptor)) &&
+               read_exactly(block->content_.data(), block->content_.size());
+  }
+  if (!complete) {
+    std::cerr << "NativeArchiveReader: ignoring truncated frame at end of "
+                 "archive file"
+              << std::endl;
+    return nullptr;
+  }
+  // the contents follow each other in the order of the descriptors
+  uint64_t offset = 0;
+  block->views_.reserve(count);
+  for (auto& desc : block->desc_) {
+    if (desc.size > block->content_.size() - offset) {
+      inconsistent();
+    }
+    block->views_.emplace_back(desc, block->content_.data() + offset);
+    offset += desc.size;
+  }
+  if (offset != block->content_.size()) {
+    inconsistent();
+  }
+  if (verify_) {
+    uint32_t crc = crc32c(&count, sizeof(count));
+    crc = crc32c(block->desc_.data(), count * sizeof(MicrosliceDescriptor),
+                 crc);
+    check(frame, crc32c(block->content_.data(), block->content_.size(), crc));
+  }
+  return block.release();
+}
+
+StorableMicroslice* NativeArchiveReader::read_single_microslice() {
+  NativeFrameHeader frame{};
+  if (!read_frame_header(frame)) {
+    return nullptr;
+  }
+  MicrosliceDescriptor desc{};
+  if (frame.size < sizeof(desc)) {
+    inconsistent();
+  }
+  std::vector<uint8_t> content(frame.size - sizeof(desc));
+  if (!read_exactly(&desc, sizeof(desc)) ||
+      !read_exactly(content.data(), content.size())) {
+    std::cerr << "NativeArchiveReader: ignoring truncated frame at end of "
+                 "archive file"
+              << std::endl;
+    return nullptr;
+  }
+  if (desc.size != content.size()) {
+    inconsistent();
+  }
+  if (verify_) {
+    check(frame, crc32c(content.data(), content.size(),
+                        crc32c(&desc, sizeof(desc))));
+  }
+  return new StorableMicroslice(desc, std::move(content)); // NOLINT
+}
+
+} // namespace fles
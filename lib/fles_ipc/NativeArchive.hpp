@@ -0,0 +1,296 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the native (version 2) archive file format and the
+/// fles::NativeArchiveWriter and fles::NativeArchiveReader classes.
+#pragma once
+
+#include "ArchiveDescriptor.hpp"
+#include "DirectFileBuffer.hpp"
+#include "Microslice.hpp"
+#include "MicrosliceDescriptor.hpp"
+#include "MicrosliceView.hpp"
+#include "RemoteStream.hpp"
+#include "StorableMicroslice.hpp"
+#include "StorableTimeslice.hpp"
+#include "Timeslice.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fles {
+
+#pragma pack(1)
+
+/**
+ * \brief Header of a native archive file.
+ *
+ * A native archive file stores its items without boost::serialization. It
+ * consists of this fixed-layout header followed by one frame per item, each
+ * a NativeFrameHeader followed by the payload:
+ *
+ * - timeslice archives: the TimesliceDescriptor, the
+ *   TimesliceComponentDescriptor table (num_components entries) and the
+ *   component data blocks (microslice descriptors followed by microslice
+ *   contents) in component order, and
+ * - microslice archives: the MicrosliceDescriptor followed by the content.
+ *
+ * With native_flag_microslice_blocks set, each frame of a microslice archive
+ * holds a block of consecutive microslices instead: the number of microslices
+ * (uint64_t), their MicrosliceDescriptor array, and their contents
+ * concatenated in the same order. This reduces the per-item overhead for
+ * channels producing many small microslices.
+ *
+ * All integers are stored in native (little-endian) byte order. The items
+ * are stored uncompressed; the chunked timeslice archive covers compression.
+ *
+ * With native_flag_overlap_refs set, the overlap microslices of a timeslice
+ * component, which are the first core microslices of the same component of
+ * the next timeslice, are stored once. The component descriptor table of a
+ * timeslice is then followed by a table of the number of leading
+ * microslices of each component (uint64_t) taken from the end of the same
+ * component of the preceding timeslice in the file. They are omitted from
+ * the stored block, which holds the remaining microslice descriptors
+ * followed by the remaining contents. The component descriptors give the
+ * size of the reconstructed component.
+ */
+struct NativeArchiveHeader {
+  /// Magic string identifying the format ("FLESARC2").
+  char magic[8];
+  /// Version of the format (native_archive_version).
+  uint16_t version;
+  /// Archive type (an ArchiveType).
+  uint8_t archive_type;
+  /// Flags (see native_flag_checksums, native_flag_overlap_refs and
+  /// native_flag_microslice_blocks).
+  uint8_t flags;
+  /// Size of this header (in bytes).
+  uint32_t header_size;
+  /// Time of creation of the archive (seconds since the epoch).
+  int64_t time_created;
+  /// Null-padded hostname of the machine creating the archive.
+  char hostname[64];
+  /// Null-padded name of the user creating the archive.
+  char username[32];
+  /// Reserved, set to zero.
+  uint32_t reserved;
+  /// CRC-32C checksum of the preceding header bytes.
+  uint32_t checksum;
+};
+
+/// Header of a frame of a native archive file (see NativeArchiveHeader).
+struct NativeFrameHeader {
+  /// Frame marker (native_frame_magic).
+  uint32_t magic;
+  /// CRC-32C checksum of the payload (0 if not computed).
+  uint32_t checksum;
+  /// Size of the payload (in bytes).
+  uint64_t size;
+};
+
+#pragma pack()
+
+/// Version of the native archive format.
+constexpr uint16_t native_archive_version = 2;
+
+/// Magic string at the start of a native archive file.
+constexpr char native_archive_magic[8] = {'F', 'L', 'E', 'S',
+                                          'A', 'R', 'C', '2'};
+
+/// Frame marker of a native archive file ("FRM2").
+constexpr uint32_t native_frame_magic = 0x324d5246;
+
+/// Header flag: the frames carry payload checksums.
+constexpr uint8_t native_flag_checksums = 0x01;
+
+/// Header flag: overlap microslices are stored once (timeslice archives).
+constexpr uint8_t native_flag_overlap_refs = 0x02;
+
+/// Header flag: the frames hold blocks of microslices (microslice archives).
+constexpr uint8_t native_flag_microslice_blocks = 0x04;
+
+/// Compute the CRC-32C checksum of a buffer, continuing from the checksum
+/// of the preceding data (0 at the start).
+uint32_t crc32c(const void* data, std::size_t size, uint32_t crc = 0);
+
+/// Check whether a local or remote file is a native archive file.
+bool is_native_archive(const std::string& filename);
+
+/**
+ * \brief The NativeArchiveWriter class writes items to a native archive
+ * file (see NativeArchiveHeader).
+ *
+ * The component data is written from the items without copying it into
+ * intermediate buffers. With overlap references, a leading run of
+ * microslices of a component is omitted if its descriptors are identical to
+ * the trailing overlap microslices of the same component of the preceding
+ * timeslice, i.e., if they stem from the same input data. In a block of
+ * microslices, the contents of consecutive microslices adjacent in memory
+ * (e.g., views into the data buffer of an input channel) are written as one
+ * contiguous part.
+ */
+class NativeArchiveWriter {
+public:
+  /**
+   * \brief Create the archive file and write its header.
+   *
+   * \param filename     File name of the archive file
+   * \param archive_type Type of the items stored in the archive
+   * \param checksums    Compute the frame checksums
+   * \param direct_io    Direct I/O parameters of the archive file
+   * \param overlap_refs Store overlap microslices once (timeslice archives
+   *                     only)
+   * \param microslice_blocks Store blocks of microslices (microslice
+   *                          archives only)
+   */
+  NativeArchiveWriter(const std::string& filename,
+                      ArchiveType archive_type,
+                      bool checksums = true,
+                      const DirectIoParameters& direct_io = {},
+                      bool overlap_refs = false,
+                      bool microslice_blocks = false);
+
+  /// Write a timeslice.
+  void write(const Timeslice& timeslice);
+
+  /// Write a microslice.
+  void write(const Microslice& microslice);
+
+  /// Write a block of microslices (one by one unless storing blocks).
+  void write(const std::vector<std::shared_ptr<const Microslice>>& microslices);
+
+private:
+  /// A contiguous part of a frame payload.
+  struct Block {
+    const void* data;
+    std::size_t size;
+  };
+
+  /// The overlap microslices of a component of the preceding timeslice.
+  struct Tail {
+    std::vector<MicrosliceDescriptor> desc;
+    /// end of the component contents (in terms of the descriptor offsets)
+    uint64_t end = 0;
+  };
+
+  void write_frame(const std::vector<Block>& blocks);
+  void append_content(const uint8_t* content, std::size_t size);
+  uint64_t reused_microslices(const Timeslice& timeslice, uint64_t component);
+  void update_tail(const Timeslice& timeslice, uint64_t component);
+
+  std::unique_ptr<std::ostream> ostream_;
+  bool checksums_;
+  bool overlap_refs_;
+  bool microslice_blocks_;
+  std::vector<TimesliceComponentDescriptor> desc_;
+  std::vector<MicrosliceDescriptor> block_desc_;
+  std::vector<uint64_t> reused_;
+  std::vector<Tail> tails_;
+  std::vector<Block> blocks_;
+};
+
+/**
+ * \brief The NativeMicrosliceBlock class provides access to a block of
+ * microslices read from a native archive file.
+ *
+ * The descriptors and the contents of the block are stored in one array
+ * each, which the MicrosliceView objects of the block refer to.
+ */
+class NativeMicrosliceBlock {
+public:
+  /// Delete copy constructor (non-copyable).
+  NativeMicrosliceBlock(const NativeMicrosliceBlock&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const NativeMicrosliceBlock&) = delete;
+
+  /// Retrieve the number of microslices in the block.
+  [[nodiscard]] std::size_t size() const { return views_.size(); }
+
+  /// Retrieve the microslices of the block.
+  [[nodiscard]] const std::vector<MicrosliceView>& microslices() const {
+    return views_;
+  }
+
+private:
+  friend class NativeArchiveReader;
+
+  NativeMicrosliceBlock() = default;
+
+  std::vector<MicrosliceDescriptor> desc_;
+  std::vector<uint8_t> content_;
+  std::vector<MicrosliceView> views_;
+};
+
+/**
+ * \brief The NativeArchiveReader class reads items from a native archive
+ * file (see NativeArchiveHeader).
+ *
+ * The component data is read in one block per component directly into the
+ * storage of the returned item. A truncated last frame is ignored. The
+ * overlap microslices of the last timeslice read are kept to reconstruct
+ * the components of the next one if the archive stores them once. Blocks
+ * of microslices are read in one piece, and read_microslice() returns their
+ * microslices one by one.
+ */
+class NativeArchiveReader {
+public:
+  /**
+   * \brief Open the archive file and read its header.
+   *
+   * \param filename     File name (or "http://" URL) of the archive file
+   * \param archive_type Expected type of the items stored in the archive
+   * \param verify       Verify the frame checksums, if present
+   * \param remote       Access parameters of a remote archive file
+   */
+  NativeArchiveReader(const std::string& filename,
+                      ArchiveType archive_type,
+                      bool verify = true,
+                      const RemoteParameters& remote = {});
+
+  /// Retrieve the archive header.
+  [[nodiscard]] const NativeArchiveHeader& header() const { return header_; }
+
+  /// Read the next timeslice, nullptr at the end of the file.
+  StorableTimeslice* read_timeslice();
+
+  /// Read the next microslice, nullptr at the end of the file.
+  StorableMicroslice* read_microslice();
+
+  /// Read the next block of microslices, nullptr at the end of the file.
+  /** A microslice archive without blocks yields blocks of one microslice.
+      The remaining microslices of a block partially returned by
+      read_microslice() are returned first. */
+  NativeMicrosliceBlock* read_microslice_block();
+
+private:
+  bool read_frame_header(NativeFrameHeader& frame);
+  bool read_exactly(void* data, std::size_t size);
+  StorableMicroslice* read_single_microslice();
+  NativeMicrosliceBlock* read_block();
+  void check(const NativeFrameHeader& frame, uint32_t crc) const;
+  [[noreturn]] void inconsistent() const;
+
+  /// The overlap microslices of a component of the preceding timeslice.
+  struct Tail {
+    std::vector<MicrosliceDescriptor> desc;
+    std::vector<uint8_t> content;
+  };
+
+  void update_tail(const StorableTimeslice& timeslice, uint64_t component);
+
+  std::string filename_;
+  std::unique_ptr<std::istream> stream_;
+  NativeArchiveHeader header_{};
+  bool verify_;
+  std::vector<uint64_t> reused_;
+  std::vector<Tail> tails_;
+  /// The block of microslices returned by read_microslice()
+  std::unique_ptr<NativeMicrosliceBlock> block_;
+  /// Number of microslices of block_ already returned
+  std::size_t block_index_ = 0;
+};
+
+} // namespace fles
@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::NativeInputArchive template class.
+#pragma once
+
+#include "NativeArchive.hpp"
+#include "Source.hpp"
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief The NativeInputArchive class reads data sets from one or more input
+ * files in the native archive format (see NativeArchiveHeader).
+ *
+ * Archive files written by OutputArchive (through boost::serialization) are
+ * read by InputArchive instead; is_native_archive() tells them apart.
+ */
+template <class Base, class Derived, ArchiveType archive_type>
+class NativeInputArchive : public Source<Base> {
+public:
+  /**
+   * \brief Construct an input archive object for a sequence of archive files,
+   * which are read one after the other.
+   *
+   * \param filenames File names (or "http://" URLs) of the archive files
+   * \param verify    Verify the frame checksums, if present
+   * \param remote    Access parameters of remote archive files
+   */
+  explicit NativeInputArchive(std::vector<std::string> filenames,
+                              bool verify = true,
+                              const RemoteParameters& remote = {})
+      : filenames_(std::move(filenames)), verify_(verify), remote_(remote) {
+    next_file();
+  }
+
+  /**
+   * \brief Construct an input archive object for the given archive file.
+   *
+   * \param filename File name (or "http://" URL) of the archive file
+   * \param verify   Verify the frame checksums, if present
+   */
+  explicit NativeInputArchive(const std::string& filename, bool verify = true)
+      : NativeInputArchive(std::vector<std::string>{filename}, verify) {}
+
+  /// Delete copy constructor (non-copyable).
+  NativeInputArchive(const NativeInputArchive&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const NativeInputArchive&) = delete;
+
+  ~NativeInputArchive() override = default;
+
+  /// Read the next data set.
+  std::unique_ptr<Derived> get() { return std::unique_ptr<Derived>(do_get()); };
+
+  /// Read the next block of microslices (microslice archives only, see
+  /// NativeArchiveReader::read_microslice_block()).
+  std::unique_ptr<NativeMicrosliceBlock> get_block() {
+    static_assert(archive_type == ArchiveType::MicrosliceArchive,
+                  "blocks are read from microslice archives only");
+    while (!eos_) {
+      if (NativeMicrosliceBlock* block = reader_->read_microslice_block()) {
+        return std::unique_ptr<NativeMicrosliceBlock>(block);
+      }
+      next_file();
+    }
+    return nullptr;
+  }
+
+  /// Retrieve the header of the current archive file.
+  [[nodiscard]] const NativeArchiveHeader& header() const {
+    return reader_->header();
+  };
+
+  [[nodiscard]] bool eos() const override { return eos_; }
+
+private:
+  std::vector<std::string> filenames_;
+  std::size_t file_count_ = 0;
+  bool verify_;
+  RemoteParameters remote_;
+  std::unique_ptr<NativeArchiveReader> reader_;
+  bool eos_ = false;
+
+  void next_file() {
+    if (file_count_ >= filenames_.size()) {
+      eos_ = true;
+      return;
+    }
+    reader_ = std::make_unique<NativeArchiveReader>(
+        filenames_.at(file_count_), archive_type, verify_, remote_);
+    ++file_count_;
+  }
+
+  void do_get_batch(std::vector<std::unique_ptr<Base>>& items,
+                    std::size_t max_items,
+                    std::chrono::nanoseconds /* timeout */) override {
+    this->get_available(items, max_items);
+  }
+
+  Derived* do_get() override {
+    while (!eos_) {
+      Derived* item = nullptr;
+      if constexpr (archive_type == ArchiveType::TimesliceArchive) {
+        item = reader_->read_timeslice();
+      } else {
+        item = reader_->read_microslice();
+      }
+      if (item != nullptr) {
+        return item;
+      }
+      next_file();
+    }
+    return nullptr;
+  }
+};
+
+using NativeTimesliceInputArchive =
+    NativeInputArchive<Timeslice,
+                       StorableTimeslice,
+                       ArchiveType::TimesliceArchive>;
+
+using NativeMicrosliceInputArchive =
+    NativeInputArchive<Microslice,
+                       StorableMicroslice,
+                       ArchiveType::MicrosliceArchive>;
+
+} // namespace fles
@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::NativeMicrosliceBlockOutputArchive class.
+#pragma once
+
+#include "NativeArchive.hpp"
+#include "Sink.hpp"
+#include "log.hpp"
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief The NativeMicrosliceBlockOutputArchive class writes microslices to
+ * an output file in the native archive format, collected into blocks (see
+ * native_flag_microslice_blocks).
+ *
+ * The microslices of a block are held until the block is written. Views into
+ * the data buffer of an input channel (see MicrosliceReceiver::set_zero_copy)
+ * are thereby written directly from the buffer, the contents of consecutive
+ * microslices in one piece. The last, partial block is written by
+ * end_stream() or on destruction.
+ */
+class NativeMicrosliceBlockOutputArchive : public Sink<Microslice> {
+public:
+  /**
+   * \brief Construct an output archive object, open the given archive file
+   * for writing, and write the archive header.
+   *
+   * \param filename          File name of the archive file
+   * \param block_microslices Maximum number of microslices per block
+   * \param block_bytes       Content size (in bytes) completing a block
+   * \param checksums         Compute the frame checksums
+   * \param direct_io         Direct I/O parameters of the archive file
+   */
+  explicit NativeMicrosliceBlockOutputArchive(
+      const std::string& filename,
+      std::size_t block_microslices = 4096,
+      std::size_t block_bytes = std::size_t{4} << 20,
+      bool checksums = true,
+      const DirectIoParameters& direct_io = {})
+      : writer_(filename,
+                ArchiveType::MicrosliceArchive,
+                checksums,
+                direct_io,
+                false,
+                true),
+        block_microslices_(block_microslices), block_bytes_(block_bytes) {
+    microslices_.reserve(block_microslices_);
+  }
+
+  /// Delete copy constructor (non-copyable).
+  NativeMicrosliceBlockOutputArchive(
+      const NativeMicrosliceBlockOutputArchive&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const NativeMicrosliceBlockOutputArchive&) = delete;
+
+  ~NativeMicrosliceBlockOutputArchive() override {
+    try {
+      flush();
+    } catch (const std::exception& e) {
+      L_(error) << e.what();
+    }
+  }
+
+  /// Store an item.
+  void put(std::shared_ptr<const Microslice> item) override {
+    bytes_ += item->desc().size;
+    microslices_.push_back(std::move(item));
+    if (microslices_.size() >= block_microslices_ || bytes_ >= block_bytes_) {
+      flush();
+    }
+  }
+
+  void end_stream() override { flush(); }
+
+  /// Write the pending microslices as a block.
+  void flush() {
+    if (microslices_.empty()) {
+      return;
+    }
+    writer_.write(microslices_);
+    microslices_.clear();
+    bytes_ = 0;
+  }
+
+private:
+  NativeArchiveWriter writer_;
+  std::size_t block_microslices_;
+  std::size_t block_bytes_;
+  /// microslices of the pending block
+  std::vector<std::shared_ptr<const Microslice>> microslices_;
+  /// content size of the pending block
+  std::size_t bytes_ = 0;
+};
+
+} // namespace fles
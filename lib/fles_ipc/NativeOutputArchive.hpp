@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::NativeOutputArchive template class.
+#pragma once
+
+#include "NativeArchive.hpp"
+#include "Sink.hpp"
+#include <memory>
+#include <string>
+
+namespace fles {
+
+/**
+ * \brief The NativeOutputArchive class writes data sets to an output file in
+ * the native archive format (see NativeArchiveHeader).
+ *
+ * Any timeslice or microslice (e.g., a view into shared memory) is written
+ * directly from its data.
+ */
+template <class Base, ArchiveType archive_type>
+class NativeOutputArchive : public Sink<Base> {
+public:
+  /**
+   * \brief Construct an output archive object, open the given archive file
+   * for writing, and write the archive header.
+   *
+   * \param filename  File name of the archive file
+   * \param checksums    Compute the frame checksums
+   * \param direct_io    Direct I/O parameters of the archive file
+   * \param overlap_refs Store the overlap microslices of consecutive
+   *                     timeslices once (timeslice archives only)
+   */
+  explicit NativeOutputArchive(const std::string& filename,
+                               bool checksums = true,
+                               const DirectIoParameters& direct_io = {},
+                               bool overlap_refs = false)
+      : writer_(filename, archive_type, checksums, direct_io, overlap_refs) {}
+
+  /// Delete copy constructor (non-copyable).
+  NativeOutputArchive(const NativeOutputArchive&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const NativeOutputArchive&) = delete;
+
+  ~NativeOutputArchive() override = default;
+
+  /// Store an item.
+  void put(std::shared_ptr<const Base> item) override { writer_.write(*item); }
+
+private:
+  NativeArchiveWriter writer_;
+};
+
+using NativeTimesliceOutputArchive =
+    NativeOutputArchive<Timeslice, ArchiveType::TimesliceArchive>;
+
+using NativeMicrosliceOutputArchive =
+    NativeOutputArchive<Microslice, ArchiveType::MicrosliceArchive>;
+
+} // namespace fles
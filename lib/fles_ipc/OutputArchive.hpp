@@ -4,13 +4,18 @@
 #pragma once
 
 #include "ArchiveDescriptor.hpp"
+#include "ArchiveIndex.hpp"
+#include "DescriptorCodec.hpp"
+#include "DirectFileBuffer.hpp"
 #include "Sink.hpp"
+#include "TimesliceSerializer.hpp"
+#include "ZstdFrameCompressor.hpp"
 #include <boost/archive/binary_oarchive.hpp>
 #ifdef BOOST_IOS_HAS_ZSTD
   #include <boost/iostreams/filter/zstd.hpp>
 #endif
 #include <boost/iostreams/filtering_stream.hpp>
-#include <fstream>
+#include <memory>
 #include <string>
 
 namespace fles {
@@ -27,14 +32,32 @@ public:
    *
    * \param filename File name of the archive file
    * \param compression Compression type to use
+   * \param write_index Write an index sidecar file (timeslice archives only)
+   * \param zstd_parameters Level and number of threads for zstd compression
+   * \param direct_io       Direct I/O parameters of the archive file
+   * \param descriptor_encoding Encoding of the microslice descriptors
    */
   explicit OutputArchive(
       const std::string& filename,
-      ArchiveCompression compression = ArchiveCompression::None)
-      : ofstream_(filename, std::ios::binary), descriptor_{archive_type,
-                                                           compression} {
+      ArchiveCompression compression = ArchiveCompression::None,
+      bool write_index = false,
+      const ZstdParameters& zstd_parameters = {},
+      const DirectIoParameters& direct_io = {},
+      DescriptorEncoding descriptor_encoding = DescriptorEncoding::Verbatim)
+      : ostream_(open_output_file(filename, direct_io)),
+        descriptor_{archive_type, compression, descriptor_encoding} {
+    if (write_index) {
+      if (archive_type != ArchiveType::TimesliceArchive ||
+          compression != ArchiveCompression::None) {
+        throw std::runtime_error(
+            "Index not supported for output archive file \"" + filename +
+            "\"");
+      }
+      index_writer_ = std::make_unique<ArchiveIndexWriter>(
+          ArchiveIndex::sidecar_filename(filename));
+    }
 
-    oarchive_ = std::make_unique<boost::archive::binary_oarchive>(ofstream_);
+    oarchive_ = std::make_unique<boost::archive::binary_oarchive>(*ostream_);
 
     *oarchive_ << descriptor_;
 
@@ -42,14 +65,13 @@ public:
 #ifdef BOOST_IOS_HAS_ZSTD
       out_ = std::make_unique<boost::iostreams::filtering_ostream>();
       if (compression == ArchiveCompression::Zstd) {
-        out_->push(boost::iostreams::zstd_compressor(
-            boost::iostreams::zstd::best_speed));
+        push_zstd_compressor(*out_, zstd_parameters);
       } else {
         throw std::runtime_error(
             "Unsupported compression type for output archive file \"" +
             filename + "\"");
       }
-      out_->push(ofstream_);
+      out_->push(*ostream_);
       oarchive_ = std::make_unique<boost::archive::binary_oarchive>(
           *out_, boost::archive::no_header);
 #else
@@ -68,16 +90,72 @@ public:
   ~OutputArchive() override = default;
 
   /// Store an item.
-  void put(std::shared_ptr<const Base> item) override { do_put(*item); }
+  void put(std::shared_ptr<const Base> item) override {
+    if constexpr (archive_type == ArchiveType::TimesliceArchive) {
+      // any timeslice (e.g., a view into shared memory) is written directly
+      do_put(*item, TimesliceSerializer(*item));
+    } else if (const auto* derived = dynamic_cast<const Derived*>(item.get())) {
+      do_put(*derived, *derived);
+    } else if constexpr (archive_type == ArchiveType::MicrosliceArchive) {
+      // e.g., views into a receive buffer: copy into reused storage
+      if (!buffer_) {
+        buffer_ = std::make_unique<Derived>(*item);
+      } else {
+        buffer_->assign(*item);
+      }
+      do_put(*buffer_, *buffer_);
+    } else {
+      const Derived copy(*item);
+      do_put(copy, copy);
+    }
+  }
+
+  /// Store an item given in serialized form.
+  /** The data has to be serialized in the format and descriptor encoding of
+      this archive, without boost class information, i.e., as written after
+      the first item of its class in another archive (cf. the index entries
+      of an archive). The item is copied verbatim.
+      \param entry the index entry of the item (timeslice archives only) */
+  void put_serialized(const uint8_t* data,
+                      std::size_t size,
+                      const ArchiveIndexEntry& entry = {}) {
+    uint64_t offset =
+        index_writer_ ? static_cast<uint64_t>(ostream_->tellp()) : 0;
+    std::ostream& out = out_ ? static_cast<std::ostream&>(*out_) : *ostream_;
+    out.write(reinterpret_cast<const char*>(data),
+              static_cast<std::streamsize>(size));
+    if (!out) {
+      throw std::ios_base::failure("error writing output archive");
+    }
+    if (index_writer_) {
+      index_writer_->add({entry.index, offset, size, entry.start_time});
+    }
+  }
 
 private:
-  std::ofstream ofstream_;
+  std::unique_ptr<std::ostream> ostream_;
   std::unique_ptr<boost::iostreams::filtering_ostream> out_;
   std::unique_ptr<boost::archive::binary_oarchive> oarchive_;
   ArchiveDescriptor descriptor_;
+  DescriptorCodec codec_;
+  std::unique_ptr<ArchiveIndexWriter> index_writer_;
+  /// Storage for serializing items which are not of the derived type.
+  std::unique_ptr<Derived> buffer_;
 
-  void do_put(const Derived& item) { *oarchive_ << item; }
-  // TODO(Jan): Solve this without the additional alloc/copy operation
+  /// Serialize an item through the given serializable object.
+  template <class Serializable>
+  void do_put(const Base& item, const Serializable& serializable) {
+    uint64_t offset =
+        index_writer_ ? static_cast<uint64_t>(ostream_->tellp()) : 0;
+    save_archive_item(*oarchive_, serializable,
+                      descriptor_.descriptor_encoding(), codec_);
+    if constexpr (archive_type == ArchiveType::TimesliceArchive) {
+      if (index_writer_) {
+        uint64_t size = static_cast<uint64_t>(ostream_->tellp()) - offset;
+        index_writer_->add(item, offset, size);
+      }
+    }
+  }
 };
 
 } // namespace fles
@@ -4,7 +4,14 @@
 #pragma once
 
 #include "ArchiveDescriptor.hpp"
+#include "ArchiveIndex.hpp"
+#include "ArchiveManifest.hpp"
+#include "DescriptorCodec.hpp"
+#include "DirectFileBuffer.hpp"
 #include "Sink.hpp"
+#include "TimesliceSerializer.hpp"
+#include "ZstdFrameCompressor.hpp"
+#include "log.hpp"
 #include <boost/algorithm/string.hpp>
 #include <boost/archive/binary_oarchive.hpp>
 #ifdef BOOST_IOS_HAS_ZSTD
@@ -12,7 +19,7 @@
 #endif
 #include <boost/iostreams/filtering_stream.hpp>
 #include <cstdint>
-#include <fstream>
+#include <future>
 #include <iomanip>
 #include <memory>
 #include <sstream>
@@ -38,15 +45,40 @@ public:
    * \param items_per_file    Number of items to store in each file
    * \param bytes_per_file    bytes per file
    * \param compression       compression
+   * \param write_index       write an index sidecar file for each file
+   *                          (timeslice archives only)
+   * \param zstd_parameters   level and number of threads for zstd compression
+   * \param direct_io         direct I/O parameters of the archive files
+   * \param descriptor_encoding encoding of the microslice descriptors
+   * \param manifest          run manifest file to append an entry to for
+   *                          each completed file (timeslice archives only)
    */
   explicit OutputArchiveSequence(
       std::string filename_template,
       std::size_t items_per_file = SIZE_MAX,
       std::size_t bytes_per_file = SIZE_MAX,
-      ArchiveCompression compression = ArchiveCompression::None)
-      : descriptor_{archive_type, compression},
+      ArchiveCompression compression = ArchiveCompression::None,
+      bool write_index = false,
+      const ZstdParameters& zstd_parameters = {},
+      const DirectIoParameters& direct_io = {},
+      DescriptorEncoding descriptor_encoding = DescriptorEncoding::Verbatim,
+      const std::string& manifest = {})
+      : descriptor_{archive_type, compression, descriptor_encoding},
         filename_template_(std::move(filename_template)),
-        items_per_file_(items_per_file), bytes_per_file_(bytes_per_file) {
+        items_per_file_(items_per_file), bytes_per_file_(bytes_per_file),
+        write_index_(write_index), zstd_parameters_(zstd_parameters),
+        direct_io_(direct_io) {
+    if (write_index_ && (archive_type != ArchiveType::TimesliceArchive ||
+                         compression != ArchiveCompression::None)) {
+      throw std::runtime_error(
+          "Index not supported for output archive file \"" +
+          filename_template_ + "\"");
+    }
+    if (!manifest.empty() && archive_type != ArchiveType::TimesliceArchive) {
+      throw std::runtime_error(
+          "Manifest not supported for output archive file \"" +
+          filename_template_ + "\"");
+    }
     if (items_per_file_ == 0) {
       items_per_file_ = SIZE_MAX;
     }
@@ -60,6 +92,11 @@ public:
       filename_template_ += ".%n";
     }
 
+    if (!manifest.empty()) {
+      manifest_writer_ =
+          std::make_unique<ArchiveManifestWriter>(manifest, filename_template_);
+    }
+
     next_file();
   }
 
@@ -68,35 +105,68 @@ public:
   /// Delete assignment operator (non-copyable).
   void operator=(const OutputArchiveSequence&) = delete;
 
-  ~OutputArchiveSequence() override = default;
+  ~OutputArchiveSequence() override {
+    try {
+      close_file(false);
+    } catch (const std::exception& e) {
+      L_(error) << e.what();
+    }
+  }
 
   /// Store an item.
-  void put(std::shared_ptr<const Base> item) override { do_put(*item); }
-
-  void end_stream() override {
-    oarchive_ = nullptr;
-    out_ = nullptr;
-    ofstream_ = nullptr;
+  void put(std::shared_ptr<const Base> item) override {
+    if constexpr (archive_type == ArchiveType::TimesliceArchive) {
+      // any timeslice (e.g., a view into shared memory) is written directly
+      do_put(*item, TimesliceSerializer(*item));
+    } else if (const auto* derived = dynamic_cast<const Derived*>(item.get())) {
+      do_put(*derived, *derived);
+    } else {
+      const Derived copy(*item);
+      do_put(copy, copy);
+    }
   }
 
+  void end_stream() override { close_file(false); }
+
 private:
-  std::unique_ptr<std::ofstream> ofstream_;
+  std::unique_ptr<std::ostream> ostream_;
   std::unique_ptr<boost::iostreams::filtering_ostream> out_;
   std::unique_ptr<boost::archive::binary_oarchive> oarchive_;
   ArchiveDescriptor descriptor_;
+  DescriptorCodec codec_;
+  std::unique_ptr<ArchiveIndexWriter> index_writer_;
+  std::unique_ptr<ArchiveManifestWriter> manifest_writer_;
 
   std::string filename_template_;
   std::size_t items_per_file_;
   std::size_t bytes_per_file_;
+  bool write_index_;
+  ZstdParameters zstd_parameters_;
+  DirectIoParameters direct_io_;
+  /// Completion of the previous file, closed in the background.
+  std::future<void> closing_;
   std::size_t file_count_ = 0;
   std::size_t file_item_count_ = 0;
 
-  // TODO(Jan): Solve this without the additional alloc/copy operation
-  void do_put(const Derived& item) {
+  /// Serialize an item through the given serializable object.
+  template <class Serializable>
+  void do_put(const Base& item, const Serializable& serializable) {
     if (file_limit_reached()) {
       next_file();
     }
-    *oarchive_ << item;
+    uint64_t offset =
+        index_writer_ ? static_cast<uint64_t>(ostream_->tellp()) : 0;
+    save_archive_item(*oarchive_, serializable,
+                      descriptor_.descriptor_encoding(), codec_);
+    if constexpr (archive_type == ArchiveType::TimesliceArchive) {
+      if (index_writer_) {
+        uint64_t size = static_cast<uint64_t>(ostream_->tellp()) - offset;
+        index_writer_->add(item, offset, size);
+      }
+      if (manifest_writer_) {
+        manifest_writer_->add(item);
+      }
+    }
     ++file_item_count_;
   }
 
@@ -113,7 +183,7 @@ private:
     }
     // check byte limit if set
     if (bytes_per_file_ < SIZE_MAX) {
-      auto pos = ofstream_->tellp();
+      auto pos = ostream_->tellp();
       if (pos > 0 && static_cast<std::size_t>(pos) >= bytes_per_file_) {
         return true;
       }
@@ -121,27 +191,67 @@ private:
     return false;
   }
 
-  void next_file() {
+  /// Close the current file. On rollover, a direct I/O file is closed in
+  /// the background (waiting for its last writes and the fsync), so that the
+  /// next file can be written meanwhile. The manifest entry of the file is
+  /// appended once it is closed.
+  void close_file(bool background) {
+    index_writer_ = nullptr;
     oarchive_ = nullptr;
     out_ = nullptr;
-    ofstream_ = nullptr;
-    ofstream_ = std::make_unique<std::ofstream>(filename(file_count_),
-                                                std::ios::binary);
-    oarchive_ = std::make_unique<boost::archive::binary_oarchive>(*ofstream_);
+    if (closing_.valid()) {
+      closing_.get();
+    }
+    ArchiveManifestEntry entry;
+    std::string manifest;
+    if (manifest_writer_ && ostream_) {
+      entry = manifest_writer_->finish_file(
+          filename(file_count_ - 1), static_cast<uint64_t>(ostream_->tellp()));
+      manifest = manifest_writer_->manifest_filename();
+    }
+    auto append_entry = [manifest, entry] {
+      if (!manifest.empty() && entry.num_timeslices > 0) {
+        ArchiveManifest::append(manifest, entry);
+      }
+    };
+    auto* direct = dynamic_cast<DirectFileStream*>(ostream_.get());
+    if (background && direct != nullptr) {
+      closing_ = std::async(std::launch::async,
+                            [stream = std::move(ostream_), append_entry] {
+                              static_cast<DirectFileStream&>(*stream).close();
+                              append_entry();
+                            });
+      return;
+    }
+    if (direct != nullptr) {
+      direct->close();
+    }
+    ostream_ = nullptr;
+    append_entry();
+  }
+
+  void next_file() {
+    close_file(true);
+    ostream_ = open_output_file(filename(file_count_), direct_io_);
+    if (write_index_) {
+      index_writer_ = std::make_unique<ArchiveIndexWriter>(
+          ArchiveIndex::sidecar_filename(filename(file_count_)));
+    }
+    oarchive_ = std::make_unique<boost::archive::binary_oarchive>(*ostream_);
     *oarchive_ << descriptor_;
+    codec_.reset();
 
     if (descriptor_.archive_compression() != ArchiveCompression::None) {
 #ifdef BOOST_IOS_HAS_ZSTD
       out_ = std::make_unique<boost::iostreams::filtering_ostream>();
       if (descriptor_.archive_compression() == ArchiveCompression::Zstd) {
-        out_->push(boost::iostreams::zstd_compressor(
-            boost::iostreams::zstd::best_speed));
+        push_zstd_compressor(*out_, zstd_parameters_);
       } else {
         throw std::runtime_error(
             "Unsupported compression type for output archive file \"" +
             filename(file_count_) + "\"");
       }
-      out_->push(*ofstream_);
+      out_->push(*ostream_);
       oarchive_ = std::make_unique<boost::archive::binary_oarchive>(
           *out_, boost::archive::no_header);
 #else
@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "PagePrefetcher.hpp"
+#include <sys/mman.h>
+#include <unistd.h>
+#include <utility>
+
+namespace fles {
+
+namespace {
+constexpr std::size_t cache_line_size = 64;
+} // namespace
+
+PagePrefetcher::PagePrefetcher(std::size_t max_pending)
+    : max_pending_(max_pending == 0 ? 1 : max_pending) {
+  thread_ = std::thread(&PagePrefetcher::run, this);
+}
+
+PagePrefetcher::~PagePrefetcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+}
+
+bool PagePrefetcher::submit(std::vector<Range> ranges,
+                            std::shared_ptr<const void> owner) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queue_.size() >= max_pending_) {
+      return false;
+    }
+    queue_.push_back({std::move(ranges), std::move(owner)});
+  }
+  cv_.notify_one();
+  return true;
+}
+
+void PagePrefetcher::prefetch(const Range& range) {
+  if (range.size == 0) {
+    return;
+  }
+  static const auto page_size =
+      static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+  const auto begin = reinterpret_cast<std::uintptr_t>(range.data);
+  const std::uintptr_t end = begin + range.size;
+  const std::uintptr_t page_begin = begin & ~(page_size - 1);
+  // only a hint, e.g. not supported for device memory
+  madvise(reinterpret_cast<void*>(page_begin), end - page_begin,
+          MADV_WILLNEED);
+  // read a byte of each page to fault it in, a prefetch would be dropped
+  for (std::uintptr_t page = page_begin; page < end; page += page_size) {
+    const std::uintptr_t address = page < begin ? begin : page;
+    static_cast<void>(*reinterpret_cast<const volatile uint8_t*>(address));
+  }
+  for (std::size_t offset = 0; offset < range.size;
+       offset += cache_line_size) {
+    __builtin_prefetch(range.data + offset);
+  }
+}
+
+void PagePrefetcher::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this] { return stopped_ || !queue_.empty(); });
+    if (stopped_) {
+      return;
+    }
+    Request request = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+    for (const auto& range : request.ranges) {
+      prefetch(range);
+    }
+    // release the owner outside of the lock
+    request.owner.reset();
+    lock.lock();
+  }
+}
+
+} // namespace fles
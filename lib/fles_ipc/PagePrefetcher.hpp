@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::PagePrefetcher class.
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief The PagePrefetcher class touches memory ranges on a helper thread
+ * ahead of their first use.
+ *
+ * For each range, the pages are advised with MADV_WILLNEED and read once,
+ * and every cache line is requested with a software prefetch. This maps
+ * the pages of a shared memory region into the page tables of the process
+ * and loads the data into the shared cache, so that the first accesses of
+ * the consumer take neither page faults nor cold misses.
+ *
+ * Requests are dropped instead of queued if the helper thread falls behind
+ * by more than max_pending requests, so submitting never blocks.
+ */
+class PagePrefetcher {
+public:
+  /// A memory range to prefetch.
+  struct Range {
+    const uint8_t* data;
+    std::size_t size;
+  };
+
+  /// Start the helper thread.
+  explicit PagePrefetcher(std::size_t max_pending = 16);
+
+  /// Delete copy constructor (non-copyable).
+  PagePrefetcher(const PagePrefetcher&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const PagePrefetcher&) = delete;
+
+  /// Stop the helper thread, dropping the pending requests.
+  ~PagePrefetcher();
+
+  /**
+   * \brief Request the prefetch of memory ranges.
+   *
+   * \param ranges The memory ranges
+   * \param owner  Object keeping the memory valid until the prefetch is done
+   * \return false if the request is dropped
+   */
+  bool submit(std::vector<Range> ranges, std::shared_ptr<const void> owner);
+
+  /// Prefetch the given memory range on the calling thread.
+  static void prefetch(const Range& range);
+
+private:
+  struct Request {
+    std::vector<Range> ranges;
+    std::shared_ptr<const void> owner;
+  };
+
+  void run();
+
+  std::size_t max_pending_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Request> queue_;
+  bool stopped_ = false;
+  std::thread thread_;
+};
+
+} // namespace fles
@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::ParallelSource template class.
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief The ParallelSource class reads items from a given set of input
+ * sources concurrently, one thread per source, and returns them in order of
+ * arrival.
+ *
+ * In contrast to MergingSource, the items are not ordered by index. This is
+ * meant for several receivers of the same stream (e.g., shared memory
+ * receivers with distinct offsets or in a common worker group), so that
+ * reception and the processing of the consumer overlap and several items are
+ * in flight at a time. The reading threads pause as soon as max_items items
+ * are queued. The first exception thrown by any source is rethrown by get().
+ */
+template <class SourceType> class ParallelSource : public SourceType {
+public:
+  using item_type = typename SourceType::item_type;
+
+  /**
+   * \brief Construct a parallel source object and start reading from all
+   * sources.
+   *
+   * \param sources   The input sources to read data from
+   * \param max_items Maximum number of items to queue (0: one per source)
+   */
+  ParallelSource(std::vector<std::unique_ptr<SourceType>> sources,
+                 std::size_t max_items = 0)
+      : sources_(std::move(sources)),
+        max_items_(max_items == 0 ? sources_.size() : max_items) {
+    for (auto& source : sources_) {
+      threads_.emplace_back(&ParallelSource::read, this, source.get());
+    }
+  }
+
+  /// Delete copy constructor (non-copyable).
+  ParallelSource(const ParallelSource&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const ParallelSource&) = delete;
+
+  /// Stop reading. Waits for pending reads of the sources.
+  ~ParallelSource() override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopped_ = true;
+    }
+    not_full_.notify_all();
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  [[nodiscard]] bool eos() const override { return eos_; }
+
+private:
+  std::vector<std::unique_ptr<SourceType>> sources_;
+  std::size_t max_items_;
+
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::deque<std::unique_ptr<item_type>> queue_;
+  std::size_t finished_ = 0;
+  bool stopped_ = false;
+  std::exception_ptr exception_;
+  std::vector<std::thread> threads_;
+
+  bool eos_ = false;
+
+  void read(SourceType* source) {
+    try {
+      while (true) {
+        {
+          std::unique_lock<std::mutex> lock(mutex_);
+          not_full_.wait(lock, [this] {
+            return stopped_ || exception_ || queue_.size() < max_items_;
+          });
+          if (stopped_ || exception_) {
+            break;
+          }
+        }
+        auto item = source->get();
+        if (!item) {
+          break;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(std::move(item));
+        not_empty_.notify_one();
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!exception_) {
+        exception_ = std::current_exception();
+      }
+      not_full_.notify_all();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++finished_;
+    // hand on a wakeup this thread may have consumed
+    not_full_.notify_one();
+    not_empty_.notify_one();
+  }
+
+  item_type* do_get() override {
+    if (eos_) {
+      return nullptr;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [this] {
+      return exception_ || !queue_.empty() || finished_ == sources_.size();
+    });
+    if (exception_) {
+      eos_ = true;
+      std::rethrow_exception(exception_);
+    }
+    if (queue_.empty()) {
+      eos_ = true;
+      return nullptr;
+    }
+    auto item = std::move(queue_.front());
+    queue_.pop_front();
+    not_full_.notify_one();
+    return item.release();
+  }
+};
+
+} // namespace fles
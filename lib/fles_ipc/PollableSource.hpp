@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::PollableSource template class.
+#pragma once
+
+#include "Source.hpp"
+#include <cerrno>
+#include <memory>
+#include <poll.h>
+#include <system_error>
+
+namespace fles {
+
+/**
+ * \brief The PollableSource class extends the item-based input interface by
+ * a non-blocking retrieval and a file descriptor signaling new items.
+ *
+ * This allows a single thread to serve many sources (see SourceMultiplexer).
+ * The file descriptor may be edge-triggered: once it has become readable,
+ * try_get() has to be called until it returns nullptr before waiting for
+ * it again. The blocking get() is implemented on top of both.
+ */
+template <class T> class PollableSource : public Source<T> {
+public:
+  /**
+   * \brief Retrieve the next item without blocking.
+   *
+   * \return pointer to the item, or nullptr if no item is available yet or
+   * at end-of-stream (see eos())
+   */
+  std::unique_ptr<T> try_get() { return std::unique_ptr<T>(do_try_get()); }
+
+  /// Retrieve the file descriptor that becomes readable when new items or
+  /// the end of the stream may be available.
+  [[nodiscard]] virtual int poll_fd() = 0;
+
+private:
+  virtual T* do_try_get() = 0;
+
+  T* do_get() override {
+    while (true) {
+      if (T* item = do_try_get()) {
+        return item;
+      }
+      if (this->eos()) {
+        return nullptr;
+      }
+      pollfd fd{poll_fd(), POLLIN, 0};
+      if (::poll(&fd, 1, -1) < 0 && errno != EINTR) {
+        throw std::system_error(errno, std::generic_category(), "poll");
+      }
+    }
+  }
+};
+
+} // namespace fles
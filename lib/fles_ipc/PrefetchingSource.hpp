@@ -0,0 +1,182 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::PrefetchingSource template class.
+#pragma once
+
+#include "Microslice.hpp"
+#include "Timeslice.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fles {
+
+/// Retrieve the amount of memory held by a timeslice (for read-ahead limits).
+inline std::size_t prefetch_size(const Timeslice& ts) {
+  std::size_t size = 0;
+  for (uint64_t c = 0; c < ts.num_components(); ++c) {
+    size += ts.size_component(c);
+  }
+  return size;
+}
+
+/// Retrieve the amount of memory held by a microslice (for read-ahead limits).
+inline std::size_t prefetch_size(const Microslice& ms) {
+  return sizeof(MicrosliceDescriptor) + ms.desc().size;
+}
+
+/**
+ * \brief The PrefetchingSource class reads items from a given source on a
+ * background thread, so that reading and processing overlap.
+ *
+ * Items are kept in a bounded queue. The reading thread pauses as soon as the
+ * queue holds max_items items or max_bytes bytes (as determined by
+ * prefetch_size()); a single item larger than max_bytes is always accepted.
+ * Exceptions thrown by the wrapped source are rethrown by get().
+ */
+template <class SourceType> class PrefetchingSource : public SourceType {
+public:
+  using item_type = typename SourceType::item_type;
+
+  /**
+   * \brief Construct a prefetching source object and start reading ahead.
+   *
+   * \param source    The input source to read data from
+   * \param max_items Maximum number of items to read ahead
+   * \param max_bytes Maximum amount of data (in bytes) to read ahead
+   */
+  PrefetchingSource(std::unique_ptr<SourceType> source,
+                    std::size_t max_items,
+                    std::size_t max_bytes = SIZE_MAX)
+      : source_(std::move(source)), max_items_(max_items == 0 ? 1 : max_items),
+        max_bytes_(max_bytes) {
+    thread_ = std::thread(&PrefetchingSource::prefetch, this);
+  }
+
+  /// Delete copy constructor (non-copyable).
+  PrefetchingSource(const PrefetchingSource&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const PrefetchingSource&) = delete;
+
+  /// Stop reading ahead. Waits for a pending read of the wrapped source.
+  ~PrefetchingSource() override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopped_ = true;
+    }
+    not_full_.notify_all();
+    thread_.join();
+  }
+
+  [[nodiscard]] bool eos() const override { return eos_; }
+
+private:
+  std::unique_ptr<SourceType> source_;
+  std::size_t max_items_;
+  std::size_t max_bytes_;
+
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::deque<std::unique_ptr<item_type>> queue_;
+  std::size_t queued_bytes_ = 0;
+  bool finished_ = false;
+  bool stopped_ = false;
+  std::exception_ptr exception_;
+  std::thread thread_;
+
+  bool eos_ = false;
+
+  void prefetch() {
+    try {
+      while (true) {
+        {
+          std::unique_lock<std::mutex> lock(mutex_);
+          not_full_.wait(lock, [this] {
+            return stopped_ || queue_.empty() ||
+                   (queue_.size() < max_items_ && queued_bytes_ < max_bytes_);
+          });
+          if (stopped_) {
+            return;
+          }
+        }
+        auto item = source_->get();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!item) {
+          finished_ = true;
+          not_empty_.notify_one();
+          return;
+        }
+        queued_bytes_ += prefetch_size(*item);
+        queue_.push_back(std::move(item));
+        not_empty_.notify_one();
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      exception_ = std::current_exception();
+      finished_ = true;
+      not_empty_.notify_one();
+    }
+  }
+
+  item_type* do_get() override {
+    if (eos_) {
+      return nullptr;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [this] { return finished_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      eos_ = true;
+      if (exception_) {
+        std::rethrow_exception(exception_);
+      }
+      return nullptr;
+    }
+    auto item = std::move(queue_.front());
+    queue_.pop_front();
+    queued_bytes_ -= prefetch_size(*item);
+    not_full_.notify_one();
+    return item.release();
+  }
+
+  void do_get_batch(std::vector<std::unique_ptr<item_type>>& items,
+                    std::size_t max_items,
+                    std::chrono::nanoseconds timeout) override {
+    if (max_items == 0) {
+      return;
+    }
+    item_type* first = do_get();
+    if (first == nullptr) {
+      return;
+    }
+    items.emplace_back(first);
+
+    // Take the items read ahead and those arriving until the deadline; the
+    // end-of-stream (or an exception) is reported by the next call
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (items.size() < max_items) {
+      if (queue_.empty()) {
+        not_empty_.wait_until(lock, deadline,
+                              [this] { return finished_ || !queue_.empty(); });
+        if (queue_.empty()) {
+          break;
+        }
+      }
+      queued_bytes_ -= prefetch_size(*queue_.front());
+      items.push_back(std::move(queue_.front()));
+      queue_.pop_front();
+    }
+    not_full_.notify_one();
+  }
+};
+
+} // namespace fles
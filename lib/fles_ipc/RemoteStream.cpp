@@ -0,0 +1,313 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "RemoteStream.hpp"
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <algorithm>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace fles {
+
+namespace http = boost::beast::http;
+
+namespace {
+
+const std::string remote_prefix = "http://";
+
+/// Persistent HTTP/1.1 connection to the server of a remote file.
+class Connection {
+public:
+  explicit Connection(const std::string& url) {
+    if (!is_remote(url)) {
+      throw std::invalid_argument("not a remote file: " + url);
+    }
+    const auto slash = url.find('/', remote_prefix.size());
+    std::string authority = url.substr(remote_prefix.size(),
+                                       slash - remote_prefix.size());
+    target_ = slash == std::string::npos ? "/" : url.substr(slash);
+    const auto colon = authority.rfind(':');
+    if (colon != std::string::npos) {
+      port_ = authority.substr(colon + 1);
+      authority.resize(colon);
+    }
+    host_ = authority;
+  }
+
+  /// Retrieve the size of the file, or nothing if it does not exist.
+  std::optional<uint64_t> file_size() {
+    http::request<http::empty_body> request{http::verb::head, target_, 11};
+    http::response_parser<http::empty_body> parser;
+    // the response to a HEAD request has a content length, but no body
+    parser.skip(true);
+    exchange(request, parser);
+    if (parser.get().result() == http::status::not_found) {
+      return std::nullopt;
+    }
+    if (parser.get().result() != http::status::ok ||
+        !parser.content_length()) {
+      throw std::ios_base::failure("error accessing remote file \"" + url() +
+                                   "\": " +
+                                   std::string(parser.get().reason()));
+    }
+    return *parser.content_length();
+  }
+
+  /// Read a range of the file.
+  void read(uint64_t offset, std::size_t length, std::vector<char>& data) {
+    http::request<http::empty_body> request{http::verb::get, target_, 11};
+    request.set(http::field::range,
+                "bytes=" + std::to_string(offset) + "-" +
+                    std::to_string(offset + length - 1));
+    http::response_parser<http::vector_body<char>> parser;
+    parser.body_limit(length);
+    exchange(request, parser);
+    const auto status = parser.get().result();
+    data = std::move(parser.get().body());
+    // A server ignoring the range returns a whole file that fits the limit
+    if ((status != http::status::partial_content &&
+         !(status == http::status::ok && offset == 0)) ||
+        data.size() != length) {
+      throw std::ios_base::failure("error reading remote file \"" + url() +
+                                   "\" at offset " + std::to_string(offset));
+    }
+  }
+
+private:
+  std::string host_;
+  std::string port_ = "80";
+  std::string target_;
+
+  boost::asio::io_context io_context_;
+  std::optional<boost::asio::ip::tcp::socket> socket_;
+  boost::beast::flat_buffer buffer_;
+
+  [[nodiscard]] std::string url() const {
+    return remote_prefix + host_ + ":" + port_ + target_;
+  }
+
+  void connect() {
+    boost::asio::ip::tcp::resolver resolver(io_context_);
+    socket_.emplace(io_context_);
+    boost::asio::connect(*socket_, resolver.resolve(host_, port_));
+    buffer_.clear();
+  }
+
+  /// Send a request and read the response, reconnecting once if the server
+  /// has closed a kept-alive connection in the meantime.
+  template <class Request, class Parser>
+  void exchange(Request& request, Parser& parser) {
+    request.set(http::field::host, host_);
+    const bool reused = socket_.has_value();
+    try {
+      if (!reused) {
+        connect();
+      }
+      http::write(*socket_, request);
+      http::read(*socket_, buffer_, parser);
+    } catch (const boost::system::system_error&) {
+      socket_.reset();
+      if (!reused || parser.got_some()) {
+        throw;
+      }
+      connect();
+      http::write(*socket_, request);
+      http::read(*socket_, buffer_, parser);
+    }
+    if (!parser.keep_alive()) {
+      socket_.reset();
+    }
+  }
+};
+
+} // namespace
+
+bool is_remote(const std::string& filename) {
+  return filename.compare(0, remote_prefix.size(), remote_prefix) == 0;
+}
+
+bool input_exists(const std::string& filename) {
+  if (!is_remote(filename)) {
+    return access(filename.c_str(), F_OK) == 0;
+  }
+  return Connection(filename).file_size().has_value();
+}
+
+std::unique_ptr<std::istream>
+open_input_stream(const std::string& filename,
+                  const RemoteParameters& remote) {
+  if (!is_remote(filename)) {
+    return std::make_unique<std::ifstream>(filename, std::ios::binary);
+  }
+  try {
+    return std::make_unique<RemoteInputStream>(filename, remote);
+  } catch (const std::ios_base::failure&) {
+    auto stream = std::make_unique<std::ifstream>();
+    stream->setstate(std::ios::failbit);
+    return stream;
+  }
+}
+
+RemoteStreamBuffer::RemoteStreamBuffer(const std::string& url,
+                                       const RemoteParameters& parameters)
+    : url_(url), parameters_(parameters) {
+  parameters_.concurrency = std::max<std::size_t>(parameters_.concurrency, 1);
+  parameters_.chunk_size = std::max<std::size_t>(parameters_.chunk_size, 1);
+  parameters_.read_ahead = std::max(parameters_.read_ahead,
+                                    parameters_.concurrency);
+
+  auto size = Connection(url_).file_size();
+  if (!size) {
+    throw std::ios_base::failure("error opening file \"" + url_ + "\"");
+  }
+  size_ = *size;
+
+  for (std::size_t i = 0; i < parameters_.concurrency; ++i) {
+    workers_.emplace_back(&RemoteStreamBuffer::fetch_chunks, this);
+  }
+}
+
+RemoteStreamBuffer::~RemoteStreamBuffer() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  changed_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void RemoteStreamBuffer::fetch_chunks() {
+  std::optional<Connection> connection;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    changed_.wait(lock, [this] {
+      return stopped_ || (window_.size() < parameters_.read_ahead &&
+                          next_offset_ < size_);
+    });
+    if (stopped_) {
+      return;
+    }
+    auto chunk = std::make_shared<Chunk>();
+    chunk->offset = next_offset_;
+    chunk->length = static_cast<std::size_t>(
+        std::min<uint64_t>(parameters_.chunk_size, size_ - next_offset_));
+    next_offset_ += chunk->length;
+    window_.push_back(chunk);
+
+    // The chunk may be discarded by a seek in the meantime, but stays valid
+    lock.unlock();
+    std::vector<char> data;
+    std::exception_ptr exception;
+    try {
+      if (!connection) {
+        connection.emplace(url_);
+      }
+      connection->read(chunk->offset, chunk->length, data);
+    } catch (...) {
+      connection.reset();
+      exception = std::current_exception();
+    }
+    lock.lock();
+    chunk->data = std::move(data);
+    chunk->exception = exception;
+    chunk->ready = true;
+    changed_.notify_all();
+  }
+}
+
+RemoteStreamBuffer::int_type RemoteStreamBuffer::underflow() {
+  if (gptr() < egptr()) {
+    return traits_type::to_int_type(*gptr());
+  }
+  if (current_) {
+    position_ = current_->offset + current_->length;
+    current_.reset();
+    setg(nullptr, nullptr, nullptr);
+  }
+  if (position_ >= size_) {
+    return traits_type::eof();
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  changed_.wait(lock, [this] {
+    return !window_.empty() && window_.front()->ready;
+  });
+  current_ = std::move(window_.front());
+  window_.pop_front();
+  changed_.notify_all();
+  lock.unlock();
+
+  if (current_->exception) {
+    auto exception = current_->exception;
+    current_.reset();
+    std::rethrow_exception(exception);
+  }
+  char* data = current_->data.data();
+  setg(data, data + (position_ - current_->offset), data + current_->length);
+  return traits_type::to_int_type(*gptr());
+}
+
+RemoteStreamBuffer::pos_type
+RemoteStreamBuffer::seekoff(off_type off,
+                            std::ios_base::seekdir dir,
+                            std::ios_base::openmode which) {
+  uint64_t position = position_;
+  if (current_) {
+    position = current_->offset + static_cast<uint64_t>(gptr() - eback());
+  }
+  if (dir == std::ios_base::cur) {
+    if (off == 0) {
+      return static_cast<pos_type>(position);
+    }
+    return seekpos(static_cast<pos_type>(position + off), which);
+  }
+  if (dir == std::ios_base::end) {
+    return seekpos(static_cast<pos_type>(size_ + off), which);
+  }
+  return seekpos(static_cast<pos_type>(off), which);
+}
+
+RemoteStreamBuffer::pos_type
+RemoteStreamBuffer::seekpos(pos_type pos, std::ios_base::openmode which) {
+  if ((which & std::ios_base::in) == 0 || pos < 0 ||
+      static_cast<uint64_t>(pos) > size_) {
+    return pos_type(off_type(-1));
+  }
+  const auto position = static_cast<uint64_t>(pos);
+
+  // Within the current chunk, just move the read position
+  if (current_ && position >= current_->offset &&
+      position < current_->offset + current_->length) {
+    setg(eback(), eback() + (position - current_->offset), egptr());
+    return pos;
+  }
+
+  current_.reset();
+  setg(nullptr, nullptr, nullptr);
+  position_ = position;
+
+  // Keep the chunks read ahead from the one containing the new position on
+  std::lock_guard<std::mutex> lock(mutex_);
+  while (!window_.empty() &&
+         window_.front()->offset + window_.front()->length <= position) {
+    window_.pop_front();
+  }
+  if (window_.empty() ? next_offset_ != position
+                      : window_.front()->offset > position) {
+    window_.clear();
+    next_offset_ = position;
+  }
+  changed_.notify_all();
+  return pos;
+}
+
+} // namespace fles
@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::RemoteStreamBuffer class and related functions.
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fles {
+
+/// Parameters of the access to a remote archive file.
+struct RemoteParameters {
+  /// Number of concurrent range requests (and connections).
+  std::size_t concurrency = 4;
+  /// Size (in bytes) of each range request.
+  std::size_t chunk_size = std::size_t{8} << 20;
+  /// Number of chunks requested ahead of the read position.
+  std::size_t read_ahead = 16;
+};
+
+/// Check whether a file name refers to a remote file ("http://...").
+bool is_remote(const std::string& filename);
+
+/// Check whether a local or remote file exists.
+bool input_exists(const std::string& filename);
+
+/**
+ * \brief Open a local or remote file for binary input.
+ *
+ * \return A std::ifstream for a local file or a RemoteInputStream for a
+ * remote file, in failed state if the file cannot be opened
+ */
+std::unique_ptr<std::istream>
+open_input_stream(const std::string& filename,
+                  const RemoteParameters& remote = {});
+
+/**
+ * \brief The RemoteStreamBuffer class provides seekable, buffered input from
+ * a file on a web server or object store through HTTP range requests.
+ *
+ * Up to RemoteParameters::read_ahead chunks following the read position are
+ * requested in parallel on RemoteParameters::concurrency persistent
+ * connections and delivered in order. Seeking forward within the chunks read
+ * ahead skips the ones before; any other seek outside of the current chunk
+ * discards them and restarts the requests at the new position.
+ */
+class RemoteStreamBuffer : public std::streambuf {
+public:
+  /// Open a remote file, throw std::ios_base::failure if it does not exist.
+  explicit RemoteStreamBuffer(const std::string& url,
+                              const RemoteParameters& parameters = {});
+
+  /// Delete copy constructor (non-copyable).
+  RemoteStreamBuffer(const RemoteStreamBuffer&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const RemoteStreamBuffer&) = delete;
+
+  ~RemoteStreamBuffer() override;
+
+  /// Retrieve the size (in bytes) of the remote file.
+  [[nodiscard]] uint64_t size() const { return size_; }
+
+protected:
+  int_type underflow() override;
+  pos_type seekoff(off_type off,
+                   std::ios_base::seekdir dir,
+                   std::ios_base::openmode which) override;
+  pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+private:
+  /// A range of the file requested ahead.
+  struct Chunk {
+    uint64_t offset = 0;
+    std::size_t length = 0;
+    std::vector<char> data;
+    bool ready = false;
+    std::exception_ptr exception;
+  };
+
+  std::string url_;
+  RemoteParameters parameters_;
+  uint64_t size_ = 0;
+
+  std::mutex mutex_;
+  std::condition_variable changed_;
+  /// Chunks requested ahead, in file order.
+  std::deque<std::shared_ptr<Chunk>> window_;
+  /// Offset of the next chunk to request.
+  uint64_t next_offset_ = 0;
+  bool stopped_ = false;
+  std::vector<std::thread> workers_;
+
+  /// Chunk of the current get area.
+  std::shared_ptr<Chunk> current_;
+  /// Read position if there is no current chunk.
+  uint64_t position_ = 0;
+
+  void fetch_chunks();
+};
+
+/// Binary input stream reading a remote file through a RemoteStreamBuffer.
+class RemoteInputStream : public std::istream {
+public:
+  explicit RemoteInputStream(const std::string& url,
+                             const RemoteParameters& parameters = {})
+      : std::istream(nullptr), buffer_(url, parameters) {
+    rdbuf(&buffer_);
+  }
+
+private:
+  RemoteStreamBuffer buffer_;
+};
+
+} // namespace fles
@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "ShardedTimesliceSubscriber.hpp"
+#include "TimeslicePublisher.hpp"
+#include "TimesliceSubscriber.hpp"
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+namespace fles {
+
+ShardedTimesliceSubscriber::ShardedTimesliceSubscriber(
+    const std::string& address,
+    std::size_t shards,
+    uint32_t hwm,
+    bool ordered,
+    ComponentFilter filter)
+    : filter_(std::move(filter)), ordered_(ordered) {
+  if (shards == 0) {
+    throw std::invalid_argument("number of subscriber shards must be positive");
+  }
+  shards_.reserve(shards);
+  for (std::size_t i = 0; i < shards; ++i) {
+    Shard& shard = shards_.emplace_back(
+        Shard{zmq::socket_t(context_, ZMQ_SUB), {}, false, {}});
+    shard.socket.set(zmq::sockopt::rcvhwm, int(hwm));
+    shard.socket.connect(TimeslicePublisher::shard_address(address, i));
+    shard.socket.set(zmq::sockopt::subscribe, "");
+  }
+  for (auto& shard : shards_) {
+    shard.thread = std::thread(&ShardedTimesliceSubscriber::receive, this,
+                               std::ref(shard));
+  }
+}
+
+ShardedTimesliceSubscriber::~ShardedTimesliceSubscriber() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  not_full_.notify_all();
+  // Pending receives fail with ETERM
+  context_.shutdown();
+  for (auto& shard : shards_) {
+    shard.thread.join();
+  }
+}
+
+void ShardedTimesliceSubscriber::receive(Shard& shard) {
+  try {
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this, &shard] {
+          return stopped_ || shard.queue.size() < queued_per_shard;
+        });
+        if (stopped_) {
+          return;
+        }
+      }
+      std::unique_ptr<Timeslice> timeslice(
+          TimesliceSubscriber::receive(shard.socket, filter_));
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!timeslice) {
+        break;
+      }
+      shard.queue.push_back(std::move(timeslice));
+      not_empty_.notify_all();
+    }
+  } catch (const zmq::error_t& e) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (e.num() != ETERM && !exception_) {
+      exception_ = std::current_exception();
+    }
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!exception_) {
+      exception_ = std::current_exception();
+    }
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  shard.finished = true;
+  not_empty_.notify_all();
+}
+
+bool ShardedTimesliceSubscriber::ready() const {
+  if (exception_) {
+    return true;
+  }
+  bool all = true;
+  bool any = false;
+  for (const auto& shard : shards_) {
+    const bool available = !shard.queue.empty();
+    all = all && (available || shard.finished);
+    any = any || available;
+  }
+  return ordered_ ? all : any || all;
+}
+
+Timeslice* ShardedTimesliceSubscriber::do_get() {
+  if (eos_) {
+    return nullptr;
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  not_empty_.wait(lock, [this] { return ready(); });
+  if (exception_) {
+    eos_ = true;
+    std::rethrow_exception(exception_);
+  }
+
+  Shard* selected = nullptr;
+  if (ordered_) {
+    for (auto& shard : shards_) {
+      if (!shard.queue.empty() &&
+          (selected == nullptr ||
+           shard.queue.front()->index() < selected->queue.front()->index())) {
+        selected = &shard;
+      }
+    }
+  } else {
+    for (std::size_t i = 0; i < shards_.size() && selected == nullptr; ++i) {
+      Shard& shard = shards_[(next_shard_ + i) % shards_.size()];
+      if (!shard.queue.empty()) {
+        selected = &shard;
+        next_shard_ = (next_shard_ + i + 1) % shards_.size();
+      }
+    }
+  }
+  if (selected == nullptr) {
+    eos_ = true;
+    return nullptr;
+  }
+  auto timeslice = std::move(selected->queue.front());
+  selected->queue.pop_front();
+  not_full_.notify_all();
+  return timeslice.release();
+}
+
+} // namespace fles
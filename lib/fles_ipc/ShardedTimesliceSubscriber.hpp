@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::ShardedTimesliceSubscriber class.
+#pragma once
+
+#include "ComponentFilter.hpp"
+#include "Timeslice.hpp"
+#include "TimesliceSource.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <zmq.hpp>
+
+namespace fles {
+
+/**
+ * \brief The ShardedTimesliceSubscriber class receives timeslices from a
+ * TimeslicePublisher in sharded mode.
+ *
+ * Each shard is received and deserialized (or, in zero-copy mode, decoded
+ * into a TimesliceMessageView) on a separate thread, so that the
+ * subscription scales beyond the throughput of a single core. In ordered
+ * mode, the timeslices are returned in ascending order of their index; this
+ * requires an item from every shard that has not ended, so a shard that
+ * receives nothing stalls the stream. Otherwise, timeslices are returned as
+ * soon as they are available, alternating between the shards.
+ */
+class ShardedTimesliceSubscriber : public TimesliceSource {
+public:
+  /**
+   * \brief Construct a subscriber connecting to all shards of a publisher.
+   *
+   * \param address Address of shard 0 (see
+   *                TimeslicePublisher::shard_address())
+   * \param shards  Number of shards
+   * \param hwm     High-water mark of each subscriber socket
+   * \param ordered Return the timeslices in ascending order of their index
+   * \param filter  Selection of components to return
+   */
+  ShardedTimesliceSubscriber(const std::string& address,
+                             std::size_t shards,
+                             uint32_t hwm = 1,
+                             bool ordered = true,
+                             ComponentFilter filter = {});
+
+  /// Delete copy constructor (non-copyable).
+  ShardedTimesliceSubscriber(const ShardedTimesliceSubscriber&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const ShardedTimesliceSubscriber&) = delete;
+
+  /// Stop the receiving threads, interrupting pending receives.
+  ~ShardedTimesliceSubscriber() override;
+
+  /**
+   * \brief Retrieve the next item.
+   *
+   * This function blocks if the next item is not yet available.
+   *
+   * \return pointer to the item, or nullptr if end-of-stream
+   */
+  std::unique_ptr<Timeslice> get() {
+    return std::unique_ptr<Timeslice>(do_get());
+  };
+
+  [[nodiscard]] bool eos() const override { return eos_; }
+
+private:
+  /// Number of deserialized timeslices to buffer per shard.
+  static constexpr std::size_t queued_per_shard = 2;
+
+  struct Shard {
+    zmq::socket_t socket;
+    std::deque<std::unique_ptr<Timeslice>> queue;
+    bool finished = false;
+    std::thread thread;
+  };
+
+  // Declared first to be destroyed after all sockets
+  zmq::context_t context_{1};
+  ComponentFilter filter_;
+  bool ordered_;
+
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::vector<Shard> shards_;
+  std::size_t next_shard_ = 0;
+  bool stopped_ = false;
+  std::exception_ptr exception_;
+
+  bool eos_ = false;
+
+  void receive(Shard& shard);
+  [[nodiscard]] bool ready() const;
+  Timeslice* do_get() override;
+};
+
+} // namespace fles
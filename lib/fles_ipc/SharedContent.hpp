@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::SharedContent class.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief The SharedContent class provides refcounted, immutable storage of
+ * the content of a microslice.
+ *
+ * The content is either held in a vector owned by the storage, or resides in
+ * memory owned elsewhere (e.g., the data buffer of a data source), which is
+ * handed back through a callback once the last reference is dropped.
+ * Copies share the content and take constant time.
+ */
+class SharedContent {
+public:
+  /// Construct empty content.
+  SharedContent() = default;
+
+  /// Take over the content of a vector.
+  explicit SharedContent(std::vector<uint8_t> data)
+      : vector_(std::make_shared<std::vector<uint8_t>>(std::move(data))) {}
+
+  /// Refer to external memory, calling release once no longer referenced.
+  SharedContent(const uint8_t* data,
+                std::size_t size,
+                std::function<void()> release)
+      : external_(data, [release = std::move(release)](const uint8_t*) {
+          release();
+        }),
+        size_(size) {}
+
+  /// Retrieve a pointer to the content.
+  [[nodiscard]] const uint8_t* data() const {
+    return vector_ ? vector_->data() : external_.get();
+  }
+
+  /// Retrieve the size (in bytes) of the content.
+  [[nodiscard]] std::size_t size() const {
+    return vector_ ? vector_->size() : size_;
+  }
+
+  /// Check whether the content refers to external memory.
+  [[nodiscard]] bool external() const { return external_ != nullptr; }
+
+  /**
+   * \brief Retrieve a vector holding the content exclusively, for modifying
+   * it in place.
+   *
+   * Shared or external content is copied into a new vector first
+   * (copy-on-write), unless keep_content is false, in which case the new
+   * vector is empty. Copies made afterwards share the modified content.
+   */
+  std::vector<uint8_t>& exclusive(bool keep_content = true) {
+    if (!vector_ || vector_.use_count() > 1) {
+      std::vector<uint8_t> data;
+      if (keep_content) {
+        data.assign(this->data(), this->data() + size());
+      }
+      *this = SharedContent(std::move(data));
+    }
+    return *vector_;
+  }
+
+private:
+  std::shared_ptr<std::vector<uint8_t>> vector_;
+  std::shared_ptr<const uint8_t> external_;
+  std::size_t size_ = 0;
+};
+
+} // namespace fles
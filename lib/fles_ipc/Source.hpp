@@ -3,7 +3,10 @@
 /// \brief Defines the fles::Source template class.
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <memory>
+#include <vector>
 
 namespace fles {
 
@@ -28,12 +31,69 @@ public:
    */
   std::unique_ptr<T> get() { return std::unique_ptr<T>(do_get()); };
 
+  /**
+   * \brief Retrieve a batch of up to max_items items.
+   *
+   * This function blocks until the first item is available and adds the
+   * items which become available within the given timeout after it. Sources
+   * without a native implementation read the following items one by one
+   * and may block for them as well. Sources reading from files return up to
+   * max_items items regardless of the timeout. An empty batch signals the
+   * end-of-stream.
+   *
+   * \return vector of the items, empty if end-of-stream
+   */
+  std::vector<std::unique_ptr<T>>
+  get_batch(std::size_t max_items,
+            std::chrono::nanoseconds timeout = std::chrono::nanoseconds{0}) {
+    std::vector<std::unique_ptr<T>> items;
+    if (max_items > 0) {
+      items.reserve(max_items);
+      do_get_batch(items, max_items, timeout);
+    }
+    return items;
+  }
+
   [[nodiscard]] virtual bool eos() const = 0;
 
   virtual ~Source() = default;
 
+protected:
+  /// Append up to max_items items to a batch without regard to a timeout,
+  /// for sources which never wait for their input (e.g., archive files).
+  void get_available(std::vector<std::unique_ptr<T>>& items,
+                     std::size_t max_items) {
+    while (items.size() < max_items) {
+      T* item = do_get();
+      if (item == nullptr) {
+        break;
+      }
+      items.emplace_back(item);
+    }
+  }
+
 private:
   virtual T* do_get() = 0;
+
+  /// Append up to max_items items to a batch (see get_batch()).
+  virtual void do_get_batch(std::vector<std::unique_ptr<T>>& items,
+                            std::size_t max_items,
+                            std::chrono::nanoseconds timeout) {
+    std::chrono::steady_clock::time_point deadline;
+    while (items.size() < max_items) {
+      if (!items.empty() && std::chrono::steady_clock::now() >= deadline) {
+        break;
+      }
+      T* item = do_get();
+      if (item == nullptr) {
+        break;
+      }
+      items.emplace_back(item);
+      if (items.size() == 1) {
+        deadline = std::chrono::steady_clock::now() + timeout;
+      }
+    }
+  }
 };
 
 } // namespace fles
@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::SourceMultiplexer template class.
+#pragma once
+
+#include "PollableSource.hpp"
+#include "Sink.hpp"
+#include <cerrno>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <poll.h>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief The SourceMultiplexer class serves a set of pollable sources on a
+ * single thread.
+ *
+ * Each source is registered with a handler, which is called for every item
+ * of the source as soon as it is available, and once with a nullptr at the
+ * end of the stream, after which the source is removed. All sources wait for
+ * new items in a common poll() call, so no thread or queue per source is
+ * required. Blocking sources can take part through ThreadedPollableSource.
+ * Exceptions thrown by a source or a handler are passed on to the caller of
+ * run_once() or run().
+ */
+template <class T> class SourceMultiplexer {
+public:
+  /// Handler for the items of a source (nullptr: end of stream).
+  using Handler = std::function<void(std::unique_ptr<T>)>;
+
+  /// Register a source with an item handler.
+  /** The source has to outlive the multiplexer or its end of stream. */
+  void add(PollableSource<T>& source, Handler handler) {
+    entries_.push_back({&source, std::move(handler)});
+  }
+
+  /// Register a source whose items are passed to a sink. The end of the
+  /// stream is signaled to the sink as well.
+  void add(PollableSource<T>& source, Sink<T>& sink) {
+    add(source, [&sink](std::unique_ptr<T> item) {
+      if (item) {
+        sink.put(std::move(item));
+      } else {
+        sink.end_stream();
+      }
+    });
+  }
+
+  /// Retrieve the number of sources not yet at the end of the stream.
+  [[nodiscard]] std::size_t active() const { return entries_.size(); }
+
+  /**
+   * \brief Dispatch all available items, then wait for new ones.
+   *
+   * \param timeout_ms Maximum time to wait in milliseconds (-1: no limit)
+   * \return false if all sources have reached the end of the stream
+   */
+  bool run_once(int timeout_ms = -1) {
+    for (std::size_t i = 0; i < entries_.size();) {
+      Entry& entry = entries_[i];
+      while (auto item = entry.source->try_get()) {
+        entry.handler(std::move(item));
+      }
+      if (entry.source->eos()) {
+        Handler handler = std::move(entry.handler);
+        entries_.erase(entries_.begin() + static_cast<std::ptrdiff_t>(i));
+        handler(nullptr);
+      } else {
+        ++i;
+      }
+    }
+    if (entries_.empty()) {
+      return false;
+    }
+    fds_.resize(entries_.size());
+    for (std::size_t i = 0; i < entries_.size(); ++i) {
+      fds_[i] = {entries_[i].source->poll_fd(), POLLIN, 0};
+    }
+    if (::poll(fds_.data(), fds_.size(), timeout_ms) < 0 && errno != EINTR) {
+      throw std::system_error(errno, std::generic_category(), "poll");
+    }
+    return true;
+  }
+
+  /// Dispatch all items until all sources have reached the end of the stream.
+  void run() {
+    while (run_once()) {
+    }
+  }
+
+private:
+  struct Entry {
+    PollableSource<T>* source;
+    Handler handler;
+  };
+
+  std::vector<Entry> entries_;
+  std::vector<pollfd> fds_;
+};
+
+} // namespace fles
@@ -15,12 +15,20 @@ StorableMicroslice::StorableMicroslice(StorableMicroslice&& ms) noexcept
 }
 
 StorableMicroslice::StorableMicroslice(const Microslice& ms)
-    : StorableMicroslice{ms.desc(), ms.content()} {}
+    : desc_(ms.desc()) {
+  if (const auto* sms = dynamic_cast<const StorableMicroslice*>(&ms)) {
+    content_ = sms->content_;
+  } else {
+    content_ = SharedContent(std::vector<uint8_t>(
+        ms.content(), ms.content() + ms.desc().size));
+  }
+  init_pointers();
+}
 
 StorableMicroslice::StorableMicroslice(MicrosliceDescriptor d,
                                        const uint8_t* content_p)
     : desc_(d), // cannot use {}, see http://stackoverflow.com/q/19347004
-      content_{content_p, content_p + d.size} {
+      content_{std::vector<uint8_t>{content_p, content_p + d.size}} {
   init_pointers();
 }
 
@@ -31,7 +39,26 @@ StorableMicroslice::StorableMicroslice(MicrosliceDescriptor d,
   init_pointers();
 }
 
-StorableMicroslice::StorableMicroslice() = default;
+StorableMicroslice::StorableMicroslice(MicrosliceDescriptor d,
+                                       SharedContent content)
+    : desc_(d), content_{std::move(content)} {
+  desc_.size = static_cast<uint32_t>(content_.size());
+  init_pointers();
+}
+
+StorableMicroslice::StorableMicroslice() { init_pointers(); }
+
+void StorableMicroslice::assign(const Microslice& ms) {
+  desc_ = ms.desc();
+  content_.exclusive(false).assign(ms.content(), ms.content() + desc_.size);
+  init_pointers();
+}
+
+uint8_t* StorableMicroslice::content() {
+  content_.exclusive();
+  init_pointers();
+  return content_ptr_;
+}
 
 void StorableMicroslice::initialize_crc() { desc_.crc = compute_crc(); }
 
@@ -3,13 +3,20 @@
 /// \brief Defines the fles::StorableMicroslice class.
 #pragma once
 
+#include "AllocationStats.hpp"
 #include "ArchiveDescriptor.hpp"
+#include "DescriptorCodec.hpp"
 #include "Microslice.hpp"
 #include "MicrosliceDescriptor.hpp"
+#include "SharedContent.hpp"
 #include <fstream>
+#include <stdexcept>
 #include <vector>
 
 #include <boost/serialization/access.hpp>
+#include <boost/serialization/array_wrapper.hpp>
+#include <boost/serialization/collection_size_type.hpp>
+#include <boost/serialization/split_member.hpp>
 #include <boost/serialization/vector.hpp>
 // Note: <fstream> has to precede boost/serialization includes for non-obvious
 // reasons to avoid segfault similar to
@@ -27,18 +34,23 @@ class InputArchiveSequence;
 /**
  * \brief The StorableMicroslice class contains the data of a single microslice.
  *
- * Both metadata and content are stored within the object.
+ * The metadata is stored within the object. The content is held in a
+ * SharedContent storage, which copies of the object share, so that copying
+ * takes constant time. The content may also reside in memory owned
+ * elsewhere, e.g., the data buffer of a MicrosliceReceiver. The objects are
+ * accounted in cbm::AllocationStats if enabled.
  */
 class StorableMicroslice : public Microslice {
 public:
-  /// Copy constructor.
+  /// Copy constructor (sharing the content).
   StorableMicroslice(const StorableMicroslice& ms);
   /// Delete assignment operator (not implemented).
   void operator=(const StorableMicroslice&) = delete;
   /// Move constructor.
   StorableMicroslice(StorableMicroslice&& ms) noexcept;
 
-  /// Construct by copying from given Microslice object.
+  /// Construct by copying from given Microslice object (sharing the content
+  /// of a StorableMicroslice).
   StorableMicroslice(const Microslice& ms);
 
   /**
@@ -66,14 +78,62 @@ public:
    */
   StorableMicroslice(MicrosliceDescriptor d, std::vector<uint8_t> content_v);
 
+  /**
+   * \brief Construct from given shared content.
+   *
+   * The descriptor will be updated to match the size of the content.
+   */
+  StorableMicroslice(MicrosliceDescriptor d, SharedContent content);
+
+  /**
+   * \brief Replace the contents by copying from given Microslice object.
+   *
+   * The memory allocated for the content is reused if it is large enough
+   * and not shared.
+   */
+  void assign(const Microslice& ms);
+
+  using Microslice::content;
+  using Microslice::desc;
+
   /// Retrieve non-const microslice descriptor reference
   MicrosliceDescriptor& desc() { return *desc_ptr_; }
 
   /// Retrieve a non-const pointer to the microslice data
-  uint8_t* content() { return content_ptr_; }
+  /** Shared content is copied first, so the other objects are not
+      affected by modifications. */
+  uint8_t* content();
+
+  /// Retrieve the storage of the microslice data
+  [[nodiscard]] const SharedContent& shared_content() const {
+    return content_;
+  }
 
   void initialize_crc();
 
+  /// Serialize with a compactly encoded descriptor (used by the archive
+  /// classes, see DescriptorEncoding).
+  /** The descriptor is encoded relative to the one of the previous
+      microslice in the archive. */
+  template <class Archive>
+  void save_compact(Archive& ar, DescriptorCodec& codec) const {
+    if (content_.size() != desc_.size) {
+      throw std::runtime_error("inconsistent microslice size");
+    }
+    codec.save(ar, &desc_, 1);
+    ar.save_binary(content_.data(), desc_.size);
+  }
+
+  /// Deserialize with a compactly encoded descriptor.
+  template <class Archive>
+  void load_compact(Archive& ar, DescriptorCodec& codec) {
+    codec.load(ar, &desc_, 1);
+    auto& content = content_.exclusive(false);
+    content.resize(desc_.size);
+    ar.load_binary(content.data(), desc_.size);
+    init_pointers();
+  }
+
 private:
   friend class boost::serialization::access;
   friend class InputArchive<Microslice,
@@ -88,21 +148,40 @@ private:
 
   StorableMicroslice();
 
+  // The content is stored in the format of a std::vector<uint8_t>
   template <class Archive>
-  void serialize(Archive& ar, const unsigned int /* version */) {
-    ar& desc_;
-    ar& content_;
+  void save(Archive& ar, const unsigned int /* version */) const {
+    ar << desc_;
+    const boost::serialization::collection_size_type count(content_.size());
+    ar << count;
+    if (count != 0) {
+      ar << boost::serialization::make_array(content_.data(), count);
+    }
+  }
+
+  template <class Archive>
+  void load(Archive& ar, const unsigned int /* version */) {
+    ar >> desc_;
+    ar >> content_.exclusive(false);
 
     init_pointers();
   }
 
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
+
   void init_pointers() {
     desc_ptr_ = &desc_;
-    content_ptr_ = content_.data();
+    // the content is only modified through content(), which unshares it
+    content_ptr_ = const_cast<uint8_t*>(content_.data()); // NOLINT
+    if (alloc_record_.Active()) {
+      alloc_record_.Update(sizeof(*this) +
+                           (content_.external() ? 0 : content_.size()));
+    }
   }
 
   MicrosliceDescriptor desc_{};
-  std::vector<uint8_t> content_;
+  SharedContent content_;
+  cbm::AllocationRecord alloc_record_{cbm::AllocationStats::kMicroslice};
 };
 
 } // namespace fles
@@ -3,34 +3,88 @@
 #include "StorableTimeslice.hpp"
 
 #include <algorithm>
+#include <utility>
 
 namespace fles {
 
-StorableTimeslice::StorableTimeslice(const StorableTimeslice& ts)
-    : Timeslice(ts), data_(ts.data_), desc_(ts.desc_) {
-  init_pointers();
+namespace {
+/// Size of the data of a component to copy.
+uint64_t copy_size(const Timeslice& ts,
+                   uint64_t component,
+                   bool descriptors_only) {
+  if (descriptors_only) {
+    return ts.num_microslices(component) * sizeof(MicrosliceDescriptor);
+  }
+  return ts.size_component(component);
 }
 
+/// Arena size required to copy the data of a given timeslice.
+std::size_t arena_bytes(const Timeslice& ts, bool descriptors_only) {
+  // a safe margin of one alignment unit per allocation
+  constexpr std::size_t margin = alignof(std::max_align_t);
+  std::size_t bytes =
+      ts.num_components() * sizeof(TimesliceArenaBuffer) + margin;
+  for (uint64_t c = 0; c < ts.num_components(); ++c) {
+    bytes += copy_size(ts, c, descriptors_only) + margin;
+  }
+  return bytes;
+}
+} // namespace
+
+StorableTimeslice::StorableTimeslice(const StorableTimeslice& ts)
+    : StorableTimeslice(static_cast<const Timeslice&>(ts)) {}
+
 StorableTimeslice::StorableTimeslice(StorableTimeslice&& ts) noexcept
-    : Timeslice(ts), data_(std::move(ts.data_)), desc_(std::move(ts.desc_)) {
+    : Timeslice(ts), arena_(std::move(ts.arena_)), data_(std::move(ts.data_)),
+      desc_(std::move(ts.desc_)) {
   init_pointers();
 }
 
 StorableTimeslice::StorableTimeslice(const Timeslice& ts)
-    : data_(ts.timeslice_descriptor_.num_components),
+    : StorableTimeslice(ts, false) {}
+
+StorableTimeslice::StorableTimeslice(const Timeslice& ts,
+                                     bool descriptors_only)
+    : arena_(TimesliceArena::acquire(arena_bytes(ts, descriptors_only))),
+      data_(TimesliceArenaAllocator<TimesliceArenaBuffer>(arena_.get())),
       desc_(ts.timeslice_descriptor_.num_components) {
   timeslice_descriptor_ = ts.timeslice_descriptor_;
+  data_.reserve(ts.timeslice_descriptor_.num_components);
   for (std::size_t component = 0;
        component < ts.timeslice_descriptor_.num_components; ++component) {
-    uint64_t size = ts.desc_ptr_[component]->size;
-    data_[component].resize(size);
-    std::copy_n(ts.data_ptr_[component], size, data_[component].begin());
+    uint64_t size = copy_size(ts, component, descriptors_only);
+    const uint8_t* data = ts.component_data_ptr(component);
+    data_.emplace_back(data, data + size);
     desc_[component] = *ts.desc_ptr_[component];
+    desc_[component].size = size;
   }
 
   init_pointers();
 }
 
-StorableTimeslice::StorableTimeslice() = default;
+StorableTimeslice::StorableTimeslice()
+    : arena_(TimesliceArena::acquire()),
+      data_(TimesliceArenaAllocator<TimesliceArenaBuffer>(arena_.get())) {}
+
+void StorableTimeslice::select_components(const ComponentFilter& filter) {
+  if (filter.all()) {
+    return;
+  }
+  std::size_t selected = 0;
+  for (std::size_t c = 0; c < num_components(); ++c) {
+    if (component_selected(c, filter)) {
+      if (selected != c) {
+        data_[selected] = std::move(data_[c]);
+        desc_[selected] = desc_[c];
+      }
+      ++selected;
+    }
+  }
+  data_.erase(data_.begin() + static_cast<std::ptrdiff_t>(selected),
+              data_.end());
+  desc_.resize(selected);
+  timeslice_descriptor_.num_components = selected;
+  init_pointers();
+}
 
 } // namespace fles
@@ -3,12 +3,17 @@
 /// \brief Defines the fles::StorableTimeslice class.
 #pragma once
 
+#include "AllocationStats.hpp"
 #include "ArchiveDescriptor.hpp"
+#include "DescriptorCodec.hpp"
 #include "StorableMicroslice.hpp"
 #include "Timeslice.hpp"
+#include "TimesliceArena.hpp"
+#include "TimesliceSerializer.hpp"
 #include <algorithm>
 #include <cstdint>
 #include <fstream>
+#include <stdexcept>
 #include <vector>
 
 #include <boost/serialization/access.hpp>
@@ -28,6 +33,10 @@ class InputArchiveSequence;
 
 /**
  * \brief The StorableTimeslice class contains the data of a single timeslice.
+ *
+ * The component data is allocated from a TimesliceArena, which is returned
+ * to a pool for reuse by later timeslices on destruction. The objects are
+ * accounted in cbm::AllocationStats if enabled.
  */
 class StorableTimeslice : public Timeslice {
 public:
@@ -41,10 +50,17 @@ public:
   /// Construct by copying from given Timeslice object.
   StorableTimeslice(const Timeslice& ts);
 
+  /// Construct by copying from given Timeslice object, optionally the
+  /// microslice descriptors only.
+  /** A descriptor-only copy does not access the microslice contents (see
+      Timeslice::content_omitted()). */
+  StorableTimeslice(const Timeslice& ts, bool descriptors_only);
+
   /// Construct and initialize empty timeslice to fill using append_component.
   explicit StorableTimeslice(uint32_t num_core_microslices,
                              uint64_t index = UINT64_MAX,
-                             uint64_t ts_pos = UINT64_MAX) {
+                             uint64_t ts_pos = UINT64_MAX)
+      : StorableTimeslice() {
     timeslice_descriptor_.index = index;
     timeslice_descriptor_.ts_pos = ts_pos;
     timeslice_descriptor_.num_core_microslices = num_core_microslices;
@@ -59,17 +75,12 @@ public:
     ts_desc.offset = 0;
     ts_desc.num_microslices = num_microslices;
 
-    std::vector<uint8_t> data;
-    for (uint64_t m = 0; m < num_microslices; ++m) {
-      MicrosliceDescriptor desc = MicrosliceDescriptor();
-      auto* desc_bytes = reinterpret_cast<uint8_t*>(&desc);
-      data.insert(data.end(), desc_bytes,
-                  desc_bytes + sizeof(MicrosliceDescriptor));
-    }
+    // zero-initialized microslice descriptors
+    TimesliceArenaBuffer& data = data_.emplace_back(
+        num_microslices * sizeof(MicrosliceDescriptor), uint8_t{0});
 
     ts_desc.size = data.size();
     desc_.push_back(ts_desc);
-    data_.push_back(data);
     uint32_t component = timeslice_descriptor_.num_components++;
 
     init_pointers();
@@ -82,7 +93,7 @@ public:
                              MicrosliceDescriptor descriptor,
                              const uint8_t* content) {
     assert(component < timeslice_descriptor_.num_components);
-    std::vector<uint8_t>& this_data = data_[component];
+    TimesliceArenaBuffer& this_data = data_[component];
     TimesliceComponentDescriptor& this_desc = desc_[component];
 
     assert(microslice < this_desc.num_microslices);
@@ -114,6 +125,44 @@ public:
     return append_microslice(component, microslice, m.desc(), m.content());
   }
 
+  /// Restrict the timeslice to the components selected by a filter (and
+  /// release the data of all other components).
+  void select_components(const ComponentFilter& filter) override;
+
+  /// Serialize with compactly encoded microslice descriptors (used by the
+  /// archive classes, see DescriptorEncoding).
+  /** The encoding of each component is independent, so that timeslices can
+      be read individually through an index. */
+  template <class Archive>
+  void save_compact(Archive& ar, DescriptorCodec& codec) const {
+    TimesliceSerializer(*this).save_compact(ar, codec);
+  }
+
+  /// Deserialize with compactly encoded microslice descriptors.
+  template <class Archive>
+  void load_compact(Archive& ar, DescriptorCodec& codec) {
+    ar >> timeslice_descriptor_;
+    ar >> desc_;
+    data_.clear();
+    data_.reserve(desc_.size());
+    for (auto& ts_desc : desc_) {
+      const uint64_t desc_size =
+          ts_desc.num_microslices * sizeof(MicrosliceDescriptor);
+      uint64_t content_size = 0;
+      ar >> content_size;
+      if (desc_size + content_size != ts_desc.size) {
+        throw std::runtime_error("inconsistent timeslice component in archive");
+      }
+      // decode the descriptors in place into the standard layout
+      TimesliceArenaBuffer& data = data_.emplace_back(ts_desc.size, uint8_t{0});
+      codec.reset();
+      codec.load(ar, reinterpret_cast<MicrosliceDescriptor*>(data.data()),
+                 ts_desc.num_microslices);
+      ar.load_binary(data.data() + desc_size, content_size);
+    }
+    init_pointers();
+  }
+
 private:
   friend class boost::serialization::access;
   friend class InputArchive<Timeslice,
@@ -126,6 +175,9 @@ private:
                                     StorableTimeslice,
                                     ArchiveType::TimesliceArchive>;
   friend class TimesliceSubscriber;
+  friend class TimesliceIndexedInputArchive;
+  friend class ChunkedTimesliceInputArchive;
+  friend class NativeArchiveReader;
 
   StorableTimeslice();
 
@@ -139,16 +191,27 @@ private:
   }
 
   void init_pointers() {
+    reset_caches();
     data_ptr_.resize(num_components());
     desc_ptr_.resize(num_components());
     for (size_t c = 0; c < num_components(); ++c) {
       desc_ptr_[c] = &desc_[c];
       data_ptr_[c] = data_[c].data();
     }
+    if (alloc_record_.Active()) {
+      std::size_t bytes = sizeof(*this);
+      for (const auto& data : data_) {
+        bytes += data.capacity();
+      }
+      alloc_record_.Update(bytes);
+    }
   }
 
-  std::vector<std::vector<uint8_t>> data_;
+  /// Arena holding the component data, declared first to outlive data_.
+  TimesliceArena::Handle arena_;
+  TimesliceArenaBuffers data_;
   std::vector<TimesliceComponentDescriptor> desc_;
+  cbm::AllocationRecord alloc_record_{cbm::AllocationStats::kTimeslice};
 };
 
 } // namespace fles
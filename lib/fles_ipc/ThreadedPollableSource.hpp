@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::ThreadedPollableSource template class.
+#pragma once
+
+#include "PollableSource.hpp"
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <sys/eventfd.h>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+
+namespace fles {
+
+/**
+ * \brief The ThreadedPollableSource class provides the PollableSource
+ * interface for a given blocking source.
+ *
+ * The wrapped source is read ahead on a background thread into a bounded
+ * queue of at most max_items items, as in PrefetchingSource. An eventfd
+ * counter is raised for each queued item and drained once the queue has been
+ * emptied, so the file descriptor is readable while items are available.
+ * Exceptions thrown by the wrapped source are rethrown by try_get() and
+ * get().
+ */
+template <class T> class ThreadedPollableSource : public PollableSource<T> {
+public:
+  /**
+   * \brief Construct a threaded pollable source object and start reading
+   * ahead.
+   *
+   * \param source    The input source to read data from
+   * \param max_items Maximum number of items to read ahead
+   */
+  ThreadedPollableSource(std::unique_ptr<Source<T>> source,
+                         std::size_t max_items = 1)
+      : source_(std::move(source)), max_items_(max_items == 0 ? 1 : max_items),
+        event_fd_(::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) {
+    if (event_fd_ < 0) {
+      throw std::system_error(errno, std::generic_category(), "eventfd");
+    }
+    thread_ = std::thread(&ThreadedPollableSource::read, this);
+  }
+
+  /// Delete copy constructor (non-copyable).
+  ThreadedPollableSource(const ThreadedPollableSource&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const ThreadedPollableSource&) = delete;
+
+  /// Stop reading ahead. Waits for a pending read of the wrapped source.
+  ~ThreadedPollableSource() override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopped_ = true;
+    }
+    not_full_.notify_all();
+    thread_.join();
+    ::close(event_fd_);
+  }
+
+  [[nodiscard]] bool eos() const override { return eos_; }
+
+  [[nodiscard]] int poll_fd() override { return event_fd_; }
+
+private:
+  std::unique_ptr<Source<T>> source_;
+  std::size_t max_items_;
+  int event_fd_;
+
+  std::mutex mutex_;
+  std::condition_variable not_full_;
+  std::deque<std::unique_ptr<T>> queue_;
+  bool finished_ = false;
+  bool stopped_ = false;
+  std::exception_ptr exception_;
+  std::thread thread_;
+
+  bool eos_ = false;
+
+  /// Raise the eventfd counter. Called with the mutex held.
+  void signal() const {
+    const uint64_t one = 1;
+    [[maybe_unused]] auto n = ::write(event_fd_, &one, sizeof(one));
+  }
+
+  void read() {
+    try {
+      while (true) {
+        {
+          std::unique_lock<std::mutex> lock(mutex_);
+          not_full_.wait(
+              lock, [this] { return stopped_ || queue_.size() < max_items_; });
+          if (stopped_) {
+            return;
+          }
+        }
+        auto item = source_->get();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!item) {
+          finished_ = true;
+          signal();
+          return;
+        }
+        queue_.push_back(std::move(item));
+        signal();
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      exception_ = std::current_exception();
+      finished_ = true;
+      signal();
+    }
+  }
+
+  T* do_try_get() override {
+    if (eos_) {
+      return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!queue_.empty()) {
+      auto item = std::move(queue_.front());
+      queue_.pop_front();
+      not_full_.notify_one();
+      return item.release();
+    }
+    if (finished_) {
+      eos_ = true;
+      if (exception_) {
+        std::rethrow_exception(exception_);
+      }
+      return nullptr;
+    }
+    // nothing queued, wait for the next signal
+    uint64_t count = 0;
+    [[maybe_unused]] auto n = ::read(event_fd_, &count, sizeof(count));
+    return nullptr;
+  }
+};
+
+} // namespace fles
@@ -1,9 +1,76 @@
 // Copyright 2014 Jan de Cuveland <cmail@cuveland.de>
 
 #include "Timeslice.hpp"
+#include "TimesliceTimeIndex.hpp"
 
 namespace fles {
 
 Timeslice::~Timeslice() = default;
 
+uint8_t* Timeslice::load_component(uint64_t component) const {
+  return data_ptr_[component];
+}
+
+void Timeslice::materialize() const {
+  for (uint64_t c = 0; c < num_components(); ++c) {
+    (void)component_data_ptr(c);
+  }
+}
+
+std::shared_ptr<const TimesliceTimeIndex> Timeslice::time_index() const {
+  auto index = std::atomic_load(&time_index_);
+  if (!index) {
+    index = std::make_shared<const TimesliceTimeIndex>(*this);
+    std::atomic_store(&time_index_, index);
+  }
+  return index;
+}
+
+ComponentSummary Timeslice::component_summary(uint64_t component) const {
+  const TimesliceComponentDescriptor& desc = *desc_ptr_[component];
+  if (component < summary_ptr_.size() && summary_ptr_[component] != nullptr) {
+    ComponentSummary summary = *summary_ptr_[component];
+    if (summary.valid_for(desc.ts_num, desc.num_microslices)) {
+      return summary;
+    }
+  }
+  auto summaries = std::atomic_load(&summaries_);
+  if (!summaries) {
+    auto computed = std::make_shared<std::vector<ComponentSummary>>();
+    computed->reserve(num_components());
+    for (uint64_t c = 0; c < num_components(); ++c) {
+      const uint64_t n = num_microslices(c);
+      computed->push_back(ComponentSummary::compute(
+          desc_ptr_[c]->ts_num, n != 0 ? &descriptor(c, 0) : nullptr, n));
+    }
+    summaries = std::move(computed);
+    std::atomic_store(&summaries_, summaries);
+  }
+  return (*summaries)[component];
+}
+
+void Timeslice::select_components(const ComponentFilter& filter) {
+  if (filter.all()) {
+    return;
+  }
+  std::size_t selected = 0;
+  for (std::size_t c = 0; c < num_components(); ++c) {
+    if (component_selected(c, filter)) {
+      data_ptr_[selected] = data_ptr_[c];
+      desc_ptr_[selected] = desc_ptr_[c];
+      if (!summary_ptr_.empty()) {
+        summary_ptr_[selected] = summary_ptr_[c];
+      }
+      ++selected;
+    }
+  }
+  data_ptr_.resize(selected);
+  desc_ptr_.resize(selected);
+  if (!summary_ptr_.empty()) {
+    summary_ptr_.resize(selected);
+  }
+  timeslice_descriptor_.num_components = selected;
+  reset_caches();
+}
+
 } // namespace fles
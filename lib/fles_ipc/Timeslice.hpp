@@ -3,11 +3,16 @@
 /// \brief Defines the fles::Timeslice abstract base class.
 #pragma once
 
+#include "ComponentFilter.hpp"
+#include "ComponentSummary.hpp"
+#include "ComponentView.hpp"
 #include "MicrosliceDescriptor.hpp"
 #include "MicrosliceView.hpp"
 #include "TimesliceComponentDescriptor.hpp"
 #include "TimesliceDescriptor.hpp"
 #include <fstream>
+#include <memory>
+#include <utility>
 #include <vector>
 
 #include <boost/serialization/access.hpp>
@@ -19,6 +24,8 @@ class ManagedTimesliceBuffer;
 
 namespace fles {
 
+class TimesliceTimeIndex;
+
 /**
  * \brief The Timeslice class provides read access to the data of a timeslice.
  *
@@ -42,6 +49,12 @@ public:
     return desc_ptr_[component]->num_microslices;
   }
 
+  /// Check whether a component is missing from the timeslice (i.e., has no
+  /// microslices).
+  [[nodiscard]] bool component_missing(uint64_t component) const {
+    return num_microslices(component) == 0;
+  }
+
   /// Retrieve the number of components (contributing input channels).
   [[nodiscard]] uint64_t num_components() const {
     return timeslice_descriptor_.num_components;
@@ -52,10 +65,28 @@ public:
     return desc_ptr_[component]->size;
   }
 
+  /// Check whether the microslice contents of a component are omitted.
+  /**
+   * The component data of a descriptor-only timeslice (e.g., see
+   * StorableTimeslice(const Timeslice&, bool)) holds the microslice
+   * descriptors only, and size_component() is the size of the descriptors.
+   * The descriptors still specify the original content sizes, but content()
+   * must not be accessed.
+   */
+  [[nodiscard]] bool content_omitted(uint64_t component) const {
+    const uint64_t n = num_microslices(component);
+    if (n == 0 ||
+        size_component(component) != n * sizeof(MicrosliceDescriptor)) {
+      return false;
+    }
+    const auto& last = descriptor(component, n - 1);
+    return last.offset + last.size != descriptor(component, 0).offset;
+  }
+
   /// Retrieve a pointer to the data content of a given microslice
   [[nodiscard]] const uint8_t* content(uint64_t component,
                                        uint64_t microslice) const {
-    return data_ptr_[component] +
+    return component_data_ptr(component) +
            desc_ptr_[component]->num_microslices *
                sizeof(MicrosliceDescriptor) +
            descriptor(component, microslice).offset -
@@ -66,28 +97,49 @@ public:
   [[nodiscard]] const MicrosliceDescriptor&
   descriptor(uint64_t component, uint64_t microslice) const {
     return reinterpret_cast<const MicrosliceDescriptor*>(
-        data_ptr_[component])[microslice];
+        component_data_ptr(component))[microslice];
   }
 
   /// Retrieve the descriptor and pointer to the data of a given microslice
   [[nodiscard]] MicrosliceView get_microslice(uint64_t component,
                                               uint64_t microslice_index) const {
-    uint8_t* component_data_ptr = data_ptr_[component];
+    uint8_t* data = component_data_ptr(component);
 
-    MicrosliceDescriptor& dd = reinterpret_cast<MicrosliceDescriptor*>(
-        component_data_ptr)[microslice_index];
+    MicrosliceDescriptor& dd =
+        reinterpret_cast<MicrosliceDescriptor*>(data)[microslice_index];
 
     MicrosliceDescriptor& dd0 =
-        reinterpret_cast<MicrosliceDescriptor*>(component_data_ptr)[0];
+        reinterpret_cast<MicrosliceDescriptor*>(data)[0];
 
-    uint8_t* cc =
-        component_data_ptr +
-        desc_ptr_[component]->num_microslices * sizeof(MicrosliceDescriptor) +
-        dd.offset - dd0.offset;
+    uint8_t* cc = data +
+                  desc_ptr_[component]->num_microslices *
+                      sizeof(MicrosliceDescriptor) +
+                  dd.offset - dd0.offset;
 
     return {dd, cc};
   }
 
+  /// Retrieve a flat view of the microslices of a given component, for
+  /// iterating them without recomputing the component offsets
+  [[nodiscard]] ComponentView component(uint64_t component) const {
+    return {component_data_ptr(component), *desc_ptr_[component]};
+  }
+
+  /// Call fn(index, microslice) for each microslice of a component, with
+  /// the descriptors and contents prefetched ahead (see
+  /// ComponentView::for_each()).
+  template <typename Fn>
+  void for_each_microslice(uint64_t component, Fn&& fn) const {
+    this->component(component).for_each(std::forward<Fn>(fn));
+  }
+
+  /// Retrieve the summary of the microslice descriptors of a component.
+  /** The summary transmitted with the component is used if available (see
+      ComponentSummary). Otherwise, the summaries of all components are
+      computed from the descriptors on first use and cached like the time
+      index. */
+  [[nodiscard]] ComponentSummary component_summary(uint64_t component) const;
+
   /// Retrieve the offical start time of the timeslice
   [[nodiscard]] uint64_t start_time() const {
     if (num_components() != 0 && num_microslices(0) != 0) {
@@ -96,21 +148,89 @@ public:
     return 0;
   }
 
+  /// Retrieve the index for time window queries on the microslices (see
+  /// TimesliceTimeIndex), built on first use.
+  /** The index is cached with the timeslice and shared by its copies, and
+      rebuilt after the components have changed. Concurrent calls are safe,
+      but may build the index more than once. */
+  [[nodiscard]] std::shared_ptr<const TimesliceTimeIndex> time_index() const;
+
+  /**
+   * \brief Restrict the timeslice to the components selected by a filter.
+   *
+   * Only the first microslice descriptor of each component is accessed. The
+   * selected components keep their original order.
+   */
+  virtual void select_components(const ComponentFilter& filter);
+
+  /// Load the data of all components of a lazily materialized timeslice
+  /// (see LazyTimeslice), e.g., before accessing it from several threads.
+  void materialize() const;
+
 protected:
   Timeslice() = default;
 
+  /// Discard the cached time index and component summaries after a change
+  /// of the components.
+  void reset_caches() {
+    std::atomic_store(&time_index_,
+                      std::shared_ptr<const TimesliceTimeIndex>());
+    std::atomic_store(&summaries_,
+                      std::shared_ptr<const std::vector<ComponentSummary>>());
+  }
+
+  /// Retrieve the data of a component, loading it first if the timeslice
+  /// is materialized lazily.
+  [[nodiscard]] uint8_t* component_data_ptr(uint64_t component) const {
+    uint8_t* data = data_ptr_[component];
+    return data != nullptr ? data : load_component(component);
+  }
+
+  /// Load the data of a component on first access.
+  /** Lazily materialized timeslices (see LazyTimeslice) leave the data
+      pointer of a component null until then. The default implementation
+      returns the data pointer unchanged. */
+  virtual uint8_t* load_component(uint64_t component) const;
+
+  /// Check whether a component is selected by a filter.
+  [[nodiscard]] bool component_selected(uint64_t component,
+                                        const ComponentFilter& filter) const {
+    return num_microslices(component) != 0 &&
+           filter.matches(descriptor(component, 0));
+  }
+
   friend class StorableTimeslice;
+  friend class TimesliceCachedArchiveLoop;
+  friend class TimesliceCachedView;
+  friend class ChunkedTimesliceOutputArchive;
+  friend class NativeArchiveWriter;
+  friend class TimeslicePublisher;
+  friend class TimesliceSerializer;
+  friend class TimesliceTap;
   friend class ::ManagedTimesliceBuffer;
 
   /// The timeslice descriptor.
   TimesliceDescriptor timeslice_descriptor_{};
 
-  /// A vector of pointers to the data content, one per timeslice component.
-  std::vector<uint8_t*> data_ptr_;
+  /// A vector of pointers to the data content, one per timeslice component
+  /// (null until loaded if materialized lazily).
+  mutable std::vector<uint8_t*> data_ptr_;
 
   /// \brief A vector of pointers to the microslice descriptors, one per
   /// timeslice component.
   std::vector<TimesliceComponentDescriptor*> desc_ptr_;
+
+  /// A vector of pointers to the summaries transmitted with the
+  /// components, one per timeslice component (null if not available), or
+  /// empty if the timeslice has none.
+  std::vector<const ComponentSummary*> summary_ptr_;
+
+private:
+  /// The cached time index (see time_index()).
+  mutable std::shared_ptr<const TimesliceTimeIndex> time_index_;
+
+  /// The cached computed component summaries (see component_summary()).
+  mutable std::shared_ptr<const std::vector<ComponentSummary>> summaries_;
 };
 
 } // namespace fles
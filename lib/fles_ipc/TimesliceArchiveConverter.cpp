@@ -0,0 +1,178 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "TimesliceArchiveConverter.hpp"
+#include "TimesliceIndexedInputArchive.hpp"
+#include "TimesliceOutputArchive.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include <boost/algorithm/string/replace.hpp>
+
+namespace fles {
+
+TimesliceArchiveConverter::TimesliceArchiveConverter(
+    std::vector<std::string> inputs,
+    std::string output_template,
+    ArchiveConversion conversion)
+    : output_template_(std::move(output_template)),
+      conversion_(std::move(conversion)) {
+  for (auto& filename : inputs) {
+    TimesliceIndexedInputArchive archive(filename);
+    Input input{filename, archive.index(),
+                archive.descriptor().descriptor_encoding(), 0, nullptr};
+    // the class information is complete after the first timeslice with
+    // components, cf. TimesliceIndexedInputArchive::seek()
+    while (auto ts = archive.read_at(input.head)) {
+      ++input.head;
+      if (ts->num_components() > 0) {
+        break;
+      }
+    }
+    input.file = std::make_shared<const MappedFile>(std::move(filename));
+    inputs_.push_back(std::move(input));
+  }
+  plan();
+}
+
+void TimesliceArchiveConverter::plan() {
+  std::vector<Frame> frames;
+  auto close_output = [&] {
+    if (!frames.empty()) {
+      outputs_.push_back(std::move(frames));
+      frames.clear();
+    }
+  };
+
+  for (std::size_t i = 0; i < inputs_.size(); ++i) {
+    const auto& entries = inputs_[i].index.entries();
+    for (std::size_t position = 0; position < entries.size(); ++position) {
+      if (entries[position].index < conversion_.first ||
+          entries[position].index > conversion_.last) {
+        continue;
+      }
+      frames.push_back({i, position});
+      if (frames.size() == conversion_.items_per_file) {
+        close_output();
+      }
+    }
+    if (conversion_.items_per_file == 0) {
+      close_output();
+    }
+  }
+  close_output();
+
+  // append sequence number to file name if missing in template
+  if (outputs_.size() > 1 &&
+      output_template_.find("%n") == std::string::npos) {
+    output_template_ += ".%n";
+  }
+}
+
+std::string TimesliceArchiveConverter::output_filename(std::size_t n) const {
+  std::ostringstream number;
+  number << std::setw(4) << std::setfill('0') << n;
+  return boost::replace_all_copy(output_template_, "%n", number.str());
+}
+
+ArchiveConversionStatistics TimesliceArchiveConverter::run() {
+  std::vector<ArchiveConversionStatistics> statistics(outputs_.size());
+  std::atomic<std::size_t> next{0};
+  std::mutex error_mutex;
+  std::exception_ptr error;
+
+  auto worker = [&] {
+    for (std::size_t n = next++; n < outputs_.size(); n = next++) {
+      try {
+        write_output(n, statistics[n]);
+      } catch (...) {
+        const std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+        next = outputs_.size();
+      }
+    }
+  };
+
+  const std::size_t num_threads =
+      std::min(std::max<std::size_t>(conversion_.threads, 1),
+               std::max<std::size_t>(outputs_.size(), 1));
+  std::vector<std::thread> threads;
+  for (std::size_t t = 1; t < num_threads; ++t) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+
+  ArchiveConversionStatistics total;
+  for (const auto& s : statistics) {
+    total.files += s.files;
+    total.copied += s.copied;
+    total.transformed += s.transformed;
+    total.copied_bytes += s.copied_bytes;
+  }
+  return total;
+}
+
+void TimesliceArchiveConverter::write_output(
+    std::size_t n, ArchiveConversionStatistics& statistics) {
+  const auto& frames = outputs_[n];
+  const DescriptorEncoding encoding = conversion_.descriptor_encoding.value_or(
+      inputs_[frames.front().input].descriptor_encoding);
+  const bool write_index = conversion_.write_index &&
+                           conversion_.compression == ArchiveCompression::None;
+  TimesliceOutputArchive output(output_filename(n), conversion_.compression,
+                                write_index, conversion_.zstd_parameters, {},
+                                encoding);
+
+  std::map<std::size_t, std::unique_ptr<TimesliceIndexedInputArchive>>
+      readers;
+  bool class_info_complete = false;
+  for (const auto& frame : frames) {
+    const Input& input = inputs_[frame.input];
+    const auto& entry = input.index.entries()[frame.position];
+
+    if (class_info_complete && frame.position >= input.head &&
+        conversion_.filter.all() && input.descriptor_encoding == encoding) {
+      output.put_serialized(input.file->data() + entry.offset, entry.size,
+                            entry);
+      ++statistics.copied;
+      statistics.copied_bytes += entry.size;
+      continue;
+    }
+
+    auto& reader = readers[frame.input];
+    if (!reader) {
+      reader = std::make_unique<TimesliceIndexedInputArchive>(input.filename,
+                                                              input.index);
+    }
+    std::shared_ptr<StorableTimeslice> ts = reader->read_at(frame.position);
+    if (!ts) {
+      throw std::runtime_error("Archive file \"" + input.filename +
+                               "\" ends before last indexed timeslice");
+    }
+    ts->select_components(conversion_.filter);
+    if (ts->num_components() > 0) {
+      class_info_complete = true;
+    }
+    output.put(ts);
+    ++statistics.transformed;
+  }
+  ++statistics.files;
+}
+
+} // namespace fles
@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::TimesliceArchiveConverter class.
+#pragma once
+
+#include "ArchiveDescriptor.hpp"
+#include "ArchiveIndex.hpp"
+#include "ComponentFilter.hpp"
+#include "MappedFile.hpp"
+#include "ZstdFrameCompressor.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace fles {
+
+/// Parameters of a conversion of timeslice archive files.
+struct ArchiveConversion {
+  /// Number of timeslices per output file (0: one file per input file).
+  std::size_t items_per_file = 0;
+
+  /// Lowest timeslice index to keep.
+  uint64_t first = 0;
+
+  /// Highest timeslice index to keep.
+  uint64_t last = UINT64_MAX;
+
+  /// Selection of components to keep.
+  ComponentFilter filter;
+
+  /// Compression type of the output files.
+  ArchiveCompression compression = ArchiveCompression::None;
+
+  /// Level and number of threads for zstd compression.
+  ZstdParameters zstd_parameters;
+
+  /// Encoding of the microslice descriptors (default: as in the input).
+  std::optional<DescriptorEncoding> descriptor_encoding;
+
+  /// Write an index sidecar file for each uncompressed output file.
+  bool write_index = true;
+
+  /// Number of output files written concurrently.
+  std::size_t threads = 1;
+};
+
+/// Statistics of a conversion of timeslice archive files.
+struct ArchiveConversionStatistics {
+  /// Number of output files written.
+  std::size_t files = 0;
+
+  /// Number of timeslices copied verbatim.
+  uint64_t copied = 0;
+
+  /// Number of timeslices deserialized and serialized again.
+  uint64_t transformed = 0;
+
+  /// Number of bytes copied verbatim.
+  uint64_t copied_bytes = 0;
+};
+
+/**
+ * \brief The TimesliceArchiveConverter class re-chunks, filters, and
+ * recompresses uncompressed timeslice archive files.
+ *
+ * The timeslices are located through the index of each input file (see
+ * TimesliceIndexedInputArchive). Wherever the serialized form of a timeslice
+ * is unchanged by the conversion, its bytes are copied verbatim from the
+ * memory-mapped input file without deserialization. Only the timeslices
+ * carrying the boost class information (the first timeslices of each input
+ * and output file), and all timeslices affected by a component selection or
+ * a change of the descriptor encoding, are deserialized and serialized
+ * again.
+ *
+ * The output files are independent of each other and are written in
+ * parallel by the given number of threads.
+ */
+class TimesliceArchiveConverter {
+public:
+  /**
+   * \brief Construct a converter and plan the output files.
+   *
+   * \param inputs          File names of the (uncompressed) input archives
+   * \param output_template File name template of the output archives; a
+   *                        placeholder "%n" is replaced by the file number,
+   *                        and ".%n" is appended if there are several files
+   * \param conversion      Parameters of the conversion
+   */
+  TimesliceArchiveConverter(std::vector<std::string> inputs,
+                            std::string output_template,
+                            ArchiveConversion conversion);
+
+  /// Write all output files.
+  ArchiveConversionStatistics run();
+
+  /// Retrieve the number of output files.
+  [[nodiscard]] std::size_t num_output_files() const {
+    return outputs_.size();
+  }
+
+  /// Retrieve the file name of an output file.
+  [[nodiscard]] std::string output_filename(std::size_t n) const;
+
+private:
+  struct Input {
+    std::string filename;
+    ArchiveIndex index;
+    DescriptorEncoding descriptor_encoding;
+    /// Number of leading timeslices holding boost class information.
+    std::size_t head;
+    std::shared_ptr<const MappedFile> file;
+  };
+
+  struct Frame {
+    std::size_t input;
+    std::size_t position;
+  };
+
+  std::vector<Input> inputs_;
+  std::vector<std::vector<Frame>> outputs_;
+  std::string output_template_;
+  ArchiveConversion conversion_;
+
+  void plan();
+  void write_output(std::size_t n, ArchiveConversionStatistics& statistics);
+};
+
+} // namespace fles
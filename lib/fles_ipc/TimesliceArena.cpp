@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "TimesliceArena.hpp"
+#include <algorithm>
+#include <mutex>
+
+namespace fles {
+
+namespace {
+
+/// Maximum number of unused arenas kept for reuse.
+constexpr std::size_t max_free_arenas = 8;
+
+std::mutex& pool_mutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::vector<std::unique_ptr<TimesliceArena>>& free_arenas() {
+  static std::vector<std::unique_ptr<TimesliceArena>> arenas;
+  return arenas;
+}
+
+} // namespace
+
+void TimesliceArena::Recycler::operator()(TimesliceArena* arena) const {
+  std::unique_ptr<TimesliceArena> owned(arena);
+  arena->reset(arena->demand_);
+  std::lock_guard<std::mutex> lock(pool_mutex());
+  if (free_arenas().size() < max_free_arenas) {
+    free_arenas().push_back(std::move(owned));
+  }
+}
+
+TimesliceArena::Handle TimesliceArena::acquire(std::size_t bytes) {
+  std::unique_ptr<TimesliceArena> arena;
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex());
+    auto& arenas = free_arenas();
+    if (!arenas.empty()) {
+      // prefer the smallest arena that is large enough, or the most recently
+      // returned one if the size is not known in advance
+      auto it = arenas.end() - 1;
+      if (bytes != 0) {
+        it = std::min_element(
+            arenas.begin(), arenas.end(),
+            [bytes](const auto& a, const auto& b) {
+              bool a_fits = a->capacity_ >= bytes;
+              bool b_fits = b->capacity_ >= bytes;
+              if (a_fits != b_fits) {
+                return a_fits;
+              }
+              return a_fits ? a->capacity_ < b->capacity_
+                            : a->capacity_ > b->capacity_;
+            });
+      }
+      arena = std::move(*it);
+      arenas.erase(it);
+    }
+  }
+  if (!arena) {
+    arena = std::make_unique<TimesliceArena>();
+  }
+  if (arena->capacity_ < bytes) {
+    arena->reset(bytes);
+  }
+  return Handle(arena.release());
+}
+
+void* TimesliceArena::allocate(std::size_t bytes) {
+  bytes = aligned(bytes);
+  demand_ += bytes;
+  if (used_ + bytes <= capacity_) {
+    void* p = block_.get() + used_;
+    used_ += bytes;
+    return p;
+  }
+  // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+  overflow_.emplace_back(new uint8_t[bytes]);
+  return overflow_.back().get();
+}
+
+void TimesliceArena::deallocate(void* p, std::size_t bytes) noexcept {
+  bytes = aligned(bytes);
+  if (used_ >= bytes && p == block_.get() + used_ - bytes) {
+    used_ -= bytes;
+    demand_ -= bytes;
+  }
+}
+
+void TimesliceArena::reset(std::size_t bytes) {
+  overflow_.clear();
+  if (capacity_ < bytes) {
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    block_.reset(new uint8_t[bytes]);
+    capacity_ = bytes;
+  }
+  used_ = 0;
+  demand_ = 0;
+}
+
+} // namespace fles
@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::TimesliceArena class and related types.
+#pragma once
+
+#include <boost/serialization/level.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <scoped_allocator>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief The TimesliceArena class provides the memory for the data of a
+ * single StorableTimeslice.
+ *
+ * Memory is handed out consecutively from one contiguous block and is only
+ * reclaimed as a whole when the arena is returned to the pool. Allocations
+ * exceeding the block are served from additional blocks, and the arena is
+ * enlarged to fit all of them when it is recycled. An arena must only be
+ * used by one thread at a time.
+ */
+class TimesliceArena {
+public:
+  /// Deleter returning an arena to the pool.
+  struct Recycler {
+    void operator()(TimesliceArena* arena) const;
+  };
+
+  /// Owning handle of an arena taken from the pool.
+  using Handle = std::unique_ptr<TimesliceArena, Recycler>;
+
+  /**
+   * \brief Take an arena from the pool, or create a new one.
+   *
+   * \param bytes Expected number of bytes to be allocated from the arena,
+   * or zero if unknown
+   */
+  static Handle acquire(std::size_t bytes = 0);
+
+  TimesliceArena() = default;
+  /// Delete copy constructor (non-copyable).
+  TimesliceArena(const TimesliceArena&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const TimesliceArena&) = delete;
+
+  /// Allocate memory, aligned to alignof(std::max_align_t).
+  void* allocate(std::size_t bytes);
+
+  /// Deallocate memory (only the latest allocation is actually reclaimed).
+  void deallocate(void* p, std::size_t bytes) noexcept;
+
+  /// Retrieve the size of the contiguous block in bytes.
+  [[nodiscard]] std::size_t capacity() const { return capacity_; }
+
+private:
+  static constexpr std::size_t alignment = alignof(std::max_align_t);
+
+  static std::size_t aligned(std::size_t bytes) {
+    return (bytes + alignment - 1) & ~(alignment - 1);
+  }
+
+  /// Release all allocations and ensure a block of at least given size.
+  void reset(std::size_t bytes);
+
+  std::unique_ptr<uint8_t[]> block_;
+  std::size_t capacity_ = 0;
+  std::size_t used_ = 0;
+
+  /// Blocks for allocations not fitting into the contiguous block.
+  std::vector<std::unique_ptr<uint8_t[]>> overflow_;
+  /// Total number of bytes allocated since the last reset.
+  std::size_t demand_ = 0;
+};
+
+/**
+ * \brief Allocator handing out memory from a TimesliceArena.
+ *
+ * A default-constructed allocator falls back to the global operator new.
+ */
+template <typename T> class TimesliceArenaAllocator {
+public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  TimesliceArenaAllocator() noexcept = default;
+
+  /// Construct an allocator for a given arena.
+  explicit TimesliceArenaAllocator(TimesliceArena* arena) noexcept
+      : arena_(arena) {}
+
+  /// Construct from an allocator for a different type.
+  template <typename U>
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  TimesliceArenaAllocator(const TimesliceArenaAllocator<U>& other) noexcept
+      : arena_(other.arena()) {}
+
+  T* allocate(std::size_t n) {
+    if (arena_ == nullptr) {
+      return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    return static_cast<T*>(arena_->allocate(n * sizeof(T)));
+  }
+
+  void deallocate(T* p, std::size_t n) noexcept {
+    if (arena_ == nullptr) {
+      ::operator delete(p);
+    } else {
+      arena_->deallocate(p, n * sizeof(T));
+    }
+  }
+
+  /// Retrieve the arena (nullptr if using the global operator new).
+  [[nodiscard]] TimesliceArena* arena() const { return arena_; }
+
+private:
+  TimesliceArena* arena_ = nullptr;
+};
+
+template <typename T, typename U>
+bool operator==(const TimesliceArenaAllocator<T>& lhs,
+                const TimesliceArenaAllocator<U>& rhs) {
+  return lhs.arena() == rhs.arena();
+}
+
+template <typename T, typename U>
+bool operator!=(const TimesliceArenaAllocator<T>& lhs,
+                const TimesliceArenaAllocator<U>& rhs) {
+  return !(lhs == rhs);
+}
+
+/// Buffer holding the data of a timeslice component.
+using TimesliceArenaBuffer =
+    std::vector<uint8_t, TimesliceArenaAllocator<uint8_t>>;
+
+/// Vector of component buffers, which share the arena of the vector.
+using TimesliceArenaBuffers =
+    std::vector<TimesliceArenaBuffer,
+                std::scoped_allocator_adaptor<
+                    TimesliceArenaAllocator<TimesliceArenaBuffer>>>;
+
+} // namespace fles
+
+// Serialize like std::vector<uint8_t> to keep the archive format unchanged
+BOOST_CLASS_IMPLEMENTATION(fles::TimesliceArenaBuffer,
+                           boost::serialization::object_serializable)
@@ -1,19 +1,152 @@
 // Copyright 2021 Jan de Cuveland <cmail@cuveland.de>
 #include "TimesliceAutoSource.hpp"
 
+#include "ArchiveCursor.hpp"
+#include "ArchiveManifest.hpp"
+#include "ChunkedTimesliceInputArchive.hpp"
 #include "ItemWorkerProtocol.hpp"
 #include "MergingSource.hpp"
+#include "NativeInputArchive.hpp"
+#include "ParallelSource.hpp"
+#include "PrefetchingSource.hpp"
+#include "RemoteStream.hpp"
+#include "ShardedTimesliceSubscriber.hpp"
+#include "StorableTimeslice.hpp"
 #include "System.hpp"
+#include "TimesliceCachedArchiveLoop.hpp"
+#include "TimesliceIndexedInputArchive.hpp"
 #include "TimesliceInputArchive.hpp"
+#include "TimesliceMappedArchive.hpp"
 #include "TimesliceReceiver.hpp"
 #include "TimesliceSubscriber.hpp"
+#include "TimesliceView.hpp"
 #include "Utility.hpp"
 
+#include <algorithm>
+#include <iomanip>
 #include <memory>
+#include <sstream>
 #include <string>
+#include <vector>
 
 namespace fles {
 
+namespace {
+
+// Expand the "%n" placeholder to the list of existing (local or remote)
+// files, stopping at the first missing sequence number like
+// TimesliceInputArchiveSequence does
+std::vector<std::string> sequence_filenames(const std::string& path) {
+  std::vector<std::string> filenames;
+  for (std::size_t n = 0;; ++n) {
+    std::ostringstream number;
+    number << std::setw(4) << std::setfill('0') << n;
+    auto filename = replace_all_copy(path, "%n", number.str());
+    if (!input_exists(filename)) {
+      break;
+    }
+    filenames.push_back(filename);
+  }
+  return filenames;
+}
+
+// Read the archive descriptor of a file
+ArchiveDescriptor archive_descriptor(const std::string& filename) {
+  MappedFile file(filename);
+  ArchiveCursor cursor(file, 0);
+  return cursor.read_archive_descriptor(filename);
+}
+
+// Check whether a file can be read through TimesliceMappedArchive
+bool mappable(const std::string& filename) {
+  const ArchiveDescriptor descriptor = archive_descriptor(filename);
+  return descriptor.archive_type() == ArchiveType::TimesliceArchive &&
+         descriptor.archive_compression() == ArchiveCompression::None &&
+         descriptor.descriptor_encoding() == DescriptorEncoding::Verbatim;
+}
+
+// Source restricting the timeslices of a source which cannot skip components
+// by itself to the components selected by a filter
+class ComponentSelectingSource : public TimesliceSource {
+public:
+  ComponentSelectingSource(std::unique_ptr<TimesliceSource> source,
+                           ComponentFilter filter)
+      : source_(std::move(source)), filter_(std::move(filter)) {}
+
+  [[nodiscard]] bool eos() const override { return source_->eos(); }
+
+private:
+  Timeslice* do_get() override {
+    auto timeslice = source_->get();
+    if (timeslice) {
+      timeslice->select_components(filter_);
+    }
+    return timeslice.release();
+  }
+
+  std::unique_ptr<TimesliceSource> source_;
+  ComponentFilter filter_;
+};
+
+// Source returning descriptor-only copies of the timeslices of a source,
+// releasing the original timeslices (e.g., in shared memory) right away
+class DescriptorOnlySource : public TimesliceSource {
+public:
+  explicit DescriptorOnlySource(std::unique_ptr<TimesliceSource> source)
+      : source_(std::move(source)) {}
+
+  [[nodiscard]] bool eos() const override { return source_->eos(); }
+
+private:
+  Timeslice* do_get() override {
+    auto timeslice = source_->get();
+    if (!timeslice) {
+      return nullptr;
+    }
+    const auto* view = dynamic_cast<const TimesliceView*>(timeslice.get());
+    if (view != nullptr && view->data_device() >= 0) {
+      throw std::runtime_error("query parameter desc_only not implemented "
+                               "for timeslice data on a GPU");
+    }
+    return new StorableTimeslice(*timeslice, true);
+  }
+
+  std::unique_ptr<TimesliceSource> source_;
+};
+
+// Wrap the sources from first_source on for the component selection (if
+// select_after_read), descriptor-only access and prefetching
+void wrap_sources(std::vector<std::unique_ptr<TimesliceSource>>& sources,
+                  std::size_t first_source,
+                  bool select_after_read,
+                  const ComponentFilter& filter,
+                  bool desc_only,
+                  std::size_t prefetch,
+                  std::size_t prefetch_bytes) {
+  if (select_after_read && !filter.all()) {
+    for (std::size_t i = first_source; i < sources.size(); ++i) {
+      sources[i] = std::make_unique<ComponentSelectingSource>(
+          std::move(sources[i]), filter);
+    }
+  }
+
+  if (desc_only) {
+    for (std::size_t i = first_source; i < sources.size(); ++i) {
+      sources[i] =
+          std::make_unique<DescriptorOnlySource>(std::move(sources[i]));
+    }
+  }
+
+  if (prefetch > 0) {
+    for (std::size_t i = first_source; i < sources.size(); ++i) {
+      sources[i] = std::make_unique<PrefetchingSource<TimesliceSource>>(
+          std::move(sources[i]), prefetch, prefetch_bytes);
+    }
+  }
+}
+
+} // namespace
+
 TimesliceAutoSource::TimesliceAutoSource(const std::string& locator) {
   // As a first step, treat ";" characters in the locator string as separators
   init(split(locator, ";"));
@@ -33,10 +166,56 @@ void TimesliceAutoSource::init(const std::vector<std::string>& locators) {
 
     if (uri.scheme == "file" || uri.scheme.empty()) {
       uint64_t cycles = 1;
+      bool cache = false;
+      bool renumber = false;
+      bool mmap = false;
+      bool mmap_given = false;
+      bool desc_only = false;
+      bool ranged = false;
+      uint64_t first = 0;
+      uint64_t last = UINT64_MAX;
+      bool chunked = false;
+      bool chunked_given = false;
+      bool lazy = false;
+      ComponentFilter filter;
+      std::size_t prefetch = 0;
+      std::size_t prefetch_bytes = SIZE_MAX;
+      std::size_t parallel = 1;
       for (auto& [key, value] : uri.query_components) {
         if (key == "cycles") {
           cycles = stoull(value);
-        } else {
+        } else if (key == "cache") {
+          cache = stoull(value) != 0;
+        } else if (key == "renumber") {
+          renumber = stoull(value) != 0;
+        } else if (key == "mmap") {
+          mmap = stoull(value) != 0;
+          mmap_given = true;
+        } else if (key == "desc_only") {
+          desc_only = stoull(value) != 0;
+        } else if (key == "start") {
+          first = stoull(value);
+          ranged = true;
+        } else if (key == "range") {
+          auto bounds = split(value, "-");
+          if (bounds.size() != 2) {
+            throw std::runtime_error("invalid timeslice range: " + value);
+          }
+          first = stoull(bounds[0]);
+          last = stoull(bounds[1]);
+          ranged = true;
+        } else if (key == "chunked") {
+          chunked = stoull(value) != 0;
+          chunked_given = true;
+        } else if (key == "lazy") {
+          lazy = stoull(value) != 0;
+        } else if (key == "prefetch") {
+          prefetch = stoull(value);
+        } else if (key == "prefetch_bytes") {
+          prefetch_bytes = stoull(value);
+        } else if (key == "parallel") {
+          parallel = stoull(value);
+        } else if (!parse_filter_parameter(key, value, filter)) {
           throw std::runtime_error(
               "query parameter not implemented for scheme file: " + key);
         }
@@ -51,16 +230,173 @@ void TimesliceAutoSource::init(const std::vector<std::string>& locators) {
       // string "0000". Nonexistant files are caught already at this stage by
       // glob() throwing a runtime_error.
       auto paths = system::glob(replace_all_copy(file_path, "%n", "0000"));
-      if (file_path.find("%n") != std::string::npos) {
+      const std::size_t first_source = sources.size();
+      // A run manifest lists the files of each writer, of which only those
+      // holding requested timeslices are opened
+      if (ArchiveManifest::is_manifest_filename(file_path)) {
+        if (chunked || lazy || cache || cycles != 1 || (ranged && mmap)) {
+          throw std::runtime_error("query parameters chunked, lazy, cache, "
+                                   "cycles and ranged mmap not implemented "
+                                   "for manifest input");
+        }
+        for (const auto& path : paths) {
+          for (auto& files :
+               ArchiveManifest::read(path).select(first, last, filter)) {
+            std::unique_ptr<fles::TimesliceSource> source;
+            if (ranged) {
+              source = std::make_unique<fles::TimesliceIndexedInputArchive>(
+                  std::move(files), first, last, filter);
+            } else if (mmap) {
+              source = std::make_unique<fles::TimesliceMappedArchive>(
+                  std::move(files), filter, desc_only);
+            } else {
+              source = std::make_unique<fles::TimesliceInputArchiveSequence>(
+                  std::move(files), parallel);
+            }
+            sources.emplace_back(std::move(source));
+          }
+        }
+        wrap_sources(sources, first_source, !ranged && !mmap, filter,
+                     desc_only && !mmap, prefetch, prefetch_bytes);
+        continue;
+      }
+      // Native archives are read sequentially
+      if (!paths.empty() && is_native_archive(paths.front())) {
+        if (chunked || lazy || ranged || mmap || cache || cycles != 1 ||
+            parallel > 1) {
+          throw std::runtime_error("query parameters chunked, lazy, range, "
+                                   "mmap, cache, cycles and parallel not "
+                                   "implemented for native input");
+        }
+        if (file_path.find("%n") != std::string::npos) {
+          for (auto& path : paths) {
+            replace_all(path, "0000", "%n");
+            std::unique_ptr<fles::TimesliceSource> source =
+                std::make_unique<fles::NativeTimesliceInputArchive>(
+                    sequence_filenames(path));
+            sources.emplace_back(std::move(source));
+          }
+        } else {
+          std::unique_ptr<fles::TimesliceSource> source =
+              std::make_unique<fles::NativeTimesliceInputArchive>(paths);
+          sources.emplace_back(std::move(source));
+        }
+        wrap_sources(sources, first_source, true, filter, desc_only, prefetch,
+                     prefetch_bytes);
+        continue;
+      }
+      // A component selection without further options reads chunked
+      // archives through the chunked archive reader
+      if (!chunked_given && !ranged && !mmap && !filter.all() &&
+          !paths.empty() &&
+          archive_descriptor(paths.front()).archive_type() ==
+              ArchiveType::ChunkedTimesliceArchive) {
+        chunked = true;
+      }
+      // Lazy timeslices are only implemented for chunked archives
+      if (lazy && !chunked) {
+        if (chunked_given) {
+          throw std::runtime_error("query parameter lazy requires chunked "
+                                   "input");
+        }
+        chunked = true;
+      }
+      // Descriptor-only access skips the contents of mappable archives
+      // without reading them, other sources drop them after reading
+      if (desc_only && !mmap_given && !chunked && !ranged && !cache &&
+          cycles == 1 && parallel == 1 && !paths.empty() &&
+          mappable(paths.front())) {
+        mmap = true;
+      }
+      if (renumber && !cache) {
+        throw std::runtime_error("query parameter renumber requires cache");
+      }
+      if (cache && (chunked || ranged || mmap || parallel > 1 ||
+                    file_path.find("%n") != std::string::npos ||
+                    paths.size() > 1)) {
+        throw std::runtime_error("query parameter cache only implemented for "
+                                 "a single archive file");
+      }
+      // Sources deserializing whole timeslices can only drop the unselected
+      // components afterwards
+      bool select_after_read = false;
+      if (chunked) {
+        if (ranged || mmap || cycles != 1 || parallel > 1) {
+          throw std::runtime_error("query parameters range, mmap, cycles and "
+                                   "parallel not implemented for chunked "
+                                   "input");
+        }
+        if (file_path.find("%n") != std::string::npos) {
+          for (auto& path : paths) {
+            replace_all(path, "0000", "%n");
+            auto source = std::make_unique<fles::ChunkedTimesliceInputArchive>(
+                sequence_filenames(path), filter);
+            source->set_lazy(lazy);
+            sources.emplace_back(std::move(source));
+          }
+        } else if (!paths.empty()) {
+          auto source = std::make_unique<fles::ChunkedTimesliceInputArchive>(
+              paths, filter);
+          source->set_lazy(lazy);
+          sources.emplace_back(std::move(source));
+        }
+      } else if (ranged) {
+        if (mmap || cycles != 1 || parallel > 1) {
+          throw std::runtime_error("query parameters mmap, cycles and "
+                                   "parallel not implemented for ranged "
+                                   "input");
+        }
+        if (file_path.find("%n") != std::string::npos) {
+          for (auto& path : paths) {
+            replace_all(path, "0000", "%n");
+            std::unique_ptr<fles::TimesliceSource> source =
+                std::make_unique<fles::TimesliceIndexedInputArchive>(
+                    sequence_filenames(path), first, last, filter);
+            sources.emplace_back(std::move(source));
+          }
+        } else if (!paths.empty()) {
+          std::unique_ptr<fles::TimesliceSource> source =
+              std::make_unique<fles::TimesliceIndexedInputArchive>(
+                  paths, first, last, filter);
+          sources.emplace_back(std::move(source));
+        }
+      } else if (mmap) {
+        if (cycles != 1 || parallel > 1) {
+          throw std::runtime_error("query parameters cycles and parallel not "
+                                   "implemented for mmap input");
+        }
+        if (file_path.find("%n") != std::string::npos) {
+          for (auto& path : paths) {
+            replace_all(path, "0000", "%n");
+            std::unique_ptr<fles::TimesliceSource> source =
+                std::make_unique<fles::TimesliceMappedArchive>(
+                    sequence_filenames(path), filter, desc_only);
+            sources.emplace_back(std::move(source));
+          }
+        } else if (!paths.empty()) {
+          std::unique_ptr<fles::TimesliceSource> source =
+              std::make_unique<fles::TimesliceMappedArchive>(paths, filter,
+                                                             desc_only);
+          sources.emplace_back(std::move(source));
+        }
+      } else if (file_path.find("%n") != std::string::npos) {
+        select_after_read = true;
         for (auto& path : paths) {
           replace_all(path, "0000", "%n");
           std::unique_ptr<fles::TimesliceSource> source =
-              std::make_unique<fles::TimesliceInputArchiveSequence>(path);
+              std::make_unique<fles::TimesliceInputArchiveSequence>(path,
+                                                                    parallel);
           sources.emplace_back(std::move(source));
         }
       } else {
+        select_after_read = true;
         if (paths.size() == 1) {
-          if (cycles == 1) {
+          if (cache) {
+            std::unique_ptr<fles::TimesliceSource> source =
+                std::make_unique<fles::TimesliceCachedArchiveLoop>(
+                    paths.front(), cycles, renumber);
+            sources.emplace_back(std::move(source));
+          } else if (cycles == 1) {
             std::unique_ptr<fles::TimesliceSource> source =
                 std::make_unique<fles::TimesliceInputArchive>(paths.front());
             sources.emplace_back(std::move(source));
@@ -72,33 +408,148 @@ void TimesliceAutoSource::init(const std::vector<std::string>& locators) {
           }
         } else if (paths.size() > 1) {
           std::unique_ptr<fles::TimesliceSource> source =
-              std::make_unique<fles::TimesliceInputArchiveSequence>(paths);
+              std::make_unique<fles::TimesliceInputArchiveSequence>(paths,
+                                                                    parallel);
           sources.emplace_back(std::move(source));
         }
       }
 
+      wrap_sources(sources, first_source, select_after_read, filter,
+                   desc_only && !mmap, prefetch, prefetch_bytes);
+
+    } else if (uri.scheme == "http") {
+      RemoteParameters remote;
+      bool desc_only = false;
+      bool chunked = false;
+      bool ranged = false;
+      uint64_t first = 0;
+      uint64_t last = UINT64_MAX;
+      ComponentFilter filter;
+      std::size_t prefetch = 0;
+      std::size_t prefetch_bytes = SIZE_MAX;
+      std::size_t parallel = 1;
+      for (auto& [key, value] : uri.query_components) {
+        if (key == "concurrency") {
+          remote.concurrency = stoull(value);
+        } else if (key == "chunk_size") {
+          remote.chunk_size = stoull(value);
+        } else if (key == "read_ahead") {
+          remote.read_ahead = stoull(value);
+        } else if (key == "desc_only") {
+          desc_only = stoull(value) != 0;
+        } else if (key == "chunked") {
+          chunked = stoull(value) != 0;
+        } else if (key == "start") {
+          first = stoull(value);
+          ranged = true;
+        } else if (key == "range") {
+          auto bounds = split(value, "-");
+          if (bounds.size() != 2) {
+            throw std::runtime_error("invalid timeslice range: " + value);
+          }
+          first = stoull(bounds[0]);
+          last = stoull(bounds[1]);
+          ranged = true;
+        } else if (key == "prefetch") {
+          prefetch = stoull(value);
+        } else if (key == "prefetch_bytes") {
+          prefetch_bytes = stoull(value);
+        } else if (key == "parallel") {
+          parallel = stoull(value);
+        } else if (!parse_filter_parameter(key, value, filter)) {
+          throw std::runtime_error(
+              "query parameter not implemented for scheme " + uri.scheme +
+              ": " + key);
+        }
+      }
+      const auto url = uri.scheme + "://" + uri.authority + uri.path;
+
+      // There is no globbing on remote servers, only the "%n" placeholder
+      std::vector<std::string> urls{url};
+      if (url.find("%n") != std::string::npos) {
+        urls = sequence_filenames(url);
+        if (urls.empty()) {
+          throw std::ios_base::failure("error opening file \"" + url + "\"");
+        }
+      }
+      const std::size_t first_source = sources.size();
+      bool select_after_read = false;
+      if (chunked) {
+        if (ranged || parallel > 1) {
+          throw std::runtime_error("query parameters range and parallel not "
+                                   "implemented for chunked input");
+        }
+        std::unique_ptr<fles::TimesliceSource> source =
+            std::make_unique<fles::ChunkedTimesliceInputArchive>(urls, filter,
+                                                                 remote);
+        sources.emplace_back(std::move(source));
+      } else if (ranged) {
+        if (parallel > 1) {
+          throw std::runtime_error("query parameter parallel not implemented "
+                                   "for ranged input");
+        }
+        std::unique_ptr<fles::TimesliceSource> source =
+            std::make_unique<fles::TimesliceIndexedInputArchive>(
+                urls, first, last, filter, remote);
+        sources.emplace_back(std::move(source));
+      } else if (urls.size() == 1) {
+        select_after_read = true;
+        std::unique_ptr<fles::TimesliceSource> source =
+            std::make_unique<fles::TimesliceInputArchive>(urls.front(),
+                                                          remote);
+        sources.emplace_back(std::move(source));
+      } else {
+        select_after_read = true;
+        std::unique_ptr<fles::TimesliceSource> source =
+            std::make_unique<fles::TimesliceInputArchiveSequence>(
+                urls, parallel, remote);
+        sources.emplace_back(std::move(source));
+      }
+      wrap_sources(sources, first_source, select_after_read, filter,
+                   desc_only, prefetch, prefetch_bytes);
+
     } else if (uri.scheme == "tcp") {
       uint32_t hwm = 1;
+      std::size_t shards = 1;
+      bool ordered = true;
+      ComponentFilter filter;
       for (auto& [key, value] : uri.query_components) {
         if (key == "hwm") {
           hwm = stou(value);
-        } else {
+        } else if (key == "shards") {
+          shards = std::stoull(value);
+        } else if (key == "ordered") {
+          ordered = std::stoull(value) != 0;
+        } else if (!parse_filter_parameter(key, value, filter)) {
           throw std::runtime_error(
               "query parameter not implemented for scheme " + uri.scheme +
               ": " + key);
         }
       }
       const auto address = uri.scheme + "://" + uri.authority;
-      std::unique_ptr<fles::TimesliceSource> source =
-          std::make_unique<fles::TimesliceSubscriber>(address, hwm);
-      sources.emplace_back(std::move(source));
+      if (shards > 1) {
+        std::unique_ptr<fles::TimesliceSource> source =
+            std::make_unique<fles::ShardedTimesliceSubscriber>(
+                address, shards, hwm, ordered, filter);
+        sources.emplace_back(std::move(source));
+      } else {
+        std::unique_ptr<fles::TimesliceSource> source =
+            std::make_unique<fles::TimesliceSubscriber>(address, hwm, filter);
+        sources.emplace_back(std::move(source));
+      }
 
     } else if (uri.scheme == "shm") {
       WorkerParameters param{1, 0, WorkerQueuePolicy::QueueAll, 0,
                              "TimesliceAutoSource at PID " +
                                  std::to_string(system::current_pid())};
+      ComponentFilter filter;
+      std::size_t workers = 1;
+      bool desc_only = false;
+      std::size_t readahead = 0;
       for (auto& [key, value] : uri.query_components) {
-        if (key == "stride") {
+        if (key == "workers") {
+          workers = std::max<std::size_t>(std::stoull(value), 1);
+        } else if (key == "stride") {
           param.stride = std::stoull(value);
         } else if (key == "offset") {
           param.offset = std::stoull(value);
@@ -106,20 +557,66 @@ void TimesliceAutoSource::init(const std::vector<std::string>& locators) {
           static const std::map<std::string, WorkerQueuePolicy> queue_map = {
               {"all", WorkerQueuePolicy::QueueAll},
               {"one", WorkerQueuePolicy::PrebufferOne},
-              {"skip", WorkerQueuePolicy::Skip}};
+              {"skip", WorkerQueuePolicy::Skip},
+              {"late", WorkerQueuePolicy::DropLate},
+              {"newest", WorkerQueuePolicy::NewestFirst}};
           param.queue_policy = queue_map.at(value);
         } else if (key == "group") {
           param.group_id = std::stoull(value);
-        } else {
+        } else if (key == "pool") {
+          param.pool_id = std::stoull(value);
+        } else if (key == "capacity") {
+          param.capacity = std::stoull(value);
+        } else if (key == "rate") {
+          const double rate = std::stod(value);
+          if (rate > 0) {
+            param.min_interval =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::duration<double>(1.0 / rate));
+          }
+        } else if (key == "desc_only") {
+          desc_only = std::stoull(value) != 0;
+        } else if (key == "readahead") {
+          readahead = std::stoull(value) * 1024;
+        } else if (!parse_filter_parameter(key, value, filter)) {
           throw std::runtime_error(
               "query parameter not implemented for scheme " + uri.scheme +
               ": " + key);
         }
       }
       const auto ipc_identifier = uri.authority + uri.path;
-      std::unique_ptr<fles::TimesliceSource> source =
-          std::make_unique<fles::TimesliceReceiver>(ipc_identifier, param);
-      sources.emplace_back(std::move(source));
+      // Descriptor-only copies release the shared memory right away
+      auto receiver = [&](const WorkerParameters& worker_param) {
+        auto timeslice_receiver = std::make_unique<fles::TimesliceReceiver>(
+            ipc_identifier, worker_param, filter);
+        timeslice_receiver->set_readahead(readahead);
+        std::unique_ptr<fles::TimesliceSource> source =
+            std::move(timeslice_receiver);
+        if (desc_only) {
+          source = std::make_unique<DescriptorOnlySource>(std::move(source));
+        }
+        return source;
+      };
+      if (workers == 1) {
+        sources.emplace_back(receiver(param));
+      } else {
+        // without a group or pool, the workers share the stride
+        const bool shared = param.group_id != 0 || param.pool_id != 0;
+        std::vector<std::unique_ptr<fles::TimesliceSource>> receivers;
+        for (std::size_t k = 0; k < workers; ++k) {
+          WorkerParameters worker_param = param;
+          if (!shared) {
+            worker_param.stride = param.stride * workers;
+            worker_param.offset = param.offset + k * param.stride;
+          }
+          worker_param.client_name += " worker " + std::to_string(k);
+          receivers.push_back(receiver(worker_param));
+        }
+        std::unique_ptr<fles::TimesliceSource> source =
+            std::make_unique<ParallelSource<fles::TimesliceSource>>(
+                std::move(receivers));
+        sources.emplace_back(std::move(source));
+      }
 
     } else {
       throw std::runtime_error("scheme not implemented: " + uri.scheme);
@@ -128,7 +625,9 @@ void TimesliceAutoSource::init(const std::vector<std::string>& locators) {
 
   if (sources.size() == 1) {
     source_ = std::move(sources.front());
-  } else if (sources.size() > 1) {
+  } else {
+    // without sources (e.g., no matching files in a manifest), the merging
+    // source is at the end of the stream right away
     source_ = std::make_unique<MergingSource<fles::TimesliceSource>>(
         std::move(sources));
   }
@@ -17,6 +17,9 @@ namespace fles {
  * following types:
  * - TimesliceInputArchive
  * - TimesliceInputArchiveSequence
+ * - ChunkedTimesliceInputArchive
+ * - TimesliceIndexedInputArchive
+ * - TimesliceMappedArchive
  * - TimesliceSubsciber
  *
  * If there is more than one TimesliceSource object, these objects are handed
@@ -29,7 +32,9 @@ namespace fles {
  * - Each provided locator string corresponds to at least one TimesliceSource
  * object.
  * - If the string starts with `tcp://`, it is considered an address string used
- * to initialize a TimesliceSubscriber object.
+ * to initialize a TimesliceSubscriber object, or, with the query option
+ * `shards=N` (N > 1), a ShardedTimesliceSubscriber object (query option
+ * `ordered=0` for out-of-order reception).
  * - If the string starts with `file://` or does not contain `://` at all, it is
  * considered a local filepath. The filepath may be relative or absolute, and it
  * may contain standard wildcard characters and patterns as understood by the
@@ -43,6 +48,79 @@ namespace fles {
  * are handed over collectively to a TimesliceInputArchiveSequence instance for
  * sequential input, or, if there is only a single resulting filepath, a
  * TimesliceInputArchive instance.
+ * - If the query option `mmap=1` is given for a filepath, the resulting files
+ * are read through memory-mapped TimesliceMappedArchive instances instead,
+ * which provide zero-copy access to uncompressed archives.
+ * - If the query option `start=N` or `range=A-B` is given for a filepath, the
+ * resulting files are read through TimesliceIndexedInputArchive instances,
+ * which use the index sidecar files to seek directly to the first requested
+ * timeslice.
+ * - If the filepath ends in `.manifest`, it is considered a run manifest
+ * (see ArchiveManifest) written by one or more
+ * TimesliceOutputArchiveSequence instances. The files of each writer
+ * overlapping the range given by `start` or `range` and holding any of the
+ * selected subsystems (`sys_id`) are read through a
+ * TimesliceIndexedInputArchive or, without a range, a TimesliceMappedArchive
+ * (with `mmap=1`) or TimesliceInputArchiveSequence instance. No other files
+ * are opened.
+ * - If the query option `chunked=1` is given for a filepath, the resulting
+ * files are read as chunked timeslice archives through
+ * ChunkedTimesliceInputArchive instances. This is also the case if a
+ * component selection (see below) is given without other options and the
+ * first file is a chunked archive.
+ * - Archive files in the native format (see NativeArchiveHeader) are
+ * detected by their header and read through NativeTimesliceInputArchive
+ * instances, verifying the frame checksums.
+ * - The query option `lazy=1` (implying `chunked=1`) returns LazyTimeslice
+ * objects, which read and decompress each component of a chunked archive
+ * file on first access only.
+ * - The query options `sys_id=...` and `eq_id=...` (comma-separated lists)
+ * and `flags_set=...` and `flags_clear=...` (bit masks) restrict the
+ * timeslices to the matching components (see ComponentFilter). They are
+ * supported for all schemes. The chunked archive reader skips the other
+ * components when reading, the memory-mapped and shared memory sources
+ * omit them from their views, and all other sources drop them after
+ * deserialization.
+ * - The query option `rate=R` of the `shm` scheme limits the timeslices of
+ * the receiver to at most R per second. The distributor skips all others
+ * without pinning them in the shared memory.
+ * - The query option `readahead=K` of the `shm` scheme prefetches the first
+ * K KiB of each component on a helper thread of the TimesliceReceiver as
+ * soon as the work item arrives (see TimesliceReceiver::set_readahead()).
+ * - The query option `workers=N` of the `shm` scheme registers N receivers
+ * with the distributor, each reading on its own thread, and returns their
+ * timeslices in order of arrival through a ParallelSource. Without a `group`
+ * or `pool`, the receivers split the stride among themselves; otherwise,
+ * they share the load through the distributor. The shared memory is mapped
+ * once for all of them.
+ * - If the query option `cache=1` is given for a single archive file, it is
+ * read into memory once and replayed `cycles` times by a
+ * TimesliceCachedArchiveLoop (with shifted indices if `renumber=1`).
+ * - The query option `desc_only=1` of the `file` and `shm` schemes returns
+ * descriptor-only timeslices (see Timeslice::content_omitted()). Mappable
+ * archives are then read through a TimesliceMappedArchive in
+ * descriptor-only mode, which does not read the contents, unless other
+ * options prevent this. Shared memory timeslices are copied and released
+ * right away.
+ * - If the string starts with `http://`, it is considered the URL of an
+ * archive file on a web server or object store (e.g., an S3 endpoint or an
+ * XRootD server with HTTP access). It may contain the `"%%n"` placeholder,
+ * which is expanded to the existing files of the sequence, but no wildcards.
+ * The files are streamed through RemoteStreamBuffer instances with
+ * `concurrency` parallel range requests of `chunk_size` bytes, up to
+ * `read_ahead` of them ahead of the read position, and deserialized by a
+ * TimesliceInputArchive, a TimesliceInputArchiveSequence (with `parallel`),
+ * with `start` or `range`, a TimesliceIndexedInputArchive using the remote
+ * index sidecar files, or, with `chunked=1`, a ChunkedTimesliceInputArchive
+ * skipping the unselected components. The options `desc_only`, `prefetch`
+ * and the component selection are supported as for local files.
+ * - If the query option `prefetch=N` is given for a filepath, each resulting
+ * source is wrapped in a PrefetchingSource reading up to N timeslices (and
+ * at most `prefetch_bytes` bytes, if given) ahead on a background thread.
+ * - If the query option `parallel=K` is given for a filepath resulting in a
+ * TimesliceInputArchiveSequence, the next K files of the sequence are opened
+ * and deserialized concurrently. The timeslices are still returned in file
+ * order.
  *
  * ## Examples
  * \code
@@ -53,6 +131,12 @@ namespace fles {
  * 5. TimesliceAutoSource("example_node?_%n.tsa")
  * 6. TimesliceAutoSource({"example0.tsa", "example1.tsa"})
  * 7. TimesliceAutoSource("{example0.tsa,example1.tsa}")
+ * 8. TimesliceAutoSource("file://example_%n.tsa?mmap=1")
+ * 9. TimesliceAutoSource("file://example.tsa?range=100-199")
+ * 10. TimesliceAutoSource("file://chunked.tsa?sys_id=0x10,0x60")
+ * 11. TimesliceAutoSource("shm://127.0.0.1/fles_in_e0?eq_id=0x1001")
+ * 12. TimesliceAutoSource("http://store:8080/run1_%n.tsa?concurrency=8")
+ * 13. TimesliceAutoSource("file://run1.manifest?range=5000-5999")
  * \endcode
  *
  * These examples will result in the creation of the following objects:
@@ -65,6 +149,16 @@ namespace fles {
  *    `"?"` wildcard expands to more than one instance)
  * 6. A MergingSource containing two TimesliceInputArchive objects
  * 7. A single TimesliceInputArchiveSequence
+ * 8. A single TimesliceMappedArchive reading the files of the sequence
+ * 9. A single TimesliceIndexedInputArchive reading timeslices 100 to 199
+ * 10. A single ChunkedTimesliceInputArchive reading the STS and TOF
+ *     components only
+ * 11. A single TimesliceReceiver returning views of a single component
+ * 12. A single TimesliceInputArchiveSequence streaming the remote files with
+ *     eight concurrent range requests
+ * 13. A MergingSource containing a TimesliceIndexedInputArchive per writer
+ *     (if the manifest lists more than one writer) reading the files of
+ *     timeslices 5000 to 5999 only
 
  */
 class TimesliceAutoSource : public TimesliceSource {
@@ -108,6 +202,12 @@ private:
   void init(const std::vector<std::string>& locators);
 
   Timeslice* do_get() override { return source_->get().release(); }
+
+  void do_get_batch(std::vector<std::unique_ptr<Timeslice>>& items,
+                    std::size_t max_items,
+                    std::chrono::nanoseconds timeout) override {
+    items = source_->get_batch(max_items, timeout);
+  }
 };
 
 } // namespace fles
@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "TimesliceCachedArchiveLoop.hpp"
+#include "TimesliceInputArchive.hpp"
+#include <utility>
+
+namespace fles {
+
+TimesliceCachedView::TimesliceCachedView(std::shared_ptr<const Cache> cache,
+                                         const Timeslice& timeslice,
+                                         uint64_t index_offset,
+                                         uint64_t ts_pos_offset)
+    : cache_(std::move(cache)) {
+  timeslice_descriptor_ = timeslice.timeslice_descriptor_;
+  timeslice_descriptor_.index += index_offset;
+  timeslice_descriptor_.ts_pos += ts_pos_offset;
+
+  desc_.reserve(num_components());
+  for (size_t c = 0; c < num_components(); ++c) {
+    desc_.push_back(*timeslice.desc_ptr_[c]);
+    desc_.back().ts_num += index_offset;
+  }
+  timeslice.materialize();
+  data_ptr_ = timeslice.data_ptr_;
+  desc_ptr_.resize(num_components());
+  for (size_t c = 0; c < num_components(); ++c) {
+    desc_ptr_[c] = &desc_[c];
+  }
+}
+
+namespace {
+
+/// Distance of a value from the first to one past the last of a sequence,
+/// extrapolating the mean step.
+uint64_t span(uint64_t first,
+              uint64_t last,
+              std::size_t count,
+              uint64_t single_step) {
+  if (count < 2 || last <= first) {
+    return (last > first ? last - first : 0) + single_step;
+  }
+  return (last - first) + (last - first) / (count - 1);
+}
+
+} // namespace
+
+TimesliceCachedArchiveLoop::TimesliceCachedArchiveLoop(
+    const std::string& filename, uint64_t cycles, bool renumber)
+    : descriptor_(ArchiveType::TimesliceArchive), cycles_(cycles),
+      renumber_(renumber) {
+  auto cache = std::make_shared<TimesliceCachedView::Cache>();
+  TimesliceInputArchive archive(filename);
+  descriptor_ = archive.descriptor();
+  while (auto timeslice = archive.get()) {
+    cache->push_back(std::move(timeslice));
+  }
+  cache_ = std::move(cache);
+  eos_ = cache_->empty() || cycles_ == 0;
+
+  if (renumber_ && !cache_->empty()) {
+    const auto& first = *cache_->front();
+    const auto& last = *cache_->back();
+    index_span_ = span(first.index(), last.index(), cache_->size(), 1);
+    ts_pos_span_ = span(first.timeslice_descriptor_.ts_pos,
+                        last.timeslice_descriptor_.ts_pos, cache_->size(),
+                        last.num_core_microslices());
+  }
+}
+
+TimesliceCachedView* TimesliceCachedArchiveLoop::do_get() {
+  if (eos_) {
+    return nullptr;
+  }
+  const Timeslice& timeslice = *(*cache_)[next_];
+  auto* view = new TimesliceCachedView( // NOLINT
+      cache_, timeslice, cycle_ * index_span_, cycle_ * ts_pos_span_);
+  if (++next_ == cache_->size()) {
+    next_ = 0;
+    if (++cycle_ == cycles_) {
+      eos_ = true;
+    }
+  }
+  return view;
+}
+
+} // namespace fles
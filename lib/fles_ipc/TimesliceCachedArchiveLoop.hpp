@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::TimesliceCachedArchiveLoop class.
+#pragma once
+
+#include "ArchiveDescriptor.hpp"
+#include "StorableTimeslice.hpp"
+#include "TimesliceSource.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief The TimesliceCachedView class provides access to a timeslice held
+ * in the cache of a TimesliceCachedArchiveLoop.
+ *
+ * The component data is not copied. Only the timeslice and component
+ * descriptors belong to the view, so that their index and position can
+ * differ between the cycles. The cache is kept alive as long as any view
+ * into it exists.
+ */
+class TimesliceCachedView : public Timeslice {
+public:
+  /// The cached timeslices.
+  using Cache = std::vector<std::unique_ptr<const StorableTimeslice>>;
+
+  /// Delete copy constructor (non-copyable).
+  TimesliceCachedView(const TimesliceCachedView&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const TimesliceCachedView&) = delete;
+
+  ~TimesliceCachedView() override = default;
+
+private:
+  friend class TimesliceCachedArchiveLoop;
+
+  TimesliceCachedView(std::shared_ptr<const Cache> cache,
+                      const Timeslice& timeslice,
+                      uint64_t index_offset,
+                      uint64_t ts_pos_offset);
+
+  std::shared_ptr<const Cache> cache_;
+  std::vector<TimesliceComponentDescriptor> desc_;
+};
+
+/**
+ * \brief The TimesliceCachedArchiveLoop class loops over the timeslices of
+ * an archive file held in memory.
+ *
+ * The archive is deserialized once on construction. Each cycle then returns
+ * TimesliceCachedView objects pointing into the cached timeslices, so a
+ * throughput test using many cycles measures the consumer instead of the
+ * deserialization (cf. InputArchiveLoop, which reads the file in every
+ * cycle). The whole archive has to fit into memory.
+ *
+ * If renumbering is enabled, the timeslice index and ts_pos are shifted by
+ * the span of the archive in every cycle, so consumers see monotonically
+ * increasing indices.
+ */
+class TimesliceCachedArchiveLoop : public TimesliceSource {
+public:
+  /**
+   * \brief Construct a cached archive loop, reading all timeslices of the
+   * given archive file.
+   *
+   * \param filename File name of the archive file
+   * \param cycles   Number of times to loop over the archive
+   * \param renumber Shift the timeslice indices in each cycle
+   */
+  explicit TimesliceCachedArchiveLoop(const std::string& filename,
+                                      uint64_t cycles = 1,
+                                      bool renumber = false);
+
+  /// Delete copy constructor (non-copyable).
+  TimesliceCachedArchiveLoop(const TimesliceCachedArchiveLoop&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const TimesliceCachedArchiveLoop&) = delete;
+
+  ~TimesliceCachedArchiveLoop() override = default;
+
+  /// Read the next timeslice.
+  std::unique_ptr<TimesliceCachedView> get() {
+    return std::unique_ptr<TimesliceCachedView>(do_get());
+  };
+
+  /// Retrieve the archive descriptor.
+  [[nodiscard]] const ArchiveDescriptor& descriptor() const {
+    return descriptor_;
+  };
+
+  /// Retrieve the number of cached timeslices.
+  [[nodiscard]] std::size_t num_timeslices() const { return cache_->size(); }
+
+  [[nodiscard]] bool eos() const override { return eos_; }
+
+private:
+  std::shared_ptr<const TimesliceCachedView::Cache> cache_;
+  ArchiveDescriptor descriptor_;
+  uint64_t cycles_;
+  bool renumber_;
+
+  /// Shift of the index and ts_pos per cycle.
+  uint64_t index_span_ = 0;
+  uint64_t ts_pos_span_ = 0;
+
+  uint64_t cycle_ = 0;
+  std::size_t next_ = 0;
+  bool eos_ = false;
+
+  void do_get_batch(std::vector<std::unique_ptr<Timeslice>>& items,
+                    std::size_t max_items,
+                    std::chrono::nanoseconds /* timeout */) override {
+    get_available(items, max_items);
+  }
+
+  TimesliceCachedView* do_get() override;
+};
+
+} // namespace fles
@@ -27,7 +27,8 @@ struct TimesliceComponentDescriptor {
   /// descriptors followed by microslice contents).
   uint64_t size;
 
-  /// Number of microslices.
+  /// Number of microslices. A component without microslices is missing
+  /// from the timeslice, e.g., as its input missed the timeslice deadline.
   uint64_t num_microslices;
 
   friend class boost::serialization::access;
@@ -0,0 +1,187 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "TimesliceIndexedInputArchive.hpp"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+namespace fles {
+
+TimesliceIndexedInputArchive::TimesliceIndexedInputArchive(
+    const std::string& filename,
+    uint64_t first,
+    uint64_t last,
+    ComponentFilter filter)
+    : TimesliceIndexedInputArchive(std::vector<std::string>{filename}, first,
+                                   last, std::move(filter)) {}
+
+TimesliceIndexedInputArchive::TimesliceIndexedInputArchive(
+    std::vector<std::string> filenames,
+    uint64_t first,
+    uint64_t last,
+    ComponentFilter filter,
+    const RemoteParameters& remote)
+    : filenames_(std::move(filenames)), first_(first), last_(last),
+      filter_(std::move(filter)), remote_(remote) {
+  next_file();
+}
+
+TimesliceIndexedInputArchive::TimesliceIndexedInputArchive(
+    const std::string& filename, ArchiveIndex index)
+    : filenames_{filename}, file_count_(1), first_(0), last_(UINT64_MAX),
+      index_(std::move(index)) {
+  open(filename);
+}
+
+ArchiveIndex
+TimesliceIndexedInputArchive::build_index(const std::string& filename) {
+  TimesliceIndexedInputArchive archive(std::vector<std::string>{});
+  archive.open(filename);
+
+  ArchiveIndex index;
+  while (true) {
+    auto offset = static_cast<uint64_t>(archive.stream_->tellg());
+    std::unique_ptr<StorableTimeslice> ts(archive.read_timeslice());
+    if (!ts) {
+      break;
+    }
+    auto size = static_cast<uint64_t>(archive.stream_->tellg()) - offset;
+    index.push_back({ts->index(), offset, size, ts->start_time()});
+  }
+  return index;
+}
+
+void TimesliceIndexedInputArchive::open(const std::string& filename) {
+  iarchive_ = nullptr;
+  stream_ = open_input_stream(filename, remote_);
+  if (!*stream_) {
+    throw std::ios_base::failure("error opening file \"" + filename + "\"");
+  }
+
+  iarchive_ = std::make_unique<boost::archive::binary_iarchive>(*stream_);
+  *iarchive_ >> descriptor_;
+
+  if (descriptor_.archive_type() != ArchiveType::TimesliceArchive) {
+    throw std::runtime_error("File \"" + filename +
+                             "\" is not of correct archive type");
+  }
+  if (descriptor_.archive_compression() != ArchiveCompression::None) {
+    throw std::runtime_error("Compressed archive file \"" + filename +
+                             "\" does not support random access");
+  }
+
+  position_ = 0;
+  stream_position_ = 0;
+  class_info_complete_ = false;
+}
+
+void TimesliceIndexedInputArchive::next_file() {
+  iarchive_ = nullptr;
+  stream_ = nullptr;
+
+  while (file_count_ < filenames_.size()) {
+    const std::string& filename = filenames_.at(file_count_);
+    ++file_count_;
+
+    auto index_filename = ArchiveIndex::sidecar_filename(filename);
+    if (input_exists(index_filename)) {
+      index_ = ArchiveIndex::read(index_filename);
+    } else {
+      std::cerr << "TimesliceIndexedInputArchive: no index file for \""
+                << filename << "\", scanning archive" << std::endl;
+      index_ = build_index(filename);
+    }
+
+    // Files without timeslices in the selected range are not even opened
+    const auto& entries = index_.entries();
+    if (std::any_of(entries.begin(), entries.end(), [this](const auto& e) {
+          return e.index >= first_ && e.index <= last_;
+        })) {
+      open(filename);
+      return;
+    }
+  }
+  eos_ = true;
+}
+
+void TimesliceIndexedInputArchive::seek(std::size_t position) {
+  // Boost writes the class information only in front of the first
+  // serialized object of each class, so it has to be consumed by reading
+  // before the objects following it can be accessed directly.
+  while (!class_info_complete_ && stream_position_ < position) {
+    std::unique_ptr<StorableTimeslice> skipped(read_timeslice());
+    if (!skipped) {
+      return;
+    }
+  }
+
+  if (stream_position_ != position) {
+    stream_->clear();
+    stream_->seekg(
+        static_cast<std::streamoff>(index_.entries().at(position).offset));
+    stream_position_ = position;
+  }
+}
+
+StorableTimeslice* TimesliceIndexedInputArchive::read_timeslice() {
+  auto* sts = new StorableTimeslice(); // NOLINT
+  try {
+    load_archive_item(*iarchive_, *sts, descriptor_.descriptor_encoding(),
+                      codec_);
+  } catch (boost::archive::archive_exception& e) {
+    delete sts; // NOLINT
+    if (e.code == boost::archive::archive_exception::input_stream_error) {
+      return nullptr;
+    }
+    throw;
+  }
+  ++stream_position_;
+  if (sts->num_components() > 0) {
+    class_info_complete_ = true;
+  }
+  return sts;
+}
+
+std::unique_ptr<StorableTimeslice>
+TimesliceIndexedInputArchive::read_at(std::size_t position) {
+  if (!iarchive_ || position >= index_.size()) {
+    return nullptr;
+  }
+  seek(position);
+  if (stream_position_ != position) {
+    return nullptr;
+  }
+  return std::unique_ptr<StorableTimeslice>(read_timeslice());
+}
+
+StorableTimeslice* TimesliceIndexedInputArchive::do_get() {
+  while (!eos_) {
+    const auto& entries = index_.entries();
+    while (position_ < entries.size() &&
+           (entries[position_].index < first_ ||
+            entries[position_].index > last_)) {
+      ++position_;
+    }
+
+    if (position_ < entries.size()) {
+      seek(position_);
+      if (stream_position_ == position_) {
+        if (auto* sts = read_timeslice()) {
+          ++position_;
+          sts->select_components(filter_);
+          return sts;
+        }
+      }
+      std::cerr << "TimesliceIndexedInputArchive: archive file ends before "
+                   "last indexed timeslice"
+                << std::endl;
+    }
+
+    next_file();
+  }
+  return nullptr;
+}
+
+} // namespace fles
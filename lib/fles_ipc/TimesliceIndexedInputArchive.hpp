@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::TimesliceIndexedInputArchive class.
+#pragma once
+
+#include "ArchiveDescriptor.hpp"
+#include "ArchiveIndex.hpp"
+#include "DescriptorCodec.hpp"
+#include "RemoteStream.hpp"
+#include "StorableTimeslice.hpp"
+#include "TimesliceSource.hpp"
+#include <boost/archive/binary_iarchive.hpp>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief The TimesliceIndexedInputArchive class deserializes a selected range
+ * of timeslices from one or more uncompressed archive files, using the
+ * random-access index of each file to seek directly to the requested data.
+ *
+ * The index is read from the sidecar file written by TimesliceOutputArchive
+ * or TimesliceOutputArchiveSequence. If no sidecar file exists, the index is
+ * built by a single pass over the archive file (see build_index()).
+ */
+class TimesliceIndexedInputArchive : public TimesliceSource {
+public:
+  /**
+   * \brief Construct an indexed input archive object for the given archive
+   * file.
+   *
+   * \param filename File name of the archive file
+   * \param first    Lowest timeslice index to read
+   * \param last     Highest timeslice index to read
+   * \param filter   Selection of components to return
+   */
+  explicit TimesliceIndexedInputArchive(const std::string& filename,
+                                        uint64_t first = 0,
+                                        uint64_t last = UINT64_MAX,
+                                        ComponentFilter filter = {});
+
+  /**
+   * \brief Construct an indexed input archive object for a sequence of
+   * archive files, which are read one after the other.
+   *
+   * \param filenames File names (or "http://" URLs) of the archive files
+   * \param first     Lowest timeslice index to read
+   * \param last      Highest timeslice index to read
+   * \param filter    Selection of components to return
+   * \param remote    Access parameters of remote archive files
+   */
+  explicit TimesliceIndexedInputArchive(std::vector<std::string> filenames,
+                                        uint64_t first = 0,
+                                        uint64_t last = UINT64_MAX,
+                                        ComponentFilter filter = {},
+                                        const RemoteParameters& remote = {});
+
+  /**
+   * \brief Construct an indexed input archive object for an archive file
+   * with a known index, e.g., as retrieved by index() before.
+   *
+   * \param filename File name of the archive file
+   * \param index    Index of the archive file
+   */
+  TimesliceIndexedInputArchive(const std::string& filename,
+                               ArchiveIndex index);
+
+  /// Delete copy constructor (non-copyable).
+  TimesliceIndexedInputArchive(const TimesliceIndexedInputArchive&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const TimesliceIndexedInputArchive&) = delete;
+
+  ~TimesliceIndexedInputArchive() override = default;
+
+  /// Read the next timeslice in the selected range.
+  std::unique_ptr<StorableTimeslice> get() {
+    return std::unique_ptr<StorableTimeslice>(do_get());
+  };
+
+  /// Retrieve the archive descriptor of the current archive file.
+  [[nodiscard]] const ArchiveDescriptor& descriptor() const {
+    return descriptor_;
+  };
+
+  /// Retrieve the index of the current archive file.
+  [[nodiscard]] const ArchiveIndex& index() const { return index_; }
+
+  /// Read the timeslice at the given position of the index of the current
+  /// archive file, regardless of the selected range and components.
+  /** \return the timeslice, or nothing if the file ends before it */
+  std::unique_ptr<StorableTimeslice> read_at(std::size_t position);
+
+  [[nodiscard]] bool eos() const override { return eos_; }
+
+  /**
+   * \brief Build the index of an existing archive file in a single pass.
+   *
+   * \param filename File name of the (uncompressed) archive file
+   * \return The index of the archive file
+   */
+  static ArchiveIndex build_index(const std::string& filename);
+
+private:
+  std::vector<std::string> filenames_;
+  std::size_t file_count_ = 0;
+  uint64_t first_;
+  uint64_t last_;
+  ComponentFilter filter_;
+  RemoteParameters remote_;
+
+  std::unique_ptr<std::istream> stream_;
+  std::unique_ptr<boost::archive::binary_iarchive> iarchive_;
+  ArchiveDescriptor descriptor_;
+  DescriptorCodec codec_;
+  ArchiveIndex index_;
+
+  /// Position (in the index) of the next timeslice to return.
+  std::size_t position_ = 0;
+  /// Position (in the index) of the timeslice at the current stream position.
+  std::size_t stream_position_ = 0;
+  /// All boost class information of the file has been read.
+  bool class_info_complete_ = false;
+
+  bool eos_ = false;
+
+  void open(const std::string& filename);
+  void next_file();
+  void seek(std::size_t position);
+  StorableTimeslice* read_timeslice();
+
+  void do_get_batch(std::vector<std::unique_ptr<Timeslice>>& items,
+                    std::size_t max_items,
+                    std::chrono::nanoseconds /* timeout */) override {
+    get_available(items, max_items);
+  }
+
+  StorableTimeslice* do_get() override;
+};
+
+} // namespace fles
@@ -0,0 +1,170 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "TimesliceMappedArchive.hpp"
+#include "ArchiveCursor.hpp"
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+namespace fles {
+
+TimesliceMappedArchive::TimesliceMappedArchive(const std::string& filename,
+                                               ComponentFilter filter,
+                                               bool descriptors_only)
+    : filenames_{filename}, filter_(std::move(filter)),
+      descriptors_only_(descriptors_only) {
+  next_file();
+}
+
+TimesliceMappedArchive::TimesliceMappedArchive(
+    std::vector<std::string> filenames,
+    ComponentFilter filter,
+    bool descriptors_only)
+    : filenames_(std::move(filenames)), filter_(std::move(filter)),
+      descriptors_only_(descriptors_only) {
+  next_file();
+}
+
+void TimesliceMappedArchive::next_file() {
+  if (file_count_ >= filenames_.size()) {
+    eos_ = true;
+    return;
+  }
+
+  file_ = nullptr;
+  index_.clear();
+  next_index_ = 0;
+
+  const std::string& filename = filenames_.at(file_count_);
+  ++file_count_;
+
+  file_ = std::make_shared<const MappedFile>(filename, !descriptors_only_);
+  ArchiveCursor cursor(*file_, 0);
+  descriptor_ = cursor.read_archive_descriptor(filename);
+
+  if (descriptor_.archive_type() != ArchiveType::TimesliceArchive) {
+    throw std::runtime_error("File \"" + filename +
+                             "\" is not of correct archive type");
+  }
+  if (descriptor_.archive_compression() != ArchiveCompression::None) {
+    throw std::runtime_error("Compressed archive file \"" + filename +
+                             "\" cannot be memory-mapped");
+  }
+  if (descriptor_.descriptor_encoding() != DescriptorEncoding::Verbatim) {
+    throw std::runtime_error("Archive file \"" + filename +
+                             "\" with compact descriptors cannot be "
+                             "memory-mapped");
+  }
+
+  build_index(cursor.offset());
+}
+
+void TimesliceMappedArchive::build_index(uint64_t offset) {
+  bool component_class_info_seen = false;
+
+  while (offset < file_->size()) {
+    IndexEntry entry{offset, index_.empty(), !component_class_info_seen};
+    try {
+      Record record = parse_record(entry, &offset);
+      if (!record.desc.empty()) {
+        component_class_info_seen = true;
+      }
+    } catch (const TruncatedArchive&) {
+      std::cerr << "TimesliceMappedArchive: ignoring incomplete timeslice at "
+                   "end of file \""
+                << file_->filename() << "\"" << std::endl;
+      break;
+    }
+    index_.push_back(entry);
+  }
+}
+
+TimesliceMappedArchive::Record
+TimesliceMappedArchive::parse_record(const IndexEntry& entry,
+                                     uint64_t* end_offset) {
+  ArchiveCursor cursor(*file_, entry.offset);
+  Record record;
+
+  // StorableTimeslice::serialize()
+  if (entry.class_info) {
+    cursor.read_class_info();
+    timeslice_descriptor_version_ = cursor.read_class_info();
+  }
+  TimesliceDescriptor& ts_desc = record.timeslice_descriptor;
+  if (timeslice_descriptor_version_ > 0) {
+    ts_desc.index = cursor.read<uint64_t>();
+  }
+  ts_desc.ts_pos = cursor.read<uint64_t>();
+  ts_desc.num_core_microslices = cursor.read<uint32_t>();
+  ts_desc.num_components = cursor.read<uint32_t>();
+
+  // data_: std::vector<std::vector<uint8_t>>
+  if (entry.class_info) {
+    cursor.read_class_info();
+  }
+  auto num_data = cursor.read<uint64_t>();
+  cursor.read<uint32_t>(); // item version
+  if (num_data != ts_desc.num_components) {
+    throw std::runtime_error("inconsistent timeslice in archive file \"" +
+                             file_->filename() + "\"");
+  }
+  record.data.resize(num_data);
+  std::vector<uint64_t> data_size(num_data);
+  for (uint64_t c = 0; c < num_data; ++c) {
+    data_size[c] = cursor.read<uint64_t>();
+    record.data[c] = cursor.skip(data_size[c]);
+  }
+
+  // desc_: std::vector<TimesliceComponentDescriptor>
+  if (entry.class_info) {
+    cursor.read_class_info();
+  }
+  auto num_desc = cursor.read<uint64_t>();
+  cursor.read<uint32_t>(); // item version
+  if (num_desc != num_data) {
+    throw std::runtime_error("inconsistent timeslice in archive file \"" +
+                             file_->filename() + "\"");
+  }
+  record.desc.resize(num_desc);
+  for (uint64_t c = 0; c < num_desc; ++c) {
+    if (c == 0 && entry.component_class_info) {
+      cursor.read_class_info();
+    }
+    // The serialized members have the layout of the packed struct
+    record.desc[c] = cursor.skip(sizeof(TimesliceComponentDescriptor));
+    uint64_t size;
+    std::memcpy(&size,
+                record.desc[c] + offsetof(TimesliceComponentDescriptor, size),
+                sizeof(size));
+    if (size != data_size[c]) {
+      throw std::runtime_error("inconsistent timeslice in archive file \"" +
+                               file_->filename() + "\"");
+    }
+  }
+
+  if (end_offset != nullptr) {
+    *end_offset = cursor.offset();
+  }
+  return record;
+}
+
+TimesliceMappedView* TimesliceMappedArchive::do_get() {
+  while (!eos_ && next_index_ >= index_.size()) {
+    next_file();
+  }
+  if (eos_) {
+    return nullptr;
+  }
+
+  Record record = parse_record(index_[next_index_++], nullptr);
+  auto* view = new TimesliceMappedView(file_, record.timeslice_descriptor,
+                                       std::move(record.data),
+                                       std::move(record.desc),
+                                       descriptors_only_);
+  view->select_components(filter_);
+  return view;
+}
+
+} // namespace fles
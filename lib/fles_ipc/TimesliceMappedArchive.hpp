@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::TimesliceMappedArchive class.
+#pragma once
+
+#include "ArchiveDescriptor.hpp"
+#include "MappedFile.hpp"
+#include "TimesliceMappedView.hpp"
+#include "TimesliceSource.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief The TimesliceMappedArchive class provides zero-copy read access to
+ * the timeslices in one or more uncompressed timeslice archive files.
+ *
+ * Each archive file is memory-mapped and scanned once to build an index of
+ * the serialized timeslices. The returned TimesliceMappedView objects point
+ * directly into the mapped pages, so neither the boost deserialization nor
+ * any copy of the component data takes place. Components not selected by
+ * the given ComponentFilter are omitted from the views, so their pages are
+ * not read beyond the first microslice descriptor.
+ *
+ * In descriptor-only mode, the views are descriptor-only timeslices (see
+ * Timeslice::content_omitted()) and the file is mapped for random access,
+ * so the pages holding only microslice contents are not read at all.
+ *
+ * The scanner understands the boost binary archive layout written by
+ * TimesliceOutputArchive for StorableTimeslice objects. Compressed archives
+ * cannot be mapped and are rejected.
+ */
+class TimesliceMappedArchive : public TimesliceSource {
+public:
+  /**
+   * \brief Construct a mapped archive object, map the given archive file and
+   * build its timeslice index.
+   *
+   * \param filename         File name of the archive file
+   * \param filter           Selection of components to return
+   * \param descriptors_only Return the microslice descriptors only
+   */
+  explicit TimesliceMappedArchive(const std::string& filename,
+                                  ComponentFilter filter = {},
+                                  bool descriptors_only = false);
+
+  /**
+   * \brief Construct a mapped archive object for a sequence of archive files,
+   * which are mapped and indexed one at a time.
+   *
+   * \param filenames        File names of the archive files
+   * \param filter           Selection of components to return
+   * \param descriptors_only Return the microslice descriptors only
+   */
+  explicit TimesliceMappedArchive(std::vector<std::string> filenames,
+                                  ComponentFilter filter = {},
+                                  bool descriptors_only = false);
+
+  /// Delete copy constructor (non-copyable).
+  TimesliceMappedArchive(const TimesliceMappedArchive&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const TimesliceMappedArchive&) = delete;
+
+  ~TimesliceMappedArchive() override = default;
+
+  /// Read the next timeslice.
+  std::unique_ptr<TimesliceMappedView> get() {
+    return std::unique_ptr<TimesliceMappedView>(do_get());
+  };
+
+  /// Retrieve the archive descriptor of the current archive file.
+  [[nodiscard]] const ArchiveDescriptor& descriptor() const {
+    return descriptor_;
+  };
+
+  /// Retrieve the number of timeslices indexed in the current archive file.
+  [[nodiscard]] std::size_t num_timeslices() const { return index_.size(); }
+
+  [[nodiscard]] bool eos() const override { return eos_; }
+
+private:
+  /// Location of a serialized timeslice in the mapped file.
+  struct IndexEntry {
+    uint64_t offset;           ///< Byte offset of the serialized object
+    bool class_info;           ///< Object is preceded by boost class info
+    bool component_class_info; ///< First component carries class info
+  };
+
+  /// Offsets of the parts of a serialized timeslice.
+  struct Record {
+    TimesliceDescriptor timeslice_descriptor{};
+    std::vector<const uint8_t*> data;
+    std::vector<const uint8_t*> desc;
+  };
+
+  std::vector<std::string> filenames_;
+  std::size_t file_count_ = 0;
+  ComponentFilter filter_;
+  bool descriptors_only_;
+
+  std::shared_ptr<const MappedFile> file_;
+  ArchiveDescriptor descriptor_;
+  std::vector<IndexEntry> index_;
+  std::size_t next_index_ = 0;
+
+  /// Version of the serialized TimesliceDescriptor class.
+  uint32_t timeslice_descriptor_version_ = 0;
+
+  bool eos_ = false;
+
+  void next_file();
+  void build_index(uint64_t offset);
+  Record parse_record(const IndexEntry& entry, uint64_t* end_offset);
+
+  void do_get_batch(std::vector<std::unique_ptr<Timeslice>>& items,
+                    std::size_t max_items,
+                    std::chrono::nanoseconds /* timeout */) override {
+    get_available(items, max_items);
+  }
+
+  TimesliceMappedView* do_get() override;
+};
+
+} // namespace fles
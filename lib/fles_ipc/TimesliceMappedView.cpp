@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "TimesliceMappedView.hpp"
+#include <utility>
+
+namespace fles {
+
+TimesliceMappedView::TimesliceMappedView(
+    std::shared_ptr<const MappedFile> file,
+    const TimesliceDescriptor& timeslice_descriptor,
+    std::vector<const uint8_t*> data,
+    std::vector<const uint8_t*> desc,
+    bool descriptors_only)
+    : file_(std::move(file)) {
+  timeslice_descriptor_ = timeslice_descriptor;
+
+  // The Timeslice interface only provides read access to the data, so the
+  // mapped pages are never written through these pointers.
+  data_ptr_.resize(num_components());
+  desc_ptr_.resize(num_components());
+  for (size_t c = 0; c < num_components(); ++c) {
+    data_ptr_[c] = const_cast<uint8_t*>(data[c]);
+    desc_ptr_[c] = reinterpret_cast<TimesliceComponentDescriptor*>(
+        const_cast<uint8_t*>(desc[c]));
+  }
+  if (descriptors_only) {
+    desc_.resize(num_components());
+    for (size_t c = 0; c < num_components(); ++c) {
+      desc_[c] = *desc_ptr_[c];
+      desc_[c].size = desc_[c].num_microslices * sizeof(MicrosliceDescriptor);
+      desc_ptr_[c] = &desc_[c];
+    }
+  }
+}
+
+} // namespace fles
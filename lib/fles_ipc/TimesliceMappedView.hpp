@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::TimesliceMappedView class.
+#pragma once
+
+#include "MappedFile.hpp"
+#include "Timeslice.hpp"
+#include <memory>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief The TimesliceMappedView class provides access to the data of a single
+ * timeslice stored in a memory-mapped archive file.
+ *
+ * The microslice descriptors and contents are not copied, the access pointers
+ * point directly into the mapped pages. The mapping is kept alive as long as
+ * any view into it exists.
+ *
+ * A descriptor-only view (see Timeslice::content_omitted()) holds copies of
+ * the timeslice component descriptors with the sizes reduced accordingly.
+ */
+class TimesliceMappedView : public Timeslice {
+public:
+  /// Delete copy constructor (non-copyable).
+  TimesliceMappedView(const TimesliceMappedView&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const TimesliceMappedView&) = delete;
+
+  ~TimesliceMappedView() override = default;
+
+private:
+  friend class TimesliceMappedArchive;
+
+  TimesliceMappedView(std::shared_ptr<const MappedFile> file,
+                      const TimesliceDescriptor& timeslice_descriptor,
+                      std::vector<const uint8_t*> data,
+                      std::vector<const uint8_t*> desc,
+                      bool descriptors_only);
+
+  std::shared_ptr<const MappedFile> file_;
+  /// Component descriptors of a descriptor-only view.
+  std::vector<TimesliceComponentDescriptor> desc_;
+};
+
+} // namespace fles
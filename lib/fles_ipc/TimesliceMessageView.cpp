@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "TimesliceMessageView.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace fles {
+
+bool TimesliceMessageView::is_header(const zmq::message_t& frame) {
+  return frame.size() >= sizeof(magic) + sizeof(TimesliceDescriptor) &&
+         std::memcmp(frame.data(), magic, sizeof(magic)) == 0;
+}
+
+TimesliceMessageView::TimesliceMessageView(std::vector<zmq::message_t> frames)
+    : frames_(std::move(frames)) {
+  if (frames_.empty() || !is_header(frames_.front())) {
+    throw std::runtime_error("invalid zero-copy timeslice message");
+  }
+  auto* header = static_cast<uint8_t*>(frames_.front().data());
+  std::memcpy(&timeslice_descriptor_, header + sizeof(magic),
+              sizeof(TimesliceDescriptor));
+
+  const auto num_components = timeslice_descriptor_.num_components;
+  if (frames_.front().size() !=
+          sizeof(magic) + sizeof(TimesliceDescriptor) +
+              num_components * sizeof(TimesliceComponentDescriptor) ||
+      frames_.size() != num_components + 1) {
+    throw std::runtime_error("invalid zero-copy timeslice message");
+  }
+
+  auto* desc = reinterpret_cast<TimesliceComponentDescriptor*>(
+      header + sizeof(magic) + sizeof(TimesliceDescriptor));
+  for (uint32_t c = 0; c < num_components; ++c) {
+    if (frames_[c + 1].size() != desc[c].size) {
+      throw std::runtime_error("invalid zero-copy timeslice message");
+    }
+    desc_ptr_.push_back(&desc[c]);
+    data_ptr_.push_back(static_cast<uint8_t*>(frames_[c + 1].data()));
+  }
+}
+
+} // namespace fles
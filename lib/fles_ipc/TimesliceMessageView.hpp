@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::TimesliceMessageView class.
+#pragma once
+
+#include "Timeslice.hpp"
+#include <vector>
+#include <zmq.hpp>
+
+namespace fles {
+
+/**
+ * \brief The TimesliceMessageView class provides access to the data of a
+ * timeslice received as a multipart ZeroMQ message.
+ *
+ * The message is sent by a TimeslicePublisher in zero-copy mode. Its first
+ * frame holds the identifier #magic, the TimesliceDescriptor and the
+ * TimesliceComponentDescriptor of each component; each following frame holds
+ * the data of one component. The view points directly into the received
+ * frames, which it owns.
+ */
+class TimesliceMessageView : public Timeslice {
+public:
+  /// Delete copy constructor (non-copyable).
+  TimesliceMessageView(const TimesliceMessageView&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const TimesliceMessageView&) = delete;
+
+  ~TimesliceMessageView() override = default;
+
+  /// Identification bytes at the start of the first message frame.
+  static constexpr char magic[8] = {'F', 'L', 'E', 'S', 'T', 'S', 'Z', 'C'};
+
+  /// Check whether a message frame starts a zero-copy timeslice message.
+  static bool is_header(const zmq::message_t& frame);
+
+private:
+  friend class TimesliceSubscriber;
+
+  explicit TimesliceMessageView(std::vector<zmq::message_t> frames);
+
+  std::vector<zmq::message_t> frames_;
+};
+
+} // namespace fles
@@ -1,33 +1,136 @@
 // Copyright 2014 Jan de Cuveland <cmail@cuveland.de>
 
 #include "TimeslicePublisher.hpp"
+#include "TimesliceMessageView.hpp"
 #include <algorithm>
 #include <boost/archive/binary_oarchive.hpp>
 #include <boost/iostreams/device/back_inserter.hpp>
 #include <boost/iostreams/stream.hpp>
+#include <stdexcept>
 
 namespace fles {
 
+struct TimeslicePublisher::FrameHint {
+  std::shared_ptr<const Timeslice> timeslice;
+  ReleasedFrames* released;
+};
+
 TimeslicePublisher::TimeslicePublisher(const std::string& address,
-                                       uint32_t hwm) {
-  publisher_.set(zmq::sockopt::sndhwm, int(hwm));
-  publisher_.bind(address.c_str());
+                                       uint32_t hwm,
+                                       bool zero_copy,
+                                       std::size_t shards,
+                                       bool descriptors_only)
+    : zero_copy_(zero_copy), descriptors_only_(descriptors_only) {
+  if (shards == 0) {
+    throw std::invalid_argument("number of publisher shards must be positive");
+  }
+  for (std::size_t shard = 0; shard < shards; ++shard) {
+    auto& publisher = publishers_.emplace_back(context_, ZMQ_PUB);
+    publisher.set(zmq::sockopt::sndhwm, int(hwm));
+    publisher.bind(
+        (shards == 1 ? address : shard_address(address, shard)).c_str());
+  }
+}
+
+TimeslicePublisher::~TimeslicePublisher() {
+  // Wait for ZeroMQ to release all pending frames
+  for (auto& publisher : publishers_) {
+    publisher.close();
+  }
+  context_.close();
+  destroy_released_frames();
+}
+
+void TimeslicePublisher::put(std::shared_ptr<const fles::Timeslice> timeslice) {
+  auto& publisher = publishers_[timeslice->index() % publishers_.size()];
+  if (zero_copy_) {
+    destroy_released_frames();
+    do_put_zero_copy(publisher, std::move(timeslice));
+  } else {
+    do_put(publisher, *timeslice);
+  }
+}
+
+std::string TimeslicePublisher::shard_address(const std::string& address,
+                                              std::size_t shard) {
+  const auto colon = address.rfind(':');
+  const std::string port =
+      colon == std::string::npos ? std::string() : address.substr(colon + 1);
+  if (port.empty() || port.size() > 5 ||
+      port.find_first_not_of("0123456789") != std::string::npos) {
+    throw std::invalid_argument("address without port for sharding: " +
+                                address);
+  }
+  return address.substr(0, colon + 1) +
+         std::to_string(std::stoul(port) + shard);
 }
 
-void TimeslicePublisher::do_put(const StorableTimeslice& timeslice) {
+void TimeslicePublisher::do_put(zmq::socket_t& publisher,
+                                const Timeslice& timeslice) {
   // serialize timeslice to string
   serial_str_.clear();
   boost::iostreams::back_insert_device<std::string> inserter(serial_str_);
   boost::iostreams::stream<boost::iostreams::back_insert_device<std::string>> s(
       inserter);
   boost::archive::binary_oarchive oa(s);
-  oa << timeslice;
+  const TimesliceSerializer serializer(timeslice, descriptors_only_);
+  oa << serializer;
   s.flush();
 
   zmq::message_t message(serial_str_.size());
   std::copy_n(static_cast<const char*>(serial_str_.data()), message.size(),
               static_cast<char*>(message.data()));
-  publisher_.send(message, zmq::send_flags::none);
+  publisher.send(message, zmq::send_flags::none);
+}
+
+void TimeslicePublisher::do_put_zero_copy(
+    zmq::socket_t& publisher,
+    std::shared_ptr<const fles::Timeslice> timeslice) {
+  const Timeslice& ts = *timeslice;
+  const auto num_components = ts.num_components();
+
+  // The small header frame is copied
+  serial_str_.assign(TimesliceMessageView::magic,
+                     sizeof(TimesliceMessageView::magic));
+  serial_str_.append(reinterpret_cast<const char*>(&ts.timeslice_descriptor_),
+                     sizeof(TimesliceDescriptor));
+  std::vector<uint64_t> sizes(num_components);
+  for (uint64_t c = 0; c < num_components; ++c) {
+    TimesliceComponentDescriptor desc = *ts.desc_ptr_[c];
+    if (descriptors_only_) {
+      desc.size = desc.num_microslices * sizeof(MicrosliceDescriptor);
+    }
+    sizes[c] = desc.size;
+    serial_str_.append(reinterpret_cast<const char*>(&desc), sizeof(desc));
+  }
+  zmq::message_t header(serial_str_.data(), serial_str_.size());
+  publisher.send(header, num_components > 0 ? zmq::send_flags::sndmore
+                                            : zmq::send_flags::none);
+
+  for (uint64_t c = 0; c < num_components; ++c) {
+    auto* hint = new FrameHint{timeslice, &released_};
+    zmq::message_t frame(ts.component_data_ptr(c), sizes[c],
+                         &TimeslicePublisher::release_frame, hint);
+    publisher.send(frame, c + 1 < num_components ? zmq::send_flags::sndmore
+                                                 : zmq::send_flags::none);
+  }
+}
+
+void TimeslicePublisher::release_frame(void* /* data */, void* hint) {
+  auto* frame_hint = static_cast<FrameHint*>(hint);
+  std::lock_guard<std::mutex> lock(frame_hint->released->mutex);
+  frame_hint->released->hints.push_back(frame_hint);
+}
+
+void TimeslicePublisher::destroy_released_frames() {
+  std::vector<FrameHint*> hints;
+  {
+    std::lock_guard<std::mutex> lock(released_.mutex);
+    std::swap(hints, released_.hints);
+  }
+  for (auto* hint : hints) {
+    delete hint; // NOLINT
+  }
 }
 
 } // namespace fles
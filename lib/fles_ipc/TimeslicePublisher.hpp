@@ -5,7 +5,9 @@
 
 #include "Sink.hpp"
 #include "StorableTimeslice.hpp"
+#include <mutex>
 #include <string>
+#include <vector>
 #include <zmq.hpp>
 
 namespace fles {
@@ -13,28 +15,80 @@ namespace fles {
 /**
  * \brief The TimeslicePublisher class publishes serialized timeslice data sets
  * to a zeromq socket.
+ *
+ * In zero-copy mode, each timeslice is sent as a multipart message (see
+ * TimesliceMessageView) whose component data frames are handed over to
+ * ZeroMQ without copying. The timeslice is kept alive until ZeroMQ has
+ * released all of its frames.
+ *
+ * In sharded mode, the publisher binds to N consecutive ports starting at
+ * the port of the given address (see shard_address()) and sends each
+ * timeslice on the socket given by its index modulo N. A
+ * ShardedTimesliceSubscriber receives and deserializes the shards in
+ * parallel.
+ *
+ * In descriptor-only mode, the publisher sends descriptor-only timeslices
+ * (see Timeslice::content_omitted()) for lightweight monitoring clients. As
+ * all subscribers of a publisher receive the same messages, such clients
+ * connect to a separate descriptor-only publisher.
  */
 class TimeslicePublisher : public TimesliceSink {
 public:
   /// Construct timeslice publisher sending at given ZMQ address.
-  TimeslicePublisher(const std::string& address, uint32_t hwm = 1);
+  TimeslicePublisher(const std::string& address,
+                     uint32_t hwm = 1,
+                     bool zero_copy = false,
+                     std::size_t shards = 1,
+                     bool descriptors_only = false);
 
   /// Delete copy constructor (non-copyable).
   TimeslicePublisher(const TimeslicePublisher&) = delete;
   /// Delete assignment operator (non-copyable).
   void operator=(const TimeslicePublisher&) = delete;
 
+  ~TimeslicePublisher() override;
+
   /// Send a timeslice to all connected subscribers.
-  void put(std::shared_ptr<const fles::Timeslice> timeslice) override {
-    do_put(*timeslice);
-  };
+  void put(std::shared_ptr<const fles::Timeslice> timeslice) override;
+
+  /**
+   * \brief Retrieve the address of a shard.
+   *
+   * The port of the address is incremented by the shard number, e.g.,
+   * "tcp://localhost:5556" yields "tcp://localhost:5557" for shard 1.
+   *
+   * \throws std::invalid_argument if the address does not end in a port
+   */
+  static std::string shard_address(const std::string& address,
+                                   std::size_t shard);
 
 private:
+  /// Frame reference released by ZeroMQ, pending destruction.
+  struct FrameHint;
+
+  /// Timeslice references released by the ZeroMQ I/O thread. They are
+  /// destroyed in the publishing thread, as the destructor of a timeslice
+  /// (e.g., a TimesliceView) need not be thread-safe.
+  struct ReleasedFrames {
+    std::mutex mutex;
+    std::vector<FrameHint*> hints;
+  };
+
+  // Declared first to be destroyed after the context has released all frames
+  ReleasedFrames released_;
+
   zmq::context_t context_{1};
-  zmq::socket_t publisher_{context_, ZMQ_PUB};
+  std::vector<zmq::socket_t> publishers_;
   std::string serial_str_;
+  bool zero_copy_;
+  bool descriptors_only_;
+
+  void do_put(zmq::socket_t& publisher, const fles::Timeslice& timeslice);
+  void do_put_zero_copy(zmq::socket_t& publisher,
+                        std::shared_ptr<const fles::Timeslice> timeslice);
+  void destroy_released_frames();
 
-  void do_put(const fles::StorableTimeslice& timeslice);
+  static void release_frame(void* data, void* hint);
 };
 
 } // namespace fles
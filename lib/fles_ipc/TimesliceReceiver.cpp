@@ -2,19 +2,67 @@
 
 #include "TimesliceReceiver.hpp"
 #include "TimesliceShmWorkItem.hpp"
+#include "TimesliceSpillLog.hpp"
 #include <boost/archive/binary_iarchive.hpp>
 #include <boost/uuid/nil_generator.hpp>
+#include <algorithm>
+#include <chrono>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
 #include <utility>
 
 namespace bi = boost::interprocess;
 
 namespace fles {
 
+namespace {
+
+/// The shared memory mappings of all receivers in this process, so that
+/// several receivers of the same producer map its segments only once.
+struct SharedMappings {
+  struct Managed {
+    std::weak_ptr<bi::managed_shared_memory> shm;
+    std::weak_ptr<DeviceMemory> device;
+    boost::uuids::uuid uuid;
+  };
+
+  std::mutex mutex;
+  std::map<std::string, Managed> managed;
+  std::map<std::string, std::weak_ptr<const TimesliceShmSegment>> flat;
+};
+
+SharedMappings& shared_mappings() {
+  static SharedMappings mappings;
+  return mappings;
+}
+
+} // namespace
+
 TimesliceReceiver::TimesliceReceiver(const std::string& ipc_identifier,
-                                     WorkerParameters parameters)
-    : worker_("ipc://@" + ipc_identifier, std::move(parameters)) {
-  worker_.set_disconnect_callback([this] { managed_shm_ = nullptr; });
+                                     WorkerParameters parameters,
+                                     ComponentFilter filter)
+    : filter_(std::move(filter)) {
+  const auto channel_name = shm_item_channel_name(ipc_identifier);
+  if (ShmItemWorker::available(channel_name)) {
+    shm_worker_ =
+        std::make_unique<ShmItemWorker>(channel_name, std::move(parameters));
+    shm_worker_->set_disconnect_callback([this] {
+      managed_shm_ = nullptr;
+      data_device_ = nullptr;
+      flat_segment_ = nullptr;
+    });
+  } else {
+    worker_ = std::make_unique<ItemWorker>("ipc://@" + ipc_identifier,
+                                           std::move(parameters));
+    worker_->set_disconnect_callback([this] {
+      managed_shm_ = nullptr;
+      data_device_ = nullptr;
+      flat_segment_ = nullptr;
+    });
+  }
 }
 
 TimesliceView* TimesliceReceiver::do_get() {
@@ -22,37 +70,222 @@ TimesliceView* TimesliceReceiver::do_get() {
     return nullptr;
   }
 
-  while (auto item = worker_.get()) {
-    fles::TimesliceShmWorkItem timeslice_item;
-    std::istringstream istream(item->payload());
-    {
-      boost::archive::binary_iarchive iarchive(istream);
-      iarchive >> timeslice_item;
+  while (auto item = shm_worker_ ? shm_worker_->get() : worker_->get()) {
+    if (auto* view = make_view(std::move(item))) {
+      return view;
+    }
+  }
+
+  eos_ = true;
+  return nullptr;
+}
+
+void TimesliceReceiver::do_get_batch(
+    std::vector<std::unique_ptr<Timeslice>>& items,
+    std::size_t max_items,
+    std::chrono::nanoseconds timeout) {
+  if (max_items == 0) {
+    return;
+  }
+  TimesliceView* first = do_get();
+  if (first == nullptr) {
+    return;
+  }
+  items.emplace_back(first);
+
+  // Take the following work items as they arrive until the deadline; an
+  // end-of-stream is detected by the next call
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (items.size() < max_items) {
+    auto item = shm_worker_ ? shm_worker_->get_until(deadline)
+                            : worker_->get_until(deadline);
+    if (!item) {
+      break;
+    }
+    if (auto* view = make_view(std::move(item))) {
+      items.emplace_back(view);
+    }
+  }
+}
+
+TimesliceView* TimesliceReceiver::make_view(std::shared_ptr<const Item> item) {
+  if (TimesliceSpillItemView::is_spill(item->payload())) {
+    // the producer spilled the timeslice to a log file
+    const TimesliceSpillItemView spill_item(item->payload());
+    std::shared_ptr<TimesliceSpillRecord> record;
+    try {
+      record = std::make_shared<TimesliceSpillRecord>(
+          std::string(spill_item.path()), spill_item.offset(),
+          spill_item.size());
+    } catch (const std::runtime_error& e) {
+      std::cerr << "TimesliceView: discarding item: " << e.what() << std::endl;
+      return nullptr;
     }
+    auto* view = new TimesliceView(std::move(record), item);
+    view->select_components(filter_);
+    return view;
+  }
 
-    // connect to matching shared memory if not already connected
-    if (managed_shm_uuid() != timeslice_item.shm_uuid) {
-      managed_shm_ =
-          std::make_unique<boost::interprocess::managed_shared_memory>(
-              boost::interprocess::open_read_only,
-              timeslice_item.shm_identifier.c_str());
-      std::cout << "TimesliceReceiver: opened shared memory "
-                << timeslice_item.shm_identifier << " {" << managed_shm_uuid()
-                << "}" << std::endl;
-      if (managed_shm_uuid() != timeslice_item.shm_uuid) {
-        std::cerr
-            << "TimesliceView: discarding item due to shm uuid mismatch (shm: "
-            << managed_shm_uuid() << ", ts_item: " << timeslice_item.shm_uuid
-            << ")" << std::endl;
-        continue;
+  if (TimesliceShmFlatItemView::is_flat(item->payload())) {
+    const TimesliceShmFlatItemView timeslice_item(item->payload());
+    if (!connect_flat_segment(timeslice_item.shm_uuid(),
+                              timeslice_item.shm_identifier())) {
+      return nullptr;
+    }
+    auto* view =
+        new TimesliceView(flat_segment_, item, timeslice_item.ts_pos());
+    if (!partial_delivery_) {
+      // the producer writes the remaining components concurrently
+      while (!view->complete()) {
+        std::this_thread::sleep_for(std::chrono::microseconds(10));
       }
     }
+    view->select_components(filter_);
+    prefetch(*view);
+    return view;
+  }
 
-    return new TimesliceView(managed_shm_, item, timeslice_item);
+  if (TimesliceShmWorkItemView::is_binary(item->payload())) {
+    const TimesliceShmWorkItemView timeslice_item(item->payload());
+    if (!connect_managed_shm(timeslice_item.shm_uuid(),
+                             timeslice_item.shm_identifier())) {
+      return nullptr;
+    }
+    auto* view = new TimesliceView(managed_shm_, data_device_, item,
+                                   timeslice_item);
+    view->select_components(filter_);
+    prefetch(*view);
+    return view;
   }
 
-  eos_ = true;
-  return nullptr;
+  // Work item from a producer using the legacy encoding
+  fles::TimesliceShmWorkItem timeslice_item;
+  std::istringstream istream(item->payload());
+  {
+    boost::archive::binary_iarchive iarchive(istream);
+    iarchive >> timeslice_item;
+  }
+  if (!connect_managed_shm(timeslice_item.shm_uuid,
+                           timeslice_item.shm_identifier)) {
+    return nullptr;
+  }
+  auto* view =
+      new TimesliceView(managed_shm_, data_device_, item, timeslice_item);
+  view->select_components(filter_);
+  prefetch(*view);
+  return view;
+}
+
+void TimesliceReceiver::prefetch(TimesliceView& view) {
+  if (!prefetcher_ || view.data_device() >= 0) {
+    return;
+  }
+  std::vector<PagePrefetcher::Range> ranges;
+  ranges.reserve(view.num_components());
+  for (uint64_t c = 0; c < view.num_components(); ++c) {
+    // with partial delivery, the producer may still write the component
+    if (view.component_complete(c)) {
+      ranges.push_back({view.component_data(c),
+                        std::min<std::size_t>(view.size_component(c),
+                                              readahead_)});
+    }
+  }
+  // the work item pins the timeslice, the mapping keeps the memory valid
+  std::shared_ptr<const void> mapping = view.segment_;
+  if (!mapping) {
+    mapping = view.managed_shm_;
+  }
+  prefetcher_->submit(
+      std::move(ranges),
+      std::make_shared<std::pair<std::shared_ptr<const Item>,
+                                 std::shared_ptr<const void>>>(
+          view.work_item_, std::move(mapping)));
+}
+
+void TimesliceReceiver::set_partial_delivery(bool enable) {
+  if (enable && !filter_.all()) {
+    throw std::runtime_error(
+        "component filter not supported with partial delivery");
+  }
+  partial_delivery_ = enable;
+}
+
+void TimesliceReceiver::set_readahead(std::size_t bytes) {
+  readahead_ = bytes;
+  if (readahead_ == 0) {
+    prefetcher_.reset();
+  } else if (!prefetcher_) {
+    prefetcher_ = std::make_unique<PagePrefetcher>();
+  }
+}
+
+bool TimesliceReceiver::connect_managed_shm(
+    const boost::uuids::uuid& shm_uuid, std::string_view shm_identifier) {
+  // connect to matching shared memory if not already connected
+  if (managed_shm_ && managed_uuid_ == shm_uuid) {
+    return true;
+  }
+  const std::string identifier(shm_identifier);
+  auto& mappings = shared_mappings();
+  std::lock_guard<std::mutex> lock(mappings.mutex);
+  auto& mapping = mappings.managed[identifier];
+  managed_shm_ = mapping.shm.lock();
+  data_device_ = mapping.device.lock();
+  managed_uuid_ = mapping.uuid;
+  if (!managed_shm_ || managed_uuid_ != shm_uuid) {
+    managed_shm_ = std::make_shared<bi::managed_shared_memory>(
+        bi::open_read_only, identifier.c_str());
+    managed_uuid_ = managed_shm_uuid();
+    std::cout << "TimesliceReceiver: opened shared memory " << shm_identifier
+              << " {" << managed_uuid_ << "}" << std::endl;
+    data_device_ = nullptr;
+    mapping = {managed_shm_, data_device_, managed_uuid_};
+    if (managed_uuid_ != shm_uuid) {
+      std::cerr
+          << "TimesliceView: discarding item due to shm uuid mismatch (shm: "
+          << managed_uuid_ << ", ts_item: " << shm_uuid << ")" << std::endl;
+      return false;
+    }
+    auto* device_handle =
+        managed_shm_->find<DeviceMemoryHandle>(bi::unique_instance).first;
+    if (device_handle != nullptr) {
+      data_device_ = std::make_shared<DeviceMemory>(*device_handle);
+      mapping.device = data_device_;
+    }
+  }
+  if (data_device_ && !filter_.all()) {
+    throw std::runtime_error(
+        "component filter not supported for timeslice data on a GPU");
+  }
+  return true;
+}
+
+bool TimesliceReceiver::connect_flat_segment(const uint8_t* shm_uuid,
+                                             std::string_view shm_identifier) {
+  if (flat_segment_ && flat_segment_->layout().has_uuid(shm_uuid)) {
+    return true;
+  }
+  const std::string identifier(shm_identifier);
+  auto& mappings = shared_mappings();
+  std::lock_guard<std::mutex> lock(mappings.mutex);
+  auto& mapping = mappings.flat[identifier];
+  flat_segment_ = mapping.lock();
+  if (!flat_segment_ || !flat_segment_->layout().has_uuid(shm_uuid)) {
+    flat_segment_ = std::make_shared<const TimesliceShmSegment>(
+        bi::open_read_only, identifier);
+    std::cout << "TimesliceReceiver: opened flat shared memory "
+              << shm_identifier << std::endl;
+    mapping = flat_segment_;
+    if (!flat_segment_->layout().has_uuid(shm_uuid)) {
+      std::cerr << "TimesliceView: discarding item due to shm uuid mismatch"
+                << std::endl;
+      flat_segment_ = nullptr;
+      return false;
+    }
+  }
+  managed_shm_ = nullptr;
+  data_device_ = nullptr;
+  return true;
 }
 
 boost::uuids::uuid TimesliceReceiver::managed_shm_uuid() const {
@@ -5,13 +5,20 @@
 
 #include "ItemWorker.hpp"
 #include "ItemWorkerProtocol.hpp"
+#include "PagePrefetcher.hpp"
+#include "ShmItemWorker.hpp"
 #include "System.hpp"
+#include "TimesliceShmSegment.hpp"
 #include "TimesliceSource.hpp"
 #include "TimesliceView.hpp"
 #include <boost/interprocess/managed_shared_memory.hpp>
 #include <boost/uuid/uuid.hpp>
+#include <chrono>
+#include <cstddef>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace fles {
 
@@ -22,8 +29,15 @@ namespace fles {
 class TimesliceReceiver : public TimesliceSource {
 public:
   /// Construct timeslice receiver connected to a given shared memory.
+  /**
+   * Work items are received through the shared memory item channel if the
+   * producer has created one, and through the ZMQ item distributor
+   * otherwise. Components not selected by the given filter are omitted
+   * from the returned views.
+   */
   explicit TimesliceReceiver(const std::string& ipc_identifier,
-                             WorkerParameters parameters);
+                             WorkerParameters parameters,
+                             ComponentFilter filter = {});
 
   /// Delete copy constructor (non-copyable).
   TimesliceReceiver(const TimesliceReceiver&) = delete;
@@ -45,18 +59,82 @@ public:
 
   [[nodiscard]] bool eos() const override { return eos_; }
 
+  /// Hand on timeslices before all of their components are complete.
+  /**
+   * Only has an effect if the producer delivers partial timeslices (flat
+   * layout only). The consumer then has to check
+   * TimesliceView::component_complete() before accessing a component.
+   * Otherwise, get() waits for all components. Requires selecting all
+   * components.
+   */
+  void set_partial_delivery(bool enable);
+
+  /// Prefetch the first bytes of each component on a helper thread.
+  /**
+   * The leading `bytes` of the data of each component (see PagePrefetcher)
+   * are touched as soon as a work item is received, while the consumer
+   * processes the previous timeslices. Timeslice data on a GPU or read
+   * from a spill log is not prefetched. A value of 0 disables the prefetch.
+   */
+  void set_readahead(std::size_t bytes);
+
 private:
   TimesliceView* do_get() override;
 
+  /// Take the work items arriving within the timeout after the first one,
+  /// from the shared memory item channel as well as the ZMQ item
+  /// distributor, which delivers one item per request.
+  void do_get_batch(std::vector<std::unique_ptr<Timeslice>>& items,
+                    std::size_t max_items,
+                    std::chrono::nanoseconds timeout) override;
+
+  /// Create the view of a work item, or return nullptr if the item is
+  /// discarded.
+  TimesliceView* make_view(std::shared_ptr<const Item> item);
+
+  /// Request the prefetch of the component data of a shared memory view.
+  void prefetch(TimesliceView& view);
+
   std::shared_ptr<boost::interprocess::managed_shared_memory> managed_shm_;
 
+  /// The data buffer memory of the producer, if placed on a GPU
+  std::shared_ptr<DeviceMemory> data_device_;
+
+  /// The UUID of the connected shared memory
+  boost::uuids::uuid managed_uuid_{};
+
   [[nodiscard]] boost::uuids::uuid managed_shm_uuid() const;
 
+  /// Connect to the given shared memory unless already connected, return
+  /// false on UUID mismatch. Data buffers placed on a GPU by the producer
+  /// are opened as well. The mappings are shared by all receivers of the
+  /// process.
+  bool connect_managed_shm(const boost::uuids::uuid& shm_uuid,
+                           std::string_view shm_identifier);
+
+  /// The shared memory segment of the producer, if in the flat layout
+  std::shared_ptr<const TimesliceShmSegment> flat_segment_;
+
+  /// Connect to the given flat shared memory segment unless already
+  /// connected, return false on UUID mismatch.
+  bool connect_flat_segment(const uint8_t* shm_uuid,
+                            std::string_view shm_identifier);
+
   /// The end-of-stream flag.
   bool eos_ = false;
 
-  // The respective item worker object
-  ItemWorker worker_;
+  /// Hand on views before all components are complete.
+  bool partial_delivery_ = false;
+
+  /// Number of bytes to prefetch per component (0: no prefetch)
+  std::size_t readahead_ = 0;
+  std::unique_ptr<PagePrefetcher> prefetcher_;
+
+  ComponentFilter filter_;
+
+  // The respective item worker object, one of which is used
+  std::unique_ptr<ItemWorker> worker_;
+  std::unique_ptr<ShmItemWorker> shm_worker_;
 };
 
 } // namespace fles
@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::TimesliceSerializer class.
+#pragma once
+
+#include "DescriptorCodec.hpp"
+#include "Timeslice.hpp"
+#include <cstdint>
+#include <vector>
+
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/collection_size_type.hpp>
+#include <boost/serialization/item_version_type.hpp>
+#include <boost/serialization/level.hpp>
+#include <boost/serialization/vector.hpp>
+
+namespace fles {
+
+/**
+ * \brief The TimesliceSerializer class writes any Timeslice in the archive
+ * format of StorableTimeslice, directly from its component data.
+ *
+ * Views into shared memory or receive buffers are thus serialized without
+ * first copying them into a StorableTimeslice. The component data is passed
+ * to the archive with a single save_binary() call per component.
+ *
+ * The serialized form (including the boost class information) is identical
+ * to that of a StorableTimeslice as long as only one of the two types is
+ * written to the same archive. The writers of timeslices therefore use this
+ * class for all timeslices. It is for saving only.
+ *
+ * With descriptors_only set, the timeslice is serialized as a
+ * descriptor-only copy (see Timeslice::content_omitted()) without accessing
+ * the microslice contents.
+ */
+class TimesliceSerializer {
+public:
+  /// Construct a serializer for a timeslice, which has to outlive it.
+  explicit TimesliceSerializer(const Timeslice& timeslice,
+                               bool descriptors_only = false)
+      : timeslice_(timeslice), descriptors_only_(descriptors_only) {}
+
+  /// Serialize with compactly encoded microslice descriptors (see
+  /// StorableTimeslice::save_compact()).
+  template <class Archive>
+  void save_compact(Archive& ar, DescriptorCodec& codec) const {
+    const auto desc_vector = component_descriptors();
+    ar << timeslice_.timeslice_descriptor_;
+    ar << desc_vector;
+    for (std::size_t c = 0; c < timeslice_.num_components(); ++c) {
+      const auto& desc = desc_vector[c];
+      const uint8_t* data = timeslice_.component_data_ptr(c);
+      const uint64_t desc_size =
+          desc.num_microslices * sizeof(MicrosliceDescriptor);
+      const uint64_t content_size = desc.size - desc_size;
+      ar << content_size;
+      codec.reset();
+      codec.save(ar, reinterpret_cast<const MicrosliceDescriptor*>(data),
+                 desc.num_microslices);
+      ar.save_binary(data + desc_size, content_size);
+    }
+  }
+
+  /// The data of a component, serialized like a std::vector<uint8_t>.
+  struct ComponentData {
+    const uint8_t* data;
+    uint64_t size;
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int /* version */) {
+      const boost::serialization::collection_size_type count(size);
+      ar << count;
+      if (size != 0) {
+        ar.save_binary(data, size);
+      }
+    }
+  };
+
+  /// The data of all components, serialized like a vector of
+  /// TimesliceArenaBuffer.
+  struct Components {
+    const std::vector<uint8_t*>& data_ptr;
+    const std::vector<TimesliceComponentDescriptor>& desc;
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int /* version */) {
+      const boost::serialization::collection_size_type count(data_ptr.size());
+      const boost::serialization::item_version_type item_version(0);
+      ar << count;
+      ar << item_version;
+      for (std::size_t c = 0; c < data_ptr.size(); ++c) {
+        const ComponentData component{data_ptr[c], desc[c].size};
+        ar << component;
+      }
+    }
+  };
+
+private:
+  friend class boost::serialization::access;
+
+  const Timeslice& timeslice_;
+  bool descriptors_only_;
+
+  [[nodiscard]] std::vector<TimesliceComponentDescriptor>
+  component_descriptors() const {
+    std::vector<TimesliceComponentDescriptor> desc;
+    desc.reserve(timeslice_.num_components());
+    for (std::size_t c = 0; c < timeslice_.num_components(); ++c) {
+      auto& d = desc.emplace_back(*timeslice_.desc_ptr_[c]);
+      if (descriptors_only_) {
+        d.size = d.num_microslices * sizeof(MicrosliceDescriptor);
+      }
+    }
+    return desc;
+  }
+
+  // mirrors StorableTimeslice::serialize()
+  template <class Archive>
+  void serialize(Archive& ar, const unsigned int /* version */) {
+    const auto desc_vector = component_descriptors();
+    timeslice_.materialize();
+    const Components components{timeslice_.data_ptr_, desc_vector};
+    ar << timeslice_.timeslice_descriptor_;
+    ar << components;
+    ar << desc_vector;
+  }
+};
+
+} // namespace fles
+
+// Serialize like std::vector<uint8_t>, cf. TimesliceArenaBuffer
+BOOST_CLASS_IMPLEMENTATION(fles::TimesliceSerializer::ComponentData,
+                           boost::serialization::object_serializable)
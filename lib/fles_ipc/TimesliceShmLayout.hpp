@@ -0,0 +1,443 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the flat shared memory timeslice buffer layout
+/// (fles::TimesliceShmLayout) and its work items.
+#pragma once
+
+#include "ComponentSummary.hpp"
+#include "TimesliceComponentDescriptor.hpp"
+#include "TimesliceDescriptor.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fles {
+
+#pragma pack(1)
+
+/**
+ * \brief Header of a shared memory timeslice buffer in the flat layout.
+ *
+ * The segment starts with this header, followed by three regions at the
+ * offsets (in bytes from the start of the segment) given in the header:
+ * - the timeslice table, an array of 2^desc_size_exp TimesliceDescriptor
+ *   entries (24 bytes each),
+ * - the descriptor rings, one array of 2^desc_size_exp
+ *   TimesliceComponentDescriptor entries (32 bytes each) per component,
+ * - the status rings (since version 2), one array of 2^desc_size_exp
+ *   uint64_t entries per component,
+ * - the data ring table (since version 3), one TimesliceShmDataRing entry
+ *   per component,
+ * - the summary rings (since version 4), one array of 2^desc_size_exp
+ *   ComponentSummary entries (64 bytes each) per component,
+ * - the data rings, one buffer per component.
+ *
+ * Up to version 2, each data ring has 2^data_size_exp bytes and they follow
+ * each other at data_offset. Since version 3, the size and offset of the
+ * data ring of each component are given by its entry in the data ring
+ * table, and data_size_exp is the exponent of the largest data ring. This
+ * allows sizing the rings according to the data rates of the inputs.
+ *
+ * The timeslice at buffer position ts_pos is described by the entries at
+ * index (ts_pos mod 2^desc_size_exp) of the timeslice table and of the
+ * descriptor ring of each component. The data of a component (microslice
+ * descriptors followed by microslice contents) is stored contiguously in
+ * its data ring at the offset of its component descriptor modulo the size
+ * of the ring. All values are unpadded and in host byte order, so readers
+ * in any language can locate a timeslice with a few loads.
+ *
+ * The status entry of a component holds ts_pos + 1 once its data for the
+ * timeslice at ts_pos is complete. It is written with release semantics
+ * after the data and the component descriptor, so a reader loading it with
+ * acquire semantics may access the component as soon as it matches. With
+ * partial delivery, the work item of a timeslice is sent before all of its
+ * components are complete.
+ *
+ * The summary entry of a component is written along with its component
+ * descriptor by transports supporting it. It belongs to the component if
+ * it is valid for the values of the descriptor (see
+ * ComponentSummary::valid_for()), otherwise it is stale or not set.
+ */
+struct TimesliceShmHeader {
+  /// Magic number identifying the layout ("FLESTSBF")
+  static constexpr uint64_t magic_value = 0x4642535453454c46;
+  /// Current version of the layout
+  static constexpr uint32_t current_version = 4;
+  /// Size of the header of version 1 (without status rings)
+  static constexpr uint32_t version_1_size = 80;
+  /// Size of the header of version 2 (without data ring table)
+  static constexpr uint32_t version_2_size = 88;
+  /// Size of the header of version 3 (without summary rings)
+  static constexpr uint32_t version_3_size = 96;
+
+  uint64_t magic;             ///< Always magic_value
+  uint32_t version;           ///< Version of the layout
+  uint32_t header_size;       ///< Size of this header in bytes
+  uint8_t shm_uuid[16];       ///< UUID of this instance of the segment
+  uint32_t num_components;    ///< Number of components (input nodes)
+  uint32_t data_size_exp;     ///< 2's exponent of the (largest) data ring size
+  uint32_t desc_size_exp;     ///< 2's exponent of the number of ring entries
+  uint32_t reserved;          ///< Reserved, set to zero
+  uint64_t ts_table_offset;   ///< Offset of the timeslice table
+  uint64_t desc_offset;       ///< Offset of the descriptor ring of component 0
+  uint64_t data_offset;       ///< Offset of the data ring of component 0
+  uint64_t segment_size;      ///< Total size of the segment in bytes
+  uint64_t status_offset;     ///< Offset of the status ring of component 0
+  uint64_t data_table_offset; ///< Offset of the data ring table
+  uint64_t summary_offset;    ///< Offset of the summary ring of component 0
+};
+
+/// Entry of the data ring table of a segment in the flat layout.
+struct TimesliceShmDataRing {
+  uint64_t offset;   ///< Offset of the data ring from the start of the segment
+  uint32_t size_exp; ///< 2's exponent of the data ring size in bytes
+  uint32_t reserved; ///< Reserved, set to zero
+};
+
+/**
+ * \brief Header of a work item referring to a timeslice in a segment in the
+ * flat layout.
+ *
+ * The header is followed by the shared memory identifier (without
+ * terminating null character).
+ */
+struct TimesliceShmFlatItemHeader {
+  /// Magic number to tell the flat work item from other encodings ("TSWF")
+  static constexpr uint32_t magic_value = 0x46575354;
+  /// Current version of the work item encoding
+  static constexpr uint16_t current_version = 1;
+
+  uint32_t magic;               ///< Always magic_value
+  uint16_t version;             ///< Version of the encoding
+  uint16_t shm_identifier_size; ///< Length of the identifier string
+  uint8_t shm_uuid[16];         ///< UUID of the segment
+  uint64_t ts_pos;              ///< Buffer position of the timeslice
+};
+
+#pragma pack()
+
+static_assert(sizeof(TimesliceDescriptor) == 24);
+static_assert(sizeof(TimesliceComponentDescriptor) == 32);
+static_assert(offsetof(TimesliceShmHeader, status_offset) ==
+              TimesliceShmHeader::version_1_size);
+static_assert(offsetof(TimesliceShmHeader, data_table_offset) ==
+              TimesliceShmHeader::version_2_size);
+static_assert(offsetof(TimesliceShmHeader, summary_offset) ==
+              TimesliceShmHeader::version_3_size);
+static_assert(sizeof(TimesliceShmDataRing) == 16);
+
+/**
+ * \brief The TimesliceShmLayout class locates the timeslices in a mapped
+ * shared memory segment in the flat layout (see TimesliceShmHeader).
+ *
+ * The class does not own the mapping.
+ */
+class TimesliceShmLayout {
+public:
+  /**
+   * \brief Compute the header and the data ring table of a new segment.
+   *
+   * \param data_size_exps 2's exponents of the data ring sizes, one per
+   *                       component
+   * \param alignment Alignment of the regions in bytes (a power of two of
+   *                  at least the page size, e.g., the huge page size)
+   * \param data_table Receives the data ring table, to be written at
+   *                   header.data_table_offset
+   */
+  static TimesliceShmHeader
+  make_header(const uint8_t* shm_uuid,
+              const std::vector<uint32_t>& data_size_exps,
+              uint32_t desc_size_exp,
+              std::size_t alignment,
+              std::vector<TimesliceShmDataRing>& data_table) {
+    const auto num_components = static_cast<uint32_t>(data_size_exps.size());
+    TimesliceShmHeader header{};
+    header.magic = TimesliceShmHeader::magic_value;
+    header.version = TimesliceShmHeader::current_version;
+    header.header_size = sizeof(TimesliceShmHeader);
+    std::memcpy(header.shm_uuid, shm_uuid, sizeof header.shm_uuid);
+    header.num_components = num_components;
+    header.desc_size_exp = desc_size_exp;
+    const uint64_t entries = UINT64_C(1) << desc_size_exp;
+    header.ts_table_offset = align(sizeof(TimesliceShmHeader), alignment);
+    header.desc_offset = align(
+        header.ts_table_offset + entries * sizeof(TimesliceDescriptor),
+        alignment);
+    header.status_offset =
+        align(header.desc_offset + num_components * entries *
+                                       sizeof(TimesliceComponentDescriptor),
+              alignment);
+    header.data_table_offset = align(
+        header.status_offset + num_components * entries * sizeof(uint64_t),
+        alignment);
+    header.summary_offset =
+        align(header.data_table_offset +
+                  num_components * sizeof(TimesliceShmDataRing),
+              alignment);
+    header.data_offset = align(header.summary_offset +
+                                   num_components * entries *
+                                       sizeof(ComponentSummary),
+                               alignment);
+    // each ring starts at an aligned offset, so the policy covers it
+    data_table.assign(num_components, TimesliceShmDataRing{});
+    uint64_t offset = header.data_offset;
+    for (uint32_t c = 0; c < num_components; ++c) {
+      data_table[c].offset = offset;
+      data_table[c].size_exp = data_size_exps[c];
+      header.data_size_exp = std::max(header.data_size_exp, data_size_exps[c]);
+      offset = align(offset + (UINT64_C(1) << data_size_exps[c]), alignment);
+    }
+    header.segment_size =
+        num_components == 0
+            ? header.data_offset
+            : data_table.back().offset +
+                  (UINT64_C(1) << data_table.back().size_exp);
+    return header;
+  }
+
+  /**
+   * \brief Validate a mapped segment and construct the layout view.
+   *
+   * Segments of version 1 have no status rings, all of their components
+   * are reported as complete. Segments of versions 1 and 2 have data rings
+   * of equal size. Segments before version 4 have no summary rings.
+   *
+   * \throws std::runtime_error if the segment is not in a supported version
+   * of the flat layout
+   */
+  TimesliceShmLayout(void* segment, std::size_t size)
+      : base_(static_cast<uint8_t*>(segment)) {
+    if (size < TimesliceShmHeader::version_1_size) {
+      throw std::runtime_error("shared memory segment too small");
+    }
+    std::memcpy(&header_, base_, TimesliceShmHeader::version_1_size);
+    if (header_.magic != TimesliceShmHeader::magic_value) {
+      throw std::runtime_error("shared memory segment not in flat layout");
+    }
+    if (header_.version == TimesliceShmHeader::current_version &&
+        header_.header_size == sizeof header_ && size >= sizeof header_) {
+      std::memcpy(&header_, base_, sizeof header_);
+    } else if (header_.version == 3 &&
+               header_.header_size == TimesliceShmHeader::version_3_size &&
+               size >= TimesliceShmHeader::version_3_size) {
+      std::memcpy(&header_, base_, TimesliceShmHeader::version_3_size);
+    } else if (header_.version == 2 &&
+               header_.header_size == TimesliceShmHeader::version_2_size &&
+               size >= TimesliceShmHeader::version_2_size) {
+      std::memcpy(&header_, base_, TimesliceShmHeader::version_2_size);
+    } else if (header_.version != 1 ||
+               header_.header_size != TimesliceShmHeader::version_1_size) {
+      throw std::runtime_error("unsupported flat layout version " +
+                               std::to_string(header_.version));
+    }
+    if (header_.segment_size > size) {
+      throw std::runtime_error("shared memory segment truncated");
+    }
+    desc_mask_ = (UINT64_C(1) << header_.desc_size_exp) - 1;
+    if (header_.data_table_offset != 0) {
+      if (header_.data_table_offset +
+              uint64_t{header_.num_components} * sizeof(TimesliceShmDataRing) >
+          header_.segment_size) {
+        throw std::runtime_error("invalid data ring table");
+      }
+      data_table_ = reinterpret_cast<const TimesliceShmDataRing*>(
+          base_ + header_.data_table_offset);
+      for (uint32_t c = 0; c < header_.num_components; ++c) {
+        if (data_table_[c].size_exp > header_.data_size_exp ||
+            data_table_[c].offset + (UINT64_C(1) << data_table_[c].size_exp) >
+                header_.segment_size) {
+          throw std::runtime_error("invalid data ring table");
+        }
+      }
+    }
+  }
+
+  /// Retrieve the header of the segment.
+  [[nodiscard]] const TimesliceShmHeader& header() const { return header_; }
+
+  /// Check whether the segment has the given UUID.
+  [[nodiscard]] bool has_uuid(const uint8_t* shm_uuid) const {
+    return std::memcmp(header_.shm_uuid, shm_uuid, sizeof header_.shm_uuid) ==
+           0;
+  }
+
+  /// Retrieve the timeslice table entry at a buffer position.
+  [[nodiscard]] TimesliceDescriptor* ts_desc(uint64_t ts_pos) const {
+    return reinterpret_cast<TimesliceDescriptor*>(base_ +
+                                                  header_.ts_table_offset) +
+           (ts_pos & desc_mask_);
+  }
+
+  /// Retrieve the descriptor ring of a component.
+  [[nodiscard]] TimesliceComponentDescriptor*
+  desc_ring(uint32_t component) const {
+    return reinterpret_cast<TimesliceComponentDescriptor*>(
+               base_ + header_.desc_offset) +
+           (static_cast<uint64_t>(component) << header_.desc_size_exp);
+  }
+
+  /// Retrieve the data ring of a component.
+  [[nodiscard]] uint8_t* data_ring(uint32_t component) const {
+    if (data_table_ != nullptr) {
+      return base_ + data_table_[component].offset;
+    }
+    return base_ + header_.data_offset +
+           (static_cast<uint64_t>(component) << header_.data_size_exp);
+  }
+
+  /// Retrieve the 2's exponent of the data ring size of a component.
+  [[nodiscard]] uint32_t data_ring_size_exp(uint32_t component) const {
+    return data_table_ != nullptr ? data_table_[component].size_exp
+                                  : header_.data_size_exp;
+  }
+
+  /// Retrieve the descriptor of a component at a buffer position.
+  [[nodiscard]] TimesliceComponentDescriptor* desc(uint32_t component,
+                                                   uint64_t ts_pos) const {
+    return desc_ring(component) + (ts_pos & desc_mask_);
+  }
+
+  /// Check whether the segment has summary rings (version 4 and later).
+  [[nodiscard]] bool has_summaries() const {
+    return header_.summary_offset != 0;
+  }
+
+  /// Retrieve the summary ring of a component (nullptr if the segment has
+  /// none).
+  [[nodiscard]] ComponentSummary* summary_ring(uint32_t component) const {
+    if (!has_summaries()) {
+      return nullptr;
+    }
+    return reinterpret_cast<ComponentSummary*>(base_ +
+                                               header_.summary_offset) +
+           (static_cast<uint64_t>(component) << header_.desc_size_exp);
+  }
+
+  /// Retrieve the summary entry of a component at a buffer position
+  /// (nullptr if the segment has no summary rings).
+  [[nodiscard]] ComponentSummary* summary(uint32_t component,
+                                          uint64_t ts_pos) const {
+    ComponentSummary* ring = summary_ring(component);
+    return ring != nullptr ? ring + (ts_pos & desc_mask_) : nullptr;
+  }
+
+  /// Check whether the segment has status rings (version 2 and later).
+  [[nodiscard]] bool has_status() const { return header_.status_offset != 0; }
+
+  /// Mark the component of the timeslice at a buffer position as complete.
+  /** Requires status rings. Safe to call concurrently for different
+      components. */
+  void set_component_complete(uint32_t component, uint64_t ts_pos) const {
+    __atomic_store_n(status(component, ts_pos), ts_pos + 1, __ATOMIC_RELEASE);
+  }
+
+  /// Check whether the component of the timeslice at a buffer position is
+  /// complete.
+  [[nodiscard]] bool component_complete(uint32_t component,
+                                        uint64_t ts_pos) const {
+    return !has_status() || __atomic_load_n(status(component, ts_pos),
+                                            __ATOMIC_ACQUIRE) == ts_pos + 1;
+  }
+
+  /// Retrieve the data of a component given its descriptor.
+  [[nodiscard]] uint8_t* data(uint32_t component,
+                              const TimesliceComponentDescriptor& desc) const {
+    const uint64_t mask = (UINT64_C(1) << data_ring_size_exp(component)) - 1;
+    return data_ring(component) + (desc.offset & mask);
+  }
+
+private:
+  [[nodiscard]] uint64_t* status(uint32_t component, uint64_t ts_pos) const {
+    return reinterpret_cast<uint64_t*>(base_ + header_.status_offset) +
+           (static_cast<uint64_t>(component) << header_.desc_size_exp) +
+           (ts_pos & desc_mask_);
+  }
+
+  static uint64_t align(uint64_t offset, std::size_t alignment) {
+    return (offset + alignment - 1) & ~(static_cast<uint64_t>(alignment) - 1);
+  }
+
+  uint8_t* base_;
+  TimesliceShmHeader header_{};
+  uint64_t desc_mask_ = 0;
+  /// data ring table (since version 3)
+  const TimesliceShmDataRing* data_table_ = nullptr;
+};
+
+/// Encode a work item referring to a timeslice in a flat segment.
+inline void encode_flat_work_item(std::string& buffer,
+                                  const uint8_t* shm_uuid,
+                                  const std::string& shm_identifier,
+                                  uint64_t ts_pos) {
+  if (shm_identifier.size() > UINT16_MAX) {
+    throw std::invalid_argument("shared memory identifier too long");
+  }
+  TimesliceShmFlatItemHeader header{};
+  header.magic = TimesliceShmFlatItemHeader::magic_value;
+  header.version = TimesliceShmFlatItemHeader::current_version;
+  header.shm_identifier_size = static_cast<uint16_t>(shm_identifier.size());
+  std::memcpy(header.shm_uuid, shm_uuid, sizeof header.shm_uuid);
+  header.ts_pos = ts_pos;
+  buffer.resize(sizeof header + shm_identifier.size());
+  std::memcpy(buffer.data(), &header, sizeof header);
+  std::memcpy(buffer.data() + sizeof header, shm_identifier.data(),
+              shm_identifier.size());
+}
+
+/**
+ * \brief Non-owning view of a work item referring to a timeslice in a flat
+ * segment.
+ *
+ * The underlying buffer has to outlive the view.
+ */
+class TimesliceShmFlatItemView {
+public:
+  /// Check whether a payload is a flat work item.
+  static bool is_flat(std::string_view payload) {
+    uint32_t magic = 0;
+    if (payload.size() < sizeof magic) {
+      return false;
+    }
+    std::memcpy(&magic, payload.data(), sizeof magic);
+    return magic == TimesliceShmFlatItemHeader::magic_value;
+  }
+
+  /// Validate the encoded work item and construct the view.
+  explicit TimesliceShmFlatItemView(std::string_view payload)
+      : payload_(payload) {
+    if (payload_.size() < sizeof header_ || !is_flat(payload_)) {
+      throw std::runtime_error("invalid flat work item");
+    }
+    std::memcpy(&header_, payload_.data(), sizeof header_);
+    if (header_.version != TimesliceShmFlatItemHeader::current_version) {
+      throw std::runtime_error("unsupported flat work item version " +
+                               std::to_string(header_.version));
+    }
+    if (payload_.size() != sizeof header_ + header_.shm_identifier_size) {
+      throw std::runtime_error("invalid flat work item size");
+    }
+  }
+
+  /// The UUID of the segment (16 bytes)
+  [[nodiscard]] const uint8_t* shm_uuid() const { return header_.shm_uuid; }
+
+  /// The identifier string of the segment
+  [[nodiscard]] std::string_view shm_identifier() const {
+    return payload_.substr(sizeof header_, header_.shm_identifier_size);
+  }
+
+  /// The buffer position of the timeslice
+  [[nodiscard]] uint64_t ts_pos() const { return header_.ts_pos; }
+
+private:
+  std::string_view payload_;
+  TimesliceShmFlatItemHeader header_{};
+};
+
+} // namespace fles
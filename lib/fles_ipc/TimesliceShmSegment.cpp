@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "TimesliceShmSegment.hpp"
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace bi = boost::interprocess;
+
+namespace fles {
+
+namespace {
+
+// Create the shared memory object and map it read-write, initialized with
+// the header and the data ring table
+bi::mapped_region create_region(const std::string& identifier,
+                                const boost::uuids::uuid& shm_uuid,
+                                const std::vector<uint32_t>& data_size_exps,
+                                uint32_t desc_size_exp,
+                                std::size_t alignment) {
+  const std::size_t page_size = bi::mapped_region::get_page_size();
+  std::vector<TimesliceShmDataRing> data_table;
+  const TimesliceShmHeader header = TimesliceShmLayout::make_header(
+      shm_uuid.data, data_size_exps, desc_size_exp,
+      std::max(alignment, page_size), data_table);
+
+  bi::shared_memory_object::remove(identifier.c_str());
+  bi::shared_memory_object shm(bi::create_only, identifier.c_str(),
+                               bi::read_write);
+  shm.truncate(static_cast<bi::offset_t>(header.segment_size));
+  bi::mapped_region region(shm, bi::read_write);
+  auto* base = static_cast<uint8_t*>(region.get_address());
+  std::memcpy(base, &header, sizeof header);
+  std::memcpy(base + header.data_table_offset, data_table.data(),
+              data_table.size() * sizeof(TimesliceShmDataRing));
+  return region;
+}
+
+} // namespace
+
+TimesliceShmSegment::TimesliceShmSegment(bi::create_only_t /* tag */,
+                                         const std::string& identifier,
+                                         const boost::uuids::uuid& shm_uuid,
+                                         uint32_t num_components,
+                                         uint32_t data_size_exp,
+                                         uint32_t desc_size_exp,
+                                         std::size_t alignment)
+    : TimesliceShmSegment(bi::create_only,
+                          identifier,
+                          shm_uuid,
+                          std::vector<uint32_t>(num_components, data_size_exp),
+                          desc_size_exp,
+                          alignment) {}
+
+TimesliceShmSegment::TimesliceShmSegment(
+    bi::create_only_t /* tag */,
+    const std::string& identifier,
+    const boost::uuids::uuid& shm_uuid,
+    const std::vector<uint32_t>& data_size_exps,
+    uint32_t desc_size_exp,
+    std::size_t alignment)
+    : identifier_(identifier),
+      region_(create_region(
+          identifier, shm_uuid, data_size_exps, desc_size_exp, alignment)),
+      layout_(region_.get_address(), region_.get_size()) {}
+
+TimesliceShmSegment::TimesliceShmSegment(bi::open_read_only_t /* tag */,
+                                         const std::string& identifier)
+    : identifier_(identifier),
+      region_(bi::shared_memory_object(bi::open_only, identifier.c_str(),
+                                       bi::read_only),
+              bi::read_only),
+      layout_(region_.get_address(), region_.get_size()) {}
+
+} // namespace fles
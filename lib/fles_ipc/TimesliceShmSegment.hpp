@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::TimesliceShmSegment class.
+#pragma once
+
+#include "TimesliceShmLayout.hpp"
+#include <boost/interprocess/creation_tags.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/uuid/uuid.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace fles {
+
+/**
+ * \brief The TimesliceShmSegment class maps a shared memory timeslice buffer
+ * in the flat layout (see TimesliceShmHeader).
+ *
+ * Unlike a managed shared memory segment, the segment contains no
+ * allocator state or named objects, and all regions are at fixed offsets.
+ */
+class TimesliceShmSegment {
+public:
+  /**
+   * \brief Create a segment, replacing an existing one of the same name.
+   *
+   * The segment is mapped read-write and initialized with the header.
+   */
+  TimesliceShmSegment(boost::interprocess::create_only_t /* tag */,
+                      const std::string& identifier,
+                      const boost::uuids::uuid& shm_uuid,
+                      uint32_t num_components,
+                      uint32_t data_size_exp,
+                      uint32_t desc_size_exp,
+                      std::size_t alignment = 4096);
+
+  /**
+   * \brief Create a segment with data rings of individual sizes.
+   *
+   * \param data_size_exps 2's exponents of the data ring sizes, one per
+   *                       component
+   */
+  TimesliceShmSegment(boost::interprocess::create_only_t /* tag */,
+                      const std::string& identifier,
+                      const boost::uuids::uuid& shm_uuid,
+                      const std::vector<uint32_t>& data_size_exps,
+                      uint32_t desc_size_exp,
+                      std::size_t alignment = 4096);
+
+  /**
+   * \brief Open an existing segment read-only.
+   *
+   * \throws std::runtime_error if the segment is not in a supported version
+   * of the flat layout
+   */
+  TimesliceShmSegment(boost::interprocess::open_read_only_t /* tag */,
+                      const std::string& identifier);
+
+  /// Delete copy constructor (non-copyable).
+  TimesliceShmSegment(const TimesliceShmSegment&) = delete;
+  /// Delete assignment operator (non-copyable).
+  void operator=(const TimesliceShmSegment&) = delete;
+
+  /// Retrieve the layout of the mapped segment.
+  [[nodiscard]] const TimesliceShmLayout& layout() const { return layout_; }
+
+  /// Retrieve the identifier of the segment.
+  [[nodiscard]] const std::string& identifier() const { return identifier_; }
+
+private:
+  std::string identifier_;
+  boost::interprocess::mapped_region region_;
+  TimesliceShmLayout layout_;
+};
+
+} // namespace fles
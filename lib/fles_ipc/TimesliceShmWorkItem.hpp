@@ -1,6 +1,7 @@
 // Copyright 2020 Jan de Cuveland <cmail@cuveland.de>
 /// \file
-/// \brief Defines the fles::TimesliceShmWorkItem serializable struct.
+/// \brief Defines the fles::TimesliceShmWorkItem serializable struct and its
+/// binary wire format.
 #pragma once
 
 #include "TimesliceDescriptor.hpp"
@@ -12,7 +13,11 @@
 #include <boost/uuid/uuid_io.hpp>
 #include <boost/uuid/uuid_serialize.hpp>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace fles {
@@ -54,6 +59,148 @@ struct TimesliceShmWorkItem {
   }
 };
 
+/**
+ * \brief Fixed-layout header of the binary %TimesliceShmWorkItem encoding.
+ *
+ * The header is followed by the shared memory identifier (without
+ * terminating null character), the data block handles and the descriptor
+ * block handles (one int64_t per component each).
+ */
+struct TimesliceShmWorkItemHeader {
+  /// Magic number to tell the binary encoding from a boost archive ("TSWI")
+  static constexpr uint32_t magic_value = 0x49575354;
+  /// Current version of the binary encoding
+  static constexpr uint16_t current_version = 1;
+
+  uint32_t magic;               ///< Always magic_value
+  uint16_t version;             ///< Version of the encoding
+  uint16_t shm_identifier_size; ///< Length of the identifier string
+  uint8_t shm_uuid[16];         ///< UUID of the managed shared memory
+  TimesliceDescriptor ts_desc;  ///< The timeslice descriptor
+};
+
 #pragma pack()
 
+/// The encoding used to pass work items to the timeslice receivers.
+enum class WorkItemEncoding {
+  Binary, ///< Fixed-layout binary encoding (TimesliceShmWorkItemHeader)
+  Legacy, ///< Boost binary archive, for receivers of older versions
+  Flat    ///< Segment in the flat layout (TimesliceShmLayout), work items
+          ///< referring to the timeslice by its position only
+};
+
+/**
+ * \brief Encode a work item in the binary format.
+ *
+ * The buffer is overwritten and only reallocated if its capacity is
+ * insufficient.
+ */
+inline void encode_binary_work_item(std::string& buffer,
+                                    const boost::uuids::uuid& shm_uuid,
+                                    const std::string& shm_identifier,
+                                    const TimesliceDescriptor& ts_desc,
+                                    const std::ptrdiff_t* data,
+                                    const std::ptrdiff_t* desc) {
+  if (shm_identifier.size() > UINT16_MAX) {
+    throw std::invalid_argument("shared memory identifier too long");
+  }
+  TimesliceShmWorkItemHeader header{};
+  header.magic = TimesliceShmWorkItemHeader::magic_value;
+  header.version = TimesliceShmWorkItemHeader::current_version;
+  header.shm_identifier_size = static_cast<uint16_t>(shm_identifier.size());
+  std::memcpy(header.shm_uuid, shm_uuid.data, sizeof header.shm_uuid);
+  header.ts_desc = ts_desc;
+
+  const size_t handles_size = ts_desc.num_components * sizeof(int64_t);
+  buffer.resize(sizeof header + shm_identifier.size() + 2 * handles_size);
+  char* p = buffer.data();
+  std::memcpy(p, &header, sizeof header);
+  p += sizeof header;
+  std::memcpy(p, shm_identifier.data(), shm_identifier.size());
+  p += shm_identifier.size();
+  static_assert(sizeof(std::ptrdiff_t) == sizeof(int64_t));
+  std::memcpy(p, data, handles_size);
+  std::memcpy(p + handles_size, desc, handles_size);
+}
+
+/**
+ * \brief Non-owning, allocation-free view of a work item in the binary
+ * format.
+ *
+ * The underlying buffer has to outlive the view.
+ */
+class TimesliceShmWorkItemView {
+public:
+  /// Check whether a payload is in the binary format (and not a boost
+  /// archive).
+  static bool is_binary(std::string_view payload) {
+    uint32_t magic = 0;
+    if (payload.size() < sizeof magic) {
+      return false;
+    }
+    std::memcpy(&magic, payload.data(), sizeof magic);
+    return magic == TimesliceShmWorkItemHeader::magic_value;
+  }
+
+  /// Validate the encoded work item and construct the view.
+  explicit TimesliceShmWorkItemView(std::string_view payload)
+      : payload_(payload) {
+    if (payload_.size() < sizeof header_ || !is_binary(payload_)) {
+      throw std::runtime_error("invalid binary work item");
+    }
+    std::memcpy(&header_, payload_.data(), sizeof header_);
+    if (header_.version != TimesliceShmWorkItemHeader::current_version) {
+      throw std::runtime_error("unsupported binary work item version " +
+                               std::to_string(header_.version));
+    }
+    const size_t expected_size =
+        sizeof header_ + header_.shm_identifier_size +
+        2 * static_cast<size_t>(header_.ts_desc.num_components) *
+            sizeof(int64_t);
+    if (payload_.size() != expected_size) {
+      throw std::runtime_error("invalid binary work item size");
+    }
+  }
+
+  /// The UUID of the containing managed shared memory
+  [[nodiscard]] boost::uuids::uuid shm_uuid() const {
+    boost::uuids::uuid uuid{};
+    std::memcpy(uuid.data, header_.shm_uuid, sizeof header_.shm_uuid);
+    return uuid;
+  }
+
+  /// The identifier string of the containing managed shared memory
+  [[nodiscard]] std::string_view shm_identifier() const {
+    return payload_.substr(sizeof header_, header_.shm_identifier_size);
+  }
+
+  /// The timeslice descriptor
+  [[nodiscard]] const TimesliceDescriptor& ts_desc() const {
+    return header_.ts_desc;
+  }
+
+  /// The handle to the data block of a component
+  [[nodiscard]] std::ptrdiff_t data(size_t component) const {
+    return handle(component);
+  }
+
+  /// The handle to the tsc descriptor block of a component
+  [[nodiscard]] std::ptrdiff_t desc(size_t component) const {
+    return handle(header_.ts_desc.num_components + component);
+  }
+
+private:
+  [[nodiscard]] std::ptrdiff_t handle(size_t index) const {
+    std::ptrdiff_t value = 0;
+    std::memcpy(&value,
+                payload_.data() + sizeof header_ +
+                    header_.shm_identifier_size + index * sizeof(int64_t),
+                sizeof value);
+    return value;
+  }
+
+  std::string_view payload_;
+  TimesliceShmWorkItemHeader header_{};
+};
+
 } // namespace fles
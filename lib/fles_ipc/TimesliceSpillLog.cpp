@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "TimesliceSpillLog.hpp"
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace fles {
+
+TimesliceSpillRecord::TimesliceSpillRecord(const std::string& path,
+                                           uint64_t offset,
+                                           uint64_t size) {
+  if (size < sizeof header_) {
+    throw std::runtime_error("invalid spill record size");
+  }
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::runtime_error("cannot open spill log \"" + path +
+                             "\": " + std::strerror(errno));
+  }
+  data_.resize(size);
+  std::size_t done = 0;
+  while (done < size) {
+    ssize_t result = ::pread(fd, data_.data() + done, size - done,
+                             static_cast<off_t>(offset + done));
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    if (result <= 0) {
+      break;
+    }
+    done += static_cast<std::size_t>(result);
+  }
+  ::close(fd);
+  if (done != size) {
+    throw std::runtime_error("cannot read spill record from \"" + path + "\"");
+  }
+
+  std::memcpy(&header_, data_.data(), sizeof header_);
+  if (header_.magic != TimesliceSpillRecordHeader::magic_value ||
+      header_.version != TimesliceSpillRecordHeader::current_version ||
+      header_.size != size ||
+      data_offset(header_.num_components) > size ||
+      header_.ts_desc.num_components != header_.num_components) {
+    throw std::runtime_error("invalid spill record in \"" + path + "\"");
+  }
+  for (uint32_t c = 0; c < header_.num_components; ++c) {
+    const auto* component = desc(c);
+    if (component->offset < data_offset(header_.num_components) ||
+        component->offset + component->size > size) {
+      throw std::runtime_error("invalid spill record in \"" + path + "\"");
+    }
+  }
+}
+
+} // namespace fles
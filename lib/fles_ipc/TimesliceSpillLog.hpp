@@ -0,0 +1,183 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the timeslice spill log format (fles::TimesliceSpillRecord)
+/// and its work items.
+#pragma once
+
+#include "TimesliceComponentDescriptor.hpp"
+#include "TimesliceDescriptor.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fles {
+
+#pragma pack(1)
+
+/**
+ * \brief Header of a timeslice record in a spill log file.
+ *
+ * A compute node spills timeslices from its shared memory buffer to a log
+ * file on local storage while its consumers fall behind. Each record starts
+ * at a multiple of record_alignment and consists of this header, the
+ * TimesliceComponentDescriptor of each component, and the data of each
+ * component (microslice descriptors followed by microslice contents). The
+ * offset of a component descriptor gives the position of the component
+ * data relative to the start of the record. All values are unpadded and in
+ * host byte order.
+ */
+struct TimesliceSpillRecordHeader {
+  /// Magic number identifying a record ("FLESTSSP")
+  static constexpr uint64_t magic_value = 0x5053535453454c46;
+  /// Current version of the record format
+  static constexpr uint32_t current_version = 1;
+  /// Alignment of the records in the file (the direct I/O block size)
+  static constexpr std::size_t record_alignment = 4096;
+
+  uint64_t magic;              ///< Always magic_value
+  uint32_t version;            ///< Version of the record format
+  uint32_t num_components;     ///< Number of components
+  uint64_t size;               ///< Size of the record without padding
+  TimesliceDescriptor ts_desc; ///< Descriptor of the timeslice
+};
+
+/**
+ * \brief Header of a work item referring to a timeslice in a spill log file.
+ *
+ * The header is followed by the path of the file (without terminating null
+ * character).
+ */
+struct TimesliceSpillItemHeader {
+  /// Magic number to tell the spill work item from other encodings ("TSWP")
+  static constexpr uint32_t magic_value = 0x50575354;
+  /// Current version of the work item encoding
+  static constexpr uint16_t current_version = 1;
+
+  uint32_t magic;     ///< Always magic_value
+  uint16_t version;   ///< Version of the encoding
+  uint16_t path_size; ///< Length of the path string
+  uint64_t offset;    ///< Offset of the record in the file
+  uint64_t size;      ///< Size of the record without padding
+};
+
+#pragma pack()
+
+static_assert(sizeof(TimesliceSpillRecordHeader) == 48);
+
+/// Encode a work item referring to a timeslice in a spill log file.
+inline void encode_spill_work_item(std::string& buffer,
+                                   const std::string& path,
+                                   uint64_t offset,
+                                   uint64_t size) {
+  if (path.size() > UINT16_MAX) {
+    throw std::invalid_argument("spill log path too long");
+  }
+  TimesliceSpillItemHeader header{};
+  header.magic = TimesliceSpillItemHeader::magic_value;
+  header.version = TimesliceSpillItemHeader::current_version;
+  header.path_size = static_cast<uint16_t>(path.size());
+  header.offset = offset;
+  header.size = size;
+  buffer.resize(sizeof header + path.size());
+  std::memcpy(buffer.data(), &header, sizeof header);
+  std::memcpy(buffer.data() + sizeof header, path.data(), path.size());
+}
+
+/**
+ * \brief Non-owning view of a work item referring to a timeslice in a spill
+ * log file.
+ *
+ * The underlying buffer has to outlive the view.
+ */
+class TimesliceSpillItemView {
+public:
+  /// Check whether a payload is a spill work item.
+  static bool is_spill(std::string_view payload) {
+    uint32_t magic = 0;
+    if (payload.size() < sizeof magic) {
+      return false;
+    }
+    std::memcpy(&magic, payload.data(), sizeof magic);
+    return magic == TimesliceSpillItemHeader::magic_value;
+  }
+
+  /// Validate the encoded work item and construct the view.
+  explicit TimesliceSpillItemView(std::string_view payload)
+      : payload_(payload) {
+    if (payload_.size() < sizeof header_ || !is_spill(payload_)) {
+      throw std::runtime_error("invalid spill work item");
+    }
+    std::memcpy(&header_, payload_.data(), sizeof header_);
+    if (header_.version != TimesliceSpillItemHeader::current_version) {
+      throw std::runtime_error("unsupported spill work item version " +
+                               std::to_string(header_.version));
+    }
+    if (payload_.size() != sizeof header_ + header_.path_size) {
+      throw std::runtime_error("invalid spill work item size");
+    }
+  }
+
+  /// The path of the spill log file
+  [[nodiscard]] std::string_view path() const {
+    return payload_.substr(sizeof header_, header_.path_size);
+  }
+
+  /// The offset of the record in the file
+  [[nodiscard]] uint64_t offset() const { return header_.offset; }
+
+  /// The size of the record
+  [[nodiscard]] uint64_t size() const { return header_.size; }
+
+private:
+  std::string_view payload_;
+  TimesliceSpillItemHeader header_{};
+};
+
+/**
+ * \brief The TimesliceSpillRecord class holds a timeslice record read from
+ * a spill log file (see TimesliceSpillRecordHeader).
+ */
+class TimesliceSpillRecord {
+public:
+  /// Retrieve the offset of the component data of a record with the given
+  /// number of components.
+  static uint64_t data_offset(uint32_t num_components) {
+    return sizeof(TimesliceSpillRecordHeader) +
+           uint64_t{num_components} * sizeof(TimesliceComponentDescriptor);
+  }
+
+  /// Read and validate a record.
+  /**
+     \throws std::runtime_error if the file cannot be read or does not hold
+     a valid record at the offset
+   */
+  TimesliceSpillRecord(const std::string& path, uint64_t offset, uint64_t size);
+
+  /// Retrieve the descriptor of the timeslice.
+  [[nodiscard]] const TimesliceDescriptor& ts_desc() const {
+    return header_.ts_desc;
+  }
+
+  /// Retrieve the descriptor of a component.
+  [[nodiscard]] TimesliceComponentDescriptor* desc(uint32_t component) {
+    return reinterpret_cast<TimesliceComponentDescriptor*>(
+               data_.data() + sizeof(TimesliceSpillRecordHeader)) +
+           component;
+  }
+
+  /// Retrieve the data of a component.
+  [[nodiscard]] uint8_t* data(uint32_t component) {
+    return data_.data() + desc(component)->offset;
+  }
+
+private:
+  std::vector<uint8_t> data_;
+  TimesliceSpillRecordHeader header_{};
+};
+
+} // namespace fles
@@ -1,23 +1,58 @@
 // Copyright 2014 Jan de Cuveland <cmail@cuveland.de>
 
 #include "TimesliceSubscriber.hpp"
+#include "TimesliceMessageView.hpp"
+#include <utility>
+#include <vector>
 
 namespace fles {
 
 TimesliceSubscriber::TimesliceSubscriber(const std::string& address,
-                                         uint32_t hwm) {
+                                         uint32_t hwm,
+                                         ComponentFilter filter)
+    : filter_(std::move(filter)) {
   subscriber_.set(zmq::sockopt::rcvhwm, int(hwm));
   subscriber_.connect(address.c_str());
   subscriber_.set(zmq::sockopt::subscribe, "");
 }
 
-fles::StorableTimeslice* TimesliceSubscriber::do_get() {
+fles::Timeslice* TimesliceSubscriber::do_get() {
   if (eos_flag) {
     return nullptr;
   }
+  auto* timeslice = receive(subscriber_, filter_);
+  if (timeslice == nullptr) {
+    eos_flag = true;
+  }
+  return timeslice;
+}
+
+fles::Timeslice* TimesliceSubscriber::do_try_get() {
+  if (eos_flag ||
+      (subscriber_.get(zmq::sockopt::events) & ZMQ_POLLIN) == 0) {
+    return nullptr;
+  }
+  return do_get();
+}
 
+fles::Timeslice* TimesliceSubscriber::receive(zmq::socket_t& socket,
+                                              const ComponentFilter& filter) {
   zmq::message_t message;
-  [[maybe_unused]] auto result = subscriber_.recv(message);
+  [[maybe_unused]] auto result = socket.recv(message);
+
+  if (TimesliceMessageView::is_header(message)) {
+    std::vector<zmq::message_t> frames;
+    bool more = message.more();
+    frames.push_back(std::move(message));
+    while (more) {
+      frames.emplace_back();
+      result = socket.recv(frames.back());
+      more = frames.back().more();
+    }
+    auto* view = new TimesliceMessageView(std::move(frames)); // NOLINT
+    view->select_components(filter);
+    return view;
+  }
 
   boost::iostreams::basic_array_source<char> device(
       static_cast<char*>(message.data()), message.size());
@@ -31,9 +66,9 @@ fles::StorableTimeslice* TimesliceSubscriber::do_get() {
     ia >> *sts;
   } catch (boost::archive::archive_exception& e) {
     delete sts; // NOLINT
-    eos_flag = true;
     return nullptr;
   }
+  sts->select_components(filter);
   return sts;
 }
 
@@ -3,6 +3,7 @@
 /// \brief Defines the fles::TimesliceSubscriber class.
 #pragma once
 
+#include "PollableSource.hpp"
 #include "StorableTimeslice.hpp"
 #include "TimesliceSource.hpp"
 #include <boost/archive/binary_iarchive.hpp>
@@ -15,11 +16,23 @@ namespace fles {
 /**
  * \brief The TimesliceSubscriber class receives serialized timeslice data sets
  * from a zeromq socket.
+ *
+ * Timeslices sent by a TimeslicePublisher in zero-copy mode are detected
+ * automatically and returned as TimesliceMessageView objects pointing into
+ * the received message frames, without deserialization or copy. All other
+ * messages are deserialized into StorableTimeslice objects. Components not
+ * selected by the given filter are omitted from the returned timeslices.
+ *
+ * The subscriber is pollable through the (edge-triggered) file descriptor of
+ * the ZMQ socket, so that many subscribers can share a thread (see
+ * SourceMultiplexer).
  */
-class TimesliceSubscriber : public TimesliceSource {
+class TimesliceSubscriber : public PollableSource<Timeslice> {
 public:
   /// Construct timeslice subscriber receiving from given ZMQ address.
-  explicit TimesliceSubscriber(const std::string& address, uint32_t hwm);
+  explicit TimesliceSubscriber(const std::string& address,
+                               uint32_t hwm,
+                               ComponentFilter filter = {});
 
   /// Delete copy constructor (non-copyable).
   TimesliceSubscriber(const TimesliceSubscriber&) = delete;
@@ -35,18 +48,37 @@ public:
    *
    * \return pointer to the item, or nullptr if end-of-file
    */
-  std::unique_ptr<StorableTimeslice> get() {
-    return std::unique_ptr<StorableTimeslice>(do_get());
+  std::unique_ptr<Timeslice> get() {
+    return std::unique_ptr<Timeslice>(do_get());
   };
 
   [[nodiscard]] bool eos() const override { return eos_flag; }
 
+  [[nodiscard]] int poll_fd() override {
+    return subscriber_.get(zmq::sockopt::fd);
+  }
+
+  /**
+   * \brief Receive a timeslice from a SUB socket.
+   *
+   * This function blocks until a message is available.
+   *
+   * \return pointer to the timeslice, or nullptr if the message is not a
+   * valid timeslice (end-of-stream)
+   */
+  static Timeslice* receive(zmq::socket_t& socket,
+                            const ComponentFilter& filter);
+
 private:
-  StorableTimeslice* do_get() override;
+  Timeslice* do_get() override;
+
+  Timeslice* do_try_get() override;
 
   zmq::context_t context_{1};
   zmq::socket_t subscriber_{context_, ZMQ_SUB};
 
+  ComponentFilter filter_;
+
   bool eos_flag = false;
 };
 
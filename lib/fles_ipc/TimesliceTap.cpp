@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "TimesliceTap.hpp"
+#include "Timeslice.hpp"
+#include <stdexcept>
+#include <utility>
+
+namespace fles {
+
+bool TapParameters::parse(const std::string& key, const std::string& value) {
+  if (key == "stride") {
+    stride = std::stoull(value);
+  } else if (key == "offset") {
+    offset = std::stoull(value);
+  } else if (key == "rate") {
+    max_rate = std::stod(value);
+  } else {
+    return parse_filter_parameter(key, value, filter);
+  }
+  return true;
+}
+
+class TimesliceTap::Selection : public Timeslice {
+public:
+  Selection(std::shared_ptr<const Timeslice> timeslice,
+            const ComponentFilter& filter)
+      : timeslice_(std::move(timeslice)) {
+    timeslice_descriptor_ = timeslice_->timeslice_descriptor_;
+    timeslice_->materialize();
+    data_ptr_ = timeslice_->data_ptr_;
+    desc_ptr_ = timeslice_->desc_ptr_;
+    summary_ptr_ = timeslice_->summary_ptr_;
+    select_components(filter);
+  }
+
+private:
+  std::shared_ptr<const Timeslice> timeslice_;
+};
+
+TimesliceTap::TimesliceTap(std::unique_ptr<TimesliceSink> sink,
+                           TapParameters parameters)
+    : sink_(std::move(sink)), parameters_(std::move(parameters)) {
+  if (parameters_.stride == 0 || parameters_.offset >= parameters_.stride) {
+    throw std::invalid_argument("invalid tap stride or offset");
+  }
+  if (parameters_.max_rate > 0) {
+    min_interval_ = std::chrono::duration_cast<
+        std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / parameters_.max_rate));
+  }
+}
+
+void TimesliceTap::put(std::shared_ptr<const Timeslice> timeslice) {
+  if (!selects(timeslice->index())) {
+    ++discarded_;
+    return;
+  }
+  ++passed_;
+  if (parameters_.filter.all()) {
+    sink_->put(std::move(timeslice));
+  } else {
+    sink_->put(std::make_shared<const Selection>(std::move(timeslice),
+                                                 parameters_.filter));
+  }
+}
+
+bool TimesliceTap::selects(uint64_t index) {
+  if (index % parameters_.stride != parameters_.offset) {
+    return false;
+  }
+  if (parameters_.max_rate > 0) {
+    const auto now = std::chrono::steady_clock::now();
+    if (last_time_.has_value() && *last_time_ + min_interval_ > now) {
+      return false;
+    }
+    last_time_ = now;
+  }
+  return true;
+}
+
+} // namespace fles
@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::TimesliceTap class.
+#pragma once
+
+#include "ComponentFilter.hpp"
+#include "Sink.hpp"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace fles {
+
+/// Selection of the timeslices and components passed on by a TimesliceTap.
+struct TapParameters {
+  /// Pass on every timeslice with index n = m * stride + offset.
+  uint64_t stride = 1;
+  uint64_t offset = 0;
+
+  /// Maximum number of timeslices per second (0: unlimited).
+  double max_rate = 0;
+
+  /// Selection of components to pass on.
+  ComponentFilter filter;
+
+  /// Check whether the parameters select all timeslices and components.
+  [[nodiscard]] bool all() const {
+    return stride == 1 && max_rate <= 0 && filter.all();
+  }
+
+  /**
+   * \brief Parse a tap parameter of a URI query.
+   *
+   * The keys are "stride", "offset", "rate" (maximum number of timeslices
+   * per second), and the component selection keys (see
+   * parse_filter_parameter()).
+   *
+   * \return false if the key does not denote a tap parameter
+   */
+  bool parse(const std::string& key, const std::string& value);
+};
+
+/**
+ * \brief The TimesliceTap class passes a downscaled stream of timeslices to
+ * a sink, e.g., a TimeslicePublisher or ManagedTimesliceBuffer serving
+ * monitoring clients.
+ *
+ * Unselected timeslices are discarded before they reach the sink, so they
+ * are neither queued, serialized, nor copied. If components are selected,
+ * the sink receives a view of the selected components of the original
+ * timeslice, which it keeps alive; the component data is not copied.
+ */
+class TimesliceTap : public TimesliceSink {
+public:
+  /// Construct a tap passing the selected timeslices to the given sink.
+  TimesliceTap(std::unique_ptr<TimesliceSink> sink, TapParameters parameters);
+
+  void put(std::shared_ptr<const Timeslice> timeslice) override;
+
+  void end_stream() override { sink_->end_stream(); }
+
+  /// Retrieve the wrapped sink.
+  TimesliceSink& sink() { return *sink_; }
+
+  /// Retrieve the number of timeslices passed on to the sink.
+  [[nodiscard]] uint64_t passed() const { return passed_; }
+
+  /// Retrieve the number of discarded timeslices.
+  [[nodiscard]] uint64_t discarded() const { return discarded_; }
+
+private:
+  /// View of the selected components of a timeslice.
+  class Selection;
+
+  std::unique_ptr<TimesliceSink> sink_;
+  TapParameters parameters_;
+  std::chrono::steady_clock::duration min_interval_{};
+  std::optional<std::chrono::steady_clock::time_point> last_time_;
+  uint64_t passed_ = 0;
+  uint64_t discarded_ = 0;
+
+  [[nodiscard]] bool selects(uint64_t index);
+};
+
+} // namespace fles
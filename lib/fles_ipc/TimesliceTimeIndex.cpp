@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "TimesliceTimeIndex.hpp"
+#include "Timeslice.hpp"
+#include <algorithm>
+#include <numeric>
+
+namespace fles {
+
+namespace {
+
+// heap order: earliest start time first, then lowest component
+template <typename Head> bool later(const Head& a, const Head& b) {
+  return a.time != b.time ? a.time > b.time : a.component > b.component;
+}
+
+} // namespace
+
+TimesliceTimeIndex::TimesliceTimeIndex(const Timeslice& ts)
+    : components_(ts.num_components()) {
+  for (uint64_t c = 0; c < ts.num_components(); ++c) {
+    const ComponentView component = ts.component(c);
+    const MicrosliceDescriptor* desc = component.descriptors();
+    const uint64_t n = component.size();
+    Component& index = components_[c];
+
+    index.start.resize(n);
+    for (uint64_t m = 0; m < n; ++m) {
+      index.start[m] = desc[m].idx;
+    }
+    if (std::is_sorted(index.start.begin(), index.start.end())) {
+      continue;
+    }
+    index.order.resize(n);
+    std::iota(index.order.begin(), index.order.end(), 0);
+    std::stable_sort(index.order.begin(), index.order.end(),
+                     [desc](uint32_t a, uint32_t b) {
+                       return desc[a].idx < desc[b].idx;
+                     });
+    for (uint64_t p = 0; p < n; ++p) {
+      index.start[p] = desc[index.order[p]].idx;
+    }
+  }
+}
+
+uint64_t TimesliceTimeIndex::end_time(uint64_t component,
+                                      uint64_t position) const {
+  const auto& start = components_[component].start;
+  if (position + 1 < start.size()) {
+    return start[position + 1];
+  }
+  if (position == 0) {
+    return start[position];
+  }
+  return start[position] + (start[position] - start[position - 1]);
+}
+
+TimesliceTimeIndex::Range
+TimesliceTimeIndex::find(uint64_t component, uint64_t t0, uint64_t t1) const {
+  const auto& start = components_[component].start;
+  auto first = std::lower_bound(start.begin(), start.end(), t0);
+  Range range;
+  range.begin = static_cast<uint64_t>(first - start.begin());
+  // the last microslice starting before the window may extend into it
+  if (range.begin > 0 && end_time(component, range.begin - 1) > t0) {
+    --range.begin;
+  }
+  if (t1 <= t0) {
+    range.end = range.begin;
+    return range;
+  }
+  range.end = static_cast<uint64_t>(
+      std::lower_bound(first, start.end(), t1) - start.begin());
+  return range;
+}
+
+TimeWindowMerge::TimeWindowMerge(const TimesliceTimeIndex& index,
+                                 uint64_t t0,
+                                 uint64_t t1)
+    : index_(index) {
+  for (uint64_t c = 0; c < index.num_components(); ++c) {
+    const auto range = index.find(c, t0, t1);
+    if (!range.empty()) {
+      heap_.push_back({index.time(c, range.begin), c, range.begin, range.end});
+    }
+  }
+  std::make_heap(heap_.begin(), heap_.end(), later<Head>);
+}
+
+bool TimeWindowMerge::next() {
+  if (heap_.empty()) {
+    return false;
+  }
+  std::pop_heap(heap_.begin(), heap_.end(), later<Head>);
+  Head& head = heap_.back();
+  current_ = {head.time, head.component,
+              index_.microslice(head.component, head.position)};
+  if (++head.position < head.end) {
+    head.time = index_.time(head.component, head.position);
+    std::push_heap(heap_.begin(), heap_.end(), later<Head>);
+  } else {
+    heap_.pop_back();
+  }
+  return true;
+}
+
+} // namespace fles
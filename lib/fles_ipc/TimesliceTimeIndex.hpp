@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::TimesliceTimeIndex class.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace fles {
+
+class Timeslice;
+
+/// A microslice located by a time window query.
+struct TimedMicroslice {
+  /// Start time of the microslice (MicrosliceDescriptor::idx).
+  uint64_t time;
+  /// Component of the microslice in the timeslice.
+  uint64_t component;
+  /// Index of the microslice in the component.
+  uint64_t microslice;
+};
+
+/**
+ * \brief The TimesliceTimeIndex class locates the microslices of a timeslice
+ * by time.
+ *
+ * The start times (MicrosliceDescriptor::idx) of each component are read
+ * once into a contiguous sorted array, so that a time window query costs a
+ * binary search per component instead of a scan of all descriptors. A
+ * microslice is taken to last until the start of the next microslice of the
+ * component, and the last one as long as its predecessor (a component with a
+ * single microslice marks an instant). The microslices of a component with
+ * start times out of order are sorted, so query results are given as
+ * time-ordered positions, which microslice() maps to the microslice indices.
+ *
+ * The index refers to the timeslice by component and microslice numbers
+ * only. Use Timeslice::time_index(), which builds it on first use and caches
+ * it with the timeslice.
+ */
+class TimesliceTimeIndex {
+public:
+  /// A range [begin, end) of time-ordered positions in a component.
+  struct Range {
+    uint64_t begin = 0;
+    uint64_t end = 0;
+
+    [[nodiscard]] bool empty() const { return begin == end; }
+    [[nodiscard]] uint64_t size() const { return end - begin; }
+  };
+
+  /// Build the index of a timeslice.
+  explicit TimesliceTimeIndex(const Timeslice& ts);
+
+  /// Retrieve the number of components.
+  [[nodiscard]] uint64_t num_components() const { return components_.size(); }
+
+  /// Retrieve the number of microslices of a component.
+  [[nodiscard]] uint64_t size(uint64_t component) const {
+    return components_[component].start.size();
+  }
+
+  /// Retrieve the positions of the microslices of a component overlapping
+  /// the time window [t0, t1).
+  [[nodiscard]] Range find(uint64_t component, uint64_t t0, uint64_t t1) const;
+
+  /// Retrieve the start time of the microslice at a position.
+  [[nodiscard]] uint64_t time(uint64_t component, uint64_t position) const {
+    return components_[component].start[position];
+  }
+
+  /// Retrieve the end time of the microslice at a position.
+  [[nodiscard]] uint64_t end_time(uint64_t component, uint64_t position) const;
+
+  /// Retrieve the index in the component of the microslice at a position.
+  [[nodiscard]] uint64_t microslice(uint64_t component,
+                                    uint64_t position) const {
+    const auto& order = components_[component].order;
+    return order.empty() ? position : order[position];
+  }
+
+private:
+  struct Component {
+    /// Sorted start times.
+    std::vector<uint64_t> start;
+    /// Microslice index at each position, empty if in order.
+    std::vector<uint32_t> order;
+  };
+
+  std::vector<Component> components_;
+};
+
+/**
+ * \brief The TimeWindowMerge class iterates the microslices of all
+ * components overlapping a time window in the order of their start times.
+ *
+ * The time-ordered ranges of the components (see TimesliceTimeIndex::find())
+ * are merged through a heap, which takes O(log k) per microslice for k
+ * components with microslices in the window. Microslices starting at the
+ * same time are ordered by component. The index has to outlive the merge.
+ */
+class TimeWindowMerge {
+public:
+  /// Single-pass iterator over the merged microslices.
+  class iterator {
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = TimedMicroslice;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const TimedMicroslice*;
+    using reference = const TimedMicroslice&;
+
+    iterator() = default;
+
+    const TimedMicroslice& operator*() const { return merge_->current_; }
+    const TimedMicroslice* operator->() const { return &merge_->current_; }
+
+    iterator& operator++() {
+      if (!merge_->next()) {
+        merge_ = nullptr;
+      }
+      return *this;
+    }
+
+    friend bool operator==(const iterator& a, const iterator& b) {
+      return a.merge_ == b.merge_;
+    }
+    friend bool operator!=(const iterator& a, const iterator& b) {
+      return a.merge_ != b.merge_;
+    }
+
+  private:
+    friend class TimeWindowMerge;
+
+    explicit iterator(TimeWindowMerge* merge) : merge_(merge) {}
+
+    TimeWindowMerge* merge_ = nullptr;
+  };
+
+  /// Prepare the merge of the microslices overlapping [t0, t1).
+  TimeWindowMerge(const TimesliceTimeIndex& index, uint64_t t0, uint64_t t1);
+
+  /// Advance to the next microslice, return false at the end.
+  bool next();
+
+  /// Retrieve the current microslice (valid after next() returned true).
+  [[nodiscard]] const TimedMicroslice& current() const { return current_; }
+
+  /// Start the iteration (advances to the first microslice).
+  iterator begin() { return iterator(next() ? this : nullptr); }
+
+  iterator end() { return iterator(); }
+
+private:
+  struct Head {
+    uint64_t time;
+    uint64_t component;
+    uint64_t position;
+    uint64_t end;
+  };
+
+  const TimesliceTimeIndex& index_;
+  std::vector<Head> heap_;
+  TimedMicroslice current_{};
+};
+
+} // namespace fles
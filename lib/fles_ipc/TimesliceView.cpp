@@ -8,10 +8,11 @@ namespace fles {
 
 TimesliceView::TimesliceView(
     std::shared_ptr<boost::interprocess::managed_shared_memory> managed_shm,
+    std::shared_ptr<DeviceMemory> data_device,
     std::shared_ptr<const Item> work_item,
     const TimesliceShmWorkItem& timeslice_item)
-    : managed_shm_(std::move(managed_shm)), work_item_(std::move(work_item)),
-      timeslice_item_(timeslice_item) {
+    : managed_shm_(std::move(managed_shm)),
+      data_device_(std::move(data_device)), work_item_(std::move(work_item)) {
 
   timeslice_descriptor_ = timeslice_item.ts_desc;
 
@@ -21,12 +22,123 @@ TimesliceView::TimesliceView(
 
   for (size_t c = 0; c < num_components(); ++c) {
     desc_ptr_[c] = reinterpret_cast<fles::TimesliceComponentDescriptor*>(
-        managed_shm_->get_address_from_handle(timeslice_item_.desc[c]));
-    data_ptr_[c] = static_cast<uint8_t*>(
-        managed_shm_->get_address_from_handle(timeslice_item_.data[c]));
+        managed_shm_->get_address_from_handle(timeslice_item.desc[c]));
+    data_ptr_[c] = data_address(timeslice_item.data[c]);
   }
 
-  // consistency check
+  check_consistency();
+}
+
+TimesliceView::TimesliceView(
+    std::shared_ptr<boost::interprocess::managed_shared_memory> managed_shm,
+    std::shared_ptr<DeviceMemory> data_device,
+    std::shared_ptr<const Item> work_item,
+    const TimesliceShmWorkItemView& timeslice_item)
+    : managed_shm_(std::move(managed_shm)),
+      data_device_(std::move(data_device)), work_item_(std::move(work_item)) {
+
+  timeslice_descriptor_ = timeslice_item.ts_desc();
+
+  // initialize access pointer vectors
+  data_ptr_.resize(num_components());
+  desc_ptr_.resize(num_components());
+
+  for (size_t c = 0; c < num_components(); ++c) {
+    desc_ptr_[c] = reinterpret_cast<fles::TimesliceComponentDescriptor*>(
+        managed_shm_->get_address_from_handle(timeslice_item.desc(c)));
+    data_ptr_[c] = data_address(timeslice_item.data(c));
+  }
+
+  check_consistency();
+}
+
+TimesliceView::TimesliceView(
+    std::shared_ptr<const TimesliceShmSegment> segment,
+    std::shared_ptr<const Item> work_item,
+    uint64_t ts_pos)
+    : segment_(std::move(segment)), work_item_(std::move(work_item)),
+      ts_pos_(ts_pos) {
+  const TimesliceShmLayout& layout = segment_->layout();
+  timeslice_descriptor_ = *layout.ts_desc(ts_pos);
+
+  // initialize access pointer vectors
+  data_ptr_.resize(num_components());
+  desc_ptr_.resize(num_components());
+
+  if (layout.has_summaries()) {
+    summary_ptr_.resize(num_components());
+  }
+
+  // the data of components not yet complete is located once they are
+  for (uint32_t c = 0; c < num_components(); ++c) {
+    desc_ptr_[c] = layout.desc(c, ts_pos);
+    if (layout.has_summaries()) {
+      summary_ptr_[c] = layout.summary(c, ts_pos);
+    }
+    if (layout.component_complete(c, ts_pos)) {
+      data_ptr_[c] = layout.data(c, *desc_ptr_[c]);
+    } else {
+      data_ptr_[c] = nullptr;
+      ++pending_;
+    }
+  }
+
+  if (pending_ == 0) {
+    check_consistency();
+  }
+}
+
+TimesliceView::TimesliceView(
+    std::shared_ptr<TimesliceSpillRecord> spill_record,
+    std::shared_ptr<const Item> work_item)
+    : work_item_(std::move(work_item)),
+      spill_record_(std::move(spill_record)) {
+  timeslice_descriptor_ = spill_record_->ts_desc();
+
+  // initialize access pointer vectors
+  data_ptr_.resize(num_components());
+  desc_ptr_.resize(num_components());
+
+  for (uint32_t c = 0; c < num_components(); ++c) {
+    desc_ptr_[c] = spill_record_->desc(c);
+    data_ptr_[c] = spill_record_->data(c);
+  }
+
+  check_consistency();
+}
+
+bool TimesliceView::component_complete(uint64_t component) {
+  if (data_ptr_[component] != nullptr) {
+    return true;
+  }
+  const TimesliceShmLayout& layout = segment_->layout();
+  const auto c = static_cast<uint32_t>(component);
+  if (!layout.component_complete(c, ts_pos_)) {
+    return false;
+  }
+  data_ptr_[component] = layout.data(c, *desc_ptr_[component]);
+  if (--pending_ == 0) {
+    check_consistency();
+  }
+  return true;
+}
+
+bool TimesliceView::complete() {
+  for (uint64_t c = 0; pending_ != 0 && c < num_components(); ++c) {
+    (void)component_complete(c);
+  }
+  return pending_ == 0;
+}
+
+uint8_t* TimesliceView::data_address(std::ptrdiff_t handle) const {
+  // with data on a GPU, the handle is the offset in the device memory
+  if (data_device_) {
+    return data_device_->ptr() + handle;
+  }
+  return static_cast<uint8_t*>(managed_shm_->get_address_from_handle(handle));
+}
+
+void TimesliceView::check_consistency() const {
   for (size_t c = 1; c < num_components(); ++c) {
     if (timeslice_descriptor_.index != desc_ptr_[c]->ts_num) {
       std::cerr << "TimesliceView consistency check failed: index="
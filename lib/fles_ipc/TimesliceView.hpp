@@ -3,9 +3,12 @@
 /// \brief Defines the fles::TimesliceView class.
 #pragma once
 
+#include "DeviceMemory.hpp"
 #include "ItemWorkerProtocol.hpp"
 #include "Timeslice.hpp"
+#include "TimesliceShmSegment.hpp"
 #include "TimesliceShmWorkItem.hpp"
+#include "TimesliceSpillLog.hpp"
 #include <boost/interprocess/managed_shared_memory.hpp>
 #include <memory>
 
@@ -24,18 +27,79 @@ public:
 
   ~TimesliceView() override = default;
 
+  /// Retrieve the GPU device holding the component data, or -1 if the data
+  /// is in host memory.
+  /**
+   * If the data is on a GPU, it includes the microslice descriptors and is
+   * not accessible from the host. Only the timeslice and timeslice
+   * component properties can then be used on the host, and the component
+   * data is to be accessed through component_data().
+   */
+  [[nodiscard]] int data_device() const {
+    return data_device_ ? data_device_->device() : -1;
+  }
+
+  /// Retrieve the pointer to the data of a component.
+  /**
+   * The data consists of the microslice descriptors followed by the
+   * microslice contents, size_component() bytes in total.
+   */
+  [[nodiscard]] const uint8_t* component_data(uint64_t component) const {
+    return data_ptr_[component];
+  }
+
+  /// Check whether the data of a component is complete.
+  /**
+   * With partial delivery by the producer (see
+   * TimesliceReceiver::set_partial_delivery()), the view may be handed on
+   * before all components are complete. The properties and data of a
+   * component must then only be accessed once this returned true. All
+   * components of other views are complete.
+   */
+  [[nodiscard]] bool component_complete(uint64_t component);
+
+  /// Check whether all components are complete.
+  [[nodiscard]] bool complete();
+
 private:
   friend class TimesliceReceiver;
   friend class StorableTimeslice;
 
   TimesliceView(
       std::shared_ptr<boost::interprocess::managed_shared_memory> managed_shm,
+      std::shared_ptr<DeviceMemory> data_device,
       std::shared_ptr<const Item> work_item,
       const TimesliceShmWorkItem& timeslice_item);
 
+  TimesliceView(
+      std::shared_ptr<boost::interprocess::managed_shared_memory> managed_shm,
+      std::shared_ptr<DeviceMemory> data_device,
+      std::shared_ptr<const Item> work_item,
+      const TimesliceShmWorkItemView& timeslice_item);
+
+  TimesliceView(std::shared_ptr<const TimesliceShmSegment> segment,
+                std::shared_ptr<const Item> work_item,
+                uint64_t ts_pos);
+
+  TimesliceView(std::shared_ptr<TimesliceSpillRecord> spill_record,
+                std::shared_ptr<const Item> work_item);
+
+  /// Resolve a data handle from a work item.
+  [[nodiscard]] uint8_t* data_address(std::ptrdiff_t handle) const;
+
+  void check_consistency() const;
+
   std::shared_ptr<boost::interprocess::managed_shared_memory> managed_shm_;
+  std::shared_ptr<DeviceMemory> data_device_;
+  std::shared_ptr<const TimesliceShmSegment> segment_;
   std::shared_ptr<const Item> work_item_;
-  fles::TimesliceShmWorkItem timeslice_item_;
+  /// Timeslice read from a spill log file
+  std::shared_ptr<TimesliceSpillRecord> spill_record_;
+
+  /// Buffer position of the timeslice in the flat segment
+  uint64_t ts_pos_ = 0;
+  /// Number of components not yet complete
+  uint64_t pending_ = 0;
 };
 
 } // namespace fles
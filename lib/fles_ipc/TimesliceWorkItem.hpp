@@ -17,7 +17,7 @@ namespace fles {
 struct TimesliceWorkItem {
   /// The timeslice descriptor
   TimesliceDescriptor ts_desc;
-  /// Size exponential (in bytes) of each data buffer
+  /// Size exponential (in bytes) of the largest data buffer
   uint32_t data_buffer_size_exp;
   /// Size exponential (in bytes) of each descriptor buffer
   uint32_t desc_buffer_size_exp;
@@ -0,0 +1,227 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "ZstdDictionary.hpp"
+#include "MicrosliceDescriptor.hpp"
+#include "Timeslice.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#ifdef HAVE_ZSTD
+#include <zdict.h>
+#include <zstd.h>
+#endif
+
+namespace fles {
+
+namespace {
+
+const std::string dictionary_extension = ".zdict";
+
+std::string dictionary_filename(uint16_t key) {
+  char name[8];
+  std::snprintf(name, sizeof(name), "%02x_%02x", key >> 8, key & 0xff);
+  return name + dictionary_extension;
+}
+
+bool parse_dictionary_filename(const std::string& name, uint16_t& key) {
+  unsigned sys_id = 0;
+  unsigned sys_ver = 0;
+  char rest = 0;
+  if (name.size() != 5 + dictionary_extension.size() || name[2] != '_' ||
+      name.compare(5, std::string::npos, dictionary_extension) != 0 ||
+      std::sscanf(name.c_str(), "%2x_%2x%c", &sys_id, &sys_ver, &rest) != 3 ||
+      rest != '.') {
+    return false;
+  }
+  key = dictionary_key(static_cast<uint8_t>(sys_id),
+                       static_cast<uint8_t>(sys_ver));
+  return true;
+}
+
+} // namespace
+
+ZstdDictionaries load_zstd_dictionaries(const std::string& directory) {
+  ZstdDictionaries dictionaries;
+  std::error_code ec;
+  for (const auto& entry :
+       std::filesystem::directory_iterator(directory, ec)) {
+    uint16_t key = 0;
+    if (!entry.is_regular_file() ||
+        !parse_dictionary_filename(entry.path().filename().string(), key)) {
+      continue;
+    }
+    std::ifstream file(entry.path(), std::ios::binary);
+    std::string content;
+    if (file) {
+      content.assign(std::istreambuf_iterator<char>(file),
+                     std::istreambuf_iterator<char>());
+    }
+    if (content.empty()) {
+      throw std::ios_base::failure("error reading dictionary \"" +
+                                   entry.path().string() + "\"");
+    }
+    dictionaries[key] = std::move(content);
+  }
+  if (ec) {
+    throw std::ios_base::failure("error reading dictionary directory \"" +
+                                 directory + "\": " + ec.message());
+  }
+  return dictionaries;
+}
+
+void save_zstd_dictionaries(const std::string& directory,
+                            const ZstdDictionaries& dictionaries) {
+  std::filesystem::create_directories(directory);
+  for (const auto& [key, content] : dictionaries) {
+    const auto path =
+        std::filesystem::path(directory) / dictionary_filename(key);
+    std::ofstream file(path, std::ios::binary);
+    file.write(content.data(), static_cast<std::streamsize>(content.size()));
+    if (!file) {
+      throw std::ios_base::failure("error writing dictionary \"" +
+                                   path.string() + "\"");
+    }
+  }
+}
+
+#ifdef HAVE_ZSTD
+
+namespace {
+
+// Compression and decompression contexts are reused by each thread
+struct ZstdContexts {
+  ZSTD_CCtx* cctx = ZSTD_createCCtx();
+  ZSTD_DCtx* dctx = ZSTD_createDCtx();
+
+  ZstdContexts() = default;
+  ZstdContexts(const ZstdContexts&) = delete;
+  void operator=(const ZstdContexts&) = delete;
+  ~ZstdContexts() {
+    ZSTD_freeCCtx(cctx);
+    ZSTD_freeDCtx(dctx);
+  }
+};
+
+ZstdContexts& contexts() {
+  thread_local ZstdContexts contexts;
+  return contexts;
+}
+
+} // namespace
+
+ZstdDictionary::ZstdDictionary(std::string content, int level)
+    : content_(std::move(content)),
+      id_(ZSTD_getDictID_fromDict(content_.data(), content_.size())),
+      cdict_(ZSTD_createCDict(content_.data(), content_.size(), level),
+             ZSTD_freeCDict),
+      ddict_(ZSTD_createDDict(content_.data(), content_.size()),
+             ZSTD_freeDDict) {
+  if (content_.empty() || !cdict_ || !ddict_) {
+    throw std::runtime_error("invalid zstd dictionary");
+  }
+}
+
+std::string ZstdDictionary::compress(const void* data,
+                                     std::size_t size) const {
+  std::string frame(ZSTD_compressBound(size), '\0');
+  const std::size_t result =
+      ZSTD_compress_usingCDict(contexts().cctx, frame.data(), frame.size(),
+                               data, size, cdict_.get());
+  if (ZSTD_isError(result) != 0u) {
+    throw std::runtime_error(std::string("zstd compression failed: ") +
+                             ZSTD_getErrorName(result));
+  }
+  frame.resize(result);
+  return frame;
+}
+
+void ZstdDictionary::decompress(const void* frame,
+                                std::size_t frame_size,
+                                void* data,
+                                std::size_t size) const {
+  const std::size_t result =
+      ZSTD_decompress_usingDDict(contexts().dctx, data, size, frame,
+                                 frame_size, ddict_.get());
+  if (ZSTD_isError(result) != 0u || result != size) {
+    throw std::runtime_error("zstd frame size mismatch");
+  }
+}
+
+std::string ZstdDictionary::train(const std::vector<std::string>& samples,
+                                  std::size_t max_size) {
+  std::string buffer;
+  std::vector<std::size_t> sizes;
+  for (const auto& sample : samples) {
+    buffer += sample;
+    sizes.push_back(sample.size());
+  }
+  std::string dictionary(max_size, '\0');
+  const std::size_t result = ZDICT_trainFromBuffer(
+      dictionary.data(), dictionary.size(), buffer.data(), sizes.data(),
+      static_cast<unsigned>(sizes.size()));
+  if (ZDICT_isError(result) != 0u) {
+    throw std::runtime_error(
+        std::string("zstd dictionary training failed: ") +
+        ZDICT_getErrorName(result));
+  }
+  dictionary.resize(result);
+  return dictionary;
+}
+
+#endif
+
+void ZstdDictionaryTrainer::add(const Timeslice& ts) {
+  for (uint64_t c = 0; c < ts.num_components(); ++c) {
+    if (ts.num_microslices(c) == 0 || ts.content_omitted(c)) {
+      continue;
+    }
+    const auto& md = ts.descriptor(c, 0);
+    Samples& samples = samples_[dictionary_key(md.sys_id, md.sys_ver)];
+    if (samples.bytes >= sample_budget_) {
+      continue;
+    }
+    // the chunk data, i.e., the microslice descriptors and contents
+    const auto* data = reinterpret_cast<const char*>(&md);
+    const auto size = static_cast<std::size_t>(ts.size_component(c));
+    samples.blocks.emplace_back(data, size);
+    samples.bytes += size;
+  }
+}
+
+bool ZstdDictionaryTrainer::saturated() const {
+  return !samples_.empty() &&
+         std::all_of(samples_.begin(), samples_.end(), [this](const auto& s) {
+           return s.second.bytes >= sample_budget_;
+         });
+}
+
+std::size_t ZstdDictionaryTrainer::num_samples(uint8_t sys_id,
+                                               uint8_t sys_ver) const {
+  auto it = samples_.find(dictionary_key(sys_id, sys_ver));
+  return it != samples_.end() ? it->second.blocks.size() : 0;
+}
+
+ZstdDictionaries ZstdDictionaryTrainer::train() const {
+#ifdef HAVE_ZSTD
+  ZstdDictionaries dictionaries;
+  for (const auto& [key, samples] : samples_) {
+    if (samples.blocks.size() < min_samples_) {
+      continue;
+    }
+    try {
+      dictionaries[key] = ZstdDictionary::train(samples.blocks, max_size_);
+    } catch (const std::runtime_error&) {
+      // e.g., samples without any redundancy, left without dictionary
+    }
+  }
+  return dictionaries;
+#else
+  throw std::runtime_error("zstd dictionaries not supported by this build");
+#endif
+}
+
+} // namespace fles
@@ -0,0 +1,159 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::ZstdDictionary and fles::ZstdDictionaryTrainer
+/// classes.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
+namespace fles {
+
+class Timeslice;
+
+/// Trained zstd dictionaries by component, keyed by dictionary_key().
+using ZstdDictionaries = std::map<uint16_t, std::string>;
+
+/// Key of the dictionary of a subsystem format version.
+inline uint16_t dictionary_key(uint8_t sys_id, uint8_t sys_ver) {
+  return static_cast<uint16_t>(sys_id << 8 | sys_ver);
+}
+
+/**
+ * \brief Read the dictionaries stored in a directory.
+ *
+ * Each dictionary is a file "<sys_id>_<sys_ver>.zdict" (two hexadecimal
+ * digits each) in the format of "zstd --train". Other files are ignored.
+ *
+ * \throws std::ios_base::failure if the directory cannot be read
+ */
+ZstdDictionaries load_zstd_dictionaries(const std::string& directory);
+
+/// Write dictionaries to a directory (see load_zstd_dictionaries()).
+void save_zstd_dictionaries(const std::string& directory,
+                            const ZstdDictionaries& dictionaries);
+
+#ifdef HAVE_ZSTD
+
+/**
+ * \brief The ZstdDictionary class compresses and decompresses small blocks
+ * of data with a trained zstd dictionary.
+ *
+ * Without a dictionary, each block starts with an empty history, which
+ * compresses blocks of a few kilobytes poorly. The dictionary is digested
+ * once on construction and shared by all (concurrent) calls. Each frame is
+ * self-contained apart from the dictionary, which is identified by its ID
+ * in the frame header.
+ */
+class ZstdDictionary {
+public:
+  /**
+   * \brief Digest a dictionary for the given compression level.
+   *
+   * \throws std::runtime_error if the dictionary is invalid
+   */
+  explicit ZstdDictionary(std::string content, int level = 1);
+
+  /// Retrieve the dictionary as stored.
+  [[nodiscard]] const std::string& content() const { return content_; }
+
+  /// Retrieve the dictionary ID (0 for raw content dictionaries).
+  [[nodiscard]] uint32_t id() const { return id_; }
+
+  /// Compress a block of data into a single zstd frame.
+  [[nodiscard]] std::string compress(const void* data, std::size_t size) const;
+
+  /**
+   * \brief Decompress a zstd frame into a buffer of known size.
+   *
+   * \throws std::runtime_error if the frame does not decompress to exactly
+   * size bytes with this dictionary
+   */
+  void decompress(const void* frame,
+                  std::size_t frame_size,
+                  void* data,
+                  std::size_t size) const;
+
+  /**
+   * \brief Train a dictionary on sample blocks.
+   *
+   * \throws std::runtime_error if training fails (e.g., too few samples)
+   */
+  static std::string train(const std::vector<std::string>& samples,
+                           std::size_t max_size);
+
+private:
+  std::string content_;
+  uint32_t id_ = 0;
+  std::shared_ptr<ZSTD_CDict_s> cdict_;
+  std::shared_ptr<ZSTD_DDict_s> ddict_;
+};
+
+#endif
+
+/**
+ * \brief The ZstdDictionaryTrainer class samples timeslice components to
+ * train one zstd dictionary per subsystem format version.
+ *
+ * Components are assigned by the subsystem identifier and format version
+ * of their first microslice, as in a chunked timeslice archive. Sampling
+ * of a format version stops once the sample budget, a multiple of the
+ * dictionary size, is reached.
+ */
+class ZstdDictionaryTrainer {
+public:
+  /**
+   * \brief Construct a trainer.
+   *
+   * \param max_size         Maximum size of each dictionary in bytes
+   * \param sample_factor    Sample budget per dictionary as a multiple of
+   *                         max_size
+   * \param min_samples      Minimum number of samples to train a dictionary
+   */
+  explicit ZstdDictionaryTrainer(std::size_t max_size = 112640,
+                                 std::size_t sample_factor = 100,
+                                 std::size_t min_samples = 16)
+      : max_size_(max_size), sample_budget_(max_size * sample_factor),
+        min_samples_(min_samples) {}
+
+  /// Sample the components of a timeslice.
+  void add(const Timeslice& ts);
+
+  /// Check whether the sample budget of all format versions seen is used up.
+  [[nodiscard]] bool saturated() const;
+
+  /// Retrieve the number of samples of a subsystem format version.
+  [[nodiscard]] std::size_t num_samples(uint8_t sys_id, uint8_t sys_ver) const;
+
+  /**
+   * \brief Train the dictionaries of all format versions with enough
+   * samples.
+   *
+   * Format versions whose training fails are left without dictionary.
+   *
+   * \throws std::runtime_error if zstd dictionaries are not supported by
+   * this build
+   */
+  [[nodiscard]] ZstdDictionaries train() const;
+
+private:
+  struct Samples {
+    std::vector<std::string> blocks;
+    std::size_t bytes = 0;
+  };
+
+  std::size_t max_size_;
+  std::size_t sample_budget_;
+  std::size_t min_samples_;
+  std::map<uint16_t, Samples> samples_;
+};
+
+} // namespace fles
@@ -0,0 +1,176 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "ZstdFrameCompressor.hpp"
+
+#ifdef BOOST_IOS_HAS_ZSTD
+
+#include <algorithm>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/filter/zstd.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace fles {
+
+struct ZstdFrameCompressor::Pool::State {
+  ZstdParameters parameters;
+  std::string buffer;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<std::packaged_task<std::string()>> tasks;
+  bool stopped = false;
+  std::vector<std::thread> workers;
+
+  // Compressed frames in input order (accessed by the writing thread only)
+  std::deque<std::future<std::string>> frames;
+
+  void work() {
+    while (true) {
+      std::packaged_task<std::string()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return stopped || !tasks.empty(); });
+        if (tasks.empty()) {
+          return;
+        }
+        task = std::move(tasks.front());
+        tasks.pop_front();
+      }
+      task();
+    }
+  }
+};
+
+ZstdFrameCompressor::ZstdFrameCompressor(const ZstdParameters& parameters)
+    : pool_(std::make_shared<Pool>(parameters)) {}
+
+ZstdFrameCompressor::Pool::Pool(const ZstdParameters& parameters)
+    : state_(std::make_unique<State>()) {
+  state_->parameters = parameters;
+  if (state_->parameters.threads == 0) {
+    state_->parameters.threads = 1;
+  }
+  if (state_->parameters.frame_size == 0) {
+    state_->parameters.frame_size = ZstdParameters{}.frame_size;
+  }
+  state_->buffer.reserve(state_->parameters.frame_size);
+  for (unsigned i = 0; i < state_->parameters.threads; ++i) {
+    state_->workers.emplace_back(&State::work, state_.get());
+  }
+}
+
+ZstdFrameCompressor::Pool::~Pool() {
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->stopped = true;
+  }
+  state_->cv.notify_all();
+  for (auto& worker : state_->workers) {
+    worker.join();
+  }
+}
+
+void ZstdFrameCompressor::Pool::append(const char* s, std::size_t n) {
+  const std::size_t frame_size = state_->parameters.frame_size;
+  while (n > 0) {
+    std::size_t chunk = std::min(n, frame_size - state_->buffer.size());
+    state_->buffer.append(s, chunk);
+    s += chunk;
+    n -= chunk;
+    if (state_->buffer.size() == frame_size) {
+      submit();
+    }
+  }
+}
+
+void ZstdFrameCompressor::Pool::finish() {
+  if (!state_->buffer.empty()) {
+    submit();
+  }
+}
+
+bool ZstdFrameCompressor::Pool::pop(std::string& frame, bool wait) {
+  if (state_->frames.empty()) {
+    return false;
+  }
+  auto& front = state_->frames.front();
+  if (!wait &&
+      front.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+    return false;
+  }
+  frame = front.get(); // rethrows compression errors
+  state_->frames.pop_front();
+  return true;
+}
+
+bool ZstdFrameCompressor::Pool::saturated() const {
+  return state_->frames.size() >= 2 * state_->parameters.threads;
+}
+
+void ZstdFrameCompressor::Pool::submit() {
+  std::string data;
+  data.reserve(state_->parameters.frame_size);
+  std::swap(data, state_->buffer);
+  std::packaged_task<std::string()> task(
+      [data = std::move(data), level = state_->parameters.level] {
+        return compress_zstd_frame(data.data(), data.size(), level);
+      });
+  state_->frames.push_back(task.get_future());
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->tasks.push_back(std::move(task));
+  }
+  state_->cv.notify_one();
+}
+
+void push_zstd_compressor(boost::iostreams::filtering_ostream& out,
+                          const ZstdParameters& parameters) {
+  if (parameters.threads > 0) {
+    out.push(ZstdFrameCompressor(parameters));
+  } else {
+    out.push(boost::iostreams::zstd_compressor(boost::iostreams::zstd_params(
+        static_cast<uint32_t>(parameters.level))));
+  }
+}
+
+std::string compress_zstd_frame(const void* data, std::size_t size, int level) {
+  std::string frame;
+  boost::iostreams::filtering_ostream out;
+  out.push(boost::iostreams::zstd_compressor(
+      boost::iostreams::zstd_params(static_cast<uint32_t>(level))));
+  out.push(boost::iostreams::back_inserter(frame));
+  out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+  out.reset();
+  return frame;
+}
+
+void decompress_zstd_frame(const void* frame,
+                           std::size_t frame_size,
+                           void* data,
+                           std::size_t size) {
+  boost::iostreams::filtering_istream in;
+  in.push(boost::iostreams::zstd_decompressor());
+  in.push(boost::iostreams::array_source(static_cast<const char*>(frame),
+                                         frame_size));
+  in.read(static_cast<char*>(data), static_cast<std::streamsize>(size));
+  if (static_cast<std::size_t>(in.gcount()) != size ||
+      in.get() != std::char_traits<char>::eof()) {
+    throw std::runtime_error("zstd frame size mismatch");
+  }
+}
+
+} // namespace fles
+
+#endif
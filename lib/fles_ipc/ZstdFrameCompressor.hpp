@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the fles::ZstdFrameCompressor class.
+#pragma once
+
+#ifdef BOOST_IOS_HAS_ZSTD
+#include <boost/iostreams/categories.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/operations.hpp>
+#endif
+#include <cstddef>
+#include <ios>
+#include <memory>
+#include <string>
+
+namespace fles {
+
+/// Parameters of the zstd compression of output archives.
+struct ZstdParameters {
+  /// Compression level (1: best speed, up to 19 or 22 for "ultra" levels).
+  int level = 1;
+
+  /// Number of worker threads (0: compress in the calling thread).
+  unsigned threads = 0;
+
+  /// Amount of uncompressed data per zstd frame in multithreaded mode.
+  std::size_t frame_size = std::size_t{4} << 20;
+};
+
+#ifdef BOOST_IOS_HAS_ZSTD
+
+/**
+ * \brief The ZstdFrameCompressor class is a Boost.Iostreams output filter
+ * that compresses its input on a pool of worker threads.
+ *
+ * The input is cut into chunks of ZstdParameters::frame_size bytes, and each
+ * chunk is compressed into a separate zstd frame. The frames are written to
+ * the sink in input order. Since every frame is complete in itself, the
+ * output can be read by the regular boost::iostreams::zstd_decompressor, and
+ * the frames can be decoded independently of each other.
+ */
+class ZstdFrameCompressor {
+public:
+  using char_type = char;
+  struct category : boost::iostreams::multichar_output_filter_tag,
+                    boost::iostreams::closable_tag {};
+
+  /// Construct a compressor with the given parameters (threads > 0).
+  explicit ZstdFrameCompressor(const ZstdParameters& parameters);
+
+  /// Buffer the given data and write all completed frames to the sink.
+  template <typename Sink>
+  std::streamsize write(Sink& sink, const char* s, std::streamsize n) {
+    pool_->append(s, static_cast<std::size_t>(n));
+    write_frames(sink, false);
+    return n;
+  }
+
+  /// Compress the remaining data and write all outstanding frames.
+  template <typename Sink> void close(Sink& sink) {
+    pool_->finish();
+    write_frames(sink, true);
+  }
+
+private:
+  class Pool;
+  // Boost.Iostreams copies filters, so all copies share the same pool
+  std::shared_ptr<Pool> pool_;
+
+  template <typename Sink> void write_frames(Sink& sink, bool wait_all) {
+    std::string frame;
+    while (pool_->pop(frame, wait_all || pool_->saturated())) {
+      boost::iostreams::write(sink, frame.data(),
+                              static_cast<std::streamsize>(frame.size()));
+    }
+  }
+
+  class Pool {
+  public:
+    explicit Pool(const ZstdParameters& parameters);
+    Pool(const Pool&) = delete;
+    void operator=(const Pool&) = delete;
+    ~Pool();
+
+    /// Append data to the current frame, submitting it when full.
+    void append(const char* s, std::size_t n);
+    /// Submit the current (partial) frame.
+    void finish();
+    /// Retrieve the oldest compressed frame if available (or if waiting).
+    bool pop(std::string& frame, bool wait);
+    /// Too many frames are in flight, the caller has to wait for the oldest.
+    [[nodiscard]] bool saturated() const;
+
+  private:
+    struct State;
+    std::unique_ptr<State> state_;
+
+    void submit();
+  };
+};
+
+/**
+ * \brief Add a zstd compressor to a filtering output stream.
+ *
+ * Pushes a ZstdFrameCompressor if parameters.threads is non-zero, and a
+ * single-threaded boost::iostreams::zstd_compressor otherwise.
+ */
+void push_zstd_compressor(boost::iostreams::filtering_ostream& out,
+                          const ZstdParameters& parameters);
+
+/// Compress a block of data into a single, self-contained zstd frame.
+std::string compress_zstd_frame(const void* data, std::size_t size, int level);
+
+/**
+ * \brief Decompress a zstd frame into a buffer of known size.
+ *
+ * \throws std::runtime_error if the frame does not decompress to exactly
+ * size bytes
+ */
+void decompress_zstd_frame(const void* frame,
+                           std::size_t frame_size,
+                           void* data,
+                           std::size_t size);
+
+#endif
+
+} // namespace fles
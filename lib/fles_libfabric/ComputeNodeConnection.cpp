@@ -65,6 +65,9 @@ ComputeNodeConnection::ComputeNodeConnection(
 }
 
 void ComputeNodeConnection::post_recv_status_message() {
+  if (shared_receive_) {
+    return;
+  }
   if (false) {
     L_(trace) << "[c" << remote_index_ << "] "
               << "[" << index_ << "] "
@@ -88,6 +91,7 @@ void ComputeNodeConnection::post_send_status_message() {
   while (pending_send_requests_ >= 2000 /*qp_cap_.max_send_wr*/) {
     throw LibfabricException("Max number of pending send requests exceeded");
   }
+  send_status_message_.local_time = std::chrono::high_resolution_clock::now();
   if (post_send_msg(&send_wr)) {
     data_acked_ = false;
     data_changed_ = false;
@@ -117,39 +121,33 @@ void ComputeNodeConnection::setup_mr(struct fid_domain* pd) {
   std::size_t data_bytes = UINT64_C(1) << data_buffer_size_exp_;
   std::size_t desc_bytes = (UINT64_C(1) << desc_buffer_size_exp_) *
                            sizeof(fles::TimesliceComponentDescriptor);
-  int res = fi_mr_reg(pd, data_ptr_, data_bytes, FI_WRITE | FI_REMOTE_WRITE, 0,
-                      Provider::requested_key++, 0, &mr_data_, nullptr);
-  if (res != 0) {
-    L_(fatal) << "fi_mr_reg failed for data_ptr: " << res << "="
-              << fi_strerror(-res);
-    throw LibfabricException("fi_mr_reg failed for data_ptr");
-  }
-  res = fi_mr_reg(pd, desc_ptr_, desc_bytes, FI_WRITE | FI_REMOTE_WRITE, 0,
-                  Provider::requested_key++, 0, &mr_desc_, nullptr);
-  if (res != 0) {
-    L_(fatal) << "fi_mr_reg failed for desc_ptr: " << res << "="
-              << fi_strerror(-res);
-    throw LibfabricException("fi_mr_reg failed for desc_ptr");
-  }
-  res = fi_mr_reg(pd, &send_status_message_, sizeof(ComputeNodeStatusMessage),
-                  FI_SEND | FI_TAGGED, 0, Provider::requested_key++, 0,
-                  &mr_send_, nullptr);
+  // the buffers are slices of the timeslice buffer, usually covered by a
+  // cached registration of the whole buffer
+  mr_data_ = MemoryRegionCache::getInst()->get(pd, data_ptr_, data_bytes,
+                                               FI_WRITE | FI_REMOTE_WRITE);
+  mr_desc_ = MemoryRegionCache::getInst()->get(pd, desc_ptr_, desc_bytes,
+                                               FI_WRITE | FI_REMOTE_WRITE);
+  int res = fi_mr_reg(pd, &send_status_message_,
+                      sizeof(ComputeNodeStatusMessage), FI_SEND | FI_TAGGED, 0,
+                      Provider::requested_key++, 0, &mr_send_, nullptr);
   if (res != 0) {
     L_(fatal) << "fi_mr_reg failed for send: " << res << "="
               << fi_strerror(-res);
     throw LibfabricException("fi_mr_reg failed for send");
   }
-  res = fi_mr_reg(pd, &recv_status_message_, sizeof(InputChannelStatusMessage),
-                  FI_RECV | FI_TAGGED, 0, Provider::requested_key++, 0,
-                  &mr_recv_, nullptr);
-  if (res != 0) {
-    L_(fatal) << "fi_mr_reg failed for recv: " << res << "="
-              << fi_strerror(-res);
-    throw LibfabricException("fi_mr_reg failed for recv");
+  if (!shared_receive_) {
+    res = fi_mr_reg(pd, &recv_status_message_,
+                    sizeof(InputChannelStatusMessage), FI_RECV | FI_TAGGED, 0,
+                    Provider::requested_key++, 0, &mr_recv_, nullptr);
+    if (res != 0) {
+      L_(fatal) << "fi_mr_reg failed for recv: " << res << "="
+                << fi_strerror(-res);
+      throw LibfabricException("fi_mr_reg failed for recv");
+    }
   }
 
-  if ((mr_data_ == nullptr) || (mr_desc_ == nullptr) || (mr_recv_ == nullptr) ||
-      (mr_send_ == nullptr)) {
+  if ((mr_data_ == nullptr) || (mr_desc_ == nullptr) ||
+      (mr_recv_ == nullptr && !shared_receive_) || (mr_send_ == nullptr)) {
     throw LibfabricException(
         "registration of memory region failed in ComputeNodeConnection");
   }
@@ -171,22 +169,25 @@ void ComputeNodeConnection::setup() {
   L_(info) << "END OF Calling add_endpoint in setup";
   setup_heartbeat();
 
-  // setup send and receive buffers
-  recv_sge.iov_base = &recv_status_message_;
-  recv_sge.iov_len = sizeof(InputChannelStatusMessage);
-
-  recv_wr_descs[0] = fi_mr_desc(mr_recv_);
-
-  recv_wr.msg_iov = &recv_sge;
-  recv_wr.desc = recv_wr_descs;
-  recv_wr.iov_count = 1;
-  recv_wr.tag = ConstVariables::STATUS_MESSAGE_TAG;
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wold-style-cast"
-  struct fi_custom_context* context =
-      LibfabricContextPool::getInst()->getContext();
-  context->op_context = (ID_RECEIVE_STATUS | (index_ << 8));
-  recv_wr.context = context;
+  struct fi_custom_context* context = nullptr;
+  // with a shared receive context, status messages are received there
+  if (!shared_receive_) {
+    // setup send and receive buffers
+    recv_sge.iov_base = &recv_status_message_;
+    recv_sge.iov_len = sizeof(InputChannelStatusMessage);
+
+    recv_wr_descs[0] = fi_mr_desc(mr_recv_);
+
+    recv_wr.msg_iov = &recv_sge;
+    recv_wr.desc = recv_wr_descs;
+    recv_wr.iov_count = 1;
+    recv_wr.tag = ConstVariables::STATUS_MESSAGE_TAG;
+    context = LibfabricContextPool::getInst()->getContext();
+    context->op_context = (ID_RECEIVE_STATUS | (index_ << 8));
+    recv_wr.context = context;
+  }
 #pragma GCC diagnostic pop
 
   send_sge.iov_base = &send_status_message_;
@@ -233,17 +234,12 @@ void ComputeNodeConnection::on_disconnected(struct fi_eq_cm_entry* event) {
     mr_send_ = nullptr;
   }
 
-  if (mr_desc_ != nullptr) {
-    fi_close((struct fid*)mr_desc_);
-    mr_desc_ = nullptr;
-  }
-
-  if (mr_data_ != nullptr) {
-    fi_close((struct fid*)mr_data_);
-    mr_data_ = nullptr;
-  }
 #pragma GCC diagnostic pop
 
+  // owned by the MemoryRegionCache
+  mr_desc_ = nullptr;
+  mr_data_ = nullptr;
+
   Connection::on_disconnected(event);
 }
 
@@ -254,8 +250,6 @@ void ComputeNodeConnection::inc_ack_pointers(uint64_t ack_pos) {
       desc_ptr_[(ack_pos - 1) & ((UINT64_C(1) << desc_buffer_size_exp_) - 1)];
 
   cn_ack_.data = acked_ts.offset + acked_ts.size;
-
-  data_changed_ = true;
 }
 
 bool ComputeNodeConnection::try_sync_buffer_positions() {
@@ -283,8 +277,15 @@ bool ComputeNodeConnection::try_sync_buffer_positions() {
     }
   }
 
-  if (data_changed_ && !send_status_message_.final) {
+  // the acknowledgement is sent along with any other change, otherwise it
+  // may be held back to be coalesced with the following ones
+  if (!send_status_message_.final && cn_ack_ != send_status_message_.ack &&
+      (data_acked_ || data_changed_ ||
+       ack_coalescer_.due(cn_ack_, send_status_message_.ack, cn_wp_,
+                          buffer_size()))) {
+    ack_coalescer_.on_sent(cn_ack_, send_status_message_.ack);
     send_status_message_.ack = cn_ack_;
+    data_changed_ = true;
   }
 
   if (data_acked_ || data_changed_) {
@@ -294,6 +295,12 @@ bool ComputeNodeConnection::try_sync_buffer_positions() {
   return false;
 }
 
+void ComputeNodeConnection::on_shared_recv(
+    const InputChannelStatusMessage& message) {
+  recv_status_message_ = message;
+  on_complete_recv();
+}
+
 void ComputeNodeConnection::on_complete_recv() {
   if (false) {
     L_(info) << "[c" << remote_index_ << "] "
@@ -349,6 +356,13 @@ void ComputeNodeConnection::update_scheduler_interval_data() {
         index_, recv_status_message_.local_time);
   }
 
+  if (recv_status_message_.echo_time.time_since_epoch().count() != 0) {
+    DDSchedulerOrchestrator::add_clock_exchange(
+        index_, std::chrono::high_resolution_clock::now(),
+        recv_status_message_.local_time, recv_status_message_.echo_time,
+        recv_status_message_.echo_hold_time);
+  }
+
   if (recv_status_message_.actual_interval_metadata.interval_index !=
       ConstVariables::MINUS_ONE) {
     DDSchedulerOrchestrator::update_clock_offset(
@@ -3,11 +3,13 @@
 
 #pragma once
 
+#include "AckCoalescer.hpp"
 #include "ComputeNodeInfo.hpp"
 #include "ComputeNodeStatusMessage.hpp"
 #include "Connection.hpp"
 #include "InputChannelStatusMessage.hpp"
 #include "InputNodeInfo.hpp"
+#include "MemoryRegionCache.hpp"
 #include "RequestIdentifier.hpp"
 #include "TimesliceComponentDescriptor.hpp"
 #include "dfs/DDSchedulerOrchestrator.hpp"
@@ -25,7 +27,7 @@ namespace tl_libfabric {
 /// Compute node connection class.
 /** A ComputeNodeConnection object represents the endpoint of a single
  timeslice building connection from a compute node to an input
- node. */
+ node. The acknowledgements can be coalesced (see AckCoalescer). */
 
 class ComputeNodeConnection : public Connection {
 public:
@@ -63,6 +65,17 @@ public:
 
   bool abort_flag() { return recv_status_message_.abort; }
 
+  /// Retrieve the first timeslice not yet placed by the input node.
+  [[nodiscard]] uint64_t input_unplaced_timeslice() const {
+    return recv_status_message_.next_unplaced_timeslice;
+  }
+
+  /// Ask the input node to admit this compute node from a timeslice on.
+  void request_join(uint64_t timeslice) {
+    send_status_message_.join_timeslice = timeslice;
+    data_changed_ = true;
+  }
+
   void setup() override;
 
   void setup_mr(struct fid_domain* pd) override;
@@ -84,6 +97,9 @@ public:
   /// Handle Libfabric receive completion notification.
   void on_complete_recv() override;
 
+  /// Handle a status message received through a shared receive context.
+  void on_shared_recv(const InputChannelStatusMessage& message);
+
   /// Handle Libfabric send completion notification.
   void on_complete_send() override;
 
@@ -93,6 +109,17 @@ public:
 
   const ComputeNodeBufferPosition& cn_ack() const { return cn_ack_; }
 
+  /// Set the parameters of the acknowledgement coalescing (default: every
+  /// acknowledgement is sent immediately).
+  void set_ack_coalescing(const AckCoalescer::Parameters& parameters) {
+    ack_coalescer_ = AckCoalescer(parameters);
+  }
+
+  /// The number of acknowledgement messages sent to the input node.
+  [[nodiscard]] uint64_t ack_messages() const {
+    return ack_coalescer_.messages();
+  }
+
   const InputChannelStatusMessage& recv_status_message() const {
     return recv_status_message_;
   }
@@ -159,6 +186,11 @@ public:
 
   void set_remote_info(InputNodeInfo remote_info);
 
+  /// Set the heartbeat endpoint sent to the input node on connect.
+  void set_heartbeat_endpoint(const HeartbeatEndpointInfo& info) {
+    send_status_message_.heartbeat_endpoint = info;
+  }
+
   bool is_connection_finalized();
 
 private:
@@ -171,6 +203,12 @@ private:
 
   void update_scheduler_interval_data();
 
+  /// The sizes of the data and descriptor buffers.
+  [[nodiscard]] ComputeNodeBufferPosition buffer_size() const {
+    return {UINT64_C(1) << data_buffer_size_exp_,
+            UINT64_C(1) << desc_buffer_size_exp_};
+  }
+
   ComputeNodeStatusMessage send_status_message_ = ComputeNodeStatusMessage();
   ComputeNodeBufferPosition cn_ack_ = ComputeNodeBufferPosition();
 
@@ -214,5 +252,8 @@ private:
   /// To prevent sending more messages (late messages) once the final message
   /// is sent out
   bool final_msg_sent_ = false;
+
+  /// Coalescing of the acknowledgements sent to the input node
+  AckCoalescer ack_coalescer_;
 };
 } // namespace tl_libfabric
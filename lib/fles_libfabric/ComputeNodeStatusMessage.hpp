@@ -6,6 +6,7 @@
 #include "ComputeNodeBufferPosition.hpp"
 #include "ComputeNodeInfo.hpp"
 #include "ConstVariables.hpp"
+#include "dfs/HeartbeatEndpointInfo.hpp"
 #include "dfs/IntervalMetaData.hpp"
 #include <chrono>
 
@@ -25,6 +26,17 @@ struct ComputeNodeStatusMessage {
   unsigned char my_address[64];
 
   IntervalMetaData proposed_interval_metadata;
+
+  // local time at which the message is sent (echoed by the input node for
+  // the clock offset estimation)
+  std::chrono::high_resolution_clock::time_point local_time;
+
+  // heartbeat endpoint of the compute process (on connect)
+  HeartbeatEndpointInfo heartbeat_endpoint;
+
+  // the timeslice from which on a joining compute node requests to be
+  // admitted
+  uint64_t join_timeslice = ConstVariables::MINUS_ONE;
 };
 } // namespace tl_libfabric
 
@@ -16,7 +16,7 @@ Connection::Connection(struct fid_eq* eq,
   max_recv_wr_ = 16;
   max_send_sge_ = 8;
   max_recv_sge_ = 8;
-  max_inline_data_ = 0;
+  max_inline_data_ = Provider::tuned_inline_data_size();
 
   send_heartbeat_message_.info.index = remote_index_;
 }
@@ -34,17 +34,11 @@ Connection::~Connection() {
   }
 }
 
-void Connection::connect(const std::string& hostname,
-                         const std::string& service,
-                         struct fid_domain* domain,
-                         struct fid_cq* cq,
-                         struct fid_av* av) {
-  auto private_data = get_private_data();
-  assert(private_data->size() <= 255);
-
-  L_(debug) << "connect: " << hostname << ":" << service;
+struct fi_info* Connection::resolve(const std::string& hostname,
+                                    const std::string& service,
+                                    std::size_t rail) {
   struct fi_info* info2 = nullptr;
-  struct fi_info* hints = fi_dupinfo(Provider::getInst()->get_info());
+  struct fi_info* hints = fi_dupinfo(Provider::getInst(rail)->get_info());
 
   int err = fi_getinfo(FIVERSION, hostname.empty() ? nullptr : hostname.c_str(),
                        service.empty() ? nullptr : service.c_str(),
@@ -56,8 +50,24 @@ void Connection::connect(const std::string& hostname,
   }
 
   fi_freeinfo(hints);
+  return info2;
+}
+
+void Connection::connect(const std::string& hostname,
+                         const std::string& service,
+                         struct fid_domain* domain,
+                         struct fid_cq* cq,
+                         struct fid_av* av,
+                         struct fi_info* resolved) {
+  auto private_data = get_private_data();
+  assert(private_data->size() <= 255);
 
-  err = fi_endpoint(domain, info2, &ep_, this);
+  L_(debug) << "connect: " << hostname << ":" << service << " (rail " << rail_
+            << ")";
+  struct fi_info* info2 =
+      (resolved != nullptr) ? resolved : resolve(hostname, service, rail_);
+
+  int err = fi_endpoint(domain, info2, &ep_, this);
   if (err != 0) {
     L_(fatal) << "fi_endpoint failed: " << err << "=" << fi_strerror(-err);
     throw LibfabricException("fi_endpoint failed");
@@ -94,10 +104,10 @@ void Connection::connect(const std::string& hostname,
   }
 
   setup_mr(domain);
-  Provider::getInst()->connect(ep_, max_send_wr_, max_send_sge_, max_recv_wr_,
-                               max_recv_sge_, max_inline_data_,
-                               private_data->data(), private_data->size(),
-                               info2->dest_addr);
+  Provider::getInst(rail_)->connect(
+      ep_, max_send_wr_, max_send_sge_, max_recv_wr_, max_recv_sge_,
+      max_inline_data_, private_data->data(), private_data->size(),
+      info2->dest_addr);
   setup();
 }
 
@@ -142,7 +152,12 @@ void Connection::on_disconnected(struct fi_eq_cm_entry* /* event */) {
 
 void Connection::on_connect_request(struct fi_eq_cm_entry* event,
                                     struct fid_domain* pd,
-                                    struct fid_cq* cq) {
+                                    struct fid_cq* cq,
+                                    struct fid_ep* srx) {
+  shared_receive_ = (srx != nullptr);
+  if (shared_receive_) {
+    event->info->ep_attr->rx_ctx_cnt = FI_SHARED_CONTEXT;
+  }
   int err = fi_endpoint(pd, event->info, &ep_, this);
   if (err != 0) {
     L_(fatal) << "fi_endpoint failed: " << err << "=" << fi_strerror(-err);
@@ -161,6 +176,14 @@ void Connection::on_connect_request(struct fi_eq_cm_entry* event,
     L_(fatal) << "fi_ep_bind failed to cq: " << err << "=" << fi_strerror(-err);
     throw LibfabricException("fi_ep_bind failed to cq");
   }
+  if (shared_receive_) {
+    err = fi_ep_bind(ep_, (fid_t)srx, 0);
+    if (err != 0) {
+      L_(fatal) << "fi_ep_bind failed to srx: " << err << "="
+                << fi_strerror(-err);
+      throw LibfabricException("fi_ep_bind failed to srx");
+    }
+  }
 #pragma GCC diagnostic pop
 
   // setup(pd);
@@ -240,25 +263,29 @@ std::unique_ptr<std::vector<uint8_t>> Connection::get_private_data() {
 }
 
 void Connection::setup_heartbeat() {
-  heartbeat_recv_descs[0] = fi_mr_desc(mr_heartbeat_recv_);
   heartbeat_send_descs[0] = fi_mr_desc(mr_heartbeat_send_);
 
-  // setup send and receive buffers
-  memset(&heartbeat_recv_wr_iovec, 0, sizeof(struct iovec));
-  heartbeat_recv_wr_iovec.iov_base = &recv_heartbeat_message_;
-  heartbeat_recv_wr_iovec.iov_len = sizeof(recv_heartbeat_message_);
-
-  memset(&heartbeat_recv_wr, 0, sizeof(struct fi_msg));
-  heartbeat_recv_wr.msg_iov = &heartbeat_recv_wr_iovec;
-  heartbeat_recv_wr.desc = heartbeat_recv_descs;
-  heartbeat_recv_wr.iov_count = 1;
-  heartbeat_recv_wr.tag = ConstVariables::HEARTBEAT_MESSAGE_TAG;
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wold-style-cast"
-  struct fi_custom_context* context =
-      LibfabricContextPool::getInst()->getContext();
-  context->op_context = (ID_HEARTBEAT_RECEIVE_STATUS | (index_ << 8));
-  heartbeat_recv_wr.context = context;
+  struct fi_custom_context* context = nullptr;
+  // with a shared receive context, heartbeats are received there
+  if (!shared_receive_) {
+    heartbeat_recv_descs[0] = fi_mr_desc(mr_heartbeat_recv_);
+
+    // setup send and receive buffers
+    memset(&heartbeat_recv_wr_iovec, 0, sizeof(struct iovec));
+    heartbeat_recv_wr_iovec.iov_base = &recv_heartbeat_message_;
+    heartbeat_recv_wr_iovec.iov_len = sizeof(recv_heartbeat_message_);
+
+    memset(&heartbeat_recv_wr, 0, sizeof(struct fi_msg));
+    heartbeat_recv_wr.msg_iov = &heartbeat_recv_wr_iovec;
+    heartbeat_recv_wr.desc = heartbeat_recv_descs;
+    heartbeat_recv_wr.iov_count = 1;
+    heartbeat_recv_wr.tag = ConstVariables::HEARTBEAT_MESSAGE_TAG;
+    context = LibfabricContextPool::getInst()->getContext();
+    context->op_context = (ID_HEARTBEAT_RECEIVE_STATUS | (index_ << 8));
+    heartbeat_recv_wr.context = context;
+  }
 #pragma GCC diagnostic pop
 
   memset(&heartbeat_send_wr_iovec, 0, sizeof(struct iovec));
@@ -283,19 +310,21 @@ void Connection::setup_heartbeat() {
 
 void Connection::setup_heartbeat_mr(struct fid_domain* pd) {
   // register memory regions
-  int res =
-      fi_mr_reg(pd, &recv_heartbeat_message_, sizeof(recv_heartbeat_message_),
-                FI_RECV | FI_TAGGED, 0, Provider::requested_key++, 0,
-                &mr_heartbeat_recv_, nullptr);
-  if (res != 0) {
-    L_(fatal) << "fi_mr_reg failed for heartbeat recv msg: " << res << "="
-              << fi_strerror(-res);
-    throw LibfabricException("fi_mr_reg failed for heartbeat recv msg");
-  }
+  int res = 0;
+  if (!shared_receive_) {
+    res = fi_mr_reg(pd, &recv_heartbeat_message_,
+                    sizeof(recv_heartbeat_message_), FI_RECV | FI_TAGGED, 0,
+                    Provider::requested_key++, 0, &mr_heartbeat_recv_, nullptr);
+    if (res != 0) {
+      L_(fatal) << "fi_mr_reg failed for heartbeat recv msg: " << res << "="
+                << fi_strerror(-res);
+      throw LibfabricException("fi_mr_reg failed for heartbeat recv msg");
+    }
 
-  if (mr_heartbeat_recv_ == nullptr)
-    throw LibfabricException(
-        "registration of memory region failed in Connection");
+    if (mr_heartbeat_recv_ == nullptr)
+      throw LibfabricException(
+          "registration of memory region failed in Connection");
+  }
 
   res = fi_mr_reg(pd, &send_heartbeat_message_, sizeof(send_heartbeat_message_),
                   FI_SEND | FI_TAGGED, 0, Provider::requested_key++, 0,
@@ -312,6 +341,9 @@ void Connection::setup_heartbeat_mr(struct fid_domain* pd) {
 }
 
 void Connection::post_recv_heartbeat_message() {
+  if (shared_receive_) {
+    return;
+  }
   if (false) {
     L_(info) << "[i" << remote_index_ << "] "
              << "[" << index_ << "] "
@@ -336,15 +368,16 @@ void Connection::post_send_heartbeat_message() {
   post_send_msg(&heartbeat_send_wr);
 }
 
-bool Connection::post_send_msg(const struct fi_msg_tagged* wr) {
+bool Connection::post_send_msg(const struct fi_msg_tagged* wr,
+                               uint64_t flags) {
   // We need only FI_INJECT_COMPLETE but this is not supported with GNI
-  uint64_t flags = FI_COMPLETION;
   int err = fi_tsendmsg(ep_, wr, flags);
   if (err != 0) {
     // dump_send_wr(wr);
-    L_(fatal) << "previous send requests: " << total_send_requests_;
-    L_(fatal) << "previous recv requests: " << total_recv_requests_;
-    L_(fatal) << "fi_sendmsg failed: " << err << "=" << fi_strerror(-err);
+    L_LIMITED(fatal) << "fi_sendmsg failed: " << err << "="
+                     << fi_strerror(-err)
+                     << ", previous send requests: " << total_send_requests_
+                     << ", previous recv requests: " << total_recv_requests_;
     // throw LibfabricException("fi_sendmsg failed");
     return false;
   }
@@ -363,9 +396,10 @@ bool Connection::post_send_rdma(struct fi_msg_rma* wr, uint64_t flags) {
   int err = fi_writemsg(ep_, wr, flags);
   if (err != 0) {
     // dump_send_wr(wr);
-    L_(fatal) << "previous send requests: " << total_send_requests_;
-    L_(fatal) << "previous recv requests: " << total_recv_requests_;
-    L_(fatal) << "fi_writemsg failed: " << err << "=" << fi_strerror(-err);
+    L_LIMITED(fatal) << "fi_writemsg failed: " << err << "="
+                     << fi_strerror(-err)
+                     << ", previous send requests: " << total_send_requests_
+                     << ", previous recv requests: " << total_recv_requests_;
     // throw LibfabricException("fi_writemsg failed");
     return false;
   }
@@ -379,7 +413,8 @@ bool Connection::post_send_rdma(struct fi_msg_rma* wr, uint64_t flags) {
 bool Connection::post_recv_msg(const struct fi_msg_tagged* wr) {
   int err = fi_trecvmsg(ep_, wr, FI_COMPLETION);
   if (err != 0) {
-    L_(fatal) << "fi_recvmsg failed: " << err << "=" << fi_strerror(-err);
+    L_LIMITED(fatal) << "fi_recvmsg failed: " << err << "="
+                     << fi_strerror(-err);
     // throw LibfabricException("fi_recvmsg failed");
     return false;
   }
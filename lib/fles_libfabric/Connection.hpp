@@ -58,12 +58,22 @@ public:
 	 \param domain Domain
 	 \param cq cq
 	 \param av av
+	 \param resolved Address information from resolve() (taken over), or
+	 nullptr to resolve the target now
   */
   void connect(const std::string& hostname,
                const std::string& service,
                struct fid_domain* domain,
                struct fid_cq* cq,
-               struct fid_av* av);
+               struct fid_av* av,
+               struct fi_info* resolved = nullptr);
+
+  /// Resolve the address of a target hostname and service on a rail.
+  /** As this may block for a network round trip, it can be called for
+      several targets concurrently before connecting. */
+  static struct fi_info* resolve(const std::string& hostname,
+                                 const std::string& service,
+                                 std::size_t rail);
 
   void disconnect();
 
@@ -79,9 +89,12 @@ public:
   virtual void on_disconnected(struct fi_eq_cm_entry* event);
 
   /// Handle RDMA_CM_EVENT_CONNECT_REQUEST event for this connection.
+  /** If srx is given, the endpoint receives through this shared receive
+      context instead of posting its own receive requests. */
   virtual void on_connect_request(struct fi_eq_cm_entry* event,
                                   struct fid_domain* pd,
-                                  struct fid_cq* cq);
+                                  struct fid_cq* cq,
+                                  struct fid_ep* srx = nullptr);
 
   virtual std::unique_ptr<std::vector<uint8_t>> get_private_data();
 
@@ -106,6 +119,11 @@ public:
   /// Post a receive work request (WR) to the receive queue
   virtual void post_recv_heartbeat_message();
 
+  /// Handle a heartbeat message received through a shared receive context.
+  void set_recv_heartbeat_message(const HeartbeatMessage& message) {
+    recv_heartbeat_message_ = message;
+  }
+
   /// Post a send work request (WR) to the send queue
   virtual void post_send_heartbeat_message();
 
@@ -115,8 +133,21 @@ public:
   /// Retrieve index of this connection in the remote connection group.
   uint_fast16_t remote_index() const { return remote_index_; }
 
+  /// Retrieve the rail (network interface) used by this connection.
+  std::size_t rail() const { return rail_; }
+
+  /// Select the rail to use, before connecting.
+  void set_rail(std::size_t rail) { rail_ = rail; }
+
   bool done() const { return done_; }
 
+  /// Retrieve whether the peer takes part in the run (false while a standby
+  /// compute node has not joined).
+  bool member() const { return member_; }
+
+  /// Set whether the peer takes part in the run.
+  void set_member(bool member) { member_ = member; }
+
   void mark_done() { done_ = true; }
 
   /// Retrieve the total number of bytes transmitted.
@@ -155,7 +186,8 @@ protected:
   bool post_send_rdma(struct fi_msg_rma* wr, uint64_t flags);
 
   /// Post an Libfabric message send work request
-  bool post_send_msg(const struct fi_msg_tagged* wr);
+  bool post_send_msg(const struct fi_msg_tagged* wr,
+                     uint64_t flags = FI_COMPLETION);
 
   /// Post an Libfabric message recveive request.
   bool post_recv_msg(const struct fi_msg_tagged* wr);
@@ -179,9 +211,15 @@ protected:
   /// Index of this connection in the remote group of connections.
   uint_fast16_t remote_index_;
 
+  /// Rail (provider instance) of this connection.
+  std::size_t rail_ = 0;
+
   /// Flag indicating connection finished state.
   bool done_ = false;
 
+  /// Flag indicating that the peer takes part in the run.
+  bool member_ = true;
+
   /// connection configuration
   uint32_t max_send_wr_;
   uint32_t max_send_sge_;
@@ -191,6 +229,9 @@ protected:
 
   struct fid_ep* ep_ = nullptr;
 
+  /// Flag, true if receiving through a shared receive context
+  bool shared_receive_ = false;
+
   bool connection_oriented_ = false;
 
   /// check if new data should be sent
@@ -4,7 +4,11 @@
 #pragma once
 
 #include "ConnectionGroupWorker.hpp"
+#include "ConstVariables.hpp"
+#include "MemoryRegionCache.hpp"
+#include "ProgressMode.hpp"
 #include "RequestIdentifier.hpp"
+#include "dfs/HeartbeatAgent.hpp"
 #include "dfs/SchedulerOrchestrator.hpp"
 #include "log.hpp"
 #include "providers/LibfabricBarrier.hpp"
@@ -15,13 +19,21 @@
 #include <rdma/fabric.h>
 #include <rdma/fi_domain.h>
 #include <rdma/fi_endpoint.h>
+#include <rdma/fi_eq.h>
 #include <rdma/fi_errno.h>
 #include <set>
 
+#include <array>
+#include <cerrno>
 #include <chrono>
+#include <cstring>
 #include <fstream>
+#include <memory>
+#include <optional>
 
+#include <sys/epoll.h>
 #include <sys/uio.h>
+#include <unistd.h>
 
 namespace tl_libfabric {
 /// Libfabric connection group base class.
@@ -32,20 +44,51 @@ template <typename CONNECTION>
 class ConnectionGroup : public ConnectionGroupWorker {
 public:
   /// The ConnectionGroup default constructor.
-  ConnectionGroup(std::string local_node_name) {
+  /**
+   * \param progress_mode Strategy of the event loop when idle
+   * \param spin_time     Time to keep polling after the last activity
+   *                      (Adaptive mode only)
+   * \param rail_host_names Local addresses of additional network
+   *                      interfaces (connection-oriented providers only)
+   */
+  ConnectionGroup(
+      std::string local_node_name,
+      ProgressMode progress_mode = ProgressMode::Busy,
+      std::chrono::microseconds spin_time = std::chrono::microseconds(100),
+      const std::vector<std::string>& rail_host_names = {})
+      : progress_mode_(progress_mode),
+        spin_time_(progress_mode == ProgressMode::Blocking
+                       ? std::chrono::microseconds::zero()
+                       : spin_time) {
     Provider::init(local_node_name);
+    if (!rail_host_names.empty() &&
+        !Provider::getInst()->is_connection_oriented()) {
+      L_(warning) << "multiple rails require a connection-oriented provider, "
+                     "additional rails ignored";
+      Provider::init_rails({});
+    } else {
+      Provider::init_rails(rail_host_names);
+      rail_host_names_ = rail_host_names;
+    }
     // std::cout << "ConnectionGroup constructor" << std::endl;
-    struct fi_eq_attr eq_attr;
-    memset(&eq_attr, 0, sizeof(eq_attr));
-    eq_attr.size = 10;
-    eq_attr.wait_obj = FI_WAIT_NONE;
-    int res =
-        fi_eq_open(Provider::getInst()->get_fabric(), &eq_attr, &eq_, nullptr);
-    if (res) {
-      L_(fatal) << "fi_eq_open failed: " << res << "=" << fi_strerror(-res);
-      throw LibfabricException("fi_eq_open failed");
+    eq_ = open_event_queue(0);
+    rails_.resize(Provider::rail_count() - 1);
+    for (std::size_t r = 1; r < Provider::rail_count(); ++r) {
+      rails_[r - 1].eq = open_event_queue(r);
     }
     cqs_.resize(MAX_CQ_INSTANCE);
+
+    if (progress_mode_ != ProgressMode::Busy) {
+      epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+      if (epoll_fd_ < 0) {
+        L_(fatal) << "epoll_create1 failed: " << strerror(errno);
+        throw LibfabricException("epoll_create1 failed");
+      }
+      add_wait_fid(&eq_->fid);
+      for (auto& rail : rails_) {
+        add_wait_fid(&rail.eq->fid);
+      }
+    }
   }
 
   ConnectionGroup(const ConnectionGroup&) = delete;
@@ -53,24 +96,44 @@ public:
 
   /// The ConnectionGroup default destructor.
   ~ConnectionGroup() override {
+    heartbeat_agent_ = nullptr;
     for (auto& c : conn_) {
       c = nullptr;
     }
+    for (std::size_t r = 0; r < rail_count(); ++r) {
+      if (rail_domain(r) != nullptr) {
+        MemoryRegionCache::getInst()->release(rail_domain(r));
+      }
+    }
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wold-style-cast"
     fi_close((fid_t)eq_);
     if (pep_ != nullptr)
       fi_close((fid_t)pep_);
+    for (auto& rail : rails_) {
+      if (rail.pep != nullptr)
+        fi_close((fid_t)rail.pep);
+      fi_close((fid_t)rail.eq);
+    }
 #pragma GCC diagnostic pop
 
     pep_ = nullptr;
+
+    if (epoll_fd_ >= 0) {
+      close(epoll_fd_);
+    }
   }
 
   void
   accept(const std::string& hostname, unsigned short port, unsigned int count) {
     conn_.resize(count);
     Provider::getInst()->accept(pep_, hostname, port, count, eq_);
+    // the input nodes select the rail, listen on all of them
+    for (std::size_t r = 1; r < rail_count(); ++r) {
+      Provider::getInst(r)->accept(rails_[r - 1].pep, rail_host_names_[r - 1],
+                                   port, count, rails_[r - 1].eq);
+    }
 
     L_(debug) << "waiting for " << count << " connections";
   }
@@ -78,12 +141,23 @@ public:
   /// Initiate disconnection.
   void disconnect() {
     for (auto& c : conn_) {
-      c->disconnect();
+      if (c->member()) {
+        c->disconnect();
+      }
     }
   }
 
   /// The connection manager event handler.
   void poll_cm_events() {
+    poll_cm_events(eq_, 0);
+    for (std::size_t r = 1; r < rail_count(); ++r) {
+      poll_cm_events(rails_[r - 1].eq, r);
+    }
+  }
+
+  /// The connection manager event handler for the event queue of a rail.
+  void poll_cm_events(struct fid_eq* eq, std::size_t rail) {
+    cm_rail_ = rail;
     const size_t max_private_data_size = 256; // verbs: 56, usnic and socket 256
     const size_t event_size =
         sizeof(struct fi_eq_cm_entry) + max_private_data_size;
@@ -91,7 +165,7 @@ public:
 
     uint32_t event_kind;
 
-    ssize_t count = fi_eq_read(eq_, &event_kind, buffer, event_size, 0);
+    ssize_t count = fi_eq_read(eq, &event_kind, buffer, event_size, 0);
     if (count > 0) {
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wold-style-cast"
@@ -104,7 +178,7 @@ public:
 
       memset(&err_event, 0, sizeof(err_event));
 
-      count = fi_eq_readerr(eq_, &err_event, 0);
+      count = fi_eq_readerr(eq, &err_event, 0);
       if (count > 0) {
         switch (err_event.err) {
         case ECONNREFUSED: {
@@ -112,7 +186,10 @@ public:
           break;
         }
         case ETIMEDOUT: {
-          // on_rejected(&err_event);
+          // with multiple rails, the connection can fail over to another one
+          if (rail_count() > 1) {
+            on_rejected(&err_event);
+          }
           break;
         }
         default: {
@@ -128,16 +205,21 @@ public:
   }
 
   /// The Libfabric completion notification handler.
+  /** In Adaptive and Blocking mode, this also puts the thread to sleep if
+      there has been no activity for longer than the spin time. */
   int poll_completion() {
-    struct fi_cq_tagged_entry* wc =
-        new struct fi_cq_tagged_entry[MAX_CQ_ENTRIES];
+    struct fi_cq_tagged_entry* wc = completion_entries_.data();
     int ne;
     int ne_total = 0;
 
     agg_CQ_count_++;
     std::chrono::high_resolution_clock::time_point start, end;
 
-    for (uint16_t i = 0; i < MAX_CQ_INSTANCE; i++) {
+    // completions of all rails are merged into the same handler
+    for (std::size_t i = 0; i < cqs_.size(); i++) {
+      if (cqs_[i] == nullptr) {
+        continue;
+      }
       start = std::chrono::high_resolution_clock::now();
       ne = fi_cq_read(cqs_[i], wc, MAX_CQ_ENTRIES);
       if (ne != 0) {
@@ -205,6 +287,8 @@ public:
       }
     }
 
+    progress(ne_total > 0);
+
     return ne_total;
   }
 
@@ -215,6 +299,25 @@ public:
 
   size_t size() const { return conn_.size(); }
 
+  /// Retrieve the number of rails (network interfaces).
+  std::size_t rail_count() const { return rails_.size() + 1; }
+
+  /// Retrieve the protection domain of a rail (nullptr if not yet opened).
+  struct fid_domain* rail_domain(std::size_t rail) const {
+    return rail == 0 ? pd_ : rails_.at(rail - 1).pd;
+  }
+
+  /// Retrieve the event queue of a rail.
+  struct fid_eq* rail_event_queue(std::size_t rail) const {
+    return rail == 0 ? eq_ : rails_.at(rail - 1).eq;
+  }
+
+  /// Retrieve the completion queue of a connection on a rail.
+  struct fid_cq* rail_completion_queue(std::size_t rail,
+                                       uint32_t conn_index) const {
+    return rail == 0 ? completion_queue(conn_index) : rails_.at(rail - 1).cq;
+  }
+
   /// Retrieve the total number of bytes transmitted.
   uint64_t aggregate_bytes_sent() const { return aggregate_bytes_sent_; }
 
@@ -238,8 +341,24 @@ public:
     L_(info) << "summary: Agg. CQ retrieving time " << agg_CQ_time_ / 1000000.
              << " s and processing time " << agg_CQ_COMP_time_ / 1000000.
              << " s in " << agg_CQ_count_ << " calls";
+    L_(info) << "summary: idle time " << agg_spin_time() << " s spinning, "
+             << agg_sleep_time() << " s sleeping in " << agg_sleep_count_
+             << " waits";
+  }
+
+  /// Retrieve the total idle time spent polling, in seconds.
+  double agg_spin_time() const {
+    return std::chrono::duration<double>(agg_spin_time_).count();
+  }
+
+  /// Retrieve the total idle time spent blocked in epoll_wait, in seconds.
+  double agg_sleep_time() const {
+    return std::chrono::duration<double>(agg_sleep_time_).count();
   }
 
+  /// Retrieve the number of blocking waits.
+  uint64_t agg_sleep_count() const { return agg_sleep_count_; }
+
   /// The "main" function of an ConnectionGroup decendant.
   virtual void operator()() override = 0;
 
@@ -255,7 +374,7 @@ protected:
 
     conn->on_established(event);
     ++connected_;
-    on_connected(pd_);
+    on_connected(rail_domain(conn->rail()));
   }
 
   /// Handle RDMA_CM_EVENT_CONNECT_REQUEST event.
@@ -302,7 +421,8 @@ protected:
       cq_attr.flags = 0;
       // cq_attr.format = FI_CQ_FORMAT_CONTEXT;
       cq_attr.format = FI_CQ_FORMAT_TAGGED;
-      cq_attr.wait_obj = FI_WAIT_NONE;
+      cq_attr.wait_obj =
+          progress_mode_ == ProgressMode::Busy ? FI_WAIT_NONE : FI_WAIT_FD;
       cq_attr.signaling_vector = Provider::vector++; // ??
       cq_attr.wait_cond = FI_CQ_COND_NONE;
       cq_attr.wait_set = nullptr;
@@ -312,6 +432,9 @@ protected:
                   << fi_strerror(-res);
         throw LibfabricException("fi_cq_open failed");
       }
+      if (progress_mode_ != ProgressMode::Busy) {
+        add_wait_fid(&cqs_[i]->fid);
+      }
     }
 
     if (Provider::getInst()->has_av()) {
@@ -333,12 +456,45 @@ protected:
     }
   }
 
+  /// Open the protection domain and completion queue of an additional rail.
+  void init_rail_context(std::size_t rail, fi_info* info) {
+    Rail& r = rails_.at(rail - 1);
+    int res =
+        fi_domain(Provider::getInst(rail)->get_fabric(), info, &r.pd, nullptr);
+    if (!r.pd) {
+      L_(fatal) << "fi_domain failed on rail " << rail << ": " << -res << "="
+                << fi_strerror(-res);
+      throw LibfabricException("fi_domain failed");
+    }
+
+    struct fi_cq_attr cq_attr;
+    memset(&cq_attr, 0, sizeof(cq_attr));
+    cq_attr.size = num_cqe_;
+    cq_attr.format = FI_CQ_FORMAT_TAGGED;
+    cq_attr.wait_obj =
+        progress_mode_ == ProgressMode::Busy ? FI_WAIT_NONE : FI_WAIT_FD;
+    cq_attr.signaling_vector = Provider::vector++;
+    cq_attr.wait_cond = FI_CQ_COND_NONE;
+    res = fi_cq_open(r.pd, &cq_attr, &r.cq, nullptr);
+    if (!r.cq) {
+      L_(fatal) << "fi_cq_open failed on rail " << rail << ": " << -res << "="
+                << fi_strerror(-res);
+      throw LibfabricException("fi_cq_open failed");
+    }
+    cqs_.push_back(r.cq);
+    if (progress_mode_ != ProgressMode::Busy) {
+      add_wait_fid(&r.cq->fid);
+    }
+  }
+
   void sync_buffer_positions() {
     for (auto& c : conn_) {
-      c->try_sync_buffer_positions();
+      if (c->member()) {
+        c->try_sync_buffer_positions();
+      }
     }
 
-    auto now = std::chrono::system_clock::now();
+    auto now = Scheduler::clock::now();
     scheduler_.add(std::bind(&ConnectionGroup::sync_buffer_positions, this),
                    now + std::chrono::milliseconds(0));
   }
@@ -350,12 +506,26 @@ protected:
     std::vector<uint32_t> inactive_conns =
         SchedulerOrchestrator::retrieve_new_inactive_connections();
     for (uint32_t inactive : inactive_conns) {
-      if (!conn_[inactive]->done()) {
+      if (conn_[inactive]->member() && !conn_[inactive]->done()) {
         conn_[inactive]->prepare_heartbeat();
       }
     }
   }
 
+  /// Pass the liveness detected by the heartbeat agent to the scheduler.
+  void sync_heartbeat_agent() {
+    for (uint32_t peer : heartbeat_agent_->retrieve_alive_peers()) {
+      if (conn_[peer]->member() && !conn_[peer]->done() &&
+          !SchedulerOrchestrator::is_connection_timed_out(peer)) {
+        SchedulerOrchestrator::log_heartbeat(peer);
+      }
+    }
+    scheduler_.add([this] { sync_heartbeat_agent(); },
+                   Scheduler::clock::now() +
+                       std::chrono::microseconds(
+                           ConstVariables::HEARTBEAT_TABLE_INTERVAL));
+  }
+
   const uint32_t num_cqe_ = 1000000;
 
   /// Libfabric protection domain.
@@ -366,9 +536,12 @@ protected:
   // TODO make it configurable
   uint16_t MAX_CQ_INSTANCE = 10;
 
-  /// Libfabric completion queues
+  /// Libfabric completion queues (of rail 0, followed by the other rails)
   std::vector<struct fid_cq*> cqs_;
 
+  /// Rail of the connection manager event being dispatched
+  std::size_t cm_rail_ = 0;
+
   /// Libfabric address vector.
   struct fid_av* av_ = nullptr;
 
@@ -402,7 +575,35 @@ protected:
 
   bool connection_oriented_ = false;
 
+  /// Heartbeats on a dedicated endpoint (for connection-less fabrics).
+  std::unique_ptr<HeartbeatAgent> heartbeat_agent_;
+
 private:
+  /// Libfabric objects of an additional rail (rail 0 uses eq_, pd_, cqs_).
+  struct Rail {
+    struct fid_eq* eq = nullptr;
+    struct fid_domain* pd = nullptr;
+    struct fid_cq* cq = nullptr;
+    struct fid_pep* pep = nullptr;
+  };
+
+  /// Open the connection manager event queue of a rail.
+  struct fid_eq* open_event_queue(std::size_t rail) {
+    struct fi_eq_attr eq_attr;
+    memset(&eq_attr, 0, sizeof(eq_attr));
+    eq_attr.size = 10;
+    eq_attr.wait_obj =
+        progress_mode_ == ProgressMode::Busy ? FI_WAIT_NONE : FI_WAIT_FD;
+    struct fid_eq* eq = nullptr;
+    int res = fi_eq_open(Provider::getInst(rail)->get_fabric(), &eq_attr, &eq,
+                         nullptr);
+    if (res) {
+      L_(fatal) << "fi_eq_open failed: " << res << "=" << fi_strerror(-res);
+      throw LibfabricException("fi_eq_open failed");
+    }
+    return eq;
+  }
+
   /// Connection manager event dispatcher. Called by the CM event loop.
   void on_cm_event(uint32_t event_kind,
                    struct fi_eq_cm_entry* event,
@@ -419,13 +620,87 @@ private:
       on_disconnected(event);
       break;
     default:
-      L_(warning) << "unknown eq event";
+      L_LIMITED(warning) << "unknown eq event";
     }
   }
 
   /// Completion notification event dispatcher. Called by the event loop.
   virtual void on_completion(uint64_t wc) = 0;
 
+  /// Register the wait fd of an EQ or CQ with the epoll set.
+  void add_wait_fid(struct fid* fid) {
+    int fd = -1;
+    int res = fi_control(fid, FI_GETWAIT, static_cast<void*>(&fd));
+    if (res) {
+      L_(fatal) << "fi_control(FI_GETWAIT) failed: " << res << "="
+                << fi_strerror(-res);
+      throw LibfabricException("fi_control(FI_GETWAIT) failed");
+    }
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+      L_(fatal) << "epoll_ctl failed: " << strerror(errno);
+      throw LibfabricException("epoll_ctl failed");
+    }
+    wait_fids_.push_back(fid);
+  }
+
+  /// Account idle time and block once the spin time has elapsed.
+  void progress(bool active) {
+    const auto now = std::chrono::steady_clock::now();
+    if (active) {
+      if (idle_begin_) {
+        agg_spin_time_ += now - *idle_begin_;
+        idle_begin_.reset();
+      }
+      sleeping_ = false;
+      return;
+    }
+    if (!idle_begin_) {
+      idle_begin_ = now;
+    }
+    if (progress_mode_ == ProgressMode::Busy ||
+        (!sleeping_ && now - *idle_begin_ < spin_time_)) {
+      return;
+    }
+
+    agg_spin_time_ += now - *idle_begin_;
+    sleeping_ = true;
+    wait_for_events();
+    idle_begin_ = std::chrono::steady_clock::now();
+    agg_sleep_time_ += *idle_begin_ - now;
+  }
+
+  /// Block until an EQ or CQ is signaled or max_sleep_time_ has elapsed.
+  /** The timeout bounds the delay of scheduled events and of work that is
+      not signaled through libfabric, e.g., new data in the input buffer. */
+  void wait_for_events() {
+    // Sleeping is only safe if no completions are pending
+    int res = fi_trywait(Provider::getInst()->get_fabric(), wait_fids_.data(),
+                         static_cast<int>(wait_fids_.size()));
+    if (res == -FI_EAGAIN) {
+      return;
+    }
+    if (res) {
+      L_(fatal) << "fi_trywait failed: " << res << "=" << fi_strerror(-res);
+      throw LibfabricException("fi_trywait failed");
+    }
+
+    ++agg_sleep_count_;
+    std::array<struct epoll_event, 16> events;
+    const int timeout =
+        static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                             max_sleep_time_)
+                             .count());
+    if (epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()),
+                   timeout) < 0 &&
+        errno != EINTR) {
+      L_(fatal) << "epoll_wait failed: " << strerror(errno);
+      throw LibfabricException("epoll_wait failed");
+    }
+  }
+
   /// Total number of bytes transmitted.
   uint64_t aggregate_bytes_sent_ = 0;
 
@@ -440,6 +715,12 @@ private:
   /// RDMA connection manager ID (for connection-oriented fabrics)
   struct fid_pep* pep_ = nullptr;
 
+  /// Local addresses of the additional rails
+  std::vector<std::string> rail_host_names_;
+
+  /// Libfabric objects of the additional rails
+  std::vector<Rail> rails_;
+
   /// LOGGING completion queues statistics
   uint64_t agg_CQ_time_ = 0;
 
@@ -448,6 +729,37 @@ private:
   uint64_t agg_CQ_COMP_time_ = 0;
 
   // TODO detect the number of messages that we are waiting for
-  const int MAX_CQ_ENTRIES = 1000;
+  static constexpr int MAX_CQ_ENTRIES = 1000;
+
+  /// Buffer for the entries retrieved by fi_cq_read
+  std::array<struct fi_cq_tagged_entry, MAX_CQ_ENTRIES> completion_entries_;
+
+  /// Strategy of the event loop when idle
+  const ProgressMode progress_mode_;
+
+  /// Time to keep polling after the last activity before blocking
+  const std::chrono::microseconds spin_time_;
+
+  /// Maximum duration of a single blocking wait
+  const std::chrono::milliseconds max_sleep_time_{1};
+
+  /// epoll instance watching the wait fds of the EQ and all CQs
+  int epoll_fd_ = -1;
+
+  /// The EQ and CQs to pass to fi_trywait
+  std::vector<struct fid*> wait_fids_;
+
+  /// Begin of the current idle period, if any
+  std::optional<std::chrono::steady_clock::time_point> idle_begin_;
+
+  /// Flag indicating that the spin time of the idle period has elapsed
+  bool sleeping_ = false;
+
+  /// LOGGING idle time statistics
+  std::chrono::steady_clock::duration agg_spin_time_{};
+
+  std::chrono::steady_clock::duration agg_sleep_time_{};
+
+  uint64_t agg_sleep_count_ = 0;
 };
 } // namespace tl_libfabric
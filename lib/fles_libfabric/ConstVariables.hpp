@@ -35,6 +35,32 @@ struct ConstVariables {
 
   const static uint64_t TIMESLICE_TIMEOUT = 200000000; // in microseconds
 
+  const static uint64_t UNSIGNALED_WRITE_FLUSH_DELAY = 100; // in microseconds
+
+  const static uint64_t HEARTBEAT_TABLE_INTERVAL = 10000; // in microseconds
+
+  const static uint8_t PLACEMENT_MAX_WEIGHT = 4;
+
+  const static uint8_t PLACEMENT_PRESSURE_THRESHOLD =
+      50; // Buffer pressure (in percent) before down-weighting a compute node
+
+  const static uint32_t SHARED_RECEIVE_STATUS_SLOTS = 128;
+  const static uint32_t SHARED_RECEIVE_HEARTBEAT_SLOTS = 32;
+
+  const static uint32_t BOOTSTRAP_PARALLELISM =
+      32; // Concurrent address resolutions and connection requests
+
+  const static uint64_t STANDBY_CONNECT_INTERVAL =
+      1000000; // in microseconds, between attempts to reach a standby node
+
+  const static uint64_t JOIN_ADMISSION_MARGIN =
+      100; // Timeslices beyond the placement of all input nodes at which a
+           // joining compute node requests to be admitted
+
+  const static uint32_t ADAPTIVE_TIMESLICE_SIZE_RANGE =
+      16; // Factor by which an adaptive timeslice size may fall below the
+          // configured timeslice size
+
   const static uint64_t STATUS_MESSAGE_TAG = 10;
   const static uint64_t HEARTBEAT_MESSAGE_TAG = 20;
   ///-----
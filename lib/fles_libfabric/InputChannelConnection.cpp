@@ -3,6 +3,8 @@
 
 #include "InputChannelConnection.hpp"
 
+#include <algorithm>
+
 namespace tl_libfabric {
 
 InputChannelConnection::InputChannelConnection(
@@ -10,18 +12,34 @@ InputChannelConnection::InputChannelConnection(
     uint_fast16_t connection_index,
     uint_fast16_t remote_connection_index,
     unsigned int max_send_wr,
-    unsigned int max_pending_write_requests)
+    unsigned int max_pending_write_requests,
+    uint32_t write_signal_interval,
+    uint32_t inline_data_size)
     : Connection(eq, connection_index, remote_connection_index),
-      max_pending_write_requests_(max_pending_write_requests) {
+      max_pending_write_requests_(max_pending_write_requests),
+      write_signal_interval_(write_signal_interval) {
   assert(max_pending_write_requests_ > 0);
+  assert(write_signal_interval_ > 0);
 
   max_send_wr_ = max_send_wr; // typical hca maximum: 16k
   max_send_sge_ = 4;          // max. two chunks each for descriptors and data
 
+  // descriptors and data of a timeslice are contiguous in the remote buffer,
+  // so their chunks can be written in one gather write
+  const struct fi_info* info = Provider::getInst()->get_info();
+  if (info != nullptr && info->tx_attr != nullptr) {
+    write_iov_limit_ = static_cast<uint32_t>(std::clamp<std::size_t>(
+        info->tx_attr->iov_limit, 1, max_send_sge_));
+    // small components are injected up to the limit of the provider
+    inline_data_size_ = static_cast<uint32_t>(std::min<std::size_t>(
+        inline_data_size, info->tx_attr->inject_size));
+  }
+
   max_recv_wr_ = 1; // receive only single ComputeNodeStatusMessage struct
   max_recv_sge_ = 1;
 
-  max_inline_data_ = sizeof(fles::TimesliceComponentDescriptor);
+  max_inline_data_ = std::max<uint32_t>(
+      sizeof(fles::TimesliceComponentDescriptor), inline_data_size_);
 
   send_status_message_.info.index = remote_index_;
 
@@ -124,26 +142,109 @@ bool InputChannelConnection::send_data(struct iovec* sge,
   }
   num_sge -= num_sge_cut;
 
+  const uint64_t total_length =
+      data_length + desc_length * sizeof(fles::MicrosliceDescriptor);
+  const bool inlined = num_sge2 == 0 &&
+                       num_sge <= static_cast<int>(write_iov_limit_) &&
+                       total_length <= inline_data_size_;
+
+  // Only the last write of every Nth timeslice requests a completion. The
+  // writes without completion are retired by the next signaled write or by a
+  // fenced status message.
+  const bool signaled =
+      !inlined && unsignaled_count_ + 1 >= write_signal_interval_;
+  const uint64_t last_flags =
+      signaled ? FI_FENCE | FI_DELIVERY_COMPLETE | FI_COMPLETION : FI_FENCE;
+  PostedTimeslice posted{timeslice, next_write_sequence_, signaled,
+                         std::chrono::steady_clock::now(), {}, inlined};
+
+  if (inlined) {
+    res = post_inline_write(
+        sge, desc, num_sge,
+        remote_info_.data.addr + (cn_wp_data & cn_data_buffer_mask),
+        total_length);
+  } else {
+    res = post_region_writes(
+        sge, desc, num_sge,
+        remote_info_.data.addr + (cn_wp_data & cn_data_buffer_mask),
+        ID_WRITE_DATA | (timeslice << 24) | (index_ << 8), num_sge2 == 0,
+        last_flags, posted);
+  }
+
+  // the part behind the end of the remote buffer wraps around to its start
+  if (num_sge2 && res) {
+    res = post_region_writes(
+        sge2, desc2, num_sge2, remote_info_.data.addr,
+        ID_WRITE_DATA_WRAP | (timeslice << 24) | (index_ << 8), true,
+        last_flags, posted);
+  }
+  if (!res)
+    return false;
+
+  ++pending_write_requests_;
+  if (inlined) {
+    inline_fence_due_ = true;
+  } else {
+    unsignaled_count_ = signaled ? 0 : unsignaled_count_ + 1;
+  }
+  ++next_write_sequence_;
+  posted_timeslices_.push_back(std::move(posted));
+
+  // timeslice component descriptor
+  fles::TimesliceComponentDescriptor tscdesc;
+  tscdesc.ts_num = timeslice;
+  // tscdesc.ts_desc = (cn_wp_pending_.desc+ cn_wp_.desc);
+  tscdesc.offset = cn_wp_data;
+  tscdesc.size = total_length;
+  tscdesc.num_microslices = desc_length;
+
+  if (false) {
+    L_(info) << "[i" << remote_index_ << "] "
+             << "[" << index_ << "] "
+             << "POST SEND data (timeslice " << timeslice << ")"
+             << " tscdesc.ts_num " << tscdesc.ts_num << " tscdesc.ts_desc "
+             << last_timeslice_info.second << " tscdesc.offset "
+             << tscdesc.offset << " tscdesc.size " << tscdesc.size
+             << " tscdesc.num_microslices " << tscdesc.num_microslices
+             << " cn_wp_.data " << cn_wp_.data << " cn_wp_pending_.data "
+             << cn_wp_pending_.data << " skip " << skip;
+  }
+  pending_descriptors_.add(last_timeslice_info.second, tscdesc);
+  assert(pending_write_requests_ <= max_pending_write_requests_);
+  return true;
+}
+
+bool InputChannelConnection::post_region_writes(struct iovec* sge,
+                                                void** desc,
+                                                int num_sge,
+                                                uint64_t remote_addr,
+                                                uint64_t context_id,
+                                                bool last,
+                                                uint64_t last_flags,
+                                                PostedTimeslice& posted) {
   struct fi_msg_rma send_wr_ts;
-  struct fi_msg_rma send_wr_tswrap;
   struct fi_rma_iov rma_iov[1];
   struct fi_custom_context* context;
+  bool res = true;
 
-  uint64_t remote_addr =
-      remote_info_.data.addr + (cn_wp_data & cn_data_buffer_mask);
-  for (int i = 0; i < num_sge; i++) {
+  for (int i = 0; i < num_sge && res;) {
+    int count = std::min<int>(write_iov_limit_, num_sge - i);
+    uint64_t length = 0;
+    for (int j = i; j < i + count; ++j) {
+      length += sge[j].iov_len;
+    }
 
     memset(rma_iov, 0, sizeof(rma_iov));
     rma_iov[0].addr = remote_addr;
-    rma_iov[0].len = sge[i].iov_len;
+    rma_iov[0].len = length;
     rma_iov[0].key = remote_info_.data.rkey;
 
-    remote_addr += sge[i].iov_len;
+    remote_addr += length;
 
     memset(&send_wr_ts, 0, sizeof(send_wr_ts));
     send_wr_ts.msg_iov = &sge[i];
     send_wr_ts.desc = &desc[i];
-    send_wr_ts.iov_count = 1;
+    send_wr_ts.iov_count = count;
     // addr
     send_wr_ts.rma_iov = rma_iov;
     send_wr_ts.rma_iov_count = 1;
@@ -151,77 +252,54 @@ bool InputChannelConnection::send_data(struct iovec* sge,
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wold-style-cast"
     context = LibfabricContextPool::getInst()->getContext();
-    context->op_context = (ID_WRITE_DATA | (timeslice << 24) | (index_ << 8));
+    context->op_context = context_id;
     send_wr_ts.context = context;
 #pragma GCC diagnostic pop
-    if (i + 1 < num_sge || num_sge2 > 0) {
+    i += count;
+    if (!last || i < num_sge) {
       res = post_send_rdma(&send_wr_ts, FI_MORE);
+      posted.contexts.push_back(context);
     } else {
-      res = post_send_rdma(&send_wr_ts,
-                           FI_FENCE | FI_DELIVERY_COMPLETE | FI_COMPLETION);
-      ++pending_write_requests_;
-    }
-  }
-
-  if (num_sge2 && res) {
-    uint64_t remote_addr = remote_info_.data.addr;
-    for (int i = 0; i < num_sge2; i++) {
-
-      rma_iov[0].addr = remote_addr;
-      rma_iov[0].len = sge2[i].iov_len;
-      rma_iov[0].key = remote_info_.data.rkey;
-
-      remote_addr += +sge2[i].iov_len;
-
-      memset(&send_wr_tswrap, 0, sizeof(send_wr_tswrap));
-      send_wr_tswrap.msg_iov = &sge2[i];
-      send_wr_tswrap.desc = &desc2[i];
-      send_wr_tswrap.iov_count = 1;
-      // addr
-      send_wr_tswrap.rma_iov = rma_iov;
-      send_wr_tswrap.rma_iov_count = 1;
-      send_wr_tswrap.addr = partner_addr_;
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wold-style-cast"
-      context = LibfabricContextPool::getInst()->getContext();
-      context->op_context =
-          (ID_WRITE_DATA_WRAP | (timeslice << 24) | (index_ << 8));
-      send_wr_tswrap.context = context;
-#pragma GCC diagnostic pop
-      if (i + 1 < num_sge2) {
-        res = post_send_rdma(&send_wr_tswrap, FI_MORE);
-      } else {
-        res = post_send_rdma(&send_wr_tswrap,
-                             FI_FENCE | FI_DELIVERY_COMPLETE | FI_COMPLETION);
-        ++pending_write_requests_;
+      res = post_send_rdma(&send_wr_ts, last_flags);
+      if (!posted.signaled) {
+        posted.contexts.push_back(context);
       }
     }
   }
-  if (!res)
-    return false;
+  return res;
+}
 
-  // timeslice component descriptor
-  fles::TimesliceComponentDescriptor tscdesc;
-  tscdesc.ts_num = timeslice;
-  // tscdesc.ts_desc = (cn_wp_pending_.desc+ cn_wp_.desc);
-  tscdesc.offset = cn_wp_data;
-  tscdesc.size = data_length + desc_length * sizeof(fles::MicrosliceDescriptor);
-  tscdesc.num_microslices = desc_length;
+bool InputChannelConnection::post_inline_write(struct iovec* sge,
+                                               void** desc,
+                                               int num_sge,
+                                               uint64_t remote_addr,
+                                               uint64_t length) {
+  struct fi_msg_rma send_wr_ts;
+  struct fi_rma_iov rma_iov[1];
 
-  if (false) {
-    L_(info) << "[i" << remote_index_ << "] "
-             << "[" << index_ << "] "
-             << "POST SEND data (timeslice " << timeslice << ")"
-             << " tscdesc.ts_num " << tscdesc.ts_num << " tscdesc.ts_desc "
-             << last_timeslice_info.second << " tscdesc.offset "
-             << tscdesc.offset << " tscdesc.size " << tscdesc.size
-             << " tscdesc.num_microslices " << tscdesc.num_microslices
-             << " cn_wp_.data " << cn_wp_.data << " cn_wp_pending_.data "
-             << cn_wp_pending_.data << " skip " << skip;
-  }
-  pending_descriptors_.add(last_timeslice_info.second, tscdesc);
-  assert(pending_write_requests_ <= max_pending_write_requests_);
-  return true;
+  memset(rma_iov, 0, sizeof(rma_iov));
+  rma_iov[0].addr = remote_addr;
+  rma_iov[0].len = length;
+  rma_iov[0].key = remote_info_.data.rkey;
+
+  memset(&send_wr_ts, 0, sizeof(send_wr_ts));
+  send_wr_ts.msg_iov = sge;
+  send_wr_ts.desc = desc;
+  send_wr_ts.iov_count = num_sge;
+  send_wr_ts.rma_iov = rma_iov;
+  send_wr_ts.rma_iov_count = 1;
+  send_wr_ts.addr = partner_addr_;
+  send_wr_ts.context = inline_write_context_;
+  // the data is copied at posting and no completion is generated, the write
+  // is retired by the fenced status message
+  return post_send_rdma(&send_wr_ts, FI_INJECT | FI_FENCE);
+}
+
+bool InputChannelConnection::is_inlined(uint64_t timeslice) const {
+  return std::any_of(posted_timeslices_.begin(), posted_timeslices_.end(),
+                     [timeslice](const PostedTimeslice& posted) {
+                       return posted.inlined && posted.timeslice == timeslice;
+                     });
 }
 
 bool InputChannelConnection::write_request_available() {
@@ -243,7 +321,9 @@ void InputChannelConnection::check_inc_write_pointers() {
 
     timeslice = pending_descriptors_.get_begin_iterator()->first;
     descriptor = pending_descriptors_.get_begin_iterator()->second;
-    if (!InputSchedulerOrchestrator::is_timeslice_rdma_acked(index_,
+    // an injected write is placed before the fenced status message
+    if (!is_inlined(descriptor.ts_num) &&
+        !InputSchedulerOrchestrator::is_timeslice_rdma_acked(index_,
                                                              descriptor.ts_num))
       break;
     send_status_message_.tscdesc_msg[added_sent_descriptors_++] =
@@ -275,16 +355,50 @@ bool InputChannelConnection::try_sync_buffer_positions() {
     }
   }
   check_inc_write_pointers();
+  bool fence = inline_fence_due_ || unsignaled_write_flush_due();
   if (data_changed_ || data_acked_ ||
-      send_status_message_.sync_after_scheduling_decision) { //
+      send_status_message_.sync_after_scheduling_decision || fence) { //
     send_status_message_.wp = cn_wp_;
     send_status_message_.local_time = std::chrono::high_resolution_clock::now();
-    post_send_status_message();
+    if (recv_time_.time_since_epoch().count() != 0) {
+      send_status_message_.echo_time = recv_cn_send_time_;
+      send_status_message_.echo_hold_time =
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              send_status_message_.local_time - recv_time_)
+              .count();
+    }
+    send_status_message_.next_unplaced_timeslice =
+        InputSchedulerOrchestrator::get_next_unplaced_timeslice();
+    post_send_status_message(fence);
     return true;
   }
   return false;
 }
 
+bool InputChannelConnection::unsignaled_write_flush_due() const {
+  if (posted_timeslices_.empty() || posted_timeslices_.back().signaled ||
+      posted_timeslices_.back().sequence < fence_sequence_) {
+    return false;
+  }
+  return std::chrono::steady_clock::now() - posted_timeslices_.back().time >=
+         std::chrono::microseconds(
+             ConstVariables::UNSIGNALED_WRITE_FLUSH_DELAY);
+}
+
+void InputChannelConnection::retire_posted_timeslices(
+    std::deque<PostedTimeslice>::iterator end) {
+  for (auto it = posted_timeslices_.begin(); it != end; ++it) {
+    for (auto* context : it->contexts) {
+      LibfabricContextPool::getInst()->releaseContext(context);
+    }
+    InputSchedulerOrchestrator::mark_timeslice_rdma_write_acked(index_,
+                                                                it->timeslice);
+    assert(pending_write_requests_ > 0);
+    pending_write_requests_--;
+  }
+  posted_timeslices_.erase(posted_timeslices_.begin(), end);
+}
+
 uint64_t InputChannelConnection::skip_required(uint64_t data_size) {
   uint64_t databuf_size = UINT64_C(1) << remote_info_.data_buffer_size_exp;
   uint64_t databuf_wp =
@@ -301,7 +415,16 @@ void InputChannelConnection::finalize(bool abort) {
   data_changed_ = true;
 }
 
-void InputChannelConnection::on_complete_write() { pending_write_requests_--; }
+void InputChannelConnection::on_complete_write(uint64_t timeslice) {
+  auto it = std::find_if(posted_timeslices_.begin(), posted_timeslices_.end(),
+                         [timeslice](const PostedTimeslice& posted) {
+                           return posted.timeslice == timeslice;
+                         });
+  // The write may already have been retired by a fenced status message
+  if (it != posted_timeslices_.end()) {
+    retire_posted_timeslices(std::next(it));
+  }
+}
 
 void InputChannelConnection::on_complete_send() {
   if (false) {
@@ -314,6 +437,14 @@ void InputChannelConnection::on_complete_send() {
   }
   send_buffer_available_ = true;
   send_status_message_.sync_after_scheduling_decision = false;
+  if (fence_pending_) {
+    fence_pending_ = false;
+    retire_posted_timeslices(std::find_if(
+        posted_timeslices_.begin(), posted_timeslices_.end(),
+        [this](const PostedTimeslice& posted) {
+          return posted.sequence >= fence_sequence_;
+        }));
+  }
   msg_latency_[msg_latency_index_] =
       std::chrono::duration_cast<std::chrono::microseconds>(
           std::chrono::high_resolution_clock::now() - msg_send_time_)
@@ -322,6 +453,8 @@ void InputChannelConnection::on_complete_send() {
 }
 
 void InputChannelConnection::on_complete_recv() {
+  recv_time_ = std::chrono::high_resolution_clock::now();
+  recv_cn_send_time_ = recv_status_message_.local_time;
   if (false) {
     L_(info)
         << "[i" << remote_index_ << "] "
@@ -344,11 +477,12 @@ void InputChannelConnection::on_complete_recv() {
   }
 
   if (recv_status_message_.ack.desc > send_status_message_.wp.desc) {
-    L_(warning) << "[i" << remote_index_ << "] "
-                << "[" << index_ << "] "
-                << "receive completion, unmatched new cn_ack_.desc="
-                << recv_status_message_.ack.desc << " latest send status "
-                << send_status_message_.wp.desc;
+    L_LIMITED(warning) << "[i" << remote_index_ << "] "
+                       << "[" << index_ << "] "
+                       << "receive completion, unmatched new cn_ack_.desc="
+                       << recv_status_message_.ack.desc
+                       << " latest send status "
+                       << send_status_message_.wp.desc;
     assert(false);
   }
 
@@ -357,11 +491,25 @@ void InputChannelConnection::on_complete_recv() {
       cn_ack_.desc < recv_status_message_.ack.desc) {
     cn_ack_ = recv_status_message_.ack;
   }
+  uint64_t data_occupancy =
+      ((cn_wp_.data - cn_ack_.data) * ConstVariables::ONE_HUNDRED) >>
+      remote_info_.data_buffer_size_exp;
+  uint64_t desc_occupancy =
+      ((cn_wp_.desc - cn_ack_.desc) * ConstVariables::ONE_HUNDRED) >>
+      remote_info_.desc_buffer_size_exp;
+  InputSchedulerOrchestrator::update_compute_buffer_occupancy(
+      index_, std::max(data_occupancy, desc_occupancy));
   if (recv_status_message_.proposed_interval_metadata.interval_index !=
       ConstVariables::MINUS_ONE) {
     InputSchedulerOrchestrator::add_proposed_meta_data(
         recv_status_message_.proposed_interval_metadata);
   }
+  if (recv_status_message_.join_timeslice != ConstVariables::MINUS_ONE &&
+      !join_handled_) {
+    join_handled_ = true;
+    InputSchedulerOrchestrator::admit_compute_node(
+        index_, recv_status_message_.join_timeslice);
+  }
   InputSchedulerOrchestrator::log_heartbeat(index_);
 
   post_recv_status_message();
@@ -435,6 +583,10 @@ void InputChannelConnection::setup() {
   context = LibfabricContextPool::getInst()->getContext();
   context->op_context = (ID_SEND_STATUS | (index_ << 8));
   send_wr.context = context;
+
+  context = LibfabricContextPool::getInst()->getContext();
+  context->op_context = (ID_WRITE_INLINE | (index_ << 8));
+  inline_write_context_ = context;
 #pragma GCC diagnostic pop
 
   // post initial receive request
@@ -499,7 +651,7 @@ void InputChannelConnection::post_recv_status_message() {
   post_recv_msg(&recv_wr);
 }
 
-void InputChannelConnection::post_send_status_message() {
+void InputChannelConnection::post_send_status_message(bool fence) {
   if (false) {
     L_(info) << "[i" << remote_index_ << "] "
              << "[" << index_ << "] "
@@ -513,12 +665,18 @@ void InputChannelConnection::post_send_status_message() {
 
   send_status_message_.descriptor_count = added_sent_descriptors_;
 
-  if (post_send_msg(&send_wr)) {
+  if (post_send_msg(&send_wr,
+                    fence ? FI_COMPLETION | FI_FENCE : FI_COMPLETION)) {
     data_changed_ = false;
     data_acked_ = false;
     send_buffer_available_ = false;
     added_sent_descriptors_ = 0;
     msg_send_time_ = std::chrono::high_resolution_clock::now();
+    if (fence) {
+      fence_pending_ = true;
+      fence_sequence_ = next_write_sequence_;
+      inline_fence_due_ = false;
+    }
   }
 }
 
@@ -527,8 +685,9 @@ void InputChannelConnection::connect(const std::string& hostname,
                                      struct fid_domain* domain,
                                      struct fid_cq* cq,
                                      struct fid_av* av,
-                                     fi_addr_t fi_addr) {
-  Connection::connect(hostname, service, domain, cq, av);
+                                     fi_addr_t fi_addr,
+                                     struct fi_info* resolved) {
+  Connection::connect(hostname, service, domain, cq, av, resolved);
   if (not Provider::getInst()->is_connection_oriented()) {
     size_t addr_len = sizeof(send_status_message_.my_address);
     send_status_message_.connect = true;
@@ -541,10 +700,13 @@ void InputChannelConnection::connect(const std::string& hostname,
     heartbeat_send_wr.addr = fi_addr;
     post_send_status_message();
   }
-  L_(debug) << "Calling add_endpoint in setup";
-  assert(LibfabricBarrier::get_instance() != nullptr);
-  LibfabricBarrier::get_instance()->add_endpoint(
-      index_, Provider::getInst()->get_info(), hostname, true);
+  // standby compute nodes join after the startup barrier
+  if (member_) {
+    L_(debug) << "Calling add_endpoint in setup";
+    assert(LibfabricBarrier::get_instance() != nullptr);
+    LibfabricBarrier::get_instance()->add_endpoint(
+        index_, Provider::getInst()->get_info(), hostname, true);
+  }
 }
 
 void InputChannelConnection::reconnect() {
@@ -16,10 +16,24 @@
 
 #include <cassert>
 #include <cstring>
+#include <deque>
 #include <rdma/fi_cm.h>
 #include <rdma/fi_rma.h>
 
 namespace tl_libfabric {
+/// Bookkeeping for the RDMA writes of a timeslice until they complete.
+struct PostedTimeslice {
+  uint64_t timeslice;
+  uint64_t sequence;
+  bool signaled;
+  std::chrono::steady_clock::time_point time;
+  /// Contexts of the writes without completion, released on retirement
+  std::vector<struct fi_custom_context*> contexts;
+  /// The data has been injected (see
+  /// InputChannelConnection::send_data())
+  bool inlined = false;
+};
+
 /// Input node connection class.
 /** An InputChannelConnection object represents the endpoint of a single
  timeslice building connection from an input node to a compute
@@ -32,7 +46,9 @@ public:
                          uint_fast16_t connection_index,
                          uint_fast16_t remote_connection_index,
                          unsigned int max_send_wr,
-                         unsigned int max_pending_write_requests);
+                         unsigned int max_pending_write_requests,
+                         uint32_t write_signal_interval = 1,
+                         uint32_t inline_data_size = 0);
 
   InputChannelConnection(const InputChannelConnection&) = delete;
   void operator=(const InputChannelConnection&) = delete;
@@ -41,6 +57,10 @@ public:
   bool check_for_buffer_space(uint64_t data_size, uint64_t desc_size);
 
   /// Send data and descriptors to compute node.
+  /** A component of up to the inline data size is injected in a single
+      write without completion, i.e., copied by the provider at posting. Its
+      descriptor is announced right away in a fenced status message, which
+      the compute node receives only after the data has been placed. */
   bool send_data(struct iovec* sge,
                  void** desc,
                  int num_sge,
@@ -66,7 +86,9 @@ public:
 
   bool request_finalize_flag() { return finalize_; }
 
-  void on_complete_write();
+  /// Handle completion of the signaled write of a timeslice.
+  /** This also retires all unsignaled writes posted before it. */
+  void on_complete_write(uint64_t timeslice);
 
   /// Handle Libfabric receive completion notification.
   void on_complete_recv() override;
@@ -100,7 +122,8 @@ public:
                struct fid_domain* domain,
                struct fid_cq* cq,
                struct fid_av* av,
-               fi_addr_t fi_addr);
+               fi_addr_t fi_addr,
+               struct fi_info* resolved = nullptr);
 
   void
   set_time_MPI(const std::chrono::high_resolution_clock::time_point time_MPI) {
@@ -115,6 +138,16 @@ public:
 
   void set_remote_info();
 
+  /// Set the heartbeat endpoint sent to the compute node on connect.
+  void set_heartbeat_endpoint(const HeartbeatEndpointInfo& info) {
+    send_status_message_.heartbeat_endpoint = info;
+  }
+
+  /// Retrieve the heartbeat endpoint of the compute node.
+  const HeartbeatEndpointInfo& remote_heartbeat_endpoint() const {
+    return recv_status_message_.heartbeat_endpoint;
+  }
+
   /// Get the last sent timeslice
   const uint64_t& get_last_sent_timeslice() const {
     return last_sent_timeslice_;
@@ -140,7 +173,36 @@ private:
   void post_recv_status_message();
 
   /// Post a send work request (WR) to the send queue
-  void post_send_status_message();
+  /** A fenced status message completes only after all previous writes,
+      which retires the unsignaled ones. */
+  void post_send_status_message(bool fence = false);
+
+  /// Post the chunks of a contiguous remote region, gathering as many
+  /// chunks per write as the provider allows.
+  bool post_region_writes(struct iovec* sge,
+                          void** desc,
+                          int num_sge,
+                          uint64_t remote_addr,
+                          uint64_t context_id,
+                          bool last,
+                          uint64_t last_flags,
+                          PostedTimeslice& posted);
+
+  /// Inject the chunks of a small component in a single write.
+  bool post_inline_write(struct iovec* sge,
+                         void** desc,
+                         int num_sge,
+                         uint64_t remote_addr,
+                         uint64_t length);
+
+  /// Check whether the data of a posted timeslice has been injected.
+  bool is_inlined(uint64_t timeslice) const;
+
+  /// Check whether unsignaled writes have been waiting for too long.
+  bool unsignaled_write_flush_due() const;
+
+  /// Release the resources of completed writes up to the given entry.
+  void retire_posted_timeslices(std::deque<PostedTimeslice>::iterator end);
 
   /// This update the last scheduled timeslice, time, and duration
   void update_last_scheduled_info();
@@ -166,6 +228,9 @@ private:
   //
   uint32_t sync_failed_conn_ = -1;
 
+  /// The admission request of a joining compute node has been handled
+  bool join_handled_ = false;
+
   /// Access information for memory regions on remote end.
   ComputeNodeInfo remote_info_ = ComputeNodeInfo();
 
@@ -206,6 +271,38 @@ private:
 
   unsigned int max_pending_write_requests_{0};
 
+  /// Request a completion only for every Nth timeslice
+  uint32_t write_signal_interval_ = 1;
+
+  /// Maximum number of local chunks gathered into a single write
+  uint32_t write_iov_limit_ = 1;
+
+  /// Maximum size of the components injected (zero if disabled)
+  uint32_t inline_data_size_ = 0;
+
+  /// Flag, true if the next status message has to be fenced to follow an
+  /// injected write
+  bool inline_fence_due_ = false;
+
+  /// Context of the injected writes, which generate no completions
+  struct fi_custom_context* inline_write_context_ = nullptr;
+
+  /// Number of timeslices written since the last signaled one
+  uint32_t unsignaled_count_ = 0;
+
+  /// Timeslices whose writes have been posted but not retired, in order
+  std::deque<PostedTimeslice> posted_timeslices_;
+
+  /// Sequence number of the next posted timeslice
+  uint64_t next_write_sequence_ = 0;
+
+  /// Writes with a smaller sequence number are covered by the fenced status
+  /// message in flight
+  uint64_t fence_sequence_ = 0;
+
+  /// Flag, true if the status message in flight is fenced
+  bool fence_pending_ = false;
+
   fi_addr_t partner_addr_ = 0;
 
   uint64_t last_sent_timeslice_ = ConstVariables::MINUS_ONE;
@@ -225,6 +322,12 @@ private:
   /// Time that a SYNC message is sent out
   std::chrono::high_resolution_clock::time_point msg_send_time_;
 
+  /// Time that the last status message of the compute node is received
+  std::chrono::high_resolution_clock::time_point recv_time_;
+
+  /// Compute node time that the last status message is sent
+  std::chrono::high_resolution_clock::time_point recv_cn_send_time_;
+
   /// current index to write in the latency ring buffer
   uint16_t msg_latency_index_ = 0;
 };
@@ -4,9 +4,12 @@
 
 #include "InputChannelSender.hpp"
 #include "ConstVariables.hpp"                          // for ConstVariables
+#include "EventTrace.hpp"
+#include "System.hpp"
 
 #include <algorithm>                                   // for min
 #include <cstring>                                     // for strerror, size_t
+#include <future>
 #include <sstream>
 #include <sys/errno.h>                                 // for errno
 #include <sys/uio.h>                                   // for iovec
@@ -22,26 +25,66 @@ InputChannelSender::InputChannelSender(
     uint32_t overlap_size,
     uint32_t max_timeslice_number,
     std::string input_node_name,
+    const std::vector<std::string>& rail_host_names,
+    std::vector<std::vector<std::string>> compute_rail_hosts,
+    std::vector<bool> compute_standby,
     uint32_t scheduler_interval_length,
+    bool scheduler_bandwidth_aware_placement,
+    bool scheduler_staggered_transfers,
+    std::vector<std::pair<uint32_t, uint32_t>> shedding_levels,
+    uint32_t shedding_priority_interval,
     std::string log_directory,
-    bool enable_logging)
-    : ConnectionGroup(input_node_name), input_index_(input_index),
+    bool enable_logging,
+    bool dedicated_heartbeat,
+    ProgressMode progress_mode,
+    std::chrono::microseconds progress_spin_time,
+    uint32_t write_signal_interval,
+    cbm::Monitor* monitor)
+    : ConnectionGroup(input_node_name, progress_mode, progress_spin_time,
+                      rail_host_names),
+      input_index_(input_index),
       data_source_(data_source), compute_hostnames_(compute_hostnames),
-      compute_services_(compute_services), timeslice_size_(timeslice_size),
+      compute_services_(compute_services),
+      compute_rail_hosts_(std::move(compute_rail_hosts)),
+      compute_standby_(std::move(compute_standby)),
+      connect_attempts_(compute_hostnames.size(), 0),
+      timeslice_size_(timeslice_size),
       overlap_size_(overlap_size), max_timeslice_number_(max_timeslice_number),
-      min_acked_desc_(data_source.desc_buffer().size() / 4),
-      min_acked_data_(data_source.data_buffer().size() / 4) {
-
-  start_index_desc_ = sent_desc_ = acked_desc_ = cached_acked_desc_ =
-      data_source.get_read_index().desc;
-  start_index_data_ = sent_data_ = acked_data_ = cached_acked_data_ =
-      data_source.get_read_index().data;
-
-  size_t min_ack_buffer_size =
-      data_source_.desc_buffer().size() / timeslice_size_ + 1;
-  ack_.alloc_with_size(min_ack_buffer_size);
+      interval_length_(scheduler_interval_length),
+      resized_until_(2 * static_cast<uint64_t>(scheduler_interval_length)),
+      boundaries_(data_source,
+                  timeslice_size,
+                  overlap_size,
+                  0,
+                  0,
+                  std::max<uint32_t>(
+                      1, timeslice_size /
+                             ConstVariables::ADAPTIVE_TIMESLICE_SIZE_RANGE)),
+      acks_(data_source, boundaries_),
+      write_signal_interval_(write_signal_interval),
+      dedicated_heartbeat_(dedicated_heartbeat),
+      staggered_transfers_(scheduler_staggered_transfers), monitor_(monitor) {
+
+  hostname_ = fles::system::current_hostname();
+  mr_data_.resize(rail_count(), nullptr);
+  mr_desc_.resize(rail_count(), nullptr);
+
+  start_index_desc_ = sent_desc_ = data_source.get_read_index().desc;
+  start_index_data_ = sent_data_ = data_source.get_read_index().data;
 
   connection_oriented_ = Provider::getInst()->is_connection_oriented();
+  if (dedicated_heartbeat_ && connection_oriented_) {
+    L_(warning) << "dedicated heartbeat requires a connection-less provider, "
+                   "option ignored";
+    dedicated_heartbeat_ = false;
+  }
+  if (!connection_oriented_ &&
+      std::find(compute_standby_.begin(), compute_standby_.end(), true) !=
+          compute_standby_.end()) {
+    L_(warning) << "standby compute nodes require a connection-oriented "
+                   "provider, option ignored";
+    compute_standby_.clear();
+  }
 
   InputSchedulerOrchestrator::initialize(
       input_index, compute_hostnames.size(),
@@ -51,26 +94,26 @@ InputChannelSender::InputChannelSender(
       ConstVariables::HEARTBEAT_INACTIVE_FACTOR,
       ConstVariables::HEARTBEAT_INACTIVE_RETRY_COUNT, scheduler_interval_length,
       data_source.get_write_index().desc, (timeslice_size + overlap_size),
-      start_index_desc_, timeslice_size, log_directory, enable_logging);
+      start_index_desc_, timeslice_size, scheduler_bandwidth_aware_placement,
+      log_directory, enable_logging);
   InputSchedulerOrchestrator::update_data_source_desc(
       data_source.get_write_index().desc);
-}
-
-InputChannelSender::~InputChannelSender() {
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wold-style-cast"
-  if (mr_desc_ != nullptr) {
-    fi_close((struct fid*)mr_desc_);
-    mr_desc_ = nullptr;
+  if (!shedding_levels.empty()) {
+    InputSchedulerOrchestrator::set_load_shedding(std::move(shedding_levels),
+                                                  shedding_priority_interval);
   }
 
-  if (mr_data_ != nullptr) {
-    fi_close((struct fid*)(mr_data_));
-    mr_data_ = nullptr;
+  for (uint32_t i = 0; i < compute_hostnames.size(); ++i) {
+    if (is_standby(i)) {
+      InputSchedulerOrchestrator::set_compute_standby(i);
+    } else {
+      ++initial_compute_count_;
+    }
   }
-#pragma GCC diagnostic pop
 }
 
+InputChannelSender::~InputChannelSender() = default;
+
 void InputChannelSender::report_status() {
   constexpr auto interval = std::chrono::seconds(1);
 
@@ -88,14 +131,14 @@ void InputChannelSender::report_status() {
   std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
   SendBufferStatus status_desc{now,
                                data_source_.desc_buffer().size(),
-                               cached_acked_desc_,
-                               acked_desc_,
+                               acks_.cached_acked().desc,
+                               acks_.acked().desc,
                                sent_desc_,
                                written_desc};
   SendBufferStatus status_data{now,
                                data_source_.data_buffer().size(),
-                               cached_acked_data_,
-                               acked_data_,
+                               acks_.cached_acked().data,
+                               acks_.acked().data,
                                sent_data_,
                                written_data};
 
@@ -128,6 +171,18 @@ void InputChannelSender::report_status() {
            << human_readable_count(rate_data, true, "B/s") << " ("
            << human_readable_count(rate_desc, true, "Hz") << ")";
 
+  if (monitor_ != nullptr) {
+    uint64_t shed_timeslices =
+        InputSchedulerOrchestrator::get_shed_timeslices();
+    monitor_->QueueMetric("progress_status",
+                          {{"host", hostname_},
+                           {"input_index", std::to_string(input_index_)}},
+                          {{"spin_time", agg_spin_time()},
+                           {"sleep_time", agg_sleep_time()},
+                           {"sleep_count", agg_sleep_count()},
+                           {"shed_timeslices", shed_timeslices}});
+  }
+
   previous_send_buffer_status_desc_ = status_desc;
   previous_send_buffer_status_data_ = status_data;
 
@@ -136,14 +191,21 @@ void InputChannelSender::report_status() {
 }
 
 void InputChannelSender::sync_data_source(bool schedule) {
-  if (acked_data_ > cached_acked_data_ || acked_desc_ > cached_acked_desc_) {
-    cached_acked_data_ = acked_data_;
-    cached_acked_desc_ = acked_desc_;
-    data_source_.set_read_index({cached_acked_desc_, cached_acked_data_});
-  }
+  acks_.sync();
+
+  // the fill level of the more occupied input buffer drives load shedding
+  auto write_index = data_source_.get_write_index();
+  uint64_t desc_fill = (write_index.desc - acks_.acked().desc) *
+                       ConstVariables::ONE_HUNDRED /
+                       data_source_.desc_buffer().size();
+  uint64_t data_fill = (write_index.data - acks_.acked().data) *
+                       ConstVariables::ONE_HUNDRED /
+                       data_source_.data_buffer().size();
+  InputSchedulerOrchestrator::update_input_buffer_fill(
+      std::max(desc_fill, data_fill));
 
   if (schedule) {
-    auto now = std::chrono::system_clock::now();
+    auto now = Scheduler::clock::now();
     scheduler_.add([this] { sync_data_source(true); },
                    now + std::chrono::milliseconds(100));
   }
@@ -159,6 +221,9 @@ void InputChannelSender::sync_heartbeat() {
     send_heartbeat_to_inactive_connections();
   } else { // Send timeout message to all active connections
     for (auto& conn : conn_) {
+      if (!conn->member()) {
+        continue;
+      }
       if (conn->request_finalize_flag() && !conn->done()) {
         mark_connection_completed(conn->index());
       } else {
@@ -172,7 +237,7 @@ void InputChannelSender::sync_heartbeat() {
   }
   // TODO 1 second?
   scheduler_.add([this] { sync_heartbeat(); },
-                 std::chrono::system_clock::now() + std::chrono::seconds(1));
+                 Scheduler::clock::now() + std::chrono::seconds(1));
 }
 
 void InputChannelSender::send_timeslices() {
@@ -180,23 +245,82 @@ void InputChannelSender::send_timeslices() {
   uint64_t up_to_timeslice =
       InputSchedulerOrchestrator::get_last_timeslice_to_send();
 
-  uint32_t conn_index = input_index_ % conn_.size();
+  uint64_t shed_ts = InputSchedulerOrchestrator::get_next_shed_timeslice();
+  while (shed_ts != ConstVariables::MINUS_ONE && shed_ts <= up_to_timeslice &&
+         shed_ts <= max_timeslice_number_ && try_shed_timeslice(shed_ts)) {
+    shed_ts = InputSchedulerOrchestrator::get_next_shed_timeslice();
+  }
+
+  // Rotate the order of the compute nodes with the input index, interval and
+  // round, so that the input nodes start with different compute nodes
+  uint32_t conn_count = conn_.size();
+  uint32_t first_conn =
+      (input_index_ +
+       InputSchedulerOrchestrator::get_current_round_rotation()) %
+      conn_count;
+
+  // In a staggered round, the input nodes send to one compute node per phase
+  // in the rotated order, so at any time each compute node receives from a
+  // different input node instead of all input nodes at once (incast)
+  uint64_t phase_duration = 0;
+  if (staggered_transfers_ && conn_count > 1) {
+    phase_duration =
+        InputSchedulerOrchestrator::get_current_round_duration() / conn_count;
+  }
+  if (phase_duration > 0) {
+    send_transfer_phase(first_conn, 0, up_to_timeslice, phase_duration);
+    return;
+  }
+
+  uint32_t conn_index = first_conn;
+  do {
+    send_connection_timeslices(conn_index, up_to_timeslice, false);
+    conn_index = (conn_index + 1) % conn_count;
+  } while (conn_index != first_conn);
+
+  schedule_send_timeslices();
+}
+
+void InputChannelSender::send_transfer_phase(uint32_t first_conn,
+                                             uint32_t phase,
+                                             uint64_t up_to_timeslice,
+                                             uint64_t phase_duration) {
+  send_connection_timeslices((first_conn + phase) % conn_.size(),
+                             up_to_timeslice, true);
+
+  if (phase + 1 < conn_.size()) {
+    scheduler_.add(
+        [this, first_conn, phase, up_to_timeslice, phase_duration] {
+          send_transfer_phase(first_conn, phase + 1, up_to_timeslice,
+                              phase_duration);
+        },
+        Scheduler::clock::now() + std::chrono::microseconds(phase_duration));
+    return;
+  }
+  schedule_send_timeslices();
+}
+
+void InputChannelSender::send_connection_timeslices(uint32_t conn_index,
+                                                    uint64_t up_to_timeslice,
+                                                    bool all) {
   do {
     uint64_t next_ts =
         InputSchedulerOrchestrator::get_connection_next_timeslice(conn_index);
 
-    if (next_ts != ConstVariables::MINUS_ONE && next_ts <= up_to_timeslice &&
-        next_ts <= max_timeslice_number_ &&
-        try_send_timeslice(next_ts, conn_index)) {
-      conn_[conn_index]->set_last_sent_timeslice(next_ts);
+    if (next_ts == ConstVariables::MINUS_ONE || next_ts > up_to_timeslice ||
+        next_ts > max_timeslice_number_ ||
+        !try_send_timeslice(next_ts, conn_index)) {
+      return;
     }
-    conn_index = (conn_index + 1) % conn_.size();
-  } while (conn_index != (input_index_ % conn_.size()));
+    conn_[conn_index]->set_last_sent_timeslice(next_ts);
+  } while (all);
+}
 
+void InputChannelSender::schedule_send_timeslices() {
   if (InputSchedulerOrchestrator::get_sent_timeslices() <=
       max_timeslice_number_) {
     scheduler_.add([this] { send_timeslices(); },
-                   std::chrono::system_clock::now() +
+                   Scheduler::clock::now() +
                        std::chrono::microseconds(
                            InputSchedulerOrchestrator::get_next_fire_time()));
   }
@@ -204,7 +328,7 @@ void InputChannelSender::send_timeslices() {
 
 void InputChannelSender::bootstrap_with_connections() {
   connect();
-  while (connected_ != compute_hostnames_.size()) {
+  while (connected_initial_ != initial_compute_count_) {
     poll_cm_events();
   }
 }
@@ -213,13 +337,24 @@ void InputChannelSender::bootstrap_wo_connections() {
   // domain, cq, av
   init_context(Provider::getInst()->get_info(), compute_hostnames_,
                compute_services_);
-  LibfabricBarrier::create_barrier_instance(input_index_, pd_, false);
+  LibfabricBarrier::create_barrier_instance(
+      input_index_, pd_, false, input_node_count_,
+      static_cast<uint32_t>(initial_compute_count_));
+  if (dedicated_heartbeat_) {
+    heartbeat_agent_ = std::make_unique<HeartbeatAgent>(
+        pd_, Provider::getInst()->get_info(), input_index_,
+        compute_hostnames_.size(),
+        std::chrono::microseconds(ConstVariables::HEARTBEAT_TABLE_INTERVAL));
+  }
 
   conn_.resize(compute_hostnames_.size());
   // setup connections objects
   for (unsigned int i = 0; i < compute_hostnames_.size(); ++i) {
     std::unique_ptr<InputChannelConnection> connection =
         create_input_node_connection(i);
+    if (heartbeat_agent_) {
+      connection->set_heartbeat_endpoint(heartbeat_agent_->local_info());
+    }
     // creates endpoint
     connection->connect(compute_hostnames_[i], compute_services_[i], pd_,
                         completion_queue(i), av_, fi_addrs[i]);
@@ -246,16 +381,28 @@ void InputChannelSender::bootstrap_wo_connections() {
 /// The thread main function.
 void InputChannelSender::operator()() {
   try {
+    auto phase_start = std::chrono::steady_clock::now();
+    auto end_phase = [this, &phase_start](const char* phase) {
+      auto now = std::chrono::steady_clock::now();
+      L_(info) << "[i" << input_index_ << "] "
+               << "bootstrap: " << phase << " took "
+               << std::chrono::duration<double, std::milli>(now - phase_start)
+                      .count()
+               << " ms";
+      phase_start = now;
+    };
 
     if (Provider::getInst()->is_connection_oriented()) {
       bootstrap_with_connections();
     } else {
       bootstrap_wo_connections();
     }
+    end_phase("connect");
 
     data_source_.proceed();
 
     LibfabricBarrier::get_instance()->call_barrier();
+    end_phase("barrier");
 
     time_begin_ = std::chrono::high_resolution_clock::now();
     InputSchedulerOrchestrator::update_input_begin_time(time_begin_);
@@ -267,6 +414,11 @@ void InputChannelSender::operator()() {
     sync_buffer_positions();
     sync_data_source(true);
     sync_heartbeat();
+    if (heartbeat_agent_) {
+      heartbeat_agent_->start();
+      sync_heartbeat_agent();
+    }
+    end_phase("synchronization");
     report_status();
     send_timeslices();
 
@@ -275,6 +427,10 @@ void InputChannelSender::operator()() {
            !abort_) {
       scheduler_.timer();
       poll_completion();
+      if (initial_compute_count_ != conn_.size()) {
+        // standby nodes connect while timeslices are being sent
+        poll_cm_events();
+      }
       update_compute_schedulers();
       data_source_.proceed();
     }
@@ -283,9 +439,9 @@ void InputChannelSender::operator()() {
              << "All timeslices are sent.  wait for pending send completions!";
 
     // wait for pending send completions
-    while (acked_desc_ <
-           timeslice_size_ * InputSchedulerOrchestrator::get_sent_timeslices() +
-               start_index_desc_) {
+    while (acks_.acked().desc <
+           boundaries_.begin(
+               InputSchedulerOrchestrator::get_sent_timeslices())) {
       poll_completion();
       scheduler_.timer();
     }
@@ -294,7 +450,11 @@ void InputChannelSender::operator()() {
     L_(debug) << "[i " << input_index_ << "] "
               << "Finalize Connections";
     for (auto& c : conn_) {
-      c->finalize(abort_);
+      if (c->member()) {
+        c->finalize(abort_);
+      } else if (!c->done()) {
+        mark_connection_completed(c->index());
+      }
     }
 
     L_(debug) << "[i" << input_index_ << "] "
@@ -305,6 +465,9 @@ void InputChannelSender::operator()() {
     }
     time_end_ = std::chrono::high_resolution_clock::now();
 
+    if (heartbeat_agent_) {
+      heartbeat_agent_->stop();
+    }
     if (connection_oriented_) {
       disconnect();
     }
@@ -315,18 +478,29 @@ void InputChannelSender::operator()() {
 
     InputSchedulerOrchestrator::generate_log_files();
     summary();
+    if (InputSchedulerOrchestrator::get_shed_timeslices() > 0) {
+      L_(warning) << "[i" << input_index_ << "] "
+                  << "summary: "
+                  << InputSchedulerOrchestrator::get_shed_timeslices()
+                  << " timeslices shed";
+    }
   } catch (std::exception& e) {
     L_(fatal) << "exception in InputChannelSender: " << e.what();
   }
 }
 
 bool InputChannelSender::try_send_timeslice(uint64_t timeslice, uint32_t cn) {
+  if (!update_timeslice_size(timeslice)) {
+    return false;
+  }
   // wait until a complete timeslice is available in the input buffer
-  uint64_t desc_offset = timeslice * timeslice_size_ + start_index_desc_;
-  uint64_t desc_length = timeslice_size_ + overlap_size_;
+  uint64_t desc_offset = boundaries_.begin(timeslice);
+  uint64_t desc_length = boundaries_.size(timeslice) + overlap_size_;
 
   if (write_index_desc_ < desc_offset + desc_length) {
-    write_index_desc_ = data_source_.get_write_index().desc;
+    // ask for the complete component, a batching source may wait for it
+    write_index_desc_ =
+        data_source_.get_write_index_min({desc_offset + desc_length, 0}).desc;
   }
   // check if microslice no. (desc_offset + desc_length - 1) is avail
   if (write_index_desc_ >= desc_offset + desc_length) {
@@ -361,8 +535,13 @@ bool InputChannelSender::try_send_timeslice(uint64_t timeslice, uint32_t cn) {
     total_length += skip;
 
     if (conn_[cn]->check_for_buffer_space(total_length, 1)) {
+      if (link_model_.enabled() &&
+          !link_model_.admit(cn, timeslice, total_length)) {
+        return false;
+      }
       if (post_send_data(timeslice, cn, desc_offset, desc_length, data_offset,
                          data_length, skip)) {
+        EventTrace::record(TraceEventType::TimeslicePosted, timeslice, cn);
         InputSchedulerOrchestrator::log_timeslice_CB_blocked(cn, timeslice,
                                                              true);
 
@@ -370,6 +549,8 @@ bool InputChannelSender::try_send_timeslice(uint64_t timeslice, uint32_t cn) {
         conn_[cn]->add_timeslice_data_address(total_length, 1);
         InputSchedulerOrchestrator::mark_timeslice_transmitted(cn, timeslice,
                                                                total_length);
+        InputSchedulerOrchestrator::add_sent_volume(timeslice, data_length,
+                                                    desc_length);
         if (data_end > sent_data_) { // This if condition is needed when the
                                      // timeslice transmissions are out of order
           sent_desc_ = desc_offset + desc_length;
@@ -387,10 +568,46 @@ bool InputChannelSender::try_send_timeslice(uint64_t timeslice, uint32_t cn) {
   return false;
 }
 
+bool InputChannelSender::try_shed_timeslice(uint64_t timeslice) {
+  if (!update_timeslice_size(timeslice)) {
+    return false;
+  }
+  // the microslices must be in the input buffer before releasing them
+  uint64_t desc_end = boundaries_.begin(timeslice + 1);
+  if (write_index_desc_ < desc_end) {
+    write_index_desc_ = data_source_.get_write_index_min({desc_end, 0}).desc;
+    if (write_index_desc_ < desc_end) {
+      return false;
+    }
+  }
+  InputSchedulerOrchestrator::mark_timeslice_shed(timeslice);
+  ack_timeslice(timeslice);
+  return true;
+}
+
+bool InputChannelSender::update_timeslice_size(uint64_t timeslice) {
+  // the first two intervals are sent before any size has been proposed
+  while (adaptive_timeslice_size_ && resized_until_ <= timeslice) {
+    uint32_t size = InputSchedulerOrchestrator::get_timeslice_size(
+        resized_until_ / interval_length_);
+    if (size == 0) {
+      return false;
+    }
+    boundaries_.resize(resized_until_, size);
+    resized_until_ += interval_length_;
+  }
+  return true;
+}
+
 std::unique_ptr<InputChannelConnection>
-InputChannelSender::create_input_node_connection(uint_fast16_t index) {
+InputChannelSender::create_input_node_connection(uint_fast16_t index,
+                                                 std::size_t rail) {
   // TODO: What is the best value?
   unsigned int max_send_wr = 8000; // ???  IB hca
+  // a probed depth must leave room for at least one pending write
+  if (Provider::tuned_send_queue_depth() > 3) {
+    max_send_wr = Provider::tuned_send_queue_depth();
+  }
   // unsigned int max_send_wr = 495; // ??? libfabric for verbs
   // unsigned int max_send_wr = 256; // ??? libfabric for sockets
 
@@ -401,7 +618,9 @@ InputChannelSender::create_input_node_connection(uint_fast16_t index) {
       static_cast<unsigned int>((num_cqe_ - 1) / compute_hostnames_.size()));
 
   std::unique_ptr<InputChannelConnection> connection(new InputChannelConnection(
-      eq_, index, input_index_, max_send_wr, max_pending_write_requests));
+      rail_event_queue(rail), index, input_index_, max_send_wr,
+      max_pending_write_requests, write_signal_interval_, inline_data_size_));
+  connection->set_rail(rail);
   return connection;
 }
 
@@ -409,58 +628,150 @@ void InputChannelSender::connect() {
   if (pd_ == nullptr) { // pd, cq2, av
     init_context(Provider::getInst()->get_info(), compute_hostnames_,
                  compute_services_);
-    LibfabricBarrier::create_barrier_instance(input_index_, pd_, false);
+    LibfabricBarrier::create_barrier_instance(
+        input_index_, pd_, false, input_node_count_,
+        static_cast<uint32_t>(initial_compute_count_));
   }
 
   conn_.resize(compute_hostnames_.size());
+  resolve_compute_nodes();
   uint32_t count = 0;
   unsigned int i = input_index_ % compute_hostnames_.size();
   while (count < compute_hostnames_.size()) {
-    std::unique_ptr<InputChannelConnection> connection =
-        create_input_node_connection(i);
-    connection->connect(compute_hostnames_[i], compute_services_[i], pd_,
-                        completion_queue(i), av_, FI_ADDR_UNSPEC);
-    // conn_.push_back(std::move(connection));
-    conn_.at(i) = (std::move(connection));
+    if (!is_standby(i)) {
+      pending_connects_.push_back(i);
+    }
     ++count;
     i = (i + 1) % compute_hostnames_.size();
   }
-}
+  connect_pending();
 
-void InputChannelSender::on_connected(struct fid_domain* pd) {
-  if (mr_data_ == nullptr) {
-    // Register memory regions.
-    int err =
-        fi_mr_reg(pd, const_cast<uint8_t*>(data_source_.data_buffer().ptr()),
-                  data_source_.data_buffer().bytes(), FI_WRITE, 0,
-                  Provider::requested_key++, 0, &mr_data_, nullptr);
-    if (err != 0) {
-      L_(fatal) << "fi_mr_reg failed for data_send_buffer: " << err << "="
-                << fi_strerror(-err);
-      throw LibfabricException("fi_mr_reg failed for data_send_buffer");
+  // standby nodes are usually not running yet, they are retried in the
+  // background and never delay the startup
+  for (i = 0; i < compute_hostnames_.size(); ++i) {
+    if (is_standby(i)) {
+      connect_compute_node(i);
     }
+  }
+}
 
-    if (mr_data_ == nullptr) {
-      L_(fatal) << "fi_mr_reg failed for mr_data: " << strerror(errno);
-      throw LibfabricException("registration of memory region failed");
+void InputChannelSender::resolve_compute_nodes() {
+  auto start = std::chrono::steady_clock::now();
+  const std::size_t n = compute_hostnames_.size();
+  resolved_.assign(n, nullptr);
+
+  // address resolution blocks for a round trip, run it in bounded batches
+  std::vector<std::pair<std::size_t, std::future<struct fi_info*>>> batch;
+  for (std::size_t index = 0; index < n; ++index) {
+    std::size_t rail = select_rail(index);
+    if (rail_domain(rail) == nullptr) {
+      init_rail_context(rail, Provider::getInst(rail)->get_info());
     }
-
-    err = fi_mr_reg(pd,
-                    const_cast<fles::MicrosliceDescriptor*>(
-                        data_source_.desc_buffer().ptr()),
-                    data_source_.desc_buffer().bytes(), FI_WRITE, 0,
-                    Provider::requested_key++, 0, &mr_desc_, nullptr);
-    if (err != 0) {
-      L_(fatal) << "fi_mr_reg failed for desc_send_buffer: " << err << "="
-                << fi_strerror(-err);
-      throw LibfabricException("fi_mr_reg failed for desc_send_buffer");
+    const std::string& hostname = (rail == 0)
+                                      ? compute_hostnames_[index]
+                                      : compute_rail_hosts_[index][rail - 1];
+    batch.emplace_back(index,
+                       std::async(std::launch::async, &Connection::resolve,
+                                  hostname, compute_services_[index], rail));
+    if (batch.size() == ConstVariables::BOOTSTRAP_PARALLELISM ||
+        index + 1 == n) {
+      for (auto& [i, result] : batch) {
+        resolved_[i] = result.get();
+      }
+      batch.clear();
     }
+  }
+
+  L_(info) << "[i" << input_index_ << "] "
+           << "bootstrap: resolved " << n << " compute node addresses in "
+           << std::chrono::duration<double, std::milli>(
+                  std::chrono::steady_clock::now() - start)
+                  .count()
+           << " ms";
+}
+
+void InputChannelSender::connect_pending() {
+  while (connecting_ < ConstVariables::BOOTSTRAP_PARALLELISM &&
+         !pending_connects_.empty()) {
+    uint_fast16_t index = pending_connects_.front();
+    pending_connects_.pop_front();
+    ++connecting_;
+    connect_compute_node(index);
+  }
+}
+
+std::size_t InputChannelSender::select_rail(uint_fast16_t index) const {
+  // spread the compute nodes over the rails both sides have, and move on
+  // to the next rail after a failed attempt
+  std::size_t rails = 1;
+  if (index < compute_rail_hosts_.size()) {
+    rails = std::min(rail_count(), compute_rail_hosts_[index].size() + 1);
+  }
+  return (input_index_ + index + connect_attempts_[index]) % rails;
+}
+
+void InputChannelSender::connect_compute_node(uint_fast16_t index) {
+  std::size_t rail = select_rail(index);
+  ++connect_attempts_[index];
+
+  if (rail_domain(rail) == nullptr) {
+    init_rail_context(rail, Provider::getInst(rail)->get_info());
+  }
+  const std::string& hostname = (rail == 0)
+                                    ? compute_hostnames_[index]
+                                    : compute_rail_hosts_[index][rail - 1];
+
+  // only the first attempt uses the pre-resolved address
+  struct fi_info* resolved = nullptr;
+  if (index < resolved_.size()) {
+    std::swap(resolved, resolved_[index]);
+  }
+
+  std::unique_ptr<InputChannelConnection> connection =
+      create_input_node_connection(index, rail);
+  connection->set_member(!is_standby(index));
+  connection->connect(hostname, compute_services_[index], rail_domain(rail),
+                      rail_completion_queue(rail, index), av_, FI_ADDR_UNSPEC,
+                      resolved);
+  conn_.at(index) = std::move(connection);
+}
+
+void InputChannelSender::on_connected(struct fid_domain* pd) {
+  std::size_t rail = 0;
+  while (rail + 1 < rail_count() && rail_domain(rail) != pd) {
+    ++rail;
+  }
+  // registered once per domain, reconnections reuse the cached regions
+  mr_data_[rail] = MemoryRegionCache::getInst()->get(
+      pd, data_source_.data_buffer().ptr(),
+      data_source_.data_buffer().mapped_bytes(), FI_WRITE);
+  mr_desc_[rail] = MemoryRegionCache::getInst()->get(
+      pd, data_source_.desc_buffer().ptr(),
+      data_source_.desc_buffer().mapped_bytes(), FI_WRITE);
+}
+
+void InputChannelSender::on_established(struct fi_eq_cm_entry* event) {
+  ConnectionGroup::on_established(event);
 
-    if (mr_desc_ == nullptr) {
-      L_(fatal) << "fi_mr_reg failed for mr_desc: " << strerror(errno);
-      throw LibfabricException("registration of memory region failed");
+  auto* conn = static_cast<InputChannelConnection*>(event->fid->context);
+  if (!is_standby(conn->index())) {
+    ++connected_initial_;
+    if (connecting_ > 0) {
+      --connecting_;
+      connect_pending();
     }
+    return;
+  }
+
+  // a standby node is part of the heartbeat group from now on, it receives
+  // timeslices only after its admission
+  conn->set_member(true);
+  if (time_begin_ != std::chrono::high_resolution_clock::time_point()) {
+    conn->set_time_MPI(time_begin_);
   }
+  InputSchedulerOrchestrator::log_heartbeat(conn->index());
+  L_(info) << "[i" << input_index_ << "] "
+           << "standby compute node " << conn->index() << " joined";
 }
 
 void InputChannelSender::on_rejected(struct fi_eq_err_entry* event) {
@@ -472,13 +783,21 @@ void InputChannelSender::on_rejected(struct fi_eq_err_entry* event) {
   uint_fast16_t i = conn->index();
   conn_.at(i) = nullptr;
 
+  if (is_standby(i)) {
+    // keep a placeholder until the next attempt, standby nodes are
+    // polled at a low rate
+    conn_.at(i) = create_input_node_connection(i);
+    conn_.at(i)->set_member(false);
+    scheduler_.add([this, i] { connect_compute_node(i); },
+                   Scheduler::clock::now() +
+                       std::chrono::microseconds(
+                           ConstVariables::STANDBY_CONNECT_INTERVAL));
+    return;
+  }
+
   L_(debug) << "retrying: " << i;
   // immediately initiate retry
-  std::unique_ptr<InputChannelConnection> connection =
-      create_input_node_connection(i);
-  connection->connect(compute_hostnames_[i], compute_services_[i], pd_,
-                      completion_queue(i), av_, FI_ADDR_UNSPEC);
-  conn_.at(i) = std::move(connection);
+  connect_compute_node(i);
 }
 
 std::string InputChannelSender::get_state_string() {
@@ -490,7 +809,7 @@ std::string InputChannelSender::get_state_string() {
     s << " (" << i << ")" << data_source_.desc_buffer().at(i).offset;
   }
   s << std::endl;
-  s << "| acked_desc_ = " << acked_desc_ << std::endl;
+  s << "| acked_desc_ = " << acks_.acked().desc << std::endl;
   s << "/--- data buf ---" << std::endl;
   s << "|";
   for (unsigned int i = 0; i < data_source_.data_buffer().size(); ++i) {
@@ -498,7 +817,7 @@ std::string InputChannelSender::get_state_string() {
       << std::dec;
   }
   s << std::endl;
-  s << "| acked_data_ = " << acked_data_ << std::endl;
+  s << "| acked_data_ = " << acks_.acked().data << std::endl;
   s << "\\---------";
 
   return s.str();
@@ -514,15 +833,18 @@ bool InputChannelSender::post_send_data(uint64_t timeslice,
   int num_sge = 0;
   struct iovec sge[4];
   void* descs[4];
+  struct fid_mr* mr_desc = mr_desc_[conn_[cn]->rail()];
+  struct fid_mr* mr_data = mr_data_[conn_[cn]->rail()];
   // descriptors
-  if ((desc_offset & data_source_.desc_buffer().size_mask()) <=
-      ((desc_offset + desc_length - 1) &
-       data_source_.desc_buffer().size_mask())) {
+  if (data_source_.desc_buffer().mirrored() ||
+      (desc_offset & data_source_.desc_buffer().size_mask()) <=
+          ((desc_offset + desc_length - 1) &
+           data_source_.desc_buffer().size_mask())) {
     // one chunk
     sge[num_sge].iov_base = &data_source_.desc_buffer().at(desc_offset);
     sge[num_sge].iov_len = sizeof(fles::MicrosliceDescriptor) * desc_length;
-    assert(mr_desc_ != nullptr);
-    descs[num_sge++] = fi_mr_desc(mr_desc_);
+    assert(mr_desc != nullptr);
+    descs[num_sge++] = fi_mr_desc(mr_desc);
     // sge[num_sge++].lkey = mr_desc_->lkey;
   } else {
     // two chunks
@@ -532,38 +854,39 @@ bool InputChannelSender::post_send_data(uint64_t timeslice,
         (data_source_.desc_buffer().size() -
          (desc_offset & data_source_.desc_buffer().size_mask()));
     // sge[num_sge++].lkey = mr_desc_->lkey;
-    descs[num_sge++] = fi_mr_desc(mr_desc_);
+    descs[num_sge++] = fi_mr_desc(mr_desc);
     sge[num_sge].iov_base = data_source_.desc_buffer().ptr();
     sge[num_sge].iov_len =
         sizeof(fles::MicrosliceDescriptor) *
         (desc_length - data_source_.desc_buffer().size() +
          (desc_offset & data_source_.desc_buffer().size_mask()));
     // sge[num_sge++].lkey = mr_desc_->lkey;
-    descs[num_sge++] = fi_mr_desc(mr_desc_);
+    descs[num_sge++] = fi_mr_desc(mr_desc);
   }
   // int num_desc_sge = num_sge;
   // data
   if (data_length == 0) {
     // zero chunks
-  } else if ((data_offset & data_source_.data_buffer().size_mask()) <=
-             ((data_offset + data_length - 1) &
-              data_source_.data_buffer().size_mask())) {
+  } else if (data_source_.data_buffer().mirrored() ||
+             (data_offset & data_source_.data_buffer().size_mask()) <=
+                 ((data_offset + data_length - 1) &
+                  data_source_.data_buffer().size_mask())) {
     // one chunk
     sge[num_sge].iov_base = &data_source_.data_buffer().at(data_offset);
     sge[num_sge].iov_len = data_length;
-    descs[num_sge++] = fi_mr_desc(mr_data_);
+    descs[num_sge++] = fi_mr_desc(mr_data);
   } else {
     // two chunks
     sge[num_sge].iov_base = &data_source_.data_buffer().at(data_offset);
     sge[num_sge].iov_len =
         data_source_.data_buffer().size() -
         (data_offset & data_source_.data_buffer().size_mask());
-    descs[num_sge++] = fi_mr_desc(mr_data_);
+    descs[num_sge++] = fi_mr_desc(mr_data);
     sge[num_sge].iov_base = data_source_.data_buffer().ptr();
     sge[num_sge].iov_len =
         data_length - data_source_.data_buffer().size() +
         (data_offset & data_source_.data_buffer().size_mask());
-    descs[num_sge++] = fi_mr_desc(mr_data_);
+    descs[num_sge++] = fi_mr_desc(mr_data);
   }
 
   return conn_[cn]->send_data(static_cast<struct iovec*>(sge), static_cast<void **>(descs), num_sge, timeslice, desc_length,
@@ -578,14 +901,14 @@ void InputChannelSender::on_completion(uint64_t wr_id) {
     uint64_t ts = wr_id >> 24;
 
     int cn = (wr_id >> 8) & 0xFFFF;
-    InputSchedulerOrchestrator::mark_timeslice_rdma_write_acked(cn, ts);
-    conn_[cn]->on_complete_write();
+    conn_[cn]->on_complete_write(ts);
+    EventTrace::record(TraceEventType::WriteCompleted, ts, cn);
 
     if (false) {
       L_(info) << "[i" << input_index_ << "] "
                << "write timeslice " << ts << " to " << cn
-               << " complete, now: acked_data_=" << acked_data_
-               << " acked_desc_=" << acked_desc_;
+               << " complete, now: acked_data_=" << acks_.acked().data
+               << " acked_desc_=" << acks_.acked().desc;
     }
   } break;
 
@@ -595,6 +918,7 @@ void InputChannelSender::on_completion(uint64_t wr_id) {
     bool was_done = conn_[cn]->done();
     conn_[cn]->on_complete_recv();
     uint64_t new_desc = conn_[cn]->cn_ack_desc();
+    EventTrace::record(TraceEventType::AckReceived, new_desc, cn);
 
     update_data_source(cn, last_desc, new_desc);
     InputSchedulerOrchestrator::mark_timeslices_acked(cn, new_desc);
@@ -602,6 +926,9 @@ void InputChannelSender::on_completion(uint64_t wr_id) {
     if (!connection_oriented_ && (0u == conn_[cn]->get_partner_addr())) {
       conn_[cn]->set_partner_addr(av_);
       conn_[cn]->set_remote_info();
+      if (heartbeat_agent_) {
+        heartbeat_agent_->add_peer(cn, conn_[cn]->remote_heartbeat_endpoint());
+      }
       on_connected(pd_);
       ++connected_;
       connected_indexes_.insert(cn);
@@ -655,7 +982,8 @@ void InputChannelSender::on_completion(uint64_t wr_id) {
               .failure_info.last_completed_desc);
 
       for (auto& conn : conn_) {
-        if (!InputSchedulerOrchestrator::is_connection_timed_out(
+        if (conn->member() &&
+            !InputSchedulerOrchestrator::is_connection_timed_out(
                 conn->index())) {
           conn->update_cn_wp_after_failure_action(
               conn_[cn]->get_recv_heartbeat_message().failure_info.index);
@@ -680,7 +1008,9 @@ void InputChannelSender::on_completion(uint64_t wr_id) {
 
 void InputChannelSender::update_compute_schedulers() {
   for (auto& c : conn_) {
-    c->ack_complete_interval_info();
+    if (c->member()) {
+      c->ack_complete_interval_info();
+    }
   }
 }
 
@@ -690,31 +1020,15 @@ void InputChannelSender::update_data_source(uint32_t compute_index,
   for (uint64_t desc = old_desc + 1; desc <= new_desc; ++desc) {
     uint64_t ts = InputSchedulerOrchestrator::get_timeslice_by_descriptor(
         compute_index, desc);
-    uint64_t acked_ts = (acked_desc_ - start_index_desc_) / timeslice_size_;
     assert(ts != ConstVariables::MINUS_ONE);
-    if (ts != acked_ts) {
-      // transmission has been reordered, store completion information
-      ack_.at(ts) = ts;
-    } else {
-      // completion is for earliest pending timeslice, update indices
-      do {
-        ++acked_ts;
-      } while (ack_.at(acked_ts) > ts);
-
-      // TODO Invalid when timeslices are not fixed in size
-      acked_desc_ = acked_ts * timeslice_size_ + start_index_desc_;
-      acked_data_ = data_source_.desc_buffer().at(acked_desc_ - 1).offset +
-                    data_source_.desc_buffer().at(acked_desc_ - 1).size;
-      if (acked_data_ >= cached_acked_data_ + min_acked_data_ ||
-          acked_desc_ >= cached_acked_desc_ + min_acked_desc_) {
-        cached_acked_data_ = acked_data_;
-        cached_acked_desc_ = acked_desc_;
-        data_source_.set_read_index({cached_acked_desc_, cached_acked_data_});
-      }
-    }
+    ack_timeslice(ts);
   }
 }
 
+void InputChannelSender::ack_timeslice(uint64_t timeslice) {
+  acks_.ack(timeslice);
+}
+
 void InputChannelSender::mark_connection_completed(uint32_t conn_id) {
   conn_[conn_id]->mark_done();
   ++connections_done_;
@@ -6,8 +6,13 @@
 #include "ConnectionGroup.hpp"
 #include "DualRingBuffer.hpp"
 #include "InputChannelConnection.hpp"
+#include "LinkModel.hpp"
 #include "MicrosliceDescriptor.hpp"
+#include "Monitor.hpp"
 #include "RingBuffer.hpp"
+#include "SendBufferStatus.hpp"
+#include "TimesliceAckTracker.hpp"
+#include "TimesliceBoundaries.hpp"
 #include "Utility.hpp"
 #include "dfs/InputIntervalInfo.hpp"
 #include "dfs/InputSchedulerOrchestrator.hpp"
@@ -17,6 +22,7 @@
 
 #include <cassert>
 #include <chrono>
+#include <deque>
 #include <iomanip>
 #include <mutex>
 #include <set>
@@ -41,9 +47,21 @@ public:
                      uint32_t overlap_size,
                      uint32_t max_timeslice_number,
                      std::string input_node_name,
+                     const std::vector<std::string>& rail_host_names,
+                     std::vector<std::vector<std::string>> compute_rail_hosts,
+                     std::vector<bool> compute_standby,
                      uint32_t scheduler_interval_length,
+                     bool scheduler_bandwidth_aware_placement,
+                     bool scheduler_staggered_transfers,
+                     std::vector<std::pair<uint32_t, uint32_t>> shedding_levels,
+                     uint32_t shedding_priority_interval,
                      std::string log_directory,
-                     bool enable_logging);
+                     bool enable_logging,
+                     bool dedicated_heartbeat,
+                     ProgressMode progress_mode,
+                     std::chrono::microseconds progress_spin_time,
+                     uint32_t write_signal_interval,
+                     cbm::Monitor* monitor);
 
   InputChannelSender(const InputChannelSender&) = delete;
   void operator=(const InputChannelSender&) = delete;
@@ -53,6 +71,28 @@ public:
 
   void report_status();
 
+  /// Emulate the delay and bandwidth of the links to the compute nodes,
+  /// e.g., for scale-out tests on a single host.
+  void set_link_model(const LinkModelParameters& parameters) {
+    link_model_ =
+        LinkModel(parameters, compute_hostnames_.size(), input_index_);
+  }
+
+  /// Set the number of input nodes taking part in the startup, which
+  /// enables the tree barrier.
+  void set_input_node_count(uint32_t count) { input_node_count_ = count; }
+
+  /// Adapt the timeslice size to the data rate. The sizes are proposed by
+  /// the compute nodes per interval length of timeslices (see
+  /// DDScheduler::get_timeslice_size()), the configured size is the maximum.
+  void set_adaptive_timeslice_size(bool enable) {
+    adaptive_timeslice_size_ = enable;
+  }
+
+  /// Inject components up to the given size (in bytes), limited by the
+  /// provider (see InputChannelConnection::send_data()).
+  void set_inline_data_size(uint32_t size) { inline_data_size_ = size; }
+
   void sync_data_source(bool schedule);
 
   void sync_heartbeat() override;
@@ -62,17 +102,58 @@ public:
   // A scheduling calls to send timeslices to each connection
   void send_timeslices();
 
+  /// Send the timeslices of one phase of a staggered round.
+  void send_transfer_phase(uint32_t first_conn,
+                           uint32_t phase,
+                           uint64_t up_to_timeslice,
+                           uint64_t phase_duration);
+
+  /// Send the next (or, if all is set, every) pending timeslice up to a
+  /// given one to a compute node.
+  void send_connection_timeslices(uint32_t conn_index,
+                                  uint64_t up_to_timeslice,
+                                  bool all);
+
+  /// Schedule the next call of send_timeslices() as paced by the scheduler.
+  void schedule_send_timeslices();
+
   /// The central function for distributing timeslice data.
   bool try_send_timeslice(uint64_t timeslice, uint32_t cn);
 
+  /// Release a shed timeslice without transmission once it is available.
+  bool try_shed_timeslice(uint64_t timeslice);
+
+  /// Apply the adaptive sizes up to a timeslice, false if not all known.
+  bool update_timeslice_size(uint64_t timeslice);
+
   std::unique_ptr<InputChannelConnection>
-  create_input_node_connection(uint_fast16_t index);
+  create_input_node_connection(uint_fast16_t index, std::size_t rail = 0);
 
   /// Initiate connection requests to list of target hostnames.
   void connect();
 
+  /// Initiate the connection request to a compute node on its next rail.
+  void connect_compute_node(uint_fast16_t index);
+
+  /// Select the rail of the next connection attempt to a compute node.
+  std::size_t select_rail(uint_fast16_t index) const;
+
+  /// Resolve the addresses of all compute nodes concurrently.
+  void resolve_compute_nodes();
+
+  /// Initiate queued connection requests up to the bootstrap window.
+  void connect_pending();
+
+  /// Check whether a compute node is a standby node.
+  [[nodiscard]] bool is_standby(uint_fast16_t index) const {
+    return index < compute_standby_.size() && compute_standby_[index];
+  }
+
   void on_connected(struct fid_domain* pd) override;
 
+  /// Handle RDMA_CM_EVENT_ESTABLISHED event.
+  void on_established(struct fi_eq_cm_entry* event) override;
+
 private:
   /// Handle RDMA_CM_REJECTED event.
   void on_rejected(struct fi_eq_err_entry* event) override;
@@ -101,6 +182,9 @@ private:
   /// Update compute scheduler when an interval is completed
   void update_compute_schedulers();
 
+  /// Mark a timeslice as acknowledged and advance the read index
+  void ack_timeslice(uint64_t timeslice);
+
   /// Update the data source after receiving the acknowledgement
   void update_data_source(uint32_t compute_index,
                           uint64_t old_desc,
@@ -111,20 +195,12 @@ private:
 
   uint64_t input_index_;
 
-  /// Libfabric memory region descriptor for input data buffer.
-  struct fid_mr* mr_data_ = nullptr;
-
-  /// Libfabric memory region descriptor for input descriptor buffer.
-  struct fid_mr* mr_desc_ = nullptr;
-
-  /// Buffer to store acknowledged status of timeslices.
-  RingBuffer<uint64_t, true> ack_;
-
-  /// Number of acknowledged microslices. Written to FLIB.
-  uint64_t acked_desc_ = 0;
+  /// Libfabric memory region descriptors for input data buffer (per rail).
+  std::vector<struct fid_mr*> mr_data_;
 
-  /// Number of acknowledged data bytes. Written to FLIB.
-  uint64_t acked_data_ = 0;
+  /// Libfabric memory region descriptors for input descriptor buffer (per
+  /// rail).
+  std::vector<struct fid_mr*> mr_desc_;
 
   /// Data source (e.g., FLIB).
   InputBufferReadInterface& data_source_;
@@ -138,15 +214,52 @@ private:
   const std::vector<std::string> compute_hostnames_;
   const std::vector<std::string> compute_services_;
 
+  /// The addresses of the additional rails of each compute node
+  const std::vector<std::vector<std::string>> compute_rail_hosts_;
+
+  /// Whether a compute node is a standby node that joins later
+  std::vector<bool> compute_standby_;
+
+  /// The number of compute nodes that take part in the startup
+  std::size_t initial_compute_count_ = 0;
+
+  /// The number of input nodes that take part in the startup (if known)
+  uint32_t input_node_count_ = 0;
+
+  /// The number of established connections to initial compute nodes
+  std::size_t connected_initial_ = 0;
+
+  /// The number of connection attempts to each compute node
+  std::vector<uint32_t> connect_attempts_;
+
+  /// Pre-resolved address information for the first connection attempts
+  std::vector<struct fi_info*> resolved_;
+
+  /// Compute nodes waiting for an initial connection attempt
+  std::deque<uint_fast16_t> pending_connects_;
+
+  /// The number of initial connection attempts in flight
+  uint32_t connecting_ = 0;
+
   const uint32_t timeslice_size_;
   const uint32_t overlap_size_;
   const uint64_t max_timeslice_number_;
 
-  const uint64_t min_acked_desc_;
-  const uint64_t min_acked_data_;
+  /// The number of timeslices of an interval, the unit of size changes
+  const uint32_t interval_length_;
+
+  /// Whether the timeslice size is adapted to the data rate
+  bool adaptive_timeslice_size_ = false;
 
-  uint64_t cached_acked_data_ = 0;
-  uint64_t cached_acked_desc_ = 0;
+  /// The timeslices before this one have their adaptive size applied
+  uint64_t resized_until_;
+
+  /// Descriptor ranges of the timeslice components.
+  TimesliceBoundaries<InputBufferReadInterface> boundaries_;
+
+  /// Acknowledgment accounting of the sent timeslices. Writes the read
+  /// indexes to FLIB.
+  TimesliceAckTracker<InputBufferReadInterface> acks_;
 
   uint64_t start_index_desc_;
   uint64_t start_index_data_;
@@ -155,59 +268,25 @@ private:
 
   bool abort_ = false;
 
-  struct SendBufferStatus {
-    std::chrono::system_clock::time_point time;
-    uint64_t size;
-
-    uint64_t cached_acked;
-    uint64_t acked;
-    uint64_t sent;
-    uint64_t written;
-
-    int64_t used() const {
-      assert(sent <= written);
-      return written - sent;
-    }
-    int64_t sending() const {
-      assert(acked <= sent);
-      return sent - acked;
-    }
-    int64_t freeing() const {
-      assert(cached_acked <= acked);
-      return acked - cached_acked;
-    }
-    int64_t unused() const {
-      assert(written <= sent + size);
-      return sent + size - written;
-    }
-
-    float percentage(int64_t value) const {
-      return static_cast<float>(value) / static_cast<float>(size);
-    }
-
-    std::string caption() const {
-      return std::string("used/sending/freeing/free");
-    }
-
-    std::string percentage_str(int64_t value) const {
-      boost::format percent_fmt("%4.1f%%");
-      percent_fmt % (percentage(value) * 100);
-      std::string s = percent_fmt.str();
-      s.resize(4);
-      return s;
-    }
-
-    std::string percentages() const {
-      return percentage_str(used()) + " " + percentage_str(sending()) + " " +
-             percentage_str(freeing()) + " " + percentage_str(unused());
-    }
-
-    std::vector<int64_t> vector() const {
-      return std::vector<int64_t>{used(), sending(), freeing(), unused()};
-    }
-  };
-
   SendBufferStatus previous_send_buffer_status_desc_ = SendBufferStatus();
   SendBufferStatus previous_send_buffer_status_data_ = SendBufferStatus();
+
+  /// Request a write completion only for every Nth timeslice
+  uint32_t write_signal_interval_;
+
+  /// Maximum size of the components injected (zero if disabled)
+  uint32_t inline_data_size_ = 0;
+
+  /// Use the heartbeat agent instead of heartbeat messages for liveness.
+  bool dedicated_heartbeat_;
+
+  /// Spread the transfers of a round over time, one compute node at a time
+  bool staggered_transfers_;
+
+  /// Emulated links to the compute nodes (disabled by default)
+  LinkModel link_model_;
+
+  cbm::Monitor* monitor_;
+  std::string hostname_;
 };
 } // namespace tl_libfabric
@@ -4,8 +4,11 @@
 #pragma once
 
 #include "ComputeNodeBufferPosition.hpp"
+#include "ConstVariables.hpp"
 #include "InputNodeInfo.hpp"
 #include "TimesliceComponentDescriptor.hpp"
+#include "dfs/HeartbeatEndpointInfo.hpp"
+#include "dfs/IntervalMetaData.hpp"
 
 #include <chrono>
 
@@ -34,6 +37,13 @@ struct InputChannelStatusMessage {
   /// The median latency of SYNC messages
   uint64_t median_latency = ConstVariables::ZERO;
 
+  /// Local time of the compute node at which its last received status
+  /// message was sent (echoed for the clock offset estimation)
+  std::chrono::high_resolution_clock::time_point echo_time;
+
+  /// Time between receiving that status message and sending this one (us)
+  uint64_t echo_hold_time = ConstVariables::ZERO;
+
   /// List of descriptors <Descriptor, TimesliceComponentDescriptor>
   std::pair<uint64_t, fles::TimesliceComponentDescriptor>
       tscdesc_msg[ConstVariables::MAX_DESCRIPTOR_ARRAY_SIZE];
@@ -43,6 +53,13 @@ struct InputChannelStatusMessage {
 
   bool sync_after_scheduling_decision = false;
   uint32_t failed_index = ConstVariables::MINUS_ONE;
+
+  /// Heartbeat endpoint of the input process (on connect)
+  HeartbeatEndpointInfo heartbeat_endpoint;
+
+  /// The first timeslice not yet placed on a compute node (for joining
+  /// compute nodes)
+  uint64_t next_unplaced_timeslice = ConstVariables::MINUS_ONE;
 };
 } // namespace tl_libfabric
 
@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "MemoryRegionCache.hpp"
+#include "providers/LibfabricException.hpp"
+#include "providers/Provider.hpp"
+
+#include <log.hpp>
+#include <rdma/fi_errno.h>
+
+namespace tl_libfabric {
+
+std::unique_ptr<MemoryRegionCache>& MemoryRegionCache::getInst() {
+  if (MemoryRegionCache::cache_ == nullptr)
+    MemoryRegionCache::cache_ =
+        std::unique_ptr<MemoryRegionCache>(new MemoryRegionCache());
+
+  return MemoryRegionCache::cache_;
+}
+
+MemoryRegionCache::~MemoryRegionCache() {
+  while (!entries_.empty()) {
+    release(entries_.begin()->first);
+  }
+  L_(debug) << "MemoryRegionCache: " << hits_ << " hits, " << misses_
+            << " registrations of " << registered_bytes_ << " bytes";
+}
+
+struct fid_mr* MemoryRegionCache::get(struct fid_domain* pd,
+                                      const void* buf,
+                                      std::size_t len,
+                                      uint64_t access) {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  auto& domain_entries = entries_[pd];
+  const auto begin = reinterpret_cast<uintptr_t>(buf);
+  const uintptr_t end = begin + len;
+
+  // candidates start at or before the requested range
+  for (auto it = domain_entries.upper_bound(begin);
+       it != domain_entries.begin();) {
+    --it;
+    if (it->second.end >= end && (it->second.access & access) == access) {
+      ++hits_;
+      return it->second.mr;
+    }
+  }
+
+  struct fid_mr* mr = nullptr;
+  int err = fi_mr_reg(pd, buf, len, access, 0, Provider::requested_key++, 0,
+                      &mr, nullptr);
+  if (err != 0 || mr == nullptr) {
+    L_(fatal) << "fi_mr_reg failed: " << err << "=" << fi_strerror(-err);
+    throw LibfabricException("fi_mr_reg failed");
+  }
+  ++misses_;
+  registered_bytes_ += len;
+  domain_entries.emplace(begin, Entry{end, access, mr});
+  return mr;
+}
+
+void MemoryRegionCache::release(struct fid_domain* pd) {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  auto it = entries_.find(pd);
+  if (it == entries_.end()) {
+    return;
+  }
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+  for (auto& entry : it->second) {
+    fi_close((struct fid*)entry.second.mr);
+  }
+#pragma GCC diagnostic pop
+  entries_.erase(it);
+}
+
+std::unique_ptr<MemoryRegionCache> MemoryRegionCache::cache_ = nullptr;
+
+} // namespace tl_libfabric
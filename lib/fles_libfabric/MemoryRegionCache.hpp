@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#pragma once
+
+#include <rdma/fabric.h>
+#include <rdma/fi_domain.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace tl_libfabric {
+/// Process-wide cache of libfabric memory registrations.
+/** Registrations are kept per protection domain and looked up by address
+ range. A request that is covered by an existing registration with at least
+ the requested access rights reuses it instead of registering the memory
+ again. As all regions are registered with FI_MR_BASIC (virtual addressing),
+ a single registration of a whole buffer serves every connection that uses a
+ part of it. Cached regions are owned by the cache and closed when their
+ domain is released. */
+
+class MemoryRegionCache {
+public:
+  ~MemoryRegionCache();
+
+  MemoryRegionCache(const MemoryRegionCache&) = delete;
+  MemoryRegionCache& operator=(const MemoryRegionCache&) = delete;
+
+  /// Retrieve a registration covering the given range, registering it if
+  /// necessary.
+  struct fid_mr* get(struct fid_domain* pd,
+                     const void* buf,
+                     std::size_t len,
+                     uint64_t access);
+
+  /// Close all cached registrations of a domain.
+  void release(struct fid_domain* pd);
+
+  static std::unique_ptr<MemoryRegionCache>& getInst();
+
+private:
+  struct Entry {
+    uintptr_t end;
+    uint64_t access;
+    struct fid_mr* mr;
+  };
+
+  static std::unique_ptr<MemoryRegionCache> cache_;
+
+  /// Entries by domain and start address.
+  std::map<struct fid_domain*, std::multimap<uintptr_t, Entry>> entries_;
+
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+  uint64_t registered_bytes_ = 0;
+
+  std::mutex cache_mutex_;
+
+  MemoryRegionCache() = default;
+};
+} // namespace tl_libfabric
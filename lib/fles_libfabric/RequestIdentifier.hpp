@@ -17,7 +17,10 @@ enum RequestIdentifier {
   ID_RECEIVE_STATUS,
   ID_SEND_FINALIZE,
   ID_HEARTBEAT_SEND_STATUS,
-  ID_HEARTBEAT_RECEIVE_STATUS
+  ID_HEARTBEAT_RECEIVE_STATUS,
+  ID_SHARED_RECEIVE_STATUS,
+  ID_SHARED_HEARTBEAT_RECEIVE_STATUS,
+  ID_WRITE_INLINE
 };
 } // namespace tl_libfabric
 #pragma pack()
@@ -42,6 +45,12 @@ inline std::ostream& operator<<(std::ostream& s, RequestIdentifier v) {
     return s << "ID_HEARTBEAT_SEND_STATUS";
   case ID_HEARTBEAT_RECEIVE_STATUS:
     return s << "ID_HEARTBEAT_RECEIVE_STATUS";
+  case ID_SHARED_RECEIVE_STATUS:
+    return s << "ID_SHARED_RECEIVE_STATUS";
+  case ID_SHARED_HEARTBEAT_RECEIVE_STATUS:
+    return s << "ID_SHARED_HEARTBEAT_RECEIVE_STATUS";
+  case ID_WRITE_INLINE:
+    return s << "ID_WRITE_INLINE";
   default:
     return s << static_cast<int>(v);
   }
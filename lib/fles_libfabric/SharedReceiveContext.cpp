@@ -0,0 +1,126 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "SharedReceiveContext.hpp"
+#include "RequestIdentifier.hpp"
+#include "log.hpp"
+#include "providers/LibfabricException.hpp"
+#include "providers/Provider.hpp"
+
+#include <rdma/fi_errno.h>
+
+#include <cstring>
+
+namespace tl_libfabric {
+
+SharedReceiveContext::SharedReceiveContext(struct fid_domain* pd,
+                                           struct fi_info* ep_info,
+                                           uint32_t status_slots,
+                                           uint32_t heartbeat_slots)
+    : status_messages_(status_slots), heartbeat_messages_(heartbeat_slots) {
+  struct fi_rx_attr rx_attr = *ep_info->rx_attr;
+  rx_attr.size = status_slots + heartbeat_slots;
+  rx_attr.iov_limit = 1;
+  int res = fi_srx_context(pd, &rx_attr, &srx_, nullptr);
+  if (res != 0) {
+    L_(fatal) << "fi_srx_context failed: " << res << "=" << fi_strerror(-res);
+    throw LibfabricException("fi_srx_context failed");
+  }
+
+  res = fi_mr_reg(pd, status_messages_.data(),
+                  status_messages_.size() * sizeof(InputChannelStatusMessage),
+                  FI_RECV | FI_TAGGED, 0, Provider::requested_key++, 0,
+                  &mr_status_, nullptr);
+  if (res != 0) {
+    L_(fatal) << "fi_mr_reg failed for shared status recv: " << res << "="
+              << fi_strerror(-res);
+    throw LibfabricException("fi_mr_reg failed for shared status recv");
+  }
+  res = fi_mr_reg(pd, heartbeat_messages_.data(),
+                  heartbeat_messages_.size() * sizeof(HeartbeatMessage),
+                  FI_RECV | FI_TAGGED, 0, Provider::requested_key++, 0,
+                  &mr_heartbeat_, nullptr);
+  if (res != 0) {
+    L_(fatal) << "fi_mr_reg failed for shared heartbeat recv: " << res << "="
+              << fi_strerror(-res);
+    throw LibfabricException("fi_mr_reg failed for shared heartbeat recv");
+  }
+
+  for (uint32_t slot = 0; slot < status_slots; ++slot) {
+    struct fi_custom_context* context =
+        LibfabricContextPool::getInst()->getContext();
+    context->op_context = (ID_SHARED_RECEIVE_STATUS | (slot << 8));
+    status_contexts_.push_back(context);
+    repost_status_message(slot);
+  }
+  for (uint32_t slot = 0; slot < heartbeat_slots; ++slot) {
+    struct fi_custom_context* context =
+        LibfabricContextPool::getInst()->getContext();
+    context->op_context = (ID_SHARED_HEARTBEAT_RECEIVE_STATUS | (slot << 8));
+    heartbeat_contexts_.push_back(context);
+    repost_heartbeat_message(slot);
+  }
+
+  L_(info) << "shared receive context with " << status_slots
+           << " status and " << heartbeat_slots << " heartbeat buffers";
+}
+
+SharedReceiveContext::~SharedReceiveContext() {
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+  if (srx_ != nullptr) {
+    fi_close((struct fid*)srx_);
+  }
+  if (mr_status_ != nullptr) {
+    fi_close((struct fid*)mr_status_);
+  }
+  if (mr_heartbeat_ != nullptr) {
+    fi_close((struct fid*)mr_heartbeat_);
+  }
+#pragma GCC diagnostic pop
+  for (auto* context : status_contexts_) {
+    LibfabricContextPool::getInst()->releaseContext(context);
+  }
+  for (auto* context : heartbeat_contexts_) {
+    LibfabricContextPool::getInst()->releaseContext(context);
+  }
+}
+
+void SharedReceiveContext::repost_status_message(uint32_t slot) {
+  post_recv(&status_messages_.at(slot), sizeof(InputChannelStatusMessage),
+            mr_status_, ConstVariables::STATUS_MESSAGE_TAG,
+            status_contexts_.at(slot));
+}
+
+void SharedReceiveContext::repost_heartbeat_message(uint32_t slot) {
+  post_recv(&heartbeat_messages_.at(slot), sizeof(HeartbeatMessage),
+            mr_heartbeat_, ConstVariables::HEARTBEAT_MESSAGE_TAG,
+            heartbeat_contexts_.at(slot));
+}
+
+void SharedReceiveContext::post_recv(void* buffer,
+                                     size_t size,
+                                     struct fid_mr* mr,
+                                     uint64_t tag,
+                                     struct fi_custom_context* context) {
+  struct iovec iov;
+  iov.iov_base = buffer;
+  iov.iov_len = size;
+  void* desc[1] = {fi_mr_desc(mr)};
+
+  struct fi_msg_tagged wr;
+  memset(&wr, 0, sizeof(wr));
+  wr.msg_iov = &iov;
+  wr.desc = desc;
+  wr.iov_count = 1;
+  wr.tag = tag;
+  wr.context = context;
+
+  int err = fi_trecvmsg(srx_, &wr, FI_COMPLETION);
+  if (err != 0) {
+    L_(fatal) << "fi_trecvmsg failed on shared receive context: " << err << "="
+              << fi_strerror(-err);
+    throw LibfabricException("fi_trecvmsg failed on shared receive context");
+  }
+}
+} // namespace tl_libfabric
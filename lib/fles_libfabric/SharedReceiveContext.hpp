@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#pragma once
+
+#include "ConstVariables.hpp"
+#include "InputChannelStatusMessage.hpp"
+#include "dfs/HeartbeatMessage.hpp"
+#include "providers/LibfabricContextPool.hpp"
+
+#include <rdma/fi_domain.h>
+#include <rdma/fi_endpoint.h>
+#include <rdma/fi_tagged.h>
+
+#include <cstdint>
+#include <vector>
+
+#include <sys/uio.h>
+
+namespace tl_libfabric {
+/// Shared receive context for the control messages of a connection group.
+/** A SharedReceiveContext object owns a fixed pool of receive buffers for
+ InputChannelStatusMessage and HeartbeatMessage traffic, posted to a
+ libfabric shared receive context (fi_srx_context) that all endpoints of the
+ group are bound to. Memory registration and posted receives thus do not grow
+ with the number of connections. The sender of a message is identified by the
+ input node index contained in it. */
+
+class SharedReceiveContext {
+public:
+  /// The SharedReceiveContext constructor.
+  SharedReceiveContext(struct fid_domain* pd,
+                       struct fi_info* ep_info,
+                       uint32_t status_slots,
+                       uint32_t heartbeat_slots);
+
+  SharedReceiveContext(const SharedReceiveContext&) = delete;
+  SharedReceiveContext& operator=(const SharedReceiveContext&) = delete;
+
+  ~SharedReceiveContext();
+
+  /// Retrieve the shared receive context to bind endpoints to.
+  struct fid_ep* srx() const { return srx_; }
+
+  /// Retrieve a received status message.
+  const InputChannelStatusMessage& status_message(uint32_t slot) const {
+    return status_messages_.at(slot);
+  }
+
+  /// Retrieve a received heartbeat message.
+  const HeartbeatMessage& heartbeat_message(uint32_t slot) const {
+    return heartbeat_messages_.at(slot);
+  }
+
+  /// Post the receive buffer of a status message slot again.
+  void repost_status_message(uint32_t slot);
+
+  /// Post the receive buffer of a heartbeat message slot again.
+  void repost_heartbeat_message(uint32_t slot);
+
+private:
+  /// Post a receive request for a single buffer.
+  void post_recv(void* buffer,
+                 size_t size,
+                 struct fid_mr* mr,
+                 uint64_t tag,
+                 struct fi_custom_context* context);
+
+  /// Libfabric shared receive context
+  struct fid_ep* srx_ = nullptr;
+
+  /// Receive buffers for status messages
+  std::vector<InputChannelStatusMessage> status_messages_;
+
+  /// Receive buffers for heartbeat messages
+  std::vector<HeartbeatMessage> heartbeat_messages_;
+
+  struct fid_mr* mr_status_ = nullptr;
+  struct fid_mr* mr_heartbeat_ = nullptr;
+
+  /// Contexts of the posted receive requests, one per slot
+  std::vector<struct fi_custom_context*> status_contexts_;
+  std::vector<struct fi_custom_context*> heartbeat_contexts_;
+};
+} // namespace tl_libfabric
@@ -2,12 +2,83 @@
 #pragma once
 
 #include "ConstVariables.hpp"
+#include <algorithm>
 #include <assert.h>
-#include <map>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
 
 namespace tl_libfabric {
+/**
+ * Ordered map holding at most a fixed number of entries, evicting the entry
+ * with the smallest key when full.
+ *
+ * The entries are stored in key order in a contiguous ring of slots,
+ * addressed by monotonically increasing positions. Keys arriving in
+ * ascending order (timeslice, interval and descriptor indices) are appended
+ * in constant time, dense keys are located by their distance to the first
+ * key and sparse keys by binary search. Removed entries leave a tombstone
+ * that is reclaimed once it reaches the front or when the ring is compacted,
+ * so iterators to other entries stay valid across removals. The ring grows
+ * geometrically, hence the map does not allocate in steady state.
+ */
 template <typename KEY, typename VALUE> class SizedMap {
+  struct Slot {
+    std::pair<KEY, VALUE> entry;
+    bool live = false;
+  };
+
 public:
+  /// Bidirectional iterator over the entries in key order.
+  class iterator {
+  public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = std::pair<KEY, VALUE>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::pair<KEY, VALUE>*;
+    using reference = std::pair<KEY, VALUE>&;
+
+    iterator() = default;
+
+    reference operator*() const { return map_->slot(pos_).entry; }
+    pointer operator->() const { return &map_->slot(pos_).entry; }
+
+    iterator& operator++() {
+      do {
+        ++pos_;
+      } while (pos_ < map_->back_ && !map_->slot(pos_).live);
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator it = *this;
+      ++*this;
+      return it;
+    }
+    iterator& operator--() {
+      do {
+        --pos_;
+      } while (!map_->slot(pos_).live);
+      return *this;
+    }
+    iterator operator--(int) {
+      iterator it = *this;
+      --*this;
+      return it;
+    }
+
+    bool operator==(const iterator& other) const { return pos_ == other.pos_; }
+    bool operator!=(const iterator& other) const { return pos_ != other.pos_; }
+
+  private:
+    friend class SizedMap;
+
+    iterator(SizedMap* map, uint64_t pos) : map_(map), pos_(pos) {}
+
+    SizedMap* map_ = nullptr;
+    uint64_t pos_ = 0;
+  };
+
   SizedMap(uint32_t max_map_size);
   SizedMap();
   // SizedMap(const SizedMap&) = delete;
@@ -19,7 +90,7 @@ public:
 
   bool remove(const KEY key);
 
-  bool remove(const typename std::map<KEY, VALUE>::iterator iterator);
+  bool remove(const iterator iterator);
 
   bool contains(const KEY key) const;
 
@@ -31,16 +102,38 @@ public:
 
   KEY get_last_key() const;
 
-  typename std::map<KEY, VALUE>::iterator get_begin_iterator();
-
-  typename std::map<KEY, VALUE>::iterator get_iterator(const KEY key);
+  iterator get_begin_iterator();
 
-  typename std::map<KEY, VALUE>::iterator get_end_iterator();
+  iterator get_iterator(const KEY key);
 
-  typedef typename std::map<KEY, VALUE>::iterator iterator;
+  iterator get_end_iterator();
 
 private:
-  typename std::map<KEY, VALUE> map_;
+  // Initial number of slots (a power of two)
+  static constexpr uint64_t INITIAL_CAPACITY_ = 16;
+
+  Slot& slot(uint64_t pos) { return slots_[pos & (slots_.size() - 1)]; }
+  const Slot& slot(uint64_t pos) const {
+    return slots_[pos & (slots_.size() - 1)];
+  }
+
+  // Position of the first slot with a key not less than the given one
+  uint64_t lower_bound(const KEY key) const;
+
+  // Position of the live entry with the given key, or back_ if none
+  uint64_t find(const KEY key) const;
+
+  // Turn the entry at the given position into a tombstone
+  void erase(uint64_t pos);
+
+  // Make room for one more slot, compacting or growing the ring
+  void reserve_slot();
+
+  std::vector<Slot> slots_;
+  // Positions of the first and one past the last used slot
+  uint64_t front_ = 0;
+  uint64_t back_ = 0;
+  uint32_t size_ = 0;
   const uint32_t MAX_MAP_SIZE_;
 };
 
@@ -54,46 +147,62 @@ SizedMap<KEY, VALUE>::SizedMap()
 
 template <typename KEY, typename VALUE>
 bool SizedMap<KEY, VALUE>::add(const KEY key, const VALUE val) {
-  if (map_.find(key) != map_.end()) {
+  if (contains(key)) {
     return false;
   }
 
-  if (map_.size() == MAX_MAP_SIZE_) {
-    map_.erase(map_.begin());
-    assert(map_.size() == MAX_MAP_SIZE_ - 1);
+  if (size_ == MAX_MAP_SIZE_) {
+    erase(front_);
+    assert(size_ == MAX_MAP_SIZE_ - 1);
   }
 
-  map_.insert(std::pair<KEY, VALUE>(key, val));
+  reserve_slot();
+  uint64_t pos = back_;
+  if (front_ != back_ && !(slot(back_ - 1).entry.first < key)) {
+    // Out-of-order key: reuse its tombstone or shift the greater entries
+    pos = lower_bound(key);
+    if (slot(pos).entry.first != key) {
+      for (uint64_t i = back_; i != pos; --i) {
+        slot(i) = std::move(slot(i - 1));
+      }
+      ++back_;
+    }
+  } else {
+    ++back_;
+  }
+  slot(pos).entry = std::pair<KEY, VALUE>(key, val);
+  slot(pos).live = true;
+  ++size_;
 
   return true;
 }
 
 template <typename KEY, typename VALUE>
 bool SizedMap<KEY, VALUE>::update(const KEY key, const VALUE val) {
-  typename std::map<KEY, VALUE>::iterator it = map_.find(key);
-  if (it == map_.end()) {
+  uint64_t pos = find(key);
+  if (pos == back_) {
     return false;
   }
 
-  it->second = val;
+  slot(pos).entry.second = val;
 
   return true;
 }
 
 template <typename KEY, typename VALUE>
 bool SizedMap<KEY, VALUE>::remove(const KEY key) {
-  if (contains(key)) {
-    map_.erase(key);
+  uint64_t pos = find(key);
+  if (pos != back_) {
+    erase(pos);
     return true;
   }
   return false;
 }
 
 template <typename KEY, typename VALUE>
-bool SizedMap<KEY, VALUE>::remove(
-    const typename std::map<KEY, VALUE>::iterator iterator) {
-  if (iterator != map_.end()) {
-    map_.erase(iterator);
+bool SizedMap<KEY, VALUE>::remove(const iterator iterator) {
+  if (iterator.pos_ != back_) {
+    erase(iterator.pos_);
     return true;
   }
   return false;
@@ -101,7 +210,7 @@ bool SizedMap<KEY, VALUE>::remove(
 
 template <typename KEY, typename VALUE>
 bool SizedMap<KEY, VALUE>::contains(const KEY key) const {
-  return !empty() && map_.find(key) != map_.end() ? true : false;
+  return !empty() && find(key) != back_ ? true : false;
 }
 
 template <typename KEY, typename VALUE>
@@ -112,36 +221,132 @@ bool SizedMap<KEY, VALUE>::empty() const {
 template <typename KEY, typename VALUE>
 uint32_t SizedMap<KEY, VALUE>::size() const {
 
-  return map_.size();
+  return size_;
 }
 
 template <typename KEY, typename VALUE>
 VALUE SizedMap<KEY, VALUE>::get(const KEY key) const {
-
-  return map_.find(key)->second;
+  uint64_t pos = find(key);
+  assert(pos != back_);
+  return slot(pos).entry.second;
 }
 
 template <typename KEY, typename VALUE>
 KEY SizedMap<KEY, VALUE>::get_last_key() const {
-
-  return (--map_.end())->first;
+  assert(!empty());
+  uint64_t pos = back_ - 1;
+  while (!slot(pos).live) {
+    --pos;
+  }
+  return slot(pos).entry.first;
 }
 
 template <typename KEY, typename VALUE>
-typename std::map<KEY, VALUE>::iterator
+typename SizedMap<KEY, VALUE>::iterator
 SizedMap<KEY, VALUE>::get_begin_iterator() {
-  return map_.begin();
+  return iterator(this, front_);
 }
 
 template <typename KEY, typename VALUE>
-typename std::map<KEY, VALUE>::iterator
+typename SizedMap<KEY, VALUE>::iterator
 SizedMap<KEY, VALUE>::get_iterator(const KEY key) {
-  return map_.find(key);
+  return iterator(this, find(key));
 }
 
 template <typename KEY, typename VALUE>
-typename std::map<KEY, VALUE>::iterator
+typename SizedMap<KEY, VALUE>::iterator
 SizedMap<KEY, VALUE>::get_end_iterator() {
-  return map_.end();
+  return iterator(this, back_);
+}
+
+template <typename KEY, typename VALUE>
+uint64_t SizedMap<KEY, VALUE>::lower_bound(const KEY key) const {
+  uint64_t first = front_;
+  uint64_t count = back_ - front_;
+  while (count > 0) {
+    uint64_t step = count / 2;
+    if (slot(first + step).entry.first < key) {
+      first += step + 1;
+      count -= step + 1;
+    } else {
+      count = step;
+    }
+  }
+  return first;
+}
+
+template <typename KEY, typename VALUE>
+uint64_t SizedMap<KEY, VALUE>::find(const KEY key) const {
+  if (front_ == back_) {
+    return back_;
+  }
+  uint64_t pos = back_;
+  const KEY& front_key = slot(front_).entry.first;
+  const KEY& back_key = slot(back_ - 1).entry.first;
+  if (key == back_key) {
+    pos = back_ - 1;
+  } else if (front_key <= key && key < back_key) {
+    // Fast path for dense keys, binary search otherwise
+    uint64_t distance = static_cast<uint64_t>(key - front_key);
+    if (distance < back_ - front_ &&
+        slot(front_ + distance).entry.first == key) {
+      pos = front_ + distance;
+    } else {
+      pos = lower_bound(key);
+      if (slot(pos).entry.first != key) {
+        return back_;
+      }
+    }
+  } else {
+    return back_;
+  }
+  return slot(pos).live ? pos : back_;
+}
+
+template <typename KEY, typename VALUE>
+void SizedMap<KEY, VALUE>::erase(uint64_t pos) {
+  assert(slot(pos).live);
+  slot(pos).live = false;
+  // Release resources held by the value
+  slot(pos).entry.second = VALUE();
+  --size_;
+  while (front_ != back_ && !slot(front_).live) {
+    ++front_;
+  }
+  if (size_ == 0) {
+    front_ = back_ = 0;
+  }
+}
+
+template <typename KEY, typename VALUE>
+void SizedMap<KEY, VALUE>::reserve_slot() {
+  if (back_ - front_ < slots_.size()) {
+    return;
+  }
+  if (size_ <= slots_.size() / 2 && !slots_.empty()) {
+    // At least half of the slots are tombstones, compact in place
+    uint64_t count = front_;
+    for (uint64_t pos = front_; pos != back_; ++pos) {
+      if (slot(pos).live) {
+        if (pos != count) {
+          slot(count) = std::move(slot(pos));
+          slot(pos).live = false;
+        }
+        ++count;
+      }
+    }
+    back_ = count;
+    return;
+  }
+  std::vector<Slot> slots(std::max(slots_.size() * 2, INITIAL_CAPACITY_));
+  uint64_t count = 0;
+  for (uint64_t pos = front_; pos != back_; ++pos) {
+    if (slot(pos).live) {
+      slots[count++] = std::move(slot(pos));
+    }
+  }
+  slots_.swap(slots);
+  front_ = 0;
+  back_ = count;
 }
 } // namespace tl_libfabric
@@ -2,6 +2,9 @@
 // Copyright 2016 Thorsten Schuett <schuett@zib.de>, Farouk Salem <salem@zib.de>
 
 #include "TimesliceBuilder.hpp"
+#include "System.hpp"
+
+#include <algorithm>
 
 namespace tl_libfabric {
 
@@ -14,19 +17,33 @@ TimesliceBuilder::TimesliceBuilder(
     volatile sig_atomic_t* signal_status,
     bool drop,
     std::string local_node_name,
+    const std::vector<std::string>& rail_host_names,
+    bool standby,
     uint32_t scheduler_history_size,
     uint32_t scheduler_interval_length,
     uint32_t scheduler_speedup_difference_percentage,
     uint32_t scheduler_speedup_percentage,
     uint32_t scheduler_speedup_interval_count,
+    SchedulerPolicy scheduler_policy,
+    uint32_t scheduler_target_buffer_fill,
     std::string log_directory,
-    bool enable_logging)
-    : ConnectionGroup(local_node_name), compute_index_(compute_index),
+    bool enable_logging,
+    bool shared_receive_context,
+    bool dedicated_heartbeat,
+    ProgressMode progress_mode,
+    std::chrono::microseconds progress_spin_time,
+    cbm::Monitor* monitor)
+    : ConnectionGroup(local_node_name, progress_mode, progress_spin_time,
+                      rail_host_names),
+      compute_index_(compute_index),
       timeslice_buffer_(timeslice_buffer), service_(service),
       num_input_nodes_(num_input_nodes), timeslice_size_(timeslice_size),
       ack_(timeslice_buffer_.get_desc_size_exp()),
       signal_status_(signal_status), local_node_name_(local_node_name),
-      drop_(drop), log_directory_(log_directory) {
+      drop_(drop), standby_(standby), log_directory_(log_directory),
+      shared_receive_context_(shared_receive_context),
+      dedicated_heartbeat_(dedicated_heartbeat), monitor_(monitor) {
+  hostname_ = fles::system::current_hostname();
   listening_cq_ = nullptr;
   assert(timeslice_buffer_.get_num_input_nodes() == num_input_nodes);
   assert(not local_node_name_.empty());
@@ -35,6 +52,26 @@ TimesliceBuilder::TimesliceBuilder(
   } else {
     connection_oriented_ = false;
   }
+  if (shared_receive_context_ && !connection_oriented_) {
+    L_(warning) << "shared receive context requires a connection-oriented "
+                   "provider, option ignored";
+    shared_receive_context_ = false;
+  }
+  if (standby_ && !connection_oriented_) {
+    L_(warning) << "standby compute nodes require a connection-oriented "
+                   "provider, option ignored";
+    standby_ = false;
+  }
+  if (shared_receive_context_ && rail_count() > 1) {
+    L_(warning) << "shared receive context is not supported with multiple "
+                   "rails, option ignored";
+    shared_receive_context_ = false;
+  }
+  if (dedicated_heartbeat_ && connection_oriented_) {
+    L_(warning) << "dedicated heartbeat requires a connection-less provider, "
+                   "option ignored";
+    dedicated_heartbeat_ = false;
+  }
   DDSchedulerOrchestrator::initialize(
       compute_index, num_input_nodes, ConstVariables::INIT_HEARTBEAT_TIMEOUT,
       ConstVariables::HEARTBEAT_TIMEOUT_HISTORY_SIZE,
@@ -43,11 +80,17 @@ TimesliceBuilder::TimesliceBuilder(
       ConstVariables::HEARTBEAT_INACTIVE_RETRY_COUNT, scheduler_history_size,
       scheduler_interval_length, scheduler_speedup_difference_percentage,
       scheduler_speedup_percentage, scheduler_speedup_interval_count,
-      log_directory, enable_logging);
+      scheduler_policy, scheduler_target_buffer_fill, log_directory,
+      enable_logging);
 }
 
 TimesliceBuilder::~TimesliceBuilder() {}
 
+void TimesliceBuilder::set_timeslice_target_bytes(uint64_t bytes) {
+  adaptive_timeslice_size_ = bytes != 0;
+  DDSchedulerOrchestrator::set_timeslice_target_bytes(bytes, timeslice_size_);
+}
+
 void TimesliceBuilder::report_status() {
   constexpr auto interval = std::chrono::seconds(1);
 
@@ -86,6 +129,34 @@ void TimesliceBuilder::report_status() {
       (last_second + 1), buffer_percentage));
   //
 
+  if (monitor_ != nullptr) {
+    monitor_->QueueMetric(
+        "progress_status",
+        {{"host", hostname_},
+         {"output_index", std::to_string(compute_index_)}},
+        {{"spin_time", agg_spin_time()},
+         {"sleep_time", agg_sleep_time()},
+         {"sleep_count", agg_sleep_count()}});
+
+    IntervalPacingModel::Status pacing =
+        DDSchedulerOrchestrator::get_pacing_status();
+    monitor_->QueueMetric(
+        "interval_pacing",
+        {{"host", hostname_},
+         {"output_index", std::to_string(compute_index_)}},
+        {{"policy", std::string(DDSchedulerOrchestrator::get_policy() ==
+                                        SchedulerPolicy::Model
+                                    ? "model"
+                                    : "heuristic")},
+         {"interval_count", pacing.interval_count},
+         {"proposed_duration", pacing.proposed_duration},
+         {"timeslice_duration_mean", pacing.timeslice_duration_mean},
+         {"timeslice_duration_stddev", pacing.timeslice_duration_stddev},
+         {"round_trip_time", pacing.round_trip_time},
+         {"predicted_buffer_fill", pacing.predicted_buffer_fill},
+         {"target_buffer_fill", pacing.target_buffer_fill}});
+  }
+
   scheduler_.add(std::bind(&TimesliceBuilder::report_status, this),
                  now + interval);
 }
@@ -207,7 +278,14 @@ void TimesliceBuilder::bootstrap_wo_connections() {
 
   // domain, cq, av
   init_context(Provider::getInst()->get_info(), {}, {});
-  LibfabricBarrier::create_barrier_instance(compute_index_, pd_, true);
+  register_timeslice_buffer(pd_);
+  LibfabricBarrier::create_barrier_instance(
+      compute_index_, pd_, true, num_input_nodes_, compute_node_count_);
+  if (dedicated_heartbeat_) {
+    heartbeat_agent_ = std::make_unique<HeartbeatAgent>(
+        pd_, Provider::getInst()->get_info(), compute_index_, num_input_nodes_,
+        std::chrono::microseconds(ConstVariables::HEARTBEAT_TABLE_INTERVAL));
+  }
 
   // listening endpoint with private cq
   make_endpoint_named(Provider::getInst()->get_info(), local_node_name_,
@@ -221,10 +299,14 @@ void TimesliceBuilder::bootstrap_wo_connections() {
 
     std::unique_ptr<ComputeNodeConnection> conn(new ComputeNodeConnection(
         eq_, pd_, completion_queue(index), av_, index, compute_index_, data_ptr,
-        timeslice_buffer_.get_data_size_exp(), desc_ptr,
+        timeslice_buffer_.get_data_size_exp(index), desc_ptr,
         timeslice_buffer_.get_desc_size_exp()));
     conn->setup_mr(pd_);
     conn->setup();
+    conn->set_ack_coalescing(ack_coalescing_);
+    if (heartbeat_agent_) {
+      conn->set_heartbeat_endpoint(heartbeat_agent_->local_info());
+    }
     conn_.at(index) = std::move(conn);
   }
 
@@ -300,6 +382,10 @@ void TimesliceBuilder::bootstrap_wo_connections() {
             ->set_partner_addr(connection_addr);
         conn_.at(recv_connect_message.info.index)
             ->set_remote_info(recv_connect_message.info);
+        if (heartbeat_agent_) {
+          heartbeat_agent_->add_peer(recv_connect_message.info.index,
+                                     recv_connect_message.heartbeat_endpoint);
+        }
         conn_.at(recv_connect_message.info.index)->send_ep_addr();
         connected_senders_.insert(recv_connect_message.info.index);
         ++connected_;
@@ -319,6 +405,16 @@ void TimesliceBuilder::bootstrap_wo_connections() {
 void TimesliceBuilder::operator()() {
   try {
     // set_cpu(0);
+    auto phase_start = std::chrono::steady_clock::now();
+    auto end_phase = [this, &phase_start](const char* phase) {
+      auto now = std::chrono::steady_clock::now();
+      L_(info) << "[c" << compute_index_ << "] "
+               << "bootstrap: " << phase << " took "
+               << std::chrono::duration<double, std::milli>(now - phase_start)
+                      .count()
+               << " ms";
+      phase_start = now;
+    };
 
     if (connection_oriented_) {
       bootstrap_with_connections();
@@ -326,8 +422,13 @@ void TimesliceBuilder::operator()() {
       conn_.resize(num_input_nodes_);
       bootstrap_wo_connections();
     }
+    end_phase("connect");
 
-    LibfabricBarrier::get_instance()->call_barrier();
+    // the running input nodes do not wait for a standby node
+    if (!standby_) {
+      LibfabricBarrier::get_instance()->call_barrier();
+      end_phase("barrier");
+    }
 
     time_begin_ = std::chrono::high_resolution_clock::now();
     DDSchedulerOrchestrator::set_begin_time(time_begin_);
@@ -335,6 +436,14 @@ void TimesliceBuilder::operator()() {
     sync_buffer_positions();
     report_status();
     sync_heartbeat();
+    if (heartbeat_agent_) {
+      heartbeat_agent_->start();
+      sync_heartbeat_agent();
+    }
+    end_phase("synchronization");
+    if (standby_) {
+      request_admission();
+    }
     while (!all_done_ || connected_ != 0) {
       if (!all_done_) {
         poll_completion();
@@ -353,6 +462,10 @@ void TimesliceBuilder::operator()() {
 
     time_end_ = std::chrono::high_resolution_clock::now();
 
+    if (heartbeat_agent_) {
+      heartbeat_agent_->stop();
+    }
+
     DDSchedulerOrchestrator::generate_log_files();
 
     build_time_file();
@@ -362,6 +475,29 @@ void TimesliceBuilder::operator()() {
   }
 }
 
+void TimesliceBuilder::request_admission() {
+  uint64_t next_unplaced = 0;
+  for (auto& connection : conn_) {
+    uint64_t ts = connection->input_unplaced_timeslice();
+    if (ts == ConstVariables::MINUS_ONE) {
+      // wait for the first status message of each input node
+      scheduler_.add([this] { request_admission(); },
+                     Scheduler::clock::now() + std::chrono::milliseconds(10));
+      return;
+    }
+    next_unplaced = std::max(next_unplaced, ts);
+  }
+
+  // the margin covers the timeslices placed while the request is on its way
+  uint64_t join_timeslice =
+      next_unplaced + ConstVariables::JOIN_ADMISSION_MARGIN;
+  for (auto& connection : conn_) {
+    connection->request_join(join_timeslice);
+  }
+  L_(info) << "[c" << compute_index_ << "] "
+           << "requesting admission at timeslice " << join_timeslice;
+}
+
 void TimesliceBuilder::build_time_file() {
 
   if (true) {
@@ -393,8 +529,18 @@ void TimesliceBuilder::on_connect_request(struct fi_eq_cm_entry* event,
                                           size_t private_data_len) {
 
   if (pd_ == nullptr) {
-    init_context(event->info, {}, {});
-    LibfabricBarrier::create_barrier_instance(compute_index_, pd_, true);
+    // a request on another rail carries the info of that rail's fabric
+    fi_info* info =
+        (cm_rail_ == 0) ? event->info : Provider::getInst()->get_info();
+    init_context(info, {}, {});
+    register_timeslice_buffer(pd_);
+    LibfabricBarrier::create_barrier_instance(
+        compute_index_, pd_, true, num_input_nodes_, compute_node_count_);
+    if (shared_receive_context_) {
+      srx_ = std::make_unique<SharedReceiveContext>(
+          pd_, info, ConstVariables::SHARED_RECEIVE_STATUS_SLOTS,
+          ConstVariables::SHARED_RECEIVE_HEARTBEAT_SLOTS);
+    }
   }
 
   assert(private_data_len >= sizeof(InputNodeInfo));
@@ -405,21 +551,47 @@ void TimesliceBuilder::on_connect_request(struct fi_eq_cm_entry* event,
   uint_fast16_t index = remote_info.index;
   assert(index < conn_.size() && conn_.at(index) == nullptr);
 
-  std::unique_ptr<ComputeNodeConnection> conn(
-      new ComputeNodeConnection(eq_, index, compute_index_, remote_info,
-                                timeslice_buffer_.get_data_ptr(index),
-                                timeslice_buffer_.get_data_size_exp(),
-                                timeslice_buffer_.get_desc_ptr(index),
-                                timeslice_buffer_.get_desc_size_exp()));
+  // the request arrived on the rail selected by the input node
+  std::size_t rail = cm_rail_;
+  if (rail_domain(rail) == nullptr) {
+    init_rail_context(rail, event->info);
+    register_timeslice_buffer(rail_domain(rail));
+  }
+
+  std::unique_ptr<ComputeNodeConnection> conn(new ComputeNodeConnection(
+      rail_event_queue(rail), index, compute_index_, remote_info,
+      timeslice_buffer_.get_data_ptr(index),
+      timeslice_buffer_.get_data_size_exp(index),
+      timeslice_buffer_.get_desc_ptr(index),
+      timeslice_buffer_.get_desc_size_exp()));
+  conn->set_rail(rail);
+  conn->set_ack_coalescing(ack_coalescing_);
   conn_.at(index) = std::move(conn);
 
-  conn_.at(index)->on_connect_request(event, pd_, completion_queue(index));
+  conn_.at(index)->on_connect_request(
+      event, rail_domain(rail), rail_completion_queue(rail, index),
+      srx_ ? srx_->srx() : nullptr);
+}
+
+void TimesliceBuilder::register_timeslice_buffer(struct fid_domain* pd) {
+  const std::size_t n = num_input_nodes_;
+  MemoryRegionCache::getInst()->get(pd, timeslice_buffer_.get_data_ptr(0),
+                                    timeslice_buffer_.get_data_size(),
+                                    FI_WRITE | FI_REMOTE_WRITE);
+  MemoryRegionCache::getInst()->get(
+      pd, timeslice_buffer_.get_desc_ptr(0),
+      n * (UINT64_C(1) << timeslice_buffer_.get_desc_size_exp()) *
+          sizeof(fles::TimesliceComponentDescriptor),
+      FI_WRITE | FI_REMOTE_WRITE);
 }
 
 /// Completion notification event dispatcher. Called by the event loop.
 void TimesliceBuilder::on_completion(uint64_t wr_id) {
   size_t in = wr_id >> 8;
-  assert(in < conn_.size());
+  // shared receive completions carry a buffer slot instead of a connection
+  assert((wr_id & 0xFF) == ID_SHARED_RECEIVE_STATUS ||
+         (wr_id & 0xFF) == ID_SHARED_HEARTBEAT_RECEIVE_STATUS ||
+         in < conn_.size());
   switch (wr_id & 0xFF) {
   case ID_SEND_STATUS:
     if (false) {
@@ -449,6 +621,25 @@ void TimesliceBuilder::on_completion(uint64_t wr_id) {
     conn_[cn]->on_complete_heartbeat_send();
   } break;
 
+  case ID_SHARED_RECEIVE_STATUS: {
+    uint32_t slot = wr_id >> 8;
+    const InputChannelStatusMessage message = srx_->status_message(slot);
+    srx_->repost_status_message(slot);
+    uint32_t cn = message.info.index;
+    assert(cn < conn_.size() && conn_[cn] != nullptr);
+    conn_[cn]->on_shared_recv(message);
+  } break;
+
+  case ID_SHARED_HEARTBEAT_RECEIVE_STATUS: {
+    uint32_t slot = wr_id >> 8;
+    const HeartbeatMessage message = srx_->heartbeat_message(slot);
+    srx_->repost_heartbeat_message(slot);
+    uint32_t cn = message.info.index;
+    assert(cn < conn_.size() && conn_[cn] != nullptr);
+    conn_[cn]->set_recv_heartbeat_message(message);
+    on_recv_heartbeat_event(cn);
+  } break;
+
   default:
     throw LibfabricException("wc for unknown wr_id");
   }
@@ -474,30 +665,6 @@ void TimesliceBuilder::poll_ts_completion() {
   }
 }
 
-bool TimesliceBuilder::check_complete_timeslices(uint64_t ts_pos) {
-  bool all_received = true;
-  for (uint32_t indx = 0; indx < conn_.size(); indx++) {
-    const fles::TimesliceComponentDescriptor& acked_ts =
-        timeslice_buffer_.get_desc(indx, ts_pos);
-    L_(debug) << "[process_pending_complete_timeslices] desc = " << ts_pos
-              << ", acked_ts.size = " << acked_ts.size
-              << ", acked_ts.offset = " << acked_ts.offset
-              << ", acked_ts.num_microslices = " << acked_ts.num_microslices
-              << ", acked_ts.ts_num = " << acked_ts.ts_num
-              << ", (acked_ts.offset + acked_ts.size) = "
-              << (acked_ts.offset + acked_ts.size)
-              << ", conn_[indx]->cn_ack().data = "
-              << conn_[indx]->cn_ack().data;
-    if (acked_ts.num_microslices == ConstVariables::ZERO ||
-        acked_ts.size == ConstVariables::ZERO ||
-        (acked_ts.offset + acked_ts.size) < conn_[indx]->cn_ack().data) {
-      all_received = false;
-      break;
-    }
-  }
-  return all_received;
-}
-
 void TimesliceBuilder::process_completed_timeslices() {
   if (connected_ != conn_.size() ||
       !DDSchedulerOrchestrator::is_all_failure_decisions_acked()) {
@@ -515,7 +682,7 @@ void TimesliceBuilder::process_completed_timeslices() {
 
     bool timed_out = DDSchedulerOrchestrator::is_timeslice_timed_out(ts_pos);
     // check whether all contributions are received if it is not timed out!
-    if (!timed_out && !check_complete_timeslices(ts_pos)) {
+    if (!timed_out && !DDSchedulerOrchestrator::is_timeslice_complete(ts_pos)) {
       timed_out = true;
       L_(fatal) << "ts: " << ts_pos << " is not completely received yet ...";
     }
@@ -523,13 +690,21 @@ void TimesliceBuilder::process_completed_timeslices() {
       const fles::TimesliceComponentDescriptor& acked_ts =
           timeslice_buffer_.get_desc(0, ts_pos);
       uint64_t ts_index = acked_ts.ts_num;
-      timeslice_buffer_.send_work_item({{ts_index, ts_pos, timeslice_size_,
-                                         static_cast<uint32_t>(conn_.size())},
-                                        timeslice_buffer_.get_data_size_exp(),
-                                        timeslice_buffer_.get_desc_size_exp()});
+      // zero if the adaptive size is not known yet, as for time-based
+      // timeslices the components hold the microslice counts
+      uint32_t core_microslices =
+          adaptive_timeslice_size_
+              ? DDSchedulerOrchestrator::get_timeslice_size(ts_index)
+              : timeslice_size_;
+      timeslice_buffer_.send_work_item(
+          {{ts_index, ts_pos, core_microslices,
+            static_cast<uint32_t>(conn_.size())},
+           timeslice_buffer_.get_max_data_size_exp(),
+           timeslice_buffer_.get_desc_size_exp()});
     }
   }
   completely_written_ = new_completely_written + 1;
+  DDSchedulerOrchestrator::release_timeslices(completely_written_);
 }
 
 void TimesliceBuilder::sync_heartbeat() {
@@ -538,7 +713,7 @@ void TimesliceBuilder::sync_heartbeat() {
   check_inactive_connections();
 
   scheduler_.add(std::bind(&TimesliceBuilder::sync_heartbeat, this),
-                 std::chrono::system_clock::now() + std::chrono::seconds(1));
+                 Scheduler::clock::now() + std::chrono::seconds(1));
 }
 
 void TimesliceBuilder::check_missing_connections_failure_info() {
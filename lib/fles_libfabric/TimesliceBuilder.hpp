@@ -5,8 +5,10 @@
 #include "ChildProcessManager.hpp"
 #include "ComputeNodeConnection.hpp"
 #include "ConnectionGroup.hpp"
+#include "Monitor.hpp"
 #include "RequestIdentifier.hpp"
 #include "RingBuffer.hpp"
+#include "SharedReceiveContext.hpp"
 #include "TimesliceBuffer.hpp"
 #include "TimesliceCompletion.hpp"
 #include "TimesliceComponentDescriptor.hpp"
@@ -43,13 +45,22 @@ public:
                    volatile sig_atomic_t* signal_status,
                    bool drop,
                    std::string local_node_name,
+                   const std::vector<std::string>& rail_host_names,
+                   bool standby,
                    uint32_t scheduler_history_size,
                    uint32_t scheduler_interval_length,
                    uint32_t scheduler_speedup_difference_percentage,
                    uint32_t scheduler_speedup_percentage,
                    uint32_t scheduler_speedup_interval_count,
+                   SchedulerPolicy scheduler_policy,
+                   uint32_t scheduler_target_buffer_fill,
                    std::string log_directory,
-                   bool enable_logging);
+                   bool enable_logging,
+                   bool shared_receive_context,
+                   bool dedicated_heartbeat,
+                   ProgressMode progress_mode,
+                   std::chrono::microseconds progress_spin_time,
+                   cbm::Monitor* monitor);
 
   TimesliceBuilder(const TimesliceBuilder&) = delete;
   void operator=(const TimesliceBuilder&) = delete;
@@ -59,6 +70,20 @@ public:
 
   void report_status();
 
+  /// Set the number of compute nodes taking part in the startup, which
+  /// enables the tree barrier.
+  void set_compute_node_count(uint32_t count) { compute_node_count_ = count; }
+
+  /// Adapt the timeslice size to the data rate, targeting the given number
+  /// of bytes per timeslice. The configured size is the maximum.
+  void set_timeslice_target_bytes(uint64_t bytes);
+
+  /// Set the parameters of the acknowledgement coalescing of the
+  /// connections to be established (see AckCoalescer).
+  void set_ack_coalescing(const AckCoalescer::Parameters& parameters) {
+    ack_coalescing_ = parameters;
+  }
+
   void request_abort();
 
   void operator()() override;
@@ -86,12 +111,13 @@ private:
                            const std::string& service,
                            struct fid_ep** ep);
 
+  /// Register the whole timeslice buffer in a domain, so that the
+  /// connections share a single memory region per buffer
+  void register_timeslice_buffer(struct fid_domain* pd);
+
   /// Process completed timeslices and send them to the analyzer
   void process_completed_timeslices();
 
-  /// Check if a timeslice is received completely
-  bool check_complete_timeslices(uint64_t ts_pos);
-
   /// Mark connection as completed in case of normal termination or failure
   void mark_connection_completed(uint32_t conn_id);
 
@@ -112,6 +138,10 @@ private:
 
   void build_time_file();
 
+  /// Ask the input nodes to admit this standby node as soon as they all
+  /// have reported their scheduling progress
+  void request_admission();
+
   fid_cq* listening_cq_;
   uint64_t compute_index_;
 
@@ -125,10 +155,19 @@ private:
   unsigned short service_;
   uint32_t num_input_nodes_;
 
+  /// The number of compute nodes that take part in the startup (if known)
+  uint32_t compute_node_count_ = 0;
+
+  /// Parameters of the acknowledgement coalescing of the connections
+  AckCoalescer::Parameters ack_coalescing_;
+
   std::set<uint_fast16_t> connected_senders_;
 
   uint32_t timeslice_size_;
 
+  /// Whether the timeslice size is adapted to the data rate
+  bool adaptive_timeslice_size_ = false;
+
   uint64_t completely_written_ = 0;
   uint64_t acked_ = 0;
 
@@ -141,6 +180,9 @@ private:
 
   bool drop_;
 
+  /// Join a running system instead of taking part in the startup
+  bool standby_;
+
   // LOGGING
   std::map<uint64_t, double> first_last_arrival_diff_;
   std::map<uint64_t, std::chrono::high_resolution_clock::time_point>
@@ -149,5 +191,17 @@ private:
   std::map<uint64_t, std::vector<double>> buffer_status_;
   std::string log_directory_;
   // END OF LOGGING
+
+  /// Use a single shared receive context for all connections.
+  bool shared_receive_context_;
+
+  /// Receive buffers shared by all connections (connection-oriented only)
+  std::unique_ptr<SharedReceiveContext> srx_;
+
+  /// Use the heartbeat agent instead of heartbeat messages for liveness.
+  bool dedicated_heartbeat_;
+
+  cbm::Monitor* monitor_;
+  std::string hostname_;
 };
 } // namespace tl_libfabric
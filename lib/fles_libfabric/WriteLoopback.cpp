@@ -0,0 +1,217 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "WriteLoopback.hpp"
+#include "providers/LibfabricException.hpp"
+#include "providers/Provider.hpp"
+
+#include <rdma/fi_domain.h>
+#include <rdma/fi_endpoint.h>
+#include <rdma/fi_errno.h>
+#include <rdma/fi_rma.h>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace tl_libfabric {
+
+namespace {
+
+constexpr std::size_t max_outstanding_writes = 16;
+constexpr std::size_t latency_message_size = 64;
+
+void check(int res, const char* what) {
+  if (res != 0) {
+    L_(error) << what << " failed: " << res << "=" << fi_strerror(-res);
+    throw LibfabricException(std::string(what) + " failed");
+  }
+}
+
+// Closes a Libfabric object
+struct FidCloser {
+  void operator()(struct fid* fid) const { fi_close(fid); }
+};
+using FidPtr = std::unique_ptr<struct fid, FidCloser>;
+
+// The loopback endpoint and its resources, closed in reverse order
+class LoopbackEndpoint {
+public:
+  LoopbackEndpoint(struct fi_info* info, std::size_t buffer_size)
+      : buffer_(buffer_size) {
+    check(fi_fabric(info->fabric_attr, &fabric_, nullptr), "fi_fabric");
+    fabric_fid_.reset(&fabric_->fid);
+    check(fi_domain(fabric_, info, &domain_, nullptr), "fi_domain");
+    domain_fid_.reset(&domain_->fid);
+
+    struct fi_cq_attr cq_attr {};
+    cq_attr.size = max_outstanding_writes * 2;
+    cq_attr.format = FI_CQ_FORMAT_CONTEXT;
+    cq_attr.wait_obj = FI_WAIT_NONE;
+    check(fi_cq_open(domain_, &cq_attr, &cq_, nullptr), "fi_cq_open");
+    cq_fid_.reset(&cq_->fid);
+
+    struct fi_av_attr av_attr {};
+    av_attr.type = FI_AV_TABLE;
+    av_attr.count = 1;
+    check(fi_av_open(domain_, &av_attr, &av_, nullptr), "fi_av_open");
+    av_fid_.reset(&av_->fid);
+
+    check(fi_mr_reg(domain_, buffer_.data(), buffer_.size(),
+                    FI_WRITE | FI_REMOTE_WRITE, 0, Provider::requested_key++,
+                    0, &mr_, nullptr),
+          "fi_mr_reg");
+    mr_fid_.reset(&mr_->fid);
+
+    check(fi_endpoint(domain_, info, &ep_, nullptr), "fi_endpoint");
+    ep_fid_.reset(&ep_->fid);
+    check(fi_ep_bind(ep_, &cq_->fid, FI_TRANSMIT | FI_RECV), "fi_ep_bind cq");
+    check(fi_ep_bind(ep_, &av_->fid, 0), "fi_ep_bind av");
+    check(fi_enable(ep_), "fi_enable");
+
+    std::array<char, 256> name{};
+    size_t name_len = name.size();
+    check(fi_getname(&ep_->fid, name.data(), &name_len), "fi_getname");
+    if (fi_av_insert(av_, name.data(), 1, &self_, 0, nullptr) != 1) {
+      throw LibfabricException("fi_av_insert failed");
+    }
+
+    // the written-to half of the buffer, addressed as the provider requires
+    const int mr_mode = info->domain_attr->mr_mode;
+    remote_addr_ = (mr_mode == FI_MR_BASIC || (mr_mode & FI_MR_VIRT_ADDR) != 0)
+                       ? reinterpret_cast<uint64_t>(buffer_.data()) +
+                             buffer_.size() / 2
+                       : buffer_.size() / 2;
+  }
+
+  // Post a write of the first half of the buffer to the second half
+  bool post(std::size_t size, void* context) {
+    ssize_t res = fi_write(ep_, buffer_.data(), size, fi_mr_desc(mr_), self_,
+                           remote_addr_, fi_mr_key(mr_), context);
+    if (res == -FI_EAGAIN) {
+      return false;
+    }
+    check(static_cast<int>(res), "fi_write");
+    return true;
+  }
+
+  // Append the contexts of the completed writes, return their number
+  std::size_t poll(std::vector<struct fi_context*>& completed) {
+    std::array<struct fi_cq_entry, max_outstanding_writes> entries{};
+    ssize_t res = fi_cq_read(cq_, entries.data(), entries.size());
+    if (res == -FI_EAGAIN) {
+      return 0;
+    }
+    if (res == -FI_EAVAIL) {
+      struct fi_cq_err_entry err {};
+      fi_cq_readerr(cq_, &err, 0);
+      L_(error) << "write completion failed: " << fi_strerror(err.err);
+      throw LibfabricException("write completion failed");
+    }
+    if (res < 0) {
+      check(static_cast<int>(res), "fi_cq_read");
+    }
+    for (ssize_t i = 0; i < res; ++i) {
+      completed.push_back(
+          static_cast<struct fi_context*>(entries[i].op_context));
+    }
+    return static_cast<std::size_t>(res);
+  }
+
+private:
+  std::vector<uint8_t> buffer_;
+  struct fid_fabric* fabric_ = nullptr;
+  struct fid_domain* domain_ = nullptr;
+  struct fid_cq* cq_ = nullptr;
+  struct fid_av* av_ = nullptr;
+  struct fid_mr* mr_ = nullptr;
+  struct fid_ep* ep_ = nullptr;
+  FidPtr fabric_fid_;
+  FidPtr domain_fid_;
+  FidPtr cq_fid_;
+  FidPtr av_fid_;
+  FidPtr mr_fid_;
+  FidPtr ep_fid_;
+  fi_addr_t self_ = FI_ADDR_UNSPEC;
+  uint64_t remote_addr_ = 0;
+};
+
+} // namespace
+
+WriteLoopbackResult measure_write_loopback(const std::string& local_host_name,
+                                           std::size_t message_size,
+                                           std::chrono::milliseconds duration) {
+  if (!Provider::getInst()) {
+    Provider::init(local_host_name);
+  }
+  const struct fi_info* selected = Provider::getInst()->get_info();
+  WriteLoopbackResult result;
+  result.provider = selected->fabric_attr->prov_name;
+  if (selected->ep_attr->type == FI_EP_MSG &&
+      result.provider.find("ofi_rxm") == std::string::npos) {
+    result.provider += ";ofi_rxm";
+  }
+
+  struct fi_info* hints = Provider::get_hints(FI_EP_RDM, result.provider);
+  struct fi_info* info = nullptr;
+  int res = fi_getinfo(FIVERSION, local_host_name.c_str(), nullptr, FI_SOURCE,
+                       hints, &info);
+  fi_freeinfo(hints);
+  check(res, "fi_getinfo");
+  std::unique_ptr<struct fi_info, void (*)(struct fi_info*)> info_ptr(
+      info, fi_freeinfo);
+
+  const std::size_t depth = std::min<std::size_t>(
+      max_outstanding_writes, std::max<std::size_t>(info->tx_attr->size, 1));
+  message_size = std::max(message_size, latency_message_size);
+  LoopbackEndpoint endpoint(info, 2 * message_size);
+  // a context is owned by the provider until its write has completed
+  std::vector<struct fi_context> contexts(depth);
+  std::vector<struct fi_context*> idle;
+  for (auto& context : contexts) {
+    idle.push_back(&context);
+  }
+
+  // bandwidth: keep the send queue filled
+  using clock = std::chrono::steady_clock;
+  const auto phase = duration / 2;
+  auto begin = clock::now();
+  auto end = begin + phase;
+  while (clock::now() < end) {
+    while (!idle.empty() && endpoint.post(message_size, idle.back())) {
+      idle.pop_back();
+    }
+    result.writes += endpoint.poll(idle);
+  }
+  while (idle.size() < depth) {
+    result.writes += endpoint.poll(idle);
+  }
+  const double seconds =
+      std::chrono::duration<double>(clock::now() - begin).count();
+  result.bandwidth =
+      static_cast<double>(result.writes * message_size) / seconds;
+
+  // latency: one small write at a time
+  uint64_t round_trips = 0;
+  begin = clock::now();
+  end = begin + phase;
+  while (clock::now() < end) {
+    if (!endpoint.post(latency_message_size, idle.back())) {
+      continue;
+    }
+    idle.pop_back();
+    while (endpoint.poll(idle) == 0) {
+    }
+    ++round_trips;
+  }
+  if (round_trips > 0) {
+    result.latency_us =
+        std::chrono::duration<double, std::micro>(clock::now() - begin)
+            .count() /
+        static_cast<double>(round_trips);
+  }
+  return result;
+}
+
+} // namespace tl_libfabric
@@ -0,0 +1,38 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+/// \file
+/// \brief Defines the measure_write_loopback() function.
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace tl_libfabric {
+
+/// Result of an RDMA write loopback measurement.
+struct WriteLoopbackResult {
+  std::string provider;    ///< Provider name (e.g., "verbs;ofi_rxm")
+  uint64_t writes = 0;     ///< Number of writes in the bandwidth phase
+  double bandwidth = 0.0;  ///< Write bandwidth in bytes per second
+  double latency_us = 0.0; ///< Mean completion latency of small writes
+};
+
+/// Measure the fi_write() bandwidth and latency from this process to itself.
+/**
+   The provider selected for the local host name (see Provider::init()) is
+   used through a reliable datagram endpoint (with the RxM utility provider
+   for connection-oriented providers) that writes to its own address, so
+   the data path includes the local network interface of hardware
+   providers. The bandwidth is measured with up to 16 outstanding writes of
+   the given size, the latency with single writes of 64 bytes, each phase
+   for half of the duration.
+
+   \throws LibfabricException if the endpoint cannot be set up
+*/
+WriteLoopbackResult measure_write_loopback(const std::string& local_host_name,
+                                           std::size_t message_size,
+                                           std::chrono::milliseconds duration);
+
+} // namespace tl_libfabric
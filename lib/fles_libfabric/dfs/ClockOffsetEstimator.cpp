@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "ClockOffsetEstimator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tl_libfabric {
+
+namespace {
+int64_t to_us(ClockOffsetEstimator::time_point time) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             time.time_since_epoch())
+      .count();
+}
+} // namespace
+
+void ClockOffsetEstimator::add_exchange(time_point receive_time,
+                                        time_point remote_send_time,
+                                        time_point echo_time,
+                                        uint64_t hold_time) {
+  const int64_t t4 = to_us(receive_time);
+  const int64_t t3 = to_us(remote_send_time);
+  const int64_t t1 = to_us(echo_time);
+  const int64_t hold = static_cast<int64_t>(hold_time);
+  // the remote node received the local message at t2 = t3 - hold
+  const int64_t round_trip_time = (t4 - t1) - hold;
+  if (t1 == 0 || round_trip_time < 0)
+    return;
+
+  Sample sample{t4, ((t4 - t3) + (t1 - (t3 - hold))) / 2,
+                static_cast<uint64_t>(round_trip_time)};
+  ++sample_count_;
+
+  if (period_valid_ && sample.time - period_start_ >= FILTER_PERIOD_) {
+    history_.push_back(period_best_);
+    if (history_.size() > HISTORY_SIZE_)
+      history_.pop_front();
+    period_valid_ = false;
+    fit();
+  }
+  if (!period_valid_) {
+    period_valid_ = true;
+    period_start_ = sample.time;
+    period_best_ = sample;
+  } else if (sample.round_trip_time < period_best_.round_trip_time) {
+    period_best_ = sample;
+  }
+}
+
+bool ClockOffsetEstimator::ready() const { return sample_count_ != 0; }
+
+int64_t ClockOffsetEstimator::get_offset(time_point local_time) const {
+  if (history_.empty())
+    return period_best_.offset;
+  return std::llround(offset_ +
+                      drift_ * static_cast<double>(to_us(local_time) -
+                                                   reference_time_));
+}
+
+ClockOffsetEstimator::Status ClockOffsetEstimator::get_status() const {
+  Status status;
+  status.sample_count = sample_count_;
+  status.offset = get_offset(std::chrono::high_resolution_clock::now());
+  status.drift = drift_ * 1e6;
+  status.round_trip_time = history_.empty() ? period_best_.round_trip_time
+                                            : history_.back().round_trip_time;
+  return status;
+}
+
+void ClockOffsetEstimator::fit() {
+  // times relative to the newest sample keep the sums well-conditioned
+  reference_time_ = history_.back().time;
+  const double n = static_cast<double>(history_.size());
+  double sum_t = 0;
+  double sum_o = 0;
+  for (const Sample& sample : history_) {
+    sum_t += static_cast<double>(sample.time - reference_time_);
+    sum_o += static_cast<double>(sample.offset);
+  }
+  const double mean_t = sum_t / n;
+  const double mean_o = sum_o / n;
+  double s_tt = 0;
+  double s_to = 0;
+  for (const Sample& sample : history_) {
+    const double t =
+        static_cast<double>(sample.time - reference_time_) - mean_t;
+    s_tt += t * t;
+    s_to += t * (static_cast<double>(sample.offset) - mean_o);
+  }
+  drift_ = s_tt > 0 ? std::clamp(s_to / s_tt, -MAX_DRIFT_, MAX_DRIFT_) : 0;
+  offset_ = mean_o - drift_ * mean_t;
+}
+} // namespace tl_libfabric
@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+
+namespace tl_libfabric {
+/**
+ * Continuous NTP-style estimation of the offset and drift of a remote clock.
+ *
+ * Each exchange of status messages yields a sample of the offset from four
+ * timestamps: the remote node echoes the local send time of the last
+ * message it received and the time it held that message before sending its
+ * own. The offset sample of an exchange is the mean of the one-way delays in
+ * both directions, which is exact if the path delay is symmetric. Queueing
+ * delays make it asymmetric, so only the sample of lowest round-trip time in
+ * each filter period is used. A least-squares line through the filtered
+ * samples of the last periods gives the current offset and the drift, so
+ * that the offset can be extrapolated between the periods.
+ */
+class ClockOffsetEstimator {
+public:
+  using time_point = std::chrono::high_resolution_clock::time_point;
+
+  // Snapshot of the estimates for monitoring
+  struct Status {
+    uint64_t sample_count = 0;
+    // Offset of the remote clock to the local clock (us)
+    int64_t offset = 0;
+    // Drift of the remote clock to the local clock (ppm)
+    double drift = 0;
+    // Round-trip time of the last filtered sample (us)
+    uint64_t round_trip_time = 0;
+  };
+
+  // Add the sample of a message exchange given the local receive time of the
+  // remote message, the remote send time of that message, the local send time
+  // echoed by it and the time (us) the remote node held the local message
+  void add_exchange(time_point receive_time,
+                    time_point remote_send_time,
+                    time_point echo_time,
+                    uint64_t hold_time);
+
+  // Check whether a sample has been added
+  bool ready() const;
+
+  // Get the offset (us) to add to a remote time to get the local time at the
+  // given local time
+  int64_t get_offset(time_point local_time) const;
+
+  // Get the current estimates
+  Status get_status() const;
+
+private:
+  struct Sample {
+    // Local time of the sample (us since the epoch)
+    int64_t time;
+    int64_t offset;
+    uint64_t round_trip_time;
+  };
+
+  // Refit the offset line through the filtered samples
+  void fit();
+
+  // Duration of a filter period (us)
+  static constexpr int64_t FILTER_PERIOD_ = 1000000;
+
+  // Number of filtered samples in the fit (covering about a minute)
+  static constexpr std::size_t HISTORY_SIZE_ = 64;
+
+  // Maximum drift of the remote clock assumed in the fit
+  static constexpr double MAX_DRIFT_ = 500e-6;
+
+  uint64_t sample_count_ = 0;
+
+  // The best sample of the current filter period
+  bool period_valid_ = false;
+  int64_t period_start_ = 0;
+  Sample period_best_{};
+
+  // The best samples of the past filter periods
+  std::deque<Sample> history_;
+
+  // The fitted line: offset_ + drift_ * (time - reference_time_)
+  int64_t reference_time_ = 0;
+  double offset_ = 0;
+  double drift_ = 0;
+};
+} // namespace tl_libfabric
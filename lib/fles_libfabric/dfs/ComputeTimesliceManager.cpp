@@ -26,7 +26,7 @@ ComputeTimesliceManager::ComputeTimesliceManager(
     uint32_t input_connection_count,
     std::string log_directory,
     bool enable_logging)
-    : compute_index_(compute_index),
+    : arrivals_(input_connection_count), compute_index_(compute_index),
       input_connection_count_(input_connection_count),
       log_directory_(log_directory), enable_logging_(enable_logging) {
   assert(input_connection_count > 0);
@@ -37,6 +37,7 @@ void ComputeTimesliceManager::update_input_connection_count(
     uint32_t input_connection_count) {
   assert(input_connection_count > 0);
   input_connection_count_ = input_connection_count;
+  arrivals_.set_num_inputs(input_connection_count);
 }
 
 void ComputeTimesliceManager::log_contribution_arrival(uint32_t connection_id,
@@ -51,35 +52,16 @@ void ComputeTimesliceManager::log_contribution_arrival(uint32_t connection_id,
         timeslice, std::chrono::high_resolution_clock::now());
   }
 
-  std::set<uint32_t>* arrived_count;
-  if (timeslice_arrived_count_.contains(timeslice)) {
-    arrived_count = timeslice_arrived_count_.get(timeslice);
-    if (arrived_count->find(connection_id) != arrived_count->end())
-      return;
-    arrived_count->insert(connection_id);
-  } else {
-    arrived_count = new std::set<uint32_t>();
-    arrived_count->insert(connection_id);
-    timeslice_arrived_count_.add(timeslice, arrived_count);
-  }
-
-  assert(arrived_count->size() <= input_connection_count_);
-  if (arrived_count->size() == input_connection_count_) {
+  if (arrivals_.mark_arrived(timeslice, connection_id)) {
     trigger_timeslice_completion(timeslice);
   }
-  arrived_count = nullptr;
 }
 
 bool ComputeTimesliceManager::undo_log_contribution_arrival(
     uint32_t connection_id, uint64_t timeslice) {
 
   if (timeslice_completion_duration_.contains(timeslice)) {
-    std::set<uint32_t>* arrived_count = new std::set<uint32_t>();
-    for (uint32_t conn = 0; conn < input_connection_count_; conn++)
-      if (conn != connection_id)
-        arrived_count->insert(conn);
-
-    timeslice_arrived_count_.add(timeslice, arrived_count);
+    arrivals_.unmark_arrived(timeslice, connection_id);
     uint64_t dur = timeslice_completion_duration_.get(timeslice);
     timeslice_first_arrival_time_.add(
         timeslice, std::chrono::high_resolution_clock::now() -
@@ -92,14 +74,7 @@ bool ComputeTimesliceManager::undo_log_contribution_arrival(
     return true;
   }
 
-  if (timeslice_arrived_count_.contains(timeslice)) {
-    std::set<uint32_t>* arrived_count = timeslice_arrived_count_.get(timeslice);
-    if (arrived_count->find(connection_id) != arrived_count->end()) {
-      arrived_count->erase(connection_id);
-      return true;
-    }
-  }
-  return false;
+  return arrivals_.unmark_arrived(timeslice, connection_id);
 }
 
 void ComputeTimesliceManager::log_timeout_timeslice() {
@@ -122,7 +97,7 @@ void ComputeTimesliceManager::log_timeout_timeslice() {
 
     timeslice_timed_out_.add(timeslice, taken_duration);
     assert(timeslice_first_arrival_time_.remove(timeslice));
-    assert(timeslice_arrived_count_.remove(timeslice));
+    arrivals_.clear(timeslice);
   }
 }
 
@@ -134,6 +109,14 @@ bool ComputeTimesliceManager::is_timeslice_timed_out(uint64_t timeslice) {
   return timeslice_timed_out_.contains(timeslice);
 }
 
+bool ComputeTimesliceManager::is_timeslice_complete(uint64_t timeslice) const {
+  return arrivals_.complete(timeslice);
+}
+
+void ComputeTimesliceManager::release_timeslices(uint64_t end) {
+  arrivals_.release(end);
+}
+
 void ComputeTimesliceManager::trigger_timeslice_completion(uint64_t timeslice) {
   double duration = std::chrono::duration_cast<std::chrono::microseconds>(
                         std::chrono::high_resolution_clock::now() -
@@ -142,7 +125,6 @@ void ComputeTimesliceManager::trigger_timeslice_completion(uint64_t timeslice) {
   timeslice_completion_duration_.add(timeslice, duration);
 
   timeslice_first_arrival_time_.remove(timeslice);
-  timeslice_arrived_count_.remove(timeslice);
 
   if (last_ordered_timeslice_ == ConstVariables::MINUS_ONE && timeslice == 0)
     last_ordered_timeslice_ = 0;
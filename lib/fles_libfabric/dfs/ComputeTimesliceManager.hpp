@@ -4,6 +4,7 @@
 
 #include "ConstVariables.hpp"
 #include "SizedMap.hpp"
+#include "TimesliceCompletionTable.hpp"
 
 #include <cassert>
 #include <chrono>
@@ -53,6 +54,12 @@ public:
   // Check whether a timeslice is timed out
   bool is_timeslice_timed_out(uint64_t timeslice);
 
+  // Check whether the contributions of all connections have arrived
+  bool is_timeslice_complete(uint64_t timeslice) const;
+
+  // Allow the arrival slots of all timeslices below end to be reused
+  void release_timeslices(uint64_t end);
+
   // Generate log files of the stored data
   void generate_log_files();
 
@@ -69,8 +76,8 @@ private:
   SizedMap<uint64_t, std::chrono::high_resolution_clock::time_point>
       timeslice_first_arrival_time_;
 
-  // Counts the number of received contributions of each timeslice
-  SizedMap<uint64_t, std::set<uint32_t>*> timeslice_arrived_count_;
+  // The received contributions of each timeslice
+  TimesliceCompletionTable arrivals_;
 
   // The singleton instance for this class
   static ComputeTimesliceManager* instance_;
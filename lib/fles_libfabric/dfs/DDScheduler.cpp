@@ -2,6 +2,7 @@
 
 #include "DDScheduler.hpp"
 
+#include <algorithm>
 // TO BE REMOVED
 #include <fstream>
 #include <iomanip>
@@ -16,13 +17,16 @@ DDScheduler* DDScheduler::get_instance(uint32_t scheduler_index,
                                        uint32_t speedup_difference_percentage,
                                        uint32_t speedup_percentage,
                                        uint32_t speedup_interval_count,
+                                       SchedulerPolicy policy,
+                                       uint32_t target_buffer_fill,
                                        std::string log_directory,
                                        bool enable_logging) {
   if (instance_ == nullptr) {
     instance_ = new DDScheduler(
         scheduler_index, input_scheduler_count, history_size, interval_length,
         speedup_difference_percentage, speedup_percentage,
-        speedup_interval_count, log_directory, enable_logging);
+        speedup_interval_count, policy, target_buffer_fill, log_directory,
+        enable_logging);
   }
   return instance_;
 }
@@ -51,6 +55,18 @@ void DDScheduler::update_clock_offset(
             .count() -
         median_latency;
   }
+  if (median_latency != ConstVariables::ZERO)
+    pacing_model_.add_round_trip_time(median_latency);
+}
+
+void DDScheduler::add_clock_exchange(
+    uint32_t input_index,
+    std::chrono::high_resolution_clock::time_point receive_time,
+    std::chrono::high_resolution_clock::time_point input_send_time,
+    std::chrono::high_resolution_clock::time_point echo_time,
+    uint64_t hold_time) {
+  input_scheduler_info_[input_index]->clock_estimator.add_exchange(
+      receive_time, input_send_time, echo_time, hold_time);
 }
 
 void DDScheduler::set_begin_time(
@@ -65,8 +81,8 @@ void DDScheduler::add_actual_meta_data(uint32_t input_index,
           meta_data.interval_index))
     return;
 
-  meta_data.start_time += std::chrono::microseconds(
-      input_scheduler_info_[input_index]->clock_offset);
+  meta_data.start_time +=
+      std::chrono::microseconds(get_clock_offset(input_index));
   input_scheduler_info_[input_index]->interval_info_.add(
       meta_data.interval_index, meta_data);
 
@@ -78,6 +94,10 @@ DDScheduler::get_proposed_meta_data(uint32_t input_index,
                                     uint64_t interval_index) {
   if (actual_interval_meta_data_.empty())
     return nullptr;
+  // the input nodes wait for the size of the timeslices of the interval
+  if (timeslice_target_bytes_ != 0 &&
+      get_timeslice_size(interval_index * interval_length_) == 0)
+    return nullptr;
 
   IntervalMetaData* interval_info;
   if (proposed_interval_meta_data_.contains(interval_index)) {
@@ -87,8 +107,11 @@ DDScheduler::get_proposed_meta_data(uint32_t input_index,
     interval_info = new IntervalMetaData(
         *calculate_proposed_interval_meta_data(interval_index));
   }
-  interval_info->start_time -= std::chrono::microseconds(
-      input_scheduler_info_[input_index]->clock_offset);
+  interval_info->start_time -=
+      std::chrono::microseconds(get_clock_offset(input_index));
+  if (timeslice_target_bytes_ != 0)
+    interval_info->timeslice_size = get_timeslice_size(interval_index *
+                                                       interval_length_);
   return interval_info;
 }
 
@@ -100,37 +123,70 @@ uint64_t DDScheduler::get_last_completed_interval() {
 
 // Generate log files of the stored data
 void DDScheduler::generate_log_files() {
-  if (!enable_logging_)
+  if (!interval_log_)
     return;
 
+  for (SizedMap<uint64_t, IntervalDataLog>::iterator it =
+           pending_interval_logs_.get_begin_iterator();
+       it != pending_interval_logs_.get_end_iterator(); ++it) {
+    interval_log_->append(it->second);
+  }
+  interval_log_->close();
+
   std::ofstream log_file;
   log_file.open(log_directory_ + "/" + std::to_string(scheduler_index_) +
                 ".compute.min_max_interval_info.out");
-
-  log_file << std::setw(25) << "Interval" << std::setw(25) << "Min start"
-           << std::setw(25) << "Max start" << std::setw(25) << "Min duration"
-           << std::setw(25) << "Max duration" << std::setw(25)
-           << "Proposed duration" << std::setw(25) << "Enhanced duration"
-           << std::setw(25) << "Speedup Factor" << std::setw(25) << "Rounds"
-           << "\n";
-
-  for (SizedMap<uint64_t, IntervalDataLog*>::iterator it =
-           interval_info_logger_.get_begin_iterator();
-       it != interval_info_logger_.get_end_iterator(); ++it) {
-    log_file << std::setw(25) << it->first << std::setw(25)
-             << it->second->min_start << std::setw(25) << it->second->max_start
-             << std::setw(25) << it->second->min_duration << std::setw(25)
-             << it->second->max_duration << std::setw(25)
-             << it->second->proposed_duration << std::setw(25)
-             << it->second->enhanced_duration << std::setw(25)
-             << it->second->speedup_applied << std::setw(25)
-             << it->second->rounds_count << "\n";
-  }
-
+  convert_interval_log(interval_log_->path(), log_file);
   log_file.flush();
   log_file.close();
 }
 
+void DDScheduler::convert_interval_log(const std::string& log_path,
+                                       std::ostream& out) {
+  out << std::setw(25) << "Interval" << std::setw(25) << "Min start"
+      << std::setw(25) << "Max start" << std::setw(25) << "Min duration"
+      << std::setw(25) << "Max duration" << std::setw(25)
+      << "Proposed duration" << std::setw(25) << "Enhanced duration"
+      << std::setw(25) << "Speedup Factor" << std::setw(25) << "Rounds"
+      << "\n";
+
+  SchedulerRecordLog<IntervalDataLog>::for_each(
+      log_path, [&out](const IntervalDataLog& entry) {
+        out << std::setw(25) << entry.interval_index << std::setw(25)
+            << entry.min_start << std::setw(25) << entry.max_start
+            << std::setw(25) << entry.min_duration << std::setw(25)
+            << entry.max_duration << std::setw(25) << entry.proposed_duration
+            << std::setw(25) << entry.enhanced_duration << std::setw(25)
+            << entry.speedup_applied << std::setw(25) << entry.rounds_count
+            << "\n";
+      });
+}
+
+SchedulerPolicy DDScheduler::get_policy() const { return policy_; }
+
+IntervalPacingModel::Status DDScheduler::get_pacing_status() const {
+  IntervalPacingModel::Status status = pacing_model_.get_status();
+  status.proposed_duration = last_proposed_duration_;
+  return status;
+}
+
+void DDScheduler::set_timeslice_target_bytes(uint64_t target_bytes,
+                                             uint32_t max_timeslice_size) {
+  timeslice_target_bytes_ = target_bytes;
+  max_timeslice_size_ = max_timeslice_size;
+}
+
+uint32_t DDScheduler::get_timeslice_size(uint64_t timeslice) {
+  // The sizes change every interval length of timeslices, i.e., at the
+  // nominal interval boundaries, which all nodes agree on
+  uint64_t interval_index = timeslice / interval_length_;
+  if (interval_index < 2)
+    return max_timeslice_size_;
+  return timeslice_sizes_.contains(interval_index)
+             ? timeslice_sizes_.get(interval_index)
+             : 0;
+}
+
 // PRIVATE
 DDScheduler::DDScheduler(uint32_t scheduler_index,
                          uint32_t input_connection_count,
@@ -139,6 +195,8 @@ DDScheduler::DDScheduler(uint32_t scheduler_index,
                          uint32_t speedup_difference_percentage,
                          uint32_t speedup_percentage,
                          uint32_t speedup_interval_count,
+                         SchedulerPolicy policy,
+                         uint32_t target_buffer_fill,
                          std::string log_directory,
                          bool enable_logging)
     : scheduler_index_(scheduler_index),
@@ -146,13 +204,27 @@ DDScheduler::DDScheduler(uint32_t scheduler_index,
       history_size_(history_size), interval_length_(interval_length),
       speedup_difference_percentage_(speedup_difference_percentage),
       speedup_percentage_(speedup_percentage),
-      speedup_interval_count_(speedup_interval_count),
-      log_directory_(log_directory), enable_logging_(enable_logging) {
+      speedup_interval_count_(speedup_interval_count), policy_(policy),
+      pacing_model_(target_buffer_fill), log_directory_(log_directory),
+      enable_logging_(enable_logging) {
 
   // TODO check correctness
   compute_node_count_ = input_connection_count;
   for (uint_fast16_t i = 0; i < input_connection_count; i++)
     input_scheduler_info_.push_back(new InputSchedulerData());
+
+  if (enable_logging_)
+    interval_log_ = std::make_unique<SchedulerRecordLog<IntervalDataLog>>(
+        log_directory_ + "/" + std::to_string(scheduler_index_) +
+        ".compute.min_max_interval_info.bin");
+}
+
+int64_t DDScheduler::get_clock_offset(uint32_t input_index) const {
+  const InputSchedulerData* input = input_scheduler_info_[input_index];
+  if (input->clock_estimator.ready())
+    return input->clock_estimator.get_offset(
+        std::chrono::high_resolution_clock::now());
+  return input->clock_offset;
 }
 
 void DDScheduler::trigger_complete_interval(const uint64_t interval_index) {
@@ -186,12 +258,15 @@ void DDScheduler::calculate_interval_info(uint64_t interval_index) {
       get_average_start_timeslice(interval_index);
   uint64_t average_last_timeslice = get_average_last_timeslice(interval_index);
   compute_node_count_ = get_average_compute_node_count(interval_index);
-  actual_interval_meta_data_.add(
-      interval_index,
-      new IntervalMetaData(interval_index, average_round_count,
-                           average_start_timeslice, average_last_timeslice,
-                           average_start_time, median_interval_duration,
-                           compute_node_count_));
+  IntervalMetaData* actual_metadata = new IntervalMetaData(
+      interval_index, average_round_count, average_start_timeslice,
+      average_last_timeslice, average_start_time, median_interval_duration,
+      compute_node_count_);
+  fill_compute_buffer_pressure(interval_index, actual_metadata);
+  if (timeslice_target_bytes_ != 0)
+    calculate_timeslice_size(interval_index, actual_metadata);
+  actual_interval_meta_data_.add(interval_index, actual_metadata);
+  pacing_model_.add_interval(*actual_metadata);
 
   if (true) {
     L_(info) << "[" << scheduler_index_ << "] interval " << interval_index
@@ -202,28 +277,27 @@ void DDScheduler::calculate_interval_info(uint64_t interval_index) {
   }
 
   // LOGGING
-  uint64_t min_start_time =
+  if (!interval_log_)
+    return;
+  IntervalDataLog interval_log;
+  if (pending_interval_logs_.contains(interval_index)) {
+    interval_log = pending_interval_logs_.get(interval_index);
+    pending_interval_logs_.remove(interval_index);
+  } else {
+    interval_log.interval_index = interval_index;
+    interval_log.rounds_count = average_round_count;
+  }
+  interval_log.min_start =
       std::chrono::duration_cast<std::chrono::milliseconds>(
           get_start_time_statistics(interval_index, 0, 1) - begin_time_)
           .count();
-  uint64_t max_start_time =
+  interval_log.max_start =
       std::chrono::duration_cast<std::chrono::milliseconds>(
           get_start_time_statistics(interval_index, 0, 0) - begin_time_)
           .count();
-  if (interval_info_logger_.contains(interval_index)) {
-    IntervalDataLog* interval_log = interval_info_logger_.get(interval_index);
-    interval_log->min_start = min_start_time;
-    interval_log->max_start = max_start_time;
-    interval_log->min_duration = get_duration_statistics(interval_index, 0, 1);
-    interval_log->max_duration = get_duration_statistics(interval_index, 0, 0);
-  } else {
-    interval_info_logger_.add(
-        interval_index,
-        new IntervalDataLog(min_start_time, max_start_time,
-                            get_duration_statistics(interval_index, 0, 1),
-                            get_duration_statistics(interval_index, 0, 0),
-                            average_round_count));
-  }
+  interval_log.min_duration = get_duration_statistics(interval_index, 0, 1);
+  interval_log.max_duration = get_duration_statistics(interval_index, 0, 0);
+  interval_log_->append(interval_log);
   //
 }
 
@@ -251,10 +325,10 @@ DDScheduler::calculate_proposed_interval_meta_data(uint64_t interval_index) {
       compute_node_count_ - compute_node_timeout_count_;
 
   uint64_t median_interval_duration = get_median_interval_duration_history();
-  uint64_t new_interval_duration =
-      get_enhanced_interval_duration(interval_index);
   uint32_t round_count = floor(interval_length_ / active_compute_count);
   round_count = round_count == 0 ? 1 : round_count;
+  uint64_t new_interval_duration = get_proposed_interval_duration(
+      interval_index, round_count * active_compute_count, round_count);
 
   std::chrono::high_resolution_clock::time_point new_start_time =
       last_interval_info->start_time +
@@ -277,18 +351,93 @@ DDScheduler::calculate_proposed_interval_meta_data(uint64_t interval_index) {
       interval_index, round_count, new_start_timeslice,
       new_start_timeslice + (round_count * active_compute_count) - 1,
       new_start_time, new_interval_duration, compute_node_count_);
+  fill_placement_weights(interval_index, new_interval_metadata);
   proposed_interval_meta_data_.add(interval_index, new_interval_metadata);
 
   // LOGGING
-  uint64_t median_duration = get_median_interval_duration_history();
-  interval_info_logger_.add(
-      interval_index,
-      new IntervalDataLog(median_duration, new_interval_duration, round_count,
-                          new_interval_duration != median_duration ? 1 : 0));
+  if (interval_log_) {
+    IntervalDataLog interval_log;
+    interval_log.interval_index = interval_index;
+    interval_log.proposed_duration = get_median_interval_duration_history();
+    interval_log.enhanced_duration = new_interval_duration;
+    interval_log.rounds_count = round_count;
+    interval_log.speedup_applied =
+        new_interval_duration != interval_log.proposed_duration ? 1 : 0;
+    pending_interval_logs_.add(interval_index, interval_log);
+  }
 
   return new_interval_metadata;
 }
 
+void DDScheduler::fill_compute_buffer_pressure(uint64_t interval_index,
+                                               IntervalMetaData* meta_data) {
+  for (uint32_t i = 0; i < input_connection_count_; i++) {
+    const IntervalMetaData& input_meta_data =
+        input_scheduler_info_[i]->interval_info_.get(interval_index);
+    for (uint32_t c = 0; c < ConstVariables::MAX_COMPUTE_NODE_COUNT; c++) {
+      if (meta_data->placement_info[c] < input_meta_data.placement_info[c])
+        meta_data->placement_info[c] = input_meta_data.placement_info[c];
+    }
+    if (meta_data->input_buffer_fill < input_meta_data.input_buffer_fill)
+      meta_data->input_buffer_fill = input_meta_data.input_buffer_fill;
+  }
+}
+
+void DDScheduler::fill_placement_weights(uint64_t interval_index,
+                                         IntervalMetaData* meta_data) {
+  // The weights are based on the interval that every compute node has
+  // completed when the proposal is requested, so that all compute nodes
+  // propose the same placement
+  const IntervalMetaData* source_interval =
+      interval_index >= 2 &&
+              actual_interval_meta_data_.contains(interval_index - 2)
+          ? actual_interval_meta_data_.get(interval_index - 2)
+          : nullptr;
+  uint32_t down_weighted = 0;
+  for (uint32_t c = 0; c < ConstVariables::MAX_COMPUTE_NODE_COUNT; c++) {
+    uint32_t pressure =
+        source_interval == nullptr ? 0 : source_interval->placement_info[c];
+    uint32_t weight = ConstVariables::PLACEMENT_MAX_WEIGHT;
+    if (pressure > ConstVariables::PLACEMENT_PRESSURE_THRESHOLD) {
+      // Reduce the weight linearly down to one at full pressure
+      weight -= (ConstVariables::PLACEMENT_MAX_WEIGHT - 1) *
+                (pressure - ConstVariables::PLACEMENT_PRESSURE_THRESHOLD) /
+                (ConstVariables::ONE_HUNDRED -
+                 ConstVariables::PLACEMENT_PRESSURE_THRESHOLD);
+      ++down_weighted;
+    }
+    meta_data->placement_info[c] = static_cast<uint8_t>(weight);
+  }
+  // The input nodes derive the share of timeslices to shed from it
+  meta_data->input_buffer_fill =
+      source_interval == nullptr ? 0 : source_interval->input_buffer_fill;
+  if (down_weighted > 0) {
+    L_(info) << "[" << scheduler_index_ << "] interval " << interval_index
+             << " down-weights " << down_weighted << " compute nodes";
+  }
+}
+
+void DDScheduler::calculate_timeslice_size(uint64_t interval_index,
+                                           IntervalMetaData* meta_data) {
+  // The size is based on the completed interval only, so that all compute
+  // nodes propose the same size
+  for (uint32_t i = 0; i < input_connection_count_; i++)
+    meta_data->microslice_size += input_scheduler_info_[i]
+                                      ->interval_info_.get(interval_index)
+                                      .microslice_size;
+  uint64_t min_size = std::max<uint64_t>(
+      1, max_timeslice_size_ / ConstVariables::ADAPTIVE_TIMESLICE_SIZE_RANGE);
+  uint64_t size = meta_data->microslice_size == 0
+                      ? max_timeslice_size_
+                      : timeslice_target_bytes_ / meta_data->microslice_size;
+  size = std::clamp<uint64_t>(size, min_size, max_timeslice_size_);
+  timeslice_sizes_.add(interval_index + 2, static_cast<uint32_t>(size));
+  L_(info) << "[" << scheduler_index_ << "] timeslices from "
+           << (interval_index + 2) * interval_length_ << " consist of "
+           << size << " microslices of " << meta_data->microslice_size
+           << " bytes";
+}
+
 uint64_t DDScheduler::get_enhanced_interval_duration(uint64_t interval_index) {
 
   if (speedup_interval_index_ != 0 &&
@@ -340,6 +489,29 @@ uint64_t DDScheduler::get_enhanced_interval_duration(uint64_t interval_index) {
   return median_interval_duration;
 }
 
+uint64_t DDScheduler::get_proposed_interval_duration(uint64_t interval_index,
+                                                     uint64_t timeslice_count,
+                                                     uint32_t round_count) {
+  uint64_t duration;
+  if (policy_ == SchedulerPolicy::Model && pacing_model_.ready()) {
+    duration = pacing_model_.propose_duration(timeslice_count, round_count);
+    if (true) {
+      IntervalPacingModel::Status status = pacing_model_.get_status();
+      L_(debug) << "[" << scheduler_index_ << "] interval " << interval_index
+                << " paced to " << duration << " us [per timeslice: "
+                << status.timeslice_duration_mean << " +- "
+                << status.timeslice_duration_stddev
+                << " us, RTT: " << status.round_trip_time
+                << " us, predicted buffer fill: "
+                << status.predicted_buffer_fill << "%]";
+    }
+  } else {
+    duration = get_enhanced_interval_duration(interval_index);
+  }
+  last_proposed_duration_ = duration;
+  return duration;
+}
+
 std::chrono::high_resolution_clock::time_point
 DDScheduler::get_start_time_statistics(uint64_t interval_index,
                                        bool average,
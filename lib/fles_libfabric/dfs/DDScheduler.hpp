@@ -2,8 +2,12 @@
 
 #pragma once
 
+#include "ClockOffsetEstimator.hpp"
 #include "ConstVariables.hpp"
 #include "IntervalMetaData.hpp"
+#include "IntervalPacingModel.hpp"
+#include "SchedulerPolicy.hpp"
+#include "SchedulerRecordLog.hpp"
 #include "SizedMap.hpp"
 
 #include <cassert>
@@ -13,6 +17,8 @@
 #include <log.hpp>
 #include <map>
 #include <math.h>
+#include <memory>
+#include <ostream>
 #include <set>
 #include <string>
 #include <vector>
@@ -32,6 +38,8 @@ public:
                                    uint32_t speedup_difference_percentage,
                                    uint32_t speedup_percentage,
                                    uint32_t speedup_interval_count,
+                                   SchedulerPolicy policy,
+                                   uint32_t target_buffer_fill,
                                    std::string log_directory,
                                    bool enable_logging);
 
@@ -45,6 +53,14 @@ public:
                       const uint64_t median_latency = ConstVariables::ZERO,
                       const uint64_t interval_index = ConstVariables::ZERO);
 
+  // Add the clock sample of a status message exchange with an input node
+  void add_clock_exchange(
+      uint32_t input_index,
+      std::chrono::high_resolution_clock::time_point receive_time,
+      std::chrono::high_resolution_clock::time_point input_send_time,
+      std::chrono::high_resolution_clock::time_point echo_time,
+      uint64_t hold_time);
+
   // Set the begin time to be used in logging
   void
   set_begin_time(std::chrono::high_resolution_clock::time_point begin_time);
@@ -66,11 +82,32 @@ public:
   // Generate log files of the stored data
   void generate_log_files();
 
+  // Convert a binary interval log to the text format of the log file
+  static void convert_interval_log(const std::string& log_path,
+                                   std::ostream& out);
+
+  // Get the policy deriving the interval durations
+  SchedulerPolicy get_policy() const;
+
+  // Get the pacing model estimates and the last proposed duration
+  IntervalPacingModel::Status get_pacing_status() const;
+
+  // Adapt the timeslice size to reach the target bytes per timeslice, up to
+  // the configured timeslice size
+  void set_timeslice_target_bytes(uint64_t target_bytes,
+                                  uint32_t max_timeslice_size);
+
+  // Get the number of core microslices of a timeslice if the timeslice size
+  // is adaptive, or zero if not decided yet
+  uint32_t get_timeslice_size(uint64_t timeslice);
+
 private:
   struct InputSchedulerData {
     // uint32_t index_;
     // std::chrono::high_resolution_clock::time_point MPI_Barrier_time;
     int64_t clock_offset = 0;
+    // Continuous estimate of the clock offset, used once available
+    ClockOffsetEstimator clock_estimator;
     /// <interval index, <actual_start_time,duration>>. Duration is the
     /// spent time from sending the contribution till getting the
     /// acknowledgement
@@ -78,36 +115,18 @@ private:
   };
 
   // LOGGING
+  // Fixed-size record of the interval log, written once the interval is
+  // completed (or at the end for the remaining proposed intervals)
   struct IntervalDataLog {
-    uint64_t min_start;
-    uint64_t max_start;
-    uint64_t min_duration;
-    uint64_t max_duration;
-    uint64_t proposed_duration;
-    uint64_t enhanced_duration;
-    uint64_t rounds_count;
-    bool speedup_applied;
-    // Constructor used when proposing an interval
-    IntervalDataLog(uint64_t proposed_duration,
-                    uint64_t enhanced_duration,
-                    uint64_t rounds_count,
-                    bool speedup_applied)
-        : min_start(0), max_start(0), min_duration(0), max_duration(0),
-          proposed_duration(proposed_duration),
-          enhanced_duration(enhanced_duration), rounds_count(rounds_count),
-          speedup_applied(speedup_applied) {}
-
-    // Constructor used when an entry is created after calculating the
-    // actual interval info
-    IntervalDataLog(uint64_t min_start,
-                    uint64_t max_start,
-                    uint64_t min_duration,
-                    uint64_t max_duration,
-                    uint64_t rounds_count)
-        : min_start(min_start), max_start(max_start),
-          min_duration(min_duration), max_duration(max_duration),
-          proposed_duration(0), enhanced_duration(0),
-          rounds_count(rounds_count), speedup_applied(0) {}
+    uint64_t interval_index = 0;
+    uint64_t min_start = 0;
+    uint64_t max_start = 0;
+    uint64_t min_duration = 0;
+    uint64_t max_duration = 0;
+    uint64_t proposed_duration = 0;
+    uint64_t enhanced_duration = 0;
+    uint64_t rounds_count = 0;
+    uint64_t speedup_applied = 0;
   };
   ///
 
@@ -118,6 +137,8 @@ private:
               uint32_t speedup_difference_percentage,
               uint32_t speedup_percentage,
               uint32_t speedup_interval_count,
+              SchedulerPolicy policy,
+              uint32_t target_buffer_fill,
               std::string log_directory,
               bool enable_logging);
 
@@ -125,6 +146,9 @@ private:
   // statistics
   void trigger_complete_interval(const uint64_t interval_index);
 
+  // Offset (us) of the clock of an input node to the local clock
+  int64_t get_clock_offset(uint32_t input_index) const;
+
   // Calculate the statistics of an interval aftere receiving all the required
   // actual meta-data
   void calculate_interval_info(uint64_t interval_index);
@@ -133,9 +157,29 @@ private:
   const IntervalMetaData*
   calculate_proposed_interval_meta_data(uint64_t interval_index);
 
+  // Fill the maximum buffer pressure of each compute node and the maximum
+  // input buffer fill level reported by the input schedulers for an interval
+  void fill_compute_buffer_pressure(uint64_t interval_index,
+                                    IntervalMetaData* meta_data);
+
+  // Fill the placement weights of each compute node and the input buffer
+  // fill level of a proposed interval
+  void fill_placement_weights(uint64_t interval_index,
+                              IntervalMetaData* meta_data);
+
+  // Derive the adaptive timeslice size of the timeslices two intervals after
+  // a completed interval from its microslice sizes
+  void calculate_timeslice_size(uint64_t interval_index,
+                                IntervalMetaData* meta_data);
+
   // Minimize the enhanced interval duration if the variance is low
   uint64_t get_enhanced_interval_duration(uint64_t interval_index);
 
+  // Get the interval duration according to the scheduler policy
+  uint64_t get_proposed_interval_duration(uint64_t interval_index,
+                                          uint64_t timeslice_count,
+                                          uint32_t round_count);
+
   // Get statistics about start time of an interval average, minimal, or
   // maximal
   std::chrono::high_resolution_clock::time_point get_start_time_statistics(
@@ -229,6 +273,24 @@ private:
   // The interval number when stabilizing is started
   uint64_t stabilizing_interval_index_ = 0;
 
+  // The policy deriving the interval durations
+  SchedulerPolicy policy_;
+
+  // The online throughput model used by the Model policy
+  IntervalPacingModel pacing_model_;
+
+  // The last proposed interval duration
+  uint64_t last_proposed_duration_ = 0;
+
+  // The target bytes per timeslice, zero if the timeslice size is fixed
+  uint64_t timeslice_target_bytes_ = 0;
+
+  // The configured timeslice size, the maximum of the adaptive sizes
+  uint32_t max_timeslice_size_ = 0;
+
+  // The adaptive timeslice sizes by interval
+  SizedMap<uint64_t, uint32_t> timeslice_sizes_;
+
   // The total count of active & timeout compute nodes
   uint32_t compute_node_count_;
 
@@ -240,6 +302,10 @@ private:
 
   bool enable_logging_;
   // LOGGING
-  SizedMap<uint64_t, IntervalDataLog*> interval_info_logger_;
+  // Proposed intervals that are not completed yet
+  SizedMap<uint64_t, IntervalDataLog> pending_interval_logs_;
+
+  // The streaming log of the interval records
+  std::unique_ptr<SchedulerRecordLog<IntervalDataLog>> interval_log_;
 };
 } // namespace tl_libfabric
@@ -17,13 +17,15 @@ void DDSchedulerOrchestrator::initialize(uint32_t scheduler_index,
                                          uint32_t speedup_difference_percentage,
                                          uint32_t speedup_percentage,
                                          uint32_t speedup_interval_count,
+                                         SchedulerPolicy policy,
+                                         uint32_t target_buffer_fill,
                                          std::string log_directory,
                                          bool enable_logging) {
 
   interval_scheduler_ = DDScheduler::get_instance(
       scheduler_index, input_scheduler_count, history_size, interval_length,
       speedup_difference_percentage, speedup_percentage, speedup_interval_count,
-      log_directory, enable_logging);
+      policy, target_buffer_fill, log_directory, enable_logging);
   timeslice_manager_ = ComputeTimesliceManager::get_instance(
       scheduler_index, input_scheduler_count, log_directory, enable_logging);
   heartbeat_manager_ = ComputeHeartbeatManager::get_instance(
@@ -42,6 +44,17 @@ void DDSchedulerOrchestrator::update_clock_offset(
                                            median_latency, interval_index);
 }
 
+void DDSchedulerOrchestrator::add_clock_exchange(
+    uint32_t input_index,
+    std::chrono::high_resolution_clock::time_point receive_time,
+    std::chrono::high_resolution_clock::time_point input_send_time,
+    std::chrono::high_resolution_clock::time_point echo_time,
+    uint64_t hold_time) {
+  interval_scheduler_->add_clock_exchange(input_index, receive_time,
+                                          input_send_time, echo_time,
+                                          hold_time);
+}
+
 void DDSchedulerOrchestrator::set_begin_time(
     std::chrono::high_resolution_clock::time_point begin_time) {
   interval_scheduler_->set_begin_time(begin_time);
@@ -70,6 +83,24 @@ uint64_t DDSchedulerOrchestrator::get_last_completed_interval() {
   return interval_scheduler_->get_last_completed_interval();
 }
 
+SchedulerPolicy DDSchedulerOrchestrator::get_policy() {
+  return interval_scheduler_->get_policy();
+}
+
+IntervalPacingModel::Status DDSchedulerOrchestrator::get_pacing_status() {
+  return interval_scheduler_->get_pacing_status();
+}
+
+void DDSchedulerOrchestrator::set_timeslice_target_bytes(
+    uint64_t target_bytes, uint32_t max_timeslice_size) {
+  interval_scheduler_->set_timeslice_target_bytes(target_bytes,
+                                                  max_timeslice_size);
+}
+
+uint32_t DDSchedulerOrchestrator::get_timeslice_size(uint64_t timeslice) {
+  return interval_scheduler_->get_timeslice_size(timeslice);
+}
+
 //// ComputeTimesliceManager Methods
 
 void DDSchedulerOrchestrator::log_contribution_arrival(uint32_t connection_id,
@@ -95,6 +126,14 @@ bool DDSchedulerOrchestrator::is_timeslice_timed_out(uint64_t timeslice) {
   return timeslice_manager_->is_timeslice_timed_out(timeslice);
 }
 
+bool DDSchedulerOrchestrator::is_timeslice_complete(uint64_t timeslice) {
+  return timeslice_manager_->is_timeslice_complete(timeslice);
+}
+
+void DDSchedulerOrchestrator::release_timeslices(uint64_t end) {
+  timeslice_manager_->release_timeslices(end);
+}
+
 //// ComputeHeartbeatManager
 HeartbeatFailedNodeInfo* DDSchedulerOrchestrator::log_heartbeat_failure(
     uint32_t connection_id, HeartbeatFailedNodeInfo failure_info) {
@@ -28,6 +28,8 @@ public:
                          uint32_t speedup_difference_percentage,
                          uint32_t speedup_percentage,
                          uint32_t speedup_interval_count,
+                         SchedulerPolicy policy,
+                         uint32_t target_buffer_fill,
                          std::string log_directory,
                          bool enable_logging);
 
@@ -38,6 +40,14 @@ public:
                       const uint64_t median_latency = ConstVariables::ZERO,
                       const uint64_t interval_index = ConstVariables::ZERO);
 
+  // Add the clock sample of a status message exchange with an input node
+  static void add_clock_exchange(
+      uint32_t input_index,
+      std::chrono::high_resolution_clock::time_point receive_time,
+      std::chrono::high_resolution_clock::time_point input_send_time,
+      std::chrono::high_resolution_clock::time_point echo_time,
+      uint64_t hold_time);
+
   // Set the begin time to be used in logging
   static void
   set_begin_time(std::chrono::high_resolution_clock::time_point begin_time);
@@ -57,6 +67,20 @@ public:
   // Check what is the last completed interval
   static uint64_t get_last_completed_interval();
 
+  // Get the policy deriving the interval durations
+  static SchedulerPolicy get_policy();
+
+  // Get the pacing model estimates and the last proposed duration
+  static IntervalPacingModel::Status get_pacing_status();
+
+  // Adapt the timeslice size to reach the target bytes per timeslice
+  static void set_timeslice_target_bytes(uint64_t target_bytes,
+                                         uint32_t max_timeslice_size);
+
+  // Get the number of core microslices of a timeslice of adaptive size, or
+  // zero if not decided yet
+  static uint32_t get_timeslice_size(uint64_t timeslice);
+
   //// ComputeTimesliceManager Methods
 
   // Set the begin time to be used in logging
@@ -76,6 +100,12 @@ public:
   // Check whether a timeslice is timed out
   static bool is_timeslice_timed_out(uint64_t timeslice);
 
+  // Check whether the contributions of all connections have arrived
+  static bool is_timeslice_complete(uint64_t timeslice);
+
+  // Allow the arrival slots of all timeslices below end to be reused
+  static void release_timeslices(uint64_t end);
+
   //// ComputeHeartbeatManager Methods
 
   // log the arrival of failure node message
@@ -0,0 +1,231 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "HeartbeatAgent.hpp"
+
+#include "log.hpp"
+#include "providers/LibfabricException.hpp"
+#include "providers/Provider.hpp"
+
+#include <rdma/fi_cm.h>
+#include <rdma/fi_eq.h>
+#include <rdma/fi_errno.h>
+
+#include <cassert>
+#include <cstring>
+#include <sys/resource.h>
+
+namespace tl_libfabric {
+
+HeartbeatAgent::HeartbeatAgent(struct fid_domain* pd,
+                               struct fi_info* info,
+                               uint32_t index,
+                               uint32_t peer_count,
+                               std::chrono::microseconds interval)
+    : index_(index), interval_(interval), table_(peer_count, 0),
+      last_seen_(peer_count, 0),
+      alive_(std::make_unique<std::atomic<bool>[]>(peer_count)),
+      peers_(peer_count) {
+  assert(!Provider::getInst()->is_connection_oriented());
+
+  struct fi_cq_attr cq_attr;
+  memset(&cq_attr, 0, sizeof(cq_attr));
+  cq_attr.size = 2 * peer_count + 1;
+  cq_attr.format = FI_CQ_FORMAT_CONTEXT;
+  cq_attr.wait_obj = FI_WAIT_NONE;
+  int res = fi_cq_open(pd, &cq_attr, &cq_, nullptr);
+  if (res != 0) {
+    L_(fatal) << "fi_cq_open failed for heartbeat endpoint: " << res << "="
+              << fi_strerror(-res);
+    throw LibfabricException("fi_cq_open failed for heartbeat endpoint");
+  }
+
+  struct fi_av_attr av_attr;
+  memset(&av_attr, 0, sizeof(av_attr));
+  av_attr.type = FI_AV_TABLE;
+  av_attr.count = peer_count;
+  res = fi_av_open(pd, &av_attr, &av_, nullptr);
+  if (res != 0) {
+    L_(fatal) << "fi_av_open failed for heartbeat endpoint: " << res << "="
+              << fi_strerror(-res);
+    throw LibfabricException("fi_av_open failed for heartbeat endpoint");
+  }
+
+  res = fi_endpoint(pd, info, &ep_, this);
+  if (res != 0) {
+    L_(fatal) << "fi_endpoint failed for heartbeat endpoint: " << res << "="
+              << fi_strerror(-res);
+    throw LibfabricException("fi_endpoint failed for heartbeat endpoint");
+  }
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+  res = fi_ep_bind(ep_, (::fid_t)cq_, FI_TRANSMIT | FI_RECV);
+  if (res != 0) {
+    L_(fatal) << "fi_ep_bind failed for heartbeat endpoint (cq): " << res
+              << "=" << fi_strerror(-res);
+    throw LibfabricException("fi_ep_bind failed for heartbeat endpoint (cq)");
+  }
+  res = fi_ep_bind(ep_, (::fid_t)av_, 0);
+  if (res != 0) {
+    L_(fatal) << "fi_ep_bind failed for heartbeat endpoint (av): " << res
+              << "=" << fi_strerror(-res);
+    throw LibfabricException("fi_ep_bind failed for heartbeat endpoint (av)");
+  }
+#pragma GCC diagnostic pop
+  res = fi_enable(ep_);
+  if (res != 0) {
+    L_(fatal) << "fi_enable failed for heartbeat endpoint: " << res << "="
+              << fi_strerror(-res);
+    throw LibfabricException("fi_enable failed for heartbeat endpoint");
+  }
+
+  res = fi_mr_reg(pd, table_.data(), table_.size() * sizeof(uint64_t),
+                  FI_REMOTE_WRITE, 0, Provider::requested_key++, 0, &mr_table_,
+                  nullptr);
+  if (res != 0) {
+    L_(fatal) << "fi_mr_reg failed for heartbeat table: " << res << "="
+              << fi_strerror(-res);
+    throw LibfabricException("fi_mr_reg failed for heartbeat table");
+  }
+
+  size_t addr_len = sizeof(local_info_.address);
+  res = fi_getname(&ep_->fid, local_info_.address, &addr_len);
+  if (res != 0) {
+    L_(fatal) << "fi_getname failed for heartbeat endpoint: " << res << "="
+              << fi_strerror(-res);
+    throw LibfabricException("fi_getname failed for heartbeat endpoint");
+  }
+  local_info_.table_addr = reinterpret_cast<uintptr_t>(table_.data());
+  local_info_.table_key = fi_mr_key(mr_table_);
+  local_info_.valid = true;
+}
+
+HeartbeatAgent::~HeartbeatAgent() {
+  stop();
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+  if (ep_ != nullptr) {
+    fi_close((struct fid*)ep_);
+  }
+  if (mr_table_ != nullptr) {
+    fi_close((struct fid*)mr_table_);
+  }
+  if (av_ != nullptr) {
+    fi_close((struct fid*)av_);
+  }
+  if (cq_ != nullptr) {
+    fi_close((struct fid*)cq_);
+  }
+#pragma GCC diagnostic pop
+}
+
+void HeartbeatAgent::add_peer(uint32_t peer,
+                              const HeartbeatEndpointInfo& info) {
+  assert(!thread_.joinable());
+  assert(peer < peers_.size());
+  if (!info.valid) {
+    L_(warning) << "no heartbeat endpoint available for peer " << peer;
+    return;
+  }
+  int res = fi_av_insert(av_, info.address, 1, &peers_[peer].addr, 0, nullptr);
+  if (res != 1) {
+    L_(fatal) << "fi_av_insert failed for heartbeat endpoint: " << res;
+    throw LibfabricException("fi_av_insert failed for heartbeat endpoint");
+  }
+  peers_[peer].table_addr = info.table_addr;
+  peers_[peer].table_key = info.table_key;
+  peers_[peer].valid = true;
+}
+
+void HeartbeatAgent::start() {
+  assert(!thread_.joinable());
+  stop_ = false;
+  thread_ = std::thread([this] { run(); });
+}
+
+void HeartbeatAgent::stop() {
+  stop_ = true;
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+std::vector<uint32_t> HeartbeatAgent::retrieve_alive_peers() {
+  std::vector<uint32_t> peers;
+  for (uint32_t i = 0; i < peers_.size(); i++) {
+    if (alive_[i].exchange(false, std::memory_order_acquire)) {
+      peers.push_back(i);
+    }
+  }
+  return peers;
+}
+
+void HeartbeatAgent::run() {
+  // Heartbeats must not compete with the data path; on Linux, this affects
+  // the calling thread only
+  setpriority(PRIO_PROCESS, 0, 10);
+
+  try {
+    while (!stop_) {
+      ++counter_;
+      write_counters();
+      progress();
+      scan_table();
+      std::this_thread::sleep_for(interval_);
+    }
+  } catch (std::exception& e) {
+    L_(error) << "exception in HeartbeatAgent: " << e.what();
+  }
+}
+
+void HeartbeatAgent::write_counters() {
+  for (const auto& peer : peers_) {
+    if (!peer.valid) {
+      continue;
+    }
+    // the counter is copied on injection, so it may change right away
+    ssize_t res = fi_inject_write(ep_, &counter_, sizeof(counter_), peer.addr,
+                                  peer.table_addr + index_ * sizeof(uint64_t),
+                                  peer.table_key);
+    if (res == -FI_EAGAIN) {
+      // retried with the next counter value
+      progress();
+    } else if (res != 0) {
+      L_(warning) << "fi_inject_write failed for heartbeat: " << res << "="
+                  << fi_strerror(-res);
+    }
+  }
+}
+
+void HeartbeatAgent::progress() {
+  struct fi_cq_entry entry;
+  ssize_t ne;
+  while ((ne = fi_cq_read(cq_, &entry, 1)) > 0) {
+  }
+  if (ne == -FI_EAVAIL) {
+    struct fi_cq_err_entry err;
+    memset(&err, 0, sizeof(err));
+    if (fi_cq_readerr(cq_, &err, 0) > 0) {
+      // a failed heartbeat write is not fatal; the remote side will notice
+      // the missing counter updates
+      L_(debug) << "heartbeat write failed: " << err.err << "="
+                << fi_strerror(err.err);
+    }
+  } else if (ne != -FI_EAGAIN) {
+    L_(fatal) << "fi_cq_read failed for heartbeat endpoint: " << ne << "="
+              << fi_strerror(-ne);
+    throw LibfabricException("fi_cq_read failed for heartbeat endpoint");
+  }
+}
+
+void HeartbeatAgent::scan_table() {
+  const volatile uint64_t* table = table_.data();
+  for (uint32_t i = 0; i < table_.size(); i++) {
+    uint64_t value = table[i];
+    if (value != last_seen_[i]) {
+      last_seen_[i] = value;
+      alive_[i].store(true, std::memory_order_release);
+    }
+  }
+}
+} // namespace tl_libfabric
@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#pragma once
+
+#include "HeartbeatEndpointInfo.hpp"
+
+#include <rdma/fabric.h>
+#include <rdma/fi_domain.h>
+#include <rdma/fi_endpoint.h>
+#include <rdma/fi_rma.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace tl_libfabric {
+/**
+ * Heartbeat agent that detects the liveness of remote processes independent
+ * of the data path.
+ *
+ * Each process registers a heartbeat table with one counter per peer. A
+ * dedicated thread periodically increments a local counter and writes it into
+ * the slot of this process in the table of every peer, using its own
+ * endpoint and completion queue. The same thread scans the local table and
+ * flags each peer whose counter has advanced since the last scan. The data
+ * path retrieves these flags with retrieve_alive_peers(), which only needs
+ * one atomic operation per peer.
+ *
+ * The agent requires a connectionless (RDM) provider.
+ */
+class HeartbeatAgent {
+public:
+  HeartbeatAgent(struct fid_domain* pd,
+                 struct fi_info* info,
+                 uint32_t index,
+                 uint32_t peer_count,
+                 std::chrono::microseconds interval);
+
+  HeartbeatAgent(const HeartbeatAgent&) = delete;
+  HeartbeatAgent& operator=(const HeartbeatAgent&) = delete;
+
+  ~HeartbeatAgent();
+
+  // Retrieve the endpoint description to be sent to the peers
+  const HeartbeatEndpointInfo& local_info() const { return local_info_; }
+
+  // Register the heartbeat endpoint of a peer (before start() is called)
+  void add_peer(uint32_t peer, const HeartbeatEndpointInfo& info);
+
+  // Start the heartbeat thread
+  void start();
+
+  // Stop the heartbeat thread
+  void stop();
+
+  // Retrieve the peers whose heartbeat counter advanced since the last call
+  std::vector<uint32_t> retrieve_alive_peers();
+
+private:
+  struct Peer {
+    bool valid = false;
+    fi_addr_t addr = FI_ADDR_UNSPEC;
+    uint64_t table_addr = 0;
+    uint64_t table_key = 0;
+  };
+
+  // The heartbeat thread main function
+  void run();
+
+  // Write the local counter to all peers
+  void write_counters();
+
+  // Read and discard completion events to drive the progress
+  void progress();
+
+  // Flag the peers whose counter advanced
+  void scan_table();
+
+  // Index of this process in the heartbeat tables of the peers
+  uint32_t index_;
+
+  std::chrono::microseconds interval_;
+
+  struct fid_ep* ep_ = nullptr;
+  struct fid_cq* cq_ = nullptr;
+  struct fid_av* av_ = nullptr;
+  struct fid_mr* mr_table_ = nullptr;
+
+  // Heartbeat counters written by the peers
+  std::vector<uint64_t> table_;
+
+  // Counter values seen during the last scan
+  std::vector<uint64_t> last_seen_;
+
+  // Peers whose counter advanced since the last retrieval
+  std::unique_ptr<std::atomic<bool>[]> alive_;
+
+  std::vector<Peer> peers_;
+
+  // The local heartbeat counter
+  uint64_t counter_ = 0;
+
+  HeartbeatEndpointInfo local_info_;
+
+  std::thread thread_;
+  std::atomic<bool> stop_{false};
+};
+} // namespace tl_libfabric
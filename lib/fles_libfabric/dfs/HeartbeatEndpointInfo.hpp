@@ -0,0 +1,23 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#pragma once
+
+#include <cstdint>
+
+#pragma pack(1)
+
+namespace tl_libfabric {
+/// Structure describing the heartbeat endpoint and table of a process. It is
+/// exchanged with the connect status messages.
+struct HeartbeatEndpointInfo {
+  // Whether a heartbeat endpoint is available
+  bool valid = false;
+  // Endpoint address of the heartbeat endpoint
+  unsigned char address[64] = {};
+  // Target address and key of the heartbeat table
+  uint64_t table_addr = 0;
+  uint64_t table_key = 0;
+};
+} // namespace tl_libfabric
+#pragma pack()
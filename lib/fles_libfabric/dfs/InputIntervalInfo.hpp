@@ -44,6 +44,7 @@ struct InputIntervalInfo {
     num_ts_per_round = (end_ts - start_ts + 1) / round_count;
     sum_compute_blockage_durations_.resize(compute_count, 0);
     sum_input_blockage_durations_.resize(compute_count, 0);
+    max_compute_buffer_occupancy_.resize(compute_count, 0);
   }
 
   uint64_t duration_per_ts = ConstVariables::ZERO;
@@ -53,6 +54,16 @@ struct InputIntervalInfo {
   std::vector<uint64_t> sum_compute_blockage_durations_;
 
   std::vector<uint64_t> sum_input_blockage_durations_;
+
+  // maximum observed compute buffer occupancy in percent
+  std::vector<uint64_t> max_compute_buffer_occupancy_;
+
+  // maximum observed input buffer fill level in percent
+  uint64_t max_input_buffer_fill_ = 0;
+
+  // content bytes and number of the microslices sent in the interval
+  uint64_t sent_data_bytes_ = 0;
+  uint64_t sent_microslices_ = 0;
 };
 } // namespace tl_libfabric
 
@@ -2,6 +2,7 @@
 
 #include "InputIntervalScheduler.hpp"
 
+#include <algorithm>
 #include <fstream>
 #include <iomanip>
 
@@ -42,6 +43,9 @@ void InputIntervalScheduler::update_input_begin_time(
 
 bool InputIntervalScheduler::add_proposed_meta_data(
     const IntervalMetaData meta_data) {
+  if (meta_data.timeslice_size != 0)
+    timeslice_sizes_.add(meta_data.interval_index, meta_data.timeslice_size);
+
   if (proposed_interval_meta_data_.contains(meta_data.interval_index))
     return false;
 
@@ -173,6 +177,26 @@ int64_t InputIntervalScheduler::get_next_fire_time() {
   return duration;
 }
 
+uint64_t InputIntervalScheduler::get_current_round_rotation() {
+  uint64_t interval = interval_info_.get_last_key();
+  if (interval_info_.get(interval)->num_ts_per_round == 0)
+    return interval;
+  return interval + get_interval_expected_round_index(interval);
+}
+
+uint64_t InputIntervalScheduler::get_current_round_duration() {
+  uint64_t interval = interval_info_.get_last_key();
+  InputIntervalInfo* current_interval = interval_info_.get(interval);
+  // Same conditions as in get_next_fire_time() to send as fast as possible
+  if (current_interval->duration_per_ts == 0 ||
+      (!is_ack_percentage_reached(interval) &&
+       (current_interval->proposed_start_time +
+        std::chrono::microseconds(current_interval->proposed_duration)) <
+           std::chrono::high_resolution_clock::now()))
+    return ConstVariables::ZERO;
+  return current_interval->duration_per_round;
+}
+
 uint32_t InputIntervalScheduler::get_compute_connection_count() {
   return compute_count_;
 }
@@ -204,6 +228,10 @@ InputIntervalScheduler::InputIntervalScheduler(uint32_t scheduler_index,
       interval_length_(interval_length), log_directory_(log_directory),
       enable_logging_(enable_logging) {
   minimum_ack_percentage_to_start_new_interval_ = 0.95;
+  if (enable_logging_)
+    interval_log_ = std::make_unique<SchedulerRecordLog<IntervalDataLog>>(
+        log_directory_ + "/" + std::to_string(scheduler_index_) +
+        ".input.proposed_actual_interval_info.bin");
 }
 
 void InputIntervalScheduler::create_new_interval_info(uint64_t interval_index) {
@@ -282,6 +310,12 @@ void InputIntervalScheduler::create_actual_interval_meta_data(
       interval_info->index, interval_info->round_count, interval_info->start_ts,
       interval_info->end_ts, interval_info->actual_start_time,
       interval_info->actual_duration, get_compute_connection_count());
+  fill_compute_buffer_pressure(interval_info, actual_metadata);
+  actual_metadata->input_buffer_fill = static_cast<uint8_t>(std::min<uint64_t>(
+      interval_info->max_input_buffer_fill_, ConstVariables::ONE_HUNDRED));
+  if (interval_info->sent_microslices_ != 0)
+    actual_metadata->microslice_size = static_cast<uint32_t>(
+        interval_info->sent_data_bytes_ / interval_info->sent_microslices_);
   if (true) {
     L_(info) << "[i " << scheduler_index_ << "] "
              << "interval" << actual_metadata->interval_index << "[TSs "
@@ -297,6 +331,45 @@ void InputIntervalScheduler::create_actual_interval_meta_data(
              << interval_info->rounds_counter << " rounds";
   }
   actual_interval_meta_data_.add(interval_info->index, actual_metadata);
+
+  // LOGGING
+  if (interval_log_) {
+    IntervalDataLog interval_log;
+    interval_log.interval_index = interval_info->index;
+    if (proposed_interval_meta_data_.contains(interval_info->index)) {
+      const IntervalMetaData* proposed_metadata =
+          proposed_interval_meta_data_.get(interval_info->index);
+      interval_log.proposed_time =
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              proposed_metadata->start_time - begin_time_)
+              .count();
+      interval_log.proposed_duration = proposed_metadata->interval_duration;
+    }
+    interval_log.actual_time =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            actual_metadata->start_time - begin_time_)
+            .count();
+    interval_log.actual_duration = actual_metadata->interval_duration;
+    interval_log_->append(interval_log);
+  }
+}
+
+void InputIntervalScheduler::fill_compute_buffer_pressure(
+    const InputIntervalInfo* interval_info, IntervalMetaData* meta_data) {
+  uint32_t count =
+      std::min<uint32_t>(interval_info->max_compute_buffer_occupancy_.size(),
+                         ConstVariables::MAX_COMPUTE_NODE_COUNT);
+  for (uint32_t i = 0; i < count; ++i) {
+    uint64_t pressure = interval_info->max_compute_buffer_occupancy_[i];
+    if (interval_info->actual_duration > 0) {
+      pressure = std::max<uint64_t>(
+          pressure, interval_info->sum_compute_blockage_durations_[i] *
+                        ConstVariables::ONE_HUNDRED /
+                        interval_info->actual_duration);
+    }
+    meta_data->placement_info[i] = static_cast<uint8_t>(
+        std::min<uint64_t>(pressure, ConstVariables::ONE_HUNDRED));
+  }
 }
 
 uint64_t InputIntervalScheduler::get_expected_sent_ts_count(uint64_t interval) {
@@ -403,48 +476,73 @@ void InputIntervalScheduler::add_input_buffer_blockage_duration(
   current_interval->sum_input_blockage_durations_[compute_index] += duration;
 }
 
+void InputIntervalScheduler::update_compute_buffer_occupancy(
+    uint32_t compute_index, uint64_t occupancy) {
+  if (interval_info_.empty())
+    return;
+  InputIntervalInfo* current_interval =
+      interval_info_.get(interval_info_.get_last_key());
+  if (compute_index < current_interval->max_compute_buffer_occupancy_.size() &&
+      current_interval->max_compute_buffer_occupancy_[compute_index] <
+          occupancy)
+    current_interval->max_compute_buffer_occupancy_[compute_index] = occupancy;
+}
+
+void InputIntervalScheduler::update_input_buffer_fill(uint64_t fill) {
+  if (interval_info_.empty())
+    return;
+  InputIntervalInfo* current_interval =
+      interval_info_.get(interval_info_.get_last_key());
+  if (current_interval->max_input_buffer_fill_ < fill)
+    current_interval->max_input_buffer_fill_ = fill;
+}
+
+void InputIntervalScheduler::add_sent_volume(uint64_t timeslice,
+                                             uint64_t data_bytes,
+                                             uint64_t microslices) {
+  InputIntervalInfo* interval = get_interval_of_timeslice(timeslice);
+  if (interval == nullptr)
+    return;
+  interval->sent_data_bytes_ += data_bytes;
+  interval->sent_microslices_ += microslices;
+}
+
+uint32_t InputIntervalScheduler::get_timeslice_size(uint64_t interval_index) {
+  return timeslice_sizes_.contains(interval_index)
+             ? timeslice_sizes_.get(interval_index)
+             : 0;
+}
+
 void InputIntervalScheduler::generate_log_files() {
-  if (!enable_logging_)
+  if (!interval_log_)
     return;
 
+  interval_log_->close();
+
   std::ofstream log_file;
   log_file.open(log_directory_ + "/" + std::to_string(scheduler_index_) +
                 ".input.proposed_actual_interval_info.out");
-
-  log_file << std::setw(25) << "Interval" << std::setw(25) << "proposed time"
-           << std::setw(25) << "Actual time" << std::setw(25)
-           << "Proposed duration" << std::setw(25) << "Actual duration"
-           << "\n";
-
-  SizedMap<uint64_t, IntervalMetaData*>::iterator it_actual =
-      actual_interval_meta_data_.get_begin_iterator();
-  IntervalMetaData* proposed_metadata = nullptr;
-  uint64_t proposed_time, actual_time;
-  while (it_actual != actual_interval_meta_data_.get_end_iterator()) {
-    proposed_metadata = proposed_interval_meta_data_.contains(it_actual->first)
-                            ? proposed_interval_meta_data_.get(it_actual->first)
-                            : nullptr;
-    proposed_time = proposed_metadata == nullptr
-                        ? 0
-                        : std::chrono::duration_cast<std::chrono::milliseconds>(
-                              proposed_metadata->start_time - begin_time_)
-                              .count();
-    actual_time = std::chrono::duration_cast<std::chrono::milliseconds>(
-                      it_actual->second->start_time - begin_time_)
-                      .count();
-    log_file << std::setw(25) << it_actual->first << std::setw(25)
-             << proposed_time << std::setw(25) << actual_time << std::setw(25)
-             << (proposed_metadata == nullptr
-                     ? 0
-                     : proposed_metadata->interval_duration)
-             << std::setw(25) << it_actual->second->interval_duration << "\n";
-
-    it_actual++;
-  }
+  convert_interval_log(interval_log_->path(), log_file);
   log_file.flush();
   log_file.close();
 }
 
+void InputIntervalScheduler::convert_interval_log(const std::string& log_path,
+                                                  std::ostream& out) {
+  out << std::setw(25) << "Interval" << std::setw(25) << "proposed time"
+      << std::setw(25) << "Actual time" << std::setw(25) << "Proposed duration"
+      << std::setw(25) << "Actual duration"
+      << "\n";
+
+  SchedulerRecordLog<IntervalDataLog>::for_each(
+      log_path, [&out](const IntervalDataLog& entry) {
+        out << std::setw(25) << entry.interval_index << std::setw(25)
+            << entry.proposed_time << std::setw(25) << entry.actual_time
+            << std::setw(25) << entry.proposed_duration << std::setw(25)
+            << entry.actual_duration << "\n";
+      });
+}
+
 InputIntervalScheduler* InputIntervalScheduler::instance_ = nullptr;
 
 } // namespace tl_libfabric
@@ -5,6 +5,7 @@
 #include "ConstVariables.hpp"
 #include "InputIntervalInfo.hpp"
 #include "IntervalMetaData.hpp"
+#include "SchedulerRecordLog.hpp"
 #include "SizedMap.hpp"
 
 #include <cassert>
@@ -14,6 +15,8 @@
 #include <log.hpp>
 #include <map>
 #include <math.h>
+#include <memory>
+#include <ostream>
 #include <set>
 #include <string>
 #include <vector>
@@ -64,6 +67,14 @@ public:
   // Get the time to start sending more timeslices
   int64_t get_next_fire_time();
 
+  // Get the rotation of the compute node order in the current round, which
+  // changes with every interval and round
+  uint64_t get_current_round_rotation();
+
+  // Get the proposed duration of a round of the current interval, or zero if
+  // the timeslices are to be sent as fast as possible
+  uint64_t get_current_round_duration();
+
   // Get the number of current compute node connections
   uint32_t get_compute_connection_count();
 
@@ -80,13 +91,45 @@ public:
                                           uint64_t timeslice,
                                           uint64_t duration);
 
+  // update the observed compute buffer occupancy (in percent) of a compute
+  // node in the current interval
+  void update_compute_buffer_occupancy(uint32_t compute_index,
+                                       uint64_t occupancy);
+
+  // update the observed input buffer fill level (in percent) in the current
+  // interval
+  void update_input_buffer_fill(uint64_t fill);
+
+  // add the content bytes and number of the microslices of a sent timeslice
+  void add_sent_volume(uint64_t timeslice,
+                       uint64_t data_bytes,
+                       uint64_t microslices);
+
+  // Get the adaptive timeslice size of the timeslices from interval_index *
+  // interval length on, or zero if not proposed yet
+  uint32_t get_timeslice_size(uint64_t interval_index);
+
   // Get the intervalinfo
   InputIntervalInfo get_current_interval_info();
 
   // Generate log files of the stored data
   void generate_log_files();
 
+  // Convert a binary interval log to the text format of the log file
+  static void convert_interval_log(const std::string& log_path,
+                                   std::ostream& out);
+
 private:
+  // Fixed-size record of the interval log, written once the actual interval
+  // meta-data is created
+  struct IntervalDataLog {
+    uint64_t interval_index = 0;
+    uint64_t proposed_time = 0;
+    uint64_t actual_time = 0;
+    uint64_t proposed_duration = 0;
+    uint64_t actual_duration = 0;
+  };
+
   struct TimesliceInfo {
     std::chrono::high_resolution_clock::time_point expected_time;
     std::chrono::high_resolution_clock::time_point transmit_time;
@@ -110,6 +153,10 @@ private:
   // compute schedulers
   void create_actual_interval_meta_data(InputIntervalInfo*);
 
+  // Fill the per compute node buffer pressure of an interval in percent
+  void fill_compute_buffer_pressure(const InputIntervalInfo*,
+                                    IntervalMetaData*);
+
   // Get the expected number of sent timeslices so far of a particular
   // interval
   uint64_t get_expected_sent_ts_count(uint64_t);
@@ -146,6 +193,9 @@ private:
   // Actual interval meta-data
   SizedMap<uint64_t, IntervalMetaData*> actual_interval_meta_data_;
 
+  // Proposed adaptive timeslice sizes
+  SizedMap<uint64_t, uint32_t> timeslice_sizes_;
+
   // Input Scheduler index
   uint32_t scheduler_index_;
 
@@ -164,6 +214,9 @@ private:
   // Check whether to generate log files
   bool enable_logging_;
 
+  // The streaming log of the interval records
+  std::unique_ptr<SchedulerRecordLog<IntervalDataLog>> interval_log_;
+
   double minimum_ack_percentage_to_start_new_interval_;
 };
 } // namespace tl_libfabric
@@ -17,6 +17,7 @@ void InputSchedulerOrchestrator::initialize(uint32_t scheduler_index,
                                             uint64_t desc_length,
                                             uint64_t start_index_desc,
                                             uint64_t timeslice_size,
+                                            bool bandwidth_aware_placement,
                                             std::string log_directory,
                                             bool enable_logging) {
   interval_scheduler_ = InputIntervalScheduler::get_instance(
@@ -24,8 +25,8 @@ void InputSchedulerOrchestrator::initialize(uint32_t scheduler_index,
       enable_logging);
   timeslice_manager_ = InputTimesliceManager::get_instance(
       scheduler_index, compute_conn_count, interval_length, data_source_desc,
-      desc_length, start_index_desc, timeslice_size, log_directory,
-      enable_logging);
+      desc_length, start_index_desc, timeslice_size, bandwidth_aware_placement,
+      log_directory, enable_logging);
   heartbeat_manager_ = InputHeartbeatManager::get_instance(
       scheduler_index, compute_conn_count, init_heartbeat_timeout,
       timeout_history_size, timeout_factor, inactive_factor,
@@ -57,7 +58,9 @@ void InputSchedulerOrchestrator::generate_log_files() {
 //// InputIntervalScheduler Methods
 void InputSchedulerOrchestrator::add_proposed_meta_data(
     const IntervalMetaData meta_data) {
-  interval_scheduler_->add_proposed_meta_data(meta_data);
+  if (interval_scheduler_->add_proposed_meta_data(meta_data)) {
+    timeslice_manager_->add_placement_plan(meta_data);
+  }
 }
 
 const IntervalMetaData*
@@ -69,10 +72,39 @@ uint64_t InputSchedulerOrchestrator::get_last_timeslice_to_send() {
   return interval_scheduler_->get_last_timeslice_to_send();
 }
 
+void InputSchedulerOrchestrator::update_compute_buffer_occupancy(
+    uint32_t compute_index, uint64_t occupancy) {
+  interval_scheduler_->update_compute_buffer_occupancy(compute_index,
+                                                       occupancy);
+}
+
+void InputSchedulerOrchestrator::update_input_buffer_fill(uint64_t fill) {
+  interval_scheduler_->update_input_buffer_fill(fill);
+}
+
+void InputSchedulerOrchestrator::add_sent_volume(uint64_t timeslice,
+                                                 uint64_t data_bytes,
+                                                 uint64_t microslices) {
+  interval_scheduler_->add_sent_volume(timeslice, data_bytes, microslices);
+}
+
+uint32_t
+InputSchedulerOrchestrator::get_timeslice_size(uint64_t interval_index) {
+  return interval_scheduler_->get_timeslice_size(interval_index);
+}
+
 int64_t InputSchedulerOrchestrator::get_next_fire_time() {
   return interval_scheduler_->get_next_fire_time();
 }
 
+uint64_t InputSchedulerOrchestrator::get_current_round_rotation() {
+  return interval_scheduler_->get_current_round_rotation();
+}
+
+uint64_t InputSchedulerOrchestrator::get_current_round_duration() {
+  return interval_scheduler_->get_current_round_duration();
+}
+
 //// InputTimesliceManager Methods
 
 uint64_t InputSchedulerOrchestrator::get_connection_next_timeslice(
@@ -91,6 +123,39 @@ uint64_t InputSchedulerOrchestrator::get_connection_next_timeslice(
   return next;
 }
 
+void InputSchedulerOrchestrator::set_compute_standby(uint32_t compute_index) {
+  timeslice_manager_->set_compute_standby(compute_index);
+}
+
+bool InputSchedulerOrchestrator::admit_compute_node(uint32_t compute_index,
+                                                    uint64_t timeslice) {
+  return timeslice_manager_->admit_compute_node(compute_index, timeslice);
+}
+
+uint64_t InputSchedulerOrchestrator::get_next_unplaced_timeslice() {
+  return timeslice_manager_->get_next_unplaced_timeslice();
+}
+
+void InputSchedulerOrchestrator::set_load_shedding(
+    std::vector<std::pair<uint32_t, uint32_t>> levels,
+    uint32_t priority_interval) {
+  timeslice_manager_->set_load_shedding(std::move(levels), priority_interval);
+}
+
+uint64_t InputSchedulerOrchestrator::get_next_shed_timeslice() {
+  return timeslice_manager_->get_next_shed_timeslice();
+}
+
+void InputSchedulerOrchestrator::mark_timeslice_shed(uint64_t timeslice) {
+  timeslice_manager_->mark_timeslice_shed(timeslice);
+  interval_scheduler_->increament_sent_timeslices(timeslice);
+  interval_scheduler_->increament_acked_timeslices(timeslice);
+}
+
+uint64_t InputSchedulerOrchestrator::get_shed_timeslices() {
+  return timeslice_manager_->get_shed_timeslices();
+}
+
 void InputSchedulerOrchestrator::mark_timeslice_transmitted(
     uint32_t compute_index, uint64_t timeslice, uint64_t size) {
   interval_scheduler_->increament_sent_timeslices(timeslice);
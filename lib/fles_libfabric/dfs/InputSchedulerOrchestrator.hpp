@@ -34,6 +34,7 @@ public:
                          uint64_t desc_length,
                          uint64_t start_index_desc,
                          uint64_t timeslice_size,
+                         bool bandwidth_aware_placement,
                          std::string log_directory,
                          bool enable_logging);
 
@@ -62,15 +63,62 @@ public:
   // Get last timeslice to be sent
   static std::uint64_t get_last_timeslice_to_send();
 
+  // Update the observed compute buffer occupancy (in percent) of a compute
+  // node
+  static void update_compute_buffer_occupancy(std::uint32_t compute_index,
+                                              std::uint64_t occupancy);
+
+  // Update the observed input buffer fill level (in percent)
+  static void update_input_buffer_fill(std::uint64_t fill);
+
+  // Add the content bytes and number of the microslices of a sent timeslice
+  static void add_sent_volume(std::uint64_t timeslice,
+                              std::uint64_t data_bytes,
+                              std::uint64_t microslices);
+
+  // Get the adaptive timeslice size of the timeslices from interval_index *
+  // interval length on, or zero if not proposed yet
+  static std::uint32_t get_timeslice_size(std::uint64_t interval_index);
+
   // Get the time to start sending more timeslices
   static int64_t get_next_fire_time();
 
+  // Get the rotation of the compute node order in the current round
+  static std::uint64_t get_current_round_rotation();
+
+  // Get the proposed duration of a round of the current interval (us)
+  static std::uint64_t get_current_round_duration();
+
   //// InputTimesliceManager Methods
 
   // Get the timeslice to be sent to specific compute index
   static std::uint64_t
   get_connection_next_timeslice(std::uint32_t compute_index);
 
+  // Exclude a standby compute node from the placement until it joins
+  static void set_compute_standby(std::uint32_t compute_index);
+
+  // Admit a joining compute node from a timeslice on
+  static bool admit_compute_node(std::uint32_t compute_index,
+                                 std::uint64_t timeslice);
+
+  // Get the first timeslice that is not yet placed on a compute node
+  static std::uint64_t get_next_unplaced_timeslice();
+
+  // Enable shedding of whole timeslices under input buffer pressure
+  static void
+  set_load_shedding(std::vector<std::pair<std::uint32_t, std::uint32_t>> levels,
+                    std::uint32_t priority_interval);
+
+  // Get the next shed timeslice to be accounted for (MINUS_ONE if none)
+  static std::uint64_t get_next_shed_timeslice();
+
+  // Account for a shed timeslice as transmitted and acknowledged
+  static void mark_timeslice_shed(std::uint64_t timeslice);
+
+  // Get the # of shed timeslices
+  static std::uint64_t get_shed_timeslices();
+
   // Log the transmission time of a timeslice
   static void mark_timeslice_transmitted(std::uint32_t compute_index,
                                          std::uint64_t timeslice,
@@ -2,6 +2,8 @@
 
 #include "InputTimesliceManager.hpp"
 
+#include <algorithm>
+
 // TO BE REMOVED
 #include <fstream>
 #include <iomanip>
@@ -15,6 +17,7 @@ InputTimesliceManager::InputTimesliceManager(uint32_t scheduler_index,
                                              uint64_t desc_length,
                                              uint64_t start_index_desc,
                                              uint64_t timeslice_size,
+                                             bool bandwidth_aware_placement,
                                              std::string log_directory,
                                              bool enable_logging)
     : compute_count_(compute_conn_count),
@@ -22,10 +25,12 @@ InputTimesliceManager::InputTimesliceManager(uint32_t scheduler_index,
       scheduler_index_(scheduler_index), interval_length_(interval_length),
       data_source_desc_(data_source_desc), desc_length_(desc_length),
       start_index_desc_(start_index_desc), timeslice_size_(timeslice_size),
-      log_directory_(log_directory), enable_logging_(enable_logging) {
+      log_directory_(log_directory), enable_logging_(enable_logging),
+      bandwidth_aware_placement_(bandwidth_aware_placement) {
 
   last_conn_desc_.resize(compute_count_, 0);
   last_conn_timeslice_.resize(compute_count_, ConstVariables::MINUS_ONE);
+  admission_timeslice_.resize(compute_count_, ConstVariables::ZERO);
   virtual_physical_compute_mapping_.resize(compute_count_);
   for (uint32_t i = 0; i < compute_count_; ++i) {
     conn_timeslice_info_.add(i, new SizedMap<uint64_t, TimesliceInfo*>());
@@ -33,22 +38,220 @@ InputTimesliceManager::InputTimesliceManager(uint32_t scheduler_index,
     future_conn_timeslices_.add(i, new std::set<uint64_t>());
     virtual_physical_compute_mapping_[i] = i;
   }
+  if (bandwidth_aware_placement_) {
+    // The first two intervals are distributed round-robin
+    uint64_t round_count =
+        std::max<uint64_t>(interval_length_ / compute_count_, 1);
+    apply_placement_plan(2 * round_count * compute_count_ - 1,
+                         std::vector<uint8_t>(
+                             compute_count_,
+                             ConstVariables::PLACEMENT_MAX_WEIGHT));
+  }
   refill_future_timeslices(interval_length_);
+  if (auto* monitor = cbm::Monitor::Ptr()) {
+    cbm::MetricTagSet tags{
+        {"host", monitor->HostName()},
+        {"input_index", std::to_string(scheduler_index_)}};
+    rdma_ack_time_metric_ = monitor->RegisterHistogram(
+        "input_timeslice_manager", tags, "rdma_ack_us");
+    completion_time_metric_ = monitor->RegisterHistogram(
+        "input_timeslice_manager", tags, "completion_us");
+  }
+}
+
+void InputTimesliceManager::apply_placement_plan(
+    uint64_t last_timeslice,
+    const std::vector<uint8_t>& weights,
+    uint32_t keep_percentage) {
+  if (last_timeslice < placement_horizon_)
+    return;
+  if (!shedding_levels_.empty()) {
+    keep_percentages_[placement_horizon_] = keep_percentage;
+    if (keep_percentage < ConstVariables::ONE_HUNDRED) {
+      L_(info) << "[i_" << scheduler_index_ << "] shedding timeslices "
+               << placement_horizon_ << " to " << last_timeslice
+               << ", keeping " << keep_percentage << "%";
+    }
+  }
+  // Interleave the compute nodes according to their weights
+  std::vector<uint32_t> slots;
+  for (uint32_t round = 0; round < ConstVariables::PLACEMENT_MAX_WEIGHT;
+       ++round) {
+    for (uint32_t i = 0; i < compute_count_; ++i) {
+      if (weights[i] > round)
+        slots.push_back(i);
+    }
+  }
+  if (slots.empty()) {
+    for (uint32_t i = 0; i < compute_count_; ++i)
+      slots.push_back(i);
+  }
+  L_(debug) << "[i_" << scheduler_index_ << "] placement of timeslices "
+            << placement_horizon_ << " to " << last_timeslice << " in "
+            << slots.size() << " slots";
+  placement_slots_[placement_horizon_] = std::move(slots);
+  placement_horizon_ = last_timeslice + 1;
+}
+
+uint32_t InputTimesliceManager::get_planned_compute_index(uint64_t timeslice) {
+  auto it = placement_slots_.upper_bound(timeslice);
+  assert(it != placement_slots_.begin());
+  const std::vector<uint32_t>& slots = (--it)->second;
+  uint64_t slot = timeslice % slots.size();
+  while (redistribution_decisions_log_.contains(slots[slot]) ||
+         !is_admitted(slots[slot], timeslice))
+    slot = (slot + 1) % slots.size();
+  return slots[slot];
 }
 
 void InputTimesliceManager::refill_future_timeslices(uint64_t up_to_timeslice) {
+  if (bandwidth_aware_placement_ || !shedding_levels_.empty()) {
+    // Timeslices beyond the known placement plans are not assigned yet
+    up_to_timeslice = std::min(up_to_timeslice, placement_horizon_);
+  }
   if (next_start_future_timeslice_ >= up_to_timeslice)
     return;
+  if (bandwidth_aware_placement_) {
+    for (uint64_t ts = next_start_future_timeslice_; ts < up_to_timeslice;
+         ++ts) {
+      if (is_timeslice_shed(ts)) {
+        if (ts >= shed_horizon_)
+          pending_shed_timeslices_.push_back(ts);
+        continue;
+      }
+      future_conn_timeslices_.get(get_planned_compute_index(ts))->insert(ts);
+    }
+    next_start_future_timeslice_ = up_to_timeslice;
+    shed_horizon_ = std::max(shed_horizon_, up_to_timeslice);
+    return;
+  }
   uint32_t comp_index = next_start_future_timeslice_ % virtual_compute_count_;
   for (uint64_t ts = next_start_future_timeslice_; ts < up_to_timeslice; ++ts) {
+    if (is_timeslice_shed(ts)) {
+      if (ts >= shed_horizon_)
+        pending_shed_timeslices_.push_back(ts);
+      continue;
+    }
     while (redistribution_decisions_log_.contains(
-        virtual_physical_compute_mapping_[comp_index]))
+               virtual_physical_compute_mapping_[comp_index]) ||
+           !is_admitted(virtual_physical_compute_mapping_[comp_index], ts))
       comp_index = (comp_index + 1) % virtual_compute_count_;
     future_conn_timeslices_.get(virtual_physical_compute_mapping_[comp_index])
         ->insert(ts);
     comp_index = (comp_index + 1) % virtual_compute_count_;
   }
   next_start_future_timeslice_ = up_to_timeslice;
+  shed_horizon_ = std::max(shed_horizon_, up_to_timeslice);
+}
+
+uint32_t
+InputTimesliceManager::get_keep_percentage(uint32_t input_buffer_fill) const {
+  uint32_t keep_percentage = ConstVariables::ONE_HUNDRED;
+  for (const auto& [fill, keep] : shedding_levels_) {
+    if (input_buffer_fill >= fill)
+      keep_percentage = keep;
+  }
+  return keep_percentage;
+}
+
+bool InputTimesliceManager::is_timeslice_shed(uint64_t timeslice) const {
+  if (shedding_levels_.empty())
+    return false;
+  // Priority timeslices are never shed
+  if (shedding_priority_interval_ != 0 &&
+      timeslice % shedding_priority_interval_ == 0)
+    return false;
+  auto it = keep_percentages_.upper_bound(timeslice);
+  if (it == keep_percentages_.begin())
+    return false;
+  uint64_t keep = (--it)->second;
+  // Spread the kept timeslices evenly; the decision depends on the timeslice
+  // number only, so that all input nodes shed the same timeslices
+  return (timeslice + 1) * keep / ConstVariables::ONE_HUNDRED ==
+         timeslice * keep / ConstVariables::ONE_HUNDRED;
+}
+
+bool InputTimesliceManager::is_admitted(uint32_t compute_index,
+                                        uint64_t timeslice) const {
+  return admission_timeslice_[compute_index] != ConstVariables::MINUS_ONE &&
+         admission_timeslice_[compute_index] <= timeslice;
+}
+
+void InputTimesliceManager::replan_future_timeslices(uint64_t from_timeslice) {
+  if (next_start_future_timeslice_ <= from_timeslice)
+    return;
+  uint64_t up_to_timeslice = next_start_future_timeslice_;
+  for (uint32_t i = 0; i < compute_count_; ++i) {
+    std::set<uint64_t>* future = future_conn_timeslices_.get(i);
+    future->erase(future->lower_bound(from_timeslice), future->end());
+  }
+  next_start_future_timeslice_ = from_timeslice;
+  refill_future_timeslices(up_to_timeslice);
+}
+
+void InputTimesliceManager::set_compute_standby(uint32_t compute_index) {
+  assert(sent_timeslices_ == 0);
+  admission_timeslice_[compute_index] = ConstVariables::MINUS_ONE;
+  replan_future_timeslices(ConstVariables::ZERO);
+}
+
+bool InputTimesliceManager::admit_compute_node(uint32_t compute_index,
+                                               uint64_t timeslice) {
+  if (is_admitted(compute_index, timeslice))
+    return true;
+  // The placement from the admission on may only change as long as none of
+  // these timeslices is transmitted
+  for (uint32_t i = 0; i < compute_count_; ++i) {
+    if (last_conn_timeslice_[i] != ConstVariables::MINUS_ONE &&
+        last_conn_timeslice_[i] >= timeslice) {
+      L_(error) << "[i_" << scheduler_index_ << "] cannot admit compute node "
+                << compute_index << " at timeslice " << timeslice
+                << ", timeslice " << last_conn_timeslice_[i]
+                << " is already transmitted";
+      return false;
+    }
+  }
+  admission_timeslice_[compute_index] = timeslice;
+  replan_future_timeslices(timeslice);
+  L_(info) << "[i_" << scheduler_index_ << "] compute node " << compute_index
+           << " admitted at timeslice " << timeslice;
+  return true;
+}
+
+uint64_t InputTimesliceManager::get_next_unplaced_timeslice() {
+  return next_start_future_timeslice_;
+}
+
+void InputTimesliceManager::set_load_shedding(
+    std::vector<std::pair<uint32_t, uint32_t>> levels,
+    uint32_t priority_interval) {
+  assert(sent_timeslices_ == 0);
+  shedding_levels_ = std::move(levels);
+  std::sort(shedding_levels_.begin(), shedding_levels_.end());
+  shedding_priority_interval_ = priority_interval;
+  if (shedding_levels_.empty() || bandwidth_aware_placement_)
+    return;
+  // The timeslices are placed only up to the placement horizon, the first two
+  // intervals are never shed
+  uint64_t round_count =
+      std::max<uint64_t>(interval_length_ / compute_count_, 1);
+  apply_placement_plan(
+      2 * round_count * compute_count_ - 1,
+      std::vector<uint8_t>(compute_count_,
+                           ConstVariables::PLACEMENT_MAX_WEIGHT));
+}
+
+uint64_t InputTimesliceManager::get_next_shed_timeslice() {
+  return pending_shed_timeslices_.empty() ? ConstVariables::MINUS_ONE
+                                          : pending_shed_timeslices_.front();
+}
+
+void InputTimesliceManager::mark_timeslice_shed(uint64_t timeslice) {
+  assert(!pending_shed_timeslices_.empty() &&
+         pending_shed_timeslices_.front() == timeslice);
+  pending_shed_timeslices_.pop_front();
+  ++sent_timeslices_;
+  ++shed_timeslices_;
 }
 
 void InputTimesliceManager::check_to_add_rescheduled_timeslices(
@@ -158,13 +361,14 @@ InputTimesliceManager::get_instance(uint32_t scheduler_index,
                                     uint64_t desc_length,
                                     uint64_t start_index_desc,
                                     uint64_t timeslice_size,
+                                    bool bandwidth_aware_placement,
                                     std::string log_directory,
                                     bool enable_logging) {
   if (instance_ == nullptr) {
     instance_ = new InputTimesliceManager(
         scheduler_index, compute_conn_count, interval_length, data_source_desc,
-        desc_length, start_index_desc, timeslice_size, log_directory,
-        enable_logging);
+        desc_length, start_index_desc, timeslice_size,
+        bandwidth_aware_placement, log_directory, enable_logging);
   }
   return instance_;
 }
@@ -182,12 +386,45 @@ InputTimesliceManager::get_connection_next_timeslice(uint32_t compute_index) {
                 compute_index) == virtual_physical_compute_mapping_.end()) {
     return ConstVariables::MINUS_ONE;
   }
+  if (future_conn_timeslices_.get(compute_index)->empty() &&
+      !is_admitted(compute_index, next_start_future_timeslice_)) {
+    // not yet joined, or admitted from a later timeslice on
+    return ConstVariables::MINUS_ONE;
+  }
   if (future_conn_timeslices_.get(compute_index)->empty()) {
     refill_future_timeslices(next_start_future_timeslice_ + interval_length_);
   }
+  if (future_conn_timeslices_.get(compute_index)->empty()) {
+    // waiting for the placement plan of the next interval
+    return ConstVariables::MINUS_ONE;
+  }
   return (*future_conn_timeslices_.get(compute_index)->begin());
 }
 
+void InputTimesliceManager::add_placement_plan(
+    const IntervalMetaData& meta_data) {
+  if ((!bandwidth_aware_placement_ && shedding_levels_.empty()) ||
+      meta_data.interval_index < next_placement_interval_)
+    return;
+  std::vector<uint8_t> weights(
+      meta_data.placement_info,
+      meta_data.placement_info +
+          std::min<uint32_t>(compute_count_,
+                             ConstVariables::MAX_COMPUTE_NODE_COUNT));
+  weights.resize(compute_count_, ConstVariables::PLACEMENT_MAX_WEIGHT);
+  pending_placement_plans_[meta_data.interval_index] = PlacementPlan{
+      meta_data.last_timeslice, std::move(weights),
+      get_keep_percentage(meta_data.input_buffer_fill)};
+  // Plans are applied in interval order to cover consecutive timeslices
+  auto it = pending_placement_plans_.find(next_placement_interval_);
+  while (it != pending_placement_plans_.end()) {
+    apply_placement_plan(it->second.last_timeslice, it->second.weights,
+                         it->second.keep_percentage);
+    pending_placement_plans_.erase(it);
+    it = pending_placement_plans_.find(++next_placement_interval_);
+  }
+}
+
 void InputTimesliceManager::log_timeslice_transmit_time(uint32_t compute_index,
                                                         uint64_t timeslice,
                                                         uint64_t size) {
@@ -236,6 +473,7 @@ bool InputTimesliceManager::acknowledge_timeslice_rdma_write(
           std::chrono::high_resolution_clock::now() -
           timeslice_info->transmit_time)
           .count();
+  rdma_ack_time_metric_.Record(timeslice_info->rdma_acked_duration);
   timeslice_info = nullptr;
   return true;
 }
@@ -262,6 +500,7 @@ double InputTimesliceManager::acknowledge_timeslices_completion(
             std::chrono::high_resolution_clock::now() -
             timeslice_info->transmit_time)
             .count();
+    completion_time_metric_.Record(timeslice_info->completion_acked_duration);
 
     // Calculate the latency
     sum_latency += timeslice_info->completion_acked_duration -
@@ -4,17 +4,21 @@
 
 #include "ConstVariables.hpp"
 #include "HeartbeatFailedNodeInfo.hpp"
+#include "IntervalMetaData.hpp"
+#include "Monitor.hpp"
 #include "SizedMap.hpp"
 
 #include <cassert>
 #include <chrono>
 #include <cstdint>
+#include <deque>
 #include <iostream>
 #include <log.hpp>
 #include <map>
 #include <math.h>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace tl_libfabric {
@@ -32,6 +36,7 @@ public:
                                              uint64_t desc_length,
                                              uint64_t start_index_desc,
                                              uint64_t timeslice_size,
+                                             bool bandwidth_aware_placement,
                                              std::string log_directory,
                                              bool enable_logging);
 
@@ -41,6 +46,37 @@ public:
   // Get the next timeslice to be trasmitted to specific compute node
   uint64_t get_connection_next_timeslice(uint32_t compute_index);
 
+  // Consider the placement weights and the input buffer fill level of a
+  // proposed interval (bandwidth-aware placement or load shedding only)
+  void add_placement_plan(const IntervalMetaData& meta_data);
+
+  // Enable shedding of whole timeslices. A level <fill, keep> keeps keep
+  // percent of the timeslices of an interval if the proposed input buffer
+  // fill level reaches fill percent. Every priority_interval-th timeslice is
+  // never shed (0 for none).
+  void set_load_shedding(std::vector<std::pair<uint32_t, uint32_t>> levels,
+                         uint32_t priority_interval);
+
+  // Get the next shed timeslice that is still to be accounted for
+  // (MINUS_ONE if none)
+  uint64_t get_next_shed_timeslice();
+
+  // Account for a shed timeslice as if it had been transmitted
+  void mark_timeslice_shed(uint64_t timeslice);
+
+  // Get the # of shed timeslices
+  uint64_t get_shed_timeslices() { return shed_timeslices_; }
+
+  // Exclude a standby compute node from the placement until it is admitted
+  void set_compute_standby(uint32_t compute_index);
+
+  // Admit a compute node to the placement from a timeslice on (returns false
+  // if timeslices from there on have already been transmitted)
+  bool admit_compute_node(uint32_t compute_index, uint64_t timeslice);
+
+  // Get the first timeslice that is not yet placed on a compute node
+  uint64_t get_next_unplaced_timeslice();
+
   // Log the transmission time of a timeslice
   void log_timeslice_transmit_time(uint32_t compute_index,
                                    uint64_t timeslice,
@@ -159,6 +195,7 @@ private:
                         uint64_t desc_length,
                         uint64_t start_index_desc,
                         uint64_t timeslice_size,
+                        bool bandwidth_aware_placement,
                         std::string log_directory,
                         bool enable_logging);
 
@@ -166,6 +203,27 @@ private:
   // timeout connections)
   void refill_future_timeslices(uint64_t up_to_timeslice);
 
+  // Append a placement plan from the placement horizon up to a timeslice
+  void
+  apply_placement_plan(uint64_t last_timeslice,
+                       const std::vector<uint8_t>& weights,
+                       uint32_t keep_percentage = ConstVariables::ONE_HUNDRED);
+
+  // Get the percentage of timeslices to keep at an input buffer fill level
+  uint32_t get_keep_percentage(uint32_t input_buffer_fill) const;
+
+  // Check whether a timeslice is shed according to the placement plans
+  bool is_timeslice_shed(uint64_t timeslice) const;
+
+  // Get the compute node of a timeslice according to the placement plans
+  uint32_t get_planned_compute_index(uint64_t timeslice);
+
+  // Check whether a compute node is admitted to receive a timeslice
+  bool is_admitted(uint32_t compute_index, uint64_t timeslice) const;
+
+  // Place the future timeslices from a timeslice on again
+  void replan_future_timeslices(uint64_t from_timeslice);
+
   // Insert rescheduled timeslices after the correct timeslice
   void check_to_add_rescheduled_timeslices(uint32_t compute_index);
 
@@ -227,6 +285,57 @@ private:
   // Check whether to generate log files
   bool enable_logging_;
 
+  // Time from transmission to the RDMA write acknowledgement in us
+  cbm::MetricHistogram rdma_ack_time_metric_;
+
+  // Time from transmission to the completion acknowledgement in us
+  cbm::MetricHistogram completion_time_metric_;
+
+  // Check whether to place timeslices according to the proposed weights
+  bool bandwidth_aware_placement_;
+
+  // Slot tables of the applied placement plans, keyed by their first
+  // timeslice
+  std::map<uint64_t, std::vector<uint32_t>> placement_slots_;
+
+  // A received placement plan waiting for its predecessors
+  struct PlacementPlan {
+    uint64_t last_timeslice;
+    std::vector<uint8_t> weights;
+    uint32_t keep_percentage;
+  };
+
+  // Received placement plans waiting for their predecessors by interval
+  std::map<uint64_t, PlacementPlan> pending_placement_plans_;
+
+  // The interval of the next placement plan to be applied (the first two
+  // intervals are never proposed)
+  uint64_t next_placement_interval_ = 2;
+
+  // The first timeslice not covered by a placement plan
+  uint64_t placement_horizon_ = ConstVariables::ZERO;
+
+  // The load shedding levels <fill percentage, keep percentage> in
+  // ascending order of the fill percentage (empty if disabled)
+  std::vector<std::pair<uint32_t, uint32_t>> shedding_levels_;
+
+  // Every n-th timeslice is never shed (0 if none)
+  uint32_t shedding_priority_interval_ = 0;
+
+  // Percentage of timeslices to keep of the applied placement plans, keyed by
+  // their first timeslice
+  std::map<uint64_t, uint32_t> keep_percentages_;
+
+  // Shed timeslices in ascending order that are still to be accounted for
+  std::deque<uint64_t> pending_shed_timeslices_;
+
+  // The first timeslice not yet checked for shedding (placing timeslices
+  // again must not shed them twice)
+  uint64_t shed_horizon_ = ConstVariables::ZERO;
+
+  // The # of shed timeslices
+  uint64_t shed_timeslices_ = 0;
+
   // Mapping of connections and their transmitted timeslices
   SizedMap<uint32_t, SizedMap<uint64_t, TimesliceInfo*>*> conn_timeslice_info_;
 
@@ -236,6 +345,10 @@ private:
   // Future Timeslices for each compute connection <conn_id, <timeslices>>
   SizedMap<uint32_t, std::set<uint64_t>*> future_conn_timeslices_;
 
+  // The first timeslice placed on each compute node (MINUS_ONE while a
+  // standby compute node has not joined)
+  std::vector<uint64_t> admission_timeslice_;
+
   // The received decisions of redistribution
   SizedMap<uint32_t, uint64_t> redistribution_decisions_log_;
 
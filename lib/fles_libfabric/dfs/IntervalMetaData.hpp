@@ -35,6 +35,26 @@ struct IntervalMetaData {
   // The number of compute nodes (active and timeout)
   uint32_t compute_node_count;
 
+  // Per compute node placement information [The buffer pressure in percent
+  // when a input node is the sender, the placement weight when a compute node
+  // is the sender]
+  uint8_t placement_info[ConstVariables::MAX_COMPUTE_NODE_COUNT] = {};
+
+  // The input buffer fill level in percent [The maximum during the interval
+  // when a input node is the sender, the maximum of all input nodes two
+  // intervals before when a compute node is the sender]
+  uint8_t input_buffer_fill = 0;
+
+  // The average microslice size in bytes [Of the sent components when a input
+  // node is the sender, the sum of all input nodes when a compute node is the
+  // sender]
+  uint32_t microslice_size = 0;
+
+  // The number of core microslices of the timeslices from interval_index *
+  // interval length on if the timeslice size is adaptive, zero otherwise
+  // [Set only when a compute node is the sender]
+  uint32_t timeslice_size = 0;
+
   IntervalMetaData() {}
 
   IntervalMetaData(uint64_t index,
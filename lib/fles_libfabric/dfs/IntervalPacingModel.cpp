@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "IntervalPacingModel.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tl_libfabric {
+
+IntervalPacingModel::IntervalPacingModel(uint32_t target_buffer_fill)
+    : target_buffer_fill_(std::clamp<uint32_t>(target_buffer_fill, 1,
+                                               ConstVariables::ONE_HUNDRED -
+                                                   1)) {}
+
+void IntervalPacingModel::add_interval(const IntervalMetaData& actual) {
+  if (actual.last_timeslice < actual.start_timeslice ||
+      actual.interval_duration == 0)
+    return;
+
+  double duration = static_cast<double>(actual.interval_duration) /
+                    (actual.last_timeslice - actual.start_timeslice + 1);
+  if (interval_count_ == 0) {
+    duration_mean_ = duration;
+    duration_variance_ = 0;
+  } else {
+    double difference = duration - duration_mean_;
+    duration_mean_ += SMOOTHING_ * difference;
+    duration_variance_ = (1 - SMOOTHING_) * (duration_variance_ +
+                                             SMOOTHING_ * difference *
+                                                 difference);
+  }
+
+  compute_node_count_ = std::min<uint32_t>(
+      actual.compute_node_count, ConstVariables::MAX_COMPUTE_NODE_COUNT);
+  for (uint32_t c = 0; c < compute_node_count_; c++) {
+    double fill = actual.placement_info[c];
+    if (interval_count_ == 0) {
+      fill_level_[c] = fill;
+      fill_trend_[c] = 0;
+    } else {
+      double previous_level = fill_level_[c];
+      fill_level_[c] = SMOOTHING_ * fill +
+                       (1 - SMOOTHING_) * (previous_level + fill_trend_[c]);
+      fill_trend_[c] = TREND_SMOOTHING_ * (fill_level_[c] - previous_level) +
+                       (1 - TREND_SMOOTHING_) * fill_trend_[c];
+    }
+  }
+  ++interval_count_;
+}
+
+void IntervalPacingModel::add_round_trip_time(uint64_t round_trip_time) {
+  if (!round_trip_time_valid_) {
+    round_trip_time_ = round_trip_time;
+    round_trip_time_valid_ = true;
+  } else {
+    round_trip_time_ += SMOOTHING_ * (round_trip_time - round_trip_time_);
+  }
+}
+
+bool IntervalPacingModel::ready() const {
+  return interval_count_ >= MIN_INTERVAL_COUNT_;
+}
+
+uint64_t IntervalPacingModel::propose_duration(uint64_t timeslice_count,
+                                               uint32_t round_count) const {
+  double duration = duration_mean_ * timeslice_count;
+  double fill = get_predicted_buffer_fill();
+  if (fill < target_buffer_fill_) {
+    // Probe less aggressively if the durations are noisy
+    double variation =
+        duration_mean_ > 0 ? std::sqrt(duration_variance_) / duration_mean_
+                           : 0;
+    duration *= 1 - MAX_SPEEDUP_ * (target_buffer_fill_ - fill) /
+                        target_buffer_fill_ / (1 + variation);
+  } else {
+    double overshoot = fill - target_buffer_fill_;
+    duration *= 1 + MAX_SLOWDOWN_ * overshoot /
+                        (ConstVariables::ONE_HUNDRED - target_buffer_fill_);
+  }
+  if (round_trip_time_valid_)
+    duration = std::max(duration, round_trip_time_ * round_count);
+  return std::max<uint64_t>(1, std::llround(duration));
+}
+
+IntervalPacingModel::Status IntervalPacingModel::get_status() const {
+  Status status;
+  status.interval_count = interval_count_;
+  status.timeslice_duration_mean = duration_mean_;
+  status.timeslice_duration_stddev = std::sqrt(duration_variance_);
+  status.round_trip_time = round_trip_time_;
+  status.predicted_buffer_fill = get_predicted_buffer_fill();
+  status.target_buffer_fill = target_buffer_fill_;
+  return status;
+}
+
+double IntervalPacingModel::get_predicted_buffer_fill() const {
+  double max_fill = 0;
+  for (uint32_t c = 0; c < compute_node_count_; c++) {
+    max_fill = std::max(max_fill,
+                        fill_level_[c] + FORECAST_HORIZON_ * fill_trend_[c]);
+  }
+  return std::clamp<double>(max_fill, 0, ConstVariables::ONE_HUNDRED);
+}
+} // namespace tl_libfabric
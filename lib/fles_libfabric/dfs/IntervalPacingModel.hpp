@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#pragma once
+
+#include "ConstVariables.hpp"
+#include "IntervalMetaData.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace tl_libfabric {
+/**
+ * Online model of the interval throughput that DDScheduler uses to pace the
+ * intervals without hand-tuned speedup parameters.
+ *
+ * The model tracks exponentially weighted estimates of
+ * - the mean and variance of the actual duration per timeslice, i.e., the
+ *   inverse of the aggregate ingest rate of the compute nodes,
+ * - the message round-trip time between the input and compute nodes, and
+ * - the level and trend of the buffer fill of each compute node, which
+ *   tells whether the node keeps up with the data it is assigned.
+ *
+ * The proposed interval duration is the predicted actual duration, shortened
+ * while the forecast of the fullest compute buffer is below the target fill
+ * (to probe for more throughput, less so if the durations vary) and
+ * stretched while it is above (to let the compute nodes drain their
+ * buffers). Each round of an interval takes at least one round trip.
+ */
+class IntervalPacingModel {
+public:
+  // Snapshot of the model estimates for monitoring
+  struct Status {
+    uint64_t interval_count = 0;
+    // Mean and standard deviation of the duration per timeslice (us)
+    double timeslice_duration_mean = 0;
+    double timeslice_duration_stddev = 0;
+    // Round-trip time between input and compute nodes (us)
+    double round_trip_time = 0;
+    // Forecast of the fullest compute buffer (percent)
+    double predicted_buffer_fill = 0;
+    // Target fill of the compute buffers (percent)
+    uint32_t target_buffer_fill = 0;
+    // Last proposed interval duration (us), filled in by the scheduler
+    uint64_t proposed_duration = 0;
+  };
+
+  IntervalPacingModel(uint32_t target_buffer_fill);
+
+  // Update the model with the unified actual meta-data of an interval
+  void add_interval(const IntervalMetaData& actual);
+
+  // Update the model with a measured message round-trip time (us)
+  void add_round_trip_time(uint64_t round_trip_time);
+
+  // Check whether enough data has been collected to propose intervals
+  bool ready() const;
+
+  // Propose the duration (us) of an interval of the given size
+  uint64_t propose_duration(uint64_t timeslice_count,
+                            uint32_t round_count) const;
+
+  // Get the current model estimates
+  Status get_status() const;
+
+private:
+  // Forecast of the fullest compute buffer at the proposed interval
+  double get_predicted_buffer_fill() const;
+
+  // Weight of a new sample in the exponentially weighted estimates
+  static constexpr double SMOOTHING_ = 0.2;
+
+  // Weight of a new sample in the buffer fill trend estimates
+  static constexpr double TREND_SMOOTHING_ = 0.1;
+
+  // Intervals between the last actual and the proposed interval (the
+  // proposal is based on the interval that all compute nodes have completed)
+  static constexpr uint32_t FORECAST_HORIZON_ = 2;
+
+  // Maximum relative shortening of the duration with empty buffers
+  static constexpr double MAX_SPEEDUP_ = 0.1;
+
+  // Maximum relative stretching of the duration with full buffers
+  static constexpr double MAX_SLOWDOWN_ = 0.5;
+
+  // The intervals needed before the model is used
+  static constexpr uint64_t MIN_INTERVAL_COUNT_ = 2;
+
+  // The target fill of the compute buffers (percent)
+  uint32_t target_buffer_fill_;
+
+  uint64_t interval_count_ = 0;
+
+  double duration_mean_ = 0;
+
+  double duration_variance_ = 0;
+
+  bool round_trip_time_valid_ = false;
+
+  double round_trip_time_ = 0;
+
+  uint32_t compute_node_count_ = 0;
+
+  std::array<double, ConstVariables::MAX_COMPUTE_NODE_COUNT> fill_level_{};
+
+  std::array<double, ConstVariables::MAX_COMPUTE_NODE_COUNT> fill_trend_{};
+};
+} // namespace tl_libfabric
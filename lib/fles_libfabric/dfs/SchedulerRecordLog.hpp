@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#pragma once
+
+#include <log.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tl_libfabric {
+/**
+ * Streaming log of fixed-size binary records of the DFS schedulers.
+ *
+ * Records are appended to an in-memory batch of bounded size, which a
+ * background thread writes to the log file. The memory footprint is thus
+ * independent of the run time. If the writer falls behind, records are
+ * counted as lost instead of blocking the scheduler.
+ *
+ * A log file consists of a Header followed by the records in the order of
+ * their appending. for_each() reads them back for the conversion to the
+ * text formats of the log files.
+ */
+template <typename Record> class SchedulerRecordLog {
+  static_assert(std::is_trivially_copyable<Record>::value,
+                "log records must be trivially copyable");
+
+public:
+  /// Header of a log file.
+  struct Header {
+    static constexpr uint64_t magic_value = 0x31534644534c4546; // "FLESDFS1"
+
+    uint64_t magic = magic_value;
+    uint32_t record_size = sizeof(Record);
+    uint32_t reserved = 0;
+  };
+
+  /// Create the log file and start the writer thread.
+  explicit SchedulerRecordLog(std::string path,
+                              std::size_t max_pending = 4096)
+      : path_(std::move(path)), max_pending_(max_pending) {
+    file_.open(path_, std::ios::binary | std::ios::trunc);
+    if (!file_) {
+      throw std::runtime_error("cannot create scheduler log \"" + path_ +
+                               "\"");
+    }
+    Header header;
+    file_.write(reinterpret_cast<const char*>(&header), sizeof header);
+    pending_.reserve(max_pending_);
+    thread_ = std::thread([this] { run(); });
+  }
+
+  SchedulerRecordLog(const SchedulerRecordLog&) = delete;
+  SchedulerRecordLog& operator=(const SchedulerRecordLog&) = delete;
+
+  ~SchedulerRecordLog() { close(); }
+
+  /// Append a record (never blocks on the file).
+  void append(const Record& record) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stopped_ || pending_.size() >= max_pending_) {
+        ++lost_;
+        return;
+      }
+      pending_.push_back(record);
+    }
+    not_empty_.notify_one();
+  }
+
+  /// Write the pending records, stop the writer and close the file.
+  void close() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stopped_) {
+        return;
+      }
+      stopped_ = true;
+    }
+    not_empty_.notify_one();
+    thread_.join();
+    file_.close();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (lost_ != 0) {
+      L_(warning) << "scheduler log \"" << path_ << "\": " << lost_
+                  << " records lost";
+    }
+  }
+
+  /// Retrieve the file name of the log.
+  [[nodiscard]] const std::string& path() const { return path_; }
+
+  /// Call f for each record of a log file, in file order.
+  template <typename F> static void for_each(const std::string& path, F f) {
+    std::ifstream ifs(path, std::ios::binary);
+    Header header;
+    ifs.read(reinterpret_cast<char*>(&header), sizeof header);
+    if (!ifs || header.magic != Header::magic_value ||
+        header.record_size != sizeof(Record)) {
+      throw std::runtime_error("not a scheduler log of this kind: " + path);
+    }
+    Record record;
+    while (ifs.read(reinterpret_cast<char*>(&record), sizeof record)) {
+      f(record);
+    }
+  }
+
+private:
+  void run() {
+    std::vector<Record> batch;
+    batch.reserve(max_pending_);
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      not_empty_.wait(lock, [this] { return stopped_ || !pending_.empty(); });
+      if (pending_.empty()) {
+        return;
+      }
+      batch.swap(pending_);
+      lock.unlock();
+      file_.write(reinterpret_cast<const char*>(batch.data()),
+                  static_cast<std::streamsize>(batch.size() * sizeof(Record)));
+      file_.flush();
+      batch.clear();
+      lock.lock();
+    }
+  }
+
+  std::string path_;
+  std::size_t max_pending_;
+  std::ofstream file_;
+
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::vector<Record> pending_;
+  uint64_t lost_ = 0;
+  bool stopped_ = false;
+  std::thread thread_;
+};
+} // namespace tl_libfabric
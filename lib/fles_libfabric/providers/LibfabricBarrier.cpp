@@ -1,13 +1,19 @@
+// Copyright 2020 Farouk Salem <salem@zib.de>
 
 #include "LibfabricBarrier.hpp"
 
+#include <chrono>
+
 namespace tl_libfabric {
 
 void LibfabricBarrier::create_barrier_instance(uint32_t remote_index,
                                                struct fid_domain* pd,
-                                               bool is_root) {
+                                               bool is_root,
+                                               uint32_t input_count,
+                                               uint32_t compute_count) {
   if (barrier_ == nullptr)
-    barrier_ = new LibfabricBarrier(remote_index, pd, is_root);
+    barrier_ = new LibfabricBarrier(remote_index, pd, is_root, input_count,
+                                    compute_count);
   assert(LibfabricBarrier::barrier_ != nullptr);
 }
 
@@ -16,22 +22,184 @@ LibfabricBarrier* LibfabricBarrier::get_instance() { return barrier_; }
 LibfabricBarrier::~LibfabricBarrier() {}
 LibfabricBarrier::LibfabricBarrier(uint32_t remote_index,
                                    struct fid_domain* pd,
-                                   bool is_root)
-    : LibfabricCollective(remote_index, pd), root_(is_root) {
-  // TODO remote_index needed?
-}
+                                   bool is_root,
+                                   uint32_t input_count,
+                                   uint32_t compute_count)
+    : LibfabricCollective(remote_index, pd), root_(is_root),
+      index_(remote_index), input_count_(input_count),
+      compute_count_(compute_count) {}
 
 size_t LibfabricBarrier::call_barrier() {
-  if (root_) {
+  auto start = std::chrono::steady_clock::now();
+  endpoints_ = retrieve_endpoint_list();
+  bool tree = is_tree_usable();
+  if (tree) {
+    if (root_) {
+      compute_tree_barrier();
+    } else {
+      input_tree_barrier();
+    }
+  } else if (root_) {
     receive_all();
     broadcast();
   } else {
     broadcast(true);
     receive_all(true);
   }
+  L_(info) << (tree ? "tree" : "linear") << " barrier with "
+           << endpoints_.size() << " endpoints took "
+           << std::chrono::duration_cast<std::chrono::microseconds>(
+                  std::chrono::steady_clock::now() - start)
+                  .count()
+           << " us";
   return 0;
 }
 
+bool LibfabricBarrier::is_tree_usable() {
+  if (input_count_ == 0 || compute_count_ == 0 ||
+      index_ >= (root_ ? compute_count_ : input_count_) ||
+      endpoints_.size() != (root_ ? input_count_ : compute_count_))
+    return false;
+  for (const auto* ep_info : endpoints_) {
+    if (!ep_info->active)
+      return false;
+  }
+  return true;
+}
+
+uint32_t LibfabricBarrier::tree_parent(uint32_t compute) {
+  // clear the lowest set bit
+  return compute & (compute - 1);
+}
+
+std::vector<uint32_t> LibfabricBarrier::tree_children(uint32_t compute) const {
+  std::vector<uint32_t> children;
+  for (uint32_t step = 1; compute + step < compute_count_; step <<= 1) {
+    if (compute != 0 && step >= (compute & -compute))
+      break;
+    children.push_back(compute + step);
+  }
+  return children;
+}
+
+void LibfabricBarrier::compute_tree_barrier() {
+  const uint32_t compute = index_;
+  const std::vector<uint32_t> children = tree_children(compute);
+  const uint32_t up_relay = relay(compute);
+  // the relay introduces itself unless it reports to this node anyway
+  const bool hello = compute != 0 && owner(up_relay) != compute;
+
+  expected_.assign(endpoints_.size(), 0);
+  uint32_t gather = 0;
+  for (uint32_t input = compute; input < input_count_;
+       input += compute_count_) {
+    expect(input); // Arrive
+    ++gather;
+  }
+  for (uint32_t child : children) {
+    expect(relay(child)); // Up
+    ++gather;
+  }
+  if (hello) {
+    expect(up_relay);
+    ++gather;
+  }
+  if (compute != 0)
+    expect(up_relay); // Down
+  post_expected();
+
+  LibfabricCollectiveMessage message;
+  for (uint32_t i = 0; i < gather; ++i) {
+    receive(message);
+    assert(message.type != LibfabricCollectiveMessage::Down);
+  }
+
+  if (compute != 0) {
+    send(up_relay, LibfabricCollectiveMessage::Up, compute);
+    receive(message);
+    assert(message.type == LibfabricCollectiveMessage::Down);
+  }
+
+  for (uint32_t child : children)
+    send(relay(child), LibfabricCollectiveMessage::Down, child);
+  for (uint32_t input = compute; input < input_count_; input += compute_count_)
+    send(input, LibfabricCollectiveMessage::Release, compute);
+}
+
+void LibfabricBarrier::input_tree_barrier() {
+  const uint32_t input = index_;
+  // compute node 0 is the root and has no parent to relay to
+  std::vector<uint32_t> relayed;
+  for (uint32_t compute = input; compute < compute_count_;
+       compute += input_count_) {
+    if (compute != 0)
+      relayed.push_back(compute);
+  }
+
+  expected_.assign(endpoints_.size(), 0);
+  expect(owner(input)); // Release
+  for (uint32_t compute : relayed) {
+    expect(compute);              // Up
+    expect(tree_parent(compute)); // Down
+  }
+  post_expected();
+
+  send(owner(input), LibfabricCollectiveMessage::Arrive, input);
+  for (uint32_t compute : relayed) {
+    if (owner(input) != compute)
+      send(compute, LibfabricCollectiveMessage::Hello, input);
+  }
+
+  uint32_t pending = 1 + 2 * static_cast<uint32_t>(relayed.size());
+  LibfabricCollectiveMessage message;
+  while (pending > 0) {
+    receive(message);
+    --pending;
+    switch (message.type) {
+    case LibfabricCollectiveMessage::Up:
+      send(tree_parent(message.origin), LibfabricCollectiveMessage::Up,
+           message.origin);
+      break;
+    case LibfabricCollectiveMessage::Down:
+      send(message.origin, LibfabricCollectiveMessage::Down, message.origin);
+      break;
+    default:
+      assert(message.type == LibfabricCollectiveMessage::Release);
+      break;
+    }
+  }
+}
+
+void LibfabricBarrier::expect(uint32_t ep_index) {
+  assert(ep_index < expected_.size());
+  ++expected_[ep_index];
+}
+
+void LibfabricBarrier::post_expected() {
+  for (uint32_t i = 0; i < expected_.size(); ++i) {
+    if (expected_[i] > 0)
+      recv(endpoints_[i]);
+  }
+}
+
+uint32_t LibfabricBarrier::receive(LibfabricCollectiveMessage& message) {
+  uint32_t ep_index = wait_for_recv();
+  assert(ep_index < expected_.size() && expected_[ep_index] > 0);
+  message = endpoints_[ep_index]->recv_buffer;
+  if (--expected_[ep_index] > 0)
+    recv(endpoints_[ep_index]);
+  return ep_index;
+}
+
+void LibfabricBarrier::send(uint32_t ep_index, uint32_t type, uint32_t origin) {
+  assert(ep_index < endpoints_.size());
+  LibfabricCollectiveEPInfo* ep_info = endpoints_[ep_index];
+  ep_info->send_buffer.type = type;
+  ep_info->send_buffer.origin = origin;
+  send(ep_info);
+  wait_for_send_cq(1);
+}
+
 void LibfabricBarrier::receive_all(bool only_root_eps) {
   std::vector<struct LibfabricCollectiveEPInfo*> endpoints =
       retrieve_endpoint_list();
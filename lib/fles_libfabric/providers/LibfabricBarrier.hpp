@@ -2,6 +2,20 @@
 
 /**
  * An implementation of fi_barrier
+ *
+ * The barrier runs between the input nodes and the compute nodes, which are
+ * connected pairwise by RDM endpoints. A compute node learns the address of
+ * an input node only from its first message, so the first message on every
+ * pair goes from the input node to the compute node.
+ *
+ * If the numbers of input and compute nodes are known, the tree barrier is
+ * used: each input node reports to an owner compute node (input index modulo
+ * compute count), and the compute nodes form a binomial tree, each edge of
+ * which is relayed by an input node (child compute index modulo input
+ * count). Arrivals are gathered up the tree to compute node 0, and the
+ * release is sent back down, in O(log N) steps. Otherwise, the linear
+ * barrier is used, in which every input node exchanges messages with every
+ * compute node.
  */
 #pragma once
 
@@ -17,21 +31,68 @@ public:
 
   size_t call_barrier();
 
+  // Create the instance, given the numbers of input and compute nodes taking
+  // part in the barrier (zero if unknown, which selects the linear barrier)
   static void create_barrier_instance(uint32_t remote_index,
                                       struct fid_domain* pd,
-                                      bool is_root);
+                                      bool is_root,
+                                      uint32_t input_count = 0,
+                                      uint32_t compute_count = 0);
 
   static LibfabricBarrier* get_instance();
 
 private:
   ~LibfabricBarrier();
-  LibfabricBarrier(uint32_t remote_index, struct fid_domain* pd, bool is_root);
+  LibfabricBarrier(uint32_t remote_index,
+                   struct fid_domain* pd,
+                   bool is_root,
+                   uint32_t input_count,
+                   uint32_t compute_count);
   void receive_all(bool only_root_eps = false);
   void broadcast(bool only_root_eps = false);
   void recv(const struct LibfabricCollectiveEPInfo* ep_info);
   void send(const struct LibfabricCollectiveEPInfo* ep_info);
 
+  // Check whether all the endpoints of the tree barrier are available
+  bool is_tree_usable();
+
+  // Run the tree barrier on a compute node
+  void compute_tree_barrier();
+
+  // Run the tree barrier on an input node
+  void input_tree_barrier();
+
+  // Parent of a compute node in the binomial tree
+  static uint32_t tree_parent(uint32_t compute);
+
+  // Children of a compute node in the binomial tree
+  std::vector<uint32_t> tree_children(uint32_t compute) const;
+
+  // Compute node an input node reports to
+  uint32_t owner(uint32_t input) const { return input % compute_count_; }
+
+  // Input node relaying between a compute node and its parent
+  uint32_t relay(uint32_t compute) const { return compute % input_count_; }
+
+  // Expect a message on an endpoint
+  void expect(uint32_t ep_index);
+
+  // Post the receives of the expected messages
+  void post_expected();
+
+  // Wait for an expected message and return the index of its endpoint
+  uint32_t receive(LibfabricCollectiveMessage& message);
+
+  // Send a message of the tree barrier and wait for its completion
+  void send(uint32_t ep_index, uint32_t type, uint32_t origin);
+
   static LibfabricBarrier* barrier_;
   bool root_;
+  uint32_t index_;
+  uint32_t input_count_;
+  uint32_t compute_count_;
+  std::vector<struct LibfabricCollectiveEPInfo*> endpoints_;
+  // Expected messages per endpoint in the tree barrier
+  std::vector<uint32_t> expected_;
 };
 } // namespace tl_libfabric
@@ -124,8 +124,8 @@ void LibfabricCollective::create_endpoint(
     L_(fatal) << "fi_enable failed: " << err << "=" << fi_strerror(-err);
     throw LibfabricException("fi_enable failed");
   }
-  size_t addr_len = sizeof(ep_info->send_buffer);
-  err = fi_getname(&ep_info->ep->fid, &ep_info->send_buffer, &addr_len);
+  size_t addr_len = sizeof(ep_info->send_buffer.address);
+  err = fi_getname(&ep_info->ep->fid, ep_info->send_buffer.address, &addr_len);
   assert(err == 0);
 }
 
@@ -179,15 +179,14 @@ void LibfabricCollective::create_recv_mr(LibfabricCollectiveEPInfo* ep_info) {
   ep_info->recv_sge.iov_base = &ep_info->recv_buffer;
   ep_info->recv_sge.iov_len = sizeof(ep_info->recv_buffer);
 
-  void* recv_wr_descs[1] = {nullptr};
-  recv_wr_descs[0] = fi_mr_desc(ep_info->mr_recv);
+  ep_info->recv_desc = fi_mr_desc(ep_info->mr_recv);
 
   struct fi_custom_context* context =
       LibfabricContextPool::getInst()->getContext();
   context->op_context = ep_info->index;
 
   ep_info->recv_msg_wr.msg_iov = &ep_info->recv_sge;
-  ep_info->recv_msg_wr.desc = recv_wr_descs;
+  ep_info->recv_msg_wr.desc = &ep_info->recv_desc;
   ep_info->recv_msg_wr.iov_count = 1;
   ep_info->recv_msg_wr.addr = ep_info->fi_addr;
   ep_info->recv_msg_wr.context = context;
@@ -212,15 +211,14 @@ void LibfabricCollective::create_send_mr(LibfabricCollectiveEPInfo* ep_info) {
   ep_info->send_sge.iov_base = &ep_info->send_buffer;
   ep_info->send_sge.iov_len = sizeof(ep_info->send_buffer);
 
-  void* send_wr_descs[1] = {nullptr};
-  send_wr_descs[0] = fi_mr_desc(ep_info->mr_send);
+  ep_info->send_desc = fi_mr_desc(ep_info->mr_send);
 
   struct fi_custom_context* context =
       LibfabricContextPool::getInst()->getContext();
   context->op_context = ep_info->index;
 
   ep_info->send_msg_wr.msg_iov = &ep_info->send_sge;
-  ep_info->send_msg_wr.desc = send_wr_descs;
+  ep_info->send_msg_wr.desc = &ep_info->send_desc;
   ep_info->send_msg_wr.iov_count = 1;
   ep_info->send_msg_wr.addr = ep_info->fi_addr;
   ep_info->send_msg_wr.context = context;
@@ -237,12 +235,12 @@ bool LibfabricCollective::deactive_endpoint(uint32_t index) {
 }
 void LibfabricCollective::wait_for_cq(struct fid_cq* cq, const int32_t events) {
 
-  struct fi_cq_entry* wc = new struct fi_cq_entry[MAX_CQ_ENTRIES];
+  std::vector<struct fi_cq_entry> wc(MAX_CQ_ENTRIES);
   int ne, received = 0, expected = std::min(MAX_CQ_ENTRIES, events),
           remaining = events - MAX_CQ_ENTRIES;
 
   while (received < expected) {
-    ne = fi_cq_read(cq, &wc, (expected - received));
+    ne = fi_cq_read(cq, wc.data(), (expected - received));
     if ((ne < 0) && (ne != -FI_EAGAIN)) {
       L_(fatal) << "wait_for_cq failed: " << ne << "=" << fi_strerror(-ne);
       throw LibfabricException("wait_for_cq failed");
@@ -258,15 +256,7 @@ void LibfabricCollective::wait_for_cq(struct fid_cq* cq, const int32_t events) {
       struct fi_custom_context* context =
           static_cast<struct fi_custom_context*>(wc[i].op_context);
       assert(context != nullptr);
-      if (endpoint_list_[context->op_context]->fi_addr == FI_ADDR_UNSPEC) {
-        int res = fi_av_insert(
-            av_, &endpoint_list_[context->op_context]->recv_buffer, 1,
-            &endpoint_list_[context->op_context]->fi_addr, 0, NULL);
-        assert(res == 1);
-        endpoint_list_[context->op_context]->recv_msg_wr.addr =
-            endpoint_list_[context->op_context]->send_msg_wr.addr =
-                endpoint_list_[context->op_context]->fi_addr;
-      }
+      resolve_address(endpoint_list_[context->op_context]);
     }
   }
   if (remaining > 0) {
@@ -274,6 +264,32 @@ void LibfabricCollective::wait_for_cq(struct fid_cq* cq, const int32_t events) {
   }
 }
 
+void LibfabricCollective::resolve_address(LibfabricCollectiveEPInfo* ep_info) {
+  if (ep_info->fi_addr != FI_ADDR_UNSPEC)
+    return;
+  int res = fi_av_insert(av_, ep_info->recv_buffer.address, 1,
+                         &ep_info->fi_addr, 0, NULL);
+  assert(res == 1);
+  ep_info->recv_msg_wr.addr = ep_info->send_msg_wr.addr = ep_info->fi_addr;
+}
+
+uint32_t LibfabricCollective::wait_for_recv() {
+  struct fi_cq_entry wc;
+  int ne;
+  do {
+    ne = fi_cq_read(recv_cq_, &wc, 1);
+    if ((ne < 0) && (ne != -FI_EAGAIN)) {
+      L_(fatal) << "wait_for_recv failed: " << ne << "=" << fi_strerror(-ne);
+      throw LibfabricException("wait_for_recv failed");
+    }
+  } while (ne != 1);
+  struct fi_custom_context* context =
+      static_cast<struct fi_custom_context*>(wc.op_context);
+  assert(context != nullptr);
+  resolve_address(endpoint_list_[context->op_context]);
+  return static_cast<uint32_t>(context->op_context);
+}
+
 void LibfabricCollective::wait_for_recv_cq(uint32_t events) {
   wait_for_cq(recv_cq_, events);
 }
@@ -42,6 +42,9 @@ protected:
 
   void wait_for_send_cq(uint32_t events);
 
+  // Wait for one receive completion and return the index of its endpoint
+  uint32_t wait_for_recv();
+
   std::vector<struct LibfabricCollectiveEPInfo*> retrieve_endpoint_list();
 
 private:
@@ -67,6 +70,9 @@ private:
 
   void wait_for_cq(struct fid_cq* cq, const int32_t events);
 
+  // Insert the address of the sender of the first received message
+  void resolve_address(LibfabricCollectiveEPInfo* ep_info);
+
   std::vector<LibfabricCollectiveEPInfo*> endpoint_list_;
 
   uint32_t remote_index_;
@@ -12,6 +12,18 @@
 
 namespace tl_libfabric {
 
+/// Message of the collective operations
+struct LibfabricCollectiveMessage {
+  enum Type : uint32_t { Arrive = 1, Hello = 2, Up = 3, Down = 4, Release = 5 };
+
+  /// Endpoint name of the sender (resolved on the first receive)
+  unsigned char address[64];
+  /// Step of the tree barrier, see LibfabricBarrier
+  uint32_t type;
+  /// Node the step refers to
+  uint32_t origin;
+};
+
 struct LibfabricCollectiveEPInfo {
   uint64_t index;
   struct fid_ep* ep = nullptr;
@@ -20,12 +32,14 @@ struct LibfabricCollectiveEPInfo {
   struct fi_msg_tagged recv_msg_wr;
   struct iovec recv_sge = iovec();
   struct fid_mr* mr_recv = nullptr;
-  unsigned char recv_buffer[64];
+  void* recv_desc = nullptr;
+  LibfabricCollectiveMessage recv_buffer;
 
   struct fi_msg_tagged send_msg_wr;
   struct iovec send_sge = iovec();
   struct fid_mr* mr_send = nullptr;
-  unsigned char send_buffer[64];
+  void* send_desc = nullptr;
+  LibfabricCollectiveMessage send_buffer;
 
   bool root_ep = false;
   bool active = true;
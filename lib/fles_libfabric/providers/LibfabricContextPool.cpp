@@ -1,76 +1,120 @@
 // Copyright 2019 Farouk Salem <salem@zib.de>
 
 #include "LibfabricContextPool.hpp"
+#include "LibfabricException.hpp"
 
 namespace tl_libfabric {
 
-std::unique_ptr<LibfabricContextPool>& LibfabricContextPool::getInst() {
-  if (LibfabricContextPool::context_pool_ == nullptr)
-    LibfabricContextPool::context_pool_ =
-        std::unique_ptr<LibfabricContextPool>(new LibfabricContextPool());
+/// The free contexts of a thread, returned to the pool at thread exit.
+struct LibfabricContextPool::ThreadCache {
+  std::vector<uint32_t> ids;
 
-  return LibfabricContextPool::context_pool_;
-}
+  ~ThreadCache() {
+    if (!ids.empty()) {
+      getInst()->push_free(ids.data(), ids.size());
+    }
+  }
+};
 
-LibfabricContextPool::LibfabricContextPool() {
-  ///
+std::unique_ptr<LibfabricContextPool>& LibfabricContextPool::getInst() {
+  static std::unique_ptr<LibfabricContextPool> context_pool(
+      new LibfabricContextPool());
+  return context_pool;
 }
-LibfabricContextPool::~LibfabricContextPool() {
 
-  for (auto it = available_.begin(); it != available_.end(); it++) {
-    delete (*it);
-  }
-
-  for (auto it = in_use_.begin(); it != in_use_.end(); it++) {
-    delete (*it);
+LibfabricContextPool::~LibfabricContextPool() {
+  for (uint32_t i = 0; i < num_blocks_; ++i) {
+    delete[] blocks_[i].load(std::memory_order_relaxed);
   }
-
-  available_.clear();
-  in_use_.clear();
   L_(info) << "LibfabricContextPool deconstructor: Total number of created "
               "objects "
-           << context_counter_;
+           << num_blocks_ * block_size_;
+}
+
+LibfabricContextPool::ThreadCache& LibfabricContextPool::thread_cache() {
+  thread_local ThreadCache cache;
+  return cache;
 }
 
 struct fi_custom_context* LibfabricContextPool::getContext() {
-  pool_mutex_.lock();
-  if (available_.empty()) {
-    struct fi_custom_context* context = new fi_custom_context();
-    context->id = context_counter_++;
-    in_use_.push_front(context);
-    L_(debug) << "getContext:: New context is created with ID " << context->id;
-  } else {
-    in_use_.push_front(available_.front());
-    available_.pop_front();
+  auto& ids = thread_cache().ids;
+  while (ids.empty()) {
+    if (pop_free(ids, batch_size_) == 0) {
+      grow();
+    }
   }
-  pool_mutex_.unlock();
-  return (*in_use_.begin());
+  const uint32_t id = ids.back();
+  ids.pop_back();
+  return &slot(id).context;
 }
 
 void LibfabricContextPool::releaseContext(struct fi_custom_context* context) {
-  uint32_t count = 0;
-  for (auto it = in_use_.begin(); it != in_use_.end(); it++) {
-    if (context->id == (*it)->id) {
-      available_.push_back((*it));
-      in_use_.erase(it);
-      break;
-    }
-    ++count;
+  auto& ids = thread_cache().ids;
+  ids.push_back(static_cast<uint32_t>(context->id));
+  if (ids.size() >= 2 * batch_size_) {
+    push_free(ids.data() + ids.size() - batch_size_, batch_size_);
+    ids.resize(ids.size() - batch_size_);
   }
-  L_(debug) << "LibfabricContextPool: Context released with ID " << context->id;
 }
 
-void LibfabricContextPool::log() {
-  int i = 0;
-  for (auto it = available_.begin(); it != available_.end(); it++, i++)
-    L_(debug) << "Logging:: Available[" << i << "].id = " << (*it)->id;
+void LibfabricContextPool::push_free(const uint32_t* ids, std::size_t count) {
+  for (std::size_t i = 0; i + 1 < count; ++i) {
+    slot(ids[i]).next_free.store(ids[i + 1] + 1, std::memory_order_relaxed);
+  }
+  Slot& last = slot(ids[count - 1]);
+  uint64_t head = free_head_.load(std::memory_order_relaxed);
+  uint64_t new_head = 0;
+  do {
+    last.next_free.store(static_cast<uint32_t>(head),
+                         std::memory_order_relaxed);
+    new_head = (((head >> 32) + 1) << 32) | (ids[0] + 1);
+  } while (!free_head_.compare_exchange_weak(
+      head, new_head, std::memory_order_release, std::memory_order_relaxed));
+}
 
-  i = 0;
-  for (auto it = in_use_.begin(); it != in_use_.end(); it++, i++)
-    L_(debug) << "Logging:: in_use_[" << i << "].id = " << (*it)->id;
+std::size_t LibfabricContextPool::pop_free(std::vector<uint32_t>& ids,
+                                           std::size_t count) {
+  std::size_t popped = 0;
+  uint64_t head = free_head_.load(std::memory_order_acquire);
+  while (popped < count && static_cast<uint32_t>(head) != 0) {
+    const uint32_t id = static_cast<uint32_t>(head) - 1;
+    // a stale link is rejected by the tag of the head
+    const uint32_t next_free =
+        slot(id).next_free.load(std::memory_order_relaxed);
+    const uint64_t new_head = (((head >> 32) + 1) << 32) | next_free;
+    if (free_head_.compare_exchange_weak(head, new_head,
+                                         std::memory_order_acquire,
+                                         std::memory_order_acquire)) {
+      ids.push_back(id);
+      ++popped;
+      head = new_head;
+    }
+  }
+  return popped;
 }
 
-std::unique_ptr<LibfabricContextPool> LibfabricContextPool::context_pool_ =
-    nullptr;
+void LibfabricContextPool::grow() {
+  std::lock_guard<std::mutex> lock(grow_mutex_);
+  if (static_cast<uint32_t>(free_head_.load(std::memory_order_acquire)) !=
+      0) {
+    // another thread has refilled the free list
+    return;
+  }
+  if (num_blocks_ == max_blocks_) {
+    throw LibfabricException("context pool exhausted");
+  }
+  auto* block = new Slot[block_size_]();
+  const uint32_t first = num_blocks_ * block_size_;
+  std::vector<uint32_t> ids(block_size_);
+  for (uint32_t i = 0; i < block_size_; ++i) {
+    block[i].context.id = first + i;
+    ids[i] = first + i;
+  }
+  blocks_[num_blocks_].store(block, std::memory_order_release);
+  ++num_blocks_;
+  push_free(ids.data(), ids.size());
+  L_(debug) << "LibfabricContextPool: created contexts " << first << " to "
+            << first + block_size_ - 1;
+}
 
 } // namespace tl_libfabric
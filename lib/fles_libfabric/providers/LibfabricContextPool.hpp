@@ -3,15 +3,24 @@
 /**
  * An implementation of fi_context object pool based on the Object Pool Design
  * Pattern
+ *
+ * The contexts are preallocated in blocks that are never freed, so each
+ * context is identified by its index (fi_custom_context::id) and
+ * context(id) maps a completion back to it. Released contexts are kept in a
+ * per-thread free list and exchanged in batches with a lock-free global free
+ * list, so posting an operation neither allocates nor locks. The pool only
+ * grows (under a mutex) if both are empty.
  */
 #pragma once
 
-#include <list>
+#include <array>
+#include <atomic>
 #include <log.hpp>
 #include <memory>
 #include <mutex>
 #include <rdma/fabric.h>
 #include <string.h>
+#include <vector>
 
 namespace tl_libfabric {
 struct fi_custom_context {
@@ -31,19 +40,57 @@ public:
 
   void releaseContext(struct fi_custom_context* context);
 
+  /// Retrieve a context by its index.
+  struct fi_custom_context* context(uint64_t id) const {
+    return &blocks_[id >> block_shift_]
+                .load(std::memory_order_acquire)[id & (block_size_ - 1)]
+                .context;
+  }
+
   static std::unique_ptr<LibfabricContextPool>& getInst();
 
 private:
-  static std::unique_ptr<LibfabricContextPool> context_pool_;
-  std::list<struct fi_custom_context*> available_;
-  std::list<struct fi_custom_context*> in_use_;
+  static constexpr uint32_t block_shift_ = 10;
+  static constexpr uint32_t block_size_ = 1U << block_shift_;
+  static constexpr uint32_t max_blocks_ = 4096;
+
+  /// Number of contexts exchanged with the global free list at once.
+  static constexpr std::size_t batch_size_ = 32;
+
+  struct Slot {
+    struct fi_custom_context context;
+    /// Index of the next free context plus one (0: none).
+    std::atomic<uint32_t> next_free{0};
+  };
+
+  struct ThreadCache;
+
+  std::array<std::atomic<Slot*>, max_blocks_> blocks_{};
+  uint32_t num_blocks_ = 0;
+
+  /// Head of the global free list: ABA tag (high word) and index of the
+  /// first free context plus one (low word, 0: empty).
+  std::atomic<uint64_t> free_head_{0};
+
+  /// Serializes the allocation of new blocks.
+  std::mutex grow_mutex_;
+
+  LibfabricContextPool() = default;
+
+  Slot& slot(uint32_t id) const {
+    return blocks_[id >> block_shift_].load(
+        std::memory_order_acquire)[id & (block_size_ - 1)];
+  }
 
-  uint64_t context_counter_ = 0;
+  /// Push a list of free contexts to the global free list.
+  void push_free(const uint32_t* ids, std::size_t count);
 
-  std::mutex pool_mutex_;
+  /// Pop up to count free contexts from the global free list.
+  std::size_t pop_free(std::vector<uint32_t>& ids, std::size_t count);
 
-  LibfabricContextPool();
+  /// Allocate a new block of contexts and add them to the global free list.
+  void grow();
 
-  void log();
+  static ThreadCache& thread_cache();
 };
 } // namespace tl_libfabric
@@ -10,6 +10,7 @@
 #include "RxMVerbsProvider.hpp"
 
 #include <cassert>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <memory>
@@ -22,51 +23,98 @@
 
 namespace tl_libfabric {
 
-std::unique_ptr<Provider> Provider::get_provider(std::string local_host_name) {
-  // std::cout << "Provider::get_provider()" << std::endl;
-  struct fi_info* fiinfo = RDMOmniPathProvider::exists(local_host_name);
-  if (fiinfo != nullptr) {
-    L_(info) << "found OmniPath";
-    return std::unique_ptr<Provider>(new RDMOmniPathProvider(fiinfo));
-  }
+namespace {
+// Known providers in the order of preference
+struct Candidate {
+  const char* name;
+  struct fi_info* (*exists)(std::string local_host_name);
+  std::unique_ptr<Provider> (*create)(struct fi_info* info);
+};
 
-  fiinfo = MsgVerbsProvider::exists(local_host_name);
-  if (fiinfo != nullptr) {
-    L_(info) << "found Verbs";
-    return std::unique_ptr<Provider>(new MsgVerbsProvider(fiinfo));
-  }
+template <typename P> std::unique_ptr<Provider> create(struct fi_info* info) {
+  return std::unique_ptr<Provider>(new P(info));
+}
 
-  fiinfo = RxMVerbsProvider::exists(local_host_name);
-  if (fiinfo != nullptr) {
-    L_(info) << "found RxM Verbs";
-    return std::unique_ptr<Provider>(new RxMVerbsProvider(fiinfo));
+const Candidate candidates[] = {
+    {"OmniPath", &RDMOmniPathProvider::exists, &create<RDMOmniPathProvider>},
+    {"Verbs", &MsgVerbsProvider::exists, &create<MsgVerbsProvider>},
+    {"RxM Verbs", &RxMVerbsProvider::exists, &create<RxMVerbsProvider>},
+    {"MSG GNI", &MsgGNIProvider::exists, &create<MsgGNIProvider>},
+    {"RDM GNI", &RDMGNIProvider::exists, &create<RDMGNIProvider>},
+    {"Sockets", &MsgSocketsProvider::exists, &create<MsgSocketsProvider>},
+    {"rdm", &RDMSocketsProvider::exists, &create<RDMSocketsProvider>}};
+} // namespace
+
+void Provider::init(std::string local_host_name) {
+  prov = get_provider(local_host_name, probe_);
+  if (probe_) {
+    const struct fi_info* info = prov->get_info();
+    tuned_send_queue_depth_ = static_cast<uint32_t>(info->tx_attr->size);
+    tuned_inline_data_size_ = static_cast<uint32_t>(info->tx_attr->inject_size);
+    L_(info) << "probe: selected " << info->fabric_attr->prov_name
+             << ", send queue depth " << tuned_send_queue_depth_
+             << ", inline data size " << tuned_inline_data_size_;
   }
+}
 
-  fiinfo = MsgGNIProvider::exists(local_host_name);
-  if (fiinfo != nullptr) {
-    L_(info) << "found MSG GNI";
-    return std::unique_ptr<Provider>(new MsgGNIProvider(fiinfo));
+std::unique_ptr<Provider> Provider::get_provider(std::string local_host_name,
+                                                bool probe) {
+  std::unique_ptr<Provider> selected;
+  for (const Candidate& candidate : candidates) {
+    struct fi_info* fiinfo = candidate.exists(local_host_name);
+    if (fiinfo == nullptr) {
+      continue;
+    }
+    if (probe) {
+      log_probe(candidate.name, fiinfo);
+    }
+    if (selected != nullptr) {
+      // only probed, the preferred provider is already selected
+      fi_freeinfo(fiinfo);
+      continue;
+    }
+    L_(info) << "found " << candidate.name;
+    selected = candidate.create(fiinfo);
+    if (!probe) {
+      return selected;
+    }
   }
-
-  fiinfo = RDMGNIProvider::exists(local_host_name);
-  if (fiinfo != nullptr) {
-    L_(info) << "found RDM GNI";
-    return std::unique_ptr<Provider>(new RDMGNIProvider(fiinfo));
+  if (selected == nullptr) {
+    throw LibfabricException("no known Libfabric provider found");
   }
+  return selected;
+}
 
-  fiinfo = MsgSocketsProvider::exists(local_host_name);
-  if (fiinfo != nullptr) {
-    L_(info) << "found Sockets";
-    return std::unique_ptr<Provider>(new MsgSocketsProvider(fiinfo));
-  }
+void Provider::log_probe(const char* name, const struct fi_info* info) {
+  L_(info) << "probe: " << name << " (" << info->fabric_attr->prov_name
+           << ", " << fi_tostr(&info->ep_attr->type, FI_TYPE_EP_TYPE)
+           << "): send queue depth " << info->tx_attr->size
+           << ", receive queue depth " << info->rx_attr->size
+           << ", inline data size " << info->tx_attr->inject_size
+           << ", max message size " << info->ep_attr->max_msg_size;
+}
 
-  fiinfo = RDMSocketsProvider::exists(local_host_name);
-  if (fiinfo != nullptr) {
-    L_(info) << "found rdm";
-    return std::unique_ptr<Provider>(new RDMSocketsProvider(fiinfo));
+void Provider::init_rails(const std::vector<std::string>& rail_host_names) {
+  rails.clear();
+  for (const auto& host_name : rail_host_names) {
+    auto rail_prov = get_provider(host_name);
+    // all rails are driven by the same code paths
+    if (strcmp(rail_prov->get_info()->fabric_attr->prov_name,
+               prov->get_info()->fabric_attr->prov_name) != 0) {
+      throw LibfabricException("rail " + host_name +
+                               " uses a different Libfabric provider");
+    }
+    L_(info) << "rail " << rails.size() + 1 << ": " << host_name;
+    rails.push_back(std::move(rail_prov));
   }
+}
 
-  throw LibfabricException("no known Libfabric provider found");
+void Provider::enable_on_demand_paging() {
+  // read by the verbs provider on initialization, keep an explicit setting
+  if (setenv("FI_VERBS_USE_ODP", "1", 0) != 0) {
+    throw LibfabricException("setenv failed for FI_VERBS_USE_ODP");
+  }
+  L_(info) << "requesting on-demand paging memory registration";
 }
 
 struct fi_info* Provider::get_hints(enum fi_ep_type ep_type, std::string prov) {
@@ -88,5 +136,13 @@ uint64_t Provider::requested_key = 0;
 
 std::unique_ptr<Provider> Provider::prov;
 
+std::vector<std::unique_ptr<Provider>> Provider::rails;
+
 int Provider::vector = 0;
+
+bool Provider::probe_ = false;
+
+uint32_t Provider::tuned_send_queue_depth_ = 0;
+
+uint32_t Provider::tuned_inline_data_size_ = 0;
 } // namespace tl_libfabric
@@ -51,9 +51,33 @@ public:
                        size_t paramlen,
                        void* addr) = 0;
 
-  static void init(std::string local_host_name) {
-    prov = get_provider(local_host_name);
-  }
+  static void init(std::string local_host_name);
+
+  /// Create the providers of additional rails (one per network interface).
+  /** Rail 0 is the provider created by init(). */
+  static void init_rails(const std::vector<std::string>& rail_host_names);
+
+  /// Request on-demand paging for memory registrations.
+  /** Must be called before the first provider is created. Registered memory
+   is then not pinned, so that large buffers register quickly. Currently
+   supported by the verbs provider only, others ignore the request. */
+  static void enable_on_demand_paging();
+
+  /// Probe the available providers on initialization.
+  /** Must be called before the first provider is created. The attributes of
+   every available provider are logged, and the send queue depth and inline
+   data size of the connections are taken from the selected provider instead
+   of the built-in defaults. */
+  static void enable_probe() { probe_ = true; }
+
+  /// Retrieve the probed send queue depth of the connections (0: default).
+  static uint32_t tuned_send_queue_depth() { return tuned_send_queue_depth_; }
+
+  /// Retrieve the probed inline data size of the connections (0: default).
+  static uint32_t tuned_inline_data_size() { return tuned_inline_data_size_; }
+
+  /// Retrieve the number of rails, including rail 0.
+  static std::size_t rail_count() { return rails.size() + 1; }
 
   virtual void set_hostnames_and_services(
       struct fid_av* /*av*/,
@@ -63,6 +87,10 @@ public:
 
   static std::unique_ptr<Provider>& getInst() { return prov; }
 
+  static std::unique_ptr<Provider>& getInst(std::size_t rail) {
+    return rail == 0 ? prov : rails.at(rail - 1);
+  }
+
   static struct fi_info* get_hints(enum fi_ep_type ep_type, std::string prov);
 
   static void dump_fi_info(const struct fi_info* info);
@@ -72,7 +100,13 @@ public:
   static int vector;
 
 private:
-  static std::unique_ptr<Provider> get_provider(std::string local_host_name);
+  static std::unique_ptr<Provider> get_provider(std::string local_host_name,
+                                                bool probe = false);
+  static void log_probe(const char* name, const struct fi_info* info);
   static std::unique_ptr<Provider> prov;
+  static std::vector<std::unique_ptr<Provider>> rails;
+  static bool probe_;
+  static uint32_t tuned_send_queue_depth_;
+  static uint32_t tuned_inline_data_size_;
 };
 } // namespace tl_libfabric
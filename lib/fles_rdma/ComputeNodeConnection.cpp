@@ -4,7 +4,10 @@
 #include "ComputeNodeInfo.hpp"
 #include "RequestIdentifier.hpp"
 #include "log.hpp"
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstring>
 
 #define WITH_TRACE 0
 
@@ -17,17 +20,34 @@ ComputeNodeConnection::ComputeNodeConnection(
     uint8_t* data_ptr,
     uint32_t data_buffer_size_exp,
     fles::TimesliceComponentDescriptor* desc_ptr,
-    uint32_t desc_buffer_size_exp)
+    uint32_t desc_buffer_size_exp,
+    uint32_t timeslice_size,
+    uint32_t num_compute_nodes)
     : IBConnection(ec, connection_index, remote_connection_index, id),
       remote_info_(remote_info), data_ptr_(data_ptr),
       data_buffer_size_exp_(data_buffer_size_exp), desc_ptr_(desc_ptr),
-      desc_buffer_size_exp_(desc_buffer_size_exp) {
+      desc_buffer_size_exp_(desc_buffer_size_exp),
+      pointer_write_(remote_info.status.rkey != 0),
+      write_with_imm_(remote_info.write_with_imm), pull_(remote_info.pull),
+      timeslice_size_(timeslice_size), num_compute_nodes_(num_compute_nodes) {
   // send and receive only single StatusMessage struct
   qp_cap_.max_send_wr = 2; // one additional wr to avoid race (recv before
   // send completion)
   qp_cap_.max_send_sge = 1;
   qp_cap_.max_recv_wr = 1;
+  if (write_with_imm_) {
+    // each descriptor write with immediate data consumes a receive request
+    qp_cap_.max_recv_wr += UINT64_C(1) << desc_buffer_size_exp_;
+  }
   qp_cap_.max_recv_sge = 1;
+
+  if (pull_) {
+    // up to two descriptor and two content reads per component
+    qp_cap_.max_send_wr += 4 * pull_read_depth;
+    read_depth_ = pull_read_depth;
+    component_length_ = timeslice_size_ + remote_info_.overlap_size;
+    pull_descs_.resize(pull_read_depth * component_length_);
+  }
 }
 
 void ComputeNodeConnection::post_recv_status_message() {
@@ -36,7 +56,7 @@ void ComputeNodeConnection::post_recv_status_message() {
             << "[" << index_ << "] "
             << "POST RECEIVE status message";
 #endif
-  post_recv(&recv_wr);
+  post_control_recv(&recv_wr);
 }
 
 void ComputeNodeConnection::post_send_status_message() {
@@ -50,7 +70,7 @@ void ComputeNodeConnection::post_send_status_message() {
     throw InfinibandException("Max number of pending send requests exceeded");
   }
   ++pending_send_requests_;
-  post_send(&send_wr);
+  post_control_send(&send_wr);
 }
 
 void ComputeNodeConnection::post_send_final_status_message() {
@@ -71,14 +91,59 @@ void ComputeNodeConnection::setup(struct ibv_pd* pd) {
                         IBV_ACCESS_LOCAL_WRITE | IBV_ACCESS_REMOTE_WRITE);
   mr_desc_ = ibv_reg_mr(pd, desc_ptr_, desc_bytes,
                         IBV_ACCESS_LOCAL_WRITE | IBV_ACCESS_REMOTE_WRITE);
+  if ((mr_data_ == nullptr) || (mr_desc_ == nullptr)) {
+    throw InfinibandException("registration of memory region failed");
+  }
+
+  if (summary_ptr_ != nullptr) {
+    mr_summary_ = ibv_reg_mr(pd, summary_ptr_,
+                             (UINT64_C(1) << desc_buffer_size_exp_) *
+                                 sizeof(fles::ComponentSummary),
+                             IBV_ACCESS_LOCAL_WRITE | IBV_ACCESS_REMOTE_WRITE);
+    if (mr_summary_ == nullptr) {
+      throw InfinibandException("registration of memory region failed");
+    }
+  }
+
+  if (pull_) {
+    mr_pull_descs_ = ibv_reg_mr(
+        pd, pull_descs_.data(),
+        pull_descs_.size() * sizeof(fles::MicrosliceDescriptor),
+        IBV_ACCESS_LOCAL_WRITE);
+    if (mr_pull_descs_ == nullptr) {
+      throw InfinibandException("registration of memory region failed");
+    }
+  }
+
+  if (pointer_write_) {
+    mr_status_slot_ =
+        ibv_reg_mr(pd, &status_slot_, sizeof(status_slot_),
+                   IBV_ACCESS_LOCAL_WRITE | IBV_ACCESS_REMOTE_WRITE);
+    mr_status_source_ =
+        ibv_reg_mr(pd, &status_source_, sizeof(status_source_), 0);
+    if ((mr_status_slot_ == nullptr) || (mr_status_source_ == nullptr)) {
+      throw InfinibandException("registration of memory region failed");
+    }
+
+    status_sge.addr = reinterpret_cast<uintptr_t>(&status_source_);
+    status_sge.length = sizeof(status_source_);
+    status_sge.lkey = mr_status_source_->lkey;
+
+    status_wr.opcode = IBV_WR_RDMA_WRITE;
+    status_wr.send_flags = IBV_SEND_SIGNALED;
+    status_wr.sg_list = &status_sge;
+    status_wr.num_sge = 1;
+    status_wr.wr.rdma.remote_addr = remote_info_.status.addr;
+    status_wr.wr.rdma.rkey = remote_info_.status.rkey;
+  }
+
   mr_send_ = ibv_reg_mr(pd, &send_status_message_,
                         sizeof(ComputeNodeStatusMessage), 0);
   mr_recv_ =
       ibv_reg_mr(pd, &recv_status_message_, sizeof(InputChannelStatusMessage),
                  IBV_ACCESS_LOCAL_WRITE);
 
-  if ((mr_data_ == nullptr) || (mr_desc_ == nullptr) || (mr_recv_ == nullptr) ||
-      (mr_send_ == nullptr)) {
+  if ((mr_recv_ == nullptr) || (mr_send_ == nullptr)) {
     throw InfinibandException("registration of memory region failed");
   }
 
@@ -101,8 +166,17 @@ void ComputeNodeConnection::setup(struct ibv_pd* pd) {
   send_wr.sg_list = &send_sge;
   send_wr.num_sge = 1;
 
-  // post initial receive request
-  post_recv_status_message();
+  // post initial receive requests: one for the status message unless
+  // status slots are used, and one per descriptor buffer entry if
+  // descriptors are written with immediate data
+  if (!pointer_write_) {
+    post_recv_status_message();
+  }
+  if (write_with_imm_) {
+    for (uint64_t i = 0; i < (UINT64_C(1) << desc_buffer_size_exp_); ++i) {
+      post_recv(&recv_wr);
+    }
+  }
 }
 
 void ComputeNodeConnection::on_established(struct rdma_cm_event* event) {
@@ -115,6 +189,21 @@ void ComputeNodeConnection::on_established(struct rdma_cm_event* event) {
 void ComputeNodeConnection::on_disconnected(struct rdma_cm_event* event) {
   disconnect();
 
+  if (mr_pull_descs_ != nullptr) {
+    ibv_dereg_mr(mr_pull_descs_);
+    mr_pull_descs_ = nullptr;
+  }
+
+  if (mr_status_slot_ != nullptr) {
+    ibv_dereg_mr(mr_status_slot_);
+    mr_status_slot_ = nullptr;
+  }
+
+  if (mr_status_source_ != nullptr) {
+    ibv_dereg_mr(mr_status_source_);
+    mr_status_source_ = nullptr;
+  }
+
   if (mr_recv_ != nullptr) {
     ibv_dereg_mr(mr_recv_);
     mr_recv_ = nullptr;
@@ -125,6 +214,11 @@ void ComputeNodeConnection::on_disconnected(struct rdma_cm_event* event) {
     mr_send_ = nullptr;
   }
 
+  if (mr_summary_ != nullptr) {
+    ibv_dereg_mr(mr_summary_);
+    mr_summary_ = nullptr;
+  }
+
   if (mr_desc_ != nullptr) {
     ibv_dereg_mr(mr_desc_);
     mr_desc_ = nullptr;
@@ -163,14 +257,244 @@ void ComputeNodeConnection::on_complete_recv() {
             << "COMPLETE RECEIVE status message"
             << " (wp.desc=" << recv_status_message_.wp.desc << ")";
 #endif
-  cn_wp_ = recv_status_message_.wp;
+  if (pull_) {
+    announced_ = recv_status_message_.wp.desc;
+  } else if (!write_with_imm_) {
+    cn_wp_ = recv_status_message_.wp;
+  }
   post_recv_status_message();
-  send_status_message_.ack = cn_ack_;
+  send_status_message_.ack = status_ack();
   post_send_status_message();
 }
 
+bool ComputeNodeConnection::poll_status() {
+  InputChannelStatusMessage old_status = recv_status_message_;
+  StatusSlot<InputChannelStatusMessage> slot;
+  if (!pointer_write_ || send_status_message_.final ||
+      !status_slot_.poll(status_slot_seq_, slot)) {
+    return false;
+  }
+  status_slot_seq_ = slot.seq;
+  recv_status_message_ = slot.message;
+  if (recv_status_message_.final) {
+    L_(debug) << "[c" << remote_index_ << "] "
+              << "[" << index_ << "] "
+              << "received FINAL status slot update";
+    send_status_message_.final = true;
+    status_changed_ = true;
+    try_write_status();
+  }
+#if WITH_TRACE
+  L_(trace) << "[c" << remote_index_ << "] "
+            << "[" << index_ << "] "
+            << "status slot update"
+            << " (wp.desc=" << recv_status_message_.wp.desc << ")";
+#endif
+  if (pull_) {
+    // the reads are posted by try_pull()
+    announced_ = recv_status_message_.wp.desc;
+    return false;
+  }
+  if (write_with_imm_) {
+    return false;
+  }
+  cn_wp_ = recv_status_message_.wp;
+  return cn_wp_ != old_status.wp;
+}
+
+void ComputeNodeConnection::try_write_status() {
+  if (!pointer_write_ || pending_send_requests_ != 0 ||
+      status_source_.message.final) {
+    return;
+  }
+  ComputeNodeBufferPosition ack = status_ack();
+  // status flags are written immediately, acknowledgements may be held back
+  // (the pulled components are acknowledged by count, without positions)
+  if (!status_changed_ &&
+      (pull_ ? ack == send_status_message_.ack
+             : !ack_coalescer_.due(ack, send_status_message_.ack, cn_wp_,
+                                   buffer_size()))) {
+    return;
+  }
+  ack_coalescer_.on_sent(ack, send_status_message_.ack);
+  send_status_message_.ack = ack;
+  status_changed_ = false;
+  status_source_.set(status_source_.seq + 1, send_status_message_);
+
+#if WITH_TRACE
+  L_(trace) << "[c" << remote_index_ << "] "
+            << "[" << index_ << "] "
+            << "POST WRITE status slot"
+            << " (ack.desc=" << send_status_message_.ack.desc << ")";
+#endif
+  // the completion of the final write marks the connection as done
+  status_wr.wr_id =
+      (send_status_message_.final ? ID_SEND_FINALIZE : ID_WRITE_STATUS) |
+      (index_ << 8);
+  ++pending_send_requests_;
+  post_control_send(&status_wr);
+}
+
+void ComputeNodeConnection::on_complete_write_with_imm(uint32_t desc_pos) {
+  assert(desc_pos == static_cast<uint32_t>(cn_wp_.desc));
+  static_cast<void>(desc_pos);
+  const fles::TimesliceComponentDescriptor& written_ts =
+      desc_ptr_[cn_wp_.desc & ((UINT64_C(1) << desc_buffer_size_exp_) - 1)];
+  ++cn_wp_.desc;
+  cn_wp_.data = written_ts.offset + written_ts.size;
+  // the writes arrive on this connection even with a control connection
+  post_recv(&recv_wr);
+}
+
 void ComputeNodeConnection::on_complete_send() { pending_send_requests_--; }
 
+bool ComputeNodeConnection::try_pull() {
+  if (!pull_ || send_status_message_.final) {
+    return false;
+  }
+
+  // read the descriptors of the announced components into the staging
+  // buffer, one slot per component in flight
+  const uint64_t desc_bytes =
+      component_length_ * sizeof(fles::MicrosliceDescriptor);
+  while (pull_posted_ < announced_ && pulls_.size() < pull_read_depth) {
+    uint64_t timeslice = remote_index_ + pull_posted_ * num_compute_nodes_;
+    fles::MicrosliceDescriptor* descs =
+        &pull_descs_.at((pull_posted_ % pull_read_depth) * component_length_);
+    post_read(ID_READ_DESC | (index_ << 8), remote_info_.desc,
+              (UINT64_C(1) << remote_info_.desc_buffer_size_exp) *
+                  sizeof(fles::MicrosliceDescriptor),
+              (remote_info_.desc_start + timeslice * timeslice_size_) *
+                  sizeof(fles::MicrosliceDescriptor),
+              descs, mr_pull_descs_->lkey, desc_bytes);
+    pulls_.push_back(
+        {PullRead::State::Desc, timeslice, descs,
+         fles::TimesliceComponentDescriptor()});
+    ++pull_posted_;
+  }
+
+  post_pull_data();
+  return complete_pulls();
+}
+
+void ComputeNodeConnection::on_complete_pull_desc() {
+  // the reads of a queue pair complete in order
+  auto it = std::find_if(pulls_.begin(), pulls_.end(), [](const auto& p) {
+    return p.state == PullRead::State::Desc;
+  });
+  assert(it != pulls_.end());
+  it->state = PullRead::State::DescDone;
+  post_pull_data();
+}
+
+bool ComputeNodeConnection::on_complete_pull_data() {
+  auto it = std::find_if(pulls_.begin(), pulls_.end(), [](const auto& p) {
+    return p.state == PullRead::State::Data;
+  });
+  assert(it != pulls_.end());
+  it->state = PullRead::State::Done;
+  return complete_pulls();
+}
+
+void ComputeNodeConnection::post_read(uint64_t wr_id,
+                                      const BufferInfo& remote,
+                                      uint64_t remote_size,
+                                      uint64_t remote_offset,
+                                      void* local,
+                                      uint32_t lkey,
+                                      uint64_t length) {
+  assert(length > 0);
+  std::array<ibv_sge, 2> sge{};
+  std::array<ibv_send_wr, 2> wr{};
+
+  // a range wrapping around the end of the remote buffer takes two reads
+  uint64_t begin = remote_offset & (remote_size - 1);
+  uint64_t first = std::min(length, remote_size - begin);
+  int num_wr = (first < length) ? 2 : 1;
+  for (int i = 0; i < num_wr; ++i) {
+    sge[i].addr = reinterpret_cast<uintptr_t>(local) + (i == 0 ? 0 : first);
+    sge[i].length = static_cast<uint32_t>(i == 0 ? first : length - first);
+    sge[i].lkey = lkey;
+    wr[i].wr_id = wr_id;
+    wr[i].opcode = IBV_WR_RDMA_READ;
+    wr[i].sg_list = &sge[i];
+    wr[i].num_sge = 1;
+    wr[i].wr.rdma.remote_addr = remote.addr + (i == 0 ? begin : 0);
+    wr[i].wr.rdma.rkey = remote.rkey;
+  }
+  if (num_wr == 2) {
+    wr[0].next = &wr[1];
+  }
+  // only the last read completes the range
+  wr[num_wr - 1].send_flags = IBV_SEND_SIGNALED;
+  post_send(wr.data());
+}
+
+void ComputeNodeConnection::post_pull_data() {
+  const uint64_t data_size = UINT64_C(1) << data_buffer_size_exp_;
+  const uint64_t desc_size = UINT64_C(1) << desc_buffer_size_exp_;
+  const uint64_t desc_bytes =
+      component_length_ * sizeof(fles::MicrosliceDescriptor);
+
+  // allocate in component order, up to the first one still being read
+  for (auto& p : pulls_) {
+    if (p.state == PullRead::State::Data || p.state == PullRead::State::Done) {
+      continue;
+    }
+    if (p.state != PullRead::State::DescDone) {
+      break;
+    }
+    const fles::MicrosliceDescriptor& first = p.descs[0];
+    const fles::MicrosliceDescriptor& last = p.descs[component_length_ - 1];
+    uint64_t content_length = last.offset + last.size - first.offset;
+    uint64_t size = desc_bytes + content_length;
+    if (size > data_size) {
+      throw InfinibandException("component exceeds the timeslice buffer");
+    }
+
+    // skip the end of the buffer to avoid a fragmented component
+    uint64_t pos = pull_wp_.data & (data_size - 1);
+    uint64_t skip = (pos + size > data_size) ? data_size - pos : 0;
+    if (pull_wp_.data + skip + size - cn_ack_.data > data_size ||
+        pull_wp_.desc + 1 - cn_ack_.desc > desc_size) {
+      break;
+    }
+    uint64_t offset = pull_wp_.data + skip;
+    uint8_t* target = data_ptr_ + (offset & (data_size - 1));
+    std::memcpy(target, p.descs, desc_bytes);
+    p.tscdesc.ts_num = p.timeslice;
+    p.tscdesc.offset = offset;
+    p.tscdesc.size = size;
+    p.tscdesc.num_microslices = component_length_;
+    pull_wp_.data = offset + size;
+    ++pull_wp_.desc;
+
+    if (content_length == 0) {
+      p.state = PullRead::State::Done;
+      continue;
+    }
+    post_read(ID_READ_DATA | (index_ << 8), remote_info_.data,
+              UINT64_C(1) << remote_info_.data_buffer_size_exp, first.offset,
+              target + desc_bytes, mr_data_->lkey, content_length);
+    p.state = PullRead::State::Data;
+  }
+}
+
+bool ComputeNodeConnection::complete_pulls() {
+  const uint64_t desc_mask = (UINT64_C(1) << desc_buffer_size_exp_) - 1;
+  bool advanced = false;
+  while (!pulls_.empty() && pulls_.front().state == PullRead::State::Done) {
+    const fles::TimesliceComponentDescriptor& tscdesc = pulls_.front().tscdesc;
+    desc_ptr_[cn_wp_.desc & desc_mask] = tscdesc;
+    cn_wp_.data = tscdesc.offset + tscdesc.size;
+    ++cn_wp_.desc;
+    ++pulled_;
+    pulls_.pop_front();
+    advanced = true;
+  }
+  return advanced;
+}
+
 void ComputeNodeConnection::on_complete_send_finalize() { done_ = true; }
 
 std::unique_ptr<std::vector<uint8_t>>
@@ -188,6 +512,16 @@ ComputeNodeConnection::get_private_data() {
   cn_info->index = remote_index_;
   cn_info->data_buffer_size_exp = data_buffer_size_exp_;
   cn_info->desc_buffer_size_exp = desc_buffer_size_exp_;
+  cn_info->status = BufferInfo();
+  if (pointer_write_) {
+    cn_info->status.addr = reinterpret_cast<uintptr_t>(&status_slot_);
+    cn_info->status.rkey = mr_status_slot_->rkey;
+  }
+  cn_info->summary = BufferInfo();
+  if (mr_summary_ != nullptr) {
+    cn_info->summary.addr = reinterpret_cast<uintptr_t>(summary_ptr_);
+    cn_info->summary.rkey = mr_summary_->rkey;
+  }
 
   return private_data;
 }
@@ -1,18 +1,46 @@
 // Copyright 2012-2013 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include "AckCoalescer.hpp"
+#include "ComponentSummary.hpp"
 #include "ComputeNodeStatusMessage.hpp"
 #include "IBConnection.hpp"
 #include "InputChannelStatusMessage.hpp"
 #include "InputNodeInfo.hpp"
+#include "MicrosliceDescriptor.hpp"
+#include "StatusSlot.hpp"
 #include "TimesliceComponentDescriptor.hpp"
 #include <boost/format.hpp>
 #include <chrono>
+#include <deque>
+#include <vector>
 
 /// Compute node connection class.
 /** A ComputeNodeConnection object represents the endpoint of a single
     timeslice building connection from a compute node to an input
-    node. */
+    node.
+
+    The connection uses pointer write mode if the input node advertises a
+    status slot in its private data. If the input node writes descriptors
+    with immediate data, the write pointers are advanced from the receive
+    completions of these writes.
+
+    If the input node advertises its buffers for pull mode, the connection
+    reads the announced components by itself whenever the buffer has space:
+    first the microslice descriptors into a staging buffer, then the
+    content into the data buffer behind a copy of the descriptors. The
+    write pointers advance as the reads complete in order, and the number
+    of components read is acknowledged instead of the buffer position.
+
+    With a control connection (see ControlConnection), the status messages
+    and status slot writes are exchanged over it.
+
+    In pointer write mode, the acknowledgements can be coalesced (see
+    AckCoalescer), which saves status slot writes at high timeslice rates.
+
+    If a component summary buffer is set, it is advertised to the input
+    node, which then writes the summary of each component (see
+    fles::ComponentSummary) to the entry corresponding to its descriptor. */
 
 class ComputeNodeConnection : public IBConnection {
 public:
@@ -24,7 +52,9 @@ public:
                         uint8_t* data_ptr,
                         uint32_t data_buffer_size_exp,
                         fles::TimesliceComponentDescriptor* desc_ptr,
-                        uint32_t desc_buffer_size_exp);
+                        uint32_t desc_buffer_size_exp,
+                        uint32_t timeslice_size,
+                        uint32_t num_compute_nodes);
 
   ComputeNodeConnection(const ComputeNodeConnection&) = delete;
   void operator=(const ComputeNodeConnection&) = delete;
@@ -36,10 +66,19 @@ public:
 
   void post_send_final_status_message();
 
-  void request_abort() { send_status_message_.request_abort = true; }
+  void request_abort() {
+    send_status_message_.request_abort = true;
+    status_changed_ = true;
+  }
 
   [[nodiscard]] bool abort_flag() const { return recv_status_message_.abort; }
 
+  /// Set the component summary buffer to be written by the input node,
+  /// with one entry per descriptor buffer entry (not in pull mode).
+  void set_summary_buffer(fles::ComponentSummary* summary_ptr) {
+    summary_ptr_ = pull_ ? nullptr : summary_ptr;
+  }
+
   void setup(struct ibv_pd* pd) override;
 
   /// Connection handler function, called on successful connection.
@@ -54,10 +93,56 @@ public:
 
   void on_complete_recv();
 
+  /// Handle the receive completion of a descriptor write with immediate
+  /// data.
+  /**
+     \param desc_pos Descriptor position of the written timeslice component
+     (lower 32 bits)
+  */
+  void on_complete_write_with_imm(uint32_t desc_pos);
+
   void on_complete_send();
 
+  /// Post the reads of announced components the buffers have space for
+  /// (pull mode).
+  /**
+     \return true if the write pointers have advanced
+  */
+  bool try_pull();
+
+  /// Handle the completion of a descriptor read (pull mode).
+  void on_complete_pull_desc();
+
+  /// Handle the completion of a content read (pull mode).
+  /**
+     \return true if the write pointers have advanced
+  */
+  bool on_complete_pull_data();
+
   void on_complete_send_finalize();
 
+  /// Check the local status slot for an update written by the input node
+  /// (pointer write mode only).
+  /**
+     \return true if a new write pointer has been received
+  */
+  bool poll_status();
+
+  /// Write the current status to the input node's status slot if it has
+  /// changed and no previous write is pending (pointer write mode only).
+  void try_write_status();
+
+  /// Set the parameters of the acknowledgement coalescing (pointer write
+  /// mode only, default: every acknowledgement is written immediately).
+  void set_ack_coalescing(const AckCoalescer::Parameters& parameters) {
+    ack_coalescer_ = AckCoalescer(parameters);
+  }
+
+  /// The number of acknowledgement messages sent to the input node.
+  [[nodiscard]] uint64_t ack_messages() const {
+    return ack_coalescer_.messages();
+  }
+
   [[nodiscard]] const ComputeNodeBufferPosition& cn_wp() const {
     return cn_wp_;
   }
@@ -105,18 +190,59 @@ public:
   [[nodiscard]] BufferStatus buffer_status_data() const {
     return BufferStatus{std::chrono::system_clock::now(),
                         (UINT64_C(1) << data_buffer_size_exp_),
-                        send_status_message_.ack.data, cn_ack_.data,
+                        pull_ ? cn_ack_.data : send_status_message_.ack.data,
+                        cn_ack_.data,
                         cn_wp_.data};
   }
 
   [[nodiscard]] BufferStatus buffer_status_desc() const {
     return BufferStatus{std::chrono::system_clock::now(),
                         (UINT64_C(1) << desc_buffer_size_exp_),
-                        send_status_message_.ack.desc, cn_ack_.desc,
+                        pull_ ? cn_ack_.desc : send_status_message_.ack.desc,
+                        cn_ack_.desc,
                         cn_wp_.desc};
   }
 
 private:
+  /// A component being read from the input node (pull mode).
+  struct PullRead {
+    enum class State { Desc, DescDone, Data, Done };
+    State state;
+    /// The global timeslice index.
+    uint64_t timeslice;
+    /// Descriptors in the staging buffer.
+    fles::MicrosliceDescriptor* descs;
+    /// The component descriptor, valid from state Data.
+    fles::TimesliceComponentDescriptor tscdesc;
+  };
+
+  /// Post a read of a range of a remote ring buffer, split at its end.
+  void post_read(uint64_t wr_id,
+                 const BufferInfo& remote,
+                 uint64_t remote_size,
+                 uint64_t remote_offset,
+                 void* local,
+                 uint32_t lkey,
+                 uint64_t length);
+
+  /// Allocate buffer space and post the content reads of the components
+  /// whose descriptors have been read.
+  void post_pull_data();
+
+  /// Advance the write pointers over the components completely read.
+  bool complete_pulls();
+
+  /// The acknowledgement sent to the input node.
+  [[nodiscard]] ComputeNodeBufferPosition status_ack() const {
+    return pull_ ? ComputeNodeBufferPosition{0, pulled_} : cn_ack_;
+  }
+
+  /// The sizes of the data and descriptor buffers.
+  [[nodiscard]] ComputeNodeBufferPosition buffer_size() const {
+    return {UINT64_C(1) << data_buffer_size_exp_,
+            UINT64_C(1) << desc_buffer_size_exp_};
+  }
+
   ComputeNodeStatusMessage send_status_message_ = ComputeNodeStatusMessage();
   ComputeNodeBufferPosition cn_ack_ = ComputeNodeBufferPosition();
 
@@ -129,7 +255,7 @@ private:
   struct ibv_mr* mr_recv_ = nullptr;
 
   /// Information on remote end.
-  InputNodeInfo remote_info_{0};
+  InputNodeInfo remote_info_ = InputNodeInfo();
 
   uint8_t* data_ptr_ = nullptr;
   std::size_t data_buffer_size_exp_ = 0;
@@ -137,6 +263,10 @@ private:
   fles::TimesliceComponentDescriptor* desc_ptr_ = nullptr;
   std::size_t desc_buffer_size_exp_ = 0;
 
+  /// Component summary buffer, nullptr if not provided
+  fles::ComponentSummary* summary_ptr_ = nullptr;
+  struct ibv_mr* mr_summary_ = nullptr;
+
   /// InfiniBand receive work request
   ibv_recv_wr recv_wr = ibv_recv_wr();
 
@@ -150,4 +280,66 @@ private:
   ibv_sge send_sge = ibv_sge();
 
   uint32_t pending_send_requests_{0};
+
+  /// Flag, true if buffer positions are exchanged by RDMA writes.
+  bool pointer_write_ = false;
+
+  /// Flag, true if descriptors are written with immediate data.
+  bool write_with_imm_ = false;
+
+  /// Flag, true if a status flag has changed since the last slot write.
+  bool status_changed_ = false;
+
+  /// Status slot written by the input node (pointer write mode)
+  StatusSlot<InputChannelStatusMessage> status_slot_{};
+
+  /// Source buffer for writes to the input node's status slot
+  StatusSlot<ComputeNodeStatusMessage> status_source_{};
+
+  struct ibv_mr* mr_status_slot_ = nullptr;
+  struct ibv_mr* mr_status_source_ = nullptr;
+
+  /// Coalescing of the acknowledgements written to the status slot
+  AckCoalescer ack_coalescer_;
+
+  /// Sequence number of the last status read from the local slot
+  uint64_t status_slot_seq_ = 0;
+
+  /// Infiniband work request for status slot writes
+  ibv_send_wr status_wr = ibv_send_wr();
+
+  /// Scatter/gather list entry for status slot writes
+  ibv_sge status_sge = ibv_sge();
+
+  /// Flag, true if the components are read from the input node.
+  bool pull_ = false;
+
+  /// Number of microslices per component (pull mode).
+  uint64_t component_length_ = 0;
+
+  /// Timeslice size in microslices (pull mode).
+  uint32_t timeslice_size_;
+
+  /// Number of compute nodes (pull mode).
+  uint32_t num_compute_nodes_;
+
+  /// Number of components announced by the input node (pull mode).
+  uint64_t announced_ = 0;
+
+  /// Number of components whose reads have been posted (pull mode).
+  uint64_t pull_posted_ = 0;
+
+  /// Number of components read completely (pull mode).
+  uint64_t pulled_ = 0;
+
+  /// Buffer position after the last allocated component (pull mode).
+  ComputeNodeBufferPosition pull_wp_ = ComputeNodeBufferPosition();
+
+  /// Components being read, in order (pull mode).
+  std::deque<PullRead> pulls_;
+
+  /// Staging buffer for the descriptors of the components being read.
+  std::vector<fles::MicrosliceDescriptor> pull_descs_;
+
+  struct ibv_mr* mr_pull_descs_ = nullptr;
 };
@@ -17,6 +17,8 @@ struct ComputeNodeInfo {
   uint32_t index;
   uint32_t data_buffer_size_exp;
   uint32_t desc_buffer_size_exp;
+  BufferInfo status; ///< Status slot, rkey 0 if status messages are used
+  BufferInfo summary; ///< Component summary buffer, rkey 0 if not provided
 };
 
 #pragma pack()
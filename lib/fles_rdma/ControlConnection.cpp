@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "ControlConnection.hpp"
+#include "InputNodeInfo.hpp"
+
+ControlConnection::ControlConnection(struct rdma_event_channel* ec,
+                                     uint_fast16_t connection_index,
+                                     uint_fast16_t remote_connection_index,
+                                     struct rdma_cm_id* id)
+    : IBConnection(ec, connection_index, remote_connection_index, id),
+      accepted_(id != nullptr) {
+  // a status message or status slot write in flight in each direction,
+  // plus the final one
+  qp_cap_.max_send_wr = 4;
+  qp_cap_.max_send_sge = 1;
+  qp_cap_.max_recv_wr = 2;
+  qp_cap_.max_recv_sge = 1;
+}
+
+void ControlConnection::setup(struct ibv_pd* /* pd */) {}
+
+void ControlConnection::on_disconnected(struct rdma_cm_event* event) {
+  if (accepted_) {
+    disconnect();
+  }
+  IBConnection::on_disconnected(event);
+}
+
+std::unique_ptr<std::vector<uint8_t>> ControlConnection::get_private_data() {
+  if (accepted_) {
+    return IBConnection::get_private_data();
+  }
+  std::unique_ptr<std::vector<uint8_t>> private_data(
+      new std::vector<uint8_t>(sizeof(InputNodeInfo)));
+
+  auto* in_info = reinterpret_cast<InputNodeInfo*>(private_data->data());
+  in_info->index = remote_index_;
+  in_info->control = true;
+
+  return private_data;
+}
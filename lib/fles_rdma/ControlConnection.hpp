@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#pragma once
+
+#include "IBConnection.hpp"
+
+/// Control connection class.
+/** A ControlConnection object represents a separate connection between an
+    input node and a compute node that carries the status exchange of the
+    timeslice building connection between them (see
+    IBConnection::set_control_connection()). The status messages and status
+    slot writes then do not queue behind the component transfers of the
+    timeslice building connection, and the connection may be given a
+    distinct type of service.
+
+    The control connection is established before the timeslice building
+    connection, which posts its receive requests to it. All buffers are
+    registered by the timeslice building connection. */
+
+class ControlConnection : public IBConnection {
+public:
+  /// The ControlConnection constructor.
+  /**
+     \param id Connection manager ID of an accepted connection request,
+     nullptr on the connecting side
+  */
+  ControlConnection(struct rdma_event_channel* ec,
+                    uint_fast16_t connection_index,
+                    uint_fast16_t remote_connection_index,
+                    struct rdma_cm_id* id = nullptr);
+
+  ControlConnection(const ControlConnection&) = delete;
+  void operator=(const ControlConnection&) = delete;
+
+  void setup(struct ibv_pd* pd) override;
+
+  void on_disconnected(struct rdma_cm_event* event) override;
+
+  std::unique_ptr<std::vector<uint8_t>> get_private_data() override;
+
+private:
+  /// Flag, true if the connection has been accepted (compute node side).
+  bool accepted_;
+};
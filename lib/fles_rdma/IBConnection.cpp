@@ -79,6 +79,15 @@ void IBConnection::disconnect() {
   }
 }
 
+void IBConnection::set_type_of_service(uint8_t tos) {
+  int err = rdma_set_option(cm_id_, RDMA_OPTION_ID, RDMA_OPTION_ID_TOS, &tos,
+                            sizeof(tos));
+  if (err != 0) {
+    L_(fatal) << "rdma_set_option failed: " << strerror(errno);
+    throw InfinibandException("rdma_set_option failed");
+  }
+}
+
 void IBConnection::on_rejected(struct rdma_cm_event* /* event */) {
   L_(debug) << "[" << index_ << "] "
             << "connection rejected";
@@ -145,6 +154,7 @@ void IBConnection::accept_connect_request() {
 
   struct rdma_conn_param conn_param = rdma_conn_param();
   conn_param.responder_resources = 1;
+  conn_param.initiator_depth = read_depth_;
   conn_param.private_data = private_data->data();
   conn_param.private_data_len = static_cast<uint8_t>(private_data->size());
   int err = rdma_accept(cm_id_, &conn_param);
@@ -177,6 +187,7 @@ void IBConnection::on_route_resolved() {
 
   struct rdma_conn_param conn_param = rdma_conn_param();
   conn_param.initiator_depth = 1;
+  conn_param.responder_resources = read_depth_;
   conn_param.retry_count = 7;
   conn_param.private_data = private_data->data();
   conn_param.private_data_len = static_cast<uint8_t>(private_data->size());
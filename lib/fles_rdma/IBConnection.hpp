@@ -36,6 +36,21 @@ public:
 
   void disconnect();
 
+  /// Set the type of service of the connection (before connect()).
+  /** The type of service selects the traffic class (RoCE) or, through the
+      path query, the service level (InfiniBand) of the connection. Their
+      mapping to a link priority is a property of the fabric. */
+  void set_type_of_service(uint8_t tos);
+
+  /// Carry the status exchange over a separate connection to the same peer
+  /// (see ControlConnection).
+  void set_control_connection(IBConnection* control) { control_ = control; }
+
+  /// Check whether the status exchange uses a separate connection.
+  [[nodiscard]] bool has_control_connection() const {
+    return control_ != nullptr;
+  }
+
   virtual void on_rejected(struct rdma_cm_event* event);
 
   /// Connection handler function, called on successful connection.
@@ -99,6 +114,18 @@ protected:
   /// Post an InfiniBand RECV work request (WR) to the receive queue.
   void post_recv(struct ibv_recv_wr* wr);
 
+  /// Post a SEND work request (WR) of the status exchange, to the control
+  /// connection if there is one.
+  void post_control_send(struct ibv_send_wr* wr) {
+    (control_ != nullptr ? control_ : this)->post_send(wr);
+  }
+
+  /// Post a RECV work request (WR) of the status exchange, to the control
+  /// connection if there is one.
+  void post_control_recv(struct ibv_recv_wr* wr) {
+    (control_ != nullptr ? control_ : this)->post_recv(wr);
+  }
+
   /// Index of this connection in the local group of connections.
   uint_fast16_t index_;
 
@@ -111,6 +138,13 @@ protected:
   /// The queue pair capabilities.
   struct ibv_qp_cap qp_cap_ {};
 
+  /// Number of RDMA reads the accepting side may have outstanding (the
+  /// connecting side is the responder).
+  uint8_t read_depth_ = 0;
+
+  /// Connection carrying the status exchange, if separate.
+  IBConnection* control_ = nullptr;
+
 private:
   /// Low-level communication parameters.
   enum {
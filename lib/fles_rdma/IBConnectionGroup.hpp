@@ -2,29 +2,69 @@
 #pragma once
 
 #include "ConnectionGroupWorker.hpp"
+#include "ControlConnection.hpp"
 #include "InfinibandException.hpp"
+#include "ProgressMode.hpp"
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <cstring>
 #include <fcntl.h>
+#include <mutex>
+#include <optional>
+#include <poll.h>
 #include <rdma/rdma_cma.h>
 #include <sstream>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <thread>
+#include <unistd.h>
 #include <vector>
 
 /// InfiniBand connection group base class.
 /** An IBConnectionGroup object represents a group of InfiniBand
-    connections that use the same completion queue. */
+    connections distributed over one or more completion queues. Each
+    completion queue may be drained by its own thread.
+
+    Except in Busy progress mode, each completion queue has a completion
+    channel, and an idle thread blocks on it after the spin time (see
+    ProgressMode). The connection manager events are detected on a separate
+    thread, so the event loops do not poll the event channel. They are
+    still dispatched by poll_cm_events() on the thread of the event loop,
+    as the handlers modify the connection state. */
 
 template <typename CONNECTION>
 class IBConnectionGroup : public ConnectionGroupWorker {
 public:
-  /// The IBConnectionGroup default constructor.
-  IBConnectionGroup() {
+  /**
+   * \brief The IBConnectionGroup constructor.
+   *
+   * \param progress_mode         Event loop behavior when idle
+   * \param spin_time             Time to keep polling after activity
+   *                              (Adaptive mode only)
+   * \param num_completion_queues Number of completion queues
+   */
+  explicit IBConnectionGroup(
+      ProgressMode progress_mode = ProgressMode::Busy,
+      std::chrono::microseconds spin_time = std::chrono::microseconds(100),
+      std::size_t num_completion_queues = 1)
+      : progress_mode_(progress_mode),
+        spin_time_(progress_mode == ProgressMode::Blocking
+                       ? std::chrono::microseconds::zero()
+                       : spin_time),
+        cqs_(std::max<std::size_t>(num_completion_queues, 1)) {
     ec_ = rdma_create_event_channel();
     if (ec_ == nullptr) {
       throw InfinibandException("rdma_create_event_channel failed");
     }
     fcntl(ec_->fd, F_SETFL, O_NONBLOCK);
+    cm_stop_fd_ = eventfd(0, EFD_CLOEXEC);
+    if (cm_stop_fd_ < 0) {
+      throw InfinibandException("eventfd failed");
+    }
+    cm_thread_ = std::thread([this] { watch_cm_events(); });
   }
 
   IBConnectionGroup(const IBConnectionGroup&) = delete;
@@ -32,9 +72,22 @@ public:
 
   /// The IBConnectionGroup default destructor.
   ~IBConnectionGroup() override {
+    {
+      std::lock_guard<std::mutex> lock(cm_mutex_);
+      cm_stopped_ = true;
+    }
+    const uint64_t one = 1;
+    [[maybe_unused]] auto n = write(cm_stop_fd_, &one, sizeof(one));
+    cm_consumed_.notify_one();
+    cm_thread_.join();
+    close(cm_stop_fd_);
+
     for (auto& c : conn_) {
       c = nullptr;
     }
+    for (auto& c : control_conn_) {
+      c = nullptr;
+    }
 
     if (listen_id_ != nullptr) {
       int err = rdma_destroy_id(listen_id_);
@@ -44,13 +97,24 @@ public:
       listen_id_ = nullptr;
     }
 
-    if (cq_ != nullptr) {
-      int err = ibv_destroy_cq(cq_);
-      if (err != 0) {
-        L_(error) << "ibv_destroy_cq() failed";
+    for (auto& q : cqs_) {
+      if (q.cq != nullptr) {
+        int err = ibv_destroy_cq(q.cq);
+        if (err != 0) {
+          L_(error) << "ibv_destroy_cq() failed";
+        }
+      }
+      if (q.channel != nullptr) {
+        int err = ibv_destroy_comp_channel(q.channel);
+        if (err != 0) {
+          L_(error) << "ibv_destroy_comp_channel() failed";
+        }
+      }
+      if (q.epoll_fd >= 0) {
+        close(q.epoll_fd);
       }
-      cq_ = nullptr;
     }
+    cq_ = nullptr;
 
     if (pd_ != nullptr) {
       int err = ibv_dealloc_pd(pd_);
@@ -65,6 +129,7 @@ public:
 
   void accept(unsigned short port, unsigned int count) {
     conn_.resize(count);
+    control_conn_.resize(count);
 
     L_(debug) << "Setting up RDMA CM structures";
 
@@ -90,8 +155,9 @@ public:
       throw InfinibandException("RDMA bind_addr failed");
     }
 
-    // Listen for connection request on rdma id
-    err = rdma_listen(listen_id_, count);
+    // Listen for connection request on rdma id (including the control
+    // connections, if any)
+    err = rdma_listen(listen_id_, 2 * count);
     if (err != 0) {
       L_(error) << "rdma_listen() failed";
       throw InfinibandException("RDMA listen failed");
@@ -105,10 +171,109 @@ public:
     for (auto& c : conn_) {
       c->disconnect();
     }
+    for (auto& c : control_conn_) {
+      if (c != nullptr) {
+        c->disconnect();
+      }
+    }
   }
 
   /// The connection manager event handler.
   void poll_cm_events() {
+    if (!cm_pending_.load(std::memory_order_acquire)) {
+      return;
+    }
+    dispatch_cm_events();
+    {
+      std::lock_guard<std::mutex> lock(cm_mutex_);
+      cm_pending_ = false;
+    }
+    cm_consumed_.notify_one();
+  }
+
+  /// The InfiniBand completion notification handler.
+  int poll_completion() { return poll_completion(0); }
+
+  /// The completion notification handler for a given completion queue.
+  /** Blocks on the completion channel if the queue has been idle for the
+      spin time (except in Busy mode). Each queue may only be polled by a
+      single thread. */
+  int poll_completion(std::size_t q) {
+    CompletionQueue& queue = cqs_.at(q);
+    int ne_total = drain_completion_queue(queue.cq);
+    progress(queue, ne_total > 0);
+    return ne_total;
+  }
+
+  /// Retrieve the InfiniBand protection domain.
+  [[nodiscard]] struct ibv_pd* protection_domain() const { return pd_; }
+
+  /// Retrieve the (first) InfiniBand completion queue.
+  [[nodiscard]] struct ibv_cq* completion_queue() const { return cq_; }
+
+  /// Retrieve a given InfiniBand completion queue.
+  [[nodiscard]] struct ibv_cq* completion_queue(std::size_t q) const {
+    return cqs_.at(q).cq;
+  }
+
+  /// Retrieve the number of completion queues.
+  [[nodiscard]] std::size_t num_completion_queues() const {
+    return cqs_.size();
+  }
+
+  [[nodiscard]] size_t size() const { return conn_.size(); }
+
+  /// Retrieve the number of control connections (see ControlConnection).
+  [[nodiscard]] size_t num_control_connections() const {
+    return static_cast<size_t>(
+        std::count_if(control_conn_.begin(), control_conn_.end(),
+                      [](const auto& c) { return c != nullptr; }));
+  }
+
+  /// Retrieve the total number of bytes transmitted.
+  [[nodiscard]] uint64_t aggregate_bytes_sent() const {
+    return aggregate_bytes_sent_;
+  }
+
+  /// Retrieve the total number of SEND work requests.
+  [[nodiscard]] uint64_t aggregate_send_requests() const {
+    return aggregate_send_requests_;
+  }
+
+  /// Retrieve the total number of RECV work requests.
+  [[nodiscard]] uint64_t aggregate_recv_requests() const {
+    return aggregate_recv_requests_;
+  }
+
+  void summary() const {
+    double runtime = std::chrono::duration_cast<std::chrono::microseconds>(
+                         time_end_ - time_begin_)
+                         .count();
+    L_(info) << "summary: " << aggregate_send_requests_ << " SEND, "
+             << aggregate_recv_requests_ << " RECV requests";
+    double rate = static_cast<double>(aggregate_bytes_sent_) / runtime;
+    L_(info) << "summary: " << human_readable_count(aggregate_bytes_sent_)
+             << " sent in " << runtime / 1000000. << " s (" << rate << " MB/s)";
+    if (progress_mode_ != ProgressMode::Busy) {
+      std::chrono::steady_clock::duration spin{};
+      std::chrono::steady_clock::duration sleep{};
+      uint64_t sleep_count = 0;
+      for (const auto& q : cqs_) {
+        spin += q.spin_time;
+        sleep += q.sleep_time;
+        sleep_count += q.sleep_count;
+      }
+      L_(info) << "summary: idle time "
+               << std::chrono::duration<double>(spin).count()
+               << " s spinning, "
+               << std::chrono::duration<double>(sleep).count()
+               << " s sleeping in " << sleep_count << " waits";
+    }
+  }
+
+protected:
+  /// Dispatch all pending connection manager events.
+  void dispatch_cm_events() {
     int err;
     struct rdma_cm_event* event;
     struct rdma_cm_event event_copy {};
@@ -142,8 +307,8 @@ public:
     }
   }
 
-  /// The InfiniBand completion notification handler.
-  int poll_completion() {
+  /// Handle the completions of a given completion queue.
+  int drain_completion_queue(struct ibv_cq* cq) {
     constexpr int ne_max = 10;
 
     std::array<ibv_wc, ne_max> wc{};
@@ -151,7 +316,7 @@ public:
     int ne_total = 0;
 
     while (ne_total < 1000 &&
-           ((ne = ibv_poll_cq(cq_, ne_max, wc.data())) != 0)) {
+           ((ne = ibv_poll_cq(cq, ne_max, wc.data())) != 0)) {
       if (ne < 0) {
         throw InfinibandException("ibv_poll_cq failed");
       }
@@ -174,55 +339,26 @@ public:
     return ne_total;
   }
 
-  /// Retrieve the InfiniBand protection domain.
-  [[nodiscard]] struct ibv_pd* protection_domain() const { return pd_; }
-
-  /// Retrieve the InfiniBand completion queue.
-  [[nodiscard]] struct ibv_cq* completion_queue() const { return cq_; }
-
-  [[nodiscard]] size_t size() const { return conn_.size(); }
-
-  /// Retrieve the total number of bytes transmitted.
-  [[nodiscard]] uint64_t aggregate_bytes_sent() const {
-    return aggregate_bytes_sent_;
-  }
-
-  /// Retrieve the total number of SEND work requests.
-  [[nodiscard]] uint64_t aggregate_send_requests() const {
-    return aggregate_send_requests_;
-  }
-
-  /// Retrieve the total number of RECV work requests.
-  [[nodiscard]] uint64_t aggregate_recv_requests() const {
-    return aggregate_recv_requests_;
+  /// Check whether a connection is a control connection.
+  [[nodiscard]] bool is_control_connection(const IBConnection* conn) const {
+    return conn->index() < control_conn_.size() &&
+           control_conn_[conn->index()].get() == conn;
   }
 
-  void summary() const {
-    double runtime = std::chrono::duration_cast<std::chrono::microseconds>(
-                         time_end_ - time_begin_)
-                         .count();
-    L_(info) << "summary: " << aggregate_send_requests_ << " SEND, "
-             << aggregate_recv_requests_ << " RECV requests";
-    double rate = static_cast<double>(aggregate_bytes_sent_) / runtime;
-    L_(info) << "summary: " << human_readable_count(aggregate_bytes_sent_)
-             << " sent in " << runtime / 1000000. << " s (" << rate << " MB/s)";
-  }
-
-protected:
   /// Handle RDMA_CM_EVENT_ADDR_RESOLVED event.
   virtual void on_addr_resolved(struct rdma_cm_id* id) {
     if (pd_ == nullptr) {
       init_context(id->verbs);
     }
 
-    auto* conn = static_cast<CONNECTION*>(id->context);
+    auto* conn = static_cast<IBConnection*>(id->context);
 
     conn->on_addr_resolved(pd_, cq_);
   }
 
   /// Handle RDMA_CM_EVENT_ROUTE_RESOLVED event.
   virtual void on_route_resolved(struct rdma_cm_id* id) {
-    auto* conn = static_cast<CONNECTION*>(id->context);
+    auto* conn = static_cast<IBConnection*>(id->context);
 
     conn->on_route_resolved();
   }
@@ -232,7 +368,7 @@ protected:
 
   /// Handle RDMA_CM_EVENT_ESTABLISHED event.
   virtual void on_established(struct rdma_cm_event* event) {
-    auto* conn = static_cast<CONNECTION*>(event->id->context);
+    auto* conn = static_cast<IBConnection*>(event->id->context);
 
     conn->on_established(event);
     ++connected_;
@@ -243,7 +379,7 @@ protected:
 
   /// Handle RDMA_CM_EVENT_DISCONNECTED event.
   virtual void on_disconnected(struct rdma_cm_event* event) {
-    auto* conn = static_cast<CONNECTION*>(event->id->context);
+    auto* conn = static_cast<IBConnection*>(event->id->context);
 
     aggregate_bytes_sent_ += conn->total_bytes_sent();
     aggregate_send_requests_ += conn->total_send_requests();
@@ -256,7 +392,7 @@ protected:
 
   /// Handle RDMA_CM_EVENT_TIMEWAIT_EXIT event.
   virtual void on_timewait_exit(struct rdma_cm_event* event) {
-    auto* conn = static_cast<CONNECTION*>(event->id->context);
+    auto* conn = static_cast<IBConnection*>(event->id->context);
 
     conn->on_timewait_exit(event);
     --timewait_;
@@ -273,14 +409,30 @@ protected:
       throw InfinibandException("ibv_alloc_pd failed");
     }
 
-    cq_ = ibv_create_cq(context, num_cqe_, nullptr, nullptr, 0);
-    if (cq_ == nullptr) {
-      throw InfinibandException("ibv_create_cq failed");
-    }
-
-    if (ibv_req_notify_cq(cq_, 0) != 0) {
-      throw InfinibandException("ibv_req_notify_cq failed");
+    for (std::size_t i = 0; i < cqs_.size(); ++i) {
+      CompletionQueue& q = cqs_[i];
+      if (progress_mode_ != ProgressMode::Busy) {
+        q.channel = ibv_create_comp_channel(context);
+        if (q.channel == nullptr) {
+          throw InfinibandException("ibv_create_comp_channel failed");
+        }
+        fcntl(q.channel->fd, F_SETFL, O_NONBLOCK);
+        q.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (q.epoll_fd < 0) {
+          throw InfinibandException("epoll_create1 failed");
+        }
+        add_wait_fd(q, q.channel->fd);
+        if (i == 0) {
+          // the first queue's thread runs the connection manager events
+          add_wait_fd(q, ec_->fd);
+        }
+      }
+      q.cq = ibv_create_cq(context, num_cqe_, nullptr, q.channel, 0);
+      if (q.cq == nullptr) {
+        throw InfinibandException("ibv_create_cq failed");
+      }
     }
+    cq_ = cqs_.front().cq;
   }
 
   const uint32_t num_cqe_ = 1000000;
@@ -288,12 +440,15 @@ protected:
   /// InfiniBand protection domain.
   struct ibv_pd* pd_ = nullptr;
 
-  /// InfiniBand completion queue
+  /// InfiniBand completion queue (the first one)
   struct ibv_cq* cq_ = nullptr;
 
   /// Vector of associated connection objects.
   std::vector<std::unique_ptr<CONNECTION>> conn_;
 
+  /// Control connections of the connections with the same index, if any.
+  std::vector<std::unique_ptr<ControlConnection>> control_conn_;
+
   /// Number of established connections
   unsigned int connected_ = 0;
 
@@ -301,7 +456,7 @@ protected:
   unsigned int timewait_ = 0;
 
   /// Number of connections in the done state.
-  unsigned int connections_done_ = 0;
+  std::atomic<unsigned int> connections_done_{0};
 
   /// Flag causing termination of completion handler.
   bool all_done_ = false;
@@ -316,6 +471,131 @@ protected:
   Scheduler scheduler_;
 
 private:
+  /// A completion queue and the idle state of the thread polling it.
+  struct CompletionQueue {
+    struct ibv_cq* cq = nullptr;
+
+    /// Completion channel (except in Busy mode)
+    struct ibv_comp_channel* channel = nullptr;
+
+    /// epoll instance watching the completion channel
+    int epoll_fd = -1;
+
+    /// Whether a completion notification has been requested
+    bool armed = false;
+
+    /// Begin of the current idle period, if any
+    std::optional<std::chrono::steady_clock::time_point> idle_begin;
+
+    /// Flag indicating that the spin time of the idle period has elapsed
+    bool sleeping = false;
+
+    /// Idle time statistics
+    std::chrono::steady_clock::duration spin_time{};
+    std::chrono::steady_clock::duration sleep_time{};
+    uint64_t sleep_count = 0;
+  };
+
+  /// Add a file descriptor to the epoll instance of a completion queue.
+  static void add_wait_fd(CompletionQueue& q, int fd) {
+    struct epoll_event event {};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(q.epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+      throw InfinibandException("epoll_ctl failed");
+    }
+  }
+
+  /// Account idle time and block once the spin time has elapsed.
+  void progress(CompletionQueue& q, bool active) {
+    const auto now = std::chrono::steady_clock::now();
+    if (active) {
+      if (q.idle_begin) {
+        q.spin_time += now - *q.idle_begin;
+        q.idle_begin.reset();
+      }
+      q.sleeping = false;
+      return;
+    }
+    if (!q.idle_begin) {
+      q.idle_begin = now;
+    }
+    if (progress_mode_ == ProgressMode::Busy ||
+        (!q.sleeping && now - *q.idle_begin < spin_time_)) {
+      return;
+    }
+    if (!q.armed) {
+      // completions arriving from now on are signaled, the queue is polled
+      // once more before blocking
+      if (ibv_req_notify_cq(q.cq, 0) != 0) {
+        throw InfinibandException("ibv_req_notify_cq failed");
+      }
+      q.armed = true;
+      return;
+    }
+
+    q.spin_time += now - *q.idle_begin;
+    q.sleeping = true;
+    wait_for_events(q);
+    q.idle_begin = std::chrono::steady_clock::now();
+    q.sleep_time += *q.idle_begin - now;
+  }
+
+  /// Block until the completion channel or the connection manager event
+  /// channel is signaled or max_sleep_time_ has elapsed.
+  /** The timeout bounds the delay of scheduled events and of work that is
+      not signaled through the completion queue, e.g., new data in the input
+      buffer. */
+  void wait_for_events(CompletionQueue& q) {
+    ++q.sleep_count;
+    std::array<struct epoll_event, 2> events{};
+    const int timeout =
+        static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                             max_sleep_time_)
+                             .count());
+    if (epoll_wait(q.epoll_fd, events.data(), static_cast<int>(events.size()),
+                   timeout) < 0 &&
+        errno != EINTR) {
+      throw InfinibandException("epoll_wait failed");
+    }
+    struct ibv_cq* cq = nullptr;
+    void* cq_context = nullptr;
+    unsigned int num_events = 0;
+    while (ibv_get_cq_event(q.channel, &cq, &cq_context) == 0) {
+      ++num_events;
+      q.armed = false;
+    }
+    if (num_events != 0) {
+      ibv_ack_cq_events(q.cq, num_events);
+    }
+  }
+
+  /// The connection manager event detection thread.
+  /** Flags pending events for poll_cm_events() and waits until they have
+      been dispatched. */
+  void watch_cm_events() {
+    std::array<struct pollfd, 2> fds{
+        {{ec_->fd, POLLIN, 0}, {cm_stop_fd_, POLLIN, 0}}};
+    while (true) {
+      if (poll(fds.data(), fds.size(), -1) < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        L_(error) << "poll() failed: " << strerror(errno);
+        return;
+      }
+      std::unique_lock<std::mutex> lock(cm_mutex_);
+      if (cm_stopped_) {
+        return;
+      }
+      cm_pending_ = true;
+      cm_consumed_.wait(lock, [this] { return !cm_pending_ || cm_stopped_; });
+      if (cm_stopped_) {
+        return;
+      }
+    }
+  }
+
   /// Connection manager event dispatcher. Called by the CM event loop.
   void on_cm_event(struct rdma_cm_event* event) {
     L_(trace) << rdma_event_str(event->event);
@@ -374,4 +654,24 @@ private:
 
   /// Total number of RECV work requests.
   uint64_t aggregate_recv_requests_ = 0;
+
+  /// Strategy of the event loops when idle
+  const ProgressMode progress_mode_;
+
+  /// Time to keep polling after the last activity before blocking
+  const std::chrono::microseconds spin_time_;
+
+  /// Maximum duration of a single blocking wait
+  const std::chrono::milliseconds max_sleep_time_{1};
+
+  /// The completion queues
+  std::vector<CompletionQueue> cqs_;
+
+  /// Connection manager event detection thread and its synchronization
+  std::thread cm_thread_;
+  int cm_stop_fd_ = -1;
+  std::atomic<bool> cm_pending_{false};
+  bool cm_stopped_ = false;
+  std::mutex cm_mutex_;
+  std::condition_variable cm_consumed_;
 };
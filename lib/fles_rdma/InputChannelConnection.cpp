@@ -4,9 +4,9 @@
 #include "InputNodeInfo.hpp"
 #include "MicrosliceDescriptor.hpp"
 #include "RequestIdentifier.hpp"
-#include "TimesliceComponentDescriptor.hpp"
-#include <array>
+#include <arpa/inet.h>
 #include <cassert>
+#include <cstddef>
 #include <cstring>
 
 #define WITH_TRACE 0
@@ -17,10 +17,21 @@ InputChannelConnection::InputChannelConnection(
     uint_fast16_t remote_connection_index,
     unsigned int max_send_wr,
     unsigned int max_pending_write_requests,
+    bool pointer_write,
+    bool write_with_imm,
+    bool pull,
     struct rdma_cm_id* id)
     : IBConnection(ec, connection_index, remote_connection_index, id),
-      max_pending_write_requests_(max_pending_write_requests) {
+      pointer_write_(pointer_write), write_with_imm_(write_with_imm),
+      pull_(pull), max_pending_write_requests_(max_pending_write_requests) {
   assert(max_pending_write_requests_ > 0);
+  static_assert(sizeof(InputNodeInfo) <= 56,
+                "private data exceeds the RDMA CM connect limit");
+
+  if (pull_) {
+    // respond to the reads of the compute node
+    read_depth_ = pull_read_depth;
+  }
 
   qp_cap_.max_send_wr = max_send_wr; // typical hca maximum: 16k
   qp_cap_.max_send_sge = 4; // max. two chunks each for descriptors and data
@@ -29,7 +40,8 @@ InputChannelConnection::InputChannelConnection(
       1; // receive only single ComputeNodeStatusMessage struct
   qp_cap_.max_recv_sge = 1;
 
-  qp_cap_.max_inline_data = sizeof(fles::TimesliceComponentDescriptor);
+  // component descriptors and summaries are written inline
+  qp_cap_.max_inline_data = sizeof(fles::ComponentSummary);
 }
 
 bool InputChannelConnection::check_for_buffer_space(uint64_t data_size,
@@ -49,14 +61,63 @@ bool InputChannelConnection::check_for_buffer_space(uint64_t data_size,
   return (data_size <= data_avail && desc_size <= desc_avail);
 }
 
-void InputChannelConnection::send_data(struct ibv_sge* sge,
-                                       int num_sge,
+void InputChannelConnection::init_send_slots() {
+  for (auto& slot : send_slots_) {
+    slot.wr_data.wr_id = ID_WRITE_DATA;
+    slot.wr_data.opcode = IBV_WR_RDMA_WRITE;
+    slot.wr_data.sg_list = slot.sge.data();
+    slot.wr_data.wr.rdma.rkey = remote_info_.data.rkey;
+
+    slot.wr_wrap.wr_id = ID_WRITE_DATA_WRAP;
+    slot.wr_wrap.opcode = IBV_WR_RDMA_WRITE;
+    slot.wr_wrap.sg_list = slot.sge_wrap.data();
+    slot.wr_wrap.wr.rdma.rkey = remote_info_.data.rkey;
+    slot.wr_wrap.wr.rdma.remote_addr =
+        static_cast<uintptr_t>(remote_info_.data.addr);
+    slot.wr_wrap.next = &slot.wr_desc;
+
+    slot.sge_summary.addr = reinterpret_cast<uintptr_t>(&slot.summary);
+    slot.sge_summary.length = sizeof(slot.summary);
+    slot.sge_summary.lkey = 0;
+
+    slot.wr_summary.wr_id = ID_WRITE_SUMMARY;
+    slot.wr_summary.opcode = IBV_WR_RDMA_WRITE;
+    slot.wr_summary.send_flags = IBV_SEND_INLINE;
+    slot.wr_summary.sg_list = &slot.sge_summary;
+    slot.wr_summary.num_sge = 1;
+    slot.wr_summary.wr.rdma.rkey = remote_info_.summary.rkey;
+    slot.wr_summary.next = &slot.wr_desc;
+
+    slot.sge_desc.addr = reinterpret_cast<uintptr_t>(&slot.tscdesc);
+    slot.sge_desc.length = sizeof(slot.tscdesc);
+    slot.sge_desc.lkey = 0;
+
+    if (write_with_imm_) {
+      // the receive completion on the compute node implies the placement of
+      // all preceding writes, so no fence is needed
+      slot.wr_desc.opcode = IBV_WR_RDMA_WRITE_WITH_IMM;
+      slot.wr_desc.send_flags = IBV_SEND_INLINE | IBV_SEND_SIGNALED;
+    } else {
+      slot.wr_desc.opcode = IBV_WR_RDMA_WRITE;
+      slot.wr_desc.send_flags =
+          IBV_SEND_INLINE | IBV_SEND_FENCE | IBV_SEND_SIGNALED;
+    }
+    slot.wr_desc.sg_list = &slot.sge_desc;
+    slot.wr_desc.num_sge = 1;
+    slot.wr_desc.wr.rdma.rkey = remote_info_.desc.rkey;
+  }
+}
+
+void InputChannelConnection::send_data(int num_sge,
                                        uint64_t timeslice,
                                        uint64_t desc_length,
                                        uint64_t data_length,
-                                       uint64_t skip) {
+                                       uint64_t skip,
+                                       const fles::ComponentSummary* summary) {
+  SendSlot& slot = send_slots_[queued_sends_];
+  ibv_sge* sge = slot.sge.data();
+  ibv_sge* sge2 = slot.sge_wrap.data();
   int num_sge2 = 0;
-  std::array<ibv_sge, 4> sge2{};
 
   uint64_t cn_wp_data = cn_wp_.data;
   cn_wp_data += skip;
@@ -92,50 +153,44 @@ void InputChannelConnection::send_data(struct ibv_sge* sge,
   }
   num_sge -= num_sge_cut;
 
-  struct ibv_send_wr send_wr_ts {};
-  struct ibv_send_wr send_wr_tswrap {};
-  struct ibv_send_wr send_wr_tscdesc {};
-  send_wr_ts.wr_id = ID_WRITE_DATA;
-  send_wr_ts.opcode = IBV_WR_RDMA_WRITE;
-  send_wr_ts.sg_list = sge;
-  send_wr_ts.num_sge = num_sge;
-  send_wr_ts.wr.rdma.rkey = remote_info_.data.rkey;
-  send_wr_ts.wr.rdma.remote_addr = static_cast<uintptr_t>(
+  slot.wr_data.num_sge = num_sge;
+  // a small component is copied into the work request
+  const uint64_t total_length =
+      data_length + desc_length * sizeof(fles::MicrosliceDescriptor);
+  const bool inline_data = num_sge2 == 0 && total_length <= inline_data_size_;
+  slot.wr_data.send_flags = inline_data ? IBV_SEND_INLINE : 0;
+  slot.wr_data.wr.rdma.remote_addr = static_cast<uintptr_t>(
       remote_info_.data.addr + (cn_wp_data & cn_data_buffer_mask));
 
+  // the component summary (if any) is written just before the descriptor
+  ibv_send_wr* wr_after_data = &slot.wr_desc;
+  if (summary != nullptr) {
+    slot.summary = *summary;
+    slot.wr_summary.wr.rdma.remote_addr = static_cast<uintptr_t>(
+        remote_info_.summary.addr + (cn_wp_.desc & cn_desc_buffer_mask) *
+                                        sizeof(fles::ComponentSummary));
+    wr_after_data = &slot.wr_summary;
+  }
+
   if (num_sge2 != 0) {
-    send_wr_tswrap.wr_id = ID_WRITE_DATA_WRAP;
-    send_wr_tswrap.opcode = IBV_WR_RDMA_WRITE;
-    send_wr_tswrap.sg_list = sge2.data();
-    send_wr_tswrap.num_sge = num_sge2;
-    send_wr_tswrap.wr.rdma.rkey = remote_info_.data.rkey;
-    send_wr_tswrap.wr.rdma.remote_addr =
-        static_cast<uintptr_t>(remote_info_.data.addr);
-    send_wr_ts.next = &send_wr_tswrap;
-    send_wr_tswrap.next = &send_wr_tscdesc;
+    slot.wr_wrap.num_sge = num_sge2;
+    slot.wr_wrap.next = wr_after_data;
+    slot.wr_data.next = &slot.wr_wrap;
   } else {
-    send_wr_ts.next = &send_wr_tscdesc;
+    slot.wr_data.next = wr_after_data;
   }
 
   // timeslice component descriptor
-  fles::TimesliceComponentDescriptor tscdesc{};
-  tscdesc.ts_num = timeslice;
-  tscdesc.offset = cn_wp_data;
-  tscdesc.size = data_length + desc_length * sizeof(fles::MicrosliceDescriptor);
-  tscdesc.num_microslices = desc_length;
-  struct ibv_sge sge3 {};
-  sge3.addr = reinterpret_cast<uintptr_t>(&tscdesc);
-  sge3.length = sizeof(tscdesc);
-  sge3.lkey = 0;
-
-  send_wr_tscdesc.wr_id = ID_WRITE_DESC | (timeslice << 24) | (index_ << 8);
-  send_wr_tscdesc.opcode = IBV_WR_RDMA_WRITE;
-  send_wr_tscdesc.send_flags =
-      IBV_SEND_INLINE | IBV_SEND_FENCE | IBV_SEND_SIGNALED;
-  send_wr_tscdesc.sg_list = &sge3;
-  send_wr_tscdesc.num_sge = 1;
-  send_wr_tscdesc.wr.rdma.rkey = remote_info_.desc.rkey;
-  send_wr_tscdesc.wr.rdma.remote_addr = static_cast<uintptr_t>(
+  slot.tscdesc.ts_num = timeslice;
+  slot.tscdesc.offset = cn_wp_data;
+  slot.tscdesc.size = total_length;
+  slot.tscdesc.num_microslices = desc_length;
+
+  slot.wr_desc.wr_id = ID_WRITE_DESC | (timeslice << 24) | (index_ << 8);
+  if (write_with_imm_) {
+    slot.wr_desc.imm_data = htonl(static_cast<uint32_t>(cn_wp_.desc));
+  }
+  slot.wr_desc.wr.rdma.remote_addr = static_cast<uintptr_t>(
       remote_info_.desc.addr + (cn_wp_.desc & cn_desc_buffer_mask) *
                                    sizeof(fles::TimesliceComponentDescriptor));
 
@@ -145,10 +200,30 @@ void InputChannelConnection::send_data(struct ibv_sge* sge,
             << "POST SEND data (timeslice " << timeslice << ")";
 #endif
 
-  // send everything
+  if (has_control_connection() && !pull_) {
+    write_ends_.push_back(
+        {slot.tscdesc.offset + slot.tscdesc.size, cn_wp_.desc + 1});
+  }
+
   assert(pending_write_requests_ < max_pending_write_requests_);
   ++pending_write_requests_;
-  post_send(&send_wr_ts);
+  if (++queued_sends_ == max_send_batch) {
+    flush_send_data();
+  }
+}
+
+void InputChannelConnection::flush_send_data() {
+  if (queued_sends_ == 0) {
+    return;
+  }
+  for (std::size_t i = 0; i + 1 < queued_sends_; ++i) {
+    send_slots_[i].wr_desc.next = &send_slots_[i + 1].wr_data;
+  }
+  send_slots_[queued_sends_ - 1].wr_desc.next = nullptr;
+  queued_sends_ = 0;
+
+  // send everything
+  post_send(&send_slots_[0].wr_data);
 }
 
 bool InputChannelConnection::write_request_available() const {
@@ -161,43 +236,100 @@ void InputChannelConnection::inc_write_pointers(uint64_t data_size,
   cn_wp_.desc += desc_size;
 }
 
+void InputChannelConnection::set_pull_source(BufferInfo data,
+                                             BufferInfo desc,
+                                             uint8_t data_buffer_size_exp,
+                                             uint8_t desc_buffer_size_exp,
+                                             uint64_t desc_start,
+                                             uint32_t overlap_size) {
+  pull_source_.data = data;
+  pull_source_.desc = desc;
+  pull_source_.data_buffer_size_exp = data_buffer_size_exp;
+  pull_source_.desc_buffer_size_exp = desc_buffer_size_exp;
+  pull_source_.desc_start = desc_start;
+  pull_source_.overlap_size = overlap_size;
+}
+
 bool InputChannelConnection::try_sync_buffer_positions() {
+  // the announced write pointer must not overtake the data
+  flush_send_data();
+  if (pointer_write_) {
+    return try_write_status();
+  }
   if (our_turn_) {
     our_turn_ = false;
-    send_status_message_.wp = cn_wp_;
+    send_status_message_.wp = announced_wp();
     post_send_status_message();
     return true;
   }
   return false;
 }
 
-uint64_t InputChannelConnection::skip_required(uint64_t data_size) const {
+double InputChannelConnection::data_fill() const {
+  return static_cast<double>(cn_wp_.data - cn_ack_.data) /
+         static_cast<double>(UINT64_C(1) << remote_info_.data_buffer_size_exp);
+}
+
+double InputChannelConnection::desc_fill() const {
+  return static_cast<double>(cn_wp_.desc - cn_ack_.desc) /
+         static_cast<double>(UINT64_C(1) << remote_info_.desc_buffer_size_exp);
+}
+
+uint64_t InputChannelConnection::skip_required(uint64_t data_size,
+                                               uint64_t content_start,
+                                               uint64_t content_phase,
+                                               uint64_t alignment) const {
   uint64_t databuf_size = UINT64_C(1) << remote_info_.data_buffer_size_exp;
   uint64_t databuf_wp = cn_wp_.data & (databuf_size - 1);
-  if (databuf_wp + data_size <= databuf_size) {
-    return 0;
+  auto padding = [&](uint64_t pos) {
+    return (content_phase - pos - content_start) & (alignment - 1);
+  };
+  uint64_t skip = padding(databuf_wp);
+  if (databuf_wp + skip + data_size <= databuf_size) {
+    return skip;
   }
-  return databuf_size - databuf_wp;
+  return databuf_size - databuf_wp + padding(0);
 }
 
 void InputChannelConnection::finalize(bool abort) {
+  flush_send_data();
   finalize_ = true;
   abort_ = abort;
+  if (pointer_write_) {
+    try_write_status();
+    return;
+  }
   if (our_turn_) {
     our_turn_ = false;
     if (cn_wp_ == cn_ack_ || abort_) {
       send_status_message_.final = true;
       send_status_message_.abort = abort_;
     } else {
-      send_status_message_.wp = cn_wp_;
+      send_status_message_.wp = announced_wp();
     }
     post_send_status_message();
   }
 }
 
-void InputChannelConnection::on_complete_write() { pending_write_requests_--; }
+void InputChannelConnection::on_complete_write() {
+  pending_write_requests_--;
+  if (!write_ends_.empty()) {
+    written_wp_ = write_ends_.front();
+    write_ends_.pop_front();
+  }
+}
+
+ComputeNodeBufferPosition InputChannelConnection::announced_wp() const {
+  // the writes and the status exchange of a control connection are not
+  // ordered, so only the completely written components are announced
+  if (has_control_connection() && !pull_) {
+    return written_wp_;
+  }
+  return cn_wp_;
+}
 
 void InputChannelConnection::on_complete_recv() {
+  status_latency_ = std::chrono::steady_clock::now() - status_posted_;
   if (recv_status_message_.final) {
     done_ = true;
     return;
@@ -211,7 +343,7 @@ void InputChannelConnection::on_complete_recv() {
   cn_ack_ = recv_status_message_.ack;
   post_recv_status_message();
 
-  if (cn_wp_ == send_status_message_.wp && finalize_) {
+  if (announced_wp() == send_status_message_.wp && finalize_) {
     if (cn_wp_ == cn_ack_ || abort_) {
       send_status_message_.final = true;
       send_status_message_.abort = abort_;
@@ -222,7 +354,83 @@ void InputChannelConnection::on_complete_recv() {
   }
 }
 
+bool InputChannelConnection::poll_status() {
+  StatusSlot<ComputeNodeStatusMessage> slot;
+  if (!pointer_write_ || done_ || !status_slot_.poll(status_slot_seq_, slot)) {
+    return false;
+  }
+  status_slot_seq_ = slot.seq;
+  recv_status_message_ = slot.message;
+  if (recv_status_message_.final) {
+    done_ = true;
+    return true;
+  }
+#if WITH_TRACE
+  L_(trace) << "[i" << remote_index_ << "] "
+            << "[" << index_ << "] "
+            << "status slot update, new cn_ack_.data="
+            << recv_status_message_.ack.data;
+#endif
+  cn_ack_ = recv_status_message_.ack;
+  try_write_status();
+  return true;
+}
+
+bool InputChannelConnection::try_write_status() {
+  if (status_write_pending_ || send_status_message_.final) {
+    return false;
+  }
+  InputChannelStatusMessage message = send_status_message_;
+  message.wp = announced_wp();
+  if (finalize_ && (cn_wp_ == cn_ack_ || abort_)) {
+    message.final = true;
+    message.abort = abort_;
+  }
+  if (message.wp == send_status_message_.wp && !message.final) {
+    return false;
+  }
+  send_status_message_ = message;
+  status_source_.set(status_source_.seq + 1, send_status_message_);
+
+#if WITH_TRACE
+  L_(trace) << "[i" << remote_index_ << "] "
+            << "[" << index_ << "] "
+            << "POST WRITE status slot (wp.data="
+            << send_status_message_.wp.data
+            << " wp.desc=" << send_status_message_.wp.desc << ")";
+#endif
+  status_wr.wr.rdma.remote_addr = remote_info_.status.addr;
+  status_wr.wr.rdma.rkey = remote_info_.status.rkey;
+  status_write_pending_ = true;
+  status_posted_ = std::chrono::steady_clock::now();
+  post_control_send(&status_wr);
+  return true;
+}
+
 void InputChannelConnection::setup(struct ibv_pd* pd) {
+  if (pointer_write_) {
+    mr_status_slot_ =
+        ibv_reg_mr(pd, &status_slot_, sizeof(status_slot_),
+                   IBV_ACCESS_LOCAL_WRITE | IBV_ACCESS_REMOTE_WRITE);
+    mr_status_source_ =
+        ibv_reg_mr(pd, &status_source_, sizeof(status_source_), 0);
+    if (mr_status_slot_ == nullptr || mr_status_source_ == nullptr) {
+      throw InfinibandException("registration of memory region failed");
+    }
+
+    status_sge.addr = reinterpret_cast<uintptr_t>(&status_source_);
+    status_sge.length = sizeof(status_source_);
+    status_sge.lkey = mr_status_source_->lkey;
+
+    status_wr.wr_id = ID_WRITE_STATUS | (index_ << 8);
+    status_wr.opcode = IBV_WR_RDMA_WRITE;
+    status_wr.send_flags = IBV_SEND_SIGNALED;
+    status_wr.sg_list = &status_sge;
+    status_wr.num_sge = 1;
+    return;
+  }
+
+
   // register memory regions
   mr_recv_ =
       ibv_reg_mr(pd, &recv_status_message_, sizeof(ComputeNodeStatusMessage),
@@ -265,14 +473,29 @@ void InputChannelConnection::setup(struct ibv_pd* pd) {
    \param event RDMA connection manager event structure
 */
 void InputChannelConnection::on_established(struct rdma_cm_event* event) {
-  assert(event->param.conn.private_data_len >= sizeof(ComputeNodeInfo));
+  assert(event->param.conn.private_data_len >=
+         offsetof(ComputeNodeInfo, summary));
+  // older compute nodes do not provide a component summary buffer
+  remote_info_ = ComputeNodeInfo();
   memcpy(&remote_info_, event->param.conn.private_data,
-         sizeof(ComputeNodeInfo));
+         std::min<size_t>(event->param.conn.private_data_len,
+                          sizeof(ComputeNodeInfo)));
+  init_send_slots();
 
   IBConnection::on_established(event);
 }
 
 void InputChannelConnection::dereg_mr() {
+  if (mr_status_slot_ != nullptr) {
+    ibv_dereg_mr(mr_status_slot_);
+    mr_status_slot_ = nullptr;
+  }
+
+  if (mr_status_source_ != nullptr) {
+    ibv_dereg_mr(mr_status_source_);
+    mr_status_source_ = nullptr;
+  }
+
   if (mr_recv_ != nullptr) {
     ibv_dereg_mr(mr_recv_);
     mr_recv_ = nullptr;
@@ -300,7 +523,15 @@ InputChannelConnection::get_private_data() {
       new std::vector<uint8_t>(sizeof(InputNodeInfo)));
 
   auto* in_info = reinterpret_cast<InputNodeInfo*>(private_data->data());
+  *in_info = pull_source_;
   in_info->index = remote_index_;
+  in_info->status = BufferInfo();
+  in_info->write_with_imm = write_with_imm_;
+  in_info->pull = pull_;
+  if (pointer_write_) {
+    in_info->status.addr = reinterpret_cast<uintptr_t>(&status_slot_);
+    in_info->status.rkey = mr_status_slot_->rkey;
+  }
 
   return private_data;
 }
@@ -311,7 +542,7 @@ void InputChannelConnection::post_recv_status_message() {
             << "[" << index_ << "] "
             << "POST RECEIVE status message";
 #endif
-  post_recv(&recv_wr);
+  post_control_recv(&recv_wr);
 }
 
 void InputChannelConnection::post_send_status_message() {
@@ -322,5 +553,6 @@ void InputChannelConnection::post_send_status_message() {
             << send_status_message_.wp.data
             << " wp.desc=" << send_status_message_.wp.desc << ")";
 #endif
-  post_send(&send_wr);
+  status_posted_ = std::chrono::steady_clock::now();
+  post_control_send(&send_wr);
 }
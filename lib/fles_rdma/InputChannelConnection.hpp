@@ -1,15 +1,43 @@
 // Copyright 2012-2013 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include "ComponentSummary.hpp"
 #include "ComputeNodeInfo.hpp"
 #include "ComputeNodeStatusMessage.hpp"
 #include "IBConnection.hpp"
 #include "InputChannelStatusMessage.hpp"
+#include "InputNodeInfo.hpp"
+#include "StatusSlot.hpp"
+#include "TimesliceComponentDescriptor.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <deque>
 
 /// Input node connection class.
 /** An InputChannelConnection object represents the endpoint of a single
     timeslice building connection from an input node to a compute
-    node. */
+    node.
+
+    Buffer positions are exchanged either by alternating status messages
+    or, in pointer write mode, by RDMA-writing them into a status slot on
+    the peer, which is polled in local memory.
+
+    In pull mode, the input node only announces the number of components
+    available for the compute node as its write position. The compute node
+    reads them from the input buffers by itself and acknowledges the number
+    of components read.
+
+    The work requests for the transfer of timeslice components are
+    prepared in a fixed set of send slots whose invariant fields are filled
+    in once the connection is established. The slots of several timeslices
+    are chained and posted by a single ibv_post_send() call.
+
+    With a control connection (see ControlConnection), the status exchange
+    is not ordered behind the component transfers. In push mode, the
+    announced write pointer then only covers the components whose writes
+    have completed. */
 
 class InputChannelConnection : public IBConnection {
 public:
@@ -19,6 +47,9 @@ public:
                          uint_fast16_t remote_connection_index,
                          unsigned int max_send_wr,
                          unsigned int max_pending_write_requests,
+                         bool pointer_write = false,
+                         bool write_with_imm = false,
+                         bool pull = false,
                          struct rdma_cm_id* id = nullptr);
 
   InputChannelConnection(const InputChannelConnection&) = delete;
@@ -28,26 +59,91 @@ public:
   [[nodiscard]] bool check_for_buffer_space(uint64_t data_size,
                                             uint64_t desc_size) const;
 
-  /// Send data and descriptors to compute node.
-  void send_data(struct ibv_sge* sge,
-                 int num_sge,
+  /// Write components up to the given size (descriptors and data, in bytes)
+  /// inline, i.e., copied into the work request at posting.
+  /** This saves the HCA reading the data from the input buffer, which
+      dominates the latency of small components. The queue pair is created
+      with the corresponding inline data capacity, so this has to be set
+      before connecting. */
+  void set_inline_data_size(uint32_t size) {
+    inline_data_size_ = size;
+    qp_cap_.max_inline_data =
+        std::max<uint32_t>(size, sizeof(fles::ComponentSummary));
+  }
+
+  /// Maximum number of timeslice components posted at once.
+  static constexpr std::size_t max_send_batch = 8;
+
+  /// Retrieve the scatter/gather list (up to four entries) to be filled by
+  /// the caller for the next send_data() call.
+  [[nodiscard]] struct ibv_sge* next_send_sge() {
+    return send_slots_[queued_sends_].sge.data();
+  }
+
+  /// Check whether the compute node provides a component summary buffer.
+  [[nodiscard]] bool summary_enabled() const {
+    return remote_info_.summary.rkey != 0;
+  }
+
+  /// Prepare sending data and descriptors to compute node.
+  /** The data is given by the first num_sge entries of next_send_sge(). The
+      work requests are posted by flush_send_data(), or as soon as
+      max_send_batch components have been prepared. If given, the component
+      summary is written ahead of the descriptor (requires
+      summary_enabled()). */
+  void send_data(int num_sge,
                  uint64_t timeslice,
                  uint64_t desc_length,
                  uint64_t data_length,
-                 uint64_t skip);
+                 uint64_t skip,
+                 const fles::ComponentSummary* summary = nullptr);
+
+  /// Post the work requests of all prepared components.
+  void flush_send_data();
 
   [[nodiscard]] bool write_request_available() const;
 
   /// Increment target write pointers after data has been sent.
   void inc_write_pointers(uint64_t data_size, uint64_t desc_size);
 
-  // Get number of bytes to skip in advance (to avoid buffer wrap)
-  [[nodiscard]] uint64_t skip_required(uint64_t data_size) const;
+  /// Set the input buffers advertised to the compute node (pull mode).
+  void set_pull_source(BufferInfo data,
+                       BufferInfo desc,
+                       uint8_t data_buffer_size_exp,
+                       uint8_t desc_buffer_size_exp,
+                       uint64_t desc_start,
+                       uint32_t overlap_size);
+
+  /// Retrieve the fill level (0..1) of the compute node data buffer as of
+  /// the last acknowledgment.
+  [[nodiscard]] double data_fill() const;
+
+  /// Retrieve the fill level (0..1) of the compute node descriptor buffer as
+  /// of the last acknowledgment.
+  [[nodiscard]] double desc_fill() const;
+
+  // Get number of bytes to skip in advance (to avoid buffer wrap, and to
+  // place the byte at content_start congruent to content_phase modulo the
+  // power-of-two alignment)
+  [[nodiscard]] uint64_t skip_required(uint64_t data_size,
+                                       uint64_t content_start = 0,
+                                       uint64_t content_phase = 0,
+                                       uint64_t alignment = 1) const;
 
   bool try_sync_buffer_positions();
 
+  /// Check the local status slot for an update written by the compute node
+  /// (pointer write mode only).
+  /**
+     \return true if a new status has been received
+  */
+  bool poll_status();
+
   void finalize(bool abort);
 
+  /// Retrieve the acknowledged descriptor position of the compute node.
+  [[nodiscard]] uint64_t cn_ack_desc() const { return cn_ack_.desc; }
+
   [[nodiscard]] bool request_abort_flag() const {
     return recv_status_message_.request_abort;
   }
@@ -57,6 +153,20 @@ public:
   /// Handle Infiniband receive completion notification.
   void on_complete_recv();
 
+  /// Handle completion of a status slot write.
+  void on_complete_status_write() {
+    status_write_pending_ = false;
+    status_latency_ = std::chrono::steady_clock::now() - status_posted_;
+  }
+
+  /// Retrieve the latency of the last status exchange.
+  /** This is the time from posting a status message to the receipt of the
+      compute node's reply or, in pointer write mode, to the completion of
+      the status slot write. */
+  [[nodiscard]] std::chrono::steady_clock::duration status_latency() const {
+    return status_latency_;
+  }
+
   void setup(struct ibv_pd* pd) override;
 
   /// Connection handler function, called on successful connection.
@@ -80,6 +190,28 @@ private:
   /// Post a send work request (WR) to the send queue
   void post_send_status_message();
 
+  /// Retrieve the write pointer to announce to the compute node.
+  [[nodiscard]] ComputeNodeBufferPosition announced_wp() const;
+
+  /// Fill in the invariant fields of the send slots.
+  void init_send_slots();
+
+  /// Write the current status to the compute node's status slot if it has
+  /// changed and no previous write is pending (pointer write mode only).
+  bool try_write_status();
+
+  /// Flag, true if buffer positions are exchanged by RDMA writes.
+  bool pointer_write_ = false;
+
+  /// Flag, true if descriptors are written with immediate data.
+  bool write_with_imm_ = false;
+
+  /// Flag, true if the compute node reads the components.
+  bool pull_ = false;
+
+  /// The input buffers advertised to the compute node (pull mode).
+  InputNodeInfo pull_source_ = InputNodeInfo();
+
   /// Flag, true if it is the input nodes's turn to send a pointer update.
   bool our_turn_ = true;
 
@@ -102,6 +234,14 @@ private:
   /// Local version of CN write pointers
   ComputeNodeBufferPosition cn_wp_ = ComputeNodeBufferPosition();
 
+  /// CN write pointers after the components whose writes have completed
+  /// (with a control connection in push mode)
+  ComputeNodeBufferPosition written_wp_ = ComputeNodeBufferPosition();
+
+  /// CN write pointers after each component being written (with a control
+  /// connection in push mode)
+  std::deque<ComputeNodeBufferPosition> write_ends_;
+
   /// Send buffer for input channel status (including CN write pointers)
   InputChannelStatusMessage send_status_message_ = InputChannelStatusMessage();
 
@@ -121,7 +261,58 @@ private:
   /// Scatter/gather list entry for send work request
   ibv_sge send_sge = ibv_sge();
 
+  /// Status slot written by the compute node (pointer write mode)
+  StatusSlot<ComputeNodeStatusMessage> status_slot_{};
+
+  /// Source buffer for writes to the compute node's status slot
+  StatusSlot<InputChannelStatusMessage> status_source_{};
+
+  ibv_mr* mr_status_slot_ = nullptr;
+  ibv_mr* mr_status_source_ = nullptr;
+
+  /// Sequence number of the last status read from the local slot
+  uint64_t status_slot_seq_ = 0;
+
+  /// Flag, true while a status slot write is in flight.
+  bool status_write_pending_ = false;
+
+  /// Infiniband work request for status slot writes
+  ibv_send_wr status_wr = ibv_send_wr();
+
+  /// Time the last status message or status slot write has been posted
+  std::chrono::steady_clock::time_point status_posted_;
+
+  /// Latency of the last status exchange (see status_latency())
+  std::chrono::steady_clock::duration status_latency_{};
+
+  /// Scatter/gather list entry for status slot writes
+  ibv_sge status_sge = ibv_sge();
+
+  /// Prepared work requests for the transfer of a timeslice component.
+  /** The descriptor is sent inline, so neither the work requests nor the
+      descriptor need to be in registered memory. */
+  struct SendSlot {
+    std::array<ibv_sge, 4> sge{};
+    std::array<ibv_sge, 4> sge_wrap{};
+    ibv_sge sge_desc{};
+    ibv_sge sge_summary{};
+    ibv_send_wr wr_data{};
+    ibv_send_wr wr_wrap{};
+    ibv_send_wr wr_summary{};
+    ibv_send_wr wr_desc{};
+    fles::TimesliceComponentDescriptor tscdesc{};
+    fles::ComponentSummary summary{};
+  };
+
+  std::array<SendSlot, max_send_batch> send_slots_{};
+
+  /// Number of prepared send slots not yet posted.
+  std::size_t queued_sends_ = 0;
+
   unsigned int pending_write_requests_{0};
 
   unsigned int max_pending_write_requests_{0};
+
+  /// Maximum size of the components written inline (zero if disabled).
+  uint32_t inline_data_size_ = 0;
 };
@@ -1,6 +1,8 @@
 // Copyright 2012-2013 Jan de Cuveland <cmail@cuveland.de>
 
 #include "InputChannelSender.hpp"
+#include "ComponentSummary.hpp"
+#include "EventTrace.hpp"
 #include "MicrosliceDescriptor.hpp"
 #include "RequestIdentifier.hpp"
 #include "System.hpp"
@@ -24,25 +26,34 @@ InputChannelSender::InputChannelSender(
     std::vector<std::string> compute_services,
     uint32_t timeslice_size,
     uint32_t overlap_size,
+    uint64_t timeslice_duration,
+    uint64_t overlap_duration,
     uint32_t max_timeslice_number,
+    bool pointer_write,
+    bool write_with_imm,
+    bool pull,
+    ProgressMode progress_mode,
+    std::chrono::microseconds spin_time,
     cbm::Monitor* monitor)
-    : input_index_(input_index), data_source_(data_source),
+    : IBConnectionGroup(progress_mode, spin_time),
+      input_index_(input_index), data_source_(data_source),
       compute_hostnames_(std::move(compute_hostnames)),
       compute_services_(std::move(compute_services)),
-      timeslice_size_(timeslice_size), overlap_size_(overlap_size),
       max_timeslice_number_(max_timeslice_number),
-      min_acked_desc_(data_source.desc_buffer().size() / 4),
-      min_acked_data_(data_source.data_buffer().size() / 4), monitor_(monitor) {
-  start_index_desc_ = sent_desc_ = acked_desc_ = cached_acked_desc_ =
-      data_source.get_read_index().desc;
-  start_index_data_ = sent_data_ = acked_data_ = cached_acked_data_ =
-      data_source.get_read_index().data;
-
-  size_t min_ack_buffer_size =
-      data_source_.desc_buffer().size() / timeslice_size_ + 1;
-  ack_.alloc_with_size(min_ack_buffer_size);
+      pointer_write_(pointer_write), write_with_imm_(write_with_imm),
+      pull_(pull), overlap_size_(overlap_size),
+      boundaries_(data_source, timeslice_size, overlap_size,
+                  timeslice_duration, overlap_duration),
+      acks_(data_source, boundaries_), monitor_(monitor) {
+  start_index_desc_ = sent_desc_ = data_source.get_read_index().desc;
+  start_index_data_ = sent_data_ = data_source.get_read_index().data;
 
   hostname_ = fles::system::current_hostname();
+  send_age_ = DataAgeMetric(
+      monitor_,
+      {{"host", hostname_}, {"input_index", std::to_string(input_index_)}},
+      "send");
+  backpressure_ = BackpressureTracker(compute_hostnames_.size());
 }
 
 InputChannelSender::~InputChannelSender() {
@@ -58,8 +69,6 @@ InputChannelSender::~InputChannelSender() {
 }
 
 void InputChannelSender::report_status() {
-  constexpr auto interval = std::chrono::seconds(1);
-
   // if data_source.written pointers are lagging behind due to lazy updates,
   // use sent value instead
   uint64_t written_desc = data_source_.get_write_index().desc;
@@ -74,14 +83,14 @@ void InputChannelSender::report_status() {
   std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
   SendBufferStatus status_desc{now,
                                data_source_.desc_buffer().size(),
-                               cached_acked_desc_,
-                               acked_desc_,
+                               acks_.cached_acked().desc,
+                               acks_.acked().desc,
                                sent_desc_,
                                written_desc};
   SendBufferStatus status_data{now,
                                data_source_.data_buffer().size(),
-                               cached_acked_data_,
-                               acked_data_,
+                               acks_.cached_acked().data,
+                               acks_.acked().data,
                                sent_data_,
                                written_data};
 
@@ -97,6 +106,8 @@ void InputChannelSender::report_status() {
       static_cast<double>(status_data.acked -
                           previous_send_buffer_status_data_.acked) /
       delta_t;
+  double rate_skipped =
+      static_cast<double>(skipped_data_ - previous_skipped_data_) / delta_t;
 
   // retrieve SubsystemIdentifier and EquipmentIdentifier
   // from most current MicrosliceDescriptor
@@ -139,38 +150,69 @@ void InputChannelSender::report_status() {
                            {"data_freeing", status_data.freeing()},
                            {"data_free", status_data.unused()},
                            {"data_rate", rate_data},
+                           {"data_skip_rate", rate_skipped},
                            {"desc_used", status_desc.used()},
                            {"desc_sending", status_desc.sending()},
                            {"desc_freeing", status_desc.freeing()},
                            {"desc_free", status_desc.unused()},
                            {"desc_rate", rate_desc}});
+
+    // attribute the time blocked to its reasons and the compute nodes
+    const auto blocked = backpressure_.take();
+    auto fraction = [delta_t](BackpressureTracker::clock::duration d) {
+      return std::chrono::duration<double>(d).count() / delta_t;
+    };
+    monitor_->QueueMetric(
+        "send_blocking",
+        {{"host", hostname_}, {"input_index", std::to_string(input_index_)}},
+        {{"data_source", fraction(blocked[BlockReason::DataSource])},
+         {"credits", fraction(blocked[BlockReason::Credits])},
+         {"remote_ack", fraction(blocked[BlockReason::RemoteAck])}});
+    for (std::size_t cn = 0; cn < conn_.size(); ++cn) {
+      monitor_->QueueMetric("send_target_status",
+                            {{"host", hostname_},
+                             {"input_index", std::to_string(input_index_)},
+                             {"compute_index", std::to_string(cn)}},
+                            {{"data_fill", conn_[cn]->data_fill()},
+                             {"desc_fill", conn_[cn]->desc_fill()},
+                             {"blocked", fraction(blocked.target.at(cn))}});
+    }
+  }
+
+  if (perf_counters_.enabled()) {
+    const uint64_t timeslices = acks_.acked_timeslices();
+    perf_counters_.report(
+        monitor_,
+        {{"host", hostname_}, {"input_index", std::to_string(input_index_)}},
+        timeslices - perf_reported_timeslices_);
+    perf_reported_timeslices_ = timeslices;
   }
 
   previous_send_buffer_status_desc_ = status_desc;
   previous_send_buffer_status_data_ = status_data;
+  previous_skipped_data_ = skipped_data_;
 
-  scheduler_.add([this] { report_status(); }, now + interval);
+  scheduler_.add([this] { report_status(); }, now + status_interval_);
 }
 
 void InputChannelSender::sync_buffer_positions() {
-  for (auto& c : conn_) {
-    c->try_sync_buffer_positions();
+  for (std::size_t cn = 0; cn < conn_.size(); ++cn) {
+    if (conn_[cn]->poll_status()) {
+      on_status_update(static_cast<int>(cn));
+    }
+    conn_[cn]->try_sync_buffer_positions();
   }
 
-  auto now = std::chrono::system_clock::now();
+  auto now = Scheduler::clock::now();
   scheduler_.add([this] { sync_buffer_positions(); },
                  now + std::chrono::milliseconds(0));
 }
 
 void InputChannelSender::sync_data_source(bool schedule) {
-  if (acked_data_ > cached_acked_data_ || acked_desc_ > cached_acked_desc_) {
-    cached_acked_data_ = acked_data_;
-    cached_acked_desc_ = acked_desc_;
-    data_source_.set_read_index({cached_acked_desc_, cached_acked_data_});
-  }
+  acks_.sync();
 
   if (schedule) {
-    auto now = std::chrono::system_clock::now();
+    auto now = Scheduler::clock::now();
     scheduler_.add([this] { sync_data_source(true); },
                    now + std::chrono::milliseconds(100));
   }
@@ -179,9 +221,25 @@ void InputChannelSender::sync_data_source(bool schedule) {
 /// The thread main function.
 void InputChannelSender::operator()() {
   try {
+    if (monitor_ != nullptr) {
+      status_latency_metric_ = monitor_->RegisterHistogram(
+          "control_latency",
+          {{"host", hostname_},
+           {"input_index", std::to_string(input_index_)},
+           {"control", control_tos_ ? "separate" : "shared"}},
+          "status_ns");
+    }
 
+    // the control connections are established first, so that the
+    // connections can post their receive requests to them
+    if (control_tos_) {
+      connect_control();
+      while (connected_ != control_conn_.size()) {
+        poll_cm_events();
+      }
+    }
     connect();
-    while (connected_ != compute_hostnames_.size()) {
+    while (connected_ != control_conn_.size() + compute_hostnames_.size()) {
       poll_cm_events();
     }
     L_(info) << "[i" << input_index_ << "] "
@@ -193,22 +251,33 @@ void InputChannelSender::operator()() {
     uint64_t timeslice = 0;
     sync_buffer_positions();
     sync_data_source(true);
+    if (perf_counters_enabled_) {
+      perf_counters_.enable();
+    }
     report_status();
     while (timeslice < max_timeslice_number_ && !abort_) {
+      perf_counters_.enter(PerfPost);
       if (try_send_timeslice(timeslice)) {
         timeslice++;
         if (timeslice == 1) {
           L_(info) << "[i" << input_index_ << "] "
                    << "first timeslice processed";
         }
+      } else {
+        // post the components prepared since the last stall at once
+        flush_send_data();
       }
+      perf_counters_.enter(PerfPoll);
       poll_completion();
+      perf_counters_.enter(PerfBookkeeping);
       data_source_.proceed();
       scheduler_.timer();
     }
 
+    flush_send_data();
+
     // wait for pending send completions
-    while (acked_desc_ < timeslice_size_ * timeslice + start_index_desc_) {
+    while (acks_.acked_timeslices() < timeslice) {
       poll_completion();
       scheduler_.timer();
     }
@@ -237,6 +306,16 @@ void InputChannelSender::operator()() {
     }
 
     summary();
+    if (status_latency_count_ != 0) {
+      auto us = [](std::chrono::steady_clock::duration d) {
+        return std::chrono::duration<double, std::micro>(d).count();
+      };
+      L_(info) << "summary: status exchange latency "
+               << us(status_latency_sum_) /
+                      static_cast<double>(status_latency_count_)
+               << " us average, " << us(status_latency_max_) << " us max ("
+               << (control_tos_ ? "separate" : "shared") << " connection)";
+    }
   } catch (std::exception& e) {
     L_(error) << "exception in InputChannelSender: " << e.what();
   }
@@ -244,14 +323,21 @@ void InputChannelSender::operator()() {
 
 bool InputChannelSender::try_send_timeslice(uint64_t timeslice) {
   // wait until a complete timeslice is available in the input buffer
-  uint64_t desc_offset = timeslice * timeslice_size_ + start_index_desc_;
-  uint64_t desc_length = timeslice_size_ + overlap_size_;
-
-  if (write_index_desc_ < desc_offset + desc_length) {
-    write_index_desc_ = data_source_.get_write_index().desc;
+  auto range = boundaries_.component(timeslice, write_index_desc_);
+  if (!range) {
+    // ask for the complete component, a batching source may wait for it
+    write_index_desc_ =
+        data_source_
+            .get_write_index_min({boundaries_.min_write_index(timeslice), 0})
+            .desc;
+    range = boundaries_.component(timeslice, write_index_desc_);
   }
-  // check if microslice no. (desc_offset + desc_length - 1) is avail
-  if (write_index_desc_ >= desc_offset + desc_length) {
+  // check if the complete component is available
+  if (!range) {
+    backpressure_.blocked(BlockReason::DataSource);
+  } else {
+    uint64_t desc_offset = range->desc_offset;
+    uint64_t desc_length = range->desc_length;
 
     uint64_t data_offset = data_source_.desc_buffer().at(desc_offset).offset;
     uint64_t data_end =
@@ -273,12 +359,26 @@ bool InputChannelSender::try_send_timeslice(uint64_t timeslice) {
 
     int cn = target_cn_index(timeslice);
 
+    if (pull_) {
+      // the compute node reads the component once it has buffer space
+      conn_[cn]->inc_write_pointers(0, 1);
+      sent_desc_ = desc_offset + desc_length;
+      sent_data_ = data_end;
+      EventTrace::record(TraceEventType::TimeslicePosted, timeslice, cn);
+      backpressure_.progressed();
+      return true;
+    }
+
     if (!conn_[cn]->write_request_available()) {
+      backpressure_.blocked(BlockReason::Credits, cn);
       return false;
     }
 
-    // number of bytes to skip in advance (to avoid buffer wrap)
-    uint64_t skip = conn_[cn]->skip_required(total_length);
+    // number of bytes to skip in advance (to avoid buffer wrap and to align
+    // the content)
+    uint64_t skip = conn_[cn]->skip_required(
+        total_length, desc_length * sizeof(fles::MicrosliceDescriptor),
+        data_offset, content_alignment_);
     total_length += skip;
 
     if (conn_[cn]->check_for_buffer_space(total_length, 1)) {
@@ -287,12 +387,15 @@ bool InputChannelSender::try_send_timeslice(uint64_t timeslice) {
                      data_length, skip);
 
       conn_[cn]->inc_write_pointers(total_length, 1);
+      skipped_data_ += skip;
 
       sent_desc_ = desc_offset + desc_length;
       sent_data_ = data_end;
 
+      backpressure_.progressed();
       return true;
     }
+    backpressure_.blocked(BlockReason::RemoteAck, cn);
   }
 
   return false;
@@ -303,13 +406,27 @@ InputChannelSender::create_input_node_connection(uint_fast16_t index) {
   unsigned int max_send_wr = 8000;
 
   // limit pending write requests so that send queue and completion queue
-  // do not overflow
+  // do not overflow (up to four work requests per component: data, wrapped
+  // data, summary, and descriptor)
   unsigned int max_pending_write_requests = std::min(
-      static_cast<unsigned int>((max_send_wr - 1) / 3),
+      static_cast<unsigned int>((max_send_wr - 1) / 4),
       static_cast<unsigned int>((num_cqe_ - 1) / compute_hostnames_.size()));
 
   std::unique_ptr<InputChannelConnection> connection(new InputChannelConnection(
-      ec_, index, input_index_, max_send_wr, max_pending_write_requests));
+      ec_, index, input_index_, max_send_wr, max_pending_write_requests,
+      pointer_write_, write_with_imm_, pull_));
+  connection->set_inline_data_size(inline_data_size_);
+  if (control_tos_) {
+    connection->set_control_connection(control_conn_.at(index).get());
+  }
+  return connection;
+}
+
+std::unique_ptr<ControlConnection>
+InputChannelSender::create_control_connection(uint_fast16_t index) {
+  auto connection =
+      std::make_unique<ControlConnection>(ec_, index, input_index_);
+  connection->set_type_of_service(*control_tos_);
   return connection;
 }
 
@@ -320,6 +437,16 @@ void InputChannelSender::connect() {
     connection->connect(compute_hostnames_[i], compute_services_[i]);
     conn_.push_back(std::move(connection));
   }
+  pulled_.assign(conn_.size(), 0);
+}
+
+void InputChannelSender::connect_control() {
+  for (unsigned int i = 0; i < compute_hostnames_.size(); ++i) {
+    std::unique_ptr<ControlConnection> connection =
+        create_control_connection(i);
+    connection->connect(compute_hostnames_[i], compute_services_[i]);
+    control_conn_.push_back(std::move(connection));
+  }
 }
 
 int InputChannelSender::target_cn_index(uint64_t timeslice) {
@@ -338,11 +465,17 @@ void InputChannelSender::dump_mr(struct ibv_mr* mr) const {
 void InputChannelSender::on_addr_resolved(struct rdma_cm_id* id) {
   IBConnectionGroup<InputChannelConnection>::on_addr_resolved(id);
 
+  // in pull mode, the compute nodes read the input buffers
+  int access = IBV_ACCESS_LOCAL_WRITE;
+  if (pull_) {
+    access |= IBV_ACCESS_REMOTE_READ;
+  }
+
   if (mr_data_ == nullptr) {
     // Register memory regions.
     mr_data_ =
         ibv_reg_mr(pd_, const_cast<uint8_t*>(data_source_.data_buffer().ptr()),
-                   data_source_.data_buffer().bytes(), IBV_ACCESS_LOCAL_WRITE);
+                   data_source_.data_buffer().mapped_bytes(), access);
     if (mr_data_ == nullptr) {
       L_(error) << "ibv_reg_mr failed for mr_data: " << strerror(errno);
       throw InfinibandException("registration of memory region failed");
@@ -352,7 +485,7 @@ void InputChannelSender::on_addr_resolved(struct rdma_cm_id* id) {
         ibv_reg_mr(pd_,
                    const_cast<fles::MicrosliceDescriptor*>(
                        data_source_.desc_buffer().ptr()),
-                   data_source_.desc_buffer().bytes(), IBV_ACCESS_LOCAL_WRITE);
+                   data_source_.desc_buffer().mapped_bytes(), access);
     if (mr_desc_ == nullptr) {
       L_(error) << "ibv_reg_mr failed for mr_desc: " << strerror(errno);
       throw InfinibandException("registration of memory region failed");
@@ -363,11 +496,37 @@ void InputChannelSender::on_addr_resolved(struct rdma_cm_id* id) {
     dump_mr(mr_data_);
 #endif
   }
+
+  auto* base = static_cast<IBConnection*>(id->context);
+  if (pull_ && !is_control_connection(base)) {
+    auto* conn = static_cast<InputChannelConnection*>(base);
+    conn->set_pull_source(
+        {reinterpret_cast<uintptr_t>(data_source_.data_buffer().ptr()),
+         mr_data_->rkey},
+        {reinterpret_cast<uintptr_t>(data_source_.desc_buffer().ptr()),
+         mr_desc_->rkey},
+        static_cast<uint8_t>(data_source_.data_buffer().size_exponent()),
+        static_cast<uint8_t>(data_source_.desc_buffer().size_exponent()),
+        start_index_desc_, overlap_size_);
+  }
 }
 
 void InputChannelSender::on_rejected(struct rdma_cm_event* event) {
-  auto* conn = static_cast<InputChannelConnection*>(event->id->context);
+  auto* base = static_cast<IBConnection*>(event->id->context);
+  if (is_control_connection(base)) {
+    base->on_rejected(event);
+    uint_fast16_t i = base->index();
+    control_conn_.at(i) = nullptr;
+
+    // immediately initiate retry
+    std::unique_ptr<ControlConnection> connection =
+        create_control_connection(i);
+    connection->connect(compute_hostnames_[i], compute_services_[i]);
+    control_conn_.at(i) = std::move(connection);
+    return;
+  }
 
+  auto* conn = static_cast<InputChannelConnection*>(base);
   conn->on_rejected(event);
   uint_fast16_t i = conn->index();
   conn_.at(i) = nullptr;
@@ -388,7 +547,7 @@ std::string InputChannelSender::get_state_string() {
     s << " (" << i << ")" << data_source_.desc_buffer().at(i).offset;
   }
   s << std::endl;
-  s << "| acked_desc_ = " << acked_desc_ << std::endl;
+  s << "| acked_desc_ = " << acks_.acked().desc << std::endl;
   s << "/--- data buf ---" << std::endl;
   s << "|";
   for (unsigned int i = 0; i < data_source_.data_buffer().size(); ++i) {
@@ -396,7 +555,7 @@ std::string InputChannelSender::get_state_string() {
       << std::dec;
   }
   s << std::endl;
-  s << "| acked_data_ = " << acked_data_ << std::endl;
+  s << "| acked_data_ = " << acks_.acked().data << std::endl;
   s << "\\---------";
 
   return s.str();
@@ -410,11 +569,13 @@ void InputChannelSender::post_send_data(uint64_t timeslice,
                                         uint64_t data_length,
                                         uint64_t skip) {
   int num_sge = 0;
-  std::array<ibv_sge, 4> sge{};
+  // filled in place in the prepared send slot of the connection
+  ibv_sge* sge = conn_[cn]->next_send_sge();
   // descriptors
-  if ((desc_offset & data_source_.desc_buffer().size_mask()) <=
-      ((desc_offset + desc_length - 1) &
-       data_source_.desc_buffer().size_mask())) {
+  if (data_source_.desc_buffer().mirrored() ||
+      (desc_offset & data_source_.desc_buffer().size_mask()) <=
+          ((desc_offset + desc_length - 1) &
+           data_source_.desc_buffer().size_mask())) {
     // one chunk
     sge[num_sge].addr = reinterpret_cast<uintptr_t>(
         &data_source_.desc_buffer().at(desc_offset));
@@ -440,9 +601,10 @@ void InputChannelSender::post_send_data(uint64_t timeslice,
   // data
   if (data_length == 0) {
     // zero chunks
-  } else if ((data_offset & data_source_.data_buffer().size_mask()) <=
-             ((data_offset + data_length - 1) &
-              data_source_.data_buffer().size_mask())) {
+  } else if (data_source_.data_buffer().mirrored() ||
+             (data_offset & data_source_.data_buffer().size_mask()) <=
+                 ((data_offset + data_length - 1) &
+                  data_source_.data_buffer().size_mask())) {
     // one chunk
     sge[num_sge].addr = reinterpret_cast<uintptr_t>(
         &data_source_.data_buffer().at(data_offset));
@@ -464,8 +626,25 @@ void InputChannelSender::post_send_data(uint64_t timeslice,
     sge[num_sge++].lkey = mr_data_->lkey;
   }
 
-  conn_[cn]->send_data(sge.data(), num_sge, timeslice, desc_length, data_length,
-                       skip);
+  // summary of the component, if the compute node can receive it
+  if (conn_[cn]->summary_enabled()) {
+    auto summary = fles::ComponentSummary::begin(timeslice);
+    for (uint64_t i = 0; i < desc_length; ++i) {
+      summary.add(data_source_.desc_buffer().at(desc_offset + i));
+    }
+    conn_[cn]->send_data(num_sge, timeslice, desc_length, data_length, skip,
+                         &summary);
+  } else {
+    conn_[cn]->send_data(num_sge, timeslice, desc_length, data_length, skip);
+  }
+  EventTrace::record(TraceEventType::TimeslicePosted, timeslice, cn);
+  send_age_.record(data_source_.desc_buffer().at(desc_offset).idx);
+}
+
+void InputChannelSender::flush_send_data() {
+  for (auto& c : conn_) {
+    c->flush_send_data();
+  }
 }
 
 void InputChannelSender::on_completion(const struct ibv_wc& wc) {
@@ -475,55 +654,65 @@ void InputChannelSender::on_completion(const struct ibv_wc& wc) {
 
     int cn = (wc.wr_id >> 8) & 0xFFFF;
     conn_[cn]->on_complete_write();
+    EventTrace::record(TraceEventType::WriteCompleted, ts, cn);
 
-    uint64_t acked_ts = (acked_desc_ - start_index_desc_) / timeslice_size_;
-    if (ts != acked_ts) {
-      // transmission has been reordered, store completion information
-      ack_.at(ts) = ts;
-    } else {
-      // completion is for earliest pending timeslice, update indices
-      do {
-        ++acked_ts;
-      } while (ack_.at(acked_ts) > ts);
-      acked_desc_ = acked_ts * timeslice_size_ + start_index_desc_;
-      acked_data_ = data_source_.desc_buffer().at(acked_desc_ - 1).offset +
-                    data_source_.desc_buffer().at(acked_desc_ - 1).size;
-      if (acked_data_ >= cached_acked_data_ + min_acked_data_ ||
-          acked_desc_ >= cached_acked_desc_ + min_acked_desc_) {
-        cached_acked_data_ = acked_data_;
-        cached_acked_desc_ = acked_desc_;
-        data_source_.set_read_index({cached_acked_desc_, cached_acked_data_});
-      }
-    }
+    acks_.ack(ts);
 #if WITH_TRACE
     L_(trace) << "[i" << input_index_ << "] "
               << "write timeslice " << ts
-              << " complete, now: acked_data_=" << acked_data_
-              << " acked_desc_=" << acked_desc_;
+              << " complete, now: acked_data_=" << acks_.acked().data
+              << " acked_desc_=" << acks_.acked().desc;
 #endif
   } break;
 
   case ID_RECEIVE_STATUS: {
     int cn = wc.wr_id >> 8;
     conn_[cn]->on_complete_recv();
-    if (conn_[cn]->request_abort_flag()) {
-      abort_ = true;
-    }
-    if (conn_[cn]->done()) {
-      ++connections_done_;
-      all_done_ = (connections_done_ == conn_.size());
-      L_(debug) << "[i" << input_index_ << "] "
-                << "ID_RECEIVE_STATUS final for id " << cn
-                << " all_done=" << all_done_;
-    }
+    record_status_latency(cn);
+    on_status_update(cn);
   } break;
 
   case ID_SEND_STATUS: {
   } break;
 
+  case ID_WRITE_STATUS: {
+    int cn = wc.wr_id >> 8;
+    conn_[cn]->on_complete_status_write();
+    record_status_latency(cn);
+  } break;
+
   default:
     L_(error) << "[i" << input_index_ << "] "
               << "wc for unknown wr_id=" << (wc.wr_id & 0xFF);
     throw InfinibandException("wc for unknown wr_id");
   }
 }
+
+void InputChannelSender::on_status_update(int cn) {
+  EventTrace::record(TraceEventType::AckReceived, conn_[cn]->cn_ack_desc(), cn);
+  if (conn_[cn]->request_abort_flag()) {
+    abort_ = true;
+  }
+  if (pull_) {
+    // release the components read by the compute node
+    while (pulled_.at(cn) < conn_[cn]->cn_ack_desc()) {
+      acks_.ack(cn + pulled_.at(cn) * conn_.size());
+      ++pulled_.at(cn);
+    }
+  }
+  if (conn_[cn]->done()) {
+    ++connections_done_;
+    all_done_ = (connections_done_ == conn_.size());
+    L_(debug) << "[i" << input_index_ << "] "
+              << "status final for id " << cn << " all_done=" << all_done_;
+  }
+}
+
+void InputChannelSender::record_status_latency(int cn) {
+  const auto latency = conn_[cn]->status_latency();
+  ++status_latency_count_;
+  status_latency_sum_ += latency;
+  status_latency_max_ = std::max(status_latency_max_, latency);
+  status_latency_metric_.Record(static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count()));
+}
@@ -1,18 +1,34 @@
 // Copyright 2012-2013 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include "BackpressureTracker.hpp"
+#include "DataAgeMetric.hpp"
 #include "DualRingBuffer.hpp"
 #include "IBConnectionGroup.hpp"
 #include "InputChannelConnection.hpp"
+#include "PerfCounters.hpp"
 #include "Monitor.hpp"
 #include "RingBuffer.hpp"
+#include "SendBufferStatus.hpp"
+#include "TimesliceAckTracker.hpp"
+#include "TimesliceBoundaries.hpp"
+#include <algorithm>
 #include <boost/format.hpp>
 #include <cassert>
+#include <optional>
 
 /// Input buffer and compute node connection container class.
 /** An InputChannelSender object represents an input buffer (filled by a
     FLIB) and a group of timeslice building connections to compute
-    nodes. */
+    nodes.
+
+    In pull mode, the sender does not write the components. It announces
+    them to their compute node as they become available, and the compute
+    node reads them from the registered input buffers at its own pace. The
+    components are released as the compute node acknowledges their reads,
+    so the sender does not track the compute node buffer space. Pull mode
+    requires count-based timeslices, which the compute node locates by
+    their number. */
 
 class InputChannelSender : public IBConnectionGroup<InputChannelConnection> {
 public:
@@ -23,7 +39,14 @@ public:
                      std::vector<std::string> compute_services,
                      uint32_t timeslice_size,
                      uint32_t overlap_size,
+                     uint64_t timeslice_duration,
+                     uint64_t overlap_duration,
                      uint32_t max_timeslice_number,
+                     bool pointer_write,
+                     bool write_with_imm,
+                     bool pull,
+                     ProgressMode progress_mode,
+                     std::chrono::microseconds spin_time,
                      cbm::Monitor* monitor);
 
   InputChannelSender(const InputChannelSender&) = delete;
@@ -34,6 +57,38 @@ public:
 
   void report_status();
 
+  /// Set the interval of the status reports (default: 1 s).
+  void set_status_interval(std::chrono::milliseconds interval) {
+    status_interval_ = interval;
+  }
+
+  /// Enable the hardware performance counters of the sender thread, which
+  /// are published per loop phase with the status reports.
+  void set_perf_counters(bool enable) { perf_counters_enabled_ = enable; }
+
+  /// Align the component contents in the compute node buffers (push mode).
+  /** The content of each component is placed at the same offset modulo the
+      given power of two as in the input buffer, so that microslices aligned
+      by the data source (e.g., to 64 bytes for aligned SIMD loads) stay
+      aligned in the timeslices. The padding is skipped in the compute node
+      buffer before the component, which keeps the component layout and
+      Timeslice::content() unchanged. */
+  void set_content_alignment(uint64_t alignment) {
+    content_alignment_ = std::max<uint64_t>(alignment, 1);
+  }
+
+  /// Exchange the status of each connection over a separate control
+  /// connection (see ControlConnection) with the given type of service.
+  /** The status messages then do not queue behind the component transfers
+      on the queue pair or, given a type of service of a higher priority
+      class, in the fabric. In push mode, the compute nodes are notified of
+      the components once their writes have completed. */
+  void set_control_connections(uint8_t tos) { control_tos_ = tos; }
+
+  /// Write components up to the given size (in bytes) inline (see
+  /// InputChannelConnection::set_inline_data_size()).
+  void set_inline_data_size(uint32_t size) { inline_data_size_ = size; }
+
   void sync_buffer_positions();
   void sync_data_source(bool schedule);
 
@@ -49,9 +104,15 @@ public:
   std::unique_ptr<InputChannelConnection>
   create_input_node_connection(uint_fast16_t index);
 
+  std::unique_ptr<ControlConnection>
+  create_control_connection(uint_fast16_t index);
+
   /// Initiate connection requests to list of target hostnames.
   void connect();
 
+  /// Initiate the control connection requests to the target hostnames.
+  void connect_control();
+
 private:
   /// Return target computation node for given timeslice.
   int target_cn_index(uint64_t timeslice);
@@ -75,9 +136,18 @@ private:
                       uint64_t data_length,
                       uint64_t skip);
 
+  /// Post the prepared work requests of all connections.
+  void flush_send_data();
+
   /// Completion notification event dispatcher. Called by the event loop.
   void on_completion(const struct ibv_wc& wc) override;
 
+  /// Handle a status update received from a compute node.
+  void on_status_update(int cn);
+
+  /// Account the latency of the last status exchange of a connection.
+  void record_status_latency(int cn);
+
   uint64_t input_index_;
 
   /// InfiniBand memory region descriptor for input data buffer.
@@ -86,15 +156,6 @@ private:
   /// InfiniBand memory region descriptor for input descriptor buffer.
   struct ibv_mr* mr_desc_ = nullptr;
 
-  /// Buffer to store acknowledged status of timeslices.
-  RingBuffer<uint64_t, true> ack_;
-
-  /// Number of acknowledged microslices. Written to FLIB.
-  uint64_t acked_desc_;
-
-  /// Number of acknowledged data bytes. Written to FLIB.
-  uint64_t acked_data_;
-
   /// Data source (e.g., FLIB).
   InputBufferReadInterface& data_source_;
 
@@ -107,15 +168,52 @@ private:
   const std::vector<std::string> compute_hostnames_;
   const std::vector<std::string> compute_services_;
 
-  const uint32_t timeslice_size_;
-  const uint32_t overlap_size_;
   const uint32_t max_timeslice_number_;
 
-  const uint64_t min_acked_desc_;
-  const uint64_t min_acked_data_;
+  /// Flag, true if buffer positions are exchanged by RDMA writes to status
+  /// slots instead of status messages.
+  const bool pointer_write_;
 
-  uint64_t cached_acked_desc_;
-  uint64_t cached_acked_data_;
+  /// Flag, true if descriptors are written with immediate data to notify
+  /// the compute node without a fence.
+  const bool write_with_imm_;
+
+  /// Flag, true if the compute nodes read the components.
+  const bool pull_;
+
+  /// Overlap size in microslices (pull mode).
+  const uint32_t overlap_size_;
+
+  /// Alignment of the component contents in the compute node buffers.
+  uint64_t content_alignment_ = 1;
+
+  /// Type of service of the control connections, if used.
+  std::optional<uint8_t> control_tos_;
+
+  /// Maximum size of the components written inline (zero if disabled).
+  uint32_t inline_data_size_ = 0;
+
+  /// Latency of the status exchanges (see
+  /// InputChannelConnection::status_latency())
+  cbm::MetricHistogram status_latency_metric_;
+  uint64_t status_latency_count_ = 0;
+  std::chrono::steady_clock::duration status_latency_sum_{};
+  std::chrono::steady_clock::duration status_latency_max_{};
+
+  /// Number of bytes skipped in the compute node buffers (buffer wrap and
+  /// alignment), for statistics.
+  uint64_t skipped_data_ = 0;
+  uint64_t previous_skipped_data_ = 0;
+
+  /// Number of components read by each compute node (pull mode).
+  std::vector<uint64_t> pulled_;
+
+  /// Descriptor ranges of the timeslice components.
+  TimesliceBoundaries<InputBufferReadInterface> boundaries_;
+
+  /// Acknowledgment accounting of the sent timeslices. Writes the read
+  /// indexes to FLIB.
+  TimesliceAckTracker<InputBufferReadInterface> acks_;
 
   uint64_t start_index_desc_;
   uint64_t start_index_data_;
@@ -127,56 +225,21 @@ private:
   cbm::Monitor* monitor_;
   std::string hostname_;
 
-  struct SendBufferStatus {
-    std::chrono::system_clock::time_point time;
-    uint64_t size = 0;
-
-    uint64_t cached_acked = 0;
-    uint64_t acked = 0;
-    uint64_t sent = 0;
-    uint64_t written = 0;
-
-    [[nodiscard]] [[nodiscard]] int64_t used() const {
-      assert(sent <= written);
-      return written - sent;
-    }
-    [[nodiscard]] [[nodiscard]] int64_t sending() const {
-      assert(acked <= sent);
-      return sent - acked;
-    }
-    [[nodiscard]] [[nodiscard]] int64_t freeing() const {
-      assert(cached_acked <= acked);
-      return acked - cached_acked;
-    }
-    [[nodiscard]] [[nodiscard]] int64_t unused() const {
-      assert(written <= cached_acked + size);
-      return cached_acked + size - written;
-    }
-
-    [[nodiscard]] [[nodiscard]] float percentage(int64_t value) const {
-      return static_cast<float>(value) / static_cast<float>(size);
-    }
-
-    static std::string caption() { return {"used/sending/freeing/free"}; }
-
-    [[nodiscard]] [[nodiscard]] std::string
-    percentage_str(int64_t value) const {
-      boost::format percent_fmt("%4.1f%%");
-      percent_fmt % (percentage(value) * 100);
-      std::string s = percent_fmt.str();
-      s.resize(4);
-      return s;
-    }
-
-    [[nodiscard]] [[nodiscard]] std::string percentages() const {
-      return percentage_str(used()) + " " + percentage_str(sending()) + " " +
-             percentage_str(freeing()) + " " + percentage_str(unused());
-    }
-
-    [[nodiscard]] [[nodiscard]] std::vector<int64_t> vector() const {
-      return std::vector<int64_t>{used(), sending(), freeing(), unused()};
-    }
-  };
+  /// Age of the timeslice components when their transfer is posted
+  DataAgeMetric send_age_;
+
+  /// Interval of the status reports
+  std::chrono::milliseconds status_interval_{1000};
+
+  /// Time the sending of timeslices has been blocked, and why
+  BackpressureTracker backpressure_;
+
+  /// Phases of the sender loop for the performance counters
+  enum PerfPhase : std::size_t { PerfPost, PerfPoll, PerfBookkeeping };
+
+  bool perf_counters_enabled_ = false;
+  PhasePerfCounters perf_counters_{{"post", "poll", "bookkeeping"}};
+  uint64_t perf_reported_timeslices_ = 0;
 
   SendBufferStatus previous_send_buffer_status_desc_ = SendBufferStatus();
   SendBufferStatus previous_send_buffer_status_data_ = SendBufferStatus();
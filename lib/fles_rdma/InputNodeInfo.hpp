@@ -1,10 +1,26 @@
 // Copyright 2012-2013 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include "ComputeNodeInfo.hpp"
+
 #pragma pack(1)
 
+/// Connection private data of an input node (at most 56 bytes).
 struct InputNodeInfo {
-  uint32_t index;
+  uint16_t index;
+  bool control; ///< Request of a ControlConnection, other fields unused
+  BufferInfo status; ///< Status slot, rkey 0 if status messages are used
+  bool write_with_imm; ///< Descriptors are written with immediate data
+  bool pull;           ///< Components are read by the compute node
+  BufferInfo data;     ///< Input data buffer (pull mode)
+  BufferInfo desc;     ///< Input descriptor buffer (pull mode)
+  uint8_t data_buffer_size_exp;
+  uint8_t desc_buffer_size_exp;
+  uint64_t desc_start;   ///< Descriptor index of timeslice 0 (pull mode)
+  uint32_t overlap_size; ///< Overlap microslices per component (pull mode)
 };
 
 #pragma pack()
+
+/// Maximum number of outstanding RDMA reads per connection (pull mode).
+constexpr uint8_t pull_read_depth = 8;
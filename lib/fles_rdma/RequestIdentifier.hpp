@@ -12,7 +12,11 @@ enum RequestIdentifier {
   ID_WRITE_DESC,
   ID_SEND_STATUS,
   ID_RECEIVE_STATUS,
-  ID_SEND_FINALIZE
+  ID_SEND_FINALIZE,
+  ID_WRITE_STATUS,
+  ID_READ_DESC,
+  ID_READ_DATA,
+  ID_WRITE_SUMMARY
 };
 
 #pragma pack()
@@ -32,6 +36,14 @@ inline std::ostream& operator<<(std::ostream& s, RequestIdentifier v) {
     return s << "ID_RECEIVE_STATUS";
   case ID_SEND_FINALIZE:
     return s << "ID_SEND_FINALIZE";
+  case ID_WRITE_STATUS:
+    return s << "ID_WRITE_STATUS";
+  case ID_READ_DESC:
+    return s << "ID_READ_DESC";
+  case ID_READ_DATA:
+    return s << "ID_READ_DATA";
+  case ID_WRITE_SUMMARY:
+    return s << "ID_WRITE_SUMMARY";
   default:
     return s << static_cast<int>(v);
   }
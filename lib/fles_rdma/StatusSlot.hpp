@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/// Structure holding a status message that is RDMA-written by the peer.
+/** The receiving side polls the slot in local memory. As the placement of
+    the bytes of an RDMA write is not atomic, each update carries a new
+    sequence number and a check word over sequence number and message. A
+    slot is accepted only if the check word matches, so partially written
+    slots are skipped until the next poll. */
+template <typename Message> struct StatusSlot {
+  uint64_t seq;    ///< Sequence number, incremented by the writer
+  Message message; ///< The status message
+  uint64_t check;  ///< Check word over sequence number and message
+
+  /// Fill the slot with a new message.
+  void set(uint64_t new_seq, const Message& new_message) {
+    seq = new_seq;
+    message = new_message;
+    check = checksum(seq, message);
+  }
+
+  /// Read a consistent copy of the slot written by the peer.
+  /**
+     \return true if the copy is valid and its sequence number differs from
+     last_seq
+   */
+  bool poll(uint64_t last_seq, StatusSlot& copy) const {
+    // the slot is written by the NIC, force a fresh read from memory
+    std::atomic_thread_fence(std::memory_order_acquire);
+    std::memcpy(&copy, this, sizeof(copy));
+    return copy.seq != last_seq &&
+           copy.check == checksum(copy.seq, copy.message);
+  }
+
+  /// FNV-1a hash over the sequence number and the message.
+  static uint64_t checksum(uint64_t seq, const Message& message) {
+    uint64_t hash = UINT64_C(14695981039346656037);
+    auto mix = [&hash](const void* ptr, std::size_t size) {
+      const auto* bytes = static_cast<const uint8_t*>(ptr);
+      for (std::size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * UINT64_C(1099511628211);
+      }
+    };
+    mix(&seq, sizeof(seq));
+    mix(&message, sizeof(message));
+    return hash;
+  }
+};
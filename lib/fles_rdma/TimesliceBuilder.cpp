@@ -8,6 +8,7 @@
 #include "TimesliceWorkItem.hpp"
 #include "log.hpp"
 #include <algorithm>
+#include <arpa/inet.h>
 #include <limits>
 #include <memory>
 
@@ -18,27 +19,54 @@ TimesliceBuilder::TimesliceBuilder(uint64_t compute_index,
                                    unsigned short service,
                                    uint32_t num_input_nodes,
                                    uint32_t timeslice_size,
+                                   uint32_t num_compute_nodes,
                                    volatile sig_atomic_t* signal_status,
                                    bool drop,
+                                   uint32_t num_progress_threads,
+                                   ProgressMode progress_mode,
+                                   std::chrono::microseconds spin_time,
                                    cbm::Monitor* monitor)
-    : compute_index_(compute_index), timeslice_buffer_(timeslice_buffer),
+    : IBConnectionGroup(
+          progress_mode,
+          spin_time,
+          std::max(UINT32_C(1),
+                   std::min(num_progress_threads, num_input_nodes))),
+      compute_index_(compute_index), timeslice_buffer_(timeslice_buffer),
       service_(service), num_input_nodes_(num_input_nodes),
-      timeslice_size_(timeslice_size),
+      timeslice_size_(timeslice_size), num_compute_nodes_(num_compute_nodes),
       ack_(timeslice_buffer_.get_desc_size_exp()),
-      signal_status_(signal_status), drop_(drop), monitor_(monitor) {
+      signal_status_(signal_status), drop_(drop),
+      aggregator_(num_completion_queues()),
+      monitor_(monitor) {
   assert(timeslice_buffer_.get_num_input_nodes() == num_input_nodes);
 
   hostname_ = fles::system::current_hostname();
+  arrival_age_ = DataAgeMetric(
+      monitor_,
+      {{"host", hostname_}, {"output_index", std::to_string(compute_index_)}},
+      "arrival");
+
+  // connection i is handled by shard i % n
+  shards_.resize(aggregator_.num_shards());
+  for (uint_fast16_t i = 0; i < num_input_nodes; ++i) {
+    shards_.at(i % shards_.size()).connections.push_back(i);
+  }
+  for (auto& shard : shards_) {
+    shard.red_lantern = shard.connections.front();
+  }
+  if (shards_.size() > 1) {
+    L_(info) << "[c" << compute_index_ << "] using " << shards_.size()
+             << " progress threads";
+  }
 
   previous_recv_buffer_status_data_.resize(num_input_nodes);
   previous_recv_buffer_status_desc_.resize(num_input_nodes);
+  components_published_.resize(num_input_nodes);
 }
 
-TimesliceBuilder::~TimesliceBuilder() = default;
+TimesliceBuilder::~TimesliceBuilder() { join_shards(); }
 
 void TimesliceBuilder::report_status() {
-  constexpr auto interval = std::chrono::seconds(1);
-
   std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
 
   L_(debug) << "[c" << compute_index_ << "] " << completely_written_
@@ -54,6 +82,8 @@ void TimesliceBuilder::report_status() {
   float min_freeing_plus_free_desc = std::numeric_limits<float>::max();
   float min_freeing_plus_free_data = std::numeric_limits<float>::max();
 
+  // the connection statistics are read without synchronization with the
+  // progress threads, so they may be slightly out of date
   for (auto& c : conn_) {
     auto status_desc = c->buffer_status_desc();
     auto status_data = c->buffer_status_data();
@@ -118,7 +148,8 @@ void TimesliceBuilder::report_status() {
                              {"desc_used", status_desc.used()},
                              {"desc_freeing", status_desc.freeing()},
                              {"desc_free", status_desc.unused()},
-                             {"desc_rate", rate_desc}});
+                             {"desc_rate", rate_desc},
+                             {"ack_messages", c->ack_messages()}});
     }
 
     previous_recv_buffer_status_data_.at(c->index()) = status_data;
@@ -162,16 +193,23 @@ void TimesliceBuilder::report_status() {
          {"work_items", timeslice_buffer_.get_num_work_items()}});
   }
 
-  scheduler_.add([this] { report_status(); }, now + interval);
+  if (perf_counters_.enabled()) {
+    perf_counters_.report(
+        monitor_,
+        {{"host", hostname_}, {"output_index", std::to_string(compute_index_)}},
+        completely_written_ - perf_reported_timeslices_);
+    perf_reported_timeslices_ = completely_written_;
+  }
+
+  scheduler_.add([this] { report_status(); }, now + status_interval_);
 }
 
 void TimesliceBuilder::request_abort() {
   L_(info) << "[c" << compute_index_ << "] "
            << "request abort";
 
-  for (auto& connection : conn_) {
-    connection->request_abort();
-  }
+  // passed to the connections by their progress threads
+  abort_requested_ = true;
 }
 
 /// The thread main function.
@@ -180,7 +218,9 @@ void TimesliceBuilder::operator()() {
     // set_cpu(0);
 
     accept(service_, num_input_nodes_);
-    while (connected_ != num_input_nodes_) {
+    // an input node establishes the control connection before the
+    // connection it belongs to
+    while (connected_ != num_input_nodes_ + num_control_connections()) {
       poll_cm_events();
     }
     L_(info) << "[c" << compute_index_ << "] "
@@ -188,11 +228,36 @@ void TimesliceBuilder::operator()() {
 
     time_begin_ = std::chrono::high_resolution_clock::now();
 
+    start_shards();
+    if (perf_counters_enabled_) {
+      perf_counters_.enable();
+    }
     report_status();
     while (!all_done_ || connected_ != 0 || timewait_ != 0) {
       if (!all_done_) {
+        perf_counters_.enter(PerfPoll);
         poll_completion();
+        progress_shard(shards_.front());
+        bool done = (connections_done_ == conn_.size());
+        perf_counters_.enter(PerfPost);
+        send_completed_timeslices();
+        perf_counters_.enter(PerfBookkeeping);
         poll_ts_completion();
+        if (done || stop_shards_) {
+          join_shards();
+          for (auto& shard : shards_) {
+            if (shard.error) {
+              std::rethrow_exception(shard.error);
+            }
+          }
+          for (auto& c : conn_) {
+            if (!c->abort_flag()) {
+              assert(timeslice_buffer_.get_num_work_items() == 0);
+              assert(timeslice_buffer_.get_num_completions() == 0);
+            }
+          }
+          all_done_ = true;
+        }
       }
       if (connected_ != 0 || timewait_ != 0) {
         poll_cm_events();
@@ -209,6 +274,138 @@ void TimesliceBuilder::operator()() {
     summary();
   } catch (std::exception& e) {
     L_(error) << "exception in TimesliceBuilder: " << e.what();
+    join_shards();
+  }
+}
+
+void TimesliceBuilder::start_shards() {
+  for (size_t s = 1; s < shards_.size(); ++s) {
+    shard_threads_.emplace_back([this, s] { run_shard(s); });
+  }
+}
+
+void TimesliceBuilder::join_shards() {
+  stop_shards_ = true;
+  for (auto& thread : shard_threads_) {
+    thread.join();
+  }
+  shard_threads_.clear();
+}
+
+void TimesliceBuilder::run_shard(size_t s) {
+  ProgressShard& shard = shards_[s];
+  try {
+    while (!stop_shards_) {
+      poll_completion(s);
+      progress_shard(shard);
+    }
+  } catch (std::exception& e) {
+    L_(error) << "exception in TimesliceBuilder progress thread: " << e.what();
+    shard.error = std::current_exception();
+    stop_shards_ = true;
+  }
+}
+
+void TimesliceBuilder::progress_shard(ProgressShard& shard) {
+  uint64_t acked = aggregator_.acked();
+  if (acked != shard.acked) {
+    shard.acked = acked;
+    for (auto i : shard.connections) {
+      conn_[i]->inc_ack_pointers(acked);
+    }
+  }
+  if (abort_requested_ && !shard.abort_forwarded) {
+    shard.abort_forwarded = true;
+    for (auto i : shard.connections) {
+      conn_[i]->request_abort();
+    }
+  }
+  for (auto i : shard.connections) {
+    if (conn_[i]->poll_status()) {
+      publish_components(i);
+      update_red_lantern(i);
+    }
+    if (conn_[i]->try_pull()) {
+      publish_components(i);
+      update_red_lantern(i);
+    }
+    conn_[i]->try_write_status();
+  }
+}
+
+void TimesliceBuilder::update_red_lantern(size_t in) {
+  size_t s = in % shards_.size();
+  ProgressShard& shard = shards_[s];
+  if (in == shard.red_lantern) {
+    auto new_red_lantern = std::min_element(
+        std::begin(shard.connections), std::end(shard.connections),
+        [this](uint_fast16_t v1, uint_fast16_t v2) {
+          return conn_[v1]->cn_wp().desc < conn_[v2]->cn_wp().desc;
+        });
+
+    shard.red_lantern = *new_red_lantern;
+    aggregator_.publish_written(s, conn_[shard.red_lantern]->cn_wp().desc);
+  }
+}
+
+void TimesliceBuilder::publish_components(size_t in) {
+  if (!timeslice_buffer_.partial_delivery()) {
+    return;
+  }
+  uint64_t written = conn_[in]->cn_wp().desc;
+  for (uint64_t tpos = components_published_[in]; tpos < written; ++tpos) {
+    timeslice_buffer_.set_component_complete(static_cast<uint32_t>(in), tpos);
+  }
+  components_published_[in] = written;
+}
+
+void TimesliceBuilder::send_partial_timeslices() {
+  partially_sent_ = std::max(partially_sent_, completely_written_);
+  while (true) {
+    // the index is taken from the first complete component
+    uint32_t c = 0;
+    while (c < conn_.size() &&
+           !timeslice_buffer_.component_complete(c, partially_sent_)) {
+      ++c;
+    }
+    if (c == conn_.size()) {
+      return;
+    }
+    uint64_t ts_index = timeslice_buffer_.get_desc(c, partially_sent_).ts_num;
+    timeslice_buffer_.send_partial_work_item(
+        {{ts_index, partially_sent_, timeslice_size_,
+          static_cast<uint32_t>(conn_.size())},
+         timeslice_buffer_.get_max_data_size_exp(),
+         timeslice_buffer_.get_desc_size_exp()});
+    ++partially_sent_;
+  }
+}
+
+void TimesliceBuilder::send_completed_timeslices() {
+  uint64_t new_completely_written = aggregator_.completely_written();
+
+  for (uint64_t tpos = completely_written_; tpos < new_completely_written;
+       ++tpos) {
+    if (arrival_age_.enabled() && !conn_.empty()) {
+      arrival_age_.record(timeslice_buffer_.get_start_time(tpos));
+    }
+    if (!drop_) {
+      uint64_t ts_index = UINT64_MAX;
+      if (!conn_.empty()) {
+        ts_index = timeslice_buffer_.get_desc(0, tpos).ts_num;
+      }
+      timeslice_buffer_.send_work_item(
+          {{ts_index, tpos, timeslice_size_,
+            static_cast<uint32_t>(conn_.size())},
+           timeslice_buffer_.get_max_data_size_exp(),
+           timeslice_buffer_.get_desc_size_exp()});
+    }
+  }
+
+  completely_written_ = new_completely_written;
+
+  if (timeslice_buffer_.partial_delivery() && !drop_) {
+    send_partial_timeslices();
   }
 }
 
@@ -222,17 +419,32 @@ void TimesliceBuilder::on_connect_request(struct rdma_cm_event* event) {
       *reinterpret_cast<const InputNodeInfo*>(event->param.conn.private_data);
 
   uint_fast16_t index = remote_info.index;
+
+  if (remote_info.control) {
+    assert(index < control_conn_.size() && control_conn_.at(index) == nullptr);
+    control_conn_.at(index) = std::make_unique<ControlConnection>(
+        ec_, index, compute_index_, event->id);
+    control_conn_.at(index)->on_connect_request(
+        event, pd_, completion_queue(index % num_completion_queues()));
+    return;
+  }
+
   assert(index < conn_.size() && conn_.at(index) == nullptr);
 
   std::unique_ptr<ComputeNodeConnection> conn(new ComputeNodeConnection(
       ec_, index, compute_index_, event->id, remote_info,
       timeslice_buffer_.get_data_ptr(index),
-      timeslice_buffer_.get_data_size_exp(),
+      timeslice_buffer_.get_data_size_exp(index),
       timeslice_buffer_.get_desc_ptr(index),
-      timeslice_buffer_.get_desc_size_exp()));
+      timeslice_buffer_.get_desc_size_exp(), timeslice_size_,
+      num_compute_nodes_));
+  conn->set_control_connection(control_conn_.at(index).get());
+  conn->set_ack_coalescing(ack_coalescing_);
+  conn->set_summary_buffer(timeslice_buffer_.get_summary_ptr(index));
   conn_.at(index) = std::move(conn);
 
-  conn_.at(index)->on_connect_request(event, pd_, cq_);
+  conn_.at(index)->on_connect_request(
+      event, pd_, completion_queue(index % num_completion_queues()));
 }
 
 /// Completion notification event dispatcher. Called by the event loop.
@@ -250,50 +462,36 @@ void TimesliceBuilder::on_completion(const struct ibv_wc& wc) {
     conn_[in]->on_complete_send();
     break;
 
+  case ID_WRITE_STATUS:
+    conn_[in]->on_complete_send();
+    break;
+
   case ID_SEND_FINALIZE: {
-    if (!conn_[in]->abort_flag()) {
-      assert(timeslice_buffer_.get_num_work_items() == 0);
-      assert(timeslice_buffer_.get_num_completions() == 0);
-    }
     conn_[in]->on_complete_send();
     conn_[in]->on_complete_send_finalize();
-    ++connections_done_;
-    all_done_ = (connections_done_ == conn_.size());
+    unsigned int done = ++connections_done_;
     L_(debug) << "[c" << compute_index_ << "] "
               << "SEND FINALIZE complete for id " << in
-              << " all_done=" << all_done_;
+              << " all_done=" << (done == conn_.size());
   } break;
 
-  case ID_RECEIVE_STATUS: {
-    conn_[in]->on_complete_recv();
-    if (connected_ == conn_.size() && in == red_lantern_) {
-      auto new_red_lantern = std::min_element(
-          std::begin(conn_), std::end(conn_),
-          [](const std::unique_ptr<ComputeNodeConnection>& v1,
-             const std::unique_ptr<ComputeNodeConnection>& v2) {
-            return v1->cn_wp().desc < v2->cn_wp().desc;
-          });
-
-      uint64_t new_completely_written = (*new_red_lantern)->cn_wp().desc;
-      red_lantern_ = std::distance(std::begin(conn_), new_red_lantern);
-
-      for (uint64_t tpos = completely_written_; tpos < new_completely_written;
-           ++tpos) {
-        if (!drop_) {
-          uint64_t ts_index = UINT64_MAX;
-          if (!conn_.empty()) {
-            ts_index = timeslice_buffer_.get_desc(0, tpos).ts_num;
-          }
-          timeslice_buffer_.send_work_item(
-              {{ts_index, tpos, timeslice_size_,
-                static_cast<uint32_t>(conn_.size())},
-               timeslice_buffer_.get_data_size_exp(),
-               timeslice_buffer_.get_desc_size_exp()});
-        }
-      }
+  case ID_READ_DESC:
+    conn_[in]->on_complete_pull_desc();
+    break;
 
-      completely_written_ = new_completely_written;
+  case ID_READ_DATA:
+    if (conn_[in]->on_complete_pull_data()) {
+      update_red_lantern(in);
     }
+    break;
+
+  case ID_RECEIVE_STATUS: {
+    if (wc.opcode == IBV_WC_RECV_RDMA_WITH_IMM) {
+      conn_[in]->on_complete_write_with_imm(ntohl(wc.imm_data));
+    } else {
+      conn_[in]->on_complete_recv();
+    }
+    update_red_lantern(in);
   } break;
 
   default:
@@ -310,9 +508,7 @@ void TimesliceBuilder::poll_ts_completion() {
     do {
       ++acked_;
     } while (ack_.at(acked_) > c.ts_pos);
-    for (auto& connection : conn_) {
-      connection->inc_ack_pointers(acked_);
-    }
+    aggregator_.publish_acked(acked_);
   } else {
     ack_.at(c.ts_pos) = c.ts_pos;
   }
@@ -2,16 +2,32 @@
 #pragma once
 
 #include "ComputeNodeConnection.hpp"
+#include "DataAgeMetric.hpp"
 #include "IBConnectionGroup.hpp"
 #include "Monitor.hpp"
+#include "PerfCounters.hpp"
 #include "RingBuffer.hpp"
+#include "TimesliceAggregator.hpp"
 #include "TimesliceBuffer.hpp"
+#include <atomic>
 #include <csignal>
+#include <exception>
+#include <thread>
 #include <vector>
 
 /// Timeslice receiver and input node connection container class.
 /** A TimesliceBuilder object represents a group of timeslice building
- connections to input nodes and receives timeslices to a timeslice buffer. */
+ connections to input nodes and receives timeslices to a timeslice buffer.
+
+ The connections may be distributed over several progress threads (shards),
+ each polling its own completion queue of the connection group. The first
+ shard runs on the main
+ thread, which also hands completed timeslices to the timeslice buffer once
+ all shards have delivered their components.
+
+ Input nodes in pull mode announce their components, which the connections
+ read on their own whenever the buffer has space (see
+ ComputeNodeConnection). */
 
 class TimesliceBuilder : public IBConnectionGroup<ComputeNodeConnection> {
 public:
@@ -21,8 +37,12 @@ public:
                    unsigned short service,
                    uint32_t num_input_nodes,
                    uint32_t timeslice_size,
+                   uint32_t num_compute_nodes,
                    volatile sig_atomic_t* signal_status,
                    bool drop,
+                   uint32_t num_progress_threads,
+                   ProgressMode progress_mode,
+                   std::chrono::microseconds spin_time,
                    cbm::Monitor* monitor);
 
   TimesliceBuilder(const TimesliceBuilder&) = delete;
@@ -33,6 +53,21 @@ public:
 
   void report_status();
 
+  /// Set the interval of the status reports (default: 1 s).
+  void set_status_interval(std::chrono::milliseconds interval) {
+    status_interval_ = interval;
+  }
+
+  /// Enable the hardware performance counters of the main builder thread,
+  /// which are published per loop phase with the status reports.
+  void set_perf_counters(bool enable) { perf_counters_enabled_ = enable; }
+
+  /// Set the parameters of the acknowledgement coalescing of the
+  /// connections to be established (see AckCoalescer).
+  void set_ack_coalescing(const AckCoalescer::Parameters& parameters) {
+    ack_coalescing_ = parameters;
+  }
+
   void request_abort();
 
   void operator()() override;
@@ -50,6 +85,52 @@ public:
   void poll_ts_completion();
 
 private:
+  /// Progress state of the connections handled by one thread.
+  struct ProgressShard {
+    /// Indices of the connections of this shard
+    std::vector<uint_fast16_t> connections;
+
+    /// Connection with the lowest write position in this shard
+    uint_fast16_t red_lantern = 0;
+
+    /// Acknowledged position last passed to the connections
+    uint64_t acked = 0;
+
+    /// Whether the abort request has been passed to the connections
+    bool abort_forwarded = false;
+
+    /// Exception that terminated the progress thread
+    std::exception_ptr error;
+  };
+
+  /// Start the progress threads of all but the first shard.
+  void start_shards();
+
+  /// Stop and join all progress threads.
+  void join_shards();
+
+  /// The progress thread main function.
+  void run_shard(size_t s);
+
+  /// Pass acknowledgements and abort requests to the shard's connections
+  /// and poll their status slots in pointer write mode.
+  void progress_shard(ProgressShard& shard);
+
+  /// Update the shard's slowest connection after a write pointer update
+  /// and publish the shard's written position.
+  void update_red_lantern(size_t in);
+
+  /// Hand timeslices completely written on all shards to the buffer.
+  void send_completed_timeslices();
+
+  /// Mark the components newly written by a connection as complete in the
+  /// buffer (partial delivery only).
+  void publish_components(size_t in);
+
+  /// Hand on the timeslices with at least one complete component to the
+  /// buffer ahead of their completion (partial delivery only).
+  void send_partial_timeslices();
+
   uint64_t compute_index_;
   TimesliceBuffer& timeslice_buffer_;
 
@@ -58,16 +139,34 @@ private:
 
   uint32_t timeslice_size_;
 
-  size_t red_lantern_ = 0;
+  /// Number of compute nodes (to locate the components in pull mode).
+  uint32_t num_compute_nodes_;
+
   uint64_t completely_written_ = 0;
   uint64_t acked_ = 0;
 
+  /// Timeslices before this one have been handed on (partial delivery).
+  uint64_t partially_sent_ = 0;
+
+  /// Per-connection write positions marked as complete in the buffer, each
+  /// updated by the connection's shard only (partial delivery).
+  std::vector<uint64_t> components_published_;
+
   /// Buffer to store acknowledged status of timeslices.
   RingBuffer<uint64_t, true> ack_;
 
   volatile sig_atomic_t* signal_status_;
   bool drop_;
 
+  std::vector<ProgressShard> shards_;
+  std::vector<std::thread> shard_threads_;
+
+  /// Per-shard write positions and the acknowledged position
+  TimesliceAggregator aggregator_;
+
+  std::atomic<bool> stop_shards_{false};
+  std::atomic<bool> abort_requested_{false};
+
   std::vector<ComputeNodeConnection::BufferStatus>
       previous_recv_buffer_status_desc_;
   std::vector<ComputeNodeConnection::BufferStatus>
@@ -75,4 +174,20 @@ private:
 
   cbm::Monitor* monitor_;
   std::string hostname_;
+
+  /// Age of the timeslices when all components have arrived
+  DataAgeMetric arrival_age_;
+
+  /// Interval of the status reports
+  std::chrono::milliseconds status_interval_{1000};
+
+  /// Parameters of the acknowledgement coalescing of the connections
+  AckCoalescer::Parameters ack_coalescing_;
+
+  /// Phases of the builder loop for the performance counters
+  enum PerfPhase : std::size_t { PerfPoll, PerfPost, PerfBookkeeping };
+
+  bool perf_counters_enabled_ = false;
+  PhasePerfCounters perf_counters_{{"poll", "post", "bookkeeping"}};
+  uint64_t perf_reported_timeslices_ = 0;
 };
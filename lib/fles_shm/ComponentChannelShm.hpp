@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#pragma once
+
+#include "RingBufferView.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/// Timeslice component request from a TimesliceBuilderShm.
+/** A ComponentRequestShm carries the free space (credit) of the builder's
+    receive buffers for this input and the current write index of its data
+    buffer, at which the sender places the component. */
+
+struct ComponentRequestShm {
+  /// The index of the requested timeslice.
+  uint64_t timeslice;
+
+  /// Free space in the descriptor buffer (in descriptors).
+  uint64_t desc_credit;
+
+  /// Free contiguous space in the data buffer (in bytes).
+  uint64_t data_credit;
+
+  /// The write index of the data buffer.
+  uint64_t data_write_index;
+};
+
+/// Reply of a ComponentSenderShm to a component request.
+/** If desc_size is zero, the component is not yet available or does not
+    fit, and the builder has to ask again. Otherwise the component has been
+    copied to the data buffer at the given offset. */
+
+struct ComponentReplyShm {
+  /// The index of the timeslice.
+  uint64_t timeslice;
+
+  /// The offset in the data buffer the component was copied to.
+  uint64_t offset;
+
+  /// Size of the microslice descriptors (in bytes).
+  uint64_t desc_size;
+
+  /// Size of the microslice data (in bytes).
+  uint64_t data_size;
+};
+
+/// In-process component channel between one input and one output.
+/** A ComponentChannelShm connects a ComponentSenderShm and a
+    TimesliceBuilderShm running in the same process. The builder posts a
+    request, the sender copies the component straight into the builder's
+    data buffer and posts the reply. At most one request is outstanding, so
+    a single state variable orders the accesses of the two threads. */
+
+class ComponentChannelShm {
+public:
+  /// Set the data buffer of the builder the components are copied to.
+  /** Must be called before the threads of sender and builder are
+      started. */
+  void attach(uint8_t* data_ptr, std::size_t data_size_exponent) {
+    data_ptr_ = data_ptr;
+    data_size_exponent_ = data_size_exponent;
+  }
+
+  /// Retrieve the data buffer of the builder.
+  [[nodiscard]] RingBufferView<uint8_t> target() const {
+    return {data_ptr_, data_size_exponent_};
+  }
+
+  /// Post a component request (builder side).
+  void post_request(const ComponentRequestShm& request) {
+    request_ = request;
+    state_.store(Requested, std::memory_order_release);
+  }
+
+  /// Retrieve a pending component request (sender side).
+  bool poll_request(ComponentRequestShm& request) const {
+    if (state_.load(std::memory_order_acquire) != Requested) {
+      return false;
+    }
+    request = request_;
+    return true;
+  }
+
+  /// Post the reply to the pending request (sender side).
+  void post_reply(const ComponentReplyShm& reply) {
+    reply_ = reply;
+    state_.store(Replied, std::memory_order_release);
+  }
+
+  /// Retrieve the reply to the posted request (builder side).
+  bool poll_reply(ComponentReplyShm& reply) {
+    if (state_.load(std::memory_order_acquire) != Replied) {
+      return false;
+    }
+    reply = reply_;
+    state_.store(Idle, std::memory_order_relaxed);
+    return true;
+  }
+
+private:
+  enum State : uint32_t { Idle, Requested, Replied };
+
+  /// The channel state, on a cache line of its own.
+  alignas(64) std::atomic<uint32_t> state_{Idle};
+
+  alignas(64) ComponentRequestShm request_{};
+  ComponentReplyShm reply_{};
+
+  uint8_t* data_ptr_ = nullptr;
+  std::size_t data_size_exponent_ = 0;
+};
@@ -0,0 +1,284 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "ComponentSenderShm.hpp"
+#include "EventTrace.hpp"
+#include "MicrosliceDescriptor.hpp"
+#include "StreamingCopy.hpp"
+#include "System.hpp"
+#include "Utility.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+namespace {
+/// Delay before polling the channels again if no request was pending.
+constexpr auto idle_interval = std::chrono::microseconds(20);
+} // namespace
+
+ComponentSenderShm::ComponentSenderShm(
+    uint64_t input_index,
+    InputBufferReadInterface& data_source,
+    std::vector<ComponentChannelShm*> channels,
+    uint32_t timeslice_size,
+    uint32_t overlap_size,
+    uint64_t timeslice_duration,
+    uint64_t overlap_duration,
+    uint32_t max_timeslice_number,
+    volatile sig_atomic_t* signal_status,
+    cbm::Monitor* monitor)
+    : input_index_(input_index), data_source_(data_source),
+      channels_(std::move(channels)),
+      max_timeslice_number_(max_timeslice_number),
+      signal_status_(signal_status),
+      boundaries_(data_source, timeslice_size, overlap_size,
+                  timeslice_duration, overlap_duration),
+      acks_(data_source, boundaries_), monitor_(monitor) {
+  start_index_ = sent_ = data_source.get_read_index();
+
+  hostname_ = fles::system::current_hostname();
+
+  if (monitor_ != nullptr) {
+    cbm::MetricTagSet tags{{"host", hostname_},
+                           {"input_index", std::to_string(input_index_)}};
+    sent_components_metric_ =
+        monitor_->RegisterCounter("component_sender", tags, "components");
+    credit_stalls_metric_ =
+        monitor_->RegisterCounter("component_sender", tags, "credit_stalls");
+    component_bytes_metric_ =
+        monitor_->RegisterHistogram("component_sender", tags, "bytes");
+  }
+}
+
+void ComponentSenderShm::operator()() {
+  run_begin();
+  while (acks_.acked_timeslices() < max_timeslice_number_ &&
+         *signal_status_ == 0) {
+    run_cycle();
+    scheduler_.timer();
+  }
+  run_end();
+}
+
+void ComponentSenderShm::run_begin() {
+  data_source_.proceed();
+  time_begin_ = std::chrono::high_resolution_clock::now();
+  report_status();
+}
+
+bool ComponentSenderShm::run_cycle() {
+  bool served = false;
+  for (auto* channel : channels_) {
+    ComponentRequestShm request{};
+    if (channel->poll_request(request)) {
+      try_send_timeslice(*channel, request);
+      served = true;
+    }
+  }
+
+  if (!served) {
+    std::this_thread::sleep_for(idle_interval);
+  }
+  data_source_.proceed();
+
+  return true;
+}
+
+void ComponentSenderShm::run_end() {
+  sync_data_source();
+  time_end_ = std::chrono::high_resolution_clock::now();
+}
+
+bool ComponentSenderShm::try_send_timeslice(
+    ComponentChannelShm& channel, const ComponentRequestShm& request) {
+  uint64_t ts = request.timeslice;
+  assert(ts >= acks_.acked_timeslices());
+
+  // check if complete timeslice is available in the input buffer
+  auto range = boundaries_.component(ts, write_index_desc_);
+  if (!range) {
+    data_source_.proceed();
+    write_index_desc_ = data_source_.get_write_index().desc;
+    range = boundaries_.component(ts, write_index_desc_);
+    if (!range) {
+      channel.post_reply({ts, 0, 0, 0});
+      return false;
+    }
+  }
+  uint64_t desc_offset = range->desc_offset;
+  uint64_t desc_length = range->desc_length;
+
+  uint64_t data_offset = data_source_.desc_buffer().at(desc_offset).offset;
+  uint64_t data_end =
+      data_source_.desc_buffer().at(desc_offset + desc_length - 1).offset +
+      data_source_.desc_buffer().at(desc_offset + desc_length - 1).size;
+  assert(data_end >= data_offset);
+  uint64_t data_length = data_end - data_offset;
+
+  // check if the component fits into the receiver's buffers
+  uint64_t desc_bytes = desc_length * sizeof(fles::MicrosliceDescriptor);
+  uint64_t size_required = desc_bytes + data_length;
+  if (request.desc_credit < 1 || request.data_credit < size_required) {
+    ++credit_stalls_;
+    credit_stalls_metric_.Add();
+    channel.post_reply({ts, 0, 0, 0});
+    return false;
+  }
+
+  EventTrace::record(TraceEventType::TimeslicePosted, ts);
+
+  if (desc_offset + desc_length > sent_.desc) {
+    sent_.desc = desc_offset + desc_length;
+  }
+  if (data_offset + data_length > sent_.data) {
+    sent_.data = data_offset + data_length;
+  }
+
+  // place the component like the builder's skip_buffer_wrap() and reserve()
+  RingBufferView<uint8_t> target = channel.target();
+  uint64_t offset = request.data_write_index;
+  if ((offset & target.size_mask()) + size_required > target.size()) {
+    offset += target.size() - (offset & target.size_mask());
+  }
+
+  // descriptors followed by data, copied straight into the timeslice buffer
+  uint8_t* dst = &target.at(offset);
+  dst += copy_chunks(data_source_.desc_buffer(), desc_offset, desc_length,
+                     dst);
+  copy_chunks(data_source_.data_buffer(), data_offset, data_length, dst);
+
+  channel.post_reply({ts, offset, desc_bytes, data_length});
+  ack_timeslice(ts);
+
+  sent_components_metric_.Add();
+  component_bytes_metric_.Record(size_required);
+  return true;
+}
+
+template <typename T_>
+std::size_t ComponentSenderShm::copy_chunks(RingBufferView<T_>& buf,
+                                            uint64_t offset,
+                                            uint64_t length,
+                                            uint8_t* target) {
+  if (length == 0) {
+    // zero chunks
+    return 0;
+  }
+  if (buf.mirrored() || (offset & buf.size_mask()) <=
+                            ((offset + length - 1) & buf.size_mask())) {
+    // one chunk
+    streaming_copy(target, &buf.at(offset), sizeof(T_) * length);
+    return sizeof(T_) * length;
+  }
+  // two chunks
+  size_t size1 = buf.size() - (offset & buf.size_mask());
+  streaming_copy(target, &buf.at(offset), sizeof(T_) * size1);
+  streaming_copy(target + sizeof(T_) * size1, buf.ptr(),
+                 sizeof(T_) * (length - size1));
+  return sizeof(T_) * length;
+}
+
+void ComponentSenderShm::ack_timeslice(uint64_t ts) {
+  EventTrace::record(TraceEventType::WriteCompleted, ts);
+  acks_.ack(ts);
+}
+
+void ComponentSenderShm::sync_data_source() { acks_.sync(); }
+
+void ComponentSenderShm::report_status() {
+  constexpr auto interval = std::chrono::seconds(1);
+
+  std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
+
+  DualIndex written = data_source_.get_write_index();
+
+  // if data_source.written pointers are lagging behind due to lazy updates,
+  // use sent value instead
+  uint64_t written_desc = std::max(written.desc, sent_.desc);
+  uint64_t written_data = std::max(written.data, sent_.data);
+
+  SendBufferStatus status_desc{now,
+                               data_source_.desc_buffer().size(),
+                               acks_.cached_acked().desc,
+                               acks_.acked().desc,
+                               sent_.desc,
+                               written_desc};
+  SendBufferStatus status_data{now,
+                               data_source_.data_buffer().size(),
+                               acks_.cached_acked().data,
+                               acks_.acked().data,
+                               sent_.data,
+                               written_data};
+
+  double delta_t =
+      std::chrono::duration<double, std::chrono::seconds::period>(
+          status_desc.time - previous_send_buffer_status_desc_.time)
+          .count();
+  double rate_desc =
+      static_cast<double>(status_desc.acked -
+                          previous_send_buffer_status_desc_.acked) /
+      delta_t;
+  double rate_data =
+      static_cast<double>(status_data.acked -
+                          previous_send_buffer_status_data_.acked) /
+      delta_t;
+
+  // retrieve SubsystemIdentifier and EquipmentIdentifier
+  // from most current MicrosliceDescriptor
+  auto sys_id = static_cast<fles::Subsystem>(0);
+  std::string eq_id("Undefined");
+  if (written_desc > 0) {
+    sys_id = static_cast<fles::Subsystem>(
+        data_source_.desc_buffer().at(written_desc - 1).sys_id);
+    std::stringstream eq_id_ss;
+    eq_id_ss << std::hex << std::uppercase << std::setfill('0') << std::setw(4)
+             << data_source_.desc_buffer().at(written_desc - 1).eq_id;
+    eq_id = eq_id_ss.str();
+  }
+
+  L_(debug) << "[i" << input_index_ << "] desc " << status_desc.percentages()
+            << " (used..free) | "
+            << human_readable_count(status_desc.acked, true, "") << " ("
+            << human_readable_count(rate_desc, true, "Hz") << ")";
+
+  L_(debug) << "[i" << input_index_ << "] data " << status_data.percentages()
+            << " (used..free) | "
+            << human_readable_count(status_data.acked, true) << " ("
+            << human_readable_count(rate_data, true, "B/s") << ")";
+
+  L_(debug) << "[i" << input_index_ << "] " << credit_stalls_
+            << " requests declined for lack of receiver credit";
+
+  L_(info) << "[i" << input_index_ << "] |"
+           << bar_graph(status_data.vector(), "#x._", 20) << "|"
+           << bar_graph(status_desc.vector(), "#x._", 10) << "| "
+           << human_readable_count(rate_data, true, "B/s") << " ("
+           << human_readable_count(rate_desc, true, "Hz") << ")";
+
+  if (monitor_ != nullptr) {
+    monitor_->QueueMetric("send_buffer_status",
+                          {{"host", hostname_},
+                           {"input_index", std::to_string(input_index_)},
+                           {"sys_id", fles::to_string(sys_id)},
+                           {"eq_id", eq_id}},
+                          {{"data_used", status_data.used()},
+                           {"data_sending", status_data.sending()},
+                           {"data_freeing", status_data.freeing()},
+                           {"data_free", status_data.unused()},
+                           {"data_rate", rate_data},
+                           {"desc_used", status_desc.used()},
+                           {"desc_sending", status_desc.sending()},
+                           {"desc_freeing", status_desc.freeing()},
+                           {"desc_free", status_desc.unused()},
+                           {"desc_rate", rate_desc}});
+  }
+
+  previous_send_buffer_status_desc_ = status_desc;
+  previous_send_buffer_status_data_ = status_data;
+
+  scheduler_.add([this] { report_status(); }, now + interval);
+}
@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#pragma once
+
+#include "ComponentChannelShm.hpp"
+#include "DualRingBuffer.hpp"
+#include "Monitor.hpp"
+#include "RingBufferView.hpp"
+#include "Scheduler.hpp"
+#include "SendBufferStatus.hpp"
+#include "TimesliceAckTracker.hpp"
+#include "TimesliceBoundaries.hpp"
+#include <chrono>
+#include <csignal>
+#include <string>
+#include <vector>
+
+/// Input buffer and compute node connection container class (SHM).
+/** A ComponentSenderShm object represents an input buffer (filled by a
+    FLIB) that serves timeslice component requests from the timeslice
+    builders running in the same process. Each component is copied once,
+    straight from the input buffer into the timeslice buffer of the
+    requesting builder. */
+
+class ComponentSenderShm {
+public:
+  /// The ComponentSenderShm default constructor.
+  ComponentSenderShm(uint64_t input_index,
+                     InputBufferReadInterface& data_source,
+                     std::vector<ComponentChannelShm*> channels,
+                     uint32_t timeslice_size,
+                     uint32_t overlap_size,
+                     uint64_t timeslice_duration,
+                     uint64_t overlap_duration,
+                     uint32_t max_timeslice_number,
+                     volatile sig_atomic_t* signal_status,
+                     cbm::Monitor* monitor);
+
+  ComponentSenderShm(const ComponentSenderShm&) = delete;
+  void operator=(const ComponentSenderShm&) = delete;
+
+  /// The ComponentSenderShm default destructor.
+  ~ComponentSenderShm() = default;
+
+  /// The thread main function.
+  void operator()();
+
+  /**
+   * @brief Return a text description of the object (to be used as a thread
+   * name).
+   *
+   * @return A string describing the object (at most 15 characters long).
+   */
+  [[nodiscard]] std::string thread_name() const {
+    return "CS/SHM/i" + std::to_string(input_index_);
+  };
+
+private:
+  /// This component's index in the list of input components.
+  uint64_t input_index_;
+
+  /// Data source (e.g., FLIB via shared memory).
+  InputBufferReadInterface& data_source_;
+
+  /// The channels to the timeslice builders, one per output.
+  const std::vector<ComponentChannelShm*> channels_;
+
+  /// Number of timeslices after which this run shall end.
+  const uint32_t max_timeslice_number_;
+
+  /// Pointer to global signal status variable.
+  volatile sig_atomic_t* signal_status_;
+
+  /// Descriptor ranges of the timeslice components.
+  TimesliceBoundaries<InputBufferReadInterface> boundaries_;
+
+  /// Acknowledgment accounting of the sent timeslices.
+  TimesliceAckTracker<InputBufferReadInterface> acks_;
+
+  /// Read indexes at start of operation.
+  DualIndex start_index_{};
+
+  /// Write index received from data source.
+  uint64_t write_index_desc_ = 0;
+
+  /// Begin of operation (for performance statistics).
+  std::chrono::high_resolution_clock::time_point time_begin_;
+
+  /// End of operation (for performance statistics).
+  std::chrono::high_resolution_clock::time_point time_end_;
+
+  /// Amount of data sent (for performance statistics).
+  DualIndex sent_{};
+
+  /// Number of requests declined for lack of receiver credit.
+  uint64_t credit_stalls_ = 0;
+
+  cbm::Monitor* monitor_;
+  std::string hostname_;
+
+  /// Per-request metrics (registered once, recorded without allocation).
+  cbm::MetricCounter sent_components_metric_;
+  cbm::MetricCounter credit_stalls_metric_;
+  cbm::MetricHistogram component_bytes_metric_;
+
+  SendBufferStatus previous_send_buffer_status_desc_ = SendBufferStatus();
+  SendBufferStatus previous_send_buffer_status_data_ = SendBufferStatus();
+
+  /// Scheduler for periodic events.
+  Scheduler scheduler_;
+
+  /// Setup at begin of run.
+  void run_begin();
+
+  /// A single cycle in the main run loop.
+  bool run_cycle();
+
+  /// Cleanup at end of run.
+  void run_end();
+
+  /// The central function for distributing timeslice data.
+  bool try_send_timeslice(ComponentChannelShm& channel,
+                          const ComponentRequestShm& request);
+
+  /// Copy the (one or two) chunks of a ring buffer region to a target.
+  template <typename T_>
+  std::size_t copy_chunks(RingBufferView<T_>& buf,
+                          uint64_t offset,
+                          uint64_t length,
+                          uint8_t* target);
+
+  /// Update read indexes after timeslice has been sent.
+  void ack_timeslice(uint64_t ts);
+
+  /// Force writing read indexes to data source.
+  void sync_data_source();
+
+  /// Print a (periodic) buffer status report.
+  void report_status();
+};
@@ -0,0 +1,249 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "TimesliceBuilderShm.hpp"
+#include "MicrosliceDescriptor.hpp"
+#include "System.hpp"
+#include "TimesliceCompletion.hpp"
+#include "TimesliceWorkItem.hpp"
+#include "Utility.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <cassert>
+#include <thread>
+#include <utility>
+
+namespace {
+/// Delay before polling the channels again if no reply was pending.
+constexpr auto idle_interval = std::chrono::microseconds(20);
+
+/// Delay before asking again for a component that was not available.
+constexpr auto retry_interval = std::chrono::microseconds(100);
+} // namespace
+
+TimesliceBuilderShm::TimesliceBuilderShm(
+    uint64_t compute_index,
+    TimesliceBuffer& timeslice_buffer,
+    std::vector<ComponentChannelShm*> channels,
+    uint32_t num_compute_nodes,
+    uint32_t timeslice_size,
+    uint32_t max_timeslice_number,
+    volatile sig_atomic_t* signal_status,
+    cbm::Monitor* monitor)
+    : compute_index_(compute_index), timeslice_buffer_(timeslice_buffer),
+      num_compute_nodes_(num_compute_nodes), timeslice_size_(timeslice_size),
+      max_timeslice_number_(max_timeslice_number),
+      signal_status_(signal_status), ts_index_(compute_index_),
+      ack_(timeslice_buffer_.get_desc_size_exp()), monitor_(monitor) {
+  for (size_t i = 0; i < channels.size(); ++i) {
+    channels.at(i)->attach(timeslice_buffer_.get_data_ptr(i),
+                           timeslice_buffer_.get_data_size_exp(i));
+    connections_.push_back(
+        std::make_unique<Connection>(timeslice_buffer_, i, *channels.at(i)));
+  }
+
+  hostname_ = fles::system::current_hostname();
+
+  if (monitor_ != nullptr) {
+    build_time_metric_ = monitor_->RegisterHistogram(
+        "timeslice_builder",
+        {{"host", hostname_}, {"output_index", std::to_string(compute_index_)}},
+        "build_time_ns");
+  }
+}
+
+void TimesliceBuilderShm::operator()() {
+  run_begin();
+  while (ts_index_ < max_timeslice_number_ && *signal_status_ == 0) {
+    run_cycle();
+    scheduler_.timer();
+  }
+  run_end();
+}
+
+void TimesliceBuilderShm::run_begin() {
+  assert(!connections_.empty());
+  time_begin_ = std::chrono::high_resolution_clock::now();
+  previous_report_time_ = std::chrono::system_clock::now();
+  report_status();
+
+  if (ts_index_ < max_timeslice_number_) {
+    build_begin_ = std::chrono::steady_clock::now();
+    for (auto& c : connections_) {
+      request_component(*c);
+    }
+  }
+}
+
+bool TimesliceBuilderShm::run_cycle() {
+  bool replied = false;
+  for (auto& c : connections_) {
+    ComponentReplyShm reply{};
+    if (c->state == Connection::State::Requested &&
+        c->channel.poll_reply(reply)) {
+      handle_reply(*c, reply);
+      replied = true;
+    }
+  }
+
+  if (components_received_ == connections_.size()) {
+    complete_timeslice();
+  } else if (!replied) {
+    std::this_thread::sleep_for(idle_interval);
+  }
+
+  return true;
+}
+
+void TimesliceBuilderShm::run_end() {
+  time_end_ = std::chrono::high_resolution_clock::now();
+
+  // wait until all pending timeslices have been acknowledged
+  while (acked_ < tpos_ && *signal_status_ == 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    handle_timeslice_completions();
+  }
+}
+
+void TimesliceBuilderShm::request_component(Connection& c) {
+  // advertise the free buffer space and where the component is to be placed
+  c.channel.post_request({ts_index_, c.desc.size_available(),
+                          c.data.size_available_contiguous(),
+                          c.data.write_index()});
+  c.state = Connection::State::Requested;
+}
+
+void TimesliceBuilderShm::handle_reply(Connection& c,
+                                       const ComponentReplyShm& reply) {
+  assert(reply.timeslice == ts_index_);
+  if (reply.desc_size == 0) {
+    // not yet available or no credit, free buffer space while waiting
+    ++retries_;
+    handle_timeslice_completions();
+    c.state = Connection::State::Idle;
+    Connection* conn = &c;
+    scheduler_.add([this, conn] { request_component(*conn); },
+                   std::chrono::steady_clock::now() + retry_interval);
+    return;
+  }
+
+  uint64_t size_required = reply.desc_size + reply.data_size;
+
+  // the sender only replies if the component fits into the advertised space
+  assert(c.data.size_available_contiguous() >= size_required &&
+         c.desc.size_available() >= 1);
+
+  // account for the space the sender has filled at the same position
+  c.data.skip_buffer_wrap(size_required);
+  [[maybe_unused]] uint64_t offset = c.data.reserve(size_required);
+  assert(offset == reply.offset);
+
+  // generate timeslice component descriptor
+  assert(tpos_ == c.desc.write_index());
+  c.desc.append({ts_index_, reply.offset, size_required,
+                 reply.desc_size / sizeof(fles::MicrosliceDescriptor)});
+
+  c.state = Connection::State::Complete;
+  ++components_received_;
+}
+
+void TimesliceBuilderShm::complete_timeslice() {
+  handle_timeslice_completions();
+
+  build_time_metric_.Record(static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - build_begin_)
+          .count()));
+
+  timeslice_buffer_.send_work_item(
+      {{ts_index_, tpos_, timeslice_size_,
+        static_cast<uint32_t>(connections_.size())},
+       timeslice_buffer_.get_max_data_size_exp(),
+       timeslice_buffer_.get_desc_size_exp()});
+  ++tpos_;
+  // next timeslice: round robin
+  ts_index_ += num_compute_nodes_;
+
+  components_received_ = 0;
+  if (ts_index_ >= max_timeslice_number_) {
+    return;
+  }
+  build_begin_ = std::chrono::steady_clock::now();
+  for (auto& c : connections_) {
+    request_component(*c);
+  }
+}
+
+void TimesliceBuilderShm::handle_timeslice_completions() {
+  ItemCompletionBatch batch;
+  while (timeslice_buffer_.try_receive_completions(batch)) {
+    uint64_t acked = std::max(acked_, batch.completed_up_to);
+    // Mark out-of-order completions, then advance over all consecutive ones
+    for (auto ts_pos : batch.completed) {
+      if (ts_pos >= acked) {
+        ack_.at(ts_pos) = ts_pos + 1;
+      }
+    }
+    while (ack_.at(acked) == acked + 1) {
+      ++acked;
+    }
+    if (acked != acked_) {
+      acked_ = acked;
+      for (auto& conn : connections_) {
+        conn->desc.set_read_index(acked_);
+        conn->data.set_read_index(conn->desc.at(acked_ - 1).offset +
+                                  conn->desc.at(acked_ - 1).size);
+      }
+    }
+  }
+}
+
+void TimesliceBuilderShm::report_status() {
+  constexpr auto interval = std::chrono::seconds(1);
+
+  std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
+
+  auto desc_size = static_cast<int64_t>(connections_.at(0)->desc.size());
+  auto desc_used = static_cast<int64_t>(tpos_ - acked_);
+  int64_t data_size = 0;
+  int64_t data_used = 0;
+  for (auto& c : connections_) {
+    data_size += static_cast<int64_t>(c->data.size());
+    data_used += static_cast<int64_t>(c->data.size_used());
+  }
+
+  double delta_t = std::chrono::duration<double, std::chrono::seconds::period>(
+                       now - previous_report_time_)
+                       .count();
+  double rate_desc =
+      delta_t > 0 ? static_cast<double>(acked_ - previous_acked_) / delta_t
+                  : 0;
+
+  L_(debug) << "[c" << compute_index_ << "] "
+            << human_readable_count(acked_, true, "") << " timeslices, "
+            << retries_ << " empty replies";
+
+  L_(info) << "[c" << compute_index_ << "] |"
+           << bar_graph(std::vector<int64_t>{data_used, data_size - data_used},
+                        "#_", 20)
+           << "|"
+           << bar_graph(std::vector<int64_t>{desc_used, desc_size - desc_used},
+                        "#_", 10)
+           << "| " << human_readable_count(rate_desc, true, "Hz");
+
+  if (monitor_ != nullptr) {
+    monitor_->QueueMetric("recv_buffer_status",
+                          {{"host", hostname_},
+                           {"output_index", std::to_string(compute_index_)}},
+                          {{"data_used", data_used},
+                           {"data_free", data_size - data_used},
+                           {"desc_used", desc_used},
+                           {"desc_free", desc_size - desc_used},
+                           {"desc_rate", rate_desc}});
+  }
+
+  previous_acked_ = acked_;
+  previous_report_time_ = now;
+
+  scheduler_.add([this] { report_status(); }, now + interval);
+}
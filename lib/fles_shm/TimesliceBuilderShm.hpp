@@ -0,0 +1,167 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#pragma once
+
+#include "ComponentChannelShm.hpp"
+#include "ManagedRingBuffer.hpp"
+#include "Monitor.hpp"
+#include "RingBuffer.hpp"
+#include "Scheduler.hpp"
+#include "TimesliceBuffer.hpp"
+#include <chrono>
+#include <csignal>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The TimesliceBuilderShm class
+ *
+ * A TimesliceBuilderShm object receives timeslices to a timeslice buffer
+ * from the inputs running in the same process. The components of a
+ * timeslice are requested from all inputs at once, and each input copies
+ * its component straight into the timeslice buffer.
+ */
+
+class TimesliceBuilderShm {
+public:
+  /// The TimesliceBuilderShm constructor.
+  TimesliceBuilderShm(uint64_t compute_index,
+                      TimesliceBuffer& timeslice_buffer,
+                      std::vector<ComponentChannelShm*> channels,
+                      uint32_t num_compute_nodes,
+                      uint32_t timeslice_size,
+                      uint32_t max_timeslice_number,
+                      volatile sig_atomic_t* signal_status,
+                      cbm::Monitor* monitor);
+
+  TimesliceBuilderShm(const TimesliceBuilderShm&) = delete;
+  void operator=(const TimesliceBuilderShm&) = delete;
+
+  /// The TimesliceBuilderShm destructor.
+  ~TimesliceBuilderShm() = default;
+
+  /// The thread main function.
+  void operator()();
+
+  /**
+   * @brief Return a text description of the object (to be used as a thread
+   * name).
+   *
+   * @return A string describing the object (at most 15 characters long).
+   */
+  [[nodiscard]] std::string thread_name() const {
+    return "TSB/SHM/o" + std::to_string(compute_index_);
+  };
+
+private:
+  /// Connection struct, handles data for one input.
+  struct Connection {
+    Connection(TimesliceBuffer& timeslice_buffer,
+               size_t i,
+               ComponentChannelShm& c)
+        : desc(timeslice_buffer.get_desc_ptr(i),
+               timeslice_buffer.get_desc_size_exp()),
+          data(timeslice_buffer.get_data_ptr(i),
+               timeslice_buffer.get_data_size_exp(i)),
+          index(i), channel(c) {}
+
+    ManagedRingBuffer<fles::TimesliceComponentDescriptor> desc;
+    ManagedRingBuffer<uint8_t> data;
+
+    /// The index of the input.
+    const size_t index;
+
+    /// The channel to the input's component sender.
+    ComponentChannelShm& channel;
+
+    enum class State { Idle, Requested, Complete };
+
+    /// The reception state of the current component.
+    State state = State::Idle;
+  };
+
+  /// This builder's index in the list of compute nodes.
+  const uint64_t compute_index_;
+
+  /// Shared memory buffer to store received timeslices.
+  TimesliceBuffer& timeslice_buffer_;
+
+  /// Number of compute nodes.
+  const uint32_t num_compute_nodes_;
+
+  /// Constant size (in microslices) of a timeslice component.
+  const uint32_t timeslice_size_;
+
+  /// Number of timeslices after which this run shall end.
+  const uint32_t max_timeslice_number_;
+
+  /// Pointer to global signal status variable.
+  volatile sig_atomic_t* signal_status_;
+
+  /// Index of acknowledged timeslices (local index).
+  uint64_t acked_ = 0;
+
+  /// The global index of the timeslice currently being received.
+  uint64_t ts_index_;
+
+  /// The local buffer position of the timeslice currently being received.
+  uint64_t tpos_ = 0;
+
+  /// The number of components of the current timeslice received.
+  uint64_t components_received_ = 0;
+
+  /// Buffer to store acknowledged status of timeslices.
+  RingBuffer<uint64_t, true> ack_;
+
+  /// The vector of connections, one per input.
+  std::vector<std::unique_ptr<Connection>> connections_;
+
+  /// Begin of operation (for performance statistics).
+  std::chrono::high_resolution_clock::time_point time_begin_;
+
+  /// End of operation (for performance statistics).
+  std::chrono::high_resolution_clock::time_point time_end_;
+
+  /// Time of the first request for the current timeslice.
+  std::chrono::steady_clock::time_point build_begin_{};
+
+  cbm::Monitor* monitor_;
+  std::string hostname_;
+
+  /// Time from the first component request to the complete timeslice (ns).
+  cbm::MetricHistogram build_time_metric_;
+
+  /// Number of empty replies (component not available or no credit).
+  uint64_t retries_ = 0;
+
+  uint64_t previous_acked_ = 0;
+  std::chrono::system_clock::time_point previous_report_time_;
+
+  /// Scheduler for delayed and periodic events.
+  Scheduler scheduler_;
+
+  /// Setup at begin of run.
+  void run_begin();
+
+  /// A single cycle in the main run loop.
+  bool run_cycle();
+
+  /// Cleanup at end of run.
+  void run_end();
+
+  /// Request the component of the current timeslice from an input.
+  void request_component(Connection& c);
+
+  /// Handle the reply of an input to the pending request.
+  void handle_reply(Connection& c, const ComponentReplyShm& reply);
+
+  /// Hand the completed timeslice to the buffer and start the next one.
+  void complete_timeslice();
+
+  /// Handle pending timeslice completions and advance read indexes.
+  void handle_timeslice_completions();
+
+  /// Print a (periodic) buffer status report.
+  void report_status();
+};
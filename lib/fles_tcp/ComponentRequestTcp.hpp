@@ -0,0 +1,146 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+/// First message on each stream from a TimesliceBuilderTcp.
+/** A StreamHelloTcp identifies the compute node and the position of the
+    stream within the group of parallel streams of the connection. It also
+    carries the payload compression requested for the connection, which
+    the sender applies if its build supports the codec. */
+
+struct StreamHelloTcp {
+  /// The index of the compute node.
+  uint64_t compute_index;
+
+  /// The index of the stream within the connection.
+  uint64_t stream_index;
+
+  /// The number of parallel streams of the connection.
+  uint64_t num_streams;
+
+  /// The requested codec (fles::ChunkCodecId, zero: uncompressed).
+  uint16_t codec;
+
+  /// The word size parameter of the requested codec.
+  uint16_t codec_word_size;
+
+  /// The requested compression level.
+  int32_t codec_level;
+};
+
+/// Timeslice component request from a TimesliceBuilderTcp.
+/** A ComponentRequestTcp is sent on the first stream of a connection to
+    request the component of a timeslice from a ComponentSenderTcp. It
+    carries the free space (credit) of the builder's receive buffers for
+    this input connection, so that the sender only replies with components
+    that fit. */
+
+struct ComponentRequestTcp {
+  /// The index of the requested timeslice.
+  uint64_t timeslice;
+
+  /// Free space in the descriptor buffer (in descriptors).
+  uint64_t desc_credit;
+
+  /// Free contiguous space in the data buffer (in bytes).
+  uint64_t data_credit;
+
+  /// Whether to omit the overlap contents (see ComponentReplyTcp).
+  uint64_t share_overlap;
+};
+
+/// Header of the reply of a ComponentSenderTcp.
+/** The header is sent on the first stream of a connection. The payload,
+    i.e., the microslice descriptors followed by the microslice contents,
+    is split into contiguous slices (see tcp_slice()) that follow on the
+    parallel streams. A reply without descriptors signals that the
+    component is not yet available or does not fit into the advertised
+    space, and the builder has to ask again.
+
+    A compressed payload consists of a table of the encoded sizes of the
+    frames (see tcp_frame()) as uint64_t values, followed by the encoded
+    frames, which the builder decodes into the advertised space.
+
+    With overlap sharing, the payload lacks the trailing shared_size bytes
+    of the microslice contents, i.e., the contents of the overlap
+    microslices. These are the first contents of the component of the next
+    timeslice, which the builder fetches from the builder of that
+    timeslice (see OverlapRequestTcp). */
+
+struct ComponentReplyTcp {
+  /// The index of the timeslice.
+  uint64_t timeslice;
+
+  /// Size of the microslice descriptors (in bytes, zero: not available).
+  uint64_t desc_size;
+
+  /// Size of the microslice contents (in bytes).
+  uint64_t data_size;
+
+  /// Size of the compressed payload (in bytes, zero: uncompressed).
+  uint64_t encoded_size;
+
+  /// Size of the overlap contents omitted from the payload (in bytes).
+  uint64_t shared_size;
+};
+
+/// Retrieve the size of the uncompressed payload of a reply.
+inline uint64_t tcp_payload_size(const ComponentReplyTcp& reply) {
+  return reply.desc_size + reply.data_size - reply.shared_size;
+}
+
+/// Overlap content request between timeslice builders.
+/** A TimesliceBuilderTcp sends an OverlapRequestTcp for each component of
+    its timeslices to the builder of the next timeslice, which replies with
+    the first size bytes of the microslice contents of the component of
+    that timeslice as soon as it has received it. Requests are answered in
+    order and without a header, requests of size zero without data. The
+    builder keeps the buffer space of a timeslice until the requests for
+    all of its components have been answered. */
+
+struct OverlapRequestTcp {
+  /// The index of the timeslice holding the overlap contents.
+  uint64_t timeslice;
+
+  /// The index of the input (component).
+  uint64_t input_index;
+
+  /// The size of the requested contents (in bytes).
+  uint64_t size;
+};
+
+/// Minimum size of a payload slice worth a stream of its own (in bytes).
+constexpr uint64_t tcp_min_slice_size = UINT64_C(64) << 10;
+
+/// Retrieve the offset and length of the payload slice sent on a stream.
+/** Small payloads are sent on fewer streams, so that each slice has at
+    least tcp_min_slice_size bytes (except for a payload smaller than
+    that). The slices of the unused streams are empty. */
+inline std::pair<uint64_t, uint64_t>
+tcp_slice(uint64_t size, uint64_t num_streams, uint64_t stream) {
+  uint64_t count =
+      std::clamp<uint64_t>(size / tcp_min_slice_size, 1, num_streams);
+  uint64_t slice_size = (size + count - 1) / count;
+  uint64_t begin = std::min(size, stream * slice_size);
+  uint64_t end = std::min(size, begin + slice_size);
+  return {begin, end - begin};
+}
+
+/// Size of the payload frames compressed independently (in bytes).
+constexpr uint64_t tcp_frame_size = UINT64_C(1) << 20;
+
+/// Retrieve the number of frames of a compressed payload.
+inline uint64_t tcp_frame_count(uint64_t size) {
+  return (size + tcp_frame_size - 1) / tcp_frame_size;
+}
+
+/// Retrieve the offset and length of a frame of a compressed payload.
+inline std::pair<uint64_t, uint64_t> tcp_frame(uint64_t size, uint64_t frame) {
+  uint64_t begin = std::min(size, frame * tcp_frame_size);
+  uint64_t end = std::min(size, begin + tcp_frame_size);
+  return {begin, end - begin};
+}
@@ -0,0 +1,673 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "ComponentSenderTcp.hpp"
+#include "EventTrace.hpp"
+#include "MicrosliceDescriptor.hpp"
+#include "System.hpp"
+#include "TcpException.hpp"
+#include "Utility.hpp"
+#include "WorkerPool.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <iomanip>
+#include <sstream>
+#include <unistd.h>
+
+namespace {
+/// Maximum time to wait for socket events in a cycle (in milliseconds).
+constexpr int poll_timeout_ms = 1;
+
+/// Compress a frame of a payload given by its chunks in the input buffer.
+std::string encode_frame(const fles::ChunkCodec& codec,
+                         const iovec* chunks,
+                         std::size_t chunk_count,
+                         uint64_t size,
+                         uint64_t desc_bytes,
+                         uint64_t frame) {
+  auto [frame_begin, frame_length] = tcp_frame(size, frame);
+  uint64_t frame_end = frame_begin + frame_length;
+  const uint8_t* data = nullptr;
+  std::vector<uint8_t> gathered;
+  uint64_t chunk_begin = 0;
+  for (std::size_t i = 0; i < chunk_count && chunk_begin < frame_end; ++i) {
+    const auto* base = static_cast<const uint8_t*>(chunks[i].iov_base);
+    uint64_t chunk_end = chunk_begin + chunks[i].iov_len;
+    if (chunk_begin <= frame_begin && frame_end <= chunk_end) {
+      // the frame is contiguous in the input buffer
+      data = base + (frame_begin - chunk_begin);
+      break;
+    }
+    uint64_t begin = std::max(frame_begin, chunk_begin);
+    uint64_t end = std::min(frame_end, chunk_end);
+    if (begin < end) {
+      gathered.insert(gathered.end(), base + (begin - chunk_begin),
+                      base + (end - chunk_begin));
+    }
+    chunk_begin = chunk_end;
+  }
+  if (data == nullptr) {
+    data = gathered.data();
+  }
+  uint64_t frame_desc_bytes =
+      desc_bytes > frame_begin ? std::min(desc_bytes - frame_begin,
+                                          frame_length)
+                               : 0;
+  return codec.encode(data, frame_length, frame_desc_bytes);
+}
+} // namespace
+
+ComponentSenderTcp::ComponentSenderTcp(uint64_t input_index,
+                                       InputBufferReadInterface& data_source,
+                                       uint16_t listen_port,
+                                       uint32_t timeslice_size,
+                                       uint32_t overlap_size,
+                                       uint64_t timeslice_duration,
+                                       uint64_t overlap_duration,
+                                       uint32_t max_timeslice_number,
+                                       bool zerocopy,
+                                       unsigned compression_threads,
+                                       volatile sig_atomic_t* signal_status,
+                                       cbm::Monitor* monitor)
+    : input_index_(input_index), data_source_(data_source),
+      max_timeslice_number_(max_timeslice_number), zerocopy_(zerocopy),
+      compression_threads_(compression_threads), signal_status_(signal_status),
+      boundaries_(data_source, timeslice_size, overlap_size,
+                  timeslice_duration, overlap_duration),
+      acks_(data_source, boundaries_), monitor_(monitor) {
+  start_index_ = sent_ = data_source.get_read_index();
+
+  listen_fd_ = TcpStream::listen(listen_port);
+
+  hostname_ = fles::system::current_hostname();
+
+  if (monitor_ != nullptr) {
+    cbm::MetricTagSet tags{{"host", hostname_},
+                           {"input_index", std::to_string(input_index_)}};
+    sent_components_metric_ =
+        monitor_->RegisterCounter("component_sender", tags, "components");
+    credit_stalls_metric_ =
+        monitor_->RegisterCounter("component_sender", tags, "credit_stalls");
+    component_bytes_metric_ =
+        monitor_->RegisterHistogram("component_sender", tags, "bytes");
+    shared_bytes_metric_ =
+        monitor_->RegisterCounter("component_sender", tags, "shared_bytes");
+    compression_in_metric_ = monitor_->RegisterCounter(
+        "component_sender", tags, "compression_in_bytes");
+    compression_out_metric_ = monitor_->RegisterCounter(
+        "component_sender", tags, "compression_out_bytes");
+    compression_time_metric_ = monitor_->RegisterHistogram(
+        "component_sender", tags, "compression_time_ns");
+  }
+}
+
+ComponentSenderTcp::~ComponentSenderTcp() {
+  if (listen_fd_ != -1) {
+    ::close(listen_fd_);
+  }
+}
+
+void ComponentSenderTcp::operator()() {
+  run_begin();
+  while (acks_.acked_timeslices() < max_timeslice_number_ &&
+         *signal_status_ == 0) {
+    run_cycle();
+    scheduler_.timer();
+  }
+  run_end();
+}
+
+void ComponentSenderTcp::run_begin() {
+  data_source_.proceed();
+  time_begin_ = std::chrono::high_resolution_clock::now();
+  report_status();
+}
+
+bool ComponentSenderTcp::run_cycle() {
+  pollfds_.clear();
+  polled_streams_.clear();
+  pollfds_.push_back({listen_fd_, POLLIN, 0});
+  polled_streams_.push_back(nullptr);
+  for (auto& new_stream : new_streams_) {
+    pollfds_.push_back({new_stream->stream->fd(), POLLIN, 0});
+    polled_streams_.push_back(new_stream->stream.get());
+  }
+  for (auto& conn : connections_) {
+    for (auto& stream : conn->streams) {
+      if (stream) {
+        pollfds_.push_back({stream->fd(), stream->poll_events(), 0});
+        polled_streams_.push_back(stream.get());
+      }
+    }
+  }
+
+  // do not wait for socket events while compressions may complete
+  int rc = poll(pollfds_.data(), pollfds_.size(),
+                compressing_ != 0 ? 0 : poll_timeout_ms);
+  if (rc == -1 && errno != EINTR) {
+    throw TcpException(std::string("poll failed: ") + std::strerror(errno));
+  }
+  if (rc <= 0 && compressing_ == 0) {
+    return true;
+  }
+
+  if (rc > 0) {
+    for (std::size_t i = 1; i < pollfds_.size(); ++i) {
+      if (pollfds_[i].revents != 0) {
+        polled_streams_[i]->handle_events(pollfds_[i].revents);
+      }
+    }
+  }
+
+  handle_new_streams(rc > 0 && (pollfds_[0].revents & POLLIN) != 0);
+
+  for (auto& conn : connections_) {
+    handle_connection(*conn);
+  }
+
+  // drop the connections closed by their builder
+  for (auto it = connections_.begin(); it != connections_.end();) {
+    auto& streams = (*it)->streams;
+    if (std::any_of(streams.begin(), streams.end(),
+                    [](const auto& s) { return s && s->closed(); })) {
+      close_connection(**it);
+      it = connections_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  return true;
+}
+
+void ComponentSenderTcp::run_end() {
+  sync_data_source();
+  time_end_ = std::chrono::high_resolution_clock::now();
+}
+
+void ComponentSenderTcp::handle_new_streams(bool accept_pending) {
+  while (accept_pending) {
+    auto stream = TcpStream::accept(listen_fd_);
+    if (!stream) {
+      break;
+    }
+    if (zerocopy_ && !stream->enable_zerocopy()) {
+      L_(debug) << "[i" << input_index_ << "] zero-copy sends not supported";
+    }
+    auto new_stream = std::make_unique<NewStream>();
+    new_stream->stream = std::move(stream);
+    new_stream->stream->receive(&new_stream->hello, sizeof(StreamHelloTcp));
+    new_streams_.push_back(std::move(new_stream));
+  }
+
+  for (auto it = new_streams_.begin(); it != new_streams_.end();) {
+    NewStream& new_stream = **it;
+    if (new_stream.stream->receive_pending() && !new_stream.stream->closed()) {
+      ++it;
+      continue;
+    }
+    const StreamHelloTcp& hello = new_stream.hello;
+    if (new_stream.stream->closed() || hello.num_streams == 0 ||
+        hello.stream_index >= hello.num_streams) {
+      L_(warning) << "[i" << input_index_ << "] invalid stream dropped";
+      it = new_streams_.erase(it);
+      continue;
+    }
+
+    auto conn_it = std::find_if(connections_.begin(), connections_.end(),
+                                [&hello](const auto& c) {
+                                  return c->compute_index ==
+                                         hello.compute_index;
+                                });
+    if (conn_it == connections_.end()) {
+      auto conn = std::make_unique<BuilderConnection>();
+      conn->compute_index = hello.compute_index;
+      conn->streams.resize(hello.num_streams);
+      if (hello.codec != 0) {
+        try {
+          conn->codec = fles::make_chunk_codec(
+              static_cast<fles::ChunkCodecId>(hello.codec),
+              static_cast<uint8_t>(hello.codec_word_size), hello.codec_level);
+        } catch (std::exception const& e) {
+          L_(warning) << "[i" << input_index_ << "] compute node "
+                      << hello.compute_index << ": " << e.what()
+                      << ", sending uncompressed";
+        }
+      }
+      if (conn->codec && compression_threads_ > 0 && !compression_pool_) {
+        compression_pool_ = std::make_unique<WorkerPool>(compression_threads_);
+      }
+      connections_.push_back(std::move(conn));
+      conn_it = std::prev(connections_.end());
+    }
+    BuilderConnection& conn = **conn_it;
+    if (conn.streams.size() != hello.num_streams ||
+        conn.streams.at(hello.stream_index)) {
+      L_(warning) << "[i" << input_index_ << "] duplicate stream dropped";
+      it = new_streams_.erase(it);
+      continue;
+    }
+    conn.streams.at(hello.stream_index) = std::move(new_stream.stream);
+    if (++conn.connected_streams == conn.streams.size()) {
+      L_(debug) << "[i" << input_index_ << "] compute node "
+                << conn.compute_index << " connected with "
+                << conn.streams.size() << " streams"
+                << (conn.codec ? ", compression " + conn.codec->name() : "");
+      conn.streams.front()->receive(&conn.request, sizeof(conn.request));
+    }
+    it = new_streams_.erase(it);
+  }
+}
+
+void ComponentSenderTcp::handle_connection(BuilderConnection& conn) {
+  if (conn.connected_streams < conn.streams.size()) {
+    return;
+  }
+
+  if (conn.compressing) {
+    finish_compression(conn);
+  }
+
+  TcpStream& control = *conn.streams.front();
+  if (!control.closed() && !control.receive_pending()) {
+    ComponentRequestTcp request = conn.request;
+    control.receive(&conn.request, sizeof(conn.request));
+    try_send_timeslice(conn, request);
+    data_source_.proceed();
+  }
+  discard_skipped(conn);
+
+  // release the buffers of the components the kernel is done with
+  while (!conn.sent_components.empty()) {
+    const SentComponent& component = conn.sent_components.front();
+    for (std::size_t k = 0; k < conn.streams.size(); ++k) {
+      if (conn.streams[k]->released() < component.end[k]) {
+        return;
+      }
+    }
+    ack_timeslice(component.timeslice);
+    conn.sent_components.pop_front();
+  }
+}
+
+void ComponentSenderTcp::discard_skipped(BuilderConnection& conn) {
+  while (!conn.skipped.empty() &&
+         boundaries_.component(conn.skipped.front(),
+                               data_source_.get_write_index().desc)) {
+    ack_timeslice(conn.skipped.front());
+    conn.skipped.pop_front();
+    ++skipped_components_;
+  }
+}
+
+void ComponentSenderTcp::close_connection(BuilderConnection& conn) {
+  L_(debug) << "[i" << input_index_ << "] compute node " << conn.compute_index
+            << " disconnected";
+  if (conn.compressing) {
+    // the compression threads may still read the input buffer
+    for (auto& done : conn.compressing->done) {
+      done.wait();
+    }
+    ack_timeslice(conn.compressing->reply.timeslice);
+    conn.compressing.reset();
+    --compressing_;
+  }
+  for (const auto& component : conn.sent_components) {
+    ack_timeslice(component.timeslice);
+  }
+  conn.sent_components.clear();
+}
+
+bool ComponentSenderTcp::try_send_timeslice(
+    BuilderConnection& conn, const ComponentRequestTcp& request) {
+  uint64_t ts = request.timeslice;
+  assert(ts >= acks_.acked_timeslices());
+  TcpStream& control = *conn.streams.front();
+
+  if (conn.declined && *conn.declined != ts) {
+    // the builder has given up on the declined component
+    conn.skipped.push_back(*conn.declined);
+  }
+  conn.declined = ts;
+
+  // check if complete timeslice is available in the input buffer
+  auto range = boundaries_.component(ts, write_index_desc_);
+  if (!range) {
+    data_source_.proceed();
+    write_index_desc_ = data_source_.get_write_index().desc;
+    range = boundaries_.component(ts, write_index_desc_);
+    if (!range) {
+      ComponentReplyTcp reply{ts, 0, 0, 0, 0};
+      control.send_copy(&reply, sizeof(reply));
+      control.progress_send();
+      return false;
+    }
+  }
+  uint64_t desc_offset = range->desc_offset;
+  uint64_t desc_length = range->desc_length;
+
+  uint64_t data_offset = data_source_.desc_buffer().at(desc_offset).offset;
+  uint64_t data_end =
+      data_source_.desc_buffer().at(desc_offset + desc_length - 1).offset +
+      data_source_.desc_buffer().at(desc_offset + desc_length - 1).size;
+  assert(data_end >= data_offset);
+  uint64_t data_length = data_end - data_offset;
+
+  // check if the component fits into the receiver's buffers
+  uint64_t desc_bytes = desc_length * sizeof(fles::MicrosliceDescriptor);
+  uint64_t size_required = desc_bytes + data_length;
+  if (request.desc_credit < 1 || request.data_credit < size_required) {
+    ++credit_stalls_;
+    credit_stalls_metric_.Add();
+    ComponentReplyTcp reply{ts, 0, 0, 0, 0};
+    control.send_copy(&reply, sizeof(reply));
+    control.progress_send();
+    return false;
+  }
+
+  EventTrace::record(TraceEventType::TimeslicePosted, ts);
+  conn.declined.reset();
+
+  if (desc_offset + desc_length > sent_.desc) {
+    sent_.desc = desc_offset + desc_length;
+  }
+  if (data_offset + data_length > sent_.data) {
+    sent_.data = data_offset + data_length;
+  }
+
+  // the overlap contents start the component of the next timeslice, the
+  // builder fetches them from the builder of that timeslice (count mode with
+  // an overlap not exceeding the core only, so they are in its core)
+  uint64_t shared_size = 0;
+  if (request.share_overlap != 0 && ts + 1 < max_timeslice_number_ &&
+      !boundaries_.time_based() && range->core_length < desc_length &&
+      desc_length - range->core_length <= range->core_length) {
+    shared_size =
+        data_end -
+        data_source_.desc_buffer().at(desc_offset + range->core_length).offset;
+    shared_bytes_ += shared_size;
+    shared_bytes_metric_.Add(shared_size);
+  }
+
+  ComponentReplyTcp reply{ts, desc_bytes, data_length, 0, shared_size};
+
+  // descriptors followed by data, sent in place from the input buffer
+  std::array<iovec, 4> chunks{};
+  std::size_t chunk_count = add_chunks(data_source_.desc_buffer(),
+                                       desc_offset, desc_length, chunks.data());
+  chunk_count +=
+      add_chunks(data_source_.data_buffer(), data_offset,
+                 data_length - shared_size, chunks.data() + chunk_count);
+
+  if (conn.codec) {
+    start_compression(conn, reply, chunks, chunk_count);
+    return true;
+  }
+  send_component(conn, reply, chunks.data(), chunk_count, {});
+  return true;
+}
+
+void ComponentSenderTcp::send_component(BuilderConnection& conn,
+                                        const ComponentReplyTcp& reply,
+                                        const iovec* chunks,
+                                        std::size_t chunk_count,
+                                        std::vector<uint8_t> encoded) {
+  conn.streams.front()->send_copy(&reply, sizeof(reply));
+
+  uint64_t size = 0;
+  for (std::size_t i = 0; i < chunk_count; ++i) {
+    size += chunks[i].iov_len;
+  }
+
+  // split the payload into one contiguous slice per stream
+  SentComponent component{reply.timeslice, {}, std::move(encoded)};
+  for (std::size_t k = 0; k < conn.streams.size(); ++k) {
+    auto [slice_begin, slice_length] = tcp_slice(size, conn.streams.size(), k);
+    uint64_t slice_end = slice_begin + slice_length;
+    uint64_t chunk_begin = 0;
+    for (std::size_t i = 0; i < chunk_count && chunk_begin < slice_end; ++i) {
+      uint64_t chunk_end = chunk_begin + chunks[i].iov_len;
+      uint64_t begin = std::max(slice_begin, chunk_begin);
+      uint64_t end = std::min(slice_end, chunk_end);
+      if (begin < end) {
+        conn.streams[k]->send(static_cast<uint8_t*>(chunks[i].iov_base) +
+                                  (begin - chunk_begin),
+                              end - begin);
+      }
+      chunk_begin = chunk_end;
+    }
+    component.end.push_back(conn.streams[k]->queued());
+    conn.streams[k]->progress_send();
+  }
+  conn.sent_components.push_back(std::move(component));
+
+  sent_components_metric_.Add();
+  component_bytes_metric_.Record(tcp_payload_size(reply));
+}
+
+void ComponentSenderTcp::start_compression(BuilderConnection& conn,
+                                           const ComponentReplyTcp& reply,
+                                           const std::array<iovec, 4>& chunks,
+                                           std::size_t chunk_count) {
+  auto c = std::make_unique<CompressingComponent>();
+  c->reply = reply;
+  c->chunks = chunks;
+  c->chunk_count = chunk_count;
+  c->begin = std::chrono::steady_clock::now();
+  uint64_t size = tcp_payload_size(reply);
+  c->frames.resize(tcp_frame_count(size));
+
+  const fles::ChunkCodec& codec = *conn.codec;
+  for (uint64_t frame = 0; frame < c->frames.size(); ++frame) {
+    auto task = [&codec, pending = c.get(), size, frame] {
+      pending->frames[frame] =
+          encode_frame(codec, pending->chunks.data(), pending->chunk_count,
+                       size, pending->reply.desc_size, frame);
+    };
+    if (compression_pool_) {
+      c->done.push_back(compression_pool_->submit(task));
+    } else {
+      task();
+    }
+  }
+
+  conn.compressing = std::move(c);
+  ++compressing_;
+  finish_compression(conn);
+}
+
+void ComponentSenderTcp::finish_compression(BuilderConnection& conn) {
+  CompressingComponent& c = *conn.compressing;
+  for (auto& done : c.done) {
+    if (done.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+      return;
+    }
+  }
+  for (auto& done : c.done) {
+    done.get();
+  }
+
+  compression_time_metric_.Record(static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - c.begin)
+          .count()));
+
+  uint64_t size = tcp_payload_size(c.reply);
+  uint64_t encoded_size = c.frames.size() * sizeof(uint64_t);
+  for (const auto& frame : c.frames) {
+    encoded_size += frame.size();
+  }
+  compression_in_ += size;
+  compression_in_metric_.Add(size);
+
+  if (encoded_size >= size) {
+    // incompressible, send in place from the input buffer
+    compression_out_ += size;
+    compression_out_metric_.Add(size);
+    send_component(conn, c.reply, c.chunks.data(), c.chunk_count, {});
+  } else {
+    compression_out_ += encoded_size;
+    compression_out_metric_.Add(encoded_size);
+    std::vector<uint8_t> encoded(encoded_size);
+    uint8_t* table = encoded.data();
+    uint8_t* pos = table + c.frames.size() * sizeof(uint64_t);
+    for (std::size_t i = 0; i < c.frames.size(); ++i) {
+      uint64_t frame_size = c.frames[i].size();
+      std::memcpy(table + i * sizeof(uint64_t), &frame_size, sizeof(uint64_t));
+      std::memcpy(pos, c.frames[i].data(), frame_size);
+      pos += frame_size;
+    }
+    c.reply.encoded_size = encoded_size;
+    iovec chunk{encoded.data(), encoded_size};
+    send_component(conn, c.reply, &chunk, 1, std::move(encoded));
+  }
+
+  conn.compressing.reset();
+  --compressing_;
+}
+
+template <typename T_>
+std::size_t ComponentSenderTcp::add_chunks(RingBufferView<T_>& buf,
+                                           uint64_t offset,
+                                           uint64_t length,
+                                           iovec* iov) {
+  if (length == 0) {
+    // zero chunks
+    return 0;
+  }
+  if (buf.mirrored() || (offset & buf.size_mask()) <=
+                            ((offset + length - 1) & buf.size_mask())) {
+    // one chunk
+    iov[0] = {&buf.at(offset), sizeof(T_) * length};
+    return 1;
+  }
+  // two chunks
+  size_t size1 = buf.size() - (offset & buf.size_mask());
+  iov[0] = {&buf.at(offset), sizeof(T_) * size1};
+  iov[1] = {buf.ptr(), sizeof(T_) * (length - size1)};
+  return 2;
+}
+
+void ComponentSenderTcp::ack_timeslice(uint64_t ts) {
+  EventTrace::record(TraceEventType::WriteCompleted, ts);
+  acks_.ack(ts);
+}
+
+void ComponentSenderTcp::sync_data_source() { acks_.sync(); }
+
+void ComponentSenderTcp::report_status() {
+  constexpr auto interval = std::chrono::seconds(1);
+
+  std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
+
+  DualIndex written = data_source_.get_write_index();
+
+  // if data_source.written pointers are lagging behind due to lazy updates,
+  // use sent value instead
+  uint64_t written_desc = std::max(written.desc, sent_.desc);
+  uint64_t written_data = std::max(written.data, sent_.data);
+
+  SendBufferStatus status_desc{now,
+                               data_source_.desc_buffer().size(),
+                               acks_.cached_acked().desc,
+                               acks_.acked().desc,
+                               sent_.desc,
+                               written_desc};
+  SendBufferStatus status_data{now,
+                               data_source_.data_buffer().size(),
+                               acks_.cached_acked().data,
+                               acks_.acked().data,
+                               sent_.data,
+                               written_data};
+
+  double delta_t =
+      std::chrono::duration<double, std::chrono::seconds::period>(
+          status_desc.time - previous_send_buffer_status_desc_.time)
+          .count();
+  double rate_desc =
+      static_cast<double>(status_desc.acked -
+                          previous_send_buffer_status_desc_.acked) /
+      delta_t;
+  double rate_data =
+      static_cast<double>(status_data.acked -
+                          previous_send_buffer_status_data_.acked) /
+      delta_t;
+
+  // retrieve SubsystemIdentifier and EquipmentIdentifier
+  // from most current MicrosliceDescriptor
+  auto sys_id = static_cast<fles::Subsystem>(0);
+  std::string eq_id("Undefined");
+  if (written_desc > 0) {
+    sys_id = static_cast<fles::Subsystem>(
+        data_source_.desc_buffer().at(written_desc - 1).sys_id);
+    std::stringstream eq_id_ss;
+    eq_id_ss << std::hex << std::uppercase << std::setfill('0') << std::setw(4)
+             << data_source_.desc_buffer().at(written_desc - 1).eq_id;
+    eq_id = eq_id_ss.str();
+  }
+
+  L_(debug) << "[i" << input_index_ << "] desc " << status_desc.percentages()
+            << " (used..free) | "
+            << human_readable_count(status_desc.acked, true, "") << " ("
+            << human_readable_count(rate_desc, true, "Hz") << ")";
+
+  L_(debug) << "[i" << input_index_ << "] data " << status_data.percentages()
+            << " (used..free) | "
+            << human_readable_count(status_data.acked, true) << " ("
+            << human_readable_count(rate_data, true, "B/s") << ")";
+
+  L_(debug) << "[i" << input_index_ << "] " << credit_stalls_
+            << " requests declined for lack of receiver credit";
+
+  if (skipped_components_ > 0) {
+    L_(debug) << "[i" << input_index_ << "] " << skipped_components_
+              << " components discarded after the timeslice deadline";
+  }
+
+  if (shared_bytes_ > 0) {
+    L_(debug) << "[i" << input_index_ << "] "
+              << human_readable_count(shared_bytes_)
+              << " of overlap shared by the builders";
+  }
+
+  if (compression_in_ > 0) {
+    L_(debug) << "[i" << input_index_ << "] compression: "
+              << human_readable_count(compression_in_) << " -> "
+              << human_readable_count(compression_out_) << " ("
+              << 100 * compression_out_ / compression_in_ << "%)";
+  }
+
+  L_(info) << "[i" << input_index_ << "] |"
+           << bar_graph(status_data.vector(), "#x._", 20) << "|"
+           << bar_graph(status_desc.vector(), "#x._", 10) << "| "
+           << human_readable_count(rate_data, true, "B/s") << " ("
+           << human_readable_count(rate_desc, true, "Hz") << ")";
+
+  if (monitor_ != nullptr) {
+    monitor_->QueueMetric("send_buffer_status",
+                          {{"host", hostname_},
+                           {"input_index", std::to_string(input_index_)},
+                           {"sys_id", fles::to_string(sys_id)},
+                           {"eq_id", eq_id}},
+                          {{"data_used", status_data.used()},
+                           {"data_sending", status_data.sending()},
+                           {"data_freeing", status_data.freeing()},
+                           {"data_free", status_data.unused()},
+                           {"data_rate", rate_data},
+                           {"desc_used", status_desc.used()},
+                           {"desc_sending", status_desc.sending()},
+                           {"desc_freeing", status_desc.freeing()},
+                           {"desc_free", status_desc.unused()},
+                           {"desc_rate", rate_desc}});
+  }
+
+  previous_send_buffer_status_desc_ = status_desc;
+  previous_send_buffer_status_data_ = status_data;
+
+  scheduler_.add([this] { report_status(); }, now + interval);
+}
@@ -0,0 +1,281 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#pragma once
+
+#include "ChunkCodec.hpp"
+#include "ComponentRequestTcp.hpp"
+#include "DualRingBuffer.hpp"
+#include "Monitor.hpp"
+#include "RingBufferView.hpp"
+#include "Scheduler.hpp"
+#include "SendBufferStatus.hpp"
+#include "TcpStream.hpp"
+#include "TimesliceAckTracker.hpp"
+#include "TimesliceBoundaries.hpp"
+#include <array>
+#include <chrono>
+#include <csignal>
+#include <deque>
+#include <future>
+#include <memory>
+#include <optional>
+#include <poll.h>
+#include <string>
+#include <sys/uio.h>
+#include <vector>
+
+class WorkerPool;
+
+/// Input buffer and compute node connection container class (TCP).
+/** A ComponentSenderTcp object represents an input buffer (filled by a
+    FLIB) that serves timeslice component requests from the timeslice
+    builders on the compute nodes. Each builder connects with a group of
+    parallel TCP streams, over which the components are sent straight from
+    the input buffer (with MSG_ZEROCOPY where supported).
+
+    If a builder requests compression, the components for it are encoded in
+    frames of tcp_frame_size bytes on a pool of compression threads, and
+    the reply is sent once all frames are complete. Components that do not
+    shrink are sent uncompressed.
+
+    Builders sharing the overlap receive the overlap contents of a
+    component from the builder of the next timeslice instead (see
+    OverlapRequestTcp), so they cross the network from the input only
+    once.
+
+    A builder that requests its next timeslice after a declined request
+    has given up on the declined component (see the timeslice deadline of
+    TimesliceBuilderTcp). The component is discarded without being sent
+    once it is available in the input buffer. */
+
+class ComponentSenderTcp {
+public:
+  /// The ComponentSenderTcp default constructor.
+  ComponentSenderTcp(uint64_t input_index,
+                     InputBufferReadInterface& data_source,
+                     uint16_t listen_port,
+                     uint32_t timeslice_size,
+                     uint32_t overlap_size,
+                     uint64_t timeslice_duration,
+                     uint64_t overlap_duration,
+                     uint32_t max_timeslice_number,
+                     bool zerocopy,
+                     unsigned compression_threads,
+                     volatile sig_atomic_t* signal_status,
+                     cbm::Monitor* monitor);
+
+  ComponentSenderTcp(const ComponentSenderTcp&) = delete;
+  void operator=(const ComponentSenderTcp&) = delete;
+
+  /// The ComponentSenderTcp default destructor.
+  ~ComponentSenderTcp();
+
+  /// The thread main function.
+  void operator()();
+
+  /**
+   * @brief Return a text description of the object (to be used as a thread
+   * name).
+   *
+   * @return A string describing the object (at most 15 characters long).
+   */
+  [[nodiscard]] std::string thread_name() const {
+    return "CS/TCP/i" + std::to_string(input_index_);
+  };
+
+private:
+  /// A stream that has connected, but not yet sent its hello message.
+  struct NewStream {
+    std::unique_ptr<TcpStream> stream;
+    StreamHelloTcp hello{};
+  };
+
+  /// A component whose buffers are still in use by the streams.
+  struct SentComponent {
+    uint64_t timeslice;
+    /// The stream positions after the component.
+    std::vector<uint64_t> end;
+    /// The compressed payload (empty if sent from the input buffer).
+    std::vector<uint8_t> encoded;
+  };
+
+  /// A component whose payload frames are being compressed.
+  struct CompressingComponent {
+    /// The reply to send, with the sizes of the uncompressed payload.
+    ComponentReplyTcp reply;
+    /// The payload regions in the input buffer.
+    std::array<iovec, 4> chunks;
+    std::size_t chunk_count;
+    /// The encoded frames.
+    std::vector<std::string> frames;
+    /// The completion of the frames compressed by the pool.
+    std::vector<std::future<void>> done;
+    std::chrono::steady_clock::time_point begin;
+  };
+
+  /// The group of parallel streams from one timeslice builder.
+  struct BuilderConnection {
+    uint64_t compute_index = 0;
+    std::vector<std::unique_ptr<TcpStream>> streams;
+    std::size_t connected_streams = 0;
+    /// Receive buffer for the requests on the first stream.
+    ComponentRequestTcp request{};
+    std::deque<SentComponent> sent_components;
+    /// The codec requested by the builder (nullptr: uncompressed).
+    std::shared_ptr<const fles::ChunkCodec> codec;
+    /// The component awaiting its compression, if any.
+    std::unique_ptr<CompressingComponent> compressing;
+    /// The timeslice of the last request declined, if not yet sent.
+    std::optional<uint64_t> declined;
+    /// Timeslices given up by the builder, discarded once available.
+    std::deque<uint64_t> skipped;
+  };
+
+  /// This component's index in the list of input components.
+  uint64_t input_index_;
+
+  /// Data source (e.g., FLIB via shared memory).
+  InputBufferReadInterface& data_source_;
+
+  /// Number of timeslices after which this run shall end.
+  const uint32_t max_timeslice_number_;
+
+  /// Whether to send large buffers with MSG_ZEROCOPY.
+  const bool zerocopy_;
+
+  /// Number of compression threads (0: compress in the sender thread).
+  const unsigned compression_threads_;
+
+  /// Pointer to global signal status variable.
+  volatile sig_atomic_t* signal_status_;
+
+  /// Listening socket.
+  int listen_fd_ = -1;
+
+  /// Streams awaiting their hello message.
+  std::vector<std::unique_ptr<NewStream>> new_streams_;
+
+  /// Connections of the timeslice builders.
+  std::vector<std::unique_ptr<BuilderConnection>> connections_;
+
+  /// The sockets polled in the current cycle (the first is listen_fd_).
+  std::vector<pollfd> pollfds_;
+
+  /// The streams of the polled sockets.
+  std::vector<TcpStream*> polled_streams_;
+
+  /// Descriptor ranges of the timeslice components.
+  TimesliceBoundaries<InputBufferReadInterface> boundaries_;
+
+  /// Acknowledgment accounting of the sent timeslices.
+  TimesliceAckTracker<InputBufferReadInterface> acks_;
+
+  /// Read indexes at start of operation.
+  DualIndex start_index_{};
+
+  /// Write index received from data source.
+  uint64_t write_index_desc_ = 0;
+
+  /// Begin of operation (for performance statistics).
+  std::chrono::high_resolution_clock::time_point time_begin_;
+
+  /// End of operation (for performance statistics).
+  std::chrono::high_resolution_clock::time_point time_end_;
+
+  /// Amount of data sent (for performance statistics).
+  DualIndex sent_{};
+
+  /// Number of requests declined for lack of receiver credit.
+  uint64_t credit_stalls_ = 0;
+
+  /// Number of components given up by the builders and discarded.
+  uint64_t skipped_components_ = 0;
+
+  /// Number of connections with a component being compressed.
+  std::size_t compressing_ = 0;
+
+  /// Overlap content bytes left to the builders to share.
+  uint64_t shared_bytes_ = 0;
+
+  /// Payload bytes of the compressed components before and after encoding.
+  uint64_t compression_in_ = 0;
+  uint64_t compression_out_ = 0;
+
+  cbm::Monitor* monitor_;
+  std::string hostname_;
+
+  /// Per-request metrics (registered once, recorded without allocation).
+  cbm::MetricCounter sent_components_metric_;
+  cbm::MetricCounter credit_stalls_metric_;
+  cbm::MetricHistogram component_bytes_metric_;
+  cbm::MetricCounter shared_bytes_metric_;
+  cbm::MetricCounter compression_in_metric_;
+  cbm::MetricCounter compression_out_metric_;
+  cbm::MetricHistogram compression_time_metric_;
+
+  SendBufferStatus previous_send_buffer_status_desc_ = SendBufferStatus();
+  SendBufferStatus previous_send_buffer_status_data_ = SendBufferStatus();
+
+  /// Scheduler for periodic events.
+  Scheduler scheduler_;
+
+  /// Compression threads (created with the first compressed connection).
+  std::unique_ptr<WorkerPool> compression_pool_;
+
+  /// Setup at begin of run.
+  void run_begin();
+
+  /// A single cycle in the main run loop.
+  bool run_cycle();
+
+  /// Cleanup at end of run.
+  void run_end();
+
+  /// Accept new streams and assign those that have sent their hello.
+  void handle_new_streams(bool accept_pending);
+
+  /// Serve requests and release the buffers of sent components.
+  void handle_connection(BuilderConnection& conn);
+
+  /// Release the components given up by the builder once available.
+  void discard_skipped(BuilderConnection& conn);
+
+  /// Release all components of a closed connection.
+  void close_connection(BuilderConnection& conn);
+
+  /// The central function for distributing timeslice data.
+  bool try_send_timeslice(BuilderConnection& conn,
+                          const ComponentRequestTcp& request);
+
+  /// Send a reply and split its payload over the streams of a connection.
+  void send_component(BuilderConnection& conn,
+                      const ComponentReplyTcp& reply,
+                      const iovec* chunks,
+                      std::size_t chunk_count,
+                      std::vector<uint8_t> encoded);
+
+  /// Start the compression of a component's payload.
+  void start_compression(BuilderConnection& conn,
+                         const ComponentReplyTcp& reply,
+                         const std::array<iovec, 4>& chunks,
+                         std::size_t chunk_count);
+
+  /// Send the pending compressed component of a connection if complete.
+  void finish_compression(BuilderConnection& conn);
+
+  /// Append the (one or two) chunks of a ring buffer region to an IOV.
+  template <typename T_>
+  std::size_t add_chunks(RingBufferView<T_>& buf,
+                         uint64_t offset,
+                         uint64_t length,
+                         iovec* iov);
+
+  /// Update read indexes after timeslice has been sent.
+  void ack_timeslice(uint64_t ts);
+
+  /// Force writing read indexes to data source.
+  void sync_data_source();
+
+  /// Print a (periodic) buffer status report.
+  void report_status();
+};
@@ -0,0 +1,16 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#pragma once
+
+#include <stdexcept>
+
+/// TCP exception class.
+/** A TcpException object signals an error that occured in the TCP
+    communication functions. */
+
+class TcpException : public std::runtime_error {
+public:
+  /// The TcpException default constructor.
+  explicit TcpException(const std::string& what_arg = "")
+      : std::runtime_error(what_arg) {}
+};
@@ -0,0 +1,339 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "TcpStream.hpp"
+#include "TcpException.hpp"
+#include "log.hpp"
+#include <arpa/inet.h>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <linux/errqueue.h>
+#endif
+
+namespace {
+#if defined(MSG_NOSIGNAL)
+constexpr int send_flags = MSG_DONTWAIT | MSG_NOSIGNAL;
+#else
+constexpr int send_flags = MSG_DONTWAIT;
+#endif
+
+// Compare sequence numbers of zero-copy calls, which wrap around
+bool seq_before(uint32_t a, uint32_t b) {
+  return static_cast<int32_t>(a - b) < 0;
+}
+
+[[noreturn]] void throw_errno(const std::string& what) {
+  throw TcpException(what + ": " + std::strerror(errno));
+}
+} // namespace
+
+TcpStream::TcpStream(int fd) : fd_(fd) {
+  int one = 1;
+  if (setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)) != 0) {
+    L_(warning) << "setsockopt(TCP_NODELAY) failed: " << std::strerror(errno);
+  }
+#if defined(SO_NOSIGPIPE)
+  setsockopt(fd_, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+  int flags = fcntl(fd_, F_GETFL, 0);
+  if (flags == -1 || fcntl(fd_, F_SETFL, flags | O_NONBLOCK) == -1) {
+    ::close(fd_);
+    throw_errno("fcntl(O_NONBLOCK) failed");
+  }
+}
+
+TcpStream::~TcpStream() { ::close(fd_); }
+
+int TcpStream::listen(uint16_t port) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd == -1) {
+    throw_errno("socket failed");
+  }
+  int one = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(port);
+  if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+      ::listen(fd, SOMAXCONN) != 0) {
+    int err = errno;
+    ::close(fd);
+    errno = err;
+    throw_errno("cannot listen on port " + std::to_string(port));
+  }
+  int flags = fcntl(fd, F_GETFL, 0);
+  if (flags == -1 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1) {
+    ::close(fd);
+    throw_errno("fcntl(O_NONBLOCK) failed");
+  }
+  return fd;
+}
+
+std::unique_ptr<TcpStream> TcpStream::accept(int listen_fd) {
+  int fd = ::accept(listen_fd, nullptr, nullptr);
+  if (fd == -1) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ||
+        errno == ECONNABORTED) {
+      return nullptr;
+    }
+    throw_errno("accept failed");
+  }
+  return std::make_unique<TcpStream>(fd);
+}
+
+std::unique_ptr<TcpStream> TcpStream::connect(const std::string& hostname,
+                                              const std::string& service) {
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* res = nullptr;
+  int err = getaddrinfo(hostname.c_str(), service.c_str(), &hints, &res);
+  if (err != 0) {
+    throw TcpException("getaddrinfo failed for " + hostname + ":" + service +
+                       ": " + gai_strerror(err));
+  }
+
+  int fd = -1;
+  for (addrinfo* ai = res; ai != nullptr; ai = ai->ai_next) {
+    fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+    if (fd == -1) {
+      continue;
+    }
+    if (::connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+      break;
+    }
+    L_(trace) << "connect to " << hostname << ":" << service
+              << " failed: " << std::strerror(errno);
+    ::close(fd);
+    fd = -1;
+  }
+  freeaddrinfo(res);
+
+  if (fd == -1) {
+    return nullptr;
+  }
+  return std::make_unique<TcpStream>(fd);
+}
+
+bool TcpStream::enable_zerocopy() {
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+  int one = 1;
+  zerocopy_ =
+      setsockopt(fd_, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) == 0;
+#endif
+  return zerocopy_;
+}
+
+void TcpStream::send_copy(const void* buf, std::size_t len) {
+  Segment segment{nullptr, len, false, {}};
+  assert(len <= segment.data.size());
+  std::memcpy(segment.data.data(), buf, len);
+  segments_.push_back(segment);
+  queued_ += len;
+}
+
+void TcpStream::send(const void* buf, std::size_t len) {
+  if (len == 0) {
+    return;
+  }
+  segments_.push_back({static_cast<const uint8_t*>(buf), len,
+                       zerocopy_ && len >= zerocopy_threshold, {}});
+  queued_ += len;
+}
+
+void TcpStream::receive(void* buf, std::size_t len) {
+  assert(!receive_pending());
+  receive_buf_ = static_cast<uint8_t*>(buf);
+  receive_len_ = len;
+  receive_received_ = 0;
+}
+
+void TcpStream::progress_send() {
+  // fall back to copying if the kernel is out of zero-copy resources
+  bool force_copy = false;
+  while (!segments_.empty() && !closed_) {
+    // gather consecutive segments sent the same way
+    bool zerocopy = !force_copy && segments_.front().zerocopy;
+    std::array<iovec, max_iov> iov{};
+    std::size_t iov_count = 0;
+    std::size_t total = 0;
+    std::size_t offset = segment_offset_;
+    for (auto& segment : segments_) {
+      if (iov_count == max_iov ||
+          (!force_copy && segment.zerocopy != zerocopy)) {
+        break;
+      }
+      const uint8_t* ptr =
+          segment.ptr != nullptr ? segment.ptr : segment.data.data();
+      iov[iov_count].iov_base = const_cast<uint8_t*>(ptr + offset);
+      iov[iov_count].iov_len = segment.len - offset;
+      total += segment.len - offset;
+      ++iov_count;
+      offset = 0;
+    }
+
+    msghdr msg{};
+    msg.msg_iov = iov.data();
+    msg.msg_iovlen = iov_count;
+    int flags = send_flags;
+#if defined(MSG_ZEROCOPY)
+    if (zerocopy) {
+      flags |= MSG_ZEROCOPY;
+    }
+#endif
+    ssize_t rc = sendmsg(fd_, &msg, flags);
+    if (rc < 0) {
+      if (errno == ENOBUFS && zerocopy) {
+        force_copy = true;
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ||
+          errno == ENOBUFS) {
+        return;
+      }
+      if (errno == EPIPE || errno == ECONNRESET) {
+        closed_ = true;
+        return;
+      }
+      throw_errno("sendmsg failed");
+    }
+    if (zerocopy) {
+      in_flight_.push_back({zerocopy_seq_++, sent_});
+    }
+    sent_ += static_cast<uint64_t>(rc);
+
+    // advance over the sent segments
+    auto remaining = static_cast<std::size_t>(rc);
+    while (remaining > 0) {
+      std::size_t left = segments_.front().len - segment_offset_;
+      if (remaining < left) {
+        segment_offset_ += remaining;
+        break;
+      }
+      remaining -= left;
+      segments_.pop_front();
+      segment_offset_ = 0;
+    }
+
+    if (static_cast<std::size_t>(rc) < total) {
+      // the socket buffer is full
+      return;
+    }
+  }
+}
+
+void TcpStream::progress_receive() {
+  while (receive_pending()) {
+    ssize_t rc = recv(fd_, receive_buf_ + receive_received_,
+                      receive_len_ - receive_received_, MSG_DONTWAIT);
+    if (rc > 0) {
+      receive_received_ += static_cast<std::size_t>(rc);
+    } else if (rc == 0) {
+      closed_ = true;
+      return;
+    } else if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+      return;
+    } else if (errno == ECONNRESET) {
+      closed_ = true;
+      return;
+    } else {
+      throw_errno("recv failed");
+    }
+  }
+}
+
+void TcpStream::progress_completions() {
+#if defined(__linux__) && defined(SO_EE_ORIGIN_ZEROCOPY)
+  while (!in_flight_.empty()) {
+    std::array<char, 128> control{};
+    msghdr msg{};
+    msg.msg_control = control.data();
+    msg.msg_controllen = control.size();
+    if (recvmsg(fd_, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) == -1) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        return;
+      }
+      throw_errno("recvmsg(MSG_ERRQUEUE) failed");
+    }
+    for (cmsghdr* cm = CMSG_FIRSTHDR(&msg); cm != nullptr;
+         cm = CMSG_NXTHDR(&msg, cm)) {
+      if ((cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR) ||
+          (cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR)) {
+        sock_extended_err err{};
+        std::memcpy(&err, CMSG_DATA(cm), sizeof(err));
+        if (err.ee_origin == SO_EE_ORIGIN_ZEROCOPY && err.ee_errno == 0) {
+          complete_zerocopy(err.ee_info, err.ee_data);
+        }
+      }
+    }
+  }
+#endif
+}
+
+short TcpStream::poll_events() const {
+  short events = 0;
+  if (receive_pending()) {
+    events |= POLLIN;
+  }
+  if (send_pending()) {
+    events |= POLLOUT;
+  }
+  return events;
+}
+
+void TcpStream::handle_events(short revents) {
+  if ((revents & POLLERR) != 0) {
+    progress_completions();
+    int err = 0;
+    socklen_t len = sizeof(err);
+    if (getsockopt(fd_, SOL_SOCKET, SO_ERROR, &err, &len) == 0 && err != 0) {
+      L_(debug) << "tcp stream error: " << std::strerror(err);
+      closed_ = true;
+    }
+  }
+  if ((revents & POLLOUT) != 0) {
+    progress_send();
+  }
+  if ((revents & (POLLIN | POLLHUP)) != 0) {
+    progress_receive();
+    if ((revents & POLLHUP) != 0 && !receive_pending()) {
+      closed_ = true;
+    }
+  }
+}
+
+void TcpStream::complete_zerocopy(uint32_t lo, uint32_t hi) {
+  completed_ranges_.emplace_back(lo, hi);
+  // merge all ranges adjoining the completed calls
+  bool merged = true;
+  while (merged) {
+    merged = false;
+    for (auto it = completed_ranges_.begin(); it != completed_ranges_.end();
+         ++it) {
+      if (!seq_before(zerocopy_completed_, it->first)) {
+        if (!seq_before(it->second, zerocopy_completed_)) {
+          zerocopy_completed_ = it->second + 1;
+        }
+        completed_ranges_.erase(it);
+        merged = true;
+        break;
+      }
+    }
+  }
+  while (!in_flight_.empty() &&
+         seq_before(in_flight_.front().seq, zerocopy_completed_)) {
+    in_flight_.pop_front();
+  }
+}
@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// Non-blocking TCP stream class.
+/** A TcpStream object owns a connected, non-blocking TCP socket. Outgoing
+    data is queued and sent by progress_send() as far as the socket accepts
+    it. Large buffers are sent in place, with MSG_ZEROCOPY if enabled, and
+    must stay valid until released() has passed their end position.
+    Incoming data is received straight into a caller-provided buffer.
+
+    The owner drives the stream from its event loop by polling the socket
+    for poll_events() and passing the result to handle_events(). */
+
+class TcpStream {
+public:
+  /// The TcpStream constructor, taking ownership of a connected socket.
+  explicit TcpStream(int fd);
+
+  TcpStream(const TcpStream&) = delete;
+  void operator=(const TcpStream&) = delete;
+
+  /// The TcpStream destructor.
+  ~TcpStream();
+
+  /// Create a non-blocking listening socket on the given port.
+  static int listen(uint16_t port);
+
+  /// Accept a connection on a listening socket (nullptr: none pending).
+  static std::unique_ptr<TcpStream> accept(int listen_fd);
+
+  /// Connect to the given host and service (nullptr: connection refused).
+  static std::unique_ptr<TcpStream> connect(const std::string& hostname,
+                                            const std::string& service);
+
+  /// Enable zero-copy sends, return false if not supported.
+  bool enable_zerocopy();
+
+  /// Retrieve the socket file descriptor.
+  [[nodiscard]] int fd() const { return fd_; }
+
+  /// Queue a copy of a small message (e.g., a header).
+  void send_copy(const void* buf, std::size_t len);
+
+  /// Queue a buffer to be sent in place (zero-copy if large enough).
+  void send(const void* buf, std::size_t len);
+
+  /// Retrieve the stream position after all queued data.
+  [[nodiscard]] uint64_t queued() const { return queued_; }
+
+  /// Retrieve the stream position up to which the buffers are released.
+  /** Data sent without zero-copy is released once the kernel has accepted
+      it, zero-copy data once the kernel has signalled its completion. */
+  [[nodiscard]] uint64_t released() const {
+    return in_flight_.empty() ? sent_ : in_flight_.front().begin;
+  }
+
+  /// Check if queued data has not been sent yet.
+  [[nodiscard]] bool send_pending() const { return !segments_.empty(); }
+
+  /// Set the buffer to receive the next len bytes of the stream into.
+  void receive(void* buf, std::size_t len);
+
+  /// Check if the receive buffer has not been filled yet.
+  [[nodiscard]] bool receive_pending() const {
+    return receive_received_ < receive_len_;
+  }
+
+  /// Check if the peer has closed the connection.
+  [[nodiscard]] bool closed() const { return closed_; }
+
+  /// Send queued data as far as possible without blocking.
+  void progress_send();
+
+  /// Receive into the receive buffer as far as possible without blocking.
+  void progress_receive();
+
+  /// Handle pending zero-copy completion notifications.
+  void progress_completions();
+
+  /// Retrieve the events to poll the socket for.
+  [[nodiscard]] short poll_events() const;
+
+  /// Handle the events returned by polling the socket.
+  void handle_events(short revents);
+
+private:
+  /// Minimum size of a buffer to send with MSG_ZEROCOPY.
+  static constexpr std::size_t zerocopy_threshold = 16 * 1024;
+
+  /// Maximum number of segments per sendmsg() call.
+  static constexpr std::size_t max_iov = 64;
+
+  struct Segment {
+    const uint8_t* ptr;
+    std::size_t len;
+    bool zerocopy;
+    /// Inline storage of copied messages (ptr is nullptr then).
+    std::array<uint8_t, 64> data;
+  };
+
+  /// A sendmsg() call with MSG_ZEROCOPY awaiting its completion.
+  struct InFlight {
+    uint32_t seq;
+    uint64_t begin;
+  };
+
+  int fd_;
+  bool zerocopy_ = false;
+  bool closed_ = false;
+
+  std::deque<Segment> segments_;
+  /// Bytes of the first segment already sent.
+  std::size_t segment_offset_ = 0;
+
+  uint64_t queued_ = 0;
+  uint64_t sent_ = 0;
+
+  std::deque<InFlight> in_flight_;
+  /// Sequence number of the next zero-copy sendmsg() call.
+  uint32_t zerocopy_seq_ = 0;
+  /// Sequence number up to which all zero-copy calls have completed.
+  uint32_t zerocopy_completed_ = 0;
+  /// Completion ranges reported out of order.
+  std::vector<std::pair<uint32_t, uint32_t>> completed_ranges_;
+
+  uint8_t* receive_buf_ = nullptr;
+  std::size_t receive_len_ = 0;
+  std::size_t receive_received_ = 0;
+
+  /// Record a completed range of zero-copy calls.
+  void complete_zerocopy(uint32_t lo, uint32_t hi);
+};
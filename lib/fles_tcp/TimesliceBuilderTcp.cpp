@@ -0,0 +1,704 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "TimesliceBuilderTcp.hpp"
+#include "MicrosliceDescriptor.hpp"
+#include "System.hpp"
+#include "TcpException.hpp"
+#include "TimesliceCompletion.hpp"
+#include "TimesliceWorkItem.hpp"
+#include "Utility.hpp"
+#include "WorkerPool.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+
+namespace {
+/// Maximum time to wait for socket events in a cycle (in milliseconds).
+constexpr int poll_timeout_ms = 1;
+
+/// Delay before asking again for a component that was not available.
+constexpr auto retry_interval = std::chrono::milliseconds(1);
+
+/// Delay before connecting again to an input server not yet listening.
+constexpr auto reconnect_interval = std::chrono::seconds(1);
+} // namespace
+
+TimesliceBuilderTcp::TimesliceBuilderTcp(
+    uint64_t compute_index,
+    TimesliceBuffer& timeslice_buffer,
+    std::vector<std::string> input_server_hosts,
+    std::vector<std::string> input_server_services,
+    uint32_t num_compute_nodes,
+    uint32_t timeslice_size,
+    uint32_t max_timeslice_number,
+    uint32_t num_streams,
+    const std::string& compression,
+    int compression_level,
+    unsigned compression_threads,
+    const std::string& overlap_host,
+    const std::string& overlap_service,
+    uint16_t overlap_port,
+    std::chrono::milliseconds deadline,
+    volatile sig_atomic_t* signal_status,
+    cbm::Monitor* monitor)
+    : compute_index_(compute_index), timeslice_buffer_(timeslice_buffer),
+      input_server_hosts_(std::move(input_server_hosts)),
+      input_server_services_(std::move(input_server_services)),
+      num_compute_nodes_(num_compute_nodes), timeslice_size_(timeslice_size),
+      max_timeslice_number_(max_timeslice_number),
+      num_streams_(std::max<uint32_t>(num_streams, 1)),
+      codec_level_(compression_level), overlap_host_(overlap_host),
+      overlap_service_(overlap_service), deadline_(deadline),
+      signal_status_(signal_status),
+      ts_index_(compute_index_), ack_(timeslice_buffer_.get_desc_size_exp()),
+      monitor_(monitor),
+      overlap_served_(timeslice_buffer_.get_desc_size_exp()) {
+  assert(input_server_hosts_.size() == input_server_services_.size());
+
+  for (size_t i = 0; i < input_server_hosts_.size(); ++i) {
+    connections_.push_back(std::make_unique<Connection>(timeslice_buffer_, i));
+  }
+
+  if (!compression.empty()) {
+    codec_ = fles::make_chunk_codec(compression, compression_level);
+    if (compression_threads > 0) {
+      decode_pool_ = std::make_unique<WorkerPool>(compression_threads);
+    }
+  }
+
+  if (overlap_sharing()) {
+    // listen right away, so the builder of the previous timeslice can
+    // connect before this one starts running
+    overlap_listen_fd_ = TcpStream::listen(overlap_port);
+  }
+
+  hostname_ = fles::system::current_hostname();
+
+  if (monitor_ != nullptr) {
+    cbm::MetricTagSet tags{{"host", hostname_},
+                           {"output_index", std::to_string(compute_index_)}};
+    build_time_metric_ =
+        monitor_->RegisterHistogram("timeslice_builder", tags, "build_time_ns");
+    decode_time_metric_ = monitor_->RegisterHistogram("timeslice_builder",
+                                                      tags, "decode_time_ns");
+    missing_components_metric_ = monitor_->RegisterCounter(
+        "timeslice_builder", tags, "missing_components");
+  }
+}
+
+TimesliceBuilderTcp::~TimesliceBuilderTcp() {
+  if (overlap_listen_fd_ != -1) {
+    ::close(overlap_listen_fd_);
+  }
+  if (missing_components_ > 0) {
+    L_(warning) << "[c" << compute_index_ << "] " << missing_components_
+                << " components missing after the timeslice deadline";
+  }
+  if (overlap_fetched_ > 0) {
+    L_(info) << "[c" << compute_index_ << "] "
+             << human_readable_count(overlap_fetched_)
+             << " of overlap fetched from output "
+             << (compute_index_ + 1) % num_compute_nodes_;
+  }
+}
+
+void TimesliceBuilderTcp::operator()() {
+  run_begin();
+  while (ts_index_ < max_timeslice_number_ && *signal_status_ == 0) {
+    run_cycle();
+    scheduler_.timer();
+  }
+  run_end();
+}
+
+void TimesliceBuilderTcp::run_begin() {
+  assert(!connections_.empty());
+  connect();
+  time_begin_ = std::chrono::high_resolution_clock::now();
+  previous_report_time_ = std::chrono::system_clock::now();
+  report_status();
+
+  if (ts_index_ < max_timeslice_number_ && *signal_status_ == 0) {
+    build_begin_ = std::chrono::steady_clock::now();
+    for (auto& c : connections_) {
+      request_component(*c);
+    }
+  }
+}
+
+bool TimesliceBuilderTcp::run_cycle() {
+  check_deadline();
+  if (components_received_ == connections_.size()) {
+    complete_timeslice();
+  }
+
+  pollfds_.clear();
+  polled_streams_.clear();
+  for (auto& c : connections_) {
+    for (auto& stream : c->streams) {
+      pollfds_.push_back({stream->fd(), stream->poll_events(), 0});
+      polled_streams_.push_back(stream.get());
+    }
+  }
+  poll_overlap_streams();
+
+  // do not wait for socket events while decodes may complete
+  int rc = poll(pollfds_.data(), pollfds_.size(),
+                decoding_ != 0 ? 0 : poll_timeout_ms);
+  if (rc == -1 && errno != EINTR) {
+    throw TcpException(std::string("poll failed: ") + std::strerror(errno));
+  }
+  if (rc <= 0 && decoding_ == 0) {
+    return true;
+  }
+
+  if (rc > 0) {
+    handle_poll_events();
+  }
+
+  for (auto& c : connections_) {
+    for (auto& stream : c->streams) {
+      if (stream->closed()) {
+        throw TcpException("connection to input " + std::to_string(c->index) +
+                           " closed");
+      }
+    }
+    handle_connection(*c);
+  }
+  if (overlap_sharing()) {
+    handle_overlap();
+  }
+
+  if (components_received_ == connections_.size()) {
+    complete_timeslice();
+  }
+
+  return true;
+}
+
+void TimesliceBuilderTcp::run_end() {
+  time_end_ = std::chrono::high_resolution_clock::now();
+
+  // wait until all pending timeslices have been acknowledged, and until
+  // the builder of the previous timeslice has fetched all overlap contents
+  while (released_ < tpos_ && *signal_status_ == 0) {
+    if (overlap_sharing()) {
+      pollfds_.clear();
+      polled_streams_.clear();
+      poll_overlap_streams();
+      int rc = poll(pollfds_.data(), pollfds_.size(), 10);
+      if (rc == -1 && errno != EINTR) {
+        throw TcpException(std::string("poll failed: ") +
+                           std::strerror(errno));
+      }
+      if (rc > 0) {
+        handle_poll_events();
+      }
+      handle_overlap();
+    } else {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    handle_timeslice_completions();
+  }
+}
+
+void TimesliceBuilderTcp::connect() {
+  for (auto& c : connections_) {
+    const auto& host = input_server_hosts_.at(c->index);
+    const auto& service = input_server_services_.at(c->index);
+    while (c->streams.size() < num_streams_) {
+      auto stream = TcpStream::connect(host, service);
+      if (!stream) {
+        // input server not yet listening, try again later
+        if (*signal_status_ != 0) {
+          return;
+        }
+        L_(debug) << "[c" << compute_index_ << "] waiting for input "
+                  << c->index << " at " << host << ":" << service;
+        std::this_thread::sleep_for(reconnect_interval);
+        continue;
+      }
+      StreamHelloTcp hello{compute_index_, c->streams.size(), num_streams_,
+                           0, 0, 0};
+      if (codec_) {
+        hello.codec = static_cast<uint16_t>(codec_->id());
+        hello.codec_word_size = codec_->word_size();
+        hello.codec_level = codec_level_;
+      }
+      stream->send_copy(&hello, sizeof(hello));
+      while (stream->send_pending() && !stream->closed()) {
+        stream->progress_send();
+      }
+      c->streams.push_back(std::move(stream));
+    }
+    L_(debug) << "[c" << compute_index_ << "] connected to input " << c->index
+              << " with " << num_streams_ << " streams";
+  }
+
+  while (overlap_sharing() && !overlap_next_) {
+    overlap_next_ = TcpStream::connect(overlap_host_, overlap_service_);
+    if (!overlap_next_) {
+      if (*signal_status_ != 0) {
+        return;
+      }
+      L_(debug) << "[c" << compute_index_ << "] waiting for output "
+                << (compute_index_ + 1) % num_compute_nodes_ << " at "
+                << overlap_host_ << ":" << overlap_service_;
+      std::this_thread::sleep_for(reconnect_interval);
+    }
+  }
+}
+
+void TimesliceBuilderTcp::request_component(Connection& c) {
+  // send request for timeslice data, advertising the free buffer space
+  ComponentRequestTcp request{ts_index_, c.desc.size_available(),
+                              c.data.size_available_contiguous(),
+                              overlap_sharing() ? 1U : 0U};
+  TcpStream& control = *c.streams.front();
+  control.send_copy(&request, sizeof(request));
+  control.progress_send();
+  control.receive(&c.reply, sizeof(c.reply));
+  c.state = Connection::State::Header;
+}
+
+void TimesliceBuilderTcp::handle_connection(Connection& c) {
+  if (c.state == Connection::State::Header) {
+    if (c.streams.front()->receive_pending()) {
+      return;
+    }
+    assert(c.reply.timeslice == ts_index_);
+    if (c.reply.desc_size == 0) {
+      // not yet available or no credit, free buffer space while waiting
+      ++retries_;
+      handle_timeslice_completions();
+      c.state = Connection::State::Idle;
+      if (deadline_passed_ && mark_missing(c)) {
+        return;
+      }
+      Connection* conn = &c;
+      scheduler_.add(
+          [this, conn, ts = ts_index_] {
+            // the component may have been given up in the meantime
+            if (conn->state == Connection::State::Idle && ts == ts_index_) {
+              request_component(*conn);
+            }
+          },
+          std::chrono::steady_clock::now() + retry_interval);
+      return;
+    }
+
+    uint64_t size_required = c.reply.desc_size + c.reply.data_size;
+
+    // the sender only replies if the component fits into the advertised
+    // space
+    assert(c.data.size_available_contiguous() >= size_required &&
+           c.desc.size_available() >= 1);
+
+    // skip remaining bytes in data buffer to avoid fragmented entry
+    c.data.skip_buffer_wrap(size_required);
+    uint64_t offset = c.data.reserve(size_required);
+
+    // generate timeslice component descriptor
+    assert(tpos_ == c.desc.write_index());
+    c.desc.append({ts_index_, offset, size_required,
+                   c.reply.desc_size / sizeof(fles::MicrosliceDescriptor)});
+
+    // a compressed payload is received aside and decoded into place
+    c.target = &c.data.at(offset);
+    uint8_t* target = c.target;
+    uint64_t payload_size = tcp_payload_size(c.reply);
+    if (c.reply.encoded_size != 0) {
+      if (!codec_) {
+        throw TcpException("unrequested compressed component from input " +
+                           std::to_string(c.index));
+      }
+      c.encoded.resize(c.reply.encoded_size);
+      target = c.encoded.data();
+      payload_size = c.reply.encoded_size;
+    }
+
+    // receive the slices of all streams at their offsets
+    for (std::size_t k = 0; k < c.streams.size(); ++k) {
+      auto [slice_offset, slice_length] =
+          tcp_slice(payload_size, c.streams.size(), k);
+      if (slice_length > 0) {
+        c.streams[k]->receive(target + slice_offset, slice_length);
+        c.streams[k]->progress_receive();
+      }
+    }
+    c.state = Connection::State::Payload;
+  }
+
+  if (c.state == Connection::State::Payload) {
+    if (std::any_of(c.streams.begin(), c.streams.end(),
+                    [](const auto& s) { return s->receive_pending(); })) {
+      return;
+    }
+    if (c.reply.encoded_size == 0) {
+      complete_component(c);
+      return;
+    }
+    start_decode(c);
+  }
+
+  if (c.state == Connection::State::Decode) {
+    for (auto& decoded : c.decoded) {
+      if (decoded.wait_for(std::chrono::seconds(0)) !=
+          std::future_status::ready) {
+        return;
+      }
+    }
+    for (auto& decoded : c.decoded) {
+      decoded.get();
+    }
+    c.decoded.clear();
+    decode_time_metric_.Record(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - c.decode_begin)
+            .count()));
+    --decoding_;
+    complete_component(c);
+  }
+}
+
+void TimesliceBuilderTcp::start_decode(Connection& c) {
+  uint64_t size = tcp_payload_size(c.reply);
+  uint64_t frames = tcp_frame_count(size);
+  uint64_t pos = frames * sizeof(uint64_t);
+  if (c.encoded.size() < pos) {
+    throw TcpException("corrupt compressed component from input " +
+                       std::to_string(c.index));
+  }
+
+  c.decode_begin = std::chrono::steady_clock::now();
+  for (uint64_t k = 0; k < frames; ++k) {
+    uint64_t frame_size = 0;
+    std::memcpy(&frame_size, c.encoded.data() + k * sizeof(uint64_t),
+                sizeof(frame_size));
+    if (frame_size > c.encoded.size() - pos) {
+      throw TcpException("corrupt compressed component from input " +
+                         std::to_string(c.index));
+    }
+    auto [frame_begin, frame_length] = tcp_frame(size, k);
+    uint64_t desc_bytes =
+        c.reply.desc_size > frame_begin
+            ? std::min(c.reply.desc_size - frame_begin, frame_length)
+            : 0;
+    auto task = [codec = codec_.get(), frame = c.encoded.data() + pos,
+                 frame_size, data = c.target + frame_begin, frame_length,
+                 desc_bytes] {
+      codec->decode(frame, frame_size, data, frame_length, desc_bytes);
+    };
+    if (decode_pool_) {
+      c.decoded.push_back(decode_pool_->submit(task));
+    } else {
+      task();
+    }
+    pos += frame_size;
+  }
+  c.state = Connection::State::Decode;
+  ++decoding_;
+}
+
+void TimesliceBuilderTcp::complete_component(Connection& c) {
+  if (overlap_sharing() && ts_index_ + 1 < max_timeslice_number_) {
+    // the builder of the next timeslice answers every request, also those
+    // without omitted contents, to count them
+    OverlapRequestTcp request{ts_index_ + 1, c.index, c.reply.shared_size};
+    overlap_next_->send_copy(&request, sizeof(request));
+    overlap_next_->progress_send();
+    if (request.size > 0) {
+      fetches_.push_back(
+          {&c, c.target + tcp_payload_size(c.reply), request.size});
+      c.state = Connection::State::Overlap;
+      return;
+    }
+  }
+  finish_component(c);
+}
+
+void TimesliceBuilderTcp::check_deadline() {
+  if (deadline_.count() == 0 || deadline_passed_ ||
+      components_received_ == connections_.size() ||
+      std::chrono::steady_clock::now() < build_begin_ + deadline_) {
+    return;
+  }
+  deadline_passed_ = true;
+  // components already being received are completed, those with a request
+  // under way are given up when it is declined
+  for (auto& c : connections_) {
+    if (c->state == Connection::State::Idle) {
+      mark_missing(*c);
+    }
+  }
+}
+
+bool TimesliceBuilderTcp::mark_missing(Connection& c) {
+  if (c.desc.size_available() < 1) {
+    // keep asking until the consumers release buffer space
+    return false;
+  }
+  assert(tpos_ == c.desc.write_index());
+  c.desc.append({ts_index_, c.data.write_index(), 0, 0});
+  ++missing_components_;
+  missing_components_metric_.Add();
+  finish_component(c);
+  return true;
+}
+
+void TimesliceBuilderTcp::finish_component(Connection& c) {
+  c.state = Connection::State::Complete;
+  ++components_received_;
+  if (timeslice_buffer_.partial_delivery()) {
+    timeslice_buffer_.set_component_complete(static_cast<uint32_t>(c.index),
+                                             tpos_);
+    if (components_received_ == 1) {
+      timeslice_buffer_.send_partial_work_item(work_item());
+    }
+  }
+}
+
+fles::TimesliceWorkItem TimesliceBuilderTcp::work_item() const {
+  return {{ts_index_, tpos_, timeslice_size_,
+           static_cast<uint32_t>(connections_.size())},
+          timeslice_buffer_.get_max_data_size_exp(),
+          timeslice_buffer_.get_desc_size_exp()};
+}
+
+void TimesliceBuilderTcp::poll_overlap_streams() {
+  if (!overlap_sharing()) {
+    return;
+  }
+  if (!overlap_previous_) {
+    pollfds_.push_back({overlap_listen_fd_, POLLIN, 0});
+    polled_streams_.push_back(nullptr);
+  }
+  for (TcpStream* stream : {overlap_next_.get(), overlap_previous_.get()}) {
+    if (stream != nullptr && !stream->closed()) {
+      pollfds_.push_back({stream->fd(), stream->poll_events(), 0});
+      polled_streams_.push_back(stream);
+    }
+  }
+}
+
+void TimesliceBuilderTcp::handle_poll_events() {
+  for (std::size_t i = 0; i < pollfds_.size(); ++i) {
+    // the listening socket has no stream, it is handled by handle_overlap()
+    if (pollfds_[i].revents != 0 && polled_streams_[i] != nullptr) {
+      polled_streams_[i]->handle_events(pollfds_[i].revents);
+    }
+  }
+}
+
+void TimesliceBuilderTcp::handle_overlap() {
+  if (!overlap_previous_) {
+    overlap_previous_ = TcpStream::accept(overlap_listen_fd_);
+    if (overlap_previous_) {
+      overlap_previous_->receive(&overlap_request_, sizeof(overlap_request_));
+      overlap_previous_->progress_receive();
+    }
+  }
+
+  // receive the fetched overlap contents in the order of the requests
+  while (!fetches_.empty()) {
+    const OverlapFetch& fetch = fetches_.front();
+    if (!fetch_receiving_) {
+      overlap_next_->receive(fetch.target, fetch.size);
+      overlap_next_->progress_receive();
+      fetch_receiving_ = true;
+    }
+    if (overlap_next_->receive_pending()) {
+      if (overlap_next_->closed()) {
+        throw TcpException("overlap connection to output " +
+                           std::to_string((compute_index_ + 1) %
+                                          num_compute_nodes_) +
+                           " closed");
+      }
+      break;
+    }
+    fetch_receiving_ = false;
+    overlap_fetched_ += fetch.size;
+    finish_component(*fetch.conn);
+    fetches_.pop_front();
+  }
+
+  if (!overlap_previous_) {
+    return;
+  }
+
+  while (!overlap_previous_->closed() &&
+         !overlap_previous_->receive_pending()) {
+    overlap_requests_.push_back(overlap_request_);
+    overlap_previous_->receive(&overlap_request_, sizeof(overlap_request_));
+    overlap_previous_->progress_receive();
+  }
+
+  // answer the requests as soon as the component has been received
+  while (!overlap_requests_.empty() && !overlap_previous_->closed()) {
+    const OverlapRequestTcp& request = overlap_requests_.front();
+    if (request.timeslice < compute_index_ ||
+        (request.timeslice - compute_index_) % num_compute_nodes_ != 0 ||
+        request.input_index >= connections_.size()) {
+      throw TcpException("invalid overlap request for timeslice " +
+                         std::to_string(request.timeslice));
+    }
+    uint64_t tpos = (request.timeslice - compute_index_) / num_compute_nodes_;
+    const Connection& c = *connections_[request.input_index];
+    if (tpos > tpos_) {
+      break;
+    }
+    if (request.size > 0) {
+      if (tpos == tpos_ && c.state != Connection::State::Complete &&
+          (c.state != Connection::State::Overlap ||
+           request.size > tcp_payload_size(c.reply) - c.reply.desc_size)) {
+        break;
+      }
+      const auto& desc = c.desc.at(tpos);
+      uint64_t descs_size =
+          desc.num_microslices * sizeof(fles::MicrosliceDescriptor);
+      if (descs_size + request.size > desc.size) {
+        throw TcpException("invalid overlap request for timeslice " +
+                           std::to_string(request.timeslice));
+      }
+      overlap_previous_->send(&c.data.at(desc.offset + descs_size),
+                              request.size);
+      overlap_previous_->progress_send();
+    }
+    overlap_served_in_flight_.push_back({tpos, overlap_previous_->queued()});
+    overlap_requests_.pop_front();
+  }
+
+  // a request is served once its contents have left the buffer
+  while (!overlap_served_in_flight_.empty() &&
+         overlap_served_in_flight_.front().end <=
+             overlap_previous_->released()) {
+    ++overlap_served_.at(overlap_served_in_flight_.front().tpos);
+    overlap_served_in_flight_.pop_front();
+  }
+
+  // the first timeslice has no previous one, and nothing more is fetched
+  // once the previous builder has finished
+  while (overlap_done_ < tpos_) {
+    bool requested = compute_index_ + overlap_done_ * num_compute_nodes_ != 0 &&
+                     !overlap_previous_->closed();
+    if (requested &&
+        overlap_served_.at(overlap_done_) < connections_.size()) {
+      break;
+    }
+    overlap_served_.at(overlap_done_) = 0;
+    ++overlap_done_;
+  }
+  release_buffers();
+}
+
+void TimesliceBuilderTcp::complete_timeslice() {
+  handle_timeslice_completions();
+
+  build_time_metric_.Record(static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - build_begin_)
+          .count()));
+
+  timeslice_buffer_.send_work_item(work_item());
+  ++tpos_;
+  // next timeslice: round robin
+  ts_index_ += num_compute_nodes_;
+
+  components_received_ = 0;
+  deadline_passed_ = false;
+  if (ts_index_ >= max_timeslice_number_) {
+    return;
+  }
+  build_begin_ = std::chrono::steady_clock::now();
+  for (auto& c : connections_) {
+    request_component(*c);
+  }
+}
+
+void TimesliceBuilderTcp::handle_timeslice_completions() {
+  ItemCompletionBatch batch;
+  while (timeslice_buffer_.try_receive_completions(batch)) {
+    uint64_t acked = std::max(acked_, batch.completed_up_to);
+    // Mark out-of-order completions, then advance over all consecutive ones
+    for (auto ts_pos : batch.completed) {
+      if (ts_pos >= acked) {
+        ack_.at(ts_pos) = ts_pos + 1;
+      }
+    }
+    while (ack_.at(acked) == acked + 1) {
+      ++acked;
+    }
+    acked_ = acked;
+  }
+  release_buffers();
+}
+
+void TimesliceBuilderTcp::release_buffers() {
+  uint64_t release =
+      overlap_sharing() ? std::min(acked_, overlap_done_) : acked_;
+  if (release <= released_) {
+    return;
+  }
+  released_ = release;
+  for (auto& conn : connections_) {
+    conn->desc.set_read_index(released_);
+    conn->data.set_read_index(conn->desc.at(released_ - 1).offset +
+                              conn->desc.at(released_ - 1).size);
+  }
+}
+
+void TimesliceBuilderTcp::report_status() {
+  constexpr auto interval = std::chrono::seconds(1);
+
+  std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
+
+  auto desc_size = static_cast<int64_t>(connections_.at(0)->desc.size());
+  auto desc_used = static_cast<int64_t>(tpos_ - released_);
+  int64_t data_size = 0;
+  int64_t data_used = 0;
+  for (auto& c : connections_) {
+    data_size += static_cast<int64_t>(c->data.size());
+    data_used += static_cast<int64_t>(c->data.size_used());
+  }
+
+  double delta_t = std::chrono::duration<double, std::chrono::seconds::period>(
+                       now - previous_report_time_)
+                       .count();
+  double rate_desc =
+      delta_t > 0 ? static_cast<double>(acked_ - previous_acked_) / delta_t
+                  : 0;
+
+  L_(debug) << "[c" << compute_index_ << "] "
+            << human_readable_count(acked_, true, "") << " timeslices, "
+            << retries_ << " empty replies";
+
+  L_(info) << "[c" << compute_index_ << "] |"
+           << bar_graph(std::vector<int64_t>{data_used, data_size - data_used},
+                        "#_", 20)
+           << "|"
+           << bar_graph(std::vector<int64_t>{desc_used, desc_size - desc_used},
+                        "#_", 10)
+           << "| " << human_readable_count(rate_desc, true, "Hz");
+
+  if (monitor_ != nullptr) {
+    monitor_->QueueMetric("recv_buffer_status",
+                          {{"host", hostname_},
+                           {"output_index", std::to_string(compute_index_)}},
+                          {{"data_used", data_used},
+                           {"data_free", data_size - data_used},
+                           {"desc_used", desc_used},
+                           {"desc_free", desc_size - desc_used},
+                           {"desc_rate", rate_desc}});
+  }
+
+  previous_acked_ = acked_;
+  previous_report_time_ = now;
+
+  scheduler_.add([this] { report_status(); }, now + interval);
+}
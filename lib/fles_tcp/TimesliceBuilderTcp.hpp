@@ -0,0 +1,358 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#pragma once
+
+#include "ChunkCodec.hpp"
+#include "ComponentRequestTcp.hpp"
+#include "ManagedRingBuffer.hpp"
+#include "Monitor.hpp"
+#include "RingBuffer.hpp"
+#include "Scheduler.hpp"
+#include "TcpStream.hpp"
+#include "TimesliceBuffer.hpp"
+#include <chrono>
+#include <csignal>
+#include <deque>
+#include <future>
+#include <memory>
+#include <poll.h>
+#include <string>
+#include <vector>
+
+class WorkerPool;
+
+/**
+ * @brief The TimesliceBuilderTcp class
+ *
+ * A TimesliceBuilderTcp object initiates connections to input nodes and
+ * receives timeslices to a timeslice buffer. Each connection consists of a
+ * group of parallel TCP streams. The components of a timeslice are
+ * requested from all input nodes at once, and each stream receives its
+ * slice of a component straight into the timeslice buffer.
+ *
+ * With a codec, the builder requests compressed components. Their payload
+ * is received into a per-connection buffer, and the frames are decoded
+ * into the timeslice buffer on a pool of decompression threads before the
+ * timeslice is handed on.
+ *
+ * With overlap sharing, the input nodes omit the overlap contents, which
+ * also start the components of the next timeslice. The builder fetches them
+ * from the builder of the next timeslice instead (see OverlapRequestTcp)
+ * and in turn serves the builder of the previous timeslice, keeping the
+ * buffer space of a timeslice until all its requests are answered.
+ *
+ * With a timeslice deadline, the builder gives up on the components not
+ * yet available from their input servers once the deadline has passed
+ * after the first request of a timeslice. The timeslice is handed on with
+ * these components marked as missing, i.e., without microslices, and the
+ * input servers discard them when they become available.
+ */
+
+class TimesliceBuilderTcp {
+public:
+  /// The TimesliceBuilderTcp constructor.
+  /** \param compression the codec name (see fles::make_chunk_codec(), empty:
+      uncompressed)
+      \param overlap_host the host of the builder of the next timeslice
+      (empty: no overlap sharing)
+      \param overlap_service the service of the builder of the next timeslice
+      \param overlap_port the port to serve the builder of the previous
+      timeslice on
+      \param deadline the time after which missing components are given up
+      (zero: wait indefinitely, not with overlap sharing) */
+  TimesliceBuilderTcp(uint64_t compute_index,
+                      TimesliceBuffer& timeslice_buffer,
+                      std::vector<std::string> input_server_hosts,
+                      std::vector<std::string> input_server_services,
+                      uint32_t num_compute_nodes,
+                      uint32_t timeslice_size,
+                      uint32_t max_timeslice_number,
+                      uint32_t num_streams,
+                      const std::string& compression,
+                      int compression_level,
+                      unsigned compression_threads,
+                      const std::string& overlap_host,
+                      const std::string& overlap_service,
+                      uint16_t overlap_port,
+                      std::chrono::milliseconds deadline,
+                      volatile sig_atomic_t* signal_status,
+                      cbm::Monitor* monitor);
+
+  TimesliceBuilderTcp(const TimesliceBuilderTcp&) = delete;
+  void operator=(const TimesliceBuilderTcp&) = delete;
+
+  /// The TimesliceBuilderTcp destructor.
+  ~TimesliceBuilderTcp();
+
+  /// The thread main function.
+  void operator()();
+
+  /**
+   * @brief Return a text description of the object (to be used as a thread
+   * name).
+   *
+   * @return A string describing the object (at most 15 characters long).
+   */
+  [[nodiscard]] std::string thread_name() const {
+    return "TSB/TCP/o" + std::to_string(compute_index_);
+  };
+
+private:
+  /// Connection struct, handles data for one input server.
+  struct Connection {
+    Connection(TimesliceBuffer& timeslice_buffer, size_t i)
+        : desc(timeslice_buffer.get_desc_ptr(i),
+               timeslice_buffer.get_desc_size_exp()),
+          data(timeslice_buffer.get_data_ptr(i),
+               timeslice_buffer.get_data_size_exp(i)),
+          index(i) {}
+
+    ManagedRingBuffer<fles::TimesliceComponentDescriptor> desc;
+    ManagedRingBuffer<uint8_t> data;
+
+    /// The index of the input server.
+    const size_t index;
+
+    /// The parallel streams, the first one also carries the control flow.
+    std::vector<std::unique_ptr<TcpStream>> streams;
+
+    enum class State { Idle, Header, Payload, Decode, Overlap, Complete };
+
+    /// The reception state of the current component.
+    State state = State::Idle;
+
+    /// Receive buffer for the reply header.
+    ComponentReplyTcp reply{};
+
+    /// Receive buffer for a compressed payload.
+    std::vector<uint8_t> encoded;
+
+    /// The target of the current component in the data buffer.
+    uint8_t* target = nullptr;
+
+    /// The completion of the frames decoded by the pool.
+    std::vector<std::future<void>> decoded;
+
+    /// Begin of the decoding of the current component.
+    std::chrono::steady_clock::time_point decode_begin{};
+  };
+
+  /// This builder's index in the list of compute nodes.
+  const uint64_t compute_index_;
+
+  /// Shared memory buffer to store received timeslices.
+  TimesliceBuffer& timeslice_buffer_;
+
+  /// Vectors of all input server hosts and services to connect to.
+  const std::vector<std::string> input_server_hosts_;
+  const std::vector<std::string> input_server_services_;
+
+  /// Number of compute nodes.
+  const uint32_t num_compute_nodes_;
+
+  /// Constant size (in microslices) of a timeslice component.
+  const uint32_t timeslice_size_;
+
+  /// Number of timeslices after which this run shall end.
+  const uint32_t max_timeslice_number_;
+
+  /// Number of parallel streams per input connection.
+  const uint32_t num_streams_;
+
+  /// The codec of the requested compression (nullptr: uncompressed).
+  std::shared_ptr<const fles::ChunkCodec> codec_;
+
+  /// The requested compression level.
+  const int codec_level_;
+
+  /// The builder of the next timeslice to fetch the overlap contents from.
+  const std::string overlap_host_;
+  const std::string overlap_service_;
+
+  /// Time after which missing components are given up (zero: never).
+  const std::chrono::milliseconds deadline_;
+
+  /// Pointer to global signal status variable.
+  volatile sig_atomic_t* signal_status_;
+
+  /// Index of acknowledged timeslices (local index).
+  uint64_t acked_ = 0;
+
+  /// The global index of the timeslice currently being received.
+  uint64_t ts_index_;
+
+  /// The local buffer position of the timeslice currently being received.
+  uint64_t tpos_ = 0;
+
+  /// The number of components of the current timeslice received.
+  uint64_t components_received_ = 0;
+
+  /// Buffer to store acknowledged status of timeslices.
+  RingBuffer<uint64_t, true> ack_;
+
+  /// The vector of connections, one per input server.
+  std::vector<std::unique_ptr<Connection>> connections_;
+
+  /// The sockets polled in the current cycle.
+  std::vector<pollfd> pollfds_;
+
+  /// The streams of the polled sockets.
+  std::vector<TcpStream*> polled_streams_;
+
+  /// Begin of operation (for performance statistics).
+  std::chrono::high_resolution_clock::time_point time_begin_;
+
+  /// End of operation (for performance statistics).
+  std::chrono::high_resolution_clock::time_point time_end_;
+
+  /// Time of the first request for the current timeslice.
+  std::chrono::steady_clock::time_point build_begin_{};
+
+  cbm::Monitor* monitor_;
+  std::string hostname_;
+
+  /// Time from the first component request to the complete timeslice (ns).
+  cbm::MetricHistogram build_time_metric_;
+
+  /// Time to decode a compressed component (ns).
+  cbm::MetricHistogram decode_time_metric_;
+
+  /// Number of connections with a component being decoded.
+  std::size_t decoding_ = 0;
+
+  /// Number of empty replies (component not available or no credit).
+  uint64_t retries_ = 0;
+
+  /// Whether the deadline of the current timeslice has passed.
+  bool deadline_passed_ = false;
+
+  /// Number of components given up after the deadline.
+  uint64_t missing_components_ = 0;
+
+  /// Components given up after the deadline.
+  cbm::MetricCounter missing_components_metric_;
+
+  uint64_t previous_acked_ = 0;
+  std::chrono::system_clock::time_point previous_report_time_;
+
+  /// An overlap request sent to the builder of the next timeslice.
+  struct OverlapFetch {
+    Connection* conn;
+    uint8_t* target;
+    uint64_t size;
+  };
+
+  /// An answered overlap request whose contents are still being sent.
+  struct OverlapServed {
+    uint64_t tpos;
+    /// Stream position after the contents.
+    uint64_t end;
+  };
+
+  /// Listening socket for the builder of the previous timeslice.
+  int overlap_listen_fd_ = -1;
+
+  /// Stream to the builder of the next timeslice.
+  std::unique_ptr<TcpStream> overlap_next_;
+
+  /// Stream from the builder of the previous timeslice.
+  std::unique_ptr<TcpStream> overlap_previous_;
+
+  /// Overlap requests awaiting their contents, in order.
+  std::deque<OverlapFetch> fetches_;
+
+  /// Whether the contents of the first fetch are being received.
+  bool fetch_receiving_ = false;
+
+  /// Receive buffer for the overlap requests.
+  OverlapRequestTcp overlap_request_{};
+
+  /// Overlap requests received but not yet answered, in order.
+  std::deque<OverlapRequestTcp> overlap_requests_;
+
+  /// Answered overlap requests, in order.
+  std::deque<OverlapServed> overlap_served_in_flight_;
+
+  /// Number of completely served overlap requests per timeslice.
+  RingBuffer<uint64_t, true> overlap_served_;
+
+  /// Index of timeslices with all overlap requests served (local index).
+  uint64_t overlap_done_ = 0;
+
+  /// Index of timeslices with released buffer space (local index).
+  uint64_t released_ = 0;
+
+  /// Overlap content bytes fetched from the builder of the next timeslice.
+  uint64_t overlap_fetched_ = 0;
+
+  /// Scheduler for delayed and periodic events.
+  Scheduler scheduler_;
+
+  /// Decompression threads (nullptr: decode in the builder thread).
+  std::unique_ptr<WorkerPool> decode_pool_;
+
+  /// Setup at begin of run.
+  void run_begin();
+
+  /// A single cycle in the main run loop.
+  bool run_cycle();
+
+  /// Cleanup at end of run.
+  void run_end();
+
+  /// Connect all streams of all connections, waiting for the input servers.
+  void connect();
+
+  /// Request the component of the current timeslice from an input server.
+  void request_component(Connection& c);
+
+  /// Advance the reception state of a connection.
+  void handle_connection(Connection& c);
+
+  /// Start decoding a received compressed payload.
+  void start_decode(Connection& c);
+
+  /// Complete a component whose payload has been received, fetching its
+  /// overlap contents if they were omitted.
+  void complete_component(Connection& c);
+
+  /// Give up on the components not yet available once the deadline of the
+  /// current timeslice has passed.
+  void check_deadline();
+
+  /// Give up on the component of a connection not yet available, marking
+  /// it as missing.
+  /** \return false if the descriptor buffer is full */
+  bool mark_missing(Connection& c);
+
+  /// Mark a component as complete, handing on the timeslice with its first
+  /// complete component if partial delivery is enabled.
+  void finish_component(Connection& c);
+
+  /// Retrieve the work item of the timeslice currently being received.
+  [[nodiscard]] fles::TimesliceWorkItem work_item() const;
+
+  /// Check whether the overlap contents are shared with the neighbors.
+  [[nodiscard]] bool overlap_sharing() const { return !overlap_host_.empty(); }
+
+  /// Add the overlap sharing sockets to the polled sockets.
+  void poll_overlap_streams();
+
+  /// Handle the events of the polled sockets.
+  void handle_poll_events();
+
+  /// Progress fetching and serving overlap contents.
+  void handle_overlap();
+
+  /// Release the buffer space of timeslices acknowledged and served.
+  void release_buffers();
+
+  /// Hand the completed timeslice to the buffer and start the next one.
+  void complete_timeslice();
+
+  /// Handle pending timeslice completions and advance read indexes.
+  void handle_timeslice_completions();
+
+  /// Print a (periodic) buffer status report.
+  void report_status();
+};
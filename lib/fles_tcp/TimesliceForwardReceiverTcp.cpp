@@ -0,0 +1,122 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "TimesliceForwardReceiverTcp.hpp"
+#include "TcpException.hpp"
+#include "log.hpp"
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+/// Maximum time to wait for socket events (in milliseconds).
+constexpr int poll_timeout_ms = 100;
+} // namespace
+
+TimesliceForwardReceiverTcp::TimesliceForwardReceiverTcp(
+    uint16_t listen_port,
+    ManagedTimesliceBuffer& timeslice_buffer,
+    volatile sig_atomic_t* signal_status)
+    : timeslice_buffer_(timeslice_buffer), signal_status_(signal_status),
+      listen_fd_(TcpStream::listen(listen_port)) {}
+
+TimesliceForwardReceiverTcp::~TimesliceForwardReceiverTcp() {
+  stream_.reset();
+  ::close(listen_fd_);
+}
+
+void TimesliceForwardReceiverTcp::operator()() {
+  if (!accept()) {
+    return;
+  }
+
+  while (*signal_status_ == 0) {
+    fles::TimesliceDescriptor tsd{};
+    if (!receive(&tsd, sizeof(tsd))) {
+      break;
+    }
+    std::vector<fles::TimesliceComponentDescriptor> tscd(tsd.num_components);
+    if (!receive(tscd.data(),
+                 tscd.size() * sizeof(fles::TimesliceComponentDescriptor))) {
+      break;
+    }
+
+    // receive the components straight into the timeslice buffer
+    const auto reservation = timeslice_buffer_.reserve(std::move(tscd));
+    bool complete = true;
+    for (uint64_t c = 0; c < tsd.num_components && complete; ++c) {
+      complete = receive(timeslice_buffer_.data_ptr(reservation, c),
+                         reservation.tscd[c].size);
+    }
+    if (!complete) {
+      // do not hand out partial data, the reserved space stays unused
+      L_(warning) << "forwarded timeslice " << tsd.index << " incomplete";
+      break;
+    }
+    timeslice_buffer_.commit(reservation, tsd);
+    ++count_;
+
+    stream_->send_copy(&tsd.index, sizeof(tsd.index));
+    if (!flush()) {
+      break;
+    }
+  }
+  L_(info) << "received " << count_ << " forwarded timeslices";
+}
+
+bool TimesliceForwardReceiverTcp::accept() {
+  while (*signal_status_ == 0) {
+    pollfd pfd{listen_fd_, POLLIN, 0};
+    int rc = poll(&pfd, 1, poll_timeout_ms);
+    if (rc == -1 && errno != EINTR) {
+      throw TcpException(std::string("poll failed: ") + std::strerror(errno));
+    }
+    if (rc > 0) {
+      stream_ = TcpStream::accept(listen_fd_);
+      if (stream_) {
+        L_(info) << "forwarder connected";
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool TimesliceForwardReceiverTcp::receive(void* buf, std::size_t len) {
+  stream_->receive(buf, len);
+  stream_->progress_receive();
+  while (stream_->receive_pending()) {
+    if (stream_->closed() || *signal_status_ != 0) {
+      return false;
+    }
+    pollfd pfd{stream_->fd(), stream_->poll_events(), 0};
+    int rc = poll(&pfd, 1, poll_timeout_ms);
+    if (rc == -1 && errno != EINTR) {
+      throw TcpException(std::string("poll failed: ") + std::strerror(errno));
+    }
+    if (rc > 0) {
+      stream_->handle_events(pfd.revents);
+    }
+  }
+  return true;
+}
+
+bool TimesliceForwardReceiverTcp::flush() {
+  stream_->progress_send();
+  while (stream_->send_pending()) {
+    if (stream_->closed() || *signal_status_ != 0) {
+      return false;
+    }
+    pollfd pfd{stream_->fd(), stream_->poll_events(), 0};
+    int rc = poll(&pfd, 1, poll_timeout_ms);
+    if (rc == -1 && errno != EINTR) {
+      throw TcpException(std::string("poll failed: ") + std::strerror(errno));
+    }
+    if (rc > 0) {
+      stream_->handle_events(pfd.revents);
+    }
+  }
+  return true;
+}
@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#pragma once
+
+#include "ManagedTimesliceBuffer.hpp"
+#include "TcpStream.hpp"
+#include <csignal>
+#include <cstdint>
+#include <memory>
+
+/// Receiver of forwarded timeslices (TCP).
+/** A TimesliceForwardReceiverTcp object accepts a connection from a
+    TimesliceForwarderTcp and receives the timeslices straight into the
+    space reserved in a ManagedTimesliceBuffer. Each timeslice is
+    acknowledged once its work item has been sent. */
+
+class TimesliceForwardReceiverTcp {
+public:
+  /// The TimesliceForwardReceiverTcp constructor.
+  TimesliceForwardReceiverTcp(uint16_t listen_port,
+                              ManagedTimesliceBuffer& timeslice_buffer,
+                              volatile sig_atomic_t* signal_status);
+
+  TimesliceForwardReceiverTcp(const TimesliceForwardReceiverTcp&) = delete;
+  void operator=(const TimesliceForwardReceiverTcp&) = delete;
+
+  /// The TimesliceForwardReceiverTcp destructor.
+  ~TimesliceForwardReceiverTcp();
+
+  /// Receive timeslices until the forwarder closes the connection.
+  void operator()();
+
+  /// Retrieve the number of timeslices received.
+  [[nodiscard]] uint64_t count() const { return count_; }
+
+private:
+  ManagedTimesliceBuffer& timeslice_buffer_;
+
+  /// Pointer to global signal status variable.
+  volatile sig_atomic_t* signal_status_;
+
+  /// Listening socket.
+  int listen_fd_ = -1;
+
+  std::unique_ptr<TcpStream> stream_;
+
+  /// Number of timeslices received.
+  uint64_t count_ = 0;
+
+  /// Wait for a connection, return false if interrupted.
+  bool accept();
+
+  /// Receive len bytes to buf, return false if closed or interrupted.
+  bool receive(void* buf, std::size_t len);
+
+  /// Send all queued data, return false if closed or interrupted.
+  bool flush();
+};
@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "TimesliceForwarderTcp.hpp"
+#include "TcpException.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+
+namespace {
+/// Maximum time to wait for socket events while blocked (in milliseconds).
+constexpr int poll_timeout_ms = 100;
+} // namespace
+
+TimesliceForwarderTcp::TimesliceForwarderTcp(const std::string& hostname,
+                                             const std::string& service,
+                                             std::size_t window,
+                                             bool zerocopy)
+    : stream_(TcpStream::connect(hostname, service)),
+      window_(std::max<std::size_t>(window, 1)) {
+  if (!stream_) {
+    throw TcpException("cannot connect to forward receiver at " + hostname +
+                       ":" + service);
+  }
+  if (zerocopy && !stream_->enable_zerocopy()) {
+    L_(info) << "zero-copy sends not supported, forwarding with copies";
+  }
+  stream_->receive(&ack_, sizeof(ack_));
+}
+
+TimesliceForwarderTcp::~TimesliceForwarderTcp() {
+  try {
+    while (!in_flight_.empty() && !stream_->closed()) {
+      progress(true);
+    }
+  } catch (const std::exception& e) {
+    L_(error) << "forwarding failed: " << e.what();
+  }
+  if (!in_flight_.empty()) {
+    L_(warning) << in_flight_.size() << " forwarded timeslices not "
+                << "acknowledged";
+  }
+}
+
+void TimesliceForwarderTcp::put(
+    std::shared_ptr<const fles::Timeslice> timeslice) {
+  while (in_flight_.size() >= window_) {
+    progress(true);
+  }
+
+  const fles::Timeslice& ts = *timeslice;
+  const auto num_components = ts.num_components();
+
+  // the descriptors are copied to the header, the data is sent in place
+  InFlight& entry = in_flight_.emplace_back();
+  fles::TimesliceDescriptor tsd{
+      ts.index(), 0, static_cast<uint32_t>(ts.num_core_microslices()),
+      static_cast<uint32_t>(num_components)};
+  constexpr auto desc_size = sizeof(fles::TimesliceComponentDescriptor);
+  entry.header.resize(sizeof(tsd) + num_components * desc_size);
+  std::memcpy(entry.header.data(), &tsd, sizeof(tsd));
+  auto* tscd = entry.header.data() + sizeof(tsd);
+  for (uint64_t c = 0; c < num_components; ++c) {
+    fles::TimesliceComponentDescriptor desc{ts.index(), 0,
+                                            ts.size_component(c),
+                                            ts.num_microslices(c)};
+    std::memcpy(tscd + c * desc_size, &desc, desc_size);
+  }
+  stream_->send(entry.header.data(), entry.header.size());
+  for (uint64_t c = 0; c < num_components; ++c) {
+    // the component data starts with its microslice descriptors
+    stream_->send(ts.component(c).descriptors(), ts.size_component(c));
+  }
+  entry.end = stream_->queued();
+  entry.timeslice = std::move(timeslice);
+
+  stream_->progress_send();
+  progress(false);
+}
+
+void TimesliceForwarderTcp::progress(bool block) {
+  pollfd pfd{stream_->fd(), stream_->poll_events(), 0};
+  int rc = poll(&pfd, 1, block ? poll_timeout_ms : 0);
+  if (rc == -1 && errno != EINTR) {
+    throw TcpException(std::string("poll failed: ") + std::strerror(errno));
+  }
+  if (rc > 0) {
+    stream_->handle_events(pfd.revents);
+  }
+
+  while (!stream_->receive_pending() && !stream_->closed()) {
+    assert(acks_pending_ < in_flight_.size());
+    assert(ack_ == in_flight_.at(acks_pending_).timeslice->index());
+    ++acks_pending_;
+    stream_->receive(&ack_, sizeof(ack_));
+    stream_->progress_receive();
+  }
+
+  // release acknowledged timeslices once the kernel is done with the data
+  while (acks_pending_ > 0 && stream_->released() >= in_flight_.front().end) {
+    in_flight_.pop_front();
+    --acks_pending_;
+  }
+
+  if (stream_->closed() && !in_flight_.empty()) {
+    throw TcpException("forward receiver closed the connection");
+  }
+}
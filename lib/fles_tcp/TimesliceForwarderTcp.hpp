@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#pragma once
+
+#include "Sink.hpp"
+#include "TcpStream.hpp"
+#include "Timeslice.hpp"
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// Timeslice sink forwarding to a remote timeslice buffer (TCP).
+/** A TimesliceForwarderTcp object sends each timeslice to a
+    TimesliceForwardReceiverTcp, which receives it straight into a shared
+    memory timeslice buffer. The components are sent in place from the
+    timeslice (with MSG_ZEROCOPY where supported), and the timeslice is
+    only released once the receiver has acknowledged it. For a TimesliceView,
+    this releases the local work item after the remote completion.
+
+    Up to window timeslices are in flight, put() blocks while the window is
+    full. */
+
+class TimesliceForwarderTcp : public fles::TimesliceSink {
+public:
+  /// The TimesliceForwarderTcp constructor.
+  TimesliceForwarderTcp(const std::string& hostname,
+                        const std::string& service,
+                        std::size_t window = 8,
+                        bool zerocopy = true);
+
+  TimesliceForwarderTcp(const TimesliceForwarderTcp&) = delete;
+  void operator=(const TimesliceForwarderTcp&) = delete;
+
+  /// The TimesliceForwarderTcp destructor, waits for all acknowledgments.
+  ~TimesliceForwarderTcp() override;
+
+  /// Send a timeslice to the receiver.
+  void put(std::shared_ptr<const fles::Timeslice> timeslice) override;
+
+private:
+  /// A forwarded timeslice awaiting its acknowledgment.
+  struct InFlight {
+    std::shared_ptr<const fles::Timeslice> timeslice;
+    /// Timeslice and component descriptors, sent before the data.
+    std::vector<uint8_t> header;
+    /// The stream position after the timeslice.
+    uint64_t end = 0;
+  };
+
+  std::unique_ptr<TcpStream> stream_;
+  const std::size_t window_;
+
+  std::deque<InFlight> in_flight_;
+
+  /// Receive buffer for the acknowledgments.
+  uint64_t ack_ = 0;
+
+  /// Number of acknowledgments not yet applied to in_flight_.
+  std::size_t acks_pending_ = 0;
+
+  /// Wait for socket events (if block) and release acknowledged timeslices.
+  void progress(bool block);
+};
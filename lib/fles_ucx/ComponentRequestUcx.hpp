@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#pragma once
+
+#include <cstdint>
+
+/// Active message identifiers of the UCX transport.
+enum UcxMessageId : unsigned int {
+  /// A ComponentRequestUcx from a TimesliceBuilderUcx.
+  UCX_AM_COMPONENT_REQUEST = 1,
+  /// A ComponentReplyUcx from a ComponentSenderUcx.
+  UCX_AM_COMPONENT_REPLY = 2
+};
+
+/// Timeslice component request from a TimesliceBuilderUcx.
+/** A ComponentRequestUcx is sent by the timeslice builder to request the
+    component of a timeslice from a ComponentSenderUcx. It carries the free
+    space (credit) of the builder's receive buffers for this input
+    connection, so that the sender only replies with components that fit. */
+
+struct ComponentRequestUcx {
+  /// The index of the requested timeslice.
+  uint64_t timeslice;
+
+  /// Free space in the descriptor buffer (in descriptors).
+  uint64_t desc_credit;
+
+  /// Free contiguous space in the data buffer (in bytes).
+  uint64_t data_credit;
+};
+
+/// Header of the reply of a ComponentSenderUcx.
+/** The active message payload holds the microslice descriptors followed by
+    the microslice contents of the component. A reply without descriptors
+    signals that the component is not yet available or does not fit into the
+    advertised space, and the builder has to ask again. */
+
+struct ComponentReplyUcx {
+  /// The index of the replying input.
+  uint64_t input_index;
+
+  /// The index of the timeslice.
+  uint64_t timeslice;
+
+  /// Size of the microslice descriptors (in bytes, zero: not available).
+  uint64_t desc_size;
+
+  /// Size of the microslice contents (in bytes).
+  uint64_t data_size;
+};
@@ -0,0 +1,395 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "ComponentSenderUcx.hpp"
+#include "EventTrace.hpp"
+#include "MicrosliceDescriptor.hpp"
+#include "System.hpp"
+#include "UcxException.hpp"
+#include "Utility.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iomanip>
+#include <sstream>
+
+ComponentSenderUcx::ComponentSenderUcx(uint64_t input_index,
+                                       InputBufferReadInterface& data_source,
+                                       uint16_t listen_port,
+                                       uint32_t timeslice_size,
+                                       uint32_t overlap_size,
+                                       uint32_t max_timeslice_number,
+                                       volatile sig_atomic_t* signal_status,
+                                       cbm::Monitor* monitor)
+    : input_index_(input_index), data_source_(data_source),
+      timeslice_size_(timeslice_size), overlap_size_(overlap_size),
+      max_timeslice_number_(max_timeslice_number),
+      signal_status_(signal_status), acks_(data_source, timeslice_size),
+      monitor_(monitor) {
+  start_index_ = sent_ = data_source.get_read_index();
+
+  worker_.set_am_handler(UCX_AM_COMPONENT_REQUEST, on_request, this);
+  listener_ = worker_.listen(listen_port, on_connection, this);
+
+  hostname_ = fles::system::current_hostname();
+
+  if (monitor_ != nullptr) {
+    cbm::MetricTagSet tags{{"host", hostname_},
+                           {"input_index", std::to_string(input_index_)}};
+    sent_components_metric_ =
+        monitor_->RegisterCounter("component_sender", tags, "components");
+    credit_stalls_metric_ =
+        monitor_->RegisterCounter("component_sender", tags, "credit_stalls");
+    component_bytes_metric_ =
+        monitor_->RegisterHistogram("component_sender", tags, "bytes");
+  }
+}
+
+ComponentSenderUcx::~ComponentSenderUcx() {
+  close_failed_endpoints();
+  // flush the last replies unless interrupted
+  for (auto* ep : endpoints_) {
+    worker_.close(ep, *signal_status_ != 0);
+  }
+  if (listener_ != nullptr) {
+    ucp_listener_destroy(listener_);
+  }
+}
+
+void ComponentSenderUcx::operator()() {
+  run_begin();
+  while (acks_.acked_timeslices() < max_timeslice_number_ &&
+         *signal_status_ == 0) {
+    run_cycle();
+    scheduler_.timer();
+  }
+  run_end();
+}
+
+void ComponentSenderUcx::run_begin() {
+  data_source_.proceed();
+  time_begin_ = std::chrono::high_resolution_clock::now();
+  report_status();
+}
+
+bool ComponentSenderUcx::run_cycle() {
+  // replies complete and requests arrive in the callbacks
+  worker_.progress();
+
+  if (!failed_endpoints_.empty()) {
+    close_failed_endpoints();
+  }
+
+  if (pending_requests_.empty()) {
+    return true;
+  }
+  while (!pending_requests_.empty()) {
+    PendingRequest pending = pending_requests_.front();
+    pending_requests_.pop_front();
+    try_send_timeslice(pending.request, pending.reply_ep);
+  }
+  data_source_.proceed();
+
+  return true;
+}
+
+void ComponentSenderUcx::run_end() {
+  sync_data_source();
+  time_end_ = std::chrono::high_resolution_clock::now();
+}
+
+bool ComponentSenderUcx::try_send_timeslice(const ComponentRequestUcx& request,
+                                            ucp_ep_h reply_ep) {
+  uint64_t ts = request.timeslice;
+  assert(ts >= acks_.acked_timeslices());
+
+  uint64_t desc_offset = ts * timeslice_size_ + start_index_.desc;
+  uint64_t desc_length = timeslice_size_ + overlap_size_;
+
+  // check if complete timeslice is available in the input buffer
+  if (write_index_desc_ < desc_offset + desc_length) {
+    data_source_.proceed();
+    write_index_desc_ = data_source_.get_write_index().desc;
+    if (write_index_desc_ < desc_offset + desc_length) {
+      send_empty_reply(ts, reply_ep);
+      return false;
+    }
+  }
+
+  uint64_t data_offset = data_source_.desc_buffer().at(desc_offset).offset;
+  uint64_t data_end =
+      data_source_.desc_buffer().at(desc_offset + desc_length - 1).offset +
+      data_source_.desc_buffer().at(desc_offset + desc_length - 1).size;
+  assert(data_end >= data_offset);
+  uint64_t data_length = data_end - data_offset;
+
+  // check if the component fits into the receiver's buffers
+  uint64_t desc_bytes = desc_length * sizeof(fles::MicrosliceDescriptor);
+  uint64_t size_required = desc_bytes + data_length;
+  if (request.desc_credit < 1 || request.data_credit < size_required) {
+    ++credit_stalls_;
+    credit_stalls_metric_.Add();
+    send_empty_reply(ts, reply_ep);
+    return false;
+  }
+
+  EventTrace::record(TraceEventType::TimeslicePosted, ts);
+
+  if (desc_offset + desc_length > sent_.desc) {
+    sent_.desc = desc_offset + desc_length;
+  }
+  if (data_offset + data_length > sent_.data) {
+    sent_.data = data_offset + data_length;
+  }
+
+  // descriptors followed by data, sent in place from the input buffer
+  auto* reply = new PendingReply{ // NOLINT
+      this, {input_index_, ts, desc_bytes, data_length}, {}};
+  std::size_t iov_count = add_chunks(data_source_.desc_buffer(), desc_offset,
+                                     desc_length, reply->iov.data());
+  iov_count += add_chunks(data_source_.data_buffer(), data_offset,
+                          data_length, reply->iov.data() + iov_count);
+  send_reply(reply, iov_count, reply_ep);
+
+  sent_components_metric_.Add();
+  component_bytes_metric_.Record(size_required);
+  return true;
+}
+
+void ComponentSenderUcx::send_empty_reply(uint64_t ts, ucp_ep_h reply_ep) {
+  ComponentReplyUcx header{input_index_, ts, 0, 0};
+
+  ucp_request_param_t param{};
+  param.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS | UCP_OP_ATTR_FIELD_CALLBACK;
+  param.flags = UCP_AM_SEND_FLAG_COPY_HEADER;
+  param.cb.send = [](void* request, ucs_status_t /* status */,
+                     void* /* user_data */) { ucp_request_free(request); };
+
+  ucs_status_ptr_t request =
+      ucp_am_send_nbx(reply_ep, UCX_AM_COMPONENT_REPLY, &header,
+                      sizeof(header), nullptr, 0, &param);
+  if (UCS_PTR_IS_ERR(request)) {
+    L_LIMITED(warning) << "[i" << input_index_ << "] empty reply failed: "
+                       << ucs_status_string(UCS_PTR_STATUS(request));
+  }
+}
+
+void ComponentSenderUcx::send_reply(PendingReply* reply,
+                                    std::size_t iov_count,
+                                    ucp_ep_h ep) {
+  ucp_request_param_t param{};
+  param.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS | UCP_OP_ATTR_FIELD_CALLBACK |
+                       UCP_OP_ATTR_FIELD_USER_DATA |
+                       UCP_OP_ATTR_FIELD_DATATYPE;
+  param.flags = UCP_AM_SEND_FLAG_COPY_HEADER;
+  param.cb.send = on_reply_sent;
+  param.user_data = reply;
+  param.datatype = UCP_DATATYPE_IOV;
+
+  ucs_status_ptr_t request =
+      ucp_am_send_nbx(ep, UCX_AM_COMPONENT_REPLY, &reply->header,
+                      sizeof(reply->header), reply->iov.data(), iov_count,
+                      &param);
+  if (UCS_PTR_IS_PTR(request)) {
+    // completed in on_reply_sent()
+    return;
+  }
+  if (UCS_PTR_IS_ERR(request)) {
+    L_LIMITED(error) << "[i" << input_index_ << "] reply for timeslice "
+                     << reply->header.timeslice << " failed: "
+                     << ucs_status_string(UCS_PTR_STATUS(request));
+  }
+  ack_timeslice(reply->header.timeslice);
+  delete reply; // NOLINT
+}
+
+template <typename T_>
+std::size_t ComponentSenderUcx::add_chunks(RingBufferView<T_>& buf,
+                                           uint64_t offset,
+                                           uint64_t length,
+                                           ucp_dt_iov_t* iov) {
+  if (length == 0) {
+    // zero chunks
+    return 0;
+  }
+  if (buf.mirrored() || (offset & buf.size_mask()) <=
+                            ((offset + length - 1) & buf.size_mask())) {
+    // one chunk
+    iov[0] = {&buf.at(offset), sizeof(T_) * length};
+    return 1;
+  }
+  // two chunks
+  size_t size1 = buf.size() - (offset & buf.size_mask());
+  iov[0] = {&buf.at(offset), sizeof(T_) * size1};
+  iov[1] = {buf.ptr(), sizeof(T_) * (length - size1)};
+  return 2;
+}
+
+void ComponentSenderUcx::close_failed_endpoints() {
+  for (auto* ep : failed_endpoints_) {
+    endpoints_.erase(std::remove(endpoints_.begin(), endpoints_.end(), ep),
+                     endpoints_.end());
+    pending_requests_.erase(
+        std::remove_if(pending_requests_.begin(), pending_requests_.end(),
+                       [ep](const PendingRequest& pending) {
+                         return pending.reply_ep == ep;
+                       }),
+        pending_requests_.end());
+    worker_.close(ep, true);
+  }
+  failed_endpoints_.clear();
+}
+
+void ComponentSenderUcx::ack_timeslice(uint64_t ts) {
+  EventTrace::record(TraceEventType::WriteCompleted, ts);
+  acks_.ack(ts);
+}
+
+void ComponentSenderUcx::sync_data_source() { acks_.sync(); }
+
+void ComponentSenderUcx::on_connection(ucp_conn_request_h conn_request,
+                                       void* arg) {
+  auto* sender = static_cast<ComponentSenderUcx*>(arg);
+  try {
+    ucp_ep_h ep =
+        sender->worker_.accept(conn_request, on_endpoint_error, arg);
+    sender->endpoints_.push_back(ep);
+    L_(debug) << "[i" << sender->input_index_ << "] accepted connection ("
+              << sender->endpoints_.size() << " connected)";
+  } catch (const UcxException& e) {
+    L_(error) << "[i" << sender->input_index_ << "] " << e.what();
+  }
+}
+
+ucs_status_t ComponentSenderUcx::on_request(void* arg,
+                                            const void* header,
+                                            size_t header_length,
+                                            void* /* data */,
+                                            size_t /* length */,
+                                            const ucp_am_recv_param_t* param) {
+  auto* sender = static_cast<ComponentSenderUcx*>(arg);
+  assert(header_length == sizeof(ComponentRequestUcx));
+  assert((param->recv_attr & UCP_AM_RECV_ATTR_FIELD_REPLY_EP) != 0u);
+  (void)header_length;
+  sender->pending_requests_.push_back(
+      {*static_cast<const ComponentRequestUcx*>(header), param->reply_ep});
+  return UCS_OK;
+}
+
+void ComponentSenderUcx::on_reply_sent(void* request,
+                                       ucs_status_t status,
+                                       void* user_data) {
+  auto* reply = static_cast<PendingReply*>(user_data);
+  ComponentSenderUcx* sender = reply->sender;
+  if (status != UCS_OK) {
+    L_LIMITED(error) << "[i" << sender->input_index_
+                     << "] reply for timeslice " << reply->header.timeslice
+                     << " failed: " << ucs_status_string(status);
+  }
+  sender->ack_timeslice(reply->header.timeslice);
+  delete reply; // NOLINT
+  ucp_request_free(request);
+}
+
+void ComponentSenderUcx::on_endpoint_error(void* arg,
+                                           ucp_ep_h ep,
+                                           ucs_status_t status) {
+  auto* sender = static_cast<ComponentSenderUcx*>(arg);
+  L_(debug) << "[i" << sender->input_index_
+            << "] connection closed: " << ucs_status_string(status);
+  sender->failed_endpoints_.push_back(ep);
+}
+
+void ComponentSenderUcx::report_status() {
+  constexpr auto interval = std::chrono::seconds(1);
+
+  std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
+
+  DualIndex written = data_source_.get_write_index();
+
+  // if data_source.written pointers are lagging behind due to lazy updates,
+  // use sent value instead
+  uint64_t written_desc = std::max(written.desc, sent_.desc);
+  uint64_t written_data = std::max(written.data, sent_.data);
+
+  SendBufferStatus status_desc{now,
+                               data_source_.desc_buffer().size(),
+                               acks_.cached_acked().desc,
+                               acks_.acked().desc,
+                               sent_.desc,
+                               written_desc};
+  SendBufferStatus status_data{now,
+                               data_source_.data_buffer().size(),
+                               acks_.cached_acked().data,
+                               acks_.acked().data,
+                               sent_.data,
+                               written_data};
+
+  double delta_t =
+      std::chrono::duration<double, std::chrono::seconds::period>(
+          status_desc.time - previous_send_buffer_status_desc_.time)
+          .count();
+  double rate_desc =
+      static_cast<double>(status_desc.acked -
+                          previous_send_buffer_status_desc_.acked) /
+      delta_t;
+  double rate_data =
+      static_cast<double>(status_data.acked -
+                          previous_send_buffer_status_data_.acked) /
+      delta_t;
+
+  // retrieve SubsystemIdentifier and EquipmentIdentifier
+  // from most current MicrosliceDescriptor
+  auto sys_id = static_cast<fles::Subsystem>(0);
+  std::string eq_id("Undefined");
+  if (written_desc > 0) {
+    sys_id = static_cast<fles::Subsystem>(
+        data_source_.desc_buffer().at(written_desc - 1).sys_id);
+    std::stringstream eq_id_ss;
+    eq_id_ss << std::hex << std::uppercase << std::setfill('0') << std::setw(4)
+             << data_source_.desc_buffer().at(written_desc - 1).eq_id;
+    eq_id = eq_id_ss.str();
+  }
+
+  L_(debug) << "[i" << input_index_ << "] desc " << status_desc.percentages()
+            << " (used..free) | "
+            << human_readable_count(status_desc.acked, true, "") << " ("
+            << human_readable_count(rate_desc, true, "Hz") << ")";
+
+  L_(debug) << "[i" << input_index_ << "] data " << status_data.percentages()
+            << " (used..free) | "
+            << human_readable_count(status_data.acked, true) << " ("
+            << human_readable_count(rate_data, true, "B/s") << ")";
+
+  L_(debug) << "[i" << input_index_ << "] " << credit_stalls_
+            << " requests declined for lack of receiver credit";
+
+  L_(info) << "[i" << input_index_ << "] |"
+           << bar_graph(status_data.vector(), "#x._", 20) << "|"
+           << bar_graph(status_desc.vector(), "#x._", 10) << "| "
+           << human_readable_count(rate_data, true, "B/s") << " ("
+           << human_readable_count(rate_desc, true, "Hz") << ")";
+
+  if (monitor_ != nullptr) {
+    monitor_->QueueMetric("send_buffer_status",
+                          {{"host", hostname_},
+                           {"input_index", std::to_string(input_index_)},
+                           {"sys_id", fles::to_string(sys_id)},
+                           {"eq_id", eq_id}},
+                          {{"data_used", status_data.used()},
+                           {"data_sending", status_data.sending()},
+                           {"data_freeing", status_data.freeing()},
+                           {"data_free", status_data.unused()},
+                           {"data_rate", rate_data},
+                           {"desc_used", status_desc.used()},
+                           {"desc_sending", status_desc.sending()},
+                           {"desc_freeing", status_desc.freeing()},
+                           {"desc_free", status_desc.unused()},
+                           {"desc_rate", rate_desc}});
+  }
+
+  previous_send_buffer_status_desc_ = status_desc;
+  previous_send_buffer_status_data_ = status_data;
+
+  scheduler_.add([this] { report_status(); }, now + interval);
+}
@@ -0,0 +1,194 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#pragma once
+
+#include "ComponentRequestUcx.hpp"
+#include "DualRingBuffer.hpp"
+#include "Monitor.hpp"
+#include "RingBufferView.hpp"
+#include "Scheduler.hpp"
+#include "SendBufferStatus.hpp"
+#include "TimesliceAckTracker.hpp"
+#include "UcxWorker.hpp"
+#include <array>
+#include <chrono>
+#include <csignal>
+#include <deque>
+#include <string>
+#include <vector>
+
+/// Input buffer and compute node connection container class (UCX).
+/** A ComponentSenderUcx object represents an input buffer (filled by a
+    FLIB) that serves timeslice component requests from the timeslice
+    builders on the compute nodes. Each component is sent as a single UCP
+    active message directly from the input buffer, UCX selects the protocol
+    (eager or rendezvous) and the transport lanes. */
+
+class ComponentSenderUcx {
+public:
+  /// The ComponentSenderUcx default constructor.
+  ComponentSenderUcx(uint64_t input_index,
+                     InputBufferReadInterface& data_source,
+                     uint16_t listen_port,
+                     uint32_t timeslice_size,
+                     uint32_t overlap_size,
+                     uint32_t max_timeslice_number,
+                     volatile sig_atomic_t* signal_status,
+                     cbm::Monitor* monitor);
+
+  ComponentSenderUcx(const ComponentSenderUcx&) = delete;
+  void operator=(const ComponentSenderUcx&) = delete;
+
+  /// The ComponentSenderUcx default destructor.
+  ~ComponentSenderUcx();
+
+  /// The thread main function.
+  void operator()();
+
+  /**
+   * @brief Return a text description of the object (to be used as a thread
+   * name).
+   *
+   * @return A string describing the object (at most 15 characters long).
+   */
+  [[nodiscard]] std::string thread_name() const {
+    return "CS/UCX/i" + std::to_string(input_index_);
+  };
+
+private:
+  /// This component's index in the list of input components.
+  uint64_t input_index_;
+
+  /// Data source (e.g., FLIB via shared memory).
+  InputBufferReadInterface& data_source_;
+
+  /// Constant size (in microslices) of a timeslice component.
+  const uint32_t timeslice_size_;
+
+  /// Constant overlap size (in microslices) of a timeslice component.
+  const uint32_t overlap_size_;
+
+  /// Number of timeslices after which this run shall end.
+  const uint32_t max_timeslice_number_;
+
+  /// Pointer to global signal status variable.
+  volatile sig_atomic_t* signal_status_;
+
+  /// UCP context and worker.
+  UcxWorker worker_;
+
+  /// Listener for connection requests of the timeslice builders.
+  ucp_listener_h listener_ = nullptr;
+
+  /// Endpoints of the connected timeslice builders.
+  std::vector<ucp_ep_h> endpoints_;
+
+  /// Endpoints that signalled an error, to be closed.
+  std::vector<ucp_ep_h> failed_endpoints_;
+
+  struct PendingRequest {
+    ComponentRequestUcx request;
+    ucp_ep_h reply_ep;
+  };
+
+  /// Received component requests, served in order of arrival.
+  std::deque<PendingRequest> pending_requests_;
+
+  /// A reply in progress, valid until its send operation completes.
+  struct PendingReply {
+    ComponentSenderUcx* sender;
+    ComponentReplyUcx header;
+    std::array<ucp_dt_iov_t, 4> iov;
+  };
+
+  /// Acknowledgment accounting of the sent timeslices.
+  TimesliceAckTracker<InputBufferReadInterface> acks_;
+
+  /// Read indexes at start of operation.
+  DualIndex start_index_{};
+
+  /// Write index received from data source.
+  uint64_t write_index_desc_ = 0;
+
+  /// Begin of operation (for performance statistics).
+  std::chrono::high_resolution_clock::time_point time_begin_;
+
+  /// End of operation (for performance statistics).
+  std::chrono::high_resolution_clock::time_point time_end_;
+
+  /// Amount of data sent (for performance statistics).
+  DualIndex sent_{};
+
+  /// Number of requests declined for lack of receiver credit.
+  uint64_t credit_stalls_ = 0;
+
+  cbm::Monitor* monitor_;
+  std::string hostname_;
+
+  /// Per-request metrics (registered once, recorded without allocation).
+  cbm::MetricCounter sent_components_metric_;
+  cbm::MetricCounter credit_stalls_metric_;
+  cbm::MetricHistogram component_bytes_metric_;
+
+  SendBufferStatus previous_send_buffer_status_desc_ = SendBufferStatus();
+  SendBufferStatus previous_send_buffer_status_data_ = SendBufferStatus();
+
+  /// Scheduler for periodic events.
+  Scheduler scheduler_;
+
+  /// Setup at begin of run.
+  void run_begin();
+
+  /// A single cycle in the main run loop.
+  bool run_cycle();
+
+  /// Cleanup at end of run.
+  void run_end();
+
+  /// The central function for distributing timeslice data.
+  bool try_send_timeslice(const ComponentRequestUcx& request,
+                          ucp_ep_h reply_ep);
+
+  /// Send an empty reply (component not available).
+  void send_empty_reply(uint64_t ts, ucp_ep_h reply_ep);
+
+  /// Send a reply with the given payload, acknowledge it on completion.
+  void send_reply(PendingReply* reply, std::size_t iov_count, ucp_ep_h ep);
+
+  /// Append the (one or two) chunks of a ring buffer region to an IOV.
+  template <typename T_>
+  std::size_t add_chunks(RingBufferView<T_>& buf,
+                         uint64_t offset,
+                         uint64_t length,
+                         ucp_dt_iov_t* iov);
+
+  /// Close the endpoints that signalled an error.
+  void close_failed_endpoints();
+
+  /// Update read indexes after timeslice has been sent.
+  void ack_timeslice(uint64_t ts);
+
+  /// Force writing read indexes to data source.
+  void sync_data_source();
+
+  /// Print a (periodic) buffer status report.
+  void report_status();
+
+  /// Handle a connection request from a timeslice builder.
+  static void on_connection(ucp_conn_request_h conn_request, void* arg);
+
+  /// Handle an incoming component request active message.
+  static ucs_status_t on_request(void* arg,
+                                 const void* header,
+                                 size_t header_length,
+                                 void* data,
+                                 size_t length,
+                                 const ucp_am_recv_param_t* param);
+
+  /// Handle the completion of a reply.
+  static void on_reply_sent(void* request, ucs_status_t status,
+                            void* user_data);
+
+  /// Handle an endpoint error (e.g., a disconnected timeslice builder).
+  static void on_endpoint_error(void* arg, ucp_ep_h ep, ucs_status_t status);
+};
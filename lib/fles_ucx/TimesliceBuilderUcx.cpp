@@ -0,0 +1,369 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "TimesliceBuilderUcx.hpp"
+#include "ComponentRequestUcx.hpp"
+#include "MicrosliceDescriptor.hpp"
+#include "System.hpp"
+#include "TimesliceCompletion.hpp"
+#include "TimesliceWorkItem.hpp"
+#include "UcxException.hpp"
+#include "Utility.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <thread>
+#include <utility>
+
+namespace {
+/// Delay before asking again for a component that was not available.
+constexpr auto retry_interval = std::chrono::milliseconds(1);
+
+/// Delay before reconnecting to an input server that is not yet listening.
+constexpr auto reconnect_interval = std::chrono::seconds(1);
+} // namespace
+
+TimesliceBuilderUcx::TimesliceBuilderUcx(
+    uint64_t compute_index,
+    TimesliceBuffer& timeslice_buffer,
+    std::vector<std::string> input_server_hosts,
+    std::vector<std::string> input_server_services,
+    uint32_t num_compute_nodes,
+    uint32_t timeslice_size,
+    uint32_t max_timeslice_number,
+    volatile sig_atomic_t* signal_status,
+    cbm::Monitor* monitor)
+    : compute_index_(compute_index), timeslice_buffer_(timeslice_buffer),
+      input_server_hosts_(std::move(input_server_hosts)),
+      input_server_services_(std::move(input_server_services)),
+      num_compute_nodes_(num_compute_nodes), timeslice_size_(timeslice_size),
+      max_timeslice_number_(max_timeslice_number),
+      signal_status_(signal_status), ts_index_(compute_index_),
+      ack_(timeslice_buffer_.get_desc_size_exp()), monitor_(monitor) {
+  assert(input_server_hosts_.size() == input_server_services_.size());
+
+  worker_.set_am_handler(UCX_AM_COMPONENT_REPLY, on_reply, this);
+
+  for (size_t i = 0; i < input_server_hosts_.size(); ++i) {
+    connections_.push_back(
+        std::make_unique<Connection>(timeslice_buffer_, i, this));
+    connect(*connections_.back());
+  }
+
+  hostname_ = fles::system::current_hostname();
+
+  if (monitor_ != nullptr) {
+    build_time_metric_ = monitor_->RegisterHistogram(
+        "timeslice_builder",
+        {{"host", hostname_}, {"output_index", std::to_string(compute_index_)}},
+        "build_time_ns");
+  }
+}
+
+TimesliceBuilderUcx::~TimesliceBuilderUcx() {
+  for (auto& c : connections_) {
+    if (c->ep != nullptr) {
+      worker_.close(c->ep, c->failed || *signal_status_ != 0);
+    }
+  }
+}
+
+void TimesliceBuilderUcx::operator()() {
+  run_begin();
+  while (ts_index_ < max_timeslice_number_ && *signal_status_ == 0) {
+    run_cycle();
+    scheduler_.timer();
+  }
+  run_end();
+}
+
+void TimesliceBuilderUcx::run_begin() {
+  assert(!connections_.empty());
+  time_begin_ = std::chrono::high_resolution_clock::now();
+  previous_report_time_ = std::chrono::system_clock::now();
+  report_status();
+
+  if (ts_index_ < max_timeslice_number_) {
+    build_begin_ = std::chrono::steady_clock::now();
+    for (auto& c : connections_) {
+      request_component(*c);
+    }
+  }
+}
+
+bool TimesliceBuilderUcx::run_cycle() {
+  // replies and rendezvous completions are handled in the callbacks
+  worker_.progress();
+
+  if (components_received_ == connections_.size()) {
+    complete_timeslice();
+  }
+
+  handle_failed_connections();
+
+  return true;
+}
+
+void TimesliceBuilderUcx::run_end() {
+  time_end_ = std::chrono::high_resolution_clock::now();
+
+  // wait until all pending timeslices have been acknowledged
+  while (acked_ < tpos_ && *signal_status_ == 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    handle_timeslice_completions();
+  }
+}
+
+void TimesliceBuilderUcx::connect(Connection& c) {
+  c.failed = false;
+  c.ep = worker_.connect(input_server_hosts_.at(c.index),
+                         input_server_services_.at(c.index),
+                         on_endpoint_error, &c);
+}
+
+void TimesliceBuilderUcx::request_component(Connection& c) {
+  // send request for timeslice data, advertising the free buffer space
+  ComponentRequestUcx request{ts_index_, c.desc.size_available(),
+                              c.data.size_available_contiguous()};
+
+  ucp_request_param_t param{};
+  param.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS | UCP_OP_ATTR_FIELD_CALLBACK;
+  param.flags = UCP_AM_SEND_FLAG_COPY_HEADER | UCP_AM_SEND_FLAG_REPLY;
+  param.cb.send = [](void* req, ucs_status_t /* status */,
+                     void* /* user_data */) { ucp_request_free(req); };
+
+  ucs_status_ptr_t req =
+      ucp_am_send_nbx(c.ep, UCX_AM_COMPONENT_REQUEST, &request,
+                      sizeof(request), nullptr, 0, &param);
+  if (UCS_PTR_IS_ERR(req)) {
+    // the endpoint error handler takes care of the connection
+    L_(debug) << "[c" << compute_index_ << "] request to input " << c.index
+              << " failed: " << ucs_status_string(UCS_PTR_STATUS(req));
+  }
+}
+
+void TimesliceBuilderUcx::component_received(Connection& c) {
+  assert(!c.complete);
+  c.complete = true;
+  ++components_received_;
+}
+
+void TimesliceBuilderUcx::complete_timeslice() {
+  handle_timeslice_completions();
+
+  build_time_metric_.Record(static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - build_begin_)
+          .count()));
+
+  timeslice_buffer_.send_work_item(
+      {{ts_index_, tpos_, timeslice_size_,
+        static_cast<uint32_t>(connections_.size())},
+       timeslice_buffer_.get_max_data_size_exp(),
+       timeslice_buffer_.get_desc_size_exp()});
+  ++tpos_;
+  // next timeslice: round robin
+  ts_index_ += num_compute_nodes_;
+
+  components_received_ = 0;
+  if (ts_index_ >= max_timeslice_number_) {
+    return;
+  }
+  build_begin_ = std::chrono::steady_clock::now();
+  for (auto& c : connections_) {
+    c->complete = false;
+    request_component(*c);
+  }
+}
+
+void TimesliceBuilderUcx::handle_failed_connections() {
+  for (auto& c : connections_) {
+    if (!c->failed || c->ep == nullptr) {
+      continue;
+    }
+    if (c->connected) {
+      throw UcxException("connection to input " + std::to_string(c->index) +
+                         " lost");
+    }
+    // input server not yet listening, try again later
+    worker_.close(c->ep, true);
+    c->ep = nullptr;
+    Connection* conn = c.get();
+    scheduler_.add(
+        [this, conn] {
+          connect(*conn);
+          if (!conn->complete) {
+            request_component(*conn);
+          }
+        },
+        std::chrono::steady_clock::now() + reconnect_interval);
+  }
+}
+
+void TimesliceBuilderUcx::handle_timeslice_completions() {
+  ItemCompletionBatch batch;
+  while (timeslice_buffer_.try_receive_completions(batch)) {
+    uint64_t acked = std::max(acked_, batch.completed_up_to);
+    // Mark out-of-order completions, then advance over all consecutive ones
+    for (auto ts_pos : batch.completed) {
+      if (ts_pos >= acked) {
+        ack_.at(ts_pos) = ts_pos + 1;
+      }
+    }
+    while (ack_.at(acked) == acked + 1) {
+      ++acked;
+    }
+    if (acked != acked_) {
+      acked_ = acked;
+      for (auto& conn : connections_) {
+        conn->desc.set_read_index(acked_);
+        conn->data.set_read_index(conn->desc.at(acked_ - 1).offset +
+                                  conn->desc.at(acked_ - 1).size);
+      }
+    }
+  }
+}
+
+ucs_status_t TimesliceBuilderUcx::on_reply(void* arg,
+                                           const void* header,
+                                           size_t header_length,
+                                           void* data,
+                                           size_t length,
+                                           const ucp_am_recv_param_t* param) {
+  auto* builder = static_cast<TimesliceBuilderUcx*>(arg);
+  assert(header_length == sizeof(ComponentReplyUcx));
+  (void)header_length;
+  const auto& reply = *static_cast<const ComponentReplyUcx*>(header);
+  Connection& c = *builder->connections_.at(reply.input_index);
+  assert(reply.timeslice == builder->ts_index_ && !c.complete);
+  c.connected = true;
+
+  if (reply.desc_size == 0) {
+    // not yet available or no credit, free buffer space while waiting
+    ++builder->retries_;
+    builder->handle_timeslice_completions();
+    Connection* conn = &c;
+    builder->scheduler_.add(
+        [builder, conn] { builder->request_component(*conn); },
+        std::chrono::steady_clock::now() + retry_interval);
+    return UCS_OK;
+  }
+
+  uint64_t size_required = reply.desc_size + reply.data_size;
+  assert(length == size_required);
+
+  // the sender only replies if the component fits into the advertised space
+  assert(c.data.size_available_contiguous() >= size_required &&
+         c.desc.size_available() >= 1);
+
+  // skip remaining bytes in data buffer to avoid fragmented entry
+  c.data.skip_buffer_wrap(size_required);
+  uint64_t offset = c.data.reserve(size_required);
+
+  // generate timeslice component descriptor
+  assert(builder->tpos_ == c.desc.write_index());
+  c.desc.append({builder->ts_index_, offset, size_required,
+                 reply.desc_size / sizeof(fles::MicrosliceDescriptor)});
+
+  void* target = &c.data.at(offset);
+  if ((param->recv_attr & UCP_AM_RECV_ATTR_FLAG_RNDV) == 0u) {
+    // eager protocol, the payload has already arrived
+    std::memcpy(target, data, length);
+    builder->component_received(c);
+    return UCS_OK;
+  }
+
+  // rendezvous protocol, let UCX fetch the payload into shared memory
+  ucp_request_param_t recv_param{};
+  recv_param.op_attr_mask =
+      UCP_OP_ATTR_FIELD_CALLBACK | UCP_OP_ATTR_FIELD_USER_DATA;
+  recv_param.cb.recv_am = on_receive_complete;
+  recv_param.user_data = &c;
+  ucs_status_ptr_t req = ucp_am_recv_data_nbx(builder->worker_.worker(), data,
+                                              target, length, &recv_param);
+  if (req == nullptr) {
+    builder->component_received(c);
+  } else if (UCS_PTR_IS_ERR(req)) {
+    L_LIMITED(error) << "[c" << builder->compute_index_
+                     << "] receive from input " << c.index << " failed: "
+                     << ucs_status_string(UCS_PTR_STATUS(req));
+    c.failed = true;
+  }
+  return UCS_OK;
+}
+
+void TimesliceBuilderUcx::on_receive_complete(void* request,
+                                              ucs_status_t status,
+                                              size_t /* length */,
+                                              void* user_data) {
+  auto* c = static_cast<Connection*>(user_data);
+  if (status == UCS_OK) {
+    c->builder->component_received(*c);
+  } else {
+    L_LIMITED(error) << "[c" << c->builder->compute_index_
+                     << "] receive from input " << c->index
+                     << " failed: " << ucs_status_string(status);
+    c->failed = true;
+  }
+  ucp_request_free(request);
+}
+
+void TimesliceBuilderUcx::on_endpoint_error(void* arg,
+                                            ucp_ep_h /* ep */,
+                                            ucs_status_t status) {
+  auto* c = static_cast<Connection*>(arg);
+  L_(debug) << "[c" << c->builder->compute_index_ << "] connection to input "
+            << c->index << ": " << ucs_status_string(status);
+  c->failed = true;
+}
+
+void TimesliceBuilderUcx::report_status() {
+  constexpr auto interval = std::chrono::seconds(1);
+
+  std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
+
+  auto desc_size = static_cast<int64_t>(connections_.at(0)->desc.size());
+  auto desc_used = static_cast<int64_t>(tpos_ - acked_);
+  int64_t data_size = 0;
+  int64_t data_used = 0;
+  for (auto& c : connections_) {
+    data_size += static_cast<int64_t>(c->data.size());
+    data_used += static_cast<int64_t>(c->data.size_used());
+  }
+
+  double delta_t = std::chrono::duration<double, std::chrono::seconds::period>(
+                       now - previous_report_time_)
+                       .count();
+  double rate_desc =
+      delta_t > 0 ? static_cast<double>(acked_ - previous_acked_) / delta_t
+                  : 0;
+
+  L_(debug) << "[c" << compute_index_ << "] "
+            << human_readable_count(acked_, true, "") << " timeslices, "
+            << retries_ << " empty replies";
+
+  L_(info) << "[c" << compute_index_ << "] |"
+           << bar_graph(std::vector<int64_t>{data_used, data_size - data_used},
+                        "#_", 20)
+           << "|"
+           << bar_graph(std::vector<int64_t>{desc_used, desc_size - desc_used},
+                        "#_", 10)
+           << "| " << human_readable_count(rate_desc, true, "Hz");
+
+  if (monitor_ != nullptr) {
+    monitor_->QueueMetric("recv_buffer_status",
+                          {{"host", hostname_},
+                           {"output_index", std::to_string(compute_index_)}},
+                          {{"data_used", data_used},
+                           {"data_free", data_size - data_used},
+                           {"desc_used", desc_used},
+                           {"desc_free", desc_size - desc_used},
+                           {"desc_rate", rate_desc}});
+  }
+
+  previous_acked_ = acked_;
+  previous_report_time_ = now;
+
+  scheduler_.add([this] { report_status(); }, now + interval);
+}
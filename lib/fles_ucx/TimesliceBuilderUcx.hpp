@@ -0,0 +1,204 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#pragma once
+
+#include "ManagedRingBuffer.hpp"
+#include "Monitor.hpp"
+#include "RingBuffer.hpp"
+#include "Scheduler.hpp"
+#include "TimesliceBuffer.hpp"
+#include "UcxWorker.hpp"
+#include <chrono>
+#include <csignal>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The TimesliceBuilderUcx class
+ *
+ * A TimesliceBuilderUcx object initiates connections to input nodes and
+ * receives timeslices to a timeslice buffer. The components of a timeslice
+ * are requested from all input nodes at once and received as UCP active
+ * messages. Large components use the rendezvous protocol, so UCX fetches
+ * them directly into the timeslice buffer.
+ */
+
+class TimesliceBuilderUcx {
+public:
+  /// The TimesliceBuilderUcx constructor.
+  TimesliceBuilderUcx(uint64_t compute_index,
+                      TimesliceBuffer& timeslice_buffer,
+                      std::vector<std::string> input_server_hosts,
+                      std::vector<std::string> input_server_services,
+                      uint32_t num_compute_nodes,
+                      uint32_t timeslice_size,
+                      uint32_t max_timeslice_number,
+                      volatile sig_atomic_t* signal_status,
+                      cbm::Monitor* monitor);
+
+  TimesliceBuilderUcx(const TimesliceBuilderUcx&) = delete;
+  void operator=(const TimesliceBuilderUcx&) = delete;
+
+  /// The TimesliceBuilderUcx destructor.
+  ~TimesliceBuilderUcx();
+
+  /// The thread main function.
+  void operator()();
+
+  /**
+   * @brief Return a text description of the object (to be used as a thread
+   * name).
+   *
+   * @return A string describing the object (at most 15 characters long).
+   */
+  [[nodiscard]] std::string thread_name() const {
+    return "TSB/UCX/o" + std::to_string(compute_index_);
+  };
+
+private:
+  /// Connection struct, handles data for one input server.
+  struct Connection {
+    Connection(TimesliceBuffer& timeslice_buffer,
+               size_t i,
+               TimesliceBuilderUcx* b)
+        : desc(timeslice_buffer.get_desc_ptr(i),
+               timeslice_buffer.get_desc_size_exp()),
+          data(timeslice_buffer.get_data_ptr(i),
+               timeslice_buffer.get_data_size_exp(i)),
+          index(i), builder(b) {}
+
+    ManagedRingBuffer<fles::TimesliceComponentDescriptor> desc;
+    ManagedRingBuffer<uint8_t> data;
+
+    /// The index of the input server.
+    const size_t index;
+
+    TimesliceBuilderUcx* builder;
+
+    ucp_ep_h ep = nullptr;
+
+    /// A reply has been received, i.e., the connection is established.
+    bool connected = false;
+
+    /// The endpoint signalled an error.
+    bool failed = false;
+
+    /// The component of the current timeslice has been received.
+    bool complete = false;
+  };
+
+  /// This builder's index in the list of compute nodes.
+  const uint64_t compute_index_;
+
+  /// Shared memory buffer to store received timeslices.
+  TimesliceBuffer& timeslice_buffer_;
+
+  /// Vectors of all input server hosts and services to connect to.
+  const std::vector<std::string> input_server_hosts_;
+  const std::vector<std::string> input_server_services_;
+
+  /// Number of compute nodes.
+  const uint32_t num_compute_nodes_;
+
+  /// Constant size (in microslices) of a timeslice component.
+  const uint32_t timeslice_size_;
+
+  /// Number of timeslices after which this run shall end.
+  const uint32_t max_timeslice_number_;
+
+  /// Pointer to global signal status variable.
+  volatile sig_atomic_t* signal_status_;
+
+  /// UCP context and worker.
+  UcxWorker worker_;
+
+  /// Index of acknowledged timeslices (local index).
+  uint64_t acked_ = 0;
+
+  /// The global index of the timeslice currently being received.
+  uint64_t ts_index_;
+
+  /// The local buffer position of the timeslice currently being received.
+  uint64_t tpos_ = 0;
+
+  /// The number of components of the current timeslice received.
+  uint64_t components_received_ = 0;
+
+  /// Buffer to store acknowledged status of timeslices.
+  RingBuffer<uint64_t, true> ack_;
+
+  /// The vector of connections, one per input server.
+  std::vector<std::unique_ptr<Connection>> connections_;
+
+  /// Begin of operation (for performance statistics).
+  std::chrono::high_resolution_clock::time_point time_begin_;
+
+  /// End of operation (for performance statistics).
+  std::chrono::high_resolution_clock::time_point time_end_;
+
+  /// Time of the first request for the current timeslice.
+  std::chrono::steady_clock::time_point build_begin_{};
+
+  cbm::Monitor* monitor_;
+  std::string hostname_;
+
+  /// Time from the first component request to the complete timeslice (ns).
+  cbm::MetricHistogram build_time_metric_;
+
+  /// Number of empty replies (component not available or no credit).
+  uint64_t retries_ = 0;
+
+  uint64_t previous_acked_ = 0;
+  std::chrono::system_clock::time_point previous_report_time_;
+
+  /// Scheduler for delayed and periodic events.
+  Scheduler scheduler_;
+
+  /// Setup at begin of run.
+  void run_begin();
+
+  /// A single cycle in the main run loop.
+  bool run_cycle();
+
+  /// Cleanup at end of run.
+  void run_end();
+
+  /// (Re-)create the endpoint of a connection.
+  void connect(Connection& c);
+
+  /// Request the component of the current timeslice from an input server.
+  void request_component(Connection& c);
+
+  /// Handle a component that has been received completely.
+  void component_received(Connection& c);
+
+  /// Hand the completed timeslice to the buffer and start the next one.
+  void complete_timeslice();
+
+  /// Reconnect or give up on connections that signalled an error.
+  void handle_failed_connections();
+
+  /// Handle pending timeslice completions and advance read indexes.
+  void handle_timeslice_completions();
+
+  /// Print a (periodic) buffer status report.
+  void report_status();
+
+  /// Handle an incoming component reply active message.
+  static ucs_status_t on_reply(void* arg,
+                               const void* header,
+                               size_t header_length,
+                               void* data,
+                               size_t length,
+                               const ucp_am_recv_param_t* param);
+
+  /// Handle the completion of a rendezvous receive.
+  static void on_receive_complete(void* request,
+                                  ucs_status_t status,
+                                  size_t length,
+                                  void* user_data);
+
+  /// Handle an endpoint error (e.g., input server not yet listening).
+  static void on_endpoint_error(void* arg, ucp_ep_h ep, ucs_status_t status);
+};
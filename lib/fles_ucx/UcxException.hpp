@@ -0,0 +1,16 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#pragma once
+
+#include <stdexcept>
+
+/// UCX exception class.
+/** An UcxException object signals an error that occured in the UCX
+    communication functions. */
+
+class UcxException : public std::runtime_error {
+public:
+  /// The UcxException default constructor.
+  explicit UcxException(const std::string& what_arg = "")
+      : std::runtime_error(what_arg) {}
+};
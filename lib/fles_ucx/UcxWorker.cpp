@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "UcxWorker.hpp"
+#include "UcxException.hpp"
+#include "log.hpp"
+#include <arpa/inet.h>
+#include <cstring>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+UcxWorker::UcxWorker() {
+  ucp_config_t* config = nullptr;
+  check(ucp_config_read(nullptr, nullptr, &config), "ucp_config_read failed");
+
+  ucp_params_t params{};
+  params.field_mask = UCP_PARAM_FIELD_FEATURES;
+  params.features = UCP_FEATURE_AM;
+  ucs_status_t status = ucp_init(&params, config, &context_);
+  ucp_config_release(config);
+  check(status, "ucp_init failed");
+
+  ucp_worker_params_t worker_params{};
+  worker_params.field_mask = UCP_WORKER_PARAM_FIELD_THREAD_MODE;
+  worker_params.thread_mode = UCS_THREAD_MODE_SINGLE;
+  status = ucp_worker_create(context_, &worker_params, &worker_);
+  if (status != UCS_OK) {
+    ucp_cleanup(context_);
+    check(status, "ucp_worker_create failed");
+  }
+}
+
+UcxWorker::~UcxWorker() {
+  ucp_worker_destroy(worker_);
+  ucp_cleanup(context_);
+}
+
+void UcxWorker::set_am_handler(unsigned int id,
+                               ucp_am_recv_callback_t cb,
+                               void* arg) {
+  ucp_am_handler_param_t param{};
+  param.field_mask = UCP_AM_HANDLER_PARAM_FIELD_ID |
+                     UCP_AM_HANDLER_PARAM_FIELD_CB |
+                     UCP_AM_HANDLER_PARAM_FIELD_ARG;
+  param.id = id;
+  param.cb = cb;
+  param.arg = arg;
+  check(ucp_worker_set_am_recv_handler(worker_, &param),
+        "ucp_worker_set_am_recv_handler failed");
+}
+
+ucp_listener_h UcxWorker::listen(uint16_t port,
+                                 ucp_listener_conn_callback_t cb,
+                                 void* arg) {
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(port);
+
+  ucp_listener_params_t params{};
+  params.field_mask = UCP_LISTENER_PARAM_FIELD_SOCK_ADDR |
+                      UCP_LISTENER_PARAM_FIELD_CONN_HANDLER;
+  params.sockaddr.addr = reinterpret_cast<const sockaddr*>(&addr);
+  params.sockaddr.addrlen = sizeof(addr);
+  params.conn_handler.cb = cb;
+  params.conn_handler.arg = arg;
+
+  ucp_listener_h listener = nullptr;
+  check(ucp_listener_create(worker_, &params, &listener),
+        "ucp_listener_create failed on port " + std::to_string(port));
+  return listener;
+}
+
+ucp_ep_h UcxWorker::accept(ucp_conn_request_h conn_request,
+                           ucp_err_handler_cb_t cb,
+                           void* arg) {
+  ucp_ep_params_t params{};
+  params.field_mask = UCP_EP_PARAM_FIELD_CONN_REQUEST |
+                      UCP_EP_PARAM_FIELD_ERR_HANDLER |
+                      UCP_EP_PARAM_FIELD_ERR_HANDLING_MODE;
+  params.conn_request = conn_request;
+  params.err_mode = UCP_ERR_HANDLING_MODE_PEER;
+  params.err_handler.cb = cb;
+  params.err_handler.arg = arg;
+
+  ucp_ep_h ep = nullptr;
+  check(ucp_ep_create(worker_, &params, &ep), "ucp_ep_create failed");
+  return ep;
+}
+
+ucp_ep_h UcxWorker::connect(const std::string& hostname,
+                            const std::string& service,
+                            ucp_err_handler_cb_t cb,
+                            void* arg) {
+  addrinfo hints{};
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* res = nullptr;
+  int err = getaddrinfo(hostname.c_str(), service.c_str(), &hints, &res);
+  if (err != 0) {
+    throw UcxException("getaddrinfo failed for " + hostname + ":" + service +
+                       ": " + gai_strerror(err));
+  }
+
+  ucp_ep_params_t params{};
+  params.field_mask = UCP_EP_PARAM_FIELD_FLAGS | UCP_EP_PARAM_FIELD_SOCK_ADDR |
+                      UCP_EP_PARAM_FIELD_ERR_HANDLER |
+                      UCP_EP_PARAM_FIELD_ERR_HANDLING_MODE;
+  params.flags = UCP_EP_PARAMS_FLAGS_CLIENT_SERVER;
+  params.sockaddr.addr = res->ai_addr;
+  params.sockaddr.addrlen = res->ai_addrlen;
+  params.err_mode = UCP_ERR_HANDLING_MODE_PEER;
+  params.err_handler.cb = cb;
+  params.err_handler.arg = arg;
+
+  ucp_ep_h ep = nullptr;
+  ucs_status_t status = ucp_ep_create(worker_, &params, &ep);
+  freeaddrinfo(res);
+  check(status, "ucp_ep_create failed for " + hostname + ":" + service);
+  return ep;
+}
+
+void UcxWorker::close(ucp_ep_h ep, bool force) {
+  ucp_request_param_t param{};
+  param.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS;
+  param.flags = force ? UCP_EP_CLOSE_FLAG_FORCE : 0;
+  ucs_status_t status = wait(ucp_ep_close_nbx(ep, &param));
+  if (status != UCS_OK && status != UCS_ERR_CANCELED) {
+    L_(debug) << "ucp_ep_close_nbx completed with "
+              << ucs_status_string(status);
+  }
+}
+
+void UcxWorker::check(ucs_status_t status, const std::string& what) {
+  if (status != UCS_OK) {
+    throw UcxException(what + ": " + ucs_status_string(status));
+  }
+}
+
+ucs_status_t UcxWorker::wait(ucs_status_ptr_t request) {
+  if (request == nullptr) {
+    return UCS_OK;
+  }
+  if (UCS_PTR_IS_ERR(request)) {
+    return UCS_PTR_STATUS(request);
+  }
+  ucs_status_t status;
+  while ((status = ucp_request_check_status(request)) == UCS_INPROGRESS) {
+    progress();
+  }
+  ucp_request_free(request);
+  return status;
+}
@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <ucp/api/ucp.h>
+
+/// UCP context and worker container class.
+/** A UcxWorker object owns the UCP context and the single-threaded worker
+    of a timeslice builder or component sender. All communication of the
+    owner, including the callbacks, is driven from its own thread by calling
+    progress(). */
+
+class UcxWorker {
+public:
+  /// The UcxWorker default constructor.
+  UcxWorker();
+
+  UcxWorker(const UcxWorker&) = delete;
+  void operator=(const UcxWorker&) = delete;
+
+  /// The UcxWorker destructor.
+  ~UcxWorker();
+
+  /// Retrieve the UCP worker handle.
+  [[nodiscard]] ucp_worker_h worker() const { return worker_; }
+
+  /// Progress all outstanding communication, return the number of events.
+  unsigned int progress() { return ucp_worker_progress(worker_); }
+
+  /// Set the callback for incoming active messages with the given id.
+  void set_am_handler(unsigned int id, ucp_am_recv_callback_t cb, void* arg);
+
+  /// Listen for connection requests on the given port of all interfaces.
+  ucp_listener_h listen(uint16_t port, ucp_listener_conn_callback_t cb,
+                        void* arg);
+
+  /// Create an endpoint from a connection request received by a listener.
+  ucp_ep_h accept(ucp_conn_request_h conn_request, ucp_err_handler_cb_t cb,
+                  void* arg);
+
+  /// Create an endpoint to a listener at the given host and service.
+  ucp_ep_h connect(const std::string& hostname, const std::string& service,
+                   ucp_err_handler_cb_t cb, void* arg);
+
+  /// Close an endpoint, flushing outstanding operations unless forced.
+  void close(ucp_ep_h ep, bool force);
+
+  /// Throw a UcxException if the status signals an error.
+  static void check(ucs_status_t status, const std::string& what);
+
+private:
+  /// Wait for the completion of a non-blocking operation.
+  ucs_status_t wait(ucs_status_ptr_t request);
+
+  ucp_context_h context_ = nullptr;
+  ucp_worker_h worker_ = nullptr;
+};
@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#pragma once
+
+#include <cstdint>
+
+/// Timeslice component request from a TimesliceBuilderZeromq.
+/** A ComponentRequestZeromq is sent by the timeslice builder to request the
+    component of a timeslice from a ComponentSenderZeromq. It carries the
+    free space (credit) of the builder's receive buffers for this input
+    connection, so that the sender only replies with components that fit.
+
+    The builder may receive a component over several parallel streams
+    (sockets), requesting one stripe of the component on each. The requests
+    of all stripes carry the same timeslice and credit. */
+
+struct ComponentRequestZeromq {
+  /// The index of the requested timeslice.
+  uint64_t timeslice;
+
+  /// Free space in the descriptor buffer (in descriptors).
+  uint64_t desc_credit;
+
+  /// Free contiguous space in the data buffer (in bytes).
+  uint64_t data_credit;
+
+  /// The index of the requested stripe.
+  uint32_t stripe;
+
+  /// The number of stripes of the component.
+  uint32_t stripe_count;
+};
+
+/// Timeslice component reply header from a ComponentSenderZeromq.
+/** A ComponentReplyZeromq is the first part of the reply to a
+    ComponentRequestZeromq that carries a component. It announces the sizes
+    of the component and the range of the data part in the following stripe,
+    so that the timeslice builder can receive it directly at its destination
+    in the receive buffer. Stripe 0 also carries the descriptor part. An
+    empty first part instead signals that no component is sent; all stripes
+    of a request receive the same answer. */
+
+struct ComponentReplyZeromq {
+  /// The size of the descriptor part (in bytes).
+  uint64_t desc_size;
+
+  /// The size of the data part (in bytes).
+  uint64_t data_size;
+
+  /// The offset of the stripe in the data part (in bytes).
+  uint64_t stripe_offset;
+
+  /// The size of the stripe (in bytes).
+  uint64_t stripe_size;
+};
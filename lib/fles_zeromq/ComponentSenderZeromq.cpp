@@ -2,6 +2,7 @@
 // Copyright 2024 Florian Schintke <schintke@zib.de>
 
 #include "ComponentSenderZeromq.hpp"
+#include "EventTrace.hpp"
 #include "MicrosliceDescriptor.hpp"
 #include "RingBufferView.hpp"
 #include "System.hpp"
@@ -24,15 +25,9 @@ ComponentSenderZeromq::ComponentSenderZeromq(
     : input_index_(input_index), data_source_(data_source),
       timeslice_size_(timeslice_size), overlap_size_(overlap_size),
       max_timeslice_number_(max_timeslice_number),
-      signal_status_(signal_status),
-      min_acked_({data_source.desc_buffer().size() / 4,
-                  data_source.data_buffer().size() / 4}),
+      signal_status_(signal_status), acks_(data_source, timeslice_size),
       monitor_(monitor) {
-  start_index_ = sent_ = acked_ = cached_acked_ = data_source.get_read_index();
-
-  size_t min_ack_buffer_size =
-      (data_source_.desc_buffer().size() / timeslice_size_ + 1) * 2;
-  ack_.alloc_with_size(min_ack_buffer_size);
+  start_index_ = sent_ = data_source.get_read_index();
 
   socket_ = zmq_socket(zmq_context, ZMQ_REP);
   assert(socket_);
@@ -47,6 +42,17 @@ ComponentSenderZeromq::ComponentSenderZeromq(
   assert(rc == 0);
 
   hostname_ = fles::system::current_hostname();
+
+  if (monitor_ != nullptr) {
+    cbm::MetricTagSet tags{{"host", hostname_},
+                           {"input_index", std::to_string(input_index_)}};
+    sent_components_metric_ =
+        monitor_->RegisterCounter("component_sender", tags, "components");
+    credit_stalls_metric_ =
+        monitor_->RegisterCounter("component_sender", tags, "credit_stalls");
+    component_bytes_metric_ =
+        monitor_->RegisterHistogram("component_sender", tags, "bytes");
+  }
 }
 
 ComponentSenderZeromq::~ComponentSenderZeromq() {
@@ -58,7 +64,8 @@ ComponentSenderZeromq::~ComponentSenderZeromq() {
 
 void ComponentSenderZeromq::operator()() {
   run_begin();
-  while (acked_ts2_ / 2 < max_timeslice_number_ && *signal_status_ == 0) {
+  while (acks_.acked_timeslices() < max_timeslice_number_ &&
+         *signal_status_ == 0) {
     run_cycle();
     scheduler_.timer();
   }
@@ -85,11 +92,12 @@ bool ComponentSenderZeromq::run_cycle() {
   }
   assert(len != -1);
 
-  assert(len == sizeof(uint64_t));
-  uint64_t timeslice = *static_cast<uint64_t*>(zmq_msg_data(&request));
+  assert(len == sizeof(ComponentRequestZeromq));
+  ComponentRequestZeromq component_request =
+      *static_cast<ComponentRequestZeromq*>(zmq_msg_data(&request));
   zmq_msg_close(&request);
 
-  try_send_timeslice(timeslice);
+  try_send_timeslice(component_request);
   data_source_.proceed();
 
   return true;
@@ -118,8 +126,38 @@ void ComponentSenderZeromq::process_pending_acks() {
   }
 }
 
-bool ComponentSenderZeromq::try_send_timeslice(uint64_t ts) {
-  assert(ts >= acked_ts2_ / 2);
+bool ComponentSenderZeromq::try_send_timeslice(
+    const ComponentRequestZeromq& request) {
+  uint64_t ts = request.timeslice;
+  assert(ts >= acks_.acked_timeslices());
+  assert(request.stripe < request.stripe_count);
+
+  // the first stripe request of a component decides for all of its stripes
+  auto it = replies_.find(ts);
+  if (it == replies_.end()) {
+    it = replies_.emplace(ts, decide(request)).first;
+  }
+  ComponentReply& reply = it->second;
+  assert(reply.stripe_count == request.stripe_count);
+
+  bool accepted = reply.accepted;
+  if (accepted) {
+    send_stripe(ts, reply, request.stripe);
+  } else {
+    send_empty_reply();
+  }
+  if (--reply.stripes_left == 0) {
+    replies_.erase(it);
+  }
+  return accepted;
+}
+
+ComponentSenderZeromq::ComponentReply
+ComponentSenderZeromq::decide(const ComponentRequestZeromq& request) {
+  uint64_t ts = request.timeslice;
+  ComponentReply reply;
+  reply.stripe_count = request.stripe_count;
+  reply.stripes_left = request.stripe_count;
 
   uint64_t desc_offset = ts * timeslice_size_ + start_index_.desc;
   uint64_t desc_length = timeslice_size_ + overlap_size_;
@@ -129,29 +167,10 @@ bool ComponentSenderZeromq::try_send_timeslice(uint64_t ts) {
     data_source_.proceed();
     write_index_desc_ = data_source_.get_write_index().desc;
     if (write_index_desc_ < desc_offset + desc_length) {
-      // send empty message
-      zmq_msg_t msg;
-      zmq_msg_init_size(&msg, 0);
-      int rc;
-      do {
-        rc = zmq_msg_send(&msg, socket_, 0);
-      } while (rc == -1 && errno == EAGAIN && *signal_status_ == 0);
-      return false;
+      return reply;
     }
   }
 
-  // part 1: descriptors
-  if (desc_offset + desc_length > sent_.desc) {
-    sent_.desc = desc_offset + desc_length;
-  }
-  auto desc_msg = create_message(data_source_.desc_buffer(), desc_offset,
-                                 desc_length, ts, false);
-  int rc;
-  do {
-    rc = zmq_msg_send(&desc_msg, socket_, ZMQ_SNDMORE);
-  } while (rc == -1 && errno == EAGAIN && *signal_status_ == 0);
-
-  // part 2: data
   uint64_t data_offset = data_source_.desc_buffer().at(desc_offset).offset;
   uint64_t data_end =
       data_source_.desc_buffer().at(desc_offset + desc_length - 1).offset +
@@ -159,16 +178,80 @@ bool ComponentSenderZeromq::try_send_timeslice(uint64_t ts) {
   assert(data_end >= data_offset);
   uint64_t data_length = data_end - data_offset;
 
+  // check if the component fits into the receiver's buffers
+  uint64_t size_required =
+      desc_length * sizeof(fles::MicrosliceDescriptor) + data_length;
+  if (request.desc_credit < 1 || request.data_credit < size_required) {
+    ++credit_stalls_;
+    credit_stalls_metric_.Add();
+    return reply;
+  }
+
+  EventTrace::record(TraceEventType::TimeslicePosted, ts);
+
+  if (desc_offset + desc_length > sent_.desc) {
+    sent_.desc = desc_offset + desc_length;
+  }
   if (data_offset + data_length > sent_.data) {
     sent_.data = data_offset + data_length;
   }
-  auto data_msg = create_message(data_source_.data_buffer(), data_offset,
-                                 data_length, ts, true);
+  data_stripes_left_[ts] = reply.stripe_count;
+
+  sent_components_metric_.Add();
+  component_bytes_metric_.Record(size_required);
+
+  reply.accepted = true;
+  reply.desc_offset = desc_offset;
+  reply.desc_length = desc_length;
+  reply.data_offset = data_offset;
+  reply.data_length = data_length;
+  return reply;
+}
+
+void ComponentSenderZeromq::send_stripe(uint64_t ts,
+                                        const ComponentReply& reply,
+                                        uint32_t stripe) {
+  // the data part is split into ranges of equal size, one per stripe
+  uint64_t chunk =
+      (reply.data_length + reply.stripe_count - 1) / reply.stripe_count;
+  uint64_t begin = std::min(stripe * chunk, reply.data_length);
+  uint64_t end = std::min(begin + chunk, reply.data_length);
+
+  // header: sizes of the component and range of the stripe
+  ComponentReplyZeromq header{
+      reply.desc_length * sizeof(fles::MicrosliceDescriptor),
+      reply.data_length, begin, end - begin};
+  int rc;
+  do {
+    rc = zmq_send(socket_, &header, sizeof(header), ZMQ_SNDMORE);
+  } while (rc == -1 && errno == EAGAIN && *signal_status_ == 0);
+
+  // part 1: descriptors (first stripe only)
+  if (stripe == 0) {
+    auto desc_msg = create_message(data_source_.desc_buffer(),
+                                   reply.desc_offset, reply.desc_length, ts,
+                                   false);
+    do {
+      rc = zmq_msg_send(&desc_msg, socket_, ZMQ_SNDMORE);
+    } while (rc == -1 && errno == EAGAIN && *signal_status_ == 0);
+  }
+
+  // part 2: data of the stripe
+  auto data_msg = create_message(data_source_.data_buffer(),
+                                 reply.data_offset + begin, end - begin, ts,
+                                 true);
   do {
     rc = zmq_msg_send(&data_msg, socket_, 0);
   } while (rc == -1 && errno == EAGAIN && *signal_status_ == 0);
+}
 
-  return true;
+void ComponentSenderZeromq::send_empty_reply() {
+  zmq_msg_t msg;
+  zmq_msg_init_size(&msg, 0);
+  int rc;
+  do {
+    rc = zmq_msg_send(&msg, socket_, 0);
+  } while (rc == -1 && errno == EAGAIN && *signal_status_ == 0);
 }
 
 template <typename T_>
@@ -183,8 +266,9 @@ zmq_msg_t ComponentSenderZeromq::create_message(RingBufferView<T_>& buf,
     // zero chunks
     zmq_msg_init_size(&msg, 0);
     ack_timeslice(ts, is_data);
-  } else if ((offset & buf.size_mask()) <=
-             ((offset + length - 1) & buf.size_mask())) {
+  } else if (buf.mirrored() ||
+             (offset & buf.size_mask()) <=
+                 ((offset + length - 1) & buf.size_mask())) {
     // one chunk
     auto* data = &buf.at(offset);
     size_t bytes = sizeof(T_) * length;
@@ -192,14 +276,8 @@ zmq_msg_t ComponentSenderZeromq::create_message(RingBufferView<T_>& buf,
     zmq_msg_init_data(&msg, data, bytes, enqueue_ack, hint);
   } else {
     // two chunks
-    auto* data1 = &buf.at(offset);
-    size_t size1 = buf.size() - (offset & buf.size_mask());
-    auto* data2 = buf.ptr();
-    size_t size2 = length - buf.size() + (offset & buf.size_mask());
-    zmq_msg_init_size(&msg, (size1 + size2) * sizeof(T_));
-    auto msg_buf = static_cast<T_*>(zmq_msg_data(&msg));
-    std::copy_n(data1, size1, msg_buf);
-    std::copy_n(data2, size2, msg_buf + size1);
+    zmq_msg_init_size(&msg, length * sizeof(T_));
+    buf.copy_out(offset, static_cast<T_*>(zmq_msg_data(&msg)), length);
     ack_timeslice(ts, is_data);
   }
 
@@ -207,34 +285,21 @@ zmq_msg_t ComponentSenderZeromq::create_message(RingBufferView<T_>& buf,
 }
 
 void ComponentSenderZeromq::ack_timeslice(uint64_t ts, bool is_data) {
-  // use ts2 and acked_ts2_ to handle desc and data sequentially
-  uint64_t ts2 = ts * 2 + (is_data ? 1 : 0);
-  assert(ts2 >= acked_ts2_);
-  if (ts2 != acked_ts2_) {
-    // transmission has been reordered, store completion information
-    ack_.at(ts2) = ts2;
-  } else {
-    // completion is for earliest pending timeslice, update indices
-    do {
-      ++acked_ts2_;
-    } while (ack_.at(acked_ts2_) > ts2);
-    acked_.desc = acked_ts2_ / 2 * timeslice_size_ + start_index_.desc;
-    acked_.data = data_source_.desc_buffer().at(acked_.desc - 1).offset +
-                  data_source_.desc_buffer().at(acked_.desc - 1).size;
-    if (acked_.data >= cached_acked_.data + min_acked_.data ||
-        acked_.desc >= cached_acked_.desc + min_acked_.desc) {
-      cached_acked_ = acked_;
-      data_source_.set_read_index(cached_acked_);
+  if (is_data) {
+    // the data is acknowledged once all of its stripes are released
+    auto it = data_stripes_left_.find(ts);
+    assert(it != data_stripes_left_.end());
+    if (--it->second != 0) {
+      return;
     }
+    data_stripes_left_.erase(it);
+    EventTrace::record(TraceEventType::WriteCompleted, ts);
   }
+  // desc and data are acknowledged in sequence
+  acks_.ack(ts, is_data ? 1 : 0);
 }
 
-void ComponentSenderZeromq::sync_data_source() {
-  if (acked_.data > cached_acked_.data || acked_.desc > cached_acked_.desc) {
-    cached_acked_ = acked_;
-    data_source_.set_read_index(cached_acked_);
-  }
-}
+void ComponentSenderZeromq::sync_data_source() { acks_.sync(); }
 
 void ComponentSenderZeromq::report_status() {
   constexpr auto interval = std::chrono::seconds(1);
@@ -258,14 +323,14 @@ void ComponentSenderZeromq::report_status() {
 
   SendBufferStatus status_desc{now,
                                data_source_.desc_buffer().size(),
-                               cached_acked_.desc,
-                               acked_.desc,
+                               acks_.cached_acked().desc,
+                               acks_.acked().desc,
                                sent_.desc,
                                written_desc};
   SendBufferStatus status_data{now,
                                data_source_.data_buffer().size(),
-                               cached_acked_.data,
-                               acked_.data,
+                               acks_.cached_acked().data,
+                               acks_.acked().data,
                                sent_.data,
                                written_data};
 
@@ -305,6 +370,9 @@ void ComponentSenderZeromq::report_status() {
             << human_readable_count(status_data.acked, true) << " ("
             << human_readable_count(rate_data, true, "B/s") << ")";
 
+  L_(debug) << "[i" << input_index_ << "] " << credit_stalls_
+            << " requests declined for lack of receiver credit";
+
   L_(info) << "[i" << input_index_ << "] |"
            << bar_graph(status_data.vector(), "#x._", 20) << "|"
            << bar_graph(status_desc.vector(), "#x._", 10) << "| "
@@ -1,14 +1,19 @@
 // Copyright 2012-2013, 2016 Jan de Cuveland <cmail@cuveland.de>
 #pragma once
 
+#include "ComponentRequestZeromq.hpp"
 #include "DualRingBuffer.hpp"
 #include "Monitor.hpp"
 #include "RingBuffer.hpp"
 #include "Scheduler.hpp"
+#include "SendBufferStatus.hpp"
+#include "TimesliceAckTracker.hpp"
 #include <boost/format.hpp>
 #include <cassert>
 #include <csignal>
 #include <mutex>
+#include <queue>
+#include <unordered_map>
 #include <zmq.h>
 
 /// Input buffer and compute node connection container class.
@@ -84,20 +89,27 @@ private:
   /// Mutex to manage access to the pending_acks_ queue.
   std::mutex pending_acks_mutex_;
 
-  /// Buffer to store acknowledged status of timeslices.
-  RingBuffer<uint64_t, true> ack_;
-
-  /// Number of acknowledged timeslices (times two - desc and data).
-  uint64_t acked_ts2_ = 0;
+  /// Decision on a requested component, shared by all of its stripes.
+  struct ComponentReply {
+    bool accepted = false;
+    uint64_t desc_offset = 0;
+    uint64_t desc_length = 0;
+    uint64_t data_offset = 0;
+    uint64_t data_length = 0;
+    uint32_t stripe_count = 1;
+    /// Number of stripe requests not yet answered.
+    uint32_t stripes_left = 1;
+  };
 
-  /// Indexes of acknowledged microslices (i.e., read indexes).
-  DualIndex acked_{};
+  /// Decisions on the components whose stripes are being requested.
+  std::unordered_map<uint64_t, ComponentReply> replies_;
 
-  /// Hysteresis for writing read indexes to data source.
-  const DualIndex min_acked_;
+  /// Number of data stripes not yet released by ZeroMQ, per timeslice.
+  std::unordered_map<uint64_t, uint32_t> data_stripes_left_;
 
-  /// Read indexes last written to data source.
-  DualIndex cached_acked_{};
+  /// Acknowledgment accounting of the sent timeslices (desc and data are
+  /// acknowledged separately).
+  TimesliceAckTracker<InputBufferReadInterface, 2> acks_;
 
   /// Read indexes at start of operation.
   DualIndex start_index_{};
@@ -114,58 +126,16 @@ private:
   /// Amount of data sent (for performance statistics).
   DualIndex sent_{};
 
+  /// Number of requests declined for lack of receiver credit.
+  uint64_t credit_stalls_ = 0;
+
   cbm::Monitor* monitor_;
   std::string hostname_;
 
-  struct SendBufferStatus {
-    std::chrono::system_clock::time_point time;
-    uint64_t size = 0;
-
-    uint64_t cached_acked = 0;
-    uint64_t acked = 0;
-    uint64_t sent = 0;
-    uint64_t written = 0;
-
-    [[nodiscard]] int64_t used() const {
-      assert(sent <= written);
-      return written - sent;
-    }
-    [[nodiscard]] int64_t sending() const {
-      assert(acked <= sent);
-      return sent - acked;
-    }
-    [[nodiscard]] int64_t freeing() const {
-      assert(cached_acked <= acked);
-      return acked - cached_acked;
-    }
-    [[nodiscard]] int64_t unused() const {
-      assert(written <= cached_acked + size);
-      return cached_acked + size - written;
-    }
-
-    [[nodiscard]] float percentage(int64_t value) const {
-      return static_cast<float>(value) / static_cast<float>(size);
-    }
-
-    static std::string caption() { return {"used/sending/freeing/free"}; }
-
-    [[nodiscard]] std::string percentage_str(int64_t value) const {
-      boost::format percent_fmt("%4.1f%%");
-      percent_fmt % (percentage(value) * 100);
-      std::string s = percent_fmt.str();
-      s.resize(4);
-      return s;
-    }
-
-    [[nodiscard]] std::string percentages() const {
-      return percentage_str(used()) + " " + percentage_str(sending()) + " " +
-             percentage_str(freeing()) + " " + percentage_str(unused());
-    }
-
-    [[nodiscard]] std::vector<int64_t> vector() const {
-      return std::vector<int64_t>{used(), sending(), freeing(), unused()};
-    }
-  };
+  /// Per-request metrics (registered once, recorded without allocation).
+  cbm::MetricCounter sent_components_metric_;
+  cbm::MetricCounter credit_stalls_metric_;
+  cbm::MetricHistogram component_bytes_metric_;
 
   SendBufferStatus previous_send_buffer_status_desc_ = SendBufferStatus();
   SendBufferStatus previous_send_buffer_status_data_ = SendBufferStatus();
@@ -186,7 +156,16 @@ private:
   void process_pending_acks();
 
   /// The central function for distributing timeslice data.
-  bool try_send_timeslice(uint64_t ts);
+  bool try_send_timeslice(const ComponentRequestZeromq& request);
+
+  /// Decide whether a requested component is available and fits.
+  ComponentReply decide(const ComponentRequestZeromq& request);
+
+  /// Send one stripe of an accepted component.
+  void send_stripe(uint64_t ts, const ComponentReply& reply, uint32_t stripe);
+
+  /// Send an empty reply (component not available).
+  void send_empty_reply();
 
   /// Create zeromq message part with requested data.
   template <typename T_>
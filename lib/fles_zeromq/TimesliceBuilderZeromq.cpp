@@ -1,12 +1,14 @@
 // Copyright 2013, 2016 Jan de Cuveland <cmail@cuveland.de>
 
 #include "TimesliceBuilderZeromq.hpp"
+#include "ComponentRequestZeromq.hpp"
 #include "MicrosliceDescriptor.hpp"
 #include "System.hpp"
 #include "TimesliceCompletion.hpp"
 #include "TimesliceWorkItem.hpp"
 #include "Utility.hpp"
 #include "log.hpp"
+#include <algorithm>
 #include <chrono>
 #include <thread>
 #include <utility>
@@ -20,7 +22,8 @@ TimesliceBuilderZeromq::TimesliceBuilderZeromq(
     uint32_t max_timeslice_number,
     volatile sig_atomic_t* signal_status,
     void* zmq_context,
-    cbm::Monitor* monitor)
+    cbm::Monitor* monitor,
+    uint32_t num_streams)
     : compute_index_(compute_index), timeslice_buffer_(timeslice_buffer),
       input_server_addresses_(std::move(input_server_addresses)),
       num_compute_nodes_(num_compute_nodes), timeslice_size_(timeslice_size),
@@ -32,29 +35,39 @@ TimesliceBuilderZeromq::TimesliceBuilderZeromq(
 
     std::unique_ptr<Connection> c(new Connection{timeslice_buffer_, i});
 
-    c->socket = zmq_socket(zmq_context, ZMQ_REQ);
-    assert(c->socket);
-    int timeout_ms = 500;
-    [[maybe_unused]] int rc =
-        zmq_setsockopt(c->socket, ZMQ_RCVTIMEO, &timeout_ms, sizeof timeout_ms);
-    assert(rc == 0);
-    rc =
-        zmq_setsockopt(c->socket, ZMQ_SNDTIMEO, &timeout_ms, sizeof timeout_ms);
-    assert(rc == 0);
+    // each socket has its own TCP connection to the input server
+    for (uint32_t s = 0; s < std::max(num_streams, 1U); ++s) {
+      void* socket = zmq_socket(zmq_context, ZMQ_REQ);
+      assert(socket);
+      int timeout_ms = 500;
+      [[maybe_unused]] int rc =
+          zmq_setsockopt(socket, ZMQ_RCVTIMEO, &timeout_ms, sizeof timeout_ms);
+      assert(rc == 0);
+      rc = zmq_setsockopt(socket, ZMQ_SNDTIMEO, &timeout_ms, sizeof timeout_ms);
+      assert(rc == 0);
 
-    rc = zmq_connect(c->socket, input_server_address.c_str());
-    assert(rc == 0);
+      rc = zmq_connect(socket, input_server_address.c_str());
+      assert(rc == 0);
+      c->sockets.push_back(socket);
+    }
 
     connections_.push_back(std::move(c));
   }
 
   hostname_ = fles::system::current_hostname();
+
+  if (monitor_ != nullptr) {
+    build_time_metric_ = monitor_->RegisterHistogram(
+        "timeslice_builder",
+        {{"host", hostname_}, {"output_index", std::to_string(compute_index_)}},
+        "build_time_ns");
+  }
 }
 
 TimesliceBuilderZeromq::~TimesliceBuilderZeromq() {
   for (auto& c : connections_) {
-    if (c->socket != nullptr) {
-      [[maybe_unused]] int rc = zmq_close(c->socket);
+    for (void* socket : c->sockets) {
+      [[maybe_unused]] int rc = zmq_close(socket);
       assert(rc == 0);
     }
   }
@@ -78,74 +91,88 @@ void TimesliceBuilderZeromq::run_begin() {
 bool TimesliceBuilderZeromq::run_cycle() {
   auto& c = connections_.at(conn_);
 
-  std::size_t msg_size;
-
-  // send request for timeslice data
-  int rc;
-  do {
-    rc = zmq_send(c->socket, &ts_index_, sizeof(ts_index_), 0);
-  } while (rc == -1 && errno == EAGAIN && *signal_status_ == 0);
-  if (*signal_status_ != 0) {
-    return true;
-  }
-
-  // receive desc answer (part 1), do not release
-  rc = zmq_msg_init(&c->desc_msg);
-  assert(rc == 0);
-  do {
-    rc = zmq_msg_recv(&c->desc_msg, c->socket, 0);
-  } while (rc == -1 && errno == EAGAIN && *signal_status_ == 0);
-  if (*signal_status_ != 0) {
-    return true;
-  }
-  assert(rc != -1);
-  msg_size = zmq_msg_size(&c->desc_msg);
-  if (msg_size == 0) {
-    zmq_msg_close(&c->desc_msg);
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  if (build_begin_ == std::chrono::steady_clock::time_point()) {
+    build_begin_ = std::chrono::steady_clock::now();
   }
 
-  if (msg_size == 0 || *signal_status_ != 0) {
-    return true;
+  // send requests for all stripes of the timeslice data, advertising the
+  // free buffer space
+  const auto stripe_count = static_cast<uint32_t>(c->sockets.size());
+  int rc;
+  for (uint32_t s = 0; s < stripe_count; ++s) {
+    ComponentRequestZeromq request{ts_index_, c->desc.size_available(),
+                                   c->data.size_available_contiguous(), s,
+                                   stripe_count};
+    do {
+      rc = zmq_send(c->sockets[s], &request, sizeof(request), 0);
+    } while (rc == -1 && errno == EAGAIN && *signal_status_ == 0);
+    if (*signal_status_ != 0) {
+      return true;
+    }
   }
 
-  // receive data answer (part 2), do not release
-  assert(zmq_msg_more(&c->desc_msg));
-  rc = zmq_msg_init(&c->data_msg);
-  assert(rc == 0);
-  do {
-    rc = zmq_msg_recv(&c->data_msg, c->socket, 0);
-  } while (rc == -1 && errno == EAGAIN && *signal_status_ == 0);
-  if (*signal_status_ != 0) {
-    return true;
+  // receive the stripes, all of which carry the same decision
+  bool accepted = false;
+  uint64_t offset = 0;
+  ComponentReplyZeromq reply{};
+  for (uint32_t s = 0; s < stripe_count; ++s) {
+    // receive reply header announcing the part sizes
+    rc = receive_part(c->sockets[s], &reply, sizeof(reply));
+    if (rc == -1) {
+      return true;
+    }
+    if (rc == 0) {
+      // not yet available or no credit
+      assert(s == 0 || !accepted);
+      continue;
+    }
+    assert(rc == sizeof(reply));
+    assert(s == 0 || accepted);
+
+    uint64_t size_required = reply.desc_size + reply.data_size;
+    if (s == 0) {
+      // the sender only replies if the component fits into the advertised
+      // space
+      assert(c->data.size_available_contiguous() >= size_required &&
+             c->desc.size_available() >= 1);
+
+      // skip remaining bytes in data buffer to avoid fragmented entry
+      c->data.skip_buffer_wrap(size_required);
+      offset = c->data.reserve(size_required);
+      accepted = true;
+    }
+    assert(c->data.write_index() == offset + size_required);
+
+    // receive desc (part 1, first stripe only) and data answer (part 2)
+    // directly into shared memory
+    uint8_t* dest = &c->data.at(offset);
+    if (s == 0) {
+      rc = receive_part(c->sockets[s], dest, reply.desc_size);
+      if (rc == -1) {
+        return true;
+      }
+      assert(static_cast<uint64_t>(rc) == reply.desc_size);
+    }
+    rc = receive_part(c->sockets[s],
+                      dest + reply.desc_size + reply.stripe_offset,
+                      reply.stripe_size);
+    if (rc == -1) {
+      return true;
+    }
+    assert(static_cast<uint64_t>(rc) == reply.stripe_size);
   }
-  assert(rc != -1);
 
-  uint64_t size_required =
-      zmq_msg_size(&c->desc_msg) + zmq_msg_size(&c->data_msg);
-
-  while (c->data.size_available_contiguous() < size_required ||
-         c->desc.size_available() < 1) {
+  if (!accepted) {
+    // free buffer space while waiting
     std::this_thread::sleep_for(std::chrono::milliseconds(10));
     handle_timeslice_completions();
+    return true;
   }
 
-  // skip remaining bytes in data buffer to avoid fragmented entry
-  c->data.skip_buffer_wrap(size_required);
-
   // generate timeslice component descriptor
   assert(tpos_ == c->desc.write_index());
-  c->desc.append(
-      {ts_index_, c->data.write_index(), size_required,
-       zmq_msg_size(&c->desc_msg) / sizeof(fles::MicrosliceDescriptor)});
-
-  // copy into shared memory and release messages
-  c->data.append(static_cast<uint8_t*>(zmq_msg_data(&c->desc_msg)),
-                 zmq_msg_size(&c->desc_msg));
-  c->data.append(static_cast<uint8_t*>(zmq_msg_data(&c->data_msg)),
-                 zmq_msg_size(&c->data_msg));
-  zmq_msg_close(&c->desc_msg);
-  zmq_msg_close(&c->data_msg);
+  c->desc.append({ts_index_, offset, reply.desc_size + reply.data_size,
+                  reply.desc_size / sizeof(fles::MicrosliceDescriptor)});
 
   ++conn_;
   if (conn_ == connections_.size()) {
@@ -153,10 +180,16 @@ bool TimesliceBuilderZeromq::run_cycle() {
 
     handle_timeslice_completions();
 
+    build_time_metric_.Record(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - build_begin_)
+            .count()));
+    build_begin_ = {};
+
     timeslice_buffer_.send_work_item(
         {{ts_index_, tpos_, timeslice_size_,
           static_cast<uint32_t>(connections_.size())},
-         timeslice_buffer_.get_data_size_exp(),
+         timeslice_buffer_.get_max_data_size_exp(),
          timeslice_buffer_.get_desc_size_exp()});
     ++tpos_;
     // next timeslice: round robin
@@ -178,20 +211,40 @@ void TimesliceBuilderZeromq::run_end() {
   assert(timeslice_buffer_.get_num_completions() == 0);
 }
 
+int TimesliceBuilderZeromq::receive_part(void* socket,
+                                         void* buf,
+                                         std::size_t size) {
+  int rc;
+  do {
+    rc = zmq_recv(socket, buf, size, 0);
+  } while (rc == -1 && errno == EAGAIN && *signal_status_ == 0);
+  if (*signal_status_ != 0) {
+    return -1;
+  }
+  assert(rc != -1);
+  return rc;
+}
+
 void TimesliceBuilderZeromq::handle_timeslice_completions() {
-  fles::TimesliceCompletion c{};
-  while (timeslice_buffer_.try_receive_completion(c)) {
-    if (c.ts_pos == acked_) {
-      do {
-        ++acked_;
-      } while (ack_.at(acked_) > c.ts_pos);
+  ItemCompletionBatch batch;
+  while (timeslice_buffer_.try_receive_completions(batch)) {
+    uint64_t acked = std::max(acked_, batch.completed_up_to);
+    // Mark out-of-order completions, then advance over all consecutive ones
+    for (auto ts_pos : batch.completed) {
+      if (ts_pos >= acked) {
+        ack_.at(ts_pos) = ts_pos + 1;
+      }
+    }
+    while (ack_.at(acked) == acked + 1) {
+      ++acked;
+    }
+    if (acked != acked_) {
+      acked_ = acked;
       for (auto& conn : connections_) {
         conn->desc.set_read_index(acked_);
         conn->data.set_read_index(conn->desc.at(acked_ - 1).offset +
                                   conn->desc.at(acked_ - 1).size);
       }
-    } else {
-      ack_.at(c.ts_pos) = c.ts_pos;
     }
   }
 }
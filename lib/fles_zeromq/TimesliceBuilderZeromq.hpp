@@ -18,6 +18,11 @@
  *
  * A TimesliceBuilderZeromq object initiates connections to input nodes  and
  * receives timeslices to a timeslice buffer.
+ *
+ * Each input connection may use several parallel streams (sockets, and thus
+ * TCP connections), which are served by the I/O threads of the ZeroMQ
+ * context in parallel. Each component is then split into stripes, one per
+ * stream, which are received directly at their place in the data buffer.
  */
 
 class TimesliceBuilderZeromq {
@@ -31,7 +36,8 @@ public:
                          uint32_t max_timeslice_number,
                          volatile sig_atomic_t* signal_status,
                          void* zmq_context,
-                         cbm::Monitor* monitor);
+                         cbm::Monitor* monitor,
+                         uint32_t num_streams = 1);
 
   TimesliceBuilderZeromq(const TimesliceBuilderZeromq&) = delete;
   void operator=(const TimesliceBuilderZeromq&) = delete;
@@ -95,14 +101,13 @@ private:
         : desc(timeslice_buffer.get_desc_ptr(i),
                timeslice_buffer.get_desc_size_exp()),
           data(timeslice_buffer.get_data_ptr(i),
-               timeslice_buffer.get_data_size_exp()) {}
+               timeslice_buffer.get_data_size_exp(i)) {}
 
     ManagedRingBuffer<fles::TimesliceComponentDescriptor> desc;
     ManagedRingBuffer<uint8_t> data;
 
-    void* socket = nullptr;
-    zmq_msg_t desc_msg{};
-    zmq_msg_t data_msg{};
+    /// ZeroMQ sockets, one per stream.
+    std::vector<void*> sockets;
   };
 
   /// The vector of connections, one per input server.
@@ -114,9 +119,15 @@ private:
   /// End of operation (for performance statistics).
   std::chrono::high_resolution_clock::time_point time_end_;
 
+  /// Time of the first request for the current timeslice (zero: none yet).
+  std::chrono::steady_clock::time_point build_begin_{};
+
   cbm::Monitor* monitor_;
   std::string hostname_;
 
+  /// Time from the first component request to the complete timeslice (ns).
+  cbm::MetricHistogram build_time_metric_;
+
   struct BufferStatus {
     std::chrono::system_clock::time_point time;
     uint64_t size = 0;
@@ -170,6 +181,11 @@ private:
   /// Cleanup at end of run.
   void run_end();
 
+  /// Receive the next message part of a socket into a buffer.
+  /** Returns the size of the message part, or -1 if interrupted by a
+      signal. */
+  int receive_part(void* socket, void* buf, std::size_t size);
+
   /// Handle pending timeslice completions and advance read indexes.
   void handle_timeslice_completions();
 
@@ -4,11 +4,14 @@
 #pragma once
 
 #include "DualRingBuffer.hpp"
+#include "shm_index.hpp"
 #include <boost/date_time/posix_time/posix_time_types.hpp>
 #include <boost/interprocess/managed_shared_memory.hpp>
 #include <boost/interprocess/sync/interprocess_condition.hpp>
 #include <boost/interprocess/sync/interprocess_mutex.hpp>
 #include <boost/interprocess/sync/scoped_lock.hpp>
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 
 namespace ip = boost::interprocess;
@@ -18,6 +21,26 @@ struct TimedDualIndex {
   boost::posix_time::ptime updated;
 };
 
+// conversion of update timestamps for lock-free index exchange
+inline int64_t to_shm_time(const boost::posix_time::ptime& time) {
+  static const boost::posix_time::ptime epoch(
+      boost::gregorian::date(1970, 1, 1));
+  return (time - epoch).total_microseconds();
+}
+
+inline boost::posix_time::ptime from_shm_time(int64_t time_us) {
+  static const boost::posix_time::ptime epoch(
+      boost::gregorian::date(1970, 1, 1));
+  return epoch + boost::posix_time::microseconds(time_us);
+}
+
+// Kinds of channel readers
+// Primary readers hold back the writer: the buffers are only released up to
+// the minimum of their read indices. Lossy readers (e.g., for monitoring)
+// never hold back the writer, so the entries they have not yet read may be
+// overwritten once all primary readers have released them.
+enum class shm_reader_type : uint8_t { none, primary, lossy };
+
 class shm_channel {
 
 public:
@@ -77,6 +100,20 @@ public:
     m_req_write_index = req;
   }
 
+  // write index the pending request waits for (see reaches_threshold())
+  DualIndex write_index_threshold(
+      [[maybe_unused]] ip::scoped_lock<ip::interprocess_mutex>& lock) {
+    assert(lock);
+    return m_write_index_threshold;
+  }
+
+  void set_write_index_threshold(
+      [[maybe_unused]] ip::scoped_lock<ip::interprocess_mutex>& lock,
+      DualIndex threshold) {
+    assert(lock);
+    m_write_index_threshold = threshold;
+  }
+
   TimedDualIndex
   write_index([[maybe_unused]] ip::scoped_lock<ip::interprocess_mutex>& lock) {
     assert(lock);
@@ -104,6 +141,7 @@ public:
                  const DualIndex read_index) {
     assert(lock);
     m_read_index = read_index;
+    m_cond_read_index.notify_all();
   }
 
   bool eof([[maybe_unused]] ip::scoped_lock<ip::interprocess_mutex>& lock) {
@@ -115,26 +153,172 @@ public:
                bool eof) {
     assert(lock);
     m_eof = eof;
+    // wake clients waiting for data
+    m_cond_write_index.notify_all();
   }
 
-  bool connect([[maybe_unused]] ip::scoped_lock<ip::interprocess_mutex>& lock) {
+  // maximum number of readers connected at a time
+  static constexpr size_t max_readers = 8;
+
+  // Connect a reader and return its slot, or -1 if all slots are in use.
+  // A primary reader starts at the channel read index, unless it joins
+  // other primary readers in lock-free mode, where the server may release
+  // entries without seeing the new reader yet; it then starts at the write
+  // index, as does a lossy reader.
+  int connect(ip::scoped_lock<ip::interprocess_mutex>& lock,
+              shm_reader_type type) {
     assert(lock);
-    if (m_clients != 0) {
-      return false;
+    assert(type != shm_reader_type::none);
+    auto slot_it = std::find(std::begin(m_reader_type),
+                             std::end(m_reader_type), shm_reader_type::none);
+    if (slot_it == std::end(m_reader_type)) {
+      return -1;
     }
-    m_clients = 1;
-    return true;
+    auto slot = static_cast<size_t>(slot_it - std::begin(m_reader_type));
+
+    bool joining = std::any_of(
+        std::begin(m_reader_type), std::end(m_reader_type),
+        [](const auto& t) { return t == shm_reader_type::primary; });
+    DualIndex start = m_read_index;
+    if (type == shm_reader_type::lossy) {
+      start = m_lockfree ? m_lf_write_index.load() : m_write_index.index;
+    } else if (m_lockfree) {
+      start = joining ? m_lf_write_index.load() : m_lf_retained_index.load();
+    }
+    m_reader_index[slot] = start;
+    m_lf_reader_index[slot].publish(start);
+    m_reader_type[slot].store(type, std::memory_order_release);
+    return static_cast<int>(slot);
   }
 
-  void
-  disconnect([[maybe_unused]] ip::scoped_lock<ip::interprocess_mutex>& lock) {
+  // Disconnect a reader. Returns true if the channel read index has changed
+  // (locked mode only).
+  bool disconnect(ip::scoped_lock<ip::interprocess_mutex>& lock, size_t slot) {
+    assert(lock);
+    assert(slot < max_readers);
+    bool primary = m_reader_type[slot] == shm_reader_type::primary;
+    m_reader_type[slot].store(shm_reader_type::none,
+                              std::memory_order_release);
+    return primary && !m_lockfree && update_read_index(lock);
+  }
+
+  shm_reader_type reader_type(size_t slot) const {
+    return m_reader_type[slot].load(std::memory_order_acquire);
+  }
+
+  // Read index of a reader (locked mode)
+  DualIndex reader_index(
+      [[maybe_unused]] ip::scoped_lock<ip::interprocess_mutex>& lock,
+      size_t slot) {
     assert(lock);
-    m_clients = 0;
+    return m_reader_index[slot];
+  }
+
+  // Set the read index of a reader (locked mode). Returns true if the
+  // channel read index, the minimum of the primary readers, has changed.
+  bool set_reader_index(ip::scoped_lock<ip::interprocess_mutex>& lock,
+                        size_t slot,
+                        DualIndex read_index) {
+    assert(lock);
+    m_reader_index[slot] = read_index;
+    if (m_reader_type[slot] != shm_reader_type::primary) {
+      return false;
+    }
+    return update_read_index(lock);
   }
 
   ip::interprocess_condition m_cond_write_index;
+  // notified on every read index update by the client
+  ip::interprocess_condition m_cond_read_index;
+
+  // lock-free index exchange
+  // The server decides on the exchange mode before any client connects. In
+  // lock-free mode, the server publishes the DMA write index continuously
+  // and picks up the client read index without requests, and none of the
+  // index getters and setters above are used.
+  bool lockfree() const { return m_lockfree; }
+  void set_lockfree(bool lockfree) { m_lockfree = lockfree; }
+
+  // maximum time the server holds back write index updates to batch them
+  // (set by the server before any client connects, 0: no batching)
+  uint64_t index_batch_us() const { return m_index_batch_us; }
+  void set_index_batch_us(uint64_t batch_us) { m_index_batch_us = batch_us; }
+
+  shm_index& lockfree_write_index() { return m_lf_write_index; }
+
+  // read index of a reader (written by that reader only)
+  shm_index& lockfree_reader_index(size_t slot) {
+    return m_lf_reader_index[slot];
+  }
+
+  // read index as last applied to the hardware (written by the server only)
+  shm_index& lockfree_retained_index() { return m_lf_retained_index; }
+
+  // minimum of the read indices of the primary readers, fallback if there
+  // are none
+  DualIndex lockfree_read_index(DualIndex fallback) const {
+    return min_reader_index(
+        [this](size_t slot) { return m_lf_reader_index[slot].load(); },
+        fallback);
+  }
+
+  // time of the latest hardware poll (written by the server only)
+  int64_t lockfree_polled() const {
+    return m_lf_polled.load(std::memory_order_acquire);
+  }
+  void set_lockfree_polled(int64_t time_us) {
+    m_lf_polled.store(time_us, std::memory_order_release);
+  }
+
+  bool lockfree_eof() const { return m_lf_eof.load(std::memory_order_acquire); }
+  void set_lockfree_eof(bool eof) {
+    m_lf_eof.store(eof, std::memory_order_release);
+  }
+
+  // hardware index access statistics (written by the server only)
+  // polls: write index requests, reads: actual device register reads
+  void set_index_stats(uint64_t polls, uint64_t reads) {
+    m_index_polls.store(polls, std::memory_order_relaxed);
+    m_index_reads.store(reads, std::memory_order_relaxed);
+  }
+  uint64_t index_polls() const {
+    return m_index_polls.load(std::memory_order_relaxed);
+  }
+  uint64_t index_reads() const {
+    return m_index_reads.load(std::memory_order_relaxed);
+  }
 
 private:
+  template <typename F>
+  DualIndex min_reader_index(F index_of, DualIndex fallback) const {
+    bool any = false;
+    DualIndex min = fallback;
+    for (size_t slot = 0; slot < max_readers; ++slot) {
+      if (reader_type(slot) != shm_reader_type::primary) {
+        continue;
+      }
+      DualIndex index = index_of(slot);
+      min = any ? DualIndex{std::min(min.desc, index.desc),
+                            std::min(min.data, index.data)}
+                : index;
+      any = true;
+    }
+    return min;
+  }
+
+  // Recompute the channel read index from the primary readers (locked
+  // mode). Returns true if it has changed. Without primary readers, it
+  // stays unchanged.
+  bool update_read_index(ip::scoped_lock<ip::interprocess_mutex>& lock) {
+    DualIndex read_index = min_reader_index(
+        [this](size_t slot) { return m_reader_index[slot]; }, m_read_index);
+    if (read_index == m_read_index) {
+      return false;
+    }
+    set_read_index(lock, read_index);
+    return true;
+  }
+
   void set_buffer_handles(ip::managed_shared_memory* shm,
                           void* data_buffer,
                           void* desc_buffer) {
@@ -151,11 +335,27 @@ private:
 
   bool m_req_read_index = false;
   bool m_req_write_index = false;
+  DualIndex m_write_index_threshold{0, 0};
 
   DualIndex m_read_index{0, 0}; // INFO not actual hw value
   TimedDualIndex m_write_index{{0, 0}, boost::posix_time::neg_infin};
 
   bool m_eof = false;
 
-  size_t m_clients = 0;
+  std::atomic<shm_reader_type> m_reader_type[max_readers]{};
+  DualIndex m_reader_index[max_readers]{};
+
+  bool m_lockfree = false;
+  uint64_t m_index_batch_us = 0;
+  // written by the server, read by the client
+  shm_index m_lf_write_index;
+  // written by the clients, read by the server
+  shm_index m_lf_reader_index[max_readers];
+  // written by the server, read by the clients
+  shm_index m_lf_retained_index;
+  alignas(shm_cache_line_size) std::atomic<int64_t> m_lf_polled{0};
+  std::atomic<bool> m_lf_eof{false};
+
+  std::atomic<uint64_t> m_index_polls{0};
+  std::atomic<uint64_t> m_index_reads{0};
 };
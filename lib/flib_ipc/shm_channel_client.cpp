@@ -5,11 +5,15 @@
 #include "log.hpp"
 #include <boost/interprocess/sync/interprocess_mutex.hpp>
 #include <cassert>
+#include <chrono>
+#include <thread>
 
 template <typename T_DESC, typename T_DATA>
 shm_channel_client<T_DESC, T_DATA>::shm_channel_client(
-    const std::shared_ptr<flib_shm_device_client>& dev, size_t index)
-    : m_dev(dev), m_shm(dev->shm()) {
+    const std::shared_ptr<flib_shm_device_client>& dev,
+    size_t index,
+    shm_reader_type type)
+    : m_dev(dev), m_shm(dev->shm()), m_type(type) {
 
   // connect to global exchange object
   std::string device_name = "shm_device";
@@ -25,23 +29,27 @@ shm_channel_client<T_DESC, T_DATA>::shm_channel_client(
     throw std::runtime_error("Unable to find object" + channel_name);
   }
 
-  {
-    ip::scoped_lock<ip::interprocess_mutex> lock(m_shm_dev->m_mutex);
-    if (!m_shm_ch->connect(lock)) {
-      throw std::runtime_error("Channel " + channel_name + " already in use");
-    }
-  }
-
   if (m_shm_ch->desc_item_size() != sizeof(T_DESC) ||
       m_shm_ch->data_item_size() != sizeof(T_DATA)) {
     throw std::runtime_error("Channel " + channel_name + " is of wrong type");
   }
 
+  {
+    ip::scoped_lock<ip::interprocess_mutex> lock(m_shm_dev->m_mutex);
+    int slot = m_shm_ch->connect(lock, m_type);
+    if (slot < 0) {
+      throw std::runtime_error("Channel " + channel_name +
+                               " has no free reader slot");
+    }
+    m_slot = static_cast<size_t>(slot);
+  }
+
   // initialize buffer info
   m_data_buffer = m_shm_ch->data_buffer_ptr(m_shm);
   m_desc_buffer = m_shm_ch->desc_buffer_ptr(m_shm);
   m_data_buffer_size_exp = m_shm_ch->data_buffer_size_exp();
   m_desc_buffer_size_exp = m_shm_ch->desc_buffer_size_exp();
+  m_lockfree = m_shm_ch->lockfree();
 
   T_DATA* data_buffer = reinterpret_cast<T_DATA*>(m_data_buffer);
   T_DESC* desc_buffer = reinterpret_cast<T_DESC*>(m_desc_buffer);
@@ -56,7 +64,11 @@ template <typename T_DESC, typename T_DATA>
 shm_channel_client<T_DESC, T_DATA>::~shm_channel_client() {
   try {
     ip::scoped_lock<ip::interprocess_mutex> lock(m_shm_dev->m_mutex);
-    m_shm_ch->disconnect(lock);
+    if (m_shm_ch->disconnect(lock, m_slot)) {
+      // the remaining primary readers may release more
+      m_shm_ch->set_req_read_index(lock, true);
+      m_shm_dev->m_cond_req.notify_one();
+    }
   } catch (ip::interprocess_exception const& e) {
     L_(error) << "Failed to disconnect client: " << e.what();
   }
@@ -64,21 +76,45 @@ shm_channel_client<T_DESC, T_DATA>::~shm_channel_client() {
 
 template <typename T_DESC, typename T_DATA>
 void shm_channel_client<T_DESC, T_DATA>::set_read_index(DualIndex read_index) {
+  if (m_lockfree) {
+    m_shm_ch->lockfree_reader_index(m_slot).publish(read_index);
+    return;
+  }
   ip::scoped_lock<ip::interprocess_mutex> lock(m_shm_dev->m_mutex);
-  m_shm_ch->set_read_index(lock, read_index);
-  m_shm_ch->set_req_read_index(lock, true);
-  m_shm_dev->m_cond_req.notify_one();
+  if (m_shm_ch->set_reader_index(lock, m_slot, read_index)) {
+    m_shm_ch->set_req_read_index(lock, true);
+    m_shm_dev->m_cond_req.notify_one();
+  }
 }
 
 template <typename T_DESC, typename T_DATA>
 DualIndex shm_channel_client<T_DESC, T_DATA>::get_read_index() {
+  if (m_lockfree) {
+    return m_shm_ch->lockfree_reader_index(m_slot).load();
+  }
+  ip::scoped_lock<ip::interprocess_mutex> lock(m_shm_dev->m_mutex);
+  return m_shm_ch->reader_index(lock, m_slot);
+}
+
+template <typename T_DESC, typename T_DATA>
+DualIndex shm_channel_client<T_DESC, T_DATA>::get_retained_index() {
+  if (m_lockfree) {
+    // the current minimum of the primary readers is at least the index
+    // applied to the hardware
+    return m_shm_ch->lockfree_read_index(
+        m_shm_ch->lockfree_retained_index().load());
+  }
   ip::scoped_lock<ip::interprocess_mutex> lock(m_shm_dev->m_mutex);
   return m_shm_ch->read_index(lock);
 }
 
 template <typename T_DESC, typename T_DATA>
 void shm_channel_client<T_DESC, T_DATA>::update_write_index() {
+  if (m_lockfree) {
+    return; // the server publishes continuously
+  }
   ip::scoped_lock<ip::interprocess_mutex> lock(m_shm_dev->m_mutex);
+  m_shm_ch->set_write_index_threshold(lock, {0, 0});
   m_shm_ch->set_req_write_index(lock, true);
   m_shm_dev->m_cond_req.notify_one();
 }
@@ -86,6 +122,12 @@ void shm_channel_client<T_DESC, T_DATA>::update_write_index() {
 // get cached write_index
 template <typename T_DESC, typename T_DATA>
 TimedDualIndex shm_channel_client<T_DESC, T_DATA>::get_write_index_cached() {
+  if (m_lockfree) {
+    // the published index is current as of the latest hardware poll
+    int64_t polled = m_shm_ch->lockfree_polled();
+    DualIndex index = m_shm_ch->lockfree_write_index().load();
+    return {index, from_shm_time(polled)};
+  }
   // TODO(Dirk): could be a shared lock
   ip::scoped_lock<ip::interprocess_mutex> lock(m_shm_dev->m_mutex);
   return m_shm_ch->write_index(lock);
@@ -96,7 +138,20 @@ template <typename T_DESC, typename T_DATA>
 std::pair<TimedDualIndex, bool>
 shm_channel_client<T_DESC, T_DATA>::get_write_index_latest(
     const boost::posix_time::ptime& abs_timeout) {
+  if (m_lockfree) {
+    // wait for the next hardware poll
+    auto const start =
+        to_shm_time(boost::posix_time::microsec_clock::universal_time());
+    while (m_shm_ch->lockfree_polled() < start) {
+      if (boost::posix_time::microsec_clock::universal_time() >= abs_timeout) {
+        return std::make_pair(get_write_index_cached(), false);
+      }
+      std::this_thread::yield();
+    }
+    return std::make_pair(get_write_index_cached(), true);
+  }
   ip::scoped_lock<ip::interprocess_mutex> lock(m_shm_dev->m_mutex);
+  m_shm_ch->set_write_index_threshold(lock, {0, 0});
   m_shm_ch->set_req_write_index(lock, true);
   m_shm_dev->m_cond_req.notify_one();
   bool ret = m_shm_ch->m_cond_write_index.timed_wait(lock, abs_timeout);
@@ -125,14 +180,93 @@ shm_channel_client<T_DESC, T_DATA>::get_write_index_newer_than(
 
 template <typename T_DESC, typename T_DATA>
 DualIndex shm_channel_client<T_DESC, T_DATA>::get_write_index() {
+  if (m_lockfree) {
+    return m_shm_ch->lockfree_write_index().load();
+  }
   return get_write_index_newer_than(boost::posix_time::microseconds(1))
       .first.index;
 }
 
+template <typename T_DESC, typename T_DATA>
+DualIndex
+shm_channel_client<T_DESC, T_DATA>::get_write_index_min(DualIndex threshold) {
+  if (m_lockfree) {
+    // the server publishes continuously, wait at most for its batch window
+    shm_index& write_index = m_shm_ch->lockfree_write_index();
+    auto const deadline =
+        std::chrono::steady_clock::now() +
+        std::chrono::microseconds(m_shm_ch->index_batch_us());
+    while (true) {
+      uint32_t generation = write_index.generation();
+      DualIndex index = write_index.load();
+      if (reaches_threshold(index, threshold) || m_shm_ch->lockfree_eof()) {
+        return index;
+      }
+      auto const now = std::chrono::steady_clock::now();
+      if (now >= deadline ||
+          !write_index.wait(
+              generation, std::chrono::duration_cast<std::chrono::microseconds>(
+                              deadline - now))) {
+        return write_index.load();
+      }
+    }
+  }
+  // the server answers the request once the threshold is reached or its
+  // batch window has expired
+  auto const abs_timeout = boost::posix_time::microsec_clock::universal_time() +
+                           boost::posix_time::milliseconds(100);
+  ip::scoped_lock<ip::interprocess_mutex> lock(m_shm_dev->m_mutex);
+  m_shm_ch->set_write_index_threshold(lock, threshold);
+  m_shm_ch->set_req_write_index(lock, true);
+  m_shm_dev->m_cond_req.notify_one();
+  while (m_shm_ch->req_write_index(lock) && !m_shm_ch->eof(lock)) {
+    if (!m_shm_ch->m_cond_write_index.timed_wait(lock, abs_timeout)) {
+      break;
+    }
+  }
+  return m_shm_ch->write_index(lock).index;
+}
+
 template <typename T_DESC, typename T_DATA>
 bool shm_channel_client<T_DESC, T_DATA>::get_eof() {
+  if (m_lockfree) {
+    return m_shm_ch->lockfree_eof();
+  }
   ip::scoped_lock<ip::interprocess_mutex> lock(m_shm_dev->m_mutex);
   return m_shm_ch->eof(lock);
 }
 
+template <typename T_DESC, typename T_DATA>
+std::pair<DualIndex, bool> shm_channel_client<T_DESC, T_DATA>::wait_write_index(
+    DualIndex known, const boost::posix_time::time_duration& rel_timeout) {
+  if (!m_lockfree) {
+    auto const abs_timeout =
+        boost::posix_time::microsec_clock::universal_time() + rel_timeout;
+    while (true) {
+      auto ret = get_write_index_latest(abs_timeout);
+      if (!(ret.first.index == known) || !ret.second) {
+        return std::make_pair(ret.first.index, ret.second);
+      }
+    }
+  }
+  shm_index& write_index = m_shm_ch->lockfree_write_index();
+  auto const deadline =
+      std::chrono::steady_clock::now() +
+      std::chrono::microseconds(rel_timeout.total_microseconds());
+  while (true) {
+    uint32_t generation = write_index.generation();
+    DualIndex index = write_index.load();
+    if (!(index == known) || m_shm_ch->lockfree_eof()) {
+      return std::make_pair(index, true);
+    }
+    auto const now = std::chrono::steady_clock::now();
+    if (now >= deadline ||
+        !write_index.wait(generation,
+                          std::chrono::duration_cast<std::chrono::microseconds>(
+                              deadline - now))) {
+      return std::make_pair(index, false);
+    }
+  }
+}
+
 template class shm_channel_client<fles::MicrosliceDescriptor, uint8_t>;
@@ -11,6 +11,7 @@
 #include "shm_device_client.hpp"
 #include <boost/date_time/posix_time/posix_time_types.hpp>
 #include <boost/interprocess/managed_shared_memory.hpp>
+#include <chrono>
 #include <cstdint>
 #include <memory>
 
@@ -21,7 +22,8 @@ class shm_channel_client : public DualRingBufferReadInterface<T_DESC, T_DATA> {
 
 public:
   shm_channel_client(const std::shared_ptr<flib_shm_device_client>& dev,
-                     size_t index);
+                     size_t index,
+                     shm_reader_type type = shm_reader_type::primary);
   shm_channel_client(const shm_channel_client&) = delete;
   void operator=(const shm_channel_client&) = delete;
 
@@ -31,6 +33,11 @@ public:
 
   DualIndex get_read_index() override;
 
+  bool lossy() override { return m_type == shm_reader_type::lossy; }
+
+  // get the oldest entry not yet released by the primary readers
+  DualIndex get_retained_index() override;
+
   void update_write_index();
 
   // get cached write_index
@@ -48,8 +55,27 @@ public:
 
   DualIndex get_write_index() override;
 
+  // get write_index once it has reached a threshold or the server's batch
+  // window has expired (blocking)
+  DualIndex get_write_index_min(DualIndex threshold) override;
+
   bool get_eof() override;
 
+  void wait_for_write_index(DualIndex known,
+                            std::chrono::milliseconds timeout) override {
+    wait_write_index(known, boost::posix_time::milliseconds(timeout.count()));
+  }
+
+  // wait until the write index differs from known (blocking, sleeps in
+  // lock-free mode)
+  std::pair<DualIndex, bool>
+  wait_write_index(DualIndex known,
+                   const boost::posix_time::time_duration& rel_timeout =
+                       boost::posix_time::milliseconds(100));
+
+  // whether the indices are exchanged without locking
+  bool lockfree() const { return m_lockfree; }
+
   size_t data_buffer_size_exp() { return m_data_buffer_size_exp; }
   size_t desc_buffer_size_exp() { return m_desc_buffer_size_exp; }
 
@@ -62,10 +88,13 @@ private:
   shm_device* m_shm_dev;
 
   shm_channel* m_shm_ch;
+  shm_reader_type m_type;
+  size_t m_slot = 0;
   void* m_data_buffer;
   void* m_desc_buffer;
   size_t m_data_buffer_size_exp;
   size_t m_desc_buffer_size_exp;
+  bool m_lockfree = false;
 
   std::unique_ptr<RingBufferView<T_DATA>> data_buffer_view_;
   std::unique_ptr<RingBufferView<T_DESC>> desc_buffer_view_;
@@ -2,6 +2,7 @@
 // Copyright 2015 Dirk Hutter
 
 #include "shm_channel_provider.hpp"
+#include "shm_persistent.hpp"
 #include <boost/date_time/posix_time/posix_time_types.hpp>
 #include <boost/interprocess/sync/scoped_lock.hpp>
 #include <string>
@@ -12,17 +13,27 @@ shm_channel_provider<T_DESC, T_DATA>::shm_channel_provider(
     shm_device* shm_dev,
     size_t index,
     size_t data_buffer_size_exp,
-    size_t desc_buffer_size_exp)
+    size_t desc_buffer_size_exp,
+    bool reattach)
     : shm_dev_(shm_dev) {
-  // allocate buffers
-  void* data_buffer_raw = shm_alloc(shm, data_buffer_size_exp, sizeof(T_DATA));
-  void* desc_buffer_raw = shm_alloc(shm, desc_buffer_size_exp, sizeof(T_DESC));
-
-  // constuct channel exchange object in shared memory
   std::string channel_name = "shm_channel_" + std::to_string(index);
-  shm_ch_ = shm->construct<shm_channel>(channel_name.c_str())(
-      shm, data_buffer_raw, data_buffer_size_exp, sizeof(T_DATA),
-      desc_buffer_raw, desc_buffer_size_exp, sizeof(T_DESC));
+  void* data_buffer_raw = nullptr;
+  void* desc_buffer_raw = nullptr;
+  if (reattach) {
+    // reuse the buffers of a persistent segment (see shm_persistent.hpp)
+    shm_ch_ = renew_shm_channel(shm, channel_name);
+    data_buffer_raw = shm_ch_->data_buffer_ptr(shm);
+    desc_buffer_raw = shm_ch_->desc_buffer_ptr(shm);
+  } else {
+    // allocate buffers
+    data_buffer_raw = shm_alloc(shm, data_buffer_size_exp, sizeof(T_DATA));
+    desc_buffer_raw = shm_alloc(shm, desc_buffer_size_exp, sizeof(T_DESC));
+
+    // constuct channel exchange object in shared memory
+    shm_ch_ = shm->construct<shm_channel>(channel_name.c_str())(
+        shm, data_buffer_raw, data_buffer_size_exp, sizeof(T_DATA),
+        desc_buffer_raw, desc_buffer_size_exp, sizeof(T_DESC));
+  }
   set_write_index({0, 0});
 
   // initialize buffer info
@@ -57,6 +68,19 @@ void shm_channel_provider<T_DESC, T_DATA>::set_eof(bool eof) {
   shm_ch_->set_eof(lock, eof);
 }
 
+template <typename T_DESC, typename T_DATA>
+void shm_channel_provider<T_DESC, T_DATA>::wait_for_read_index(
+    DualIndex known, std::chrono::milliseconds timeout) {
+  auto const abs_timeout = boost::posix_time::microsec_clock::universal_time() +
+                           boost::posix_time::milliseconds(timeout.count());
+  ip::scoped_lock<ip::interprocess_mutex> lock(shm_dev_->m_mutex);
+  while (shm_ch_->read_index(lock) == known) {
+    if (!shm_ch_->m_cond_read_index.timed_wait(lock, abs_timeout)) {
+      return;
+    }
+  }
+}
+
 template <typename T_DESC, typename T_DATA>
 DualIndex shm_channel_provider<T_DESC, T_DATA>::get_occupied_size() {
   ip::scoped_lock<ip::interprocess_mutex> lock(shm_dev_->m_mutex);
@@ -8,6 +8,7 @@
 #include "shm_channel.hpp"
 #include "shm_device.hpp"
 #include <boost/interprocess/managed_shared_memory.hpp>
+#include <chrono>
 #include <memory>
 
 namespace ip = boost::interprocess;
@@ -31,7 +32,8 @@ public:
                        shm_device* shm_dev,
                        size_t index,
                        size_t data_buffer_size_exp,
-                       size_t desc_buffer_size_exp);
+                       size_t desc_buffer_size_exp,
+                       bool reattach = false);
 
   DualIndex get_read_index() override;
 
@@ -39,6 +41,9 @@ public:
 
   void set_eof(bool eof) override;
 
+  void wait_for_read_index(DualIndex known,
+                           std::chrono::milliseconds timeout) override;
+
   DualIndex get_occupied_size();
 
   bool empty() { return get_occupied_size() == DualIndex({0, 0}); }
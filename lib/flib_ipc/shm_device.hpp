@@ -22,6 +22,11 @@ public:
 
   size_t num_channels() { return m_num_channels; }
 
+  // NUMA node of the device and its buffers, -1 if unknown
+  void set_numa_node(int node) { m_numa_node = node; }
+
+  int numa_node() const { return m_numa_node; }
+
   bool connect([[maybe_unused]] ip::scoped_lock<ip::interprocess_mutex>& lock) {
     assert(lock);
     ++m_clients;
@@ -44,4 +49,5 @@ public:
 private:
   size_t m_num_channels = 0;
   size_t m_clients = 0;
+  int m_numa_node = -1;
 };
@@ -18,6 +18,7 @@ public:
   ~shm_device_client();
 
   size_t num_channels() { return m_shm_dev->num_channels(); }
+  int numa_node() { return m_shm_dev->numa_node(); }
   ip::managed_shared_memory* shm() { return m_shm.get(); }
 
 private:
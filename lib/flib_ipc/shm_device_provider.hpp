@@ -12,6 +12,9 @@
 
 namespace ip = boost::interprocess;
 
+// If persistent is set, the segment is kept on destruction, and a later
+// provider of the same geometry re-attaches to it (see shm_persistent.hpp).
+// Its pages are populated up front in either case.
 template <typename T_DESC, typename T_DATA> class shm_device_provider {
 
 public:
@@ -20,7 +23,8 @@ public:
   shm_device_provider(const std::string& shm_identifier,
                       size_t num_channels,
                       size_t data_buffer_size_exp,
-                      size_t desc_buffer_size_exp);
+                      size_t desc_buffer_size_exp,
+                      bool persistent = false);
 
   ~shm_device_provider();
 
@@ -30,6 +34,7 @@ public:
 
 private:
   std::string shm_identifier_;
+  bool persistent_;
   std::unique_ptr<ip::managed_shared_memory> shm_;
   shm_device* shm_dev_;
   std::vector<std::unique_ptr<shm_channel_provider_type>> shm_ch_vec_;
@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#pragma once
+
+#include "DualRingBuffer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <thread>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/// Size of a cache line, used to keep independently written data apart.
+constexpr std::size_t shm_cache_line_size = 64;
+
+/**
+ * \brief Dual index exchanged between processes through shared memory
+ * without locking.
+ *
+ * The index has a single writer and any number of readers. Both values and
+ * the update timestamp are guarded by a sequence counter (seqlock), so a
+ * reader never sees a desc index from one update combined with a data index
+ * from another. Readers may sleep until the next update; on Linux, this uses
+ * a futex on the shared generation counter, which the writer only wakes if
+ * there are sleeping readers.
+ */
+class alignas(shm_cache_line_size) shm_index {
+public:
+  /// Publish a new index value (single writer only).
+  void publish(DualIndex index, int64_t updated_us = 0) {
+    uint64_t sequence = m_sequence.load(std::memory_order_relaxed);
+    m_sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_desc.store(index.desc, std::memory_order_relaxed);
+    m_data.store(index.data, std::memory_order_relaxed);
+    m_updated_us.store(updated_us, std::memory_order_relaxed);
+    m_sequence.store(sequence + 2, std::memory_order_release);
+
+    m_generation.fetch_add(1, std::memory_order_seq_cst);
+    if (m_waiters.load(std::memory_order_seq_cst) != 0) {
+      wake();
+    }
+  }
+
+  /// Retrieve the most recently published index value.
+  DualIndex load(int64_t* updated_us = nullptr) const {
+    while (true) {
+      uint64_t before = m_sequence.load(std::memory_order_acquire);
+      if ((before & 1) == 0) {
+        DualIndex index{m_desc.load(std::memory_order_relaxed),
+                        m_data.load(std::memory_order_relaxed)};
+        int64_t updated = m_updated_us.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_sequence.load(std::memory_order_relaxed) == before) {
+          if (updated_us != nullptr) {
+            *updated_us = updated;
+          }
+          return index;
+        }
+      }
+      std::this_thread::yield();
+    }
+  }
+
+  /// Retrieve the update counter, to be passed to wait().
+  [[nodiscard]] uint32_t generation() const {
+    return m_generation.load(std::memory_order_acquire);
+  }
+
+  /**
+   * \brief Sleep until the index is published again.
+   *
+   * \param generation The update counter as seen before checking the index
+   * \param timeout    Maximum time to wait
+   * \return false if the timeout expired
+   */
+  bool wait(uint32_t generation, std::chrono::microseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    m_waiters.fetch_add(1, std::memory_order_seq_cst);
+    bool updated = false;
+    while (true) {
+      if (m_generation.load(std::memory_order_seq_cst) != generation) {
+        updated = true;
+        break;
+      }
+      auto now = std::chrono::steady_clock::now();
+      if (now >= deadline) {
+        break;
+      }
+      sleep(generation, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            deadline - now));
+    }
+    m_waiters.fetch_sub(1, std::memory_order_seq_cst);
+    return updated;
+  }
+
+private:
+  static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+                    std::atomic<uint32_t>::is_always_lock_free,
+                "shared memory index requires lock-free atomics");
+  static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+                "futex requires a plain 32-bit word");
+
+  void wake() {
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_generation), FUTEX_WAKE,
+            INT32_MAX, nullptr, nullptr, 0);
+#endif
+  }
+
+  void sleep(uint32_t generation, std::chrono::nanoseconds timeout) {
+#ifdef __linux__
+    struct timespec ts {};
+    ts.tv_sec = static_cast<time_t>(timeout.count() / 1000000000);
+    ts.tv_nsec = static_cast<long>(timeout.count() % 1000000000);
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_generation), FUTEX_WAIT,
+            generation, &ts, nullptr, 0);
+#else
+    // no futex available, poll at a moderate rate instead
+    std::this_thread::sleep_for(
+        std::min<std::chrono::nanoseconds>(timeout,
+                                           std::chrono::microseconds(100)));
+#endif
+  }
+
+  std::atomic<uint64_t> m_sequence{0};
+  std::atomic<uint64_t> m_desc{0};
+  std::atomic<uint64_t> m_data{0};
+  std::atomic<int64_t> m_updated_us{0};
+  std::atomic<uint32_t> m_generation{0};
+  std::atomic<uint32_t> m_waiters{0};
+};
+
+static_assert(sizeof(shm_index) == shm_cache_line_size,
+              "shm_index should occupy a single cache line");
@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#pragma once
+
+#include "shm_channel.hpp"
+#include "shm_device.hpp"
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace ip = boost::interprocess;
+
+// Persistent device segments
+// A provider or server may keep its segment when it exits, so that its
+// successor can re-attach to the existing buffers instead of creating and
+// faulting in a new multi-GB segment. The exchange objects are re-created
+// in place on re-attaching, which resets the indices, requests, client
+// connections and synchronization state of the previous process.
+
+// Open a device segment left by a previous process if it holds num_channels
+// channels of the given geometry. Returns nullptr otherwise.
+inline std::unique_ptr<ip::managed_shared_memory>
+open_persistent_shm(const std::string& shm_identifier,
+                    size_t num_channels,
+                    size_t data_buffer_size_exp,
+                    size_t desc_buffer_size_exp,
+                    size_t data_item_size,
+                    size_t desc_item_size) {
+  std::unique_ptr<ip::managed_shared_memory> shm;
+  try {
+    shm = std::make_unique<ip::managed_shared_memory>(ip::open_only,
+                                                      shm_identifier.c_str());
+  } catch (ip::interprocess_exception const&) {
+    return nullptr; // no segment yet
+  }
+  shm_device* shm_dev = shm->find<shm_device>("shm_device").first;
+  if (shm_dev == nullptr || shm_dev->num_channels() != num_channels) {
+    return nullptr;
+  }
+  for (size_t i = 0; i < num_channels; ++i) {
+    std::string channel_name = "shm_channel_" + std::to_string(i);
+    shm_channel* shm_ch = shm->find<shm_channel>(channel_name.c_str()).first;
+    if (shm_ch == nullptr ||
+        shm_ch->data_buffer_size_exp() != data_buffer_size_exp ||
+        shm_ch->desc_buffer_size_exp() != desc_buffer_size_exp ||
+        shm_ch->data_item_size() != data_item_size ||
+        shm_ch->desc_item_size() != desc_item_size) {
+      return nullptr;
+    }
+  }
+  return shm;
+}
+
+// Re-create the device exchange object of a persistent segment.
+inline shm_device* renew_shm_device(ip::managed_shared_memory* shm) {
+  shm->destroy<shm_device>("shm_device");
+  return shm->construct<shm_device>("shm_device")();
+}
+
+// Re-create a channel exchange object of a persistent segment, keeping its
+// buffers.
+inline shm_channel* renew_shm_channel(ip::managed_shared_memory* shm,
+                                      const std::string& channel_name) {
+  shm_channel* previous = shm->find<shm_channel>(channel_name.c_str()).first;
+  assert(previous != nullptr);
+  void* data_buffer = previous->data_buffer_ptr(shm);
+  void* desc_buffer = previous->desc_buffer_ptr(shm);
+  size_t data_buffer_size_exp = previous->data_buffer_size_exp();
+  size_t desc_buffer_size_exp = previous->desc_buffer_size_exp();
+  size_t data_item_size = previous->data_item_size();
+  size_t desc_item_size = previous->desc_item_size();
+  shm->destroy<shm_channel>(channel_name.c_str());
+  return shm->construct<shm_channel>(channel_name.c_str())(
+      shm, data_buffer, data_buffer_size_exp, data_item_size, desc_buffer,
+      desc_buffer_size_exp, desc_item_size);
+}
@@ -0,0 +1,189 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#pragma once
+
+#include "log.hpp"
+
+#include <boost/log/attributes/value_extraction.hpp>
+#include <boost/log/core/record_view.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace logging {
+
+/// Bounded lock-free log record queue for boost::log asynchronous sinks.
+/** Implements the boost::log queueing strategy interface on a bounded
+    multi-producer ring buffer with per-cell sequence numbers (after D.
+    Vyukov), so that logging threads never take a lock as long as the
+    feeding thread keeps up. If the queue is full, records below warning
+    severity are dropped and counted, more severe records wait for space.
+
+    The feeding thread sleeps on a condition variable only when the queue
+    is empty, producers take the mutex only to wake it. */
+template <std::size_t CapacityV> class LockFreeRecordQueue {
+public:
+  /// Return the number of records dropped because the queue was full.
+  [[nodiscard]] std::uint64_t dropped_records() const {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+protected:
+  using value_type = boost::log::record_view;
+
+  LockFreeRecordQueue() {
+    for (std::size_t i = 0; i < CapacityV; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  template <typename ArgsT>
+  explicit LockFreeRecordQueue(ArgsT const& /*args*/)
+      : LockFreeRecordQueue() {}
+
+  /// Enqueue a record, drop it if the queue is full and it is not severe.
+  void enqueue(boost::log::record_view const& rec) {
+    while (!try_push(rec)) {
+      if (!is_severe(rec)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+      std::this_thread::yield();
+    }
+    wake_consumer();
+  }
+
+  /// Attempt to enqueue a record, fail if the queue is full.
+  bool try_enqueue(boost::log::record_view const& rec) {
+    if (!try_push(rec)) {
+      return false;
+    }
+    wake_consumer();
+    return true;
+  }
+
+  bool try_dequeue_ready(boost::log::record_view& rec) {
+    return try_dequeue(rec);
+  }
+
+  bool try_dequeue(boost::log::record_view& rec) { return try_pop(rec); }
+
+  /// Dequeue a record, block while the queue is empty.
+  /** Returns false if interrupted by interrupt_dequeue(). */
+  bool dequeue_ready(boost::log::record_view& rec) {
+    while (true) {
+      if (try_pop(rec)) {
+        return true;
+      }
+      std::unique_lock<std::mutex> lock(mutex_);
+      sleeping_.store(true, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      bool popped = try_pop(rec);
+      if (!popped && !interrupted_) {
+        // the timeout only guards against a missed wakeup
+        cond_.wait_for(lock, std::chrono::milliseconds(100));
+        popped = try_pop(rec);
+      }
+      sleeping_.store(false, std::memory_order_relaxed);
+      if (popped) {
+        return true;
+      }
+      if (interrupted_) {
+        interrupted_ = false;
+        return false;
+      }
+    }
+  }
+
+  /// Wake the feeding thread blocked in dequeue_ready().
+  void interrupt_dequeue() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    interrupted_ = true;
+    cond_.notify_one();
+  }
+
+private:
+  struct Cell {
+    std::atomic<std::size_t> sequence{0};
+    boost::log::record_view record;
+  };
+
+  static bool is_severe(boost::log::record_view const& rec) {
+    auto level = boost::log::extract<severity_level>("Severity", rec);
+    return level && *level >= warning;
+  }
+
+  bool try_push(boost::log::record_view const& rec) {
+    std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+      cell = &cells_[pos % CapacityV];
+      std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+      auto diff =
+          static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false; // full
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    cell->record = rec;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool try_pop(boost::log::record_view& rec) {
+    std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+      cell = &cells_[pos % CapacityV];
+      std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<std::ptrdiff_t>(seq) -
+                  static_cast<std::ptrdiff_t>(pos + 1);
+      if (diff == 0) {
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false; // empty
+      } else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    rec.swap(cell->record);
+    cell->record.reset();
+    cell->sequence.store(pos + CapacityV, std::memory_order_release);
+    return true;
+  }
+
+  void wake_consumer() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed)) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      cond_.notify_one();
+    }
+  }
+
+  std::array<Cell, CapacityV> cells_;
+  alignas(64) std::atomic<std::size_t> enqueue_pos_{0};
+  alignas(64) std::atomic<std::size_t> dequeue_pos_{0};
+  alignas(64) std::atomic<bool> sleeping_{false};
+  std::atomic<std::uint64_t> dropped_{0};
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  bool interrupted_ = false;
+};
+
+} // namespace logging
@@ -1,18 +1,25 @@
 // Copyright 2014 Jan de Cuveland <cmail@cuveland.de>
 #include "log.hpp"
+#include "LockFreeRecordQueue.hpp"
 
+#include <boost/core/null_deleter.hpp>
 #include <boost/log/attributes.hpp>
 #include <boost/log/expressions.hpp>
-#include <boost/log/sinks/sync_frontend.hpp>
+#include <boost/log/sinks/async_frontend.hpp>
+#include <boost/log/sinks/text_file_backend.hpp>
+#include <boost/log/sinks/text_ostream_backend.hpp>
 #include <boost/log/support/date_time.hpp>
 #include <boost/log/utility/setup.hpp>
 
 #include <array>
 #include <cstdio>
 #include <cstdlib>
+#include <functional>
 #include <iostream>
+#include <mutex>
 #include <string>
 #include <unistd.h>
+#include <vector>
 
 #define __ansi(code_m) "\033[" code_m "m"
 
@@ -122,6 +129,50 @@ namespace {
 bool cout_is_a_tty() {
   return (isatty(fileno(stdout)) != 0) && (getenv("TERM") != nullptr);
 }
+
+// Records formatted by the logging threads are queued to a dedicated feeding
+// thread per sink, which formats the line and performs the actual output.
+constexpr std::size_t queue_capacity = 65536;
+
+template <typename BackendT>
+using async_sink =
+    boost::log::sinks::asynchronous_sink<BackendT,
+                                         logging::LockFreeRecordQueue<
+                                             queue_capacity>>;
+
+struct registered_sink {
+  std::function<void()> flush;
+  std::function<void()> stop;
+  std::function<std::uint64_t()> dropped_records;
+};
+
+std::mutex sinks_mutex;
+std::vector<registered_sink> sinks;
+
+// Stop the feeding threads and write all pending records at program exit
+void shutdown_sinks() {
+  std::uint64_t dropped = logging::dropped_records();
+  std::lock_guard<std::mutex> lock(sinks_mutex);
+  for (auto& sink : sinks) {
+    sink.stop();
+    sink.flush();
+  }
+  // the logger itself is no longer usable at this point
+  if (dropped > 0) {
+    std::cerr << "warning: " << dropped << " log records dropped, queue full"
+              << std::endl;
+  }
+}
+
+template <typename SinkT> void register_sink(boost::shared_ptr<SinkT> sink) {
+  boost::log::core::get()->add_sink(sink);
+  std::lock_guard<std::mutex> lock(sinks_mutex);
+  if (sinks.empty()) {
+    std::atexit(shutdown_sinks);
+  }
+  sinks.push_back({[sink] { sink->flush(); }, [sink] { sink->stop(); },
+                   [sink] { return sink->dropped_records(); }});
+}
 } // namespace
 
 namespace logging {
@@ -148,9 +199,17 @@ void add_console(severity_level minimum_severity) {
         << ": " << boost::log::expressions::message;
   }
 
-  auto console_sink = boost::log::add_console_log();
+  auto backend = boost::make_shared<boost::log::sinks::text_ostream_backend>();
+  backend->add_stream(
+      boost::shared_ptr<std::ostream>(&std::clog, boost::null_deleter()));
+  backend->auto_flush(true);
+
+  auto console_sink =
+      boost::make_shared<async_sink<boost::log::sinks::text_ostream_backend>>(
+          backend);
   console_sink->set_formatter(console_formatter);
   console_sink->set_filter(severity >= minimum_severity);
+  register_sink(console_sink);
 }
 
 void add_file(std::string filename, severity_level minimum_severity) {
@@ -162,12 +221,14 @@ void add_file(std::string filename, severity_level minimum_severity) {
       << "] " << boost::log::expressions::attr<severity_level>("Severity")
       << ": " << boost::log::expressions::message;
 
-  auto file_sink =
-      boost::log::add_file_log(boost::log::keywords::file_name = filename,
-                               boost::log::keywords::auto_flush = true);
   // default open_mode is (std::ios_base::trunc | std::ios_base::out)
+  auto file_sink =
+      boost::make_shared<async_sink<boost::log::sinks::text_file_backend>>(
+          boost::log::keywords::file_name = filename,
+          boost::log::keywords::auto_flush = true);
   file_sink->set_formatter(file_formatter);
   file_sink->set_filter(severity >= minimum_severity);
+  register_sink(file_sink);
 }
 
 void add_syslog(syslog::facility facility, severity_level minimum_severity) {
@@ -176,8 +237,8 @@ void add_syslog(syslog::facility facility, severity_level minimum_severity) {
       << boost::log::expressions::attr<severity_level>("Severity") << ": "
       << boost::log::expressions::message;
 
-  auto syslog_sink = boost::make_shared<
-      boost::log::sinks::synchronous_sink<boost::log::sinks::syslog_backend>>(
+  auto syslog_sink =
+      boost::make_shared<async_sink<boost::log::sinks::syslog_backend>>(
       boost::log::keywords::facility = facility,
       boost::log::keywords::use_impl = syslog::native);
 
@@ -193,8 +254,25 @@ void add_syslog(syslog::facility facility, severity_level minimum_severity) {
 
   syslog_sink->set_formatter(syslog_formatter);
   syslog_sink->set_filter(severity >= minimum_severity);
+  register_sink(syslog_sink);
+}
 
-  boost::log::core::get()->add_sink(syslog_sink);
+// Block until all records queued so far have been written
+void flush() {
+  std::lock_guard<std::mutex> lock(sinks_mutex);
+  for (auto& sink : sinks) {
+    sink.flush();
+  }
+}
+
+// Total number of records dropped by the asynchronous sinks
+std::uint64_t dropped_records() {
+  std::lock_guard<std::mutex> lock(sinks_mutex);
+  std::uint64_t count = 0;
+  for (auto& sink : sinks) {
+    count += sink.dropped_records();
+  }
+  return count;
 }
 
 LogBuffer::LogBuffer(severity_level level) : level_(level) {}
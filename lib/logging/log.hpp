@@ -6,6 +6,10 @@
 #include <boost/log/common.hpp>
 #include <boost/log/sinks/syslog_backend.hpp>
 #include <boost/log/utility/manipulators/to_log.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <iosfwd>
 #include <iostream>
 
@@ -32,6 +36,8 @@ namespace syslog = boost::log::sinks::syslog;
 void add_console(severity_level minimum_severity);
 void add_file(std::string filename, severity_level minimum_severity);
 void add_syslog(syslog::facility /*facility*/, severity_level minimum_severity);
+void flush();
+std::uint64_t dropped_records();
 
 class LogBuffer {
 public:
@@ -53,6 +59,82 @@ private:
 public:
   std::ostream stream;
 };
+
+/// Token bucket of a rate-limited log statement (see L_RATE).
+/** Up to `burst` messages pass at once, then `per_second` on average. A
+    suppressed message costs a clock read and an atomic increment. The
+    number of suppressed messages is reported with the next message that
+    passes. */
+class RateLimit {
+public:
+  RateLimit(uint32_t burst, double per_second)
+      : interval_ns_(static_cast<int64_t>(1e9 / per_second)),
+        window_ns_(interval_ns_ * (burst > 0 ? burst - 1 : 0)) {}
+
+  /// Check whether a message may pass at the given time, return the number
+  /// of messages suppressed before it, or -1 if it is suppressed.
+  int64_t admit(int64_t now_ns) {
+    int64_t due = due_ns_.load(std::memory_order_relaxed);
+    if (due - now_ns > window_ns_ ||
+        !due_ns_.compare_exchange_strong(
+            due, std::max(due, now_ns) + interval_ns_,
+            std::memory_order_relaxed)) {
+      suppressed_.fetch_add(1, std::memory_order_relaxed);
+      return -1;
+    }
+    return static_cast<int64_t>(
+        suppressed_.exchange(0, std::memory_order_relaxed));
+  }
+
+  int64_t admit() {
+    return admit(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now().time_since_epoch())
+                     .count());
+  }
+
+private:
+  const int64_t interval_ns_;
+  const int64_t window_ns_;
+  // Time at which the bucket is full again
+  std::atomic<int64_t> due_ns_{INT64_MIN / 2};
+  std::atomic<uint64_t> suppressed_{0};
+};
+
+/// Prefix of a rate-limited message reporting the suppressed messages.
+struct Suppressed {
+  int64_t count;
+};
+
+inline std::ostream& operator<<(std::ostream& strm, Suppressed s) {
+  if (s.count > 0) {
+    strm << "[" << s.count << " similar messages suppressed] ";
+  }
+  return strm;
+}
 } // namespace logging
 
-#define L_(severity) BOOST_LOG_SEV(g_logger::get(), severity)
+// Log statements below this severity are removed at compile time
+#ifndef LOG_MIN_SEVERITY
+#define LOG_MIN_SEVERITY trace
+#endif
+
+#define L_(severity)                                                           \
+  if ((severity) < LOG_MIN_SEVERITY) {                                         \
+  } else                                                                       \
+    BOOST_LOG_SEV(g_logger::get(), severity)
+
+// Rate-limited log statement for paths that may fail repeatedly, e.g., in
+// transport loops: each statement passes up to `burst` messages at once and
+// then `per_second` on average, and reports the number of suppressed ones
+#define L_RATE(severity, burst, per_second)                                  \
+  if ((severity) < LOG_MIN_SEVERITY) {                                         \
+  } else if (static logging::RateLimit l_rate_limit_((burst), (per_second));   \
+             false) {                                                          \
+  } else if (const int64_t l_suppressed_ = l_rate_limit_.admit();              \
+             l_suppressed_ < 0) {                                              \
+  } else                                                                       \
+    BOOST_LOG_SEV(g_logger::get(), severity)                                   \
+        << logging::Suppressed{l_suppressed_}
+
+// Rate-limited log statement with a default rate (10 at once, 1 per second)
+#define L_LIMITED(severity) L_RATE(severity, 10, 1.0)
@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "AllocationStats.hpp"
+
+#include <algorithm>
+
+namespace cbm {
+
+/*! \class AllocationStats
+  \brief Optional accounting of the allocations of frequently created objects
+
+  The objects of the accounted categories hold an AllocationRecord, which
+  adds their size including the owned data to the live bytes of their
+  category and counts the object as one allocation. Until Enable() is
+  called, the records stay inactive, so the accounting costs a single
+  branch per object.
+
+  When enabled, the Monitor reports the measurement "allocations" with the
+  tag "category" in each cycle (see Monitor::kELoopTimeout), with the fields
+  - `live_bytes`: bytes currently held by the objects
+  - `peak_bytes`: maximum of `live_bytes` since the previous report
+  - `allocations`: objects created since the previous report
+  - `allocation_rate`: objects created per second
+
+  Content shared by several objects (e.g. copies of a
+  fles::StorableMicroslice) is accounted by each of them, content residing
+  in external memory (e.g. a shared memory buffer) is not accounted.
+*/
+
+/*! \class AllocationRecord
+  \brief Accounting of a single object in AllocationStats
+
+  Held as a member by the accounted objects, which call Update() whenever
+  the size of their data changes. A copied record accounts a new object.
+*/
+
+//-----------------------------------------------------------------------------
+//! \brief Enables the accounting for objects created from now on
+
+void AllocationStats::Enable() {
+  std::lock_guard<std::mutex> lock(fSnapshotMutex);
+  if (!fEnabled.load(std::memory_order_relaxed)) {
+    fLastSnapshot = clock::now();
+    fEnabled.store(true, std::memory_order_relaxed);
+  }
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Accounts allocated bytes
+  \param category  accounted category
+  \param bytes     number of bytes
+  \param count     number of allocated objects
+ */
+
+void AllocationStats::Allocate(Category category,
+                               size_t bytes,
+                               uint64_t count) {
+  Counters& counters = fCounters[category];
+  if (count > 0)
+    counters.fAllocations.fetch_add(count, std::memory_order_relaxed);
+  uint64_t live =
+      counters.fLiveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  uint64_t peak = counters.fPeakBytes.load(std::memory_order_relaxed);
+  while (live > peak && !counters.fPeakBytes.compare_exchange_weak(
+                            peak, live, std::memory_order_relaxed)) {
+  }
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Accounts released bytes
+  \param category  accounted category
+  \param bytes     number of bytes
+ */
+
+void AllocationStats::Release(Category category, size_t bytes) {
+  fCounters[category].fLiveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Returns the current values of a category
+
+AllocationStats::Values AllocationStats::Read(Category category) {
+  const Counters& counters = fCounters[category];
+  Values values;
+  values.fLiveBytes = counters.fLiveBytes.load(std::memory_order_relaxed);
+  values.fPeakBytes = counters.fPeakBytes.load(std::memory_order_relaxed);
+  values.fAllocations = counters.fAllocations.load(std::memory_order_relaxed);
+  return values;
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Returns the name of a category, used as tag value
+
+const char* AllocationStats::CategoryName(Category category) {
+  switch (category) {
+  case kTimeslice:
+    return "timeslice";
+  case kMicroslice:
+    return "microslice";
+  case kItem:
+    return "item";
+  case kMetric:
+    return "metric";
+  default:
+    return "unknown";
+  }
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Appends the metrics of all categories and starts a new period
+  \param metvec  metric list to append to
+
+  Called by the Monitor work thread. The peak of each category restarts
+  from its current live bytes.
+ */
+
+void AllocationStats::Snapshot(std::vector<Metric>& metvec) {
+  std::lock_guard<std::mutex> lock(fSnapshotMutex);
+  if (!fEnabled.load(std::memory_order_relaxed))
+    return;
+  auto now = clock::now();
+  double seconds = std::chrono::duration<double>(now - fLastSnapshot).count();
+  fLastSnapshot = now;
+  auto timestamp = std::chrono::system_clock::now();
+
+  for (size_t i = 0; i < kNCategory; ++i) {
+    Counters& counters = fCounters[i];
+    uint64_t live = counters.fLiveBytes.load(std::memory_order_relaxed);
+    uint64_t peak =
+        counters.fPeakBytes.exchange(live, std::memory_order_relaxed);
+    uint64_t allocations =
+        counters.fAllocations.load(std::memory_order_relaxed);
+    uint64_t nalloc = allocations - counters.fLastAllocations;
+    counters.fLastAllocations = allocations;
+    double rate = seconds > 0. ? static_cast<double>(nalloc) / seconds : 0.;
+    metvec.emplace_back(
+        "allocations",
+        MetricTagSet{{"category", CategoryName(static_cast<Category>(i))}},
+        MetricFieldSet{{"live_bytes", live},
+                       {"peak_bytes", std::max(peak, live)},
+                       {"allocations", nalloc},
+                       {"allocation_rate", rate}},
+        timestamp);
+  }
+}
+
+std::atomic<bool> AllocationStats::fEnabled{false};
+std::array<AllocationStats::Counters, AllocationStats::kNCategory>
+    AllocationStats::fCounters{};
+AllocationStats::clock::time_point AllocationStats::fLastSnapshot{};
+std::mutex AllocationStats::fSnapshotMutex{};
+
+} // end namespace cbm
@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#ifndef included_Cbm_AllocationStats
+#define included_Cbm_AllocationStats 1
+
+#include "Metric.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace cbm {
+
+class AllocationStats {
+public:
+  enum Category : size_t {
+    kTimeslice,  //!< fles::StorableTimeslice objects
+    kMicroslice, //!< fles::StorableMicroslice objects
+    kItem,       //!< work items of the item distribution
+    kMetric,     //!< Metric points queued in the Monitor
+    kNCategory   //!< number of categories
+  };
+
+  struct Values {
+    uint64_t fLiveBytes{0};   //!< bytes currently allocated
+    uint64_t fPeakBytes{0};   //!< maximum of fLiveBytes since last snapshot
+    uint64_t fAllocations{0}; //!< allocations since start
+  };
+
+  static void Enable();
+  static bool Enabled();
+
+  static void Allocate(Category category, size_t bytes, uint64_t count = 1);
+  static void Release(Category category, size_t bytes);
+
+  static Values Read(Category category);
+  static const char* CategoryName(Category category);
+  static void Snapshot(std::vector<Metric>& metvec);
+
+private:
+  using clock = std::chrono::steady_clock;
+
+  struct Counters {
+    std::atomic<uint64_t> fLiveBytes{0};   //!< bytes currently allocated
+    std::atomic<uint64_t> fPeakBytes{0};   //!< peak since last snapshot
+    std::atomic<uint64_t> fAllocations{0}; //!< allocations since start
+    uint64_t fLastAllocations{0};          //!< fAllocations at last snapshot
+  };
+
+  static std::atomic<bool> fEnabled;                 //!< accounting on
+  static std::array<Counters, kNCategory> fCounters; //!< per category
+  static clock::time_point fLastSnapshot;            //!< last Snapshot()
+  static std::mutex fSnapshotMutex;                  //!< for Snapshot()
+};
+
+class AllocationRecord {
+public:
+  explicit AllocationRecord(AllocationStats::Category category);
+  AllocationRecord(const AllocationRecord& other);
+  AllocationRecord& operator=(const AllocationRecord& other);
+  ~AllocationRecord();
+
+  bool Active() const;
+  void Update(size_t bytes);
+
+private:
+  AllocationStats::Category fCategory; //!< accounted category
+  bool fActive;                        //!< accounted at construction
+  size_t fBytes{0};                    //!< currently accounted bytes
+};
+
+} // end namespace cbm
+
+#include "AllocationStats.ipp"
+
+#endif
@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+namespace cbm {
+
+//-----------------------------------------------------------------------------
+//! \brief Returns true if the allocation accounting is enabled
+
+inline bool AllocationStats::Enabled() {
+  return fEnabled.load(std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Constructor
+  \param category  accounted category
+
+  The record is active if the accounting is enabled at construction. An
+  inactive record ignores all updates, so the instrumentation can stay in
+  the constructors of frequently allocated objects.
+ */
+
+inline AllocationRecord::AllocationRecord(AllocationStats::Category category)
+    : fCategory(category), fActive(AllocationStats::Enabled()) {
+  if (fActive)
+    AllocationStats::Allocate(fCategory, 0);
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Copy constructor, accounts a new object of the same category
+
+inline AllocationRecord::AllocationRecord(const AllocationRecord& other)
+    : AllocationRecord(other.fCategory) {}
+
+//-----------------------------------------------------------------------------
+//! \brief Assignment, keeps the accounting of this object
+
+inline AllocationRecord&
+AllocationRecord::operator=(const AllocationRecord& /*other*/) {
+  return *this;
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Destructor, releases the accounted bytes
+
+inline AllocationRecord::~AllocationRecord() {
+  if (fBytes > 0)
+    AllocationStats::Release(fCategory, fBytes);
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Returns true if the record accounts its object
+
+inline bool AllocationRecord::Active() const { return fActive; }
+
+//-----------------------------------------------------------------------------
+/*! \brief Sets the number of bytes currently held by the object
+  \param bytes  bytes held by the object, including its own size
+ */
+
+inline void AllocationRecord::Update(size_t bytes) {
+  if (!fActive || bytes == fBytes)
+    return;
+  if (bytes > fBytes)
+    AllocationStats::Allocate(fCategory, bytes - fBytes, 0);
+  else
+    AllocationStats::Release(fCategory, fBytes - bytes);
+  fBytes = bytes;
+}
+
+} // end namespace cbm
@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "Histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cbm {
+
+/*! \class Histogram
+  \brief Log-linear histogram of unsigned integer values, e.g. latencies
+
+  The buckets cover the full 64-bit range with a bounded relative error, in
+  the manner of an HDR histogram: each power of two is divided into `kNSub`
+  linear sub-buckets, so a bucket spans at most 1/`kNSub` (12.5%) of its
+  lower bound. Values below `2*kNSub` are counted exactly.
+
+  Histograms are mergeable, so each thread can record into an instance of
+  its own without synchronization, and the instances are combined for a
+  report. A Histogram can be used as a MetricField, the sinks derive count,
+  sum, maximum, mean, and percentile fields from it (and MonitorSinkFile
+  the full bucket list).
+*/
+
+//-----------------------------------------------------------------------------
+//! \brief Add the values recorded in another histogram
+
+void Histogram::Merge(const Histogram& other) {
+  const auto& buckets = other.Buckets();
+  for (size_t i = 0; i < buckets.size(); i++)
+    if (buckets[i] != 0)
+      MergeBucket(i, buckets[i]);
+  MergeSummary(other.fSum, other.fMax);
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Add to the count of a bucket
+  \param index  bucket index
+  \param count  number of values to add
+
+  Also call MergeSummary() to keep sum and maximum consistent.
+ */
+
+void Histogram::MergeBucket(size_t index, uint64_t count) {
+  if (count == 0)
+    return;
+  if (fBucket.empty())
+    fBucket.resize(kNBucket);
+  fBucket[index] += count;
+  fCount += count;
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Add to the sum and update the maximum of the values
+  \param sum  sum of the added values
+  \param max  largest added value
+ */
+
+void Histogram::MergeSummary(uint64_t sum, uint64_t max) {
+  fSum += sum;
+  fMax = std::max(fMax, max);
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Remove all recorded values
+
+void Histogram::Reset() { *this = Histogram(); }
+
+//-----------------------------------------------------------------------------
+/*! \brief Returns the value at a given quantile
+  \param quantile  quantile in the range [0,1], e.g. 0.99
+  \returns upper bound of the bucket holding the value of the given rank,
+    but at most the largest recorded value; 0 if empty
+ */
+
+uint64_t Histogram::Percentile(double quantile) const {
+  if (fCount == 0)
+    return 0;
+  auto rank = static_cast<uint64_t>(
+      std::ceil(quantile * static_cast<double>(fCount)));
+  rank = std::clamp<uint64_t>(rank, 1, fCount);
+  uint64_t cumulative = 0;
+  for (size_t i = 0; i < fBucket.size(); i++) {
+    cumulative += fBucket[i];
+    if (cumulative >= rank)
+      return std::min(BucketUpper(i), fMax);
+  }
+  return fMax;
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Compare two histograms
+
+bool Histogram::operator==(const Histogram& other) const {
+  return fCount == other.fCount && fSum == other.fSum && fMax == other.fMax &&
+         fBucket == other.fBucket;
+}
+
+} // end namespace cbm
@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#ifndef included_Cbm_Histogram
+#define included_Cbm_Histogram 1
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cbm {
+
+class Histogram {
+public:
+  static constexpr unsigned kSubBits = 3; //!< sub-bucket bits
+  static constexpr size_t kNSub = size_t(1) << kSubBits; //!< # sub-buckets
+  static constexpr size_t kNBucket = (65 - kSubBits) * kNSub; //!< # buckets
+
+  Histogram() = default;
+
+  void Record(uint64_t value, uint64_t count = 1);
+  void Merge(const Histogram& other);
+  void MergeBucket(size_t index, uint64_t count);
+  void MergeSummary(uint64_t sum, uint64_t max);
+  void Reset();
+
+  uint64_t Count() const;
+  uint64_t Sum() const;
+  uint64_t Max() const;
+  double Mean() const;
+  uint64_t Percentile(double quantile) const;
+  const std::vector<uint64_t>& Buckets() const;
+
+  bool operator==(const Histogram& other) const;
+
+  static size_t BucketIndex(uint64_t value);
+  static uint64_t BucketLower(size_t index);
+  static uint64_t BucketUpper(size_t index);
+
+private:
+  std::vector<uint64_t> fBucket{}; //!< counts per bucket (empty: all zero)
+  uint64_t fCount{0};              //!< # of recorded values
+  uint64_t fSum{0};                //!< sum of recorded values
+  uint64_t fMax{0};                //!< largest recorded value
+};
+
+} // end namespace cbm
+
+#include "Histogram.ipp"
+
+#endif
@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include <algorithm>
+
+namespace cbm {
+
+//-----------------------------------------------------------------------------
+/*! \brief Record a value
+  \param value  value to be counted
+  \param count  number of times to count the value
+ */
+
+inline void Histogram::Record(uint64_t value, uint64_t count) {
+  MergeBucket(BucketIndex(value), count);
+  MergeSummary(value * count, value);
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Returns the number of recorded values
+
+inline uint64_t Histogram::Count() const { return fCount; }
+
+//-----------------------------------------------------------------------------
+//! \brief Returns the sum of the recorded values
+
+inline uint64_t Histogram::Sum() const { return fSum; }
+
+//-----------------------------------------------------------------------------
+//! \brief Returns the largest recorded value
+
+inline uint64_t Histogram::Max() const { return fMax; }
+
+//-----------------------------------------------------------------------------
+//! \brief Returns the mean of the recorded values (0 if empty)
+
+inline double Histogram::Mean() const {
+  return fCount == 0 ? 0.
+                     : static_cast<double>(fSum) / static_cast<double>(fCount);
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Returns the bucket counts, an empty vector if nothing was recorded
+
+inline const std::vector<uint64_t>& Histogram::Buckets() const {
+  return fBucket;
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Returns the bucket index of a value
+
+  Values below `2*kNSub` have a bucket of their own, larger values share a
+  bucket with values of the same upper `kSubBits + 1` bits.
+ */
+
+inline size_t Histogram::BucketIndex(uint64_t value) {
+  if (value < 2 * kNSub)
+    return static_cast<size_t>(value);
+  unsigned exp = 63 - static_cast<unsigned>(__builtin_clzll(value));
+  return (exp - kSubBits + 1) * kNSub +
+         static_cast<size_t>((value >> (exp - kSubBits)) & (kNSub - 1));
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Returns the smallest value counted in a bucket
+
+inline uint64_t Histogram::BucketLower(size_t index) {
+  if (index < 2 * kNSub)
+    return index;
+  size_t exp = index / kNSub + kSubBits - 1;
+  return (kNSub + index % kNSub) << (exp - kSubBits);
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Returns the largest value counted in a bucket
+
+inline uint64_t Histogram::BucketUpper(size_t index) {
+  return index + 1 < kNBucket ? BucketLower(index + 1) - 1 : UINT64_MAX;
+}
+
+} // end namespace cbm
@@ -0,0 +1,370 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "InfluxWriter.hpp"
+
+#include "System.hpp"
+
+#include "fmt/format.h"
+
+// define needed for Boost 1.67 in Debian Buster to avoid a missing
+// boost::system::system_category() symbol. That's apparently default since
+// Boost 1.69, so Boost 1.71 (Ub focal) and 1.74 (Debian Bullseye work fine
+// without. See https://stackoverflow.com/questions/9723793/
+#define BOOST_ERROR_CODE_HEADER_ONLY
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+
+#include <algorithm>
+#include <iostream>
+
+namespace cbm {
+using tcp = boost::asio::ip::tcp;     // from <boost/asio/ip/tcp.hpp>
+namespace http = boost::beast::http;  // from <boost/beast/http.hpp>
+using namespace std::string_literals; // for ""s
+using namespace std::chrono_literals; // for ms, s
+
+// some constants
+static const size_t kMaxBuffered = 64'000'000ull; // buffer limit in bytes
+static const size_t kPipelineDepth = 4;           // max. requests in flight
+static const auto kIoTimeout = 10s;               // connect/write/read timeout
+static const auto kBackoffMin = 100ms;            // first retry delay
+static const auto kBackoffMax = 30s;              // max. retry delay
+
+/*! \class InfluxWriter
+  \brief Asynchronous HTTP writer for the InfluxDB sinks
+
+  Sends chunks of points in line format to an InfluxDB write endpoint from a
+  thread of its own, so that a slow or unreachable database never blocks the
+  Monitor event loop and thus never lets the metric queue of the producers
+  grow.
+
+  - the chunks are gzip compressed when queued
+  - one HTTP/1.1 connection is kept open and reused for all requests
+  - up to `kPipelineDepth` requests are written before the responses are read
+  - the buffer holds at most `kMaxBuffered` bytes, when full the oldest
+    chunks are dropped
+  - failed requests are repeated with an exponential backoff from
+    `kBackoffMin` to `kBackoffMax`. Requests rejected by the server with a
+    client error (except 429) are dropped, repeating them can't help.
+
+  At destruction, the pending chunks are sent with one final attempt.
+*/
+
+//-----------------------------------------------------------------------------
+// Connection: a persistent HTTP connection with timeouts
+
+class InfluxWriter::Connection {
+public:
+  bool IsOpen() const { return fStream.socket().is_open(); }
+
+  void Open(const std::string& host, const std::string& port) {
+    auto const results = fResolver.resolve(host, port);
+    fStream.expires_after(kIoTimeout);
+    fStream.async_connect(
+        results, [this](boost::system::error_code ec,
+                        const tcp::endpoint&) { fEc = ec; });
+    Run();
+    fReadBuffer.clear();
+  }
+
+  void Write(http::request<http::string_body>& req) {
+    fStream.expires_after(kIoTimeout);
+    http::async_write(fStream, req,
+                      [this](boost::system::error_code ec, size_t) {
+                        fEc = ec;
+                      });
+    Run();
+  }
+
+  void Read(http::response<http::string_body>& res) {
+    fStream.expires_after(kIoTimeout);
+    http::async_read(fStream, fReadBuffer, res,
+                     [this](boost::system::error_code ec, size_t) {
+                       fEc = ec;
+                     });
+    Run();
+  }
+
+  void Close() {
+    boost::system::error_code ec;
+    fStream.socket().shutdown(tcp::socket::shutdown_both, ec);
+    fStream.close();
+  }
+
+private:
+  // run the pending operation, throws on error or timeout
+  void Run() {
+    fEc = {};
+    fIoc.restart();
+    fIoc.run();
+    if (fEc)
+      throw boost::system::system_error{fEc};
+  }
+
+  boost::asio::io_context fIoc{};
+  tcp::resolver fResolver{fIoc};
+  boost::beast::tcp_stream fStream{fIoc};
+  boost::beast::flat_buffer fReadBuffer{};
+  boost::system::error_code fEc{};
+};
+
+//-----------------------------------------------------------------------------
+// gzip compress a string
+
+static std::string GzipCompress(const std::string& msg) {
+  namespace bio = boost::iostreams;
+  std::string res;
+  bio::filtering_ostream os;
+  os.push(bio::gzip_compressor(bio::gzip_params(bio::gzip::best_speed)));
+  os.push(bio::back_inserter(res));
+  os.write(msg.data(), static_cast<std::streamsize>(msg.size()));
+  os.reset(); // flushes and closes the compressor
+  return res;
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Constructor
+  \param sinkpath       path of the owning sink, used in messages
+  \param host           server host name
+  \param port           server port
+  \param target         request target, e.g. `/write?db=cbm`
+  \param authorization  value of the authorization header, empty if none
+ */
+
+InfluxWriter::InfluxWriter(const std::string& sinkpath,
+                           const std::string& host,
+                           const std::string& port,
+                           const std::string& target,
+                           const std::string& authorization)
+    : fSinkPath(sinkpath), fHost(host), fPort(port), fTarget(target),
+      fAuthorization(authorization) {
+  fThread = std::thread([this]() { WriterLoop(); });
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Destructor
+
+  Sends the pending chunks with one final attempt and terminates the writer
+  thread.
+ */
+
+InfluxWriter::~InfluxWriter() {
+  {
+    std::lock_guard<std::mutex> lk(fMutex);
+    fStopped = true;
+  }
+  fCV.notify_one();
+  if (fThread.joinable())
+    fThread.join();
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Queue a chunk of points for sending
+  \param msg     points in line format (will be moved)
+  \param npoint  number of points in `msg`
+
+  The chunk is compressed and appended to the buffer. If the buffer limit is
+  exceeded, the oldest chunks are dropped.
+ */
+
+void InfluxWriter::Queue(std::string&& msg, size_t npoint) {
+  Chunk chunk{GzipCompress(msg), npoint};
+  msg.clear();
+  {
+    std::lock_guard<std::mutex> lk(fMutex);
+    while (!fBuffer.empty() &&
+           fNBuffered + chunk.fMsg.size() > kMaxBuffered) {
+      fNBuffered -= fBuffer.front().fMsg.size();
+      fStats.fNDrop += fBuffer.front().fNPoint;
+      fBuffer.pop_front();
+    }
+    fNBuffered += chunk.fMsg.size();
+    fBuffer.emplace_back(std::move(chunk));
+  }
+  fCV.notify_one();
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Returns the statistics since the previous call and resets them
+ */
+
+InfluxWriter::Stats InfluxWriter::TakeStats() {
+  std::lock_guard<std::mutex> lk(fMutex);
+  Stats stats = std::move(fStats);
+  stats.fNBuffered = fNBuffered;
+  fStats = Stats();
+  return stats;
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief The event loop of the writer thread
+ */
+
+void InfluxWriter::WriterLoop() {
+  cbm::system::set_thread_name("cbm:influx");
+
+  Connection conn;
+  std::chrono::milliseconds backoff{0};
+  while (true) {
+    std::vector<Chunk> chunks;
+    {
+      std::unique_lock<std::mutex> lk(fMutex);
+      fCV.wait(lk, [this] { return fStopped || !fBuffer.empty(); });
+      if (fBuffer.empty())
+        break; // stopped and all sent
+      while (!fBuffer.empty() && chunks.size() < kPipelineDepth) {
+        fNBuffered -= fBuffer.front().fMsg.size();
+        chunks.emplace_back(std::move(fBuffer.front()));
+        fBuffer.pop_front();
+      }
+    }
+
+    size_t ndone = SendChunks(conn, chunks);
+    if (ndone == chunks.size()) {
+      backoff = 0ms;
+      continue;
+    }
+
+    // failed: drop all when stopping, otherwise requeue and wait
+    std::unique_lock<std::mutex> lk(fMutex);
+    fStats.fNRetry += 1;
+    if (fStopped) {
+      for (size_t i = ndone; i < chunks.size(); i++)
+        fStats.fNDrop += chunks[i].fNPoint;
+      for (auto& chunk : fBuffer)
+        fStats.fNDrop += chunk.fNPoint;
+      fBuffer.clear();
+      fNBuffered = 0;
+      break;
+    }
+    for (size_t i = chunks.size(); i > ndone; i--) {
+      fNBuffered += chunks[i - 1].fMsg.size();
+      fBuffer.emplace_front(std::move(chunks[i - 1]));
+    }
+    backoff = std::clamp<std::chrono::milliseconds>(2 * backoff, kBackoffMin,
+                                                    kBackoffMax);
+    fCV.wait_for(lk, backoff, [this] { return fStopped; });
+  }
+  if (conn.IsOpen())
+    conn.Close();
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Send chunks as pipelined requests on a persistent connection
+  \param conn    connection, opened if needed
+  \param chunks  chunks to be sent
+  \returns number of leading chunks which are done, i.e. either accepted or
+    rejected by the server
+
+  A connection that was idle may have been closed by the server in the
+  meantime. Therefore a failure on a reused connection is retried once on a
+  new connection before being reported.
+ */
+
+size_t InfluxWriter::SendChunks(Connection& conn,
+                                const std::vector<Chunk>& chunks) {
+  size_t ndone = 0;
+  bool reused = conn.IsOpen();
+  while (true) {
+    try {
+      if (!conn.IsOpen())
+        conn.Open(fHost, fPort);
+
+      using clock = std::chrono::steady_clock;
+      std::vector<http::request<http::string_body>> reqs;
+      std::vector<clock::time_point> tbeg;
+      for (size_t i = ndone; i < chunks.size(); i++) {
+        auto& req = reqs.emplace_back(http::verb::post, fTarget, 11);
+        req.set(http::field::host, fHost);
+        if (!fAuthorization.empty())
+          req.set(http::field::authorization, fAuthorization);
+        req.set(http::field::user_agent, "Monitor");
+        req.set(http::field::accept, "application/json");
+        req.set(http::field::content_type, "text/plain; charset=utf-8");
+        req.set(http::field::content_encoding, "gzip");
+        req.keep_alive(true);
+        req.body() = chunks[i].fMsg;
+        req.prepare_payload();
+      }
+      for (auto& req : reqs) {
+        tbeg.push_back(clock::now());
+        conn.Write(req);
+      }
+
+      for (size_t i = 0; i < reqs.size(); i++) {
+        http::response<http::string_body> res;
+        conn.Read(res);
+        std::chrono::duration<double> dt = clock::now() - tbeg[i];
+        const Chunk& chunk = chunks[ndone];
+        // Note in InfluxDB:
+        //   returns a 204 -> "No Content" for successful completion
+        //   returns 4xx if the request is ill-formed or not authorized,
+        //     except 429 -> "Too Many Requests"
+        //   returns 5xx if the server failed or is not ready
+        int status = res.result_int();
+        bool accepted = status == 200 || status == 204;
+        bool rejected = status >= 400 && status < 500 && status != 429;
+        if (!accepted) {
+          std::string ebody = res.body(); // trim \r and trailing \n
+          ebody.erase(std::remove(ebody.begin(), ebody.end(), '\r'),
+                      ebody.end());
+          if (!ebody.empty() && ebody[ebody.size() - 1] == '\n')
+            ebody.erase(ebody.size() - 1);
+          LogError(fmt::format("HTTP status={} {}, HTTP body={}", status,
+                               std::string(res.reason()), ebody));
+          if (!rejected) {
+            conn.Close();
+            return ndone;
+          }
+        }
+        {
+          std::lock_guard<std::mutex> lk(fMutex);
+          if (accepted) {
+            fStats.fNSend += 1;
+            fStats.fNByte += chunk.fMsg.size();
+          } else {
+            fStats.fNDrop += chunk.fNPoint;
+          }
+          fStats.fSndTime += dt.count();
+          fStats.fSndLatency.Record(static_cast<uint64_t>(dt.count() * 1e6));
+        }
+        ndone += 1;
+        if (res.need_eof()) { // server closes, requeue the remainder
+          conn.Close();
+          return ndone;
+        }
+      }
+      return ndone;
+
+    } catch (std::exception const& e) {
+      if (conn.IsOpen())
+        conn.Close();
+      if (reused && ndone == 0) {
+        reused = false; // stale connection, retry once on a new one
+        continue;
+      }
+      LogError(fmt::format("error={}", e.what()));
+      return ndone;
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Report a send error
+ */
+
+void InfluxWriter::LogError(const std::string& msg) {
+#if defined(CBMLOGERR1)
+  CBMLOGERR1("cid=__Monitor", "SendData-err")
+      << "sinkname=" << fSinkPath << ", " << msg;
+#else
+  std::cerr << "InfluxWriter::SendData error: "
+            << "sinkname=" << fSinkPath << ", " << msg << "\n";
+#endif
+}
+
+} // end namespace cbm
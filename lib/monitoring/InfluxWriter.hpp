@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#ifndef included_Cbm_InfluxWriter
+#define included_Cbm_InfluxWriter 1
+
+#include "Histogram.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace cbm {
+
+class InfluxWriter {
+public:
+  struct Stats {
+    uint64_t fNSend{0};    //!< # of successful HTTP post requests
+    uint64_t fNByte{0};    //!< # of sent (compressed) bytes
+    uint64_t fNDrop{0};    //!< # of dropped points
+    uint64_t fNRetry{0};   //!< # of failed and repeated requests
+    size_t fNBuffered{0};  //!< bytes waiting to be sent
+    double fSndTime{0.};   //!< time spend in requests (in s)
+    Histogram fSndLatency; //!< request latencies (in us)
+  };
+
+  InfluxWriter(const std::string& sinkpath,
+               const std::string& host,
+               const std::string& port,
+               const std::string& target,
+               const std::string& authorization);
+  ~InfluxWriter();
+
+  InfluxWriter(const InfluxWriter&) = delete;
+  InfluxWriter& operator=(const InfluxWriter&) = delete;
+
+  void Queue(std::string&& msg, size_t npoint);
+  Stats TakeStats();
+
+private:
+  struct Chunk {
+    std::string fMsg{}; //!< points in line format
+    size_t fNPoint{0};  //!< # of points in fMsg
+  };
+  class Connection; // defined in InfluxWriter.cpp
+
+  void WriterLoop();
+  size_t SendChunks(Connection& conn, const std::vector<Chunk>& chunks);
+  void LogError(const std::string& msg);
+
+  std::string fSinkPath;      //!< sink path, for messages
+  std::string fHost;          //!< server host name
+  std::string fPort;          //!< server port
+  std::string fTarget;        //!< request target
+  std::string fAuthorization; //!< authorization header, empty if none
+
+  std::deque<Chunk> fBuffer{};   //!< chunks waiting to be sent
+  size_t fNBuffered{0};          //!< bytes in fBuffer
+  Stats fStats{};                //!< statistics since last TakeStats()
+  std::mutex fMutex{};           //!< mutex for fBuffer and fStats
+  std::condition_variable fCV{}; //!< signals new chunks and rundown
+  bool fStopped{false};          //!< signals thread rundown
+  std::thread fThread{};         //!< writer thread
+};
+
+} // end namespace cbm
+
+// #include "InfluxWriter.ipp"
+
+#endif
@@ -0,0 +1,314 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "LiveStats.hpp"
+#include "System.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cbm {
+
+/*! \class LiveStats
+  \brief Process-wide live statistics in a shared memory segment
+
+  Once Create() is called, a process publishes named counters and
+  histograms in the POSIX shared memory segment `/cbm_live_stats.<instance>`.
+  The hot paths update them with relaxed atomic operations through
+  LiveCounter and LiveHistogram handles, so external tools (see
+  LiveStatsReader) can read them at any frequency without any interaction
+  with the producer. Rates are derived by the readers from the increase of
+  the counters between two reads.
+
+  The segment has a fixed layout with kNCounter counter slots and
+  kNHistogram histogram slots, which are assigned on the first request of a
+  name (and key) and never released. The histograms use the buckets of
+  cbm::Histogram, e.g. for the microslice sizes per eq_id. Handles
+  requested before Create() or when the slots are exhausted discard all
+  values, so the instrumentation can stay in place when the statistics are
+  disabled.
+*/
+
+/*! \class LiveCounter
+  \brief Handle of a counter in the LiveStats segment
+*/
+
+/*! \class LiveHistogram
+  \brief Handle of a histogram in the LiveStats segment
+*/
+
+/*! \class LiveStatsReader
+  \brief Read-only access to the LiveStats segment of another process
+*/
+
+namespace {
+// Copy a slot name, truncated to the slot size
+void SetName(char* dst, const std::string& name) {
+  size_t len = std::min(name.size(), LiveStats::kNameSize - 1);
+  std::memcpy(dst, name.data(), len);
+  dst[len] = '\0';
+}
+
+// Compare a slot name with a name truncated to the slot size
+bool NameEquals(const char* slot, const std::string& name) {
+  return std::strncmp(slot, name.c_str(), LiveStats::kNameSize - 1) == 0;
+}
+
+std::string GetName(const char* slot) {
+  return std::string(slot, strnlen(slot, LiveStats::kNameSize));
+}
+} // namespace
+
+//-----------------------------------------------------------------------------
+/*! \brief Creates the segment of this process
+  \param instance  instance name, e.g. program name and process id
+
+  A stale segment of the same instance name (e.g. of a crashed process) is
+  replaced. Throws std::runtime_error if the segment cannot be created or
+  if it has already been created.
+ */
+
+void LiveStats::Create(const std::string& instance) {
+  std::lock_guard<std::mutex> lock(fMutex);
+  if (fLayout != nullptr)
+    throw std::runtime_error("live statistics segment already created");
+
+  std::string name = SegmentName(instance);
+  shm_unlink(name.c_str());
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+  if (fd < 0)
+    throw std::runtime_error("cannot create shared memory " + name + ": " +
+                             system::stringerror(errno));
+  if (ftruncate(fd, sizeof(Layout)) != 0) {
+    int err = errno;
+    close(fd);
+    shm_unlink(name.c_str());
+    throw std::runtime_error("cannot resize shared memory " + name + ": " +
+                             system::stringerror(err));
+  }
+  void* addr =
+      mmap(nullptr, sizeof(Layout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    int err = errno;
+    shm_unlink(name.c_str());
+    throw std::runtime_error("cannot map shared memory " + name + ": " +
+                             system::stringerror(err));
+  }
+
+  // the new segment is zero-filled, i.e. all slots are empty
+  auto* layout = static_cast<Layout*>(addr);
+  layout->fVersion = kVersion;
+  layout->fPid = static_cast<uint32_t>(getpid());
+  layout->fStartTime =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count();
+  std::atomic_thread_fence(std::memory_order_release);
+  layout->fMagic = kMagic;
+
+  fLayout = layout;
+  fSegmentName = name;
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Removes the segment name, e.g. at the end of the process
+
+  The mapping stays valid, so the existing handles can still be used.
+ */
+
+void LiveStats::Remove() {
+  std::lock_guard<std::mutex> lock(fMutex);
+  if (!fSegmentName.empty())
+    shm_unlink(fSegmentName.c_str());
+  fSegmentName.clear();
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Returns the shared memory name of the segment of an instance
+
+std::string LiveStats::SegmentName(const std::string& instance) {
+  return std::string("/") + kPrefix + instance;
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Returns a handle of the counter with a given name
+  \param name  counter name (truncated to kNameSize - 1 characters)
+
+  Handles of the same name refer to the same counter.
+ */
+
+LiveCounter LiveStats::Counter(const std::string& name) {
+  std::lock_guard<std::mutex> lock(fMutex);
+  if (fLayout == nullptr)
+    return LiveCounter();
+  uint32_t n = fLayout->fNCounter.load(std::memory_order_relaxed);
+  for (uint32_t i = 0; i < n; i++)
+    if (NameEquals(fLayout->fCounter[i].fName, name))
+      return LiveCounter(&fLayout->fCounter[i].fValue);
+  if (n == kNCounter)
+    return LiveCounter();
+  SetName(fLayout->fCounter[n].fName, name);
+  fLayout->fNCounter.store(n + 1, std::memory_order_release);
+  return LiveCounter(&fLayout->fCounter[n].fValue);
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Returns a handle of the histogram with a given name and key
+  \param name  histogram name (truncated to kNameSize - 1 characters)
+  \param key   key distinguishing histograms of the same name, e.g. eq_id
+
+  Handles of the same name and key refer to the same histogram.
+ */
+
+LiveHistogram LiveStats::Histogram(const std::string& name, uint32_t key) {
+  std::lock_guard<std::mutex> lock(fMutex);
+  if (fLayout == nullptr)
+    return LiveHistogram();
+  uint32_t n = fLayout->fNHistogram.load(std::memory_order_relaxed);
+  for (uint32_t i = 0; i < n; i++)
+    if (fLayout->fHistogram[i].fKey == key &&
+        NameEquals(fLayout->fHistogram[i].fName, name))
+      return LiveHistogram(&fLayout->fHistogram[i]);
+  if (n == kNHistogram)
+    return LiveHistogram();
+  SetName(fLayout->fHistogram[n].fName, name);
+  fLayout->fHistogram[n].fKey = key;
+  fLayout->fNHistogram.store(n + 1, std::memory_order_release);
+  return LiveHistogram(&fLayout->fHistogram[n]);
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Constructor, maps the segment of an instance read-only
+  \param instance  instance name given to LiveStats::Create()
+
+  Throws std::runtime_error if the segment does not exist or is not a
+  LiveStats segment of this version.
+ */
+
+LiveStatsReader::LiveStatsReader(const std::string& instance)
+    : fInstance(instance) {
+  std::string name = LiveStats::SegmentName(instance);
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0)
+    throw std::runtime_error("cannot open shared memory " + name + ": " +
+                             system::stringerror(errno));
+  struct stat st {};
+  if (fstat(fd, &st) != 0 ||
+      static_cast<size_t>(st.st_size) < sizeof(LiveStats::Layout)) {
+    close(fd);
+    throw std::runtime_error("not a live statistics segment: " + name);
+  }
+  void* addr =
+      mmap(nullptr, sizeof(LiveStats::Layout), PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED)
+    throw std::runtime_error("cannot map shared memory " + name + ": " +
+                             system::stringerror(errno));
+  fLayout = static_cast<const LiveStats::Layout*>(addr);
+  if (fLayout->fMagic != LiveStats::kMagic ||
+      fLayout->fVersion != LiveStats::kVersion) {
+    munmap(addr, sizeof(LiveStats::Layout));
+    throw std::runtime_error("not a live statistics segment: " + name);
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Destructor, unmaps the segment
+
+LiveStatsReader::~LiveStatsReader() {
+  munmap(const_cast<LiveStats::Layout*>(fLayout), sizeof(LiveStats::Layout));
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Returns the instance name
+
+const std::string& LiveStatsReader::Instance() const { return fInstance; }
+
+//-----------------------------------------------------------------------------
+//! \brief Returns the process id of the producer
+
+uint32_t LiveStatsReader::Pid() const { return fLayout->fPid; }
+
+//-----------------------------------------------------------------------------
+//! \brief Returns false if the producer has terminated
+
+bool LiveStatsReader::Alive() const {
+  return kill(static_cast<pid_t>(fLayout->fPid), 0) == 0 || errno == EPERM;
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Returns the current values of all counters
+
+std::vector<LiveStatsReader::CounterValue> LiveStatsReader::Counters() const {
+  uint32_t n = std::min<uint32_t>(
+      fLayout->fNCounter.load(std::memory_order_acquire), LiveStats::kNCounter);
+  std::vector<CounterValue> values;
+  values.reserve(n);
+  for (uint32_t i = 0; i < n; i++) {
+    const auto& slot = fLayout->fCounter[i];
+    values.push_back(
+        {GetName(slot.fName), slot.fValue.load(std::memory_order_relaxed)});
+  }
+  return values;
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Returns copies of all histograms
+
+  The buckets are read one by one while the producer may record, so the
+  copies are consistent only to within the values recorded while reading.
+ */
+
+std::vector<LiveStatsReader::HistogramValue>
+LiveStatsReader::Histograms() const {
+  uint32_t n =
+      std::min<uint32_t>(fLayout->fNHistogram.load(std::memory_order_acquire),
+                         LiveStats::kNHistogram);
+  std::vector<HistogramValue> values;
+  values.reserve(n);
+  for (uint32_t i = 0; i < n; i++) {
+    const auto& slot = fLayout->fHistogram[i];
+    HistogramValue value{GetName(slot.fName), slot.fKey, cbm::Histogram()};
+    for (size_t b = 0; b < Histogram::kNBucket; b++)
+      value.fHistogram.MergeBucket(
+          b, slot.fBucket[b].load(std::memory_order_relaxed));
+    value.fHistogram.MergeSummary(slot.fSum.load(std::memory_order_relaxed),
+                                  slot.fMax.load(std::memory_order_relaxed));
+    values.push_back(std::move(value));
+  }
+  return values;
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Returns the instance names of all existing segments
+
+std::vector<std::string> LiveStatsReader::List() {
+  std::vector<std::string> instances;
+  DIR* dir = opendir("/dev/shm");
+  if (dir == nullptr)
+    return instances;
+  const size_t len = std::strlen(LiveStats::kPrefix);
+  while (dirent* entry = readdir(dir))
+    if (std::strncmp(entry->d_name, LiveStats::kPrefix, len) == 0)
+      instances.emplace_back(entry->d_name + len);
+  closedir(dir);
+  std::sort(instances.begin(), instances.end());
+  return instances;
+}
+
+LiveStats::Layout* LiveStats::fLayout{nullptr};
+std::string LiveStats::fSegmentName{};
+std::mutex LiveStats::fMutex{};
+
+} // end namespace cbm
@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#ifndef included_Cbm_LiveStats
+#define included_Cbm_LiveStats 1
+
+#include "Histogram.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace cbm {
+
+class LiveCounter;
+class LiveHistogram;
+
+class LiveStats {
+public:
+  static constexpr size_t kNCounter = 128;   //!< # of counter slots
+  static constexpr size_t kNHistogram = 256; //!< # of histogram slots
+  static constexpr size_t kNameSize = 48;    //!< slot name size incl. '\0'
+  static constexpr const char* kPrefix = "cbm_live_stats."; //!< shm prefix
+
+  static void Create(const std::string& instance);
+  static void Remove();
+  static bool Enabled();
+  static std::string SegmentName(const std::string& instance);
+
+  static LiveCounter Counter(const std::string& name);
+  static LiveHistogram Histogram(const std::string& name, uint32_t key);
+
+private:
+  friend class LiveCounter;
+  friend class LiveHistogram;
+  friend class LiveStatsReader;
+
+  static constexpr uint64_t kMagic = 0x5354534556494c43; //!< "CLIVESTS"
+  static constexpr uint32_t kVersion = 1;                 //!< layout version
+
+  struct CounterSlot {
+    char fName[kNameSize];        //!< counter name
+    std::atomic<uint64_t> fValue; //!< counter value
+  };
+
+  struct HistogramSlot {
+    char fName[kNameSize];      //!< histogram name
+    uint32_t fKey;              //!< key, e.g. eq_id
+    std::atomic<uint64_t> fSum; //!< sum of values
+    std::atomic<uint64_t> fMax; //!< largest value
+    std::atomic<uint64_t> fBucket[cbm::Histogram::kNBucket]; //!< counts
+  };
+
+  struct Layout {
+    uint64_t fMagic;                       //!< kMagic once initialized
+    uint32_t fVersion;                     //!< kVersion
+    uint32_t fPid;                         //!< process id of the producer
+    int64_t fStartTime;                    //!< creation time (ns since epoch)
+    std::atomic<uint32_t> fNCounter;       //!< # of published counters
+    std::atomic<uint32_t> fNHistogram;     //!< # of published histograms
+    CounterSlot fCounter[kNCounter];       //!< counter slots
+    HistogramSlot fHistogram[kNHistogram]; //!< histogram slots
+  };
+
+  static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                "shared memory counters must be lock-free");
+
+  static Layout* fLayout;          //!< mapped segment, nullptr if disabled
+  static std::string fSegmentName; //!< name of the created segment
+  static std::mutex fMutex;        //!< for Create(), Remove() and slots
+};
+
+class LiveCounter {
+public:
+  LiveCounter() = default;
+
+  void Add(uint64_t n = 1) const;
+  void Set(uint64_t value) const;
+
+private:
+  friend class LiveStats;
+  explicit LiveCounter(std::atomic<uint64_t>* value) : fValue(value) {}
+
+  std::atomic<uint64_t>* fValue{nullptr}; //!< slot value, nullptr discards
+};
+
+class LiveHistogram {
+public:
+  LiveHistogram() = default;
+
+  void Record(uint64_t value) const;
+
+private:
+  friend class LiveStats;
+  explicit LiveHistogram(LiveStats::HistogramSlot* slot) : fSlot(slot) {}
+
+  LiveStats::HistogramSlot* fSlot{nullptr}; //!< slot, nullptr discards
+};
+
+class LiveStatsReader {
+public:
+  struct CounterValue {
+    std::string fName; //!< counter name
+    uint64_t fValue;   //!< counter value
+  };
+
+  struct HistogramValue {
+    std::string fName;         //!< histogram name
+    uint32_t fKey;             //!< histogram key
+    cbm::Histogram fHistogram; //!< copy of the recorded values
+  };
+
+  explicit LiveStatsReader(const std::string& instance);
+  ~LiveStatsReader();
+
+  LiveStatsReader(const LiveStatsReader&) = delete;
+  LiveStatsReader& operator=(const LiveStatsReader&) = delete;
+
+  const std::string& Instance() const;
+  uint32_t Pid() const;
+  bool Alive() const;
+  std::vector<CounterValue> Counters() const;
+  std::vector<HistogramValue> Histograms() const;
+
+  static std::vector<std::string> List();
+
+private:
+  std::string fInstance;                     //!< instance name
+  const LiveStats::Layout* fLayout{nullptr}; //!< read-only mapping
+};
+
+} // end namespace cbm
+
+#include "LiveStats.ipp"
+
+#endif
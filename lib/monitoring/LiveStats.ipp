@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+namespace cbm {
+
+//-----------------------------------------------------------------------------
+//! \brief Returns true if the live statistics segment exists
+
+inline bool LiveStats::Enabled() {
+  std::lock_guard<std::mutex> lock(fMutex);
+  return fLayout != nullptr;
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Adds to the counter
+  \param n  increment
+ */
+
+inline void LiveCounter::Add(uint64_t n) const {
+  if (fValue != nullptr)
+    fValue->fetch_add(n, std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Sets the counter, e.g. to use it as a gauge
+  \param value  new value
+ */
+
+inline void LiveCounter::Set(uint64_t value) const {
+  if (fValue != nullptr)
+    fValue->store(value, std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Records a value
+  \param value  value to be counted
+ */
+
+inline void LiveHistogram::Record(uint64_t value) const {
+  if (fSlot == nullptr)
+    return;
+  fSlot->fBucket[Histogram::BucketIndex(value)].fetch_add(
+      1, std::memory_order_relaxed);
+  fSlot->fSum.fetch_add(value, std::memory_order_relaxed);
+  uint64_t max = fSlot->fMax.load(std::memory_order_relaxed);
+  while (value > max && !fSlot->fMax.compare_exchange_weak(
+                            max, value, std::memory_order_relaxed)) {
+  }
+}
+
+} // end namespace cbm
@@ -5,6 +5,8 @@
 #ifndef included_Cbm_Metric
 #define included_Cbm_Metric 1
 
+#include "Histogram.hpp"
+
 #include <chrono>
 #include <string>
 #include <string_view>
@@ -22,7 +24,8 @@ using MetricField = std::variant<bool,
                                  float,
                                  double,
                                  std::string,
-                                 std::string_view>;
+                                 std::string_view,
+                                 Histogram>;
 using MetricFieldSet = std::vector<std::pair<std::string, MetricField>>;
 
 struct Metric {
@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#ifndef included_Cbm_MetricHandle
+#define included_Cbm_MetricHandle 1
+
+#include "Histogram.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cbm {
+
+class Monitor; // forward declaration
+
+class MetricCounter {
+public:
+  MetricCounter() = default;
+
+  void Add(uint64_t n = 1) const;
+
+private:
+  friend class Monitor;
+  MetricCounter(Monitor* monitor, uint32_t cell)
+      : fMonitor(monitor), fCell(cell) {}
+
+  Monitor* fMonitor{nullptr}; //!< owning Monitor, nullptr discards values
+  uint32_t fCell{0};          //!< index of the per-thread cell
+};
+
+class MetricGauge {
+public:
+  MetricGauge() = default;
+
+  void Set(int64_t value) const;
+
+private:
+  friend class Monitor;
+  MetricGauge(Monitor* monitor, uint32_t cell)
+      : fMonitor(monitor), fCell(cell) {}
+
+  Monitor* fMonitor{nullptr}; //!< owning Monitor, nullptr discards values
+  uint32_t fCell{0};          //!< index of the per-thread cell
+};
+
+class MetricHistogram {
+public:
+  MetricHistogram() = default;
+
+  void Record(uint64_t value) const;
+
+  static constexpr size_t kNBucket = Histogram::kNBucket; //!< # of buckets
+  static constexpr size_t kNCell = kNBucket + 2; //!< buckets, sum, max
+
+private:
+  friend class Monitor;
+  MetricHistogram(Monitor* monitor, uint32_t cell)
+      : fMonitor(monitor), fCell(cell) {}
+
+  Monitor* fMonitor{nullptr}; //!< owning Monitor, nullptr discards values
+  uint32_t fCell{0};          //!< index of the first per-thread cell
+};
+
+} // end namespace cbm
+
+// MetricHandle.ipp is included by Monitor.hpp, after the Monitor definition
+
+#endif
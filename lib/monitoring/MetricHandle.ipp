@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+namespace cbm {
+
+/*! \class MetricCounter
+  \brief Handle of a registered counter metric
+
+  Obtained from Monitor::RegisterCounter(). Each thread adds to its own cell,
+  the Monitor reports the sum over all threads. Recording is wait-free and
+  does not allocate. A default-constructed handle discards all values.
+*/
+
+/*! \class MetricGauge
+  \brief Handle of a registered gauge metric
+
+  Obtained from Monitor::RegisterGauge(). Each thread sets its own cell, the
+  Monitor reports the sum over all threads. A gauge is thus typically set
+  from a single thread.
+*/
+
+/*! \class MetricHistogram
+  \brief Handle of a registered histogram metric
+
+  Obtained from Monitor::RegisterHistogram(). Values are counted in the
+  log-linear buckets of Histogram. The Monitor reports a Histogram of the
+  values recorded since the previous report.
+*/
+
+//-----------------------------------------------------------------------------
+/*! \brief Add to the counter
+  \param n  increment
+ */
+
+inline void MetricCounter::Add(uint64_t n) const {
+  if (!fMonitor)
+    return;
+  // the cell is written by the calling thread only, no atomic RMW needed
+  std::atomic<uint64_t>& cell = fMonitor->ThreadCells()[fCell];
+  cell.store(cell.load(std::memory_order_relaxed) + n,
+             std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Set the gauge value of the calling thread
+  \param value  new value
+ */
+
+inline void MetricGauge::Set(int64_t value) const {
+  if (!fMonitor)
+    return;
+  fMonitor->ThreadCells()[fCell].store(static_cast<uint64_t>(value),
+                                       std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Record a value
+  \param value  value to be counted
+ */
+
+inline void MetricHistogram::Record(uint64_t value) const {
+  if (!fMonitor)
+    return;
+  std::atomic<uint64_t>* cells = fMonitor->ThreadCells() + fCell;
+  std::atomic<uint64_t>& bucket = cells[Histogram::BucketIndex(value)];
+  bucket.store(bucket.load(std::memory_order_relaxed) + 1,
+               std::memory_order_relaxed);
+  std::atomic<uint64_t>& sum = cells[kNBucket];
+  sum.store(sum.load(std::memory_order_relaxed) + value,
+            std::memory_order_relaxed);
+  // the maximum is also reset by the Monitor thread, a lost reset is harmless
+  std::atomic<uint64_t>& max = cells[kNBucket + 1];
+  if (value > max.load(std::memory_order_relaxed))
+    max.store(value, std::memory_order_relaxed);
+}
+
+} // end namespace cbm
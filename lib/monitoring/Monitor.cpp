@@ -4,16 +4,37 @@
 
 #include "Monitor.hpp"
 
+#include "AllocationStats.hpp"
 #include "MonitorSinkFile.hpp"
 #include "MonitorSinkInflux1.hpp"
 #include "MonitorSinkInflux2.hpp"
+#include "MonitorSinkPrometheus.hpp"
 #include "System.hpp"
+#include <algorithm>
 #include <stdexcept>
+#include <utility>
 
 #include "fmt/format.h"
 
 namespace cbm {
 
+namespace {
+//! \brief Returns the approximate number of bytes held by a metric point
+size_t MetricBytes(const Metric& point) {
+  size_t bytes = sizeof(Metric) + point.fMeasurement.capacity();
+  bytes += point.fTagset.capacity() * sizeof(MetricTagSet::value_type);
+  bytes += point.fFieldset.capacity() * sizeof(MetricFieldSet::value_type);
+  for (const auto& tag : point.fTagset)
+    bytes += tag.first.capacity() + tag.second.capacity();
+  for (const auto& field : point.fFieldset) {
+    bytes += field.first.capacity();
+    if (const auto* str = std::get_if<std::string>(&field.second))
+      bytes += str->capacity();
+  }
+  return bytes;
+}
+} // namespace
+
 /*! \class Monitor
   \brief Thread-safe metric monitor system for CBM
 
@@ -43,6 +64,22 @@ namespace cbm {
 
   See QueueMetric() for a more detailed description the Monitor input interface.
 
+  For metrics updated at high rates, e.g. per processed item, QueueMetric()
+  is too costly, as each call allocates the Metric and locks the queue. Such
+  metrics are registered once with RegisterCounter(), RegisterGauge(), or
+  RegisterHistogram(), the returned handle is used to record values
+  \code{.cpp}
+   auto nsent = Monitor::Ref().RegisterCounter("sender",           // once
+                                               {{"host", host}},
+                                               "components");
+   nsent.Add();                                                    // often
+  \endcode
+  Fields registered with the same measurement and tags are reported as one
+  point. Each thread records into its own array of cells, so recording is
+  wait-free and does not allocate. The work thread sums up the cells of all
+  threads in each cycle (see kELoopTimeout) and reports the metrics that
+  have changed since the previous cycle.
+
   The Monitor back end is provided by MonitorSink objects and controlled via
   - OpenSink(): creates a new sink
   - CloseSink(): removes a sink
@@ -51,6 +88,7 @@ namespace cbm {
   - MonitorSinkFile: writes to files
   - MonitorSinkInflux1: writes to an InfluxDB V1.x time-series database
   - MonitorSinkInflux2: writes to an InfluxDB V2.x time-series database
+  - MonitorSinkPrometheus: serves the latest values to Prometheus scrapes
 
   The Monitor is a \glos{singleton} and accessed via the Monitor::Ref() static
   method.
@@ -62,6 +100,15 @@ namespace cbm {
     `mutex` is thus very unlikely:
     - at metrics queueing: just a `vector::push_back(move(...))`
     - at metrics processing: just a `vector::swap(...)`
+  - EnableThreadStats() adds the CPU usage and scheduling statistics of the
+    named threads of the process (see ThreadStats) in each cycle
+  - with AllocationStats enabled, the queued metric points are accounted in
+    the category AllocationStats::kMetric until they are processed, and the
+    allocation metrics are reported in each cycle
+  - the cells of registered metrics are written by their own thread only,
+    with relaxed atomic stores. The cell array of a thread is allocated at
+    its first recording and kept until the Monitor is destroyed, so values
+    recorded by threads that have finished are still reported.
 */
 
 //-----------------------------------------------------------------------------
@@ -73,7 +120,7 @@ namespace cbm {
   the name "cbm:monitor" for processing the metrics.
  */
 
-Monitor::Monitor(const std::string& sname) {
+Monitor::Monitor(const std::string& sname) : fSerial(++fNextSerial) {
   // singleton check
   if (fpSingleton)
     throw std::runtime_error("Monitor::ctor: already instantiated");
@@ -124,6 +171,7 @@ Monitor::~Monitor() {
   - `file`: will create a MonitorSinkFile sink
   - `influx1`: will create a MonitorSinkInflux1 sink
   - `influx2`: will create a MonitorSinkInflux2 sink
+  - `prometheus`: will create a MonitorSinkPrometheus sink
  */
 
 void Monitor::OpenSink(const std::string& sname) {
@@ -160,6 +208,11 @@ void Monitor::OpenSink(const std::string& sname) {
         std::make_unique<MonitorSinkInflux2>(*this, spath);
     std::lock_guard<std::mutex> lock(fSinkMapMutex);
     fSinkMap.try_emplace(sname, std::move(uptr));
+  } else if (stype == "prometheus") {
+    std::unique_ptr<MonitorSink> uptr =
+        std::make_unique<MonitorSinkPrometheus>(*this, spath);
+    std::lock_guard<std::mutex> lock(fSinkMapMutex);
+    fSinkMap.try_emplace(sname, std::move(uptr));
   } else {
     throw std::runtime_error(
         fmt::format("Monitor::OpenSink: invalid sink type '{}'", stype));
@@ -211,10 +264,16 @@ void Monitor::QueueMetric(Metric&& point) {
   auto ts = point.fTimestamp;
   if (ts == time_point())
     ts = std::chrono::system_clock::now();
+  size_t bytes = 0;
+  if (AllocationStats::Enabled()) {
+    bytes = MetricBytes(point);
+    AllocationStats::Allocate(AllocationStats::kMetric, bytes);
+  }
   {
     std::lock_guard<std::mutex> lock(fMetVecMutex);
     fMetVec.emplace_back(std::move(point));
     fMetVec[fMetVec.size() - 1].fTimestamp = ts;
+    fMetVecBytes += bytes;
   }
 }
 
@@ -282,11 +341,13 @@ void Monitor::EventLoop() {
     // timeout results in auto flush
 
     metvec_t metvec;
+    size_t metvec_bytes = 0;
     {
       std::lock_guard<std::mutex> lock(fMetVecMutex);
       if (!fMetVec.empty()) {
         // move whole vector from protected queue to local environment
         metvec.swap(fMetVec);
+        std::swap(metvec_bytes, fMetVecBytes);
         // determine sensible capacity to minimize re-allocs
         size_t ncap = metvec.capacity();
         if (metvec.size() > metvec.capacity() / 2)
@@ -299,11 +360,18 @@ void Monitor::EventLoop() {
       }
     }
 
+    SnapshotRegistered(metvec);
+    AllocationStats::Snapshot(metvec);
+    if (fThreadStats)
+      fThreadStats->Snapshot(metvec);
+
     if (metvec.size() > 0) {
       std::lock_guard<std::mutex> lock(fSinkMapMutex);
       for (auto& kv : fSinkMap)
         (*kv.second).ProcessMetricVec(metvec);
     }
+    if (metvec_bytes > 0)
+      AllocationStats::Release(AllocationStats::kMetric, metvec_bytes);
     if (std::chrono::system_clock::now() > fNextHeartbeat && !stopped) {
       // handle heartbeats
       fNextHeartbeat += kHeartbeat; // schedule next
@@ -314,6 +382,73 @@ void Monitor::EventLoop() {
   }
 }
 
+//-----------------------------------------------------------------------------
+/*! \brief Enables the reporting of the thread statistics (see ThreadStats)
+
+  The threads are sampled by the work thread in each cycle, the first
+  report follows after the second cycle.
+ */
+
+void Monitor::EnableThreadStats() {
+  std::lock_guard<std::mutex> lk(fControlMutex);
+  if (!fThreadStats)
+    fThreadStats = std::make_unique<ThreadStats>();
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Registers a counter metric
+  \param measurement  measurement id
+  \param tagset       set of tags
+  \param field        field name
+  \throws std::runtime_error if the field is registered with another type or
+    all cells are in use
+  \returns handle to add to the counter
+
+  Registering the same field again returns a handle to the same counter.
+ */
+
+MetricCounter Monitor::RegisterCounter(const std::string& measurement,
+                                       const MetricTagSet& tagset,
+                                       const std::string& field) {
+  return {this, RegisterField(measurement, tagset, field, RegKind::Counter)};
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Registers a gauge metric
+  \param measurement  measurement id
+  \param tagset       set of tags
+  \param field        field name
+  \throws std::runtime_error if the field is registered with another type or
+    all cells are in use
+  \returns handle to set the gauge
+ */
+
+MetricGauge Monitor::RegisterGauge(const std::string& measurement,
+                                   const MetricTagSet& tagset,
+                                   const std::string& field) {
+  return {this, RegisterField(measurement, tagset, field, RegKind::Gauge)};
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Registers a histogram metric
+  \param measurement  measurement id
+  \param tagset       set of tags
+  \param field        field name
+  \throws std::runtime_error if the field is registered with another type or
+    all cells are in use
+  \returns handle to record values
+
+  The histogram is reported as a Histogram field covering the values
+  recorded since the previous report, see MonitorSink::InfluxHistogram()
+  for the exported fields.
+ */
+
+MetricHistogram Monitor::RegisterHistogram(const std::string& measurement,
+                                           const MetricTagSet& tagset,
+                                           const std::string& field) {
+  return {this, RegisterField(measurement, tagset, field, RegKind::Histogram)};
+}
+
 //-----------------------------------------------------------------------------
 /*! \brief Returns reference to a sink
   \param sname    sink name, given as proto:path
@@ -329,9 +464,120 @@ MonitorSink& Monitor::SinkRef(const std::string& sname) {
   return *(it->second.get());
 }
 
+//-----------------------------------------------------------------------------
+/*! \brief Registers a field, returns the index of its first cell
+ */
+
+uint32_t Monitor::RegisterField(const std::string& measurement,
+                                const MetricTagSet& tagset,
+                                const std::string& field,
+                                RegKind kind) {
+  std::string key = measurement;
+  for (auto& tag : tagset)
+    key += "," + tag.first + "=" + tag.second;
+
+  std::lock_guard<std::mutex> lock(fRegMutex);
+  auto [it, inserted] = fRegIndex.try_emplace(key, fRegGroups.size());
+  if (inserted)
+    fRegGroups.push_back({measurement, tagset, {}});
+  RegGroup& group = fRegGroups[it->second];
+
+  for (auto& regfield : group.fFields) {
+    if (regfield.fName == field) {
+      if (regfield.fKind != kind)
+        throw std::runtime_error(
+            fmt::format("Monitor::RegisterField: field '{}' of '{}'"
+                        " registered with another type",
+                        field, key));
+      return regfield.fCell;
+    }
+  }
+
+  size_t ncell = kind == RegKind::Histogram ? MetricHistogram::kNCell : 1;
+  if (fNextCell + ncell > kMaxCells)
+    throw std::runtime_error(
+        fmt::format("Monitor::RegisterField: no cells left for '{}'", field));
+  uint32_t cell = fNextCell;
+  fNextCell += ncell;
+  group.fFields.push_back({kind, cell, field, std::vector<uint64_t>(ncell)});
+  return cell;
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Allocates the registered metric cells of the calling thread
+ */
+
+std::atomic<uint64_t>* Monitor::AttachThread() {
+  auto cells = std::make_unique<cells_t>();
+  for (auto& cell : *cells)
+    cell.store(0, std::memory_order_relaxed);
+  std::lock_guard<std::mutex> lock(fThreadCellsMutex);
+  fThreadCells.push_back(std::move(cells));
+  return fThreadCells.back()->data();
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Appends the changed registered metrics to a metric vector
+ */
+
+void Monitor::SnapshotRegistered(metvec_t& metvec) {
+  std::lock_guard<std::mutex> reglock(fRegMutex);
+  if (fRegGroups.empty())
+    return;
+  std::lock_guard<std::mutex> cellslock(fThreadCellsMutex);
+  auto now = std::chrono::system_clock::now();
+
+  // sum of a cell over all threads
+  auto sum = [this](uint32_t cell) {
+    uint64_t res = 0;
+    for (auto& cells : fThreadCells)
+      res += (*cells)[cell].load(std::memory_order_relaxed);
+    return res;
+  };
+
+  for (auto& group : fRegGroups) {
+    MetricFieldSet fieldset;
+    bool changed = false;
+    for (auto& field : group.fFields) {
+      if (field.fKind == RegKind::Histogram) {
+        Histogram hist;
+        for (size_t i = 0; i < MetricHistogram::kNBucket; i++) {
+          uint64_t val = sum(field.fCell + i);
+          hist.MergeBucket(i, val - field.fLast[i]);
+          field.fLast[i] = val;
+        }
+        uint32_t sumcell = field.fCell + MetricHistogram::kNBucket;
+        uint64_t valsum = sum(sumcell);
+        uint64_t max = 0;
+        for (auto& cells : fThreadCells)
+          max = std::max(max, (*cells)[sumcell + 1].exchange(
+                                  0, std::memory_order_relaxed));
+        hist.MergeSummary(valsum - field.fLast[MetricHistogram::kNBucket], max);
+        field.fLast[MetricHistogram::kNBucket] = valsum;
+        if (hist.Count() > 0) {
+          fieldset.emplace_back(field.fName, std::move(hist));
+          changed = true;
+        }
+      } else {
+        uint64_t val = sum(field.fCell);
+        changed |= val != field.fLast[0];
+        field.fLast[0] = val;
+        if (field.fKind == RegKind::Counter)
+          fieldset.emplace_back(field.fName, val);
+        else
+          fieldset.emplace_back(field.fName, static_cast<int64_t>(val));
+      }
+    }
+    if (changed)
+      metvec.emplace_back(group.fMeasurement, group.fTagset,
+                          std::move(fieldset), now);
+  }
+}
+
 //-----------------------------------------------------------------------------
 // define static member variables
 
 Monitor* Monitor::fpSingleton = nullptr;
+std::atomic<uint64_t> Monitor::fNextSerial{0};
 
 } // end namespace cbm
@@ -6,8 +6,12 @@
 #define included_Cbm_Monitor 1
 
 #include "Metric.hpp"
+#include "MetricHandle.hpp"
 #include "MonitorSink.hpp"
+#include "ThreadStats.hpp"
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <memory>
@@ -49,6 +53,16 @@ public:
                    MetricTagSet&& tagset,
                    MetricFieldSet&& fieldset,
                    time_point timestamp = time_point());
+  MetricCounter RegisterCounter(const std::string& measurement,
+                                const MetricTagSet& tagset,
+                                const std::string& field);
+  MetricGauge RegisterGauge(const std::string& measurement,
+                            const MetricTagSet& tagset,
+                            const std::string& field);
+  MetricHistogram RegisterHistogram(const std::string& measurement,
+                                    const MetricTagSet& tagset,
+                                    const std::string& field);
+  void EnableThreadStats();
   const std::string& HostName() const;
 
   static Monitor& Ref();
@@ -59,14 +73,43 @@ public:
       std::chrono::seconds(10); //!< monitor flush time
   static constexpr auto kHeartbeat =
       std::chrono::seconds(60); //!< heartbeat interval
+  static constexpr size_t kMaxCells =
+      16384; //!< per-thread cells for registered metrics
 
 private:
-  void EventLoop();
-  MonitorSink& SinkRef(const std::string& sname);
+  friend class MetricCounter;
+  friend class MetricGauge;
+  friend class MetricHistogram;
+
+  enum class RegKind { Counter, Gauge, Histogram };
+
+  struct RegField {
+    RegKind fKind;               //!< metric type
+    uint32_t fCell;              //!< index of first cell
+    std::string fName;           //!< field name
+    std::vector<uint64_t> fLast; //!< cell sums at last snapshot
+  };
+
+  struct RegGroup {
+    std::string fMeasurement;      //!< measurement name
+    MetricTagSet fTagset;          //!< interned set of tags
+    std::vector<RegField> fFields; //!< registered fields
+  };
 
   using metvec_t = std::vector<Metric>;
   using sink_uptr_t = std::unique_ptr<MonitorSink>;
   using smap_t = std::unordered_map<std::string, sink_uptr_t>;
+  using cells_t = std::array<std::atomic<uint64_t>, kMaxCells>;
+
+  void EventLoop();
+  MonitorSink& SinkRef(const std::string& sname);
+  uint32_t RegisterField(const std::string& measurement,
+                         const MetricTagSet& tagset,
+                         const std::string& field,
+                         RegKind kind);
+  std::atomic<uint64_t>* ThreadCells();
+  std::atomic<uint64_t>* AttachThread();
+  void SnapshotRegistered(metvec_t& metvec);
 
   std::thread fThread{};              //!< worker thread
   std::condition_variable fControlCV; //!< condition variable for thread control
@@ -75,15 +118,29 @@ private:
 
   metvec_t fMetVec{};          //!< metric list
   std::mutex fMetVecMutex{};   //!< mutex for fMetVec access
+  size_t fMetVecBytes{0};      //!< accounted bytes of fMetVec
   std::string fHostName;       //!< hostname
   smap_t fSinkMap{};           //!< sink registry
   std::mutex fSinkMapMutex{};  //!< mutex for fSinkMap access
   time_point fNextHeartbeat{}; //!< time of next heartbeat
-  static Monitor* fpSingleton; //!< \glos{singleton} this
+
+  std::vector<RegGroup> fRegGroups{};                  //!< registered metrics
+  std::unordered_map<std::string, size_t> fRegIndex{}; //!< group lookup
+  uint32_t fNextCell{0};                               //!< next free cell
+  std::mutex fRegMutex{}; //!< mutex for registry access
+  std::vector<std::unique_ptr<cells_t>> fThreadCells{}; //!< cells per thread
+  std::mutex fThreadCellsMutex{}; //!< mutex for fThreadCells access
+  uint64_t fSerial;               //!< unique id of this instance
+
+  std::unique_ptr<ThreadStats> fThreadStats{}; //!< thread statistics
+
+  static Monitor* fpSingleton;             //!< \glos{singleton} this
+  static std::atomic<uint64_t> fNextSerial; //!< next instance id
 };
 
 } // end namespace cbm
 
+#include "MetricHandle.ipp"
 #include "Monitor.ipp"
 
 #endif
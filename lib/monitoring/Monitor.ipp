@@ -21,4 +21,18 @@ inline Monitor& Monitor::Ref() { return *fpSingleton; }
 
 inline Monitor* Monitor::Ptr() { return fpSingleton; }
 
+//-----------------------------------------------------------------------------
+//! \brief Returns the registered metric cells of the calling thread
+
+inline std::atomic<uint64_t>* Monitor::ThreadCells() {
+  // cache per thread, valid for the Monitor instance with the given id
+  thread_local uint64_t tSerial = 0;
+  thread_local std::atomic<uint64_t>* tCells = nullptr;
+  if (tSerial != fSerial) {
+    tCells = AttachThread();
+    tSerial = fSerial;
+  }
+  return tCells;
+}
+
 } // end namespace cbm
@@ -19,6 +19,7 @@ namespace cbm {
   Concrete implementations are
   - MonitorSinkFile: concrete sink for file output (in InfluxDB line format)
   - MonitorSinkInflux1: concrete sink for InfluxDB V1 output
+  - MonitorSinkPrometheus: concrete sink serving Prometheus scrapes
 */
 
 //-----------------------------------------------------------------------------
@@ -79,12 +80,14 @@ std::string MonitorSink::InfluxTags(const Metric& point) {
 
 //-----------------------------------------------------------------------------
 /*! \brief Return field string for a Metric `point` in InfluxDB line format
+  \param point    metric
+  \param buckets  include the full bucket list of Histogram fields
  */
 
 template <class... Ts> struct overloaded : Ts... { using Ts::operator()...; };
 template <class... Ts> overloaded(Ts...) -> overloaded<Ts...>;
 
-std::string MonitorSink::InfluxFields(const Metric& point) {
+std::string MonitorSink::InfluxFields(const Metric& point, bool buckets) {
   std::stringstream ss;
   ss.precision(16); // ensure full double precision
   for (auto& field : point.fFieldset) {
@@ -92,6 +95,10 @@ std::string MonitorSink::InfluxFields(const Metric& point) {
       ss << ",";
     auto& key = field.first;
     auto& val = field.second;
+    if (auto* hist = std::get_if<Histogram>(&val)) {
+      ss << InfluxHistogram(CleanString(key), *hist, buckets);
+      continue;
+    }
     ss << CleanString(key) << "=";
     // use overloaded visitor pattern as described in cppreference.com
     visit(overloaded{
@@ -118,23 +125,69 @@ std::string MonitorSink::InfluxFields(const Metric& point) {
               },
               [this, &ss](std::string_view arg) { // case string + string_view
                 ss << '"' << EscapeString(arg) << '"';
+              },
+              [](const Histogram&) { // case Histogram, handled above
               }},
           val);
   }
   return ss.str();
 }
 
+//-----------------------------------------------------------------------------
+/*! \brief Return field string for a Histogram in InfluxDB line format
+  \param key      field key, used as prefix of the derived field keys
+  \param hist     histogram
+  \param buckets  include the full bucket list
+
+  The histogram is represented by the fields `<key>_count`, `<key>_sum`,
+  `<key>_max`, `<key>_mean`, and the percentiles `<key>_p50`, `<key>_p90`,
+  `<key>_p99`, and `<key>_p999`. With `buckets`, the string field
+  `<key>_buckets` lists all non-empty buckets as `lower:count` pairs.
+ */
+
+std::string MonitorSink::InfluxHistogram(const std::string& key,
+                                         const Histogram& hist,
+                                         bool buckets) {
+  std::stringstream ss;
+  ss.precision(16); // ensure full double precision
+  ss << key << "_count=" << hist.Count() << "i";
+  if (hist.Count() == 0)
+    return ss.str();
+  ss << "," << key << "_sum=" << hist.Sum() << "i";
+  ss << "," << key << "_max=" << hist.Max() << "i";
+  ss << "," << key << "_mean=" << hist.Mean();
+  ss << "," << key << "_p50=" << hist.Percentile(0.5) << "i";
+  ss << "," << key << "_p90=" << hist.Percentile(0.9) << "i";
+  ss << "," << key << "_p99=" << hist.Percentile(0.99) << "i";
+  ss << "," << key << "_p999=" << hist.Percentile(0.999) << "i";
+  if (buckets) {
+    ss << "," << key << "_buckets=\"";
+    const auto& counts = hist.Buckets();
+    bool first = true;
+    for (size_t i = 0; i < counts.size(); i++) {
+      if (counts[i] == 0)
+        continue;
+      ss << (first ? "" : ",") << Histogram::BucketLower(i) << ":" << counts[i];
+      first = false;
+    }
+    ss << '"';
+  }
+  return ss.str();
+}
+
 //-----------------------------------------------------------------------------
 /*! \brief Return Metric `point` in InfluxDB line format
+  \param point    metric
+  \param buckets  include the full bucket list of Histogram fields
  */
 
-std::string MonitorSink::InfluxLine(const Metric& point) {
+std::string MonitorSink::InfluxLine(const Metric& point, bool buckets) {
   std::chrono::duration<long, std::nano> timestamp_ns =
       point.fTimestamp - std::chrono::system_clock::time_point();
 
   std::string res = point.fMeasurement;
   res += "," + InfluxTags(point);
-  res += " " + InfluxFields(point);
+  res += " " + InfluxFields(point, buckets);
   res += " " + std::to_string(timestamp_ns.count());
   return res;
 }
@@ -27,8 +27,11 @@ protected:
   std::string CleanString(const std::string& id);
   std::string EscapeString(std::string_view str);
   std::string InfluxTags(const Metric& point);
-  std::string InfluxFields(const Metric& point);
-  std::string InfluxLine(const Metric& point);
+  std::string InfluxFields(const Metric& point, bool buckets = false);
+  std::string InfluxHistogram(const std::string& key,
+                              const Histogram& hist,
+                              bool buckets);
+  std::string InfluxLine(const Metric& point, bool buckets = false);
 
   Monitor& fMonitor;       //!< back reference to Monitor
   std::string fSinkPath;   //!< path for output
@@ -47,12 +47,14 @@ MonitorSinkFile::MonitorSinkFile(Monitor& monitor, const std::string& path)
 
 //-----------------------------------------------------------------------------
 /*! \brief Process a vector of metrics
+
+  Histogram fields are written with their full bucket list.
  */
 
 void MonitorSinkFile::ProcessMetricVec(const std::vector<Metric>& metvec) {
   std::ostream& os = fpCout ? *fpCout : *fpOStream;
   for (auto& met : metvec)
-    os << InfluxLine(met) << "\n";
+    os << InfluxLine(met, true) << "\n";
   if (size(metvec) > 0)
     os.flush();
 }
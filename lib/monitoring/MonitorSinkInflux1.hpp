@@ -5,8 +5,11 @@
 #ifndef included_Cbm_MonitorSinkInflux1
 #define included_Cbm_MonitorSinkInflux1 1
 
+#include "InfluxWriter.hpp"
 #include "MonitorSink.hpp"
 
+#include <memory>
+
 namespace cbm {
 
 class MonitorSinkInflux1 : public MonitorSink {
@@ -17,12 +20,10 @@ public:
   virtual void ProcessHeartbeat();
 
 private:
-  void SendData(const std::string& msg);
-
-private:
-  std::string fHost; //!< server host name
-  std::string fPort; //!< port for InfluxDB
-  std::string fDB;   //!< target database
+  std::string fHost;                     //!< server host name
+  std::string fPort;                     //!< port for InfluxDB
+  std::string fDB;                       //!< target database
+  std::unique_ptr<InfluxWriter> fWriter; //!< asynchronous sender
 };
 
 } // end namespace cbm
@@ -9,24 +9,11 @@
 
 #include "fmt/format.h"
 
-// define needed for Boost 1.67 in Debian Buster to avoid a missing
-// boost::system::system_category() symbol. That's apparently default since
-// Boost 1.69, so Boost 1.71 (Ub focal) and 1.74 (Debian Bullseye work fine
-// without. See https://stackoverflow.com/questions/9723793/
-#define BOOST_ERROR_CODE_HEADER_ONLY
-#include <boost/asio/connect.hpp>
-#include <boost/asio/ip/tcp.hpp>
-#include <boost/beast/core.hpp>
-#include <boost/beast/http.hpp>
-#include <boost/beast/version.hpp>
-
 #include <cstdlib>
 #include <iostream>
 #include <regex>
 
 namespace cbm {
-using tcp = boost::asio::ip::tcp;     // from <boost/asio/ip/tcp.hpp>
-namespace http = boost::beast::http;  // from <boost/beast/http.hpp>
 using namespace std::string_literals; // for ""s
 
 // some constants
@@ -44,6 +31,15 @@ static const size_t kSendChunkSize = 2'000'000ull; // send chunk size
   - `sends`: number of HTTP post requests in last period
   - `bytes`: total number bytes written in last period
   - `sndtime`: total elapsed time spend in HTTP post requests (in s)
+  - `sndlat`: histogram of the HTTP post request latencies (in us)
+  - `dropped`: number of points dropped in last period
+  - `retries`: number of failed and repeated requests in last period
+  - `buffered`: number of compressed bytes waiting to be sent
+
+  The points are sent by an InfluxWriter, asynchronous to the Monitor event
+  loop, gzip compressed, and on a persistent connection. When the database
+  is slow or unreachable, the writer buffers a bounded amount of data and
+  drops the oldest points beyond.
 */
 
 //-----------------------------------------------------------------------------
@@ -92,6 +88,9 @@ MonitorSinkInflux2::MonitorSinkInflux2(Monitor& monitor,
           " no token given and CBM_INFLUX_TOKEN not defined");
     fToken = std::string(pchar);
   }
+  fWriter = std::make_unique<InfluxWriter>(
+      fSinkPath, fHost, fPort, "/api/v2/write?org=CBM&bucket="s + fBucket,
+      "Token "s + fToken);
 }
 
 //-----------------------------------------------------------------------------
@@ -100,19 +99,22 @@ MonitorSinkInflux2::MonitorSinkInflux2(Monitor& monitor,
 
 void MonitorSinkInflux2::ProcessMetricVec(const std::vector<Metric>& metvec) {
   std::string msg;
+  size_t npoint = 0;
 
   fStatNPoint += metvec.size();
   for (auto& met : metvec) {
     fStatNTag += met.fTagset.size();
     fStatNField += met.fFieldset.size();
     msg += InfluxLine(met) + "\n"s;
+    npoint += 1;
     if (msg.size() > kSendChunkSize) { // limit send chunk size
-      SendData(msg);
+      fWriter->Queue(std::move(msg), npoint);
       msg.clear();
+      npoint = 0;
     }
   }
   if (msg.size() > 0)
-    SendData(msg);
+    fWriter->Queue(std::move(msg), npoint);
 }
 
 //-----------------------------------------------------------------------------
@@ -120,6 +122,10 @@ void MonitorSinkInflux2::ProcessMetricVec(const std::vector<Metric>& metvec) {
  */
 
 void MonitorSinkInflux2::ProcessHeartbeat() {
+  InfluxWriter::Stats stats = fWriter->TakeStats();
+  fStatNSend += stats.fNSend;
+  fStatNByte += stats.fNByte;
+  fStatSndTime += stats.fSndTime;
   Monitor::Ref().QueueMetric("Monitor",                       // measurement
                              {{"host", fMonitor.HostName()}}, // no extra tags
                              {{"points", fStatNPoint},        // fields
@@ -127,7 +133,11 @@ void MonitorSinkInflux2::ProcessHeartbeat() {
                               {"fields", fStatNField},
                               {"sends", fStatNSend},
                               {"bytes", fStatNByte},
-                              {"sndtime", fStatSndTime}}); // 'time' not allowed
+                              {"sndtime", fStatSndTime}, // 'time' not allowed
+                              {"sndlat", std::move(stats.fSndLatency)},
+                              {"dropped", stats.fNDrop},
+                              {"retries", stats.fNRetry},
+                              {"buffered", stats.fNBuffered}});
   fStatNPoint = 0;
   fStatNTag = 0;
   fStatNField = 0;
@@ -136,113 +146,4 @@ void MonitorSinkInflux2::ProcessHeartbeat() {
   fStatSndTime = 0.;
 }
 
-//-----------------------------------------------------------------------------
-/*! \brief Send a set of points in line format to database
- */
-
-void MonitorSinkInflux2::SendData(const std::string& msg) {
-  try {
-    // start timer
-    auto tbeg = std::chrono::system_clock::now();
-
-    // The io_context is required for all I/O
-    boost::asio::io_context ioc;
-
-    // These objects perform our I/O
-    tcp::resolver resolver{ioc};
-    tcp::socket socket{ioc};
-
-    // Look up the domain name
-    auto const results = resolver.resolve(fHost, fPort);
-
-    // Make the connection on the IP address we get from a lookup
-    boost::asio::connect(socket, results.begin(), results.end());
-
-    // Set up an HTTP POST request message
-    std::string target = "/api/v2/write?org=CBM&bucket="s + fBucket;
-    int version = 11;
-    http::request<http::string_body> req{http::verb::post, target, version};
-    req.set(http::field::host, fHost);
-    req.set(http::field::authorization, "Token "s + fToken);
-    req.set(http::field::user_agent, "Monitor");
-    req.set(http::field::accept, "application/json");
-    req.set(http::field::content_type, "text/plain; charset=utf-8");
-    req.set(http::field::content_length, std::to_string(msg.size()));
-    req.body() = msg;
-
-    // Send the HTTP request to the remote host
-    http::write(socket, req);
-
-    // This buffer is used for reading and must be persisted
-    boost::beast::flat_buffer buffer;
-
-    // Declare a container to hold the response
-    http::response<http::string_body> res;
-
-    // Receive the HTTP response
-    http::read(socket, buffer, res);
-
-    // Check response
-    // Note on boost::beast::http::response:
-    //   result() does not return the HTTP status, one gets the reason phrase as
-    //   it is also returned by reason(). result_int() return the status as int.
-    // Note in InfluxDB V1:
-    //   returns a 204 -> "No Content" for successful completion
-    //   returns a 404 -> "Not Found" if data base not existing
-    //   returns a 422 -> "Unprocessable entity" if request is ill-formed
-    if (res.result_int() != 200 && res.result_int() != 204) { // allow 200 & 204
-      std::string efields = "";
-      for (auto const& field : res) {
-        efields += std::string(field.name_string());       // C++17 string_view
-        efields += "=" + std::string(field.value()) + ";"; // limitation, grrr
-      }
-      std::string ebody = res.body(); // get body, trim \r and trailing \n
-      ebody.erase(std::remove(ebody.begin(), ebody.end(), '\r'), ebody.end());
-      if (!ebody.empty() && ebody[ebody.size() - 1] == '\n')
-        ebody.erase(ebody.size() - 1);
-
-#if defined(CBMLOGERR1)
-      CBMLOGERR1("cid=__Monitor", "SendData-err")
-          << "sinkname=" << fSinkPath << ", HTTP status=" << res.result_int()
-          << " " << res.reason() << ", HTTP fields=" << efields
-          << ", HTTP body=" << ebody;
-#else
-      std::cerr << "MonitorSinkInflux2::SendData error: "
-                << "sinkname=" << fSinkPath
-                << ", HTTP status=" << res.result_int() << " " << res.reason()
-                << ", HTTP fields=" << efields << ", HTTP body=" << ebody
-                << "\n";
-#endif
-    }
-
-    // Gracefully close the socket
-    boost::system::error_code ec;
-    socket.shutdown(tcp::socket::shutdown_both, ec);
-
-    // not_connected happens sometimes
-    // so don't bother reporting it.
-    //
-    if (ec && ec != boost::system::errc::not_connected)
-      throw boost::system::system_error{ec};
-
-    // do stats
-    fStatNSend += 1;
-    fStatNByte += msg.size();
-    std::chrono::duration<double> dt = std::chrono::system_clock::now() - tbeg;
-    fStatSndTime += dt.count();
-
-    // If we get here then the connection is closed gracefully
-  } catch (std::exception const& e) {
-#if defined(CBMLOGERR1)
-    CBMLOGERR1("cid=__Monitor", "SendData-err")
-        << "sinkname=" << fSinkPath << ", error=" << e.what();
-#else
-    std::cerr << "MonitorSinkInflux2::SendData error: "
-              << "sinkname=" << fSinkPath << ", error=" << e.what() << "\n";
-#endif
-    return;
-  }
-  return;
-}
-
 } // end namespace cbm
@@ -5,8 +5,11 @@
 #ifndef included_Cbm_MonitorSinkInflux2
 #define included_Cbm_MonitorSinkInflux2 1
 
+#include "InfluxWriter.hpp"
 #include "MonitorSink.hpp"
 
+#include <memory>
+
 namespace cbm {
 class MonitorSinkInflux2 : public MonitorSink {
 public:
@@ -16,13 +19,11 @@ public:
   virtual void ProcessHeartbeat();
 
 private:
-  void SendData(const std::string& msg);
-
-private:
-  std::string fHost;   //!< server host name
-  std::string fPort;   //!< port for InfluxDB
-  std::string fBucket; //!< target bucket
-  std::string fToken;  //!< access token
+  std::string fHost;                     //!< server host name
+  std::string fPort;                     //!< port for InfluxDB
+  std::string fBucket;                   //!< target bucket
+  std::string fToken;                    //!< access token
+  std::unique_ptr<InfluxWriter> fWriter; //!< asynchronous sender
 };
 
 } // end namespace cbm
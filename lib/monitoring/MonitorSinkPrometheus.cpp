@@ -0,0 +1,373 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "MonitorSinkPrometheus.hpp"
+
+#include "Monitor.hpp"
+#include "System.hpp"
+
+#include "fmt/format.h"
+
+// see InfluxWriter.cpp
+#define BOOST_ERROR_CODE_HEADER_ONLY
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+
+#include <cctype>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <variant>
+
+namespace cbm {
+using tcp = boost::asio::ip::tcp;     // from <boost/asio/ip/tcp.hpp>
+namespace http = boost::beast::http;  // from <boost/beast/http.hpp>
+using namespace std::string_literals; // for ""s
+using namespace std::chrono_literals; // for s
+
+// some constants
+static const auto kIoTimeout = 10s; // read/write timeout of a scrape
+
+/*! \class MonitorSinkPrometheus
+  \brief Monitor sink - concrete sink serving metrics to Prometheus scrapes
+
+  Instead of pushing the metrics to a database, this sink keeps the latest
+  value of each field in memory and serves them on request from an embedded
+  HTTP endpoint in the Prometheus text exposition format. Nothing is sent
+  while nobody scrapes, and the text is only formatted on a scrape.
+
+  - the metric name is `<measurement>_<field>`, the tags become labels
+  - numeric and bool fields are exported as untyped samples, string fields
+    are skipped
+  - Histogram fields (which cover the values since the previous report) are
+    accumulated and exported as Prometheus histograms, with the upper bounds
+    of the non-empty buckets as `le` labels
+
+  The values are those of the last cycle of the Monitor event loop (see
+  Monitor::kELoopTimeout). Registered metrics are only reported when they
+  change, so series are kept for the lifetime of the sink.
+*/
+
+//-----------------------------------------------------------------------------
+// Server: the HTTP endpoint, run in a thread of its own
+
+class MonitorSinkPrometheus::Server {
+public:
+  Server(MonitorSinkPrometheus& sink,
+         const std::string& host,
+         const std::string& port)
+      : fSink(sink) {
+    tcp::resolver resolver(fIoc);
+    tcp::endpoint endpoint =
+        *resolver.resolve(host, port, tcp::resolver::passive).begin();
+    fAcceptor.open(endpoint.protocol());
+    fAcceptor.set_option(tcp::acceptor::reuse_address(true));
+    fAcceptor.bind(endpoint);
+    fAcceptor.listen();
+    fPort = fAcceptor.local_endpoint().port();
+    Accept();
+    fThread = std::thread([this]() {
+      cbm::system::set_thread_name("cbm:prometheus");
+      fIoc.run();
+    });
+  }
+
+  ~Server() {
+    fIoc.stop();
+    if (fThread.joinable())
+      fThread.join();
+  }
+
+  Server(const Server&) = delete;
+  Server& operator=(const Server&) = delete;
+
+  uint16_t Port() const { return fPort; }
+
+private:
+  // a connection of a scraper, possibly serving several requests
+  class Session : public std::enable_shared_from_this<Session> {
+  public:
+    Session(MonitorSinkPrometheus& sink, tcp::socket&& socket)
+        : fSink(sink), fStream(std::move(socket)) {}
+
+    void Read() {
+      fRequest = {};
+      fStream.expires_after(kIoTimeout);
+      http::async_read(fStream, fBuffer, fRequest,
+                       [self = shared_from_this()](
+                           boost::system::error_code ec, size_t) {
+                         if (!ec)
+                           self->Write();
+                       });
+    }
+
+  private:
+    void Write() {
+      fResponse = {};
+      fResponse.version(fRequest.version());
+      fResponse.keep_alive(fRequest.keep_alive());
+      fResponse.set(http::field::server, "flesnet");
+      if (fRequest.method() != http::verb::get &&
+          fRequest.method() != http::verb::head) {
+        fResponse.result(http::status::method_not_allowed);
+      } else if (fRequest.target() != "/metrics" &&
+                 fRequest.target() != "/") {
+        fResponse.result(http::status::not_found);
+      } else {
+        fResponse.result(http::status::ok);
+        fResponse.set(http::field::content_type,
+                      "text/plain; version=0.0.4; charset=utf-8");
+        fResponse.body() = fSink.Exposition();
+      }
+      fResponse.prepare_payload();
+      if (fRequest.method() == http::verb::head)
+        fResponse.body().clear(); // keeps the content length
+      fStream.expires_after(kIoTimeout);
+      http::async_write(fStream, fResponse,
+                        [self = shared_from_this()](
+                            boost::system::error_code ec, size_t) {
+                          if (ec)
+                            return;
+                          if (self->fResponse.need_eof()) {
+                            boost::system::error_code ignored;
+                            self->fStream.socket().shutdown(
+                                tcp::socket::shutdown_send, ignored);
+                            return;
+                          }
+                          self->Read();
+                        });
+    }
+
+    MonitorSinkPrometheus& fSink;
+    boost::beast::tcp_stream fStream;
+    boost::beast::flat_buffer fBuffer{};
+    http::request<http::string_body> fRequest{};
+    http::response<http::string_body> fResponse{};
+  };
+
+  void Accept() {
+    fAcceptor.async_accept(
+        [this](boost::system::error_code ec, tcp::socket socket) {
+          if (ec)
+            return;
+          std::make_shared<Session>(fSink, std::move(socket))->Read();
+          Accept();
+        });
+  }
+
+  MonitorSinkPrometheus& fSink;
+  boost::asio::io_context fIoc{};
+  tcp::acceptor fAcceptor{fIoc};
+  uint16_t fPort{0};
+  std::thread fThread{};
+};
+
+//-----------------------------------------------------------------------------
+/*! \brief Constructor
+  \param monitor back reference to Monitor
+  \param path endpoint as `[host:]port`
+  \throws std::runtime_error if the endpoint cannot be opened
+
+  Serve metrics on `http://host:port/metrics`. `host` is the address to
+  listen on (default `0.0.0.0`, i.e., all interfaces). With port `0`, a free
+  port is chosen, see Port().
+ */
+
+MonitorSinkPrometheus::MonitorSinkPrometheus(Monitor& monitor,
+                                             const std::string& path)
+    : MonitorSink(monitor, path) {
+  auto pos = path.rfind(':');
+  bool has_host = pos != std::string::npos;
+  std::string host = has_host ? path.substr(0, pos) : "0.0.0.0"s;
+  std::string port = has_host ? path.substr(pos + 1) : path;
+  if (port.empty())
+    throw std::runtime_error(fmt::format("MonitorSinkPrometheus::ctor:"
+                                         " no port in '{}'",
+                                         path));
+  try {
+    fServer = std::make_unique<Server>(*this, host, port);
+  } catch (const std::exception& e) {
+    throw std::runtime_error(fmt::format("MonitorSinkPrometheus::ctor:"
+                                         " cannot listen on '{}': {}",
+                                         path, e.what()));
+  }
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Destructor, stops the HTTP endpoint
+
+MonitorSinkPrometheus::~MonitorSinkPrometheus() { fServer.reset(); }
+
+//-----------------------------------------------------------------------------
+/*! \brief Process a vector of metrics
+
+  Only updates the in-memory state, the exposition is formatted on a scrape.
+ */
+
+void MonitorSinkPrometheus::ProcessMetricVec(
+    const std::vector<Metric>& metvec) {
+  std::lock_guard<std::mutex> lock(fMutex);
+  for (auto& met : metvec) {
+    std::string labels = Labels(met.fTagset);
+    auto& series = fSeriesMap[met.fMeasurement + "{" + labels + "}"];
+    if (series.fMeasurement.empty()) {
+      series.fMeasurement = met.fMeasurement;
+      series.fLabels = std::move(labels);
+    }
+    for (auto& [key, val] : met.fFieldset) {
+      if (auto* hist = std::get_if<Histogram>(&val)) {
+        auto it = series.fFieldMap.try_emplace(key, Histogram()).first;
+        if (auto* total = std::get_if<Histogram>(&it->second))
+          total->Merge(*hist);
+        else
+          it->second = *hist;
+      } else if (!std::holds_alternative<std::string>(val) &&
+                 !std::holds_alternative<std::string_view>(val)) {
+        series.fFieldMap.insert_or_assign(key, val);
+      }
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Process heartbeat (noop for Prometheus sink)
+ */
+
+void MonitorSinkPrometheus::ProcessHeartbeat() {}
+
+//-----------------------------------------------------------------------------
+/*! \brief Returns the current metrics in the Prometheus text format
+
+  The samples are grouped by metric name, as required by the format.
+ */
+
+std::string MonitorSinkPrometheus::Exposition() {
+  auto number = [](double val) {
+    if (std::isnan(val))
+      return "NaN"s;
+    if (std::isinf(val))
+      return val > 0 ? "+Inf"s : "-Inf"s;
+    return fmt::format("{}", val);
+  };
+  auto labelset = [](const std::string& labels, const std::string& extra) {
+    std::string all = labels;
+    all += all.empty() || extra.empty() ? "" : ",";
+    all += extra;
+    return all.empty() ? all : "{" + all + "}";
+  };
+
+  std::map<std::string, std::string> families;
+  std::lock_guard<std::mutex> lock(fMutex);
+  for (auto& [skey, series] : fSeriesMap) {
+    for (auto& [fkey, val] : series.fFieldMap) {
+      std::string name = MetricName(series.fMeasurement, fkey);
+      std::string& text = families[name];
+      if (auto* hist = std::get_if<Histogram>(&val)) {
+        if (text.empty())
+          text = "# TYPE " + name + " histogram\n";
+        uint64_t cumulative = 0;
+        const auto& counts = hist->Buckets();
+        for (size_t i = 0; i < counts.size(); i++) {
+          if (counts[i] == 0)
+            continue;
+          cumulative += counts[i];
+          text += fmt::format(
+              "{}_bucket{} {}\n", name,
+              labelset(series.fLabels,
+                       fmt::format("le=\"{}\"", Histogram::BucketUpper(i))),
+              cumulative);
+        }
+        text += fmt::format("{}_bucket{} {}\n", name,
+                            labelset(series.fLabels, "le=\"+Inf\""),
+                            hist->Count());
+        text += fmt::format("{}_sum{} {}\n", name,
+                            labelset(series.fLabels, ""), hist->Sum());
+        text += fmt::format("{}_count{} {}\n", name,
+                            labelset(series.fLabels, ""), hist->Count());
+        continue;
+      }
+      if (text.empty())
+        text = "# TYPE " + name + " untyped\n";
+      std::string value = std::visit(
+          [&number](auto&& arg) -> std::string {
+            using T = std::decay_t<decltype(arg)>;
+            if constexpr (std::is_same_v<T, bool>)
+              return arg ? "1" : "0";
+            else if constexpr (std::is_integral_v<T>)
+              return std::to_string(arg);
+            else if constexpr (std::is_floating_point_v<T>)
+              return number(arg);
+            else
+              return "NaN"; // strings are not stored
+          },
+          val);
+      text += name + labelset(series.fLabels, "") + " " + value + "\n";
+    }
+  }
+
+  std::string res;
+  for (auto& kv : families)
+    res += kv.second;
+  return res;
+}
+
+//-----------------------------------------------------------------------------
+//! \brief Returns the port of the HTTP endpoint
+
+uint16_t MonitorSinkPrometheus::Port() const { return fServer->Port(); }
+
+//-----------------------------------------------------------------------------
+/*! \brief Returns a valid Prometheus metric name for a field
+  \param measurement  measurement name
+  \param field        field name
+
+  Characters not allowed in metric names are replaced by '_'.
+ */
+
+std::string MonitorSinkPrometheus::MetricName(const std::string& measurement,
+                                              const std::string& field) {
+  std::string res = measurement + "_" + field;
+  for (auto& c : res) {
+    if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_' && c != ':')
+      c = '_';
+  }
+  if (std::isdigit(static_cast<unsigned char>(res.front())))
+    res.insert(0, "_");
+  return res;
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Returns the label set of a tag set, without braces
+
+  Characters not allowed in label names are replaced by '_', the values are
+  escaped.
+ */
+
+std::string MonitorSinkPrometheus::Labels(const MetricTagSet& tagset) {
+  std::string res;
+  for (auto& [key, val] : tagset) {
+    std::string name = key.empty() ? "_"s : key;
+    for (auto& c : name) {
+      if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_')
+        c = '_';
+    }
+    if (std::isdigit(static_cast<unsigned char>(name.front())))
+      name.insert(0, "_");
+    std::string value;
+    for (char c : val) {
+      if (c == '\\' || c == '"')
+        value += '\\';
+      if (c == '\n')
+        value += "\\n";
+      else
+        value += c;
+    }
+    res += res.empty() ? "" : ",";
+    res += name + "=\"" + value + "\"";
+  }
+  return res;
+}
+
+} // end namespace cbm
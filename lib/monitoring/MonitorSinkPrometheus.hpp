@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#ifndef included_Cbm_MonitorSinkPrometheus
+#define included_Cbm_MonitorSinkPrometheus 1
+
+#include "MonitorSink.hpp"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace cbm {
+
+class MonitorSinkPrometheus : public MonitorSink {
+public:
+  MonitorSinkPrometheus(Monitor& monitor, const std::string& path);
+  virtual ~MonitorSinkPrometheus();
+
+  virtual void ProcessMetricVec(const std::vector<Metric>& metvec);
+  virtual void ProcessHeartbeat();
+
+  std::string Exposition();
+  uint16_t Port() const;
+
+private:
+  struct Series {
+    std::string fMeasurement;                     //!< measurement name
+    std::string fLabels;                          //!< formatted label set
+    std::map<std::string, MetricField> fFieldMap; //!< latest field values
+  };
+  class Server; // defined in MonitorSinkPrometheus.cpp
+
+  static std::string MetricName(const std::string& measurement,
+                                const std::string& field);
+  static std::string Labels(const MetricTagSet& tagset);
+
+  std::map<std::string, Series> fSeriesMap{}; //!< series by measurement+tags
+  std::mutex fMutex{};                        //!< mutex for fSeriesMap
+  std::unique_ptr<Server> fServer;            //!< HTTP endpoint
+};
+
+} // end namespace cbm
+
+// #include "MonitorSinkPrometheus.ipp"
+
+#endif
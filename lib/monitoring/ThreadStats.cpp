@@ -0,0 +1,268 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#include "ThreadStats.hpp"
+
+#include <cstdlib>
+#include <dirent.h>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <unistd.h>
+#include <utility>
+
+namespace cbm {
+
+/*! \class ThreadStats
+  \brief Collector of the CPU usage and scheduling statistics of the named
+  threads of the process
+
+  Each call of Snapshot() reads the entries of all threads from
+  `/proc/self/task` and reports the measurement "thread_stats" with the tag
+  "thread" for each thread name except the name of the process (i.e. for
+  the threads named with cbm::system::set_thread_name() or
+  pthread_setname_np()). Threads with the same name are summed up. The
+  fields are the rates since the previous call
+  - `threads`: number of threads with the name
+  - `cpu_utilization`: CPU time per wall clock time (1 for a busy core)
+  - `run_queue_wait`: time runnable but waiting for a CPU per wall clock
+    time, e.g. when preempted by other threads
+  - `run_queue_latency_us`: mean wait for a CPU per scheduling (in us)
+  - `voluntary_switch_rate`: voluntary context switches per second
+  - `involuntary_switch_rate`: involuntary context switches per second
+
+  Threads that belong to a Linux resctrl control group other than the
+  default one (as reported in `cpu_resctrl_groups`) carry the additional
+  tag "resctrl_group", and the measurement "resctrl_group" with the tag
+  "group" is reported for each such group with the fields
+  - `llc_occupancy`: last-level cache occupancy in bytes
+  - `memory_bandwidth`: memory traffic in bytes per second
+  - `local_memory_bandwidth`: memory traffic to the local NUMA node in
+    bytes per second
+
+  summed up over the cache domains (`mon_data/mon_L3_*`). The fields are
+  zero where the hardware does not support the monitoring.
+
+  The CPU and wait times are taken from `schedstat`. Without it (kernels
+  built without CONFIG_SCHED_INFO), the CPU time is taken from `stat` with
+  clock tick resolution and the run queue fields are zero. Threads are
+  reported from the second call after their start.
+
+  The Monitor calls Snapshot() in each cycle once enabled with
+  Monitor::EnableThreadStats().
+*/
+
+namespace {
+// Read the first line of a file
+std::string ReadLine(const std::string& path) {
+  std::ifstream ifs(path);
+  std::string line;
+  std::getline(ifs, line);
+  return line;
+}
+
+// Read a counter value, zero if unavailable
+uint64_t ReadCounter(const std::string& path) {
+  std::ifstream ifs(path);
+  uint64_t value = 0;
+  if (!(ifs >> value))
+    return 0;
+  return value;
+}
+
+// Increase of a counter
+double Delta(uint64_t now, uint64_t last) {
+  return now > last ? static_cast<double>(now - last) : 0.;
+}
+} // namespace
+
+//-----------------------------------------------------------------------------
+/*! \brief Constructor
+  \param taskdir     directory with one subdirectory per thread
+  \param resctrldir  mount point of the resctrl file system
+ */
+
+ThreadStats::ThreadStats(const std::string& taskdir,
+                         const std::string& resctrldir)
+    : fTaskDir(taskdir), fResctrlDir(resctrldir) {
+  fProcessName = ReadLine(fTaskDir + "/../comm");
+  long ticks = sysconf(_SC_CLK_TCK);
+  fNsPerTick = 1e9 / static_cast<double>(ticks > 0 ? ticks : 100);
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Reads the current statistics of a thread
+  \param dir     directory of the thread
+  \param sample  filled with the statistics
+  \returns false if the thread has terminated
+ */
+
+bool ThreadStats::ReadSample(const std::string& dir, Sample& sample) const {
+  sample.fName = ReadLine(dir + "/comm");
+  if (sample.fName.empty())
+    return false;
+
+  std::ifstream schedstat(dir + "/schedstat");
+  if (!(schedstat >> sample.fRunNs >> sample.fWaitNs >> sample.fTimeslices)) {
+    // fall back to utime + stime, the fields 14 and 15 of stat
+    std::string stat = ReadLine(dir + "/stat");
+    auto pos = stat.rfind(')');
+    if (pos == std::string::npos)
+      return false;
+    std::istringstream iss(stat.substr(pos + 1));
+    std::string field;
+    uint64_t utime = 0;
+    uint64_t stime = 0;
+    for (int i = 3; i < 14; ++i)
+      iss >> field;
+    if (!(iss >> utime >> stime))
+      return false;
+    sample.fRunNs = static_cast<uint64_t>(
+        static_cast<double>(utime + stime) * fNsPerTick);
+  }
+
+  std::ifstream status(dir + "/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.rfind("voluntary_ctxt_switches:", 0) == 0)
+      sample.fVoluntary = std::strtoull(line.c_str() + 24, nullptr, 10);
+    else if (line.rfind("nonvoluntary_ctxt_switches:", 0) == 0)
+      sample.fInvoluntary = std::strtoull(line.c_str() + 27, nullptr, 10);
+  }
+
+  // "res:/" for the default group, "res:<name>" otherwise
+  std::string groups = ReadLine(dir + "/cpu_resctrl_groups");
+  if (groups.rfind("res:", 0) == 0 && groups.size() > 4 && groups[4] != '/')
+    sample.fGroup = groups.substr(4);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Reads the current monitoring values of a resctrl group
+  \param group   name of the group
+  \param sample  filled with the values summed over the cache domains
+  \returns false if the group has no monitoring data
+ */
+
+bool ThreadStats::ReadGroup(const std::string& group,
+                            GroupSample& sample) const {
+  std::string mondir = fResctrlDir + "/" + group + "/mon_data";
+  DIR* dir = opendir(mondir.c_str());
+  if (dir == nullptr)
+    return false;
+  bool found = false;
+  while (dirent* entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    if (name.rfind("mon_L3_", 0) != 0)
+      continue;
+    std::string domain = mondir + "/" + name;
+    sample.fLlcOccupancy += ReadCounter(domain + "/llc_occupancy");
+    sample.fTotalBytes += ReadCounter(domain + "/mbm_total_bytes");
+    sample.fLocalBytes += ReadCounter(domain + "/mbm_local_bytes");
+    found = true;
+  }
+  closedir(dir);
+  return found;
+}
+
+//-----------------------------------------------------------------------------
+/*! \brief Appends the metrics of the named threads since the previous call
+  \param metvec  metric list to append to
+ */
+
+void ThreadStats::Snapshot(std::vector<Metric>& metvec) {
+  auto now = clock::now();
+  double seconds = std::chrono::duration<double>(now - fLastTime).count();
+
+  struct Sum {
+    uint64_t fThreads{0};
+    double fRunNs{0.};
+    double fWaitNs{0.};
+    double fTimeslices{0.};
+    double fVoluntary{0.};
+    double fInvoluntary{0.};
+  };
+  // by thread name and resctrl group
+  std::map<std::pair<std::string, std::string>, Sum> sums;
+  std::unordered_map<int, Sample> current;
+
+  DIR* dir = opendir(fTaskDir.c_str());
+  if (dir == nullptr)
+    return;
+  while (dirent* entry = readdir(dir)) {
+    if (entry->d_name[0] < '0' || entry->d_name[0] > '9')
+      continue;
+    int tid = std::atoi(entry->d_name);
+    Sample sample;
+    if (!ReadSample(fTaskDir + "/" + entry->d_name, sample) ||
+        sample.fName == fProcessName)
+      continue;
+    auto last = fLast.find(tid);
+    if (last != fLast.end() && last->second.fName == sample.fName) {
+      const Sample& prev = last->second;
+      Sum& sum = sums[{sample.fName, sample.fGroup}];
+      ++sum.fThreads;
+      sum.fRunNs += Delta(sample.fRunNs, prev.fRunNs);
+      sum.fWaitNs += Delta(sample.fWaitNs, prev.fWaitNs);
+      sum.fTimeslices += Delta(sample.fTimeslices, prev.fTimeslices);
+      sum.fVoluntary += Delta(sample.fVoluntary, prev.fVoluntary);
+      sum.fInvoluntary += Delta(sample.fInvoluntary, prev.fInvoluntary);
+    }
+    current.emplace(tid, std::move(sample));
+  }
+  closedir(dir);
+
+  std::unordered_map<std::string, GroupSample> groups;
+  for (const auto& [tid, sample] : current) {
+    if (!sample.fGroup.empty() && groups.count(sample.fGroup) == 0) {
+      GroupSample group;
+      if (ReadGroup(sample.fGroup, group))
+        groups.emplace(sample.fGroup, group);
+    }
+  }
+
+  fLast.swap(current);
+  fLastGroups.swap(groups);
+  fLastTime = now;
+  if (sums.empty() || seconds <= 0.)
+    return;
+
+  auto timestamp = std::chrono::system_clock::now();
+  double wall_ns = seconds * 1e9;
+  for (const auto& [key, sum] : sums) {
+    const auto& [name, group] = key;
+    double latency_us =
+        sum.fTimeslices > 0. ? sum.fWaitNs / sum.fTimeslices / 1e3 : 0.;
+    MetricTagSet tagset{{"thread", name}};
+    if (!group.empty())
+      tagset.emplace_back("resctrl_group", group);
+    metvec.emplace_back(
+        "thread_stats", std::move(tagset),
+        MetricFieldSet{{"threads", sum.fThreads},
+                       {"cpu_utilization", sum.fRunNs / wall_ns},
+                       {"run_queue_wait", sum.fWaitNs / wall_ns},
+                       {"run_queue_latency_us", latency_us},
+                       {"voluntary_switch_rate", sum.fVoluntary / seconds},
+                       {"involuntary_switch_rate", sum.fInvoluntary / seconds}},
+        timestamp);
+  }
+
+  // groups holds the previous samples after the swap
+  for (const auto& [group, sample] : fLastGroups) {
+    auto last = groups.find(group);
+    if (last == groups.end())
+      continue;
+    const GroupSample& prev = last->second;
+    metvec.emplace_back(
+        "resctrl_group", MetricTagSet{{"group", group}},
+        MetricFieldSet{
+            {"llc_occupancy", sample.fLlcOccupancy},
+            {"memory_bandwidth",
+             Delta(sample.fTotalBytes, prev.fTotalBytes) / seconds},
+            {"local_memory_bandwidth",
+             Delta(sample.fLocalBytes, prev.fLocalBytes) / seconds}},
+        timestamp);
+  }
+}
+
+} // end namespace cbm
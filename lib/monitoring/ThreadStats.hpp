@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+
+#ifndef included_Cbm_ThreadStats
+#define included_Cbm_ThreadStats 1
+
+#include "Metric.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cbm {
+
+class ThreadStats {
+public:
+  explicit ThreadStats(const std::string& taskdir = "/proc/self/task",
+                       const std::string& resctrldir = "/sys/fs/resctrl");
+
+  ThreadStats(const ThreadStats&) = delete;
+  ThreadStats& operator=(const ThreadStats&) = delete;
+
+  void Snapshot(std::vector<Metric>& metvec);
+
+private:
+  using clock = std::chrono::steady_clock;
+
+  struct Sample {
+    std::string fName;        //!< thread name
+    uint64_t fRunNs{0};       //!< time spent on the CPU
+    uint64_t fWaitNs{0};      //!< time spent runnable on a run queue
+    uint64_t fTimeslices{0};  //!< number of times run on a CPU
+    uint64_t fVoluntary{0};   //!< voluntary context switches
+    uint64_t fInvoluntary{0}; //!< involuntary context switches
+    std::string fGroup;       //!< resctrl group (empty: default group)
+  };
+
+  struct GroupSample {
+    uint64_t fLlcOccupancy{0}; //!< last-level cache occupancy in bytes
+    uint64_t fTotalBytes{0};   //!< memory traffic counter
+    uint64_t fLocalBytes{0};   //!< local NUMA node memory traffic counter
+  };
+
+  bool ReadSample(const std::string& dir, Sample& sample) const;
+  bool ReadGroup(const std::string& group, GroupSample& sample) const;
+
+  std::string fTaskDir;                    //!< directory of the thread entries
+  std::string fResctrlDir;                 //!< resctrl mount point
+  std::string fProcessName;                //!< name of the main thread
+  double fNsPerTick;                       //!< duration of a clock tick
+  std::unordered_map<int, Sample> fLast{}; //!< previous samples by thread id
+  std::unordered_map<std::string, GroupSample> fLastGroups{}; //!< by group
+  clock::time_point fLastTime{};           //!< time of the previous samples
+};
+
+} // end namespace cbm
+
+#endif
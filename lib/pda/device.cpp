@@ -12,6 +12,7 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <iostream>
 
 using namespace std;
@@ -87,4 +88,18 @@ size_t device::max_payload_size() {
   return (0);
 }
 
+int device::numa_node() {
+  char path[64];
+  snprintf(path, sizeof(path),
+           "/sys/bus/pci/devices/%04x:%02x:%02x.%x/numa_node",
+           static_cast<unsigned>(domain()), static_cast<unsigned>(bus()),
+           static_cast<unsigned>(slot()), static_cast<unsigned>(func()));
+  ifstream ifs(path);
+  int node = -1;
+  if (!(ifs >> node) || node < 0) {
+    return (-1);
+  }
+  return (node);
+}
+
 } // namespace pda
@@ -53,6 +53,12 @@ public:
    **/
   size_t max_payload_size();
 
+  /**
+   * NUMA node the device is attached to (from sysfs)
+   * @return int NUMA node, -1 if unknown
+   **/
+  int numa_node();
+
   /**
    * PCI-Device
    * @return PCI-Device-Pointer
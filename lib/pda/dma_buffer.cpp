@@ -63,7 +63,8 @@ std::string dma_buffer::print_buffer_info() {
      << "physical size = " << (m_size >> 20) << " MByte, " << std::endl
      << "  end address = "
      << static_cast<void*>(static_cast<uint8_t*>(m_mem) + m_size - 1) << ", "
-     << "num SG entries = " << m_sglist.size() << std::endl
+     << "num SG entries = " << m_sglist.size() << " (coalesced from "
+     << m_raw_sg_entries << ")" << std::endl
      << "SG entries (max. 5):" << std::endl;
   for (size_t i = 0; i < 5 && i < m_sglist.size(); ++i) {
     ss << "entry " << i << " start: " << m_sglist.at(i).pointer << " end: "
@@ -94,8 +95,20 @@ void dma_buffer::connect() {
   if (DMABuffer_getSGList(m_buffer, &sglist) != PDA_SUCCESS) {
     throw PdaException("DMA_BUFFER_FAULT_SGLIST");
   }
-  sg_entry entry{};
+  // coalesce physically contiguous chunks (e.g., the pages of a huge page)
+  m_sglist.clear();
+  m_raw_sg_entries = 0;
   for (DMABuffer_SGNode* sg = sglist; sg != nullptr; sg = sg->next) {
+    ++m_raw_sg_entries;
+    if (!m_sglist.empty()) {
+      sg_entry& last = m_sglist.back();
+      if (static_cast<uint8_t*>(last.pointer) + last.length ==
+          static_cast<uint8_t*>(sg->d_pointer)) {
+        last.length += sg->length;
+        continue;
+      }
+    }
+    sg_entry entry{};
     entry.pointer = sg->d_pointer;
     entry.length = sg->length;
     m_sglist.push_back(entry);
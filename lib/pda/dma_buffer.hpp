@@ -70,11 +70,19 @@ public:
 
   /**
    * return SG list
+   * Physically contiguous entries are coalesced, so a buffer backed by
+   * huge pages results in one entry per huge page or less.
    * @return verctor of scatter gather list entries
    **/
-  std::vector<sg_entry> sg_list() { return m_sglist; }
+  const std::vector<sg_entry>& sg_list() const { return m_sglist; }
 
-  size_t num_sg_entries() { return m_sglist.size(); };
+  size_t num_sg_entries() const { return m_sglist.size(); };
+
+  /**
+   * Number of SG entries as reported by PDA (before coalescing)
+   * @return number of pinned memory chunks
+   **/
+  size_t num_raw_sg_entries() const { return m_raw_sg_entries; }
 
   std::string print_buffer_info();
 
@@ -89,5 +97,6 @@ private:
   void* m_mem = nullptr;
   size_t m_size = 0;
   std::vector<sg_entry> m_sglist;
+  size_t m_raw_sg_entries = 0;
 };
 } // namespace pda
@@ -0,0 +1,130 @@
+#ifndef SHM_IPC_ITEMCOMPLETIONBATCH_HPP
+#define SHM_IPC_ITEMCOMPLETIONBATCH_HPP
+
+#include "ItemWorkerProtocol.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * A batch of item completions sent from the distributor to the producer.
+ *
+ * The batch is range-encoded: all items with an ID smaller than
+ * completed_up_to have been completed, in addition to the out-of-order items
+ * listed in completed. This requires the producer to use monotonically
+ * increasing item IDs.
+ */
+struct ItemCompletionBatch {
+  ItemID completed_up_to = 0;
+  std::vector<ItemID> completed;
+
+  // Encode as a sequence of native-endian item IDs, the first one being
+  // completed_up_to
+  [[nodiscard]] std::string serialize() const {
+    std::string message((1 + completed.size()) * sizeof(ItemID), '\0');
+    std::memcpy(message.data(), &completed_up_to, sizeof(ItemID));
+    if (!completed.empty()) {
+      std::memcpy(message.data() + sizeof(ItemID), completed.data(),
+                  completed.size() * sizeof(ItemID));
+    }
+    return message;
+  }
+
+  void deserialize(const void* data, size_t size) {
+    if (size < sizeof(ItemID) || size % sizeof(ItemID) != 0) {
+      throw std::invalid_argument("Invalid completion batch message");
+    }
+    const auto* ids = static_cast<const char*>(data);
+    std::memcpy(&completed_up_to, ids, sizeof(ItemID));
+    completed.resize(size / sizeof(ItemID) - 1);
+    if (!completed.empty()) {
+      std::memcpy(completed.data(), ids + sizeof(ItemID),
+                  completed.size() * sizeof(ItemID));
+    }
+  }
+};
+
+/**
+ * The ItemCompletionCoalescer collects item completions on the distributor
+ * side and combines them into ItemCompletionBatch objects. A batch is due if
+ * the number of pending completions or the age of the oldest one exceeds the
+ * given thresholds.
+ */
+class ItemCompletionCoalescer {
+public:
+  ItemCompletionCoalescer(size_t max_count,
+                          std::chrono::steady_clock::duration max_delay)
+      : max_count_(max_count), max_delay_(max_delay) {}
+
+  // Register a new item received from the producer
+  void add_item(ItemID id) {
+    in_flight_.emplace(id, std::chrono::steady_clock::now());
+    next_id_ = std::max(next_id_, id + 1);
+  }
+
+  // Return the time since the arrival of an in-flight item
+  [[nodiscard]] std::chrono::steady_clock::duration age(ItemID id) const {
+    auto it = in_flight_.find(id);
+    if (it == in_flight_.end()) {
+      return {};
+    }
+    return std::chrono::steady_clock::now() - it->second;
+  }
+
+  // Register the completion of an item, return the time since its arrival
+  std::chrono::steady_clock::duration complete(ItemID id) {
+    auto it = in_flight_.find(id);
+    if (it == in_flight_.end()) {
+      throw std::invalid_argument("Invalid item completion: " +
+                                  std::to_string(id));
+    }
+    const auto now = std::chrono::steady_clock::now();
+    const auto turnaround = now - it->second;
+    in_flight_.erase(it);
+    if (pending_.empty()) {
+      first_pending_time_ = now;
+    }
+    pending_.push_back(id);
+    return turnaround;
+  }
+
+  [[nodiscard]] bool empty() const { return pending_.empty(); }
+
+  [[nodiscard]] bool
+  is_due(std::chrono::steady_clock::time_point now) const {
+    return !pending_.empty() && (pending_.size() >= max_count_ ||
+                                 first_pending_time_ + max_delay_ <= now);
+  }
+
+  // Move all pending completions to a batch
+  void flush(ItemCompletionBatch& batch) {
+    const ItemID up_to =
+        in_flight_.empty() ? next_id_ : in_flight_.begin()->first;
+    completed_up_to_ = std::max(completed_up_to_, up_to);
+    batch.completed_up_to = completed_up_to_;
+    batch.completed.clear();
+    for (ItemID id : pending_) {
+      if (id >= completed_up_to_) {
+        batch.completed.push_back(id);
+      }
+    }
+    std::sort(batch.completed.begin(), batch.completed.end());
+    pending_.clear();
+  }
+
+private:
+  const size_t max_count_;
+  const std::chrono::steady_clock::duration max_delay_;
+  std::map<ItemID, std::chrono::steady_clock::time_point> in_flight_;
+  std::vector<ItemID> pending_;
+  std::chrono::steady_clock::time_point first_pending_time_;
+  ItemID next_id_ = 0;
+  ItemID completed_up_to_ = 0;
+};
+
+#endif
@@ -1,15 +1,243 @@
 #include "ItemDistributor.hpp"
+#include "ItemDistributorWorker.hpp"
+#include "log.hpp"
 
-#include <memory>
-#include <set>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <exception>
 #include <stdexcept>
+#include <thread>
+
+/**
+ * A shard of a sharded ItemDistributor, running an ItemDistributorShard on
+ * its own thread. It receives the items ("I") and the messages of its
+ * workers ("W") from the distributor and returns the messages to its
+ * workers ("W") and the IDs of the items completed by them ("C").
+ */
+class ItemDistributor::ShardThread {
+public:
+  ShardThread(zmq::context_t& context,
+              const std::string& address,
+              size_t deadline_horizon,
+              cbm::MetricTagSet tagset)
+      : socket_(context, zmq::socket_type::pair),
+        shard_(
+            [this](zmq::multipart_t&& message) {
+              message.pushstr("W");
+              message.send(socket_);
+            },
+            deadline_horizon,
+            std::move(tagset)) {
+    socket_.set(zmq::sockopt::linger, 0);
+    socket_.connect(address);
+  }
+
+  // ShardThread is non-copyable
+  ShardThread(const ShardThread& other) = delete;
+  ShardThread& operator=(const ShardThread& other) = delete;
+  ShardThread(ShardThread&& other) = delete;
+  ShardThread& operator=(ShardThread&& other) = delete;
+
+  ~ShardThread() { join(); }
+
+  void start(std::chrono::milliseconds status_interval) {
+    status_interval_ = status_interval;
+    thread_ = std::thread([this] { run(); });
+  }
+
+  void stop() { stopped_ = true; }
+
+  void join() {
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+  // Number of items outstanding at or queued for the workers of the shard
+  [[nodiscard]] size_t num_pending() const { return pending_; }
+
+private:
+  void run() {
+    zmq::active_poller_t poller;
+    poller.add(socket_, zmq::event_flags::pollin,
+               [&](zmq::event_flags /*e*/) { on_distributor_pollin(); });
+    while (!stopped_) {
+      poller.wait(distributor_poll_timeout);
+      shard_.send_heartbeats();
+      shard_.report_workers(status_interval_);
+      send_completions();
+      pending_ = shard_.num_pending();
+    }
+  }
+
+  void on_distributor_pollin() {
+    zmq::multipart_t message(socket_);
+    const std::string type = message.popstr();
+    if (type == "I") {
+      ItemID id = std::stoull(message.popstr());
+      std::string payload;
+      if (!message.empty()) {
+        payload = message.popstr();
+      }
+      shard_.distribute(id, std::move(payload));
+    } else {
+      assert(type == "W");
+      shard_.on_worker_message(message);
+    }
+    send_completions();
+  }
+
+  // Pass the items completed by the workers of the shard on as an array of
+  // native-endian item IDs
+  void send_completions() {
+    ItemID id;
+    while (shard_.try_pop_completion(&id)) {
+      completed_.push_back(id);
+    }
+    if (completed_.empty()) {
+      return;
+    }
+    zmq::multipart_t message("C");
+    message.addmem(completed_.data(), completed_.size() * sizeof(ItemID));
+    message.send(socket_);
+    completed_.clear();
+  }
+
+  zmq::socket_t socket_;
+  ItemDistributorShard shard_;
+  std::vector<ItemID> completed_;
+  std::chrono::milliseconds status_interval_{1000};
+  std::atomic<bool> stopped_{false};
+  std::atomic<size_t> pending_{0};
+  std::thread thread_;
+};
+
+ItemDistributor::ItemDistributor(zmq::context_t& context,
+                                 const std::string& producer_address,
+                                 const std::string& worker_address,
+                                 size_t deadline_horizon,
+                                 size_t num_shards)
+    : generator_socket_(context, zmq::socket_type::pair),
+      worker_socket_(context, zmq::socket_type::router) {
+  generator_socket_.bind(producer_address);
+  generator_socket_.set(zmq::sockopt::linger, 0);
+  worker_socket_.set(zmq::sockopt::router_mandatory, 1);
+  worker_socket_.set(zmq::sockopt::router_notify, ZMQ_NOTIFY_DISCONNECT);
+  worker_socket_.bind(worker_address);
+  worker_socket_.set(zmq::sockopt::linger, 0);
+  if (auto* monitor = cbm::Monitor::Ptr()) {
+    turnaround_metric_ = monitor->RegisterHistogram(
+        "item_distributor",
+        {{"host", monitor->HostName()}, {"producer", producer_address}},
+        "turnaround_ns");
+    dispatch_metric_ = monitor->RegisterHistogram(
+        "item_distributor",
+        {{"host", monitor->HostName()}, {"producer", producer_address}},
+        "dispatch_ns");
+    tagset_ = {{"host", monitor->HostName()}, {"producer", producer_address}};
+  }
+
+  if (num_shards <= 1) {
+    shard_ = std::make_unique<ItemDistributorShard>(
+        [this](zmq::multipart_t&& message) {
+          send_worker(std::move(message));
+        },
+        deadline_horizon, tagset_);
+    return;
+  }
+  const std::string address_prefix =
+      "inproc://item_distributor_" +
+      std::to_string(reinterpret_cast<uintptr_t>(this)) + "_shard";
+  for (size_t k = 0; k < num_shards; ++k) {
+    const std::string address = address_prefix + std::to_string(k);
+    shard_sockets_.emplace_back(context, zmq::socket_type::pair);
+    shard_sockets_.back().set(zmq::sockopt::linger, 0);
+    shard_sockets_.back().bind(address);
+    shards_.push_back(std::make_unique<ShardThread>(context, address,
+                                                    deadline_horizon, tagset_));
+  }
+}
+
+ItemDistributor::~ItemDistributor() = default;
+
+void ItemDistributor::operator()() {
+  zmq::active_poller_t poller;
+  poller.add(generator_socket_, zmq::event_flags::pollin,
+             [&](zmq::event_flags /*e*/) { on_generator_pollin(); });
+  poller.add(worker_socket_, zmq::event_flags::pollin,
+             [&](zmq::event_flags /*e*/) { on_worker_pollin(); });
+  for (size_t k = 0; k < shard_sockets_.size(); ++k) {
+    poller.add(shard_sockets_[k], zmq::event_flags::pollin,
+               [this, k](zmq::event_flags /*e*/) { on_shard_pollin(k); });
+  }
+  for (auto& shard : shards_) {
+    shard->start(status_interval_);
+  }
+
+  while (!stopped_) {
+    poller.wait(completions_.empty() ? distributor_poll_timeout
+                                     : distributor_completion_flush_interval);
+    send_pending_completions();
+    if (shard_) {
+      shard_->send_heartbeats();
+      shard_->report_workers(status_interval_);
+    }
+    report_load();
+  }
+
+  for (auto& shard : shards_) {
+    shard->stop();
+  }
+  for (auto& shard : shards_) {
+    shard->join();
+  }
+}
+
+// Pass the number of pending items to the load observer once it is due
+void ItemDistributor::report_load() {
+  if (!load_observer_) {
+    return;
+  }
+  const auto now = std::chrono::steady_clock::now();
+  if (now < next_load_time_) {
+    return;
+  }
+  next_load_time_ = now + load_interval_;
+  size_t pending = shard_ ? shard_->num_pending() : 0;
+  for (const auto& shard : shards_) {
+    pending += shard->num_pending();
+  }
+  load_observer_(pending);
+}
+
+// Collect completions and send them to the producer once a batch is due
+void ItemDistributor::send_pending_completions() {
+  ItemID item;
+  while (shard_ && shard_->try_pop_completion(&item)) {
+    complete(item);
+  }
+  if (completions_.is_due(std::chrono::steady_clock::now())) {
+    completions_.flush(completion_batch_);
+    generator_socket_.send(zmq::buffer(completion_batch_.serialize()));
+  }
+}
+
+void ItemDistributor::complete(ItemID id) {
+  turnaround_metric_.Record(static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          completions_.complete(id))
+          .count()));
+}
 
 // Handle incoming message (work item) from the generator
 void ItemDistributor::on_generator_pollin() {
   zmq::multipart_t message(generator_socket_);
 
   // Receive item ID
-  ItemID id = std::stoull(message.popstr());
+  std::string id_string = message.popstr();
+  ItemID id = std::stoull(id_string);
 
   // Receive optional item payload
   std::string payload;
@@ -17,52 +245,22 @@ void ItemDistributor::on_generator_pollin() {
     payload = message.popstr();
   }
 
-  auto new_item = std::make_shared<Item>(&completed_items_, id, payload);
-
-  // Distribute the new work item.
-  // If a group_id is set, send only once per group.
-  std::set<size_t> completed_groups;
-  for (auto& [identity, worker] : workers_) {
-    if (worker->group_id() != 0 &&
-        completed_groups.find(worker->group_id()) != completed_groups.end()) {
-      // This group has already been served, skip it
-      continue;
-    }
-    try {
-      if (worker->wants(new_item->id())) {
-        if (worker->queue_policy() == WorkerQueuePolicy::PrebufferOne) {
-          worker->clear_queue();
-        }
-        if (worker->is_idle()) {
-          // The worker is idle, send the item immediately
-          if (worker->group_id() != 0) {
-            completed_groups.insert(worker->group_id());
-            // As we can send the item immediately, delete this work item from
-            // the queues of other (previous) workers with the same group_id
-            for (auto& [identity, other_worker] : workers_) {
-              if (other_worker == worker) {
-                break;
-              }
-              if (other_worker->group_id() == worker->group_id()) {
-                other_worker->delete_from_queue(new_item->id());
-              }
-            }
-          }
-          worker->add_outstanding(new_item);
-          send_worker_work_item(identity, *new_item);
-        } else {
-          // The worker is busy, enqueue the item
-          if (worker->queue_policy() != WorkerQueuePolicy::Skip) {
-            worker->push_queue(new_item);
-          }
-        }
+  // Distribute the new work item
+  completions_.add_item(id);
+  if (shard_) {
+    shard_->distribute(id, std::move(payload));
+  } else {
+    shard_completions_[id] = shard_sockets_.size();
+    for (auto& socket : shard_sockets_) {
+      zmq::multipart_t item("I");
+      item.addstr(id_string);
+      if (!payload.empty()) {
+        item.addstr(payload);
       }
-    } catch (std::exception& e) {
-      L_(error) << e.what();
-      workers_.erase(identity);
+      item.send(socket);
     }
   }
-  new_item = nullptr;
+
   // A pending completion could occur here if this item is not sent to any
   // worker, so...
   send_pending_completions();
@@ -75,73 +273,108 @@ void ItemDistributor::on_worker_pollin() {
   assert(!message.at(0).empty()); // for ROUTER sockets
   assert(message.at(1).empty());  //
 
-  std::string identity = message.peekstr(0);
+  if (shard_) {
+    shard_->on_worker_message(message);
+    send_pending_completions();
+    return;
+  }
 
+  const size_t shard = shard_of(message);
   if (message.size() == 2) {
-    // Handle ZMQ worker disconnect notification
-    if (workers_.count(identity) != 0) {
-      L_(info) << "worker disconnected: "
-               << workers_.at(identity)->description();
-    }
-    if (workers_.erase(identity) == 0) {
-      // This could happen if a misbehaving worker did not send a REGISTER
-      // message
-      L_(error) << "disconnect from unknown worker";
+    // The worker has disconnected
+    worker_shards_.erase(message.peekstr(0));
+  }
+  message.pushstr("W");
+  message.send(shard_sockets_[shard]);
+}
+
+// Handle incoming message from a shard thread
+void ItemDistributor::on_shard_pollin(size_t shard) {
+  zmq::multipart_t message(shard_sockets_[shard]);
+  const std::string type = message.popstr();
+  if (type == "W") {
+    send_worker(std::move(message));
+    return;
+  }
+  assert(type == "C");
+  const zmq::message_t ids = message.pop();
+  const auto* data = static_cast<const char*>(ids.data());
+  for (size_t i = 0; i < ids.size() / sizeof(ItemID); ++i) {
+    ItemID id;
+    std::memcpy(&id, data + i * sizeof(ItemID), sizeof(ItemID));
+    auto it = shard_completions_.find(id);
+    if (it != shard_completions_.end() && --it->second == 0) {
+      shard_completions_.erase(it);
+      complete(id);
     }
-  } else {
+  }
+  send_pending_completions();
+}
+
+// Select the shard serving the worker that sent a message. A registering
+// worker is assigned by its pool or group, if any, so that these are served
+// by a single shard, and by its identity otherwise.
+size_t ItemDistributor::shard_of(const zmq::multipart_t& message) {
+  const std::string identity = message.peekstr(0);
+  const std::string body = message.size() > 2 ? message.peekstr(2) : "";
+  if (body.rfind("REGISTER", 0) == 0) {
+    std::string key = identity;
     try {
-      // Handle general message from a worker
-      std::string message_string = message.peekstr(2);
-      if (message_string.rfind("REGISTER ", 0) == 0) {
-        // Handle new worker registration
-        auto worker = std::make_unique<ItemDistributorWorker>(message_string);
-        workers_[identity] = std::move(worker);
-        L_(info) << "worker connected: "
-                 << workers_.at(identity)->description();
-      } else if (message_string.rfind("COMPLETE ", 0) == 0) {
-        // Handle worker completion message
-        auto& worker = workers_.at(identity);
-        std::string command;
-        ItemID id;
-        std::stringstream s(message_string);
-        s >> command >> id;
-        if (s.fail()) {
-          throw std::invalid_argument("Invalid completion message");
-        }
-        // Find the corresponding outstanding item object and delete it
-        worker->delete_outstanding(id);
-        // Send next item if available
-        if (!worker->queue_empty()) {
-          auto item = worker->pop_queue();
-          if (worker->group_id() != 0) {
-            // Delete this work item from the queues of other workers with the
-            // same group_id
-            for (auto& [identity, other_worker] : workers_) {
-              if (worker != other_worker &&
-                  other_worker->group_id() == worker->group_id()) {
-                other_worker->delete_from_queue(item->id());
-              }
-            }
-          }
-          worker->add_outstanding(item);
-          send_worker_work_item(identity, *item);
-        } else {
-          worker->reset_heartbeat_time();
-        }
-      } else if (message_string.rfind("HEARTBEAT", 0) == 0) {
-        // Ignore heartbeat reply
-      } else {
-        throw std::invalid_argument("Unknown message type: " + message_string);
+      ItemDistributorWorker worker(body);
+      if (worker.pool_id() != 0) {
+        key = "pool " + std::to_string(worker.pool_id());
+      } else if (worker.group_id() != 0) {
+        key = "group " + std::to_string(worker.group_id());
       }
-    } catch (std::exception& e) {
-      L_(error) << e.what();
-      L_(error) << "protocol violation, disconnecting worker";
-      try {
-        send_worker_disconnect(identity);
-      } catch (std::exception&) {
-      };
-      workers_.erase(identity);
+    } catch (std::exception&) {
+      // The shard reports the protocol violation
     }
+    const size_t shard = std::hash<std::string>{}(key) % shard_sockets_.size();
+    worker_shards_[identity] = shard;
+    return shard;
+  }
+  auto it = worker_shards_.find(identity);
+  if (it != worker_shards_.end()) {
+    return it->second;
+  }
+  return std::hash<std::string>{}(identity) % shard_sockets_.size();
+}
+
+// Send a message in ROUTER format (identity, delimiter, body) to a worker.
+// If sharded, a worker that has gone away is reported to its shard as
+// disconnected, as the shard cannot see the failed send.
+void ItemDistributor::send_worker(zmq::multipart_t&& message) {
+  assert(message.size() >= 3 && !message.at(0).empty());
+  const std::string identity = message.peekstr(0);
+  const std::string body = message.peekstr(2);
+  if (body.rfind("WORK_ITEM ", 0) == 0) {
+    const ItemID id = std::stoull(body.substr(sizeof("WORK_ITEM ") - 1));
+    dispatch_metric_.Record(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            completions_.age(id))
+            .count()));
+  }
+  if (shard_) {
+    if (!message.send(worker_socket_)) {
+      L_LIMITED(error) << "message send failed";
+    }
+    return;
+  }
+  try {
+    if (!message.send(worker_socket_)) {
+      L_LIMITED(error) << "message send failed";
+    }
+  } catch (const zmq::error_t& e) {
+    L_(error) << "sending to worker failed: " << e.what();
+    auto it = worker_shards_.find(identity);
+    if (it == worker_shards_.end()) {
+      // Already reported
+      return;
+    }
+    zmq::multipart_t disconnect("W");
+    disconnect.addstr(identity);
+    disconnect.addstr("");
+    disconnect.send(shard_sockets_[it->second]);
+    worker_shards_.erase(it);
   }
-  send_pending_completions();
 }
@@ -1,40 +1,44 @@
 #ifndef SHM_IPC_ITEMDISTRIBUTOR_HPP
 #define SHM_IPC_ITEMDISTRIBUTOR_HPP
 
-#include "ItemDistributorWorker.hpp"
+#include "ItemCompletionBatch.hpp"
+#include "ItemDistributorShard.hpp"
 #include "ItemWorkerProtocol.hpp"
-#include "log.hpp"
+#include "Monitor.hpp"
 
-#include <algorithm>
-#include <cassert>
 #include <chrono>
-#include <exception>
-#include <map>
+#include <functional>
 #include <memory>
-#include <queue>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <zmq.hpp>
 #include <zmq_addon.hpp>
 
 /**
  * Work items are received from an exclusive producer client through a ZMQ_PAIR
- * socket.
+ * socket. Completions are returned to the producer in batches (see
+ * ItemCompletionBatch). Items are late once the item with an ID larger by
+ * the deadline horizon has arrived (zero: no deadlines).
+ *
+ * With more than one shard, the workers are partitioned across shard
+ * threads, each scheduling the items for its own workers (see
+ * ItemDistributorShard). The thread of the distributor then only passes on
+ * messages: each worker message to the shard of the worker, each item to all
+ * shards, and the messages of the shards to the workers. Workers are
+ * assigned by the hash of their identity, or of their group or pool, which
+ * is served by a single shard as a whole. The shards are connected through
+ * inproc PAIR sockets, i.e., lock-free pipes. An item is completed once all
+ * shards have completed it.
  */
 class ItemDistributor {
 public:
   ItemDistributor(zmq::context_t& context,
                   const std::string& producer_address,
-                  const std::string& worker_address)
-      : generator_socket_(context, zmq::socket_type::pair),
-        worker_socket_(context, zmq::socket_type::router) {
-    generator_socket_.bind(producer_address);
-    generator_socket_.set(zmq::sockopt::linger, 0);
-    worker_socket_.set(zmq::sockopt::router_mandatory, 1);
-    worker_socket_.set(zmq::sockopt::router_notify, ZMQ_NOTIFY_DISCONNECT);
-    worker_socket_.bind(worker_address);
-    worker_socket_.set(zmq::sockopt::linger, 0);
-  }
+                  const std::string& worker_address,
+                  size_t deadline_horizon = 0,
+                  size_t num_shards = 1);
 
   // ItemDistributor is non-copyable
   ItemDistributor(const ItemDistributor& other) = delete;
@@ -42,49 +46,38 @@ public:
   ItemDistributor(ItemDistributor&& other) = delete;
   ItemDistributor& operator=(ItemDistributor&& other) = delete;
 
-  void operator()() {
-    zmq::active_poller_t poller;
-    poller.add(generator_socket_, zmq::event_flags::pollin,
-               [&](zmq::event_flags /*e*/) { on_generator_pollin(); });
-    poller.add(worker_socket_, zmq::event_flags::pollin,
-               [&](zmq::event_flags /*e*/) { on_worker_pollin(); });
-
-    while (!stopped_) {
-      poller.wait(distributor_poll_timeout);
-      send_heartbeats();
-    }
-  }
+  void operator()();
 
   void stop() { stopped_ = true; }
 
+  // Set the interval of the per-worker status reports (default: 1 s)
+  void set_status_interval(std::chrono::milliseconds interval) {
+    status_interval_ = interval;
+  }
+
+  // Call a function with the number of pending items (outstanding at or
+  // queued for the workers) at the given interval, from the thread of the
+  // distributor
+  void set_load_observer(std::function<void(size_t)> observer,
+                         std::chrono::milliseconds interval) {
+    load_observer_ = std::move(observer);
+    load_interval_ = interval;
+  }
+
   // TODO(cuveland): sensible clean-up
-  ~ItemDistributor() = default;
+  ~ItemDistributor();
 
 private:
-  // Send heartbeat messages to workers that have been idle for a while
-  void send_heartbeats() {
-    std::chrono::system_clock::time_point now =
-        std::chrono::system_clock::now();
-    for (auto& [identity, worker] : workers_) {
-      try {
-        if (worker->wants_heartbeat(now)) {
-          worker->reset_heartbeat_time();
-          send_worker_heartbeat(identity);
-        }
-      } catch (std::exception& e) {
-        L_(error) << e.what();
-        workers_.erase(identity);
-      }
-    }
-  }
+  class ShardThread;
 
-  void send_pending_completions() {
-    while (!completed_items_.empty()) {
-      auto item = completed_items_.front();
-      generator_socket_.send(zmq::buffer(std::to_string(item)));
-      completed_items_.pop();
-    }
-  }
+  // Pass the number of pending items to the load observer once it is due
+  void report_load();
+
+  // Collect completions and send them to the producer once a batch is due
+  void send_pending_completions();
+
+  // Account for an item completed by all workers
+  void complete(ItemID id);
 
   // Handle incoming message (work item) from the generator
   void on_generator_pollin();
@@ -92,41 +85,40 @@ private:
   // Handle incoming message from a worker
   void on_worker_pollin();
 
-  void send_worker(const std::string& identity, zmq::multipart_t&& message) {
-    assert(!identity.empty());
-    // Prepare first two message parts as required for a ROUTER socket
-    message.push(zmq::message_t(0));
-    message.pushstr(identity);
-
-    // Send the message
-    if (!message.send(worker_socket_)) {
-      L_(error) << "message send failed";
-    }
-  }
-
-  void send_worker_work_item(const std::string& identity, const Item& item) {
-    zmq::multipart_t message("WORK_ITEM " + std::to_string(item.id()));
-    if (!item.payload().empty()) {
-      message.addstr(item.payload());
-    }
-    send_worker(identity, std::move(message));
-  }
+  // Handle incoming message from a shard thread
+  void on_shard_pollin(size_t shard);
 
-  void send_worker_heartbeat(const std::string& identity) {
-    zmq::multipart_t message("HEARTBEAT");
-    send_worker(identity, std::move(message));
-  }
+  // Select the shard serving the worker that sent a message
+  size_t shard_of(const zmq::multipart_t& message);
 
-  void send_worker_disconnect(const std::string& identity) {
-    zmq::multipart_t message("DISCONNECT");
-    send_worker(identity, std::move(message));
-  }
+  // Send a message in ROUTER format (identity, delimiter, body) to a worker
+  void send_worker(zmq::multipart_t&& message);
 
   zmq::socket_t generator_socket_;
   zmq::socket_t worker_socket_;
-  std::queue<ItemID> completed_items_;
-  std::map<std::string, std::unique_ptr<ItemDistributorWorker>> workers_;
+  ItemCompletionCoalescer completions_{distributor_completion_batch_size,
+                                       distributor_completion_flush_interval};
+  ItemCompletionBatch completion_batch_;
+  // Serves all workers in the thread of the distributor if not sharded
+  std::unique_ptr<ItemDistributorShard> shard_;
+  // Shard threads and the sockets connecting them, if sharded
+  std::vector<std::unique_ptr<ShardThread>> shards_;
+  std::vector<zmq::socket_t> shard_sockets_;
+  // Shard of each registered worker by identity
+  std::unordered_map<std::string, size_t> worker_shards_;
+  // Number of shards yet to complete each item
+  std::unordered_map<ItemID, size_t> shard_completions_;
   bool stopped_ = false;
+  // Time from the arrival of an item to its completion by all workers
+  cbm::MetricHistogram turnaround_metric_;
+  // Time from the arrival of an item to its dispatch to a worker
+  cbm::MetricHistogram dispatch_metric_;
+  // Tags of the per-worker status reports
+  cbm::MetricTagSet tagset_;
+  std::chrono::milliseconds status_interval_{1000};
+  std::function<void(size_t)> load_observer_;
+  std::chrono::milliseconds load_interval_{100};
+  std::chrono::steady_clock::time_point next_load_time_;
 };
 
 #endif
@@ -0,0 +1,130 @@
+#include "ItemDistributorShard.hpp"
+#include "log.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <exception>
+#include <sstream>
+#include <stdexcept>
+
+// Handle a message received from a worker through a ROUTER socket
+void ItemDistributorShard::on_worker_message(zmq::multipart_t& message) {
+  assert(message.size() >= 2);    // Multipart format ensured by ZMQ
+  assert(!message.at(0).empty()); // for ROUTER sockets
+  assert(message.at(1).empty());  //
+
+  std::string identity = message.peekstr(0);
+
+  if (message.size() == 2) {
+    // Handle ZMQ worker disconnect notification
+    if (auto* worker = scheduler_.find_worker(identity)) {
+      L_(info) << "worker disconnected: " << worker->description() << ", "
+               << worker->statistics();
+    }
+    if (!scheduler_.remove_worker(identity)) {
+      // This could happen if a misbehaving worker did not send a REGISTER
+      // message
+      L_(error) << "disconnect from unknown worker";
+    }
+    return;
+  }
+
+  try {
+    // Handle general message from a worker
+    std::string message_string = message.peekstr(2);
+    if (message_string.rfind("REGISTER ", 0) == 0 ||
+        message_string.rfind("REGISTER2 ", 0) == 0 ||
+        message_string.rfind("REGISTER3 ", 0) == 0) {
+      // Handle new worker registration
+      auto worker = std::make_unique<ItemDistributorWorker>(message_string);
+      L_(info) << "worker connected: " << worker->description();
+      scheduler_.add_worker(identity, std::move(worker));
+      if (const auto* added = scheduler_.find_worker(identity)) {
+        heartbeats_.push({added->heartbeat_due(), identity, added});
+      }
+    } else if (message_string.rfind("COMPLETE ", 0) == 0) {
+      // Handle worker completion message
+      std::string command;
+      ItemID id;
+      std::stringstream s(message_string);
+      s >> command >> id;
+      if (s.fail()) {
+        throw std::invalid_argument("Invalid completion message");
+      }
+      scheduler_.complete(identity, id);
+    } else if (message_string.rfind("HEARTBEAT", 0) == 0) {
+      // Ignore heartbeat reply
+    } else {
+      throw std::invalid_argument("Unknown message type: " + message_string);
+    }
+  } catch (std::exception& e) {
+    L_(error) << e.what();
+    L_(error) << "protocol violation, disconnecting worker";
+    try {
+      send_worker_disconnect(identity);
+    } catch (std::exception&) {
+    };
+    scheduler_.remove_worker(identity);
+  }
+}
+
+// Send heartbeat messages to workers that have been idle for a while. Busy
+// workers are checked again after a heartbeat interval, idle ones once
+// their heartbeat is due.
+void ItemDistributorShard::send_heartbeats() {
+  const auto now = std::chrono::system_clock::now();
+  std::vector<std::string> failed_workers;
+  while (!heartbeats_.empty() && heartbeats_.top().due <= now) {
+    HeartbeatTimer timer = heartbeats_.top();
+    heartbeats_.pop();
+    auto* worker = scheduler_.find_worker(timer.identity);
+    if (worker == nullptr || worker != timer.worker) {
+      // The worker has been removed since
+      continue;
+    }
+    try {
+      if (worker->wants_heartbeat(now)) {
+        worker->reset_heartbeat_time();
+        send_worker_heartbeat(timer.identity);
+      }
+    } catch (std::exception& e) {
+      L_(error) << e.what();
+      failed_workers.push_back(timer.identity);
+      continue;
+    }
+    timer.due = worker->is_idle()
+                    ? std::max(worker->heartbeat_due(), now)
+                    : now + distributor_heartbeat_interval;
+    if (timer.due == now) {
+      timer.due += distributor_poll_timeout;
+    }
+    heartbeats_.push(std::move(timer));
+  }
+  for (const auto& identity : failed_workers) {
+    scheduler_.remove_worker(identity);
+  }
+}
+
+// Publish the outstanding and queued items of each worker, so that a
+// backlog can be attributed to the responsible worker
+void ItemDistributorShard::report_workers(
+    std::chrono::milliseconds status_interval) {
+  auto* monitor = cbm::Monitor::Ptr();
+  if (monitor == nullptr) {
+    return;
+  }
+  const auto now = std::chrono::steady_clock::now();
+  if (now < next_status_time_) {
+    return;
+  }
+  next_status_time_ = now + status_interval;
+  for (const auto& [identity, worker] : scheduler_.workers()) {
+    cbm::MetricTagSet tagset = tagset_;
+    tagset.emplace_back("client_name", worker->client_name());
+    monitor->QueueMetric(
+        "item_distributor_worker", std::move(tagset),
+        {{"outstanding", static_cast<uint64_t>(worker->num_outstanding())},
+         {"queued", static_cast<uint64_t>(worker->num_queued())},
+         {"completed", static_cast<uint64_t>(worker->completed())}});
+  }
+}
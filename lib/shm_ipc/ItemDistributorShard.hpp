@@ -0,0 +1,124 @@
+#ifndef SHM_IPC_ITEMDISTRIBUTORSHARD_HPP
+#define SHM_IPC_ITEMDISTRIBUTORSHARD_HPP
+
+#include "ItemDistributorWorker.hpp"
+#include "ItemScheduler.hpp"
+#include "ItemWorkerProtocol.hpp"
+#include "Monitor.hpp"
+
+#include <chrono>
+#include <functional>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include <zmq_addon.hpp>
+
+/**
+ * The ItemDistributorShard serves the workers of an ItemDistributor, or the
+ * subset of them assigned to one of its shards. It handles the worker
+ * messages, schedules the items through an ItemScheduler and sends
+ * heartbeats to idle workers.
+ *
+ * Messages to the workers are handed to the send function in the multipart
+ * format of a ROUTER socket (identity, empty delimiter, body). Heartbeats
+ * are kept in a timer queue ordered by their due time, so that each worker
+ * is looked at about once per heartbeat interval instead of on every poll
+ * cycle.
+ */
+class ItemDistributorShard {
+public:
+  using SendFunction = std::function<void(zmq::multipart_t&& message)>;
+
+  ItemDistributorShard(SendFunction send,
+                       size_t deadline_horizon,
+                       cbm::MetricTagSet tagset)
+      : send_(std::move(send)),
+        scheduler_(
+            [this](const std::string& identity, const Item& item) {
+              send_worker_work_item(identity, item);
+            },
+            deadline_horizon),
+        tagset_(std::move(tagset)) {}
+
+  // ItemDistributorShard is non-copyable
+  ItemDistributorShard(const ItemDistributorShard& other) = delete;
+  ItemDistributorShard& operator=(const ItemDistributorShard& other) = delete;
+  ItemDistributorShard(ItemDistributorShard&& other) = delete;
+  ItemDistributorShard& operator=(ItemDistributorShard&& other) = delete;
+  ~ItemDistributorShard() = default;
+
+  // Distribute a new work item to the workers
+  void distribute(ItemID id, std::string payload) {
+    scheduler_.distribute(id, std::move(payload));
+  }
+
+  // Handle a message received from a worker through a ROUTER socket
+  void on_worker_message(zmq::multipart_t& message);
+
+  // Send heartbeat messages to workers that have been idle for a while
+  void send_heartbeats();
+
+  // Publish the outstanding and queued items of each worker once the status
+  // interval has passed, so that a backlog can be attributed to the
+  // responsible worker
+  void report_workers(std::chrono::milliseconds status_interval);
+
+  // Retrieve the ID of the next item completed by all workers of the shard
+  bool try_pop_completion(ItemID* id) {
+    return scheduler_.try_pop_completion(id);
+  }
+
+  // Number of items outstanding at or queued for the workers
+  [[nodiscard]] size_t num_pending() const { return scheduler_.num_pending(); }
+
+private:
+  // Due time of the next heartbeat check of a worker
+  struct HeartbeatTimer {
+    std::chrono::system_clock::time_point due;
+    std::string identity;
+    // Distinguishes a re-registered worker with the same identity
+    const ItemDistributorWorker* worker;
+
+    bool operator>(const HeartbeatTimer& other) const {
+      return due > other.due;
+    }
+  };
+
+  void send_worker(const std::string& identity, zmq::multipart_t&& message) {
+    // Prepare first two message parts as required for a ROUTER socket
+    message.push(zmq::message_t(0));
+    message.pushstr(identity);
+    send_(std::move(message));
+  }
+
+  void send_worker_work_item(const std::string& identity, const Item& item) {
+    zmq::multipart_t message("WORK_ITEM " + std::to_string(item.id()));
+    if (!item.payload().empty()) {
+      message.addstr(item.payload());
+    }
+    send_worker(identity, std::move(message));
+  }
+
+  void send_worker_heartbeat(const std::string& identity) {
+    zmq::multipart_t message("HEARTBEAT");
+    send_worker(identity, std::move(message));
+  }
+
+  void send_worker_disconnect(const std::string& identity) {
+    zmq::multipart_t message("DISCONNECT");
+    send_worker(identity, std::move(message));
+  }
+
+  SendFunction send_;
+  ItemScheduler<std::string> scheduler_;
+  std::priority_queue<HeartbeatTimer,
+                      std::vector<HeartbeatTimer>,
+                      std::greater<>>
+      heartbeats_;
+  // Tags of the per-worker status reports
+  cbm::MetricTagSet tagset_;
+  std::chrono::steady_clock::time_point next_status_time_;
+};
+
+#endif
@@ -4,13 +4,33 @@
 #include "ItemWorkerProtocol.hpp"
 
 #include <algorithm>
+#include <chrono>
+#include <deque>
 #include <memory>
+#include <optional>
 #include <sstream>
+#include <string>
 
 class ItemDistributorWorker {
 public:
   explicit ItemDistributorWorker(const std::string& message) {
     initialize_from_string(message);
+    check_queue_policy();
+  }
+
+  explicit ItemDistributorWorker(const WorkerParameters& parameters)
+      : stride_(parameters.stride), offset_(parameters.offset),
+        queue_policy_(parameters.queue_policy),
+        group_id_(parameters.group_id), client_name_(parameters.client_name),
+        min_interval_(parameters.min_interval), pool_id_(parameters.pool_id),
+        capacity_(parameters.capacity) {
+    if (stride_ == 0) {
+      throw std::invalid_argument("Invalid worker stride: 0");
+    }
+    if (capacity_ == 0) {
+      throw std::invalid_argument("Invalid worker capacity: 0");
+    }
+    check_queue_policy();
   }
 
   // ItemDistributorWorker is non-copyable
@@ -22,27 +42,68 @@ public:
 
   [[nodiscard]] bool wants(ItemID id) const { return id % stride_ == offset_; }
 
+  // Check whether the rate limit admits another item at the given time
+  [[nodiscard]] bool admits(std::chrono::steady_clock::time_point when) const {
+    return min_interval_.count() == 0 || !last_item_time_.has_value() ||
+           *last_item_time_ + min_interval_ <= when;
+  }
+
+  // Record that an item has been sent or queued at the given time
+  void record_item(std::chrono::steady_clock::time_point when) {
+    if (min_interval_.count() != 0) {
+      last_item_time_ = when;
+    }
+  }
+
   [[nodiscard]] WorkerQueuePolicy queue_policy() const { return queue_policy_; }
 
   [[nodiscard]] size_t group_id() const { return group_id_; }
 
+  [[nodiscard]] size_t pool_id() const { return pool_id_; }
+
+  [[nodiscard]] size_t capacity() const { return capacity_; }
+
   [[nodiscard]] bool queue_empty() const { return waiting_items_.empty(); }
 
+  [[nodiscard]] size_t num_queued() const { return waiting_items_.size(); }
+
   void clear_queue() { waiting_items_.clear(); }
 
   void push_queue(const std::shared_ptr<Item>& item) {
     waiting_items_.push_back(item);
   }
 
-  std::shared_ptr<Item> pop_queue() {
+  // Retrieve the next queued item according to the queue policy, dropping
+  // the items that are late at the arrival of the newest item
+  std::shared_ptr<Item> pop_queue(ItemID newest) {
+    drop_late(newest);
     if (queue_empty()) {
       return nullptr;
     }
-    std::shared_ptr<Item> item = waiting_items_.front();
-    waiting_items_.pop_front();
+    std::shared_ptr<Item> item;
+    if (queue_policy_ == WorkerQueuePolicy::NewestFirst) {
+      item = waiting_items_.back();
+      waiting_items_.pop_back();
+    } else {
+      item = waiting_items_.front();
+      waiting_items_.pop_front();
+    }
     return item;
   }
 
+  // Drop the queued items that are late at the arrival of the newest item,
+  // if the queue policy asks for it
+  void drop_late(ItemID newest) {
+    if (!drops_late_items(queue_policy_)) {
+      return;
+    }
+    // Items are queued in the order of arrival, so the oldest ones are first
+    while (!waiting_items_.empty() && waiting_items_.front()->is_late(newest)) {
+      waiting_items_.pop_front();
+      ++dropped_late_;
+    }
+  }
+
   void delete_from_queue(ItemID id) {
     auto it = std::find_if(
         std::begin(waiting_items_), std::end(waiting_items_),
@@ -54,25 +115,58 @@ public:
 
   [[nodiscard]] bool is_idle() const { return outstanding_items_.empty(); }
 
+  [[nodiscard]] size_t num_outstanding() const {
+    return outstanding_items_.size();
+  }
+
+  // Check whether the worker can take another item (pool members)
+  [[nodiscard]] bool has_capacity() const {
+    return outstanding_items_.size() < capacity_;
+  }
+
   void add_outstanding(const std::shared_ptr<Item>& item) {
-    outstanding_items_.push_back(item);
+    outstanding_items_.push_back({item, std::chrono::steady_clock::now()});
   }
 
-  // Find an outstanding item object and delete it
+  // Find an outstanding item object and delete it, recording its latency
   void delete_outstanding(ItemID id) {
     auto it = std::find_if(
         std::begin(outstanding_items_), std::end(outstanding_items_),
-        [id](const std::shared_ptr<Item>& i) { return i->id() == id; });
+        [id](const Outstanding& o) { return o.item->id() == id; });
     if (it == std::end(outstanding_items_)) {
       throw std::invalid_argument("Invalid work completion");
     }
+    const auto latency = std::chrono::steady_clock::now() - it->sent;
+    ++completed_;
+    total_latency_ += latency;
+    max_latency_ = std::max(max_latency_, latency);
     outstanding_items_.erase(it);
   }
 
+  // Number of items completed by the worker
+  [[nodiscard]] size_t completed() const { return completed_; }
+
+  // Mean time from sending an item to its completion
+  [[nodiscard]] std::chrono::steady_clock::duration mean_latency() const {
+    return completed_ != 0
+               ? total_latency_ / static_cast<int64_t>(completed_)
+               : std::chrono::steady_clock::duration::zero();
+  }
+
+  // Maximum time from sending an item to its completion
+  [[nodiscard]] std::chrono::steady_clock::duration max_latency() const {
+    return max_latency_;
+  }
+
   void reset_heartbeat_time() {
     last_heartbeat_time_ = std::chrono::system_clock::now();
   }
 
+  // Time after which an idle worker wants a heartbeat
+  [[nodiscard]] std::chrono::system_clock::time_point heartbeat_due() const {
+    return last_heartbeat_time_ + distributor_heartbeat_interval;
+  }
+
   [[nodiscard]] bool
   wants_heartbeat(std::chrono::system_clock::time_point when) const {
     return (is_idle() &&
@@ -82,21 +176,61 @@ public:
   [[nodiscard]] const std::string& client_name() const { return client_name_; }
 
   [[nodiscard]] std::string description() const {
-    return client_name_ + " (s" + std::to_string(stride_) + "/o" +
-           std::to_string(offset_) + "/p" + to_string(queue_policy_) + "/g" +
-           std::to_string(group_id_) + ")";
+    std::string description =
+        client_name_ + " (s" + std::to_string(stride_) + "/o" +
+        std::to_string(offset_) + "/p" + to_string(queue_policy_) + "/g" +
+        std::to_string(group_id_);
+    if (min_interval_.count() != 0) {
+      description += "/i" + std::to_string(min_interval_.count()) + "ns";
+    }
+    if (pool_id_ != 0) {
+      description += "/P" + std::to_string(pool_id_) + "x" +
+                     std::to_string(capacity_);
+    }
+    return description + ")";
+  }
+
+  // Describe the completion statistics of the worker
+  [[nodiscard]] std::string statistics() const {
+    using us = std::chrono::microseconds;
+    return std::to_string(completed_) + " items completed, " +
+           std::to_string(dropped_late_) + " dropped late, latency mean " +
+           std::to_string(std::chrono::duration_cast<us>(mean_latency())
+                              .count()) +
+           " us, max " +
+           std::to_string(std::chrono::duration_cast<us>(max_latency_)
+                              .count()) +
+           " us";
   }
 
 private:
+  void check_queue_policy() const {
+    if (queue_policy_ != WorkerQueuePolicy::QueueAll &&
+        queue_policy_ != WorkerQueuePolicy::PrebufferOne &&
+        queue_policy_ != WorkerQueuePolicy::Skip &&
+        !drops_late_items(queue_policy_)) {
+      throw std::invalid_argument("Invalid worker queue policy: " +
+                                  to_string(queue_policy_));
+    }
+  }
+
   void initialize_from_string(const std::string& message) {
     std::string command;
     std::stringstream s(message);
     // Read space-separated string into separate variables
-    s >> command >> stride_ >> offset_ >> queue_policy_ >> group_id_ >>
-        client_name_;
+    s >> command >> stride_ >> offset_ >> queue_policy_ >> group_id_;
+    if (command == "REGISTER2" || command == "REGISTER3") {
+      int64_t min_interval = 0;
+      s >> min_interval;
+      min_interval_ = std::chrono::nanoseconds(min_interval);
+    }
+    if (command == "REGISTER3") {
+      s >> pool_id_;
+    }
+    s >> client_name_;
     // Read remainder of string and add contents to client_name_
     client_name_ += std::string(std::istreambuf_iterator<char>(s), {});
-    if (s.fail()) {
+    if (s.fail() || min_interval_.count() < 0) {
       throw std::invalid_argument("Invalid register message: " + message);
     }
   }
@@ -106,9 +240,24 @@ private:
   WorkerQueuePolicy queue_policy_{};
   size_t group_id_{};
   std::string client_name_;
+  std::chrono::nanoseconds min_interval_{0};
+  std::optional<std::chrono::steady_clock::time_point> last_item_time_;
+  size_t pool_id_{};
+  size_t capacity_ = 1;
+
+  // An item sent to the worker and the time it was sent
+  struct Outstanding {
+    std::shared_ptr<Item> item;
+    std::chrono::steady_clock::time_point sent;
+  };
 
   std::deque<std::shared_ptr<Item>> waiting_items_;
-  std::deque<std::shared_ptr<Item>> outstanding_items_;
+  std::deque<Outstanding> outstanding_items_;
+
+  size_t completed_ = 0;
+  size_t dropped_late_ = 0;
+  std::chrono::steady_clock::duration total_latency_{};
+  std::chrono::steady_clock::duration max_latency_{};
   std::chrono::system_clock::time_point last_heartbeat_time_ =
       std::chrono::system_clock::now();
 };
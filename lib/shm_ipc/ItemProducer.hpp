@@ -1,11 +1,13 @@
 #ifndef SHM_IPC_ITEMPRODUCER_HPP
 #define SHM_IPC_ITEMPRODUCER_HPP
 
+#include "ItemCompletionBatch.hpp"
+
+#include <chrono>
 #include <cstddef>
+#include <vector>
 #include <zmq.hpp>
 
-using ItemID = size_t;
-
 class ItemProducer {
 public:
   ItemProducer(zmq::context_t& context, const std::string& distributor_address)
@@ -24,7 +26,8 @@ public:
     }
   }
 
-  bool try_receive_completion(ItemID* id) {
+  // Receive the next batch of completions
+  bool try_receive_completions(ItemCompletionBatch* batch) {
     zmq::message_t message;
     try {
       const auto result =
@@ -38,10 +41,32 @@ public:
       }
       throw;
     }
-    *id = std::stoull(message.to_string());
+    batch->deserialize(message.data(), message.size());
     return true;
   }
 
+  // Receive the next batch of completions, waiting up to the timeout
+  bool wait_for_completions(ItemCompletionBatch* batch,
+                            std::chrono::milliseconds timeout) {
+    if (try_receive_completions(batch)) {
+      return true;
+    }
+    zmq::poller_t poller;
+    poller.add(distributor_socket_, zmq::event_flags::pollin);
+    std::vector<decltype(poller)::event_type> events(1);
+    try {
+      if (poller.wait_all(events, timeout) == 0) {
+        return false;
+      }
+    } catch (zmq::error_t& ex) {
+      if (ex.num() == EINTR) {
+        return false;
+      }
+      throw;
+    }
+    return try_receive_completions(batch);
+  }
+
 private:
   zmq::socket_t distributor_socket_;
 };
@@ -0,0 +1,353 @@
+#ifndef SHM_IPC_ITEMSCHEDULER_HPP
+#define SHM_IPC_ITEMSCHEDULER_HPP
+
+#include "ItemDistributorWorker.hpp"
+#include "ItemWorkerProtocol.hpp"
+#include "log.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * The ItemScheduler implements the distribution of work items to the
+ * registered workers according to their WorkerParameters (stride, offset,
+ * queue policy, group and pool). It is independent of the transport: workers
+ * are identified by a Key, and items are handed to the transport through the
+ * send function.
+ *
+ * Workers with deterministic assignment receive every item matching their
+ * stride and offset (once per group). Pool members instead receive items on
+ * demand: an item goes to the member with the least outstanding items that
+ * has capacity left, or waits in the queue of the pool for the next member
+ * to complete an item.
+ *
+ * Items are reference-counted. Once an item has been completed by all
+ * workers it was sent or queued to, its ID is placed in the completion queue.
+ *
+ * With a deadline horizon, each item is late once the item with an ID
+ * larger by the horizon has arrived. Queues of workers (and pools) with a
+ * policy dropping late items are pruned on the arrival of every item, so
+ * that late items do not hold on to buffer space.
+ */
+template <typename Key> class ItemScheduler {
+public:
+  using SendFunction = std::function<void(const Key& key, const Item& item)>;
+
+  explicit ItemScheduler(SendFunction send, size_t deadline_horizon = 0)
+      : send_(std::move(send)), deadline_horizon_(deadline_horizon) {}
+
+  // ItemScheduler is non-copyable
+  ItemScheduler(const ItemScheduler& other) = delete;
+  ItemScheduler& operator=(const ItemScheduler& other) = delete;
+  ItemScheduler(ItemScheduler&& other) = delete;
+  ItemScheduler& operator=(ItemScheduler&& other) = delete;
+  ~ItemScheduler() = default;
+
+  void add_worker(const Key& key,
+                  std::unique_ptr<ItemDistributorWorker> worker) {
+    auto& added = workers_[key];
+    added = std::move(worker);
+    if (added->pool_id() != 0) {
+      // Take over items waiting in the pool
+      try {
+        while (added->has_capacity() && send_next_pool_item(key, *added)) {
+        }
+      } catch (std::exception& e) {
+        L_(error) << e.what();
+        remove_worker(key);
+      }
+    }
+  }
+
+  // Remove a worker, releasing all its outstanding and queued items
+  bool remove_worker(const Key& key) {
+    auto it = workers_.find(key);
+    if (it == workers_.end()) {
+      return false;
+    }
+    const size_t pool_id = it->second->pool_id();
+    workers_.erase(it);
+    if (pool_id != 0 &&
+        std::none_of(workers_.begin(), workers_.end(), [pool_id](auto& w) {
+          return w.second->pool_id() == pool_id;
+        })) {
+      // Release the items waiting for the last member of the pool
+      pool_queues_.erase(pool_id);
+    }
+    return true;
+  }
+
+  [[nodiscard]] ItemDistributorWorker* find_worker(const Key& key) const {
+    auto it = workers_.find(key);
+    return it != workers_.end() ? it->second.get() : nullptr;
+  }
+
+  [[nodiscard]] const std::map<Key, std::unique_ptr<ItemDistributorWorker>>&
+  workers() const {
+    return workers_;
+  }
+
+  // Number of items outstanding at or queued for the workers and pools
+  [[nodiscard]] size_t num_pending() const {
+    size_t pending = 0;
+    for (const auto& [key, worker] : workers_) {
+      pending += worker->num_outstanding() + worker->num_queued();
+    }
+    for (const auto& [pool_id, pool] : pool_queues_) {
+      pending += pool.items.size();
+    }
+    return pending;
+  }
+
+  // Distribute a new work item. If a group_id is set, send only once per
+  // group. Workers with a rate limit skip items arriving too early.
+  void distribute(ItemID id, std::string payload) {
+    std::optional<ItemID> deadline;
+    if (deadline_horizon_ != 0) {
+      deadline = id + deadline_horizon_;
+    }
+    newest_ = std::max(newest_, id);
+    drop_late_items();
+
+    auto new_item = std::make_shared<Item>(&completed_items_, id,
+                                           std::move(payload), deadline);
+    const auto now = std::chrono::steady_clock::now();
+
+    std::set<size_t> completed_groups;
+    std::set<size_t> served_pools;
+    std::vector<Key> failed_workers;
+    for (auto& [key, worker] : workers_) {
+      if (worker->pool_id() != 0) {
+        if (served_pools.insert(worker->pool_id()).second) {
+          distribute_to_pool(worker->pool_id(), new_item, now,
+                             failed_workers);
+        }
+        continue;
+      }
+      if (worker->group_id() != 0 &&
+          completed_groups.find(worker->group_id()) != completed_groups.end()) {
+        // This group has already been served, skip it
+        continue;
+      }
+      try {
+        if (worker->wants(new_item->id()) && worker->admits(now)) {
+          if (worker->queue_policy() == WorkerQueuePolicy::PrebufferOne) {
+            worker->clear_queue();
+          }
+          if (worker->is_idle()) {
+            // The worker is idle, send the item immediately
+            if (worker->group_id() != 0) {
+              completed_groups.insert(worker->group_id());
+              // As we can send the item immediately, delete this work item
+              // from the queues of other (previous) workers with the same
+              // group_id
+              for (auto& [other_key, other_worker] : workers_) {
+                if (other_worker == worker) {
+                  break;
+                }
+                if (other_worker->group_id() == worker->group_id()) {
+                  other_worker->delete_from_queue(new_item->id());
+                }
+              }
+            }
+            worker->add_outstanding(new_item);
+            worker->record_item(now);
+            send_(key, *new_item);
+          } else {
+            // The worker is busy, enqueue the item
+            if (worker->queue_policy() != WorkerQueuePolicy::Skip) {
+              worker->push_queue(new_item);
+              worker->record_item(now);
+            }
+          }
+        }
+      } catch (std::exception& e) {
+        L_(error) << e.what();
+        failed_workers.push_back(key);
+      }
+    }
+    for (const auto& key : failed_workers) {
+      remove_worker(key);
+    }
+  }
+
+  // Handle a completion from a worker and send the next item if available.
+  // Throws if the worker is unknown or the item is not outstanding.
+  void complete(const Key& key, ItemID id) {
+    auto& worker = workers_.at(key);
+    // Find the corresponding outstanding item object and delete it
+    worker->delete_outstanding(id);
+    // Send next item if available
+    if (worker->pool_id() != 0) {
+      if (!send_next_pool_item(key, *worker) && worker->is_idle()) {
+        worker->reset_heartbeat_time();
+      }
+    } else if (auto item = worker->pop_queue(newest_)) {
+      if (worker->group_id() != 0) {
+        // Delete this work item from the queues of other workers with the
+        // same group_id
+        for (auto& [other_key, other_worker] : workers_) {
+          if (worker != other_worker &&
+              other_worker->group_id() == worker->group_id()) {
+            other_worker->delete_from_queue(item->id());
+          }
+        }
+      }
+      worker->add_outstanding(item);
+      send_(key, *item);
+    } else {
+      worker->reset_heartbeat_time();
+    }
+  }
+
+  // Retrieve the ID of the next item that has been completed by all workers
+  bool try_pop_completion(ItemID* id) {
+    if (completed_items_.empty()) {
+      return false;
+    }
+    *id = completed_items_.front();
+    completed_items_.pop();
+    return true;
+  }
+
+private:
+  // Send a new item to the pool member with the least outstanding items
+  // that wants it and has capacity left, or enqueue it for the pool
+  void distribute_to_pool(size_t pool_id,
+                          const std::shared_ptr<Item>& item,
+                          std::chrono::steady_clock::time_point now,
+                          std::vector<Key>& failed_workers) {
+    const Key* target_key = nullptr;
+    ItemDistributorWorker* target = nullptr;
+    bool wanted = false;
+    auto policy = WorkerQueuePolicy::Skip;
+    for (auto& [key, worker] : workers_) {
+      if (worker->pool_id() != pool_id || !worker->wants(item->id()) ||
+          !worker->admits(now)) {
+        continue;
+      }
+      wanted = true;
+      if (queue_policy_restrictiveness(worker->queue_policy()) <
+          queue_policy_restrictiveness(policy)) {
+        policy = worker->queue_policy();
+      }
+      // Prefer the least loaded member, then the fastest one
+      if (worker->has_capacity() &&
+          (target == nullptr ||
+           worker->num_outstanding() < target->num_outstanding() ||
+           (worker->num_outstanding() == target->num_outstanding() &&
+            worker->mean_latency() < target->mean_latency()))) {
+        target_key = &key;
+        target = worker.get();
+      }
+    }
+    if (!wanted) {
+      return;
+    }
+    auto& pool = pool_queues_[pool_id];
+    pool.policy = policy;
+    if (target != nullptr) {
+      try {
+        target->add_outstanding(item);
+        target->record_item(now);
+        send_(*target_key, *item);
+      } catch (std::exception& e) {
+        L_(error) << e.what();
+        failed_workers.push_back(*target_key);
+      }
+      return;
+    }
+    // All members are busy, apply the least restrictive policy of them
+    if (policy == WorkerQueuePolicy::PrebufferOne) {
+      pool.items.clear();
+    }
+    if (policy != WorkerQueuePolicy::Skip) {
+      pool.items.push_back(item);
+    }
+  }
+
+  // Drop the late items from the queues of workers and pools that ask for it
+  void drop_late_items() {
+    if (deadline_horizon_ == 0) {
+      return;
+    }
+    for (auto& [key, worker] : workers_) {
+      worker->drop_late(newest_);
+    }
+    for (auto& [pool_id, pool] : pool_queues_) {
+      pool.drop_late(newest_);
+    }
+  }
+
+  // Send the oldest item of the pool queue the member wants, return false if
+  // there is none
+  bool send_next_pool_item(const Key& key, ItemDistributorWorker& worker) {
+    auto it = pool_queues_.find(worker.pool_id());
+    if (it == pool_queues_.end()) {
+      return false;
+    }
+    auto& pool = it->second;
+    pool.drop_late(newest_);
+    auto wanted = [&worker](const std::shared_ptr<Item>& item) {
+      return worker.wants(item->id());
+    };
+    std::shared_ptr<Item> item;
+    if (pool.policy == WorkerQueuePolicy::NewestFirst) {
+      auto found = std::find_if(pool.items.rbegin(), pool.items.rend(), wanted);
+      if (found == pool.items.rend()) {
+        return false;
+      }
+      item = *found;
+      pool.items.erase(std::next(found).base());
+    } else {
+      auto found = std::find_if(pool.items.begin(), pool.items.end(), wanted);
+      if (found == pool.items.end()) {
+        return false;
+      }
+      item = *found;
+      pool.items.erase(found);
+    }
+    worker.add_outstanding(item);
+    send_(key, *item);
+    return true;
+  }
+
+  // Items waiting for a member of a pool to take them
+  struct PoolQueue {
+    std::deque<std::shared_ptr<Item>> items;
+    // The least restrictive policy of the members wanting the last item
+    WorkerQueuePolicy policy = WorkerQueuePolicy::QueueAll;
+
+    void drop_late(ItemID newest) {
+      if (!drops_late_items(policy)) {
+        return;
+      }
+      while (!items.empty() && items.front()->is_late(newest)) {
+        items.pop_front();
+      }
+    }
+  };
+
+  SendFunction send_;
+  const size_t deadline_horizon_;
+  // ID of the newest item distributed
+  ItemID newest_ = 0;
+  // Must outlive the items referenced by workers_ and pool_queues_
+  CompletedItems completed_items_;
+  std::map<Key, std::unique_ptr<ItemDistributorWorker>> workers_;
+  // Items waiting for a member of a pool to take them, by pool ID
+  std::map<size_t, PoolQueue> pool_queues_;
+};
+
+#endif
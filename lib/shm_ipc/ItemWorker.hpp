@@ -4,6 +4,7 @@
 #include "ItemWorkerProtocol.hpp"
 #include "log.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <queue>
@@ -33,6 +34,13 @@ public:
   }
 
   std::shared_ptr<const Item> get() {
+    return get_until(std::chrono::steady_clock::time_point::max());
+  }
+
+  // Wait for the next item until the given time, return nullptr if there is
+  // none by then
+  std::shared_ptr<const Item>
+  get_until(std::chrono::steady_clock::time_point deadline) {
     while (!stopped_) {
       try {
         if (!distributor_socket_) {
@@ -44,7 +52,15 @@ public:
         zmq::poller_t poller;
         poller.add(*distributor_socket_, zmq::event_flags::pollin);
         std::vector<decltype(poller)::event_type> events(1);
-        size_t num_events = poller.wait_all(events, worker_poll_timeout);
+        const auto now = std::chrono::steady_clock::now();
+        const auto timeout =
+            now >= deadline
+                ? std::chrono::milliseconds{0}
+                : std::min<std::chrono::milliseconds>(
+                      worker_poll_timeout,
+                      std::chrono::ceil<std::chrono::milliseconds>(deadline -
+                                                                   now));
+        size_t num_events = poller.wait_all(events, timeout);
 
         if (num_events > 0) {
           // receive message
@@ -89,16 +105,19 @@ public:
         L_(error) << "Worker protocol violation: " << wp_error.what();
         distributor_socket_ = nullptr;
         disconnect_callback_();
-        std::queue<ItemID>().swap(completed_items_);
+        completed_items_.clear();
       } catch (zmq::error_t& zmq_error) {
         L_(error) << "ZMQ: " << zmq_error.what();
         distributor_socket_ = nullptr;
         disconnect_callback_();
-        std::queue<ItemID>().swap(completed_items_);
+        completed_items_.clear();
         if (zmq_error.num() == EINTR) {
           stop();
         }
       }
+      if (std::chrono::steady_clock::now() >= deadline) {
+        break;
+      }
     }
     return nullptr;
   }
@@ -118,11 +137,22 @@ private:
   }
 
   void send_register() {
+    // Workers without rate limit or pool use the original message for
+    // compatibility
+    const bool pooled = parameters_.pool_id != 0;
+    const bool limited = pooled || parameters_.min_interval.count() > 0;
     const std::string message_str =
-        "REGISTER " + std::to_string(parameters_.stride) + " " +
+        std::string(pooled    ? "REGISTER3 "
+                    : limited ? "REGISTER2 "
+                              : "REGISTER ") +
+        std::to_string(parameters_.stride) + " " +
         std::to_string(parameters_.offset) + " " +
         to_string(parameters_.queue_policy) + " " +
-        std::to_string(parameters_.group_id) + " " + parameters_.client_name;
+        std::to_string(parameters_.group_id) + " " +
+        (limited ? std::to_string(parameters_.min_interval.count()) + " "
+                 : std::string()) +
+        (pooled ? std::to_string(parameters_.pool_id) + " " : std::string()) +
+        parameters_.client_name;
     distributor_socket_->send(zmq::buffer(message_str));
     reset_heartbeat_time();
   }
@@ -179,7 +209,7 @@ private:
   const WorkerParameters parameters_{1, 0, WorkerQueuePolicy::QueueAll, 0,
                                      "example_client"};
   std::set<ItemID> items_;
-  std::queue<ItemID> completed_items_;
+  CompletedItems completed_items_;
   std::chrono::system_clock::time_point last_heartbeat_time_ =
       std::chrono::system_clock::now();
   bool stopped_ = false;
@@ -1,9 +1,12 @@
 #ifndef SHM_IPC_ITEMWORKERPROTOCOL_HPP
 #define SHM_IPC_ITEMWORKERPROTOCOL_HPP
 
+#include "AllocationStats.hpp"
 #include "log.hpp"
 
 #include <chrono>
+#include <mutex>
+#include <optional>
 #include <ostream>
 #include <queue>
 #include <stdexcept>
@@ -27,6 +30,9 @@
  *
  * The REGISTER message contains a specification of the type of items the worker
  * wants to receive (stride, offset). It also specifies the queueing mode.
+ * Workers with a rate limit send a REGISTER2 message instead, which carries
+ * the minimum interval between items in addition. Pool members send a
+ * REGISTER3 message, which carries the minimum interval and the pool ID.
  */
 
 constexpr static auto distributor_heartbeat_interval =
@@ -35,6 +41,11 @@ constexpr static auto distributor_poll_timeout = std::chrono::milliseconds{100};
 constexpr static auto worker_poll_timeout = std::chrono::milliseconds{500};
 constexpr static auto worker_heartbeat_timeout =
     10 * distributor_heartbeat_interval;
+// Completions are passed on to the producer in batches of up to this size,
+// or once the oldest pending completion is this old
+constexpr static size_t distributor_completion_batch_size = 64;
+constexpr static auto distributor_completion_flush_interval =
+    std::chrono::milliseconds{1};
 
 class WorkerProtocolError : public std::runtime_error {
 public:
@@ -44,11 +55,60 @@ public:
 
 using ItemID = size_t;
 
+/**
+ * The IDs of completed items, in order of completion. Items may be released
+ * on any thread, e.g. when a consumer hands them on to worker threads, while
+ * the owning worker or scheduler sends the completions.
+ */
+class CompletedItems {
+public:
+  void push(ItemID id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push(id);
+  }
+
+  [[nodiscard]] bool empty() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.empty();
+  }
+
+  [[nodiscard]] ItemID front() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.front();
+  }
+
+  void pop() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.pop();
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::queue<ItemID>().swap(queue_);
+  }
+
+private:
+  mutable std::mutex mutex_;
+  std::queue<ItemID> queue_;
+};
+
+/**
+ * An item may have a deadline, given as the ID of the newest item at whose
+ * arrival it is late. For timeslices, the ID is the position in the
+ * TimesliceBuffer, so the deadline marks the point at which the producer
+ * would need the buffer space back. Items are accounted in
+ * cbm::AllocationStats if enabled.
+ */
 class Item {
 public:
-  Item(std::queue<ItemID>* completed_items, ItemID id, std::string payload)
+  Item(CompletedItems* completed_items,
+       ItemID id,
+       std::string payload,
+       std::optional<ItemID> deadline = std::nullopt)
       : completed_items_(completed_items), id_(id),
-        payload_(std::move(payload)) {}
+        payload_(std::move(payload)), deadline_(deadline) {
+    alloc_record_.Update(sizeof(Item) + payload_.capacity());
+  }
 
   // Item is non-copyable
   Item(const Item& other) = delete;
@@ -60,12 +120,21 @@ public:
 
   [[nodiscard]] const std::string& payload() const { return payload_; }
 
+  [[nodiscard]] std::optional<ItemID> deadline() const { return deadline_; }
+
+  // Check whether the item is late once the given item has arrived
+  [[nodiscard]] bool is_late(ItemID newest) const {
+    return deadline_.has_value() && newest >= *deadline_;
+  }
+
   ~Item() { completed_items_->push(id_); }
 
 private:
-  std::queue<ItemID>* completed_items_;
+  CompletedItems* completed_items_;
   const ItemID id_;
   const std::string payload_;
+  const std::optional<ItemID> deadline_;
+  cbm::AllocationRecord alloc_record_{cbm::AllocationStats::kItem};
 };
 
 /**
@@ -94,9 +163,47 @@ enum class WorkerQueuePolicy {
    * The broker keeps no item queue for this worker. It only sends the item
    * immediately if the worker is idle.
    */
-  Skip
+  Skip,
+  /**
+   * DropLate:
+   *
+   * As QueueAll, but queued items are dropped as soon as they are past their
+   * deadline, releasing their buffer space early.
+   */
+  DropLate,
+  /**
+   * NewestFirst:
+   *
+   * As DropLate, but the newest queued item is sent first once the worker
+   * becomes idle. This suits online monitoring that wants fresh data while
+   * the system is behind.
+   */
+  NewestFirst
 };
 
+// Check whether the broker drops queued items past their deadline
+inline bool drops_late_items(WorkerQueuePolicy policy) {
+  return policy == WorkerQueuePolicy::DropLate ||
+         policy == WorkerQueuePolicy::NewestFirst;
+}
+
+// Rank the policies by the share of matching items they may discard
+inline int queue_policy_restrictiveness(WorkerQueuePolicy policy) {
+  switch (policy) {
+  case WorkerQueuePolicy::QueueAll:
+    return 0;
+  case WorkerQueuePolicy::DropLate:
+    return 1;
+  case WorkerQueuePolicy::NewestFirst:
+    return 2;
+  case WorkerQueuePolicy::PrebufferOne:
+    return 3;
+  case WorkerQueuePolicy::Skip:
+    return 4;
+  }
+  return 4;
+}
+
 // Stream enum as the underlying integer type
 inline std::ostream& operator<<(std::ostream& os, WorkerQueuePolicy val) {
   return os << static_cast<std::underlying_type_t<WorkerQueuePolicy>>(val);
@@ -129,6 +236,32 @@ struct WorkerParameters {
   size_t group_id;
 
   std::string client_name;
+
+  /**
+   * Minimum interval between two items sent or queued to the worker. Matching
+   * items arriving earlier are skipped without being pinned for the worker.
+   * This allows monitoring clients to request a stream downscaled to a
+   * maximum rate. Zero means no rate limit.
+   */
+  std::chrono::nanoseconds min_interval{0};
+
+  /**
+   * Workers with the same pool_id form a pool. Items are distributed on
+   * demand within the pool: each item that any member wants is sent to the
+   * member with the fewest outstanding items that wants it and has capacity
+   * left. Items no member can take immediately wait in a queue shared by the
+   * pool until a member completes an item, so that fast members take over
+   * the work slow ones cannot keep up with. The queue policy of the pool is
+   * the least restrictive one of its members. Pool members ignore their
+   * group_id. Pool_id 0 means no pool.
+   */
+  size_t pool_id = 0;
+
+  /**
+   * Maximum number of outstanding items of a pool member. Workers of the
+   * ZMQ-based protocol always have at most one outstanding item.
+   */
+  size_t capacity = 1;
 };
 
 #endif
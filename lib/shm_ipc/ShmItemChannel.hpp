@@ -0,0 +1,105 @@
+#ifndef SHM_IPC_SHMITEMCHANNEL_HPP
+#define SHM_IPC_SHMITEMCHANNEL_HPP
+
+#include "ItemWorkerProtocol.hpp"
+#include "ShmQueue.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * The shared memory item channel
+ *
+ * An alternative to the ZMQ-based ItemWorker protocol that lives entirely in
+ * a shared memory segment created by the producer (ShmItemDistributor). The
+ * segment contains one ShmItemChannel object with a fixed number of worker
+ * slots and an arena for the item payloads.
+ *
+ * A worker (ShmItemWorker) registers by claiming a free slot and filling in
+ * its WorkerParameters. The distributor then places work items in the slot's
+ * work queue and wakes the worker through the slot's event. The worker
+ * returns completions through the slot's completion queue, which the
+ * distributor polls, and signals them through the channel's completion
+ * event. Queueing policy, stride/offset, groups and pools are handled
+ * by the distributor exactly as in the ZMQ-based ItemDistributor. Pool
+ * members may have several items outstanding (up to the queue capacity).
+ *
+ * Crash detection replaces the heartbeat messages: the distributor
+ * periodically checks whether the process of each registered worker is
+ * still alive and releases the items of dead workers; a waiting worker
+ * checks the distributor process in the same way. A worker that violates
+ * the protocol is rejected and has to register again.
+ */
+
+constexpr static size_t shm_item_channel_max_workers = 64;
+constexpr static size_t shm_item_queue_capacity = 64;
+constexpr static size_t shm_item_client_name_size = 128;
+// "FLESITEM" in little-endian byte order
+constexpr static uint64_t shm_item_channel_magic = 0x4d45544953454c46;
+constexpr static const char* shm_item_channel_object_name = "ShmItemChannel";
+
+// Name of the item channel segment belonging to a shared memory identifier
+inline std::string shm_item_channel_name(const std::string& identifier) {
+  return identifier + "_items";
+}
+
+// Check whether a process exists (it may belong to a different user)
+inline bool shm_item_process_alive(int32_t pid) {
+  return pid > 0 && (kill(pid, 0) == 0 || errno != ESRCH);
+}
+
+// A work item; the payload is located at an offset from the channel object
+struct ShmWorkEntry {
+  ItemID id;
+  std::ptrdiff_t payload_offset;
+  uint64_t payload_size;
+};
+
+enum class ShmWorkerState : uint32_t {
+  Free,       ///< Slot is unused
+  Claimed,    ///< Worker is filling in its parameters
+  Registered, ///< Worker is active
+  Closed,     ///< Worker has disconnected, slot is to be released
+  Rejected    ///< Distributor has disconnected the worker
+};
+
+struct ShmWorkerSlot {
+  std::atomic<ShmWorkerState> state{ShmWorkerState::Free};
+  // Incremented on every registration to detect slot reuse
+  std::atomic<uint32_t> generation{0};
+  int32_t pid = 0;
+
+  uint64_t stride = 1;
+  uint64_t offset = 0;
+  WorkerQueuePolicy queue_policy = WorkerQueuePolicy::QueueAll;
+  uint64_t group_id = 0;
+  int64_t min_interval_ns = 0;
+  char client_name[shm_item_client_name_size] = {};
+
+  ShmEvent work_event;
+  ShmMpmcQueue<ShmWorkEntry, shm_item_queue_capacity> work_queue;
+  ShmMpmcQueue<ItemID, shm_item_queue_capacity> completion_queue;
+};
+
+// Pool membership of a worker slot, written before the registration
+struct ShmWorkerPoolSlot {
+  uint64_t pool_id = 0;
+  uint64_t capacity = 1;
+};
+
+struct ShmItemChannel {
+  uint64_t magic = shm_item_channel_magic;
+  int32_t distributor_pid = 0;
+  std::atomic<uint32_t> closed{0};
+  ShmWorkerSlot workers[shm_item_channel_max_workers];
+  // Placed last to keep the slots compatible with workers not notifying it
+  ShmEvent completion_event;
+  // Placed last for workers not knowing about pools, reset on release
+  ShmWorkerPoolSlot pools[shm_item_channel_max_workers];
+};
+
+#endif
@@ -0,0 +1,223 @@
+#include "ShmItemDistributor.hpp"
+
+#include "log.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace bi = boost::interprocess;
+
+ShmItemDistributor::ShmItemDistributor(std::string channel_name,
+                                       size_t deadline_horizon,
+                                       size_t payload_arena_size)
+    : channel_name_(std::move(channel_name)),
+      last_liveness_check_(std::chrono::steady_clock::now()),
+      scheduler_(
+          [this](const size_t& index, const Item& item) {
+            send_worker_work_item(index, item);
+          },
+          deadline_horizon) {
+  bi::shared_memory_object::remove(channel_name_.c_str());
+
+  constexpr size_t overhead_size = 4096;
+  const size_t managed_shm_size = sizeof(ShmItemChannel) +
+                                  alignof(ShmItemChannel) +
+                                  payload_arena_size + overhead_size;
+  managed_shm_ = std::make_unique<bi::managed_shared_memory>(
+      bi::create_only, channel_name_.c_str(), managed_shm_size);
+
+  // The channel is over-aligned, so it is placed manually and published by
+  // its handle
+  void* channel_memory = managed_shm_->allocate_aligned(
+      sizeof(ShmItemChannel), alignof(ShmItemChannel));
+  channel_ = new (channel_memory) ShmItemChannel();
+  channel_->distributor_pid = static_cast<int32_t>(getpid());
+  managed_shm_->construct<bi::managed_shared_memory::handle_t>(
+      shm_item_channel_object_name)(
+      managed_shm_->get_handle_from_address(channel_));
+
+  if (auto* monitor = cbm::Monitor::Ptr()) {
+    turnaround_metric_ = monitor->RegisterHistogram(
+        "item_distributor",
+        {{"host", monitor->HostName()}, {"channel", channel_name_}},
+        "turnaround_ns");
+  }
+}
+
+ShmItemDistributor::~ShmItemDistributor() {
+  channel_->closed.store(1, std::memory_order_release);
+  for (auto& slot : channel_->workers) {
+    slot.work_event.notify();
+  }
+  bi::shared_memory_object::remove(channel_name_.c_str());
+}
+
+void ShmItemDistributor::send_work_item(ItemID id, const std::string& payload) {
+  poll();
+  completions_.add_item(id);
+  scheduler_.distribute(id, payload);
+}
+
+bool ShmItemDistributor::try_receive_completions(ItemCompletionBatch* batch) {
+  poll();
+  ItemID id;
+  while (scheduler_.try_pop_completion(&id)) {
+    free_payload(id);
+    turnaround_metric_.Record(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            completions_.complete(id))
+            .count()));
+  }
+  if (completions_.empty()) {
+    return false;
+  }
+  completions_.flush(*batch);
+  return true;
+}
+
+bool ShmItemDistributor::wait_for_completions(
+    ItemCompletionBatch* batch, std::chrono::milliseconds timeout) {
+  const uint32_t count = channel_->completion_event.count();
+  if (try_receive_completions(batch)) {
+    return true;
+  }
+  channel_->completion_event.wait(count, timeout);
+  return try_receive_completions(batch);
+}
+
+void ShmItemDistributor::poll() {
+  const auto now = std::chrono::steady_clock::now();
+  const bool check_liveness =
+      now >= last_liveness_check_ + distributor_heartbeat_interval;
+  if (check_liveness) {
+    last_liveness_check_ = now;
+  }
+  for (size_t i = 0; i < shm_item_channel_max_workers; ++i) {
+    update_slot(i, check_liveness);
+  }
+}
+
+void ShmItemDistributor::update_slot(size_t index, bool check_liveness) {
+  ShmWorkerSlot& slot = channel_->workers[index];
+  const ShmWorkerState state = slot.state.load(std::memory_order_acquire);
+
+  switch (state) {
+  case ShmWorkerState::Free:
+    return;
+  case ShmWorkerState::Closed:
+    if (auto* worker = scheduler_.find_worker(index)) {
+      L_(info) << "worker disconnected: " << worker->description() << ", "
+               << worker->statistics();
+    }
+    release_worker(index, ShmWorkerState::Free);
+    return;
+  case ShmWorkerState::Claimed:
+  case ShmWorkerState::Rejected:
+    // The worker is expected to change the state; clean up if it has died
+    if (check_liveness && !shm_item_process_alive(slot.pid)) {
+      release_worker(index, ShmWorkerState::Free);
+    }
+    return;
+  case ShmWorkerState::Registered:
+    break;
+  }
+
+  if (check_liveness && !shm_item_process_alive(slot.pid)) {
+    if (auto* worker = scheduler_.find_worker(index)) {
+      L_(error) << "worker process " << slot.pid
+                << " has died: " << worker->description();
+    }
+    release_worker(index, ShmWorkerState::Free);
+    return;
+  }
+
+  try {
+    if (registered_generation_[index] !=
+        slot.generation.load(std::memory_order_acquire)) {
+      register_worker(index);
+    }
+    receive_completions(index);
+  } catch (std::exception& e) {
+    L_(error) << e.what();
+    L_(error) << "protocol violation, disconnecting worker";
+    release_worker(index, ShmWorkerState::Rejected);
+  }
+}
+
+void ShmItemDistributor::register_worker(size_t index) {
+  ShmWorkerSlot& slot = channel_->workers[index];
+  if (registered_generation_[index].has_value()) {
+    // The slot has been reused without notice
+    scheduler_.remove_worker(index);
+  }
+  registered_generation_[index] =
+      slot.generation.load(std::memory_order_acquire);
+
+  const ShmWorkerPoolSlot& pool = channel_->pools[index];
+  WorkerParameters parameters{
+      slot.stride,
+      slot.offset,
+      slot.queue_policy,
+      slot.group_id,
+      std::string(slot.client_name,
+                  strnlen(slot.client_name, shm_item_client_name_size)),
+      std::chrono::nanoseconds(slot.min_interval_ns),
+      pool.pool_id,
+      std::clamp<size_t>(pool.capacity, 1, shm_item_queue_capacity)};
+  auto worker = std::make_unique<ItemDistributorWorker>(parameters);
+  L_(info) << "worker connected: " << worker->description();
+  scheduler_.add_worker(index, std::move(worker));
+}
+
+void ShmItemDistributor::release_worker(size_t index,
+                                        ShmWorkerState new_state) {
+  scheduler_.remove_worker(index);
+  registered_generation_[index].reset();
+  channel_->pools[index] = {};
+  ShmWorkerSlot& slot = channel_->workers[index];
+  slot.state.store(new_state, std::memory_order_release);
+  slot.work_event.notify();
+}
+
+void ShmItemDistributor::receive_completions(size_t index) {
+  ShmWorkerSlot& slot = channel_->workers[index];
+  ItemID id;
+  while (slot.completion_queue.try_pop(id)) {
+    scheduler_.complete(index, id);
+  }
+}
+
+void ShmItemDistributor::send_worker_work_item(size_t index,
+                                               const Item& item) {
+  auto& payload = payloads_[item.id()];
+  if (payload == nullptr && !item.payload().empty()) {
+    payload = managed_shm_->allocate(item.payload().size());
+    std::memcpy(payload, item.payload().data(), item.payload().size());
+  }
+
+  ShmWorkerSlot& slot = channel_->workers[index];
+  const ShmWorkEntry entry{
+      item.id(),
+      payload != nullptr ? static_cast<char*>(payload) -
+                               reinterpret_cast<char*>(channel_)
+                         : 0,
+      item.payload().size()};
+  if (!slot.work_queue.try_push(entry)) {
+    throw std::runtime_error("work queue of worker is full");
+  }
+  slot.work_event.notify();
+}
+
+void ShmItemDistributor::free_payload(ItemID id) {
+  auto it = payloads_.find(id);
+  if (it == payloads_.end()) {
+    return;
+  }
+  if (it->second != nullptr) {
+    managed_shm_->deallocate(it->second);
+  }
+  payloads_.erase(it);
+}
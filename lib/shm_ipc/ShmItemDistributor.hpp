@@ -0,0 +1,104 @@
+#ifndef SHM_IPC_SHMITEMDISTRIBUTOR_HPP
+#define SHM_IPC_SHMITEMDISTRIBUTOR_HPP
+
+#include "ItemCompletionBatch.hpp"
+#include "ItemScheduler.hpp"
+#include "ItemWorkerProtocol.hpp"
+#include "Monitor.hpp"
+#include "ShmItemChannel.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include <boost/interprocess/managed_shared_memory.hpp>
+
+/**
+ * The ShmItemDistributor is the producer side of the shared memory item
+ * channel. It creates the channel segment and distributes work items to the
+ * ShmItemWorkers that have registered there.
+ *
+ * Unlike the ZMQ-based ItemDistributor, it does not run in a thread of its
+ * own. It is used directly by the producer in the same way as ItemProducer:
+ * every call to send_work_item() or try_receive_completions() also handles
+ * worker registrations, completions and crash detection. Items are late once
+ * the item with an ID larger by the deadline horizon has arrived (zero: no
+ * deadlines).
+ */
+class ShmItemDistributor {
+public:
+  ShmItemDistributor(std::string channel_name,
+                     size_t deadline_horizon = 0,
+                     size_t payload_arena_size = default_payload_arena_size);
+
+  // ShmItemDistributor is non-copyable
+  ShmItemDistributor(const ShmItemDistributor& other) = delete;
+  ShmItemDistributor& operator=(const ShmItemDistributor& other) = delete;
+  ShmItemDistributor(ShmItemDistributor&& other) = delete;
+  ShmItemDistributor& operator=(ShmItemDistributor&& other) = delete;
+
+  ~ShmItemDistributor();
+
+  void send_work_item(ItemID id, const std::string& payload);
+
+  // Receive all completions since the last call as a batch
+  bool try_receive_completions(ItemCompletionBatch* batch);
+
+  // Receive completions as try_receive_completions(), waiting up to the
+  // timeout for a worker to signal completions if there are none
+  bool wait_for_completions(ItemCompletionBatch* batch,
+                            std::chrono::milliseconds timeout);
+
+  // Handle worker registrations, completions and crash detection
+  void poll();
+
+  [[nodiscard]] size_t num_workers() const {
+    return scheduler_.workers().size();
+  }
+
+  [[nodiscard]] const std::string& channel_name() const {
+    return channel_name_;
+  }
+
+  constexpr static size_t default_payload_arena_size = UINT64_C(16) << 20;
+
+private:
+  void update_slot(size_t index, bool check_liveness);
+
+  void register_worker(size_t index);
+
+  void release_worker(size_t index, ShmWorkerState new_state);
+
+  void receive_completions(size_t index);
+
+  void send_worker_work_item(size_t index, const Item& item);
+
+  void free_payload(ItemID id);
+
+  const std::string channel_name_;
+  std::unique_ptr<boost::interprocess::managed_shared_memory> managed_shm_;
+  ShmItemChannel* channel_ = nullptr;
+
+  // Generation of the registration known to the scheduler, per slot
+  std::array<std::optional<uint32_t>, shm_item_channel_max_workers>
+      registered_generation_;
+
+  // Payloads in the channel segment, allocated on first send
+  std::map<ItemID, void*> payloads_;
+
+  std::chrono::steady_clock::time_point last_liveness_check_;
+
+  // As there is no message overhead, completions are never delayed
+  ItemCompletionCoalescer completions_{1, {}};
+
+  // Time from the arrival of an item to its completion by all workers
+  cbm::MetricHistogram turnaround_metric_;
+
+  ItemScheduler<size_t> scheduler_;
+};
+
+#endif
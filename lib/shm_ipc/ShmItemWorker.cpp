@@ -0,0 +1,218 @@
+#include "ShmItemWorker.hpp"
+
+#include "log.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+
+namespace bi = boost::interprocess;
+
+ShmItemWorker::ShmItemWorker(std::string channel_name,
+                             WorkerParameters parameters)
+    : channel_name_(std::move(channel_name)),
+      parameters_(std::move(parameters)) {
+  if (parameters_.client_name.empty()) {
+    throw std::invalid_argument("WorkerParameters.client_name cannot be empty");
+  }
+  if (parameters_.stride == 0) {
+    throw std::invalid_argument("WorkerParameters.stride cannot be 0");
+  }
+  connect();
+}
+
+ShmItemWorker::~ShmItemWorker() { disconnect(); }
+
+bool ShmItemWorker::available(const std::string& channel_name) {
+  try {
+    bi::shared_memory_object shm(bi::open_only, channel_name.c_str(),
+                                 bi::read_only);
+    return true;
+  } catch (bi::interprocess_exception&) {
+    return false;
+  }
+}
+
+std::shared_ptr<const Item> ShmItemWorker::get() {
+  return get_until(std::chrono::steady_clock::time_point::max());
+}
+
+std::shared_ptr<const Item>
+ShmItemWorker::get_until(std::chrono::steady_clock::time_point deadline) {
+  while (!stopped_) {
+    const auto now = std::chrono::steady_clock::now();
+    const auto timeout =
+        now >= deadline
+            ? std::chrono::milliseconds{0}
+            : std::min<std::chrono::milliseconds>(
+                  worker_poll_timeout,
+                  std::chrono::ceil<std::chrono::milliseconds>(deadline -
+                                                               now));
+    try {
+      if (slot_ == nullptr) {
+        if (!connect()) {
+          std::this_thread::sleep_for(timeout);
+          if (now >= deadline) {
+            return nullptr;
+          }
+          continue;
+        }
+      } else {
+        send_pending_completions();
+      }
+
+      if (!check_connection()) {
+        L_(info) << "item distributor has closed the connection";
+        disconnect();
+        disconnect_callback_();
+        completed_items_.clear();
+        continue;
+      }
+
+      const uint32_t count = slot_->work_event.count();
+      ShmWorkEntry entry{};
+      if (slot_->work_queue.try_pop(entry)) {
+        std::string payload;
+        if (entry.payload_size != 0) {
+          const char* data =
+              reinterpret_cast<const char*>(channel_) + entry.payload_offset;
+          payload.assign(data, entry.payload_size);
+        }
+        items_.insert(entry.id);
+        return std::make_shared<Item>(&completed_items_, entry.id, payload);
+      }
+
+      if (now >= deadline) {
+        return nullptr;
+      }
+      slot_->work_event.wait(count, timeout);
+    } catch (WorkerProtocolError& wp_error) {
+      L_(error) << "Worker protocol violation: " << wp_error.what();
+      disconnect();
+      disconnect_callback_();
+      completed_items_.clear();
+    }
+  }
+  return nullptr;
+}
+
+bool ShmItemWorker::connect() {
+  try {
+    managed_shm_ = std::make_unique<bi::managed_shared_memory>(
+        bi::open_only, channel_name_.c_str());
+  } catch (bi::interprocess_exception&) {
+    managed_shm_ = nullptr;
+    return false;
+  }
+
+  auto* handle = managed_shm_
+                     ->find<bi::managed_shared_memory::handle_t>(
+                         shm_item_channel_object_name)
+                     .first;
+  if (handle == nullptr) {
+    // The distributor has not finished initialization yet
+    managed_shm_ = nullptr;
+    return false;
+  }
+  channel_ = static_cast<ShmItemChannel*>(
+      managed_shm_->get_address_from_handle(*handle));
+  if (channel_->magic != shm_item_channel_magic ||
+      channel_->closed.load(std::memory_order_acquire) != 0) {
+    disconnect();
+    return false;
+  }
+
+  for (auto& slot : channel_->workers) {
+    ShmWorkerState expected = ShmWorkerState::Free;
+    if (slot.state.compare_exchange_strong(expected, ShmWorkerState::Claimed,
+                                           std::memory_order_acq_rel)) {
+      slot_ = &slot;
+      break;
+    }
+  }
+  if (slot_ == nullptr) {
+    L_(error) << "no free worker slot in " << channel_name_;
+    disconnect();
+    return false;
+  }
+
+  slot_->pid = static_cast<int32_t>(getpid());
+  slot_->stride = parameters_.stride;
+  slot_->offset = parameters_.offset;
+  slot_->queue_policy = parameters_.queue_policy;
+  slot_->group_id = parameters_.group_id;
+  slot_->min_interval_ns = parameters_.min_interval.count();
+  channel_->pools[slot_ - channel_->workers] = {parameters_.pool_id,
+                                                parameters_.capacity};
+  const size_t name_size = std::min(parameters_.client_name.size(),
+                                    shm_item_client_name_size - 1);
+  std::memcpy(slot_->client_name, parameters_.client_name.data(), name_size);
+  slot_->client_name[name_size] = '\0';
+  slot_->work_queue.reset();
+  slot_->completion_queue.reset();
+  generation_ = slot_->generation.fetch_add(1, std::memory_order_acq_rel) + 1;
+  slot_->state.store(ShmWorkerState::Registered, std::memory_order_release);
+
+  items_.clear();
+  last_liveness_check_ = std::chrono::steady_clock::now();
+  return true;
+}
+
+void ShmItemWorker::disconnect() {
+  if (slot_ != nullptr) {
+    // Release the slot if the distributor has rejected us, otherwise leave
+    // the clean-up to the distributor. The slot may already belong to
+    // another worker.
+    ShmWorkerState expected = ShmWorkerState::Rejected;
+    if (!slot_->state.compare_exchange_strong(expected, ShmWorkerState::Free,
+                                              std::memory_order_acq_rel) &&
+        slot_->generation.load(std::memory_order_acquire) == generation_) {
+      expected = ShmWorkerState::Registered;
+      slot_->state.compare_exchange_strong(expected, ShmWorkerState::Closed,
+                                           std::memory_order_acq_rel);
+    }
+  }
+  slot_ = nullptr;
+  channel_ = nullptr;
+  managed_shm_ = nullptr;
+}
+
+bool ShmItemWorker::check_connection() {
+  if (channel_->closed.load(std::memory_order_acquire) != 0) {
+    return false;
+  }
+  if (slot_->state.load(std::memory_order_acquire) !=
+          ShmWorkerState::Registered ||
+      slot_->generation.load(std::memory_order_acquire) != generation_) {
+    throw WorkerProtocolError("item distributor has rejected the worker");
+  }
+  const auto now = std::chrono::steady_clock::now();
+  if (now >= last_liveness_check_ + distributor_heartbeat_interval) {
+    last_liveness_check_ = now;
+    if (!shm_item_process_alive(channel_->distributor_pid)) {
+      throw WorkerProtocolError("item distributor process has died");
+    }
+  }
+  return true;
+}
+
+void ShmItemWorker::send_pending_completions() {
+  bool sent = false;
+  while (!completed_items_.empty()) {
+    const ItemID id = completed_items_.front();
+    // Skip completions of items from a previous connection
+    if (items_.erase(id) != 0) {
+      if (!slot_->completion_queue.try_push(id)) {
+        items_.insert(id);
+        break;
+      }
+      sent = true;
+    }
+    completed_items_.pop();
+  }
+  if (sent) {
+    channel_->completion_event.notify();
+  }
+}
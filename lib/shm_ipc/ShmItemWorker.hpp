@@ -0,0 +1,80 @@
+#ifndef SHM_IPC_SHMITEMWORKER_HPP
+#define SHM_IPC_SHMITEMWORKER_HPP
+
+#include "ItemWorkerProtocol.hpp"
+#include "ShmItemChannel.hpp"
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <set>
+#include <string>
+
+#include <boost/interprocess/managed_shared_memory.hpp>
+
+/**
+ * The ShmItemWorker is the worker side of the shared memory item channel,
+ * a drop-in alternative to the ZMQ-based ItemWorker. It registers in a free
+ * worker slot of the channel created by a ShmItemDistributor and reconnects
+ * automatically if the distributor goes away or rejects the worker.
+ */
+class ShmItemWorker {
+public:
+  using DisconnectCallback = std::function<void(void)>;
+
+  ShmItemWorker(std::string channel_name, WorkerParameters parameters);
+
+  // ShmItemWorker is non-copyable
+  ShmItemWorker(const ShmItemWorker& other) = delete;
+  ShmItemWorker& operator=(const ShmItemWorker& other) = delete;
+  ShmItemWorker(ShmItemWorker&& other) = delete;
+  ShmItemWorker& operator=(ShmItemWorker&& other) = delete;
+
+  ~ShmItemWorker();
+
+  // Check whether a shared memory item channel with this name exists
+  static bool available(const std::string& channel_name);
+
+  void set_disconnect_callback(DisconnectCallback callback) {
+    disconnect_callback_ = std::move(callback);
+  }
+
+  std::shared_ptr<const Item> get();
+
+  // Wait for the next item until the given time, return nullptr if there is
+  // none by then
+  std::shared_ptr<const Item>
+  get_until(std::chrono::steady_clock::time_point deadline);
+
+  [[nodiscard]] WorkerParameters parameters() const { return parameters_; }
+
+  void stop() { stopped_ = true; }
+
+private:
+  bool connect();
+
+  void disconnect();
+
+  // Return false if the distributor has closed the channel, throw a
+  // WorkerProtocolError if the connection has been lost otherwise
+  bool check_connection();
+
+  void send_pending_completions();
+
+  const std::string channel_name_;
+  std::unique_ptr<boost::interprocess::managed_shared_memory> managed_shm_;
+  ShmItemChannel* channel_ = nullptr;
+  ShmWorkerSlot* slot_ = nullptr;
+  uint32_t generation_ = 0;
+  DisconnectCallback disconnect_callback_ = [] {};
+
+  const WorkerParameters parameters_;
+  // Items received through the current connection
+  std::set<ItemID> items_;
+  CompletedItems completed_items_;
+  std::chrono::steady_clock::time_point last_liveness_check_;
+  bool stopped_ = false;
+};
+
+#endif
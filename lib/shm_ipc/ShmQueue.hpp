@@ -0,0 +1,171 @@
+#ifndef SHM_IPC_SHMQUEUE_HPP
+#define SHM_IPC_SHMQUEUE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+
+#ifdef __linux__
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Primitives for inter-process communication through shared memory. All
+ * objects consist of lock-free atomics only and can be placed in a shared
+ * memory segment mapped at different addresses in different processes.
+ */
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free &&
+                  std::atomic<uint64_t>::is_always_lock_free,
+              "shared memory queues require lock-free atomics");
+
+/**
+ * An event counter that a process can wait on until it is notified by
+ * another process. On Linux, waiting uses a shared futex; elsewhere, it
+ * falls back to periodic polling.
+ */
+class ShmEvent {
+public:
+  // Retrieve the current event count, to be passed to wait()
+  [[nodiscard]] uint32_t count() const {
+    return count_.load(std::memory_order_acquire);
+  }
+
+  // Notify all waiting processes
+  void notify() {
+    count_.fetch_add(1, std::memory_order_acq_rel);
+#ifdef __linux__
+    if (waiters_.load(std::memory_order_acquire) != 0) {
+      syscall(SYS_futex, word(), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+    }
+#endif
+  }
+
+  // Wait until the event count differs from "count" or the timeout expires
+  void wait(uint32_t count, std::chrono::milliseconds timeout) {
+#ifdef __linux__
+    waiters_.fetch_add(1, std::memory_order_acq_rel);
+    if (count_.load(std::memory_order_acquire) == count) {
+      struct timespec ts {};
+      ts.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+      ts.tv_nsec = static_cast<long>((timeout.count() % 1000) * 1000000);
+      syscall(SYS_futex, word(), FUTEX_WAIT, count, &ts, nullptr, 0);
+    }
+    waiters_.fetch_sub(1, std::memory_order_acq_rel);
+#else
+    constexpr auto poll_interval = std::chrono::milliseconds{1};
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (count_.load(std::memory_order_acquire) == count &&
+           std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(poll_interval);
+    }
+#endif
+  }
+
+private:
+#ifdef __linux__
+  uint32_t* word() { return reinterpret_cast<uint32_t*>(&count_); }
+#endif
+
+  std::atomic<uint32_t> count_{0};
+  std::atomic<uint32_t> waiters_{0};
+};
+
+/**
+ * A bounded lock-free multi-producer/multi-consumer queue (D. Vyukov's
+ * algorithm). Each cell carries a sequence number that tells producers and
+ * consumers whether it is free or filled for their current position.
+ *
+ * A process that dies between claiming and publishing a cell blocks the
+ * queue at that position; use reset() to recover once all users are gone.
+ */
+template <typename T, size_t Capacity> class ShmMpmcQueue {
+  static_assert((Capacity & (Capacity - 1)) == 0 && Capacity >= 2,
+                "capacity must be a power of two");
+  static_assert(std::is_trivially_copyable_v<T>,
+                "elements must be trivially copyable");
+
+public:
+  ShmMpmcQueue() { reset(); }
+
+  ShmMpmcQueue(const ShmMpmcQueue&) = delete;
+  ShmMpmcQueue& operator=(const ShmMpmcQueue&) = delete;
+
+  // Reinitialize the queue (not thread-safe)
+  void reset() {
+    for (size_t i = 0; i < Capacity; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    enqueue_pos_.store(0, std::memory_order_relaxed);
+    dequeue_pos_.store(0, std::memory_order_release);
+  }
+
+  // Append an element, return false if the queue is full
+  bool try_push(const T& value) {
+    Cell* cell;
+    uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      cell = &cells_[pos & (Capacity - 1)];
+      const uint64_t seq = cell->sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<int64_t>(seq - pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    cell->data = value;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Remove the oldest element, return false if the queue is empty
+  bool try_pop(T& value) {
+    Cell* cell;
+    uint64_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      cell = &cells_[pos & (Capacity - 1)];
+      const uint64_t seq = cell->sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<int64_t>(seq - (pos + 1));
+      if (diff == 0) {
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    value = cell->data;
+    cell->sequence.store(pos + Capacity, std::memory_order_release);
+    return true;
+  }
+
+private:
+  static constexpr size_t cache_line_size = 64;
+
+  struct Cell {
+    std::atomic<uint64_t> sequence;
+    T data;
+  };
+
+  alignas(cache_line_size) std::atomic<uint64_t> enqueue_pos_{0};
+  alignas(cache_line_size) std::atomic<uint64_t> dequeue_pos_{0};
+  alignas(cache_line_size) Cell cells_[Capacity];
+};
+
+#endif
@@ -0,0 +1,118 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: GPL-3.0-only
+# (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+"""Run a performance test and compare its results against a baseline.
+
+The command given after "--" has to print its results to stdout in the JSON
+format of Google Benchmark (--benchmark_format=json), of which the fields
+"name", "real_time" and "time_unit" of each benchmark are used. Repetitions
+of a benchmark are reduced to their minimum time, aggregates are ignored.
+
+A benchmark is a regression if its time exceeds the baseline by more than
+the tolerance. Benchmarks without baseline are reported as new. The report
+is written as JSON to the output file. If the environment variable
+FLESNET_PERF_UPDATE is set to 1, the baseline is replaced by the results.
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+
+TIME_UNITS = {'ns': 1.0, 'us': 1e3, 'ms': 1e6, 's': 1e9}
+
+
+def parse_results(text):
+    """Extract the times in ns by benchmark name."""
+    times = {}
+    for bench in json.loads(text).get('benchmarks', []):
+        if bench.get('run_type') == 'aggregate':
+            continue
+        time = bench['real_time'] * TIME_UNITS[bench.get('time_unit', 'ns')]
+        name = bench['name']
+        times[name] = min(time, times.get(name, time))
+    return times
+
+
+def compare(times, baseline, tolerance):
+    """Compare the times against the baseline times."""
+    results = []
+    for name, time in sorted(times.items()):
+        entry = {'name': name, 'time_ns': time}
+        reference = baseline.get(name)
+        if reference is None:
+            entry['status'] = 'new'
+        else:
+            ratio = time / reference
+            entry['baseline_ns'] = reference
+            entry['ratio'] = ratio
+            if ratio > 1 + tolerance:
+                entry['status'] = 'regression'
+            elif ratio < 1 - tolerance:
+                entry['status'] = 'improved'
+            else:
+                entry['status'] = 'ok'
+        results.append(entry)
+    for name in sorted(set(baseline) - set(times)):
+        results.append({'name': name, 'baseline_ns': baseline[name],
+                        'status': 'missing'})
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(prog='perf_check.py',
+                                     description=__doc__.splitlines()[0])
+    parser.add_argument('--name', required=True, help='name of the test')
+    parser.add_argument('--baseline', required=True,
+                        help='JSON file of baseline times in ns by name')
+    parser.add_argument('--output', required=True,
+                        help='JSON report file to write')
+    parser.add_argument('--tolerance', type=float, default=0.15,
+                        help='relative slowdown tolerated (default: 0.15)')
+    parser.add_argument('command', nargs=argparse.REMAINDER,
+                        help='-- command printing the results')
+    options = parser.parse_args()
+    command = options.command[1:] if options.command[:1] == ['--'] \
+        else options.command
+    if not command:
+        parser.error('no command given')
+
+    run = subprocess.run(command, stdout=subprocess.PIPE, check=False,
+                         universal_newlines=True)
+    if run.returncode != 0:
+        raise SystemExit('{}: command failed with exit code {}'.format(
+            options.name, run.returncode))
+    times = parse_results(run.stdout)
+
+    baseline = {}
+    if os.path.exists(options.baseline):
+        with open(options.baseline) as infile:
+            baseline = json.load(infile)
+
+    update = os.environ.get('FLESNET_PERF_UPDATE') == '1'
+    results = compare(times, baseline, options.tolerance)
+    regressions = [r for r in results if r['status'] == 'regression']
+    report = {'name': options.name, 'tolerance': options.tolerance,
+              'baseline': options.baseline, 'updated': update,
+              'passed': update or not regressions, 'results': results}
+    with open(options.output, 'w') as outfile:
+        json.dump(report, outfile, indent=2)
+
+    for r in results:
+        ratio = ' ({:.2f}x)'.format(r['ratio']) if 'ratio' in r else ''
+        print('{}: {} {}{}'.format(options.name, r['name'], r['status'],
+                                   ratio))
+    if update:
+        os.makedirs(os.path.dirname(os.path.abspath(options.baseline)),
+                    exist_ok=True)
+        with open(options.baseline, 'w') as outfile:
+            json.dump(times, outfile, indent=2, sort_keys=True)
+        print('{}: baseline {} updated'.format(options.name,
+                                               options.baseline))
+    elif regressions:
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,50 @@
+#!/bin/bash
+# SPDX-License-Identifier: GPL-3.0-only
+# (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#
+# Short end-to-end runs on the local node, printing the time per timeslice
+# in the JSON format of Google Benchmark (see perf_check.py).
+#
+# usage: perf_loopback.sh <tsclient> <flesnet> <reference dir>
+
+set -o errexit
+set -o pipefail
+
+tsclient=$1
+flesnet=$2
+reference=$3
+cycles=${PERF_ARCHIVE_CYCLES:-20000}
+timeslices=${PERF_LOOPBACK_TIMESLICES:-2000}
+
+now() { date +%s%N; }
+
+results=()
+
+# Print a result, the time per timeslice in ns
+result() {
+  local name=$1 begin=$2 end=$3 count=$4
+  results+=("$(printf '{"name": "%s", "real_time": %d, "time_unit": "ns", "iterations": %d}' \
+    "$name" $(((end - begin) / count)) "$count")")
+}
+
+# Archive reading and pattern analysis of the reference data
+begin=$(now)
+"$tsclient" -i "file://$reference/example1.tsa?cycles=$cycles" -a \
+  -l 3 >&2
+result loopback/archive_analyze "$begin" "$(now)" $((cycles * 2))
+
+# Pattern generator to zeromq transport to shared memory to tsclient
+shm=perf_loopback_$$
+begin=$(now)
+"$flesnet" -l 3 -t zeromq -n "$timeslices" --timeslice-size 100 \
+  -I "pgen://127.0.0.1/?mean=102400&overlap=1&pattern=0" \
+  -O "shm://127.0.0.1/$shm?datasize=27&descsize=19" \
+  --processor-executable "$tsclient -c%i -ishm:%s -a -l 3" \
+  --processor-instances 1 >&2
+result loopback/pgen_zeromq_shm_tsclient "$begin" "$(now)" "$timeslices"
+
+printf '{"benchmarks": [\n'
+for i in "${!results[@]}"; do
+  printf '  %s%s\n' "${results[$i]}" "$([ "$i" -lt $((${#results[@]} - 1)) ] && echo ,)"
+done
+printf ']}\n'
@@ -26,16 +26,19 @@ public:
     while (i_ < item_count_limit_ || !outstanding_.empty()) {
 
       // receive completion messages if available
-      while (true) {
-        ItemID id;
-        bool result = try_receive_completion(&id);
-        if (!result) {
-          break;
+      ItemCompletionBatch batch;
+      while (try_receive_completions(&batch)) {
+        auto range_end = outstanding_.lower_bound(batch.completed_up_to);
+        for (auto it = outstanding_.begin(); it != range_end; ++it) {
+          std::cout << "Producer RELEASE item " << *it << std::endl;
+        }
+        outstanding_.erase(outstanding_.begin(), range_end);
+        for (auto id : batch.completed) {
+          std::cout << "Producer RELEASE item " << id << std::endl;
+          if (outstanding_.erase(id) != 1) {
+            std::cerr << "Error: invalid item " << id << std::endl;
+          };
         }
-        std::cout << "Producer RELEASE item " << id << std::endl;
-        if (outstanding_.erase(id) != 1) {
-          std::cerr << "Error: invalid item " << id << std::endl;
-        };
       }
 
       wait();
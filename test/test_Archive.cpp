@@ -2,14 +2,41 @@
 #define BOOST_TEST_MODULE test_Archive
 #include <boost/test/unit_test.hpp>
 
+#include "ArchiveManifest.hpp"
+#include "ByteShuffle.hpp"
+#include "ChunkCodec.hpp"
+#include "ChunkedTimesliceInputArchive.hpp"
+#include "ChunkedTimesliceOutputArchive.hpp"
+#include "ComponentFilter.hpp"
+#include "DescriptorCodec.hpp"
 #include "MergingSource.hpp"
 #include "MicrosliceInputArchive.hpp"
 #include "MicrosliceOutputArchive.hpp"
+#include "NativeInputArchive.hpp"
+#include "NativeMicrosliceBlockOutputArchive.hpp"
+#include "NativeOutputArchive.hpp"
+#include "ParallelSource.hpp"
+#include "PrefetchingSource.hpp"
+#include "SourceMultiplexer.hpp"
+#include "StorableTimeslice.hpp"
+#include "ThreadedPollableSource.hpp"
+#include "TimesliceArchiveConverter.hpp"
+#include "TimesliceCachedArchiveLoop.hpp"
+#include "TimesliceIndexedInputArchive.hpp"
 #include "TimesliceInputArchive.hpp"
+#include "TimesliceMappedArchive.hpp"
 #include "TimesliceOutputArchive.hpp"
 #include "TimesliceSource.hpp"
+#include "ZstdDictionary.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <memory>
+#include <vector>
 
 BOOST_AUTO_TEST_CASE(timeslice_output_archive_sequence_test) {
   fles::TimesliceInputArchiveLoop source("example1.tsa", 3);
@@ -82,17 +109,1073 @@ BOOST_AUTO_TEST_CASE(microslice_input_archive_sequence_test) {
 }
 
 BOOST_AUTO_TEST_CASE(merging_input_archive_test) {
-  std::unique_ptr<fles::TimesliceSource> source0 =
-      std::make_unique<fles::TimesliceInputArchiveSequence>("test2_%n.tsa");
-  std::unique_ptr<fles::TimesliceSource> source1 =
-      std::make_unique<fles::TimesliceInputArchive>("example1.tsa");
+  for (std::size_t prefetch : {0, 2}) {
+    std::unique_ptr<fles::TimesliceSource> source0 =
+        std::make_unique<fles::TimesliceInputArchiveSequence>("test2_%n.tsa");
+    std::unique_ptr<fles::TimesliceSource> source1 =
+        std::make_unique<fles::TimesliceInputArchive>("example1.tsa");
+    std::vector<std::unique_ptr<fles::TimesliceSource>> sources;
+    sources.emplace_back(std::move(source0));
+    sources.emplace_back(std::move(source1));
+    fles::MergingSource<fles::TimesliceSource> merging_source{
+        std::move(sources), prefetch};
+    uint64_t count = 0;
+    uint64_t last_index = 0;
+    while (auto timeslice = merging_source.get()) {
+      BOOST_CHECK_GE(timeslice->index(), last_index);
+      last_index = timeslice->index();
+      ++count;
+    }
+    BOOST_CHECK_EQUAL(count, 8);
+    BOOST_CHECK(merging_source.eos());
+  }
+}
+
+static void check_equal_timeslices(const fles::Timeslice& a,
+                                   const fles::Timeslice& b) {
+  BOOST_CHECK_EQUAL(a.index(), b.index());
+  BOOST_CHECK_EQUAL(a.num_core_microslices(), b.num_core_microslices());
+  BOOST_REQUIRE_EQUAL(a.num_components(), b.num_components());
+  for (uint64_t c = 0; c < a.num_components(); ++c) {
+    BOOST_REQUIRE_EQUAL(a.num_microslices(c), b.num_microslices(c));
+    BOOST_CHECK_EQUAL(a.size_component(c), b.size_component(c));
+    for (uint64_t m = 0; m < a.num_microslices(c); ++m) {
+      BOOST_CHECK_EQUAL(a.descriptor(c, m).idx, b.descriptor(c, m).idx);
+      BOOST_CHECK_EQUAL(a.descriptor(c, m).eq_id, b.descriptor(c, m).eq_id);
+      BOOST_CHECK_EQUAL_COLLECTIONS(
+          a.content(c, m), a.content(c, m) + a.descriptor(c, m).size,
+          b.content(c, m), b.content(c, m) + b.descriptor(c, m).size);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(mapped_input_archive_test) {
+  for (const auto* filename : {"example1.tsa", "test3.tsa"}) {
+    fles::TimesliceInputArchive reference(filename);
+    fles::TimesliceMappedArchive source(filename);
+    uint64_t count = 0;
+    while (auto timeslice = source.get()) {
+      auto expected = reference.get();
+      BOOST_REQUIRE(expected);
+      check_equal_timeslices(*timeslice, *expected);
+      ++count;
+    }
+    BOOST_CHECK(source.eos());
+    BOOST_CHECK(!reference.get());
+    BOOST_CHECK_EQUAL(count, source.num_timeslices());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(mapped_descriptors_only_test) {
+  fles::TimesliceInputArchive reference("example1.tsa");
+  fles::TimesliceMappedArchive source("example1.tsa", {}, true);
+  uint64_t count = 0;
+  while (auto timeslice = source.get()) {
+    auto full = reference.get();
+    BOOST_REQUIRE(full);
+    const fles::StorableTimeslice expected(*full, true);
+    BOOST_REQUIRE_EQUAL(timeslice->num_components(), expected.num_components());
+    for (uint64_t c = 0; c < timeslice->num_components(); ++c) {
+      BOOST_CHECK_EQUAL(timeslice->content_omitted(c),
+                        full->size_component(c) != expected.size_component(c));
+      BOOST_CHECK_EQUAL(timeslice->size_component(c),
+                        expected.size_component(c));
+      BOOST_REQUIRE_EQUAL(timeslice->num_microslices(c),
+                          expected.num_microslices(c));
+      for (uint64_t m = 0; m < timeslice->num_microslices(c); ++m) {
+        BOOST_CHECK_EQUAL(timeslice->descriptor(c, m).idx,
+                          expected.descriptor(c, m).idx);
+        BOOST_CHECK_EQUAL(timeslice->descriptor(c, m).size,
+                          expected.descriptor(c, m).size);
+      }
+    }
+    ++count;
+  }
+  BOOST_CHECK(!reference.get());
+  BOOST_CHECK_EQUAL(count, source.num_timeslices());
+}
+
+BOOST_AUTO_TEST_CASE(storable_timeslice_copy_test) {
+  {
+    fles::TimesliceInputArchive source("example1.tsa");
+    fles::TimesliceOutputArchive sink("test9.tsa");
+    while (auto timeslice = source.get()) {
+      // copy once more to exercise the arena reuse
+      std::shared_ptr<const fles::Timeslice> ts =
+          std::make_shared<fles::StorableTimeslice>(*timeslice);
+      check_equal_timeslices(*ts, *timeslice);
+      timeslice.reset();
+      sink.put(ts);
+    }
+  }
+  // the mapped archive parser checks the serialized layout
+  fles::TimesliceInputArchive reference("example1.tsa");
+  fles::TimesliceMappedArchive source("test9.tsa");
+  while (auto timeslice = source.get()) {
+    auto expected = reference.get();
+    BOOST_REQUIRE(expected);
+    check_equal_timeslices(*timeslice, *expected);
+  }
+  BOOST_CHECK(!reference.get());
+}
+
+BOOST_AUTO_TEST_CASE(cached_archive_loop_test) {
+  {
+    fles::TimesliceInputArchiveLoop reference("example1.tsa", 2);
+    fles::TimesliceCachedArchiveLoop source("example1.tsa", 2);
+    // views are written directly, the mapped archive parser checks the
+    // serialized layout below
+    fles::TimesliceOutputArchive sink("test10.tsa");
+    uint64_t count = 0;
+    while (auto timeslice = source.get()) {
+      auto expected = reference.get();
+      BOOST_REQUIRE(expected);
+      check_equal_timeslices(*timeslice, *expected);
+      sink.put(std::move(timeslice));
+      ++count;
+    }
+    BOOST_CHECK(source.eos());
+    BOOST_CHECK(!reference.get());
+    BOOST_CHECK_EQUAL(count, 2 * source.num_timeslices());
+  }
+  fles::TimesliceInputArchiveLoop reference("example1.tsa", 2);
+  fles::TimesliceMappedArchive written("test10.tsa");
+  while (auto timeslice = written.get()) {
+    auto expected = reference.get();
+    BOOST_REQUIRE(expected);
+    check_equal_timeslices(*timeslice, *expected);
+  }
+  BOOST_CHECK(!reference.get());
+}
+
+BOOST_AUTO_TEST_CASE(cached_archive_loop_renumber_test) {
+  fles::TimesliceCachedArchiveLoop source("example1.tsa", 3, true);
+  const uint64_t n = source.num_timeslices();
+  BOOST_REQUIRE(n > 0);
+  std::vector<uint64_t> indexes;
+  while (auto timeslice = source.get()) {
+    indexes.push_back(timeslice->index());
+  }
+  BOOST_REQUIRE_EQUAL(indexes.size(), 3 * n);
+  BOOST_CHECK(std::is_sorted(indexes.begin(), indexes.end()));
+  BOOST_CHECK_GT(indexes[n], indexes[n - 1]);
+  BOOST_CHECK_EQUAL(indexes[2 * n] - indexes[n], indexes[n] - indexes[0]);
+}
+
+BOOST_AUTO_TEST_CASE(mapped_input_archive_empty_component_test) {
+  fles::TimesliceInputArchive input("example1.tsa");
+  auto first = input.get();
+  {
+    fles::TimesliceOutputArchive sink("test5.tsa");
+    // A leading timeslice without components defers some boost class info
+    sink.put(std::make_shared<fles::StorableTimeslice>(1, 0));
+    sink.put(std::move(first));
+  }
+  fles::TimesliceMappedArchive source(
+      std::vector<std::string>{"test5.tsa", "example1.tsa"});
+  uint64_t count = 0;
+  while (auto timeslice = source.get()) {
+    ++count;
+  }
+  BOOST_CHECK_EQUAL(count, 4);
+}
+
+BOOST_AUTO_TEST_CASE(indexed_input_archive_test) {
+  // The timeslices in example1.tsa have index 1; surround them by empty
+  // timeslices with index 0 and 2
+  std::vector<std::unique_ptr<fles::StorableTimeslice>> reference;
+  {
+    fles::TimesliceInputArchive input("example1.tsa");
+    fles::TimesliceOutputArchive sink("test6.tsa",
+                                      fles::ArchiveCompression::None, true);
+    // A leading timeslice without components defers some boost class info
+    sink.put(std::make_shared<fles::StorableTimeslice>(1, 0));
+    while (auto timeslice = input.get()) {
+      reference.push_back(
+          std::make_unique<fles::StorableTimeslice>(*timeslice));
+      sink.put(std::move(timeslice));
+    }
+    sink.put(std::make_shared<fles::StorableTimeslice>(1, 2));
+  }
+  BOOST_REQUIRE_EQUAL(reference.size(), 2);
+
+  auto index = fles::ArchiveIndex::read("test6.tsa.idx");
+  auto scanned = fles::TimesliceIndexedInputArchive::build_index("test6.tsa");
+  BOOST_REQUIRE_EQUAL(index.size(), reference.size() + 2);
+  BOOST_REQUIRE_EQUAL(scanned.size(), index.size());
+  for (std::size_t i = 0; i < index.size(); ++i) {
+    BOOST_CHECK_EQUAL(index.entries()[i].index, scanned.entries()[i].index);
+    BOOST_CHECK_EQUAL(index.entries()[i].offset, scanned.entries()[i].offset);
+    BOOST_CHECK_EQUAL(index.entries()[i].size, scanned.entries()[i].size);
+    BOOST_CHECK_EQUAL(index.entries()[i].start_time,
+                      scanned.entries()[i].start_time);
+  }
+
+  fles::TimesliceIndexedInputArchive source("test6.tsa", 1, 1);
+  for (const auto& expected : reference) {
+    auto timeslice = source.get();
+    BOOST_REQUIRE(timeslice);
+    check_equal_timeslices(*timeslice, *expected);
+  }
+  BOOST_CHECK(!source.get());
+  BOOST_CHECK(source.eos());
+
+  fles::TimesliceIndexedInputArchive tail("test6.tsa", 2);
+  auto timeslice = tail.get();
+  BOOST_REQUIRE(timeslice);
+  BOOST_CHECK_EQUAL(timeslice->index(), 2);
+  BOOST_CHECK(!tail.get());
+}
+
+BOOST_AUTO_TEST_CASE(archive_converter_test) {
+  std::vector<std::unique_ptr<fles::StorableTimeslice>> reference;
+  {
+    fles::TimesliceOutputArchive sink("test11.tsa");
+    // A leading timeslice without components defers some boost class info
+    sink.put(std::make_shared<fles::StorableTimeslice>(1, 0));
+    reference.push_back(std::make_unique<fles::StorableTimeslice>(1, 0));
+    for (int i = 0; i < 3; ++i) {
+      fles::TimesliceInputArchive input("example1.tsa");
+      while (auto timeslice = input.get()) {
+        reference.push_back(
+            std::make_unique<fles::StorableTimeslice>(*timeslice));
+        sink.put(std::move(timeslice));
+      }
+    }
+  }
+  const std::size_t n = reference.size();
+
+  fles::ArchiveConversion conversion;
+  conversion.items_per_file = 3;
+  conversion.threads = 2;
+  fles::TimesliceArchiveConverter converter({"test11.tsa", "test11.tsa"},
+                                            "test11_%n.tsa", conversion);
+  BOOST_REQUIRE_EQUAL(converter.num_output_files(), (2 * n + 2) / 3);
+  auto statistics = converter.run();
+  BOOST_CHECK_EQUAL(statistics.files, converter.num_output_files());
+  BOOST_CHECK_EQUAL(statistics.copied + statistics.transformed, 2 * n);
+  BOOST_CHECK_GT(statistics.copied, 0);
+
+  std::size_t count = 0;
+  for (std::size_t f = 0; f < converter.num_output_files(); ++f) {
+    const auto filename = converter.output_filename(f);
+    // the mapped archive parser checks the serialized layout
+    fles::TimesliceMappedArchive mapped(filename);
+    fles::TimesliceIndexedInputArchive indexed(filename);
+    while (auto timeslice = mapped.get()) {
+      const auto& expected = *reference[count % n];
+      check_equal_timeslices(*timeslice, expected);
+      auto read = indexed.get();
+      BOOST_REQUIRE(read);
+      check_equal_timeslices(*read, expected);
+      ++count;
+    }
+    BOOST_CHECK(!indexed.get());
+  }
+  BOOST_CHECK_EQUAL(count, 2 * n);
+
+  // a change of the descriptor encoding transforms all timeslices
+  conversion.items_per_file = 0;
+  conversion.descriptor_encoding = fles::DescriptorEncoding::Compact;
+  conversion.first = 1;
+  fles::TimesliceArchiveConverter compact({"test11.tsa"}, "test12.tsa",
+                                          conversion);
+  BOOST_REQUIRE_EQUAL(compact.num_output_files(), 1);
+  BOOST_CHECK_EQUAL(compact.output_filename(0), "test12.tsa");
+  statistics = compact.run();
+  BOOST_CHECK_EQUAL(statistics.copied, 0);
+  BOOST_CHECK_EQUAL(statistics.transformed, n - 1);
+  fles::TimesliceInputArchive input("test12.tsa");
+  BOOST_CHECK(input.descriptor().descriptor_encoding() ==
+              fles::DescriptorEncoding::Compact);
+  for (std::size_t i = 1; i < n; ++i) {
+    auto timeslice = input.get();
+    BOOST_REQUIRE(timeslice);
+    check_equal_timeslices(*timeslice, *reference[i]);
+  }
+  BOOST_CHECK(!input.get());
+}
+
+BOOST_AUTO_TEST_CASE(zstd_frame_output_archive_test) {
+  fles::ZstdParameters parameters;
+  parameters.level = 3;
+  parameters.threads = 2;
+  parameters.frame_size = 256; // force several frames per timeslice
+  {
+    fles::TimesliceInputArchive source("example1.tsa");
+    fles::TimesliceOutputArchive sink(
+        "test7.tsa", fles::ArchiveCompression::Zstd, false, parameters);
+    while (auto timeslice = source.get()) {
+      sink.put(std::move(timeslice));
+    }
+  }
+  fles::TimesliceInputArchive reference("example1.tsa");
+  fles::TimesliceInputArchive source("test7.tsa");
+  BOOST_CHECK(source.descriptor().archive_compression() ==
+              fles::ArchiveCompression::Zstd);
+  uint64_t count = 0;
+  while (auto timeslice = source.get()) {
+    auto expected = reference.get();
+    BOOST_REQUIRE(expected);
+    check_equal_timeslices(*timeslice, *expected);
+    ++count;
+  }
+  BOOST_CHECK(!reference.get());
+  BOOST_CHECK_EQUAL(count, 2);
+}
+
+BOOST_AUTO_TEST_CASE(chunked_archive_test) {
+  for (auto compression :
+       {fles::ArchiveCompression::None, fles::ArchiveCompression::Zstd}) {
+    {
+      fles::TimesliceInputArchive source("example1.tsa");
+      fles::ChunkedTimesliceOutputArchive sink("test8.tsa", compression);
+      while (auto timeslice = source.get()) {
+        sink.put(std::move(timeslice));
+      }
+    }
+
+    // Without filter, the chunked archive reproduces the original data
+    {
+      fles::TimesliceInputArchive reference("example1.tsa");
+      fles::ChunkedTimesliceInputArchive source("test8.tsa");
+      uint64_t count = 0;
+      while (auto timeslice = source.get()) {
+        auto expected = reference.get();
+        BOOST_REQUIRE(expected);
+        check_equal_timeslices(*timeslice, *expected);
+        ++count;
+      }
+      BOOST_CHECK(!reference.get());
+      BOOST_CHECK_EQUAL(count, 2);
+    }
+
+    // Select the components of the first component's subsystem/equipment
+    fles::TimesliceInputArchive reference("example1.tsa");
+    auto first = reference.get();
+    BOOST_REQUIRE(first->num_components() > 0);
+    BOOST_REQUIRE(first->num_microslices(0) > 0);
+    fles::ComponentFilter filter;
+    filter.sys_ids.insert(first->descriptor(0, 0).sys_id);
+    filter.eq_ids.insert(first->descriptor(0, 0).eq_id);
+    fles::ChunkedTimesliceInputArchive source("test8.tsa", filter);
+    auto timeslice = source.get();
+    BOOST_REQUIRE(timeslice);
+    BOOST_CHECK_GE(timeslice->num_components(), 1);
+    for (uint64_t c = 0; c < timeslice->num_components(); ++c) {
+      BOOST_CHECK(filter.matches(timeslice->descriptor(c, 0).sys_id,
+                                 timeslice->descriptor(c, 0).eq_id));
+    }
+
+    // A filter matching nothing yields timeslices without components
+    filter.eq_ids = {0xffff};
+    fles::ChunkedTimesliceInputArchive empty("test8.tsa", filter);
+    timeslice = empty.get();
+    BOOST_REQUIRE(timeslice);
+    BOOST_CHECK_EQUAL(timeslice->index(), first->index());
+    BOOST_CHECK_EQUAL(timeslice->num_components(), 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(lazy_chunked_archive_test) {
+  for (auto compression :
+       {fles::ArchiveCompression::None, fles::ArchiveCompression::Zstd}) {
+    {
+      fles::TimesliceInputArchive source("example1.tsa");
+      fles::ChunkedTimesliceOutputArchive sink("test15.tsa", compression);
+      while (auto timeslice = source.get()) {
+        sink.put(std::move(timeslice));
+      }
+    }
+
+    // The components are read on first access, in any order
+    fles::TimesliceInputArchive reference("example1.tsa");
+    fles::ChunkedTimesliceInputArchive source("test15.tsa");
+    uint64_t count = 0;
+    while (auto timeslice = source.get_lazy()) {
+      auto expected = reference.get();
+      BOOST_REQUIRE(expected);
+      BOOST_REQUIRE_EQUAL(timeslice->num_components(),
+                          expected->num_components());
+      for (uint64_t c = timeslice->num_components(); c-- > 0;) {
+        BOOST_CHECK(!timeslice->component_loaded(c));
+        BOOST_CHECK_EQUAL(timeslice->num_microslices(c),
+                          expected->num_microslices(c));
+      }
+      check_equal_timeslices(*timeslice, *expected);
+      ++count;
+    }
+    BOOST_CHECK_EQUAL(count, 2);
+
+    // In lazy mode, the source interface returns lazy timeslices
+    fles::ChunkedTimesliceInputArchive lazy("test15.tsa");
+    lazy.set_lazy(true, 64);
+    fles::TimesliceSource& lazy_source = lazy;
+    auto timeslice = lazy_source.get();
+    BOOST_REQUIRE(timeslice);
+    BOOST_CHECK(dynamic_cast<fles::LazyTimeslice*>(timeslice.get()));
+    timeslice->materialize();
+    BOOST_CHECK(static_cast<fles::LazyTimeslice&>(*timeslice)
+                    .component_loaded(0));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(native_archive_test) {
+  {
+    fles::TimesliceInputArchive source("example1.tsa");
+    fles::NativeTimesliceOutputArchive sink("test16.tsa");
+    while (auto timeslice = source.get()) {
+      sink.put(std::move(timeslice));
+    }
+  }
+  BOOST_CHECK(fles::is_native_archive("test16.tsa"));
+  BOOST_CHECK(!fles::is_native_archive("example1.tsa"));
+
+  {
+    fles::TimesliceInputArchive reference("example1.tsa");
+    fles::NativeTimesliceInputArchive source("test16.tsa");
+    BOOST_CHECK_EQUAL(source.header().version, fles::native_archive_version);
+    uint64_t count = 0;
+    while (auto timeslice = source.get()) {
+      auto expected = reference.get();
+      BOOST_REQUIRE(expected);
+      check_equal_timeslices(*timeslice, *expected);
+      ++count;
+    }
+    BOOST_CHECK_EQUAL(count, 2);
+    BOOST_CHECK(source.eos());
+  }
+
+  // A corrupted byte in the last frame fails the checksum
+  const auto size = std::filesystem::file_size("test16.tsa");
+  {
+    std::fstream file("test16.tsa",
+                      std::ios::in | std::ios::out | std::ios::binary);
+    file.seekg(static_cast<std::streamoff>(size - 1));
+    const auto byte = static_cast<char>(file.get() ^ 0x01);
+    file.seekp(static_cast<std::streamoff>(size - 1));
+    file.put(byte);
+  }
+  {
+    fles::NativeTimesliceInputArchive source("test16.tsa");
+    BOOST_CHECK(source.get());
+    BOOST_CHECK_THROW(source.get(), std::runtime_error);
+  }
+  {
+    fles::NativeTimesliceInputArchive source("test16.tsa", false);
+    BOOST_CHECK(source.get());
+    BOOST_CHECK(source.get());
+  }
+
+  // A truncated last frame is ignored
+  std::filesystem::resize_file("test16.tsa", size - 100);
+  {
+    fles::NativeTimesliceInputArchive source("test16.tsa");
+    BOOST_CHECK(source.get());
+    BOOST_CHECK(!source.get());
+  }
+
+  BOOST_CHECK_THROW(fles::NativeMicrosliceInputArchive("test16.tsa"),
+                    std::runtime_error);
+  BOOST_CHECK_THROW(fles::NativeTimesliceInputArchive("example1.tsa"),
+                    std::runtime_error);
+
+  {
+    fles::MicrosliceInputArchive source("example2.msa");
+    fles::NativeMicrosliceOutputArchive sink("test16.msa");
+    while (auto microslice = source.get()) {
+      sink.put(std::move(microslice));
+    }
+  }
+  fles::MicrosliceInputArchive reference("example2.msa");
+  fles::NativeMicrosliceInputArchive source("test16.msa");
+  uint64_t count = 0;
+  while (auto microslice = source.get()) {
+    auto expected = reference.get();
+    BOOST_REQUIRE(expected);
+    BOOST_CHECK_EQUAL(microslice->desc().idx, expected->desc().idx);
+    BOOST_REQUIRE_EQUAL(microslice->desc().size, expected->desc().size);
+    BOOST_CHECK(std::equal(microslice->content(),
+                           microslice->content() + microslice->desc().size,
+                           expected->content()));
+    ++count;
+  }
+  BOOST_CHECK(!reference.get());
+  BOOST_CHECK_GT(count, 0);
+}
+
+// Consecutive timeslices of two components with 4 core and 2 overlap
+// microslices, cut from contiguous microslice streams
+static fles::StorableTimeslice overlapping_timeslice(uint64_t index) {
+  constexpr uint64_t core = 4;
+  constexpr uint64_t overlap = 2;
+  fles::StorableTimeslice ts{core, index};
+  for (uint32_t c = 0; c < 2; ++c) {
+    ts.append_component(core + overlap);
+    for (uint64_t m = 0; m < core + overlap; ++m) {
+      const uint64_t idx = index * core + m;
+      const uint32_t size = 16 + 8 * c;
+      fles::MicrosliceDescriptor desc{};
+      desc.eq_id = static_cast<uint16_t>(c);
+      desc.idx = idx;
+      desc.size = size;
+      desc.offset = idx * size;
+      std::vector<uint8_t> content(size, static_cast<uint8_t>(idx + c));
+      ts.append_microslice(c, m, desc, content.data());
+    }
+  }
+  return ts;
+}
+
+BOOST_AUTO_TEST_CASE(native_archive_overlap_test) {
+  for (const bool overlap_refs : {false, true}) {
+    fles::NativeTimesliceOutputArchive sink(
+        overlap_refs ? "test17b.tsa" : "test17a.tsa", true, {}, overlap_refs);
+    for (uint64_t i = 0; i < 4; ++i) {
+      sink.put(std::make_shared<fles::StorableTimeslice>(
+          overlapping_timeslice(i)));
+    }
+  }
+  // the leading microslices of the last three timeslices are omitted, at
+  // the cost of the table of reused microslices
+  BOOST_CHECK_EQUAL(std::filesystem::file_size("test17a.tsa") -
+                        std::filesystem::file_size("test17b.tsa"),
+                    3 * (4 * sizeof(fles::MicrosliceDescriptor) + 2 * 16 +
+                         2 * 24) -
+                        4 * 2 * sizeof(uint64_t));
+
+  fles::NativeTimesliceInputArchive source("test17b.tsa");
+  uint64_t count = 0;
+  while (auto timeslice = source.get()) {
+    check_equal_timeslices(*timeslice, overlapping_timeslice(count));
+    ++count;
+  }
+  BOOST_CHECK_EQUAL(count, 4);
+}
+
+BOOST_AUTO_TEST_CASE(native_microslice_block_test) {
+  // views of consecutive microslices in one buffer, as in an input channel
+  constexpr std::size_t n = 10;
+  std::vector<fles::MicrosliceDescriptor> desc(n);
+  std::vector<uint8_t> content;
+  for (std::size_t i = 0; i < n; ++i) {
+    desc[i].idx = i;
+    desc[i].size = static_cast<uint32_t>(8 * (i % 3));
+    desc[i].offset = content.size();
+    content.insert(content.end(), desc[i].size, static_cast<uint8_t>(i));
+  }
+  {
+    fles::NativeMicrosliceBlockOutputArchive sink("test18.msa", 4);
+    for (std::size_t i = 0; i < n; ++i) {
+      sink.put(std::make_shared<fles::MicrosliceView>(
+          desc[i], content.data() + desc[i].offset));
+    }
+  }
+  BOOST_CHECK_EQUAL(std::filesystem::file_size("test18.msa"),
+                    sizeof(fles::NativeArchiveHeader) +
+                        3 * (sizeof(fles::NativeFrameHeader) +
+                             sizeof(uint64_t)) +
+                        n * sizeof(fles::MicrosliceDescriptor) +
+                        content.size());
+
+  auto check_equal = [&](const fles::Microslice& microslice) {
+    const uint64_t i = microslice.desc().idx;
+    BOOST_REQUIRE_LT(i, n);
+    BOOST_REQUIRE_EQUAL(microslice.desc().size, desc[i].size);
+    BOOST_CHECK(std::equal(microslice.content(),
+                           microslice.content() + microslice.desc().size,
+                           content.data() + desc[i].offset));
+  };
+  {
+    fles::NativeMicrosliceInputArchive source("test18.msa");
+    BOOST_CHECK(source.header().flags & fles::native_flag_microslice_blocks);
+    std::vector<std::size_t> sizes;
+    while (auto block = source.get_block()) {
+      sizes.push_back(block->size());
+      for (const auto& microslice : block->microslices()) {
+        check_equal(microslice);
+      }
+    }
+    BOOST_CHECK((sizes == std::vector<std::size_t>{4, 4, 2}));
+  }
+  {
+    // microslices one by one, then the rest of the block
+    fles::NativeMicrosliceInputArchive source("test18.msa");
+    auto first = source.get();
+    BOOST_REQUIRE(first);
+    BOOST_CHECK_EQUAL(first->desc().idx, 0);
+    auto block = source.get_block();
+    BOOST_REQUIRE(block);
+    BOOST_REQUIRE_EQUAL(block->size(), 3);
+    BOOST_CHECK_EQUAL(block->microslices().front().desc().idx, 1);
+    uint64_t count = 4;
+    while (auto microslice = source.get()) {
+      check_equal(*microslice);
+      ++count;
+    }
+    BOOST_CHECK_EQUAL(count, n);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(component_selection_test) {
+  fles::TimesliceInputArchive reference("example1.tsa");
+  auto first = reference.get();
+  BOOST_REQUIRE(first->num_components() > 1);
+  BOOST_REQUIRE(first->num_microslices(1) > 0);
+  const auto& selected = first->descriptor(1, 0);
+  fles::ComponentFilter filter;
+  filter.sys_ids.insert(selected.sys_id);
+  filter.eq_ids.insert(selected.eq_id);
+
+  // Expected result: the matching components of the reference timeslice
+  std::vector<uint64_t> expected;
+  for (uint64_t c = 0; c < first->num_components(); ++c) {
+    if (first->num_microslices(c) > 0 &&
+        filter.matches(first->descriptor(c, 0))) {
+      expected.push_back(c);
+    }
+  }
+
+  auto check_selection = [&](const fles::Timeslice& ts) {
+    BOOST_CHECK_EQUAL(ts.index(), first->index());
+    BOOST_REQUIRE_EQUAL(ts.num_components(), expected.size());
+    for (uint64_t c = 0; c < ts.num_components(); ++c) {
+      BOOST_REQUIRE_EQUAL(ts.size_component(c),
+                          first->size_component(expected[c]));
+      BOOST_CHECK_EQUAL(ts.descriptor(c, 0).eq_id,
+                        first->descriptor(expected[c], 0).eq_id);
+      BOOST_CHECK_EQUAL_COLLECTIONS(
+          ts.content(c, 0), ts.content(c, 0) + ts.descriptor(c, 0).size,
+          first->content(expected[c], 0),
+          first->content(expected[c], 0) + ts.descriptor(c, 0).size);
+    }
+  };
+
+  fles::StorableTimeslice sts(*first);
+  sts.select_components(filter);
+  check_selection(sts);
+  check_selection(fles::StorableTimeslice(sts));
+
+  fles::TimesliceMappedArchive mapped("example1.tsa", filter);
+  check_selection(*mapped.get());
+
+  fles::TimesliceIndexedInputArchive indexed("example1.tsa", 0, UINT64_MAX,
+                                             filter);
+  check_selection(*indexed.get());
+
+  // Unselected flags remove all components
+  filter.flags_clear = 0xffff;
+  filter.flags_set = 0xffff;
+  fles::TimesliceMappedArchive none("example1.tsa", filter);
+  BOOST_CHECK_EQUAL(none.get()->num_components(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(prefetching_source_test) {
+  for (std::size_t max_bytes : {std::size_t{1}, std::size_t{SIZE_MAX}}) {
+    fles::TimesliceInputArchive reference("example1.tsa");
+    fles::PrefetchingSource<fles::TimesliceSource> source(
+        std::make_unique<fles::TimesliceInputArchive>("example1.tsa"), 1,
+        max_bytes);
+    uint64_t count = 0;
+    while (auto timeslice = source.get()) {
+      auto expected = reference.get();
+      BOOST_REQUIRE(expected);
+      check_equal_timeslices(*timeslice, *expected);
+      ++count;
+    }
+    BOOST_CHECK(source.eos());
+    BOOST_CHECK(!source.get());
+    BOOST_CHECK_EQUAL(count, 2);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(batch_delivery_test) {
+  fles::TimesliceInputArchiveLoop archive("example1.tsa", 3);
+  std::vector<std::size_t> sizes;
+  while (true) {
+    auto batch = archive.get_batch(4);
+    if (batch.empty()) {
+      break;
+    }
+    sizes.push_back(batch.size());
+  }
+  BOOST_CHECK(archive.eos());
+  BOOST_CHECK((sizes == std::vector<std::size_t>{4, 2}));
+
+  fles::PrefetchingSource<fles::TimesliceSource> source(
+      std::make_unique<fles::TimesliceInputArchiveLoop>("example1.tsa", 3), 8);
+  std::vector<uint64_t> indexes;
+  while (true) {
+    auto batch = source.get_batch(4, std::chrono::seconds(1));
+    if (batch.empty()) {
+      break;
+    }
+    BOOST_CHECK_LE(batch.size(), 4);
+    for (const auto& timeslice : batch) {
+      indexes.push_back(timeslice->index());
+    }
+  }
+  BOOST_CHECK(source.eos());
+  fles::TimesliceInputArchiveLoop reference("example1.tsa", 3);
+  std::vector<uint64_t> expected;
+  while (auto timeslice = reference.get()) {
+    expected.push_back(timeslice->index());
+  }
+  BOOST_CHECK_EQUAL(expected.size(), 6);
+  BOOST_CHECK(indexes == expected);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_source_test) {
   std::vector<std::unique_ptr<fles::TimesliceSource>> sources;
-  sources.emplace_back(std::move(source0));
-  sources.emplace_back(std::move(source1));
-  fles::MergingSource<fles::TimesliceSource> merging_source{std::move(sources)};
+  for (int i = 0; i < 3; ++i) {
+    sources.push_back(
+        std::make_unique<fles::TimesliceInputArchive>("example1.tsa"));
+  }
+  fles::ParallelSource<fles::TimesliceSource> source(std::move(sources), 1);
+  std::vector<uint64_t> indexes;
+  while (auto timeslice = source.get()) {
+    indexes.push_back(timeslice->index());
+  }
+  BOOST_CHECK(source.eos());
+  BOOST_CHECK(!source.get());
+  std::sort(indexes.begin(), indexes.end());
+  BOOST_REQUIRE_EQUAL(indexes.size(), 6);
+  BOOST_CHECK_EQUAL(indexes.front(), indexes[2]);
+  BOOST_CHECK_EQUAL(indexes.back(), indexes[3]);
+}
+
+BOOST_AUTO_TEST_CASE(source_multiplexer_test) {
+  fles::ThreadedPollableSource<fles::Timeslice> blocking(
+      std::make_unique<fles::TimesliceInputArchive>("example1.tsa"));
   uint64_t count = 0;
-  while (auto timeslice = merging_source.get()) {
+  while (auto timeslice = blocking.get()) {
     ++count;
   }
-  BOOST_CHECK_EQUAL(count, 8);
+  BOOST_CHECK(blocking.eos());
+  BOOST_CHECK_EQUAL(count, 2);
+
+  std::vector<std::unique_ptr<fles::ThreadedPollableSource<fles::Timeslice>>>
+      sources;
+  fles::SourceMultiplexer<fles::Timeslice> multiplexer;
+  std::vector<uint64_t> counts(3);
+  std::vector<bool> ended(3);
+  for (std::size_t i = 0; i < counts.size(); ++i) {
+    sources.push_back(
+        std::make_unique<fles::ThreadedPollableSource<fles::Timeslice>>(
+            std::make_unique<fles::TimesliceInputArchive>("example1.tsa")));
+    multiplexer.add(*sources.back(),
+                    [&, i](std::unique_ptr<fles::Timeslice> timeslice) {
+                      BOOST_CHECK(!ended[i]);
+                      if (timeslice) {
+                        ++counts[i];
+                      } else {
+                        ended[i] = true;
+                      }
+                    });
+  }
+  BOOST_CHECK_EQUAL(multiplexer.active(), 3);
+  multiplexer.run();
+  BOOST_CHECK_EQUAL(multiplexer.active(), 0);
+  for (std::size_t i = 0; i < counts.size(); ++i) {
+    BOOST_CHECK_EQUAL(counts[i], 2);
+    BOOST_CHECK(ended[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(direct_io_output_archive_sequence_test) {
+  fles::DirectIoParameters direct_io;
+  direct_io.enabled = true;
+  direct_io.buffer_size = fles::DirectFileBuffer::alignment; // many writes
+  direct_io.fsync = fles::FsyncPolicy::Close;
+  {
+    fles::TimesliceInputArchiveLoop source("example1.tsa", 3);
+    fles::TimesliceOutputArchiveSequence sink(
+        "test10_%n.tsa", 2, SIZE_MAX, fles::ArchiveCompression::None, true,
+        {}, direct_io);
+    while (auto timeslice = source.get()) {
+      sink.put(std::move(timeslice));
+    }
+    sink.end_stream();
+  }
+
+  auto index = fles::ArchiveIndex::read("test10_0001.tsa.idx");
+  auto scanned =
+      fles::TimesliceIndexedInputArchive::build_index("test10_0001.tsa");
+  BOOST_REQUIRE_EQUAL(index.size(), 2);
+  BOOST_REQUIRE_EQUAL(scanned.size(), index.size());
+  for (std::size_t i = 0; i < index.size(); ++i) {
+    BOOST_CHECK_EQUAL(index.entries()[i].offset, scanned.entries()[i].offset);
+    BOOST_CHECK_EQUAL(index.entries()[i].size, scanned.entries()[i].size);
+  }
+
+  fles::TimesliceInputArchiveLoop reference("example1.tsa", 3);
+  fles::TimesliceInputArchiveSequence source("test10_%n.tsa");
+  uint64_t count = 0;
+  while (auto timeslice = source.get()) {
+    auto expected = reference.get();
+    BOOST_REQUIRE(expected);
+    check_equal_timeslices(*timeslice, *expected);
+    ++count;
+  }
+  BOOST_CHECK_EQUAL(count, 6);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_input_archive_sequence_test) {
+  fles::TimesliceInputArchiveSequence reference("test2_%n.tsa");
+  fles::TimesliceInputArchiveSequence source("test2_%n.tsa", 2);
+  uint64_t count = 0;
+  while (auto timeslice = source.get()) {
+    auto expected = reference.get();
+    BOOST_REQUIRE(expected);
+    check_equal_timeslices(*timeslice, *expected);
+    ++count;
+  }
+  BOOST_CHECK(!reference.get());
+  BOOST_CHECK(source.eos());
+  BOOST_CHECK_EQUAL(count, 6);
+
+  BOOST_CHECK_THROW(fles::TimesliceInputArchiveSequence("missing_%n.tsa", 2),
+                    std::ios_base::failure);
+}
+
+BOOST_AUTO_TEST_CASE(descriptor_codec_test) {
+  std::vector<fles::MicrosliceDescriptor> desc(10);
+  uint64_t offset = 1000;
+  for (std::size_t i = 0; i < desc.size(); ++i) {
+    desc[i] = {0xDD, 0x01, 0x1001, 0, 0x10, 0x20, 5000 + 100 * i,
+               static_cast<uint32_t>(i * 7919), static_cast<uint32_t>(i * 3),
+               offset};
+    offset += desc[i].size;
+  }
+  desc[4].flags = 0x0002;  // header change
+  desc[6].idx += 50;       // stride change
+  desc[8].offset = 12;     // wrap-around of the offset
+  desc[9].offset = 12 + 8; // contiguous again
+
+  std::vector<uint8_t> encoded;
+  fles::DescriptorCodec encoder;
+  encoder.encode(desc.data(), desc.size(), encoded);
+  BOOST_CHECK_LT(encoded.size(), desc.size() * sizeof(desc[0]) / 2);
+
+  std::vector<fles::MicrosliceDescriptor> decoded(desc.size());
+  fles::DescriptorCodec decoder;
+  decoder.decode(encoded.data(), encoded.size(), decoded.data(),
+                 decoded.size());
+  BOOST_CHECK(std::memcmp(decoded.data(), desc.data(),
+                          desc.size() * sizeof(desc[0])) == 0);
+
+  decoder.reset();
+  BOOST_CHECK_THROW(decoder.decode(encoded.data(), encoded.size() - 1,
+                                   decoded.data(), decoded.size()),
+                    std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(compact_descriptor_archive_test) {
+  {
+    fles::TimesliceInputArchive source("example1.tsa");
+    fles::TimesliceOutputArchive sink("test11.tsa",
+                                      fles::ArchiveCompression::None, true, {},
+                                      {}, fles::DescriptorEncoding::Compact);
+    while (auto timeslice = source.get()) {
+      sink.put(std::move(timeslice));
+    }
+  }
+  {
+    fles::TimesliceInputArchive reference("example1.tsa");
+    fles::TimesliceIndexedInputArchive source("test11.tsa");
+    BOOST_CHECK(source.descriptor().descriptor_encoding() ==
+                fles::DescriptorEncoding::Compact);
+    uint64_t count = 0;
+    while (auto timeslice = source.get()) {
+      auto expected = reference.get();
+      BOOST_REQUIRE(expected);
+      check_equal_timeslices(*timeslice, *expected);
+      ++count;
+    }
+    BOOST_CHECK_EQUAL(count, 2);
+  }
+  BOOST_CHECK_THROW(fles::TimesliceMappedArchive("test11.tsa"),
+                    std::runtime_error);
+
+  {
+    fles::MicrosliceInputArchive source("example2.msa");
+    fles::MicrosliceOutputArchive sink("test11.msa",
+                                       fles::ArchiveCompression::None, false,
+                                       {}, {},
+                                       fles::DescriptorEncoding::Compact);
+    while (auto microslice = source.get()) {
+      sink.put(std::move(microslice));
+    }
+  }
+  fles::MicrosliceInputArchive reference("example2.msa");
+  fles::MicrosliceInputArchive source("test11.msa");
+  uint64_t count = 0;
+  while (auto microslice = source.get()) {
+    auto expected = reference.get();
+    BOOST_REQUIRE(expected);
+    BOOST_CHECK(std::memcmp(&microslice->desc(), &expected->desc(),
+                            sizeof(fles::MicrosliceDescriptor)) == 0);
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        microslice->content(), microslice->content() + microslice->desc().size,
+        expected->content(), expected->content() + expected->desc().size);
+    ++count;
+  }
+  BOOST_CHECK(!reference.get());
+  BOOST_CHECK_EQUAL(count, 4);
+}
+
+BOOST_AUTO_TEST_CASE(byte_shuffle_test) {
+  std::vector<uint8_t> data(1000);
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i * 37 + (i >> 5));
+  }
+  for (std::size_t width : {2, 4, 8, 32}) {
+    for (std::size_t size : {std::size_t{0}, std::size_t{13}, data.size()}) {
+      std::vector<uint8_t> shuffled(size);
+      fles::byte_shuffle(data.data(), shuffled.data(), size, width);
+      const std::size_t count = size / width;
+      for (std::size_t i = 0; i < count * width; ++i) {
+        BOOST_REQUIRE_EQUAL(shuffled[(i % width) * count + i / width],
+                            data[i]);
+      }
+      std::vector<uint8_t> restored(size);
+      fles::byte_unshuffle(shuffled.data(), restored.data(), size, width);
+      BOOST_CHECK(std::equal(restored.begin(), restored.end(), data.begin()));
+    }
+  }
+
+  std::vector<uint8_t> words(data.begin(), data.begin() + 101);
+  fles::delta_encode(words.data(), words.size(), 8);
+  fles::delta_decode(words.data(), words.size(), 8);
+  BOOST_CHECK(std::equal(words.begin(), words.end(), data.begin()));
+}
+
+BOOST_AUTO_TEST_CASE(chunk_codec_archive_test) {
+  for (const auto* spec : {"auto", "*:delta4", "sts:shuffle8,*:stored"}) {
+    {
+      fles::TimesliceInputArchive source("example1.tsa");
+      fles::ChunkedTimesliceOutputArchive sink(
+          "test12.tsa", fles::ArchiveCompression::None, 1,
+          fles::ChunkCodecMap::parse(spec));
+      while (auto timeslice = source.get()) {
+        sink.put(std::move(timeslice));
+      }
+    }
+    fles::TimesliceInputArchive reference("example1.tsa");
+    fles::ChunkedTimesliceInputArchive source("test12.tsa");
+    uint64_t count = 0;
+    while (auto timeslice = source.get()) {
+      auto expected = reference.get();
+      BOOST_REQUIRE(expected);
+      check_equal_timeslices(*timeslice, *expected);
+      ++count;
+    }
+    BOOST_CHECK_EQUAL(count, 2);
+  }
+
+  BOOST_CHECK_EQUAL(fles::make_chunk_codec("shuffle4")->name(), "shuffle4");
+  BOOST_CHECK_THROW(fles::make_chunk_codec("shuffle3"), std::invalid_argument);
+  BOOST_CHECK_THROW(fles::ChunkCodecMap::parse("sts"), std::invalid_argument);
+  BOOST_CHECK_THROW(fles::ChunkCodecMap::parse("nosuchsys:zstd"),
+                    std::invalid_argument);
+  const auto map = fles::ChunkCodecMap::parse("tof:shuffle8,tof.0x01:zstd");
+  BOOST_CHECK_EQUAL(map.find(0x60, 0x00)->name(), "shuffle8");
+  BOOST_CHECK_EQUAL(map.find(0x60, 0x01)->name(), "zstd");
+  BOOST_CHECK(map.find(0x10, 0x00) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(zstd_dictionary_archive_test) {
+  // a raw content dictionary per subsystem format version, taken from the
+  // first timeslice
+  fles::ZstdDictionaries dictionaries;
+  fles::ZstdDictionaryTrainer trainer(1, 1, 1);
+  BOOST_CHECK(!trainer.saturated());
+  {
+    fles::TimesliceInputArchive source("example1.tsa");
+    auto timeslice = source.get();
+    BOOST_REQUIRE(timeslice);
+    for (uint64_t c = 0; c < timeslice->num_components(); ++c) {
+      const auto& md = timeslice->descriptor(c, 0);
+      dictionaries[fles::dictionary_key(md.sys_id, md.sys_ver)].assign(
+          reinterpret_cast<const char*>(&md), timeslice->size_component(c));
+    }
+    trainer.add(*timeslice);
+    const auto& md = timeslice->descriptor(0, 0);
+    BOOST_CHECK_GT(trainer.num_samples(md.sys_id, md.sys_ver), 0);
+  }
+  BOOST_CHECK(trainer.saturated());
+
+  fles::save_zstd_dictionaries("test13.zdicts", dictionaries);
+  BOOST_CHECK(fles::load_zstd_dictionaries("test13.zdicts") == dictionaries);
+  BOOST_CHECK_THROW(fles::load_zstd_dictionaries("test13.nosuchdir"),
+                    std::ios_base::failure);
+
+#ifdef HAVE_ZSTD
+  {
+    fles::TimesliceInputArchive source("example1.tsa");
+    fles::ChunkedTimesliceOutputArchive sink(
+        "test13.tsa", fles::ArchiveCompression::None, 1, {}, dictionaries);
+    while (auto timeslice = source.get()) {
+      sink.put(std::move(timeslice));
+    }
+  }
+  fles::TimesliceInputArchive reference("example1.tsa");
+  fles::ChunkedTimesliceInputArchive source("test13.tsa");
+  uint64_t count = 0;
+  while (auto timeslice = source.get()) {
+    auto expected = reference.get();
+    BOOST_REQUIRE(expected);
+    check_equal_timeslices(*timeslice, *expected);
+    ++count;
+  }
+  BOOST_CHECK_EQUAL(count, 2);
+  BOOST_CHECK(source.descriptor().dictionaries() == dictionaries);
+#else
+  BOOST_CHECK_THROW(fles::make_dictionary_chunk_codec("dictionary"),
+                    std::runtime_error);
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(archive_manifest_test) {
+  std::remove("test14.manifest");
+  for (const auto* name : {"test14a_%n.tsa", "test14b_%n.tsa"}) {
+    fles::TimesliceCachedArchiveLoop source("example1.tsa", 3, true);
+    fles::TimesliceOutputArchiveSequence sink(
+        name, 2, SIZE_MAX, fles::ArchiveCompression::None, true, {}, {},
+        fles::DescriptorEncoding::Verbatim, "test14.manifest");
+    while (auto timeslice = source.get()) {
+      sink.put(std::move(timeslice));
+    }
+    sink.end_stream();
+  }
+
+  auto manifest = fles::ArchiveManifest::read("test14.manifest");
+  BOOST_REQUIRE_EQUAL(manifest.entries().size(), 6);
+  for (const auto& entry : manifest.entries()) {
+    BOOST_CHECK_EQUAL(entry.num_timeslices, 2);
+    BOOST_CHECK_LE(entry.first_index, entry.last_index);
+    BOOST_CHECK_EQUAL(entry.size, std::filesystem::file_size(entry.filename));
+  }
+  BOOST_CHECK_EQUAL(manifest.entries()[4].writer, "test14b_%n.tsa");
+
+  // the second file of each writer holds the requested timeslices
+  const auto& second = manifest.entries()[1];
+  auto files = manifest.select(second.first_index, second.last_index, {});
+  BOOST_REQUIRE_EQUAL(files.size(), 2);
+  BOOST_CHECK(files[0] == std::vector<std::string>{"test14a_0001.tsa"});
+  BOOST_CHECK(files[1] == std::vector<std::string>{"test14b_0001.tsa"});
+  fles::TimesliceIndexedInputArchive source(files[0], second.first_index,
+                                            second.last_index);
+  uint64_t count = 0;
+  while (auto timeslice = source.get()) {
+    BOOST_CHECK_GE(timeslice->index(), second.first_index);
+    ++count;
+  }
+  BOOST_CHECK_EQUAL(count, 2);
+
+  fles::ComponentFilter filter;
+  filter.sys_ids = {0xfe};
+  BOOST_CHECK(manifest.select(0, UINT64_MAX, filter).empty());
+  BOOST_CHECK(fles::ArchiveManifest::is_manifest_filename("test14.manifest"));
+  BOOST_CHECK(!fles::ArchiveManifest::is_manifest_filename("test14.tsa"));
 }
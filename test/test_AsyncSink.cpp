@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#define BOOST_TEST_MODULE test_AsyncSink
+#include <boost/test/unit_test.hpp>
+
+#include "AsyncSink.hpp"
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+// example sink: item collector, optionally held up until released
+class Collector : public fles::Sink<int> {
+public:
+  explicit Collector(bool arg_hold = false) : hold(arg_hold) {}
+
+  void put(std::shared_ptr<const int> item) override {
+    std::unique_lock<std::mutex> lock(mutex);
+    released.wait(lock, [this] { return !hold; });
+    if (*item < 0) {
+      throw std::runtime_error("negative item");
+    }
+    items.push_back(*item);
+  }
+
+  void end_stream() override { ended = true; }
+
+  void release() {
+    std::lock_guard<std::mutex> lock(mutex);
+    hold = false;
+    released.notify_all();
+  }
+
+  std::vector<int> items;
+  bool ended = false;
+
+private:
+  bool hold;
+  std::mutex mutex;
+  std::condition_variable released;
+};
+
+BOOST_AUTO_TEST_CASE(block_test) {
+  auto* collector = new Collector;
+  fles::AsyncSink<int> sink(std::unique_ptr<fles::Sink<int>>(collector), 2);
+  for (int i = 0; i < 100; ++i) {
+    sink.put(std::make_shared<const int>(i));
+  }
+  sink.end_stream();
+
+  BOOST_CHECK(collector->ended);
+  BOOST_REQUIRE_EQUAL(collector->items.size(), 100);
+  BOOST_CHECK_EQUAL(collector->items.back(), 99);
+  auto stats = sink.statistics();
+  BOOST_CHECK_EQUAL(stats.count, 100);
+  BOOST_CHECK_EQUAL(stats.dropped, 0);
+  BOOST_CHECK(stats.max_queue_depth <= 2);
+}
+
+BOOST_AUTO_TEST_CASE(drop_test) {
+  // the held-up sink takes the first item, the queue the next two
+  auto* collector = new Collector(true);
+  fles::AsyncSink<int> sink(std::unique_ptr<fles::Sink<int>>(collector), 2,
+                            fles::OverflowPolicy::Drop);
+  sink.put(std::make_shared<const int>(0));
+  while (sink.statistics().queue_depth != 0) {
+    std::this_thread::yield();
+  }
+  for (int i = 1; i < 10; ++i) {
+    sink.put(std::make_shared<const int>(i));
+  }
+  collector->release();
+  sink.flush();
+
+  std::vector<int> expected{0, 1, 2};
+  BOOST_CHECK_EQUAL_COLLECTIONS(collector->items.begin(),
+                                collector->items.end(), expected.begin(),
+                                expected.end());
+  BOOST_CHECK_EQUAL(sink.statistics().dropped, 7);
+}
+
+BOOST_AUTO_TEST_CASE(sample_test) {
+  auto* collector = new Collector(true);
+  fles::AsyncSink<int> sink(std::unique_ptr<fles::Sink<int>>(collector), 2,
+                            fles::OverflowPolicy::Sample);
+  sink.put(std::make_shared<const int>(0));
+  while (sink.statistics().queue_depth != 0) {
+    std::this_thread::yield();
+  }
+  for (int i = 1; i < 10; ++i) {
+    sink.put(std::make_shared<const int>(i));
+  }
+  collector->release();
+  sink.flush();
+
+  std::vector<int> expected{0, 8, 9};
+  BOOST_CHECK_EQUAL_COLLECTIONS(collector->items.begin(),
+                                collector->items.end(), expected.begin(),
+                                expected.end());
+  BOOST_CHECK_EQUAL(sink.statistics().dropped, 7);
+
+  BOOST_CHECK(fles::parse_overflow_policy("sample") ==
+              fles::OverflowPolicy::Sample);
+  BOOST_CHECK_THROW(fles::parse_overflow_policy("wait"),
+                    std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(exception_test) {
+  auto* collector = new Collector;
+  fles::AsyncSink<int> sink(std::unique_ptr<fles::Sink<int>>(collector), 4);
+  sink.put(std::make_shared<const int>(1));
+  sink.put(std::make_shared<const int>(-1));
+  sink.put(std::make_shared<const int>(2));
+  BOOST_CHECK_THROW(sink.flush(), std::runtime_error);
+  // further items are discarded
+  sink.put(std::make_shared<const int>(3));
+  sink.flush();
+  BOOST_CHECK_EQUAL(collector->items.size(), 1);
+}
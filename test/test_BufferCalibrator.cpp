@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#define BOOST_TEST_MODULE test_BufferCalibrator
+#include <boost/test/unit_test.hpp>
+
+#include "BufferCalibrator.hpp"
+#include <algorithm>
+
+using namespace std::chrono_literals;
+
+BOOST_AUTO_TEST_CASE(recommendation_test) {
+  CalibrationParameters p;
+  p.duration = 1s;
+  p.headroom = 2s;
+  const auto t0 = BufferCalibrator::clock::time_point();
+  BufferCalibrator calibrator(p, 2, t0);
+
+  // 100 items per second, each held by the consumers for 50 ms
+  for (uint64_t i = 0; i < 100; ++i) {
+    const auto t = t0 + i * 10ms;
+    const uint64_t in_use = std::min<uint64_t>(i + 1, 5);
+    calibrator.record_item(i, {1000000, 1000},
+                           {in_use * 1000000, in_use * 1000}, in_use, t);
+    if (i >= 5) {
+      calibrator.record_completion(i - 5, t);
+    }
+  }
+  BOOST_CHECK(!calibrator.done(t0 + 990ms));
+  BOOST_CHECK(calibrator.done(t0 + 1s));
+
+  BOOST_CHECK_CLOSE(calibrator.item_rate(), 100.0, 1e-6);
+  BOOST_CHECK_CLOSE(calibrator.data_rate(0), 1e8, 1e-6);
+  BOOST_CHECK_CLOSE(calibrator.data_rate(1), 1e5, 1e-6);
+  BOOST_CHECK_CLOSE(calibrator.mean_latency(), 0.05, 1e-6);
+  BOOST_CHECK_CLOSE(calibrator.latency_fill_ratio(0, 30),
+                    0.05 * 1e8 / (1 << 30), 1e-6);
+
+  // 5 MB in use plus 2 s at 100 MB/s, the small input at the minimum
+  // size, and twice 5 items in use plus 2 s at 100 items/s
+  const auto r = calibrator.recommend();
+  BOOST_REQUIRE_EQUAL(r.data_size_exps.size(), 2);
+  BOOST_CHECK_EQUAL(r.data_size_exps[0], 28);
+  BOOST_CHECK_EQUAL(r.data_size_exps[1], p.min_data_size_exp);
+  BOOST_CHECK_EQUAL(r.desc_size_exp, 9);
+  BOOST_CHECK_EQUAL(r.to_string(), "datasize=28,20&descsize=9");
+  BOOST_CHECK(calibrator.summary().find(r.to_string()) != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(limits_test) {
+  CalibrationParameters p;
+  p.duration = 1s;
+  p.max_data_size_exp = 24;
+  const auto t0 = BufferCalibrator::clock::time_point();
+  BufferCalibrator calibrator(p, 1, t0);
+
+  // without any items, all buffers get the minimum size
+  auto r = calibrator.recommend();
+  BOOST_CHECK_EQUAL(r.data_size_exps.at(0), p.min_data_size_exp);
+  BOOST_CHECK_EQUAL(r.desc_size_exp, p.min_desc_size_exp);
+  BOOST_CHECK_EQUAL(calibrator.mean_latency(), 0.0);
+
+  calibrator.record_item(0, {1}, {UINT64_C(1) << 30}, 1, t0);
+  r = calibrator.recommend();
+  BOOST_CHECK_EQUAL(r.data_size_exps.at(0), 24);
+}
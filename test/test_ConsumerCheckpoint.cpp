@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#define BOOST_TEST_MODULE test_ConsumerCheckpoint
+#include <boost/test/unit_test.hpp>
+
+#include "ConsumerCheckpoint.hpp"
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+BOOST_AUTO_TEST_CASE(write_read_test) {
+  ConsumerCheckpoint checkpoint;
+  checkpoint.input = "file://run_%n.tsa?prefetch=4";
+  checkpoint.index = 1234;
+  checkpoint.position = 618;
+  checkpoint.count = 617;
+  checkpoint.write("test_checkpoint.state");
+
+  auto restored = ConsumerCheckpoint::read("test_checkpoint.state");
+  BOOST_CHECK_EQUAL(restored.input, checkpoint.input);
+  BOOST_CHECK_EQUAL(restored.index, 1234);
+  BOOST_CHECK_EQUAL(restored.position, 618);
+  BOOST_CHECK_EQUAL(restored.count, 617);
+
+  {
+    std::ofstream ofs("test_checkpoint.state");
+    ofs << "input=x.tsa\nposition=3\n";
+  }
+  BOOST_CHECK_THROW(ConsumerCheckpoint::read("test_checkpoint.state"),
+                    std::runtime_error);
+  std::remove("test_checkpoint.state");
+  BOOST_CHECK_THROW(ConsumerCheckpoint::read("test_checkpoint.state"),
+                    std::ios_base::failure);
+}
+
+BOOST_AUTO_TEST_CASE(resume_locator_test) {
+  ConsumerCheckpoint checkpoint;
+  checkpoint.index = 99;
+  BOOST_CHECK_EQUAL(checkpoint.resume_locator("run.tsa"), "run.tsa?start=100");
+  BOOST_CHECK_EQUAL(checkpoint.resume_locator("file://run_%n.tsa?prefetch=4"),
+                    "file://run_%n.tsa?prefetch=4&start=100");
+  BOOST_CHECK_EQUAL(checkpoint.resume_locator("a.tsa?range=10-200;b.tsa"),
+                    "a.tsa?range=100-200;b.tsa?start=100");
+  BOOST_CHECK_EQUAL(checkpoint.resume_locator("a.tsa?start=500"),
+                    "a.tsa?start=500");
+  BOOST_CHECK_EQUAL(checkpoint.resume_locator("http://store/run.tsa"),
+                    "http://store/run.tsa?start=100");
+  BOOST_CHECK_THROW(checkpoint.resume_locator("shm://127.0.0.1/ts"),
+                    std::runtime_error);
+  BOOST_CHECK_THROW(checkpoint.resume_locator("run.tsa?mmap=1"),
+                    std::runtime_error);
+}
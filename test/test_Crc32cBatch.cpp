@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#define BOOST_TEST_MODULE test_Crc32cBatch
+#include <boost/test/unit_test.hpp>
+
+#include "crc32c_batch.h"
+#include "interface.h"
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(batch_matches_crcutil_test) {
+  crcutil_interface::CRC* reference = crcutil_interface::CRC::Create(
+      0x82f63b78, 0, 32, true, 0, 0, 0,
+      crcutil_interface::CRC::IsSSE42Available(), nullptr);
+
+  std::mt19937 engine;
+  std::uniform_int_distribution<uint8_t> distribution;
+  std::vector<uint8_t> data(1 << 20);
+  for (auto& byte : data) {
+    byte = distribution(engine);
+  }
+
+  // Mix of sizes around the word, block and folding boundaries, at
+  // unaligned offsets
+  std::vector<crcutil_interface::CrcBuffer> buffers;
+  const size_t sizes[] = {0,     1,     7,     8,      9,      100,
+                          4096,  12287, 12288, 12289,  65536,  100001,
+                          30000, 3,     5000,  500000, 123456, 17};
+  size_t offset = 0;
+  for (size_t size : sizes) {
+    buffers.push_back({data.data() + offset, size});
+    offset = (offset + 13) % 1000;
+  }
+
+  std::vector<uint32_t> crcs(buffers.size());
+  crcutil_interface::Crc32cBatch(buffers.data(), buffers.size(), crcs.data());
+
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    crcutil_interface::UINT64 crc64 = 0;
+    reference->Compute(buffers[i].data, buffers[i].size, &crc64);
+    BOOST_CHECK_EQUAL(crcs[i], static_cast<uint32_t>(crc64));
+    BOOST_CHECK_EQUAL(crcutil_interface::Crc32c(buffers[i].data,
+                                                buffers[i].size),
+                      static_cast<uint32_t>(crc64));
+  }
+  reference->Delete();
+
+  // Continued computation over consecutive regions
+  uint32_t crc = crcutil_interface::Crc32c(data.data(), 50000);
+  crc = crcutil_interface::Crc32c(data.data() + 50000, 70000, crc);
+  BOOST_CHECK_EQUAL(crc, crcutil_interface::Crc32c(data.data(), 120000));
+}
@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#define BOOST_TEST_MODULE test_DescriptorColumns
+#include <boost/test/unit_test.hpp>
+
+#include "DescriptorColumns.hpp"
+#include <random>
+#include <vector>
+
+namespace {
+
+std::vector<fles::MicrosliceDescriptor> random_descriptors(size_t count) {
+  std::mt19937_64 rng(count);
+  std::vector<fles::MicrosliceDescriptor> desc(count);
+  for (size_t i = 0; i < count; ++i) {
+    desc[i].hdr_id = 0xdd;
+    desc[i].hdr_ver = 0x01;
+    desc[i].eq_id = static_cast<uint16_t>(rng());
+    desc[i].flags = static_cast<uint16_t>(rng());
+    desc[i].sys_id = static_cast<uint8_t>(rng());
+    desc[i].sys_ver = static_cast<uint8_t>(rng());
+    desc[i].idx = 1000 + i * 100;
+    desc[i].crc = static_cast<uint32_t>(rng());
+    desc[i].size = static_cast<uint32_t>(rng());
+    desc[i].offset = rng();
+  }
+  return desc;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(decode_implementations_test) {
+  DescriptorColumns columns;
+  for (DescriptorColumnsIsa isa : descriptor_columns_supported_isas()) {
+    BOOST_TEST_MESSAGE("implementation: " << to_string(isa));
+    for (size_t count : {0, 1, 3, 4, 5, 8, 17, 100}) {
+      const auto desc = random_descriptors(count);
+      columns.assign(isa, desc.data(), count);
+      BOOST_REQUIRE_EQUAL(columns.count(), count);
+
+      uint64_t total_size = 0;
+      for (size_t i = 0; i < count; ++i) {
+        BOOST_CHECK_EQUAL(columns.idx[i], desc[i].idx);
+        BOOST_CHECK_EQUAL(columns.size[i], desc[i].size);
+        BOOST_CHECK_EQUAL(columns.flags[i], desc[i].flags);
+        BOOST_CHECK_EQUAL(columns.eq_id[i], desc[i].eq_id);
+        total_size += desc[i].size;
+      }
+      BOOST_CHECK_EQUAL(columns.total_size(), total_size);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(reductions_test) {
+  auto desc = random_descriptors(40);
+  for (auto& d : desc) {
+    d.flags = 0;
+  }
+  desc[3].flags = 0x0002;
+  desc[7].flags = 0x0006;
+  desc[9].flags = 0x0010;
+
+  DescriptorColumns columns;
+  columns.assign(desc.data(), desc.size());
+  BOOST_CHECK_EQUAL(columns.count_flags(0x0002), 2);
+  BOOST_CHECK_EQUAL(columns.count_flags(0x0014), 2);
+  BOOST_CHECK_EQUAL(columns.count_flags(0x0001), 0);
+
+  BOOST_CHECK_EQUAL(columns.first_non_increasing(), 40);
+  BOOST_CHECK_EQUAL(columns.first_irregular(2, 1000, 100), 40);
+  BOOST_CHECK_EQUAL(columns.first_irregular(40, 1000, 100), 40);
+
+  columns.idx[25] = columns.idx[24];
+  BOOST_CHECK_EQUAL(columns.first_non_increasing(), 25);
+  BOOST_CHECK_EQUAL(columns.first_irregular(2, 1000, 100), 25);
+  BOOST_CHECK_EQUAL(columns.first_irregular(26, 1000, 100), 40);
+}
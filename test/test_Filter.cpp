@@ -6,11 +6,15 @@
 #include "FilterExamples.hpp"
 #include "MicrosliceInputArchive.hpp"
 #include "MicrosliceOutputArchive.hpp"
+#include "Pipeline.hpp"
 #include "Source.hpp"
+#include "StaticPipeline.hpp"
 #include <cstdint>
 #include <iostream>
 #include <limits>
+#include <stdexcept>
 #include <type_traits>
+#include <vector>
 
 // example source: integer counter
 template <typename T> class Counter : public fles::Source<T> {
@@ -76,6 +80,85 @@ private:
   }
 };
 
+// example sink: item collector
+template <typename T> class Collector : public fles::Sink<T> {
+public:
+  void put(std::shared_ptr<const T> item) override { items.push_back(*item); }
+  void end_stream() override { ended = true; }
+
+  std::vector<T> items;
+  bool ended = false;
+};
+
+// example stage 1: integer doubler, modifying the item in place
+template <typename T> class DoublerStage : public fles::PipelineStage<T> {
+  void process(std::unique_ptr<T> item,
+               fles::PipelineOutput<T>& output) override {
+    *item *= 2;
+    output.push(std::move(item));
+  }
+};
+
+// example stage 2: integer pair adder, flushing an odd item at the end
+template <typename T> class PairAdderStage : public fles::PipelineStage<T> {
+  void process(std::unique_ptr<T> item,
+               fles::PipelineOutput<T>& output) override {
+    if (!pending_) {
+      pending_ = std::move(item);
+      return;
+    }
+    *pending_ += *item;
+    output.push(std::move(pending_));
+  }
+
+  void finish(fles::PipelineOutput<T>& output) override {
+    if (pending_) {
+      output.push(std::move(pending_));
+    }
+  }
+
+  std::unique_ptr<T> pending_;
+};
+
+// example stage 3: failure after a number of items
+template <typename T> class FailingStage : public fles::PipelineStage<T> {
+public:
+  explicit FailingStage(int arg_limit) : limit(arg_limit) {}
+
+private:
+  void process(std::unique_ptr<T> item,
+               fles::PipelineOutput<T>& output) override {
+    if (++count > limit) {
+      throw std::runtime_error("stage failure");
+    }
+    output.push(std::move(item));
+  }
+
+  int count = 0;
+  int limit;
+};
+
+// example static stage: integer doubler, called without virtual functions
+template <typename T>
+class StaticDoublerStage : public fles::StaticStage<StaticDoublerStage<T>, T> {
+public:
+  template <class Emit> void process_item(std::unique_ptr<T> item, Emit& emit) {
+    *item *= 2;
+    emit(std::move(item));
+  }
+};
+
+// example static sink: item collector, receiving the items by reference
+template <typename T>
+class StaticCollector : public fles::StaticSink<StaticCollector<T>, T> {
+public:
+  void consume(const T& item) { items.push_back(item); }
+  void end_stream() override { ended = true; }
+
+  std::vector<T> items;
+  bool ended = false;
+};
+
 BOOST_AUTO_TEST_CASE(int_filter_test) {
   Counter<int> counter(12);
 
@@ -178,3 +261,128 @@ BOOST_AUTO_TEST_CASE(filter_example3_test) {
 
   BOOST_CHECK_EQUAL(count, 4);
 }
+
+BOOST_AUTO_TEST_CASE(int_pipeline_test) {
+  Counter<int> counter(11);
+  DoublerStage<int> doubler;
+  PairAdderStage<int> pair_adder;
+  Collector<int> collector;
+  std::vector<fles::Sink<int>*> sinks{&collector};
+
+  uint64_t count = fles::Pipeline<int>(counter)
+                       .thread(2)
+                       .then(doubler)
+                       .thread(1)
+                       .then(pair_adder)
+                       .run(sinks);
+
+  BOOST_CHECK_EQUAL(count, 6);
+  BOOST_CHECK(collector.ended);
+  std::vector<int> expected{2, 10, 18, 26, 34, 20};
+  BOOST_CHECK_EQUAL_COLLECTIONS(collector.items.begin(), collector.items.end(),
+                                expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(pipeline_limit_test) {
+  Counter<int> counter;
+  Collector<int> collector;
+  std::vector<fles::Sink<int>*> sinks{&collector};
+
+  uint64_t count = fles::Pipeline<int>(counter).thread(4).run(sinks, 100);
+
+  BOOST_CHECK_EQUAL(count, 100);
+  BOOST_CHECK_EQUAL(collector.items.back(), 99);
+}
+
+BOOST_AUTO_TEST_CASE(pipeline_failure_test) {
+  Counter<int> counter;
+  DoublerStage<int> doubler;
+  FailingStage<int> failing(50);
+  Collector<int> collector;
+  std::vector<fles::Sink<int>*> sinks{&collector};
+
+  // the failure stops the endless source
+  BOOST_CHECK_THROW(fles::Pipeline<int>(counter)
+                        .thread(4)
+                        .then(failing)
+                        .thread(4)
+                        .then(doubler)
+                        .run(sinks),
+                    std::runtime_error);
+  BOOST_CHECK(!collector.ended);
+  BOOST_CHECK(collector.items.size() <= 50);
+}
+
+BOOST_AUTO_TEST_CASE(microslice_pipeline_test) {
+  fles::DescriptorOverrideStage override_stage(
+      static_cast<uint8_t>(fles::Subsystem::FLES),
+      static_cast<uint8_t>(fles::SubsystemFormatFLES::Uninitialized));
+  fles::CombineContentsStage combine;
+
+  fles::MicrosliceInputArchive source("example2.msa");
+  fles::MicrosliceOutputArchive sink("filtertest4.msa");
+  std::vector<fles::MicrosliceSink*> sinks{&sink};
+
+  uint64_t count = fles::Pipeline<fles::Microslice>(source)
+                       .thread(2)
+                       .then(override_stage)
+                       .thread(2)
+                       .then(combine)
+                       .run(sinks);
+
+  BOOST_CHECK_EQUAL(count, 2);
+}
+
+BOOST_AUTO_TEST_CASE(static_pipeline_test) {
+  std::vector<int> expected{2, 10, 18, 26, 34, 20};
+
+  // static stage and sink, combined with a dynamic stage
+  Counter<int> counter(11);
+  StaticDoublerStage<int> doubler;
+  PairAdderStage<int> pair_adder;
+  StaticCollector<int> collector;
+  uint64_t count =
+      fles::make_pipeline(counter, doubler, pair_adder, collector).run();
+  BOOST_CHECK_EQUAL(count, 6);
+  BOOST_CHECK(collector.ended);
+  BOOST_CHECK_EQUAL_COLLECTIONS(collector.items.begin(), collector.items.end(),
+                                expected.begin(), expected.end());
+
+  // dynamic sink
+  Counter<int> counter2(11);
+  PairAdderStage<int> pair_adder2;
+  Collector<int> dynamic_collector;
+  count = fles::make_pipeline(counter2, doubler, pair_adder2, dynamic_collector)
+              .run();
+  BOOST_CHECK_EQUAL(count, 6);
+  BOOST_CHECK(dynamic_collector.ended);
+  BOOST_CHECK_EQUAL_COLLECTIONS(dynamic_collector.items.begin(),
+                                dynamic_collector.items.end(),
+                                expected.begin(), expected.end());
+
+  // the static stage and sink in a dynamic pipeline
+  Counter<int> counter3(11);
+  StaticCollector<int> collector3;
+  std::vector<fles::Sink<int>*> sinks{&collector3};
+  count = fles::Pipeline<int>(counter3).thread(2).then(doubler).run(sinks, 5);
+  BOOST_CHECK_EQUAL(count, 5);
+  std::vector<int> expected3{0, 2, 4, 6, 8};
+  BOOST_CHECK_EQUAL_COLLECTIONS(collector3.items.begin(),
+                                collector3.items.end(), expected3.begin(),
+                                expected3.end());
+}
+
+BOOST_AUTO_TEST_CASE(static_microslice_pipeline_test) {
+  fles::DescriptorOverrideStage override_stage(
+      static_cast<uint8_t>(fles::Subsystem::FLES),
+      static_cast<uint8_t>(fles::SubsystemFormatFLES::Uninitialized));
+  fles::CombineContentsStage combine;
+
+  fles::MicrosliceInputArchive source("example2.msa");
+  fles::MicrosliceOutputArchive sink("filtertest5.msa");
+
+  uint64_t count =
+      fles::make_pipeline(source, override_stage, combine, sink).run();
+
+  BOOST_CHECK_EQUAL(count, 2);
+}
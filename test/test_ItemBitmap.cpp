@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#define BOOST_TEST_MODULE test_ItemBitmap
+#include <boost/test/unit_test.hpp>
+
+#include "ItemBitmap.hpp"
+#include <cstdint>
+#include <set>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(insert_erase_test) {
+  ItemBitmap items(6);
+  BOOST_CHECK(items.empty());
+  items.insert(100);
+  items.insert(101);
+  items.insert(130);
+  BOOST_CHECK_EQUAL(items.size(), 3);
+  BOOST_CHECK_EQUAL(items.front(), 100);
+  BOOST_CHECK(items.contains(130));
+  BOOST_CHECK(!items.contains(102));
+
+  BOOST_CHECK(items.erase(100));
+  BOOST_CHECK(!items.erase(100));
+  BOOST_CHECK_EQUAL(items.front(), 101);
+  BOOST_CHECK(items.erase(101));
+  BOOST_CHECK_EQUAL(items.front(), 130);
+  BOOST_CHECK(items.erase(130));
+  BOOST_CHECK(items.empty());
+}
+
+BOOST_AUTO_TEST_CASE(erase_below_test) {
+  ItemBitmap items(7);
+  for (uint64_t id = 1000; id < 1100; ++id) {
+    if (id % 3 != 0) {
+      items.insert(id);
+    }
+  }
+  std::vector<uint64_t> erased;
+  items.erase_below(1070, [&](uint64_t id) { erased.push_back(id); });
+  BOOST_REQUIRE_EQUAL(erased.size(), 47);
+  BOOST_CHECK_EQUAL(erased.front(), 1000);
+  BOOST_CHECK_EQUAL(erased.back(), 1069);
+  for (std::size_t i = 1; i < erased.size(); ++i) {
+    BOOST_CHECK_LT(erased[i - 1], erased[i]);
+  }
+  BOOST_CHECK_EQUAL(items.front(), 1070);
+  BOOST_CHECK_EQUAL(items.size(), 20);
+
+  std::vector<uint64_t> visited;
+  items.for_each(1080, 1090, [&](uint64_t id) { visited.push_back(id); });
+  BOOST_CHECK_EQUAL(visited.size(), 6);
+  BOOST_CHECK_EQUAL(items.size(), 20);
+}
+
+BOOST_AUTO_TEST_CASE(erase_run_test) {
+  ItemBitmap items(6);
+  for (uint64_t id = 10; id < 200; ++id) {
+    if (id != 150) {
+      items.insert(id);
+    }
+  }
+  BOOST_CHECK_EQUAL(items.erase_run(5), 5);
+  BOOST_CHECK_EQUAL(items.erase_run(10), 150);
+  BOOST_CHECK_EQUAL(items.front(), 151);
+  items.insert(150);
+  BOOST_CHECK_EQUAL(items.erase_run(150), 200);
+  BOOST_CHECK(items.empty());
+}
+
+BOOST_AUTO_TEST_CASE(grow_test) {
+  ItemBitmap items(6);
+  std::set<uint64_t> reference;
+  for (uint64_t id = 60; id < 1000; id += 7) {
+    items.insert(id);
+    reference.insert(id);
+  }
+  BOOST_CHECK_GE(items.capacity(), 1000 - 60);
+  items.insert(3);
+  reference.insert(3);
+  BOOST_CHECK_EQUAL(items.size(), reference.size());
+  std::vector<uint64_t> visited;
+  items.for_each(0, UINT64_MAX, [&](uint64_t id) { visited.push_back(id); });
+  BOOST_CHECK_EQUAL_COLLECTIONS(visited.begin(), visited.end(),
+                                reference.begin(), reference.end());
+}
+
+BOOST_AUTO_TEST_CASE(sliding_window_test) {
+  ItemBitmap items(6);
+  std::set<uint64_t> reference;
+  for (uint64_t id = 0; id < 10000; ++id) {
+    items.insert(id);
+    reference.insert(id);
+    if (id % 40 == 39 && id >= 79) {
+      // complete the previous block of 40 items out of order
+      const uint64_t base = id - 79;
+      for (uint64_t k = 0; k < 40; ++k) {
+        const uint64_t done = base + (k * 13) % 40;
+        BOOST_CHECK(items.erase(done));
+        reference.erase(done);
+        BOOST_REQUIRE_EQUAL(items.front(), *reference.begin());
+      }
+    }
+  }
+  BOOST_CHECK_EQUAL(items.size(), reference.size());
+  BOOST_CHECK_LE(items.capacity(), 256);
+  items.erase_below(10000);
+  BOOST_CHECK(items.empty());
+}
@@ -0,0 +1,170 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#define BOOST_TEST_MODULE test_ItemDistributor
+#include <boost/test/unit_test.hpp>
+
+#include "ItemDistributor.hpp"
+#include "ItemProducer.hpp"
+#include "ItemWorker.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+std::string address(const std::string& test, const std::string& role) {
+  return "ipc:///tmp/test_ItemDistributor_" + test + "_" + role + "_" +
+         std::to_string(getpid());
+}
+
+// A worker on its own thread, recording the IDs of the items it receives
+class WorkerThread {
+public:
+  WorkerThread(const std::string& distributor_address,
+               WorkerParameters parameters)
+      : worker_(distributor_address, std::move(parameters)) {
+    worker_.set_disconnect_callback([] {});
+    thread_ = std::thread([this] {
+      while (!stopped_) {
+        auto item = worker_.get_until(std::chrono::steady_clock::now() +
+                                      std::chrono::milliseconds(10));
+        if (item) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          ids_.insert(item->id());
+        }
+      }
+    });
+  }
+
+  WorkerThread(const WorkerThread&) = delete;
+  WorkerThread& operator=(const WorkerThread&) = delete;
+
+  ~WorkerThread() {
+    stopped_ = true;
+    thread_.join();
+  }
+
+  std::set<ItemID> ids() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ids_;
+  }
+
+private:
+  ItemWorker worker_;
+  std::atomic<bool> stopped_{false};
+  std::mutex mutex_;
+  std::set<ItemID> ids_;
+  std::thread thread_;
+};
+
+// Send items and wait until all of them have been completed
+void produce(ItemProducer& producer, ItemID first, ItemID count) {
+  for (ItemID id = first; id < first + count; ++id) {
+    producer.send_work_item(id, "");
+  }
+  ItemID completed_up_to = first;
+  std::set<ItemID> completed;
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (completed_up_to < first + count) {
+    BOOST_REQUIRE(std::chrono::steady_clock::now() < deadline);
+    ItemCompletionBatch batch;
+    if (producer.wait_for_completions(&batch,
+                                      std::chrono::milliseconds(100))) {
+      completed_up_to = std::max(completed_up_to, batch.completed_up_to);
+      completed.insert(batch.completed.begin(), batch.completed.end());
+      while (completed.erase(completed_up_to) != 0) {
+        ++completed_up_to;
+      }
+    }
+  }
+  BOOST_CHECK_EQUAL(completed_up_to, first + count);
+}
+
+// Wait until the workers have registered with their shards
+void wait_for_registration() {
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(sharded_distribution_test) {
+  const std::string worker_address = address("sharded", "workers");
+  zmq::context_t context;
+  ItemDistributor distributor(context, "inproc://sharded_producer",
+                              worker_address, 0, 2);
+  ItemProducer producer(context, "inproc://sharded_producer");
+  std::thread distributor_thread(std::ref(distributor));
+
+  constexpr ItemID num_items = 40;
+  {
+    WorkerThread even(worker_address,
+                      {2, 0, WorkerQueuePolicy::QueueAll, 0, "even"});
+    WorkerThread odd(worker_address,
+                     {2, 1, WorkerQueuePolicy::QueueAll, 0, "odd"});
+    // a group is served by a single shard, which sends each item to one
+    // of its workers
+    WorkerThread group_a(worker_address,
+                         {1, 0, WorkerQueuePolicy::QueueAll, 7, "group"});
+    WorkerThread group_b(worker_address,
+                         {1, 0, WorkerQueuePolicy::QueueAll, 7, "group"});
+    wait_for_registration();
+
+    // an item is completed once the shards of all workers have completed it
+    produce(producer, 0, num_items);
+
+    const auto even_ids = even.ids();
+    const auto odd_ids = odd.ids();
+    BOOST_CHECK_EQUAL(even_ids.size(), num_items / 2);
+    BOOST_CHECK_EQUAL(odd_ids.size(), num_items / 2);
+    BOOST_CHECK(std::all_of(even_ids.begin(), even_ids.end(),
+                            [](ItemID id) { return id % 2 == 0; }));
+    BOOST_CHECK(std::all_of(odd_ids.begin(), odd_ids.end(),
+                            [](ItemID id) { return id % 2 == 1; }));
+
+    const auto a_ids = group_a.ids();
+    const auto b_ids = group_b.ids();
+    std::set<ItemID> group_ids(a_ids.begin(), a_ids.end());
+    group_ids.insert(b_ids.begin(), b_ids.end());
+    BOOST_CHECK_EQUAL(group_ids.size(), num_items);
+    BOOST_CHECK_EQUAL(a_ids.size() + b_ids.size(), num_items);
+  }
+
+  distributor.stop();
+  distributor_thread.join();
+}
+
+BOOST_AUTO_TEST_CASE(sharded_worker_removal_test) {
+  const std::string worker_address = address("removal", "workers");
+  zmq::context_t context;
+  ItemDistributor distributor(context, "inproc://removal_producer",
+                              worker_address, 0, 2);
+  ItemProducer producer(context, "inproc://removal_producer");
+  std::thread distributor_thread(std::ref(distributor));
+
+  WorkerThread remaining(worker_address,
+                         {1, 0, WorkerQueuePolicy::QueueAll, 0, "remaining"});
+  std::vector<std::unique_ptr<WorkerThread>> removed;
+  for (int i = 0; i < 3; ++i) {
+    removed.push_back(std::make_unique<WorkerThread>(
+        worker_address, WorkerParameters{1, 0, WorkerQueuePolicy::QueueAll, 0,
+                                         "removed" + std::to_string(i)}));
+  }
+  wait_for_registration();
+  produce(producer, 0, 10);
+
+  // the items of vanished workers must not stay outstanding on any shard
+  removed.clear();
+  produce(producer, 10, 10);
+  BOOST_CHECK_EQUAL(remaining.ids().size(), 20);
+
+  distributor.stop();
+  distributor_thread.join();
+}
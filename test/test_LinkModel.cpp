@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#define BOOST_TEST_MODULE test_LinkModel
+#include <boost/test/unit_test.hpp>
+
+#include "LinkModel.hpp"
+#include <set>
+#include <stdexcept>
+
+using namespace std::chrono_literals;
+
+BOOST_AUTO_TEST_CASE(parse_test) {
+  auto p = LinkModelParameters::parse("latency=20000,bandwidth=1e9,seed=3");
+  BOOST_CHECK_EQUAL(p.latency_ns, 20000);
+  BOOST_CHECK_EQUAL(p.link_bandwidth, 1e9);
+  BOOST_CHECK_EQUAL(p.uplink_bandwidth, 0);
+  BOOST_CHECK_EQUAL(p.seed, 3);
+  BOOST_CHECK(p.enabled());
+  BOOST_CHECK(!LinkModelParameters::parse("").enabled());
+  BOOST_CHECK_THROW(LinkModelParameters::parse("latency"),
+                    std::invalid_argument);
+  BOOST_CHECK_THROW(LinkModelParameters::parse("speed=1"),
+                    std::invalid_argument);
+  BOOST_CHECK_THROW(LinkModelParameters::parse("bandwidth=-1"),
+                    std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(delay_and_bandwidth_test) {
+  LinkModelParameters p;
+  p.latency_ns = 10000;     // 10 us
+  p.link_bandwidth = 1e9;   // 1 GB/s
+  p.uplink_bandwidth = 2e9; // 2 GB/s
+  LinkModel model(p, 2);
+  const auto t0 = LinkModel::clock::now();
+
+  // a transfer is ready only after the latency
+  BOOST_CHECK(!model.admit(0, 0, 100000, t0));
+  BOOST_CHECK(!model.admit(0, 0, 100000, t0 + 9us));
+  BOOST_CHECK(model.admit(0, 0, 100000, t0 + 10us));
+
+  // 100 kB occupy the link for 100 us and the uplink for 50 us
+  BOOST_CHECK(!model.admit(0, 1, 100000, t0 + 20us));
+  BOOST_CHECK(!model.admit(0, 1, 100000, t0 + 109us));
+  BOOST_CHECK(model.admit(0, 1, 100000, t0 + 110us));
+
+  // another link waits for the shared uplink only
+  BOOST_CHECK(!model.admit(1, 0, 100000, t0 + 120us));
+  BOOST_CHECK(!model.admit(1, 0, 100000, t0 + 159us));
+  BOOST_CHECK(model.admit(1, 0, 100000, t0 + 160us));
+}
+
+BOOST_AUTO_TEST_CASE(jitter_test) {
+  LinkModelParameters p;
+  p.jitter_ns = 1000000;
+  p.seed = 42;
+  const auto t0 = LinkModel::clock::now();
+  // time from offering a transfer to its admission, in steps of 10 us
+  auto admission = [t0](LinkModel& model, uint64_t ts) {
+    const auto t = t0 + ts * 2ms;
+    auto dt = 0us;
+    while (!model.admit(0, ts, 0, t + dt)) {
+      dt += 10us;
+    }
+    return dt;
+  };
+
+  // the same seed and sender index give the same delays
+  LinkModel a(p, 1, 5);
+  LinkModel b(p, 1, 5);
+  std::set<std::chrono::microseconds> delays;
+  for (uint64_t ts = 0; ts < 10; ++ts) {
+    const auto dt = admission(a, ts);
+    BOOST_CHECK(dt == admission(b, ts));
+    BOOST_CHECK(dt <= 1ms + 10us);
+    delays.insert(dt);
+  }
+  BOOST_CHECK_GT(delays.size(), 1);
+}
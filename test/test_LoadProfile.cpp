@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#define BOOST_TEST_MODULE test_LoadProfile
+#include <boost/test/unit_test.hpp>
+
+#include "LoadProfile.hpp"
+#include "ProfileLoadGenerator.hpp"
+#include <sstream>
+
+namespace {
+fles::MicrosliceDescriptor make_desc(uint64_t idx, uint32_t size) {
+  fles::MicrosliceDescriptor desc{};
+  desc.eq_id = 0x1234;
+  desc.sys_id = 0x10;
+  desc.idx = idx;
+  desc.size = size;
+  return desc;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(size_histogram_test) {
+  for (uint32_t size : {0u, 7u, 8u, 15u, 16u, 17u, 1000u, 123456789u}) {
+    const uint32_t bin = SizeHistogram::bin(size);
+    BOOST_CHECK_LE(SizeHistogram::lower_bound(bin), size);
+    BOOST_CHECK_GT(SizeHistogram::upper_bound(bin), size);
+  }
+  BOOST_CHECK_EQUAL(SizeHistogram::bin(UINT32_MAX), 239);
+
+  SizeHistogram sizes;
+  sizes.add(1000, 3);
+  std::mt19937_64 random;
+  for (int i = 0; i < 100; ++i) {
+    const uint32_t size = sizes.sample(random);
+    BOOST_CHECK_EQUAL(SizeHistogram::bin(size), SizeHistogram::bin(1000));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(learn_and_replay_test) {
+  // 10 ms microslices, spill cycles of 20 windows with 5 windows of pause
+  constexpr uint64_t duration = 10'000'000;
+  constexpr uint64_t per_window = 10;
+  LoadProfileLearner learner;
+  uint64_t idx = 0;
+  for (uint64_t w = 0; w < 100; ++w) {
+    const bool pause = w % 20 >= 15;
+    for (uint64_t m = 0; m < per_window; ++m) {
+      learner.add(0, make_desc(idx, pause ? 100 : 10000 + 100 * (m % 5)));
+      idx += duration;
+    }
+    learner.end_window();
+  }
+
+  const LoadProfile learned = learner.profile();
+  BOOST_REQUIRE_EQUAL(learned.components.size(), 1);
+  const auto& p = learned.components[0];
+  BOOST_CHECK_EQUAL(p.eq_id, 0x1234);
+  BOOST_CHECK_EQUAL(p.sys_id, 0x10);
+  BOOST_CHECK_EQUAL(p.microslice_duration_ns, duration);
+  BOOST_CHECK_EQUAL(p.spill_period_ns, 20 * per_window * duration);
+  BOOST_CHECK_CLOSE(p.spill_duty, 0.75, 1e-6);
+  BOOST_CHECK_EQUAL(p.spill_sizes.total(), 75 * per_window);
+  BOOST_CHECK_EQUAL(p.pause_sizes.total(), 25 * per_window);
+
+  std::stringstream text;
+  learned.save(text);
+  const LoadProfile loaded = LoadProfile::load(text);
+  BOOST_REQUIRE_EQUAL(loaded.components.size(), 1);
+  const auto& q = loaded.components[0];
+  BOOST_CHECK_EQUAL(q.eq_id, p.eq_id);
+  BOOST_CHECK_EQUAL(q.spill_period_ns, p.spill_period_ns);
+  BOOST_CHECK_CLOSE(q.spill_duty, p.spill_duty, 1e-3);
+  BOOST_CHECK(q.spill_sizes.bins() == p.spill_sizes.bins());
+  BOOST_CHECK(q.pause_sizes.bins() == p.pause_sizes.bins());
+
+  // replay at unlimited rate, the last quarter of each cycle is the pause
+  ProfileLoadGenerator generator(24, 10, q, 0.0);
+  generator.proceed();
+  const DualIndex written = generator.get_write_index();
+  BOOST_REQUIRE_GT(written.desc, 400);
+  const auto& first = generator.desc_buffer().at(0);
+  for (uint64_t i = 0; i < 400; ++i) {
+    const auto& desc = generator.desc_buffer().at(i);
+    BOOST_CHECK_EQUAL(desc.idx, first.idx + i * duration);
+    BOOST_CHECK_EQUAL(desc.sys_id, 0x10);
+    const bool pause = i % (20 * per_window) >= 15 * per_window;
+    if (pause) {
+      BOOST_CHECK_LT(desc.size, 1000);
+    } else {
+      BOOST_CHECK_GE(desc.size, 9000);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(stationary_profile_test) {
+  LoadProfileLearner learner;
+  for (uint64_t w = 0; w < 10; ++w) {
+    for (uint64_t m = 0; m < 10; ++m) {
+      learner.add(0, make_desc((w * 10 + m) * 1000, 4096));
+    }
+    learner.end_window();
+  }
+  const LoadProfile profile = learner.profile();
+  const auto& p = profile.components.at(0);
+  BOOST_CHECK_EQUAL(p.spill_period_ns, 0);
+  BOOST_CHECK_EQUAL(p.spill_sizes.total(), 100);
+  BOOST_CHECK(p.in_spill(12345));
+
+  std::istringstream bad("component 0x10 0 0x1 1000\n");
+  BOOST_CHECK_THROW(LoadProfile::load(bad), std::runtime_error);
+}
@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#define BOOST_TEST_MODULE test_MicrosliceCrcChecker
+#include <boost/test/unit_test.hpp>
+
+#include "MicrosliceCrcChecker.hpp"
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+constexpr auto crc_valid =
+    static_cast<uint16_t>(fles::MicrosliceFlags::CrcValid);
+constexpr auto crc_checked =
+    static_cast<uint16_t>(fles::MicrosliceFlags::CrcChecked);
+constexpr auto crc_error =
+    static_cast<uint16_t>(fles::MicrosliceFlags::CrcError);
+
+/// Component with four microslices (descriptors followed by the contents),
+/// the first two with a valid CRC, the second one corrupted.
+struct Component {
+  std::vector<uint8_t> content;
+  std::vector<fles::MicrosliceDescriptor> descs;
+
+  Component() : content(1000), descs(4) {
+    std::iota(content.begin(), content.end(), 0);
+    uint64_t offset = 4096;
+    for (std::size_t i = 0; i < descs.size(); ++i) {
+      descs[i].size = 250;
+      descs[i].offset = offset;
+      offset += descs[i].size;
+    }
+    for (std::size_t i = 0; i < 2; ++i) {
+      descs[i].crc = crcutil_interface::Crc32c(content.data() + i * 250, 250);
+      descs[i].flags = crc_valid;
+    }
+    descs[1].crc ^= 1;
+  }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(verify_test) {
+  Component c;
+  MicrosliceCrcChecker checker(CrcCheckMode::Verify);
+  checker.check(c.descs.data(), c.descs.size(), c.content.data());
+
+  BOOST_CHECK_EQUAL(c.descs[0].flags, crc_valid | crc_checked);
+  BOOST_CHECK_EQUAL(c.descs[1].flags, crc_valid | crc_checked | crc_error);
+  BOOST_CHECK_EQUAL(c.descs[2].flags, 0);
+  BOOST_CHECK_EQUAL(checker.checked(), 2);
+  BOOST_CHECK_EQUAL(checker.errors(), 1);
+  BOOST_CHECK_EQUAL(checker.computed(), 0);
+
+  // checked microslices are not verified again
+  checker.check(c.descs.data(), c.descs.size(), c.content.data());
+  BOOST_CHECK_EQUAL(checker.checked(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(compute_test) {
+  Component c;
+  MicrosliceCrcChecker checker(CrcCheckMode::Compute);
+  checker.check(c.descs.data(), c.descs.size(), c.content.data());
+
+  BOOST_CHECK_EQUAL(checker.checked(), 2);
+  BOOST_CHECK_EQUAL(checker.computed(), 2);
+  for (std::size_t i = 2; i < c.descs.size(); ++i) {
+    BOOST_CHECK_EQUAL(c.descs[i].flags, crc_valid | crc_checked);
+    BOOST_CHECK_EQUAL(c.descs[i].crc, crcutil_interface::Crc32c(
+                                          c.content.data() + i * 250, 250));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(parse_test) {
+  BOOST_CHECK(parse_crc_check_mode("none") == CrcCheckMode::None);
+  BOOST_CHECK(parse_crc_check_mode("verify") == CrcCheckMode::Verify);
+  BOOST_CHECK(parse_crc_check_mode("compute") == CrcCheckMode::Compute);
+  BOOST_CHECK_THROW(parse_crc_check_mode("always"), std::invalid_argument);
+}
@@ -2,10 +2,17 @@
 #define BOOST_TEST_MODULE test_MicrosliceReceiver
 #include <boost/test/unit_test.hpp>
 
+#include "FlesnetPatternChecker.hpp"
 #include "FlesnetPatternGenerator.hpp"
+#include "MicrosliceArchiveReplay.hpp"
+#include "MicrosliceInputArchive.hpp"
 #include "MicrosliceOutputArchive.hpp"
 #include "MicrosliceReceiver.hpp"
+#include <cstring>
+#include <deque>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 
 BOOST_AUTO_TEST_CASE(usage_test) {
   uint32_t typical_content_size = 10000;
@@ -34,3 +41,211 @@ BOOST_AUTO_TEST_CASE(usage_test) {
 
   BOOST_CHECK_EQUAL(count, 1000);
 }
+
+BOOST_AUTO_TEST_CASE(fill_threads_test) {
+  uint32_t typical_content_size = 10000;
+  std::size_t desc_buffer_size_exp = 7;  // 128 entries
+  std::size_t data_buffer_size_exp = 20; // 1 MiB
+
+  FlesnetPatternGenerator serial_source(data_buffer_size_exp,
+                                        desc_buffer_size_exp, 1,
+                                        typical_content_size, true, true);
+  FlesnetPatternGenerator threaded_source(
+      data_buffer_size_exp, desc_buffer_size_exp, 1, typical_content_size,
+      true, true, 0, 0, {}, 3);
+  fles::MicrosliceReceiver serial(serial_source);
+  fles::MicrosliceReceiver threaded(threaded_source);
+  FlesnetPatternChecker checker(1);
+
+  for (std::size_t count = 0; count < 1000; ++count) {
+    auto expected = serial.get();
+    auto microslice = threaded.get();
+    BOOST_REQUIRE(expected && microslice);
+    BOOST_REQUIRE_EQUAL(microslice->desc().idx, count);
+    BOOST_CHECK_EQUAL(microslice->desc().size, expected->desc().size);
+    BOOST_CHECK_EQUAL(microslice->desc().crc, expected->desc().crc);
+    BOOST_CHECK(checker.check(*microslice));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(content_alignment_test) {
+  uint32_t typical_content_size = 10000;
+  std::size_t desc_buffer_size_exp = 7;  // 128 entries
+  std::size_t data_buffer_size_exp = 20; // 1 MiB
+
+  FlesnetPatternGenerator source(data_buffer_size_exp, desc_buffer_size_exp,
+                                 1, typical_content_size, true, true, 0, 0,
+                                 {}, 0, 64);
+  source.proceed();
+  const uint64_t written = source.get_write_index().desc;
+  BOOST_REQUIRE(written > 1);
+  for (uint64_t i = 0; i < written; ++i) {
+    BOOST_CHECK_EQUAL(source.desc_buffer().at(i).offset % 64, 0);
+  }
+
+  fles::MicrosliceReceiver receiver(source);
+  FlesnetPatternChecker checker(1);
+  for (uint64_t i = 0; i < written; ++i) {
+    auto microslice = receiver.get();
+    BOOST_REQUIRE(microslice);
+    BOOST_CHECK(checker.check(*microslice));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(batch_test) {
+  uint32_t typical_content_size = 10000;
+  std::size_t desc_buffer_size_exp = 7;  // 128 entries
+  std::size_t data_buffer_size_exp = 20; // 1 MiB
+
+  FlesnetPatternGenerator single_source(data_buffer_size_exp,
+                                        desc_buffer_size_exp, 1,
+                                        typical_content_size, true, true);
+  FlesnetPatternGenerator batch_source(data_buffer_size_exp,
+                                       desc_buffer_size_exp, 1,
+                                       typical_content_size, true, true);
+  fles::MicrosliceReceiver single(single_source);
+  fles::MicrosliceReceiver batched(batch_source);
+
+  {
+    fles::MicrosliceOutputArchive single_output("single.msa");
+    fles::MicrosliceOutputArchive batch_output("batch.msa");
+
+    std::size_t count = 0;
+    while (count < 1000) {
+      fles::MicrosliceBatch batch = batched.get_batch(1000 - count);
+      BOOST_REQUIRE(!batch.empty());
+      BOOST_CHECK_LE(batch.size(), 1000 - count);
+      for (const auto& view : batch) {
+        auto expected = single.get();
+        BOOST_REQUIRE(expected);
+        BOOST_REQUIRE_EQUAL(view.desc().idx, count);
+        BOOST_REQUIRE_EQUAL(view.desc().size, expected->desc().size);
+        BOOST_CHECK(std::memcmp(view.content(), expected->content(),
+                                view.desc().size) == 0);
+        single_output.put(std::move(expected));
+        batch_output.put(std::shared_ptr<const fles::Microslice>(
+            std::shared_ptr<const fles::Microslice>(), &view));
+        ++count;
+      }
+    }
+  }
+
+  // the archives must not depend on the type of the stored microslices
+  std::ifstream single_file("single.msa", std::ios::binary);
+  std::ifstream batch_file("batch.msa", std::ios::binary);
+  std::vector<char> single_bytes{std::istreambuf_iterator<char>(single_file),
+                                 std::istreambuf_iterator<char>()};
+  std::vector<char> batch_bytes{std::istreambuf_iterator<char>(batch_file),
+                                std::istreambuf_iterator<char>()};
+  BOOST_CHECK(!batch_bytes.empty());
+  BOOST_CHECK(single_bytes == batch_bytes);
+}
+
+BOOST_AUTO_TEST_CASE(zero_copy_test) {
+  uint32_t typical_content_size = 10000;
+  std::size_t desc_buffer_size_exp = 7;  // 128 entries
+  std::size_t data_buffer_size_exp = 20; // 1 MiB
+
+  FlesnetPatternGenerator copy_source(data_buffer_size_exp,
+                                      desc_buffer_size_exp, 1,
+                                      typical_content_size, true, true);
+  FlesnetPatternGenerator zero_copy_source(data_buffer_size_exp,
+                                           desc_buffer_size_exp, 1,
+                                           typical_content_size, true, true);
+  fles::MicrosliceReceiver copying(copy_source);
+  fles::MicrosliceReceiver zero_copy(zero_copy_source);
+  zero_copy.set_zero_copy(true);
+
+  // hold some microslices (sharing their content) while reading on
+  using Pair = std::pair<fles::StorableMicroslice,
+                         std::unique_ptr<fles::StorableMicroslice>>;
+  std::deque<Pair> held;
+  std::size_t referenced = 0;
+  for (std::size_t count = 0; count < 1000; ++count) {
+    auto expected = copying.get();
+    std::unique_ptr<const fles::StorableMicroslice> microslice =
+        zero_copy.get();
+    BOOST_REQUIRE(expected && microslice);
+    BOOST_REQUIRE_EQUAL(microslice->desc().idx, count);
+    if (microslice->shared_content().external()) {
+      ++referenced;
+    }
+    fles::StorableMicroslice copy(*microslice);
+    BOOST_CHECK_EQUAL(copy.shared_content().data(), microslice->content());
+    held.emplace_back(std::move(copy), std::move(expected));
+    if (held.size() > 20) {
+      held.pop_front();
+    }
+    for (const auto& [ms, reference] : held) {
+      BOOST_REQUIRE_EQUAL(ms.desc().size, reference->desc().size);
+      BOOST_REQUIRE(std::memcmp(ms.shared_content().data(),
+                                reference->shared_content().data(),
+                                ms.desc().size) == 0);
+    }
+  }
+  BOOST_CHECK_GT(referenced, 900);
+
+  // modifying a copy does not affect the referenced content
+  std::unique_ptr<fles::StorableMicroslice> microslice;
+  do {
+    microslice = zero_copy.get();
+    BOOST_REQUIRE(microslice);
+  } while (!microslice->shared_content().external());
+  fles::StorableMicroslice copy(*microslice);
+  copy.content()[0] ^= 0xff;
+  BOOST_CHECK(!copy.shared_content().external());
+  BOOST_CHECK_NE(copy.content()[0], microslice->shared_content().data()[0]);
+  BOOST_CHECK(microslice->shared_content().external());
+}
+
+BOOST_AUTO_TEST_CASE(archive_replay_test) {
+  uint32_t typical_content_size = 10000;
+  std::size_t desc_buffer_size_exp = 7;  // 128 entries
+  std::size_t data_buffer_size_exp = 20; // 1 MiB
+  constexpr std::size_t archive_count = 300;
+
+  {
+    FlesnetPatternGenerator source(data_buffer_size_exp, desc_buffer_size_exp,
+                                   1, typical_content_size, true, true);
+    fles::MicrosliceReceiver receiver(source);
+    fles::MicrosliceOutputArchive output("replay.msa");
+    for (std::size_t count = 0; count < archive_count; ++count) {
+      output.put(receiver.get());
+    }
+  }
+
+  std::vector<std::unique_ptr<fles::StorableMicroslice>> reference;
+  fles::MicrosliceInputArchive input("replay.msa");
+  while (auto microslice = input.get()) {
+    reference.push_back(std::move(microslice));
+  }
+  BOOST_REQUIRE_EQUAL(reference.size(), archive_count);
+
+  for (uint64_t loops : {1, 3}) {
+    MicrosliceArchiveReplay replay("replay.msa", desc_buffer_size_exp, loops);
+    BOOST_REQUIRE_EQUAL(replay.num_microslices(), archive_count);
+    fles::MicrosliceReceiver receiver(replay);
+
+    std::size_t count = 0;
+    std::size_t next = 0;
+    uint64_t previous_idx = 0;
+    while (auto microslice = receiver.get()) {
+      // the replay may continue from the start of the archive at any time
+      const auto equal = [&microslice](const fles::Microslice& expected) {
+        return microslice->desc().size == expected.desc().size &&
+               std::memcmp(microslice->content(), expected.content(),
+                           expected.desc().size) == 0;
+      };
+      if (next == reference.size() || !equal(*reference[next])) {
+        BOOST_REQUIRE(loops > 1);
+        next = 0;
+      }
+      BOOST_REQUIRE(equal(*reference[next]));
+      BOOST_CHECK(count == 0 || microslice->desc().idx > previous_idx);
+      previous_idx = microslice->desc().idx;
+      ++next;
+      ++count;
+    }
+    BOOST_CHECK_EQUAL(count, loops * archive_count);
+  }
+}
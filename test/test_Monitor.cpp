@@ -0,0 +1,360 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#define BOOST_TEST_MODULE test_Monitor
+#include <boost/test/unit_test.hpp>
+
+#include "AllocationStats.hpp"
+#include "LiveStats.hpp"
+#include "Monitor.hpp"
+#include "MonitorSinkPrometheus.hpp"
+#include "ThreadStats.hpp"
+#define BOOST_ERROR_CODE_HEADER_ONLY
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <pthread.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+std::string temp_file_name() {
+  return "test_Monitor_" + std::to_string(getpid()) + ".txt";
+}
+
+// Read the metric lines written by a file sink, without timestamps
+std::vector<std::string> read_lines(const std::string& filename) {
+  std::vector<std::string> lines;
+  std::ifstream ifs(filename);
+  std::string line;
+  while (std::getline(ifs, line)) {
+    lines.push_back(line.substr(0, line.rfind(' ')));
+  }
+  return lines;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(registered_metrics_test) {
+  std::string filename = temp_file_name();
+  {
+    cbm::Monitor monitor("file:" + filename);
+    auto count = monitor.RegisterCounter("test", {{"a", "1"}}, "count");
+    auto gauge = monitor.RegisterGauge("test", {{"a", "1"}}, "level");
+    auto hist = monitor.RegisterHistogram("test", {{"a", "1"}}, "size");
+    auto other = monitor.RegisterCounter("test", {{"a", "2"}}, "count");
+    // a metric that is never recorded is left out of the output
+    [[maybe_unused]] auto unused =
+        monitor.RegisterCounter("unused", {}, "count");
+
+    // registering again yields the same cells
+    auto count2 = monitor.RegisterCounter("test", {{"a", "1"}}, "count");
+    BOOST_CHECK_THROW(monitor.RegisterGauge("test", {{"a", "1"}}, "count"),
+                      std::runtime_error);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back([&] {
+        for (uint64_t i = 0; i < 1000; ++i) {
+          count.Add();
+          hist.Record(i);
+        }
+        count2.Add(2);
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    gauge.Set(-5);
+    other.Add(7);
+  }
+
+  auto lines = read_lines(filename);
+  std::remove(filename.c_str());
+  BOOST_REQUIRE_EQUAL(lines.size(), 2);
+  std::string expected = "test,a=1 count=4008i,level=-5i,size_count=4000i,"
+                         "size_sum=1998000i,size_max=999i,size_mean=499.5,"
+                         "size_p50=511i,size_p90=959i,size_p99=999i,"
+                         "size_p999=999i,size_buckets=\"0:4,1:4,";
+  BOOST_CHECK_EQUAL(lines[0].substr(0, expected.size()), expected);
+  BOOST_CHECK(lines[0].find("960:160\"") != std::string::npos);
+  BOOST_CHECK_EQUAL(lines[1], "test,a=2 count=7i");
+  BOOST_CHECK(std::none_of(lines.begin(), lines.end(), [](const auto& line) {
+    return line.rfind("unused", 0) == 0;
+  }));
+}
+
+BOOST_AUTO_TEST_CASE(default_handle_test) {
+  cbm::MetricCounter count;
+  cbm::MetricHistogram hist;
+  count.Add();
+  hist.Record(42);
+}
+
+BOOST_AUTO_TEST_CASE(histogram_buckets_test) {
+  using cbm::Histogram;
+  for (size_t i = 0; i < Histogram::kNBucket; ++i) {
+    BOOST_REQUIRE_EQUAL(Histogram::BucketIndex(Histogram::BucketLower(i)), i);
+    BOOST_REQUIRE_EQUAL(Histogram::BucketIndex(Histogram::BucketUpper(i)), i);
+    if (i > 0) {
+      BOOST_REQUIRE_EQUAL(Histogram::BucketLower(i),
+                          Histogram::BucketUpper(i - 1) + 1);
+    }
+    // relative bucket width is bounded
+    uint64_t lower = Histogram::BucketLower(i);
+    uint64_t width = Histogram::BucketUpper(i) - lower;
+    BOOST_REQUIRE_LE(width, lower / Histogram::kNSub);
+  }
+  BOOST_CHECK_EQUAL(Histogram::BucketIndex(UINT64_MAX),
+                    Histogram::kNBucket - 1);
+}
+
+BOOST_AUTO_TEST_CASE(histogram_merge_test) {
+  cbm::Histogram a;
+  cbm::Histogram b;
+  cbm::Histogram all;
+  for (uint64_t i = 1; i <= 1000; ++i) {
+    (i % 2 == 0 ? a : b).Record(i * 1000);
+    all.Record(i * 1000);
+  }
+  a.Merge(b);
+  BOOST_CHECK(a == all);
+  BOOST_CHECK_EQUAL(a.Count(), 1000);
+  BOOST_CHECK_EQUAL(a.Max(), 1000000);
+  BOOST_CHECK_EQUAL(a.Mean(), 500500.);
+  // percentiles are accurate to the bucket width
+  for (double q : {0.5, 0.9, 0.99}) {
+    double exact = q * 1000000;
+    auto p = static_cast<double>(a.Percentile(q));
+    BOOST_CHECK_GE(p, exact);
+    BOOST_CHECK_LE(p, exact * (1. + 1. / cbm::Histogram::kNSub));
+  }
+  BOOST_CHECK_EQUAL(a.Percentile(1.), 1000000);
+  a.Reset();
+  BOOST_CHECK_EQUAL(a.Count(), 0);
+  BOOST_CHECK_EQUAL(a.Percentile(0.5), 0);
+}
+
+BOOST_AUTO_TEST_CASE(prometheus_sink_test) {
+  namespace http = boost::beast::http;
+  using tcp = boost::asio::ip::tcp;
+  cbm::Monitor monitor;
+  cbm::MonitorSinkPrometheus sink(monitor, "127.0.0.1:0");
+
+  cbm::Histogram hist;
+  hist.Record(3);
+  hist.Record(100);
+  for (int i = 0; i < 2; ++i) {
+    sink.ProcessMetricVec(
+        {cbm::Metric("test-sink", {{"host", "a\"b"}},
+                     {{"count", uint64_t(5 + i)},
+                      {"ok", true},
+                      {"name", std::string("skipped")},
+                      {"size", hist}})});
+  }
+
+  // histograms accumulate, other fields keep their latest value
+  const std::string tags = "host=\"a\\\"b\"";
+  std::string expected =
+      "# TYPE test_sink_count untyped\n"
+      "test_sink_count{" + tags + "} 6\n"
+      "# TYPE test_sink_ok untyped\n"
+      "test_sink_ok{" + tags + "} 1\n"
+      "# TYPE test_sink_size histogram\n"
+      "test_sink_size_bucket{" + tags + ",le=\"3\"} 2\n"
+      "test_sink_size_bucket{" + tags + ",le=\"103\"} 4\n"
+      "test_sink_size_bucket{" + tags + ",le=\"+Inf\"} 4\n"
+      "test_sink_size_sum{" + tags + "} 206\n"
+      "test_sink_size_count{" + tags + "} 4\n";
+  BOOST_CHECK_EQUAL(sink.Exposition(), expected);
+
+  // a scrape returns the same text
+  boost::asio::io_context ioc;
+  tcp::socket socket(ioc);
+  socket.connect(tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"),
+                               sink.Port()));
+  http::request<http::string_body> req{http::verb::get, "/metrics", 11};
+  http::write(socket, req);
+  boost::beast::flat_buffer buffer;
+  http::response<http::string_body> res;
+  http::read(socket, buffer, res);
+  BOOST_CHECK_EQUAL(res.result_int(), 200);
+  BOOST_CHECK_EQUAL(res.body(), expected);
+}
+
+BOOST_AUTO_TEST_CASE(thread_stats_test) {
+  std::atomic<bool> stop{false};
+  std::thread spin([&stop] {
+    while (!stop.load(std::memory_order_relaxed)) {
+    }
+  });
+  pthread_setname_np(spin.native_handle(), "test:spin");
+
+  cbm::ThreadStats stats;
+  std::vector<cbm::Metric> metvec;
+  stats.Snapshot(metvec);
+  BOOST_CHECK(metvec.empty());
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  stats.Snapshot(metvec);
+  stop = true;
+  spin.join();
+
+  BOOST_REQUIRE_EQUAL(metvec.size(), 1);
+  const auto& metric = metvec[0];
+  BOOST_CHECK_EQUAL(metric.fMeasurement, "thread_stats");
+  BOOST_CHECK_EQUAL(metric.fTagset[0].second, "test:spin");
+  BOOST_CHECK(metric.fFieldset[0].second == cbm::MetricField(uint64_t{1}));
+  BOOST_CHECK_EQUAL(metric.fFieldset[1].first, "cpu_utilization");
+  double utilization = std::get<double>(metric.fFieldset[1].second);
+  BOOST_CHECK_GT(utilization, 0.1);
+  BOOST_CHECK_LT(utilization, 1.5);
+}
+
+BOOST_AUTO_TEST_CASE(thread_stats_resctrl_test) {
+  namespace fs = std::filesystem;
+  const fs::path root = "test_Monitor_" + std::to_string(getpid());
+  auto write = [](const fs::path& path, const std::string& content) {
+    fs::create_directories(path.parent_path());
+    std::ofstream(path) << content;
+  };
+  write(root / "comm", "flesnet\n");
+  write(root / "task/10/comm", "fles:builder\n");
+  write(root / "task/10/schedstat", "1000 0 1\n");
+  write(root / "task/10/cpu_resctrl_groups", "res:transport\nmon:\n");
+  write(root / "task/11/comm", "fles:builder\n");
+  write(root / "task/11/schedstat", "1000 0 1\n");
+  write(root / "task/11/cpu_resctrl_groups", "res:/\nmon:/\n");
+  const fs::path mon = root / "resctrl/transport/mon_data";
+  write(mon / "mon_L3_00/llc_occupancy", "1000\n");
+  write(mon / "mon_L3_00/mbm_total_bytes", "5000\n");
+  write(mon / "mon_L3_01/llc_occupancy", "500\n");
+  write(mon / "mon_L3_01/mbm_total_bytes", "Unavailable\n");
+
+  cbm::ThreadStats stats((root / "task").string(),
+                         (root / "resctrl").string());
+  std::vector<cbm::Metric> metvec;
+  stats.Snapshot(metvec);
+  BOOST_CHECK(metvec.empty());
+  write(mon / "mon_L3_00/mbm_total_bytes", "105000\n");
+  stats.Snapshot(metvec);
+  fs::remove_all(root);
+
+  // one builder in the group, one in the default group
+  BOOST_REQUIRE_EQUAL(metvec.size(), 3);
+  BOOST_CHECK_EQUAL(metvec[0].fTagset.size(), 1);
+  BOOST_REQUIRE_EQUAL(metvec[1].fTagset.size(), 2);
+  BOOST_CHECK_EQUAL(metvec[1].fTagset[1].first, "resctrl_group");
+  BOOST_CHECK_EQUAL(metvec[1].fTagset[1].second, "transport");
+
+  const auto& group = metvec[2];
+  BOOST_CHECK_EQUAL(group.fMeasurement, "resctrl_group");
+  BOOST_CHECK_EQUAL(group.fTagset[0].second, "transport");
+  BOOST_CHECK(group.fFieldset[0].second == cbm::MetricField(uint64_t{1500}));
+  BOOST_CHECK_EQUAL(group.fFieldset[1].first, "memory_bandwidth");
+  BOOST_CHECK_GT(std::get<double>(group.fFieldset[1].second), 0.);
+}
+
+// enables the accounting for the rest of the process, so it runs last
+BOOST_AUTO_TEST_CASE(allocation_stats_test) {
+  using cbm::AllocationStats;
+  {
+    // created before enabling, not accounted
+    cbm::AllocationRecord inactive(AllocationStats::kItem);
+    inactive.Update(1000);
+    BOOST_CHECK(!inactive.Active());
+  }
+  BOOST_CHECK_EQUAL(AllocationStats::Read(AllocationStats::kItem).fAllocations,
+                    0);
+
+  AllocationStats::Enable();
+  {
+    cbm::AllocationRecord a(AllocationStats::kItem);
+    a.Update(100);
+    {
+      cbm::AllocationRecord b(a);
+      b.Update(300);
+      auto values = AllocationStats::Read(AllocationStats::kItem);
+      BOOST_CHECK_EQUAL(values.fLiveBytes, 400);
+      BOOST_CHECK_EQUAL(values.fAllocations, 2);
+    }
+    a.Update(50);
+    auto values = AllocationStats::Read(AllocationStats::kItem);
+    BOOST_CHECK_EQUAL(values.fLiveBytes, 50);
+    BOOST_CHECK_EQUAL(values.fPeakBytes, 400);
+  }
+
+  std::vector<cbm::Metric> metvec;
+  AllocationStats::Snapshot(metvec);
+  BOOST_REQUIRE_EQUAL(metvec.size(), AllocationStats::kNCategory);
+  const auto& item = metvec[AllocationStats::kItem];
+  BOOST_CHECK_EQUAL(item.fMeasurement, "allocations");
+  BOOST_CHECK_EQUAL(item.fTagset[0].second, "item");
+  BOOST_CHECK(item.fFieldset[0].second == cbm::MetricField(uint64_t{0}));
+  BOOST_CHECK(item.fFieldset[1].second == cbm::MetricField(uint64_t{400}));
+  BOOST_CHECK(item.fFieldset[2].second == cbm::MetricField(uint64_t{2}));
+
+  // the peak restarts from the live bytes
+  BOOST_CHECK_EQUAL(AllocationStats::Read(AllocationStats::kItem).fPeakBytes,
+                    0);
+}
+
+BOOST_AUTO_TEST_CASE(live_stats_test) {
+  using cbm::LiveStats;
+  using cbm::LiveStatsReader;
+  const std::string instance = "test_Monitor." + std::to_string(getpid());
+
+  // handles requested before creation discard their values
+  cbm::LiveCounter inactive = LiveStats::Counter("inactive");
+  inactive.Add();
+  BOOST_CHECK(!LiveStats::Enabled());
+
+  LiveStats::Create(instance);
+  BOOST_CHECK(LiveStats::Enabled());
+  BOOST_CHECK_THROW(LiveStats::Create(instance), std::runtime_error);
+
+  cbm::LiveCounter count = LiveStats::Counter("count");
+  count.Add(3);
+  LiveStats::Counter("count").Add();
+  LiveStats::Counter("index").Set(42);
+  cbm::LiveHistogram size = LiveStats::Histogram("size", 0x1234);
+  size.Record(10);
+  size.Record(1000);
+  LiveStats::Histogram("size", 0x1235).Record(7);
+
+  auto instances = LiveStatsReader::List();
+  BOOST_CHECK(std::find(instances.begin(), instances.end(), instance) !=
+              instances.end());
+  {
+    LiveStatsReader reader(instance);
+    BOOST_CHECK_EQUAL(reader.Pid(), static_cast<uint32_t>(getpid()));
+    BOOST_CHECK(reader.Alive());
+
+    auto counters = reader.Counters();
+    BOOST_REQUIRE_EQUAL(counters.size(), 2);
+    BOOST_CHECK_EQUAL(counters[0].fName, "count");
+    BOOST_CHECK_EQUAL(counters[0].fValue, 4);
+    BOOST_CHECK_EQUAL(counters[1].fName, "index");
+    BOOST_CHECK_EQUAL(counters[1].fValue, 42);
+
+    auto histograms = reader.Histograms();
+    BOOST_REQUIRE_EQUAL(histograms.size(), 2);
+    BOOST_CHECK_EQUAL(histograms[0].fName, "size");
+    BOOST_CHECK_EQUAL(histograms[0].fKey, 0x1234);
+    BOOST_CHECK_EQUAL(histograms[0].fHistogram.Count(), 2);
+    BOOST_CHECK_EQUAL(histograms[0].fHistogram.Sum(), 1010);
+    BOOST_CHECK_EQUAL(histograms[0].fHistogram.Max(), 1000);
+    BOOST_CHECK_EQUAL(histograms[1].fHistogram.Count(), 1);
+  }
+
+  LiveStats::Remove();
+  BOOST_CHECK_THROW(LiveStatsReader reader(instance), std::runtime_error);
+}
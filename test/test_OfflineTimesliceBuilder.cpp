@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#define BOOST_TEST_MODULE test_OfflineTimesliceBuilder
+#include <boost/test/unit_test.hpp>
+
+#include "MicrosliceOutputArchive.hpp"
+#include "OfflineTimesliceBuilder.hpp"
+#include "StorableMicroslice.hpp"
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/// A microslice source returning microslices with the given start times.
+class VectorSource : public fles::MicrosliceSource {
+public:
+  VectorSource(uint16_t eq_id, std::vector<uint64_t> times)
+      : eq_id_(eq_id), times_(std::move(times)) {}
+
+  [[nodiscard]] bool eos() const override { return next_ == times_.size(); }
+
+private:
+  uint16_t eq_id_;
+  std::vector<uint64_t> times_;
+  std::size_t next_ = 0;
+
+  fles::StorableMicroslice* do_get() override {
+    if (eos()) {
+      return nullptr;
+    }
+    fles::MicrosliceDescriptor desc{};
+    desc.eq_id = eq_id_;
+    desc.idx = times_[next_++];
+    desc.size = 1;
+    const auto content = static_cast<uint8_t>(desc.idx);
+    return new fles::StorableMicroslice(desc, &content); // NOLINT
+  }
+};
+
+std::vector<uint64_t> ramp(uint64_t count, uint64_t step) {
+  std::vector<uint64_t> times;
+  for (uint64_t i = 0; i < count; ++i) {
+    times.push_back(i * step);
+  }
+  return times;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(count_mode_test) {
+  std::vector<std::unique_ptr<fles::MicrosliceSource>> channels;
+  channels.push_back(std::make_unique<VectorSource>(1, ramp(10, 100)));
+  channels.push_back(std::make_unique<VectorSource>(2, ramp(12, 100)));
+  OfflineTimesliceBuilder builder(std::move(channels), 4, 1);
+
+  // timeslice n holds microslices 4n to 4n + 4 (overlap) of each channel;
+  // the third one would need microslice 12 of the first channel
+  for (uint64_t n = 0; n < 2; ++n) {
+    auto ts = builder.get();
+    BOOST_REQUIRE(ts);
+    BOOST_CHECK_EQUAL(ts->index(), n);
+    BOOST_CHECK_EQUAL(ts->num_core_microslices(), 4);
+    BOOST_REQUIRE_EQUAL(ts->num_components(), 2);
+    for (uint64_t c = 0; c < 2; ++c) {
+      BOOST_REQUIRE_EQUAL(ts->num_microslices(c), 5);
+      BOOST_CHECK_EQUAL(ts->descriptor(c, 0).eq_id, c + 1);
+      for (uint64_t m = 0; m < 5; ++m) {
+        BOOST_CHECK_EQUAL(ts->descriptor(c, m).idx, (4 * n + m) * 100);
+        BOOST_CHECK_EQUAL(*ts->content(c, m),
+                          static_cast<uint8_t>((4 * n + m) * 100));
+      }
+    }
+  }
+  BOOST_CHECK(!builder.get());
+  BOOST_CHECK(builder.eos());
+}
+
+BOOST_AUTO_TEST_CASE(time_mode_test) {
+  // channels with different microslice durations cover the same windows
+  std::vector<std::unique_ptr<fles::MicrosliceSource>> channels;
+  channels.push_back(std::make_unique<VectorSource>(1, ramp(20, 100)));
+  channels.push_back(std::make_unique<VectorSource>(2, ramp(10, 200)));
+  OfflineTimesliceBuilder builder(std::move(channels), 0, 0, 500, 100);
+
+  std::vector<uint64_t> first_times;
+  while (auto ts = builder.get()) {
+    BOOST_CHECK_EQUAL(ts->num_core_microslices(), 0);
+    BOOST_REQUIRE_EQUAL(ts->num_components(), 2);
+    // window [500n, 500n + 500) and overlap up to 500n + 600
+    const uint64_t n = ts->index();
+    BOOST_CHECK_EQUAL(ts->num_microslices(0), 6);
+    BOOST_CHECK_EQUAL(ts->descriptor(0, 0).idx, 500 * n);
+    BOOST_CHECK_LT(ts->descriptor(1, ts->num_microslices(1) - 1).idx,
+                   500 * n + 600);
+    first_times.push_back(ts->descriptor(1, 0).idx);
+  }
+  BOOST_CHECK_EQUAL(first_times.size(), 3);
+  BOOST_CHECK_EQUAL(first_times.at(1), 600);
+}
+
+BOOST_AUTO_TEST_CASE(archive_test) {
+  const std::vector<std::string> filenames{"test_otb_0.msa", "test_otb_1.msa"};
+  for (std::size_t c = 0; c < filenames.size(); ++c) {
+    fles::MicrosliceOutputArchive output(filenames[c]);
+    VectorSource source(static_cast<uint16_t>(c), ramp(7, 100));
+    while (auto ms = source.get()) {
+      output.put(std::move(ms));
+    }
+  }
+  auto builder = OfflineTimesliceBuilder::from_archives(filenames, 2, 1);
+  uint64_t count = 0;
+  while (auto ts = builder->get()) {
+    BOOST_CHECK_EQUAL(ts->num_components(), 2);
+    BOOST_CHECK_EQUAL(ts->descriptor(1, 2).idx, (2 * count + 2) * 100);
+    ++count;
+  }
+  BOOST_CHECK_EQUAL(count, 3);
+}
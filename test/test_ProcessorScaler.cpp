@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#define BOOST_TEST_MODULE test_ProcessorScaler
+#include <boost/test/unit_test.hpp>
+
+#include "ProcessorScaler.hpp"
+#include <stdexcept>
+
+using namespace std::chrono_literals;
+
+BOOST_AUTO_TEST_CASE(parse_test) {
+  auto p = ProcessorScalingParameters::parse("min=2,max=8,up=4,downdelay=60");
+  BOOST_CHECK(p.enabled());
+  BOOST_CHECK_EQUAL(p.min_instances, 2);
+  BOOST_CHECK_EQUAL(p.max_instances, 8);
+  BOOST_CHECK_EQUAL(p.scale_up_load, 4);
+  BOOST_CHECK(p.scale_down_delay == 60s);
+  BOOST_CHECK(!ProcessorScalingParameters::parse("").enabled());
+  BOOST_CHECK_THROW(ProcessorScalingParameters::parse("max"),
+                    std::invalid_argument);
+  BOOST_CHECK_THROW(ProcessorScalingParameters::parse("cores=1"),
+                    std::invalid_argument);
+  BOOST_CHECK_THROW(ProcessorScalingParameters::parse("min=4,max=2"),
+                    std::invalid_argument);
+  BOOST_CHECK_THROW(ProcessorScalingParameters::parse("max=2,up=1,down=1"),
+                    std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(hysteresis_test) {
+  ProcessorScalingParameters p;
+  p.min_instances = 1;
+  p.max_instances = 3;
+  p.scale_up_load = 2;
+  p.scale_down_load = 0.5;
+  p.scale_up_delay = 1s;
+  p.scale_down_delay = 5s;
+  const auto t0 = ProcessorScaler::clock::time_point();
+  ProcessorScaler scaler(p, 1, t0);
+
+  // a short burst does not add an instance
+  BOOST_CHECK_EQUAL(scaler.update(10, t0 + 1s), 0);
+  BOOST_CHECK_EQUAL(scaler.update(10, t0 + 1500ms), 0);
+  BOOST_CHECK_EQUAL(scaler.update(1, t0 + 2s), 0);
+
+  // a sustained backlog does, one instance per delay
+  BOOST_CHECK_EQUAL(scaler.update(10, t0 + 3s), 0);
+  BOOST_CHECK_EQUAL(scaler.update(10, t0 + 4s), 1);
+  BOOST_CHECK_EQUAL(scaler.update(10, t0 + 4500ms), 0);
+  BOOST_CHECK_EQUAL(scaler.update(10, t0 + 5s), 1);
+  BOOST_CHECK_EQUAL(scaler.instances(), 3);
+
+  // but not beyond the maximum
+  BOOST_CHECK_EQUAL(scaler.update(100, t0 + 10s), 0);
+  BOOST_CHECK_EQUAL(scaler.instances(), 3);
+
+  // a load between the thresholds keeps the instances
+  BOOST_CHECK_EQUAL(scaler.update(3, t0 + 20s), 0);
+  BOOST_CHECK_EQUAL(scaler.update(3, t0 + 30s), 0);
+
+  // idle instances are retired after the longer delay, down to the minimum
+  BOOST_CHECK_EQUAL(scaler.update(0, t0 + 31s), 0);
+  BOOST_CHECK_EQUAL(scaler.update(0, t0 + 35s), 0);
+  BOOST_CHECK_EQUAL(scaler.update(0, t0 + 36s), -1);
+  BOOST_CHECK_EQUAL(scaler.update(0, t0 + 41s), -1);
+  BOOST_CHECK_EQUAL(scaler.update(0, t0 + 60s), 0);
+  BOOST_CHECK_EQUAL(scaler.instances(), 1);
+}
@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#define BOOST_TEST_MODULE test_RampCompare
+#include <boost/test/unit_test.hpp>
+
+#include "FlesnetPatternChecker.hpp"
+#include "MicrosliceView.hpp"
+#include "RampCompare.hpp"
+#include <vector>
+
+namespace {
+
+std::vector<uint64_t> ramp(size_t count, uint64_t first, uint64_t step) {
+  std::vector<uint64_t> words(count + 1);
+  for (size_t i = 0; i < words.size(); ++i) {
+    words[i] = first + i * step;
+  }
+  return words;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(ramp_compare_implementations_test) {
+  const uint64_t first = 0xABCD000000000000;
+  for (RampCompareIsa isa : ramp_compare_supported_isas()) {
+    BOOST_TEST_MESSAGE("implementation: " << to_string(isa));
+    for (size_t count : {0, 1, 7, 8, 15, 16, 17, 33, 100, 1000}) {
+      // offset by one word to test unaligned access
+      std::vector<uint64_t> words = ramp(count, first - 8, 8);
+      const uint64_t* data = words.data() + 1;
+
+      uint64_t expected_xor = 0;
+      for (size_t i = 0; i < count; ++i) {
+        expected_xor ^= data[i];
+      }
+      uint64_t word_xor = 0;
+      BOOST_CHECK_EQUAL(ramp_compare(isa, data, count, first, 8, word_xor),
+                        count);
+      BOOST_CHECK_EQUAL(word_xor, expected_xor);
+
+      for (size_t error = 0; error < count; error += 3) {
+        words[1 + error] ^= 0x10;
+        BOOST_CHECK_EQUAL(ramp_compare(isa, data, count, first, 8, word_xor),
+                          error);
+        words[1 + error] ^= 0x10;
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(flesnet_pattern_checker_test) {
+  const size_t component = 3;
+  std::vector<uint64_t> words(100);
+  uint32_t crc = 0;
+  for (size_t pos = 0; pos < words.size(); ++pos) {
+    words[pos] = (static_cast<uint64_t>(component) << 48) | (pos * 8);
+    crc ^= static_cast<uint32_t>(words[pos] & 0xffffffff) ^
+           static_cast<uint32_t>(words[pos] >> 32);
+  }
+
+  fles::MicrosliceDescriptor desc = fles::MicrosliceDescriptor();
+  desc.size = static_cast<uint32_t>(words.size() * sizeof(uint64_t));
+  desc.crc = crc;
+  fles::MicrosliceView m(desc, reinterpret_cast<uint8_t*>(words.data()));
+
+  FlesnetPatternChecker checker(component);
+  BOOST_CHECK(checker.check(m));
+
+  desc.crc ^= 1;
+  BOOST_CHECK(!checker.check(m));
+  desc.crc ^= 1;
+
+  words[42] ^= 1;
+  BOOST_CHECK(!checker.check(m));
+}
@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#define BOOST_TEST_MODULE test_ReducingSource
+#include <boost/test/unit_test.hpp>
+
+#include "ReducingSource.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+// Input buffer with microslices written by the test
+class FakeInput : public InputBufferReadInterface {
+public:
+  FakeInput()
+      : data_(6), desc_(3), data_view_(data_.ptr(), 6),
+        desc_view_(desc_.ptr(), 3) {}
+
+  // Append a microslice filled with its index
+  void write(uint32_t size) {
+    auto& desc = desc_.at(write_index_.desc);
+    desc = fles::MicrosliceDescriptor();
+    desc.idx = write_index_.desc;
+    desc.size = size;
+    desc.offset = write_index_.data;
+    for (uint32_t i = 0; i < size; ++i) {
+      data_.at(write_index_.data + i) = static_cast<uint8_t>(desc.idx);
+    }
+    write_index_ += {1, size};
+  }
+
+  RingBufferView<uint8_t>& data_buffer() override { return data_view_; }
+  RingBufferView<fles::MicrosliceDescriptor>& desc_buffer() override {
+    return desc_view_;
+  }
+  DualIndex get_write_index() override { return write_index_; }
+  bool get_eof() override { return false; }
+  void set_read_index(DualIndex new_read_index) override {
+    read_index_ = new_read_index;
+  }
+  DualIndex get_read_index() override { return read_index_; }
+
+  DualIndex write_index_{0, 0};
+  DualIndex read_index_{0, 0};
+
+private:
+  RingBuffer<uint8_t> data_;
+  RingBuffer<fles::MicrosliceDescriptor, true> desc_;
+  RingBufferView<uint8_t> data_view_;
+  RingBufferView<fles::MicrosliceDescriptor> desc_view_;
+};
+} // namespace
+
+BOOST_AUTO_TEST_CASE(truncate_test) {
+  FakeInput input;
+  ReducingSource source(input, make_microslice_reducer("truncate:8"));
+  input.write(4);
+  input.write(20);
+  input.write(8);
+  source.proceed();
+
+  BOOST_REQUIRE_EQUAL(source.get_write_index().desc, 3);
+  BOOST_CHECK_EQUAL(source.get_write_index().data, 20);
+  const auto& desc = source.desc_buffer().at(1);
+  BOOST_CHECK_EQUAL(desc.size, 8);
+  BOOST_CHECK_EQUAL(desc.offset, 4);
+  BOOST_CHECK(desc.flags &
+              static_cast<uint16_t>(fles::MicrosliceFlags::OverflowUser));
+  BOOST_CHECK_EQUAL(source.data_buffer().at(desc.offset + 7), 1);
+  BOOST_CHECK_EQUAL(source.bytes_in(), 32);
+  BOOST_CHECK_EQUAL(source.bytes_out(), 20);
+
+  // the upstream space is released with the staged microslices
+  source.set_read_index({2, 12});
+  BOOST_CHECK_EQUAL(input.read_index_.desc, 2);
+  BOOST_CHECK_EQUAL(input.read_index_.data, 24);
+}
+
+BOOST_AUTO_TEST_CASE(drop_test) {
+  FakeInput input;
+  ReducingSource source(input, make_microslice_reducer("empty"), 2, true);
+  input.write(0);
+  input.write(16);
+  input.write(0);
+  for (int i = 0; i < 100; ++i) {
+    source.proceed();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  BOOST_REQUIRE_EQUAL(source.get_write_index().desc, 1);
+  BOOST_CHECK_EQUAL(source.desc_buffer().at(0).idx, 1);
+
+  // trailing dropped microslices are released once all staged ones are
+  source.set_read_index({1, 16});
+  BOOST_CHECK_EQUAL(input.read_index_.desc, 3);
+  BOOST_CHECK_EQUAL(input.read_index_.data, 16);
+
+  BOOST_CHECK_THROW(make_microslice_reducer("truncate:x"),
+                    std::invalid_argument);
+}
@@ -0,0 +1,45 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#define BOOST_TEST_MODULE test_ReplayScheduler
+#include <boost/test/unit_test.hpp>
+
+#include "ReplayScheduler.hpp"
+#include <chrono>
+#include <stdexcept>
+
+BOOST_AUTO_TEST_CASE(pacing_test) {
+  using namespace std::chrono_literals;
+  // replay 20 ms of timestamps at twice the original speed
+  ReplayScheduler scheduler(2.0);
+  constexpr uint64_t first = 1'000'000'000;
+  constexpr uint64_t step = 2'000'000; // 2 ms
+
+  auto begin = ReplayScheduler::clock::now();
+  for (uint64_t i = 0; i <= 10; ++i) {
+    auto error = scheduler.wait(first + i * step);
+    auto elapsed = ReplayScheduler::clock::now() - begin;
+    BOOST_CHECK(error >= 0ns);
+    BOOST_CHECK(elapsed >= i * 1ms);
+  }
+
+  const auto& stats = scheduler.statistics();
+  BOOST_CHECK_EQUAL(stats.count, 11);
+  BOOST_CHECK(stats.max_error >= stats.mean_error());
+  // generous bound, as the test may run on a loaded machine
+  BOOST_CHECK(stats.mean_error() < 5ms);
+
+  scheduler.reset_statistics();
+  BOOST_CHECK_EQUAL(scheduler.statistics().count, 0);
+}
+
+BOOST_AUTO_TEST_CASE(past_timestamp_test) {
+  using namespace std::chrono_literals;
+  ReplayScheduler scheduler(1.0);
+  scheduler.wait(5'000'000);
+  // an earlier timestamp is released immediately
+  auto begin = ReplayScheduler::clock::now();
+  scheduler.wait(1'000'000);
+  BOOST_CHECK(ReplayScheduler::clock::now() - begin < 10ms);
+
+  BOOST_CHECK_THROW(ReplayScheduler(0.0), std::invalid_argument);
+}
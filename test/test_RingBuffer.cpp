@@ -1,7 +1,11 @@
 // Copyright 2015 Jan de Cuveland <cmail@cuveland.de>
 
+#include "ManagedRingBuffer.hpp"
 #include "RingBuffer.hpp"
+#include "StreamingCopy.hpp"
 #include <iostream>
+#include <numeric>
+#include <vector>
 
 class Simple {
 public:
@@ -15,6 +19,52 @@ int main() {
     RingBuffer<Simple, false, true> s;
     s.alloc_with_size(4);
     std::printf("ptr: %p\n", static_cast<void*>(s.ptr()));
+
+    MemoryPolicy policy;
+    policy.huge_pages = HugePages::Transparent;
+    RingBuffer<uint64_t, true> t(21 - 3, policy);
+    t.at(t.size() - 1) = 42;
+    std::printf("ptr: %p (%s)\n", static_cast<void*>(t.ptr()),
+                policy.description().c_str());
+    if (t.at(0) != 0 || t.at(t.size() - 1) != 42) {
+      return EXIT_FAILURE;
+    }
+
+    policy = MemoryPolicy{};
+    policy.mirrored = true;
+    RingBuffer<uint64_t, true> m(16 - 3, policy);
+    m.at(m.size() - 1) = 1;
+    (&m.at(m.size() - 1))[1] = 2;
+    std::printf("ptr: %p (%s)\n", static_cast<void*>(m.ptr()),
+                policy.description().c_str());
+    if (!m.mirrored() || m.at(0) != 2 || (&m.at(0))[2 * m.size() - 1] != 1) {
+      return EXIT_FAILURE;
+    }
+
+    // Streaming copy of a reserved range at an unaligned offset
+    std::vector<uint8_t> buffer(UINT64_C(1) << 20);
+    ManagedRingBuffer<uint8_t> r(buffer.data(), 20);
+    std::vector<uint8_t> source(streaming_copy_threshold + 77);
+    std::iota(source.begin(), source.end(), uint8_t{3});
+    r.reserve(5);
+    const size_t offset = r.reserve(source.size());
+    streaming_copy(&r.at(offset), source.data() + 1, source.size() - 1);
+    if (r.write_index() != 5 + source.size() ||
+        !std::equal(source.begin() + 1, source.end(), &r.at(offset))) {
+      return EXIT_FAILURE;
+    }
+
+    // Bulk copies across the wrap-around, streamed and not
+    for (const std::size_t n : {std::size_t{1000}, source.size()}) {
+      const std::size_t index = r.size() * 3 - n / 2;
+      r.copy_in(index, source.data(), n, true);
+      std::vector<uint8_t> copy(n);
+      r.copy_out(index, copy.data(), n);
+      if (!std::equal(copy.begin(), copy.end(), source.begin()) ||
+          r.at(index + n - 1) != source[n - 1]) {
+        return EXIT_FAILURE;
+      }
+    }
   } catch (std::exception const& e) {
     std::cerr << e.what() << std::endl;
     return EXIT_FAILURE;
@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#define BOOST_TEST_MODULE test_Scheduler
+#include <boost/test/unit_test.hpp>
+
+#include "Scheduler.hpp"
+#include <array>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(order_test) {
+  using namespace std::chrono_literals;
+  Scheduler scheduler;
+  std::vector<int> fired;
+  auto now = Scheduler::clock::now();
+  scheduler.add([&] { fired.push_back(3); }, now + 15ms);
+  scheduler.add([&] { fired.push_back(1); }, now + 1ms);
+  scheduler.add([&] { fired.push_back(0); }, now);
+  scheduler.add([&] { fired.push_back(2); }, now + 6ms);
+  BOOST_CHECK_EQUAL(scheduler.size(), 4);
+
+  // events due when added run on the next call
+  scheduler.timer();
+  BOOST_REQUIRE_EQUAL(fired.size(), 1);
+  BOOST_CHECK_EQUAL(fired[0], 0);
+
+  while (!scheduler.empty()) {
+    scheduler.timer();
+    // no event may run before its time
+    if (Scheduler::clock::now() < now + 15ms) {
+      BOOST_CHECK(fired.size() < 4);
+    }
+  }
+  BOOST_CHECK((fired == std::vector<int>{0, 1, 2, 3}));
+  BOOST_CHECK(Scheduler::clock::now() >= now + 15ms);
+}
+
+BOOST_AUTO_TEST_CASE(cascade_test) {
+  using namespace std::chrono_literals;
+  // delays spanning the lower three levels of the wheel
+  Scheduler scheduler;
+  std::array<std::chrono::milliseconds, 4> delays{2ms, 30ms, 300ms, 700ms};
+  std::vector<Scheduler::clock::duration> lateness(delays.size());
+  auto now = Scheduler::clock::now();
+  for (std::size_t i = 0; i < delays.size(); ++i) {
+    scheduler.add(
+        [&, i] { lateness[i] = Scheduler::clock::now() - (now + delays[i]); },
+        now + delays[i]);
+  }
+  while (!scheduler.empty()) {
+    scheduler.timer();
+    std::this_thread::sleep_for(100us);
+  }
+  for (auto late : lateness) {
+    BOOST_CHECK(late >= 0ns);
+    // generous bound, as the test may run on a loaded machine
+    BOOST_CHECK(late < 50ms);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(cancel_test) {
+  using namespace std::chrono_literals;
+  Scheduler scheduler;
+  int count = 0;
+  auto now = Scheduler::clock::now();
+  auto first = scheduler.add([&] { ++count; }, now + 1ms);
+  auto second = scheduler.add([&] { count += 10; }, now + 2ms);
+  BOOST_CHECK(scheduler.cancel(second));
+  BOOST_CHECK(!scheduler.cancel(second));
+  BOOST_CHECK_EQUAL(scheduler.size(), 1);
+
+  std::this_thread::sleep_for(3ms);
+  scheduler.timer();
+  BOOST_CHECK_EQUAL(count, 1);
+  BOOST_CHECK(scheduler.empty());
+  // the handle of an event that has run is stale, even if its storage is
+  // reused
+  auto third = scheduler.add([&] { count += 100; }, now);
+  BOOST_CHECK(!scheduler.cancel(first));
+  BOOST_CHECK(scheduler.cancel(third));
+  scheduler.timer();
+  BOOST_CHECK_EQUAL(count, 1);
+}
+
+BOOST_AUTO_TEST_CASE(reschedule_test) {
+  using namespace std::chrono_literals;
+  // a periodic event adding itself again, as used by the event loops
+  Scheduler scheduler;
+  int count = 0;
+  std::function<void()> periodic = [&] {
+    ++count;
+    scheduler.add(periodic, Scheduler::clock::now());
+  };
+  scheduler.add(periodic, Scheduler::clock::now());
+  for (int i = 0; i < 5; ++i) {
+    scheduler.timer();
+    BOOST_CHECK_EQUAL(count, i + 1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(callback_test) {
+  using namespace std::chrono_literals;
+  Scheduler scheduler;
+  auto value = std::make_shared<int>(0);
+  std::array<char, 256> large{};
+  large[0] = 5;
+  scheduler.add([value] { *value += 1; }, std::chrono::system_clock::now());
+  scheduler.add([value, large] { *value += large[0]; },
+                Scheduler::clock::now());
+  BOOST_CHECK_EQUAL(value.use_count(), 3);
+  scheduler.timer();
+  BOOST_CHECK_EQUAL(*value, 6);
+  // callbacks are destroyed once they have run or are cancelled
+  BOOST_CHECK_EQUAL(value.use_count(), 1);
+  auto h = scheduler.add([value] { *value = 0; }, Scheduler::clock::now());
+  scheduler.cancel(h);
+  BOOST_CHECK_EQUAL(value.use_count(), 1);
+}
@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#define BOOST_TEST_MODULE test_ShmIndex
+#include <boost/test/unit_test.hpp>
+
+#include "shm_channel_client.hpp"
+#include "shm_device_client.hpp"
+#include "shm_device_provider.hpp"
+#include "shm_index.hpp"
+#include <chrono>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+BOOST_AUTO_TEST_CASE(consistency_test) {
+  shm_index index;
+  constexpr uint64_t updates = 100000;
+
+  std::thread writer([&index] {
+    for (uint64_t i = 1; i <= updates; ++i) {
+      index.publish({i, 3 * i}, static_cast<int64_t>(i));
+    }
+  });
+
+  // the reader must never see values from different updates
+  uint64_t last = 0;
+  bool consistent = true;
+  bool monotonic = true;
+  while (last < updates) {
+    int64_t updated = 0;
+    DualIndex value = index.load(&updated);
+    consistent &= value.data == 3 * value.desc &&
+                  updated == static_cast<int64_t>(value.desc);
+    monotonic &= value.desc >= last;
+    last = value.desc;
+  }
+  writer.join();
+
+  BOOST_CHECK(consistent);
+  BOOST_CHECK(monotonic);
+}
+
+BOOST_AUTO_TEST_CASE(wait_test) {
+  using namespace std::chrono_literals;
+  shm_index index;
+
+  // no update: timeout
+  uint32_t generation = index.generation();
+  auto begin = std::chrono::steady_clock::now();
+  BOOST_CHECK(!index.wait(generation, 10ms));
+  BOOST_CHECK(std::chrono::steady_clock::now() - begin >= 10ms);
+
+  // update while sleeping: wake up
+  std::thread writer([&index] {
+    std::this_thread::sleep_for(20ms);
+    index.publish({1, 2});
+  });
+  BOOST_CHECK(index.wait(generation, 10s));
+  BOOST_CHECK_EQUAL(index.load().desc, 1);
+  writer.join();
+
+  // update before sleeping: no wait
+  BOOST_CHECK(index.wait(generation, 10s));
+}
+
+BOOST_AUTO_TEST_CASE(channel_wait_test) {
+  using namespace std::chrono_literals;
+  const std::string identifier =
+      "test_ShmIndex_" + std::to_string(getpid());
+  flib_shm_device_provider provider(identifier, 1, 12, 8);
+  auto* sink = provider.channels().at(0);
+  auto device = std::make_shared<flib_shm_device_client>(identifier);
+  flib_shm_channel_client source(device, 0);
+
+  // The consumer is woken by the producer moving the write index, and vice
+  // versa, long before the timeouts expire
+  const auto begin = std::chrono::steady_clock::now();
+  std::thread producer([sink] {
+    std::this_thread::sleep_for(20ms);
+    sink->set_write_index({1, 64});
+    sink->wait_for_read_index({0, 0}, 10s);
+  });
+  source.wait_for_write_index({0, 0}, 10s);
+  BOOST_CHECK_EQUAL(source.get_write_index().desc, 1);
+  source.set_read_index({1, 64});
+  producer.join();
+  BOOST_CHECK(std::chrono::steady_clock::now() - begin < 5s);
+  BOOST_CHECK_EQUAL(sink->get_read_index().desc, 1);
+}
+
+BOOST_AUTO_TEST_CASE(channel_readers_test) {
+  const std::string identifier =
+      "test_ShmIndex_readers_" + std::to_string(getpid());
+  flib_shm_device_provider provider(identifier, 1, 12, 8);
+  auto* sink = provider.channels().at(0);
+  auto device = std::make_shared<flib_shm_device_client>(identifier);
+  flib_shm_channel_client first(device, 0);
+  flib_shm_channel_client second(device, 0);
+  flib_shm_channel_client monitor(device, 0, shm_reader_type::lossy);
+  BOOST_CHECK(!first.lossy());
+  BOOST_CHECK(monitor.lossy());
+
+  // The writer is held back by the slowest primary reader only
+  sink->set_write_index({4, 256});
+  first.set_read_index({3, 192});
+  second.set_read_index({1, 64});
+  BOOST_CHECK_EQUAL(sink->get_read_index().desc, 1);
+  second.set_read_index({4, 256});
+  BOOST_CHECK_EQUAL(sink->get_read_index().desc, 3);
+  BOOST_CHECK_EQUAL(monitor.get_read_index().desc, 0);
+  BOOST_CHECK_EQUAL(monitor.get_retained_index().desc, 3);
+
+  // A disconnecting reader no longer holds back the writer
+  {
+    flib_shm_channel_client late(device, 0);
+    BOOST_CHECK_EQUAL(late.get_read_index().desc, 3);
+  }
+  BOOST_CHECK_EQUAL(sink->get_read_index().desc, 3);
+}
@@ -0,0 +1,286 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#define BOOST_TEST_MODULE test_ShmItemChannel
+#include <boost/test/unit_test.hpp>
+
+#include "ShmItemDistributor.hpp"
+#include "ShmItemWorker.hpp"
+#include <future>
+#include <unistd.h>
+
+namespace {
+
+std::string channel_name(const std::string& test) {
+  return "test_ShmItemChannel_" + test + "_" + std::to_string(getpid());
+}
+
+// Retrieve the next item while the distributor keeps polling
+std::shared_ptr<const Item> get_item(ShmItemWorker& worker,
+                                     ShmItemDistributor& distributor) {
+  auto future = std::async(std::launch::async, [&] { return worker.get(); });
+  while (future.wait_for(std::chrono::milliseconds(1)) !=
+         std::future_status::ready) {
+    distributor.poll();
+  }
+  return future.get();
+}
+
+// Wait for the next completions from the distributor
+ItemCompletionBatch receive_completions(ShmItemDistributor& distributor) {
+  ItemCompletionBatch batch;
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (!distributor.try_receive_completions(&batch)) {
+    BOOST_REQUIRE(std::chrono::steady_clock::now() < deadline);
+  }
+  return batch;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(completion_batch_test) {
+  ItemCompletionCoalescer coalescer(3, std::chrono::hours(1));
+  for (ItemID id = 10; id < 15; ++id) {
+    coalescer.add_item(id);
+  }
+  coalescer.complete(13);
+  coalescer.complete(10);
+  BOOST_CHECK(!coalescer.is_due(std::chrono::steady_clock::now()));
+  coalescer.complete(11);
+  BOOST_CHECK(coalescer.is_due(std::chrono::steady_clock::now()));
+  BOOST_CHECK_THROW(coalescer.complete(11), std::invalid_argument);
+
+  ItemCompletionBatch batch;
+  coalescer.flush(batch);
+  BOOST_CHECK(coalescer.empty());
+  BOOST_CHECK_EQUAL(batch.completed_up_to, 12);
+  BOOST_CHECK(batch.completed == std::vector<ItemID>{13});
+
+  ItemCompletionBatch decoded;
+  const auto message = batch.serialize();
+  decoded.deserialize(message.data(), message.size());
+  BOOST_CHECK_EQUAL(decoded.completed_up_to, 12);
+  BOOST_CHECK(decoded.completed == batch.completed);
+  BOOST_CHECK_THROW(decoded.deserialize(message.data(), 3),
+                    std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(no_worker_test) {
+  ShmItemDistributor distributor(channel_name("no_worker"));
+  BOOST_CHECK(ShmItemWorker::available(distributor.channel_name()));
+  BOOST_CHECK_EQUAL(distributor.num_workers(), 0);
+
+  // Items without interested workers are completed immediately
+  distributor.send_work_item(42, "payload");
+  const auto batch = receive_completions(distributor);
+  BOOST_CHECK_EQUAL(batch.completed_up_to, 43);
+  BOOST_CHECK(batch.completed.empty());
+}
+
+BOOST_AUTO_TEST_CASE(stride_offset_test) {
+  ShmItemDistributor distributor(channel_name("stride_offset"));
+  ShmItemWorker even(distributor.channel_name(),
+                     {2, 0, WorkerQueuePolicy::QueueAll, 0, "even"});
+  ShmItemWorker odd(distributor.channel_name(),
+                    {2, 1, WorkerQueuePolicy::QueueAll, 0, "odd"});
+  distributor.poll();
+  BOOST_REQUIRE_EQUAL(distributor.num_workers(), 2);
+
+  for (ItemID id = 0; id < 4; ++id) {
+    distributor.send_work_item(id, "item " + std::to_string(id));
+  }
+
+  auto even_item = get_item(even, distributor);
+  BOOST_REQUIRE(even_item);
+  BOOST_CHECK_EQUAL(even_item->id(), 0);
+  BOOST_CHECK_EQUAL(even_item->payload(), "item 0");
+  auto odd_item = get_item(odd, distributor);
+  BOOST_REQUIRE(odd_item);
+  BOOST_CHECK_EQUAL(odd_item->id(), 1);
+  BOOST_CHECK_EQUAL(odd_item->payload(), "item 1");
+
+  // The queued items are sent once the previous ones are completed
+  odd_item = nullptr;
+  odd_item = get_item(odd, distributor);
+  BOOST_REQUIRE(odd_item);
+  BOOST_CHECK_EQUAL(odd_item->id(), 3);
+  // Item 1 is completed out of order
+  auto batch = receive_completions(distributor);
+  BOOST_CHECK_EQUAL(batch.completed_up_to, 0);
+  BOOST_CHECK(batch.completed == std::vector<ItemID>{1});
+  even_item = nullptr;
+  even_item = get_item(even, distributor);
+  BOOST_REQUIRE(even_item);
+  BOOST_CHECK_EQUAL(even_item->id(), 2);
+  batch = receive_completions(distributor);
+  BOOST_CHECK_EQUAL(batch.completed_up_to, 2);
+  BOOST_CHECK(batch.completed.empty());
+  even_item = nullptr;
+  odd_item = nullptr;
+}
+
+BOOST_AUTO_TEST_CASE(worker_removal_test) {
+  ShmItemDistributor distributor(channel_name("worker_removal"));
+  auto worker = std::make_unique<ShmItemWorker>(
+      distributor.channel_name(),
+      WorkerParameters{1, 0, WorkerQueuePolicy::Skip, 0, "worker"});
+  distributor.poll();
+  BOOST_REQUIRE_EQUAL(distributor.num_workers(), 1);
+
+  distributor.send_work_item(0, "");
+  auto item = get_item(*worker, distributor);
+  BOOST_REQUIRE(item);
+  BOOST_CHECK_EQUAL(item->id(), 0);
+  BOOST_CHECK(item->payload().empty());
+
+  // Item 1 is skipped as the worker is busy
+  distributor.send_work_item(1, "");
+  auto batch = receive_completions(distributor);
+  BOOST_CHECK_EQUAL(batch.completed_up_to, 0);
+  BOOST_CHECK(batch.completed == std::vector<ItemID>{1});
+
+  // Outstanding items are released when the worker disconnects
+  item = nullptr;
+  worker = nullptr;
+  batch = receive_completions(distributor);
+  BOOST_CHECK_EQUAL(batch.completed_up_to, 2);
+  BOOST_CHECK(batch.completed.empty());
+  BOOST_CHECK_EQUAL(distributor.num_workers(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(rate_limit_test) {
+  ShmItemDistributor distributor(channel_name("rate_limit"));
+  auto worker = std::make_unique<ShmItemWorker>(
+      distributor.channel_name(),
+      WorkerParameters{1, 0, WorkerQueuePolicy::QueueAll, 0, "monitor",
+                       std::chrono::hours(1)});
+  distributor.poll();
+  BOOST_REQUIRE_EQUAL(distributor.num_workers(), 1);
+
+  // Only the first item is admitted within the interval, the others are
+  // completed immediately although the worker queues all items
+  for (ItemID id = 0; id < 3; ++id) {
+    distributor.send_work_item(id, "");
+  }
+  auto item = get_item(*worker, distributor);
+  BOOST_REQUIRE(item);
+  BOOST_CHECK_EQUAL(item->id(), 0);
+  auto batch = receive_completions(distributor);
+  BOOST_CHECK_EQUAL(batch.completed_up_to, 0);
+  BOOST_CHECK((batch.completed == std::vector<ItemID>{1, 2}));
+  item = nullptr;
+  worker = nullptr;
+  batch = receive_completions(distributor);
+  BOOST_CHECK_EQUAL(batch.completed_up_to, 3);
+}
+
+BOOST_AUTO_TEST_CASE(completion_event_test) {
+  ShmItemDistributor distributor(channel_name("completion_event"));
+  ShmItemWorker worker(distributor.channel_name(),
+                       WorkerParameters{1, 0, WorkerQueuePolicy::QueueAll, 0,
+                                        "worker"});
+  distributor.poll();
+  BOOST_REQUIRE_EQUAL(distributor.num_workers(), 1);
+
+  distributor.send_work_item(0, "");
+  auto item = get_item(worker, distributor);
+  BOOST_REQUIRE(item);
+  ItemCompletionBatch batch;
+  BOOST_CHECK(!distributor.wait_for_completions(
+      &batch, std::chrono::milliseconds(10)));
+
+  // The completion is passed on the next call to get(), waking the
+  // distributor
+  item = nullptr;
+  auto future = std::async(std::launch::async, [&] { return worker.get(); });
+  BOOST_REQUIRE(
+      distributor.wait_for_completions(&batch, std::chrono::seconds(5)));
+  BOOST_CHECK_EQUAL(batch.completed_up_to, 1);
+  worker.stop();
+  BOOST_CHECK(future.get() == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(pool_test) {
+  ShmItemDistributor distributor(channel_name("pool"));
+  WorkerParameters parameters{1, 0, WorkerQueuePolicy::QueueAll, 0, "slow"};
+  parameters.pool_id = 1;
+  ShmItemWorker slow(distributor.channel_name(), parameters);
+  parameters.client_name = "fast";
+  ShmItemWorker fast(distributor.channel_name(), parameters);
+  distributor.poll();
+  BOOST_REQUIRE_EQUAL(distributor.num_workers(), 2);
+
+  // Each item is sent to one idle member, the others wait in the pool
+  for (ItemID id = 0; id < 4; ++id) {
+    distributor.send_work_item(id, "");
+  }
+  auto slow_item = get_item(slow, distributor);
+  BOOST_REQUIRE(slow_item);
+  BOOST_CHECK_EQUAL(slow_item->id(), 0);
+  auto fast_item = get_item(fast, distributor);
+  BOOST_REQUIRE(fast_item);
+  BOOST_CHECK_EQUAL(fast_item->id(), 1);
+
+  // The fast member takes over the waiting items
+  for (ItemID id = 2; id < 4; ++id) {
+    fast_item = nullptr;
+    fast_item = get_item(fast, distributor);
+    BOOST_REQUIRE(fast_item);
+    BOOST_CHECK_EQUAL(fast_item->id(), id);
+  }
+  auto batch = receive_completions(distributor);
+  BOOST_CHECK_EQUAL(batch.completed_up_to, 0);
+  BOOST_CHECK((batch.completed == std::vector<ItemID>{1, 2}));
+
+  // A member with a larger capacity receives several items at once
+  parameters.client_name = "wide";
+  parameters.capacity = 2;
+  ShmItemWorker wide(distributor.channel_name(), parameters);
+  distributor.poll();
+  BOOST_REQUIRE_EQUAL(distributor.num_workers(), 3);
+  for (ItemID id = 4; id < 6; ++id) {
+    distributor.send_work_item(id, "");
+  }
+  auto first = get_item(wide, distributor);
+  auto second = get_item(wide, distributor);
+  BOOST_REQUIRE(first && second);
+  BOOST_CHECK_EQUAL(first->id(), 4);
+  BOOST_CHECK_EQUAL(second->id(), 5);
+
+  slow_item = nullptr;
+  fast_item = nullptr;
+  first = nullptr;
+  second = nullptr;
+}
+
+BOOST_AUTO_TEST_CASE(deadline_test) {
+  ShmItemDistributor distributor(channel_name("deadline"), 2);
+  ShmItemWorker worker(distributor.channel_name(),
+                       {1, 0, WorkerQueuePolicy::NewestFirst, 0, "monitor"});
+  distributor.poll();
+  BOOST_REQUIRE_EQUAL(distributor.num_workers(), 1);
+
+  distributor.send_work_item(0, "");
+  auto item = get_item(worker, distributor);
+  BOOST_REQUIRE(item);
+  BOOST_CHECK_EQUAL(item->id(), 0);
+
+  // Item 1 is late at the arrival of item 3 and dropped from the queue
+  for (ItemID id = 1; id < 4; ++id) {
+    distributor.send_work_item(id, "");
+  }
+  auto batch = receive_completions(distributor);
+  BOOST_CHECK_EQUAL(batch.completed_up_to, 0);
+  BOOST_CHECK(batch.completed == std::vector<ItemID>{1});
+
+  // The newest queued item is sent first
+  item = nullptr;
+  item = get_item(worker, distributor);
+  BOOST_REQUIRE(item);
+  BOOST_CHECK_EQUAL(item->id(), 3);
+  item = nullptr;
+  item = get_item(worker, distributor);
+  BOOST_REQUIRE(item);
+  BOOST_CHECK_EQUAL(item->id(), 2);
+  item = nullptr;
+}
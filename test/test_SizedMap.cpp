@@ -0,0 +1,185 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#define BOOST_TEST_MODULE test_SizedMap
+#include <boost/test/unit_test.hpp>
+
+#include "SizedMap.hpp"
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <random>
+#include <vector>
+
+using tl_libfabric::SizedMap;
+
+namespace {
+
+// Reference model: a std::map evicting its smallest key when full
+class ReferenceMap {
+public:
+  explicit ReferenceMap(uint32_t max_size) : max_size_(max_size) {}
+
+  bool add(uint64_t key, uint64_t value) {
+    if (map_.count(key) != 0) {
+      return false;
+    }
+    if (map_.size() == max_size_) {
+      map_.erase(map_.begin());
+    }
+    map_.emplace(key, value);
+    return true;
+  }
+
+  bool update(uint64_t key, uint64_t value) {
+    auto it = map_.find(key);
+    if (it == map_.end()) {
+      return false;
+    }
+    it->second = value;
+    return true;
+  }
+
+  bool remove(uint64_t key) { return map_.erase(key) != 0; }
+
+  const std::map<uint64_t, uint64_t>& map() const { return map_; }
+
+private:
+  uint32_t max_size_;
+  std::map<uint64_t, uint64_t> map_;
+};
+
+// Compare all observable state, iterating forward and backward
+void check_equal(SizedMap<uint64_t, uint64_t>& map, const ReferenceMap& ref) {
+  const auto& expected = ref.map();
+  BOOST_REQUIRE_EQUAL(map.size(), expected.size());
+  BOOST_REQUIRE_EQUAL(map.empty(), expected.empty());
+  if (expected.empty()) {
+    BOOST_REQUIRE(map.get_begin_iterator() == map.get_end_iterator());
+    return;
+  }
+  BOOST_REQUIRE_EQUAL(map.get_last_key(), expected.rbegin()->first);
+
+  auto it = map.get_begin_iterator();
+  for (const auto& [key, value] : expected) {
+    BOOST_REQUIRE(it != map.get_end_iterator());
+    BOOST_REQUIRE_EQUAL(it->first, key);
+    BOOST_REQUIRE_EQUAL(it->second, value);
+    BOOST_REQUIRE(map.contains(key));
+    BOOST_REQUIRE_EQUAL(map.get(key), value);
+    BOOST_REQUIRE(map.get_iterator(key) == it);
+    ++it;
+  }
+  BOOST_REQUIRE(it == map.get_end_iterator());
+
+  for (auto rit = expected.rbegin(); rit != expected.rend(); ++rit) {
+    --it;
+    BOOST_REQUIRE_EQUAL(it->first, rit->first);
+    BOOST_REQUIRE_EQUAL(it->second, rit->second);
+  }
+  BOOST_REQUIRE(it == map.get_begin_iterator());
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(in_order_eviction_test) {
+  constexpr uint32_t max_size = 10;
+  SizedMap<uint64_t, uint64_t> map(max_size);
+  ReferenceMap ref(max_size);
+
+  for (uint64_t key = 0; key < 100; ++key) {
+    BOOST_CHECK(map.add(key, key * 2));
+    ref.add(key, key * 2);
+    check_equal(map, ref);
+  }
+  BOOST_CHECK_EQUAL(map.size(), max_size);
+  BOOST_CHECK(!map.contains(89));
+  BOOST_CHECK(map.contains(90));
+  BOOST_CHECK(!map.add(95, 0));
+}
+
+BOOST_AUTO_TEST_CASE(out_of_order_test) {
+  SizedMap<uint64_t, uint64_t> map(100);
+  ReferenceMap ref(100);
+
+  for (uint64_t key : {10, 5, 20, 15, 1, 30, 25, 2}) {
+    BOOST_CHECK(map.add(key, key));
+    ref.add(key, key);
+    check_equal(map, ref);
+  }
+  BOOST_CHECK(!map.add(15, 0));
+  BOOST_CHECK(!map.contains(3));
+  BOOST_CHECK(!map.contains(100));
+}
+
+BOOST_AUTO_TEST_CASE(tombstone_reuse_test) {
+  SizedMap<uint64_t, uint64_t> map(100);
+  ReferenceMap ref(100);
+
+  for (uint64_t key = 0; key < 20; ++key) {
+    map.add(key, key);
+    ref.add(key, key);
+  }
+  // leave tombstones in the middle and at the back, then fill them again
+  for (uint64_t key : {5, 6, 12, 19}) {
+    BOOST_CHECK(map.remove(key));
+    ref.remove(key);
+    check_equal(map, ref);
+  }
+  BOOST_CHECK(!map.remove(5));
+  BOOST_CHECK(!map.update(6, 0));
+  for (uint64_t key : {6, 19, 5, 12}) {
+    BOOST_CHECK(map.add(key, key + 100));
+    ref.add(key, key + 100);
+    check_equal(map, ref);
+  }
+
+  // removal through an iterator
+  BOOST_CHECK(map.remove(map.get_iterator(10)));
+  ref.remove(10);
+  BOOST_CHECK(!map.remove(map.get_end_iterator()));
+  check_equal(map, ref);
+
+  // removing everything resets the map
+  for (uint64_t key = 0; key < 20; ++key) {
+    map.remove(key);
+    ref.remove(key);
+  }
+  check_equal(map, ref);
+  BOOST_CHECK(map.add(3, 3));
+  ref.add(3, 3);
+  check_equal(map, ref);
+}
+
+BOOST_AUTO_TEST_CASE(randomized_test) {
+  std::mt19937_64 rng(42);
+  for (uint32_t max_size : {1, 7, 64, 500}) {
+    SizedMap<uint64_t, uint64_t> map(max_size);
+    ReferenceMap ref(max_size);
+    uint64_t next_key = 0;
+
+    for (int step = 0; step < 20000; ++step) {
+      const auto op = rng() % 10;
+      uint64_t key = 0;
+      if (op < 4) {
+        // mostly ascending keys, as in the transport
+        key = next_key++;
+      } else if (next_key != 0) {
+        // keys in the window behind the newest one, including removed and
+        // evicted ones
+        key = next_key - 1 - rng() % std::min<uint64_t>(next_key, 2 * max_size);
+      }
+      const uint64_t value = rng();
+      if (op < 6) {
+        BOOST_REQUIRE_EQUAL(map.add(key, value), ref.add(key, value));
+      } else if (op < 7) {
+        BOOST_REQUIRE_EQUAL(map.update(key, value), ref.update(key, value));
+      } else {
+        BOOST_REQUIRE_EQUAL(map.remove(key), ref.remove(key));
+      }
+      if (step % 97 == 0) {
+        check_equal(map, ref);
+      }
+    }
+    check_equal(map, ref);
+  }
+}
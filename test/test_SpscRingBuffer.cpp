@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#define BOOST_TEST_MODULE test_SpscRingBuffer
+#include <boost/test/unit_test.hpp>
+
+#include "SpscRingBuffer.hpp"
+#include <thread>
+
+BOOST_AUTO_TEST_CASE(batch_test) {
+  SpscRingBuffer<uint64_t> ring(3);
+  BOOST_CHECK_EQUAL(ring.size(), 8);
+  BOOST_CHECK_EQUAL(ring.available(), 0);
+
+  BOOST_REQUIRE_EQUAL(ring.reserve(5), 5);
+  for (std::size_t i = 0; i < 5; ++i) {
+    ring.slot(i) = i;
+  }
+  BOOST_CHECK_EQUAL(ring.available(), 0);
+  ring.commit(5);
+  BOOST_CHECK_EQUAL(ring.reserve(), 3);
+  BOOST_CHECK_EQUAL(ring.reserve(10), 3);
+
+  BOOST_REQUIRE_EQUAL(ring.available(2), 2);
+  BOOST_CHECK_EQUAL(ring.at(1), 1);
+  ring.consume(2);
+
+  // Wrap around the end of the buffer
+  for (uint64_t i = 5; i < 10; ++i) {
+    BOOST_CHECK(ring.push(i));
+  }
+  BOOST_CHECK(!ring.push(10));
+  uint64_t item = 0;
+  for (uint64_t i = 2; i < 10; ++i) {
+    BOOST_REQUIRE(ring.pop(item));
+    BOOST_CHECK_EQUAL(item, i);
+  }
+  BOOST_CHECK(!ring.pop(item));
+  BOOST_CHECK_EQUAL(ring.write_position(), 10);
+  BOOST_CHECK_EQUAL(ring.read_position(), 10);
+}
+
+BOOST_AUTO_TEST_CASE(threaded_test) {
+  constexpr uint64_t count = 1000000;
+  SpscRingBuffer<uint64_t> ring(6);
+
+  std::thread producer([&ring] {
+    uint64_t next = 0;
+    while (next < count) {
+      std::size_t n = ring.reserve(7);
+      for (std::size_t i = 0; i < n && next + i < count; ++i) {
+        ring.slot(i) = next + i;
+      }
+      n = std::min<uint64_t>(n, count - next);
+      ring.commit(n);
+      next += n;
+    }
+  });
+
+  uint64_t expected = 0;
+  bool in_order = true;
+  while (expected < count) {
+    std::size_t n = ring.available(5);
+    for (std::size_t i = 0; i < n; ++i) {
+      in_order = in_order && ring.at(i) == expected + i;
+    }
+    ring.consume(n);
+    expected += n;
+  }
+  producer.join();
+  BOOST_CHECK(in_order);
+  BOOST_CHECK_EQUAL(ring.read_position(), count);
+}
@@ -3,15 +3,26 @@
 #include <boost/test/unit_test.hpp>
 
 #include "MicrosliceView.hpp"
+#include "PagePrefetcher.hpp"
 #include "StorableTimeslice.hpp"
 #include "System.hpp"
 #include "TimesliceInputArchive.hpp"
 #include "TimesliceOutputArchive.hpp"
+#include "TimesliceSerializer.hpp"
+#include "TimesliceShmSegment.hpp"
+#include "TimesliceShmWorkItem.hpp"
+#include "TimesliceTap.hpp"
+#include "TimesliceTimeIndex.hpp"
 #include <array>
+#include <boost/interprocess/shared_memory_object.hpp>
 #include <boost/archive/binary_iarchive.hpp>
 #include <boost/archive/binary_oarchive.hpp>
+#include <chrono>
+#include <cstring>
 #include <fstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 struct F {
   F() {
@@ -78,6 +89,20 @@ BOOST_FIXTURE_TEST_CASE(content_access_test, F) {
   BOOST_CHECK_EQUAL(*ts0.content(1, 0), 3);
 }
 
+BOOST_FIXTURE_TEST_CASE(for_each_microslice_test, F) {
+  std::vector<uint64_t> indexes;
+  std::vector<uint8_t> first_bytes;
+  ts0.for_each_microslice(0, [&](uint64_t m, const fles::MicrosliceRef& ms) {
+    indexes.push_back(m);
+    first_bytes.push_back(*ms.content);
+    BOOST_CHECK_EQUAL(ms.desc.idx, ts0.descriptor(0, m).idx);
+  });
+  BOOST_CHECK_EQUAL(indexes.size(), 2);
+  BOOST_CHECK_EQUAL(indexes[1], 1);
+  BOOST_CHECK_EQUAL(first_bytes[0], 7);
+  BOOST_CHECK_EQUAL(first_bytes[1], 11);
+}
+
 BOOST_FIXTURE_TEST_CASE(start_time_test, F) {
   BOOST_CHECK_EQUAL(ts0.start_time(), 1);
 }
@@ -103,6 +128,117 @@ BOOST_FIXTURE_TEST_CASE(serialization_test, F) {
   BOOST_CHECK_EQUAL(*ts1.content(1, 0), 3);
 }
 
+BOOST_FIXTURE_TEST_CASE(serializer_test, F) {
+  // the serializer has to produce the same bytes as the StorableTimeslice
+  std::stringstream expected;
+  {
+    boost::archive::binary_oarchive oa(expected);
+    oa << ts0;
+    oa << ts0;
+  }
+  std::stringstream actual;
+  {
+    boost::archive::binary_oarchive oa(actual);
+    const fles::TimesliceSerializer serializer(ts0);
+    oa << serializer;
+    oa << serializer;
+  }
+  BOOST_CHECK(actual.str() == expected.str());
+
+  boost::archive::binary_iarchive ia(actual);
+  fles::StorableTimeslice ts1{0};
+  ia >> ts1;
+  ia >> ts1;
+  BOOST_CHECK_EQUAL(ts1.num_components(), 2);
+  BOOST_CHECK_EQUAL(*ts1.content(0, 1), 11);
+  BOOST_CHECK_EQUAL(*ts1.content(1, 0), 3);
+}
+
+BOOST_FIXTURE_TEST_CASE(descriptors_only_test, F) {
+  BOOST_CHECK(!ts0.content_omitted(0));
+  const fles::StorableTimeslice skeleton(ts0, true);
+  BOOST_REQUIRE_EQUAL(skeleton.num_components(), 2);
+  for (uint64_t c = 0; c < skeleton.num_components(); ++c) {
+    BOOST_CHECK(skeleton.content_omitted(c));
+    BOOST_REQUIRE_EQUAL(skeleton.num_microslices(c), ts0.num_microslices(c));
+    BOOST_CHECK_EQUAL(skeleton.size_component(c),
+                      ts0.num_microslices(c) *
+                          sizeof(fles::MicrosliceDescriptor));
+    for (uint64_t m = 0; m < skeleton.num_microslices(c); ++m) {
+      BOOST_CHECK_EQUAL(skeleton.descriptor(c, m).idx,
+                        ts0.descriptor(c, m).idx);
+      BOOST_CHECK_EQUAL(skeleton.descriptor(c, m).size,
+                        ts0.descriptor(c, m).size);
+    }
+  }
+
+  // descriptor-only serialization equals that of the copy
+  std::stringstream expected;
+  {
+    boost::archive::binary_oarchive oa(expected);
+    oa << skeleton;
+  }
+  std::stringstream actual;
+  {
+    boost::archive::binary_oarchive oa(actual);
+    const fles::TimesliceSerializer serializer(ts0, true);
+    oa << serializer;
+  }
+  BOOST_CHECK(actual.str() == expected.str());
+}
+
+BOOST_AUTO_TEST_CASE(time_index_test) {
+  // components with microslices of 100 and 250 ns (out of order in the
+  // latter), and a single microslice
+  const std::vector<std::vector<uint64_t>> start_times{
+      {1000, 1100, 1200, 1300}, {1250, 1000, 1500}, {1150}};
+  fles::StorableTimeslice ts(1);
+  for (const auto& times : start_times) {
+    const uint32_t c = ts.append_component(times.size());
+    for (uint64_t m = 0; m < times.size(); ++m) {
+      fles::MicrosliceDescriptor desc = fles::MicrosliceDescriptor();
+      desc.idx = times[m];
+      ts.append_microslice(c, m, desc, nullptr);
+    }
+  }
+
+  const auto index = ts.time_index();
+  BOOST_CHECK(ts.time_index() == index);
+  BOOST_REQUIRE_EQUAL(index->num_components(), 3);
+  BOOST_CHECK_EQUAL(index->end_time(0, 3), 1400);
+  BOOST_CHECK_EQUAL(index->end_time(2, 0), 1150);
+
+  auto range = index->find(0, 1150, 1300);
+  BOOST_CHECK_EQUAL(range.begin, 1);
+  BOOST_CHECK_EQUAL(range.end, 3);
+  BOOST_CHECK(index->find(0, 1400, 1500).empty());
+  BOOST_CHECK_EQUAL(index->find(0, 1399, 1500).size(), 1);
+  BOOST_CHECK(index->find(0, 1200, 1200).empty());
+
+  range = index->find(1, 1300, 1550);
+  BOOST_REQUIRE_EQUAL(range.size(), 2);
+  BOOST_CHECK_EQUAL(index->microslice(1, range.begin), 0);
+  BOOST_CHECK_EQUAL(index->microslice(1, range.begin + 1), 2);
+  BOOST_CHECK_EQUAL(index->find(2, 1100, 1200).size(), 1);
+  BOOST_CHECK(index->find(2, 1151, 1200).empty());
+
+  // merge in start time order, ties ordered by component
+  std::vector<std::pair<uint64_t, uint64_t>> merged;
+  for (const auto& ms : fles::TimeWindowMerge(*index, 1050, 1250)) {
+    BOOST_CHECK_EQUAL(ms.time, ts.descriptor(ms.component, ms.microslice).idx);
+    merged.emplace_back(ms.time, ms.component);
+  }
+  const std::vector<std::pair<uint64_t, uint64_t>> expected{
+      {1000, 0}, {1000, 1}, {1100, 0}, {1150, 2}, {1200, 0}};
+  BOOST_CHECK(merged == expected);
+
+  // the index is rebuilt after a change of the components
+  fles::ComponentFilter filter;
+  BOOST_REQUIRE(fles::parse_filter_parameter("eq_id", "0", filter));
+  ts.select_components(filter);
+  BOOST_CHECK(ts.time_index() != index);
+}
+
 BOOST_FIXTURE_TEST_CASE(archive_test, F) {
   auto ts0_ptr = std::make_shared<const fles::StorableTimeslice>(ts0);
 
@@ -131,6 +267,24 @@ BOOST_AUTO_TEST_CASE(archive_exception_test) {
                     std::ios_base::failure);
 }
 
+BOOST_FIXTURE_TEST_CASE(component_view_test, F) {
+  const auto component = ts0.component(0);
+  BOOST_REQUIRE_EQUAL(component.size(), 2);
+  BOOST_CHECK_EQUAL(component.content_size(), data_a.size() + data_b.size());
+  BOOST_CHECK_EQUAL(component.content(1), ts0.content(0, 1));
+  BOOST_CHECK_EQUAL(&component.descriptor(1), &ts0.descriptor(0, 1));
+
+  std::vector<uint64_t> idx;
+  for (const auto& ms : component) {
+    idx.push_back(ms.desc.idx);
+    BOOST_CHECK_EQUAL(*ms.content, ms.desc.idx == 1 ? 7 : 11);
+  }
+  BOOST_CHECK((idx == std::vector<uint64_t>{1, 2}));
+  BOOST_CHECK_EQUAL(component.end() - component.begin(), 2);
+  BOOST_CHECK_EQUAL(component.begin()[1].content, ts0.content(0, 1));
+  BOOST_CHECK_EQUAL(*ts0.component(1)[0].content, 3);
+}
+
 BOOST_FIXTURE_TEST_CASE(microslice_access_test, F) {
   fles::MicrosliceView m = ts0.get_microslice(1, 0);
   const uint8_t* content = m.content();
@@ -179,3 +333,242 @@ BOOST_AUTO_TEST_CASE(invalid_archive_test) {
   BOOST_CHECK_THROW(fles::TimesliceInputArchive source(filename2),
                     std::runtime_error);
 }
+
+BOOST_AUTO_TEST_CASE(binary_work_item_test) {
+  boost::uuids::uuid uuid{};
+  for (std::size_t i = 0; i < uuid.size(); ++i) {
+    uuid.data[i] = static_cast<uint8_t>(i);
+  }
+  fles::TimesliceDescriptor ts_desc{17, 5, 100, 2};
+  const std::array<std::ptrdiff_t, 2> data{1024, 4096};
+  const std::array<std::ptrdiff_t, 2> desc{64, 128};
+
+  std::string buffer;
+  fles::encode_binary_work_item(buffer, uuid, "flesnet_0", ts_desc,
+                                data.data(), desc.data());
+  BOOST_REQUIRE(fles::TimesliceShmWorkItemView::is_binary(buffer));
+
+  const fles::TimesliceShmWorkItemView item(buffer);
+  BOOST_CHECK(item.shm_uuid() == uuid);
+  BOOST_CHECK_EQUAL(item.shm_identifier(), "flesnet_0");
+  BOOST_CHECK_EQUAL(item.ts_desc().index, 17);
+  BOOST_CHECK_EQUAL(item.ts_desc().ts_pos, 5);
+  BOOST_CHECK_EQUAL(item.ts_desc().num_components, 2);
+  BOOST_CHECK_EQUAL(item.data(1), 4096);
+  BOOST_CHECK_EQUAL(item.desc(0), 64);
+
+  // A legacy boost archive is recognized as such
+  fles::TimesliceShmWorkItem legacy_item;
+  legacy_item.shm_uuid = uuid;
+  legacy_item.ts_desc = ts_desc;
+  std::ostringstream ostream;
+  {
+    boost::archive::binary_oarchive oarchive(ostream);
+    oarchive << legacy_item;
+  }
+  BOOST_CHECK(!fles::TimesliceShmWorkItemView::is_binary(ostream.str()));
+
+  buffer.pop_back();
+  BOOST_CHECK_THROW(fles::TimesliceShmWorkItemView{buffer},
+                    std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(flat_shm_segment_test) {
+  boost::uuids::uuid uuid{};
+  for (std::size_t i = 0; i < uuid.size(); ++i) {
+    uuid.data[i] = static_cast<uint8_t>(i + 1);
+  }
+  const std::string identifier = "test_Timeslice_flat";
+  {
+    const fles::TimesliceShmSegment producer(
+        boost::interprocess::create_only, identifier, uuid, 2, 12, 4);
+    const auto& layout = producer.layout();
+    BOOST_CHECK_EQUAL(layout.header().num_components, 2);
+    BOOST_CHECK_EQUAL(layout.header().data_offset % 4096, 0);
+    BOOST_CHECK_EQUAL(layout.data_ring(1) - layout.data_ring(0), 4096);
+    BOOST_CHECK_EQUAL(layout.desc(1, 17) - layout.desc_ring(1), 1);
+
+    *layout.ts_desc(17) = fles::TimesliceDescriptor{42, 17, 1, 2};
+    for (uint32_t c = 0; c < 2; ++c) {
+      auto* desc = layout.desc(c, 17);
+      *desc = fles::TimesliceComponentDescriptor{42, 4096 * 3 + 8, 4, 0};
+      std::memcpy(layout.data(c, *desc), "data", 4);
+    }
+
+    const fles::TimesliceShmSegment consumer(
+        boost::interprocess::open_read_only, identifier);
+    const auto& view = consumer.layout();
+    BOOST_CHECK(view.has_uuid(uuid.data));
+    BOOST_CHECK_EQUAL(view.ts_desc(17)->index, 42);
+    BOOST_CHECK_EQUAL(view.data(1, *view.desc(1, 17)) - view.data_ring(1), 8);
+    BOOST_CHECK_EQUAL(
+        std::string(reinterpret_cast<const char*>(
+                        view.data(1, *view.desc(1, 17))),
+                    4),
+        "data");
+    BOOST_REQUIRE(view.has_status());
+    BOOST_CHECK(!view.component_complete(1, 17));
+    layout.set_component_complete(1, 17);
+    BOOST_CHECK(view.component_complete(1, 17));
+    BOOST_CHECK(!view.component_complete(0, 17));
+    // the same ring entry in the next round
+    BOOST_CHECK(!view.component_complete(1, 33));
+  }
+  boost::interprocess::shared_memory_object::remove(identifier.c_str());
+
+  std::string buffer;
+  fles::encode_flat_work_item(buffer, uuid.data, identifier, 17);
+  BOOST_REQUIRE(fles::TimesliceShmFlatItemView::is_flat(buffer));
+  BOOST_CHECK(!fles::TimesliceShmWorkItemView::is_binary(buffer));
+  const fles::TimesliceShmFlatItemView item(buffer);
+  BOOST_CHECK_EQUAL(item.shm_identifier(), identifier);
+  BOOST_CHECK_EQUAL(item.ts_pos(), 17);
+  BOOST_CHECK(std::memcmp(item.shm_uuid(), uuid.data, 16) == 0);
+
+  buffer.pop_back();
+  BOOST_CHECK_THROW(fles::TimesliceShmFlatItemView{buffer},
+                    std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(flat_shm_segment_sizes_test) {
+  boost::uuids::uuid uuid{};
+  const std::string identifier = "test_Timeslice_flat_sizes";
+  {
+    const fles::TimesliceShmSegment producer(boost::interprocess::create_only,
+                                             identifier, uuid,
+                                             std::vector<uint32_t>{14, 12, 16},
+                                             4);
+    const auto& layout = producer.layout();
+    BOOST_CHECK_EQUAL(layout.header().version, 4);
+    BOOST_CHECK_EQUAL(layout.header().data_size_exp, 16);
+    BOOST_CHECK_EQUAL(layout.data_ring_size_exp(0), 14);
+    BOOST_CHECK_EQUAL(layout.data_ring_size_exp(1), 12);
+    BOOST_CHECK_EQUAL(layout.data_ring(1) - layout.data_ring(0), 1 << 14);
+    BOOST_CHECK_EQUAL(layout.data_ring(2) - layout.data_ring(1), 1 << 12);
+    BOOST_CHECK_EQUAL(layout.header().segment_size,
+                      static_cast<uint64_t>(layout.data_ring(2) -
+                                            layout.data_ring(0)) +
+                          layout.header().data_offset + (1 << 16));
+
+    // the offsets wrap according to the ring size of each component
+    const fles::TimesliceComponentDescriptor desc{42, 4096 * 3 + 8, 4, 0};
+    BOOST_CHECK_EQUAL(layout.data(0, desc) - layout.data_ring(0), 4096 * 3 + 8);
+    BOOST_CHECK_EQUAL(layout.data(1, desc) - layout.data_ring(1), 8);
+
+    const fles::TimesliceShmSegment consumer(
+        boost::interprocess::open_read_only, identifier);
+    BOOST_CHECK_EQUAL(consumer.layout().data_ring_size_exp(2), 16);
+    BOOST_CHECK_EQUAL(consumer.layout().data(1, desc) -
+                          consumer.layout().data_ring(1),
+                      8);
+  }
+  boost::interprocess::shared_memory_object::remove(identifier.c_str());
+
+  // a segment of version 2 has data rings of equal size
+  std::vector<fles::TimesliceShmDataRing> data_table;
+  fles::TimesliceShmHeader header = fles::TimesliceShmLayout::make_header(
+      uuid.data, {12, 12}, 4, 4096, data_table);
+  header.version = 2;
+  header.header_size = fles::TimesliceShmHeader::version_2_size;
+  header.data_table_offset = 0;
+  std::vector<uint8_t> segment(header.segment_size);
+  std::memcpy(segment.data(), &header, sizeof header);
+  const fles::TimesliceShmLayout layout(segment.data(), segment.size());
+  BOOST_CHECK_EQUAL(layout.data_ring_size_exp(1), 12);
+  BOOST_CHECK_EQUAL(layout.data_ring(1) - layout.data_ring(0), 4096);
+  BOOST_CHECK(!layout.has_summaries());
+  BOOST_CHECK(layout.summary(0, 0) == nullptr);
+}
+
+BOOST_FIXTURE_TEST_CASE(component_summary_test, F) {
+  // computed from the microslice descriptors
+  const fles::ComponentSummary summary = ts0.component_summary(0);
+  BOOST_CHECK(summary.valid_for(1, 2));
+  BOOST_CHECK_EQUAL(summary.content_size, data_a.size() + data_b.size());
+  BOOST_CHECK_EQUAL(summary.first_idx, 1);
+  BOOST_CHECK_EQUAL(summary.last_idx, 2);
+  BOOST_CHECK_EQUAL(summary.error_count, 0);
+  BOOST_CHECK_EQUAL(summary.crc_valid_ratio(), 0.0);
+  BOOST_CHECK_EQUAL(ts0.component_summary(1).content_size, data_c.size());
+
+  desc_c.flags = static_cast<uint16_t>(fles::MicrosliceFlags::CrcValid) |
+                 static_cast<uint16_t>(fles::MicrosliceFlags::OverflowFlim);
+  const auto flagged = fles::ComponentSummary::compute(7, &desc_c, 1);
+  BOOST_CHECK(!flagged.valid_for(1, 1));
+  BOOST_CHECK_EQUAL(flagged.overflow_count, 1);
+  BOOST_CHECK_EQUAL(flagged.crc_valid_ratio(), 1.0);
+
+  // transmitted in the summary rings of a flat segment
+  boost::uuids::uuid uuid{};
+  const std::string identifier = "test_Timeslice_summary";
+  {
+    const fles::TimesliceShmSegment segment(boost::interprocess::create_only,
+                                            identifier, uuid, 2, 12, 4);
+    const auto& layout = segment.layout();
+    BOOST_REQUIRE(layout.has_summaries());
+    BOOST_CHECK_EQUAL(layout.summary(1, 17) - layout.summary_ring(1), 1);
+    BOOST_CHECK(layout.summary_ring(0) + 16 <= layout.summary_ring(1));
+    BOOST_CHECK(reinterpret_cast<uint8_t*>(layout.summary_ring(1) + 16) <=
+                layout.data_ring(0));
+    *layout.summary(1, 17) = flagged;
+    BOOST_CHECK_EQUAL(layout.summary(1, 1)->overflow_count, 1);
+  }
+  boost::interprocess::shared_memory_object::remove(identifier.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(page_prefetcher_test) {
+  std::vector<uint8_t> data(100000, 1);
+  fles::PagePrefetcher::prefetch({data.data() + 3, data.size() - 3});
+  fles::PagePrefetcher::prefetch({data.data(), 0});
+
+  // the owner is released once the request is done
+  auto owner = std::make_shared<int>(0);
+  {
+    fles::PagePrefetcher prefetcher(1);
+    BOOST_CHECK(prefetcher.submit({{data.data(), data.size()}}, owner));
+    for (int i = 0; i < 1000 && owner.use_count() > 1; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    BOOST_CHECK_EQUAL(owner.use_count(), 1);
+  }
+  BOOST_CHECK_EQUAL(owner.use_count(), 1);
+}
+
+namespace {
+
+struct TimesliceCollector : public fles::TimesliceSink {
+  void put(std::shared_ptr<const fles::Timeslice> timeslice) override {
+    timeslices.push_back(std::move(timeslice));
+  }
+  std::vector<std::shared_ptr<const fles::Timeslice>> timeslices;
+};
+
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(tap_test, F) {
+  auto* collector = new TimesliceCollector;
+  fles::TapParameters parameters;
+  BOOST_CHECK(parameters.all());
+  BOOST_CHECK(parameters.parse("stride", "2"));
+  BOOST_CHECK(parameters.parse("offset", "1"));
+  BOOST_CHECK(parameters.parse("eq_id", "11"));
+  BOOST_CHECK(!parameters.parse("hwm", "1"));
+  fles::TimesliceTap tap(std::unique_ptr<fles::TimesliceSink>(collector),
+                         parameters);
+
+  auto original = std::make_shared<const fles::StorableTimeslice>(ts0);
+  tap.put(original);
+  tap.put(std::make_shared<const fles::StorableTimeslice>(1, 2));
+  BOOST_CHECK_EQUAL(tap.passed(), 1);
+  BOOST_CHECK_EQUAL(tap.discarded(), 1);
+  BOOST_REQUIRE_EQUAL(collector->timeslices.size(), 1);
+
+  // The selection refers to the component data of the original timeslice
+  const auto& selection = *collector->timeslices.front();
+  BOOST_CHECK_EQUAL(selection.index(), 1);
+  BOOST_REQUIRE_EQUAL(selection.num_components(), 1);
+  BOOST_CHECK_EQUAL(selection.descriptor(0, 0).eq_id, 11);
+  BOOST_CHECK_EQUAL(selection.content(0, 0), original->content(1, 0));
+  original = nullptr;
+  BOOST_CHECK_EQUAL(*selection.content(0, 0), 3);
+}
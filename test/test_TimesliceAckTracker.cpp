@@ -0,0 +1,269 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#define BOOST_TEST_MODULE test_TimesliceAckTracker
+#include <boost/test/unit_test.hpp>
+
+#include "AckCoalescer.hpp"
+#include "BackpressureTracker.hpp"
+#include "TimesliceAckTracker.hpp"
+#include "TimesliceBoundaries.hpp"
+#include <thread>
+#include <vector>
+
+namespace {
+// Minimal data source with microslices of 10 bytes each
+struct FakeDataSource {
+  struct DescBuffer {
+    std::vector<fles::MicrosliceDescriptor> descs;
+    [[nodiscard]] std::size_t size() const { return descs.size(); }
+    fles::MicrosliceDescriptor& at(std::size_t n) {
+      return descs[n % descs.size()];
+    }
+  };
+  struct DataBuffer {
+    std::size_t bytes;
+    [[nodiscard]] std::size_t size() const { return bytes; }
+  };
+
+  explicit FakeDataSource(std::size_t microslices)
+      : desc_buffer_{std::vector<fles::MicrosliceDescriptor>(microslices)},
+        data_buffer_{microslices * 10} {
+    for (std::size_t i = 0; i < microslices; ++i) {
+      desc_buffer_.descs[i].offset = i * 10;
+      desc_buffer_.descs[i].size = 10;
+    }
+  }
+
+  DescBuffer& desc_buffer() { return desc_buffer_; }
+  DataBuffer& data_buffer() { return data_buffer_; }
+  DualIndex get_read_index() { return read_index_; }
+  void set_read_index(DualIndex new_read_index) {
+    read_index_ = new_read_index;
+    ++writes_;
+  }
+
+  DescBuffer desc_buffer_;
+  DataBuffer data_buffer_;
+  DualIndex read_index_{0, 0};
+  int writes_ = 0;
+};
+} // namespace
+
+BOOST_AUTO_TEST_CASE(reorder_test) {
+  FakeDataSource source(64);
+  TimesliceAckTracker<FakeDataSource> acks(source, 4);
+
+  acks.ack(1);
+  acks.ack(2);
+  BOOST_CHECK_EQUAL(acks.acked_timeslices(), 0);
+  BOOST_CHECK_EQUAL(acks.acked().desc, 0);
+
+  // the completion of the first timeslice covers the reordered ones
+  acks.ack(0);
+  BOOST_CHECK_EQUAL(acks.acked_timeslices(), 3);
+  BOOST_CHECK_EQUAL(acks.acked().desc, 12);
+  BOOST_CHECK_EQUAL(acks.acked().data, 120);
+}
+
+BOOST_AUTO_TEST_CASE(hysteresis_test) {
+  FakeDataSource source(64);
+  TimesliceAckTracker<FakeDataSource> acks(source, 4);
+
+  // the read index is written once a quarter of the buffer is acknowledged
+  for (uint64_t ts = 0; ts < 3; ++ts) {
+    acks.ack(ts);
+  }
+  BOOST_CHECK_EQUAL(source.writes_, 0);
+  acks.ack(3);
+  BOOST_CHECK_EQUAL(source.writes_, 1);
+  BOOST_CHECK_EQUAL(source.read_index_.desc, 16);
+  BOOST_CHECK_EQUAL(acks.cached_acked().desc, 16);
+
+  acks.ack(4);
+  BOOST_CHECK_EQUAL(source.writes_, 1);
+  acks.sync();
+  BOOST_CHECK_EQUAL(source.writes_, 2);
+  BOOST_CHECK_EQUAL(source.read_index_.desc, 20);
+  BOOST_CHECK_EQUAL(source.read_index_.data, 200);
+  // nothing new to release
+  acks.sync();
+  BOOST_CHECK_EQUAL(source.writes_, 2);
+}
+
+BOOST_AUTO_TEST_CASE(multiple_completions_test) {
+  FakeDataSource source(64);
+  source.read_index_ = {8, 80};
+  TimesliceAckTracker<FakeDataSource, 2> acks(source, 4);
+  BOOST_CHECK_EQUAL(acks.start_index().desc, 8);
+
+  // a timeslice is complete once both its completions have arrived
+  acks.ack(0, 1);
+  acks.ack(1, 0);
+  BOOST_CHECK_EQUAL(acks.acked_timeslices(), 0);
+  acks.ack(0, 0);
+  BOOST_CHECK_EQUAL(acks.acked_timeslices(), 1);
+  BOOST_CHECK_EQUAL(acks.acked().desc, 12);
+  BOOST_CHECK_EQUAL(acks.acked().data, 120);
+  acks.ack(1, 1);
+  BOOST_CHECK_EQUAL(acks.acked_timeslices(), 2);
+  BOOST_CHECK_EQUAL(acks.acked().desc, 16);
+}
+
+BOOST_AUTO_TEST_CASE(time_boundaries_test) {
+  FakeDataSource source(64);
+  // microslices of 25 ns, a gap, and microslices of varying duration
+  std::vector<uint64_t> starts{1010, 1035, 1060, 1085, 1110, 1135,
+                               1160, 1185, 1500, 1550, 1620};
+  for (std::size_t i = 0; i < starts.size(); ++i) {
+    source.desc_buffer_.descs[i].idx = starts[i];
+  }
+  TimesliceBoundaries<FakeDataSource> boundaries(source, 0, 0, 100);
+
+  // the end of a window is known once a later microslice has been written
+  BOOST_CHECK(!boundaries.component(0, 4));
+  auto c = boundaries.component(0, 5);
+  BOOST_REQUIRE(c);
+  BOOST_CHECK_EQUAL(c->desc_offset, 0);
+  BOOST_CHECK_EQUAL(c->desc_length, 4);
+
+  c = boundaries.component(1, 9);
+  BOOST_REQUIRE(c);
+  BOOST_CHECK_EQUAL(c->desc_offset, 4);
+  BOOST_CHECK_EQUAL(c->desc_length, 4);
+
+  // empty windows consist of the next microslice as overlap
+  for (uint64_t ts = 2; ts < 5; ++ts) {
+    c = boundaries.component(ts, 9);
+    BOOST_REQUIRE(c);
+    BOOST_CHECK_EQUAL(c->desc_offset, 8);
+    BOOST_CHECK_EQUAL(c->desc_length, 1);
+    BOOST_CHECK_EQUAL(c->core_length, 0);
+  }
+
+  BOOST_CHECK(!boundaries.component(5, 10));
+  c = boundaries.component(5, 11);
+  BOOST_REQUIRE(c);
+  BOOST_CHECK_EQUAL(c->desc_offset, 8);
+  BOOST_CHECK_EQUAL(c->desc_length, 2);
+  BOOST_CHECK_EQUAL(boundaries.begin(6), 10);
+}
+
+BOOST_AUTO_TEST_CASE(time_overlap_test) {
+  FakeDataSource source(64);
+  for (std::size_t i = 0; i < 16; ++i) {
+    source.desc_buffer_.descs[i].idx = 1010 + 25 * i;
+  }
+  TimesliceBoundaries<FakeDataSource> boundaries(source, 0, 0, 100, 30);
+  TimesliceAckTracker<FakeDataSource> acks(source, boundaries);
+
+  // the overlap covers the microslices starting within 30 ns of the window
+  BOOST_CHECK(!boundaries.component(0, 5));
+  auto c = boundaries.component(0, 6);
+  BOOST_REQUIRE(c);
+  BOOST_CHECK_EQUAL(c->desc_offset, 0);
+  BOOST_CHECK_EQUAL(c->desc_length, 5);
+  BOOST_CHECK_EQUAL(c->core_length, 4);
+
+  // the buffer space is released up to the next window
+  acks.ack(0);
+  BOOST_CHECK_EQUAL(acks.acked_timeslices(), 1);
+  BOOST_CHECK_EQUAL(acks.acked().desc, 4);
+  BOOST_CHECK_EQUAL(acks.acked().data, 40);
+}
+
+BOOST_AUTO_TEST_CASE(resize_boundaries_test) {
+  FakeDataSource source(64);
+  TimesliceBoundaries<FakeDataSource> boundaries(source, 4, 1, 0, 0, 2);
+  TimesliceAckTracker<FakeDataSource> acks(source, boundaries);
+  BOOST_CHECK_EQUAL(boundaries.max_pending(), 33);
+
+  // the timeslices from 2 on consist of 2 core microslices
+  boundaries.resize(2, 2);
+  auto c = boundaries.component(1, 64);
+  BOOST_REQUIRE(c);
+  BOOST_CHECK_EQUAL(c->desc_offset, 4);
+  BOOST_CHECK_EQUAL(c->desc_length, 5);
+  c = boundaries.component(3, 64);
+  BOOST_REQUIRE(c);
+  BOOST_CHECK_EQUAL(c->desc_offset, 10);
+  BOOST_CHECK_EQUAL(c->desc_length, 3);
+  BOOST_CHECK_EQUAL(c->core_length, 2);
+  BOOST_CHECK(!boundaries.component(3, 12));
+  BOOST_CHECK_EQUAL(boundaries.min_write_index(3), 13);
+
+  boundaries.resize(4, 3);
+  BOOST_CHECK_EQUAL(boundaries.begin(5), 15);
+  BOOST_CHECK_EQUAL(boundaries.size(5), 3);
+
+  // the buffer space is released up to the next timeslice
+  for (uint64_t ts = 0; ts < 5; ++ts) {
+    acks.ack(ts);
+  }
+  BOOST_CHECK_EQUAL(acks.acked().desc, 15);
+  BOOST_CHECK_EQUAL(boundaries.begin(6), 18);
+}
+
+BOOST_AUTO_TEST_CASE(backpressure_tracker_test) {
+  using namespace std::chrono_literals;
+  BackpressureTracker tracker(2);
+
+  tracker.blocked(BlockReason::RemoteAck, 1);
+  std::this_thread::sleep_for(5ms);
+  tracker.blocked(BlockReason::RemoteAck, 1);
+  tracker.progressed();
+  BOOST_CHECK(tracker.reason() == BlockReason::None);
+  tracker.blocked(BlockReason::DataSource);
+  std::this_thread::sleep_for(2ms);
+
+  auto times = tracker.take();
+  BOOST_CHECK(times[BlockReason::RemoteAck] >= 5ms);
+  BOOST_CHECK(times[BlockReason::DataSource] >= 2ms);
+  BOOST_CHECK(times[BlockReason::Credits] == 0ms);
+  BOOST_CHECK(times.target[0] == 0ms);
+  BOOST_CHECK(times.target[1] == times[BlockReason::RemoteAck]);
+
+  // the current blocking period continues after take()
+  BOOST_CHECK(tracker.reason() == BlockReason::DataSource);
+  tracker.progressed();
+  times = tracker.take();
+  BOOST_CHECK(times[BlockReason::RemoteAck] == 0ms);
+}
+
+BOOST_AUTO_TEST_CASE(ack_coalescer_test) {
+  using namespace std::chrono_literals;
+  struct Position {
+    uint64_t data;
+    uint64_t desc;
+  };
+  const Position size{1000, 100};
+  Position sent{0, 0};
+
+  // by default, every acknowledgement is sent immediately
+  AckCoalescer immediate;
+  BOOST_CHECK(!immediate.due(sent, sent, Position{50, 5}, size));
+  BOOST_CHECK(immediate.due(Position{10, 1}, sent, Position{50, 5}, size));
+
+  AckCoalescer coalescer({4, 10ms, 0.5});
+  // held back until it covers max_count timeslices
+  BOOST_CHECK(!coalescer.due(Position{10, 1}, sent, Position{100, 10}, size));
+  BOOST_CHECK(!coalescer.due(Position{30, 3}, sent, Position{100, 10}, size));
+  BOOST_CHECK(coalescer.due(Position{40, 4}, sent, Position{100, 10}, size));
+  coalescer.on_sent(Position{40, 4}, sent);
+  sent = {40, 4};
+
+  // expedited when the input node's view of the buffer is half full
+  BOOST_CHECK(!coalescer.due(Position{50, 5}, sent, Position{300, 30}, size));
+  BOOST_CHECK(coalescer.due(Position{50, 5}, sent, Position{540, 30}, size));
+  BOOST_CHECK(coalescer.due(Position{50, 5}, sent, Position{100, 54}, size));
+  coalescer.on_sent(Position{50, 5}, sent);
+  sent = {50, 5};
+
+  // sent at the latest after max_delay
+  BOOST_CHECK(!coalescer.due(Position{60, 6}, sent, Position{100, 10}, size));
+  std::this_thread::sleep_for(10ms);
+  BOOST_CHECK(coalescer.due(Position{60, 6}, sent, Position{100, 10}, size));
+  coalescer.on_sent(Position{60, 6}, sent);
+
+  BOOST_CHECK_EQUAL(coalescer.messages(), 3);
+  BOOST_CHECK_EQUAL(coalescer.timeslices(), 6);
+}
@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#define BOOST_TEST_MODULE test_TimesliceAggregator
+#include <boost/test/unit_test.hpp>
+
+#include "TimesliceAggregator.hpp"
+#include "TimesliceCompletionTable.hpp"
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(minimum_test) {
+  TimesliceAggregator aggregator(3);
+  BOOST_CHECK_EQUAL(aggregator.num_shards(), 3);
+  BOOST_CHECK_EQUAL(aggregator.completely_written(), 0);
+
+  aggregator.publish_written(0, 5);
+  aggregator.publish_written(2, 7);
+  BOOST_CHECK_EQUAL(aggregator.completely_written(), 0);
+  aggregator.publish_written(1, 6);
+  BOOST_CHECK_EQUAL(aggregator.completely_written(), 5);
+  aggregator.publish_written(0, 9);
+  BOOST_CHECK_EQUAL(aggregator.completely_written(), 6);
+
+  BOOST_CHECK_EQUAL(aggregator.acked(), 0);
+  aggregator.publish_acked(4);
+  BOOST_CHECK_EQUAL(aggregator.acked(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_test) {
+  constexpr std::size_t num_shards = 4;
+  constexpr uint64_t count = 100000;
+  TimesliceAggregator aggregator(num_shards);
+
+  std::vector<std::thread> shards;
+  for (std::size_t s = 0; s < num_shards; ++s) {
+    shards.emplace_back([&aggregator, s] {
+      for (uint64_t i = 1; i <= count; ++i) {
+        aggregator.publish_written(s, i);
+      }
+    });
+  }
+
+  // The aggregated position never decreases
+  uint64_t written = 0;
+  while (written < count) {
+    uint64_t next = aggregator.completely_written();
+    BOOST_REQUIRE_GE(next, written);
+    written = next;
+  }
+  for (auto& shard : shards) {
+    shard.join();
+  }
+  BOOST_CHECK_EQUAL(aggregator.completely_written(), count);
+}
+
+BOOST_AUTO_TEST_CASE(completion_table_test) {
+  TimesliceCompletionTable table(70, 1);
+
+  BOOST_CHECK(!table.mark_arrived(5, 69));
+  BOOST_CHECK(!table.mark_arrived(5, 69));
+  BOOST_CHECK_EQUAL(table.arrived(5), 1);
+  for (uint32_t i = 0; i < 68; ++i) {
+    BOOST_CHECK(!table.mark_arrived(5, i));
+  }
+  BOOST_CHECK(!table.complete(5));
+  BOOST_CHECK(table.mark_arrived(5, 68));
+  BOOST_CHECK(table.complete(5));
+
+  BOOST_CHECK(table.unmark_arrived(5, 3));
+  BOOST_CHECK(!table.unmark_arrived(5, 3));
+  BOOST_CHECK(!table.complete(5));
+  BOOST_CHECK(table.mark_arrived(5, 3));
+
+  // an unreleased position is kept when the ring grows
+  table.mark_arrived(7, 0);
+  BOOST_CHECK_EQUAL(table.capacity(), 4);
+  BOOST_CHECK(table.complete(5));
+  BOOST_CHECK_EQUAL(table.arrived(7), 1);
+
+  // a released position is reused
+  table.release(6);
+  table.mark_arrived(9, 1);
+  BOOST_CHECK_EQUAL(table.capacity(), 4);
+  BOOST_CHECK_EQUAL(table.arrived(5), 0);
+  BOOST_CHECK_EQUAL(table.arrived(9), 1);
+
+  table.clear(7);
+  BOOST_CHECK_EQUAL(table.arrived(7), 0);
+}
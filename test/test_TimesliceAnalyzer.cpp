@@ -0,0 +1,255 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#define BOOST_TEST_MODULE test_TimesliceAnalyzer
+#include <boost/test/unit_test.hpp>
+
+#include "DeviceTimesliceAnalyzer.hpp"
+#include "StorableTimeslice.hpp"
+#include "TimesliceAnalyzer.hpp"
+#include "TimesliceDebugger.hpp"
+#include "crc32c_batch.h"
+#include <array>
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Create a timeslice with some defective microslices and components
+std::shared_ptr<const fles::Timeslice> create_timeslice(uint64_t index) {
+  static const std::array<uint8_t, 4> data{{7, 13, 12, 8}};
+
+  fles::MicrosliceDescriptor desc = fles::MicrosliceDescriptor();
+  desc.hdr_id = static_cast<uint8_t>(fles::HeaderFormatIdentifier::Standard);
+  desc.hdr_ver = static_cast<uint8_t>(fles::HeaderFormatVersion::Standard);
+  desc.sys_id = static_cast<uint8_t>(fles::Subsystem::FLES);
+  desc.sys_ver = static_cast<uint8_t>(fles::SubsystemFormatFLES::Uninitialized);
+  desc.size = static_cast<uint32_t>(data.size());
+
+  auto ts = std::make_shared<fles::StorableTimeslice>(4, index);
+  for (uint32_t c = 0; c < 8; ++c) {
+    ts->append_component(4, index);
+    for (uint64_t m = 0; m < 4; ++m) {
+      fles::MicrosliceDescriptor d = desc;
+      d.eq_id = static_cast<uint16_t>(c);
+      d.idx = (index * 4 + m) * 100;
+      if (c % 3 == 1 && m == 2) {
+        d.hdr_ver = 0x7f; // unknown header format
+      }
+      if (c == 5 && m == 3) {
+        d.idx += 1; // unexpected start time
+      }
+      ts->append_microslice(c, m, d, data.data());
+    }
+  }
+  return ts;
+}
+
+// Run the analyzer on a sequence of timeslices and return its output
+std::string analyze(unsigned threads) {
+  std::ostringstream out;
+  std::ostringstream hist;
+  {
+    TimesliceAnalyzer analyzer(2, out, "", &hist, nullptr, threads);
+    for (uint64_t i = 0; i < 6; ++i) {
+      analyzer.put(create_timeslice(i));
+    }
+  }
+  return out.str() + hist.str();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(serial_check_test) {
+  std::string output = analyze(0);
+  BOOST_CHECK(output.find("error in ts0/c1/m2") != std::string::npos);
+  BOOST_CHECK(output.find("error in ts0/c5/m3") != std::string::npos);
+  BOOST_CHECK(output.find("with errors") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_check_test) {
+  std::string serial = analyze(0);
+  for (unsigned threads : {1U, 3U, 8U}) {
+    BOOST_CHECK_EQUAL(analyze(threads), serial);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(device_crc_test) {
+  std::array<uint32_t, 256> table{};
+  for (uint32_t i = 0; i < table.size(); ++i) {
+    table[i] = crc32c_table_entry(i);
+  }
+  const std::string data = "123456789";
+  const auto* bytes = reinterpret_cast<const uint8_t*>(data.data());
+  BOOST_CHECK_EQUAL(crc32c_bytewise(table.data(), bytes, data.size()),
+                    0xe3069283U);
+  BOOST_CHECK_EQUAL(crc32c_bytewise(table.data(), bytes, data.size()),
+                    crcutil_interface::Crc32c(bytes, data.size()));
+}
+
+BOOST_AUTO_TEST_CASE(device_host_analysis_test) {
+  // component c carries the flesnet test pattern, microslice 1 of
+  // component 1 is corrupted
+  std::array<uint64_t, 4> words{};
+  fles::MicrosliceDescriptor pattern = fles::MicrosliceDescriptor();
+  pattern.sys_id = static_cast<uint8_t>(fles::Subsystem::FLES);
+  pattern.sys_ver =
+      static_cast<uint8_t>(fles::SubsystemFormatFLES::BasicRampPattern);
+  pattern.size = sizeof(words);
+
+  // microslices with a CRC-32C, microslice 0 with a wrong one
+  const std::array<uint8_t, 5> data{{1, 2, 3, 4, 5}};
+  fles::MicrosliceDescriptor crc = fles::MicrosliceDescriptor();
+  crc.eq_id = 7;
+  crc.flags = static_cast<uint16_t>(fles::MicrosliceFlags::CrcValid);
+  crc.size = data.size();
+  crc.crc = crcutil_interface::Crc32c(data.data(), data.size());
+
+  auto ts = std::make_shared<fles::StorableTimeslice>(2, 5);
+  for (uint32_t c = 0; c < 2; ++c) {
+    ts->append_component(2, 5);
+    for (uint64_t m = 0; m < 2; ++m) {
+      uint64_t word_xor = 0;
+      for (std::size_t i = 0; i < words.size(); ++i) {
+        words[i] = (static_cast<uint64_t>(c) << 48) | (i * sizeof(uint64_t));
+        word_xor ^= words[i];
+      }
+      if (c == 1 && m == 1) {
+        words[2] = 0;
+      }
+      fles::MicrosliceDescriptor d = pattern;
+      d.eq_id = static_cast<uint16_t>(c);
+      d.crc = static_cast<uint32_t>(word_xor & 0xffffffff) ^
+              static_cast<uint32_t>(word_xor >> 32);
+      ts->append_microslice(c, m, d, reinterpret_cast<uint8_t*>(words.data()));
+    }
+  }
+  ts->append_component(2, 5);
+  for (uint64_t m = 0; m < 2; ++m) {
+    fles::MicrosliceDescriptor d = crc;
+    d.crc ^= m == 0 ? 1 : 0;
+    ts->append_microslice(2, m, d, data.data());
+  }
+
+  std::ostringstream out;
+  std::ostringstream hist;
+  DeviceTimesliceAnalyzer::Parameters parameters;
+  parameters.device = -1;
+  parameters.batch_timeslices = 2;
+  {
+    DeviceTimesliceAnalyzer analyzer(parameters, out, "", &hist);
+    std::vector<std::pair<uint64_t, uint32_t>> results;
+    analyzer.set_result_handler(
+        [&](uint64_t ts_index, uint32_t component,
+            const DeviceAnalysisResult& result) {
+          results.emplace_back(ts_index, component);
+          if (component == 1) {
+            BOOST_CHECK_EQUAL(result.pattern_errors, 1);
+          }
+        });
+    for (int i = 0; i < 3; ++i) {
+      analyzer.put(ts);
+    }
+    // the first batch is analyzed once the second one is submitted
+    BOOST_CHECK(results.empty());
+    analyzer.flush();
+    BOOST_CHECK_EQUAL(results.size(), 9);
+
+    const auto& stats = analyzer.statistics();
+    BOOST_CHECK_EQUAL(stats.timeslices, 3);
+    BOOST_CHECK_EQUAL(stats.microslices, 18);
+    BOOST_CHECK_EQUAL(stats.pattern_checked, 12);
+    BOOST_CHECK_EQUAL(stats.pattern_errors, 3);
+    BOOST_CHECK_EQUAL(stats.crc_checked, 6);
+    BOOST_CHECK_EQUAL(stats.crc_errors, 3);
+    // content sizes 32 (bit width 6) and 5 (bit width 3)
+    BOOST_CHECK_EQUAL(stats.size_histograms.at(0)[6], 6);
+    BOOST_CHECK_EQUAL(stats.size_histograms.at(7)[3], 6);
+  }
+  BOOST_CHECK(out.str().find("crc errors: 3/6") != std::string::npos);
+  BOOST_CHECK(hist.str().find("7 0 0 0 6 0") == 0 ||
+              hist.str().find("\n7 0 0 0 6 0") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(dump_sampler_test) {
+  DumpSampling every;
+  every.every = 3;
+  DumpSampler every_sampler(every);
+  std::string selected;
+  for (int i = 0; i < 8; ++i) {
+    selected += every_sampler.sample(0) ? 'x' : '.';
+  }
+  BOOST_CHECK_EQUAL(selected, "x..x..x.");
+  BOOST_CHECK_EQUAL(every_sampler.sampled(), 3);
+  BOOST_CHECK_EQUAL(every_sampler.skipped(), 5);
+
+  DumpSampling rate;
+  rate.rate = 2.0;
+  DumpSampler rate_sampler(rate);
+  auto t0 = DumpSampler::clock::now();
+  BOOST_CHECK(rate_sampler.sample(0, t0));
+  BOOST_CHECK(rate_sampler.sample(0, t0));
+  BOOST_CHECK(!rate_sampler.sample(0, t0));
+  BOOST_CHECK(rate_sampler.sample(0, t0 + std::chrono::milliseconds(500)));
+  BOOST_CHECK(!rate_sampler.sample(0, t0 + std::chrono::milliseconds(600)));
+
+  // a large item overdraws the byte budget and delays the next one
+  DumpSampling bytes;
+  bytes.bytes_per_second = 1000;
+  DumpSampler bytes_sampler(bytes);
+  t0 = DumpSampler::clock::now();
+  BOOST_CHECK(bytes_sampler.sample(1500, t0));
+  BOOST_CHECK(!bytes_sampler.sample(10, t0 + std::chrono::milliseconds(400)));
+  BOOST_CHECK(bytes_sampler.sample(10, t0 + std::chrono::milliseconds(600)));
+}
+
+BOOST_AUTO_TEST_CASE(dump_format_test) {
+  fles::MicrosliceDescriptor desc = fles::MicrosliceDescriptor();
+  desc.hdr_id = 0xdd;
+  desc.hdr_ver = 0x01;
+  desc.eq_id = 0x1234;
+  desc.flags = 0x0001;
+  desc.sys_id = 0x0a;
+  desc.sys_ver = 0x02;
+  desc.idx = 0x1122334455;
+  desc.crc = 0xdeadbeef;
+  desc.size = 0x40;
+  desc.offset = 0x1000;
+  std::ostringstream desc_out;
+  desc_out << MicrosliceDescriptorDump(desc);
+  BOOST_CHECK_EQUAL(
+      desc_out.str(),
+      "hi hv eqid flag si sv idx/start        crc      size     offset\n"
+      "dd 01 1234 0001 0a 02 0000001122334455 deadbeef 00000040 "
+      "0000000000001000\n");
+
+  const std::array<uint8_t, 4> data{{7, 13, 12, 8}};
+  std::ostringstream buf_out;
+  buf_out << BufferDump(data.data(), data.size());
+  BOOST_CHECK_EQUAL(buf_out.str(), std::string(62, ' ') + "080c0d07  :0000\n");
+
+  std::ostringstream ts_out;
+  ts_out << TimesliceDump(*create_timeslice(3), 1);
+  BOOST_CHECK_EQUAL(ts_out.str(),
+                    "timeslice 3 size: 8 x 4 microslices (+0 overlap) = 32\n"
+                    "\tmicroslice size min/avg/max: 4/4/4\n");
+}
+
+BOOST_AUTO_TEST_CASE(sampled_dumper_test) {
+  std::ostringstream out;
+  {
+    DumpSampling sampling;
+    sampling.every = 2;
+    TimesliceDumper dumper(out, 2, sampling);
+    for (uint64_t i = 0; i < 4; ++i) {
+      dumper.put(create_timeslice(i));
+    }
+  }
+  std::ostringstream expected;
+  expected << TimesliceDump(*create_timeslice(0), 2) << "\n"
+           << TimesliceDump(*create_timeslice(2), 2) << "\n";
+  BOOST_CHECK(out.str() == expected.str());
+}
@@ -4,7 +4,108 @@
 
 #include "TimesliceAutoSource.hpp"
 
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <atomic>
+#include <fstream>
+#include <iterator>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+namespace http = boost::beast::http;
+using boost::asio::ip::tcp;
+
+// Minimal web server answering HEAD and range GET requests for the files in
+// the current directory, one thread per connection
+class RangeServer {
+public:
+  RangeServer()
+      : acceptor_(io_context_, {boost::asio::ip::address_v4::loopback(), 0}) {
+    thread_ = std::thread([this] { accept(); });
+  }
+
+  ~RangeServer() {
+    stopped_ = true;
+    // wake up the blocking accept() call
+    tcp::socket socket(io_context_);
+    socket.connect(acceptor_.local_endpoint());
+    thread_.join();
+    for (auto& session : sessions_) {
+      session.join();
+    }
+  }
+
+  [[nodiscard]] std::string url() const {
+    return "http://127.0.0.1:" +
+           std::to_string(acceptor_.local_endpoint().port());
+  }
+
+private:
+  boost::asio::io_context io_context_;
+  tcp::acceptor acceptor_;
+  std::atomic<bool> stopped_{false};
+  std::thread thread_;
+  std::vector<std::thread> sessions_;
+
+  void accept() {
+    while (true) {
+      tcp::socket socket(io_context_);
+      acceptor_.accept(socket);
+      if (stopped_) {
+        return;
+      }
+      sessions_.emplace_back(&RangeServer::serve, std::move(socket));
+    }
+  }
+
+  static void serve(tcp::socket socket) {
+    boost::beast::flat_buffer buffer;
+    while (true) {
+      http::request<http::empty_body> request;
+      boost::system::error_code ec;
+      http::read(socket, buffer, request, ec);
+      if (ec) {
+        return;
+      }
+      std::ifstream file("." + std::string(request.target()),
+                         std::ios::binary);
+      std::string content((std::istreambuf_iterator<char>(file)),
+                          std::istreambuf_iterator<char>());
+      if (!file) {
+        http::response<http::empty_body> response{http::status::not_found,
+                                                  11};
+        response.content_length(0);
+        http::write(socket, response);
+      } else if (request.method() == http::verb::head) {
+        http::response<http::empty_body> response{http::status::ok, 11};
+        response.set(http::field::content_length,
+                     std::to_string(content.size()));
+        http::serializer<false, http::empty_body> serializer(response);
+        serializer.split(true);
+        http::write_header(socket, serializer);
+      } else {
+        // "bytes=first-last"
+        const std::string range(request[http::field::range]);
+        const auto dash = range.find('-');
+        const auto first = std::stoull(range.substr(6, dash - 6));
+        const auto last = std::stoull(range.substr(dash + 1));
+        http::response<http::string_body> response{
+            http::status::partial_content, 11};
+        response.body() = content.substr(first, last - first + 1);
+        response.prepare_payload();
+        http::write(socket, response);
+      }
+    }
+  }
+};
+
+} // namespace
 
 BOOST_AUTO_TEST_CASE(input_archive_sequence_test) {
   fles::TimesliceAutoSource source("test2_%n.tsa");
@@ -46,3 +147,48 @@ BOOST_AUTO_TEST_CASE(invalid_input_archive_test) {
   BOOST_CHECK_THROW(fles::TimesliceAutoSource source(filename),
                     std::runtime_error);
 }
+
+BOOST_AUTO_TEST_CASE(component_selection_test) {
+  for (const auto* locator : {"file://example1.tsa?eq_id=0xffff",
+                              "file://example1.tsa?mmap=1&eq_id=0xffff"}) {
+    fles::TimesliceAutoSource source(locator);
+    uint64_t count = 0;
+    while (auto timeslice = source.get()) {
+      BOOST_CHECK_EQUAL(timeslice->num_components(), 0);
+      ++count;
+    }
+    BOOST_CHECK_EQUAL(count, 2);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(remote_archive_test) {
+  RangeServer server;
+  for (const auto& locator :
+       {server.url() + "/test2_%n.tsa?concurrency=3&chunk_size=1000",
+        server.url() + "/test2_%n.tsa?parallel=2&read_ahead=1",
+        server.url() + "/test2_%n.tsa?start=0&chunk_size=64"}) {
+    fles::TimesliceAutoSource source(locator);
+    uint64_t count = 0;
+    while (auto timeslice = source.get()) {
+      ++count;
+    }
+    BOOST_CHECK_EQUAL(count, 6);
+  }
+  BOOST_CHECK_THROW(
+      fles::TimesliceAutoSource source(server.url() + "/missing.tsa"),
+      std::ios_base::failure);
+}
+
+BOOST_AUTO_TEST_CASE(manifest_test) {
+  // test14.manifest lists two writers of three files each (see test_Archive)
+  fles::TimesliceAutoSource source("file://test14.manifest?range=2-3");
+  uint64_t count = 0;
+  while (auto timeslice = source.get()) {
+    BOOST_CHECK_GE(timeslice->index(), 2);
+    ++count;
+  }
+  BOOST_CHECK_EQUAL(count, 8);
+
+  fles::TimesliceAutoSource none("file://test14.manifest?sys_id=0xfe");
+  BOOST_CHECK(!none.get());
+}
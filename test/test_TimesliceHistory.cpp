@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#define BOOST_TEST_MODULE test_TimesliceHistory
+#include <boost/test/unit_test.hpp>
+
+#include "StorableTimeslice.hpp"
+#include "TimesliceHistory.hpp"
+#include "TimesliceInputArchive.hpp"
+#include <chrono>
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(history_dump_request_test) {
+  HistoryDumpRequest request;
+  request.first_index = 17;
+  request.last_index = 42;
+  request.path = "/data/dump 1.tsa";
+
+  const auto decoded = HistoryDumpRequest::parse(request.to_string());
+  BOOST_CHECK_EQUAL(decoded.first_index, 17u);
+  BOOST_CHECK_EQUAL(decoded.last_index, 42u);
+  BOOST_CHECK_EQUAL(decoded.path, "/data/dump 1.tsa");
+
+  BOOST_CHECK_THROW((void)HistoryDumpRequest::parse("17 42"),
+                    std::invalid_argument);
+  BOOST_CHECK_THROW((void)HistoryDumpRequest::parse("42 17 dump.tsa"),
+                    std::invalid_argument);
+  BOOST_CHECK_THROW((void)HistoryDumpRequest::parse("x y dump.tsa"),
+                    std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(history_dump_test) {
+  std::vector<std::shared_ptr<const fles::Timeslice>> timeslices;
+  {
+    fles::TimesliceInputArchive source("example1.tsa");
+    while (auto timeslice = source.get()) {
+      timeslices.emplace_back(std::move(timeslice));
+    }
+  }
+  BOOST_REQUIRE(!timeslices.empty());
+
+  {
+    TimesliceHistoryDump dump("test_history.tsa", timeslices);
+    while (!dump.done()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    BOOST_CHECK_EQUAL(dump.error(), "");
+    BOOST_CHECK_EQUAL(dump.size(), timeslices.size());
+  }
+
+  fles::TimesliceInputArchive archive("test_history.tsa");
+  std::size_t count = 0;
+  while (auto timeslice = archive.get()) {
+    BOOST_REQUIRE_LT(count, timeslices.size());
+    const auto& original = *timeslices[count];
+    BOOST_CHECK_EQUAL(timeslice->index(), original.index());
+    BOOST_REQUIRE_EQUAL(timeslice->num_components(),
+                        original.num_components());
+    for (uint64_t c = 0; c < original.num_components(); ++c) {
+      BOOST_CHECK_EQUAL(timeslice->size_component(c),
+                        original.size_component(c));
+    }
+    ++count;
+  }
+  BOOST_CHECK_EQUAL(count, timeslices.size());
+}
+
+BOOST_AUTO_TEST_CASE(history_dump_error_test) {
+  TimesliceHistoryDump dump("no_such_directory/test_history.tsa", {});
+  while (!dump.done()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  BOOST_CHECK(!dump.error().empty());
+}
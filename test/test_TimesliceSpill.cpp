@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#define BOOST_TEST_MODULE test_TimesliceSpill
+#include <boost/test/unit_test.hpp>
+
+#include "TimesliceSpill.hpp"
+#include "TimesliceSpillLog.hpp"
+#include <chrono>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// A timeslice of two components with data of distinct values
+struct SpillTimeslice {
+  explicit SpillTimeslice(uint64_t index)
+      : data{std::vector<uint8_t>(1000 + index, static_cast<uint8_t>(index)),
+             std::vector<uint8_t>(5000, static_cast<uint8_t>(index + 100))} {
+    request.ts_pos = index;
+    request.ts_desc.index = index;
+    request.ts_desc.num_components = 2;
+    for (uint64_t c = 0; c < 2; ++c) {
+      fles::TimesliceComponentDescriptor desc{};
+      desc.ts_num = index;
+      desc.size = data[c].size();
+      request.desc.push_back(desc);
+      request.data.push_back(data[c].data());
+    }
+  }
+
+  std::vector<uint8_t> data[2];
+  TimesliceSpill::Request request;
+};
+
+TimesliceSpill::Result pop(TimesliceSpill& spill) {
+  TimesliceSpill::Result result;
+  while (!spill.try_pop(result)) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return result;
+}
+
+bool file_exists(const std::string& path) {
+  return std::ifstream(path).good();
+}
+
+SpillParameters test_parameters() {
+  SpillParameters parameters;
+  parameters.directory = ".";
+  parameters.io.buffer_size = fles::DirectFileBuffer::alignment;
+  return parameters;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(spill_round_trip_test) {
+  TimesliceSpill spill("test_spill", test_parameters());
+  std::vector<SpillTimeslice> timeslices;
+  for (uint64_t i = 0; i < 3; ++i) {
+    timeslices.emplace_back(i);
+  }
+  for (auto& ts : timeslices) {
+    spill.submit(ts.request);
+  }
+
+  for (uint64_t i = 0; i < 3; ++i) {
+    const auto result = pop(spill);
+    BOOST_REQUIRE(result.written);
+    BOOST_CHECK_EQUAL(result.ts_pos, i);
+    BOOST_CHECK_EQUAL(result.offset %
+                          fles::TimesliceSpillRecordHeader::record_alignment,
+                      0u);
+
+    fles::TimesliceSpillRecord record(spill.file_name(result.file),
+                                      result.offset, result.size);
+    BOOST_CHECK_EQUAL(record.ts_desc().index, i);
+    for (uint32_t c = 0; c < 2; ++c) {
+      const auto& data = timeslices[i].data[c];
+      BOOST_CHECK_EQUAL(record.desc(c)->ts_num, i);
+      BOOST_REQUIRE_EQUAL(record.desc(c)->size, data.size());
+      BOOST_CHECK_EQUAL_COLLECTIONS(record.data(c),
+                                    record.data(c) + data.size(), data.begin(),
+                                    data.end());
+    }
+  }
+
+  const auto stats = spill.statistics();
+  BOOST_CHECK_EQUAL(stats.timeslices, 3u);
+  BOOST_CHECK_EQUAL(stats.failed, 0u);
+  BOOST_CHECK_EQUAL(stats.files, 1u);
+}
+
+BOOST_AUTO_TEST_CASE(spill_release_test) {
+  SpillParameters parameters = test_parameters();
+  parameters.max_file_size = 1; // one record per file
+  std::string first_file;
+  std::string second_file;
+  {
+    TimesliceSpill spill("test_spill_release", parameters);
+    SpillTimeslice ts0(0);
+    SpillTimeslice ts1(1);
+    spill.submit(ts0.request);
+    spill.submit(ts1.request);
+    const auto result0 = pop(spill);
+    const auto result1 = pop(spill);
+    BOOST_REQUIRE(result0.written && result1.written);
+    BOOST_CHECK_NE(result0.file, result1.file);
+    first_file = spill.file_name(result0.file);
+    second_file = spill.file_name(result1.file);
+    BOOST_CHECK(file_exists(first_file));
+
+    // the first file is closed and removed with its last record
+    spill.release(result0.file, result0.size);
+    BOOST_CHECK(!file_exists(first_file));
+    BOOST_CHECK(file_exists(second_file));
+    BOOST_CHECK_EQUAL(spill.statistics().live_size,
+                      TimesliceSpill::record_size(ts1.request));
+  }
+  // the remaining files are removed with the writer
+  BOOST_CHECK(!file_exists(second_file));
+}
+
+BOOST_AUTO_TEST_CASE(spill_max_size_test) {
+  SpillParameters parameters = test_parameters();
+  SpillTimeslice ts(0);
+  const uint64_t size = TimesliceSpill::record_size(ts.request);
+  parameters.max_size = size;
+  TimesliceSpill spill("test_spill_max", parameters);
+  BOOST_CHECK(spill.can_accept(size));
+  spill.submit(ts.request);
+  BOOST_CHECK(!spill.can_accept(1));
+  const auto result = pop(spill);
+  BOOST_CHECK(!spill.can_accept(1));
+  spill.release(result.file, result.size);
+  BOOST_CHECK(spill.can_accept(size));
+}
+
+BOOST_AUTO_TEST_CASE(spill_work_item_test) {
+  std::string buffer;
+  fles::encode_spill_work_item(buffer, "./flesnet_0.spill.3", 8192, 6048);
+  BOOST_REQUIRE(fles::TimesliceSpillItemView::is_spill(buffer));
+  const fles::TimesliceSpillItemView item(buffer);
+  BOOST_CHECK_EQUAL(item.path(), "./flesnet_0.spill.3");
+  BOOST_CHECK_EQUAL(item.offset(), 8192u);
+  BOOST_CHECK_EQUAL(item.size(), 6048u);
+
+  BOOST_CHECK(!fles::TimesliceSpillItemView::is_spill("TSF"));
+  buffer.push_back('x');
+  BOOST_CHECK_THROW(fles::TimesliceSpillItemView{buffer}, std::runtime_error);
+}
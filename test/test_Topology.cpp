@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// (C) Copyright 2026 Johann Wolfgang Goethe-Universität Frankfurt
+#define BOOST_TEST_MODULE test_Topology
+#include <boost/test/unit_test.hpp>
+
+#include "ResourceControl.hpp"
+#include "Topology.hpp"
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <unistd.h>
+
+BOOST_AUTO_TEST_CASE(parse_cpu_list_test) {
+  const std::vector<int> expected{0, 1, 2, 3, 8, 10, 11};
+  const auto cpus = parse_cpu_list("0-3,8,10-11\n");
+  BOOST_CHECK_EQUAL_COLLECTIONS(cpus.begin(), cpus.end(), expected.begin(),
+                                expected.end());
+  BOOST_CHECK(parse_cpu_list("").empty());
+  BOOST_CHECK_EQUAL(format_cpu_list(cpus), "0-3,8,10-11");
+}
+
+BOOST_AUTO_TEST_CASE(parse_cpu_list_invalid_test) {
+  BOOST_CHECK_THROW(parse_cpu_list("1-"), std::invalid_argument);
+  BOOST_CHECK_THROW(parse_cpu_list("3-1"), std::invalid_argument);
+  BOOST_CHECK_THROW(parse_cpu_list("a"), std::invalid_argument);
+  BOOST_CHECK_THROW(parse_cpu_list("1x"), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(core_placement_test) {
+  CorePlacement placement({{0, {0, 1, 2}}, {1, {3, 4}}}, {0});
+
+  BOOST_CHECK(placement.assign(1) == std::vector<int>{3});
+  BOOST_CHECK((placement.assign(0, 2) == std::vector<int>{1, 2}));
+  // node 0 is exhausted, fall back to the remaining core
+  BOOST_CHECK(placement.assign(0) == std::vector<int>{4});
+  BOOST_CHECK(placement.assign(-1).empty());
+
+  BOOST_CHECK_EQUAL(placement.node_of(4), 1);
+  BOOST_CHECK_EQUAL(placement.node_of(7), -1);
+}
+
+BOOST_AUTO_TEST_CASE(parse_resctrl_schemata_test) {
+  const auto lines = parse_resctrl_schemata(" L3:0=ff0;1=ff0, MB:0=50;1=50");
+  BOOST_REQUIRE_EQUAL(lines.size(), 2);
+  BOOST_CHECK_EQUAL(lines[0], "L3:0=ff0;1=ff0");
+  BOOST_CHECK_EQUAL(lines[1], "MB:0=50;1=50");
+  BOOST_CHECK(parse_resctrl_schemata("").empty());
+
+  BOOST_CHECK_THROW(parse_resctrl_schemata("L3"), std::invalid_argument);
+  BOOST_CHECK_THROW(parse_resctrl_schemata("L3:0"), std::invalid_argument);
+  BOOST_CHECK_THROW(parse_resctrl_schemata("L3:0=ff;1="),
+                    std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(resctrl_group_test) {
+  namespace fs = std::filesystem;
+  const fs::path root = "test_Topology_" + std::to_string(getpid());
+  BOOST_CHECK_THROW(ResctrlGroup("transport", {}, root.string()),
+                    std::runtime_error);
+
+  fs::create_directories(root);
+  std::ofstream(root / "schemata") << "L3:0=fff\n";
+  {
+    // a directory on a regular file system stands in for the group
+    ResctrlGroup group("transport", {}, root.string());
+    BOOST_CHECK(fs::is_directory(root / "transport"));
+    std::ofstream(root / "transport/tasks");
+    std::ofstream(root / "transport/schemata");
+    group.add_task(42);
+    std::ifstream tasks(root / "transport/tasks");
+    std::string tid;
+    tasks >> tid;
+    BOOST_CHECK_EQUAL(tid, "42");
+
+    ResctrlGroup existing("transport", {"MB:0=50"}, root.string());
+    BOOST_CHECK_EQUAL(existing.schemata(), "MB:0=50");
+    fs::remove(root / "transport/tasks");
+    fs::remove(root / "transport/schemata");
+  }
+  // removed by the group that created it
+  BOOST_CHECK(!fs::exists(root / "transport"));
+  BOOST_CHECK_THROW(ResctrlGroup("a/b", {}, root.string()),
+                    std::invalid_argument);
+  fs::remove_all(root);
+}
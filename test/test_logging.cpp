@@ -1,6 +1,7 @@
 // Copyright 2016 Dirk Hutter <hutter@compeng.uni-frankfurt.de>
 
 #include "log.hpp"
+#include <fstream>
 #include <string>
 
 int main() {
@@ -28,5 +29,28 @@ int main() {
                 << std::endl;
   status_stream << "This is a status_stream message" << std::endl;
 
-  return 0;
+  for (int i = 0; i < 100; ++i) {
+    L_RATE(info, 3, 1.0) << "This is a rate-limited message.";
+  }
+
+  // two at once, then one per 100 ms, reporting the suppressed ones
+  logging::RateLimit limit(2, 10.0);
+  bool limited = limit.admit(0) == 0 && limit.admit(0) == 0 &&
+                 limit.admit(0) == -1 && limit.admit(50'000'000) == -1 &&
+                 limit.admit(100'000'000) == 2;
+
+  // the sinks are asynchronous, wait until all records have been written
+  logging::flush();
+  std::ifstream ifs(log_file);
+  std::string line;
+  bool found = false;
+  int rate_limited = 0;
+  while (std::getline(ifs, line)) {
+    found |= line.find("This is a fatal error message.") != std::string::npos;
+    if (line.find("This is a rate-limited message.") != std::string::npos) {
+      ++rate_limited;
+    }
+  }
+
+  return found && limited && rate_limited == 3 ? 0 : 1;
 }